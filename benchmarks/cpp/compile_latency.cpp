@@ -0,0 +1,375 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <csrc/exceptions.h>
+#include <fusion.h>
+#include <fusion_profiler.h>
+#include <ir/all_nodes.h>
+#include <ir/builder.h>
+#include <kernel_cache.h>
+#include <ops/all_ops.h>
+#include <options.h>
+
+#include <benchmark/benchmark.h>
+
+#include <cuda_runtime.h>
+
+#include <benchmarks/cpp/utils.h>
+#include <tests/cpp/utils.h>
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+
+using namespace nvfuser;
+
+// Compile latency of a corpus of fusions taken from real models. Each
+// iteration compiles a fusion from scratch with a new FusionExecutorCache,
+// and the time of each compile stage is taken from the compile steps
+// recorded by the FusionProfiler, see CompileStepScope. The medians over
+// the iterations are reported as <stage>_ms counters. The first compile of
+// a fusion in the process, which also pays for loading NVRTC and warming
+// up the allocators, is reported as cold_<stage>_ms counters.
+//
+// The kernel disk cache, the kernel database and the remote kernel cache
+// must not be enabled, as they would skip NVRTC.
+//
+// To add a fusion, e.g., one generated with tools/cpp-repro-gen.py from a
+// Python repro, add a function defining it and its inputs to corpus().
+//
+// bin/nvfuser_compile_bench --benchmark_filter=NvFuserCompile/bert
+
+namespace {
+
+struct CorpusEntry {
+  std::string name;
+  std::function<void(Fusion*)> define;
+  std::function<std::vector<c10::IValue>()> make_inputs;
+};
+
+at::TensorOptions halfOptions() {
+  return at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+}
+
+at::TensorOptions floatOptions() {
+  return at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+}
+
+// BERT-large: bias + dropout + residual add + layer norm after attention
+void defineBertBiasDropoutAddLayerNorm(Fusion* fusion) {
+  FusionGuard fg(fusion);
+  auto weight = makeContigTensor(1, DataType::Half);
+  auto bias = makeContigTensor(1, DataType::Half);
+  auto residual = makeContigTensor(3, DataType::Half);
+  auto x = makeContigTensor(3, DataType::Half);
+  auto linear_bias = makeContigTensor(1, DataType::Half);
+  fusion->addInput(weight);
+  fusion->addInput(bias);
+  fusion->addInput(residual);
+  fusion->addInput(x);
+  fusion->addInput(linear_bias);
+
+  auto y = add(
+      castOp(DataType::Float, x),
+      broadcast(castOp(DataType::Float, linear_bias), {true, true, false}));
+  auto dropout_outs = dropout(y, IrBuilder::create<Val>(0.9));
+  auto sum = add(dropout_outs.output, castOp(DataType::Float, residual));
+  auto norm = layer_norm(
+      sum,
+      1,
+      castOp(DataType::Float, weight),
+      castOp(DataType::Float, bias),
+      IrBuilder::create<Val>(1e-5));
+  fusion->addOutput(dropout_outs.mask);
+  fusion->addOutput(castOp(DataType::Half, sum));
+  fusion->addOutput(castOp(DataType::Half, norm.output));
+  fusion->addOutput(norm.mean);
+  fusion->addOutput(norm.invstd);
+}
+
+std::vector<c10::IValue> bertBiasDropoutAddLayerNormInputs() {
+  return {
+      at::ones({1024}, halfOptions()),
+      at::zeros({1024}, halfOptions()),
+      at::randn({8, 512, 1024}, halfOptions()),
+      at::randn({8, 512, 1024}, halfOptions()),
+      at::randn({1024}, halfOptions())};
+}
+
+// BERT-large: scaled and masked attention softmax with dropout
+void defineBertSoftmaxDropout(Fusion* fusion) {
+  FusionGuard fg(fusion);
+  auto scores = makeContigTensor(4, DataType::Half);
+  auto mask = makeContigConcreteTensor({-1, 1, 1, -1}, DataType::Half);
+  fusion->addInput(scores);
+  fusion->addInput(mask);
+
+  auto x = div(castOp(DataType::Float, scores), IrBuilder::create<Val>(8.0));
+  x = add(x, castOp(DataType::Float, mask));
+  auto probs = softmax(x, 3);
+  auto dropout_outs = dropout(probs, IrBuilder::create<Val>(0.9));
+  fusion->addOutput(castOp(DataType::Half, probs));
+  fusion->addOutput(castOp(DataType::Half, dropout_outs.output));
+  fusion->addOutput(dropout_outs.mask);
+}
+
+std::vector<c10::IValue> bertSoftmaxDropoutInputs() {
+  return {
+      at::randn({8, 16, 512, 512}, halfOptions()),
+      at::zeros({8, 1, 1, 512}, halfOptions())};
+}
+
+// timm ResNet: channels-last batch norm in training followed by a ReLU
+void defineTimmBatchNormRelu(Fusion* fusion) {
+  FusionGuard fg(fusion);
+  auto x = makeContigTensor(4, DataType::Half);
+  auto weight = makeContigTensor(1, DataType::Half);
+  auto bias = makeContigTensor(1, DataType::Half);
+  auto running_mean = makeContigTensor(1, DataType::Float);
+  auto running_var = makeContigTensor(1, DataType::Float);
+  fusion->addInput(x);
+  fusion->addInput(weight);
+  fusion->addInput(bias);
+  fusion->addInput(running_mean);
+  fusion->addInput(running_var);
+
+  auto norm = batch_norm(
+      castOp(DataType::Float, x),
+      castOp(DataType::Float, weight),
+      castOp(DataType::Float, bias),
+      running_mean,
+      running_var,
+      /*kTraining=*/true,
+      IrBuilder::create<Val>(0.1),
+      IrBuilder::create<Val>(1e-5),
+      /*channels_last=*/true);
+  fusion->addOutput(castOp(DataType::Half, relu(norm.output)));
+  fusion->addOutput(norm.mean);
+  fusion->addOutput(norm.invstd);
+}
+
+std::vector<c10::IValue> timmBatchNormReluInputs() {
+  return {
+      at::randn({32, 56, 56, 64}, halfOptions()),
+      at::ones({64}, halfOptions()),
+      at::zeros({64}, halfOptions()),
+      at::zeros({64}, floatOptions()),
+      at::ones({64}, floatOptions())};
+}
+
+// nanoGPT: causal attention softmax
+void defineNanoGptCausalSoftmax(Fusion* fusion) {
+  FusionGuard fg(fusion);
+  auto scores = makeContigTensor(4, DataType::Half);
+  auto mask = makeContigTensor(2, DataType::Bool);
+  fusion->addInput(scores);
+  fusion->addInput(mask);
+
+  auto x = mul(castOp(DataType::Float, scores), IrBuilder::create<Val>(0.125));
+  x = where(
+      broadcast(mask, {true, true, false, false}),
+      x,
+      IrBuilder::create<Val>(-std::numeric_limits<double>::infinity()));
+  fusion->addOutput(castOp(DataType::Half, softmax(x, 3)));
+}
+
+std::vector<c10::IValue> nanoGptCausalSoftmaxInputs() {
+  return {
+      at::randn({12, 12, 1024, 1024}, halfOptions()),
+      at::ones({1024, 1024}, halfOptions().dtype(at::kBool)).tril()};
+}
+
+// nanoGPT: bias + GELU of the MLP
+void defineNanoGptBiasGelu(Fusion* fusion) {
+  FusionGuard fg(fusion);
+  auto x = makeContigTensor(2, DataType::Half);
+  auto bias = makeContigTensor(1, DataType::Half);
+  fusion->addInput(x);
+  fusion->addInput(bias);
+
+  auto y = add(
+      castOp(DataType::Float, x),
+      broadcast(castOp(DataType::Float, bias), {true, false}));
+  fusion->addOutput(castOp(DataType::Half, tanh_gelu(y)));
+}
+
+std::vector<c10::IValue> nanoGptBiasGeluInputs() {
+  return {
+      at::randn({12 * 1024, 3072}, halfOptions()),
+      at::randn({3072}, halfOptions())};
+}
+
+// nanoGPT: layer norm backward
+void defineNanoGptLayerNormBackward(Fusion* fusion) {
+  FusionGuard fg(fusion);
+  auto dy = makeContigTensor(2, DataType::Half);
+  auto x = makeContigTensor(2, DataType::Half);
+  auto mean = makeContigConcreteTensor({-1, 1});
+  auto invstd = makeContigConcreteTensor({-1, 1});
+  auto weight = makeContigTensor(1, DataType::Half);
+  auto bias = makeContigTensor(1, DataType::Half);
+  fusion->addInput(dy);
+  fusion->addInput(x);
+  fusion->addInput(mean);
+  fusion->addInput(invstd);
+  fusion->addInput(weight);
+  fusion->addInput(bias);
+
+  auto grads = layer_norm_backward(
+      castOp(DataType::Float, dy),
+      castOp(DataType::Float, x),
+      {768},
+      mean,
+      invstd,
+      castOp(DataType::Float, weight),
+      castOp(DataType::Float, bias),
+      {true, true, true});
+  fusion->addOutput(castOp(DataType::Half, grads.grad_input));
+  fusion->addOutput(castOp(DataType::Half, grads.grad_weight));
+  fusion->addOutput(castOp(DataType::Half, grads.grad_bias));
+}
+
+std::vector<c10::IValue> nanoGptLayerNormBackwardInputs() {
+  return {
+      at::randn({12 * 1024, 768}, halfOptions()),
+      at::randn({12 * 1024, 768}, halfOptions()),
+      at::zeros({12 * 1024, 1}, floatOptions()),
+      at::ones({12 * 1024, 1}, floatOptions()),
+      at::ones({768}, halfOptions()),
+      at::zeros({768}, halfOptions())};
+}
+
+const std::vector<CorpusEntry>& corpus() {
+  static const std::vector<CorpusEntry> entries{
+      {"bert_bias_dropout_add_layer_norm",
+       defineBertBiasDropoutAddLayerNorm,
+       bertBiasDropoutAddLayerNormInputs},
+      {"bert_softmax_dropout",
+       defineBertSoftmaxDropout,
+       bertSoftmaxDropoutInputs},
+      {"timm_batch_norm_relu",
+       defineTimmBatchNormRelu,
+       timmBatchNormReluInputs},
+      {"nanogpt_causal_softmax",
+       defineNanoGptCausalSoftmax,
+       nanoGptCausalSoftmaxInputs},
+      {"nanogpt_bias_gelu", defineNanoGptBiasGelu, nanoGptBiasGeluInputs},
+      {"nanogpt_layer_norm_backward",
+       defineNanoGptLayerNormBackward,
+       nanoGptLayerNormBackwardInputs},
+  };
+  return entries;
+}
+
+// The reported compile stages, each the sum of the compile steps of the
+// given names over all segments. The steps don't nest in each other.
+const std::vector<std::pair<std::string, std::vector<std::string>>>&
+compileStages() {
+  static const std::vector<std::pair<std::string, std::vector<std::string>>>
+      stages{
+          {"segmentation", {"FusionKernelRuntime::FusionKernelRuntime"}},
+          {"scheduling", {"SchedulerEntry::schedule"}},
+          {"lowering", {"GpuLower::analysis", "GpuLower::run"}},
+          {"codegen", {"codegen::generateCudaKernel"}},
+          {"nvrtc", {"executor_utils::NVRTC"}},
+      };
+  return stages;
+}
+
+// Compiles and runs the fusion with a new FusionExecutorCache, and returns
+// the time of each compile stage followed by the total compile time
+std::vector<double> compileOnce(
+    const CorpusEntry& entry,
+    const std::vector<c10::IValue>& inputs) {
+  auto fusion = std::make_unique<Fusion>();
+  entry.define(fusion.get());
+  {
+    FusionExecutorCache fec(std::move(fusion));
+    fec.runFusionWithInputs(inputs);
+  }
+
+  const auto& steps = FusionProfiler::profile().compile_steps;
+  std::vector<double> times;
+  for (const auto& stage : compileStages()) {
+    double ms = 0.0;
+    for (const auto& step : steps) {
+      if (std::find(stage.second.begin(), stage.second.end(), step.name) !=
+          stage.second.end()) {
+        ms += step.time_ms;
+      }
+    }
+    times.push_back(ms);
+  }
+  // Top-level steps cover the whole compilation
+  double total_ms = 0.0;
+  for (const auto& step : steps) {
+    if (step.depth == 0) {
+      total_ms += step.time_ms;
+    }
+  }
+  times.push_back(total_ms);
+  return times;
+}
+
+double median(std::vector<double> values) {
+  NVF_ERROR(!values.empty());
+  const auto mid = values.begin() + (int64_t)values.size() / 2;
+  std::nth_element(values.begin(), mid, values.end());
+  return *mid;
+}
+
+void NvFuserCompile(benchmark::State& benchmark_state, size_t entry_index) {
+  const CorpusEntry& entry = corpus().at(entry_index);
+
+  // Only host time is measured, and compiling the segments one by one
+  // attributes the time of each stage exactly
+  ProfilerOptionsGuard pog;
+  ProfilerOptionsGuard::getCurOptions().set(ProfilerOption::EnableNocupti);
+  DisableOptionsGuard dog;
+  DisableOptionsGuard::getCurOptions().set(DisableOption::ParallelCompile);
+
+  at::manual_seed(0);
+  const std::vector<c10::IValue> inputs = entry.make_inputs();
+
+  // The benchmark library may call this function more than once, but only
+  // the first compile in the process is cold
+  static std::unordered_map<size_t, std::vector<double>> cold_times;
+  if (cold_times.count(entry_index) == 0) {
+    cold_times[entry_index] = compileOnce(entry, inputs);
+  }
+  const auto& cold = cold_times.at(entry_index);
+
+  const size_t num_stages = compileStages().size();
+  std::vector<std::vector<double>> warm(num_stages + 1);
+  for (auto _ : benchmark_state) {
+    auto times = compileOnce(entry, inputs);
+    for (auto i : c10::irange(times.size())) {
+      warm.at(i).push_back(times.at(i));
+    }
+    benchmark_state.SetIterationTime(times.back() / 1000.0);
+  }
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaDeviceSynchronize());
+
+  for (auto i : c10::irange(num_stages + 1)) {
+    const std::string stage =
+        i < num_stages ? compileStages().at(i).first : "total";
+    benchmark_state.counters[stage + "_ms"] = median(warm.at(i));
+    benchmark_state.counters["cold_" + stage + "_ms"] = cold.at(i);
+  }
+}
+
+[[maybe_unused]] const bool compile_latency_registered = []() {
+  for (auto i : c10::irange(corpus().size())) {
+    auto b = benchmark::RegisterBenchmark(
+        ("NvFuserCompile/" + corpus().at(i).name).c_str(), NvFuserCompile, i);
+    b->Unit(benchmark::kMillisecond)->UseManualTime()->Iterations(5);
+  }
+  return true;
+}();
+
+} // namespace
@@ -0,0 +1,133 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <csrc/exceptions.h>
+#include <kernel_cache.h>
+#include <python_frontend/fusion_cache.h>
+#include <python_frontend/fusion_replay.h>
+
+#include <benchmark/benchmark.h>
+
+#include <cuda_runtime.h>
+
+#include <benchmarks/cpp/utils.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <set>
+
+using namespace nvfuser;
+using namespace nvfuser::python_frontend;
+
+// Replays the fusions of a captured model with synthetic inputs, e.g., to
+// share a reproducible performance case without the model code:
+//
+// 1. Run the model with the fusion replay log enabled, and serialize the
+//    FusionCache at exit, e.g.
+//      NVFUSER_ENABLE=fusion_replay_log(replay.log) python train.py
+//    with nvfuser.FusionCache.get().serialize("fusion_cache.bin") at the
+//    end, or with the default workspace of the FusionCache enabled.
+//
+// 2. Replay every recorded execution in order:
+//      NVFUSER_REPLAY_FUSION_CACHE=fusion_cache.bin \
+//      NVFUSER_REPLAY_LOG=replay.log NVFUSER_REPLAY_STEPS=<steps> \
+//      bin/nvfuser_replay_bench
+//
+// NVFUSER_REPLAY_STEPS is the number of model iterations the log covers
+// (default 1), so that the counters are per step. host_ms is the CPU time
+// of issuing the fusions of a step, kernel_ms is the sum of their kernel
+// times, measured in a separate pass since that synchronizes after every
+// kernel, and the iteration time is the device time of a step.
+
+namespace {
+
+const char* getEnvOrNull(const char* name) {
+  const char* value = std::getenv(name);
+  return value != nullptr && value[0] != '\0' ? value : nullptr;
+}
+
+void NvFuserReplay(benchmark::State& benchmark_state) {
+  const char* cache_path = getEnvOrNull("NVFUSER_REPLAY_FUSION_CACHE");
+  const char* log_path = getEnvOrNull("NVFUSER_REPLAY_LOG");
+  const char* steps_env = getEnvOrNull("NVFUSER_REPLAY_STEPS");
+  const double steps = steps_env != nullptr ? std::stod(steps_env) : 1.0;
+
+  FusionCache* fusion_cache = FusionCache::get(
+      /*max_fusions=*/16384,
+      /*selected_device=*/std::nullopt,
+      /*load_from_default_workspace=*/false);
+  if (fusion_cache->numFusions() == 0) {
+    fusion_cache->deserialize(cache_path);
+  }
+
+  const std::vector<FusionReplayCall> calls = readFusionReplayLog(log_path);
+  NVF_CHECK(!calls.empty(), "The fusion replay log is empty: ", log_path);
+
+  at::manual_seed(0);
+  std::vector<FusionExecutorCache*> fecs;
+  std::vector<std::vector<c10::IValue>> inputs;
+  std::set<size_t> fusion_ids;
+  for (const auto& call : calls) {
+    FusionSchedules* scheds =
+        fusion_cache->queryFusionSchedules(call.fusion_id);
+    fecs.push_back(scheds->auto_gen_schedules.get());
+    inputs.push_back(makeFusionReplayInputs(scheds->preschedFusion(), call));
+    fusion_ids.insert(call.fusion_id);
+  }
+
+  auto replay = [&]() {
+    for (auto i : c10::irange(calls.size())) {
+      fecs.at(i)->runFusionWithInputs(inputs.at(i));
+    }
+  };
+
+  // Compiles all fusions
+  replay();
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaDeviceSynchronize());
+
+  double host_ms = 0.0;
+  CudaKernelTimer timer;
+  for (auto _ : benchmark_state) {
+    timer.restart();
+    const auto start = std::chrono::steady_clock::now();
+    replay();
+    host_ms += std::chrono::duration<double, std::milli>(
+                   std::chrono::steady_clock::now() - start)
+                   .count();
+    benchmark_state.SetIterationTime(timer.elapsed() / 1000.0 / steps);
+  }
+
+  double kernel_ms = 0.0;
+  for (auto fec : fecs) {
+    fec->enableKernelTimeMeasurement();
+  }
+  for (auto i : c10::irange(calls.size())) {
+    fecs.at(i)->runFusionWithInputs(inputs.at(i));
+    kernel_ms += fecs.at(i)->getMostRecentKernelTimeMs();
+  }
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaDeviceSynchronize());
+
+  benchmark_state.counters["host_ms"] = benchmark::Counter(
+      host_ms / steps, benchmark::Counter::kAvgIterations);
+  benchmark_state.counters["kernel_ms"] = kernel_ms / steps;
+  benchmark_state.counters["fusions"] = (double)fusion_ids.size();
+  benchmark_state.counters["calls_per_step"] = (double)calls.size() / steps;
+}
+
+// Only registered when a captured model is given
+[[maybe_unused]] const bool fusion_replay_registered = []() {
+  if (getEnvOrNull("NVFUSER_REPLAY_FUSION_CACHE") == nullptr ||
+      getEnvOrNull("NVFUSER_REPLAY_LOG") == nullptr) {
+    return false;
+  }
+  benchmark::RegisterBenchmark("NvFuserReplay", NvFuserReplay)
+      ->Unit(benchmark::kMillisecond)
+      ->UseManualTime();
+  return true;
+}();
+
+} // namespace
@@ -8,6 +8,11 @@
 #include <device_lower/lower2device.h>
 #include <executor.h>
 #include <fusion.h>
+#include <host_ir/container.h>
+#include <host_ir/executor.h>
+#include <host_ir/host_ir.h>
+#include <ir/builder.h>
+#include <ir/cloner.h>
 #include <ops/all_ops.h>
 #include <scheduler/all_schedulers.h>
 
@@ -269,3 +274,118 @@ BENCHMARK_CAPTURE(
     1024,
     128)
     ->Unit(benchmark::kMicrosecond);
+
+//------------------------------------------------------------------------------
+
+// Runs the cell over a sequence of timesteps in a host IR loop carrying the
+// cell state. The gates of all timesteps are precomputed, so the loop only
+// carries cx:
+//   FOR t in 0 : kTimesteps: carrying cx <- cy
+//     cy, hy = Fusion0 (gates, t, cx)
+// With capture_in_cuda_graph, the loop is replayed as a CUDA graph launching
+// all timesteps back to back.
+static void NvFuserScheduler_LstmSequence(
+    benchmark::State& benchmark_state,
+    int hidden_features,
+    int batch_size,
+    bool capture_in_cuda_graph) {
+  constexpr int64_t kTimesteps = 32;
+
+  auto fusion = std::make_unique<Fusion>();
+  {
+    FusionGuard fg(fusion.get());
+    std::vector<TensorView*> gates;
+    for (auto i : c10::irange(4)) {
+      (void)i;
+      gates.push_back(makeContigTensor(3, DataType::Float));
+      fusion->addInput(gates.back());
+    }
+    auto timestep = IrBuilder::create<Val>(DataType::Int);
+    fusion->addInput(timestep);
+    const auto cx = makeContigTensor(2, DataType::Float);
+    fusion->addInput(cx);
+
+    auto lstm_result = lstm(
+        cx,
+        select(gates.at(0), 0, timestep),
+        select(gates.at(1), 0, timestep),
+        select(gates.at(2), 0, timestep),
+        select(gates.at(3), 0, timestep));
+    fusion->addOutput(lstm_result.cell);
+    fusion->addOutput(lstm_result.hidden);
+  }
+
+  at::manual_seed(0);
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  std::vector<c10::IValue> inputs;
+  for (auto i : c10::irange(4)) {
+    (void)i;
+    inputs.emplace_back(
+        at::randn({kTimesteps, batch_size, hidden_features}, options));
+  }
+  inputs.emplace_back((int64_t)0);
+  inputs.emplace_back(at::randn({batch_size, hidden_features}, options));
+  schedulePointwise(fusion.get(), c10::ArrayRef<c10::IValue>(inputs));
+
+  auto hic = std::make_unique<hir::HostIrContainer>();
+  FusionGuard fg(hic.get());
+  auto container = static_cast<IrContainer*>(hic.get());
+  auto host_unit =
+      IrBuilder::create<hir::HostUnit>(container, std::move(fusion));
+  IrCloner ir_cloner(hic.get());
+  std::vector<Val*> host_inputs;
+  for (auto input : host_unit->fusion_to_execute()->inputs()) {
+    host_inputs.push_back(ir_cloner.clone(input));
+  }
+  std::vector<Val*> host_outputs;
+  for (auto output : host_unit->fusion_to_execute()->outputs()) {
+    host_outputs.push_back(ir_cloner.clone(output));
+  }
+  Val* timestep = host_inputs.at(4);
+  Val* cx = host_inputs.at(5);
+  auto for_loop = IrBuilder::create<hir::ForLoop>(
+      container,
+      timestep,
+      hic->zeroVal(DataType::Int),
+      IrBuilder::create<Val>(kTimesteps, DataType::Int));
+  for_loop->pushBackBody(IrBuilder::create<hir::PostOnStream>(
+      container, host_unit, host_inputs, host_outputs));
+  for_loop->pushBackCarriedVal(cx, host_outputs.at(0));
+  hic->pushBackTopLevelExprs(for_loop);
+  for (auto input : host_inputs) {
+    if (input != timestep) {
+      hic->addInput(input);
+    }
+  }
+  hic->addOutput(cx);
+  hic->addOutput(host_outputs.at(1));
+
+  hir::HostIrExecutorParams params;
+  params.cache_fusion_executor = true;
+  params.capture_loops_in_cuda_graph = capture_in_cuda_graph;
+  hir::HostIrExecutor hie(std::move(hic), params);
+
+  inputs.erase(inputs.begin() + 4);
+  // Compiles, and captures the loop with capture_in_cuda_graph
+  for (auto i : c10::irange(2)) {
+    (void)i;
+    hie.runWithInput(inputs);
+  }
+  C10_CUDA_CHECK(cudaDeviceSynchronize());
+
+  CudaKernelTimer timer;
+  for (auto _ : benchmark_state) {
+    timer.restart();
+    hie.runWithInput(inputs);
+    benchmark_state.SetIterationTime(timer.elapsed() / 1000.0);
+  }
+  C10_CUDA_CHECK(cudaDeviceSynchronize());
+}
+
+BENCHMARK_CAPTURE(NvFuserScheduler_LstmSequence, Small_Eager, 512, 1, false)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseManualTime();
+
+BENCHMARK_CAPTURE(NvFuserScheduler_LstmSequence, Small_CudaGraph, 512, 1, true)
+    ->Unit(benchmark::kMicrosecond)
+    ->UseManualTime();
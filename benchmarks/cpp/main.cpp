@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 // clang-format on
+#include "roofline.h"
 #include "utils.h"
 
 #include <options.h>
@@ -16,6 +17,8 @@
 #include <unistd.h>
 #endif
 
+#include <cstring>
+
 namespace {
 
 std::string getHostName() {
@@ -64,10 +67,55 @@ void addGPUBenchmarkContext() {
       "gpu_max_threads_per_block", std::to_string(prop.maxThreadsPerBlock));
 }
 
+// Removes --roofline_out=<path> from the arguments, since it's not a flag of
+// the benchmark library, and returns the path. Returns an empty string if the
+// flag is not given.
+std::string parseRooflineOut(int* argc, char** argv) {
+  constexpr const char* flag = "--roofline_out=";
+  std::string path;
+  int new_argc = 0;
+  for (int i = 0; i < *argc; ++i) {
+    if (std::strncmp(argv[i], flag, std::strlen(flag)) == 0) {
+      path = argv[i] + std::strlen(flag);
+    } else {
+      argv[new_argc++] = argv[i];
+    }
+  }
+  argv[new_argc] = nullptr;
+  *argc = new_argc;
+  return path;
+}
+
+// Removes --host_overhead from the arguments, and returns whether it was
+// given
+bool parseHostOverhead(int* argc, char** argv) {
+  constexpr const char* flag = "--host_overhead";
+  bool found = false;
+  int new_argc = 0;
+  for (int i = 0; i < *argc; ++i) {
+    if (std::strcmp(argv[i], flag) == 0) {
+      found = true;
+    } else {
+      argv[new_argc++] = argv[i];
+    }
+  }
+  argv[new_argc] = nullptr;
+  *argc = new_argc;
+  return found;
+}
+
 } // namespace
 
 // Copied from BENCHMARK_MAIN with extra custom settings
 int main(int argc, char** argv) {
+  // Writes a roofline report in JSON in addition to the regular output, e.g.
+  // bin/nvfuser_bench --roofline_out=roofline.json
+  const std::string roofline_out = parseRooflineOut(&argc, argv);
+  // Measures the host overhead of cache hits instead of the kernel times of
+  // the benchmarks using a FusionExecutorCache, e.g.
+  // bin/nvfuser_bench --host_overhead --benchmark_filter=NvFuserScheduler
+  setMeasureHostOverhead(parseHostOverhead(&argc, argv));
+
   ::benchmark::Initialize(&argc, argv);
   if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
     return 1;
@@ -87,7 +135,17 @@ int main(int argc, char** argv) {
   DisableOptionsGuard og;
   DisableOptionsGuard::getCurOptions().set(DisableOption::KernelReuse);
 
-  ::benchmark::RunSpecifiedBenchmarks();
+  if (roofline_out.empty()) {
+    ::benchmark::RunSpecifiedBenchmarks();
+  } else {
+    int dev_idx = 0;
+    NVFUSER_CUDA_RT_SAFE_CALL(cudaGetDevice(&dev_idx));
+    RooflineReporter reporter(
+        std::make_unique<::benchmark::ConsoleReporter>(),
+        roofline_out,
+        DevicePeaks::query(dev_idx));
+    ::benchmark::RunSpecifiedBenchmarks(&reporter);
+  }
 
   ::benchmark::Shutdown();
   return 0;
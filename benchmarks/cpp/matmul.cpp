@@ -23,6 +23,7 @@
 
 #include <cuda_runtime.h>
 
+#include <benchmarks/cpp/roofline.h>
 #include <benchmarks/cpp/utils.h>
 #include <tests/cpp/utils.h>
 
@@ -187,7 +188,7 @@ static void SingleMatmulBase(
 
   runBenchmarkIterations(benchmark_state, &fe, aten_inputs);
 
-  // TODO: FLOPS calculation
+  setFlopsProcessed(benchmark_state, 2 * m * n * k);
 }
 
 static void Baseline_Matmul(
@@ -221,6 +222,9 @@ static void Baseline_Matmul(
   // Sync everything up before we're finished, don't want to run ahead on the
   // cpu while benchmarking.
   cudaDeviceSynchronize();
+
+  setFlopsProcessed(
+      benchmark_state, 2 * input_mnk.at(0) * input_mnk.at(1) * input_mnk.at(2));
 }
 
 // Actual benchmarking
@@ -365,7 +369,7 @@ static void SingleMatmulPartitionedK(
 
   runBenchmarkIterations(benchmark_state, &fe, aten_inputs);
 
-  // TODO: FLOPS calculation
+  setFlopsProcessed(benchmark_state, 2 * M * N * K);
 }
 
 static void NvFuserScheduler_Matmul(
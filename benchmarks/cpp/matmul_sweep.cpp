@@ -0,0 +1,222 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+
+// Sweeps the matmul scheduler over the problems of matmul_problems.csv in all
+// four layouts and in half and bfloat16 precision. This is built as the
+// separate nvfuser_matmul_bench target, since the sweep is much longer than
+// the other benchmarks.
+//
+// The problems file defaults to benchmarks/python/matmul_problems.csv and can
+// be set with NVFUSER_MATMUL_PROBLEMS. Only the first
+// NVFUSER_MATMUL_SWEEP_MAX_PROBLEMS (default 100) distinct MNK shapes of the
+// file are benchmarked, and the layout column is ignored.
+//
+// Each run records the following counters, which tools/check_matmul_sweep.py
+// checks against a baseline run:
+//   tflops:          achieved TFLOPs of the nvFuser kernel
+//   cublas_tflops:   achieved TFLOPs of at::matmul on the same inputs
+//   pct_of_cublas:   100 * cuBLAS time / nvFuser time
+//   registers:       registers per thread of the nvFuser kernel
+//   smem_bytes:      static plus dynamic shared memory of the nvFuser kernel
+//
+// Example:
+//   bin/nvfuser_matmul_bench --roofline_out=roofline.json \
+//     --benchmark_out=sweep.json --benchmark_out_format=json
+#include <csrc/exceptions.h>
+#include <cuda_utils.h>
+#include <driver_api.h>
+#include <executor.h>
+#include <fusion.h>
+#include <ir/all_nodes.h>
+#include <kernel_cache.h>
+#include <ops/all_ops.h>
+#include <options.h>
+#include <scheduler/matmul_heuristic.h>
+#include <utils.h>
+
+#include <benchmark/benchmark.h>
+
+#include <cuda_runtime.h>
+
+#include <benchmarks/cpp/roofline.h>
+#include <benchmarks/cpp/utils.h>
+#include <tests/cpp/utils.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <tuple>
+
+using namespace nvfuser;
+
+namespace {
+
+using MatmulProblem = std::tuple<int64_t, int64_t, int64_t>;
+
+std::vector<MatmulProblem> loadMatmulProblems() {
+  const char* path_env = std::getenv("NVFUSER_MATMUL_PROBLEMS");
+  const std::string path =
+      path_env != nullptr ? path_env : NVFUSER_MATMUL_PROBLEMS_CSV;
+  const char* max_env = std::getenv("NVFUSER_MATMUL_SWEEP_MAX_PROBLEMS");
+  const size_t max_problems = max_env != nullptr ? std::stoul(max_env) : 100;
+
+  std::ifstream file(path);
+  NVF_CHECK(file.good(), "Could not open matmul problems file ", path);
+
+  std::vector<MatmulProblem> problems;
+  std::set<MatmulProblem> seen;
+  std::string line;
+  // Skip the M,N,K,layout header
+  std::getline(file, line);
+  while (problems.size() < max_problems && std::getline(file, line)) {
+    std::stringstream ss(line);
+    std::string m, n, k;
+    if (!std::getline(ss, m, ',') || !std::getline(ss, n, ',') ||
+        !std::getline(ss, k, ',')) {
+      continue;
+    }
+    MatmulProblem problem{std::stol(m), std::stol(n), std::stol(k)};
+    if (seen.insert(problem).second) {
+      problems.push_back(problem);
+    }
+  }
+  return problems;
+}
+
+std::unique_ptr<Fusion> makeMatmulFusion(MmaLayout layout, DataType dtype) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto a = makeContigTensor(2, dtype);
+  auto b = makeContigTensor(2, dtype);
+  fusion->addInput(a);
+  fusion->addInput(b);
+
+  a = canonicalizeInputToBMNK(a, layout, MmaOperand::A);
+  b = canonicalizeInputToBMNK(b, layout, MmaOperand::B);
+  auto c = fusedMultiplySum(a, b, {-1});
+  fusion->addOutput(castOp(dtype, c));
+  return fusion;
+}
+
+void NvFuserScheduler_MatmulSweep(
+    benchmark::State& benchmark_state,
+    MmaLayout layout,
+    DataType dtype) {
+  int64_t m = benchmark_state.range(0);
+  int64_t n = benchmark_state.range(1);
+  int64_t k = benchmark_state.range(2);
+
+  if (cudaArchGuardShouldSkip(8, 0)) {
+    benchmark_state.SkipWithError("Matmul sweep requires Ampere or newer");
+    return;
+  }
+
+  DisableOptionsGuard dog;
+  DisableOptionsGuard::getCurOptions().set(DisableOption::MatmulExprEval);
+
+  // Disable reduced-precision reduction for fair comparison since we do not
+  // use it in nvFuser
+  at::globalContext().setAllowFP16ReductionCuBLAS(false);
+  at::globalContext().setAllowBF16ReductionCuBLAS(false);
+
+  at::manual_seed(0);
+  auto inputs = matmulAtInput2D(m, n, k, layout, data_type_to_aten(dtype));
+  std::vector<c10::IValue> aten_inputs({inputs.first, inputs.second});
+
+  FusionExecutorCache fec(makeMatmulFusion(layout, dtype));
+  auto outputs = fec.runFusionWithInputs(aten_inputs);
+
+  FusionKernelRuntime* runtime = fec.getMostRecentKernelRuntime();
+  ExecutorLog log = fec.getMostRecentExecutorInfo();
+  if (runtime->isSegmented() || log.params == nullptr ||
+      !log.params->isA<MatmulParams>()) {
+    benchmark_state.SkipWithError("Not scheduled by the matmul scheduler");
+    return;
+  }
+  FusionExecutor* fe = log.fusion_executor;
+  benchmark_state.SetLabel(
+      toString(log.params) + toString(fe->lastLaunchParams()));
+
+  auto expected = atMatmul(inputs.first, inputs.second, layout);
+  const double tol = (dtype == DataType::Half ? 1e-4 : 1e-3) * (double)k;
+  NVF_CHECK(
+      at::allclose(
+          outputs.at(0).to(at::kFloat), expected.to(at::kFloat), tol, tol),
+      "Fusion returns wrong results!");
+
+  int num_registers = 0;
+  NVFUSER_CUDA_SAFE_CALL(cuFuncGetAttribute(
+      &num_registers,
+      CU_FUNC_ATTRIBUTE_NUM_REGS,
+      fe->compiledKernel().function));
+  int static_smem_bytes = 0;
+  NVFUSER_CUDA_SAFE_CALL(cuFuncGetAttribute(
+      &static_smem_bytes,
+      CU_FUNC_ATTRIBUTE_SHARED_SIZE_BYTES,
+      fe->compiledKernel().function));
+  const int64_t smem_bytes = static_smem_bytes + fe->lastLaunchParams().smem();
+
+  // Both are timed in the same iterations so that clock and thermal changes
+  // during the sweep affect them alike. Only the nvFuser kernel time is
+  // reported as the iteration time.
+  fe->setMeasureKernelTimeFlag(true);
+  double nvfuser_ms = 0.0;
+  double cublas_ms = 0.0;
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaDeviceSynchronize());
+  for (auto _ : benchmark_state) {
+    clearL2Cache();
+    CudaKernelTimer timer;
+    expected = atMatmul(inputs.first, inputs.second, layout);
+    cublas_ms += timer.elapsed();
+
+    clearL2Cache();
+    outputs = fec.runFusionWithInputs(aten_inputs);
+    nvfuser_ms += fe->kernelTimeMs();
+    benchmark_state.SetIterationTime(fe->kernelTimeMs() / 1000.0);
+  }
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaDeviceSynchronize());
+
+  const int64_t flops = 2 * m * n * k;
+  const double iterations = (double)benchmark_state.iterations();
+  setFlopsProcessed(benchmark_state, flops);
+  benchmark_state.counters["tflops"] =
+      (double)flops * iterations / (nvfuser_ms * 1e9);
+  benchmark_state.counters["cublas_tflops"] =
+      (double)flops * iterations / (cublas_ms * 1e9);
+  benchmark_state.counters["pct_of_cublas"] = 100.0 * cublas_ms / nvfuser_ms;
+  benchmark_state.counters["registers"] = num_registers;
+  benchmark_state.counters["smem_bytes"] = (double)smem_bytes;
+}
+
+// Registers one benchmark per layout and precision, each with all problems of
+// the problems file as arguments.
+[[maybe_unused]] const bool matmul_sweep_registered = []() {
+  const std::vector<MatmulProblem> problems = loadMatmulProblems();
+  for (DataType dtype : {DataType::Half, DataType::BFloat16}) {
+    const char* dtype_name = dtype == DataType::Half ? "half" : "bfloat16";
+    for (MmaLayout layout :
+         {MmaLayout::TT, MmaLayout::TN, MmaLayout::NT, MmaLayout::NN}) {
+      std::stringstream name;
+      name << "NvFuserScheduler_MatmulSweep/" << dtype_name << "_"
+           << toString(layout);
+      auto b = benchmark::RegisterBenchmark(
+          name.str().c_str(), NvFuserScheduler_MatmulSweep, layout, dtype);
+      b->ArgNames({"M", "N", "K"})
+          ->Unit(benchmark::kMicrosecond)
+          ->UseManualTime();
+      for (auto [m, n, k] : problems) {
+        b->Args({m, n, k});
+      }
+    }
+  }
+  return true;
+}();
+
+} // namespace
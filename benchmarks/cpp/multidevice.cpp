@@ -0,0 +1,469 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+
+// Benchmarks of tensor parallel (TP) and sequence parallel (SP) transformer
+// blocks sharded like Megatron-LM's, to be run with one process per GPU, e.g.
+//   mpirun -np 8 bin/nvfuser_multidevice_bench
+//
+// Each benchmark reports as its time the step time of the block with the
+// communications overlapping the independent compute, and as counters:
+//   - serial_step_ms: the step time when each communication is waited for
+//     right after it is posted
+//   - <CommunicationType>_ms and <CommunicationType>_busbw_GBps: the time
+//     and bus bandwidth of each collective of the block run on its own,
+//     where the bus bandwidth follows the definition of nccl-tests
+//   - comm_ms: the total time of the collectives
+//   - overlap_pct: the part of comm_ms hidden behind compute, i.e.
+//     (serial_step_ms - step time) / comm_ms
+//
+// All processes run the same number of iterations, and only the process of
+// device 0 reports.
+
+#include <fusion.h>
+#include <ir/builder.h>
+#include <ir/utils.h>
+#include <multidevice/communication.h>
+#include <multidevice/communicator.h>
+#include <multidevice/executor.h>
+#include <ops/all_ops.h>
+#include <tests/cpp/utils.h>
+
+#include <ATen/cuda/CUDAEvent.h>
+#include <benchmark/benchmark.h>
+#include <c10/util/irange.h>
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <optional>
+#include <sstream>
+#include <unordered_set>
+
+using namespace nvfuser;
+
+namespace {
+
+constexpr int64_t num_iterations = 20;
+
+Communicator& getCommunicator() {
+  // Never destroyed, as the backends may outlive the benchmarks
+  static auto* communicator = new Communicator();
+  return *communicator;
+}
+
+// Returns the time in ms of fn on the current stream, after synchronizing
+// all the devices so that the processes start together
+float timeMs(const std::function<void()>& fn) {
+  getCommunicator().barrier();
+  at::cuda::CUDAEvent start(cudaEventDefault);
+  at::cuda::CUDAEvent stop(cudaEventDefault);
+  start.record();
+  fn();
+  stop.record();
+  stop.synchronize();
+  return start.elapsed_time(stop);
+}
+
+// A collective of a block on all the devices, on a tensor of numel elements
+// of the given type before sharding
+struct Collective {
+  CommunicationType type;
+  int64_t numel;
+  at::ScalarType dtype = at::kHalf;
+};
+
+// Ratio of the bus bandwidth over the algorithm bandwidth of nccl-tests
+double busBandwidthFactor(CommunicationType type, int64_t num_devices) {
+  const double n = static_cast<double>(num_devices);
+  switch (type) {
+    case CommunicationType::Allreduce:
+      return 2.0 * (n - 1.0) / n;
+    case CommunicationType::Allgather:
+    case CommunicationType::ReduceScatter:
+    case CommunicationType::Gather:
+    case CommunicationType::Scatter:
+      return (n - 1.0) / n;
+    default:
+      return 1.0;
+  }
+}
+
+// Returns the average time in ms of the collective on its own, with the
+// buffers laid out as by the lowering of the corresponding resharding
+float timeCollectiveMs(const Collective& collective) {
+  Communicator& comm = getCommunicator();
+  const int64_t num_devices = comm.size();
+  NVF_CHECK(
+      collective.numel % num_devices == 0,
+      "The collective can't be evenly sharded on ",
+      num_devices,
+      " devices");
+  const int64_t shard_numel = collective.numel / num_devices;
+
+  static IrContainer container;
+  CommParams params;
+  params.type = collective.type;
+  params.team = Team(num_devices);
+  std::iota(params.team.begin(), params.team.end(), 0);
+  auto options =
+      at::TensorOptions().dtype(collective.dtype).device(comm.device());
+  at::Tensor input;
+  at::Tensor output;
+  switch (collective.type) {
+    case CommunicationType::Allgather:
+      input = at::randn({1, shard_numel}, options);
+      output = at::empty({num_devices, shard_numel}, options);
+      break;
+    case CommunicationType::Allreduce:
+      params.redOp = c10d::ReduceOp::RedOpType::SUM;
+      input = at::randn({1, collective.numel}, options);
+      output = at::empty({collective.numel}, options);
+      break;
+    case CommunicationType::ReduceScatter:
+      params.redOp = c10d::ReduceOp::RedOpType::SUM;
+      params.root = 0;
+      params.scattered_axis = 1;
+      input = at::randn({1, num_devices, shard_numel}, options);
+      output = at::empty({1, shard_numel}, options);
+      break;
+    default:
+      NVF_ERROR(false, "Unsupported collective ", collective.type);
+  }
+  auto communication = IrBuilder::create<Communication>(&container, params);
+  c10::intrusive_ptr<c10d::Backend> backend =
+      comm.getBackendForTeam(params.team, std::nullopt);
+
+  auto post = [&]() {
+    auto work = postSingleCommunication(
+        communication, comm.deviceId(), backend, input, output);
+    if (work != nullptr) {
+      work->wait();
+    }
+  };
+  // Warm up, e.g. to initialize the communicators of the backend
+  post();
+  float total_ms = 0;
+  for (auto i : c10::irange(num_iterations)) {
+    (void)i; // Suppress unused variable warning
+    total_ms += timeMs(post);
+  }
+  return total_ms / (float)num_iterations;
+}
+
+void runBlockBenchmark(
+    benchmark::State& state,
+    const std::function<std::unique_ptr<Fusion>(const DeviceMesh&)>&
+        define_block,
+    const std::vector<c10::IValue>& inputs,
+    const std::vector<Collective>& collectives) {
+  Communicator& comm = getCommunicator();
+  auto mesh = DeviceMesh::createForNumDevices(comm.size());
+
+  MultiDeviceExecutorParams params;
+  params.cache_fusion_executor = true;
+  MultiDeviceExecutor overlapped(define_block(mesh), comm, params);
+  params.overlap_communications = false;
+  MultiDeviceExecutor serial(define_block(mesh), comm, params);
+
+  // The first runs compile the kernels
+  overlapped.runWithInput(inputs);
+  serial.runWithInput(inputs);
+
+  float step_ms = 0;
+  for (auto _ : state) {
+    float iteration_ms = timeMs([&]() { overlapped.runWithInput(inputs); });
+    state.SetIterationTime(iteration_ms / 1000.0);
+    step_ms += iteration_ms;
+  }
+  step_ms /= (float)state.iterations();
+
+  float serial_step_ms = 0;
+  for (auto i : c10::irange(num_iterations)) {
+    (void)i; // Suppress unused variable warning
+    serial_step_ms += timeMs([&]() { serial.runWithInput(inputs); });
+  }
+  serial_step_ms /= (float)num_iterations;
+
+  float comm_ms = 0;
+  for (const Collective& collective : collectives) {
+    const float collective_ms = timeCollectiveMs(collective);
+    comm_ms += collective_ms;
+    std::stringstream name;
+    name << collective.type;
+    const double bytes = static_cast<double>(collective.numel) *
+        static_cast<double>(c10::elementSize(collective.dtype));
+    state.counters[name.str() + "_ms"] = collective_ms;
+    state.counters[name.str() + "_busbw_GBps"] = bytes / collective_ms / 1e6 *
+        busBandwidthFactor(collective.type, comm.size());
+  }
+
+  state.counters["serial_step_ms"] = serial_step_ms;
+  state.counters["comm_ms"] = comm_ms;
+  state.counters["overlap_pct"] = comm_ms > 0
+      ? std::max(0.0f, serial_step_ms - step_ms) / comm_ms * 100
+      : 0;
+  state.counters["num_devices"] = (double)comm.size();
+}
+
+// Shards axis 0 of all the TensorViews of the fusion on the devices of mesh,
+// except for the given replicated ones
+void shardOuterAxis(
+    Fusion* fusion,
+    const DeviceMesh& mesh,
+    const std::unordered_set<TensorView*>& replicated) {
+  for (TensorView* tv : ir_utils::allTvs(fusion)) {
+    tv->setDeviceMesh(mesh);
+    if (!replicated.count(tv)) {
+      tv->axis(0)->parallelize(ParallelType::DIDx);
+    }
+  }
+}
+
+// Returns a @ b^T for a [D, M, K] and b [D, N, K], batched on D, where either
+// may be broadcast on D
+TensorView* linear(TensorView* a, TensorView* b) {
+  TensorView* a_b = broadcast(a, {false, false, true, false}); // [D,M,b,K]
+  TensorView* b_b = broadcast(b, {false, true, false, false}); // [D,b,N,K]
+  return sum(mul(a_b, b_b), {-1}); // [D,M,N]
+}
+
+// Megatron's MLP: a column-parallel linear, GeLU and a row-parallel linear
+// whose partial outputs are summed by an Allreduce. x [M, H] is replicated,
+// the weights w0 [D, 4H/D, H] and w1 [D, H, 4H/D] are sharded.
+std::unique_ptr<Fusion> shardedMlp(const DeviceMesh& mesh) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  TensorView* x = makeContigTensor(2, DataType::Half);
+  TensorView* w0 = makeContigTensor(3, DataType::Half);
+  TensorView* w1 = makeContigTensor(3, DataType::Half);
+  fusion->addInput(x);
+  fusion->addInput(w0);
+  fusion->addInput(w1);
+
+  TensorView* x_b = broadcast(x, {true, false, false}); // [b,M,H]
+  TensorView* h0 = castOp(DataType::Half, gelu(linear(x_b, w0)));
+  TensorView* partial = linear(h0, w1); // [D,M,H]
+  TensorView* y = sum(partial, {0}); // [r,M,H]
+  fusion->addOutput(y);
+
+  shardOuterAxis(fusion.get(), mesh, {x, y});
+  return fusion;
+}
+
+// Megatron's self-attention with one head per device: column-parallel
+// projections of the queries, keys and values, the attention of the head,
+// and a row-parallel output projection whose partial outputs are summed by
+// an Allreduce. x [S, H] is replicated, the weights wq, wk, wv [D, H/D, H]
+// and wo [D, H, H/D] are sharded.
+std::unique_ptr<Fusion> shardedAttention(const DeviceMesh& mesh) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  TensorView* x = makeContigTensor(2, DataType::Half);
+  std::vector<TensorView*> weights;
+  fusion->addInput(x);
+  for (auto i : c10::irange(4)) {
+    (void)i; // Suppress unused variable warning
+    weights.push_back(makeContigTensor(3, DataType::Half));
+    fusion->addInput(weights.back());
+  }
+
+  TensorView* x_b = broadcast(x, {true, false, false}); // [b,S,H]
+  TensorView* q = castOp(DataType::Half, linear(x_b, weights[0])); // [D,S,E]
+  TensorView* k = castOp(DataType::Half, linear(x_b, weights[1])); // [D,S,E]
+  TensorView* v = castOp(DataType::Half, linear(x_b, weights[2])); // [D,S,E]
+  TensorView* scores = linear(q, k); // [D,S,S]
+  TensorView* probs = castOp(DataType::Half, softmax(scores, -1));
+  TensorView* ctx = linear(probs, transpose(v, 1, 2)); // [D,S,E]
+  TensorView* partial =
+      linear(castOp(DataType::Half, ctx), weights[3]); // [D,S,H]
+  TensorView* y = sum(partial, {0}); // [r,S,H]
+  fusion->addOutput(y);
+
+  shardOuterAxis(fusion.get(), mesh, {x, y});
+  return fusion;
+}
+
+// Megatron's sequence-parallel layer norm: the partial outputs [D, S, H] of
+// the previous row-parallel linear are summed by a ReduceScatter along the
+// sequence, normalized on each device, and gathered by an Allgather for the
+// next column-parallel linear.
+std::unique_ptr<Fusion> sequenceParallelLayerNorm(
+    const DeviceMesh& mesh,
+    int64_t s,
+    int64_t h) {
+  const auto num_devices = static_cast<int64_t>(mesh.vector().size());
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  TensorView* partial = makeContigTensor(3, DataType::Half); // [D,S,H]
+  fusion->addInput(partial);
+
+  TensorView* x = reshape(
+      partial,
+      std::vector<int64_t>({num_devices, s, h}),
+      std::vector<int64_t>(
+          {num_devices, num_devices, s / num_devices, h})); // [D,D,S/D,H]
+  TensorView* x_sum = sum(x, {0}); // [r,D,S/D,H]
+  TensorView* x_norm = castOp(
+      DataType::Half,
+      layer_norm(
+          x_sum,
+          /*kNormShapeNumDims=*/1,
+          /*weight=*/nullptr,
+          /*bias=*/nullptr,
+          IrBuilder::create<Val>(1e-5))
+          .output); // [D,S/D,H]
+  TensorView* y = set(x_norm); // [D,S/D,H]
+  fusion->addOutput(y);
+
+  shardOuterAxis(fusion.get(), mesh, {x_sum, y});
+  x_sum->axis(1)->parallelize(ParallelType::DIDx);
+  return fusion;
+}
+
+// Returns a random tensor of the given sizes, with a leading axis of size 1
+// if it's sharded
+at::Tensor makeInput(std::vector<int64_t> sizes, bool sharded) {
+  if (sharded) {
+    sizes.insert(sizes.begin(), 1);
+  }
+  auto options =
+      at::TensorOptions().dtype(at::kHalf).device(getCommunicator().device());
+  return at::randn(sizes, options);
+}
+
+// Skips the benchmark if the devices can't evenly shard the sizes. Returns
+// the number of devices otherwise.
+std::optional<int64_t> getNumDevices(
+    benchmark::State& state,
+    const std::vector<int64_t>& sizes) {
+  const int64_t num_devices = getCommunicator().size();
+  for (auto size : sizes) {
+    if (size % num_devices != 0) {
+      state.SkipWithError("Sizes can't be sharded on the devices");
+      return std::nullopt;
+    }
+  }
+  return num_devices;
+}
+
+} // namespace
+
+static void NvFuserScheduler_Multidevice_ShardedMlp(benchmark::State& state) {
+  const int64_t m = state.range(0);
+  const int64_t h = state.range(1);
+  const auto num_devices = getNumDevices(state, {4 * h});
+  if (!num_devices.has_value()) {
+    return;
+  }
+  const int64_t f = 4 * h / num_devices.value();
+  std::vector<c10::IValue> inputs = {
+      makeInput({m, h}, /*sharded=*/false),
+      makeInput({f, h}, /*sharded=*/true),
+      makeInput({h, f}, /*sharded=*/true)};
+  runBlockBenchmark(
+      state, shardedMlp, inputs, {{CommunicationType::Allreduce, m * h}});
+}
+
+static void NvFuserScheduler_Multidevice_ShardedAttention(
+    benchmark::State& state) {
+  const int64_t s = state.range(0);
+  const int64_t h = state.range(1);
+  const auto num_devices = getNumDevices(state, {h});
+  if (!num_devices.has_value()) {
+    return;
+  }
+  const int64_t e = h / num_devices.value();
+  std::vector<c10::IValue> inputs = {makeInput({s, h}, /*sharded=*/false)};
+  for (auto i : c10::irange(3)) {
+    (void)i; // Suppress unused variable warning
+    inputs.push_back(makeInput({e, h}, /*sharded=*/true));
+  }
+  inputs.push_back(makeInput({h, e}, /*sharded=*/true));
+  runBlockBenchmark(
+      state,
+      shardedAttention,
+      inputs,
+      {{CommunicationType::Allreduce, s * h}});
+}
+
+static void NvFuserScheduler_Multidevice_SequenceParallelLayerNorm(
+    benchmark::State& state) {
+  const int64_t s = state.range(0);
+  const int64_t h = state.range(1);
+  if (!getNumDevices(state, {s}).has_value()) {
+    return;
+  }
+  runBlockBenchmark(
+      state,
+      [s, h](const DeviceMesh& mesh) {
+        return sequenceParallelLayerNorm(mesh, s, h);
+      },
+      {makeInput({s, h}, /*sharded=*/true)},
+      {{CommunicationType::ReduceScatter, s * h},
+       {CommunicationType::Allgather, s * h}});
+}
+
+BENCHMARK(NvFuserScheduler_Multidevice_ShardedMlp)
+    ->ArgNames({"tokens", "hidden"})
+    ->Args({2048, 1024})
+    ->Args({2048, 4096})
+    ->Iterations(num_iterations)
+    ->Unit(benchmark::kMillisecond)
+    ->UseManualTime();
+
+BENCHMARK(NvFuserScheduler_Multidevice_ShardedAttention)
+    ->ArgNames({"sequence", "hidden"})
+    ->Args({1024, 1024})
+    ->Args({2048, 4096})
+    ->Iterations(num_iterations)
+    ->Unit(benchmark::kMillisecond)
+    ->UseManualTime();
+
+BENCHMARK(NvFuserScheduler_Multidevice_SequenceParallelLayerNorm)
+    ->ArgNames({"sequence", "hidden"})
+    ->Args({2048, 1024})
+    ->Args({8192, 4096})
+    ->Iterations(num_iterations)
+    ->Unit(benchmark::kMillisecond)
+    ->UseManualTime();
+
+namespace {
+
+// Discards the results of the processes of devices other than 0
+class NullReporter : public benchmark::BenchmarkReporter {
+ public:
+  bool ReportContext(const Context&) override {
+    return true;
+  }
+  void ReportRuns(const std::vector<Run>&) override {}
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+
+  Communicator& comm = getCommunicator();
+  if (!comm.is_available()) {
+    std::cerr << "No distributed setup found, run with e.g. mpirun"
+              << std::endl;
+    return 1;
+  }
+  if (comm.deviceId() == 0) {
+    ::benchmark::RunSpecifiedBenchmarks();
+  } else {
+    NullReporter reporter;
+    ::benchmark::RunSpecifiedBenchmarks(&reporter);
+  }
+  ::benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,168 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <benchmarks/cpp/roofline.h>
+
+#include <cuda_utils.h>
+#include <exceptions.h>
+#include <fusion_profiler.h>
+
+#include <cuda_runtime.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+using namespace nvfuser;
+
+namespace {
+
+// Dense half-precision tensor core FLOPs per clock per SM
+double mmaFlopsPerClockPerSm(int major, int minor) {
+  switch (major * 10 + minor) {
+    case 70:
+    case 72:
+    case 75:
+    case 86:
+    case 87:
+    case 89:
+      return 1024.0;
+    case 80:
+      return 2048.0;
+    case 90:
+      return 4096.0;
+    case 100:
+      return 8192.0;
+    default:
+      return 0.0;
+  }
+}
+
+std::string escapeJson(const std::string& str) {
+  std::stringstream ss;
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      ss << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      ss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << (int)c
+         << std::dec;
+    } else {
+      ss << c;
+    }
+  }
+  return ss.str();
+}
+
+double counterValue(
+    const benchmark::UserCounters& counters,
+    const std::string& name) {
+  auto it = counters.find(name);
+  return it == counters.end() ? 0.0 : (double)it->second;
+}
+
+} // namespace
+
+DevicePeaks DevicePeaks::query(int device) {
+  DeviceDescriptor desc;
+  DeviceDescriptor::generate(desc, device);
+
+  cudaDeviceProp prop;
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaGetDeviceProperties(&prop, device));
+  int clock_khz = 0;
+  NVFUSER_CUDA_RT_SAFE_CALL(
+      cudaDeviceGetAttribute(&clock_khz, cudaDevAttrClockRate, device));
+
+  DevicePeaks peaks;
+  peaks.name = prop.name;
+  peaks.dram_bytes_per_second = desc.peak_bandwidth_gbs * 1.0e9;
+  peaks.mma_flops_per_second = mmaFlopsPerClockPerSm(prop.major, prop.minor) *
+      prop.multiProcessorCount * clock_khz * 1.0e3;
+  return peaks;
+}
+
+void setFlopsProcessed(benchmark::State& benchmark_state, int64_t flops) {
+  benchmark_state.counters["flops_per_second"] = benchmark::Counter(
+      (double)flops, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+RooflineReporter::RooflineReporter(
+    std::unique_ptr<benchmark::BenchmarkReporter> display_reporter,
+    std::string out_path,
+    DevicePeaks peaks)
+    : display_reporter_(std::move(display_reporter)),
+      out_path_(std::move(out_path)),
+      peaks_(std::move(peaks)) {
+  NVF_ERROR(display_reporter_ != nullptr);
+}
+
+bool RooflineReporter::ReportContext(const Context& context) {
+  return display_reporter_->ReportContext(context);
+}
+
+void RooflineReporter::ReportRuns(const std::vector<Run>& runs) {
+  display_reporter_->ReportRuns(runs);
+  for (const auto& run : runs) {
+    // Aggregates like the mean of repetitions are derived from the iterations
+    if (run.run_type != Run::RT_Iteration) {
+      continue;
+    }
+    Entry entry;
+    entry.bytes_per_second = counterValue(run.counters, "bytes_per_second");
+    entry.flops_per_second = counterValue(run.counters, "flops_per_second");
+    if (entry.bytes_per_second <= 0.0 && entry.flops_per_second <= 0.0) {
+      continue;
+    }
+    entry.name = run.benchmark_name();
+    entry.real_time = run.GetAdjustedRealTime();
+    entry.time_unit = benchmark::GetTimeUnitString(run.time_unit);
+    if (peaks_.dram_bytes_per_second > 0.0) {
+      entry.pct_peak_bandwidth =
+          entry.bytes_per_second / peaks_.dram_bytes_per_second * 100.0;
+    }
+    if (peaks_.mma_flops_per_second > 0.0) {
+      entry.pct_peak_flops =
+          entry.flops_per_second / peaks_.mma_flops_per_second * 100.0;
+    }
+    entry.pct_sol = std::max(entry.pct_peak_bandwidth, entry.pct_peak_flops);
+    entries_.push_back(std::move(entry));
+  }
+}
+
+void RooflineReporter::Finalize() {
+  display_reporter_->Finalize();
+
+  std::ofstream out(out_path_);
+  NVF_CHECK(out, "Unable to open roofline report ", out_path_);
+  out << std::setprecision(6);
+  out << "{\n";
+  out << "  \"device\": {\n";
+  out << "    \"name\": \"" << escapeJson(peaks_.name) << "\",\n";
+  out << "    \"peak_dram_bytes_per_second\": " << peaks_.dram_bytes_per_second
+      << ",\n";
+  out << "    \"peak_mma_flops_per_second\": " << peaks_.mma_flops_per_second
+      << "\n";
+  out << "  },\n";
+  out << "  \"benchmarks\": [";
+  for (size_t i = 0; i < entries_.size(); ++i) {
+    const auto& entry = entries_.at(i);
+    out << (i == 0 ? "\n" : ",\n");
+    out << "    {\n";
+    out << "      \"name\": \"" << escapeJson(entry.name) << "\",\n";
+    out << "      \"real_time\": " << entry.real_time << ",\n";
+    out << "      \"time_unit\": \"" << entry.time_unit << "\",\n";
+    out << "      \"bytes_per_second\": " << entry.bytes_per_second << ",\n";
+    out << "      \"flops_per_second\": " << entry.flops_per_second << ",\n";
+    out << "      \"pct_peak_bandwidth\": " << entry.pct_peak_bandwidth
+        << ",\n";
+    out << "      \"pct_peak_flops\": " << entry.pct_peak_flops << ",\n";
+    out << "      \"pct_sol\": " << entry.pct_sol << "\n";
+    out << "    }";
+  }
+  out << "\n  ]\n";
+  out << "}\n";
+}
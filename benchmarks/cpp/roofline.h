@@ -0,0 +1,69 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+//! Peak throughputs of a device, which make up its roofline
+struct DevicePeaks {
+  std::string name;
+  //! DRAM bandwidth in bytes per second
+  double dram_bytes_per_second = 0.0;
+  //! Dense half-precision tensor core throughput in FLOPs per second. Zero if
+  //! unknown for the architecture.
+  double mma_flops_per_second = 0.0;
+
+  static DevicePeaks query(int device);
+};
+
+//! Records the FLOPs of one iteration of a benchmark. They are reported as
+//! the flops_per_second counter and compared against the tensor core peak in
+//! the roofline report, so this is meant for matmul-like benchmarks.
+void setFlopsProcessed(benchmark::State& benchmark_state, int64_t flops);
+
+//! A display reporter that forwards to display_reporter and additionally
+//! writes a roofline report to a JSON file once all benchmarks have run.
+//!
+//! For each benchmark run, the report contains the achieved bandwidth and
+//! FLOPs from the bytes_per_second and flops_per_second counters and their
+//! percentages of the device peaks. The percent of speed of light (SOL) is
+//! the achieved fraction of the roofline min(peak FLOPs, arithmetic intensity
+//! * peak bandwidth), which is the larger of the two percentages. Runs that
+//! report neither counter are skipped.
+class RooflineReporter : public benchmark::BenchmarkReporter {
+ public:
+  RooflineReporter(
+      std::unique_ptr<benchmark::BenchmarkReporter> display_reporter,
+      std::string out_path,
+      DevicePeaks peaks);
+
+  bool ReportContext(const Context& context) override;
+  void ReportRuns(const std::vector<Run>& runs) override;
+  void Finalize() override;
+
+ private:
+  struct Entry {
+    std::string name;
+    double real_time = 0.0;
+    std::string time_unit;
+    double bytes_per_second = 0.0;
+    double flops_per_second = 0.0;
+    double pct_peak_bandwidth = 0.0;
+    double pct_peak_flops = 0.0;
+    double pct_sol = 0.0;
+  };
+
+  std::unique_ptr<benchmark::BenchmarkReporter> display_reporter_;
+  const std::string out_path_;
+  const DevicePeaks peaks_;
+  std::vector<Entry> entries_;
+};
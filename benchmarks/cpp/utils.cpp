@@ -8,6 +8,7 @@
 #include <benchmarks/cpp/utils.h>
 #include <c10/cuda/CUDACachingAllocator.h>
 #include <cuda_utils.h>
+#include <instrumentation.h>
 #include <scheduler/all_schedulers.h>
 #include <tests/cpp/utils.h>
 
@@ -161,12 +162,51 @@ int64_t getSizeOfOutputs(const std::vector<at::Tensor>& outputs) {
   }
   return bytes;
 }
+
+bool measure_host_overhead = false;
+
+// The FUSER_PERF_SCOPEs that make up each phase of a cache hit in
+// FusionExecutorCache::runFusionWithInputs. The scopes of a phase don't
+// nest in each other, nor in the scopes of another phase.
+const std::vector<std::pair<std::string, std::vector<std::string>>>&
+hostOverheadPhases() {
+  static const std::vector<std::pair<std::string, std::vector<std::string>>>
+      phases{
+          {"input_id_lookup",
+           {"InputsIdLookup::lookupId",
+            "FusionExecutorCache::getKernelRuntimeFor"}},
+          {"arg_binding",
+           {"KernelArgumentHolder::createKernelArgumentHolder",
+            "FusionExecutor::bindInputs",
+            "Initial GetArgsBuffers",
+            "Recompute GetArgsBuffers"}},
+          {"launch_params",
+           {"FusionKernelRuntime::getKernelConfig",
+            "FusionExecutor::initializeExecutorEntry"}},
+          {"allocation",
+           {"allocateOutputs", "ExecutorRunFusion::IntermediateBufferAlloc"}},
+          {"launch",
+           {"ExecutorRunFusion::cuLaunchKernel",
+            "ExecutorRunFusion::cuLaunchCooperativeKernel",
+            "FusionExecutor::launchDeferred"}},
+      };
+  return phases;
+}
 } // namespace
 
+void setMeasureHostOverhead(bool measure) {
+  measure_host_overhead = measure;
+}
+
 int64_t runBenchmarkIterations(
     benchmark::State& benchmark_state,
     FusionExecutorCache* fusion_executor_cache,
     std::vector<c10::IValue>& aten_inputs) {
+  if (measure_host_overhead) {
+    return runHostOverheadIterations(
+        benchmark_state, fusion_executor_cache, aten_inputs);
+  }
+
   c10::cuda::CUDACachingAllocator::emptyCache();
   fusion_executor_cache->profile(true);
 
@@ -226,6 +266,71 @@ int64_t runBenchmarkIterations(
   return io_bytes;
 }
 
+int64_t runHostOverheadIterations(
+    benchmark::State& benchmark_state,
+    FusionExecutorCache* fusion_executor_cache,
+    std::vector<c10::IValue>& aten_inputs) {
+  using Clock = inst::ScopeTimer::Clock;
+
+  int64_t io_bytes = getSizeOfInputs(aten_inputs);
+
+  // Segment and compile the fusion, and run it once more so that the
+  // measured iterations only hit the caches
+  for (auto i : c10::irange(2)) {
+    auto cg_outputs = fusion_executor_cache->runFusionWithInputs(aten_inputs);
+    if (i == 0) {
+      io_bytes += getSizeOfOutputs(cg_outputs);
+    }
+  }
+  const auto num_runtimes = fusion_executor_cache->countRuntimes();
+
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaDeviceSynchronize());
+
+  inst::ScopeTimer scope_timer;
+  Clock::duration total = Clock::duration::zero();
+  for (auto _ : benchmark_state) {
+    const auto start = Clock::now();
+    auto cg_outputs = fusion_executor_cache->runFusionWithInputs(aten_inputs);
+    const auto elapsed = Clock::now() - start;
+    total += elapsed;
+    benchmark_state.SetIterationTime(
+        std::chrono::duration<double>(elapsed).count());
+    // Don't let the kernels queue up, which would eventually block the
+    // launches. The synchronization is not part of the iteration time.
+    benchmark_state.PauseTiming();
+    cg_outputs.clear();
+    NVFUSER_CUDA_RT_SAFE_CALL(cudaDeviceSynchronize());
+    benchmark_state.ResumeTiming();
+  }
+  NVF_CHECK(
+      fusion_executor_cache->countRuntimes() == num_runtimes,
+      "Host overhead iterations are expected to hit the caches");
+
+  const auto to_us = [](Clock::duration dur) {
+    return std::chrono::duration<double, std::micro>(dur).count();
+  };
+  const auto entries = scope_timer.entries();
+  Clock::duration accounted = Clock::duration::zero();
+  for (const auto& [phase, scopes] : hostOverheadPhases()) {
+    Clock::duration phase_total = Clock::duration::zero();
+    for (const auto& scope : scopes) {
+      auto it = entries.find(scope);
+      if (it != entries.end()) {
+        phase_total += it->second.total;
+      }
+    }
+    accounted += phase_total;
+    benchmark_state.counters[phase + "_us"] = benchmark::Counter(
+        to_us(phase_total), benchmark::Counter::kAvgIterations);
+  }
+  benchmark_state.counters["other_us"] = benchmark::Counter(
+      to_us(total - accounted), benchmark::Counter::kAvgIterations);
+  benchmark_state.counters["host_us"] =
+      benchmark::Counter(to_us(total), benchmark::Counter::kAvgIterations);
+
+  return io_bytes;
+}
+
 int64_t runBenchmarkIterations(
     benchmark::State& benchmark_state,
     FusionExecutor* fusion_executor,
@@ -43,6 +43,22 @@ int64_t runBenchmarkIterations(
     FusionExecutorCache* fusion_executor_cache,
     std::vector<c10::IValue>& aten_inputs);
 
+//! Run benchmark iterations with a fusion executor cache and inputs,
+//! measuring the wall-clock CPU time of runFusionWithInputs on a cache
+//! hit instead of the kernel time. The time is also broken down into
+//! input id lookup, argument binding, launch parameter evaluation,
+//! allocation and launch by the FUSER_PERF_SCOPEs of each phase, which
+//! are added as per-iteration counters in microseconds.
+int64_t runHostOverheadIterations(
+    benchmark::State& benchmark_state,
+    FusionExecutorCache* fusion_executor_cache,
+    std::vector<c10::IValue>& aten_inputs);
+
+//! Makes runBenchmarkIterations with a fusion executor cache measure
+//! the host overhead with runHostOverheadIterations, e.g., with
+//! bin/nvfuser_bench --host_overhead
+void setMeasureHostOverhead(bool measure);
+
 //! Run benchmark iterations with a fusion executor and
 //! inputs. The fusion is assumed to have already been compiled. The
 //! kernel time is added to benchmark_state.
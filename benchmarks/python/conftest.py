@@ -44,6 +44,12 @@ def pytest_addoption(parser):
         help="Number of warmup rounds for each benchmark.",
     )
 
+    parser.addoption(
+        "--benchmark-fusion-profile",
+        action="store_true",
+        help="Stores the nvFuser profile of each fusion segment in the benchmark extra info.",
+    )
+
 
 @pytest.fixture
 def disable_validation(request):
@@ -70,6 +76,9 @@ def pytest_configure(config):
     BENCHMARK_CONFIG["warmup_rounds"] = int(
         config.getoption("--benchmark-warmup-rounds")
     )
+    BENCHMARK_CONFIG["fusion_profile"] = config.getoption(
+        "--benchmark-fusion-profile"
+    )
     config.addinivalue_line(
         "markers",
         "inner_outer_persistent: mark tests using inner_outer_persistent scheduler if not being segmented.",
@@ -9,6 +9,7 @@ from torch.autograd import DeviceType
 from torch.profiler import profile, ProfilerActivity
 from typing import List, Callable, Union, Tuple
 import numpy as np
+from nvfuser import FusionDefinition
 
 
 def get_device_properties() -> Tuple[int, float]:
@@ -308,10 +309,43 @@ class NVFBenchmark:
             100 * (bandwidth_bps / 1024**3) / PEAK_BANDWIDTH_GBPS
         )
 
+    def set_fusion_profile(self, fd, inputs: List) -> None:
+        """
+        Executes the fusion once with the nvFuser profiler and stores the
+        profile of each segment as extra information, e.g. to follow the
+        schedulers and launch parameters of the kernels on dashboards.
+
+        Args:
+            fd: FusionDefinition that was benchmarked
+            inputs: Inputs to the fusion
+        """
+        fd.execute(inputs, profile=True)
+        prof = fd.profile()
+        self.benchmark.extra_info["Compile Time (ms)"] = prof.compile_time_ms
+        self.benchmark.extra_info["Segments"] = [
+            {
+                "name": kp.name,
+                "scheduler": kp.scheduler,
+                "grid": list(kp.grid),
+                "block": list(kp.block),
+                "cluster": list(kp.cluster),
+                "registers": kp.registers,
+                "dynamic_smem_bytes": kp.dynamic_smem_bytes,
+                "static_smem_bytes": kp.static_smem_bytes,
+                "time_ms": kp.time_ms,
+                "input_bytes": kp.input_bytes,
+                "output_bytes": kp.output_bytes,
+                "bandwidth_gbs": kp.effective_bandwidth_gbs,
+                "compile_time_ms": kp.compile_time_ms,
+            }
+            for kp in prof.kernel_profiles
+        ]
+
 
 # These variables can be overwritten through CLI commands
 # --benchmark-rounds=rounds --benchmark-warmup-rounds=warmup_rounds
-BENCHMARK_CONFIG = {"rounds": 10, "warmup_rounds": 1}
+# --benchmark-fusion-profile
+BENCHMARK_CONFIG = {"rounds": 10, "warmup_rounds": 1, "fusion_profile": False}
 
 
 def run_benchmark(
@@ -345,4 +379,58 @@ def run_benchmark(
     )
     nvf_benchmark.set_metrics(inputs, outputs, iobytes)
     nvf_benchmark.cleanup()
+    # Profiling is done after benchmarking as it perturbs the timing
+    fd = getattr(benchmark_fn, "__self__", None)
+    if BENCHMARK_CONFIG["fusion_profile"] and isinstance(fd, FusionDefinition):
+        nvf_benchmark.set_fusion_profile(fd, inputs)
+    return outputs
+
+
+def run_host_benchmark(
+    benchmark: pytest_benchmark.fixture.BenchmarkFixture,
+    benchmark_fn: Callable,
+    setup: Callable = None,
+    fd: FusionDefinition = None,
+    inputs: List = None,
+    calls_per_round: int = 1,
+):
+    """
+    Benchmarks the host latency of the target function with the wall clock
+    timer of pytest-benchmark, unlike run_benchmark which measures CUDA time.
+    The host time per call is stored as extra information, next to the kernel
+    time of the fusion if given.
+
+    Arguments:
+        benchmark: pytest-benchmark fixture
+        benchmark_fn: Target function, which should not synchronize with the
+            GPU unless its GPU work is part of the measured latency
+        setup: Called before each round, returning the args and kwargs of
+            benchmark_fn as pytest-benchmark's pedantic setup
+        fd: FusionDefinition executed by benchmark_fn, whose kernel time is
+            measured with a profiled execution of inputs
+        inputs: Inputs to fd
+        calls_per_round: Number of calls of the measured operation made by
+            each call of benchmark_fn, to report the time per call
+
+    Returns:
+        outputs: Output of the target function
+    """
+    outputs = benchmark.pedantic(
+        benchmark_fn,
+        setup=setup,
+        rounds=BENCHMARK_CONFIG["rounds"],
+        warmup_rounds=BENCHMARK_CONFIG["warmup_rounds"],
+    )
+    torch.cuda.synchronize()
+    benchmark.extra_info["Host Time (us/call)"] = (
+        benchmark.stats["mean"] * 1e6 / calls_per_round
+    )
+    benchmark.extra_info["Calls per Second"] = (
+        calls_per_round / benchmark.stats["mean"]
+    )
+    if fd is not None:
+        fd.execute(inputs, profile=True)
+        benchmark.extra_info["Kernel Time (us/call)"] = (
+            fd.profile().kernel_time_ms * 1e3
+        )
     return outputs
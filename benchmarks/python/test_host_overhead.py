@@ -0,0 +1,176 @@
+# SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+# All rights reserved.
+# SPDX-License-Identifier: BSD-3-Clause
+import itertools
+import pytest
+from concurrent.futures import ThreadPoolExecutor
+from nvfuser import FusionCache, FusionDefinition, DataType
+import torch
+from .core import run_host_benchmark, clear_cuda_cache
+
+# Host overhead is measured on small inputs, so that launches don't wait for
+# the GPU and the kernel time is negligible.
+BATCH_SIZE = 4
+HIDDEN_SIZE = 1024
+
+# Sequence lengths of requests that change from one call to the next
+SEQ_LENS = [17, 128, 255, 256, 500, 1000, 1023, 1024]
+
+
+def pointwise_chain_fusion(fd: FusionDefinition, num_ops: int) -> None:
+    T0 = fd.define_tensor(
+        shape=[-1, -1], contiguity=[True, True], dtype=DataType.Float, is_cpu=False
+    )
+    S0 = fd.define_scalar(1.0001)
+    T1 = T0
+    for _ in range(num_ops):
+        T1 = fd.ops.mul(T1, S0)
+    fd.add_output(T1)
+
+
+def normalization_fusion(fd: FusionDefinition) -> None:
+    """A softmax over the last dimension, which needs a reduction scheduler."""
+    T0 = fd.define_tensor(
+        shape=[-1, -1, -1],
+        contiguity=[True, True, True],
+        dtype=DataType.Float,
+        is_cpu=False,
+    )
+    T1 = fd.ops.max(T0, dims=[2], keepdim=True)
+    T2 = fd.ops.sub(T0, T1)
+    T3 = fd.ops.exp(T2)
+    T4 = fd.ops.sum(T3, dims=[2], keepdim=True)
+    T5 = fd.ops.div(T3, T4)
+    fd.add_output(T5)
+
+
+@pytest.mark.parametrize("num_ops", [1, 16, 64])
+def test_cache_hit_host_benchmark(
+    benchmark,
+    num_ops: int,
+    disable_benchmarking: bool,
+):
+    """Host latency of executing an already compiled fusion."""
+    clear_cuda_cache()
+
+    inputs = [torch.randn(BATCH_SIZE, HIDDEN_SIZE, device="cuda")]
+    with FusionDefinition() as fd:
+        pointwise_chain_fusion(fd, num_ops)
+    fd.execute(inputs)
+
+    if not disable_benchmarking:
+        run_host_benchmark(
+            benchmark,
+            fd.execute,
+            setup=lambda: ([inputs], {}),
+            fd=fd,
+            inputs=inputs,
+        )
+
+
+def test_first_call_host_benchmark(
+    benchmark,
+    disable_benchmarking: bool,
+):
+    """Host latency of defining, segmenting, scheduling and compiling a fusion
+    and executing it once."""
+    clear_cuda_cache()
+
+    inputs = [torch.randn(BATCH_SIZE, 128, HIDDEN_SIZE, device="cuda")]
+
+    def setup():
+        # Drops the definitions and compiled kernels of previous rounds
+        FusionCache.reset()
+        return [], {}
+
+    def first_call():
+        with FusionDefinition() as fd:
+            normalization_fusion(fd)
+        outputs = fd.execute(inputs)
+        torch.cuda.synchronize()
+        return outputs
+
+    if not disable_benchmarking:
+        run_host_benchmark(benchmark, first_call, setup=setup)
+
+
+@pytest.mark.parametrize("dynamic", [True, False], ids=["dynamic", "static"])
+def test_seq_len_churn_host_benchmark(
+    benchmark,
+    dynamic: bool,
+    disable_benchmarking: bool,
+):
+    """Host latency of executing a fusion with a sequence length that changes
+    on every call. Dynamic definitions reuse their kernels across sequence
+    lengths when the heuristics allow it, static definitions compile a fusion
+    for each of them once."""
+    clear_cuda_cache()
+
+    inputs_per_seq_len = [
+        [torch.randn(BATCH_SIZE, seq_len, HIDDEN_SIZE, device="cuda")]
+        for seq_len in SEQ_LENS
+    ]
+
+    def execute(inputs):
+        if dynamic:
+            fd = dynamic_fd
+        else:
+            with FusionDefinition() as fd:
+                T0 = fd.from_pytorch(inputs[0], static_sizes=True)
+                T1 = fd.ops.exp(T0)
+                fd.add_output(fd.ops.sum(T1, dims=[2]))
+        return fd.execute(inputs)
+
+    with FusionDefinition() as dynamic_fd:
+        T0 = dynamic_fd.from_pytorch(inputs_per_seq_len[0][0])
+        T1 = dynamic_fd.ops.exp(T0)
+        dynamic_fd.add_output(dynamic_fd.ops.sum(T1, dims=[2]))
+
+    # Every sequence length has been seen before the timed rounds
+    for inputs in inputs_per_seq_len:
+        execute(inputs)
+
+    seq_len_inputs = itertools.cycle(inputs_per_seq_len)
+    if not disable_benchmarking:
+        run_host_benchmark(
+            benchmark,
+            execute,
+            setup=lambda: ([next(seq_len_inputs)], {}),
+        )
+
+
+@pytest.mark.parametrize("num_threads", [1, 2, 4, 8])
+def test_multithread_dispatch_host_benchmark(
+    benchmark,
+    num_threads: int,
+    disable_benchmarking: bool,
+):
+    """Throughput of executing compiled fusions from several python threads,
+    each with its own fusion."""
+    clear_cuda_cache()
+
+    calls_per_thread = 100
+    inputs = [torch.randn(BATCH_SIZE, HIDDEN_SIZE, device="cuda")]
+    fds = []
+    for num_ops in range(1, num_threads + 1):
+        with FusionDefinition() as fd:
+            pointwise_chain_fusion(fd, num_ops)
+        fd.execute(inputs)
+        fds.append(fd)
+
+    def dispatch(fd):
+        for _ in range(calls_per_thread):
+            fd.execute(inputs)
+
+    with ThreadPoolExecutor(max_workers=num_threads) as pool:
+
+        def dispatch_all():
+            for future in [pool.submit(dispatch, fd) for fd in fds]:
+                future.result()
+
+        if not disable_benchmarking:
+            run_host_benchmark(
+                benchmark,
+                dispatch_all,
+                calls_per_round=num_threads * calls_per_thread,
+            )
@@ -0,0 +1,142 @@
+# SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+# All rights reserved.
+# SPDX-License-Identifier: BSD-3-Clause
+"""
+Fits the weights of the analytical matmul heuristic model, which is enabled
+with NVFUSER_ENABLE=matmul_heuristic_model, to the problems of
+matmul_problems.csv.
+
+Each combination of the given weight values is measured in a separate process,
+since nvFuser reads its options once per process. The problems are defined as
+mul-sum fusions of TN operands, which are scheduled by the matmul scheduler.
+
+Usage:
+  python tune_matmul_heuristic_model.py --max-problems 200 \
+      --weight flops_per_byte=100,150,200 --weight l2_reuse=0.6,0.8,0.95
+"""
+
+import argparse
+import csv
+import itertools
+import json
+import math
+import os
+import random
+import subprocess
+import sys
+
+
+def load_matmul_problems():
+    with open(os.path.join(os.path.dirname(__file__), "matmul_problems.csv"), "r") as f:
+        reader = csv.reader(f)
+        next(reader, None)  # skip header row
+        return list((int(m), int(n), int(k), layout) for m, n, k, layout in reader)
+
+
+def measure(problems, num_iters):
+    import torch
+    from nvfuser import FusionDefinition, DataType
+
+    times = []
+    for m, n, k, _ in problems:
+        a = torch.randn(m, k, device="cuda", dtype=torch.float16)
+        b = torch.randn(n, k, device="cuda", dtype=torch.float16)
+        with FusionDefinition() as fd:
+            t0 = fd.from_pytorch(a)
+            t1 = fd.from_pytorch(b)
+            t2 = fd.ops.broadcast_in_dim(t0, [m, n, k], [0, 2])
+            t3 = fd.ops.broadcast_in_dim(t1, [m, n, k], [1, 2])
+            t4 = fd.ops.sum(fd.ops.mul(t2, t3), [2])
+            fd.add_output(fd.ops.cast(t4, DataType.Half))
+        fd.execute([a, b])
+        start = torch.cuda.Event(enable_timing=True)
+        end = torch.cuda.Event(enable_timing=True)
+        start.record()
+        for _ in range(num_iters):
+            fd.execute([a, b])
+        end.record()
+        torch.cuda.synchronize()
+        times.append(start.elapsed_time(end) / num_iters)
+    return times
+
+
+def run_weights(weights, problems_file, num_iters):
+    env = dict(os.environ)
+    args = ",".join(f"{key}={value}" for key, value in weights.items())
+    option = "matmul_heuristic_model"
+    if args:
+        option += f"({args})"
+    env["NVFUSER_ENABLE"] = ",".join(
+        filter(None, [env.get("NVFUSER_ENABLE"), option])
+    )
+    env["NVFUSER_DISABLE"] = ",".join(
+        filter(None, [env.get("NVFUSER_DISABLE"), "matmul_expr_eval"])
+    )
+    result = subprocess.run(
+        [
+            sys.executable,
+            __file__,
+            "--worker",
+            problems_file,
+            "--iters",
+            str(num_iters),
+        ],
+        env=env,
+        check=True,
+        capture_output=True,
+        text=True,
+    )
+    return option, json.loads(result.stdout.splitlines()[-1])
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument(
+        "--weight",
+        action="append",
+        default=[],
+        help="A weight of the model and its candidate values, e.g. l2_reuse=0.8,0.9",
+    )
+    parser.add_argument("--max-problems", type=int, default=100)
+    parser.add_argument("--iters", type=int, default=10)
+    parser.add_argument("--seed", type=int, default=0)
+    parser.add_argument("--worker", help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.worker is not None:
+        with open(args.worker, "r") as f:
+            problems = json.load(f)
+        print(json.dumps(measure(problems, args.iters)))
+        return
+
+    problems = load_matmul_problems()
+    random.Random(args.seed).shuffle(problems)
+    problems = problems[: args.max_problems]
+    problems_file = os.path.join(
+        os.environ.get("TMPDIR", "/tmp"), "nvfuser_matmul_tuning_problems.json"
+    )
+    with open(problems_file, "w") as f:
+        json.dump(problems, f)
+
+    keys = []
+    values = []
+    for weight in args.weight:
+        key, _, candidates = weight.partition("=")
+        keys.append(key)
+        values.append(candidates.split(","))
+
+    best = None
+    for combination in itertools.product(*values):
+        option, times = run_weights(
+            dict(zip(keys, combination)), problems_file, args.iters
+        )
+        # The geometric mean weighs all problems equally regardless of size
+        geomean = math.exp(sum(math.log(t) for t in times) / len(times))
+        print(f"{option}: geometric mean {geomean:.4f} ms")
+        if best is None or geomean < best[1]:
+            best = (option, geomean)
+    print(f"Best: NVFUSER_ENABLE={best[0]}")
+
+
+if __name__ == "__main__":
+    main()
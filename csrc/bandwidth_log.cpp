@@ -0,0 +1,115 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <bandwidth_log.h>
+#include <fusion_profiler.h>
+#include <options.h>
+
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace nvfuser {
+
+namespace {
+
+void writeJsonString(std::ostream& os, const std::string& value) {
+  os << "\"";
+  for (const char c : value) {
+    switch (c) {
+      case '"':
+        os << "\\\"";
+        break;
+      case '\\':
+        os << "\\\\";
+        break;
+      case '\n':
+        os << "\\n";
+        break;
+      case '\t':
+        os << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          os << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+             << (int)c << std::dec << std::setfill(' ');
+        } else {
+          os << c;
+        }
+    }
+  }
+  os << "\"";
+}
+
+} // namespace
+
+std::string toJsonLine(
+    const SegmentBandwidth& record,
+    double peak_bandwidth_gbs) {
+  const double gbs = record.time_ms > 0.0
+      ? (double)record.actual_bytes / ((double)record.time_ms * 1.0e6)
+      : 0.0;
+  const double pct_peak =
+      peak_bandwidth_gbs > 0.0 ? gbs / peak_bandwidth_gbs * 100.0 : 0.0;
+
+  std::stringstream line;
+  line << std::setprecision(6);
+  line << "{\"fusion_id\":" << record.fusion_id
+       << ",\"segment_id\":" << record.segment_id << ",\"kernel\":";
+  writeJsonString(line, record.kernel_name);
+  line << ",\"heuristic\":";
+  writeJsonString(line, record.heuristic);
+  line << ",\"device\":" << record.device << ",\"time_ms\":" << record.time_ms
+       << ",\"actual_bytes\":" << record.actual_bytes
+       << ",\"ideal_bytes\":" << record.ideal_bytes << ",\"gbs\":" << gbs
+       << ",\"peak_gbs\":" << peak_bandwidth_gbs
+       << ",\"pct_peak\":" << pct_peak << ",\"params\":";
+  writeJsonString(line, record.params);
+  line << "}";
+  return line.str();
+}
+
+void recordSegmentBandwidth(const SegmentBandwidth& record) {
+  if (!isOptionEnabled(EnableOption::BandwidthLog)) {
+    return;
+  }
+  const auto& args = getEnableOptionArguments(EnableOption::BandwidthLog);
+  NVF_CHECK(
+      !args.empty(), "NVFUSER_ENABLE=bandwidth_log needs the path of the log");
+
+  static std::mutex log_mutex;
+  static std::string log_path;
+  static std::ofstream log;
+  // The peak bandwidth of each device, queried once
+  static std::vector<DeviceDescriptor> devices;
+  std::lock_guard<std::mutex> guard(log_mutex);
+  if (log_path != args.at(0)) {
+    log.close();
+    log.clear();
+    log.open(args.at(0), std::ios::app);
+    log_path = args.at(0);
+  }
+
+  double peak_bandwidth_gbs = 0.0;
+  if (record.device >= 0) {
+    if ((size_t)record.device >= devices.size()) {
+      devices.resize(record.device + 1);
+    }
+    DeviceDescriptor& desc = devices.at(record.device);
+    if (desc.device != record.device) {
+      DeviceDescriptor::generate(desc, record.device);
+    }
+    peak_bandwidth_gbs = desc.peak_bandwidth_gbs;
+  }
+
+  NVF_CHECK(log.good(), "Could not write the bandwidth log ", args.at(0));
+  log << toJsonLine(record, peak_bandwidth_gbs) << "\n" << std::flush;
+}
+
+} // namespace nvfuser
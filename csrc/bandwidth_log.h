@@ -0,0 +1,56 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+#include <exceptions.h>
+#include <visibility.h>
+
+#include <cstdint>
+#include <string>
+
+namespace nvfuser {
+
+//! \struct SegmentBandwidth
+//! \brief The memory traffic of one kernel launch of a segment, as written to
+//! the bandwidth log.
+//!
+//! With NVFUSER_ENABLE=bandwidth_log(<path>), every segment run appends a JSON
+//! object per line to the log, e.g.
+//!
+//!   {"fusion_id":0,"segment_id":1,"kernel":"nvfuser_reduction_f0_c1_r0_g1",
+//!    "heuristic":"reduction","device":0,"time_ms":0.021,
+//!    "actual_bytes":8388608,"ideal_bytes":4194304,"gbs":399.4,
+//!    "peak_gbs":2039.0,"pct_peak":19.6,"params":"..."}
+//!
+//! actual_bytes are the bytes of all the tensors the segment reads and
+//! writes, while ideal_bytes only count the inputs and outputs of the
+//! complete fusion. The difference is the traffic of the intermediates passed
+//! between segments.
+struct SegmentBandwidth {
+  int64_t fusion_id = -1;
+  int64_t segment_id = -1;
+  std::string kernel_name;
+  std::string heuristic;
+  //! HeuristicParams::toString() of the segment
+  std::string params;
+  int device = -1;
+  float time_ms = 0.0;
+  int64_t actual_bytes = 0;
+  int64_t ideal_bytes = 0;
+};
+
+//! Formats record as a line of the bandwidth log. The achieved and the peak
+//! bandwidths of the device are given in GB/s.
+NVF_API std::string toJsonLine(
+    const SegmentBandwidth& record,
+    double peak_bandwidth_gbs);
+
+//! Appends record to the bandwidth log if EnableOption::BandwidthLog is
+//! enabled. Thread-safe.
+void recordSegmentBandwidth(const SegmentBandwidth& record);
+
+} // namespace nvfuser
@@ -18,6 +18,7 @@
 
 #include <array>
 #include <cmath>
+#include <optional>
 #include <sstream>
 #include <typeindex>
 #include <vector>
@@ -152,6 +153,47 @@ std::string genReinterpretCast(const CastType& type, const ArgType& arg) {
   return genCall("reinterpret_cast", type, arg);
 }
 
+//! Returns the phase of expr timed by NVFUSER_ENABLE=kernel_profile(phases),
+//! or nullopt if expr is a scope or generates no instructions
+std::optional<kir::KernelPhase> getKernelPhase(const Expr* expr) {
+  if (expr->isOneOf<
+          kir::ForLoop,
+          kir::IfThenElse,
+          kir::Allocate,
+          kir::AllocateFusedReduction>()) {
+    return std::nullopt;
+  }
+  if (expr->isOneOf<
+          kir::GridSync,
+          kir::BlockSerializeWait,
+          kir::BlockSerializeRelease,
+          kir::GridBroadcast>()) {
+    return kir::KernelPhase::GridSync;
+  }
+  if (expr->isOneOf<
+          ReductionOp,
+          GroupedReductionOp,
+          WelfordOp,
+          GroupedWelfordOp,
+          kir::GridReduction,
+          kir::GroupedGridReduction,
+          kir::GridWelford,
+          kir::GroupedGridWelford>()) {
+    return kir::KernelPhase::Reduction;
+  }
+  auto is_global = [](const Val* val) {
+    auto ti = dynamic_cast<const kir::TensorIndex*>(val);
+    return ti != nullptr && ti->view()->getMemoryType() == MemoryType::Global;
+  };
+  if (std::any_of(expr->outputs().begin(), expr->outputs().end(), is_global)) {
+    return kir::KernelPhase::Store;
+  }
+  if (std::any_of(expr->inputs().begin(), expr->inputs().end(), is_global)) {
+    return kir::KernelPhase::Load;
+  }
+  return kir::KernelPhase::Compute;
+}
+
 class CudaKernelGenerator : private kir::ConstIrVisitor {
   static constexpr const char* kTab = "  ";
 
@@ -169,6 +211,61 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
     return codegen.code_.str();
   }
 
+  static std::string generateHorizontalKernelDefinition(
+      const std::vector<const kir::Kernel*>& kernels,
+      const std::vector<std::string>& function_names,
+      const std::string& kernel_name) {
+    NVF_ERROR(kernels.size() == function_names.size());
+    std::stringstream code;
+    std::vector<std::vector<std::pair<std::string, std::string>>> params;
+    for (auto i : c10::irange(kernels.size())) {
+      CudaKernelGenerator codegen(kernels[i]);
+      params.push_back(
+          codegen.genDeviceFunctionDeclaration(function_names[i]));
+      codegen.startBlock();
+      codegen.genPrologue();
+      codegen.genBody();
+      codegen.endBlock();
+      NVF_CHECK(codegen.block_nest_level_ == 0);
+      code << codegen.code_.str() << "\n";
+    }
+
+    // The parameters of all kernels, followed by the grid of each kernel
+    auto prefix = [](size_t i) { return "k" + std::to_string(i) + "_"; };
+    code << "__global__ void " << kernel_name << "(";
+    for (auto i : c10::irange(kernels.size())) {
+      for (const auto& [type, name] : params[i]) {
+        code << type << " " << prefix(i) << name << ", ";
+      }
+    }
+    for (auto i : c10::irange(kernels.size())) {
+      code << "const dim3 " << prefix(i) << "grid_dim"
+           << (i + 1 != kernels.size() ? ", " : "");
+    }
+    code << ") {\n";
+    // Consecutive ranges of the blocks run each kernel. Blocks are
+    // linearized in the same order as the hardware does.
+    code << kTab << "unsigned int block = blockIdx.x;\n";
+    for (auto i : c10::irange(kernels.size())) {
+      const std::string grid = prefix(i) + "grid_dim";
+      code << kTab << "if (block < " << grid << ".x * " << grid << ".y * "
+           << grid << ".z) {\n";
+      code << kTab << kTab << function_names[i] << "(dim3(block % " << grid
+           << ".x, block / " << grid << ".x % " << grid << ".y, block / ("
+           << grid << ".x * " << grid << ".y)), " << grid;
+      for (const auto& param : params[i]) {
+        code << ", " << prefix(i) << param.second;
+      }
+      code << ");\n";
+      code << kTab << kTab << "return;\n";
+      code << kTab << "}\n";
+      code << kTab << "block -= " << grid << ".x * " << grid << ".y * "
+           << grid << ".z;\n";
+    }
+    code << "}\n";
+    return code.str();
+  }
+
  private:
   explicit CudaKernelGenerator(const kir::Kernel* kernel) : kernel_(kernel) {
     initStringStreamFormat(code_);
@@ -267,20 +364,15 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
     }
   }
 
-  // Generates the kernel function declaration
-  void genDeclaration(const std::string& kernel_name) {
-    code_ << "__global__ void " << kernel_name << "(";
-
+  // Generates the type and name of each kernel parameter
+  std::vector<std::pair<std::string, std::string>> genParameters() {
     std::unordered_set<Val*> unique_args;
+    std::vector<std::pair<std::string, std::string>> params;
 
-    std::vector<Val*> params;
-
-    // Generate parameter declarations
     kernel_params_.reserve(kernel_->parameters().size());
     unsigned int duplicate_counter = 0;
-    for (auto i : c10::irange(kernel_->parameters().size())) {
+    for (auto param : kernel_->parameters()) {
       std::stringstream var_name_ss;
-      auto param = kernel_->parameters().at(i);
       kernel_params_.insert(param);
 
       if (param->isA<TensorView>()) {
@@ -295,45 +387,85 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
         var_name_ss << "_duplicate_" << duplicate_counter++;
       }
 
+      std::stringstream type_ss;
       if (const auto tv = dynamic_cast<TensorView*>(param)) {
         if (tv->isCpuScalar()) {
-          code_ << " CpuScalarTensor<" << param->dtype() << "> "
-                << var_name_ss.str();
+          type_ss << " CpuScalarTensor<" << param->dtype() << ">";
         } else {
-          code_
+          type_ss
               << "Tensor<" << param->dtype() << ", "
               << TensorDomain::noReductions(tv->getMaybeRFactorDomain()).size()
               << ", "
               << TensorDomain::noReductions(tv->getMaybeAllocationDomain())
                      .size()
-              << "> " << var_name_ss.str();
+              << ">";
         }
       } else {
         NVF_ERROR(param->isScalar()); // NOLINT (LLVM bug 48525)
         if (isTmaType(param->dtype())) {
-          code_ << "const __grid_constant__ " << param->dtype() << " "
-                << var_name_ss.str();
+          type_ss << "const __grid_constant__ " << param->dtype();
         } else {
-          code_ << param->dtype() << " " << var_name_ss.str();
+          type_ss << param->dtype();
         }
       }
+      params.emplace_back(type_ss.str(), var_name_ss.str());
+    }
+    return params;
+  }
 
-      if (i + 1 != kernel_->parameters().size()) {
+  // Generates the kernel function declaration
+  void genDeclaration(const std::string& kernel_name) {
+    code_ << "__global__ void ";
+    const auto& cluster_dims = kernel_->summary().cluster_dims;
+    if (kernel_->summary().hasClusters()) {
+      code_ << "__cluster_dims__(" << cluster_dims[0] << ", "
+            << cluster_dims[1] << ", " << cluster_dims[2] << ") ";
+    }
+    if (kernel_->summary().min_blocks_per_sm > 0) {
+      // Defined by executor_utils for the block size the kernel is compiled
+      // for
+      code_ << "__launch_bounds__(NVFUSER_MAX_THREADS_PER_BLOCK, "
+            << "NVFUSER_MIN_BLOCKS_PER_SM) ";
+    }
+    code_ << kernel_name << "(";
+    const auto params = genParameters();
+    for (auto i : c10::irange(params.size())) {
+      code_ << params[i].first << " " << params[i].second;
+      if (i + 1 != params.size()) {
         code_ << ", ";
       }
     }
+    code_ << ") ";
+  }
 
+  // Generates the declaration of a device function running the kernel on
+  // the given blockIdx and gridDim, which shadow the builtin variables.
+  // Returns the parameters of the kernel.
+  std::vector<std::pair<std::string, std::string>> genDeviceFunctionDeclaration(
+      const std::string& function_name) {
+    code_ << "__device__ void " << function_name
+          << "(const dim3 blockIdx, const dim3 gridDim";
+    auto params = genParameters();
+    for (const auto& [type, name] : params) {
+      code_ << ", " << type << " " << name;
+    }
     code_ << ") ";
+    return params;
   }
 
   // Generates setup code which is executed before the kernel body
   void genPrologue() {
     const auto& kernel_summary = kernel_->summary();
 
-    if (kernel_summary.has_philox_op) {
-      indent() << "uint4 rng_result;\n";
-      indent() << "nvfuser_index_t rng_subseq = -1;\n";
-      indent() << "nvfuser_index_t rng_offset = -1;\n";
+    // Each RNG op keeps the 4 random numbers of its latest philox call, so
+    // that consecutive elements computed by a thread reuse them even when
+    // the ops are interleaved
+    for (auto rop : kernel_summary.rng_ops) {
+      indent() << "uint4 rng_result" << rop->name() << ";\n";
+      indent() << "nvfuser_index_t rng_cached_subseq" << rop->name()
+               << " = -1;\n";
+      indent() << "nvfuser_index_t rng_cached_offset" << rop->name()
+               << " = -1;\n";
     }
 
     // Do we have any dynamic shared memory buffers?
@@ -404,12 +536,35 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
   // non-const Expr*.
   void handle(const std::vector<Expr*>& exprs) {
     for (Expr* expr : exprs) {
-      kir::ConstIrVisitor::dispatch(expr);
+      dispatch(expr);
+    }
+  }
+
+  using kir::ConstIrVisitor::dispatch;
+
+  void dispatch(const Expr* expr) final {
+    kir::ConstIrVisitor::dispatch(expr);
+    // Attribute the cycles since the previous expression to the phase of
+    // expr, unless expr is generated inline by gen
+    if (profile_phases_ && gen_nest_level_ == 0) {
+      if (auto phase = getKernelPhase(expr); phase.has_value()) {
+        indent() << "phase_timer.mark(" << (int)phase.value() << ");\n";
+      }
     }
   }
 
   void genBody() {
+    const auto& profile = kernel_->profile();
+    profile_phases_ =
+        isOptionEnabled(EnableOption::KernelProfile) && profile.hasPhases();
+    if (profile_phases_) {
+      indent() << "PhaseTimer<" << kir::kNumKernelPhases << "> phase_timer;\n";
+    }
     handle(kernel_->topLevelExprs());
+    if (profile_phases_) {
+      indent() << "phase_timer.flush(&" << genVariableName(profile.getBuffer())
+               << "[" << profile.getPhaseIndexInProfileBuffer() << "]);\n";
+    }
   }
 
   void startBlock(bool continuation = false) {
@@ -469,7 +624,9 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
     std::stringstream tmp_code;
     initStringStreamFormat(tmp_code);
     std::swap(tmp_code, code_);
+    ++gen_nest_level_;
     dispatch(stmt);
+    --gen_nest_level_;
     std::swap(tmp_code, code_);
     return tmp_code.str();
   }
@@ -745,6 +902,9 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
         code_ << "std::bit_cast<" << uop->out()->dtype() << ">";
       } else if (op_type == UnaryOpType::RefCast) {
         code_ << "(*reinterpret_cast<" << uop->out()->dtype() << "*>(&";
+      } else if (
+          uop->isApproximate() && uop->out()->dtype() == DataType::Float) {
+        code_ << approx_func_str(op_type).value();
       } else {
         code_ << op_type;
         if (needFloatSuffix(op_type) &&
@@ -777,20 +937,24 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
              << " = linear_index" << rop->name() << " % " << multiple << ";\n";
     indent() << "nvfuser_index_t rng_offset" << rop->name() << " = "
              << genInline(rop->getRNGOffsetVal()) << ";\n";
-    indent() << "if (rng_subseq != rng_subseq" << rop->name()
-             << " || rng_offset != rng_offset" << rop->name() << ") {\n";
-    indent() << "  rng_result = philox(" << genInline(rop->getRNGSeedVal())
-             << ", rng_subseq" << rop->name() << ", "
+    indent() << "if (rng_cached_subseq" << rop->name() << " != rng_subseq"
+             << rop->name() << " || rng_cached_offset" << rop->name()
+             << " != rng_offset" << rop->name() << ") {\n";
+    indent() << "  rng_result" << rop->name() << " = philox("
+             << genInline(rop->getRNGSeedVal()) << ", rng_subseq"
+             << rop->name() << ", "
              << "rng_offset" << rop->name() << ");\n";
-    indent() << "  rng_subseq = rng_subseq" << rop->name() << ";\n";
-    indent() << "  rng_offset = rng_offset" << rop->name() << ";\n";
+    indent() << "  rng_cached_subseq" << rop->name() << " = rng_subseq"
+             << rop->name() << ";\n";
+    indent() << "  rng_cached_offset" << rop->name() << " = rng_offset"
+             << rop->name() << ";\n";
     indent() << "}\n";
     auto op_type = rop->getRNGOpType();
     indent() << gen(rop->output(0)) << " = " << op_type;
     if (needFloatSuffix(op_type) && rop->dtype() == DataType::Float) {
       code_ << "f";
     }
-    code_ << "(rng_result, rng_component" << rop->name();
+    code_ << "(rng_result" << rop->name() << ", rng_component" << rop->name();
     switch (op_type) {
       case RNGOpType::UniformRange: {
         auto parameters = rop->getParameters();
@@ -1081,6 +1245,11 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
       // When value of index_tv are not unique, the behavior of Set is
       // non-deterministic
       indent() << gen(sop->output(0)) << " = " << gen(sop->input(2)) << ";\n";
+    } else if (sop->getScatterOpType() == ScatterOpType::Add) {
+      // Duplicate indices accumulate into the same element. The output is
+      // initialized from self by the executor before the launch.
+      indent() << "atomicAdd(&" << gen(sop->output(0)) << ", "
+               << gen(sop->input(2)) << ");\n";
     } else {
       NVF_ERROR(false, "unkown scatterOp");
     }
@@ -1141,15 +1310,42 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
     return;
   }
 
+  // The redux.sync operation of the runtime warp reduction, which is only
+  // available for 32-bit integers
+  std::string genReduxOp(BinaryOpType op_type, DataType data_type) {
+    if (data_type != DataType::Int32) {
+      return "warp::ReduxOp::None";
+    }
+    switch (op_type) {
+      case BinaryOpType::Add:
+        return "warp::ReduxOp::Add";
+      case BinaryOpType::Min:
+        return "warp::ReduxOp::Min";
+      case BinaryOpType::Max:
+        return "warp::ReduxOp::Max";
+      case BinaryOpType::BitwiseAnd:
+        return "warp::ReduxOp::And";
+      case BinaryOpType::BitwiseOr:
+        return "warp::ReduxOp::Or";
+      case BinaryOpType::BitwiseXor:
+        return "warp::ReduxOp::Xor";
+      default:
+        return "warp::ReduxOp::None";
+    }
+  }
+
   void genWarpReduction(
       const kir::TensorIndex* output,
       const kir::TensorIndex* input,
       const Val* init,
       BinaryOpType reduction_op_type,
-      kir::Predicate* read_pred) {
+      kir::Predicate* read_pred,
+      bool is_allreduce = false) {
     ArgumentBuilder template_args;
     template_args.arg(kernel_->getWarpPaddedParallelInfo().is_tidx_single_warp);
     template_args.arg(isAligned());
+    template_args.arg(is_allreduce);
+    template_args.arg(genReduxOp(reduction_op_type, output->dtype()));
 
     ArgumentBuilder func_args;
     func_args.arg(gen(output));
@@ -1229,7 +1425,13 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
       genSerialReduction(output, input, op_type);
     } else if (
         auto reduction_id = ir_utils::getMaybeWarpReductionDim(output, input)) {
-      genWarpReduction(output, input, rop->init(), op_type, rop->predicate());
+      genWarpReduction(
+          output,
+          input,
+          rop->init(),
+          op_type,
+          rop->predicate(),
+          rop->isAllreduce());
     } else {
       genBlockReduction(
           output,
@@ -1442,8 +1644,19 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
         par_domains.find(ParallelType::TIDz) != par_domains.end() &&
         par_domains.at(ParallelType::TIDz)->isReduction();
 
+    // Welfords over TIDx padded to warps combine the triplets with shuffles
+    const bool is_warp_welford = !has_grid_reduce &&
+        wop->writePredicate() == nullptr &&
+        ir_utils::getMaybeWarpReductionDim(wop->outAvg(), wop->inAvg())
+            .has_value();
+
     ArgumentBuilder template_args;
-    template_args.arg(tidx).arg(tidy).arg(tidz);
+    if (is_warp_welford) {
+      template_args.arg(
+          kernel_->getWarpPaddedParallelInfo().is_tidx_single_warp);
+    } else {
+      template_args.arg(tidx).arg(tidy).arg(tidz);
+    }
     template_args.arg(isAligned());
 
     ArgumentBuilder func_args;
@@ -1471,7 +1684,11 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
     }
     func_args.arg(genStaticCast(data_type, 0));
 
-    indent() << genCall("blockWelford", template_args, func_args) << ";\n";
+    indent() << genCall(
+                    is_warp_welford ? "warp::warpWelfordTIDX" : "blockWelford",
+                    template_args,
+                    func_args)
+             << ";\n";
   }
 
   void handle(const WelfordOp* wop) final {
@@ -1529,6 +1746,13 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
     func_args.arg(gen(out_var));
     func_args.arg(gen(out_N));
     func_args.arg(gen(in_avg));
+    // Partial states are combined with their var and count
+    if (!wop->inVar()->isZeroInt() || !wop->inN()->isOneInt()) {
+      func_args.arg(gen(wop->inVar()));
+      std::stringstream in_N_ss;
+      in_N_ss << "(" << out_avg->dtype() << ")" << gen(wop->inN());
+      func_args.arg(in_N_ss.str());
+    }
     func_args.arg(gen(wop->reciprocalOfCount()));
     func_args.arg(gen(wop->count()));
     if (is_predicated) {
@@ -1629,6 +1853,11 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
       return;
     }
 
+    if (grop->isAtomic()) {
+      generateAtomicGridReduction(grop);
+      return;
+    }
+
     NVF_ERROR(grop->reduction_buffer()->buffer()->isA<TensorView>());
     NVF_ERROR(grop->sync_buffer()->buffer()->isA<TensorView>());
     const auto work_buffer =
@@ -1676,10 +1905,41 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
 
     addProfileArguments(func_args, grop);
 
-    indent() << "reduction::gridReduce<" << template_args << ">(\n";
+    const std::string func_name = useClusterReduction(grop)
+        ? "reduction::clusterGridReduce"
+        : "reduction::gridReduce";
+    indent() << func_name << "<" << template_args << ">(\n";
     indent() << kTab << func_args << ");\n";
   }
 
+  // Grid reductions reduce through the distributed shared memory of thread
+  // block clusters when the blocks of each cluster are all reduced together,
+  // i.e., the clusters are only larger than one block along the reduced
+  // dimensions. Profiled reductions keep using gridReduce, which measures
+  // its cycles.
+  bool useClusterReduction(const kir::GridReduction* grop) const {
+    const auto& kernel_summary = kernel_->summary();
+    if (!kernel_summary.hasClusters()) {
+      return false;
+    }
+    if (isOptionEnabled(EnableOption::KernelProfile) &&
+        kernel_->profile().isProfiled(grop)) {
+      return false;
+    }
+    const auto par_domains =
+        ir_utils::getParallelDomains(ir_utils::getTvOutput(grop));
+    for (const auto i : c10::irange(kParallelTypeBIDs.size())) {
+      if (kernel_summary.cluster_dims.at(i) == 1) {
+        continue;
+      }
+      const auto it = par_domains.find(kParallelTypeBIDs.at(i));
+      if (it == par_domains.end() || !it->second->isReduction()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   std::string genFusedReductionName(const TensorView* reduction_out) {
     return genVariableName(reduction_out) + "_reduction";
   }
@@ -1718,19 +1978,28 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
     ArgumentBuilder template_args;
     template_args.arg("/*vec_size=*/").append(std::to_string(vectorize_size));
 
+    // A global output is its own work buffer, see
+    // IndexLowering::handleSerialGridReduction
+    const bool in_place = grop->serialReductionTensor()->view() == out->view();
+
     ArgumentBuilder func_args(block_nest_level_ + 1, kTab);
     func_args.arg("&").append(gen(out));
     func_args.arg("&").append(gen(grop->in()));
     func_args.arg(gen(grop->init()));
-    func_args.arg("&").append(gen(grop->serialReductionTensor()));
+    if (!in_place) {
+      func_args.arg("&").append(gen(grop->serialReductionTensor()));
+    }
     func_args.arg(genReductionOp(op_type, out->dtype()));
 
-    // Whether this is the first or last step
+    // Whether this is the first or last step. The last step of an in-place
+    // reduction writes the result like the others.
     func_args.arg(idx_in_segment).append(" == 0");
-    func_args.arg(idx_in_segment)
-        .append(" == ")
-        .append(segment_size)
-        .append(" - 1");
+    if (!in_place) {
+      func_args.arg(idx_in_segment)
+          .append(" == ")
+          .append(segment_size)
+          .append(" - 1");
+    }
     // TODO: can we hoist the first and last step predicates? We might need to
     // attach them to grop in order to do that?
 
@@ -1745,10 +2014,76 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
       func_args.arg(read_pred);
     }
 
-    indent() << "reduction::serialReductionStep<" << template_args << ">(\n";
+    const std::string func_name =
+        in_place ? "serialReductionStepInPlace" : "serialReductionStep";
+    indent() << "reduction::" << func_name << "<" << template_args << ">(\n";
+    indent() << kTab << func_args << ");\n";
+  }
+
+  void generateAtomicGridReduction(const kir::GridReduction* grop) {
+    NVF_ERROR(grop->isAtomic());
+
+    if (ir_utils::isCpAsyncBulkReduction(grop)) {
+      generateCpAsyncBulkReduction(grop);
+      return;
+    }
+
+    const auto data_type = grop->out()->dtype();
+
+    const auto par_domains =
+        ir_utils::getParallelDomains(ir_utils::getTvOutput(grop));
+    ArgumentBuilder template_args;
+    bool has_block_reduction = false;
+    for (const ParallelType pt : kParallelTypeTIDs) {
+      const bool parallel_reduction =
+          par_domains.find(pt) != par_domains.end() &&
+          par_domains.at(pt)->isReduction();
+      has_block_reduction = has_block_reduction || parallel_reduction;
+      template_args.arg(parallel_reduction);
+    }
+    template_args.arg(isAligned());
+
+    ArgumentBuilder func_args(block_nest_level_ + 1, kTab);
+    func_args.arg(gen(grop->out()));
+    func_args.arg(gen(grop->in()));
+    func_args.arg(genReductionOp(grop->getReductionOpType(), data_type));
+    // Without a block reduction, the shared memory is not used nor allocated
+    func_args.arg(genCall(
+        "static_cast",
+        ptrType(data_type),
+        has_block_reduction ? "shared_mem" : "nullptr"));
+    // read and write predicates
+    NVF_ERROR(grop->predicate() != nullptr && grop->predicate()->hasValue());
+    const auto read_pred = genInline(grop->predicate());
+    func_args.arg(read_pred);
+    if (grop->writePredicate() != nullptr) {
+      NVF_ERROR(grop->writePredicate()->hasValue());
+      func_args.arg(genInline(grop->writePredicate()));
+    } else {
+      func_args.arg(read_pred);
+    }
+    // Init val
+    func_args.arg(genCall(data_type, genInline(grop->init())));
+
+    indent() << "reduction::atomicGridReduce<" << template_args << ">(\n";
     indent() << kTab << func_args << ");\n";
   }
 
+  // The tile in shared memory is added to the output with a single
+  // cp.reduce.async.bulk.tensor issued by the threads selected by the
+  // predicate
+  void generateCpAsyncBulkReduction(const kir::GridReduction* grop) {
+    NVF_ERROR(grop->predicate() != nullptr && grop->predicate()->hasValue());
+    ArgumentBuilder func_args;
+    func_args.arg(genInline(grop->out()->as<kir::TensorIndex>()->index()));
+    func_args.arg(genInline(grop->in()->as<kir::TensorIndex>()->index()));
+    indent() << "if (" << genInline(grop->predicate()) << ") {\n";
+    indent() << kTab
+             << genCall("Hopper::cpAsyncBulkTensorTileS2GReduceAdd", func_args)
+             << ";\n";
+    indent() << "}\n";
+  }
+
   void generateGridAllreduce(const kir::GridReduction* grop) {
     NVF_ERROR(grop->isAllreduce());
 
@@ -2784,6 +3119,46 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
              << ";\n";
   }
 
+  // Whether all the reductions of grouped_rop are warp reductions
+  bool isGroupedWarpReduction(const GroupedReductionOp* grouped_rop) {
+    for (const auto i :
+         c10::irange(grouped_rop->numHorizontallyGroupedExprs())) {
+      auto output = grouped_rop->output(i)->as<kir::TensorIndex>();
+      if (!output->view()->domain()->hasBlockReduction() ||
+          output->view()->domain()->hasGridReduction() ||
+          !ir_utils::getMaybeWarpReductionDim(output, grouped_rop->input(i))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void genGroupedWarpReduction(const GroupedReductionOp* grouped_rop) {
+    ArgumentBuilder template_args;
+    template_args.arg(kernel_->getWarpPaddedParallelInfo().is_tidx_single_warp);
+    template_args.arg(isAligned());
+
+    ArgumentBuilder func_args;
+    for (const auto i :
+         c10::irange(grouped_rop->numHorizontallyGroupedExprs())) {
+      const auto output = grouped_rop->output(i)->as<kir::TensorIndex>();
+      func_args.arg(gen(output));
+      func_args.arg(gen(grouped_rop->input(i)));
+      func_args.arg(
+          genReductionOp(grouped_rop->getReductionOpType(i), output->dtype()));
+      func_args.arg(
+          genStaticCast(output->dtype(), genInline(grouped_rop->initVal(i))));
+    }
+    func_args.arg("shared_mem");
+    NVF_ERROR(
+        grouped_rop->predicate() != nullptr &&
+        grouped_rop->predicate()->hasValue());
+    func_args.arg(genInline(grouped_rop->predicate()));
+
+    indent() << genCall("warp::warpReduceTIDX", template_args, func_args)
+             << ";\n";
+  }
+
   void handle(const GroupedReductionOp* grouped_rop) final {
     const auto num_grouped_iterations =
         getGroupedLoopIndexConcreteIntSets().size();
@@ -2814,6 +3189,12 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
           grouped_rop->writePredicate());
     }
 
+    if (num_grouped_iterations <= 1 && num_grouped_exprs == 2 &&
+        isGroupedWarpReduction(grouped_rop)) {
+      genGroupedWarpReduction(grouped_rop);
+      return;
+    }
+
     for (const auto i : c10::irange(num_grouped_exprs)) {
       NVF_ERROR(grouped_rop->output(i)->isA<kir::TensorIndex>());
 
@@ -3254,6 +3635,22 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
     indent() << call << ";\n";
   }
 
+  void handle(const kir::MBarrierWaitParity* wait) final {
+    auto call = genCall(
+        "mbarrier::waitParity",
+        ArgumentBuilder()
+            .arg(genInline(wait->mbarrier()))
+            .arg(genInline(wait->parity())));
+    indent() << call << ";\n";
+  }
+
+  void handle(const kir::MBarrierArriveCpAsync* arrive) final {
+    auto call = genCall(
+        "mbarrier::arriveCpAsync",
+        ArgumentBuilder().arg(genInline(arrive->mbarrier())));
+    indent() << call << ";\n";
+  }
+
   void handle(const kir::BlockSerializeWait* sync) final {
     // Use a custom synchronization method if enabled
     bool bidx = sync->syncDims().get(ParallelType::BIDx);
@@ -3370,6 +3767,10 @@ class CudaKernelGenerator : private kir::ConstIrVisitor {
 
   // Mark when we are inside of a vectorized for-loop
   bool vectorize_scope_ = false;
+  //! Whether each expression is timed, see getKernelPhase
+  bool profile_phases_ = false;
+  //! Number of nested calls of gen, whose expressions are generated inline
+  int gen_nest_level_ = 0;
   //! Keep track of Allocate node for Val. Used to determine if Val
   //! should be inlined.
   std::unordered_set<const Val*> alloc_set_;
@@ -3394,5 +3795,14 @@ std::string generateCudaKernel(
   return CudaKernelGenerator::generateKernelDefinition(kernel, kernel_name);
 }
 
+std::string generateHorizontalCudaKernel(
+    const std::vector<const kir::Kernel*>& kernels,
+    const std::vector<std::string>& function_names,
+    const std::string& kernel_name) {
+  FUSER_PERF_SCOPE("generateHorizontalCudaKernel");
+  return CudaKernelGenerator::generateHorizontalKernelDefinition(
+      kernels, function_names, kernel_name);
+}
+
 } // namespace codegen
 } // namespace nvfuser
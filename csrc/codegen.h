@@ -12,6 +12,7 @@
 #include <visibility.h>
 
 #include <string>
+#include <vector>
 
 namespace nvfuser {
 namespace codegen {
@@ -21,5 +22,20 @@ NVF_API std::string generateCudaKernel(
     const kir::Kernel* kernel,
     const std::string& kernel_name = "CUDAGeneratedKernel");
 
+//! Generates a CUDA kernel definition that runs each of the given kernels on
+//! a consecutive range of its blocks. The kernels become __device__
+//! functions named function_names, which get the blockIdx and gridDim within
+//! their range as arguments. The parameters of the generated kernel are the
+//! parameters of all kernels in order, followed by a dim3 with the grid of
+//! each kernel. It is launched with a 1D grid of the total number of blocks
+//! and the block shared by all kernels.
+//!
+//! The kernels must not use the builtin blockIdx and gridDim outside of the
+//! generated code, e.g. through grid reductions in the runtime library.
+NVF_API std::string generateHorizontalCudaKernel(
+    const std::vector<const kir::Kernel*>& kernels,
+    const std::vector<std::string>& function_names,
+    const std::string& kernel_name);
+
 } // namespace codegen
 } // namespace nvfuser
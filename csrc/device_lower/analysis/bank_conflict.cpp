@@ -92,9 +92,13 @@ std::vector<int64_t> evaluateAddressesOnFirstPhase(
   int64_t num_threads = -1;
   if (ir_utils::isLdMatrixOp(ldst)) {
     // See the comment of getLdMatrixNumThreads for why ldmatrix is handled
-    // differently.
-    word_size = 8;
-    num_threads = getLdMatrixNumThreads(getVectorizeSize(consumer));
+    // differently. Each address points to a 16-byte row, and the number of
+    // addresses depends on the number of 16-bit items per thread, which is
+    // half the vector size for 8-bit items.
+    const int64_t item_size = dataTypeSize(consumer->view()->dtype());
+    word_size = 16 / item_size;
+    num_threads =
+        getLdMatrixNumThreads(getVectorizeSize(consumer) * item_size / 2);
   } else {
     word_size = getVectorizeSize(consumer);
     num_threads = (bdimx ? bdimx.as<int64_t>() : 1) *
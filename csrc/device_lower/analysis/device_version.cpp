@@ -54,6 +54,15 @@ void MinimumDeviceVersion::handle(LoadStoreOp* ls_op) {
   }
 }
 
+void MinimumDeviceVersion::handle(ReductionOp* rop) {
+  if (ir_utils::isCpAsyncBulkReduction(rop)) {
+    ensureVersion(
+        {9, 0},
+        "Atomic grid reductions of shared memory tiles into Bulk outputs "
+        "require Hopper (9.0) or newer");
+  }
+}
+
 void MinimumDeviceVersion::ensureVersion(
     std::pair<int, int> version,
     std::string reason) {
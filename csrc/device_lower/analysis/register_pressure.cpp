@@ -0,0 +1,190 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <device_lower/analysis/register_pressure.h>
+
+#include <kernel_ir.h>
+#include <kernel_ir_dispatch.h>
+#include <scheduler/utils.h>
+#include <type.h>
+#include <utils.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace nvfuser {
+
+namespace {
+
+class RegisterPressureEstimator : public kir::IrVisitor {
+ public:
+  static int64_t get(const kir::Kernel* kernel) {
+    RegisterPressureEstimator estimator(kernel);
+    return estimator.peakRegisters() + scheduler_utils::register_overhead;
+  }
+
+ private:
+  struct LiveRange {
+    int64_t registers = 0;
+    int64_t start = 0;
+    int64_t end = 0;
+    //! Number of loops enclosing the allocation
+    size_t depth = 0;
+    //! Outermost loop not enclosing the allocation with a use of it
+    kir::ForLoop* loop = nullptr;
+  };
+
+  RegisterPressureEstimator(const kir::Kernel* kernel)
+      : index_type_(kernel->indexType()) {
+    handle(kernel->topLevelExprs());
+  }
+
+  using kir::IrVisitor::dispatch;
+  using kir::IrVisitor::handle;
+
+  void dispatch(Expr* expr) final {
+    if (expr->isA<kir::ForLoop>() || expr->isA<kir::IfThenElse>()) {
+      kir::IrVisitor::dispatch(expr);
+      return;
+    }
+    ++position_;
+    if (auto alloc = dynamic_cast<kir::Allocate*>(expr)) {
+      handleAllocate(alloc);
+      return;
+    }
+    std::unordered_set<Val*> visited;
+    for (auto val : expr->inputs()) {
+      markUse(val, visited);
+    }
+    for (auto val : expr->outputs()) {
+      markUse(val, visited);
+    }
+  }
+
+  void handle(kir::ForLoop* fl) final {
+    std::unordered_set<Val*> visited;
+    markUse(fl->start(), visited);
+    markUse(fl->stop(), visited);
+    kir::IrVisitor::handle(fl);
+    // The allocations used in the loop are used again by its next iteration
+    for (auto& range : ranges_) {
+      if (range.loop == fl) {
+        range.end = std::max(range.end, position_);
+        range.loop = nullptr;
+      }
+    }
+  }
+
+  void handle(kir::IfThenElse* ite) final {
+    if (ite->predicate()->hasValue()) {
+      std::unordered_set<Val*> visited;
+      markUse(ite->predicate()->value(), visited);
+    }
+    kir::IrVisitor::handle(ite);
+  }
+
+  void handleAllocate(kir::Allocate* alloc) {
+    if (alloc->memoryType() != MemoryType::Local) {
+      return;
+    }
+    // Aliases reuse the registers of the allocation they alias
+    const kir::Allocate* root = alloc;
+    while (root->alias() != nullptr) {
+      root = root->alias();
+    }
+    if (root != alloc) {
+      if (auto it = range_of_buffer_.find(root->buffer());
+          it != range_of_buffer_.end()) {
+        range_of_buffer_[alloc->buffer()] = it->second;
+      }
+      return;
+    }
+    if (!alloc->size()->isConstInt()) {
+      return;
+    }
+    int64_t replicas = 1;
+    for (auto fl : for_loops_) {
+      if (fl->isUnrolled() && fl->start()->isConstInt() &&
+          fl->stop()->isConstInt()) {
+        replicas *= fl->stop()->evaluate().as<int64_t>() -
+            fl->start()->evaluate().as<int64_t>();
+      }
+    }
+    const int64_t bytes = alloc->size()->evaluate().as<int64_t>() *
+        dataTypeSize(alloc->buffer()->dtype(), index_type_);
+    LiveRange range;
+    range.registers =
+        ceilDiv(bytes, scheduler_utils::bytes_per_register) * replicas;
+    range.start = position_;
+    range.end = position_;
+    range.depth = for_loops_.size();
+    range_of_buffer_[alloc->buffer()] = (int64_t)ranges_.size();
+    ranges_.push_back(range);
+  }
+
+  //! Extends the live range of the allocations val refers to
+  void markUse(Val* val, std::unordered_set<Val*>& visited) {
+    if (val == nullptr || !visited.insert(val).second) {
+      return;
+    }
+    if (auto it = range_of_buffer_.find(val); it != range_of_buffer_.end()) {
+      LiveRange& range = ranges_.at(it->second);
+      range.end = std::max(range.end, position_);
+      if (for_loops_.size() > range.depth && range.loop == nullptr) {
+        range.loop = for_loops_.at(range.depth);
+      }
+      return;
+    }
+    if (auto ti = dynamic_cast<kir::TensorIndex*>(val)) {
+      markUse(ti->view(), visited);
+      markUse(ti->index(), visited);
+      return;
+    }
+    if (val->isA<TensorView>() || val->definition() == nullptr) {
+      return;
+    }
+    // Index expressions that are not hoisted are inlined by the code
+    // generator, so they use the allocations they are computed from
+    for (auto inp : val->definition()->inputs()) {
+      markUse(inp, visited);
+    }
+  }
+
+  int64_t peakRegisters() const {
+    // (position, change of live registers), where a range ending at a
+    // position is live until after that position
+    std::vector<std::pair<int64_t, int64_t>> events;
+    events.reserve(ranges_.size() * 2);
+    for (const auto& range : ranges_) {
+      events.emplace_back(range.start, range.registers);
+      events.emplace_back(range.end + 1, -range.registers);
+    }
+    std::sort(events.begin(), events.end());
+    int64_t live = 0;
+    int64_t peak = 0;
+    for (const auto& [position, change] : events) {
+      live += change;
+      peak = std::max(peak, live);
+    }
+    return peak;
+  }
+
+  const DataType index_type_;
+  int64_t position_ = 0;
+  std::vector<LiveRange> ranges_;
+  std::unordered_map<Val*, int64_t> range_of_buffer_;
+};
+
+} // namespace
+
+int64_t estimateRegisterUsage(const kir::Kernel* kernel) {
+  return RegisterPressureEstimator::get(kernel);
+}
+
+} // namespace nvfuser
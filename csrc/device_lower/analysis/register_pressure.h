@@ -0,0 +1,36 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <exceptions.h>
+#include <kernel.h>
+#include <visibility.h>
+
+namespace nvfuser {
+
+// Warning: This is a rough estimate of the registers ptxas assigns to a
+// thread, meant to catch schedules that are likely to spill before they are
+// compiled. It has the following assumptions and limitations:
+//
+//   1. Only local memory allocations with a constant size are considered to
+//      live in registers. This includes the scalars hoisted by scalar_hoist,
+//      which are allocated as local scalars.
+//   2. An allocation is live from its kir::Allocate to its last use. A use
+//      inside a loop not enclosing the allocation keeps the allocation live
+//      until the end of the outermost such loop, as the next iteration uses
+//      it again.
+//   3. An allocation inside unrolled loops is replicated once per unrolled
+//      iteration.
+//   4. Temporaries that are not allocated, e.g. inlined index expressions and
+//      the loop indices, are covered by scheduler_utils::register_overhead.
+//
+// Returns the estimated number of 32-bit registers per thread, which may
+// exceed the 255 registers ptxas can assign.
+NVF_API int64_t estimateRegisterUsage(const kir::Kernel* kernel);
+
+} // namespace nvfuser
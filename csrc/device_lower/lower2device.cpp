@@ -14,17 +14,21 @@
 #include <device_lower/analysis/shift.h>
 #include <device_lower/pass/alias_memory.h>
 #include <device_lower/pass/allocation.h>
+#include <device_lower/pass/bank_conflict_swizzle.h>
 #include <device_lower/pass/double_buffer.h>
 #include <device_lower/pass/expr_sort.h>
+#include <device_lower/pass/fast_divmod.h>
 #include <device_lower/pass/fusion_simplifier.h>
 #include <device_lower/pass/grid_serialization.h>
 #include <device_lower/pass/index.h>
 #include <device_lower/pass/inline_ptx.h>
 #include <device_lower/pass/insert_syncs.h>
 #include <device_lower/pass/instrument.h>
+#include <device_lower/pass/loop_peeling.h>
 #include <device_lower/pass/loop_rotation.h>
 #include <device_lower/pass/loops.h>
 #include <device_lower/pass/magic_zero.h>
+#include <device_lower/pass/masked_reduction.h>
 #include <device_lower/pass/misaligned_vectorization.h>
 #include <device_lower/pass/predicate.h>
 #include <device_lower/pass/replace_size.h>
@@ -35,11 +39,18 @@
 #include <device_lower/validation.h>
 #include <expr_simplifier.h>
 #include <fusion.h>
+#include <fusion_profiler.h>
 #include <id_model/id_model.h>
 #include <instrumentation.h>
 #include <ir/iostream.h>
 #include <ir/utils.h>
+#include <options.h>
+#include <utils.h>
 
+#include <array>
+#include <chrono>
+#include <functional>
+#include <iomanip>
 #include <list>
 #include <unordered_map>
 #include <unordered_set>
@@ -161,6 +172,11 @@ void GpuLower::collectPaddedParallelDims() {
                   .has_value()) {
             warp_pad_info_.has_warp_reduction = true;
           }
+        } else if (auto wop = dynamic_cast<WelfordOp*>(tv->definition())) {
+          if (ir_utils::getMaybeWarpReductionDim(wop->outAvg(), wop->inAvg())
+                  .has_value()) {
+            warp_pad_info_.has_warp_reduction = true;
+          }
         }
       }
 
@@ -235,21 +251,22 @@ void assignRNGOffset(Fusion* fusion) {
   }
 }
 
+bool isLowerVerboseEnabled(const std::string& pass_name) {
+  if (!isDebugDumpEnabled(DebugDumpOption::LowerVerbose)) {
+    return false;
+  }
+  const auto& args = getDebugDumpArguments(DebugDumpOption::LowerVerbose);
+  return (
+      args.empty() ||
+      std::find(args.begin(), args.end(), pass_name) != args.end());
+}
+
 // Dump expr string if enable lower_verbose
 void dumpExprsIfEnabled(
     const std::vector<Expr*>& exprs,
     std::string pass_name,
     bool force_enable = false) {
-  auto enabled_by_env = [&pass_name]() {
-    if (!isDebugDumpEnabled(DebugDumpOption::LowerVerbose)) {
-      return false;
-    }
-    const auto& args = getDebugDumpArguments(DebugDumpOption::LowerVerbose);
-    return (
-        args.empty() ||
-        std::find(args.begin(), args.end(), pass_name) != args.end());
-  };
-  if (force_enable || enabled_by_env()) {
+  if (force_enable || isLowerVerboseEnabled(pass_name)) {
     debug() << "After " << pass_name << ":" << std::endl;
     for (auto exp : exprs) {
       // `Expr::toString()` already ends with a new line.
@@ -258,6 +275,70 @@ void dumpExprsIfEnabled(
   }
 }
 
+// Same as above, but only sorts the exprs of fusion when they are dumped
+void dumpExprsIfEnabled(Fusion* fusion, const std::string& pass_name) {
+  if (isLowerVerboseEnabled(pass_name)) {
+    dumpExprsIfEnabled(fusion->exprs(), pass_name, /*force_enable=*/true);
+  }
+}
+
+//! Collects the wall time of each step of GpuLower for
+//! DebugDumpOption::LowerPassTiming
+class PassTimer {
+ public:
+  PassTimer()
+      : print_(isDebugDumpEnabled(DebugDumpOption::LowerPassTiming)),
+        record_(FusionProfiler::isRecordingCompileSteps()),
+        start_(std::chrono::steady_clock::now()) {}
+
+  //! Records the time since the last lap or restart as the time of name.
+  //! The step is also recorded as a compile step when profiling.
+  void lap(const std::string& name) {
+    if (!print_ && !record_) {
+      return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (record_) {
+      FusionProfiler::recordCompileStep(name, start_, now);
+    }
+    if (print_) {
+      timings_.emplace_back(
+          name,
+          std::chrono::duration<double, std::milli>(now - start_).count());
+    }
+    start_ = now;
+  }
+
+  //! Excludes the time since the last lap, e.g. spent on dumping
+  void restart() {
+    if (print_ || record_) {
+      start_ = std::chrono::steady_clock::now();
+    }
+  }
+
+  void print(const std::string& title) const {
+    if (!print_) {
+      return;
+    }
+    double total_ms = 0;
+    for (const auto& timing : timings_) {
+      total_ms += timing.second;
+    }
+    debug() << title << " took " << std::fixed << std::setprecision(3)
+            << total_ms << " ms:" << std::endl;
+    for (const auto& [name, ms] : timings_) {
+      debug() << "  " << std::setw(10) << ms << " ms  " << name << std::endl;
+    }
+    debug().unsetf(std::ios_base::floatfield);
+  }
+
+ private:
+  bool print_;
+  bool record_;
+  std::chrono::steady_clock::time_point start_;
+  std::vector<std::pair<std::string, double>> timings_;
+};
+
 GpuLower::GpuLower(Fusion* fusion, const CompileParams& cparams)
     : passes_(
           // Passes will be executed in the order they are added here
@@ -276,11 +357,14 @@ GpuLower::GpuLower(Fusion* fusion, const CompileParams& cparams)
            {"UnrollPass", UnrollPass::runPass},
            {"processMisalignedVectorization", processMisalignedVectorization},
            {"IndexLowering", IndexLowering::getIndexedExprs},
+           {"skipMaskedReductions", skipMaskedReductions},
            {"fuseWarpReduce", fuseWarpReduce},
            {"generateConditionalFromPredicate",
             generateConditionalFromPredicate},
            {"vectorizeWelford", vectorizeWelford},
+           {"fastDivMod", fastDivMod},
            {"allocateCommonScalars", allocateCommonScalars},
+           {"peelLoops", peelLoops},
            {"insertMagicZero", insertMagicZero},
            {"KIRCleaner", KIRCleaner::cleanUp},
            {"instrumentKernel", instrumentKernel},
@@ -299,15 +383,80 @@ struct LowerGuard {
   }
 };
 
+// Val::uses() of a TensorView lazily rebuilds the uses of all TensorViews of
+// the fusion, which must not happen in concurrent analyses
+void makeTvUsesValid(Fusion* fusion) {
+  for (auto val : fusion->inputs()) {
+    if (val->isA<TensorView>()) {
+      val->uses();
+      return;
+    }
+  }
+  for (auto val : fusion->outputs()) {
+    if (val->isA<TensorView>()) {
+      val->uses();
+      return;
+    }
+  }
+}
+
+//! Runs first and second concurrently when EnableOption::ParallelLowering is
+//! set, through runOnThreadPool. Both must only read the fusion, since
+//! creating IR nodes is not thread-safe. Lowering itself may run on the
+//! thread pool, e.g. in FusionKernelRuntime::compileFusionParallel, which
+//! runOnThreadPool handles by running both on the calling thread if no
+//! worker is free.
+void runConcurrently(
+    GpuLower* gpu_lower,
+    const std::function<void()>& first,
+    const std::function<void()>& second) {
+  if (!isOptionEnabled(EnableOption::ParallelLowering)) {
+    first();
+    second();
+    return;
+  }
+
+  Fusion* fusion = FusionGuard::getCurFusion();
+  std::ostream* debug_stream = &debug();
+  const std::array<const std::function<void()>*, 2> fns = {&first, &second};
+  runOnThreadPool(2, [&](int64_t i) {
+    FusionGuard fg(fusion);
+    LowerGuard lower_guard(gpu_lower);
+    DebugStreamGuard dsg(*debug_stream);
+    (*fns.at(i))();
+  });
+}
+
+// Clusters of up to 8 blocks are portable across devices, larger ones would
+// need CU_FUNC_ATTRIBUTE_NON_PORTABLE_CLUSTER_SIZE_ALLOWED
+void validateClusterDims(const std::array<int64_t, 3>& cluster_dims) {
+  constexpr int64_t max_portable_cluster_size = 8;
+  for (int64_t dim : cluster_dims) {
+    NVF_CHECK(dim > 0, "Invalid cluster dimension: ", dim);
+  }
+  const int64_t cluster_size =
+      cluster_dims[0] * cluster_dims[1] * cluster_dims[2];
+  NVF_CHECK(
+      cluster_size <= max_portable_cluster_size,
+      "Clusters of more than ",
+      max_portable_cluster_size,
+      " blocks are not supported, got ",
+      cluster_size);
+}
+
 } // namespace
 
 kir::Kernel* GpuLower::run() {
   FusionGuard fg(fusion_);
   LowerGuard lower_guard(this);
+  CompileStepScope step("GpuLower::run");
+  PassTimer timer;
   // Reorder expressions for loop-nest generation respecting computeAt
   // relationships
   auto exprs_lowered = reorderExprsForComputeAt();
+  timer.lap("reorderExprsForComputeAt");
   dumpExprsIfEnabled(exprs_lowered, "reorderExprsForComputeAt");
+  timer.restart();
 
   commonScalarMap().initialize(exprs_lowered);
 
@@ -317,28 +466,33 @@ kir::Kernel* GpuLower::run() {
   // computation of offset and seed to be considered as part of fusion
   // definition
   assignRNGOffset(fusion_);
+  timer.lap("assignRNGOffset");
 
   for (auto [name, pass] : passes()) {
     exprs_lowered = pass(exprs_lowered);
+    timer.lap(name);
     dumpExprsIfEnabled(exprs_lowered, name);
+    timer.restart();
   }
 
   // We now have the lowered expressions, finalize the kernel IR. This function
   // will also copy over some relevant information for code generation from
   // GpuLower.
   kernel_->finalize(exprs_lowered);
+  timer.lap("finalize");
+  timer.print("GpuLower::run");
 
   return kernel_.get();
 }
 
 void GpuLower::analysis(Fusion* fusion) {
   FUSER_PERF_SCOPE("GpuLower::lower");
+  CompileStepScope step("GpuLower::analysis");
+  PassTimer timer;
   NVF_ERROR(fusion != nullptr);
   NVF_ERROR(
       active_gpu_lower == nullptr, "Nested lowering passes are not supported");
 
-  LowerGuard lower_guard(this);
-
   // Use int64 by default as the kernel index type
   if (!cparams_.index_type.has_value()) {
     cparams_.index_type = PrimDataType::Int;
@@ -349,11 +503,33 @@ void GpuLower::analysis(Fusion* fusion) {
   // Alias the fusion kernel caries around as a view of itself.
   fusion_ = kernel_.get();
 
-  dumpExprsIfEnabled(fusion_->exprs(), "initialize lowering");
+  // Lowers copies of the kernel to find the conflicts, so this must run
+  // before this lowering becomes active
+  if (isOptionEnabled(EnableOption::BankConflictSwizzle)) {
+    swizzleBankConflicts(fusion_, cparams_);
+  }
+
+  LowerGuard lower_guard(this);
+
+  // Records the time of the steps that just finished, which ran concurrently
+  // if there are several, and dumps the fusion after each of them. Dumping
+  // doesn't count towards the next step.
+  auto finish_steps = [this, &timer](const std::vector<std::string>& names) {
+    timer.lap(toDelimitedString(names, " || "));
+    for (const auto& name : names) {
+      dumpExprsIfEnabled(fusion_, name);
+    }
+    timer.restart();
+  };
+  auto finish_step = [&finish_steps](const std::string& name) {
+    finish_steps({name});
+  };
+
+  finish_step("initialize lowering");
 
   segmenterHintCleanup(fusion_);
   FusionGuard fg(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "segmenterHintCleanup");
+  finish_step("segmenterHintCleanup");
 
   // Temporarily set allKnownVals to inputs. In the future, we will have a real
   // pass to determine how to set allKnownVals.
@@ -361,25 +537,33 @@ void GpuLower::analysis(Fusion* fusion) {
   // change their use of fusion_->exprs() to only include exprs that are not
   // between inputs and allKnownVals()?
   allKnownVals() = kernel_->inputs();
-  dumpExprsIfEnabled(fusion_->exprs(), "set allKnownVals");
+  finish_step("set allKnownVals");
 
   // prepare for lowering
   validateIr(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validateIr");
+  finish_step("validateIr");
 
   // Determines minimum device version necessary to compile and run this fusion.
   std::tie(min_device_version_, min_device_version_reason_) =
       MinimumDeviceVersion::compute(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "MinimumDeviceVersion");
+  if (cparams_.hasClusters()) {
+    validateClusterDims(cparams_.cluster_dims);
+    if (min_device_version_ < std::make_pair(9, 0)) {
+      min_device_version_ = {9, 0};
+      min_device_version_reason_ =
+          "Thread block clusters require Hopper (9.0) or newer";
+    }
+  }
+  finish_step("MinimumDeviceVersion");
 
   // Checks if any TIDx dim is marked as padded to a warp. Also checks if we can
   // determine the padding is explicitly a single warp.
   collectPaddedParallelDims();
-  dumpExprsIfEnabled(fusion_->exprs(), "collectPaddedParallelDims");
+  finish_step("collectPaddedParallelDims");
 
   // Replaces integers that are tensor sizes by named scalars as "T0.size[0]"
   replaceSymbolicSizes(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "replaceSymbolicSizes");
+  finish_step("replaceSymbolicSizes");
 
   // Build what's refered to as the compute at map. This map contains the
   // mappings of all iteration domains across the fusion. There are three types
@@ -387,114 +571,134 @@ void GpuLower::analysis(Fusion* fusion) {
   // information.
   compute_at_map_ = std::make_shared<ComputeAtMap>(fusion_);
 
-  // Transitory testing of IdModel if enabled. No existing
-  // functionality should be affected. New IterDomains may be created,
-  // so it is expected that generated code may use diffrent variable
-  // names
+  // Global tensors are indexed with IdModel if enabled, falling back to
+  // the ComputeAtMap-based indexing for unsupported accesses. New
+  // IterDomains may be created, so it is expected that generated code
+  // may use diffrent variable names
   if (isOptionEnabled(EnableOption::IdModel)) {
-    IdModel id_model(fusion_);
+    id_model_ = std::make_unique<IdModel>(fusion_);
+    tensor_indexer_ = std::make_unique<TensorIndexer>(*id_model_);
   }
 
   resolveComputeWith(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "resolveComputeWith");
+  finish_step("resolveComputeWith");
 
   if (isDebugDumpEnabled(DebugDumpOption::ComputeAtMap)) {
     debug() << compute_at_map_->toString() << std::endl;
   }
   compute_at_map_->validateAndPropagatePType();
-  dumpExprsIfEnabled(fusion_->exprs(), "validateAndPropagatePType");
-
-  // Uses compute_at_map, find all splits that are enforced to be divisible
-  divisible_splits_ = getAllDivisibleSplits(fusion_, compute_at_map_.get());
-  dumpExprsIfEnabled(fusion_->exprs(), "getAllDivisibleSplits");
-
-  // Used in parallel dimension map
-  concretized_broadcast_domains_ =
-      std::make_shared<const ConcretizedBroadcastDomains>(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "build ConcretizedBroadcastDomains");
+  finish_step("validateAndPropagatePType");
+
+  // Analyses in the runConcurrently calls below only read the fusion
+  makeTvUsesValid(fusion_);
+
+  runConcurrently(
+      this,
+      [this]() {
+        // Uses compute_at_map, find all splits that are enforced to be
+        // divisible
+        divisible_splits_ =
+            getAllDivisibleSplits(fusion_, compute_at_map_.get());
+      },
+      [this]() {
+        // Used in parallel dimension map
+        concretized_broadcast_domains_ =
+            std::make_shared<const ConcretizedBroadcastDomains>(fusion_);
+      });
+  finish_steps({"getAllDivisibleSplits", "build ConcretizedBroadcastDomains"});
 
   parallelDimensionMap().build(fusion_);
   if (isDebugDumpEnabled(DebugDumpOption::ParallelDimensions)) {
     debug() << "Parallel dimension map:" << std::endl;
     debug() << parallel_dimension_map_.toString() << std::endl;
   }
-  dumpExprsIfEnabled(fusion_->exprs(), "build parallelDimensionMap");
-
-  // Validate mma data format and compatibility if any on the fusion.
-  validateMma(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validateMma");
-
-  // Validate swizzle usage on the fusion schedule.
-  validateSwizzle(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validateSwizzle");
-
-  validateResize(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validateResize");
-
-  validateReductions(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validateReductions");
+  finish_step("build parallelDimensionMap");
+
+  makeTvUsesValid(fusion_);
+  runConcurrently(
+      this,
+      [this]() {
+        // Validate mma data format and compatibility if any on the fusion.
+        validateMma(fusion_);
+      },
+      [this]() {
+        // Validate swizzle usage on the fusion schedule.
+        validateSwizzle(fusion_);
+        validateResize(fusion_);
+        validateReductions(fusion_);
+      });
+  finish_steps(
+      {"validateMma",
+       "validateSwizzle",
+       "validateResize",
+       "validateReductions"});
 
   // Compute thread predicates. Depends on parallel_dimension_map_
   thread_pred_map_.build(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "build thread_pred_map_");
+  finish_step("build thread_pred_map_");
 
   // Fuse cetain patterns of reductions, such as a grid reduction
   // followed by a grid broadcast. Only depends on parallelization and
   // thread predicate map.
   fuseReductionsAndBroadcasts(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "fuseReductionsAndBroadcasts");
+  finish_step("fuseReductionsAndBroadcasts");
 
   // Scan the whole fusion and build mappings about halo extensions of
   // all IterDomains
   halo_info_ = std::make_shared<HaloInfo>(fusion_, compute_at_map_);
-  dumpExprsIfEnabled(fusion_->exprs(), "build HaloInfo");
+  finish_step("build HaloInfo");
 
   // Want to run this after parallel map and halo info map are
   // created. vectorized_accesses_ and vectorized_set_info_ are filled.
   validateAndCollectVectorizeInfo(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validateAndCollectVectorizeInfo");
+  finish_step("validateAndCollectVectorizeInfo");
 
   // Depends on ComputeAtMap and HaloInfo.
   validateAndConvertIterDomainGrouping(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validateAndConvertIterDomainGrouping");
+  finish_step("validateAndConvertIterDomainGrouping");
 
   // Assumes all grouped reductions are convered to
   // GroupedReductionOp, which is done by
   // validateAndConvertIterDomainGrouping
   validateGroupedReductions(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validateGroupedReductions");
+  finish_step("validateGroupedReductions");
 
   // all of the lookup TVs are fusion inputs
   validateLookupTV(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validateLookupTV");
-
-  // Depends on thread_pred_map_, validates parallelization collects which
-  // tensor views need WAR or RAW syncs
-  sync_map_ = std::make_shared<const SyncMap>(fusion_);
+  finish_step("validateLookupTV");
+
+  makeTvUsesValid(fusion_);
+  runConcurrently(
+      this,
+      [this]() {
+        // Depends on thread_pred_map_, validates parallelization collects
+        // which tensor views need WAR or RAW syncs
+        sync_map_ = std::make_shared<const SyncMap>(fusion_);
+      },
+      [this]() {
+        partialSplitMap().build(fusion_);
+        validatePartialSplit(fusion_);
+      });
   if (isDebugDumpEnabled(DebugDumpOption::SyncMap)) {
     debug() << sync_map_->toString() << std::endl;
   }
-  dumpExprsIfEnabled(fusion_->exprs(), "SyncMap");
-
-  partialSplitMap().build(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "build partialSplitMap");
-
-  validatePartialSplit(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "validatePartialSplit");
+  finish_steps({"SyncMap", "build partialSplitMap", "validatePartialSplit"});
 
   nonDivisibleSplitInfo().build(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "build nonDivisibleSplitInfo");
+  finish_step("build nonDivisibleSplitInfo");
 
   // Detects all exprssions that don't need predicates. Depends on
   // nonDivisibleSplitInfo.
   pred_elimination_ = std::make_unique<PredicateElimination>(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "build predicateElimination");
+  finish_step("build predicateElimination");
 
   doubleBufferInfo().build(fusion_);
-  dumpExprsIfEnabled(fusion_->exprs(), "build doubleBufferInfo");
+  finish_step("build doubleBufferInfo");
 
   compute_at_map_->allocateIndexVariables();
-  dumpExprsIfEnabled(fusion_->exprs(), "allocateIndexVariables");
+  finish_step("allocateIndexVariables");
+
+  timer.print("GpuLower::analysis");
 }
 
 kir::Kernel* GpuLower::kernel() const {
@@ -24,6 +24,8 @@
 #include <exceptions.h>
 #include <executor_params.h>
 #include <expr_simplifier.h>
+#include <id_model/id_model.h>
+#include <id_model/indexing.h>
 #include <ir/all_nodes.h>
 #include <kernel.h>
 #include <kernel_ir.h>
@@ -91,6 +93,14 @@ class GpuLower : public NonCopyable {
     return min_device_version_reason_;
   }
 
+  const std::array<int64_t, 3>& clusterDims() const {
+    return cparams_.cluster_dims;
+  }
+
+  int64_t minBlocksPerSm() const {
+    return cparams_.min_blocks_per_sm;
+  }
+
   std::shared_ptr<const ConcretizedBroadcastDomains>
   concretizedBroadcastDomains() {
     return concretized_broadcast_domains_;
@@ -110,6 +120,12 @@ class GpuLower : public NonCopyable {
     return std::const_pointer_cast<const ComputeAtMap>(compute_at_map_);
   }
 
+  //! The IdModel-based indexer of global tensors, only built if
+  //! EnableOption::IdModel is set
+  TensorIndexer* tensorIndexer() const {
+    return tensor_indexer_.get();
+  }
+
   std::shared_ptr<const HaloInfo> haloInfo() const {
     return std::const_pointer_cast<const HaloInfo>(halo_info_);
   }
@@ -294,6 +310,8 @@ class GpuLower : public NonCopyable {
   ThreadPredicateMap thread_pred_map_;
   std::unique_ptr<PredicateElimination> pred_elimination_;
   std::shared_ptr<ComputeAtMap> compute_at_map_;
+  std::unique_ptr<IdModel> id_model_;
+  std::unique_ptr<TensorIndexer> tensor_indexer_;
   std::shared_ptr<HaloInfo> halo_info_;
   LocalAllocationInfoMap local_allocation_info_map_;
   WarpPaddedParallelInfo warp_pad_info_;
@@ -19,6 +19,9 @@
 #include <ops/arith.h>
 #include <options.h>
 
+#include <algorithm>
+#include <limits>
+#include <optional>
 #include <sstream>
 #include <unordered_map>
 #include <unordered_set>
@@ -1853,6 +1856,178 @@ class StackBasedSharedMemAllocator : kir::IrVisitor {
   std::vector<AllocationInfo*> waiting_to_push_;
 };
 
+//! Assign the offsets of shared memory allocations by packing them as
+//! rectangles in (lifetime, offset) space, placing larger allocations first
+//! and each one in the tightest gap below or between the allocations it
+//! conflicts with. Unlike StackBasedSharedMemAllocator, memory freed below
+//! the top of the stack is reused. For example, if A is pushed before B and
+//! is last read before C is first written while B is still live, the stack
+//! places C above B, whereas the packer places C at the offset of A if C
+//! fits there.
+//!
+//! Two allocations conflict unless the last aliased read of one of them is
+//! followed by a block sync before the first write of the other, which is the
+//! same reuse condition as the stack, so no new syncs are needed. Offsets are
+//! aligned to 16 bytes for vectorized and ldmatrix accesses, and to 128 bytes
+//! for TMA.
+//!
+//! This requires the sizes of all allocations to be known at compile time.
+//! allocate() returns false without assigning any address otherwise.
+class PackingSharedMemAllocator : kir::IrVisitor {
+ public:
+  PackingSharedMemAllocator(const AllocationInfoMap& allocation_info_map)
+      : allocation_info_map_(allocation_info_map) {}
+
+  bool allocate(const std::vector<Expr*>& exprs) {
+    for (auto& alloc_info : allocation_info_map_.allAllocationInfos()) {
+      if (alloc_info->mem_type != MemoryType::Shared || alloc_info->alias_to) {
+        continue;
+      }
+      auto alloc = alloc_info->alloc_expr;
+      auto size = allocSizeBytes(alloc);
+      if (!size->isConstInt() ||
+          alloc_info->outer_live_interval->firstWrite() < 0) {
+        return false;
+      }
+      Block block;
+      block.alloc_info = alloc_info.get();
+      block.size = size->evaluate().as<int64_t>();
+      block.alignment = getAlignment(alloc);
+      block.first_write = alloc_info->outer_live_interval->firstWrite();
+      block.last_read = std::max(
+          alloc_info->getAliasedOuterLastRead(), block.first_write);
+      blocks_.push_back(block);
+    }
+
+    // Find the syncs that free the memory of the allocations
+    handle(exprs);
+    for (auto& block : blocks_) {
+      auto sync_it = std::lower_bound(
+          sync_positions_.begin(), sync_positions_.end(), block.last_read);
+      block.release = sync_it == sync_positions_.end()
+          ? std::numeric_limits<int64_t>::max()
+          : *sync_it;
+    }
+
+    // Larger allocations first, breaking ties so that allocations are
+    // deterministic
+    std::vector<Block*> order;
+    order.reserve(blocks_.size());
+    for (auto& block : blocks_) {
+      order.push_back(&block);
+    }
+    std::sort(order.begin(), order.end(), [](Block* a, Block* b) {
+      if (a->size != b->size) {
+        return a->size > b->size;
+      }
+      if (a->first_write != b->first_write) {
+        return a->first_write < b->first_write;
+      }
+      return a->alloc_info->alloc_expr->name() <
+          b->alloc_info->alloc_expr->name();
+    });
+
+    std::vector<Block*> placed;
+    for (auto block : order) {
+      place(block, placed);
+      placed.push_back(block);
+    }
+    return true;
+  }
+
+ private:
+  struct Block {
+    AllocationInfo* alloc_info = nullptr;
+    int64_t size = 0;
+    int64_t alignment = 16;
+    int64_t first_write = -1;
+    int64_t last_read = -1;
+    //! Position of the first block sync after the last aliased read
+    int64_t release = -1;
+    int64_t offset = -1;
+  };
+
+  static int64_t getAlignment(kir::Allocate* alloc) {
+    auto tv = dynamic_cast<TensorView*>(alloc->buffer());
+    if (tv == nullptr) {
+      return 16;
+    }
+    if (tv->definition() != nullptr &&
+        ir_utils::isCpAsyncBulk(tv->definition())) {
+      return 128;
+    }
+    for (auto use : tv->uses()) {
+      if (ir_utils::isCpAsyncBulk(use)) {
+        return 128;
+      }
+    }
+    return 16;
+  }
+
+  static bool conflict(const Block* a, const Block* b) {
+    return !(a->release < b->first_write || b->release < a->first_write);
+  }
+
+  static int64_t alignOffset(int64_t offset, int64_t alignment) {
+    return (offset + alignment - 1) / alignment * alignment;
+  }
+
+  //! Best fit: the smallest gap between the placed conflicting allocations
+  //! that fits block, or else the lowest offset above all of them
+  void place(Block* block, const std::vector<Block*>& placed) {
+    std::vector<const Block*> conflicts;
+    for (auto other : placed) {
+      if (conflict(block, other)) {
+        conflicts.push_back(other);
+      }
+    }
+    std::sort(
+        conflicts.begin(), conflicts.end(), [](const Block* a, const Block* b) {
+          return a->offset < b->offset;
+        });
+
+    std::optional<int64_t> best_offset;
+    int64_t best_gap = std::numeric_limits<int64_t>::max();
+    int64_t gap_start = 0;
+    for (auto other : conflicts) {
+      const int64_t offset = alignOffset(gap_start, block->alignment);
+      const int64_t gap = other->offset - gap_start;
+      if (offset + block->size <= other->offset && gap < best_gap) {
+        best_offset = offset;
+        best_gap = gap;
+      }
+      gap_start = std::max(gap_start, other->offset + other->size);
+    }
+    block->offset =
+        best_offset.value_or(alignOffset(gap_start, block->alignment));
+
+    auto alloc = block->alloc_info->alloc_expr;
+    alloc->setAddress(IrBuilder::create<Val>(block->offset, DataType::Index));
+    if (isDebugDumpEnabled(DebugDumpOption::BufferReuseInfo)) {
+      debug() << "Packed T" << alloc->buffer()->name() << " of " << block->size
+              << " bytes live in [" << block->first_write << ", "
+              << block->release << ") at address " << block->offset
+              << std::endl;
+    }
+  }
+
+  void dispatch(Expr* expr) final {
+    if (lower_utils::hasBlockSync(expr, GpuLower::current()->threadPredMap())) {
+      sync_positions_.push_back(
+          allocation_info_map_.getScopeMap().getExprPos(expr));
+    }
+    kir::IrVisitor::dispatch(expr);
+  }
+
+ private:
+  const AllocationInfoMap& allocation_info_map_;
+
+  std::vector<Block> blocks_;
+
+  //! Positions of the block syncs in increasing order
+  std::vector<int64_t> sync_positions_;
+};
+
 } // namespace
 
 // Use allocation info map to find aliases, i.e. allocations that are properly
@@ -2054,11 +2229,15 @@ std::pair<std::vector<Expr*>, bool> promoteReuseSyncs(
 
 // Assign addresses for dynamic shared memory allocations. This re-uses memory
 // by reclaiming memory that is unused when encountering a block
-// synchronization.
+// synchronization. With EnableOption::SmemPacking, allocations of constant
+// sizes are packed by PackingSharedMemAllocator instead.
 void assignSharedMemoryAllocations(
     const std::vector<Expr*>& exprs,
     AllocationInfoMap& allocation_info_map) {
-  StackBasedSharedMemAllocator(allocation_info_map).allocate(exprs);
+  if (!isOptionEnabled(EnableOption::SmemPacking) ||
+      !PackingSharedMemAllocator(allocation_info_map).allocate(exprs)) {
+    StackBasedSharedMemAllocator(allocation_info_map).allocate(exprs);
+  }
 
   // Verify that all smem allocations have a non-null address now
   for (auto& alloc_info : allocation_info_map.allAllocationInfos()) {
@@ -7,6 +7,7 @@
 // clang-format on
 #include <device_lower/lower2device.h>
 #include <device_lower/pass/allocation.h>
+#include <device_lower/pass/double_buffer.h>
 #include <expr_evaluator.h>
 #include <expr_simplifier.h>
 #include <instrumentation.h>
@@ -464,7 +465,12 @@ class AllocationInserter : public kir::ExprMutator {
         NVF_ERROR(
             default_val == nullptr,
             "Reduction should not have a default initialization value for predicate elimination.");
-        init = expr->as<ReductionOp>()->init();
+        // Atomic grid reductions accumulate into the output, which is
+        // zero-initialized by the executor before the launch. Initializing
+        // it in the kernel would discard the additions of earlier blocks.
+        if (!expr->as<ReductionOp>()->atomicGridReductionRequested()) {
+          init = expr->as<ReductionOp>()->init();
+        }
       } else if (expr->isA<GroupedReductionOp>() && out_tv->hasReduction()) {
         NVF_ERROR(
             default_val == nullptr,
@@ -548,10 +554,12 @@ class AllocationInserter : public kir::ExprMutator {
       }
     }
 
-    // Allocate mbarrier for cp.async.bulk, note that this is only a temporary
-    // solution, we should remove this after we have a better way to handle
-    // synchronizations for cp.async.bulk.
-    if (ir_utils::isCpAsyncBulkLoad(expr)) {
+    if (isMBarrierCircularBufferLoad(expr)) {
+      insertCircularBufferMBarrier(expr);
+    } else if (ir_utils::isCpAsyncBulkLoad(expr)) {
+      // Allocate mbarrier for cp.async.bulk, note that this is only a
+      // temporary solution, we should remove this after we have a better way
+      // to handle synchronizations for cp.async.bulk.
       // create and allocate a memory barrier
       TensorView* mbarrier = TensorViewBuilder()
                                  .shape(std::vector<int64_t>{})
@@ -582,6 +590,75 @@ class AllocationInserter : public kir::ExprMutator {
     }
   }
 
+  // Allocates the mbarriers of the stages of a circular buffered load and
+  // initializes them before the circular buffer loop, so that they are shared
+  // by the prologue and the main loop, see [MBarrier circular buffer].
+  void insertCircularBufferMBarrier(Expr* expr) {
+    auto out_tv = ir_utils::getTvOutput(expr);
+    auto cb_loop =
+        gpu_lower->doubleBufferInfo().getDoubleBufferLoop(out_tv, for_loops_);
+    NVF_ERROR(
+        cb_loop != nullptr,
+        "No circular buffer loop found for ",
+        out_tv->toString());
+
+    // Each thread arrives once per stage after all of its cp.async, so the
+    // cp.async loads of a loop share their mbarriers
+    const bool is_cp_async = ir_utils::isCpAsyncOp(expr);
+    if (is_cp_async) {
+      auto it = cp_async_mbarriers_.find(cb_loop);
+      if (it != cp_async_mbarriers_.end()) {
+        gpu_lower->ldstMBarrierMap()[expr] = it->second;
+        return;
+      }
+    }
+
+    const auto stage_depth =
+        gpu_lower->doubleBufferInfo().getStageDepthFor(cb_loop->iter_domain());
+    TensorView* mbarrier =
+        TensorViewBuilder()
+            .shape(std::vector<int64_t>{(int64_t)stage_depth})
+            .dtype(DataType::UInt)
+            .contiguity(true)
+            .build();
+    mbarrier->setMemoryType(MemoryType::Shared);
+
+    // cp.async arrives without incrementing the pending count, so every
+    // thread of the block has to be counted
+    Val* num_threads = nullptr;
+    if (is_cp_async) {
+      num_threads = gpu_lower->kernel()->oneVal();
+      for (auto pt : kParallelTypeTIDs) {
+        if (auto dim = gpu_lower->parallelDimensionMap().get(pt)) {
+          num_threads = SimplifyingIrBuilder::mulExpr(num_threads, dim);
+        }
+      }
+      cp_async_mbarriers_[cb_loop] = mbarrier;
+    } else {
+      num_threads = lower_utils::getNumThreadsInTensorView(out_tv);
+    }
+    auto mbarrier_init = IrBuilder::create<kir::MBarrierInit>(
+        mbarrier,
+        simplifyExpr(SimplifyingIrBuilder::maybeCastExpr(
+            DataType::UInt32, num_threads)));
+    auto mbarrier_inval = IrBuilder::create<kir::MBarrierInvalidate>(mbarrier);
+
+    auto loop_it = std::find(for_loops_.begin(), for_loops_.end(), cb_loop);
+    kir::Scope* loop_scope =
+        loop_it == for_loops_.begin() ? nullptr : &(*(loop_it - 1))->body();
+    registerInsertBefore(
+        cb_loop,
+        IrBuilder::create<kir::Allocate>(mbarrier, MemoryType::Shared),
+        loop_scope);
+    registerInsertBefore(cb_loop, mbarrier_init, loop_scope);
+    registerInsertBefore(
+        cb_loop, IrBuilder::create<kir::BlockSync>(), loop_scope);
+    registerInsertAfter(cb_loop, mbarrier_inval, loop_scope);
+    registerInsertAfter(
+        cb_loop, IrBuilder::create<kir::BlockSync>(), loop_scope);
+    gpu_lower->ldstMBarrierMap()[expr] = mbarrier;
+  }
+
   // Sends alloc_expr, info.has_halo, info.allocation_domains to GpuLower
   void writeInfoToGPULower(
       const AllocationInformation& allocation,
@@ -622,6 +699,9 @@ class AllocationInserter : public kir::ExprMutator {
  private:
   GpuLower* gpu_lower;
 
+  // The mbarriers shared by the circular buffered cp.async loads of a loop
+  std::unordered_map<kir::ForLoop*, TensorView*> cp_async_mbarriers_;
+
  public:
   static std::vector<Expr*> insert(const std::vector<Expr*>& exprs) {
     AllocationInserter inserter(exprs);
@@ -0,0 +1,155 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <device_lower/pass/bank_conflict_swizzle.h>
+
+#include <ir/all_nodes.h>
+#include <ir/cloner.h>
+#include <ir/utils.h>
+#include <type.h>
+
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace nvfuser {
+
+namespace {
+
+// Set while swizzles are selected, so that the lowerings of the trials don't
+// select swizzles again
+thread_local bool selecting_swizzles = false;
+
+using BankConflictMap = std::unordered_map<
+    TensorView*,
+    std::pair<std::vector<int64_t>, std::vector<int64_t>>>;
+
+// Sum of the conflict ways of all accesses of tv with conflicts, so 0 means
+// tv is conflict free
+int64_t conflictWays(const BankConflictMap& info, TensorView* tv) {
+  auto it = info.find(tv);
+  if (it == info.end()) {
+    return 0;
+  }
+  int64_t ways = 0;
+  for (auto way : it->second.first) {
+    ways += way;
+  }
+  for (auto way : it->second.second) {
+    ways += way;
+  }
+  return ways;
+}
+
+bool canSwizzle(TensorView* tv, int64_t x, int64_t y) {
+  if (x < tv->getMaxComputePosition() ||
+      y < tv->getMaybeMaxProducerPosition()) {
+    return false;
+  }
+  for (auto id : {tv->axis(x), tv->axis(y)}) {
+    if (id->isBroadcast() || id->isReduction() ||
+        id->getParallelType() == ParallelType::Vectorize ||
+        !id->extent()->isConstInt()) {
+      return false;
+    }
+  }
+  const int64_t extent = tv->axis(x)->extent()->evaluate().as<int64_t>();
+  return extent > 1 && (extent & (extent - 1)) == 0 &&
+      tv->axis(y)->extent()->evaluate().as<int64_t>() == extent;
+}
+
+// Lowers a copy of the fusion and returns the conflict ways of each of tvs in
+// the copy, or nullopt if the copy can't be lowered. If swizzled is given,
+// the leaf domains x and y of tvs[swizzled] are swizzled in the copy first.
+std::optional<std::vector<int64_t>> trialConflictWays(
+    Fusion* fusion,
+    const CompileParams& cparams,
+    const std::vector<TensorView*>& tvs,
+    std::optional<size_t> swizzled = std::nullopt,
+    int64_t x = 0,
+    int64_t y = 0) {
+  Fusion copy;
+  IrCloner ir_cloner = Fusion::copy(fusion, &copy);
+  FusionGuard fg(&copy);
+  std::vector<TensorView*> tvs_in_copy;
+  tvs_in_copy.reserve(tvs.size());
+  for (auto tv : tvs) {
+    tvs_in_copy.push_back(ir_cloner.clone(tv));
+  }
+  try {
+    if (swizzled.has_value()) {
+      tvs_in_copy.at(*swizzled)->swizzle(Swizzle2DType::XOR, x, y);
+    }
+    auto info = copy.bankConflictInfo(cparams);
+    std::vector<int64_t> ways;
+    ways.reserve(tvs_in_copy.size());
+    for (auto tv : tvs_in_copy) {
+      ways.push_back(conflictWays(info, tv));
+    }
+    return ways;
+  } catch (const std::exception&) {
+    return std::nullopt;
+  }
+}
+
+} // namespace
+
+void swizzleBankConflicts(Fusion* fusion, const CompileParams& cparams) {
+  if (selecting_swizzles) {
+    return;
+  }
+  struct SelectionGuard {
+    SelectionGuard() {
+      selecting_swizzles = true;
+    }
+    ~SelectionGuard() {
+      selecting_swizzles = false;
+    }
+  } selection_guard;
+
+  std::vector<TensorView*> smem_tvs;
+  for (auto tv : ir_utils::allTvs(fusion)) {
+    if (tv->getMemoryType() == MemoryType::Shared && !tv->hasSwizzleOp()) {
+      smem_tvs.push_back(tv);
+    }
+  }
+  if (smem_tvs.empty()) {
+    return;
+  }
+  // If the fusion can't be lowered, the lowering itself reports why
+  auto baseline = trialConflictWays(fusion, cparams, smem_tvs);
+  if (!baseline.has_value()) {
+    return;
+  }
+
+  FusionGuard fg(fusion);
+  for (auto i : c10::irange(smem_tvs.size())) {
+    TensorView* tv = smem_tvs.at(i);
+    int64_t best_ways = baseline->at(i);
+    std::optional<std::pair<int64_t, int64_t>> best_swizzle;
+    // Innermost domains first, where the accesses of a warp usually differ
+    for (int64_t y = tv->nDims() - 1; y > 0 && best_ways > 0; --y) {
+      for (int64_t x = y - 1; x >= 0 && best_ways > 0; --x) {
+        if (!canSwizzle(tv, x, y)) {
+          continue;
+        }
+        auto ways = trialConflictWays(fusion, cparams, smem_tvs, i, x, y);
+        if (ways.has_value() && ways->at(i) < best_ways) {
+          best_ways = ways->at(i);
+          best_swizzle = std::make_pair(x, y);
+        }
+      }
+    }
+    if (best_swizzle.has_value()) {
+      tv->swizzle(
+          Swizzle2DType::XOR, best_swizzle->first, best_swizzle->second);
+    }
+  }
+}
+
+} // namespace nvfuser
@@ -0,0 +1,29 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <executor_params.h>
+#include <fusion.h>
+
+namespace nvfuser {
+
+// Picks XOR data swizzles of shared memory tensors with bank conflicts, as
+// detected by getBankConflictInfo. For each such tensor, every pair of leaf
+// domains that could be swizzled is tried on a copy of the fusion, and the
+// swizzle with the fewest conflict ways is applied to the tensor if it
+// reduces its conflicts. A pair of leaf domains qualifies if both are
+// outside of the compute-at and producer positions, are neither vectorized,
+// broadcast nor reduction domains, and have the same constant power-of-2
+// extent. Tensors that are already swizzled are left as they are.
+//
+// Each trial lowers a copy of the fusion, so this is only run by GpuLower
+// when EnableOption::BankConflictSwizzle is set, before the lowering itself
+// starts. The lowerings of the trials don't select swizzles again.
+void swizzleBankConflicts(Fusion* fusion, const CompileParams& cparams);
+
+} // namespace nvfuser
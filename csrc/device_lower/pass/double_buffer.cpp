@@ -8,6 +8,7 @@
 #include <device_lower/lower2device.h>
 #include <ir/utils.h>
 #include <kernel_ir.h>
+#include <options.h>
 
 #include <device_lower/pass/double_buffer.h>
 
@@ -116,6 +117,36 @@ void validateDoubleBufferedTensor(const TensorView* tv) {
   return;
 }
 
+bool isMBarrierCircularBufferLoad(const Expr* expr) {
+  auto out_tv = ir_utils::getTvOutput(expr);
+  if (out_tv == nullptr ||
+      !(out_tv->isDoubleBuffered() || out_tv->isCircularBuffered())) {
+    return false;
+  }
+  return ir_utils::isCpAsyncBulkLoad(expr) ||
+      (ir_utils::isCpAsyncOp(expr) &&
+       isOptionEnabled(EnableOption::MBarrierCircularBuffer));
+}
+
+Val* getCircularBufferLoadStage(kir::ForLoop* loop) {
+  if (loop->doubleBufferLoopStage() == DoubleBufferLoopStage::Prolog) {
+    return loop->index();
+  }
+  NVF_ERROR(
+      loop->doubleBufferLoopStage() == DoubleBufferLoopStage::Main,
+      "Circular buffer loads are only issued by prologue and main loops");
+  auto stage_depth = IrBuilder::create<Val>(
+      (int64_t)GpuLower::current()->doubleBufferInfo().getStageDepthFor(
+          loop->iter_domain()),
+      DataType::Index);
+  return SimplifyingIrBuilder::modExpr(
+      SimplifyingIrBuilder::addExpr(
+          loop->index(),
+          SimplifyingIrBuilder::subExpr(
+              stage_depth, GpuLower::current()->kernel()->oneVal())),
+      stage_depth);
+}
+
 namespace {
 
 // Initial inspection of a fusion to find and validate double buffered tensors
@@ -500,6 +531,31 @@ class DoubleBufferInserter : private kir::ExprMutator {
               MemoryType::Shared;
         });
 
+    // Loads whose stages are synchronized with mbarriers instead, see
+    // [MBarrier circular buffer]
+    std::vector<Expr*> mbarrier_loads;
+    std::copy_if(
+        loads.begin(),
+        loads.end(),
+        std::back_inserter(mbarrier_loads),
+        isMBarrierCircularBufferLoad);
+
+    // The cp.async loads of a loop share their mbarriers, which they arrive
+    // on after all loads of a stage
+    TensorView* cp_async_mbarrier = nullptr;
+    for (auto load : mbarrier_loads) {
+      if (ir_utils::isCpAsyncOp(load)) {
+        cp_async_mbarrier = GpuLower::current()->ldstMBarrierMap().at(load);
+      }
+    }
+    if (cp_async_mbarrier != nullptr) {
+      prologue_loop->body().push_back(
+          IrBuilder::create<kir::MBarrierArriveCpAsync>(
+              lower_utils::u32IndexSmemTv(
+                  cp_async_mbarrier,
+                  getCircularBufferLoadStage(prologue_loop))));
+    }
+
     // RAW sync is not inserted for double buffered tensors. The only
     // exception is the prologue load.
     bool has_cpasync = false;
@@ -510,7 +566,10 @@ class DoubleBufferInserter : private kir::ExprMutator {
       // If any of the double buffered tensor in this double buffer
       //  loop is async copy. We want to wait for the gmem loads to
       //  finish before synchronizing the block.
-      if (std::any_of(loads.begin(), loads.end(), ir_utils::isCpAsyncOp)) {
+      if (std::any_of(loads.begin(), loads.end(), [](Expr* expr) {
+            return ir_utils::isCpAsyncOp(expr) &&
+                !isMBarrierCircularBufferLoad(expr);
+          })) {
         auto stage_depth =
             GpuLower::current()->doubleBufferInfo().getStageDepthFor(
                 double_buffer_loop->iter_domain());
@@ -522,12 +581,14 @@ class DoubleBufferInserter : private kir::ExprMutator {
         has_cpasync = true;
       }
 
-      // Insert the initial block sync before entering main loop.
+      // Insert the initial block sync before entering main loop. Loads
+      // synchronized with mbarriers are waited for in the main loop instead.
       if (std::any_of(loads.begin(), loads.end(), [](Expr* expr) {
-            return GpuLower::current()
-                ->syncMap()
-                ->needsRawSync(ir_utils::getTvOutput(expr))
-                .hasTID();
+            return !isMBarrierCircularBufferLoad(expr) &&
+                GpuLower::current()
+                    ->syncMap()
+                    ->needsRawSync(ir_utils::getTvOutput(expr))
+                    .hasTID();
           })) {
         // If any of the double buffered loads require sync, as indicated
         //  by sync info map, insert the sync before entering the double buffer
@@ -585,6 +646,23 @@ class DoubleBufferInserter : private kir::ExprMutator {
       registerInsertAfter(double_buffer_loop, cp_async_wait_all);
     }
 
+    if (!mbarrier_loads.empty()) {
+      insertMBarrierArriveWaitInMainLoop(
+          main_loop, mbarrier_loads, cp_async_mbarrier);
+    }
+
+    if (cp_async_mbarrier != nullptr) {
+      // Same as above, the loads of the main loop beyond the last stage are
+      // drained. They are not in any cp.async group yet, so they are
+      // committed first.
+      registerInsertAfter(
+          double_buffer_loop,
+          IrBuilder::create<kir::AsyncWait>(AsyncOpType::CpAsync, 0));
+      registerInsertAfter(
+          double_buffer_loop,
+          IrBuilder::create<kir::AsyncCommit>(AsyncOpType::CpAsync));
+    }
+
     if (requireEpilogue(loads)) {
       // In the case where the main loop is trivial (for example, ldmatrix in
       // matmul kernel), we need to be careful when copying epilog loop. For
@@ -610,6 +688,59 @@ class DoubleBufferInserter : private kir::ExprMutator {
     }
   }
 
+  // Inserts the mbarrier arrival of the cp.async loads of the stage loaded
+  //  by a main loop iteration and the mbarrier waits for the stage consumed
+  //  by the iteration right after the last load, see [MBarrier circular
+  //  buffer].
+  void insertMBarrierArriveWaitInMainLoop(
+      kir::ForLoop* main_loop,
+      const std::vector<Expr*>& mbarrier_loads,
+      TensorView* cp_async_mbarrier) {
+    auto& exprs = main_loop->body().exprs();
+    std::vector<Expr*>::const_iterator last_load = exprs.end();
+    for (auto it = exprs.begin(); it != exprs.end(); ++it) {
+      if (IsDoubleBufferLoadLoop::check(*it, mbarrier_loads)) {
+        last_load = it;
+      }
+    }
+    NVF_ERROR(last_load != exprs.end());
+    Expr* insertion_point = *last_load;
+
+    if (cp_async_mbarrier != nullptr) {
+      auto arrive = IrBuilder::create<kir::MBarrierArriveCpAsync>(
+          lower_utils::u32IndexSmemTv(
+              cp_async_mbarrier, getCircularBufferLoadStage(main_loop)));
+      main_loop->body().insert_after(insertion_point, arrive);
+      insertion_point = arrive;
+    }
+
+    auto stage_depth = IrBuilder::create<Val>(
+        (int64_t)GpuLower::current()->doubleBufferInfo().getStageDepthFor(
+            main_loop->iter_domain()),
+        DataType::Index);
+    auto stage = SimplifyingIrBuilder::modExpr(main_loop->index(), stage_depth);
+    auto parity = SimplifyingIrBuilder::maybeCastExpr(
+        DataType::UInt32,
+        SimplifyingIrBuilder::modExpr(
+            SimplifyingIrBuilder::divExpr(main_loop->index(), stage_depth),
+            IrBuilder::create<Val>(2L, DataType::Index)));
+
+    std::vector<TensorView*> mbarriers;
+    for (auto load : mbarrier_loads) {
+      auto mbarrier = GpuLower::current()->ldstMBarrierMap().at(load);
+      if (std::find(mbarriers.begin(), mbarriers.end(), mbarrier) ==
+          mbarriers.end()) {
+        mbarriers.push_back(mbarrier);
+      }
+    }
+    for (auto mbarrier : mbarriers) {
+      auto wait = IrBuilder::create<kir::MBarrierWaitParity>(
+          lower_utils::u32IndexSmemTv(mbarrier, stage), parity);
+      main_loop->body().insert_after(insertion_point, wait);
+      insertion_point = wait;
+    }
+  }
+
   // Simple conservative rule for inserting async copy wait
   //  primitive in the double buffer loop:
   void insertCpAsyncCommitWaitInMainLoop(
@@ -163,6 +163,42 @@
 //                      would need to sync to this point to ensure
 //                      completion of the whole tile.
 
+// [MBarrier circular buffer]
+// Instead of cp.async groups and block syncs, the stages of a circular
+//  buffer can be synchronized with an array of D mbarriers, one per stage.
+//  The loads of a stage arrive on its mbarrier, TMA loads with
+//  mbarrier.arrive.expect_tx and cp.async loads with
+//  cp.async.mbarrier.arrive once all loads of the stage are issued. The
+//  iteration consuming a stage waits for the completion of the mbarrier
+//  phase of that iteration. Since stage s is filled for iterations s, s+D,
+//  s+2D and so on, the phase of iteration i is i/D, and waiting for its
+//  parity is enough.
+//
+// allocate X[S*D], mbarrier[D]
+// for s in 0..D: mbarrier.init(mbarrier[s])
+// __syncthreads();
+// for i in 0..D-1: // prolog
+//   for j in ...
+//     x[i*S+j] = y[i, j]; // arrives on mbarrier[i]
+//
+// for i in 0..N: // main loop
+//   for j in ...
+//     x[((i+D-1)%D)*S+j] = y[i+D-1, j]; // arrives on mbarrier[(i+D-1)%D]
+//   mbarrier.wait.parity(mbarrier[i%D], (i/D)%2);
+//   for j in ...
+//     .. = x[(i%D)*S+j]
+//   __syncthreads(); // WAR sync before the next iteration overwrites a stage
+// __syncthreads();
+// for s in 0..D: mbarrier.inval(mbarrier[s])
+//
+// Each thread only waits for the loads it consumes to be visible, so there
+//  is no block sync for RAW dependencies, and since the wait is placed
+//  right after the loads of the iteration, only the loads of one stage are
+//  waited for at a time. The mbarriers are allocated by the allocation pass
+//  and recorded in GpuLower::ldstMBarrierMap. cp.async loads of the same
+//  loop share one array, since each thread arrives once per stage after all
+//  of its copies.
+
 namespace nvfuser {
 
 int64_t getDoubleBufferAxisPosition(const TensorView* tv);
@@ -171,6 +207,16 @@ IterDomain* getDoubleBufferAxis(const TensorView* tv);
 
 void validateDoubleBufferedTensor(const TensorView* tv);
 
+//! Returns true if the stages of the circular buffered output of a load are
+//! synchronized with mbarriers, see [MBarrier circular buffer]. This is the
+//! case for TMA loads, and for cp.async loads when
+//! EnableOption::MBarrierCircularBuffer is set.
+bool isMBarrierCircularBufferLoad(const Expr* expr);
+
+//! Returns the circular buffer stage that the loads of the current iteration
+//! of a prologue or main loop write to.
+Val* getCircularBufferLoadStage(kir::ForLoop* loop);
+
 class DoubleBufferPass {
  public:
   //! Apply double buffering transformations
@@ -0,0 +1,235 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <device_lower/pass/fast_divmod.h>
+
+#include <device_lower/lower2device.h>
+#include <device_lower/pass/magic_zero.h>
+#include <device_lower/utils.h>
+#include <ir/builder.h>
+#include <ir/utils.h>
+#include <kernel_ir.h>
+#include <kernel_ir_dispatch.h>
+#include <options.h>
+
+#include <algorithm>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace nvfuser {
+
+namespace {
+
+class FastDivModReplacer : public kir::IrVisitor {
+ public:
+  static void run(const std::vector<Expr*>& exprs) {
+    FastDivModReplacer replacer(exprs);
+  }
+
+ private:
+  FastDivModReplacer(const std::vector<Expr*>& exprs) {
+    handle(exprs);
+  }
+
+  using kir::IrVisitor::dispatch;
+  using kir::IrVisitor::handle;
+
+  void dispatch(Expr* expr) final {
+    if (expr->isA<kir::ForLoop>() || expr->isA<kir::IfThenElse>()) {
+      kir::IrVisitor::dispatch(expr);
+      return;
+    }
+    // Scalar expressions of the lowered exprs are printed as statements, so
+    // their definitions are not replaced. Their inputs may still be.
+    lowered_exprs_.insert(expr);
+    for (auto val : expr->inputs()) {
+      replaceDivMod(val);
+    }
+    for (auto val : expr->outputs()) {
+      if (auto ti = dynamic_cast<kir::TensorIndex*>(val)) {
+        replaceDivMod(ti->index());
+      }
+    }
+    for (auto pred : {expr->predicate(), expr->writePredicate()}) {
+      if (pred != nullptr && pred->hasValue()) {
+        replaceDivMod(pred->value());
+      }
+    }
+  }
+
+  void handle(kir::ForLoop* fl) final {
+    loop_indices_.insert(fl->index());
+    replaceDivMod(fl->start());
+    replaceDivMod(fl->stop());
+    kir::IrVisitor::handle(fl);
+  }
+
+  void handle(kir::IfThenElse* ite) final {
+    if (ite->predicate()->hasValue()) {
+      replaceDivMod(ite->predicate()->value());
+    }
+    kir::IrVisitor::handle(ite);
+  }
+
+  //! Whether val is known to be non-negative from how it is computed
+  bool isNonNegative(Val* val) const {
+    if (val->isConstInt()) {
+      return val->evaluate().as<int64_t>() >= 0;
+    }
+    if (ir_utils::isTensorSize(val)) {
+      return true;
+    }
+    auto def = val->definition();
+    if (def == nullptr) {
+      return val->isA<NamedScalar>() || loop_indices_.count(val) > 0;
+    }
+    if (auto uop = dynamic_cast<UnaryOp*>(def)) {
+      return uop->getUnaryOpType() == UnaryOpType::Cast &&
+          isIntegralType(uop->out()->dtype()) && isNonNegative(uop->in());
+    }
+    if (auto bop = dynamic_cast<BinaryOp*>(def)) {
+      switch (bop->getBinaryOpType()) {
+        case BinaryOpType::Add:
+        case BinaryOpType::Mul:
+        case BinaryOpType::Div:
+        case BinaryOpType::CeilDiv:
+        case BinaryOpType::Mod:
+        case BinaryOpType::Max:
+        case BinaryOpType::Min:
+          return isNonNegative(bop->lhs()) && isNonNegative(bop->rhs());
+        default:
+          return false;
+      }
+    }
+    return false;
+  }
+
+  //! Whether val has the same value everywhere in the kernel, i.e. only
+  //! depends on tensor metadata, constants and named scalars
+  bool isKernelInvariant(Val* val) const {
+    if (val->isA<kir::TensorIndex>() || isMagicZero(val) ||
+        loop_indices_.count(val) > 0) {
+      return false;
+    }
+    if (val->isA<TensorView>()) {
+      return true;
+    }
+    auto def = val->definition();
+    if (def == nullptr) {
+      return val->isConst() || val->isA<NamedScalar>();
+    }
+    return std::all_of(
+        def->inputs().begin(), def->inputs().end(), [this](Val* inp) {
+          return isKernelInvariant(inp);
+        });
+  }
+
+  //! Returns (multiplier, shift) of the divisor, which are computed once per
+  //! sameAs divisor. They are kernel parameters computed by the host if
+  //! possible, and are otherwise computed at the top level of the kernel.
+  std::pair<Val*, Val*> getMagicNumbers(Val* divisor) {
+    for (const auto& [d, magic] : magic_numbers_) {
+      if (d->sameAs(divisor)) {
+        return magic;
+      }
+    }
+    auto multiplier = IrBuilder::create<Val>(DataType::UInt32);
+    IrBuilder::create<UnaryOp>(
+        UnaryOpType::FastDivMultiplier, multiplier, divisor);
+    auto shift = IrBuilder::create<Val>(DataType::UInt32);
+    IrBuilder::create<UnaryOp>(UnaryOpType::FastDivShift, shift, divisor);
+    if (lower_utils::isHostComputable(divisor)) {
+      auto& known_vals = GpuLower::current()->allKnownVals();
+      known_vals.push_back(multiplier);
+      known_vals.push_back(shift);
+    } else {
+      auto& common_scalar_map = GpuLower::current()->commonScalarMap();
+      common_scalar_map.hoistToTopLevel(multiplier);
+      common_scalar_map.hoistToTopLevel(shift);
+    }
+    magic_numbers_.emplace_back(divisor, std::make_pair(multiplier, shift));
+    return magic_numbers_.back().second;
+  }
+
+  //! Defines out as n / divisor. As n < 2^31, umulhi(m, n) + n can't
+  //! overflow 32 bits.
+  void defineFastDiv(Val* out, Val* n, Val* divisor) {
+    auto [multiplier, shift] = getMagicNumbers(divisor);
+    auto n32 = IrBuilder::maybeCastExpr(DataType::UInt32, n);
+    auto high = IrBuilder::create<Val>(DataType::UInt32);
+    IrBuilder::create<BinaryOp>(BinaryOpType::UMulHi, high, multiplier, n32);
+    auto sum = IrBuilder::create<Val>(DataType::UInt32);
+    IrBuilder::create<BinaryOp>(BinaryOpType::Add, sum, high, n32);
+    auto quotient = IrBuilder::create<Val>(DataType::UInt32);
+    IrBuilder::create<BinaryOp>(BinaryOpType::Rshift, quotient, sum, shift);
+    IrBuilder::create<UnaryOp>(UnaryOpType::Cast, out, quotient);
+  }
+
+  void replaceDivMod(Val* val) {
+    if (val == nullptr || !visited_.insert(val).second) {
+      return;
+    }
+    if (auto ti = dynamic_cast<kir::TensorIndex*>(val)) {
+      replaceDivMod(ti->index());
+      return;
+    }
+    auto def = val->definition();
+    if (val->isA<TensorView>() || def == nullptr ||
+        lowered_exprs_.count(def) > 0) {
+      return;
+    }
+    for (auto inp : def->inputs()) {
+      replaceDivMod(inp);
+    }
+    auto bop = dynamic_cast<BinaryOp*>(def);
+    if (bop == nullptr ||
+        (bop->getBinaryOpType() != BinaryOpType::Div &&
+         bop->getBinaryOpType() != BinaryOpType::Mod) ||
+        val->dtype() != DataType::Index) {
+      return;
+    }
+    Val* n = bop->lhs();
+    Val* divisor = bop->rhs();
+    if (n->dtype() != DataType::Index || divisor->dtype() != DataType::Index ||
+        divisor->isConst() || !isKernelInvariant(divisor) ||
+        !isNonNegative(divisor) || !isNonNegative(n)) {
+      return;
+    }
+
+    // val keeps its uses and allocation, only its definition is replaced
+    const bool is_mod = bop->getBinaryOpType() == BinaryOpType::Mod;
+    GpuLower::current()->kernel()->removeExpr(bop);
+    if (!is_mod) {
+      defineFastDiv(val, n, divisor);
+      return;
+    }
+    auto quotient = IrBuilder::create<Val>(DataType::Index);
+    defineFastDiv(quotient, n, divisor);
+    IrBuilder::create<BinaryOp>(
+        BinaryOpType::Sub, val, n, IrBuilder::mulExpr(quotient, divisor));
+  }
+
+  std::unordered_set<Expr*> lowered_exprs_;
+  std::unordered_set<Val*> loop_indices_;
+  std::unordered_set<Val*> visited_;
+  std::vector<std::pair<Val*, std::pair<Val*, Val*>>> magic_numbers_;
+};
+
+} // namespace
+
+std::vector<Expr*> fastDivMod(const std::vector<Expr*>& exprs) {
+  if (!isOptionEnabled(EnableOption::FastDivMod) ||
+      isOptionDisabled(DisableOption::IndexHoist) ||
+      GpuLower::current()->kernel()->indexType() != DataType::Int32) {
+    return exprs;
+  }
+  FastDivModReplacer::run(exprs);
+  return exprs;
+}
+
+} // namespace nvfuser
@@ -0,0 +1,41 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <exceptions.h>
+#include <ir/all_nodes.h>
+
+#include <vector>
+
+namespace nvfuser {
+
+//! Replace the divisions and modulos of indices and predicates by divisors
+//! that are not compile time constants but don't change during the kernel,
+//! e.g. the extents of tensors, with multiplications by magic numbers:
+//!
+//!   n / d = (umulhi(m, n) + n) >> l
+//!   n % d = n - (n / d) * d
+//!
+//! where m = fastDivMultiplier(d) and l = fastDivShift(d) are 32-bit
+//! unsigned integers. If d only depends on the metadata of input tensors,
+//! e.g. it is an input extent, m and l are computed by the host and passed as
+//! kernel parameters, otherwise they are computed once at the top level of
+//! the kernel. Constant divisors are left to nvcc, which already does the
+//! same for them.
+//!
+//! This is only valid for 32-bit indices that are known to be non-negative,
+//! so only kernels with the Int32 index type are handled, and a division is
+//! only replaced if its dividend is a sum, product, division or modulo of
+//! loop indices, parallel indices, tensor sizes and non-negative constants.
+//!
+//! Runs before allocateCommonScalars, which allocates the magic numbers,
+//! and only if EnableOption::FastDivMod is set and DisableOption::IndexHoist
+//! is not.
+std::vector<Expr*> fastDivMod(const std::vector<Expr*>& exprs);
+
+} // namespace nvfuser
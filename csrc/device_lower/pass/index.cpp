@@ -7,6 +7,7 @@
 // clang-format on
 #include <device_lower/analysis/index_compute.h>
 #include <device_lower/lower2device.h>
+#include <device_lower/pass/double_buffer.h>
 #include <device_lower/utils.h>
 #include <index_compute.h>
 #include <ir/iostream.h>
@@ -316,8 +317,15 @@ void IndexLowering::handle(const IndexSelectOp* sop) {
       lowerSrcIndex(sop->input(0), sop->output(0), override_index);
 
   const auto out = lowerDstIndex(sop->output(0));
-  pushBack(
-      IrBuilder::create<IndexSelectOp>(out, lookup, sop->dim(), lowered_index));
+  // Vectorized gathers of rows of the lookup table are lowered like the
+  // vectorized loads of a set, with the row index overridden
+  if (ir_utils::getVectorizeSize(sop->output(0)->as<TensorView>()) > 1) {
+    pushBack(
+        IrBuilder::create<LoadStoreOp>(LoadStoreOpType::Set, out, lookup));
+  } else {
+    pushBack(IrBuilder::create<IndexSelectOp>(
+        out, lookup, sop->dim(), lowered_index));
+  }
   GpuLower::current()->propagateExprInfo(sop, back());
 }
 
@@ -577,6 +585,12 @@ void IndexLowering::handle(const ReductionOp* rop) {
   const bool has_block_reduce = out_domain->hasBlockReduction();
   const bool has_grid_reduce = out_domain->hasGridReduction();
 
+  // The output of a TMA reduction is indexed as a TMA store
+  if (ir_utils::isCpAsyncBulkReduction(rop)) {
+    handleCpAsyncBulkReduction(rop);
+    return;
+  }
+
   const auto out = lowerDstIndex(rop->out());
   const auto in = lowerSrcIndex(rop->in(), rop->out());
 
@@ -637,34 +651,42 @@ void IndexLowering::handleSerialGridReduction(
 
   NVF_ERROR(!rop->isAllreduce(), "Serial grid allReduce is not implemented");
 
-  // Allocate global work buffer TensorIndex.
+  // A global output is reduced in place, i.e., the partial results of the
+  // blocks are accumulated in the output itself, which the last block
+  // overwrites with the result. Otherwise, allocate global work buffer
+  // TensorIndex.
   //
   // For convenience, the global work buffer is allocated like the leaf domain
-  // of the ReductionOp output. In the future, we may want the allocation
-  // domain to be different in order to enable re-use of global output buffers
-  // for in-place reduction.
-  std::vector<IterDomain*> work_buffer_root;
-  work_buffer_root.reserve(out_tv->nDims());
-  for (IterDomain* id : out_tv->getLeafDomain()) {
-    work_buffer_root.push_back(IterDomainBuilder(id).build());
-  }
-  auto work_buffer_domain = IrBuilder::create<TensorDomain>(work_buffer_root);
-  auto work_buffer_tv = IrBuilder::create<TensorView>(
-      work_buffer_domain, out_tv->dtype(), MemoryType::Global);
-  Val* work_buffer_idx_val = nullptr;
-  for (auto v :
-       Index::getGlobalConsumerStridedIndices(out_tv, for_loops_, {})) {
-    work_buffer_idx_val = SimplifyingIrBuilder::addExpr(work_buffer_idx_val, v);
-  }
-
-  auto work_buffer_idx = IrBuilder::create<kir::TensorIndex>(
-      work_buffer_tv,
-      GpuLower::current()->commonScalarMap().hoistScalar(
-          work_buffer_idx_val, for_loops_));
-
-  auto work_alloc = IrBuilder::create<kir::Allocate>(
-      work_buffer_tv, work_buffer_tv->getMemoryType());
-  pushBack(work_alloc);
+  // of the ReductionOp output.
+  kir::TensorIndex* work_buffer_idx = nullptr;
+  if (out_tv->getMemoryType() == MemoryType::Global) {
+    work_buffer_idx = out->as<kir::TensorIndex>();
+  } else {
+    std::vector<IterDomain*> work_buffer_root;
+    work_buffer_root.reserve(out_tv->nDims());
+    for (IterDomain* id : out_tv->getLeafDomain()) {
+      work_buffer_root.push_back(IterDomainBuilder(id).build());
+    }
+    auto work_buffer_domain =
+        IrBuilder::create<TensorDomain>(work_buffer_root);
+    auto work_buffer_tv = IrBuilder::create<TensorView>(
+        work_buffer_domain, out_tv->dtype(), MemoryType::Global);
+    Val* work_buffer_idx_val = nullptr;
+    for (auto v :
+         Index::getGlobalConsumerStridedIndices(out_tv, for_loops_, {})) {
+      work_buffer_idx_val =
+          SimplifyingIrBuilder::addExpr(work_buffer_idx_val, v);
+    }
+
+    work_buffer_idx = IrBuilder::create<kir::TensorIndex>(
+        work_buffer_tv,
+        GpuLower::current()->commonScalarMap().hoistScalar(
+            work_buffer_idx_val, for_loops_));
+
+    auto work_alloc = IrBuilder::create<kir::Allocate>(
+        work_buffer_tv, work_buffer_tv->getMemoryType());
+    pushBack(work_alloc);
+  }
 
   // The thread predicate for GridReduction needs to be set
   // separately from the main predicate. Do not combine them like
@@ -704,6 +726,137 @@ void IndexLowering::handleSerialGridReduction(
   GpuLower::current()->propagateExprInfo(rop, back());
 }
 
+void IndexLowering::handleAtomicGridReduction(
+    const ReductionOp* rop,
+    Val* out,
+    Val* in) {
+  const auto out_tv = out->as<kir::TensorIndex>()->view();
+
+  NVF_ERROR(
+      rop->getReductionOpType() == BinaryOpType::Add,
+      "Atomic grid reductions are only supported for sum reductions: ",
+      rop->toString());
+  NVF_ERROR(!rop->isAllreduce(), "Atomic grid allReduce is not implemented");
+  NVF_ERROR(
+      out_tv->isFusionOutput() && out_tv->getMemoryType() == MemoryType::Global,
+      "Atomic grid reductions must write to a fusion output: ",
+      out_tv->toString());
+  NVF_ERROR(
+      std::none_of(
+          out_tv->getLeafDomain().begin(),
+          out_tv->getLeafDomain().end(),
+          [](IterDomain* id) {
+            return !id->isThread() && id->isReduction() &&
+                !id->extent()->isOneInt();
+          }),
+      "Found a reduction stage that has both a non-parallelized ",
+      "reduction and a grid reduction. This is not supported, ",
+      "please use rfactor to do the serialized reduction first, ",
+      "then the grid reduction. ",
+      rop->toString());
+
+  const auto& thread_pred =
+      GpuLower::current()->threadPredMap().getPredicatedParallelTypes(out_tv);
+
+  // The blocks add their results to the zero-initialized output, so no
+  // work buffer, sync buffer or entrance index is needed
+  auto grid_reduction = IrBuilder::create<kir::GridReduction>(
+      rop->getReductionOpType(),
+      rop->init(),
+      out,
+      in,
+      nullptr,
+      nullptr,
+      nullptr,
+      nullptr,
+      false);
+  grid_reduction->requestAtomicGridReduction();
+
+  grid_reduction = grid_reduction->withThreadPredicate(thread_pred);
+
+  if (rop->predicate()) {
+    grid_reduction = grid_reduction->withPredicate(rop->predicate())
+                         ->as<kir::GridReduction>();
+  }
+  if (rop->writePredicate()) {
+    grid_reduction = grid_reduction->withWritePredicate(rop->writePredicate())
+                         ->as<kir::GridReduction>();
+  }
+
+  pushBack(grid_reduction);
+  GpuLower::current()->propagateExprInfo(rop, back());
+}
+
+void IndexLowering::handleCpAsyncBulkReduction(const ReductionOp* rop) {
+  const auto in_tv = rop->in()->as<TensorView>();
+  const auto out_tv = rop->out()->as<TensorView>();
+
+  NVF_ERROR(
+      rop->getReductionOpType() == BinaryOpType::Add,
+      "TMA reductions are only supported for sum reductions: ",
+      rop->toString());
+  NVF_ERROR(
+      out_tv->isFusionOutput(),
+      "TMA reductions must write to a fusion output: ",
+      out_tv->toString());
+  NVF_ERROR(
+      out_tv->dtype() == DataType::Float ||
+          out_tv->dtype() == DataType::Half ||
+          out_tv->dtype() == DataType::BFloat16 ||
+          out_tv->dtype() == DataType::Int32,
+      "Unsupported data type of a TMA reduction: ",
+      out_tv->toString());
+  NVF_ERROR(
+      std::all_of(
+          out_tv->getLeafDomain().begin(),
+          out_tv->getLeafDomain().end(),
+          [](IterDomain* id) {
+            return !id->isReduction() || id->isBlockDim() ||
+                id->extent()->isOneInt();
+          }),
+      "The reduction axes of a TMA reduction must be parallelized by BID: ",
+      out_tv->toString());
+
+  // The smem tile must be visible to the async proxy
+  pushBack(IrBuilder::create<kir::Asm>(
+      "fence.proxy.async",
+      std::vector<Val*>{},
+      std::vector<Val*>{},
+      kir::Asm::Options{/*volatile=*/true}));
+  auto in = lowerSrcIndex(rop->in(), rop->out(), {}, true);
+  auto [out, _] = Index::getCpAsyncBulkGmemIndex(
+      in_tv, out_tv, nullptr, for_loops_, rotated_loop_);
+
+  // The blocks add their tiles to the zero-initialized output like an atomic
+  // grid reduction
+  auto grid_reduction = IrBuilder::create<kir::GridReduction>(
+      rop->getReductionOpType(),
+      rop->init(),
+      out,
+      in,
+      nullptr,
+      nullptr,
+      nullptr,
+      nullptr,
+      false);
+  grid_reduction->requestAtomicGridReduction();
+  grid_reduction = grid_reduction->withThreadPredicate(
+      GpuLower::current()->threadPredMap().getPredicatedParallelTypes(
+          out_tv));
+  if (rop->predicate()) {
+    grid_reduction = grid_reduction->withPredicate(rop->predicate())
+                         ->as<kir::GridReduction>();
+  }
+  pushBack(grid_reduction);
+  GpuLower::current()->propagateExprInfo(rop, back());
+
+  // Like TMA stores, waits for the smem tile to be read before it can be
+  // overwritten. The reduction is synchronous, so it doesn't overlap with
+  // the computation of the next tile.
+  pushBack(IrBuilder::create<kir::AsyncCommit>(AsyncOpType::CpAsyncBulk));
+  pushBack(IrBuilder::create<kir::AsyncWait>(AsyncOpType::CpAsyncBulk, 0));
+}
+
 void IndexLowering::handleGridReduction(
     const ReductionOp* rop,
     Val* out,
@@ -713,6 +866,11 @@ void IndexLowering::handleGridReduction(
     return;
   }
 
+  if (rop->atomicGridReductionRequested()) {
+    handleAtomicGridReduction(rop, out, in);
+    return;
+  }
+
   const auto out_tv = out->as<kir::TensorIndex>()->view();
   const auto out_domain = out_tv->domain();
 
@@ -1390,28 +1548,77 @@ void IndexLowering::handleGroupedGridWelford(
   }
 }
 
+namespace {
+
+// Returns the indices of all mbarriers of a scalar mbarrier or of an array of
+// mbarriers of circular buffer stages
+std::vector<Val*> getMBarrierIndices(TensorView* mbarrier) {
+  if (mbarrier->nDims() == 0) {
+    return {lower_utils::u32IndexScalarSmemTv(mbarrier)};
+  }
+  NVF_ERROR(mbarrier->nDims() == 1, "Unexpected mbarrier ", mbarrier);
+  auto size = mbarrier->axis(0)->extent()->evaluate().as<int64_t>();
+  std::vector<Val*> indices;
+  indices.reserve(size);
+  for (auto i : c10::irange(size)) {
+    indices.push_back(lower_utils::u32IndexSmemTv(
+        mbarrier, IrBuilder::create<Val>(i, DataType::Index)));
+  }
+  return indices;
+}
+
+} // namespace
+
 void IndexLowering::handle(const kir::MBarrierInit* minit) {
-  auto minit_indexed = IrBuilder::create<kir::MBarrierInit>(
-      lower_utils::u32IndexScalarSmemTv(minit->mbarrier()->as<TensorView>()),
-      minit->threadCount());
-  pushBack(minit_indexed);
-  GpuLower::current()->propagateExprInfo(minit, minit_indexed);
+  for (auto mbarrier_index :
+       getMBarrierIndices(minit->mbarrier()->as<TensorView>())) {
+    auto minit_indexed = IrBuilder::create<kir::MBarrierInit>(
+        mbarrier_index, minit->threadCount());
+    pushBack(minit_indexed);
+    GpuLower::current()->propagateExprInfo(minit, minit_indexed);
+  }
 }
 
 void IndexLowering::handle(const kir::MBarrierInvalidate* minval) {
-  auto minval_indexed = IrBuilder::create<kir::MBarrierInvalidate>(
-      lower_utils::u32IndexScalarSmemTv(minval->mbarrier()->as<TensorView>()));
-  pushBack(minval_indexed);
-  GpuLower::current()->propagateExprInfo(minval, minval_indexed);
+  for (auto mbarrier_index :
+       getMBarrierIndices(minval->mbarrier()->as<TensorView>())) {
+    auto minval_indexed =
+        IrBuilder::create<kir::MBarrierInvalidate>(mbarrier_index);
+    pushBack(minval_indexed);
+    GpuLower::current()->propagateExprInfo(minval, minval_indexed);
+  }
+}
+
+void IndexLowering::handle(const kir::MBarrierWaitParity* wait) {
+  // The mbarrier of the stage is already indexed by the double buffer pass
+  // TODO(kir): remove the need for const_cast
+  pushBack(const_cast<kir::MBarrierWaitParity*>(wait)); // NOLINT
+}
+
+void IndexLowering::handle(const kir::MBarrierArriveCpAsync* arrive) {
+  // TODO(kir): remove the need for const_cast
+  pushBack(const_cast<kir::MBarrierArriveCpAsync*>(arrive)); // NOLINT
 }
 
 void IndexLowering::handleCpAsyncBulkLoad(const LoadStoreOp* ldst) {
   auto out_tv = ldst->out()->as<TensorView>();
   auto in_tv = ldst->in()->as<TensorView>();
 
-  // indexing mbarrier
+  // indexing mbarrier. A circular buffered load arrives on the mbarrier of
+  // the stage it writes, which is waited by the iteration consuming the
+  // stage, see [MBarrier circular buffer].
   auto mbarrier = GpuLower::current()->ldstMBarrierMap().at(ldst);
-  auto mbarrier_index = lower_utils::u32IndexScalarSmemTv(mbarrier);
+  const bool is_circular_buffered = isMBarrierCircularBufferLoad(ldst);
+  Val* mbarrier_index = nullptr;
+  if (is_circular_buffered) {
+    auto cb_loop = GpuLower::current()->doubleBufferInfo().getDoubleBufferLoop(
+        out_tv, for_loops_);
+    NVF_ERROR(cb_loop != nullptr);
+    mbarrier_index = lower_utils::u32IndexSmemTv(
+        mbarrier, getCircularBufferLoadStage(cb_loop));
+  } else {
+    mbarrier_index = lower_utils::u32IndexScalarSmemTv(mbarrier);
+  }
 
   // gmem indexing and expect_bytes for mbarrier
   auto [in, expect_bytes] = Index::getCpAsyncBulkGmemIndex(
@@ -1432,7 +1639,9 @@ void IndexLowering::handleCpAsyncBulkLoad(const LoadStoreOp* ldst) {
   pushBack(new_ldst);
   GpuLower::current()->propagateExprInfo(ldst, back());
   // wait mbarrier
-  pushBack(IrBuilder::create<kir::MBarrierWait>(mbarrier_index, state));
+  if (!is_circular_buffered) {
+    pushBack(IrBuilder::create<kir::MBarrierWait>(mbarrier_index, state));
+  }
 }
 
 void IndexLowering::handleCpAsyncBulkStore(const LoadStoreOp* ldst) {
@@ -1458,16 +1667,16 @@ void IndexLowering::handleCpAsyncBulkStore(const LoadStoreOp* ldst) {
   pushBack(IrBuilder::create<kir::AsyncWait>(AsyncOpType::CpAsyncBulk, 0));
 }
 
-static DataType getMmaInputAType(MmaMacro macro) {
-  int warp_group_size = isHopper(macro) ? 128 : 32;
-  int size = getM(macro) * getK(macro) / warp_group_size /
-      2 /* halves per 32bit register */;
+static DataType getMmaInputAType(MmaMacro macro, DataType dtype) {
+  int64_t warp_group_size = isHopper(macro) ? 128 : 32;
+  int64_t size = getM(macro) * getK(macro) / warp_group_size /
+      (4 / dataTypeSize(dtype)) /* items per 32bit register */;
   return ArrayType{std::make_shared<DataType>(DataType::UInt32), (size_t)size};
 }
 
-static DataType getMmaInputBType(MmaMacro macro) {
-  int size = getN(macro) * getK(macro) / 32 /* threads per warp */ /
-      2 /* halves per 32bit register */;
+static DataType getMmaInputBType(MmaMacro macro, DataType dtype) {
+  int64_t size = getN(macro) * getK(macro) / 32 /* threads per warp */ /
+      (4 / dataTypeSize(dtype)) /* items per 32bit register */;
   return ArrayType{std::make_shared<DataType>(DataType::UInt32), (size_t)size};
 }
 
@@ -1478,7 +1687,8 @@ static inline DataType getMmaOutType(TensorView* mma_out) {
       size *= id->extent()->evaluate().as<int64_t>();
     }
   }
-  return ArrayType{std::make_shared<DataType>(DataType::Float), (size_t)size};
+  // Float for floating point operands, Int32 for Int8 operands
+  return ArrayType{std::make_shared<DataType>(mma_out->dtype()), (size_t)size};
 }
 
 void IndexLowering::handle(const LoadStoreOp* ldst) {
@@ -1495,10 +1705,12 @@ void IndexLowering::handle(const LoadStoreOp* ldst) {
   } else {
     DataType as_type = DataType::Null;
     if (ir_utils::isLdMatrixOp(ldst)) {
+      // Each 32-bit register holds 2 16-bit or 4 8-bit items
+      auto out_tv = ldst->out()->as<TensorView>();
       as_type = ArrayType{
           std::make_shared<DataType>(DataType::UInt32),
-          (size_t)ir_utils::getVectorizeSize(ldst->out()->as<TensorView>()) /
-              2};
+          (size_t)(ir_utils::getVectorizeSize(out_tv) *
+                   dataTypeSize(out_tv->dtype()) / 4)};
     } else if (ldst->out()->definition()->isA<MmaOp>()) {
       // For MMA accumulator initialization
       as_type = getMmaOutType(ldst->out()->as<TensorView>());
@@ -1592,7 +1804,7 @@ void IndexLowering::handle(const MmaOp* mma) {
         : getM(mma->macro());
     int64_t stride_bytes = core_matrix_outer_size *
         /*number of core matrices, rounded up to handle padding */
-        roundUpToMultiple(inner_size * /*bytes per item*/ 2L,
+        roundUpToMultiple(inner_size * dataTypeSize(tv->dtype()),
                           getBytesFromSwizzle(swizzle));
     if (swizzle == MmaInputSmemSwizzle::None &&
         (mma->layout() == MmaLayout::NT || mma->layout() == MmaLayout::NN)) {
@@ -1611,7 +1823,11 @@ void IndexLowering::handle(const MmaOp* mma) {
             matrix_desc, for_loops_));
   } else {
     a = lowerSrcIndex(
-        mma->inA(), mma->out(), {}, false, getMmaInputAType(mma->macro()));
+        mma->inA(),
+        mma->out(),
+        {},
+        false,
+        getMmaInputAType(mma->macro(), mma->inA()->dtype()));
   }
   if (mma->inB()->as<TensorView>()->getMemoryType() == MemoryType::Shared) {
     // TODO: This is a temporary solution and only supports a single tile in
@@ -1627,7 +1843,7 @@ void IndexLowering::handle(const MmaOp* mma) {
         : getN(mma->macro());
     int64_t stride_bytes = core_matrix_outer_size *
         /*number of core matrices, rounded up to handle padding */
-        roundUpToMultiple(inner_size * /*bytes per item*/ 2L,
+        roundUpToMultiple(inner_size * dataTypeSize(tv->dtype()),
                           getBytesFromSwizzle(swizzle));
     if (swizzle == MmaInputSmemSwizzle::None &&
         (mma->layout() == MmaLayout::TT || mma->layout() == MmaLayout::NT)) {
@@ -1646,7 +1862,11 @@ void IndexLowering::handle(const MmaOp* mma) {
             matrix_desc, for_loops_));
   } else {
     b = lowerSrcIndex(
-        mma->inB(), mma->out(), {}, false, getMmaInputBType(mma->macro()));
+        mma->inB(),
+        mma->out(),
+        {},
+        false,
+        getMmaInputBType(mma->macro(), mma->inB()->dtype()));
   }
   const auto out = lowerDstIndex(
       mma->out(), {}, false, getMmaOutType(mma->out()->as<TensorView>()));
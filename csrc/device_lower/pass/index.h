@@ -79,6 +79,8 @@ class IndexLowering : private OptOutConstDispatch {
   void handle(const kir::GridSync*) final;
   void handle(const kir::MBarrierInit*) final;
   void handle(const kir::MBarrierInvalidate*) final;
+  void handle(const kir::MBarrierWaitParity*) final;
+  void handle(const kir::MBarrierArriveCpAsync*) final;
   void handle(const kir::AsyncWait*) final;
   void handle(const kir::AsyncCommit*) final;
   void handle(const kir::BlockSerializeWait*) final;
@@ -124,6 +126,10 @@ class IndexLowering : private OptOutConstDispatch {
   //! Called by handleGridReduction, this returns true if rop is lowered as a
   //! serial grid reduction.
   void handleSerialGridReduction(const ReductionOp* rop, Val* out, Val* in);
+  //! Called by handleGridReduction when the blocks of rop combine their
+  //! results with atomic additions into the output.
+  void handleAtomicGridReduction(const ReductionOp* rop, Val* out, Val* in);
+  void handleCpAsyncBulkReduction(const ReductionOp* rop);
 
   void handleBlockReduction(
       const GroupedReductionOp* rop,
@@ -104,20 +104,26 @@ class LowerToInlinePtx : public kir::ExprMutator {
     // https://docs.nvidia.com/cuda/parallel-thread-execution/index.html#multiply-and-accumulate-instruction-mma
     const int m = 16;
     const int n = 8;
-    const int k = mma->isAmpere() ? 16 : 8;
+    const bool is_int8 = isInt8(mma->macro());
+    const int k = is_int8 ? 32 : (mma->isAmpere() ? 16 : 8);
 
     std::string op;
     {
       std::stringstream op_ss;
-      op_ss << "mma.sync.aligned.m" << m << "n" << n << "k" << k
-            << ".row.col.f32";
-      if (mma->inA()->as<kir::TensorIndex>()->view()->getDataType().value() ==
-          DataType::BFloat16) {
-        op_ss << ".bf16.bf16";
+      op_ss << "mma.sync.aligned.m" << m << "n" << n << "k" << k << ".row.col";
+      const DataType a_dtype =
+          mma->inA()->as<kir::TensorIndex>()->view()->getDataType().value();
+      if (is_int8) {
+        NVF_ERROR(
+            a_dtype == DataType::Int8,
+            "Expected an Int8 mma operand, got: ",
+            a_dtype);
+        op_ss << ".s32.s8.s8.s32";
+      } else if (a_dtype == DataType::BFloat16) {
+        op_ss << ".f32.bf16.bf16.f32";
       } else {
-        op_ss << ".f16.f16";
+        op_ss << ".f32.f16.f16.f32";
       }
-      op_ss << ".f32";
       op = op_ss.str();
     }
 
@@ -206,8 +212,23 @@ class LowerToInlinePtx : public kir::ExprMutator {
     std::stringstream inst_ss;
     inst_ss << "wgmma.mma_async.sync.aligned.m" << mma->m() << "n" << mma->n()
             << "k" << mma->k() << ".f32";
-    if (mma->inA()->as<kir::TensorIndex>()->view()->getDataType().value() ==
-        DataType::BFloat16) {
+    const DataType a_dtype =
+        mma->inA()->as<kir::TensorIndex>()->view()->getDataType().value();
+    const DataType b_dtype =
+        mma->inB()->as<kir::TensorIndex>()->view()->getDataType().value();
+    const bool is_fp8 = isFp8(mma->macro());
+    if (is_fp8) {
+      // The 8-bit types of A and B can differ, e.g., e4m3 activations times
+      // e5m2 gradients
+      const auto fp8TypeName = [](DataType dtype) {
+        NVF_ERROR(
+            dtype == DataType::Float8_e4m3fn || dtype == DataType::Float8_e5m2,
+            "Expected an 8-bit floating point mma operand, got: ",
+            dtype);
+        return dtype == DataType::Float8_e4m3fn ? ".e4m3" : ".e5m2";
+      };
+      inst_ss << fp8TypeName(a_dtype) << fp8TypeName(b_dtype);
+    } else if (a_dtype == DataType::BFloat16) {
       inst_ss << ".bf16.bf16";
     } else {
       inst_ss << ".f16.f16";
@@ -222,20 +243,28 @@ class LowerToInlinePtx : public kir::ExprMutator {
         /*scaleA=*/IrBuilder::create<Val>(1, DataType::Int32),
         /*scaleB=*/IrBuilder::create<Val>(1, DataType::Int32)};
     auto layout = *mma->layout();
-    if (a_on_smem) {
-      // tnspA
-      if (layout == MmaLayout::TT || layout == MmaLayout::TN) {
+    if (is_fp8) {
+      // 8-bit operands must be K-major and take no transpose arguments
+      NVF_ERROR(
+          layout == MmaLayout::TN,
+          "Hopper mma with 8-bit operands requires the TN layout, got: ",
+          toString(layout));
+    } else {
+      if (a_on_smem) {
+        // tnspA
+        if (layout == MmaLayout::TT || layout == MmaLayout::TN) {
+          inputs.push_back(IrBuilder::create<Val>(0, DataType::Int32));
+        } else {
+          inputs.push_back(IrBuilder::create<Val>(1, DataType::Int32));
+        }
+      }
+      // tnspB
+      if (layout == MmaLayout::TN || layout == MmaLayout::NN) {
         inputs.push_back(IrBuilder::create<Val>(0, DataType::Int32));
       } else {
         inputs.push_back(IrBuilder::create<Val>(1, DataType::Int32));
       }
     }
-    // tnspB
-    if (layout == MmaLayout::TN || layout == MmaLayout::NN) {
-      inputs.push_back(IrBuilder::create<Val>(0, DataType::Int32));
-    } else {
-      inputs.push_back(IrBuilder::create<Val>(1, DataType::Int32));
-    }
     registerInsertBefore(
         mma,
         IrBuilder::create<kir::Asm>(
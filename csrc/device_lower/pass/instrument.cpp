@@ -12,15 +12,21 @@
 
 #include <device_lower/pass/instrument.h>
 
+#include <algorithm>
+
 namespace nvfuser {
 
 namespace {
 
 class Instrumentor : private kir::IrVisitor {
  public:
-  Instrumentor(const std::vector<Expr*>& exprs) {
+  Instrumentor(const std::vector<Expr*>& exprs, bool profile_phases) {
     IrVisitor::handle(exprs);
 
+    if (profile_phases) {
+      profile_.registerPhases();
+    }
+
     if (profile_.getNumberOfProfileEntries() == 0) {
       exprs_ = exprs;
       return;
@@ -106,7 +112,13 @@ std::vector<Expr*> instrumentKernel(const std::vector<Expr*>& exprs) {
     return exprs;
   }
 
-  Instrumentor inst(exprs);
+  // NVFUSER_ENABLE=kernel_profile(phases) also times the phases of the
+  // kernel, see KernelPhase
+  const auto& args = getEnableOptionArguments(EnableOption::KernelProfile);
+  const bool profile_phases =
+      std::find(args.begin(), args.end(), "phases") != args.end();
+
+  Instrumentor inst(exprs, profile_phases);
 
   GpuLower::current()->profile() = inst.profile();
 
@@ -18,7 +18,9 @@ namespace nvfuser {
 //! buffer. Note that any expression added after this pass will not be
 //! profiled, so this pass should be called after all expressions are
 //! lowered. KernelPerformanceProfile is copied to Kernel after
-//! lowering.
+//! lowering. With NVFUSER_ENABLE=kernel_profile(phases), the buffer also
+//! has an entry for each KernelPhase, which codegen times around each
+//! expression.
 std::vector<Expr*> instrumentKernel(const std::vector<Expr*>& exprs);
 
 } // namespace nvfuser
@@ -0,0 +1,423 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <device_lower/pass/loop_peeling.h>
+
+#include <device_lower/lower2device.h>
+#include <device_lower/utils.h>
+#include <ir/builder.h>
+#include <ir/utils.h>
+#include <kernel_ir.h>
+#include <kernel_ir_dispatch.h>
+#include <options.h>
+
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace nvfuser {
+
+namespace {
+
+// Direction in which a value changes when the loop index increases: 1 if it
+// doesn't decrease, -1 if it doesn't increase and 0 if it doesn't depend on
+// the loop index. nullopt if unknown.
+using Direction = std::optional<int>;
+
+Direction negate(Direction dir) {
+  if (!dir.has_value()) {
+    return std::nullopt;
+  }
+  return -*dir;
+}
+
+Direction combine(Direction a, Direction b) {
+  if (!a.has_value() || !b.has_value()) {
+    return std::nullopt;
+  }
+  if (*a == 0 || *a == *b) {
+    return b;
+  }
+  if (*b == 0) {
+    return a;
+  }
+  return std::nullopt;
+}
+
+// Replicates the loops and if-then-else exprs of from into to. The if-then-
+// else exprs in dropped are replaced by their then body, and the other exprs
+// in dropped lose their predicate.
+void cloneScope(
+    const kir::Scope& from,
+    kir::Scope& to,
+    const std::unordered_set<Expr*>& dropped) {
+  for (auto expr : from.exprs()) {
+    if (auto loop = dynamic_cast<kir::ForLoop*>(expr)) {
+      auto new_loop = IrBuilder::create<kir::ForLoop>(loop);
+      cloneScope(loop->body(), new_loop->body(), dropped);
+      to.push_back(new_loop);
+    } else if (auto ite = dynamic_cast<kir::IfThenElse*>(expr)) {
+      if (dropped.count(ite) > 0) {
+        cloneScope(ite->thenBody(), to, dropped);
+        continue;
+      }
+      auto new_ite = IrBuilder::create<kir::IfThenElse>(ite->predicate());
+      cloneScope(ite->thenBody(), new_ite->thenBody(), dropped);
+      cloneScope(ite->elseBody(), new_ite->elseBody(), dropped);
+      to.push_back(new_ite);
+    } else if (dropped.count(expr) > 0) {
+      auto new_expr = expr->withPredicate(IrBuilder::create<kir::Predicate>(
+          GpuLower::current()->kernel()->trueVal()));
+      GpuLower::current()->propagateExprInfo(expr, new_expr);
+      to.push_back(new_expr);
+    } else {
+      to.push_back(expr);
+    }
+  }
+}
+
+class LoopPeeler : private kir::ExprMutator {
+ public:
+  static std::vector<Expr*> run(const std::vector<Expr*>& exprs) {
+    LoopPeeler peeler(exprs);
+    return peeler.exprs_;
+  }
+
+ private:
+  LoopPeeler(const std::vector<Expr*>& exprs) {
+    kir::ExprMutator::traverseAndInsert(exprs);
+  }
+
+  using kir::ExprMutator::handle;
+
+  void handle(kir::ForLoop* fl) final {
+    if (canPeel(fl) && peel(fl)) {
+      return;
+    }
+    kir::ExprMutator::handle(fl);
+  }
+
+  static bool canPeel(kir::ForLoop* fl) {
+    if (fl->isTrivial() || fl->isUnrolled() || fl->vectorize() ||
+        fl->iter_domain()->getParallelType() != ParallelType::Serial ||
+        !fl->step()->isOneInt() ||
+        fl->doubleBufferLoopStage() != DoubleBufferLoopStage::NotApplicable) {
+      return false;
+    }
+    return !hasBlockSync(fl->body());
+  }
+
+  static bool hasBlockSync(const kir::Scope& scope) {
+    const auto& pred_map = GpuLower::current()->threadPredMap();
+    for (auto expr : scope.exprs()) {
+      if (auto loop = dynamic_cast<kir::ForLoop*>(expr)) {
+        if (hasBlockSync(loop->body())) {
+          return true;
+        }
+      } else if (auto ite = dynamic_cast<kir::IfThenElse*>(expr)) {
+        if (hasBlockSync(ite->thenBody()) || hasBlockSync(ite->elseBody())) {
+          return true;
+        }
+      } else if (lower_utils::hasBlockSync(expr, pred_map)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  //! Collects the values defined inside of scope, which are not available
+  //! outside of the loop
+  static void collectInsideVals(
+      const kir::Scope& scope,
+      std::unordered_set<Val*>& inside_vals) {
+    for (auto expr : scope.exprs()) {
+      if (auto loop = dynamic_cast<kir::ForLoop*>(expr)) {
+        inside_vals.insert(loop->index());
+        collectInsideVals(loop->body(), inside_vals);
+      } else if (auto ite = dynamic_cast<kir::IfThenElse*>(expr)) {
+        collectInsideVals(ite->thenBody(), inside_vals);
+        collectInsideVals(ite->elseBody(), inside_vals);
+      } else {
+        if (auto alloc = dynamic_cast<kir::Allocate*>(expr)) {
+          inside_vals.insert(alloc->buffer());
+        }
+        inside_vals.insert(expr->outputs().begin(), expr->outputs().end());
+      }
+    }
+  }
+
+  static bool refersTo(Val* val, const std::unordered_set<Val*>& vals) {
+    if (vals.count(val) > 0 || val->isA<kir::TensorIndex>()) {
+      return true;
+    }
+    auto def = val->definition();
+    return def != nullptr &&
+        std::any_of(def->inputs().begin(),
+                    def->inputs().end(),
+                    [&vals](Val* inp) { return refersTo(inp, vals); });
+  }
+
+  //! Whether val is known to be non-negative from how it is computed
+  bool isNonNegative(Val* val) const {
+    if (val->isConstInt()) {
+      return val->evaluate().as<int64_t>() >= 0;
+    }
+    if (ir_utils::isTensorSize(val)) {
+      return true;
+    }
+    auto def = val->definition();
+    if (def == nullptr) {
+      return val->isA<NamedScalar>() ||
+          std::any_of(for_loops_.begin(),
+                      for_loops_.end(),
+                      [val](kir::ForLoop* fl) { return fl->index() == val; });
+    }
+    if (auto uop = dynamic_cast<UnaryOp*>(def)) {
+      return uop->getUnaryOpType() == UnaryOpType::Cast &&
+          isNonNegative(uop->in());
+    }
+    if (auto bop = dynamic_cast<BinaryOp*>(def)) {
+      switch (bop->getBinaryOpType()) {
+        case BinaryOpType::Add:
+        case BinaryOpType::Mul:
+        case BinaryOpType::Div:
+        case BinaryOpType::CeilDiv:
+          return isNonNegative(bop->lhs()) && isNonNegative(bop->rhs());
+        default:
+          return false;
+      }
+    }
+    return false;
+  }
+
+  Direction direction(Val* val, Val* index) {
+    if (val == index) {
+      return 1;
+    }
+    if (val->isOneOf<TensorView, kir::TensorIndex>()) {
+      return std::nullopt;
+    }
+    auto def = val->definition();
+    if (def == nullptr) {
+      return 0;
+    }
+    if (auto it = directions_.find(val); it != directions_.end()) {
+      return it->second;
+    }
+    Direction dir = std::nullopt;
+    if (auto bop = dynamic_cast<BinaryOp*>(def)) {
+      const Direction lhs = direction(bop->lhs(), index);
+      const Direction rhs = direction(bop->rhs(), index);
+      switch (bop->getBinaryOpType()) {
+        case BinaryOpType::Add:
+          dir = combine(lhs, rhs);
+          break;
+        case BinaryOpType::Sub:
+          dir = combine(lhs, negate(rhs));
+          break;
+        case BinaryOpType::Mul:
+          if (lhs == 0 && isNonNegative(bop->lhs())) {
+            dir = rhs;
+          } else if (rhs == 0 && isNonNegative(bop->rhs())) {
+            dir = lhs;
+          } else if (lhs == 0 && rhs == 0) {
+            dir = 0;
+          }
+          break;
+        case BinaryOpType::Div:
+        case BinaryOpType::CeilDiv:
+          if (rhs == 0 && isNonNegative(bop->rhs())) {
+            dir = lhs;
+          } else if (lhs == 0 && rhs == 0) {
+            dir = 0;
+          }
+          break;
+        case BinaryOpType::Max:
+        case BinaryOpType::Min:
+          dir = combine(lhs, rhs);
+          break;
+        default:
+          if (lhs == 0 && rhs == 0) {
+            dir = 0;
+          }
+          break;
+      }
+    } else if (
+        auto uop = dynamic_cast<UnaryOp*>(def);
+        uop != nullptr && uop->getUnaryOpType() == UnaryOpType::Cast) {
+      dir = direction(uop->in(), index);
+    } else if (std::all_of(
+                   def->inputs().begin(),
+                   def->inputs().end(),
+                   [&](Val* inp) { return direction(inp, index) == 0; })) {
+      dir = 0;
+    }
+    directions_.emplace(val, dir);
+    return dir;
+  }
+
+  //! Whether pred is a conjunction of comparisons that are monotonic in the
+  //! loop index
+  bool isMonotonic(Val* pred, Val* index) {
+    auto bop = dynamic_cast<BinaryOp*>(pred->definition());
+    if (bop == nullptr) {
+      return direction(pred, index).has_value();
+    }
+    switch (bop->getBinaryOpType()) {
+      case BinaryOpType::LogicalAnd:
+        return isMonotonic(bop->lhs(), index) &&
+            isMonotonic(bop->rhs(), index);
+      case BinaryOpType::LT:
+      case BinaryOpType::LE:
+      case BinaryOpType::GT:
+      case BinaryOpType::GE:
+        return combine(
+                   direction(bop->lhs(), index),
+                   negate(direction(bop->rhs(), index)))
+            .has_value();
+      default:
+        return direction(pred, index) == 0;
+    }
+  }
+
+  //! Whether the predicate of expr can be removed from the main loop. If so,
+  //! adds the conditions for that to conditions.
+  bool isPeelable(
+      Expr* expr,
+      kir::ForLoop* fl,
+      Val* last,
+      const std::unordered_set<Val*>& inside_vals,
+      std::vector<Val*>& conditions) {
+    auto ite = dynamic_cast<kir::IfThenElse*>(expr);
+    kir::Predicate* pred =
+        ite != nullptr ? ite->predicate() : expr->predicate();
+    if (pred == nullptr || !pred->hasValue() || pred->value()->isConst() ||
+        direction(pred->value(), fl->index()) == 0 ||
+        !isMonotonic(pred->value(), fl->index())) {
+      return false;
+    }
+    Val* first_cond = ir_utils::replaceValRecursively(
+        pred->value(), {{fl->index(), fl->start()}});
+    Val* last_cond =
+        ir_utils::replaceValRecursively(pred->value(), {{fl->index(), last}});
+    if (refersTo(first_cond, inside_vals) ||
+        refersTo(last_cond, inside_vals)) {
+      return false;
+    }
+    conditions.push_back(first_cond);
+    conditions.push_back(last_cond);
+    return true;
+  }
+
+  //! Collects the predicated exprs of scope whose predicates can be removed
+  //! from the main loop, and the conditions that make it valid
+  void collectPeelablePredicates(
+      const kir::Scope& scope,
+      kir::ForLoop* fl,
+      Val* last,
+      const std::unordered_set<Val*>& inside_vals,
+      std::unordered_set<Expr*>& dropped,
+      std::vector<Val*>& conditions) {
+    for (auto expr : scope.exprs()) {
+      if (auto loop = dynamic_cast<kir::ForLoop*>(expr)) {
+        collectPeelablePredicates(
+            loop->body(), fl, last, inside_vals, dropped, conditions);
+        continue;
+      }
+      const bool peelable = isPeelable(expr, fl, last, inside_vals, conditions);
+      if (peelable) {
+        dropped.insert(expr);
+      }
+      if (auto ite = dynamic_cast<kir::IfThenElse*>(expr)) {
+        collectPeelablePredicates(
+            ite->thenBody(), fl, last, inside_vals, dropped, conditions);
+        // The else body of a dropped if-then-else is not in the main loop
+        if (!peelable) {
+          collectPeelablePredicates(
+              ite->elseBody(), fl, last, inside_vals, dropped, conditions);
+        }
+      }
+    }
+  }
+
+  bool peel(kir::ForLoop* fl) {
+    std::unordered_set<Val*> inside_vals{fl->index()};
+    collectInsideVals(fl->body(), inside_vals);
+
+    auto one = IrBuilder::create<Val>(1L, DataType::Index);
+    auto main_stop = IrBuilder::subExpr(fl->stop(), one);
+    auto last = IrBuilder::subExpr(
+        fl->stop(), IrBuilder::create<Val>(2L, DataType::Index));
+
+    directions_.clear();
+    std::unordered_set<Expr*> dropped;
+    std::vector<Val*> conditions;
+    collectPeelablePredicates(
+        fl->body(), fl, last, inside_vals, dropped, conditions);
+    if (dropped.empty()) {
+      return false;
+    }
+
+    // The main loop must have at least one iteration, so that the conditions
+    // are those of its first and last iterations
+    Val* guard =
+        IrBuilder::ltExpr(IrBuilder::addExpr(fl->start(), one), fl->stop());
+    for (auto cond : conditions) {
+      guard = IrBuilder::logicalAndExpr(guard, cond);
+    }
+
+    auto main_loop = IrBuilder::create<kir::ForLoop>(
+        fl->iter_domain(),
+        fl->index(),
+        fl->start(),
+        main_stop,
+        fl->step(),
+        fl->vectorize(),
+        fl->vectorize_shift(),
+        fl->isUnrollRequired(),
+        fl->doubleBufferLoopStage());
+    cloneScope(fl->body(), main_loop->body(), dropped);
+
+    auto last_loop = IrBuilder::create<kir::ForLoop>(
+        fl->iter_domain(),
+        fl->index(),
+        main_stop,
+        fl->stop(),
+        fl->step(),
+        fl->vectorize(),
+        fl->vectorize_shift(),
+        fl->isUnrollRequired(),
+        fl->doubleBufferLoopStage());
+    cloneScope(fl->body(), last_loop->body(), {});
+
+    auto peeled_ite = IrBuilder::create<kir::IfThenElse>(
+        IrBuilder::create<kir::Predicate>(guard));
+    peeled_ite->thenBody().push_back(main_loop);
+    peeled_ite->thenBody().push_back(last_loop);
+    auto original_loop = IrBuilder::create<kir::ForLoop>(fl);
+    cloneScope(fl->body(), original_loop->body(), {});
+    peeled_ite->elseBody().push_back(original_loop);
+
+    kir::ExprMutator::registerReplace(fl, peeled_ite);
+    return true;
+  }
+
+  //! Cache of direction for the loop being peeled
+  std::unordered_map<Val*, Direction> directions_;
+};
+
+} // namespace
+
+std::vector<Expr*> peelLoops(const std::vector<Expr*>& exprs) {
+  if (!isOptionEnabled(EnableOption::LoopPeeling)) {
+    return exprs;
+  }
+  return LoopPeeler::run(exprs);
+}
+
+} // namespace nvfuser
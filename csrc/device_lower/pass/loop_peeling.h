@@ -0,0 +1,48 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <exceptions.h>
+#include <ir/all_nodes.h>
+
+#include <vector>
+
+namespace nvfuser {
+
+//! Peel the last iteration of serial loops whose body is predicated with
+//! conditions that can only fail at the ends of the loop, e.g. the unswitch
+//! and inline predicates of the outer loop of a non-divisible split:
+//!
+//!   for i in [start, stop):
+//!     if (i * 4 + 3 < N) { unpredicated } else { predicated }
+//!
+//! becomes
+//!
+//!   if (start + 1 < stop && start * 4 + 3 < N && (stop - 2) * 4 + 3 < N) {
+//!     for i in [start, stop - 1):
+//!       unpredicated
+//!     for i in [stop - 1, stop):
+//!       if (i * 4 + 3 < N) { unpredicated } else { predicated }
+//!   } else {
+//!     for i in [start, stop):
+//!       if (i * 4 + 3 < N) { unpredicated } else { predicated }
+//!   }
+//!
+//! A predicate is removed from the main loop if it only depends on the loop
+//! index and values computed outside of the loop, and is a conjunction of
+//! comparisons whose sides are monotonic in the loop index, so that holding
+//! for the first and the last iteration of the main loop means holding for
+//! all of them.
+//!
+//! Only serial loops that are not unrolled, double buffered nor contain
+//! block synchronizations are peeled, and only the outermost such loop of a
+//! loop nest, as the body is replicated three times. Runs after
+//! allocateCommonScalars and only if EnableOption::LoopPeeling is set.
+std::vector<Expr*> peelLoops(const std::vector<Expr*>& exprs);
+
+} // namespace nvfuser
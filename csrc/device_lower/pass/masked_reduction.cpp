@@ -0,0 +1,325 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <device_lower/pass/masked_reduction.h>
+
+#include <device_lower/lower2device.h>
+#include <ir/builder.h>
+#include <kernel_ir.h>
+#include <options.h>
+
+#include <c10/util/irange.h>
+
+#include <algorithm>
+#include <unordered_set>
+#include <vector>
+
+namespace nvfuser {
+
+namespace {
+
+TensorView* getView(Val* val) {
+  auto ti = dynamic_cast<kir::TensorIndex*>(val);
+  return ti == nullptr ? nullptr : ti->view();
+}
+
+// Tensors written by exprs, including their nested scopes
+void collectWrittenTvs(
+    const std::vector<Expr*>& exprs,
+    std::unordered_set<TensorView*>& written_tvs) {
+  for (auto expr : exprs) {
+    if (auto loop = dynamic_cast<kir::ForLoop*>(expr)) {
+      collectWrittenTvs(loop->body().exprs(), written_tvs);
+    } else if (auto ite = dynamic_cast<kir::IfThenElse*>(expr)) {
+      collectWrittenTvs(ite->thenBody().exprs(), written_tvs);
+      collectWrittenTvs(ite->elseBody().exprs(), written_tvs);
+    } else {
+      for (auto out : expr->outputs()) {
+        if (auto tv = getView(out)) {
+          written_tvs.insert(tv);
+        }
+      }
+    }
+  }
+}
+
+// Whether expr computes its output in the registers of each thread without
+// communicating with other threads, so that it can be moved or skipped
+bool isThreadLocal(Expr* expr) {
+  if (expr->isOneOf<UnaryOp, BinaryOp, TernaryOp>()) {
+    return true;
+  }
+  if (auto ldst = dynamic_cast<LoadStoreOp*>(expr)) {
+    return ldst->opType() == LoadStoreOpType::Set;
+  }
+  if (auto bop = dynamic_cast<BroadcastOp*>(expr)) {
+    return GpuLower::current()
+        ->threadPredMap()
+        .getParallelBroadcastDomains(getView(bop->out()))
+        .none();
+  }
+  if (auto rop = dynamic_cast<ReductionOp*>(expr)) {
+    auto tv = getView(rop->out());
+    return tv != nullptr && !tv->domain()->hasBlockReduction() &&
+        !tv->domain()->hasGridReduction();
+  }
+  return false;
+}
+
+// Whether some threads can skip exprs, i.e., they don't synchronize threads
+bool isSkippable(const std::vector<Expr*>& exprs) {
+  return std::all_of(exprs.begin(), exprs.end(), [](Expr* expr) {
+    if (auto loop = dynamic_cast<kir::ForLoop*>(expr)) {
+      return isSkippable(loop->body().exprs());
+    }
+    if (auto ite = dynamic_cast<kir::IfThenElse*>(expr)) {
+      return isSkippable(ite->thenBody().exprs()) &&
+          isSkippable(ite->elseBody().exprs());
+    }
+    if (auto alloc = dynamic_cast<kir::Allocate*>(expr)) {
+      return alloc->memoryType() == MemoryType::Local;
+    }
+    return isThreadLocal(expr);
+  });
+}
+
+class MaskedReductionSkipper {
+ public:
+  static std::vector<Expr*> run(const std::vector<Expr*>& exprs) {
+    MaskedReductionSkipper skipper(exprs);
+    return skipper.skipInScope(exprs);
+  }
+
+ private:
+  MaskedReductionSkipper(const std::vector<Expr*>& exprs) {
+    collectAliasedBuffers(exprs);
+  }
+
+  // Buffers that share their memory with others can't be written earlier
+  void collectAliasedBuffers(const std::vector<Expr*>& exprs) {
+    for (auto expr : exprs) {
+      if (auto loop = dynamic_cast<kir::ForLoop*>(expr)) {
+        collectAliasedBuffers(loop->body().exprs());
+      } else if (auto ite = dynamic_cast<kir::IfThenElse*>(expr)) {
+        collectAliasedBuffers(ite->thenBody().exprs());
+        collectAliasedBuffers(ite->elseBody().exprs());
+      } else if (auto alloc = dynamic_cast<kir::Allocate*>(expr)) {
+        if (alloc->alias() != nullptr) {
+          aliased_buffers_.insert(alloc->buffer());
+          aliased_buffers_.insert(alloc->alias()->buffer());
+        }
+      }
+    }
+  }
+
+  std::vector<Expr*> skipInScope(std::vector<Expr*> exprs) {
+    for (auto expr : exprs) {
+      if (auto loop = dynamic_cast<kir::ForLoop*>(expr)) {
+        replaceScope(loop->body());
+      } else if (auto ite = dynamic_cast<kir::IfThenElse*>(expr)) {
+        replaceScope(ite->thenBody());
+        replaceScope(ite->elseBody());
+      }
+    }
+    for (size_t i = 0; i < exprs.size(); ++i) {
+      maybeSkipLoop(exprs, i);
+    }
+    return exprs;
+  }
+
+  void replaceScope(kir::Scope& scope) {
+    auto exprs = skipInScope(scope.exprs());
+    scope.clear();
+    for (auto expr : exprs) {
+      scope.push_back(expr);
+    }
+  }
+
+  // Wraps exprs[loop_pos] in an IfThenElse on the mask of the where
+  // consuming its reduction if possible
+  void maybeSkipLoop(std::vector<Expr*>& exprs, size_t loop_pos) {
+    auto loop = dynamic_cast<kir::ForLoop*>(exprs.at(loop_pos));
+    if (loop == nullptr || loop->isTrivial() ||
+        !isSkippable(loop->body().exprs())) {
+      return;
+    }
+    std::unordered_set<TensorView*> loop_tvs;
+    collectWrittenTvs({loop}, loop_tvs);
+
+    // The first where after the loop selecting a reduction of the loop
+    size_t where_pos = loop_pos + 1;
+    TernaryOp* where = nullptr;
+    TensorView* reduction_tv = nullptr;
+    for (; where_pos < exprs.size(); ++where_pos) {
+      auto top = dynamic_cast<TernaryOp*>(exprs.at(where_pos));
+      if (top == nullptr || top->getTernaryOpType() != TernaryOpType::Where) {
+        continue;
+      }
+      auto in2 = getView(top->in2());
+      auto in3 = getView(top->in3());
+      if (loop_tvs.count(in2) == 0 && loop_tvs.count(in3) == 0) {
+        continue;
+      }
+      // Only one of the branches can be skipped
+      if (loop_tvs.count(in2) != 0 && loop_tvs.count(in3) != 0) {
+        return;
+      }
+      where = top;
+      reduction_tv = loop_tvs.count(in2) != 0 ? in2 : in3;
+      break;
+    }
+    if (where == nullptr || getView(where->in1()) == nullptr ||
+        !isOnlyUsedByWhere(reduction_tv, loop_tvs)) {
+      return;
+    }
+
+    // Exprs between the loop and the where computing the mask, which are
+    // moved before the loop
+    std::vector<Expr*> moved_exprs;
+    if (!collectMaskExprs(
+            exprs,
+            loop_pos,
+            where_pos,
+            getView(where->in1()),
+            loop_tvs,
+            moved_exprs)) {
+      return;
+    }
+
+    Val* pred = where->in1();
+    if (getView(where->in3()) == reduction_tv) {
+      pred = IrBuilder::logicalNotExpr(pred);
+    }
+    auto ite = IrBuilder::create<kir::IfThenElse>(
+        IrBuilder::create<kir::Predicate>(pred));
+    ite->thenBody().push_back(loop);
+
+    std::vector<Expr*> new_exprs(
+        exprs.begin(), exprs.begin() + (int64_t)loop_pos);
+    new_exprs.insert(new_exprs.end(), moved_exprs.begin(), moved_exprs.end());
+    new_exprs.push_back(ite);
+    std::unordered_set<Expr*> moved(moved_exprs.begin(), moved_exprs.end());
+    std::copy_if(
+        exprs.begin() + (int64_t)loop_pos + 1,
+        exprs.end(),
+        std::back_inserter(new_exprs),
+        [&](Expr* expr) { return moved.count(expr) == 0; });
+    exprs = std::move(new_exprs);
+  }
+
+  // Whether reduction_tv is a reduction whose only use is a where, and the
+  // other tensors written by the loop are only used in the loop
+  bool isOnlyUsedByWhere(
+      TensorView* reduction_tv,
+      const std::unordered_set<TensorView*>& loop_tvs) const {
+    if (!reduction_tv->definition()->isA<ReductionOp>() ||
+        reduction_tv->isFusionOutput() || reduction_tv->uses().size() != 1) {
+      return false;
+    }
+    auto where = dynamic_cast<TernaryOp*>(reduction_tv->uses().at(0));
+    if (where == nullptr ||
+        where->getTernaryOpType() != TernaryOpType::Where) {
+      return false;
+    }
+    return std::all_of(loop_tvs.begin(), loop_tvs.end(), [&](TensorView* tv) {
+      if (tv == reduction_tv) {
+        return true;
+      }
+      if (tv->isFusionOutput()) {
+        return false;
+      }
+      return std::all_of(tv->uses().begin(), tv->uses().end(), [&](Expr* use) {
+        return std::all_of(
+            use->outputs().begin(), use->outputs().end(), [&](Val* out) {
+              return out->isA<TensorView>() &&
+                  loop_tvs.count(out->as<TensorView>()) != 0;
+            });
+      });
+    });
+  }
+
+  // Collects the exprs and allocations between loop_pos and where_pos that
+  // mask_tv depends on in moved_exprs, in their order. Returns false if the
+  // mask depends on the loop or is computed in nested scopes.
+  bool collectMaskExprs(
+      const std::vector<Expr*>& exprs,
+      size_t loop_pos,
+      size_t where_pos,
+      TensorView* mask_tv,
+      const std::unordered_set<TensorView*>& loop_tvs,
+      std::vector<Expr*>& moved_exprs) const {
+    std::unordered_set<TensorView*> nested_tvs;
+    for (auto i : c10::irange(loop_pos + 1, where_pos)) {
+      auto expr = exprs.at(i);
+      if (expr->isOneOf<kir::ForLoop, kir::IfThenElse>()) {
+        collectWrittenTvs({expr}, nested_tvs);
+      }
+    }
+
+    std::unordered_set<TensorView*> mask_tvs;
+    std::vector<TensorView*> to_visit{mask_tv};
+    while (!to_visit.empty()) {
+      auto tv = to_visit.back();
+      to_visit.pop_back();
+      if (!mask_tvs.insert(tv).second) {
+        continue;
+      }
+      if (loop_tvs.count(tv) != 0 || nested_tvs.count(tv) != 0 ||
+          aliased_buffers_.count(tv) != 0) {
+        return false;
+      }
+      for (auto i : c10::irange(loop_pos + 1, where_pos)) {
+        auto expr = exprs.at(i);
+        if (std::none_of(
+                expr->outputs().begin(), expr->outputs().end(), [&](Val* out) {
+                  return getView(out) == tv;
+                })) {
+          continue;
+        }
+        if (!isThreadLocal(expr)) {
+          return false;
+        }
+        for (auto inp : expr->inputs()) {
+          if (auto inp_tv = getView(inp)) {
+            to_visit.push_back(inp_tv);
+          }
+        }
+      }
+    }
+
+    for (auto i : c10::irange(loop_pos + 1, where_pos)) {
+      auto expr = exprs.at(i);
+      if (auto alloc = dynamic_cast<kir::Allocate*>(expr)) {
+        if (mask_tvs.count(dynamic_cast<TensorView*>(alloc->buffer())) != 0) {
+          moved_exprs.push_back(expr);
+        }
+        continue;
+      }
+      if (std::any_of(
+              expr->outputs().begin(), expr->outputs().end(), [&](Val* out) {
+                return mask_tvs.count(getView(out)) != 0;
+              })) {
+        moved_exprs.push_back(expr);
+      }
+    }
+    return true;
+  }
+
+ private:
+  std::unordered_set<Val*> aliased_buffers_;
+};
+
+} // namespace
+
+std::vector<Expr*> skipMaskedReductions(const std::vector<Expr*>& exprs) {
+  if (!isOptionEnabled(EnableOption::SkipMaskedReductions)) {
+    return exprs;
+  }
+  return MaskedReductionSkipper::run(exprs);
+}
+
+} // namespace nvfuser
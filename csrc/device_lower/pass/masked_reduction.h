@@ -0,0 +1,45 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <exceptions.h>
+#include <ir/all_nodes.h>
+
+#include <vector>
+
+namespace nvfuser {
+
+//! Skip the serial reduction loops of the elements that a where replaces
+//! afterward, e.g., the scores above the diagonal of a causal attention mask
+//! built from iota comparisons:
+//!
+//!   FOR i.. (serial reduction loop)
+//!     T3[0] += T1[...] * T2[...];
+//!   b4[0] = T5[0] >= T6[0];
+//!   T7[0] = where(b4[0], T3[0], -inf);
+//!
+//! becomes
+//!
+//!   b4[0] = T5[0] >= T6[0];
+//!   if (b4[0]) {
+//!     FOR i..
+//!       T3[0] += T1[...] * T2[...];
+//!   }
+//!   T7[0] = where(b4[0], T3[0], -inf);
+//!
+//! The mask is moved before the loop, which is only done if it does not
+//! depend on the loop and is computed in the same scope as the where. The
+//! loop must not synchronize threads, e.g., with block or grid reductions,
+//! and the tensors it writes may only be used by the loop itself, except for
+//! the reduction consumed by the where.
+//!
+//! Runs after IndexLowering and only if EnableOption::SkipMaskedReductions is
+//! set.
+std::vector<Expr*> skipMaskedReductions(const std::vector<Expr*>& exprs);
+
+} // namespace nvfuser
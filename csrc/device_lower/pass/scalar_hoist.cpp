@@ -7,13 +7,19 @@
 // clang-format on
 #include <device_lower/lower2device.h>
 #include <device_lower/pass/magic_zero.h>
+#include <device_lower/utils.h>
 #include <expr_simplifier.h>
 #include <iter_visitor.h>
 #include <kernel_ir_dispatch.h>
 #include <options.h>
+#include <utils.h>
 
 #include <device_lower/pass/scalar_hoist.h>
 
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+
 namespace nvfuser {
 
 namespace {
@@ -163,6 +169,31 @@ bool isHelpfulToReuse(Val* value) {
   return true;
 }
 
+// Whether the definition of value divides by a non-constant. Such divisors
+// may be zero on the host, e.g. the extents of empty tensors, while the
+// kernel never evaluates the division.
+bool hasNonConstantDivisor(Val* value) {
+  auto def = value->definition();
+  if (def == nullptr || value->isA<kir::TensorIndex>()) {
+    return false;
+  }
+  if (auto bop = dynamic_cast<BinaryOp*>(def)) {
+    switch (bop->getBinaryOpType()) {
+      case BinaryOpType::Div:
+      case BinaryOpType::Mod:
+      case BinaryOpType::CeilDiv:
+        if (!bop->rhs()->isConstScalar()) {
+          return true;
+        }
+        break;
+      default:
+        break;
+    }
+  }
+  return std::any_of(
+      def->inputs().begin(), def->inputs().end(), hasNonConstantDivisor);
+}
+
 // Find if the given `value` is already computed on the host. If yes, then
 // return the host value, else return nullptr.
 Val* reuseValsKnownToKernel(Val* value) {
@@ -223,6 +254,19 @@ std::pair<Val*, bool> CommonScalarMap::hoistScalarImpl(
     return {value, false};
   }
 
+  // Top-level values that only depend on the metadata of inputs, like
+  // products of extents, are evaluated by the host and passed as kernel
+  // parameters instead of being computed by every thread.
+  if (my_pos < 0 && isOptionEnabled(EnableOption::HostIndexHoist) &&
+      isHelpfulToReuse(value) && lower_utils::isHostComputable(value) &&
+      !hasNonConstantDivisor(value)) {
+    if (auto known_val = reuseValsKnownToKernel(value)) {
+      return {known_val, false};
+    }
+    GpuLower::current()->allKnownVals().emplace_back(value);
+    return {value, false};
+  }
+
   // Check if `value` is already computed. If yes, just reuse it and return.
   if (auto existing_subexpr = reuseScalarIfAlreadyComputed(value, my_loop)) {
     return {existing_subexpr, false};
@@ -361,13 +405,55 @@ std::vector<Val*> getAssumptions(const std::vector<kir::ForLoop*>& loops) {
   return assumptions;
 }
 
+// Hash of the scalar expression of value that is consistent with sameAs,
+// i.e. values that are sameAs have the same hash. hashes caches the hashes
+// of the subexpressions, which are often shared.
+size_t structuralHash(Val* value, std::unordered_map<Val*, size_t>& hashes) {
+  if (auto it = hashes.find(value); it != hashes.end()) {
+    return it->second;
+  }
+  size_t hash = typeid(*value).hash_code();
+  if (auto def = value->definition()) {
+    hashCombine(hash, typeid(*def).hash_code());
+    for (auto input : def->inputs()) {
+      hashCombine(hash, structuralHash(input, hashes));
+    }
+  } else if (auto ns = dynamic_cast<NamedScalar*>(value)) {
+    hashCombine(hash, std::hash<std::string>()(ns->name()));
+  } else if (value->value().is<int64_t>()) {
+    hashCombine(hash, std::hash<int64_t>()(value->value().as<int64_t>()));
+  } else if (!value->value().hasValue()) {
+    // Symbolic values without definitions are only sameAs themselves
+    hashCombine(hash, std::hash<Val*>()(value));
+  }
+  hashes.emplace(value, hash);
+  return hash;
+}
+
 } // namespace
 
-Val* CommonScalarMap::hoistScalar(
+Val* CommonScalarMap::simplifyScalar(
     Val* value,
     const std::vector<kir::ForLoop*>& loops) {
-  value =
+  std::unordered_map<Val*, size_t> hashes;
+  const size_t hash = structuralHash(value, hashes);
+  auto [begin, end] = simplified_scalars_.equal_range(hash);
+  for (auto it = begin; it != end; ++it) {
+    const SimplifiedScalar& entry = it->second;
+    if (entry.loops == loops && entry.value->sameAs(value)) {
+      return entry.simplified;
+    }
+  }
+  Val* simplified =
       simplifyExpr(value, getVariableInfo(value, loops), getAssumptions(loops));
+  simplified_scalars_.emplace(hash, SimplifiedScalar{value, loops, simplified});
+  return simplified;
+}
+
+Val* CommonScalarMap::hoistScalar(
+    Val* value,
+    const std::vector<kir::ForLoop*>& loops) {
+  value = simplifyScalar(value, loops);
   std::vector<Val*> seen_subexprs;
   return hoistScalarImpl(
              value,
@@ -425,6 +511,11 @@ std::vector<Val*> CommonScalarMap::getHoistedScalars(kir::ForLoop* loop) const {
   return result;
 }
 
+void CommonScalarMap::hoistToTopLevel(Val* value) {
+  common_scalar_map_[nullptr].emplace_back(value);
+  hoisted_or_reused_.emplace(value);
+}
+
 void CommonScalarMap::initialize(const std::vector<Expr*> exprs) {
   // We only hoist scalars not depending on tensors. In lowered expressions, all
   // these scalars are computed in top level scope.
@@ -57,6 +57,11 @@ class CommonScalarMap {
   //! allocation.
   std::vector<Val*> getHoistedScalars(kir::ForLoop* loop) const;
 
+  //! Insert value, which must only depend on values available in the top
+  //! level scope, to common_scalar_map_[nullptr], and make it get its own
+  //! allocation there, even if it is used only once.
+  void hoistToTopLevel(Val* value);
+
   //! Initialize the common_scalar_map_ with lowered exprs. If some scalar is
   //! already computed in these lowered exprs and is recomputed in indexing or
   //! predicate math, then we should reuse these existing computation.
@@ -96,7 +101,18 @@ class CommonScalarMap {
   //! return nullptr.
   Val* reuseScalarIfAlreadyComputed(Val* value, kir::ForLoop* loop);
 
+  //! Simplify value with the variables and assumptions of loops. Lowering
+  //! hoists many values that are sameAs each other, e.g. the same index in
+  //! the indexing and the predicates of an expression, so the results are
+  //! memoized and those values are only simplified once per loop nest.
+  Val* simplifyScalar(Val* value, const std::vector<kir::ForLoop*>& loops);
+
  private:
+  struct SimplifiedScalar {
+    Val* value = nullptr;
+    std::vector<kir::ForLoop*> loops;
+    Val* simplified = nullptr;
+  };
   //! Map to hold hoisted common indices. The order matters and indicates data
   //! dependency. For example, my list might have [i1*4, i1*4+2, i1*4/16]
   std::unordered_map<kir::ForLoop*, std::list<Val*>> common_scalar_map_;
@@ -106,6 +122,9 @@ class CommonScalarMap {
   //! computation of this expression is hoisted to an outer loop) or reused (one
   //! expression is used in multiple indices/predicates).
   std::unordered_set<Val*> hoisted_or_reused_;
+
+  //! Results of simplifyScalar keyed by the structural hash of the value
+  std::unordered_multimap<size_t, SimplifiedScalar> simplified_scalars_;
 };
 
 //! Insert allocations of hoisted indices. Must be called after
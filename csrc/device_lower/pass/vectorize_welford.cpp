@@ -12,6 +12,7 @@
 #include <dispatch.h>
 #include <instrumentation.h>
 #include <ir/utils.h>
+#include <iter_visitor.h>
 #include <kernel_ir_dispatch.h>
 #include <ops/arith.h>
 
@@ -19,6 +20,12 @@ namespace nvfuser {
 
 namespace {
 
+// Whether wop combines partial (avg, var, N) states, e.g., of a
+// previous welford, rather than single items
+bool isPartialStateWelford(WelfordOp* wop) {
+  return !wop->inVar()->isZeroInt() || !wop->inN()->isOneInt();
+}
+
 // Vectorize serial WelfordOp, in other words hoists loop-invariant
 // expressions out of a loop that is exactly mapped with a vectorized
 // IterDomain.
@@ -109,12 +116,15 @@ class WelfordVectorizer : public kir::ExprMutator {
       return false;
     }
 
+    if (out_domain->hasBlockReduction() || out_domain->hasGridReduction()) {
+      return false;
+    }
+
     // This optimization should be safe for the initial sequential
     // welford, where the var and N arguments are zero and one,
-    // respectively. It should also be mostly safe otherwise, but not
-    // guaranteed.
-    if (out_domain->hasBlockReduction() || out_domain->hasGridReduction() ||
-        !wop->inVar()->isZeroInt() || !wop->inN()->isOneInt()) {
+    // respectively. Partial states are combined as well if their count
+    // is invariant in the loop, like the count of the output
+    if (isPartialStateWelford(wop) && !isInvariantCount(wop->inN())) {
       return false;
     }
 
@@ -153,6 +163,34 @@ class WelfordVectorizer : public kir::ExprMutator {
     return true;
   }
 
+  // Check if the count of the partial states combined in the innermost
+  // loop is invariant in the loop. A count tensor of a welford is
+  // assumed to have the same value for all the items of the loop, which
+  // is also assumed for the output count by hoistCount. It must not be
+  // written in the loop, as it is read before the loop.
+  bool isInvariantCount(Val* in_N) const {
+    NVF_ERROR(!for_loops_.empty());
+    auto innermost_loop = for_loops_.back();
+    auto ti = dynamic_cast<kir::TensorIndex*>(in_N);
+    if (ti == nullptr) {
+      return !DependencyCheck::isDependencyOf(
+          innermost_loop->indexOrStartIfTrivial(), in_N);
+    }
+    auto def = ti->view()->definition();
+    if (def == nullptr || !def->isOneOf<WelfordOp, GroupedWelfordOp>()) {
+      return false;
+    }
+    const auto loop_exprs =
+        ir_utils::flattenScopedExprs(innermost_loop->body().exprs());
+    return std::none_of(loop_exprs.begin(), loop_exprs.end(), [&](Expr* expr) {
+      return std::any_of(
+          expr->outputs().begin(), expr->outputs().end(), [&](Val* out) {
+            auto out_ti = dynamic_cast<kir::TensorIndex*>(out);
+            return out_ti != nullptr && out_ti->view() == ti->view();
+          });
+    });
+  }
+
   // Transform a serial WelfordOp.
   void vectorize(WelfordOp* wop) {
     NVF_ERROR(!scope_exprs_.empty());
@@ -319,6 +357,15 @@ class WelfordVectorizer : public kir::ExprMutator {
       pred = GpuLower::current()->kernel()->trueVal();
     }
 
+    // The count of the combined partial states, or nullptr if single
+    // items are combined
+    Val* in_count = nullptr;
+    if (isPartialStateWelford(wop)) {
+      in_count = wop->inN()->isA<kir::TensorIndex>()
+          ? hoistCount(wop->inN()->as<kir::TensorIndex>())
+          : wop->inN();
+    }
+
     // nvfuser_index_t new_count;
     // new_count = hoisted_count + count_increment
 
@@ -328,12 +375,24 @@ class WelfordVectorizer : public kir::ExprMutator {
 
     Val* count_increment = nullptr;
     if (!is_predicated) {
-      count_increment = GpuLower::current()->kernel()->oneVal();
+      count_increment = in_count != nullptr
+          ? in_count
+          : GpuLower::current()->kernel()->oneVal();
     } else {
       // count_increment = (int)pred;
       count_increment = defineScalar(index_type);
       registerInsertBeforeInnerMostLoop(
           IrBuilder::create<UnaryOp>(UnaryOpType::Cast, count_increment, pred));
+      if (in_count != nullptr) {
+        // count_increment = (int)pred * in_count;
+        auto predicated_in_count = defineScalar(index_type);
+        registerInsertBeforeInnerMostLoop(IrBuilder::create<BinaryOp>(
+            BinaryOpType::Mul,
+            predicated_in_count,
+            count_increment,
+            in_count));
+        count_increment = predicated_in_count;
+      }
     }
 
     registerInsertBeforeInnerMostLoop(IrBuilder::create<BinaryOp>(
@@ -349,16 +408,47 @@ class WelfordVectorizer : public kir::ExprMutator {
     // float reciprocal;
     auto reciprocal = defineScalar(data_type);
 
+    // The ratio of the count of the combined state to the new count,
+    // which is just the reciprocal of the new count for single items
+    Val* numerator = GpuLower::current()->kernel()->oneVal();
+    if (in_count != nullptr) {
+      // float in_count_float = (float)in_count;
+      numerator = defineScalar(data_type);
+      registerInsertBeforeInnerMostLoop(
+          IrBuilder::create<UnaryOp>(UnaryOpType::Cast, numerator, in_count));
+    }
+
     auto reciprocal_expr = IrBuilder::create<BinaryOp>(
-        BinaryOpType::Div,
-        reciprocal,
-        GpuLower::current()->kernel()->oneVal(),
-        new_count_float);
+        BinaryOpType::Div, reciprocal, numerator, new_count_float);
+
+    // Partial states may have zero counts, in which case the new count
+    // can be zero as well
+    Val* reciprocal_pred = pred;
+    if (in_count != nullptr) {
+      // bool nonzero_count = new_count > 0;
+      auto nonzero_count = defineScalar(DataType::Bool);
+      registerInsertBeforeInnerMostLoop(IrBuilder::create<BinaryOp>(
+          BinaryOpType::GT,
+          nonzero_count,
+          new_count,
+          GpuLower::current()->kernel()->zeroVal()));
+      if (is_predicated) {
+        // nonzero_count = nonzero_count && pred;
+        auto predicated_nonzero_count = defineScalar(DataType::Bool);
+        registerInsertBeforeInnerMostLoop(IrBuilder::create<BinaryOp>(
+            BinaryOpType::LogicalAnd,
+            predicated_nonzero_count,
+            nonzero_count,
+            pred));
+        nonzero_count = predicated_nonzero_count;
+      }
+      reciprocal_pred = nonzero_count;
+    }
 
     // If not predicated, just set the reciprocal variable
     // with the reciprocl expr. Otherwise, guard it with an if
     // statement.
-    if (!is_predicated) {
+    if (!is_predicated && in_count == nullptr) {
       registerInsertBeforeInnerMostLoop(reciprocal_expr);
     } else {
       // Initialize reciprocal as 0;
@@ -369,7 +459,7 @@ class WelfordVectorizer : public kir::ExprMutator {
 
       // if (pred) reciprocal = 1 / new_count_float;
       auto reciprocal_ite = IrBuilder::create<kir::IfThenElse>(
-          IrBuilder::create<kir::Predicate>(pred));
+          IrBuilder::create<kir::Predicate>(reciprocal_pred));
       registerInsertBeforeInnerMostLoop(reciprocal_ite);
       registerInsertBefore(
           nullptr, reciprocal_expr, &(reciprocal_ite->thenBody()));
@@ -40,6 +40,12 @@ class Expr;
 // non-reduction domain and is vectorized, so the prediacte should not
 // have any dependency with the loop index, which enables the code
 // moition as the above.
+//
+// WelfordOps combining partial states, e.g., the per-thread results
+// of a previous welford merged in a grid-persistent kernel, are
+// transformed as well if the count of the partial states is invariant
+// in the loop. The ratio of that count to the new count then replaces
+// the reciprocal.
 std::vector<Expr*> vectorizeWelford(const std::vector<Expr*>& exprs);
 
 } // namespace nvfuser
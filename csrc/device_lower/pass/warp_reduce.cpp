@@ -5,11 +5,11 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 // clang-format on
-#include <ATen/cuda/CUDAContext.h>
 #include <device_lower/lower2device.h>
 #include <device_lower/pass/warp_reduce.h>
 #include <device_lower/utils.h>
 #include <expr_evaluator.h>
+#include <ir/builder.h>
 #include <ir/internal_nodes.h>
 #include <ir/utils.h>
 #include <kernel_ir_dispatch.h>
@@ -129,6 +129,51 @@ class EliminateDeadBroadcastAndAllocate {
   std::unordered_set<TensorView*> candidate_tv_set_;
 };
 
+//! Replaces the warp reductions whose broadcasts are fused by
+//!  FuseBroadcastWithWarpReduce with allreduce ones, so that all threads
+//!  get the reduction results.
+class MarkWarpAllreduce : private kir::ExprMutator {
+ public:
+  static std::vector<Expr*> run(
+      const std::vector<Expr*>& exprs,
+      const std::unordered_set<TensorView*>& allreduce_tvs) {
+    if (allreduce_tvs.empty()) {
+      return exprs;
+    }
+    return MarkWarpAllreduce(exprs, allreduce_tvs).exprs_;
+  }
+
+ private:
+  MarkWarpAllreduce(
+      const std::vector<Expr*>& exprs,
+      const std::unordered_set<TensorView*>& allreduce_tvs)
+      : allreduce_tvs_(allreduce_tvs) {
+    traverseAndInsert(exprs);
+  }
+
+  using kir::ExprMutator::handle;
+
+  void handle(ReductionOp* reduction) final {
+    auto out_ti = dynamic_cast<kir::TensorIndex*>(reduction->out());
+    if (out_ti == nullptr || reduction->isAllreduce() ||
+        !allreduce_tvs_.count(out_ti->view())) {
+      return;
+    }
+    auto allreduce = IrBuilder::create<ReductionOp>(
+                         reduction->getReductionOpType(),
+                         reduction->init(),
+                         reduction->out(),
+                         reduction->in(),
+                         /*is_allreduce=*/true)
+                         ->withPredicate(reduction->predicate())
+                         ->withWritePredicate(reduction->writePredicate());
+    registerReplace(reduction, allreduce);
+  }
+
+ private:
+  const std::unordered_set<TensorView*>& allreduce_tvs_;
+};
+
 //! A pass to eliminate redundant parallel broadcasts that are consumers
 //!  of warp reduction.
 //! Detects the following pattern:
@@ -138,9 +183,9 @@ class EliminateDeadBroadcastAndAllocate {
 //!     T1[0] = warp_reduce (T0[0])
 //!     T2[0] = block_broadcast (T1[0])
 //!
-//!  The block_broadcast can then be eliminated given that both the warp
-//!   reduce and the broadcast are known in compile-time to be parallelized
-//!   on a single warp only.
+//!  The block_broadcast can then be eliminated given that the reduction is
+//!   known in compile-time to be a warp reduction and the broadcast is only
+//!   parallelized on TIDx. The warp reduction is then marked as allreduce.
 //!
 //!  Currently only limited to buffers of size-1 to avoid having to
 //!   re-run indexing
@@ -161,7 +206,9 @@ class FuseBroadcastWithWarpReduce : private kir::IrVisitor {
     FuseBroadcastWithWarpReduce fuse_broadcast_map(exprs);
     const auto replaced_inputs = ir_utils::replaceInputsInExpr(
         exprs, fuse_broadcast_map.val_replacement_map_);
-    return EliminateDeadBroadcastAndAllocate::run(replaced_inputs);
+    return MarkWarpAllreduce::run(
+        EliminateDeadBroadcastAndAllocate::run(replaced_inputs),
+        fuse_broadcast_map.allreduce_tvs_);
   }
 
  private:
@@ -378,64 +425,42 @@ class FuseBroadcastWithWarpReduce : private kir::IrVisitor {
       //  so the future uses of this tv will put
       //  the tensorIndex's in the actual replacement map.
       running_tv_replacement_map_[out_tv] = in_ti;
+      allreduce_tvs_.insert(in_ti->view());
     }
   }
 
-  // Checks if the given IterDomain is mapped to a single warp,
-  //  i.e. they are known at compile time to be of constant
-  //   size of warp_size and they are paralleled on TIDx
-  int warp_size = at::cuda::warp_size();
-  bool isSingleWarp(IterDomain* id) {
-    if (id->getParallelType() != ParallelType::TIDx) {
-      return false;
-    }
-
-    if (!GpuLower::current()->getWarpPaddedParallelInfo().is_tidx_single_warp) {
-      return false;
-    }
-
-    // Prioritize checking for padded dimension
-    if (id->getMaybeSizeAfterPadding().has_value()) {
-      return id->getMaybeSizeAfterPadding().value() == warp_size;
-    }
-
-    if (id->extent()->isConstScalar()) {
-      return id->extent()->evaluate() == warp_size;
-    }
-
-    return false;
-  }
-
   // Check if this broadcast can be fused with the producer reduction
   //  Assumes:
   //   1. Already checked the producer of input is a reduction
   //   2. Already checked the producer reduction is in the same loop nest
   //  Checks:
-  //   1. Reduction is only non-trivially parallel on TIDx as a single warp
-  //   2. Broadcast is only non-trivially parallel on TIDx as a single warp
+  //   1. Reduction is a warp reduction, i.e., only non-trivially parallel on
+  //      TIDx with a multiple of the warp size
+  //   2. Broadcast is only non-trivially parallel on TIDx
+  //  Warp reductions of more than a single warp broadcast their results to
+  //  all threads through shared memory when marked as allreduce, which is
+  //  cheaper than a separate block broadcast.
   bool canFuseBroadcastWithWarpReduction(BroadcastOp* broadcast) {
     auto reduction_out_tv = broadcast->in()->as<TensorView>();
     auto broadcast_out_tv = broadcast->out()->as<TensorView>();
+    auto reduction = reduction_out_tv->definition()->as<ReductionOp>();
 
-    bool reduction_has_single_warp = false, broadcast_has_single_warp = false;
-
-    for (auto id : reduction_out_tv->getLeafDomain()) {
-      if (id->isReduction() && id->isThread() && !isSingleWarp(id)) {
-        return false;
-      }
-      if (id->isReduction() && isSingleWarp(id)) {
-        reduction_has_single_warp = true;
-      }
+    if (!ir_utils::getMaybeWarpReductionDim(
+            reduction->out(), reduction->in())) {
+      return false;
     }
+
+    bool broadcast_on_tidx = false;
     for (auto id : broadcast_out_tv->getLeafDomain()) {
-      if (id->isBroadcast() && id->isThread() && !isSingleWarp(id)) {
-        return false;
+      if (!id->isBroadcast() || !id->isThread()) {
+        continue;
       }
-      if (id->isBroadcast() && isSingleWarp(id)) {
-        broadcast_has_single_warp = true;
+      if (id->getParallelType() != ParallelType::TIDx) {
+        return false;
       }
+      broadcast_on_tidx = true;
     }
-    return reduction_has_single_warp && broadcast_has_single_warp;
+    return broadcast_on_tidx;
   }
 
  private:
@@ -468,6 +493,10 @@ class FuseBroadcastWithWarpReduce : private kir::IrVisitor {
   //!  TensorIndex is uniquely generated by lower_index pass for each access of
   //!  a tv.
   std::unordered_map<Val*, Val*> val_replacement_map_;
+
+  //! Outputs of the reductions whose results are used in place of their
+  //!  broadcasts
+  std::unordered_set<TensorView*> allreduce_tvs_;
 };
 
 } // namespace
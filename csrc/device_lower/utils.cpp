@@ -188,9 +188,32 @@ bool isCpAsyncOp(const Expr* expr) {
 
 namespace {
 
-enum class CpAsyncBulkTileType { G2S, S2G, NotACpAsyncBulkTile };
+enum class CpAsyncBulkTileType {
+  G2S,
+  S2G,
+  S2GReduce,
+  NotACpAsyncBulkTile
+};
 
 inline CpAsyncBulkTileType getCpAsyncBulkTileType(const Expr* expr) {
+  // Atomic grid reductions of a shared memory tile into a Bulk parallelized
+  // output are lowered to cp.reduce.async.bulk.tensor
+  if (auto rop = dynamic_cast<const ReductionOp*>(expr)) {
+    auto in_tv = getTv(rop->in());
+    auto out_tv = getTv(rop->out());
+    if (rop->atomicGridReductionRequested() && in_tv != nullptr &&
+        out_tv != nullptr && in_tv->getMemoryType() == MemoryType::Shared &&
+        out_tv->getMemoryType() == MemoryType::Global &&
+        std::any_of(
+            out_tv->getLeafDomain().begin(),
+            out_tv->getLeafDomain().end(),
+            [](IterDomain* id) {
+              return id->getParallelType() == ParallelType::Bulk;
+            })) {
+      return CpAsyncBulkTileType::S2GReduce;
+    }
+    return CpAsyncBulkTileType::NotACpAsyncBulkTile;
+  }
   if (auto ldst = dynamic_cast<const LoadStoreOp*>(expr)) {
     if (ldst->opType() == LoadStoreOpType::CpAsyncBulkTensorTile) {
       if (getTv(ldst->in())->getMemoryType() == MemoryType::Global &&
@@ -223,6 +246,10 @@ bool isCpAsyncBulkStore(const Expr* expr) {
   return getCpAsyncBulkTileType(expr) == CpAsyncBulkTileType::S2G;
 }
 
+bool isCpAsyncBulkReduction(const Expr* expr) {
+  return getCpAsyncBulkTileType(expr) == CpAsyncBulkTileType::S2GReduce;
+}
+
 bool isTensorScalarFillOp(const Expr* expr) {
   // Check that the input is a single scalar.
   if (expr->inputs().size() == 1 && expr->input(0)->isScalar()) {
@@ -818,6 +845,22 @@ bool isScalarExpr(Expr* expr) {
   return true;
 }
 
+bool isHostComputable(Val* val) {
+  if (auto tv = dynamic_cast<TensorView*>(val)) {
+    return tv->isFusionInput();
+  }
+  if (val->isA<kir::TensorIndex>()) {
+    return false;
+  }
+  auto def = val->definition();
+  if (def == nullptr) {
+    return val->isConst() || val->isFusionInput();
+  }
+  return std::all_of(def->inputs().begin(), def->inputs().end(), [](Val* inp) {
+    return isHostComputable(inp);
+  });
+}
+
 bool isExtentEqualToMaxParallelTypeExtent(const IterDomain* id) {
   const auto& parallel_dim_map = GpuLower::current()->parallelDimensionMap();
   auto* pdm_max_extent = parallel_dim_map.getRaw(id->getParallelType());
@@ -837,6 +880,15 @@ Val* u32IndexScalarSmemTv(TensorView* smem_tv) {
   return u32addr;
 }
 
+Val* u32IndexSmemTv(TensorView* smem_tv, Val* index) {
+  auto index_bytes = SimplifyingIrBuilder::mulExpr(
+      index,
+      IrBuilder::create<Val>(
+          (int64_t)dataTypeSize(smem_tv->dtype()), *index->getDataType()));
+  return SimplifyingIrBuilder::addExpr(
+      u32IndexScalarSmemTv(smem_tv), index_bytes);
+}
+
 Val* getGridSyncBufferSize(const ParallelTypeBitmap& ptb) {
   // See the comment above for getGridCommWorkBufferSize.
   NVF_ERROR(
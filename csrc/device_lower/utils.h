@@ -136,6 +136,9 @@ bool isCpAsyncOp(const Expr* expr);
 //!  a cp.async.bulk (a.k.a. TMA) intrinsic.
 bool isCpAsyncBulkLoad(const Expr* expr);
 bool isCpAsyncBulkStore(const Expr* expr);
+//! An atomic grid reduction of a shared memory tile into a global output
+//! parallelized as Bulk, lowered to cp.reduce.async.bulk.tensor
+bool isCpAsyncBulkReduction(const Expr* expr);
 bool isCpAsyncBulk(const Expr* expr);
 
 //! Short-cut for detecting initialization for cpAsync op.
@@ -295,6 +298,11 @@ bool supportInlinePredicate(Expr* expr);
 //! Test if an expression is a scalar expression.
 bool isScalarExpr(Expr* expr);
 
+//! Test if a scalar can be evaluated by the host before the launch, i.e. it
+//! only depends on the metadata of input tensors, scalar inputs and
+//! constants. Such scalars can be passed as kernel parameters.
+bool isHostComputable(Val* val);
+
 //! Test if provided IterDomain instance has an extent that matches maximum
 //!  extent stored in parallel dimension map for parallel type of provided
 //!  IterDomain object.
@@ -304,6 +312,10 @@ bool isExtentEqualToMaxParallelTypeExtent(const IterDomain* id);
 //! indexing special items in shared memory, like mbarrier.
 NVF_API Val* u32IndexScalarSmemTv(TensorView* tv);
 
+//! Get the uint32_t index of the item at the given position of a
+//! one-dimensional TensorView in shared memory, like an array of mbarriers.
+Val* u32IndexSmemTv(TensorView* tv, Val* index);
+
 //! Get the size of a global sync buffer needed to perform a grid reduction for
 //! each axis in bitmap.
 Val* getGridSyncBufferSize(const ParallelTypeBitmap& bitmap);
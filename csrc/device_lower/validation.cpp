@@ -472,8 +472,10 @@ class VectorizeValidator : public OptInDispatch {
             tv->getDataType().value(), GpuLower::current()->indexType()) *
         vector_word_size;
 
-    // Allow half2, float2, float4 and same sized vtypes.
-    std::array<int64_t, 4> allowed_vector_sizes = {2, 4, 8, 16}; // NOLINT
+    // Allow half2, float2, float4, float8 and same sized vtypes. 32-byte
+    // accesses are single instructions on Blackwell and pairs of 16-byte ones
+    // elsewhere, see array.cu.
+    std::array<int64_t, 5> allowed_vector_sizes = {2, 4, 8, 16, 32}; // NOLINT
 
     NVF_CHECK(
         std::find(
@@ -482,7 +484,7 @@ class VectorizeValidator : public OptInDispatch {
             vector_size) != allowed_vector_sizes.end(),
         "Tried to vectorize a dim resulting in a word size of ",
         vector_size,
-        " however, vector sizes only upto and including 16 bytes are supported.");
+        " however, vector sizes only upto and including 32 bytes are supported.");
 
     auto consumer_vectorized_id =
         getVectorizedIdInAllocationDomain(v_id, tv, "consumer");
@@ -528,8 +530,11 @@ class VectorizeValidator : public OptInDispatch {
     vectorized_set_info.vectorized_leaf_id = v_id;
     vectorized_set_info.vectorized_consumer_alloc_id = consumer_vectorized_id;
 
-    // Validate producer
-    auto pairwise_map = PairwiseRootDomainMap(producer_tv, tv);
+    // Validate producer. The indexed domain of the lookup table of
+    // index_select is mapped so that the rows of the table are replayed as
+    // the consumer.
+    auto pairwise_map =
+        PairwiseRootDomainMap(producer_tv, tv).mapIndexedDomains(true);
     auto producer_replayed_as_consumer =
         TransformReplay::replayPasC(
             producer_tv,
@@ -547,6 +552,16 @@ class VectorizeValidator : public OptInDispatch {
         getVectorizedIdInAllocationDomain(
             c2p_map.at(v_id), producer_tv, "producer");
 
+    // Only the inner dimension of the rows of the lookup table can be
+    // vectorized, not the indirectly accessed one
+    if (auto index_select = dynamic_cast<IndexSelectOp*>(tv_def)) {
+      NVF_ERROR(
+          vectorized_set_info.vectorized_producer_alloc_id !=
+              index_select->getIndexedID(),
+          "Cannot vectorize the indexed domain of ",
+          index_select->toString());
+    }
+
     // For aligned vectorize, the extent of a vectorized domain must
     // be divisible by the vector word size. The domain is usually
     // just one of the allocation domains, but can be a merged domain of
@@ -611,6 +626,7 @@ void validateAndCollectVectorizeInfo(Fusion* fusion) {
       Expr* def = tv->definition();
       NVF_ERROR(
           def == nullptr || def->isA<LoadStoreOp>() || def->isA<SliceOp>() ||
+              def->isA<IndexSelectOp>() ||
               (def->isA<ReductionOp>() &&
                def->as<ReductionOp>()->serialGridReductionRequested()),
           "Vectorized accesses cannot be inline with computation: ",
@@ -988,6 +1004,39 @@ void validateMmaTensors(MmaOp* mma) {
 
   validate_operand(mma->inA()->as<TensorView>(), MmaOperand::A);
   validate_operand(mma->inB()->as<TensorView>(), MmaOperand::B);
+
+  // The compressed values of a sparse A and their metadata can not be
+  // expressed as the operands of an MmaOp yet, see decompress_2_4
+  NVF_ERROR(
+      !isSparse(mma->macro()),
+      "Sparse mma macro ",
+      toString(mma->macro()),
+      " is not supported by MmaOp yet");
+
+  // Only the k = 32 Hopper macros take 8-bit floating point operands, and
+  // only the k = 32 Ampere macros take Int8 operands
+  const bool int8_operands = mma->inA()->dtype() == DataType::Int8;
+  const bool fp8_operands =
+      !int8_operands && dataTypeSize(mma->inA()->dtype()) == 1;
+  NVF_ERROR(
+      fp8_operands == isFp8(mma->macro()) &&
+          int8_operands == isInt8(mma->macro()) &&
+          int8_operands == (mma->inB()->dtype() == DataType::Int8),
+      "Mma macro ",
+      toString(mma->macro()),
+      " does not support operands of type ",
+      mma->inA()->dtype(),
+      " and ",
+      mma->inB()->dtype());
+  if (int8_operands) {
+    NVF_ERROR(
+        mma->out()->dtype() == DataType::Int32,
+        "Mma with Int8 operands must accumulate in Int32, got: ",
+        mma->out()->dtype());
+    NVF_ERROR(
+        mma->layout() == MmaLayout::TN,
+        "Mma with Int8 operands requires the TN layout");
+  }
 }
 
 void validateSizeMemoryOp(LoadStoreOp* ldst) {
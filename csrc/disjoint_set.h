@@ -169,6 +169,12 @@ class VectorOfUniqueEntries {
     return v;
   }
 
+  // Reserves space for at least n entries
+  void reserve(int64_t n) {
+    vector_.reserve(n);
+    set_.reserve(n);
+  }
+
   // Returns if this container is empty
   bool empty() const {
     return vector_.empty();
@@ -298,6 +304,7 @@ class DisjointSets {
     using std::swap;
     swap(sets1.disjoint_sets_, sets2.disjoint_sets_);
     swap(sets1.disjoint_set_maps_, sets2.disjoint_set_maps_);
+    swap(sets1.has_removed_sets_, sets2.has_removed_sets_);
   }
 
   // Warning: returned values should never be modified. This accessor isn't
@@ -310,6 +317,7 @@ class DisjointSets {
   // strictly safe as VectorOfUniqueEntries is not returned as a const.
   const std::vector<std::shared_ptr<VectorOfUniqueEntries<T, Hash>>>&
   disjointSets() const {
+    removeStaleSets();
     return disjoint_sets_;
   }
 
@@ -356,6 +364,9 @@ class DisjointSets {
     disjoint_sets_.push_back(
         std::make_shared<VectorOfUniqueEntries<T, Hash>>());
     auto new_set = disjoint_sets_.back();
+    new_set->reserve(
+        (set_0_found ? set_it_0->second->size() : 1) +
+        (set_1_found ? set_it_1->second->size() : 1));
 
     // Add an entry to new_set along with the other entries previously
     // grouped together with the entry. The existing set is erased.
@@ -367,8 +378,9 @@ class DisjointSets {
           new_set->pushBack(existing_entry);
           disjoint_set_maps_[existing_entry] = new_set;
         }
-        disjoint_sets_.erase(std::find(
-            disjoint_sets_.begin(), disjoint_sets_.end(), existing_set));
+        // existing_set is no longer mapped to by any entry and is removed
+        // from disjoint_sets_ lazily
+        has_removed_sets_ = true;
       } else {
         new_set->pushBack(entry);
         disjoint_set_maps_[entry] = new_set;
@@ -426,8 +438,7 @@ class DisjointSets {
           set->front() == entry,
           "Disjoint set container found to be in inconsistent state.");
       disjoint_set_maps_.erase(entry);
-      disjoint_sets_.erase(
-          std::find(disjoint_sets_.begin(), disjoint_sets_.end(), set));
+      has_removed_sets_ = true;
     } else {
       disjoint_set_maps_.erase(entry);
       set->erase(entry);
@@ -442,7 +453,7 @@ class DisjointSets {
   // Warning: constructed on every call, consider caching result.
   VectorOfUniqueEntries<T, Hash> getAllElements() const {
     VectorOfUniqueEntries<T, Hash> all_elements;
-    for (auto set : disjoint_sets_) {
+    for (auto set : disjointSets()) {
       for (auto entry : set->vector()) {
         all_elements.pushBack(entry);
       }
@@ -454,13 +465,14 @@ class DisjointSets {
   void clear() {
     disjoint_set_maps_.clear();
     disjoint_sets_.clear();
+    has_removed_sets_ = false;
   }
 
   std::string toString() const {
     std::stringstream ss;
     ss << "disjoint sets{\n";
     const std::string sep("  ");
-    for (auto s_ptr : disjoint_sets_) {
+    for (auto s_ptr : disjointSets()) {
       auto& set = *s_ptr;
       ss << sep << abstractToString(set) << "\n";
     }
@@ -469,10 +481,32 @@ class DisjointSets {
   }
 
   auto size() const {
-    return disjoint_sets_.size();
+    return disjointSets().size();
   }
 
  private:
+  // Erases the sets that have been merged into other sets or whose only
+  // entry has been erased. Doing this lazily instead of searching
+  // disjoint_sets_ on every merge keeps building large disjoint sets linear
+  // in the number of merges. The order of the remaining sets doesn't change.
+  void removeStaleSets() const {
+    if (!has_removed_sets_) {
+      return;
+    }
+    // Sets are never empty, and a set is stale once its first entry is
+    // mapped to another set or isn't mapped at all
+    disjoint_sets_.erase(
+        std::remove_if(
+            disjoint_sets_.begin(),
+            disjoint_sets_.end(),
+            [this](const auto& set) {
+              auto it = disjoint_set_maps_.find(set->front());
+              return it == disjoint_set_maps_.end() || it->second != set;
+            }),
+        disjoint_sets_.end());
+    has_removed_sets_ = false;
+  }
+
   // Disjoint sets
   DisjointSetMap disjoint_set_maps_;
 
@@ -480,7 +514,13 @@ class DisjointSets {
   //
   // TODO: Should this just be a
   // VectorOfUniqueEntries<std::shared_ptr<VectorOfUniqueEntries ?
-  std::vector<std::shared_ptr<VectorOfUniqueEntries<T, Hash>>> disjoint_sets_;
+  //
+  // May contain stale sets until removeStaleSets is called
+  mutable std::vector<std::shared_ptr<VectorOfUniqueEntries<T, Hash>>>
+      disjoint_sets_;
+
+  // Whether disjoint_sets_ may contain stale sets
+  mutable bool has_removed_sets_ = false;
 };
 
 template <typename T, typename Hash>
@@ -490,7 +530,7 @@ DisjointSets<T, Hash>::DisjointSets(const DisjointSets<T, Hash>& other) {
 
   // Deep copy the vector of the disjoint sets, keeping the same
   // ordering of the sets.
-  for (const auto& other_set : other.disjoint_sets_) {
+  for (const auto& other_set : other.disjointSets()) {
     auto new_set = std::make_shared<VectorOfUniqueEntries<T, Hash>>(*other_set);
     int new_set_index = disjoint_sets_.size();
     disjoint_sets_.emplace_back(new_set);
@@ -108,6 +108,12 @@ class Val;
   f(Swizzle2D);                   \
   f(Resize);                      \
   f(MatmulOp);                    \
+  f(GroupedMatmulOp);             \
+  f(SdpaFwdOp);                   \
+  f(SdpaBwdOp);                   \
+  f(ScanOp);                      \
+  f(TopKOp);                      \
+  f(ArgsortOp);                   \
   f(Communication);
 #define DISPATCH_FOR_ALL_KIR_EXPRS(f) \
   f(Allocate);                        \
@@ -119,6 +125,8 @@ class Val;
   f(MBarrierArrive);                  \
   f(MBarrierArriveExpectTx);          \
   f(MBarrierWait);                    \
+  f(MBarrierWaitParity);              \
+  f(MBarrierArriveCpAsync);           \
   f(BlockSerializeWait);              \
   f(BlockSerializeRelease);           \
   f(AsyncWait);                       \
@@ -138,7 +146,15 @@ class Val;
   f(EncodeTensorMapTiled);
 #define DISPATCH_FOR_ALL_HIR_EXPRS(f) \
   f(HostUnit);                        \
-  f(PostOnStream);
+  f(PostOnStream);                    \
+  f(ForLoop);                         \
+  f(If);                              \
+  f(PostCommunication);               \
+  f(SetCurrentStream);                \
+  f(RecordEvent);                     \
+  f(WaitEvent);                       \
+  f(Allocate);                        \
+  f(Deallocate);
 
 // Forward declarations for all Val and Expr types
 
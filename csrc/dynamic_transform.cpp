@@ -15,6 +15,8 @@
 #include <ops/alias.h>
 #include <ops/arith.h>
 #include <ops/utils.h>
+#include <options.h>
+#include <tensor_metadata.h>
 #include <transform_iter.h>
 #include <transform_view.h>
 #include <utils.h>
@@ -43,6 +45,16 @@ DynamicTransformInitialInfo DynamicTransformInitialInfo::clone(
   for (const auto v : dynamic_factory_tvs_) {
     cloned_info.dynamic_factory_tvs_.push_back(ir_cloner.clone(v));
   }
+  cloned_info.maybe_inner_contig_inputs_.reserve(
+      maybe_inner_contig_inputs_.size());
+  for (const auto tv : maybe_inner_contig_inputs_) {
+    cloned_info.maybe_inner_contig_inputs_.push_back(ir_cloner.clone(tv));
+  }
+  cloned_info.maybe_specialized_extents_.reserve(
+      maybe_specialized_extents_.size());
+  for (const auto v : maybe_specialized_extents_) {
+    cloned_info.maybe_specialized_extents_.push_back(ir_cloner.clone(v));
+  }
   cloned_info.maybe_zero_extents_set_.reserve(maybe_zero_extents_set_.size());
   for (const auto v : maybe_zero_extents_set_) {
     cloned_info.maybe_zero_extents_set_.insert(ir_cloner.clone(v));
@@ -78,6 +90,14 @@ std::string DynamicTransformInitialInfo::toString() const {
   for (const auto& tv : dynamic_factory_tvs_) {
     ss << indent << indent << tv->toString() << "\n";
   }
+  ss << indent << "Maybe inner-contiguous inputs:\n";
+  for (const auto& tv : maybe_inner_contig_inputs_) {
+    ss << indent << indent << tv->toString() << "\n";
+  }
+  ss << indent << "Maybe specialized extents:\n";
+  for (const auto& v : maybe_specialized_extents_) {
+    ss << indent << indent << v->toInlineString() << "\n";
+  }
   ss << indent << "Dynamic extent Vals:\n";
   for (const auto& v : maybe_zero_extents_) {
     ss << indent << indent << v->toInlineString() << "\n";
@@ -103,6 +123,14 @@ class DynamicTransformInitialInfoBuilder : public IterVisitor {
     finalizeDynamicVals();
 
     finalizeMaybeEmptyExtents();
+
+    if (isOptionEnabled(EnableOption::ContiguitySpecialization)) {
+      findMaybeInnerContiguousInputs(fusion);
+    }
+
+    if (isOptionEnabled(EnableOption::ShapeSpecialization)) {
+      findMaybeSpecializedExtents(fusion);
+    }
   }
 
   const auto& getInfo() const {
@@ -229,6 +257,49 @@ class DynamicTransformInitialInfoBuilder : public IterVisitor {
     }
   }
 
+  //! Find the inputs whose innermost non-broadcast allocation dimension is not
+  //! marked contiguous. Such inputs can't be vectorized, although they
+  //! commonly have stride 1 at run time, e.g. when only outer dimensions are
+  //! sliced or when the contiguity of a definition is unknown.
+  void findMaybeInnerContiguousInputs(Fusion* fusion) {
+    for (auto tv : ir_utils::filterByType<TensorView>(fusion->inputs())) {
+      if (tv->isCpuScalar()) {
+        continue;
+      }
+      const std::vector<IterDomain*>& alloc = tv->getMaybeAllocationDomain();
+      const auto& contiguity = tv->getContiguity();
+      for (int64_t i = (int64_t)alloc.size() - 1; i >= 0; --i) {
+        if (alloc.at(i)->isBroadcast() || alloc.at(i)->isReduction()) {
+          continue;
+        }
+        if (!contiguity.at(i).value_or(true)) {
+          info_.maybe_inner_contig_inputs_.push_back(tv);
+        }
+        break;
+      }
+    }
+  }
+
+  //! Find the symbolic extents of the non-broadcast dimensions of inputs.
+  //! Replacing these with constants lets every extent exactly mapped to them
+  //! be constant in the kernel.
+  void findMaybeSpecializedExtents(Fusion* fusion) {
+    std::unordered_set<Val*> extents;
+    for (auto tv : ir_utils::filterByType<TensorView>(fusion->inputs())) {
+      if (tv->isCpuScalar()) {
+        continue;
+      }
+      for (auto id : TensorDomain::noReductions(tv->getMaybeRFactorDomain())) {
+        Val* extent = id->extent();
+        if (id->isBroadcast() || extent->isConstScalar() ||
+            !extents.insert(extent).second) {
+          continue;
+        }
+        info_.maybe_specialized_extents_.push_back(extent);
+      }
+    }
+  }
+
   //! Convert maybe_zero_extents_set_ to a vector so we can index it reliably
   void finalizeMaybeEmptyExtents() {
     info_.maybe_zero_extents_ = std::vector<Val*>(
@@ -253,7 +324,8 @@ class DynamicTransformInitialInfoBuilder : public IterVisitor {
 
 DynamicTransformConcretizationInfo::DynamicTransformConcretizationInfo(
     const DynamicTransformInitialInfo* initial_info,
-    ExpressionEvaluator* expr_eval)
+    ExpressionEvaluator* expr_eval,
+    bool specialize_extents)
     : initial_info_(initial_info) {
   NVF_ERROR(
       !fusion()->isA<kir::Kernel>(),
@@ -271,6 +343,12 @@ DynamicTransformConcretizationInfo::DynamicTransformConcretizationInfo(
 
   analyzeFactoryOutputs(expr_eval);
 
+  analyzeInnerContiguity(expr_eval);
+
+  if (specialize_extents) {
+    analyzeSpecializedExtents(expr_eval);
+  }
+
   auto maybe_zero_extents = initial_info_->getMaybeZeroExtents();
   for (auto i : c10::irange((int64_t)maybe_zero_extents.size())) {
     auto ext = maybe_zero_extents.at(i);
@@ -478,6 +556,49 @@ void DynamicTransformConcretizationInfo::analyzeFactoryOutputs(
   }
 }
 
+void DynamicTransformConcretizationInfo::analyzeInnerContiguity(
+    ExpressionEvaluator* expr_eval) {
+  const std::vector<TensorView*>& input_tvs =
+      initial_info_->getMaybeInnerContiguousInputs();
+  for (const auto tv_index : c10::irange((int64_t)input_tvs.size())) {
+    TensorView* tv = input_tvs.at(tv_index);
+    const auto& metadata = expr_eval->evaluate(IrBuilder::metadataExpr(tv));
+    const auto& alloc_sizes = metadata->*&TensorMetaData::alloc_size;
+    const auto& alloc_strides = metadata->*&TensorMetaData::alloc_stride;
+    const std::vector<IterDomain*> alloc =
+        TensorDomain::noReductions(tv->getMaybeAllocationDomain());
+    NVF_ERROR(alloc.size() == alloc_strides.size());
+    for (int64_t i = (int64_t)alloc.size() - 1; i >= 0; --i) {
+      if (alloc.at(i)->isBroadcast()) {
+        continue;
+      }
+      // A single element says nothing about the stride of later inputs
+      if (alloc_sizes.at(i) > 1 && alloc_strides.at(i) == 1) {
+        inner_contig_inputs_.push_back(tv_index);
+      }
+      break;
+    }
+  }
+}
+
+void DynamicTransformConcretizationInfo::analyzeSpecializedExtents(
+    ExpressionEvaluator* expr_eval) {
+  const std::vector<Val*>& extents =
+      initial_info_->getMaybeSpecializedExtents();
+  for (const auto i : c10::irange((int64_t)extents.size())) {
+    Val* extent = extents.at(i);
+    auto extent_opt = expr_eval->evaluate(extent);
+    NVF_ERROR(
+        extent_opt.hasValue(),
+        "Could not evaluate extent to specialize: ",
+        extent->toString());
+    // Empty extents are concretized by concretizeEmptyExtents
+    if (extent_opt != 0) {
+      specialized_extents_.emplace_back(i, extent_opt.as<int64_t>());
+    }
+  }
+}
+
 bool DynamicTransformConcretizationInfo::operator==(
     const DynamicTransformConcretizationInfo& other) const {
   if (this == &other) {
@@ -512,6 +633,14 @@ bool DynamicTransformConcretizationInfo::operator==(
     return false;
   }
 
+  if (inner_contig_inputs_ != other.inner_contig_inputs_) {
+    return false;
+  }
+
+  if (specialized_extents_ != other.specialized_extents_) {
+    return false;
+  }
+
   for (const auto i : c10::irange((int64_t)expand_axes_.size())) {
     const auto& expand_axes = expand_axes_.at(i);
     const auto& other_expand_axes = other.expand_axes_.at(i);
@@ -589,6 +718,17 @@ std::string DynamicTransformConcretizationInfo::toString() const {
          << iter_type << std::endl;
     }
   }
+  ss << indent << "Inner-contiguous inputs:\n";
+  for (const auto& i : inner_contig_inputs_) {
+    auto tv = initial_info_->getMaybeInnerContiguousInputs().at(i);
+    ss << indent << indent << tv->toString() << " (index=" << i << ")\n";
+  }
+  ss << indent << "Specialized extents:\n";
+  for (const auto& [i, value] : specialized_extents_) {
+    auto extent = initial_info_->getMaybeSpecializedExtents().at(i);
+    ss << indent << indent << extent->toInlineString() << " => " << value
+       << "\n";
+  }
   return ss.str();
 }
 
@@ -619,6 +759,10 @@ class DynamicTransformConcretizer : public OptOutMutator {
 
   void concretizeFactoryOutputs();
 
+  void concretizeInnerContiguity();
+
+  void concretizeSpecializedExtents();
+
   //! Use this instead of calling registerMutation directly, since it will also
   //! check that the concretized value is a valid input to all of its uses.
   void registerConcretization(Val* old_val, Val* new_val) {
@@ -660,9 +804,15 @@ void DynamicTransformConcretizer::concretize() {
   // Registers replacement of all empty extents with zeroVal()
   concretizeEmptyExtents();
 
+  // Registers replacement of specialized extents with their constant values
+  concretizeSpecializedExtents();
+
   // Set IterTypes for factory op outputs
   concretizeFactoryOutputs();
 
+  // Mark inputs with stride-1 innermost dimensions contiguous there
+  concretizeInnerContiguity();
+
   // Finally, propagate concretized domains
   auto all_stmts = StmtSort::getStmts(
       info_->fusion(),
@@ -709,6 +859,37 @@ void DynamicTransformConcretizer::concretize() {
   }
 }
 
+void DynamicTransformConcretizer::concretizeInnerContiguity() {
+  for (const auto& tv_index : info_->getInnerContiguousInputs()) {
+    TensorView* tv =
+        info_->initialInfo()->getMaybeInnerContiguousInputs().at(tv_index);
+    std::vector<std::optional<bool>> contiguity = tv->getContiguity();
+    const std::vector<IterDomain*>& alloc = tv->getMaybeAllocationDomain();
+    for (int64_t i = (int64_t)alloc.size() - 1; i >= 0; --i) {
+      if (alloc.at(i)->isBroadcast() || alloc.at(i)->isReduction()) {
+        continue;
+      }
+      contiguity.at(i) = true;
+      break;
+    }
+    tv->setContiguity(contiguity);
+  }
+}
+
+void DynamicTransformConcretizer::concretizeSpecializedExtents() {
+  for (const auto& [ext_index, value] : info_->getSpecializedExtents()) {
+    auto ext = info_->initialInfo()->getMaybeSpecializedExtents().at(ext_index);
+    auto constant = IrBuilder::create<Val>(value, ext->getDataType().value());
+    // As in concretizeEmptyExtents, replace the uses of the extent in scalar
+    // expressions and register it for the IterDomains that hold it
+    auto uses = ext->uses();
+    for (auto use : uses) {
+      ir_utils::replaceValInExprInputs(use, ext, constant);
+    }
+    registerConcretization(ext, constant);
+  }
+}
+
 void DynamicTransformConcretizer::concretizeEmptyExtents() {
   auto fusion = FusionGuard::getCurFusion();
   for (const auto& ext_index : info_->getEmptyExtents()) {
@@ -1355,6 +1536,13 @@ size_t DynamicTransformConcretizationInfo::hash() const {
       hashCombine(hash, (size_t)e);
     }
   }
+  for (const auto& tv_index : getInnerContiguousInputs()) {
+    hashCombine(hash, (size_t)tv_index);
+  }
+  for (const auto& [ext_index, value] : getSpecializedExtents()) {
+    hashCombine(hash, (size_t)ext_index);
+    hashCombine(hash, (size_t)value);
+  }
   return hash;
 }
 
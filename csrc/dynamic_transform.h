@@ -46,7 +46,8 @@ class DynamicTransformInitialInfo {
   //! the structure of the Fusion.
   bool isDynamic() const {
     return hasPossibleEmptyTensor() || !dynamic_reshaped_tvs_.empty() ||
-        !dynamic_resized_ids_.empty();
+        !dynamic_resized_ids_.empty() || !maybe_inner_contig_inputs_.empty() ||
+        !maybe_specialized_extents_.empty();
   }
 
   //! Return whether there are any tensors with unknown extent in some
@@ -93,6 +94,21 @@ class DynamicTransformInitialInfo {
     return dynamic_factory_tvs_;
   }
 
+  //! Return a vector of fusion inputs whose innermost allocation dimension is
+  //! not marked contiguous. These are only collected with
+  //! EnableOption::ContiguitySpecialization.
+  const std::vector<TensorView*>& getMaybeInnerContiguousInputs() const {
+    return maybe_inner_contig_inputs_;
+  }
+
+  //! Return a vector of the unique symbolic extents of the non-broadcast
+  //! dimensions of fusion inputs, which concretization may replace with
+  //! constants. These are only collected with
+  //! EnableOption::ShapeSpecialization.
+  const std::vector<Val*>& getMaybeSpecializedExtents() const {
+    return maybe_specialized_extents_;
+  }
+
   std::string toString() const;
 
   DynamicTransformInitialInfo clone(IrCloner& ir_cloner) const;
@@ -128,6 +144,10 @@ class DynamicTransformInitialInfo {
 
   std::vector<TensorView*> dynamic_factory_tvs_;
 
+  std::vector<TensorView*> maybe_inner_contig_inputs_;
+
+  std::vector<Val*> maybe_specialized_extents_;
+
   // This is a minimal set of scalars to check for empty tensors. If any are
   // zero, we should traverse to find empty tensors.
   std::unordered_set<Val*> maybe_zero_extents_set_;
@@ -144,9 +164,13 @@ class DynamicTransformInitialInfo {
 //! of the fusion inputs
 class DynamicTransformConcretizationInfo {
  public:
+  //! With specialize_extents, the extents of
+  //! initial_info->getMaybeSpecializedExtents() are concretized to their
+  //! values in expr_eval.
   NVF_API DynamicTransformConcretizationInfo(
       const DynamicTransformInitialInfo* initial_info,
-      ExpressionEvaluator* expr_eval);
+      ExpressionEvaluator* expr_eval,
+      bool specialize_extents = false);
 
   //! Return a vector of integers each corresponding to the position in
   //! initialInfo()->getMaybeZeroExtents() of an extent Val which is guaranteed
@@ -189,6 +213,21 @@ class DynamicTransformConcretizationInfo {
     return factory_output_itertypes_;
   }
 
+  //! Return a vector of integers each corresponding to the position in
+  //! initialInfo()->getMaybeInnerContiguousInputs() of an input whose
+  //! innermost allocation dimension has stride 1.
+  const std::vector<int64_t>& getInnerContiguousInputs() const {
+    return inner_contig_inputs_;
+  }
+
+  //! Return a vector of pairs holding the position of each extent in
+  //! initialInfo()->getMaybeSpecializedExtents() along with the constant it
+  //! is concretized to.
+  const std::vector<std::pair<int64_t, int64_t>>& getSpecializedExtents()
+      const {
+    return specialized_extents_;
+  }
+
   //! Comparison operator for the purposes of determining cache hits. This does
   //! not guarantee equality of all members. Instead, it returns equal if the
   //! resulting concretizations would be structurally equivalent. Note that
@@ -218,6 +257,14 @@ class DynamicTransformConcretizationInfo {
   //! determine the IterTypes of factory function outputs.
   void analyzeFactoryOutputs(ExpressionEvaluator* expr_eval);
 
+  //! Given an ExpressionEvaluator which already has input tensors bound to it,
+  //! determine which inputs are contiguous in their innermost dimension.
+  void analyzeInnerContiguity(ExpressionEvaluator* expr_eval);
+
+  //! Given an ExpressionEvaluator which already has input tensors bound to it,
+  //! determine the values of the extents to specialize.
+  void analyzeSpecializedExtents(ExpressionEvaluator* expr_eval);
+
   const DynamicTransformInitialInfo* initialInfo() const {
     return initial_info_;
   }
@@ -266,6 +313,15 @@ class DynamicTransformConcretizationInfo {
   std::vector<std::vector<std::pair<int64_t, IterType>>>
       factory_output_itertypes_;
 
+  //! Holds a vector of indices into
+  //! initial_info_->getMaybeInnerContiguousInputs() whose innermost stride is
+  //! 1
+  std::vector<int64_t> inner_contig_inputs_;
+
+  //! Holds the index into initial_info_->getMaybeSpecializedExtents() and the
+  //! value of each nonzero extent to specialize
+  std::vector<std::pair<int64_t, int64_t>> specialized_extents_;
+
   friend class DynamicTransformInfoBuilder;
 };
 
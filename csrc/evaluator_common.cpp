@@ -15,7 +15,11 @@
 #include <ir/utils.h>
 #include <tensor_metadata.h>
 
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
 #include <optional>
+#include <type_traits>
 
 namespace nvfuser {
 
@@ -195,6 +199,8 @@ void PrecomputedValues::initializeValueList(
   is_constant_ = std::vector<bool>(num_of_values_, false);
   values_ = std::vector<PolymorphicValue>(num_of_values_, PolymorphicValue());
 
+  bound_ = std::vector<bool>(num_of_values_, false);
+
   // Fill in constants and assign evaluator indices
   for (const auto i : c10::irange(num_of_values_)) {
     // Use an expression evaluator to test if value is const
@@ -204,6 +210,33 @@ void PrecomputedValues::initializeValueList(
     }
     sorted_value_list[i]->setEvaluatorIndex(i);
   }
+
+  // Record which values are computed from each value
+  consumers_ = std::vector<std::vector<int>>(num_of_values_);
+  for (auto val : sorted_value_list) {
+    if (val->definition() == nullptr) {
+      continue;
+    }
+    for (auto inp : val->definition()->inputs()) {
+      if (inp->evaluatorIndex() >= 0) {
+        consumers_[inp->evaluatorIndex()].push_back(val->evaluatorIndex());
+      }
+    }
+  }
+}
+
+void PrecomputedValues::bindValue_(int index, const PolymorphicValue& value) {
+  if (index < 0 || is_constant_[index]) {
+    return;
+  }
+  if (!defined_[index] ||
+      !PolymorphicValue_functions::isSame(values_[index], value)) {
+    dirty_.push_back(index);
+    values_[index] = value;
+  }
+  defined_[index] = true;
+  bound_[index] = true;
+  binding_log_.emplace_back(index, value);
 }
 
 const PolymorphicValue& PrecomputedValues::getMaybeValueFor(
@@ -230,16 +263,67 @@ void PrecomputedValues::print() const {
 
 void PrecomputedValues::evaluate() {
   FUSER_PERF_SCOPE("PrecomputedValues::Evaluate");
+  if (incremental_) {
+    // Values bound last time but not this time are unknown again
+    for (auto index : previously_bound_) {
+      if (!bound_[index]) {
+        defined_[index] = false;
+        dirty_.push_back(index);
+      }
+    }
+    previously_bound_.clear();
+    if (dirty_.empty()) {
+      // Same bindings as the last evaluation, which was validated already
+      has_valid_values_ = true;
+      return;
+    }
+    invalidateDependents();
+  }
+
+  dirty_.clear();
+  previously_bound_.clear();
+
+  // A failed evaluation leaves the workspace in an unknown state
+  incremental_ = false;
   value_machine_->run();
   validate();
+  incremental_ = true;
+}
+
+void PrecomputedValues::invalidateDependents() {
+  FUSER_PERF_SCOPE("PrecomputedValues::invalidateDependents");
+  std::vector<int> to_visit;
+  to_visit.swap(dirty_);
+  while (!to_visit.empty()) {
+    const int index = to_visit.back();
+    to_visit.pop_back();
+    for (auto consumer : consumers_[index]) {
+      // Undefined values have no defined dependents either, unless those are
+      // bound
+      if (bound_[consumer] || is_constant_[consumer] || !defined_[consumer]) {
+        continue;
+      }
+      defined_[consumer] = false;
+      to_visit.push_back(consumer);
+    }
+  }
 }
 
 void PrecomputedValues::invalidate() {
   // clear binding values
+  previously_bound_.clear();
+  for (const auto& [index, value] : binding_log_) {
+    bound_[index] = false;
+    previously_bound_.push_back(index);
+  }
   binding_log_.clear();
 
-  // invalidate value entries
-  std::fill(defined_.begin(), defined_.end(), false);
+  // invalidate value entries unless they can be updated incrementally
+  if (!incremental_) {
+    std::fill(defined_.begin(), defined_.end(), false);
+    previously_bound_.clear();
+    dirty_.clear();
+  }
 
   // invalidate flag
   has_valid_values_ = false;
@@ -373,11 +457,482 @@ void PrecomputedValues::bindTensorMetaData(
   bindValue(metadata_val->evaluatorIndex(), metadata);
 }
 
+namespace {
+
+//! Type of val in ScalarValueMachine, if it is a supported scalar
+std::optional<ScalarValueMachine::ScalarType> toScalarType(Val* val) {
+  const DataType dtype = val->dtype();
+  if (isIntegralType(dtype)) {
+    return ScalarValueMachine::ScalarType::Int;
+  }
+  if (isFloatingPointType(dtype)) {
+    return ScalarValueMachine::ScalarType::Double;
+  }
+  if (dtype == DataType::Bool) {
+    return ScalarValueMachine::ScalarType::Bool;
+  }
+  return std::nullopt;
+}
+
+} // namespace
+
+ScalarValueMachine::ScalarValueMachine(PrecomputedValues& precomputed_values)
+    : precomputed_values_(precomputed_values),
+      values_(precomputed_values.num_of_values_, ScalarValue{0}),
+      types_(precomputed_values.num_of_values_, ScalarType::Int),
+      known_(precomputed_values.num_of_values_, false) {
+  for (auto val : precomputed_values_.symbols_) {
+    const int index = val->evaluatorIndex();
+    auto type = toScalarType(val);
+    if (index < 0 || !type.has_value()) {
+      continue;
+    }
+    types_[index] = type.value();
+    if (precomputed_values_.is_constant_[index]) {
+      known_[index] = load(index, precomputed_values_.values_[index]);
+    }
+  }
+
+  std::unordered_set<int> operand_set;
+  for (auto val : precomputed_values_.symbols_) {
+    auto def = val->definition();
+    if (def == nullptr || !tryMakeInstruction(def)) {
+      continue;
+    }
+    handled_exprs_.insert(def);
+    for (auto operand : def->inputs()) {
+      operand_set.insert(operand->evaluatorIndex());
+    }
+    operand_set.insert(val->evaluatorIndex());
+  }
+  for (auto index : operand_set) {
+    if (!precomputed_values_.is_constant_[index]) {
+      operands_.push_back(index);
+    }
+  }
+  std::sort(operands_.begin(), operands_.end());
+}
+
+void ScalarValueMachine::copyFrom(const ScalarValueMachine& other) {
+  instructions_ = other.instructions_;
+  operands_ = other.operands_;
+  values_ = other.values_;
+  types_ = other.types_;
+  known_ = other.known_;
+}
+
+bool ScalarValueMachine::load(int index, const PolymorphicValue& value) {
+  switch (types_[index]) {
+    case ScalarType::Int:
+      if (value.is<int64_t>()) {
+        values_[index].i = value.as<int64_t>();
+        return true;
+      }
+      return false;
+    case ScalarType::Double:
+      if (value.is<double>()) {
+        values_[index].d = value.as<double>();
+        return true;
+      }
+      return false;
+    case ScalarType::Bool:
+      if (value.is<bool>()) {
+        values_[index].b = value.as<bool>();
+        return true;
+      }
+      return false;
+  }
+  return false;
+}
+
+bool ScalarValueMachine::isScalarOperand(Val* val) const {
+  const int index = val->evaluatorIndex();
+  if (index < 0 || !toScalarType(val).has_value()) {
+    return false;
+  }
+  if (precomputed_values_.is_constant_[index]) {
+    return known_[index];
+  }
+  // Values computed by NaiveValueMachine are not available yet, since it runs
+  // after this machine. All other values can only be bound.
+  auto def = val->definition();
+  return def == nullptr || handled_exprs_.count(def) > 0 ||
+      !(def->isA<UnaryOp>() || def->isA<BinaryOp>() || def->isA<TernaryOp>());
+}
+
+bool ScalarValueMachine::tryMakeInstruction(Expr* expr) {
+  if (expr->outputs().size() != 1 ||
+      !std::all_of(
+          expr->inputs().begin(),
+          expr->inputs().end(),
+          [this](Val* inp) { return isScalarOperand(inp); }) ||
+      !toScalarType(expr->output(0)).has_value()) {
+    return false;
+  }
+
+  const auto& inputs = expr->inputs();
+  std::vector<ScalarType> in_types;
+  in_types.reserve(inputs.size());
+  for (auto inp : inputs) {
+    in_types.push_back(toScalarType(inp).value());
+  }
+  const ScalarType out_type = toScalarType(expr->output(0)).value();
+  const bool same_types =
+      std::all_of(in_types.begin(), in_types.end(), [&](ScalarType type) {
+        return type == in_types.front();
+      });
+  const ScalarType type = in_types.front();
+  const bool is_number = type != ScalarType::Bool;
+
+  // Ops on operands of different types, which PolymorphicValue promotes, are
+  // left to NaiveValueMachine
+  std::optional<OpType> op;
+  if (auto uop = dynamic_cast<UnaryOp*>(expr)) {
+    switch (uop->getUnaryOpType()) {
+      case UnaryOpType::Neg:
+        if (is_number && out_type == type) {
+          op = OpType::Neg;
+        }
+        break;
+      case UnaryOpType::Abs:
+        if (is_number && out_type == type) {
+          op = OpType::Abs;
+        }
+        break;
+      case UnaryOpType::Cast:
+        op = OpType::Cast;
+        break;
+      case UnaryOpType::BitwiseNot:
+        if (type == ScalarType::Int && out_type == type) {
+          op = OpType::BitwiseNot;
+        }
+        break;
+      case UnaryOpType::LogicalNot:
+        if (type == ScalarType::Bool && out_type == type) {
+          op = OpType::LogicalNot;
+        }
+        break;
+      default:
+        break;
+    }
+  } else if (auto bop = dynamic_cast<BinaryOp*>(expr)) {
+    const bool is_arith = same_types && is_number && out_type == type;
+    const bool is_int_arith = is_arith && type == ScalarType::Int;
+    const bool is_compare =
+        same_types && is_number && out_type == ScalarType::Bool;
+    const bool is_logical = same_types && type == ScalarType::Bool &&
+        out_type == ScalarType::Bool;
+    switch (bop->getBinaryOpType()) {
+      case BinaryOpType::Add:
+        op = is_arith ? std::make_optional(OpType::Add) : std::nullopt;
+        break;
+      case BinaryOpType::Sub:
+        op = is_arith ? std::make_optional(OpType::Sub) : std::nullopt;
+        break;
+      case BinaryOpType::Mul:
+        op = is_arith ? std::make_optional(OpType::Mul) : std::nullopt;
+        break;
+      case BinaryOpType::Div:
+        op = is_arith ? std::make_optional(OpType::Div) : std::nullopt;
+        break;
+      case BinaryOpType::Max:
+        op = is_arith ? std::make_optional(OpType::Max) : std::nullopt;
+        break;
+      case BinaryOpType::Min:
+        op = is_arith ? std::make_optional(OpType::Min) : std::nullopt;
+        break;
+      case BinaryOpType::Mod:
+        op = is_int_arith ? std::make_optional(OpType::Mod) : std::nullopt;
+        break;
+      case BinaryOpType::CeilDiv:
+        op = is_int_arith ? std::make_optional(OpType::CeilDiv) : std::nullopt;
+        break;
+      case BinaryOpType::Gcd:
+        op = is_int_arith ? std::make_optional(OpType::Gcd) : std::nullopt;
+        break;
+      case BinaryOpType::BitwiseAnd:
+        op = is_int_arith ? std::make_optional(OpType::BitwiseAnd)
+                          : std::nullopt;
+        break;
+      case BinaryOpType::BitwiseOr:
+        op = is_int_arith ? std::make_optional(OpType::BitwiseOr)
+                          : std::nullopt;
+        break;
+      case BinaryOpType::BitwiseXor:
+        op = is_int_arith ? std::make_optional(OpType::BitwiseXor)
+                          : std::nullopt;
+        break;
+      case BinaryOpType::Eq:
+        op = is_compare ? std::make_optional(OpType::Eq) : std::nullopt;
+        break;
+      case BinaryOpType::NE:
+        op = is_compare ? std::make_optional(OpType::NE) : std::nullopt;
+        break;
+      case BinaryOpType::LT:
+        op = is_compare ? std::make_optional(OpType::LT) : std::nullopt;
+        break;
+      case BinaryOpType::LE:
+        op = is_compare ? std::make_optional(OpType::LE) : std::nullopt;
+        break;
+      case BinaryOpType::GT:
+        op = is_compare ? std::make_optional(OpType::GT) : std::nullopt;
+        break;
+      case BinaryOpType::GE:
+        op = is_compare ? std::make_optional(OpType::GE) : std::nullopt;
+        break;
+      case BinaryOpType::LogicalAnd:
+        op = is_logical ? std::make_optional(OpType::LogicalAnd)
+                        : std::nullopt;
+        break;
+      case BinaryOpType::LogicalOr:
+        op = is_logical ? std::make_optional(OpType::LogicalOr) : std::nullopt;
+        break;
+      default:
+        break;
+    }
+  } else if (auto top = dynamic_cast<TernaryOp*>(expr)) {
+    if (top->getTernaryOpType() == TernaryOpType::Clamp && same_types &&
+        is_number && out_type == type) {
+      op = OpType::Clamp;
+    } else if (
+        top->getTernaryOpType() == TernaryOpType::Where &&
+        type == ScalarType::Bool && in_types.at(1) == in_types.at(2) &&
+        out_type == in_types.at(1)) {
+      op = OpType::Where;
+    }
+  }
+  if (!op.has_value()) {
+    return false;
+  }
+
+  int src0 = inputs.at(0)->evaluatorIndex();
+  int src1 = inputs.size() > 1 ? inputs.at(1)->evaluatorIndex() : src0;
+  int src2 = inputs.size() > 2 ? inputs.at(2)->evaluatorIndex() : src0;
+  int dest = expr->output(0)->evaluatorIndex();
+  NVF_ERROR(dest >= 0, "Scalar Machine: unknown out: ", expr);
+  instructions_.push_back(
+      {op.value(),
+       op == OpType::Where ? in_types.at(1) : type,
+       src0,
+       src1,
+       src2,
+       dest});
+  return true;
+}
+
+namespace {
+
+template <typename T>
+T& scalarAs(int64_t& i, double& d, bool& b) {
+  if constexpr (std::is_same_v<T, int64_t>) {
+    return i;
+  } else if constexpr (std::is_same_v<T, double>) {
+    return d;
+  } else {
+    return b;
+  }
+}
+
+} // namespace
+
+template <typename T>
+void ScalarValueMachine::runInstruction(const Instruction& inst) {
+  auto get = [](ScalarValue& value) -> T& {
+    return scalarAs<T>(value.i, value.d, value.b);
+  };
+  const T a = get(values_[inst.src0]);
+  const T b = get(values_[inst.src1]);
+  const T c = get(values_[inst.src2]);
+  ScalarValue& dest = values_[inst.dest];
+
+  // The semantics below follow the ops of PolymorphicValue used by
+  // NaiveValueMachine, which is the fallback of this machine
+  switch (inst.op) {
+    case OpType::Cast:
+      switch (types_[inst.dest]) {
+        case ScalarType::Int:
+          dest.i = static_cast<int64_t>(a);
+          break;
+        case ScalarType::Double:
+          dest.d = static_cast<double>(a);
+          break;
+        case ScalarType::Bool:
+          dest.b = static_cast<bool>(a);
+          break;
+      }
+      return;
+    case OpType::Eq:
+      dest.b = a == b;
+      return;
+    case OpType::NE:
+      dest.b = a != b;
+      return;
+    case OpType::LT:
+      dest.b = a < b;
+      return;
+    case OpType::LE:
+      dest.b = a <= b;
+      return;
+    case OpType::GT:
+      dest.b = a > b;
+      return;
+    case OpType::GE:
+      dest.b = a >= b;
+      return;
+    case OpType::Where:
+      // The condition is the only Bool operand
+      get(dest) = values_[inst.src0].b ? b : c;
+      return;
+    default:
+      break;
+  }
+
+  if constexpr (std::is_same_v<T, bool>) {
+    switch (inst.op) {
+      case OpType::LogicalAnd:
+        dest.b = a && b;
+        break;
+      case OpType::LogicalOr:
+        dest.b = a || b;
+        break;
+      case OpType::LogicalNot:
+        dest.b = !a;
+        break;
+      default:
+        NVF_ERROR(false, "Unexpected boolean op in Scalar Machine");
+    }
+  } else {
+    T& out = get(dest);
+    switch (inst.op) {
+      case OpType::Neg:
+        out = -a;
+        break;
+      case OpType::Abs:
+        out = std::abs(a);
+        break;
+      case OpType::Add:
+        out = a + b;
+        break;
+      case OpType::Sub:
+        out = a - b;
+        break;
+      case OpType::Mul:
+        out = a * b;
+        break;
+      case OpType::Div:
+        // Like PolymorphicValue, a floating-point division by zero gives an
+        // infinity or a NaN
+        if constexpr (std::is_same_v<T, int64_t>) {
+          NVF_CHECK(b != 0);
+        }
+        out = a / b;
+        break;
+      case OpType::Max:
+        out = a > b ? a : b;
+        break;
+      case OpType::Min:
+        out = a < b ? a : b;
+        break;
+      case OpType::Clamp:
+        out = std::min(std::max(a, b), c);
+        break;
+      default:
+        if constexpr (std::is_same_v<T, int64_t>) {
+          switch (inst.op) {
+            case OpType::Mod:
+              NVF_CHECK(b != 0);
+              out = a % b;
+              break;
+            case OpType::CeilDiv:
+              NVF_CHECK(b != 0);
+              // Same rounding as ceildiv of PolymorphicValue
+              out = b > 0 ? (a + b - 1) / b : (a + b + 1) / b;
+              break;
+            case OpType::Gcd:
+              out = std::gcd(a, b);
+              break;
+            case OpType::BitwiseAnd:
+              out = a & b;
+              break;
+            case OpType::BitwiseOr:
+              out = a | b;
+              break;
+            case OpType::BitwiseXor:
+              out = a ^ b;
+              break;
+            case OpType::BitwiseNot:
+              out = ~a;
+              break;
+            default:
+              NVF_ERROR(false, "Unexpected integer op in Scalar Machine");
+          }
+        } else {
+          NVF_ERROR(false, "Unexpected floating point op in Scalar Machine");
+        }
+    }
+  }
+}
+
+void ScalarValueMachine::run() {
+  if (instructions_.empty()) {
+    return;
+  }
+  const auto& defined = precomputed_values_.defined_;
+  auto& values = precomputed_values_.values_;
+
+  // Load bound values. A binding of another type leaves the instructions
+  // depending on it unevaluated, like an unbound value.
+  for (auto index : operands_) {
+    known_[index] = defined[index] && load(index, values[index]);
+  }
+
+  for (const auto& inst : instructions_) {
+    // Bound values are not recomputed, see NaiveValueMachine::run
+    if (known_[inst.dest] || !known_[inst.src0] || !known_[inst.src1] ||
+        !known_[inst.src2]) {
+      continue;
+    }
+    switch (inst.type) {
+      case ScalarType::Int:
+        runInstruction<int64_t>(inst);
+        break;
+      case ScalarType::Double:
+        runInstruction<double>(inst);
+        break;
+      case ScalarType::Bool:
+        runInstruction<bool>(inst);
+        break;
+    }
+    known_[inst.dest] = true;
+  }
+
+  // Write back computed values
+  for (const auto& inst : instructions_) {
+    if (known_[inst.dest] && !defined[inst.dest]) {
+      const ScalarValue& value = values_[inst.dest];
+      switch (types_[inst.dest]) {
+        case ScalarType::Int:
+          values[inst.dest] = value.i;
+          break;
+        case ScalarType::Double:
+          values[inst.dest] = value.d;
+          break;
+        case ScalarType::Bool:
+          values[inst.dest] = value.b;
+          break;
+      }
+      precomputed_values_.defined_[inst.dest] = true;
+    }
+  }
+}
+
 NaiveValueMachine::NaiveValueMachine(PrecomputedValues& precomputed_values)
-    : precomputed_values_(precomputed_values), num_of_instructions_{0} {
+    : precomputed_values_(precomputed_values),
+      scalar_machine_(precomputed_values),
+      num_of_instructions_{0} {
   for (auto val : precomputed_values_.symbols_) {
     auto def = val->definition();
-    if (def) {
+    if (def && !scalar_machine_.handles(def)) {
       if (auto uop = dynamic_cast<UnaryOp*>(def)) {
         makeUnaryOp(uop);
       } else if (auto bop = dynamic_cast<BinaryOp*>(def)) {
@@ -393,6 +948,8 @@ NaiveValueMachine::NaiveValueMachine(PrecomputedValues& precomputed_values)
 }
 
 void NaiveValueMachine::copyFrom(const NaiveValueMachine& other) {
+  scalar_machine_.copyFrom(other.scalar_machine_);
+
   num_of_instructions_ = other.num_of_instructions_;
 
   inst_type_.clear();
@@ -414,14 +971,22 @@ void NaiveValueMachine::copyFrom(const NaiveValueMachine& other) {
   src0_.clear();
   src0_.insert(src0_.end(), other.src0_.begin(), other.src0_.end());
 
+  top_type_.clear();
+  top_type_.insert(
+      top_type_.end(), other.top_type_.begin(), other.top_type_.end());
+
   src1_.clear();
   src1_.insert(src1_.end(), other.src1_.begin(), other.src1_.end());
 
+  src2_.clear();
+  src2_.insert(src2_.end(), other.src2_.begin(), other.src2_.end());
+
   dest_.clear();
   dest_.insert(dest_.end(), other.dest_.begin(), other.dest_.end());
 }
 
 void NaiveValueMachine::run() {
+  scalar_machine_.run();
   for (const auto i : c10::irange(num_of_instructions_)) {
     // Skip this instruction if the dest location
     //  has already been computed or is constant.
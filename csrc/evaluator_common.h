@@ -23,6 +23,140 @@ class PrecomputedValues;
 class KernelArgumentHolder;
 struct TensorArgAbstract;
 
+//! ScalarValueMachine:
+//!  A runtime specialized for the scalar arithmetic that makes
+//!   up most extents, allocation sizes and launch parameters.
+//!   It takes the unary, binary and ternary ops on integer,
+//!   floating point and boolean scalars that only depend on
+//!   bound values, constants or other ops of this machine, and
+//!   runs them on a compact workspace of ScalarValue without
+//!   dispatching on PolymorphicValue. Values are only converted
+//!   from and to PolymorphicValue when bound values are loaded
+//!   and results are written back. Everything else, e.g. ops on
+//!   operands of different types, is left to the
+//!   NaiveValueMachine, which runs afterwards.
+class ScalarValueMachine {
+ public:
+  //! Types of the scalars in the workspace. Integers are held
+  //!  as int64_t and floating point values as double, like in
+  //!  PolymorphicValue.
+  enum class ScalarType : uint8_t { Int, Double, Bool };
+
+  //! Scalar operations supported by this machine. The types of
+  //!  the operands of each instruction are resolved when it is
+  //!  made, see tryMakeInstruction.
+  enum class OpType {
+    Neg,
+    Abs,
+    Cast,
+    Add,
+    Sub,
+    Mul,
+    Div,
+    Mod,
+    CeilDiv,
+    Max,
+    Min,
+    Gcd,
+    BitwiseAnd,
+    BitwiseOr,
+    BitwiseXor,
+    BitwiseNot,
+    Eq,
+    NE,
+    LT,
+    LE,
+    GT,
+    GE,
+    LogicalAnd,
+    LogicalOr,
+    LogicalNot,
+    Clamp,
+    Where
+  };
+
+  //! Constructor lowers all the supported expr IR nodes stored in
+  //!  precomputed_values and stores them in the private state.
+  ScalarValueMachine(PrecomputedValues& precomputed_values);
+
+  //! Copy all values other than `precomputed_values_` from other,
+  //!  see NaiveValueMachine::copyFrom.
+  void copyFrom(const ScalarValueMachine& other);
+
+  //! Returns true if expr was lowered to this machine
+  bool handles(const Expr* expr) const {
+    return handled_exprs_.count(expr) > 0;
+  }
+
+  //! Runs all the instructions and write results to the associated
+  //!  precomputed_values.
+  void run();
+
+ private:
+  //! An untagged scalar, the type of each workspace entry is
+  //!  given by types_
+  union ScalarValue {
+    int64_t i;
+    double d;
+    bool b;
+  };
+
+  struct Instruction {
+    OpType op;
+    //! Type of the operands. For Where, this is the type of the
+    //!  last two operands, the first one being Bool.
+    ScalarType type;
+    //! Workspace indices of the operands and the destination.
+    //!  Unused operands repeat src0.
+    int src0;
+    int src1;
+    int src2;
+    int dest;
+  };
+
+  //! Maps expr to an instruction if expr is a scalar operation
+  //!  supported by this machine and returns true on success.
+  bool tryMakeInstruction(Expr* expr);
+
+  //! Returns true if val is a scalar whose value is either
+  //!  bound, a constant or computed by this machine.
+  bool isScalarOperand(Val* val) const;
+
+  //! Converts value to the workspace entry at index, returns
+  //!  false if it doesn't have the type of that entry
+  bool load(int index, const PolymorphicValue& value);
+
+  //! Runs inst, whose operands are of type T
+  template <typename T>
+  void runInstruction(const Instruction& inst);
+
+ private:
+  //! Reference to the PrecomputedValues workspace associated with
+  //!   this runtime.
+  PrecomputedValues& precomputed_values_;
+
+  //! Instructions in topological order
+  std::vector<Instruction> instructions_;
+
+  //! Workspace indices read or written by the instructions, excluding
+  //!  constants. Bound values are loaded from these before each run.
+  std::vector<int> operands_;
+
+  //! Scalar workspace indexed like PrecomputedValues::values_. Constants
+  //!  are filled in at construction.
+  std::vector<ScalarValue> values_;
+
+  //! Type of the value at each index of values_
+  std::vector<ScalarType> types_;
+
+  //! Marks if the value at each index is known, i.e. constant,
+  //!  bound or computed.
+  std::vector<bool> known_;
+
+  //! Exprs lowered to this machine, skipped by NaiveValueMachine
+  std::unordered_set<const Expr*> handled_exprs_;
+};
+
 //! NaiveValueMachine:
 //!  This is an un-optimized runtime for evaluating a
 //!   set of values in one run. The runtime contains
@@ -89,6 +223,10 @@ class NaiveValueMachine {
   //!  the entry of each vector at the same index correspond to
   //!  the same instruction.
 
+  //! Fast path for the scalar instructions, which run before the
+  //!  ones in this machine
+  ScalarValueMachine scalar_machine_;
+
   //! Total number of instructions
   int num_of_instructions_ = 0;
 
@@ -204,21 +342,16 @@ class PrecomputedValues {
   void initializeValueList(const std::vector<Val*>& sorted_value_list);
 
   //! Bind concrete value to the given index
-  //!  if the index is valid.
-  void bindValue_(int index, const PolymorphicValue& value) {
-    if (index < 0 || is_constant_[index]) {
-      return;
-    }
-    defined_[index] = true;
-    values_[index] = value;
-    binding_log_.emplace_back(index, value);
-  }
+  //!  if the index is valid. Values that differ from the
+  //!  last evaluation are recorded as dirty.
+  void bindValue_(int index, const PolymorphicValue& value);
   template <typename T>
   void bindValue(int index, const T& value) {
     bindValue_(index, PolymorphicValue(value));
   }
 
-  //! Invalidate all computed values in the workspace.
+  //! Starts a new binding cycle. Computed values are kept so that the next
+  //!  evaluation only recomputes values depending on changed bindings.
   void invalidate();
 
   //! Interface for subclasses to access symbols_
@@ -256,7 +389,12 @@ class PrecomputedValues {
 
   void bindTensorMetaData(TensorView* tv, const at::Tensor& tensor);
 
+  //! Marks all computed values depending on the dirty bindings as
+  //!  undefined, so that the value machine recomputes them.
+  void invalidateDependents();
+
  private:
+  friend ScalarValueMachine;
   friend NaiveValueMachine;
 
   //! Marks if an evaluation has finished
@@ -288,6 +426,27 @@ class PrecomputedValues {
   //!  consistency check.
   std::vector<std::pair<int, PolymorphicValue>> binding_log_;
 
+  //! Marks if a value is bound in the current evaluation cycle.
+  std::vector<bool> bound_;
+
+  //! Indices of the values computed by each value, i.e. the
+  //!  outputs of the exprs using it.
+  std::vector<std::vector<int>> consumers_;
+
+  //! Indices bound to a different value than in the last
+  //!  evaluation, or bound in the last cycle but not in this one.
+  std::vector<int> dirty_;
+
+  //! Indices bound in the last evaluation cycle
+  std::vector<int> previously_bound_;
+
+  //! Marks if the workspace holds the values of the last
+  //!  successful evaluation, so that evaluate() only needs to
+  //!  recompute the values depending on dirty bindings. When no
+  //!  binding changed, evaluate() skips both the value machine
+  //!  and validate().
+  bool incremental_ = false;
+
   //! Integer runtime for realizing the values computations.
   std::unique_ptr<NaiveValueMachine> value_machine_;
 };
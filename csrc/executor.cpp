@@ -14,6 +14,7 @@
 #include <driver_api.h>
 #include <executor_kernel_arg.h>
 #include <executor_utils.h>
+#include <fusion_profiler.h>
 #include <global_allocator.h>
 #include <instrumentation.h>
 #include <ir/all_nodes.h>
@@ -22,6 +23,7 @@
 #include <kernel_ir.h>
 #include <options.h>
 #include <polymorphic_value.h>
+#include <sampling_profiler.h>
 #include <serde/utils.h>
 #include <tensor_metadata.h>
 #include <utils.h>
@@ -146,7 +148,7 @@ std::unique_ptr<PrecomputedValues>& FusionExecutor::
     evaluatorPrecomputedValues() {
   if (!evaluator_precomputed_values_) {
     evaluator_precomputed_values_ =
-        std::make_unique<PrecomputedValues>(lowered_->kernel());
+        std::make_unique<PrecomputedValues>(kernel());
   }
   return evaluator_precomputed_values_;
 }
@@ -158,8 +160,8 @@ std::string FusionExecutor::getStructuredCode(
   std::string code = "";
   code += includeStdComplex();
   code += std::string("namespace {\n") + defineTypes() +
-      defineIndexType(index_type) + executor_utils::kernelPreamble() +
-      kernel_str + "}\n";
+      defineIndexType(index_type) +
+      executor_utils::kernelPreamble(kernel_str) + kernel_str + "}\n";
 
   if (isDebugDumpEnabled(DebugDumpOption::CudaKernel)) {
     debug() << "\n======= Codegen output for kernel: " << kernelName()
@@ -372,7 +374,10 @@ void FusionExecutor::compileFusion(
     }
   }
 
-  kernel_code_ = codegen::generateCudaKernel(kernel, kernelName());
+  {
+    CompileStepScope step("codegen::generateCudaKernel");
+    kernel_code_ = codegen::generateCudaKernel(kernel, kernelName());
+  }
 
   // If NVFUSER_EXTERNAL_SRC is set, utilize the external source code.
   // If the loaded external source code is empty, revert to the default codegen.
@@ -458,13 +463,8 @@ void FusionExecutor::compileFusion(
       (block_size.has_value() ? block_size.value() : 1),
       block_size_high_water_mark_);
   maxrregcount_high_water_mark_ = compile_params.maxrregcount;
-  compiled_kernel_ = executor_utils::getCompiledKernel(
-      kernel_code_,
-      structured_code,
-      kernelName(),
-      kernel_id_,
-      compile_params,
-      block_size);
+  compileKernel(
+      structured_code, compile_params, block_size, dynamic_smem.value_or(0));
   NVF_ERROR(validKernelId(), "Invalid kernel id for FusionExecutor.");
 
   // These should be nullopt at this point, but reset just in case
@@ -964,12 +964,86 @@ int64_t IndexOfFusionInput(const Val* in, const Fusion* fusion) {
   return std::distance(fusion->inputs().begin(), i);
 }
 
-// Allocate an `at::Tensor` for `out_info` or compute it as an alias.
+// Check if a buffer kept in an ExecutorEntry pool can be handed out again
+// for a buffer described by info. This requires that no tensor, including
+// views, outside of the pool refers to its storage.
+bool isRecyclable(
+    const at::Tensor& pooled,
+    const FusionExecutor::GlobalBufferInfo& info) {
+  return pooled.defined() && pooled.use_count() == 1 &&
+      pooled.storage().use_count() == 1 && pooled.sizes() == info.sizes &&
+      pooled.scalar_type() == info.type;
+}
+
+// Sub-allocates the zero-initialized intermediates that are not taken from
+// the zeroed-memory arena from a single zeroed region, so that a launch
+// clears them with one memset instead of one per buffer. Returns the
+// unexpanded buffers by intermediate index, undefined for the intermediates
+// outside of the region, or nothing if fewer than two buffers would share it.
+std::vector<at::Tensor> allocateZeroedIntermediates(
+    const std::vector<FusionExecutor::GlobalBufferInfo>& intermediates,
+    const c10::Device& device) {
+  // Keeps the buffers aligned for vectorized accesses
+  constexpr int64_t kAlignment = 256;
+  std::vector<int64_t> offsets(intermediates.size(), -1);
+  int64_t num_bytes = 0;
+  int64_t num_buffers = 0;
+  for (const auto i : c10::irange(intermediates.size())) {
+    const auto& buf_info = intermediates.at(i);
+    if (!buf_info.zero_init || buf_info.resets_to_zero ||
+        isOptionEnabled(EnableOption::ReuseZeroedMemory)) {
+      continue;
+    }
+    int64_t numel = 1;
+    for (const auto j : c10::irange(buf_info.sizes.size())) {
+      if (buf_info.strides.at(j) != 0) {
+        numel *= buf_info.sizes.at(j);
+      }
+    }
+    offsets.at(i) = num_bytes;
+    num_bytes += roundUpToMultiple(
+        numel * (int64_t)at::elementSize(buf_info.type), kAlignment);
+    ++num_buffers;
+  }
+  if (num_buffers < 2) {
+    return {};
+  }
+
+  at::Tensor region = at::zeros(
+      {num_bytes}, at::TensorOptions().dtype(at::kByte).device(device));
+  std::vector<at::Tensor> buffers(intermediates.size());
+  for (const auto i : c10::irange(intermediates.size())) {
+    if (offsets.at(i) < 0) {
+      continue;
+    }
+    const auto& buf_info = intermediates.at(i);
+    std::vector<int64_t> sizes;
+    for (const auto j : c10::irange(buf_info.sizes.size())) {
+      sizes.push_back(buf_info.strides.at(j) == 0 ? 1L : buf_info.sizes.at(j));
+    }
+    std::vector<int64_t> strides(sizes.size(), 1L);
+    for (int64_t j = (int64_t)sizes.size() - 2; j >= 0; --j) {
+      strides.at(j) = strides.at(j + 1) * std::max(sizes.at(j + 1), 1L);
+    }
+    at::Tensor buffer = at::empty({0}, region.options().dtype(buf_info.type));
+    buffer.set_(
+        region.storage(),
+        offsets.at(i) / (int64_t)at::elementSize(buf_info.type),
+        sizes,
+        strides);
+    buffers.at(i) = std::move(buffer);
+  }
+  return buffers;
+}
+
+// Allocate an `at::Tensor` for `out_info` or compute it as an alias. If
+// pooled is given, a newly allocated tensor is recycled from or saved to it.
 at::Tensor allocateOutput(
     const FusionExecutor::GlobalBufferInfo& out_info,
     const AliasInfo& alias_info,
     const c10::Device& device,
-    ExpressionEvaluator& ee) {
+    ExpressionEvaluator& ee,
+    at::Tensor* pooled = nullptr) {
   // Handle a fusion with duplicated outputs.
   TensorView* out_tv = out_info.tv;
   if (ee.isKnown(out_tv)) {
@@ -995,6 +1069,13 @@ at::Tensor allocateOutput(
 
   switch (alias_info.type) {
     case AllocationType::New: {
+      if (pooled != nullptr && isRecyclable(*pooled, out_info) &&
+          pooled->strides() == out_info.strides) {
+        if (shouldFillAllocationWithNan()) {
+          fillTensorWithNan(*pooled);
+        }
+        return *pooled;
+      }
       auto alloc_tensor = at::native::empty_strided_cuda(
           out_info.sizes,
           out_info.strides,
@@ -1005,6 +1086,9 @@ at::Tensor allocateOutput(
       if (shouldFillAllocationWithNan()) {
         fillTensorWithNan(alloc_tensor);
       }
+      if (pooled != nullptr) {
+        *pooled = alloc_tensor;
+      }
       return alloc_tensor;
     }
     case AllocationType::ReuseBuffer:
@@ -1013,6 +1097,31 @@ at::Tensor allocateOutput(
       // the output tensor may hold different data from the input, e.g., an
       // updated running mean.  `ExpressionEvaluator::evaluate(out_tv)`
       // would trigger non-trivial host computation.
+      if (alias_info.slice_start != nullptr) {
+        // Write only the slice of the buffer covered by the output, e.g., the
+        // new entries of a KV cache. The rest of the buffer is untouched.
+        const int64_t dim = alias_info.slice_dim;
+        const int64_t start = ee.evaluate(alias_info.slice_start).as<int64_t>();
+        const int64_t extent =
+            ee.evaluate(TensorDomain::noReductions(
+                            out_tv->getMaybeRFactorDomain())
+                            .at(dim)
+                            ->extent())
+                .as<int64_t>();
+        NVF_CHECK(
+            start >= 0 && start + extent <= aliased_io_tensor->size(dim),
+            "Slice [",
+            start,
+            ", ",
+            start + extent,
+            ") of dimension ",
+            dim,
+            " is out of range for ",
+            aliased_io->toString(),
+            " of size ",
+            aliased_io_tensor->sizes());
+        return aliased_io_tensor->narrow(dim, start, extent);
+      }
       return aliased_io_tensor.value();
     case AllocationType::Evaluate: {
       auto out_tensor = ee.evaluate(out_tv).as<at::Tensor>();
@@ -1033,15 +1142,22 @@ at::Tensor allocateOutput(
 }
 
 // Allocate output tensors for a given fusion. Outputs may alias inputs, in
-// that case output tensors are shallow copies of the aliased inputs
+// that case output tensors are shallow copies of the aliased inputs. If
+// output_pool is given, newly allocated outputs are recycled from it. Defined
+// tensors in given_outputs are used as is instead of being allocated.
 std::vector<at::Tensor> allocateOutputs(
     const Fusion* fusion,
     const std::vector<FusionExecutor::GlobalBufferInfo>& output_info,
     const c10::Device& device,
-    ExpressionEvaluator& ee) {
+    ExpressionEvaluator& ee,
+    std::vector<at::Tensor>* output_pool = nullptr,
+    const std::vector<at::Tensor>& given_outputs = {}) {
   FUSER_PERF_SCOPE("allocateOutputs");
 
   const auto num_outs = output_info.size();
+  if (output_pool != nullptr) {
+    output_pool->resize(num_outs);
+  }
 
   // Sort the outputs so we compute aliases after allocating non-aliases. The
   // order between aliases can be arbitrary. E.g.,
@@ -1074,8 +1190,17 @@ std::vector<at::Tensor> allocateOutputs(
 
   std::vector<at::Tensor> out_tensors(num_outs);
   for (const auto& [out_index, out] : sorted_outs) {
+    if (!given_outputs.empty() && given_outputs.at(out_index).defined()) {
+      ee.bind(out, given_outputs.at(out_index));
+      out_tensors[out_index] = given_outputs.at(out_index);
+      continue;
+    }
     at::Tensor out_tensor = allocateOutput(
-        output_info[out_index], fusion->getOutputAlias(out), device, ee);
+        output_info[out_index],
+        fusion->getOutputAlias(out),
+        device,
+        ee,
+        output_pool == nullptr ? nullptr : &output_pool->at(out_index));
     // Bind `out_tensor` so
     // 1. duplicated outputs map to the same tensor,
     // 2. an output that aliases another output can be evaluated via
@@ -1151,7 +1276,7 @@ LaunchParams FusionExecutor::computeLaunchParams(
 
   auto data_cache = compileTimeDataCache();
 
-  auto lower = lowered_.get();
+  auto lower = lowered();
   auto& used_tvs = getUsedTVs();
   auto parallel_binding_ids_entry =
       executor_utils::caching::ExecutorCompileTimeEntry<
@@ -1241,7 +1366,7 @@ LaunchParams FusionExecutor::computeLaunchParams(
     expr_eval.precomputedValues()->evaluate();
   }
 
-  const auto kernel = lowered_->kernel();
+  const auto kernel = this->kernel();
   const auto& kernel_summary = kernel->summary();
 
   // Calculate Dynamic Shared Memory Size
@@ -1294,6 +1419,30 @@ LaunchParams FusionExecutor::computeLaunchParams(
     validateDynamicSmemSize(dynamic_smem_size);
   }
 
+  if (kernel_summary.hasClusters()) {
+    NVF_CHECK(
+        !kernel_summary.has_cooperative_grid_reduction,
+        "Cooperative launches with thread block clusters are not supported");
+    const auto& cluster_dims = kernel_summary.cluster_dims;
+    NVF_CHECK(
+        launch_params.gdimx() % cluster_dims[0] == 0 &&
+            launch_params.gdimy() % cluster_dims[1] == 0 &&
+            launch_params.gdimz() % cluster_dims[2] == 0,
+        "The grid (",
+        launch_params.gdimx(),
+        ", ",
+        launch_params.gdimy(),
+        ", ",
+        launch_params.gdimz(),
+        ") is not divisible by the thread block clusters (",
+        cluster_dims[0],
+        ", ",
+        cluster_dims[1],
+        ", ",
+        cluster_dims[2],
+        ")");
+  }
+
   launch_params.setSmem(dynamic_smem_size);
 
   return launch_params;
@@ -1307,7 +1456,7 @@ std::vector<FusionExecutor::GlobalBufferInfo> FusionExecutor::
 
   std::vector<GlobalBufferInfo> global_buffers;
 
-  const auto kernel = lowered_->kernel();
+  const auto kernel = this->kernel();
   const auto& kernel_summary = kernel->summary();
 
   for (auto alloc : kernel_summary.global_allocations) {
@@ -1379,6 +1528,11 @@ std::vector<FusionExecutor::GlobalBufferInfo> getOutputBufferInfo(
     auto dtype =
         (info.tv->dtype() == DataType::Index ? index_dtype : info.tv->dtype());
     info.type = data_type_to_aten(dtype);
+    // Atomic grid reductions accumulate into their outputs
+    if (auto rop = dynamic_cast<ReductionOp*>(info.tv->definition());
+        rop != nullptr && rop->atomicGridReductionRequested()) {
+      info.zero_init = true;
+    }
 
     outputs.emplace_back(info);
   }
@@ -1570,7 +1724,8 @@ void FusionExecutor::initializeExecutorEntry(
     const LaunchParams& launch_constraints,
     const CompileParams& compile_params,
     const std::vector<at::Tensor>& outputs,
-    DataType index_type) {
+    DataType index_type,
+    bool infer_output_info) {
   FUSER_PERF_SCOPE("FusionExecutor::initializeExecutorEntry");
 
   ExpressionEvaluator expr_eval;
@@ -1584,14 +1739,23 @@ void FusionExecutor::initializeExecutorEntry(
     NVF_CHECK(expr_eval.evaluate(entry.first).as<bool>(), entry.second);
   }
 
+  // Undefined outputs are allocated by runFusion
+  const bool all_outputs_given = !outputs.empty() &&
+      std::all_of(outputs.begin(), outputs.end(), [](const at::Tensor& t) {
+        return t.defined();
+      });
+
   executor_utils::validateVectorizedTensors(
       kernel(), args, outputs, compileTimeDataCache(), expr_eval);
+  executor_entry.vectorized_alignment_bits =
+      executor_utils::getVectorizedTensorAlignmentBits(
+          kernel(), args, outputs, compileTimeDataCache());
 
   std::vector<GlobalBufferInfo> output_info;
 
-  if (outputs.empty()) {
+  if (!all_outputs_given || infer_output_info) {
     output_info =
-        getOutputBufferInfo(args, expr_eval, index_type, lowered_->kernel());
+        getOutputBufferInfo(args, expr_eval, index_type, kernel());
   } else {
     // Need to save the information necessary for allocations as
     // future uses of this ExecutorEntry may not be provided with
@@ -1611,7 +1775,7 @@ void FusionExecutor::initializeExecutorEntry(
 }
 
 /// Copies the data, logical_size, and alloc_stride parameters to the
-/// appropriate parts of entry.args[idx].
+/// appropriate parts of the idx-th argument in entry.args.
 ///
 /// For GPU tensors, we pass a Tensor<type, rank, rank> struct (see
 /// runtime/tensor.cu), where the rank describes the number of elements in the
@@ -1649,11 +1813,18 @@ static void fillTensorArgMetadata(
 #undef TMD_ARRAY_REF
 
   // These are the three offsets we need to copy into.
+  std::byte* arg = entry.args.data() + entry.arg_offsets[idx];
+  NVF_ERROR(
+      sizeof(void*) + (shape.size() + strides.size()) * idx_type_size <=
+          entry.arg_sizes[idx],
+      "Tensor argument ",
+      idx,
+      " doesn't fit in the space set up for it");
   std::array<std::byte*, 3> offsets = {
-      entry.args[idx].data(), // data ptr
-      entry.args[idx].data() + sizeof(void*), // shape array
+      arg, // data ptr
+      arg + sizeof(void*), // shape array
       // strides array:
-      entry.args[idx].data() + sizeof(void*) + shape.size() * idx_type_size,
+      arg + sizeof(void*) + shape.size() * idx_type_size,
   };
 
   memcpy(offsets[0], &data, sizeof(void*));
@@ -1695,13 +1866,31 @@ void FusionExecutor::computeArgs(
     const kir::Kernel* kernel) const {
   FUSER_PERF_SCOPE("Initial GetArgsBuffers");
 
+  // Each argument is aligned like the largest type it can contain, e.g. a
+  // pointer or a complex double
+  constexpr int64_t arg_alignment = 16;
+
   const std::vector<Val*>& params = kernel->parameters();
-  entry.args.resize(params.size());
-  entry.arg_ptrs.resize(params.size());
   const PrimDataType idx_type = kernel->indexType();
+  std::vector<std::vector<std::byte>> arg_bytes;
+  arg_bytes.reserve(params.size());
+  entry.arg_offsets.resize(params.size());
+  entry.arg_sizes.resize(params.size());
+  size_t total_bytes = 0;
   for (size_t p = 0; p < params.size(); ++p) {
-    entry.args[p] = getKernelArgument(expr_eval, params[p], idx_type);
-    entry.arg_ptrs[p] = entry.args[p].data();
+    arg_bytes.push_back(getKernelArgument(expr_eval, params[p], idx_type));
+    entry.arg_offsets[p] = total_bytes;
+    entry.arg_sizes[p] = arg_bytes.back().size();
+    total_bytes += (size_t)roundUpToMultiple(
+        (int64_t)entry.arg_sizes[p], arg_alignment);
+  }
+
+  entry.args.assign(total_bytes, std::byte{0});
+  entry.arg_ptrs.resize(params.size());
+  for (size_t p = 0; p < params.size(); ++p) {
+    std::byte* arg = entry.args.data() + entry.arg_offsets[p];
+    memcpy(arg, arg_bytes[p].data(), entry.arg_sizes[p]);
+    entry.arg_ptrs[p] = arg;
   }
 }
 
@@ -1716,9 +1905,9 @@ void FusionExecutor::recomputeArgs(
 
   const std::vector<Val*>& params = kernel->parameters();
   const PrimDataType idx_type = kernel->indexType();
-  // assert(entry.args.size() == params.size());
-  // assert(entry.arg_ptrs.size() == params.size());
-  // assert(params.size() >= args.size());
+  NVF_ERROR(
+      entry.arg_offsets.size() == params.size(),
+      "Kernel arguments have not been set up for this entry");
   for (size_t p = 0; p < params.size(); ++p) {
     PolymorphicValue pv = expr_eval.evaluate(params[p]);
     if (pv.is<at::Tensor>() && pv.as<at::Tensor>().is_cuda()) {
@@ -1735,13 +1924,199 @@ void FusionExecutor::recomputeArgs(
       const size_t idx_type_size =
           PrimDataType::Int == idx_type ? sizeof(int64_t) : sizeof(int32_t);
       fillTensorArgMetadata(entry, tmd, p, idx_type_size);
-    } else {
-      entry.args[p] = getKernelArgument(expr_eval, params[p], idx_type);
+    } else if (!writeScalarKernelArgument(
+                   pv,
+                   params[p]->dtype(),
+                   idx_type,
+                   entry.args.data() + entry.arg_offsets[p],
+                   entry.arg_sizes[p])) {
+      // Scalars have a static size, so they are overwritten in place. Only
+      // those that aren't primitive scalars, e.g. CPU scalar tensors, are
+      // converted to a temporary buffer first.
+      std::vector<std::byte> bytes =
+          getKernelArgument(expr_eval, params[p], idx_type);
+      NVF_ERROR(
+          bytes.size() == entry.arg_sizes[p],
+          "Size of kernel argument ",
+          p,
+          " changed from ",
+          entry.arg_sizes[p],
+          " to ",
+          bytes.size());
+      memcpy(
+          entry.args.data() + entry.arg_offsets[p], bytes.data(), bytes.size());
     }
-    entry.arg_ptrs[p] = entry.args[p].data();
   }
 }
 
+bool FusionExecutor::canLaunchWithDataPointers(size_t cache_id) const {
+  if (!hasCompiledKernel() || disable_parameter_cache_ || !execute_kernel_ ||
+      kernel()->topLevelExprs().empty()) {
+    return false;
+  }
+  auto it = executor_entry_lookup_.find(cache_id);
+  if (it == executor_entry_lookup_.end()) {
+    return false;
+  }
+  const ExecutorEntry& entry = it->second;
+  if (!entry.init || entry.arg_ptrs.empty() || !entry.intermediates.empty()) {
+    return false;
+  }
+  // Scalars, including the RNG seed and offset, may change between launches
+  const std::vector<Val*>& params = kernel()->parameters();
+  return params.size() ==
+      kernel()->inputs().size() + kernel()->outputs().size() &&
+      std::all_of(params.begin(), params.end(), [](Val* param) {
+           auto tv = dynamic_cast<TensorView*>(param);
+           return tv != nullptr && !tv->isCpuScalar() &&
+               tv->getMemoryType() == MemoryType::Global;
+         });
+}
+
+void FusionExecutor::launchWithDataPointers(
+    size_t cache_id,
+    c10::ArrayRef<void*> data_ptrs) {
+  FUSER_PERF_SCOPE("FusionExecutor::launchWithDataPointers");
+  ExecutorEntry& entry = executor_entry_lookup_.at(cache_id);
+  NVF_ERROR(
+      data_ptrs.size() == entry.arg_ptrs.size(),
+      "Expected ",
+      entry.arg_ptrs.size(),
+      " data pointers, but got ",
+      data_ptrs.size());
+
+  // The data pointer is the first field of a Tensor argument, see
+  // fillTensorArgMetadata
+  for (const auto i : c10::irange(data_ptrs.size())) {
+    memcpy(
+        entry.args.data() + entry.arg_offsets[i], &data_ptrs[i], sizeof(void*));
+  }
+
+  c10::DeviceGuard dg(options_.device);
+  auto stream = at::cuda::getCurrentCUDAStream();
+  const LaunchParams& launch_params = entry.launch_params;
+  const bool sample_kernel_time = SamplingProfiler::shouldSample(num_runs_++);
+  cudaEvent_t sample_start = nullptr;
+  if (sample_kernel_time) {
+    sample_start =
+        SamplingProfiler::get().startSample(options_.device.index(), stream);
+  }
+  if (!kernel()->summary().has_cooperative_grid_reduction) {
+    NVFUSER_CUDA_SAFE_CALL(cuLaunchKernel(
+        compiled_kernel_->function,
+        launch_params.gdimx(),
+        launch_params.gdimy(),
+        launch_params.gdimz(),
+        launch_params.bdimx(),
+        launch_params.bdimy(),
+        launch_params.bdimz(),
+        launch_params.smem(),
+        stream,
+        entry.arg_ptrs.data(),
+        nullptr));
+  } else {
+    NVFUSER_CUDA_SAFE_CALL(cuLaunchCooperativeKernel(
+        compiled_kernel_->function,
+        launch_params.gdimx(),
+        launch_params.gdimy(),
+        launch_params.gdimz(),
+        launch_params.bdimx(),
+        launch_params.bdimy(),
+        launch_params.bdimz(),
+        launch_params.smem(),
+        stream,
+        entry.arg_ptrs.data()));
+  }
+  if (sample_kernel_time) {
+    // The bytes are only known if they have been measured by runFusion
+    const bool bytes_known = bytes_processed_per_input_.has_value() &&
+        bytes_processed_per_output_.has_value();
+    SamplingProfiler::get().stopSample(
+        options_.device.index(),
+        stream,
+        sample_start,
+        kernelName(),
+        bytes_known ? bytesProcessed() : 0);
+  }
+}
+
+void FusionExecutor::launchDeferred(const DeferredLaunch& launch) {
+  FUSER_PERF_SCOPE("FusionExecutor::launchDeferred");
+  NVF_ERROR(hasCompiledKernel());
+  std::vector<void*> arg_ptrs;
+  arg_ptrs.reserve(launch.arg_offsets.size());
+  for (auto offset : launch.arg_offsets) {
+    // cuLaunchKernel only reads the arguments
+    arg_ptrs.push_back(const_cast<std::byte*>(launch.args.data() + offset));
+  }
+  c10::DeviceGuard dg(options_.device);
+  auto stream = at::cuda::getCurrentCUDAStream();
+  const auto& launch_params = launch.launch_params;
+  NVFUSER_CUDA_SAFE_CALL(cuLaunchKernel(
+      compiled_kernel_->function,
+      launch_params.gdimx(),
+      launch_params.gdimy(),
+      launch_params.gdimz(),
+      launch_params.bdimx(),
+      launch_params.bdimy(),
+      launch_params.bdimz(),
+      launch_params.smem(),
+      stream,
+      arg_ptrs.data(),
+      nullptr));
+}
+
+void FusionExecutor::compileKernel(
+    const std::string& structured_code,
+    CompileParams compile_params,
+    std::optional<int64_t> block_size,
+    int64_t dynamic_smem) {
+  const bool has_target =
+      compile_params.min_blocks_per_sm > 1 && block_size.has_value();
+  const bool enable_ptxas_verbose = compile_params.enable_ptxas_verbose;
+  if (has_target) {
+    // Spills are only reported in the verbose log of ptxas
+    compile_params.enable_ptxas_verbose = true;
+  }
+  compiled_kernel_ = executor_utils::getCompiledKernel(
+      kernel_code_,
+      structured_code,
+      kernelName(),
+      kernel_id_,
+      compile_params,
+      block_size);
+  if (!has_target) {
+    return;
+  }
+
+  int blocks_per_sm = -1;
+  NVFUSER_CUDA_SAFE_CALL(cuOccupancyMaxActiveBlocksPerMultiprocessor(
+      &blocks_per_sm,
+      compiled_kernel_->function,
+      (int)block_size.value(),
+      (size_t)dynamic_smem));
+  const int spills = compiled_kernel_->register_spills;
+  if (blocks_per_sm >= compile_params.min_blocks_per_sm && spills <= 0) {
+    return;
+  }
+  if (isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
+    debug() << kernelName() << " reaches " << blocks_per_sm << " of "
+            << compile_params.min_blocks_per_sm << " target blocks per SM"
+            << " and spills " << std::max(spills, 0)
+            << " bytes, recompiling without the target" << std::endl;
+  }
+  // The launch bounds are kept for the block size only
+  compile_params.min_blocks_per_sm = 1;
+  compile_params.enable_ptxas_verbose = enable_ptxas_verbose;
+  compiled_kernel_ = executor_utils::getCompiledKernel(
+      kernel_code_,
+      structured_code,
+      kernelName(),
+      kernel_id_,
+      compile_params,
+      block_size);
+}
+
 void FusionExecutor::recompileKernel(
     const LaunchParams& new_launch_params,
     const CompileParams& new_compile_params) {
@@ -1754,13 +2129,11 @@ void FusionExecutor::recompileKernel(
   block_size_high_water_mark_ = new_launch_params.nThreads();
   maxrregcount_high_water_mark_ = new_compile_params.maxrregcount;
 
-  compiled_kernel_ = executor_utils::getCompiledKernel(
-      kernel_code_,
+  compileKernel(
       structured_code,
-      kernelName(),
-      kernel_id_,
       new_compile_params,
-      block_size_high_water_mark_);
+      block_size_high_water_mark_,
+      new_launch_params.smem());
 
   resetCompiledKernelProperties();
 
@@ -1836,6 +2209,11 @@ int64_t FusionExecutor::ensureAvailableDynamicSmemSize(
   NVF_ERROR(
       hasCompiledKernel(),
       "Cannot set dynamic smem size unless kernel is compiled");
+  if (dynamic_smem_size > getAvailableDynamicSmemSize()) {
+    // The kernel may be shared with other executors that raised its limit in
+    // the meantime, which must not be lowered
+    available_dynamic_smem_size_.reset();
+  }
   if (dynamic_smem_size > getAvailableDynamicSmemSize()) {
     validateDynamicSmemSize(dynamic_smem_size);
     NVFUSER_CUDA_SAFE_CALL(cuFuncSetAttribute(
@@ -1858,10 +2236,19 @@ std::vector<at::Tensor> FusionExecutor::evaluateFusionOutputs(
     ExpressionEvaluator& expr_eval) {
   // TODO: Add relevant profiling code.
   if (outputs.empty()) {
-    for (const auto& out_val : fusion()->outputs()) {
-      auto out_tensor =
-          expr_eval.evaluate(out_val->as<TensorView>()).as<at::Tensor>();
-      outputs.emplace_back(out_tensor);
+    outputs.resize(fusion()->outputs().size());
+  }
+  const c10::Device device(c10::DeviceType::CUDA, args.getDeviceIndex());
+  for (const auto i : c10::irange(outputs.size())) {
+    if (!outputs[i].defined()) {
+      outputs[i] = expr_eval.evaluate(fusion()->outputs()[i]->as<TensorView>())
+                       .as<at::Tensor>();
+      // Fusions of CPU scalars are evaluated on the host, see
+      // ExprEvalScheduler. Their outputs are copied to the device
+      // asynchronously, which costs less than a kernel launch.
+      if (outputs[i].is_cpu()) {
+        outputs[i] = outputs[i].to(device, /*non_blocking=*/true);
+      }
     }
   }
   args.push(outputs);
@@ -1884,19 +2271,23 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
   // Bind fusion inputs
   ExpressionEvaluator expr_eval;
   const auto& inputs = fusion()->inputs();
-  for (const auto i : c10::irange(inputs.size())) {
-    expr_eval.bind(inputs[i], *args[i]);
+  {
+    FUSER_PERF_SCOPE("FusionExecutor::bindInputs");
+    for (const auto i : c10::irange(inputs.size())) {
+      expr_eval.bind(inputs[i], *args[i]);
+    }
   }
 
   const bool measure_kernel_time = measure_kernel_time_ ||
       isDebugDumpEnabled(DebugDumpOption::EffectiveBandwidth) ||
       isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose);
+  const bool sample_kernel_time = SamplingProfiler::shouldSample(num_runs_++);
 
   // It's important to determine the input bytes processed prior
   // to pushing the outputs into the arg struct.  Otherwise,
   // the outputs will also be included with inputs when determining
   // the input bytes accessed.
-  if (measure_kernel_time) {
+  if (measure_kernel_time || sample_kernel_time) {
     inputBytesProcessed(args);
   }
 
@@ -1909,9 +2300,6 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
   }
 
   NVF_ERROR(validKernelId(), "Invalid kernel id for FusionExecutor.");
-  NVF_ERROR(
-      !args.getCacheId().has_value() || outputs.empty(),
-      "short cut input cache is not compatible with pre-allocated output");
 
   validateIndexType(kernel(), compile_params);
 
@@ -1943,7 +2331,73 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
         launch_constraints,
         compile_params,
         outputs,
-        kernel()->indexType());
+        kernel()->indexType(),
+        /*infer_output_info=*/executor_entry != &temporary_executor_entry);
+  } else {
+    // The input id already encodes the metadata and the alignment of the
+    // fusion inputs, but neither of them covers pre-allocated outputs or the
+    // inputs of a segment, so the pointers are checked before the previous
+    // validation is trusted
+    const auto alignment_bits =
+        executor_utils::getVectorizedTensorAlignmentBits(
+            kernel(), args, outputs, compileTimeDataCache());
+#ifdef NDEBUG
+    const bool validate = !alignment_bits.has_value() ||
+        alignment_bits != executor_entry->vectorized_alignment_bits;
+#else
+    const bool validate = true;
+#endif // NDEBUG
+    if (validate) {
+      ExpressionEvaluator validation_eval;
+      evaluatorPrecomputedValues()->bindInputs(args);
+      validation_eval.precomputedValues() =
+          evaluatorPrecomputedValues().get();
+      executor_utils::validateVectorizedTensors(
+          kernel(), args, outputs, compileTimeDataCache(), validation_eval);
+      executor_entry->vectorized_alignment_bits = alignment_bits;
+    }
+  }
+
+  // Pre-allocated outputs are only compatible with the short cut input cache
+  // when they have the layout the kernel writes, since the cached launch
+  // parameters are derived from it. Strides of size-1 dimensions don't
+  // matter.
+  if (!outputs.empty() && executor_entry != &temporary_executor_entry) {
+    for (const auto i : c10::irange(outputs.size())) {
+      if (!outputs[i].defined()) {
+        continue;
+      }
+      const auto& info = executor_entry->outputs.at(i);
+      bool same_strides = outputs[i].dim() == (int64_t)info.strides.size();
+      for (int64_t dim = 0; same_strides && dim < outputs[i].dim(); dim++) {
+        same_strides = outputs[i].size(dim) <= 1 ||
+            outputs[i].stride(dim) == info.strides.at(dim);
+      }
+      NVF_CHECK(
+          outputs[i].sizes() == info.sizes && same_strides &&
+              outputs[i].scalar_type() == info.type &&
+              outputs[i].device() == options_.device,
+          "Pre-allocated output ",
+          i,
+          " does not match the cached output for input id ",
+          *args.getCacheId(),
+          ": expected sizes ",
+          info.sizes,
+          " and strides ",
+          info.strides,
+          " of type ",
+          info.type,
+          " on ",
+          options_.device,
+          ", but got sizes ",
+          outputs[i].sizes(),
+          " and strides ",
+          outputs[i].strides(),
+          " of type ",
+          outputs[i].scalar_type(),
+          " on ",
+          outputs[i].device());
+    }
   }
 
   recompileKernel(executor_entry->launch_params, compile_params);
@@ -1954,10 +2408,48 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
   // context manager to disable auto grad for `empty_cuda` calls later
   at::AutoDispatchBelowADInplaceOrView non_variable_type_mode;
 
+  // Buffer recycling is only possible with a persistent executor entry
+  const bool use_buffer_pool = isOptionEnabled(EnableOption::BufferPool) &&
+      executor_entry != &temporary_executor_entry;
+  if (use_buffer_pool && executor_entry->pool_stream != stream.unwrap()) {
+    executor_entry->output_pool.clear();
+    executor_entry->intermediate_pool.clear();
+    executor_entry->pool_stream = stream.unwrap();
+  }
+
   // only allocate outputs when not given
-  if (outputs.empty()) {
+  if (outputs.empty() ||
+      std::any_of(outputs.begin(), outputs.end(), [](const at::Tensor& t) {
+        return !t.defined();
+      })) {
     outputs = allocateOutputs(
-        fusion(), executor_entry->outputs, options_.device, expr_eval);
+        fusion(),
+        executor_entry->outputs,
+        options_.device,
+        expr_eval,
+        use_buffer_pool ? &executor_entry->output_pool : nullptr,
+        outputs);
+  }
+  // Outputs of atomic grid reductions must be zero before every launch, even
+  // when they are given or recycled
+  for (const auto i : c10::irange(outputs.size())) {
+    if (executor_entry->outputs.at(i).zero_init) {
+      outputs[i].zero_();
+    }
+  }
+  // Scatter-add kernels only accumulate src into the output, so it has to
+  // hold a copy of self before every launch
+  for (const auto i : c10::irange(outputs.size())) {
+    auto sop = dynamic_cast<ScatterOp*>(kernel()->outputs()[i]->definition());
+    if (sop == nullptr || sop->getScatterOpType() != ScatterOpType::Add) {
+      continue;
+    }
+    auto self = expr_eval.evaluate(sop->selfTv());
+    NVF_CHECK(
+        self.is<at::Tensor>(),
+        "The self tensor of scatter_add must be computable on the host: ",
+        sop->selfTv()->toString());
+    outputs[i].copy_(self.as<at::Tensor>());
   }
   args.push(outputs);
 
@@ -1977,8 +2469,46 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
   at::Tensor profile_buffer;
   {
     FUSER_PERF_SCOPE("ExecutorRunFusion::IntermediateBufferAlloc");
+    if (use_buffer_pool) {
+      executor_entry->intermediate_pool.resize(
+          executor_entry->intermediates.size());
+    }
+    // Pooled buffers are refilled one by one instead
+    const std::vector<at::Tensor> zeroed_intermediates = use_buffer_pool
+        ? std::vector<at::Tensor>()
+        : allocateZeroedIntermediates(
+              executor_entry->intermediates, options_.device);
     for (const auto i : c10::irange(executor_entry->intermediates.size())) {
       const auto& buf_info = executor_entry->intermediates.at(i);
+      at::Tensor* pooled =
+          use_buffer_pool ? &executor_entry->intermediate_pool.at(i) : nullptr;
+      // The zeroed-memory arena already recycles its memory. Expanded
+      // buffers can't be refilled in place, so they are not pooled either.
+      const bool uses_zeroed_arena = buf_info.zero_init &&
+          (isOptionEnabled(EnableOption::ReuseZeroedMemory) ||
+           buf_info.resets_to_zero);
+      const bool is_expanded = std::any_of(
+          buf_info.strides.begin(), buf_info.strides.end(), [](int64_t s) {
+            return s == 0;
+          });
+      const bool can_pool = !uses_zeroed_arena && !is_expanded;
+      if (pooled != nullptr && can_pool && isRecyclable(*pooled, buf_info)) {
+        at::Tensor intermediate_buffer = *pooled;
+        if (buf_info.zero_init) {
+          intermediate_buffer.zero_();
+        } else if (shouldFillAllocationWithNan()) {
+          fillTensorWithNan(intermediate_buffer);
+        }
+        args.push(intermediate_buffer);
+        intermediates.push_back(intermediate_buffer);
+        expr_eval.bind(
+            kernel()->summary().global_allocations.at(i)->buffer(),
+            *args[inputs.size() + outputs.size() + i]);
+        if (buf_info.is_profile_buffer) {
+          profile_buffer = intermediate_buffer;
+        }
+        continue;
+      }
       bool has_expansion = false;
       std::vector<int64_t> unexpanded_sizes;
       unexpanded_sizes.reserve(buf_info.sizes.size());
@@ -2000,6 +2530,10 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
           // enabled the option (unsafe)
           intermediate_buffer = contigZeroedTensor(
               unexpanded_sizes, buf_info.type, options_.device);
+        } else if (
+            !zeroed_intermediates.empty() &&
+            zeroed_intermediates.at(i).defined()) {
+          intermediate_buffer = zeroed_intermediates.at(i);
         } else {
           intermediate_buffer = at::zeros(
               unexpanded_sizes,
@@ -2020,6 +2554,9 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
         intermediate_buffer =
             at::native::expand(intermediate_buffer, buf_info.sizes);
       }
+      if (pooled != nullptr && can_pool) {
+        *pooled = intermediate_buffer;
+      }
       args.push(intermediate_buffer);
       intermediates.push_back(intermediate_buffer);
       expr_eval.bind(
@@ -2055,7 +2592,16 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
 
   executor_utils::CudaKernelTimer timer(stream);
 
-  if (execute_kernel_ && !kernel()->topLevelExprs().empty()) {
+  if (execute_kernel_ && !kernel()->topLevelExprs().empty() && defer_launch_) {
+    // Launched by the caller, e.g. as part of a HorizontalKernel
+    NVF_ERROR(
+        !kernel()->summary().has_cooperative_grid_reduction,
+        "Cooperative launches can't be deferred");
+    ensureAvailableDynamicSmemSize(executor_entry->launch_params.smem());
+    recomputeArgs(*executor_entry, expr_eval, kernel());
+    deferred_launch_ = DeferredLaunch{
+        launch_params_, executor_entry->args, executor_entry->arg_offsets};
+  } else if (execute_kernel_ && !kernel()->topLevelExprs().empty()) {
     if (measure_kernel_time) {
       timer.init();
     }
@@ -2067,23 +2613,13 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
     if (isDebugDumpEnabled(DebugDumpOption::Occupancy) ||
         isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
       int blocks_per_sm = -1;
-      NVFUSER_CUDA_SAFE_CALL(cuOccupancyMaxActiveBlocksPerMultiprocessor(
-          &blocks_per_sm,
-          compiled_kernel_->function,
-          launch_params_.nThreads(),
-          launch_params_.smem()));
+      const float occupancy =
+          computeKernelOccupancy(launch_params_, &blocks_per_sm);
+      setKernelOccupancy(occupancy);
 
-      const int64_t device_id =
-          static_cast<unsigned char>(options_.device.index());
-      const auto prop =
-          at::cuda::getDeviceProperties((c10::DeviceIndex)device_id);
+      const auto prop = at::cuda::getDeviceProperties(options_.device.index());
       const int64_t warps_per_sm =
           ceilDiv(blocks_per_sm * launch_params_.nThreads(), prop->warpSize);
-
-      const int hw_max_warps =
-          prop->maxThreadsPerMultiProcessor / prop->warpSize;
-      const float occupancy = (float)warps_per_sm / (float)hw_max_warps * 100.f;
-      setKernelOccupancy(occupancy);
       std::ostringstream oss;
       oss << std::fixed << std::setprecision(2) << occupancy << "%";
 
@@ -2096,6 +2632,11 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
     if (measure_kernel_time) {
       timer.start();
     }
+    cudaEvent_t sample_start = nullptr;
+    if (sample_kernel_time) {
+      sample_start =
+          SamplingProfiler::get().startSample(options_.device.index(), stream);
+    }
 
     if (!kernel()->summary().has_cooperative_grid_reduction) {
       FUSER_PERF_SCOPE("ExecutorRunFusion::cuLaunchKernel");
@@ -2126,6 +2667,14 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
           executor_entry->arg_ptrs.data()));
     }
 
+    if (sample_kernel_time) {
+      SamplingProfiler::get().stopSample(
+          options_.device.index(),
+          stream,
+          sample_start,
+          kernelName(),
+          inputBytesProcessed(args) + outputBytesProcessed(outputs));
+    }
     if (measure_kernel_time) {
       kernel_time_ms_ = timer.elapsed();
     }
@@ -2147,12 +2696,36 @@ std::vector<at::Tensor> FusionExecutor::runFusion(
   releaseZeroedMemory();
 
   if (isOptionEnabled(EnableOption::KernelProfile)) {
+    if (group_id_ >= 0) {
+      debug() << "Segment " << group_id_ << ": ";
+    }
     debug() << kernel()->profile().toString(profile_buffer);
   }
 
   return outputs;
 }
 
+float FusionExecutor::computeKernelOccupancy(
+    const LaunchParams& launch_params,
+    int* blocks_per_sm) const {
+  NVF_ERROR(hasCompiledKernel(), "No compiled kernel to compute occupancy of");
+  int num_blocks = -1;
+  NVFUSER_CUDA_SAFE_CALL(cuOccupancyMaxActiveBlocksPerMultiprocessor(
+      &num_blocks,
+      compiled_kernel_->function,
+      (int)launch_params.nThreads(),
+      (size_t)launch_params.smem()));
+  if (blocks_per_sm != nullptr) {
+    *blocks_per_sm = num_blocks;
+  }
+
+  const auto prop = at::cuda::getDeviceProperties(options_.device.index());
+  const int64_t warps_per_sm =
+      ceilDiv(num_blocks * launch_params.nThreads(), prop->warpSize);
+  const int hw_max_warps = prop->maxThreadsPerMultiProcessor / prop->warpSize;
+  return (float)warps_per_sm / (float)hw_max_warps * 100.f;
+}
+
 int64_t FusionExecutor::inputBytesProcessed(const KernelArgumentHolder& args) {
   int64_t total_bytes = 0;
   if (!bytes_processed_per_input_.has_value()) {
@@ -2290,6 +2863,11 @@ flatbuffers::Offset<serde::FusionExecutor> FusionExecutor::serialize(
   // See table definition for FusionExecutor in serde/fusion_cache.fbs
   using fb_executor_entry = flatbuffers::Offset<serde::ExecutorEntry>;
 
+  // The executor entries refer to the tvs of the lowered kernel
+  if (hasCompiledKernel()) {
+    lowered();
+  }
+
   // Separate unordered_map for executor_entry_lookup into key and value
   // vectors. The key value is the cache_id value in the KernelArgumentHolder.
   std::vector<size_t> executor_entry_lookup_keys_fb;
@@ -2496,9 +3074,10 @@ void FusionExecutor::deserialize(
   compile_params.index_type = serde::mapToNvfuserDtype(buffer->index_type());
   compile_params.maxrregcount = maxrregcount_high_water_mark_;
 
-  // Get lowered fusion
-  lowered_ = std::make_unique<GpuLower>(fusion, compile_params);
-  lowered_->run();
+  // Lowering is deferred until the kernel IR is first needed. The fusion is
+  // copied as the caller may not keep it alive until then.
+  deserialized_fusion_ = std::make_unique<Fusion>(*fusion);
+  deserialized_compile_params_ = compile_params;
 
   // Replace integers that are tensor sizes by named scalars like "T0.size[0]"
   createKernelId(
@@ -2507,13 +3086,26 @@ void FusionExecutor::deserialize(
       buffer->concrete_id(),
       buffer->runtime_id(),
       buffer->group_id());
-  setUsedTVs();
 
-  // GlobalBufferInfo requires lowered kernel before deserialization
+  // The tvs of GlobalBufferInfo require the lowered kernel, so only their
+  // positions are kept until then
   for (auto idx : c10::irange(buffer->executor_entry_lookup_keys()->size())) {
-    executor_entry_lookup_.emplace(
-        buffer->executor_entry_lookup_keys()->Get(idx),
-        deserialize(buffer->executor_entry_lookup_values()->Get(idx)));
+    const size_t cache_id = buffer->executor_entry_lookup_keys()->Get(idx);
+    const serde::ExecutorEntry* entry_buffer =
+        buffer->executor_entry_lookup_values()->Get(idx);
+    executor_entry_lookup_.emplace(cache_id, deserialize(entry_buffer));
+    for (auto is_intermediate : {false, true}) {
+      auto buffers = is_intermediate ? entry_buffer->intermediates()
+                                     : entry_buffer->outputs();
+      for (auto i : c10::irange(buffers->size())) {
+        deserialized_buffer_tvs_.push_back(
+            {cache_id,
+             is_intermediate,
+             i,
+             buffers->Get(i)->tv(),
+             buffers->Get(i)->is_fusion_output()});
+      }
+    }
   }
 
   compiled_kernel_ = executor_utils::getCompiledKernel(
@@ -2554,19 +3146,8 @@ FusionExecutor::GlobalBufferInfo FusionExecutor::deserialize(
   NVF_ERROR(
       buffer->tv() != -1, "Serialization failed to encode buffer tv position.");
 
-  NVF_ERROR(lowered_ != nullptr, "Lowered kernel is not initialized.");
-
+  // info.tv is set by lowerDeserializedFusion
   GlobalBufferInfo info;
-  if (buffer->is_fusion_output()) {
-    auto out_val = kernel()->outputs().at(buffer->tv());
-    NVF_ERROR(out_val != nullptr);
-    info.tv = dynamic_cast<TensorView*>(out_val);
-  } else {
-    auto out_val = kernel()->summary().global_allocations.at(buffer->tv());
-    NVF_ERROR(out_val != nullptr);
-    info.tv = dynamic_cast<TensorView*>(out_val->buffer());
-  }
-
   for (auto dim_size : *buffer->sizes()) {
     info.sizes.emplace_back(dim_size);
   }
@@ -2582,4 +3163,36 @@ FusionExecutor::GlobalBufferInfo FusionExecutor::deserialize(
   return info;
 }
 
+void FusionExecutor::lowerDeserializedFusion() {
+  FUSER_PERF_SCOPE("FusionExecutor::lowerDeserializedFusion");
+  NVF_ERROR(lowered_ == nullptr && deserialized_fusion_ != nullptr);
+
+  c10::DeviceGuard dg(options_.device);
+  lowered_ = std::make_unique<GpuLower>(
+      deserialized_fusion_.get(), deserialized_compile_params_);
+  lowered_->run();
+  setUsedTVs();
+
+  for (const auto& buffer : deserialized_buffer_tvs_) {
+    auto entry_it = executor_entry_lookup_.find(buffer.cache_id);
+    if (entry_it == executor_entry_lookup_.end()) {
+      // Evicted before the first launch
+      continue;
+    }
+    GlobalBufferInfo& info = buffer.is_intermediate
+        ? entry_it->second.intermediates.at(buffer.index)
+        : entry_it->second.outputs.at(buffer.index);
+    if (buffer.is_fusion_output) {
+      auto out_val = kernel()->outputs().at(buffer.tv);
+      NVF_ERROR(out_val != nullptr);
+      info.tv = dynamic_cast<TensorView*>(out_val);
+    } else {
+      auto out_val = kernel()->summary().global_allocations.at(buffer.tv);
+      NVF_ERROR(out_val != nullptr);
+      info.tv = dynamic_cast<TensorView*>(out_val->buffer());
+    }
+  }
+  deserialized_buffer_tvs_.clear();
+}
+
 } // namespace nvfuser
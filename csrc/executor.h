@@ -21,8 +21,11 @@
 #include <atomic>
 
 #include <c10/core/DeviceType.h>
+#include <c10/core/Stream.h>
 
 #include <functional>
+#include <optional>
+#include <utility>
 
 namespace nvfuser {
 
@@ -174,7 +177,7 @@ class FusionExecutor : public NonCopyable {
   bool isCompiled() const {
     // Check at most one of fusion_ and lowered_ is null.
     NVF_ERROR(!(fusion_ && lowered_));
-    return fusion_ || lowered_;
+    return fusion_ || lowered_ || deserialized_fusion_;
   };
 
   // function to query whether a `FusionExecutor` has a compiled kernel to
@@ -186,13 +189,54 @@ class FusionExecutor : public NonCopyable {
           !fusion_,
           "fusion_ should only be initialized when using expression evaluator.");
     }
-    return validKernelId() && lowered_ && compiled_kernel_ != nullptr;
+    return validKernelId() && (lowered_ || deserialized_fusion_) &&
+        compiled_kernel_ != nullptr;
   };
 
   void evictCache(size_t cache_id) {
     executor_entry_lookup_.erase(cache_id);
   }
 
+  //! Returns true if the kernel can be relaunched for cache_id with
+  //! launchWithDataPointers, i.e. the executor entry of cache_id has been
+  //! launched before and the kernel only takes global input and output
+  //! tensors
+  bool canLaunchWithDataPointers(size_t cache_id) const;
+
+  //! Relaunches the kernel with the arguments cached for cache_id on the
+  //! current stream, replacing only the data pointers of its input and output
+  //! tensors. The caller guarantees that the tensors have the sizes, strides
+  //! and alignment the entry was set up for.
+  NVF_API void launchWithDataPointers(
+      size_t cache_id,
+      c10::ArrayRef<void*> data_ptrs);
+
+  //! A kernel launch that runFusion prepared but didn't issue, see
+  //! setDeferLaunchFlag
+  struct DeferredLaunch {
+    LaunchParams launch_params;
+    //! The packed kernel arguments, laid out like ExecutorEntry::args
+    std::vector<std::byte> args;
+    std::vector<size_t> arg_offsets;
+  };
+
+  //! When set, runFusion allocates the outputs and computes the arguments as
+  //! usual, but leaves the launch to the caller through takeDeferredLaunch.
+  //! The caller has to keep the arguments given to runFusion alive until the
+  //! kernel is launched. Used to launch several kernels as one, see
+  //! HorizontalKernel.
+  void setDeferLaunchFlag(bool defer_launch) {
+    defer_launch_ = defer_launch;
+  }
+
+  //! Returns the launch deferred by the last runFusion, if any
+  std::optional<DeferredLaunch> takeDeferredLaunch() {
+    return std::exchange(deferred_launch_, std::nullopt);
+  }
+
+  //! Issues a deferred launch of this kernel on the current stream
+  void launchDeferred(const DeferredLaunch& launch);
+
   // struct used to hold necessary information to launch compiled kernel on a
   // given input set.
   //
@@ -205,36 +249,53 @@ class FusionExecutor : public NonCopyable {
     std::vector<GlobalBufferInfo> outputs;
     // Temporary work buffers and intemediate global-memory tensors
     std::vector<GlobalBufferInfo> intermediates;
-    // The arguments to the kernel. These are configured in computeArgs and
-    // recomputeArgs.
-    // For the common case of a tensor argument, these correspond to the
-    // `struct Tensor` data in runtime/tensor.cu. That means each tensor
-    // element in `args` would be a sizeof(void*) + len(shape)*sizeof(int) +
+    // Misalignment of the vectorized tensors when they were last validated,
+    // see executor_utils::getVectorizedTensorAlignmentBits. Later launches
+    // with the same bits skip the validation.
+    std::optional<uint64_t> vectorized_alignment_bits;
+    // The arguments to the kernel, packed into a single buffer. Its layout is
+    // set up in computeArgs and only the values are updated in place by
+    // recomputeArgs, so it is never reallocated on the launch path.
+    // For the common case of a tensor argument, the bytes of an argument
+    // correspond to the `struct Tensor` data in runtime/tensor.cu. That means
+    // each tensor would be a sizeof(void*) + len(shape)*sizeof(int) +
     // len(shape)*sizeof(int) byte array (here "int" is used in place of the
     // index type, which varies in practice).
-    std::vector<std::vector<std::byte>> args;
-    // This is just the data() pointers to the above `args`; cuLaunchKernel
+    std::vector<std::byte> args;
+    // Offset and size in bytes of each kernel parameter in `args`
+    std::vector<size_t> arg_offsets;
+    std::vector<size_t> arg_sizes;
+    // Pointers to each parameter in the above `args`; cuLaunchKernel
     // requires an array of this form.
     std::vector<void*> arg_ptrs;
+    // Buffers recycled across runs when EnableOption::BufferPool is set,
+    // indexed like `outputs` and `intermediates`. A pooled buffer is only
+    // handed out again once nothing outside of this entry refers to it.
+    std::vector<at::Tensor> output_pool;
+    std::vector<at::Tensor> intermediate_pool;
+    // The stream the pooled buffers were last used on. Reuse is only
+    // stream-ordered on the same stream, so the pools are dropped when the
+    // stream changes.
+    std::optional<c10::Stream> pool_stream;
   };
 
   using ExecutorCompileTimeInfoCache =
       executor_utils::caching::ExecutorCompileTimeInfoCache;
 
   kir::Kernel* kernel() const {
-    NVF_ERROR(lowered_);
-    return lowered_->kernel();
+    return lowered()->kernel();
   }
 
   Fusion* fusion() const {
+    const bool is_lowered = lowered_ || deserialized_fusion_;
     NVF_ERROR(
-        (lowered_ && !fusion_) || (!lowered_ && fusion_),
+        (is_lowered && !fusion_) || (!is_lowered && fusion_),
         "Expected one and only one of fusion_ and lowered_ to be initialized.");
-    return lowered_ ? lowered_->kernel()->as<Fusion>() : fusion_.get();
+    return fusion_ ? fusion_.get() : lowered()->kernel()->as<Fusion>();
   }
 
   const ThreadPredicateMap& threadPredMap() const {
-    return lowered_->threadPredMap();
+    return lowered()->threadPredMap();
   }
 
   //! Internal knob used for debugging/profiling only
@@ -268,6 +329,18 @@ class FusionExecutor : public NonCopyable {
     kernel_occupancy_ = occupancy;
   }
 
+  //! Number of launches so far
+  int64_t numRuns() const {
+    return num_runs_;
+  }
+
+  //! Computes the theoretical occupancy of the compiled kernel launched with
+  //! launch_params, in percent of the warps an SM can hold. blocks_per_sm, if
+  //! given, is set to the number of resident blocks per SM.
+  NVF_API float computeKernelOccupancy(
+      const LaunchParams& launch_params,
+      int* blocks_per_sm = nullptr) const;
+
   //! get register spills (load + store) of the compiled kernel
   int getKernelRegisterSpills() const {
     return compiled_kernel_->register_spills;
@@ -330,6 +403,16 @@ class FusionExecutor : public NonCopyable {
     return *compiled_kernel_;
   }
 
+  //! Host memory held by the compiled kernel in bytes, i.e. its CUDA code,
+  //! PTX and cubin. A kernel shared with other executors is counted by each.
+  int64_t compiledKernelBytes() const {
+    if (compiled_kernel_ == nullptr) {
+      return 0;
+    }
+    return (int64_t)(kernel_code_.size() + compiled_kernel_->ptx.size() +
+                     compiled_kernel_->cubin.size());
+  }
+
   //! Returns the disassembled latest compiled binary
   NVF_API std::string disassembledBinary(
       const std::string& nvdisasm_args = "") const {
@@ -455,6 +538,8 @@ class FusionExecutor : public NonCopyable {
   void setUsedTVs();
 
   const std::vector<TensorView*>& getUsedTVs() const {
+    // used_tvs_ of deserialized executors is set by the deferred lowering
+    lowered();
     return used_tvs_;
   };
 
@@ -463,16 +548,31 @@ class FusionExecutor : public NonCopyable {
   }
 
   //! TODO: Consider changing this to a constructor of ExecutorEntry
+  //! If infer_output_info is false, the layout of the outputs is taken from
+  //! the given outputs, if any. Otherwise it is inferred from the kernel so
+  //! that outputs given to later runs can be validated against it.
   void initializeExecutorEntry(
       ExecutorEntry& executor_entry,
       const KernelArgumentHolder& args,
       const LaunchParams& launch_constraints,
       const CompileParams& compile_params,
       const std::vector<at::Tensor>& outputs,
-      DataType index_type);
+      DataType index_type,
+      bool infer_output_info);
 
   std::unique_ptr<PrecomputedValues>& evaluatorPrecomputedValues();
 
+  // Sets compiled_kernel_ to structured_code compiled for blocks of
+  // block_size threads. If compile_params has a target occupancy, which the
+  // compiled kernel doesn't reach with dynamic_smem bytes of shared memory
+  // or only reaches by spilling registers, the kernel is compiled again
+  // without the target.
+  void compileKernel(
+      const std::string& structured_code,
+      CompileParams compile_params,
+      std::optional<int64_t> block_size,
+      int64_t dynamic_smem);
+
   // Recompile the kernel if the number of threads in the block has increased
   // or maxrregcount has changed
   void recompileKernel(
@@ -517,6 +617,21 @@ class FusionExecutor : public NonCopyable {
   //! Deserialize GlobalBufferInfo using flatbuffers
   GlobalBufferInfo deserialize(const serde::GlobalBufferInfo* buffer);
 
+  //! Returns the lowering of the kernel, lowering the deserialized fusion
+  //! first if it has not been lowered yet
+  GpuLower* lowered() const {
+    if (lowered_ == nullptr && deserialized_fusion_ != nullptr) {
+      // The deferred lowering is logically part of deserialize
+      const_cast<FusionExecutor*>(this)->lowerDeserializedFusion();
+    }
+    NVF_ERROR(lowered_);
+    return lowered_.get();
+  }
+
+  //! Lowers the deserialized fusion and sets what deserialize skipped, i.e.,
+  //! the used tvs and the tvs of the deserialized executor entries
+  void lowerDeserializedFusion();
+
   //! Get the current dynamic shared memory size
   int64_t getAvailableDynamicSmemSize();
 
@@ -556,7 +671,7 @@ class FusionExecutor : public NonCopyable {
   const int64_t max_static_smem_ = 48 << 10;
 
   int64_t warp_size_ = 0;
-  std::unique_ptr<executor_utils::CompiledKernel> compiled_kernel_;
+  std::shared_ptr<executor_utils::CompiledKernel> compiled_kernel_;
 
   // TensorViews actually used in the kernel.
   std::vector<TensorView*> used_tvs_;
@@ -587,6 +702,25 @@ class FusionExecutor : public NonCopyable {
   // Initialized for non-compiled fusions
   std::unique_ptr<Fusion> fusion_;
 
+  // The lowering of deserialized executors is deferred until the kernel IR
+  // is first needed, e.g., by the first launch, so that the kernels of a
+  // deserialized cache that are never launched are never lowered. See
+  // lowered().
+  std::unique_ptr<Fusion> deserialized_fusion_;
+  CompileParams deserialized_compile_params_;
+
+  // Buffers of the deserialized executor entries, whose tvs are set once the
+  // deserialized fusion is lowered
+  struct DeserializedBufferTv {
+    size_t cache_id = 0;
+    bool is_intermediate = false;
+    size_t index = 0;
+    // Position in the kernel outputs or global allocations
+    int64_t tv = -1;
+    bool is_fusion_output = false;
+  };
+  std::vector<DeserializedBufferTv> deserialized_buffer_tvs_;
+
   // Track the block size this kernel was compiled with. If the block size
   // increases, recompile to adjust maxregister count.
   int64_t block_size_high_water_mark_ = 1;
@@ -609,6 +743,13 @@ class FusionExecutor : public NonCopyable {
   // kernel on the GPU or not
   bool execute_kernel_ = true;
 
+  // Horizontal fusion support: knob to leave the kernel launch of runFusion
+  // to the caller
+  bool defer_launch_ = false;
+
+  // Horizontal fusion support: the launch skipped by the last runFusion
+  std::optional<DeferredLaunch> deferred_launch_ = std::nullopt;
+
   // Profiling support: knob to enable measuring kernel execution time
   bool measure_kernel_time_ = false;
 
@@ -616,6 +757,10 @@ class FusionExecutor : public NonCopyable {
   // is true
   float kernel_time_ms_ = 0;
 
+  // Profiling support: number of runs, used to pick the launches timed by
+  // the SamplingProfiler
+  int64_t num_runs_ = 0;
+
   // Heuristic tuning support: the last kernel occupancy, if
   // DebugDumpOption::Occupancy is true
   float kernel_occupancy_ = -1.0f;
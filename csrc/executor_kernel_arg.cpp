@@ -21,6 +21,7 @@ namespace nvfuser {
 KernelArgumentHolder KernelArgumentHolder::createKernelArgumentHolder(
     const c10::ArrayRef<c10::IValue>& inputs,
     std::optional<int8_t> selected_device) {
+  FUSER_PERF_SCOPE("KernelArgumentHolder::createKernelArgumentHolder");
   if (inputs.empty()) {
     // default to device 0
     KernelArgumentHolder args;
@@ -226,12 +227,18 @@ std::vector<std::byte> polymorphicValueToBytes(
         (index_type == PrimDataType::Int32 && dtype == DataType::Index)) {
       int32_t v32 = (int32_t)v;
       return std::vector<std::byte>((std::byte*)&v32, (std::byte*)&v32 + 4);
+    } else if (dtype == DataType::UInt32) {
+      uint32_t v32 = (uint32_t)v;
+      return std::vector<std::byte>((std::byte*)&v32, (std::byte*)&v32 + 4);
+    } else if (dtype == DataType::Int8) {
+      int8_t v8 = (int8_t)v;
+      return std::vector<std::byte>((std::byte*)&v8, (std::byte*)&v8 + 1);
     } else {
       NVF_ERROR(
           false,
           "Cannot convert int64_t to ",
           dtype,
-          " type: only int32 and int64 are supported.");
+          " type: only int8, int32, uint32 and int64 are supported.");
     }
   } else if (argument.is<bool>()) {
     // FUSER_PERF_SCOPE("polymorphicValueToBytes(bool)");
@@ -378,4 +385,73 @@ std::vector<std::byte> getKernelArgument(
   return polymorphicValueToBytes(pv, parameter->dtype(), index_type);
 }
 
+bool writeScalarKernelArgument(
+    const PolymorphicValue& argument,
+    const DataType& dtype,
+    PrimDataType index_type,
+    std::byte* dst,
+    size_t size) {
+  auto write = [dst, size, &dtype](auto v) {
+    NVF_ERROR(
+        sizeof(v) == size,
+        "Size of kernel argument of type ",
+        dtype,
+        " changed from ",
+        size,
+        " to ",
+        sizeof(v));
+    memcpy(dst, &v, sizeof(v));
+    return true;
+  };
+  if (argument.is<Pointer>()) {
+    if (!std::holds_alternative<PointerType>(dtype.type)) {
+      return false;
+    }
+    return write((void*)argument);
+  } else if (argument.is<int64_t>()) {
+    int64_t v = argument.as<int64_t>();
+    if (dtype == DataType::Int ||
+        (index_type == PrimDataType::Int && dtype == DataType::Index)) {
+      return write(v);
+    } else if (
+        dtype == DataType::Int32 ||
+        (index_type == PrimDataType::Int32 && dtype == DataType::Index)) {
+      return write((int32_t)v);
+    } else if (dtype == DataType::UInt32) {
+      return write((uint32_t)v);
+    } else if (dtype == DataType::Int8) {
+      return write((int8_t)v);
+    }
+  } else if (argument.is<bool>()) {
+    if (dtype == DataType::Bool) {
+      return write(argument.as<bool>());
+    }
+  } else if (argument.is<double>()) {
+    double v = argument.as<double>();
+    if (dtype == DataType::Double) {
+      return write(v);
+    } else if (dtype == DataType::Float) {
+      return write((float)v);
+    } else if (dtype == DataType::Half) {
+      return write((at::Half)(float)v);
+    } else if (dtype == DataType::BFloat16) {
+      return write((at::BFloat16)(float)v);
+    } else if (dtype == DataType::Float8_e4m3fn) {
+      return write((at::Float8_e4m3fn)(float)v);
+    } else if (dtype == DataType::Float8_e5m2) {
+      return write((at::Float8_e5m2)(float)v);
+    }
+  } else if (argument.is<std::complex<double>>()) {
+    std::complex<double> v = argument.as<std::complex<double>>();
+    if (dtype == DataType::ComplexDouble) {
+      return write(v);
+    } else if (dtype == DataType::ComplexFloat) {
+      return write((std::complex<float>)v);
+    }
+  }
+  // Anything else, including unsupported conversions, goes through
+  // polymorphicValueToBytes, which reports the error
+  return false;
+}
+
 } // namespace nvfuser
@@ -127,4 +127,14 @@ std::vector<std::byte> getKernelArgument(
     Val* parameter,
     PrimDataType index_type);
 
+//! Converts a scalar argument like polymorphicValueToBytes, but writes its
+//! size bytes directly to dst. Returns false without writing if the argument
+//! is not a primitive scalar, e.g., an array or a CPU scalar tensor.
+bool writeScalarKernelArgument(
+    const PolymorphicValue& argument,
+    const DataType& dtype,
+    PrimDataType index_type,
+    std::byte* dst,
+    size_t size);
+
 } // namespace nvfuser
@@ -22,7 +22,15 @@ std::string CompileParams::toString() const {
   }
   ss << "maxrregcount = " << maxrregcount << ", "
      << "enable_magic_zero = " << enable_magic_zero << ", "
-     << "enable_ptxas_verbose = " << enable_ptxas_verbose << "\n";
+     << "enable_ptxas_verbose = " << enable_ptxas_verbose;
+  if (hasClusters()) {
+    ss << ", cluster_dims = (" << cluster_dims[0] << ", " << cluster_dims[1]
+       << ", " << cluster_dims[2] << ")";
+  }
+  if (min_blocks_per_sm > 0) {
+    ss << ", min_blocks_per_sm = " << min_blocks_per_sm;
+  }
+  ss << "\n";
   return ss.str();
 }
 
@@ -11,6 +11,7 @@
 #include <type.h>
 #include <visibility.h>
 
+#include <array>
 #include <optional>
 
 namespace nvfuser {
@@ -21,6 +22,14 @@ struct CompileParams {
   bool enable_magic_zero = true;
   // if true, save ptxas info to compile log and check for register spilling
   bool enable_ptxas_verbose = false;
+  // Thread block cluster dimensions the kernel is launched with. Clusters are
+  // only used when one of them is larger than 1, which requires Hopper.
+  std::array<int64_t, 3> cluster_dims = {1, 1, 1};
+  // Target occupancy of the kernel in blocks per SM, see
+  // EnableOption::OccupancyTargeting. If positive, the kernel is declared
+  // with __launch_bounds__ of its block size and this minimum, and the
+  // register cap leaves room for that many blocks. 0 means no target.
+  int64_t min_blocks_per_sm = 0;
 
   bool operator==(const CompileParams& other) const {
     // Disallow comparison if the index type is nullopt
@@ -32,7 +41,13 @@ struct CompileParams {
         "cannot compare as the other index type is not defined");
     return index_type == other.index_type &&
         maxrregcount == other.maxrregcount &&
-        enable_magic_zero == other.enable_magic_zero;
+        enable_magic_zero == other.enable_magic_zero &&
+        cluster_dims == other.cluster_dims &&
+        min_blocks_per_sm == other.min_blocks_per_sm;
+  }
+
+  bool hasClusters() const {
+    return cluster_dims[0] > 1 || cluster_dims[1] > 1 || cluster_dims[2] > 1;
   }
 
   bool operator!=(const CompileParams& other) const {
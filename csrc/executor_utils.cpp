@@ -15,12 +15,16 @@
 #include <debug.h>
 #include <driver_api.h>
 #include <executor_utils.h>
+#include <fusion_profiler.h>
 #include <instrumentation.h>
 #include <ir/all_nodes.h>
 #include <ir/iostream.h>
 #include <ir/utils.h>
+#include <kernel_db/disk_cache.h>
 #include <kernel_db/kernel_db.h>
+#include <kernel_db/kernel_store.h>
 #include <options.h>
+#include <scheduler/registry.h>
 #include <tensor_metadata.h>
 #include <torch/csrc/jit/resource_guard.h>
 #include <utils.h>
@@ -35,6 +39,7 @@
 #include <nvfuser_resources/block_sync_default.h>
 #include <nvfuser_resources/block_welford_outer.h>
 #include <nvfuser_resources/broadcast.h>
+#include <nvfuser_resources/cluster.h>
 #include <nvfuser_resources/complex_number.h>
 #include <nvfuser_resources/fp16_support.h>
 #include <nvfuser_resources/fp8_support.h>
@@ -56,8 +61,15 @@
 #include <nvfuser_resources/warp.h>
 #include <nvfuser_resources/welford.h>
 
+#include <algorithm>
 #include <cstdlib>
 #include <fstream>
+#include <future>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #include <variant>
 
 #include <nvrtc.h>
@@ -65,7 +77,50 @@
 namespace nvfuser {
 namespace executor_utils {
 
-std::string kernelPreamble() {
+namespace {
+
+// Which optional parts of the runtime library a kernel needs. The runtime
+// functions are called by name by the generated code, so they are detected
+// from the names that appear in the kernel string. The parts the detected
+// ones depend on are included as well.
+struct RuntimeSections {
+  bool fp8 = true;
+  bool random_numbers = true;
+  bool grid_sync = true;
+  bool mbarrier = true;
+  bool cluster = true;
+  // block and grid reductions, broadcasts and welfords, which depend on each
+  // other
+  bool reductions = true;
+  bool warp = true;
+  bool memory = true;
+
+  static RuntimeSections usedBy(const std::string& kernel_str) {
+    auto uses = [&kernel_str](std::initializer_list<const char*> names) {
+      return std::any_of(names.begin(), names.end(), [&](const char* name) {
+        return kernel_str.find(name) != std::string::npos;
+      });
+    };
+    RuntimeSections sections;
+    sections.fp8 = uses({"__e4m3", "__e5m2"});
+    sections.random_numbers = uses({"philox", "rng_"});
+    sections.reductions = uses(
+        {"blockReduce",
+         "blockIterGroupedReduce",
+         "reduction::",
+         "broadcast::",
+         "welford",
+         "Welford"});
+    sections.warp = uses({"warp::"});
+    sections.memory = uses({"toSmem", "Turing::", "Ampere::", "Hopper::"});
+    sections.mbarrier = sections.memory || uses({"mbarrier::"});
+    sections.grid_sync = sections.reductions || uses({"grid_sync::"});
+    sections.cluster = sections.reductions || uses({"cluster::"});
+    return sections;
+  }
+};
+
+std::string kernelPreamble(const RuntimeSections& sections) {
   std::stringstream ss;
   ss << nvfuser_resources::basic_type_traits_cu;
   ss << nvfuser_resources::bit_cu;
@@ -73,13 +128,17 @@ std::string kernelPreamble() {
 
   ss << nvfuser_resources::fp16_support_cu;
   ss << nvfuser_resources::bf16_support_cu;
-  ss << nvfuser_resources::fp8_support_cu;
+  if (sections.fp8) {
+    ss << nvfuser_resources::fp8_support_cu;
+  }
 
   // Base classes and helpers
   ss << nvfuser_resources::type_traits_cu;
   ss << nvfuser_resources::array_cu;
   ss << nvfuser_resources::tensor_cu;
-  ss << nvfuser_resources::random_numbers_cu;
+  if (sections.random_numbers) {
+    ss << nvfuser_resources::random_numbers_cu;
+  }
   ss << nvfuser_resources::helpers_cu;
   ss << nvfuser_resources::index_utils_cu;
   ss << nvfuser_resources::tuple_cu;
@@ -90,26 +149,54 @@ std::string kernelPreamble() {
   } else {
     ss << nvfuser_resources::block_sync_default_cu;
   }
-  ss << nvfuser_resources::grid_sync_cu;
-  ss << nvfuser_resources::mbarrier_cu;
+  if (sections.grid_sync) {
+    ss << nvfuser_resources::grid_sync_cu;
+  }
+  if (sections.mbarrier) {
+    ss << nvfuser_resources::mbarrier_cu;
+  }
+  if (sections.cluster) {
+    ss << nvfuser_resources::cluster_cu;
+  }
 
   // Communication classes
-  ss << nvfuser_resources::block_reduction_cu;
-  ss << nvfuser_resources::grid_reduction_cu;
-  ss << nvfuser_resources::grid_broadcast_cu;
-  ss << nvfuser_resources::broadcast_cu;
-  ss << nvfuser_resources::welford_cu;
-  ss << nvfuser_resources::warp_cu;
-  ss << nvfuser_resources::memory_cu;
-  ss << nvfuser_resources::fused_welford_helper_cu;
-  ss << nvfuser_resources::fused_reduction_cu;
-  ss << nvfuser_resources::fused_welford_impl_cu;
-  ss << nvfuser_resources::block_welford_outer_cu;
-  ss << nvfuser_resources::fused_welford_impl_outer_cu;
+  if (sections.reductions) {
+    ss << nvfuser_resources::block_reduction_cu;
+    ss << nvfuser_resources::grid_reduction_cu;
+    ss << nvfuser_resources::grid_broadcast_cu;
+    ss << nvfuser_resources::broadcast_cu;
+    ss << nvfuser_resources::welford_cu;
+  }
+  if (sections.warp) {
+    ss << nvfuser_resources::warp_cu;
+  }
+  if (sections.memory) {
+    ss << nvfuser_resources::memory_cu;
+  }
+  if (sections.reductions) {
+    ss << nvfuser_resources::fused_welford_helper_cu;
+    ss << nvfuser_resources::fused_reduction_cu;
+    ss << nvfuser_resources::fused_welford_impl_cu;
+    ss << nvfuser_resources::block_welford_outer_cu;
+    ss << nvfuser_resources::fused_welford_impl_outer_cu;
+  }
 
   return ss.str();
 }
 
+} // namespace
+
+std::string kernelPreamble() {
+  return kernelPreamble(RuntimeSections());
+}
+
+std::string kernelPreamble(const std::string& kernel_str) {
+  if (!isOptionEnabled(EnableOption::PrunePreamble)) {
+    return kernelPreamble();
+  }
+  return kernelPreamble(RuntimeSections::usedBy(kernel_str));
+}
+
 // Query the target GPU version number NVRTC compiles CUDA kernels for
 void queryTargetGPUVersion(
     const cudaDeviceProp* const prop,
@@ -612,6 +699,10 @@ void validateAlignedVectorizedTensors(
   if (!outputs.empty()) {
     for (auto pos : tensor_vectorization_validation_entry.get()
                         .aligned_vectorized_out_tensor_pos) {
+      // Undefined outputs are allocated by the executor
+      if (!outputs[pos].defined()) {
+        continue;
+      }
       auto tv = kernel->outputs().at(pos)->as<TensorView>();
       auto word_size = kernel->summary().vectorized_accesses.at(tv);
       validateAlignedVectorizedFusionInputOutput(
@@ -655,11 +746,11 @@ void validateMisalignedVectorizedTensors(
       tensor_vectorization_validation_entry.get().out_misaligned_tensors_pos;
   if (!outputs.empty()) {
     out_misaligned_tensors.reserve(out_misaligned_tensors_pos.size());
-    std::transform(
-        out_misaligned_tensors_pos.begin(),
-        out_misaligned_tensors_pos.end(),
-        std::back_inserter(out_misaligned_tensors),
-        [&outputs](int idx) { return outputs[idx]; });
+    for (int idx : out_misaligned_tensors_pos) {
+      if (outputs[idx].defined()) {
+        out_misaligned_tensors.emplace_back(outputs[idx]);
+      }
+    }
   }
   // If input stride is non-contiguous + no outputs, return false
   NVF_ERROR(
@@ -688,6 +779,61 @@ void validateVectorizedTensors(
       kernel, args, outputs, data_cache, expr_eval);
 }
 
+std::optional<uint64_t> getVectorizedTensorAlignmentBits(
+    kir::Kernel* kernel,
+    const KernelArgumentHolder& args,
+    const std::vector<at::Tensor>& outputs,
+    caching::ExecutorCompileTimeInfoCache* data_cache) {
+  auto tensor_vectorization_validation_entry =
+      executor_utils::caching::ExecutorCompileTimeEntry<
+          executor_utils::caching::VectorizedTensorValidation>(
+          data_cache, [kernel]() {
+            return executor_utils::getVectorizedTensorValidationInfo(kernel);
+          });
+  const auto& info = tensor_vectorization_validation_entry.get();
+
+  // Each pointer takes the bits below the maximum alignment
+  constexpr size_t bits_per_ptr = 5;
+  constexpr uint64_t ptr_mask = (1 << bits_per_ptr) - 1;
+  static_assert(
+      SchedulerRuntimeInfo::max_alignment_size_in_byte == ptr_mask + 1,
+      "The alignment bits must cover the maximum alignment");
+
+  uint64_t bits = 0;
+  size_t num_ptrs = 0;
+  auto add_ptr = [&](const void* ptr) {
+    bits |= ((uint64_t)(size_t)ptr & ptr_mask) << (num_ptrs * bits_per_ptr);
+    num_ptrs++;
+  };
+  auto add_output_ptrs = [&](const auto& positions) {
+    // Undefined outputs are allocated by the executor and not validated
+    for (auto pos : positions) {
+      add_ptr(
+          outputs.empty() || !outputs.at(pos).defined()
+              ? nullptr
+              : outputs.at(pos).data_ptr());
+    }
+  };
+
+  const size_t max_num_ptrs = 64 / bits_per_ptr;
+  if (info.aligned_vectorized_inp_tensor_pos.size() +
+          info.aligned_vectorized_out_tensor_pos.size() +
+          info.inp_misaligned_tensors_pos.size() +
+          info.out_misaligned_tensors_pos.size() >
+      max_num_ptrs) {
+    return std::nullopt;
+  }
+  for (auto pos : info.aligned_vectorized_inp_tensor_pos) {
+    add_ptr(args[pos]->as<at::Tensor>().data_ptr());
+  }
+  add_output_ptrs(info.aligned_vectorized_out_tensor_pos);
+  for (auto pos : info.inp_misaligned_tensors_pos) {
+    add_ptr(args[pos]->as<at::Tensor>().data_ptr());
+  }
+  add_output_ptrs(info.out_misaligned_tensors_pos);
+  return bits;
+}
+
 ExpressionEvaluator bindInputs(
     const KernelArgumentHolder& args,
     Fusion* kernel) {
@@ -749,11 +895,12 @@ std::string dumpCompiledCodeToFile(
 }
 
 // Get the max register count passed as -maxrregcount ptxas
-// option. The count is determined based on block sizes, an optional
-// heuristic and an environment variable.
+// option. The count is determined based on block sizes, the target
+// occupancy, an optional heuristic and an environment variable.
 std::optional<int64_t> getMaxRegCount(
     std::optional<int64_t> opt_block_size,
-    const int64_t max_register_heuristic) {
+    const int64_t max_register_heuristic,
+    const int64_t min_blocks_per_sm) {
   // The maximum possible count allowed by ptxas is 255
   constexpr int64_t max_register_limit = 255;
 
@@ -762,9 +909,9 @@ std::optional<int64_t> getMaxRegCount(
   int64_t max_register = max_register_limit + 1;
 
   // If the block size is known, set the maximum that at least allows
-  // one block to be resident on an SM
+  // one block, or the target number of blocks, to be resident on an SM
   if (opt_block_size.has_value() && opt_block_size.value() > 0) {
-    constexpr int64_t block_per_sm = 1;
+    const int64_t block_per_sm = std::max<int64_t>(1, min_blocks_per_sm);
     max_register = std::min(
         max_register_limit,
         getRegPerThreadGivenThreadsPerSM(
@@ -810,6 +957,8 @@ class NvrtcCompileDriver {
 
   std::string invoke(nvrtcProgram program, const std::string& src) const {
     FUSER_PERF_SCOPE("executor_utils::Nvrtc::CompileProgram");
+    // Includes ptxas when compiling to SASS
+    CompileStepScope step("nvrtcCompileProgram");
     auto opts = getOptions();
     auto result = nvrtcCompileProgram(
         program, static_cast<int>(opts.size()), opts.data());
@@ -882,6 +1031,8 @@ class CuModuleLoadDataDriver {
   //! if enabled
   std::string invoke(CUmodule& module, const void* image) {
     FUSER_PERF_SCOPE("executor_utils::Nvrtc::LoadPTX");
+    // Includes the JIT compilation by the driver when loading PTX
+    CompileStepScope step("cuModuleLoadDataEx");
 
     auto [opts, opt_vals] = getOptions();
 
@@ -1034,8 +1185,22 @@ void fillCompileOptions(
     }
   }
 
-  const auto max_register =
-      getMaxRegCount(opt_block_size, compile_params.maxrregcount);
+  const auto max_register = getMaxRegCount(
+      opt_block_size,
+      compile_params.maxrregcount,
+      compile_params.min_blocks_per_sm);
+
+  // Arguments of the __launch_bounds__ of kernels with a target occupancy.
+  // Without a block size, the kernel is compiled for the largest blocks.
+  if (compile_params.min_blocks_per_sm > 0) {
+    const int64_t max_threads = opt_block_size.value_or(
+        at::cuda::getCurrentDeviceProperties()->maxThreadsPerBlock);
+    nvrtc_compile_driver.setOption(
+        "-DNVFUSER_MAX_THREADS_PER_BLOCK=" + std::to_string(max_threads));
+    nvrtc_compile_driver.setOption(
+        "-DNVFUSER_MIN_BLOCKS_PER_SM=" +
+        std::to_string(compile_params.min_blocks_per_sm));
+  }
 
   // If the max register count is set
   if (max_register.has_value()) {
@@ -1145,6 +1310,152 @@ std::unique_ptr<CompiledKernel> compileSource(
   return compiled_kernel;
 }
 
+// Copies the result of a compilation, but not its loaded module
+std::unique_ptr<CompiledKernel> copyCompiledBinary(const CompiledKernel& from) {
+  auto compiled_kernel = std::make_unique<CompiledKernel>();
+  compiled_kernel->kernel_name = from.kernel_name;
+  compiled_kernel->compile_log = from.compile_log;
+  compiled_kernel->ptx = from.ptx;
+  compiled_kernel->ptx_filename = from.ptx_filename;
+  compiled_kernel->cubin = from.cubin;
+  compiled_kernel->cubin_filename = from.cubin_filename;
+  return compiled_kernel;
+}
+
+// Identifies the binary compiled from the source with the compile args. The
+// kernel name is left out, as whoever reuses the binary looks up the function
+// by the lowered name of the compiled kernel.
+std::string compilationKey(
+    const std::string& compile_args,
+    const std::string& full_src_code,
+    const std::string& func_name) {
+  std::string key = compile_args + "\n" + full_src_code;
+  for (auto pos = key.find(func_name);
+       !func_name.empty() && pos != std::string::npos;
+       pos = key.find(func_name, pos)) {
+    key.replace(pos, func_name.size(), "$");
+  }
+  return key;
+}
+
+// Compilations in progress, keyed by compilationKey. Threads
+// compiling the same kernel at the same time, e.g. the same segment of
+// fusions that are cached separately, wait for one of them to compile it
+// instead of all of them compiling it.
+class InflightCompilations {
+ public:
+  static InflightCompilations& get() {
+    static InflightCompilations inflight;
+    return inflight;
+  }
+
+  // Compiles the source, unless another thread is already compiling it with
+  // the same args, in which case that compilation is waited for and reused
+  // is set to true. Compile errors are rethrown by all waiting threads.
+  std::unique_ptr<CompiledKernel> compile(
+      const std::string& full_src_code,
+      const std::string& func_name,
+      const std::string& id,
+      const bool compile_to_sass,
+      NvrtcCompileDriver& nvrtc_compile,
+      const std::string& compile_args,
+      bool& reused) {
+    const std::string key =
+        compilationKey(compile_args, full_src_code, func_name);
+    std::promise<std::shared_ptr<const CompiledKernel>> promise;
+    std::shared_future<std::shared_ptr<const CompiledKernel>> future;
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      auto it = compilations_.find(key);
+      reused = it != compilations_.end();
+      if (reused) {
+        future = it->second;
+      } else {
+        future = promise.get_future().share();
+        compilations_.emplace(key, future);
+      }
+    }
+    if (reused) {
+      FUSER_PERF_SCOPE("executor_utils::WaitForInflightCompilation");
+      return copyCompiledBinary(*future.get());
+    }
+
+    std::unique_ptr<CompiledKernel> compiled_kernel;
+    try {
+      compiled_kernel = compileSource(
+          full_src_code, func_name, id, compile_to_sass, nvrtc_compile);
+      promise.set_value(copyCompiledBinary(*compiled_kernel));
+    } catch (...) {
+      promise.set_exception(std::current_exception());
+      finish(key);
+      throw;
+    }
+    finish(key);
+    return compiled_kernel;
+  }
+
+ private:
+  void finish(const std::string& key) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    compilations_.erase(key);
+  }
+
+  std::mutex mutex_;
+  std::unordered_map<
+      std::string,
+      std::shared_future<std::shared_ptr<const CompiledKernel>>>
+      compilations_;
+};
+
+// The kernels loaded by the executors of this process, keyed by device,
+// block size and compilationKey, so that executors generating the same code,
+// e.g. for the same layer norm of every layer of a model, share one module.
+// Their binaries are also indexed by compilationKey alone, which includes the
+// target architecture, so that the executors of the other devices of the
+// same architecture, e.g. of a process driving all GPUs of a node, load the
+// binary instead of compiling it again.
+class LoadedKernels {
+ public:
+  static LoadedKernels& get() {
+    static LoadedKernels loaded;
+    return loaded;
+  }
+
+  std::shared_ptr<CompiledKernel> find(const std::string& key) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = kernels_.find(key);
+    return it == kernels_.end() ? nullptr : it->second.lock();
+  }
+
+  // Returns a kernel compiled from binary_key for any device, or nullptr
+  std::shared_ptr<CompiledKernel> findBinary(const std::string& binary_key) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto it = binaries_.find(binary_key);
+    return it == binaries_.end() ? nullptr : it->second.lock();
+  }
+
+  void insert(
+      const std::string& key,
+      const std::string& binary_key,
+      const std::shared_ptr<CompiledKernel>& compiled_kernel) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    for (auto* kernels : {&kernels_, &binaries_}) {
+      for (auto it = kernels->begin(); it != kernels->end();) {
+        it = it->second.expired() ? kernels->erase(it) : std::next(it);
+      }
+    }
+    kernels_[key] = compiled_kernel;
+    binaries_[binary_key] = compiled_kernel;
+  }
+
+ private:
+  std::mutex mutex_;
+  // Kernels are unloaded when the last executor using them is destroyed
+  std::unordered_map<std::string, std::weak_ptr<CompiledKernel>> kernels_;
+  // The binaries are only shared while a device has them loaded
+  std::unordered_map<std::string, std::weak_ptr<CompiledKernel>> binaries_;
+};
+
 } // namespace
 
 CompiledKernel::~CompiledKernel() {
@@ -1155,7 +1466,7 @@ CompiledKernel::~CompiledKernel() {
 }
 
 // Compile the source if no existing compiled binary is found in KernelDB
-std::unique_ptr<CompiledKernel> getCompiledKernel(
+std::shared_ptr<CompiledKernel> getCompiledKernel(
     std::optional<std::reference_wrapper<const std::string>> kernel_code,
     const std::string& full_src_code,
     const std::string& func_name,
@@ -1163,6 +1474,7 @@ std::unique_ptr<CompiledKernel> getCompiledKernel(
     const CompileParams& compile_params,
     std::optional<int64_t> opt_block_size) {
   FUSER_PERF_SCOPE("executor_utils::NVRTC");
+  CompileStepScope step("executor_utils::NVRTC");
 
   at::cuda::jit::initializeCudaContext();
 
@@ -1221,21 +1533,149 @@ std::unique_ptr<CompiledKernel> getCompiledKernel(
   const auto compile_args =
       toDelimitedString(nvrtc_compile_driver.options(), " ");
 
+  const bool share_kernel =
+      !isOptionDisabled(DisableOption::CompiledKernelSharing);
+  std::string loaded_key;
+  std::string shared_binary_key;
+  std::shared_ptr<CompiledKernel> shared_binary;
+  if (share_kernel) {
+    shared_binary_key =
+        compilationKey(compile_args, full_src_code, func_name);
+    std::stringstream key;
+    key << "device=" << device
+        << ";block_size=" << opt_block_size.value_or(-1) << ";"
+        << shared_binary_key;
+    loaded_key = key.str();
+    if (auto loaded = LoadedKernels::get().find(loaded_key)) {
+      return loaded;
+    }
+    shared_binary = LoadedKernels::get().findBinary(shared_binary_key);
+  }
+
   auto& kernel_db = KernelDb::get();
   const auto use_kernel_db = kernel_db.enabled() && kernel_code.has_value();
 
+  // The key of the disk and remote caches covers everything besides the
+  // source that determines the binary. The compile args include the target
+  // architecture.
+  KernelDiskCache* disk_cache = KernelDiskCache::get();
+  std::shared_ptr<KernelStore> remote_store = KernelStore::remote();
+  std::string binary_key;
+  if (disk_cache != nullptr || remote_store != nullptr) {
+    int nvrtc_major = 0;
+    int nvrtc_minor = 0;
+    NVFUSER_NVRTC_SAFE_CALL(nvrtcVersion(&nvrtc_major, &nvrtc_minor));
+    std::stringstream key;
+    key << "nvfuser=" << NVFUSER_VERSION << ";nvrtc=" << nvrtc_major << "."
+        << nvrtc_minor << ";arch=" << major << "." << minor
+        << ";sass=" << compile_to_sass << ";args=" << compile_args;
+    binary_key = key.str();
+  }
+
+  // The remote cache is queried in the background while the local caches are
+  // queried
+  std::optional<KernelStoreLookup> remote_lookup;
+  if (remote_store != nullptr && shared_binary == nullptr) {
+    remote_lookup.emplace(remote_store, binary_key, full_src_code);
+  }
+
   // If the Kernel Query fails, the Kernel is recompiled
-  if (!(use_kernel_db &&
-        kernel_db.query(
-            kernel_code.value(),
-            compile_args,
+  if (shared_binary != nullptr) {
+    // Only the module is loaded on this device
+    compiled_kernel = copyCompiledBinary(*shared_binary);
+    compiled_kernel->register_spills = shared_binary->register_spills;
+    log << "Reused the binary loaded on another device" << std::endl;
+  } else if (
+      use_kernel_db &&
+      kernel_db.query(
+          kernel_code.value(),
+          compile_args,
+          compiled_kernel->kernel_name,
+          (compile_to_sass ? compiled_kernel->cubin : compiled_kernel->ptx))) {
+    log << "Loaded from kernel_db" << std::endl;
+  } else if (
+      disk_cache != nullptr &&
+      disk_cache->query(
+          binary_key,
+          full_src_code,
+          compiled_kernel->kernel_name,
+          (compile_to_sass ? compiled_kernel->cubin : compiled_kernel->ptx))) {
+    log << "Loaded from kernel disk cache " << disk_cache->cacheDir().string()
+        << std::endl;
+  } else if (
+      remote_lookup.has_value() &&
+      remote_lookup->wait(
+          compiled_kernel->kernel_name,
+          (compile_to_sass ? compiled_kernel->cubin : compiled_kernel->ptx))) {
+    log << "Loaded from kernel remote cache " << remote_store->describe()
+        << std::endl;
+    // Later lookups on this node are served by the disk cache
+    if (disk_cache != nullptr) {
+      disk_cache->write(
+          binary_key,
+          full_src_code,
+          compiled_kernel->kernel_name,
+          (compile_to_sass ? compiled_kernel->cubin : compiled_kernel->ptx));
+    }
+  } else if (
+      KernelDiskCache::EntryLock entry_lock = disk_cache != nullptr
+          ? disk_cache->lock(binary_key, full_src_code)
+          : KernelDiskCache::EntryLock();
+      entry_lock.waited() &&
+      disk_cache->query(
+          binary_key,
+          full_src_code,
+          compiled_kernel->kernel_name,
+          (compile_to_sass ? compiled_kernel->cubin : compiled_kernel->ptx))) {
+    // Another process sharing the cache directory compiled the kernel while
+    // this one waited for the entry lock
+    log << "Loaded from kernel disk cache " << disk_cache->cacheDir().string()
+        << " after waiting for another process" << std::endl;
+  } else {
+    // entry_lock is held until the kernel is written to the disk cache
+    bool reused = false;
+    compiled_kernel = InflightCompilations::get().compile(
+        full_src_code,
+        func_name,
+        id,
+        compile_to_sass,
+        nvrtc_compile_driver,
+        compile_args,
+        reused);
+    if (reused) {
+      log << "Reused the compilation of another thread" << std::endl;
+    }
+    log << compiled_kernel->compile_log << std::endl;
+    // Only the thread that compiled the kernel caches it
+    if (!reused && disk_cache != nullptr &&
+        !disk_cache->write(
+            binary_key,
+            full_src_code,
             compiled_kernel->kernel_name,
             (compile_to_sass ? compiled_kernel->cubin
-                             : compiled_kernel->ptx)))) {
-    compiled_kernel = compileSource(
-        full_src_code, func_name, id, compile_to_sass, nvrtc_compile_driver);
-    log << compiled_kernel->compile_log << std::endl;
-    if (use_kernel_db) {
+                             : compiled_kernel->ptx))) {
+      TORCH_WARN_ONCE(
+          "Kernel disk cache was unable to write kernel: ",
+          compiled_kernel->kernel_name);
+    }
+    if (!reused && remote_store != nullptr) {
+      // Like the lookup, a failing remote store never fails the compile
+      bool written = false;
+      try {
+        written = remote_store->write(
+            binary_key,
+            full_src_code,
+            compiled_kernel->kernel_name,
+            (compile_to_sass ? compiled_kernel->cubin : compiled_kernel->ptx));
+      } catch (const std::exception&) {
+      }
+      if (!written) {
+        TORCH_WARN_ONCE(
+            "Kernel remote cache was unable to write kernel: ",
+            compiled_kernel->kernel_name);
+      }
+    }
+    if (!reused && use_kernel_db) {
       auto result = kernel_db.write(
           kernel_code.value(),
           compile_args,
@@ -1257,8 +1697,11 @@ std::unique_ptr<CompiledKernel> getCompiledKernel(
   compiled_kernel->compile_log = log.str();
   compiled_kernel->compile_args = compile_args;
 
-  if (isOptionEnabled(EnableOption::WarnRegisterSpill) ||
-      compile_params.enable_ptxas_verbose) {
+  // A shared binary has the spills of its compilation, which were already
+  // reported
+  if (shared_binary == nullptr &&
+      (isOptionEnabled(EnableOption::WarnRegisterSpill) ||
+       compile_params.enable_ptxas_verbose)) {
     compiled_kernel->register_spills =
         warnRegisterSpill(compiled_kernel->compile_log);
   }
@@ -1273,13 +1716,18 @@ std::unique_ptr<CompiledKernel> getCompiledKernel(
     compiled_kernel->block_size = opt_block_size.value();
   }
 
-  return compiled_kernel;
+  std::shared_ptr<CompiledKernel> shared_kernel = std::move(compiled_kernel);
+  if (share_kernel) {
+    LoadedKernels::get().insert(loaded_key, shared_binary_key, shared_kernel);
+  }
+  return shared_kernel;
 }
 
 std::unique_ptr<CompiledKernel> getCompiledKernel(
     const serde::CudaKernel* buffer,
     const CompileParams& compile_params) {
   FUSER_PERF_SCOPE("executor_utils::serde_NVRTC");
+  CompileStepScope step("executor_utils::serde_NVRTC");
 
   NVF_ERROR(buffer != nullptr, "serde::CudaKernel is nullptr.");
 
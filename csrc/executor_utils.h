@@ -23,6 +23,7 @@
 #include <ir/all_nodes.h>
 #include <kernel.h>
 
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -32,6 +33,11 @@ namespace executor_utils {
 // Include all the functions we might need in generated code
 std::string kernelPreamble();
 
+//! Include only the functions kernel_str uses if
+//! EnableOption::PrunePreamble is set, which shortens the compilation of
+//! kernels that e.g. don't reduce, otherwise all of them
+NVF_API std::string kernelPreamble(const std::string& kernel_str);
+
 //! Bind input values to runtime values
 NVF_API ExpressionEvaluator
 bindInputs(const KernelArgumentHolder& args, Fusion* fusion);
@@ -58,8 +64,10 @@ struct CompiledKernel : public NonCopyable {
   int register_spills = -1;
 };
 
-// Returns executable function and the ptxas log from compilation
-std::unique_ptr<CompiledKernel> getCompiledKernel(
+// Returns executable function and the ptxas log from compilation. Unless
+// DisableOption::CompiledKernelSharing is set, the kernel is shared with the
+// callers that compiled the same code for the same device and block size.
+std::shared_ptr<CompiledKernel> getCompiledKernel(
     std::optional<std::reference_wrapper<const std::string>> kernel_code,
     const std::string& code,
     const std::string& func_name,
@@ -246,6 +254,17 @@ void validateVectorizedTensors(
     caching::ExecutorCompileTimeInfoCache* data_cache,
     ExpressionEvaluator& expr_eval);
 
+//! Packs the misalignment of the pointers of the vectorized inputs and
+//! outputs validated by validateVectorizedTensors, i.e., their address modulo
+//! the maximum vectorization size, into a bitmask. If the bitmask and the
+//! metadata of the tensors didn't change, neither does the validation result.
+//! Returns std::nullopt if there are too many tensors to pack.
+std::optional<uint64_t> getVectorizedTensorAlignmentBits(
+    kir::Kernel* kernel,
+    const KernelArgumentHolder& args,
+    const std::vector<at::Tensor>& outputs,
+    caching::ExecutorCompileTimeInfoCache* data_cache);
+
 //! Kernel timing utility
 //!
 //! Usage example:
@@ -58,6 +58,13 @@ void swap(Fusion& a, Fusion& b) noexcept {
   swap(a.io_alias_, b.io_alias_);
   swap(a.permuted_input_map_, b.permuted_input_map_);
   swap(a.permuted_output_map_, b.permuted_output_map_);
+
+  // Caches kept by a and b, e.g., the result of exprs() or managed data of
+  // MaxPosCalculator, are not swapped and are no longer valid
+  a.invalidateTensorGraph();
+  b.invalidateTensorGraph();
+  ++a.mutation_version_;
+  ++b.mutation_version_;
 }
 
 std::unique_ptr<SegmentedFusion> Fusion::segment(
@@ -91,7 +98,9 @@ IrCloner Fusion::copy(const Fusion* from, Fusion* to) {
     to->io_alias_[copied_output] = {
         .type = alias_info.type,
         .aliased_io = copied_input,
-        .hide_output = alias_info.hide_output};
+        .hide_output = alias_info.hide_output,
+        .slice_dim = alias_info.slice_dim,
+        .slice_start = ir_cloner.clone(alias_info.slice_start)};
   }
 
   to->permuted_input_map_ = from->permuted_input_map_;
@@ -122,6 +131,116 @@ IrCloner Fusion::copy(const Fusion* from, Fusion* to) {
   return ir_cloner;
 }
 
+IrCloner Fusion::copyBetween(
+    const Fusion* from,
+    Fusion* to,
+    const std::vector<Val*>& inputs,
+    const std::vector<Val*>& outputs) {
+  FUSER_PERF_SCOPE("Fusion::copyBetween");
+  to->clear();
+  IrCloner ir_cloner(to);
+
+  // Axioms are copied along with the scalars they depend on
+  std::vector<Val*> roots = outputs;
+  if (from->axioms_ != nullptr) {
+    roots.insert(roots.end(), from->axioms_->begin(), from->axioms_->end());
+  }
+
+  std::unordered_set<Statement*> stmts_to_copy(inputs.begin(), inputs.end());
+  for (auto stmt : StmtSort::getStmtsBetween(
+           inputs,
+           roots,
+           /*traverse_members=*/true,
+           /*traverse_attributes=*/true,
+           /*traverse_siblings=*/true)) {
+    stmts_to_copy.insert(stmt);
+  }
+
+  // Copy in the same deterministic order as IrContainer::copy
+  std::vector<Val*> copied_vals;
+  for (auto val : from->deterministic_vals()) {
+    if (from->vals_.count(val) > 0 && stmts_to_copy.count(val) > 0) {
+      to->vals_.insert(ir_cloner.clone(val));
+      copied_vals.push_back(val);
+    }
+  }
+  for (auto expr : from->deterministic_exprs()) {
+    if (from->exprs_.count(expr) > 0 && stmts_to_copy.count(expr) > 0) {
+      to->exprs_.insert(ir_cloner.clone(expr));
+    }
+  }
+
+  // Keep the names of the new statements unique
+  to->val_type_name_map_ = from->val_type_name_map_;
+  to->expr_name_counter_ = from->expr_name_counter_;
+
+  if (from->axioms_ != nullptr) {
+    to->axioms_ = std::make_unique<std::vector<Val*>>();
+    for (auto pred : *from->axioms_) {
+      to->axioms_->emplace_back(ir_cloner.clone(pred));
+    }
+  }
+
+  // Definitions and uses outside of the copied statements are dropped. Uses
+  // of tensors are recomputed anyway once the caller sets the inputs and
+  // outputs of to.
+  for (auto val : copied_vals) {
+    auto def = val->definition_;
+    ir_cloner.clone(val)->setDefinition(
+        def != nullptr && stmts_to_copy.count(def) > 0 ? ir_cloner.clone(def)
+                                                       : nullptr);
+    std::vector<Expr*> uses;
+    for (auto use : val->uses_) {
+      if (stmts_to_copy.count(use) > 0) {
+        uses.push_back(ir_cloner.clone(use));
+      }
+    }
+    ir_cloner.clone(val)->setUses(uses);
+  }
+
+  for (const auto& [val, metadata] : from->metadata_) {
+    if (stmts_to_copy.count(val) > 0) {
+      to->metadata_[ir_cloner.clone(val)] = ir_cloner.clone(metadata);
+    }
+  }
+
+  for (const auto& [output, alias_info] : from->io_alias_) {
+    if (stmts_to_copy.count(output) == 0) {
+      continue;
+    }
+    Val* copied_output = ir_cloner.clone(output);
+    Val* copied_input = ir_cloner.clone(alias_info.aliased_io);
+    to->io_alias_[copied_output] = {
+        .type = alias_info.type,
+        .aliased_io = copied_input,
+        .hide_output = alias_info.hide_output,
+        .slice_dim = alias_info.slice_dim,
+        .slice_start = ir_cloner.clone(alias_info.slice_start)};
+  }
+
+  to->permuted_input_map_ = from->permuted_input_map_;
+  to->permuted_output_map_ = from->permuted_output_map_;
+
+  for (const auto& i : from->managed_data_) {
+    if (i.first.has_value()) {
+      to->managed_data_.emplace_back(i.second(ir_cloner, i.first), i.second);
+    } else {
+      to->managed_data_.emplace_back(i.first, i.second);
+    }
+  }
+
+  for (auto [k, v] : from->managed_named_data_) {
+    if (v.first.has_value()) {
+      to->managed_named_data_.insert(std::make_pair(
+          k, std::make_pair(v.second(ir_cloner, v.first), v.second)));
+    }
+  }
+
+  to->expected_dynamic_smem_bytes_ = from->expected_dynamic_smem_bytes_;
+
+  return ir_cloner;
+}
+
 // Clang tidy complains when using default constructor for IrContainer instead
 // of copy constructor. Fusion::copy has a call to IrContainer::copy, so it's
 // redundant to use the IrContainer copy constructor, but it is harmless since
@@ -175,6 +294,10 @@ void Fusion::clear() noexcept {
 
   all_tv_uses_valid_ = false;
   is_during_update_uses_ = false;
+
+  invalidateTensorGraph();
+  ++mutation_version_;
+  sorted_exprs_.clear();
 }
 
 void Fusion::removeExpr(Expr* expr) {
@@ -183,6 +306,8 @@ void Fusion::removeExpr(Expr* expr) {
   // that removing something that doesn't exist simply does nothing. For now,
   // we're going with the strictest model which errors.
 
+  ++mutation_version_;
+
   for (auto out : expr->outputs()) {
     out->setDefinition(nullptr);
   }
@@ -255,7 +380,8 @@ void Fusion::addInput(Val* input) {
   inputs_.push_back(input);
   input->setIsFusionInput(true);
 
-  all_tv_uses_valid_ = false;
+  ++mutation_version_;
+  invalidateTvUses();
 }
 
 void Fusion::addOutput(Val* output) {
@@ -281,7 +407,8 @@ void Fusion::addOutput(Val* output) {
   outputs_.push_back(output);
   output->setIsFusionOutput(true);
 
-  all_tv_uses_valid_ = false;
+  ++mutation_version_;
+  invalidateTvUses();
 }
 
 void Fusion::removeInput(Val* input) {
@@ -290,7 +417,8 @@ void Fusion::removeInput(Val* input) {
     inputs_.erase(find_input);
   }
   input->setIsFusionInput(false);
-  all_tv_uses_valid_ = false;
+  ++mutation_version_;
+  invalidateTvUses();
 }
 
 void Fusion::removeOutput(Val* output) {
@@ -299,7 +427,8 @@ void Fusion::removeOutput(Val* output) {
     outputs_.erase(find_output);
   }
   output->setIsFusionOutput(false);
-  all_tv_uses_valid_ = false;
+  ++mutation_version_;
+  invalidateTvUses();
 }
 
 void Fusion::replaceOutput(Val* output, Val* replacement) {
@@ -322,6 +451,7 @@ void Fusion::replaceOutput(Val* output, Val* replacement) {
       output->as<TensorView>()->setMemoryType(MemoryType::Local);
     }
     // Mark uses invalid so that they will be reset next time uses() is called
+    ++mutation_version_;
     invalidateTvUses();
   }
 
@@ -335,7 +465,12 @@ void Fusion::replaceOutput(Val* output, Val* replacement) {
 }
 
 std::vector<Expr*> Fusion::exprs() const {
-  return StmtSort::getExprs(this);
+  if (sorted_exprs_version_ != mutation_version_) {
+    const int64_t version = mutation_version_;
+    sorted_exprs_ = StmtSort::getExprs(this);
+    sorted_exprs_version_ = version;
+  }
+  return sorted_exprs_;
 }
 
 bool Fusion::isNoOp() {
@@ -571,6 +706,7 @@ void Fusion::registerExpr(Expr* expr) {
   }
 
   IrContainer::registerExpr(expr);
+  ++mutation_version_;
 
   for (Val* input : expr->inputs()) {
     assertInContainer(input, "Input to expr is invalid, ");
@@ -824,6 +960,71 @@ void Fusion::aliasOutputToInput(
   }
 }
 
+void Fusion::aliasOutputToInputSlice(
+    TensorView* output,
+    TensorView* input,
+    const int64_t dim,
+    Val* start) {
+  NVF_CHECK(
+      input->isFusionInput(),
+      "Expected ",
+      input->toString(),
+      " to be a fusion input.");
+  NVF_CHECK(
+      start->isScalar() && start->isFusionInput(),
+      "The slice start ",
+      start->toString(),
+      " must be a scalar fusion input.");
+  NVF_CHECK(
+      isAliasCompatible(input, output),
+      "The input and output values are not alias-compatible.");
+  const std::vector<IterDomain*>& out_rfactor =
+      output->getMaybeRFactorDomain();
+  const std::vector<IterDomain*> out_logical =
+      TensorDomain::noReductions(out_rfactor);
+  NVF_CHECK(
+      output->getMaybeAllocationDomain() == out_rfactor,
+      "Slice aliases of outputs with an allocation domain are not supported.");
+  NVF_CHECK(
+      out_logical.size() ==
+          TensorDomain::noReductions(input->getMaybeRFactorDomain()).size(),
+      "Expected ",
+      output->toString(),
+      " and ",
+      input->toString(),
+      " to have the same rank.");
+  NVF_CHECK(
+      dim >= 0 && dim < (int64_t)out_logical.size(),
+      "Invalid slice dimension: ",
+      dim);
+
+  // The output is strided like `input`, so it's no longer contiguous right to
+  // the left of the sliced dimension. Mark that so the kernel indexes it with
+  // the runtime strides instead of merging it with the sliced dimension.
+  std::vector<std::optional<bool>> contiguity = output->getContiguity();
+  const auto sliced_pos = std::distance(
+      out_rfactor.begin(),
+      std::find(out_rfactor.begin(), out_rfactor.end(), out_logical.at(dim)));
+  for (int64_t i = sliced_pos - 1; i >= 0; i--) {
+    if (contiguity.at(i).has_value()) {
+      contiguity.at(i) = false;
+      break;
+    }
+  }
+  output->setContiguity(contiguity);
+
+  io_alias_[output] = AliasInfo{
+      .type = AllocationType::ReuseBuffer,
+      .aliased_io = input,
+      .hide_output = !output->isFusionOutput(),
+      .slice_dim = dim,
+      .slice_start = start};
+
+  if (!output->isFusionOutput()) {
+    addOutput(output);
+  }
+}
+
 const AliasInfo& Fusion::getOutputAlias(const Val* output) const {
   static AliasInfo no_alias_info{
       .type = AllocationType::New, .aliased_io = nullptr, .hide_output = false};
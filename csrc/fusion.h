@@ -106,6 +106,13 @@ struct AliasInfo {
   // Whether integration should hide the output from users. This is currently
   // only used for ReuseBuffer.
   bool hide_output;
+  // For ReuseBuffer, the output may reuse only a slice of `aliased_io`, e.g.,
+  // the new entries of a KV cache. The output then occupies
+  // aliased_io[..., slice_start : slice_start + extent, ...] along
+  // `slice_dim`, and the rest of the buffer is left untouched. `slice_start`
+  // is null when the whole buffer is reused.
+  int64_t slice_dim = -1;
+  Val* slice_start = nullptr;
 };
 
 //! Fusion is mutable but unique. Nodes cannot be copied in any way from one
@@ -194,7 +201,8 @@ class NVF_API Fusion : public IrContainer {
   bankConflictInfo(const CompileParams& compile_params = CompileParams());
 
   //! Return a list of topologically sorted expressions. This only includes
-  //! exprs required to generate registered outputs.
+  //! exprs required to generate registered outputs. The order is cached until
+  //! the next mutation of the fusion, see mutationVersion().
   std::vector<Expr*> exprs() const;
 
   //! Return a vector of fusion inputs that feed this Val
@@ -255,6 +263,17 @@ class NVF_API Fusion : public IrContainer {
   // those of type `ReuseBuffer` are marked in fusion definitions.
   NVF_API void aliasOutputToInput(Val* output, Val* input, AllocationType type);
 
+  //! Makes `output` reuse the buffer of `input` starting at `start` along
+  //! `dim`, so a kernel writes it in place, e.g., the K/V entries of a decode
+  //! step into a preallocated cache. The two must match in dtype and rank,
+  //! and `start` has to be a scalar fusion input so it is known when the
+  //! output is allocated.
+  NVF_API void aliasOutputToInputSlice(
+      TensorView* output,
+      TensorView* input,
+      int64_t dim,
+      Val* start);
+
   //! Returns the aliased input of a given output along with an `AliasInfo`
   //! describing how they alias. Returns <nullptr,nullptr> when `output` is not
   //! aliased.
@@ -290,6 +309,22 @@ class NVF_API Fusion : public IrContainer {
     return is_during_update_uses_;
   }
 
+  //! Incremented every time the tensor graph may have changed, i.e., a tensor
+  //! expression, an input or an output was added or removed, or the root or
+  //! rfactor domain of a tensor was replaced. Leaf domain transformations like
+  //! split, merge and reorder, including their propagation, don't change it,
+  //! so analyses of root domains can be cached across them, e.g., by
+  //! MaxPosCalculator.
+  int64_t tensorGraphVersion() const {
+    return tensor_graph_version_;
+  }
+
+  //! Incremented every time an expression, an input or an output is added or
+  //! removed, i.e., every time the result of exprs() may change.
+  int64_t mutationVersion() const {
+    return mutation_version_;
+  }
+
   // NOTE: [Fusion managed data]
   //
   // Fusion-managed data is a mechanism to communicate data that survives fusion
@@ -437,6 +472,17 @@ class NVF_API Fusion : public IrContainer {
 
   static IrCloner copy(const Fusion* from, Fusion* to);
 
+  //! Like copy, but only copies the statements of from that are needed to
+  //! compute outputs from inputs, including the members of tensors and the
+  //! scalars they depend on. The rest of from, e.g. other segments of a
+  //! segmented fusion, is not cloned. Inputs and outputs of to are left
+  //! empty for the caller to set.
+  static IrCloner copyBetween(
+      const Fusion* from,
+      Fusion* to,
+      const std::vector<Val*>& inputs,
+      const std::vector<Val*>& outputs);
+
   //! During scheduling, this can be set to a non-negative value. If done, then
   //! during execution by FusionExecutor, we will check that this value matches
   //! the corresponding value in LaunchParams.
@@ -453,6 +499,7 @@ class NVF_API Fusion : public IrContainer {
   friend SegmentedFusion;
   friend class TranslateApplicableWelford;
   friend Val;
+  friend TensorView;
 
   using IrContainer::registerExpr;
   using IrContainer::registerVal;
@@ -477,6 +524,14 @@ class NVF_API Fusion : public IrContainer {
   //! the update).
   void invalidateTvUses() {
     all_tv_uses_valid_ = false;
+    invalidateTensorGraph();
+  }
+
+  //! Declare that the tensor graph has changed without changing any uses,
+  //! e.g., the rfactor domain of a tensor was replaced. See
+  //! tensorGraphVersion().
+  void invalidateTensorGraph() {
+    ++tensor_graph_version_;
   }
 
  private:
@@ -503,6 +558,16 @@ class NVF_API Fusion : public IrContainer {
   bool all_tv_uses_valid_ = false;
   bool is_during_update_uses_ = false;
 
+  // See tensorGraphVersion()
+  int64_t tensor_graph_version_ = 0;
+
+  // See mutationVersion()
+  int64_t mutation_version_ = 0;
+
+  // Result of exprs() as of sorted_exprs_version_
+  mutable std::vector<Expr*> sorted_exprs_;
+  mutable int64_t sorted_exprs_version_ = -1;
+
   std::vector<std::pair<std::any, CloneFn>> managed_data_;
   std::unordered_map<std::string, std::pair<std::any, CloneFn>>
       managed_named_data_;
@@ -7,8 +7,18 @@
 // clang-format on
 
 #include <cupti.h>
+#if __has_include(<cupti_range_profiler.h>)
+#include <cupti_profiler_host.h>
+#include <cupti_profiler_target.h>
+#include <cupti_range_profiler.h>
+#endif
 #include <fusion_profiler.h>
+#include <instrumentation.h>
+#include <algorithm>
+#include <array>
 #include <iomanip>
+#include <memory>
+#include <mutex>
 
 namespace nvfuser {
 
@@ -162,6 +172,255 @@ void cupti_buffer_completed(
   }
 }
 
+//! Metrics collected for NVFUSER_PROF=counters. The order matches the
+//! fields read in RangeProfiler::stop.
+constexpr std::array<const char*, 5> counter_metric_names{
+    "dram__throughput.avg.pct_of_peak_sustained_elapsed",
+    "lts__t_sector_hit_rate.pct",
+    "sm__warps_active.avg.pct_of_peak_sustained_active",
+    "l1tex__data_bank_conflicts_pipe_lsu_mem_shared_op_ld.sum",
+    "l1tex__data_bank_conflicts_pipe_lsu_mem_shared_op_st.sum"};
+
+constexpr std::array<const char*, 9> warp_stall_reasons{
+    "long_scoreboard",
+    "short_scoreboard",
+    "barrier",
+    "membar",
+    "mio_throttle",
+    "lg_throttle",
+    "math_pipe_throttle",
+    "wait",
+    "not_selected"};
+
+#if __has_include(<cupti_range_profiler.h>)
+
+//! Collects the hardware counters of a kernel with the CUPTI range profiler.
+//! Each kernel launched between start and stop is replayed as many times as
+//! needed to collect all metrics. There is one RangeProfiler per device.
+class RangeProfiler {
+ public:
+  static RangeProfiler& get(int device) {
+    static std::mutex lock;
+    static std::unordered_map<int, std::unique_ptr<RangeProfiler>> profilers;
+    std::lock_guard<std::mutex> guard(lock);
+    auto& profiler = profilers[device];
+    if (profiler == nullptr) {
+      profiler.reset(new RangeProfiler(device));
+    }
+    return *profiler;
+  }
+
+  void start() {
+    // The counter data image holds a single range, so it is reinitialized
+    // for each kernel
+    CUpti_RangeProfiler_CounterDataImage_Initialize_Params init_params{
+        CUpti_RangeProfiler_CounterDataImage_Initialize_Params_STRUCT_SIZE};
+    init_params.pRangeProfilerObject = range_profiler_;
+    init_params.counterDataSize = counter_data_image_.size();
+    init_params.pCounterData = counter_data_image_.data();
+    NVFUSER_CUPTI_SAFE_CALL(
+        cuptiRangeProfilerCounterDataImageInitialize(&init_params));
+
+    CUpti_RangeProfiler_SetConfig_Params config_params{
+        CUpti_RangeProfiler_SetConfig_Params_STRUCT_SIZE};
+    config_params.pRangeProfilerObject = range_profiler_;
+    config_params.configSize = config_image_.size();
+    config_params.pConfig = config_image_.data();
+    config_params.counterDataImageSize = counter_data_image_.size();
+    config_params.pCounterDataImage = counter_data_image_.data();
+    config_params.range = CUPTI_AutoRange;
+    config_params.replayMode = CUPTI_KernelReplay;
+    config_params.maxRangesPerPass = 1;
+    config_params.numNestingLevels = 1;
+    config_params.minNestingLevel = 1;
+    config_params.passIndex = 0;
+    config_params.targetNestingLevel = 1;
+    NVFUSER_CUPTI_SAFE_CALL(cuptiRangeProfilerSetConfig(&config_params));
+
+    CUpti_RangeProfiler_Start_Params start_params{
+        CUpti_RangeProfiler_Start_Params_STRUCT_SIZE};
+    start_params.pRangeProfilerObject = range_profiler_;
+    NVFUSER_CUPTI_SAFE_CALL(cuptiRangeProfilerStart(&start_params));
+  }
+
+  KernelCounters stop() {
+    CUpti_RangeProfiler_Stop_Params stop_params{
+        CUpti_RangeProfiler_Stop_Params_STRUCT_SIZE};
+    stop_params.pRangeProfilerObject = range_profiler_;
+    NVFUSER_CUPTI_SAFE_CALL(cuptiRangeProfilerStop(&stop_params));
+
+    CUpti_RangeProfiler_DecodeData_Params decode_params{
+        CUpti_RangeProfiler_DecodeData_Params_STRUCT_SIZE};
+    decode_params.pRangeProfilerObject = range_profiler_;
+    NVFUSER_CUPTI_SAFE_CALL(cuptiRangeProfilerDecodeData(&decode_params));
+
+    KernelCounters counters;
+    CUpti_RangeProfiler_GetCounterDataInfo_Params info_params{
+        CUpti_RangeProfiler_GetCounterDataInfo_Params_STRUCT_SIZE};
+    info_params.pCounterDataImage = counter_data_image_.data();
+    info_params.counterDataImageSize = counter_data_image_.size();
+    NVFUSER_CUPTI_SAFE_CALL(cuptiRangeProfilerGetCounterDataInfo(&info_params));
+    if (info_params.numTotalRanges == 0) {
+      // No kernel was launched, e.g. for a segment evaluated on the host
+      return counters;
+    }
+
+    std::vector<double> values(metric_names_.size(), 0.0);
+    CUpti_Profiler_Host_EvaluateToGpuValues_Params eval_params{
+        CUpti_Profiler_Host_EvaluateToGpuValues_Params_STRUCT_SIZE};
+    eval_params.pHostObject = host_;
+    eval_params.pCounterDataImage = counter_data_image_.data();
+    eval_params.counterDataImageSize = counter_data_image_.size();
+    eval_params.ppMetricNames = metric_names_.data();
+    eval_params.numMetrics = metric_names_.size();
+    eval_params.rangeIndex = 0;
+    eval_params.pMetricValues = values.data();
+    NVFUSER_CUPTI_SAFE_CALL(cuptiProfilerHostEvaluateToGpuValues(&eval_params));
+
+    counters.collected = true;
+    counters.dram_throughput_pct = values.at(0);
+    counters.l2_hit_rate_pct = values.at(1);
+    counters.achieved_occupancy_pct = values.at(2);
+    counters.smem_load_bank_conflicts = values.at(3);
+    counters.smem_store_bank_conflicts = values.at(4);
+    for (size_t i = 0; i < warp_stall_reasons.size(); ++i) {
+      counters.warp_stalls.emplace_back(
+          warp_stall_reasons.at(i), values.at(counter_metric_names.size() + i));
+    }
+    return counters;
+  }
+
+ private:
+  explicit RangeProfiler(int device) {
+    static std::once_flag initialized;
+    std::call_once(initialized, []() {
+      CUpti_Profiler_Initialize_Params params{
+          CUpti_Profiler_Initialize_Params_STRUCT_SIZE};
+      NVFUSER_CUPTI_SAFE_CALL(cuptiProfilerInitialize(&params));
+    });
+
+    metric_names_.assign(
+        counter_metric_names.begin(), counter_metric_names.end());
+    for (const char* reason : warp_stall_reasons) {
+      stall_metric_names_.push_back(
+          std::string("smsp__warp_issue_stalled_") + reason +
+          "_per_warp_active.pct");
+    }
+    for (const auto& name : stall_metric_names_) {
+      metric_names_.push_back(name.c_str());
+    }
+
+    CUcontext context = nullptr;
+    NVFUSER_CUDA_SAFE_CALL(cuCtxGetCurrent(&context));
+
+    CUpti_Device_GetChipName_Params chip_params{
+        CUpti_Device_GetChipName_Params_STRUCT_SIZE};
+    chip_params.deviceIndex = device;
+    NVFUSER_CUPTI_SAFE_CALL(cuptiDeviceGetChipName(&chip_params));
+
+    CUpti_Profiler_GetCounterAvailability_Params availability_params{
+        CUpti_Profiler_GetCounterAvailability_Params_STRUCT_SIZE};
+    availability_params.ctx = context;
+    NVFUSER_CUPTI_SAFE_CALL(
+        cuptiProfilerGetCounterAvailability(&availability_params));
+    std::vector<uint8_t> availability(
+        availability_params.counterAvailabilityImageSize);
+    availability_params.pCounterAvailabilityImage = availability.data();
+    NVFUSER_CUPTI_SAFE_CALL(
+        cuptiProfilerGetCounterAvailability(&availability_params));
+
+    CUpti_Profiler_Host_Initialize_Params host_params{
+        CUpti_Profiler_Host_Initialize_Params_STRUCT_SIZE};
+    host_params.profilerType = CUPTI_PROFILER_TYPE_RANGE_PROFILER;
+    host_params.pChipName = chip_params.pChipName;
+    host_params.pCounterAvailabilityImage = availability.data();
+    NVFUSER_CUPTI_SAFE_CALL(cuptiProfilerHostInitialize(&host_params));
+    host_ = host_params.pHostObject;
+
+    CUpti_Profiler_Host_ConfigAddMetrics_Params add_params{
+        CUpti_Profiler_Host_ConfigAddMetrics_Params_STRUCT_SIZE};
+    add_params.pHostObject = host_;
+    add_params.ppMetricNames = metric_names_.data();
+    add_params.numMetrics = metric_names_.size();
+    NVFUSER_CUPTI_SAFE_CALL(cuptiProfilerHostConfigAddMetrics(&add_params));
+
+    CUpti_Profiler_Host_GetConfigImageSize_Params config_size_params{
+        CUpti_Profiler_Host_GetConfigImageSize_Params_STRUCT_SIZE};
+    config_size_params.pHostObject = host_;
+    NVFUSER_CUPTI_SAFE_CALL(
+        cuptiProfilerHostGetConfigImageSize(&config_size_params));
+    config_image_.resize(config_size_params.configImageSize);
+    CUpti_Profiler_Host_GetConfigImage_Params config_params{
+        CUpti_Profiler_Host_GetConfigImage_Params_STRUCT_SIZE};
+    config_params.pHostObject = host_;
+    config_params.configImageSize = config_image_.size();
+    config_params.pConfigImage = config_image_.data();
+    NVFUSER_CUPTI_SAFE_CALL(cuptiProfilerHostGetConfigImage(&config_params));
+
+    CUpti_RangeProfiler_Enable_Params enable_params{
+        CUpti_RangeProfiler_Enable_Params_STRUCT_SIZE};
+    enable_params.ctx = context;
+    NVFUSER_CUPTI_SAFE_CALL(cuptiRangeProfilerEnable(&enable_params));
+    range_profiler_ = enable_params.pRangeProfilerObject;
+
+    CUpti_RangeProfiler_GetCounterDataSize_Params data_size_params{
+        CUpti_RangeProfiler_GetCounterDataSize_Params_STRUCT_SIZE};
+    data_size_params.pRangeProfilerObject = range_profiler_;
+    data_size_params.pMetricNames = metric_names_.data();
+    data_size_params.numMetrics = metric_names_.size();
+    data_size_params.maxNumOfRanges = 1;
+    data_size_params.maxNumRangeTreeNodes = 1;
+    NVFUSER_CUPTI_SAFE_CALL(
+        cuptiRangeProfilerGetCounterDataSize(&data_size_params));
+    counter_data_image_.resize(data_size_params.counterDataSize);
+  }
+
+ private:
+  std::vector<std::string> stall_metric_names_;
+  std::vector<const char*> metric_names_;
+  CUpti_Profiler_Host_Object* host_ = nullptr;
+  CUpti_RangeProfiler_Object* range_profiler_ = nullptr;
+  std::vector<uint8_t> config_image_;
+  std::vector<uint8_t> counter_data_image_;
+};
+
+bool isRangeProfilerAvailable() {
+  return true;
+}
+
+#else
+
+//! The range profiler is available starting with CUPTI 12.6
+class RangeProfiler {
+ public:
+  static RangeProfiler& get(int) {
+    static RangeProfiler profiler;
+    return profiler;
+  }
+  void start() {}
+  KernelCounters stop() {
+    return {};
+  }
+};
+
+bool isRangeProfilerAvailable() {
+  return false;
+}
+
+#endif // __has_include(<cupti_range_profiler.h>)
+
+bool isCollectingCounters() {
+  if (!ProfilerOptionsGuard::getCurOptions().has(ProfilerOption::Counters)) {
+    return false;
+  }
+  if (!isRangeProfilerAvailable()) {
+    TORCH_WARN_ONCE(
+        "NVFUSER_PROF=counters requires the CUPTI range profiler of CUDA 12.6 or newer. Hardware counters are not collected.");
+    return false;
+  }
+  return true;
+}
+
 //! A local utility function to give ProfilerState enum state strings
 const char* profiler_state2string(const ProfilerState& pstate) {
   switch (pstate) {
@@ -344,6 +603,9 @@ void SegmentProfiler::startKernel(int device) {
     NVFUSER_CUPTI_SAFE_CALL(cuptiActivityPushExternalCorrelationId(
         CUPTI_EXTERNAL_CORRELATION_KIND_UNKNOWN,
         static_cast<uint64_t>(segment_id_)));
+    if (isCollectingCounters()) {
+      RangeProfiler::get(device_).start();
+    }
   }
   kernel_profile_state_ = ProfilerState::Running;
 }
@@ -355,6 +617,9 @@ void SegmentProfiler::stopKernel() {
       kernel_profile_state_);
   uint64_t corr_id = 0;
   if (!cupti_disabled_) {
+    if (isCollectingCounters()) {
+      counters_ = RangeProfiler::get(device_).stop();
+    }
     NVFUSER_CUPTI_SAFE_CALL(cuptiActivityPopExternalCorrelationId(
         CUPTI_EXTERNAL_CORRELATION_KIND_UNKNOWN, &corr_id));
     NVF_CHECK(
@@ -402,6 +667,8 @@ auto FusionProfile::toTuple(const FusionProfile& prof, size_t seg_id) {
       prof.percentage_peak_bandwidth,
       prof.input_bytes,
       prof.output_bytes,
+      prof.intermediate_bytes,
+      prof.planned_intermediate_bytes,
       kp.segment_id,
       kp.time_ms,
       kp.compile_time_ms,
@@ -449,7 +716,11 @@ void FusionProfile::reset() {
   input_bytes = 0;
   output_bytes = 0;
 
+  intermediate_bytes = 0;
+  planned_intermediate_bytes = 0;
+
   kernel_profiles.clear();
+  compile_steps.clear();
 }
 
 const std::vector<ProfileAttrDescriptor> FusionProfile::profile_attr_descs{
@@ -465,6 +736,8 @@ const std::vector<ProfileAttrDescriptor> FusionProfile::profile_attr_descs{
     {"%PkBw", false, false, false, 7, true, 2, std::nullopt},
     {"In(MB)", true, false, false, 8, true, 3, 1.0e-6},
     {"Out(MB)", true, false, false, 9, true, 3, 1.0e-6},
+    {"Intrm(MB)", true, false, false, 9, true, 3, 1.0e-6},
+    {"PlnIntrm(MB)", true, false, false, 12, true, 3, 1.0e-6},
     {"S-Seg#", false, true, false, 6, true, 0, std::nullopt},
     {"S-KerTm(ms)", false, true, false, 11, true, 3, std::nullopt},
     {"S-CmpTm(ms)", true, true, false, 11, true, 3},
@@ -550,6 +823,26 @@ constexpr std::ostream& printTuple(
 }
 } // namespace
 
+std::ostream& operator<<(std::ostream& os, const KernelCounters& counters) {
+  if (!counters.collected) {
+    return os << "not collected";
+  }
+  os << std::fixed << std::setprecision(1)
+     << "DRAM throughput: " << counters.dram_throughput_pct << "%"
+     << ", L2 hit rate: " << counters.l2_hit_rate_pct << "%"
+     << ", achieved occupancy: " << counters.achieved_occupancy_pct << "%"
+     << ", smem bank conflicts (ld/st): "
+     << (int64_t)counters.smem_load_bank_conflicts << "/"
+     << (int64_t)counters.smem_store_bank_conflicts;
+  if (!counters.warp_stalls.empty()) {
+    os << ", warp stalls:";
+    for (const auto& [reason, pct] : counters.warp_stalls) {
+      os << " " << reason << "=" << pct << "%";
+    }
+  }
+  return os << std::defaultfloat;
+}
+
 std::ostream& operator<<(std::ostream& os, const FusionProfile& fp) {
   // Print headers only for first fusion
   if (fp.fusion_id == 0) {
@@ -594,6 +887,41 @@ std::ostream& operator<<(std::ostream& os, const FusionProfile& fp) {
     }
   }
 
+  // Print the hardware counters of each kernel
+  bool has_counters = std::any_of(
+      fp.kernel_profiles.begin(), fp.kernel_profiles.end(), [](const auto& kp) {
+        return kp.counters.collected;
+      });
+  if (has_counters) {
+    os << "Hardware counters of fusion " << fp.fusion_id << ":" << std::endl;
+    for (const auto& kp : fp.kernel_profiles) {
+      os << "  Segment " << kp.segment_id << " (" << kp.heuristic
+         << "): " << kp.counters << std::endl;
+    }
+  }
+
+  // Print the compile steps of each segment as a tree
+  if (fp.verbose && !fp.compile_steps.empty()) {
+    os << "Compile steps of fusion " << fp.fusion_id << ":" << std::endl;
+    for (int64_t seg_id = -1; seg_id < fp.segments; ++seg_id) {
+      bool first_step = true;
+      for (const auto& step : fp.compile_steps) {
+        if (step.segment_id != seg_id) {
+          continue;
+        }
+        if (first_step) {
+          first_step = false;
+          if (seg_id >= 0) {
+            os << "  Segment " << seg_id << ":" << std::endl;
+          }
+        }
+        os << "  " << std::setw(10) << std::setprecision(3) << step.time_ms
+           << " ms  " << std::string(2 * step.depth, ' ') << step.name
+           << std::endl;
+      }
+    }
+  }
+
   return os;
 }
 
@@ -608,6 +936,8 @@ FusionProfiler::FusionProfiler()
       host_timer_(),
       compile_timer_(),
       segments_(),
+      start_timestamp_(),
+      compile_steps_lock_(),
       device_descriptors_(),
       kernel_profiles_(),
       corrid_2_segid_() {
@@ -681,6 +1011,7 @@ SegmentProfiler& FusionProfiler::segment(size_t idx) {
         cuptiActivityEnable(CUPTI_ACTIVITY_KIND_EXTERNAL_CORRELATION));
   }
   cudaDeviceSynchronize();
+  fp->start_timestamp_ = HostTimer::Clock::now();
   fp->fusion_timer_.start();
   fp->host_timer_.start();
   fp->state_ = ProfilerState::Running;
@@ -729,11 +1060,18 @@ const DeviceDescriptor& FusionProfiler::deviceDescriptor(const int device_id) {
     NVFUSER_CUPTI_SAFE_CALL(cuptiActivityFlushAll(0));
 
     fprof.kernel_profiles.resize(fp->segments_.size());
+    std::vector<bool> recorded(fp->segments_.size(), false);
     for (auto& kprof : fp->kernel_profiles_) {
       auto corr_id = kprof.correlation_id;
       if (fp->corrid_2_segid_.count(corr_id) == 0) {
         continue;
       }
+      // Kernels replayed by the range profiler to collect counters may report
+      // more than one activity record per launch. Only the first is kept.
+      if (recorded.at(fp->corrid_2_segid_[corr_id])) {
+        continue;
+      }
+      recorded.at(fp->corrid_2_segid_[corr_id]) = true;
       const DeviceDescriptor& device_desc = fp->deviceDescriptor(kprof.device);
       kprof.device_name = device_desc.name;
       kprof.peak_bandwidth_gbs = device_desc.peak_bandwidth_gbs;
@@ -761,6 +1099,8 @@ const DeviceDescriptor& FusionProfiler::deviceDescriptor(const int device_id) {
       kprof.percentage_peak_bandwidth =
           kprof.effective_bandwidth_gbs / kprof.peak_bandwidth_gbs * 100.0;
       kprof.compile_time_ms = segment(kp_idx).compileTime();
+      kprof.heuristic = segment(kp_idx).heuristic();
+      kprof.counters = segment(kp_idx).counters();
 
       kprof.grid_str = toString(kprof.grid);
       kprof.block_str = toString(kprof.block);
@@ -789,6 +1129,17 @@ const DeviceDescriptor& FusionProfiler::deviceDescriptor(const int device_id) {
   }
   fprof.compile_time_ms = fp->compile_timer_.time();
 
+  {
+    std::lock_guard<std::mutex> guard(fp->compile_steps_lock_);
+    std::stable_sort(
+        fprof.compile_steps.begin(),
+        fprof.compile_steps.end(),
+        [](const CompileStepProfile& a, const CompileStepProfile& b) {
+          return a.start_ms < b.start_ms ||
+              (a.start_ms == b.start_ms && a.depth < b.depth);
+        });
+  }
+
   fp->state_ = ProfilerState::Processed;
 }
 
@@ -824,6 +1175,17 @@ void FusionProfiler::outputBytesAccessed(int64_t bytes) {
   get()->profile_.output_bytes = bytes;
 }
 
+void FusionProfiler::intermediateBytesAllocated(
+    int64_t unplanned_bytes,
+    int64_t planned_bytes) {
+  NVF_CHECK(
+      state() == ProfilerState::Running,
+      "FusionProfiler state is not Running!",
+      state());
+  get()->profile_.intermediate_bytes = unplanned_bytes;
+  get()->profile_.planned_intermediate_bytes = planned_bytes;
+}
+
 const FusionProfile& FusionProfiler::profile() {
   NVF_CHECK(
       state() == ProfilerState::Processed,
@@ -832,6 +1194,66 @@ const FusionProfile& FusionProfiler::profile() {
   return get()->profile_;
 }
 
+namespace {
+
+// Nesting of the CompileStepScopes open on this thread
+thread_local int64_t compile_step_depth = 0;
+thread_local int64_t compile_step_segment_id = -1;
+
+} // namespace
+
+bool FusionProfiler::isRecordingCompileSteps() {
+  return inst::Trace::instance()->enabled() ||
+      (isProfilerEnabled() && state() == ProfilerState::Running);
+}
+
+void FusionProfiler::recordCompileStep(
+    const std::string& name,
+    HostTimer::Clock::time_point start,
+    HostTimer::Clock::time_point stop) {
+  inst::Trace::instance()->completeEvent(name.c_str(), start, stop);
+
+  FusionProfiler* fp = get();
+  std::lock_guard<std::mutex> guard(fp->compile_steps_lock_);
+  if (fp->state_ != ProfilerState::Running) {
+    return;
+  }
+  CompileStepProfile step;
+  step.name = name;
+  step.segment_id = compile_step_segment_id;
+  step.depth = compile_step_depth;
+  step.start_ms = std::chrono::duration<double, std::milli>(
+                      start - fp->start_timestamp_)
+                      .count();
+  step.time_ms =
+      std::chrono::duration<double, std::milli>(stop - start).count();
+  fp->profile_.compile_steps.push_back(std::move(step));
+}
+
+CompileStepScope::CompileStepScope(std::string name, int64_t segment_id)
+    : enabled_(FusionProfiler::isRecordingCompileSteps()),
+      prev_segment_id_(compile_step_segment_id) {
+  if (!enabled_) {
+    return;
+  }
+  name_ = std::move(name);
+  if (segment_id >= 0) {
+    compile_step_segment_id = segment_id;
+  }
+  start_ = HostTimer::Clock::now();
+  ++compile_step_depth;
+}
+
+CompileStepScope::~CompileStepScope() {
+  if (!enabled_) {
+    return;
+  }
+  const auto stop = HostTimer::Clock::now();
+  --compile_step_depth;
+  FusionProfiler::recordCompileStep(name_, start_, stop);
+  compile_step_segment_id = prev_segment_id_;
+}
+
 void FusionProfiler::recordAsyncCorrIdActivity(
     uint32_t seg_id,
     uint32_t corr_id) {
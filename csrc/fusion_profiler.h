@@ -7,6 +7,7 @@
 // clang-format on
 #pragma once
 #include <chrono>
+#include <mutex>
 #include <unordered_map>
 
 #include <c10/cuda/CUDAStream.h>
@@ -91,12 +92,34 @@ struct DeviceDescriptor {
   double peak_bandwidth_gbs{0.0};
 };
 
+//! \struct KernelCounters
+//! \brief This struct captures the hardware counters of a kernel collected
+//! with the CUPTI range profiler when NVFUSER_PROF=counters is set.
+struct KernelCounters {
+  //! False if the counters could not be collected, e.g. because the CUPTI
+  //! range profiler is not available
+  bool collected{false};
+
+  double dram_throughput_pct{0.0};
+  double l2_hit_rate_pct{0.0};
+  double achieved_occupancy_pct{0.0};
+  double smem_load_bank_conflicts{0.0};
+  double smem_store_bank_conflicts{0.0};
+
+  //! Percentage of the active warps stalled for each reason
+  std::vector<std::pair<std::string, double>> warp_stalls{};
+};
+
+NVF_API std::ostream& operator<<(std::ostream&, const KernelCounters&);
+
 //! \struct KernelProfile
 //! \brief This struct captures the CUPTI profiled information from a kernel
 //! generated by a segment.
 struct KernelProfile {
   std::string name{};
   size_t segment_id{0};
+  //! Scheduler of the segment
+  std::string heuristic{};
   int device{-1};
   uint32_t stream{0};
   uint32_t correlation_id{0};
@@ -119,6 +142,8 @@ struct KernelProfile {
   std::string device_name{};
   double peak_bandwidth_gbs{0.0};
 
+  KernelCounters counters{};
+
   // These strings are here to capture the conversion
   // in struct that can be reference when making a tuple
   std::string grid_str{};
@@ -127,6 +152,21 @@ struct KernelProfile {
   std::string shared_mem_str{};
 };
 
+//! \struct CompileStepProfile
+//! \brief This struct captures the host time of one step of compiling a
+//! Fusion, e.g. a pre-segmenter pass, a segmenter merge iteration or a
+//! lowering pass. Steps nest, so the depth of a step is the number of steps
+//! it is part of.
+struct CompileStepProfile {
+  std::string name{};
+  //! The segment the step compiles or -1 if it is not specific to a segment
+  int64_t segment_id{-1};
+  int64_t depth{0};
+  //! Time since the start of profiling
+  double start_ms{0.0};
+  double time_ms{0.0};
+};
+
 struct ProfileAttrDescriptor {
   std::string column_header{};
 
@@ -172,11 +212,21 @@ struct FusionProfile {
   int64_t input_bytes{0};
   int64_t output_bytes{0};
 
+  //! Bytes needed by the tensors passed between segments when each gets its
+  //! own allocation, and bytes of the arena they were packed into when
+  //! segment memory planning is enabled
+  int64_t intermediate_bytes{0};
+  int64_t planned_intermediate_bytes{0};
+
   //! Vector of of the KernelProfiles for each segment of a Fusion
   std::vector<KernelProfile> kernel_profiles{};
+
+  //! The compile steps of all threads ordered by their start time. An
+  //! enclosing step comes before the steps it is made of.
+  std::vector<CompileStepProfile> compile_steps{};
 };
 
-std::ostream& operator<<(std::ostream&, const FusionProfile&);
+NVF_API std::ostream& operator<<(std::ostream&, const FusionProfile&);
 
 //! \struct SegmentProfiler
 //! \brief A class used to profile each segment of a Fusion
@@ -192,6 +242,9 @@ class SegmentProfiler {
 
   void inputBytesAccessed(int64_t bytes);
   void outputBytesAccessed(int64_t bytes);
+  void setHeuristic(std::string heuristic) {
+    heuristic_ = std::move(heuristic);
+  }
 
   uint32_t segmentId() const;
   int device() const {
@@ -210,6 +263,12 @@ class SegmentProfiler {
   ProfilerState state() const {
     return kernel_profile_state_;
   }
+  const std::string& heuristic() const {
+    return heuristic_;
+  }
+  const KernelCounters& counters() const {
+    return counters_;
+  }
 
  private:
   bool cupti_disabled_;
@@ -221,6 +280,8 @@ class SegmentProfiler {
   int64_t input_bytes_;
   int64_t output_bytes_;
   ProfilerState kernel_profile_state_;
+  std::string heuristic_;
+  KernelCounters counters_;
 };
 
 //! \struct FusionProfiler
@@ -247,9 +308,24 @@ class FusionProfiler {
   static void stopCompile();
   static void inputBytesAccessed(int64_t bytes);
   static void outputBytesAccessed(int64_t bytes);
+  static void intermediateBytesAllocated(
+      int64_t unplanned_bytes,
+      int64_t planned_bytes);
   NVF_API static const FusionProfile& profile();
   static SegmentProfiler& segment(size_t idx);
 
+  //! Whether compile steps are currently recorded, either because the
+  //! profiler is running or because NVFUSER_TRACE is set
+  static bool isRecordingCompileSteps();
+  //! Records a compile step that ran on this thread from start to stop. The
+  //! step is part of the CompileStepScopes currently open on this thread. It
+  //! is added to the FusionProfile if the profiler is running and to the
+  //! Chrome trace of NVFUSER_TRACE.
+  static void recordCompileStep(
+      const std::string& name,
+      HostTimer::Clock::time_point start,
+      HostTimer::Clock::time_point stop);
+
   //! Methods to capture Asynchronous CUPTI activity that get called from
   //! functions registered with CUPTI.
   //! Correlation ID -> Segment ID
@@ -287,6 +363,10 @@ class FusionProfiler {
   //! Total compilation time if there is more than one segment
   HostTimer compile_timer_;
   std::vector<SegmentProfiler> segments_;
+  //! Start of profiling, used as the origin of compile step times
+  HostTimer::Clock::time_point start_timestamp_;
+  //! Compile steps may be recorded by the threads compiling segments
+  std::mutex compile_steps_lock_;
   //! The FusionProfiler collects a cache of device descriptors so each segment
   //! does not need to spend time re-generating the information.
   std::vector<DeviceDescriptor> device_descriptors_;
@@ -297,4 +377,22 @@ class FusionProfiler {
   std::unordered_map<uint32_t, uint32_t> corrid_2_segid_;
 };
 
+//! \class CompileStepScope
+//! \brief Records the scope it is alive in as a compile step, see
+//! FusionProfiler::recordCompileStep. Steps recorded inside the scope are
+//! nested in it. A segment id can be given to attribute the step and the
+//! steps nested in it to a segment. Does nothing when compile steps are not
+//! being recorded.
+class CompileStepScope : public NonCopyable {
+ public:
+  explicit CompileStepScope(std::string name, int64_t segment_id = -1);
+  ~CompileStepScope();
+
+ private:
+  bool enabled_;
+  std::string name_;
+  int64_t prev_segment_id_;
+  HostTimer::Clock::time_point start_;
+};
+
 } // namespace nvfuser
@@ -7,6 +7,7 @@
 // clang-format on
 #include <debug.h>
 #include <fusion.h>
+#include <fusion_profiler.h>
 #include <fusion_segmenter.h>
 #include <instrumentation.h>
 #include <ir/all_nodes.h>
@@ -19,7 +20,13 @@
 #include <options.h>
 #include <scheduler/debug_utils.h>
 #include <scheduler/normalization_utils.h>
+#include <scheduler/utils.h>
+
+#include <ATen/cuda/CUDAContext.h>
+
 #include <algorithm>
+#include <bit>
+#include <cmath>
 
 #include <sstream>
 
@@ -354,9 +361,9 @@ void SegmentedGroup::finalize() {
   // alias aware segmentation. we add inputs that are aliased by output
   // generated in this SegmentedGroup
   for (Val* output : output_vals) {
-    if (Val* aliased_input = segmented_fusion_->completeFusion()
-                                 ->getOutputAlias(output)
-                                 .aliased_io) {
+    const AliasInfo& alias_info =
+        segmented_fusion_->completeFusion()->getOutputAlias(output);
+    if (Val* aliased_input = alias_info.aliased_io) {
       // aliasing currently only supported as output to input
       NVF_ERROR(
           aliased_input->isFusionInput(),
@@ -368,6 +375,13 @@ void SegmentedGroup::finalize() {
         input_vals.push_back(aliased_input);
       }
     }
+    // The slice offset is needed to allocate the output even if no
+    // expression of this group uses it.
+    if (Val* slice_start = alias_info.slice_start;
+        slice_start != nullptr && !input_set.count(slice_start)) {
+      input_set.insert(slice_start);
+      input_vals.push_back(slice_start);
+    }
   }
 }
 
@@ -469,10 +483,46 @@ std::unique_ptr<SegmentedFusion> SegmentedFusion::fromCompleteFusion(
   return segmented_fusion_ptr;
 }
 
+/*static*/ LowerPrecisionPolicy LowerPrecisionPolicy::fromOptions() {
+  LowerPrecisionPolicy policy;
+  const std::unordered_map<std::string, DataType> storage_types = {
+      {"fp16", DataType::Half},
+      {"bf16", DataType::BFloat16},
+      {"fp8_e4m3", DataType::Float8_e4m3fn},
+      {"fp8_e5m2", DataType::Float8_e5m2}};
+  for (const auto& arg :
+       getEnableOptionArguments(EnableOption::IoToLowerPrecision)) {
+    if (auto it = storage_types.find(arg); it != storage_types.end()) {
+      policy.storage_type = it->second;
+      continue;
+    }
+    const auto eq_pos = arg.find('=');
+    if (eq_pos != std::string::npos) {
+      const std::string key = arg.substr(0, eq_pos);
+      try {
+        const double value = std::stod(arg.substr(eq_pos + 1));
+        if (key == "tolerance") {
+          policy.tolerance = value;
+          continue;
+        }
+        if (key == "scale" && value > 0.0) {
+          policy.fp8_scale = value;
+          continue;
+        }
+      } catch (const std::exception&) {
+      }
+    }
+    debug() << "skip invalid argument for IoToLowerPrecision, arg = " << arg
+            << std::endl;
+  }
+  return policy;
+}
+
 SegmentedFusion::SegmentedFusion(std::unique_ptr<Fusion> fusion)
     : segmented_fusion_name_{segmentedFusionName()},
       impl_(this),
       complete_fusion_(std::move(fusion)),
+      lower_precision_policy_(LowerPrecisionPolicy::fromOptions()),
       initial_vals_size_{complete_fusion_->vals().size()},
       initial_exprs_size_{complete_fusion_->unordered_exprs().size()} {
   annotateFP16IntermediateTensors();
@@ -1128,6 +1178,28 @@ void detailGroupPrint(std::ostream& os, const SegmentedGroup* group) {
   os << "}\n\n";
 }
 
+bool isFp8Type(DataType dtype) {
+  return dtype == DataType::Float8_e4m3fn || dtype == DataType::Float8_e5m2;
+}
+
+//! Relative rounding error of a value stored as dtype, i.e., half the
+//! distance between 1 and the next representable value
+double unitRoundoff(DataType dtype) {
+  int64_t mantissa_bits = 0;
+  if (dtype == DataType::Float8_e5m2) {
+    mantissa_bits = 2;
+  } else if (dtype == DataType::Float8_e4m3fn) {
+    mantissa_bits = 3;
+  } else if (dtype == DataType::BFloat16) {
+    mantissa_bits = 7;
+  } else if (dtype == DataType::Half) {
+    mantissa_bits = 10;
+  } else {
+    NVF_ERROR(false, "Unexpected lower precision type: ", dtype);
+  }
+  return std::ldexp(1.0, -(int)mantissa_bits - 1);
+}
+
 //! Insert casts for an intermediate tensorview, i.e. ones
 //!  that are in segmentedEdges. The insertion is done on
 //!  the complete fusion, which should be owned by a segmented
@@ -1138,17 +1210,25 @@ void detailGroupPrint(std::ostream& os, const SegmentedGroup* group) {
 //!       fp16_tv = cast(TV0)
 //!       fp32_tv = cast(fp16_tv)
 //!
+//!  When scale is not 1, TV0 is scaled before the cast and unscaled
+//!  after the cast back:
+//!       fp8_tv = cast(TV0 * scale)
+//!       fp32_tv = cast(fp8_tv) * (1 / scale)
+//!  The tensors of the scaling exprs are added to scaling_tvs.
+//!
 //!  The replacement is done only for uses_to_modify exprs. This
-//!  function can be called for the same original FP32 tensor multiple
+//!  function can be called for the same original tensor multiple
 //!  times but with different use exprs. In the second and later
 //!  calls, the half-precision tensor should be passed in as well.
 //!
 //! Returns nullptr if no replacement is done.
 TensorView* castIntermediateValueInCompleteFusion(
     Fusion* fusion,
-    TensorView* original_fp32_tv,
+    TensorView* original_tv,
     const std::vector<Expr*>& uses_to_modify,
     DataType half_type,
+    double scale,
+    std::unordered_set<Val*>& scaling_tvs,
     TensorView* half_tv = nullptr) {
   FusionGuard fg(fusion);
 
@@ -1159,7 +1239,7 @@ TensorView* castIntermediateValueInCompleteFusion(
     // Keep broadcast axes and remove reduction axes
     size_t i = 0;
     auto no_reduction_root_domain =
-        TensorDomain::noReductions(original_fp32_tv->getMaybeRFactorDomain());
+        TensorDomain::noReductions(original_tv->getMaybeRFactorDomain());
     std::vector<IterDomain*> new_root_domain(no_reduction_root_domain.size());
     for (const auto& dom : no_reduction_root_domain) {
       new_root_domain[i++] = dom->cloneWithoutRFactor();
@@ -1173,17 +1253,18 @@ TensorView* castIntermediateValueInCompleteFusion(
         data_type);
   };
 
-  TensorView* reverted_fp32_tv = nullptr;
+  const DataType original_type = original_tv->dtype();
+  TensorView* reverted_tv = nullptr;
   bool is_replaced = false;
 
-  // replace uses of original tv with fp32_tv in the complete
+  // replace uses of original tv with reverted_tv in the complete
   //  fusion
   for (auto expr : uses_to_modify) {
-    if (reverted_fp32_tv == nullptr) {
-      reverted_fp32_tv = make_consumer_tv(original_fp32_tv, DataType::Float);
+    if (reverted_tv == nullptr) {
+      reverted_tv = make_consumer_tv(original_tv, original_type);
     }
-    auto replaced = ir_utils::replaceValInExprInputs(
-        expr, original_fp32_tv, reverted_fp32_tv);
+    auto replaced =
+        ir_utils::replaceValInExprInputs(expr, original_tv, reverted_tv);
     NVF_ERROR(replaced != expr);
     is_replaced = true;
   }
@@ -1194,12 +1275,33 @@ TensorView* castIntermediateValueInCompleteFusion(
 
   // create the tv's to cast
   if (half_tv == nullptr) {
-    half_tv = make_consumer_tv(original_fp32_tv, half_type);
-    IrBuilder::create<UnaryOp>(UnaryOpType::Cast, half_tv, original_fp32_tv);
+    TensorView* cast_from_tv = original_tv;
+    if (scale != 1.0) {
+      cast_from_tv = make_consumer_tv(original_tv, original_type);
+      IrBuilder::create<BinaryOp>(
+          BinaryOpType::Mul,
+          cast_from_tv,
+          original_tv,
+          IrBuilder::create<Val>(scale, original_type));
+      scaling_tvs.insert(cast_from_tv);
+    }
+    half_tv = make_consumer_tv(original_tv, half_type);
+    IrBuilder::create<UnaryOp>(UnaryOpType::Cast, half_tv, cast_from_tv);
   }
 
   // Insert the cast ops.
-  IrBuilder::create<UnaryOp>(UnaryOpType::Cast, reverted_fp32_tv, half_tv);
+  if (scale == 1.0) {
+    IrBuilder::create<UnaryOp>(UnaryOpType::Cast, reverted_tv, half_tv);
+  } else {
+    auto cast_back_tv = make_consumer_tv(original_tv, original_type);
+    IrBuilder::create<UnaryOp>(UnaryOpType::Cast, cast_back_tv, half_tv);
+    IrBuilder::create<BinaryOp>(
+        BinaryOpType::Mul,
+        reverted_tv,
+        cast_back_tv,
+        IrBuilder::create<Val>(1.0 / scale, original_type));
+    scaling_tvs.insert(cast_back_tv);
+  }
 
   return half_tv;
 }
@@ -1342,6 +1444,16 @@ std::vector<SegmentedEdge*> SegmentedFusion::castInputOutputToLowerPrecision(
       continue;
     }
 
+    const std::optional<DataType> cast_type = lowerPrecisionTypeOf(edge_tv);
+    if (!cast_type.has_value()) {
+      continue;
+    }
+    // Only float tensors are scaled, so that the scaling is done in fp32
+    double scale = 1.0;
+    if (isFp8Type(*cast_type) && edge_tv->dtype() == DataType::Float) {
+      scale = lower_precision_policy_.fp8_scale;
+    }
+
     auto cast_tv_it = fp32_to_half_cast_map.find(edge_tv);
     TensorView* cast_tv = nullptr;
 
@@ -1351,7 +1463,9 @@ std::vector<SegmentedEdge*> SegmentedFusion::castInputOutputToLowerPrecision(
           complete_fusion_.get(),
           edge_tv,
           uses_to_modify,
-          force_half_precision_type_);
+          *cast_type,
+          scale,
+          fp8_scaling_tvs_);
       NVF_ERROR(cast_tv != nullptr);
       fp32_to_half_cast_map[edge_tv] = cast_tv;
     } else {
@@ -1364,7 +1478,9 @@ std::vector<SegmentedEdge*> SegmentedFusion::castInputOutputToLowerPrecision(
           complete_fusion_.get(),
           edge_tv,
           uses_to_modify,
-          force_half_precision_type_,
+          *cast_type,
+          scale,
+          fp8_scaling_tvs_,
           cast_tv);
     }
 
@@ -1383,6 +1499,25 @@ std::vector<SegmentedEdge*> SegmentedFusion::castInputOutputToLowerPrecision(
   return affected_edges;
 }
 
+std::optional<DataType> SegmentedFusion::lowerPrecisionTypeOf(
+    TensorView* tv) const {
+  if (force_fp16_tv_set_.count(tv) == 0) {
+    return std::nullopt;
+  }
+  std::vector<DataType> candidates;
+  if (lower_precision_policy_.storage_type.has_value()) {
+    candidates.push_back(lower_precision_policy_.storage_type.value());
+  }
+  candidates.push_back(force_half_precision_type_);
+  for (auto dtype : candidates) {
+    if (dataTypeSize(dtype) < dataTypeSize(tv->dtype()) &&
+        unitRoundoff(dtype) <= lower_precision_policy_.tolerance) {
+      return dtype;
+    }
+  }
+  return std::nullopt;
+}
+
 std::vector<SegmentedEdge*> SegmentedFusion::getEdgesByVal(Val* val) const {
   std::vector<SegmentedEdge*> edges_with_val;
   std::copy_if(
@@ -1397,28 +1532,39 @@ void SegmentedFusion::revertInputOutputPrecisionChanges(
     const std::vector<SegmentedEdge*>& edges) {
   std::unordered_set<Val*> lowered_tv_to_remove;
   std::unordered_set<Val*> same_precision_tv_to_remove;
+  std::unordered_set<Val*> original_tvs;
   for (auto edge : edges) {
     auto lowered_tv = edge->val;
     auto original_tv = lowered_tv->definition()->inputs().at(0);
+    // Skip the fp8 scaling, if any
+    if (fp8_scaling_tvs_.erase(original_tv)) {
+      same_precision_tv_to_remove.insert(original_tv);
+      original_tv = original_tv->definition()->inputs().at(0);
+    }
     for (auto cast_back_expr : lowered_tv->uses()) {
       NVF_ERROR(
           cast_back_expr->isA<UnaryOp>() &&
           cast_back_expr->as<UnaryOp>()->getUnaryOpType() == UnaryOpType::Cast);
       auto same_precision_tv = cast_back_expr->outputs().at(0);
+      if (fp8_scaling_tvs_.erase(same_precision_tv)) {
+        NVF_ERROR(same_precision_tv->uses().size() == 1);
+        same_precision_tv_to_remove.insert(same_precision_tv);
+        same_precision_tv = same_precision_tv->uses().at(0)->outputs().at(0);
+      }
       for (auto expr : complete_fusion_->unordered_uses(same_precision_tv)) {
         ir_utils::replaceValInExprInputs(expr, same_precision_tv, original_tv);
       }
       same_precision_tv_to_remove.insert(same_precision_tv);
     }
     lowered_tv_to_remove.insert(lowered_tv);
+    original_tvs.insert(original_tv);
     edge->val = original_tv;
   }
 
   // Any group with an edge with the original TVs may have its
   // expressions replaced.
   std::unordered_set<SegmentedGroup*> groups_to_reset;
-  for (auto lowered_tv : lowered_tv_to_remove) {
-    auto original_tv = lowered_tv->definition()->inputs().at(0);
+  for (auto original_tv : original_tvs) {
     for (auto e : getEdgesByVal(original_tv)) {
       groups_to_reset.insert(e->from);
       groups_to_reset.insert(e->to);
@@ -1438,20 +1584,20 @@ void SegmentedFusion::revertInputOutputPrecisionChanges(
 }
 
 //! An utility class to compute and maintain the "producers of"
-//!   relationship in a segmented graph. Space heavy and should
-//!   avoid use on very large graphs.
+//!   relationship in a segmented graph.
+//!
+//!  The transitive producers of each group are kept in a bitset indexed by
+//!   a dense id assigned to each group, so that queries are a bit test and
+//!   merging two groups is a word-wise OR over the groups that depend on
+//!   them. The bitsets are O(n^2) bits, which is a few MB for graphs of
+//!   thousands of groups.
 //!
 //!  Currently trying to move as far as possible with only a
 //!   producer map, without transposing it to make a consumer map.
 //!  Making it NonCopyable because we should never need to
 //!   copy an instance of this class.
-//!  TODO: Space efficiency of this class will be important,
-//!        because we need it in the pre-merging of segmentedGroups,
-//!        currently O(n^2). O(nlogn) would be a reasonable
-//!        goal to achieve.
 class GroupDependencyAnalysis : public NonCopyable, public SegmenterAnalysis {
-  using GroupSetOwningPtr = std::unique_ptr<GroupSet>;
-  using DependencyMap = std::unordered_map<SegmentedGroup*, GroupSetOwningPtr>;
+  using Bitset = std::vector<uint64_t>;
 
  public:
   //! Populate producers of all groups in segmented fusion
@@ -1461,28 +1607,27 @@ class GroupDependencyAnalysis : public NonCopyable, public SegmenterAnalysis {
   }
 
   //! Checks if group is consumer of any group in groups_to_check
-  //!  TODO: refactor this similar to isConsumerOf
   bool isConsumerOfAny(
       SegmentedGroup* group,
       const std::vector<SegmentedGroup*>& groups_to_check) {
-    auto& producers_of_group = getAllKnownProducersSet(group);
-    for (const auto& potential_producer : groups_to_check) {
-      if (producers_of_group->has(potential_producer)) {
-        return true;
-      }
-    }
-    return false;
+    return std::any_of(
+        groups_to_check.begin(),
+        groups_to_check.end(),
+        [this, group](SegmentedGroup* potential_producer) {
+          return isConsumerOf(group, potential_producer);
+        });
   }
 
-  bool isConsumerOf(SegmentedGroup* a, SegmentedGroup* b) {
-    auto it = known_producers_of_.find(a);
-    if (it == known_producers_of_.end()) {
+  bool isConsumerOf(SegmentedGroup* a, SegmentedGroup* b) const {
+    auto a_it = ids_.find(a);
+    auto b_it = ids_.find(b);
+    if (a_it == ids_.end() || b_it == ids_.end()) {
       return false;
     }
-    return it->second->has(b);
+    return test(producers_.at(a_it->second), b_it->second);
   }
 
-  bool isProducerOf(SegmentedGroup* a, SegmentedGroup* b) {
+  bool isProducerOf(SegmentedGroup* a, SegmentedGroup* b) const {
     return isConsumerOf(b, a);
   }
 
@@ -1501,32 +1646,32 @@ class GroupDependencyAnalysis : public NonCopyable, public SegmenterAnalysis {
   void mergeGroups(const GroupSet& groups, SegmentedGroup* merged);
 
   //! Populate all values that is on a path from producer to consumer
-  //!  efficiency can be important here. (TODO)
   GroupSet valuesBetween(SegmentedGroup* producer, SegmentedGroup* consumer) {
     if (producer == consumer) {
       return {};
     }
 
-    GroupSet values_between;
-    auto& all_producers_of_consumer = known_producers_of_.at(consumer);
     NVF_ERROR(
-        all_producers_of_consumer->has(producer),
+        isConsumerOf(consumer, producer),
         "Fusion segment: Trying to compute path between two nodes that are not producer-consumer pairs");
+    const int64_t producer_id = ids_.at(producer);
 
-    for (auto producer_of_consumer : *all_producers_of_consumer) {
-      if (known_producers_of_.at(producer_of_consumer)->has(producer)) {
-        values_between.pushBack(producer_of_consumer);
-      }
-    }
-
+    GroupSet values_between;
+    forEachGroup(
+        producers_.at(ids_.at(consumer)),
+        [&](SegmentedGroup* producer_of_consumer, int64_t id) {
+          if (test(producers_.at(id), producer_id)) {
+            values_between.pushBack(producer_of_consumer);
+          }
+        });
     return values_between;
   }
 
   //! Checks if the segmented fusion this class tracks is still a DAG
   //!  used for generating assertions after transforms
   bool isproducerMapDAG() const {
-    for (auto& it : known_producers_of_) {
-      if (it.second->has(it.first)) {
+    for (const auto& [group, id] : ids_) {
+      if (test(producers_.at(id), id)) {
         return false;
       }
     }
@@ -1534,59 +1679,86 @@ class GroupDependencyAnalysis : public NonCopyable, public SegmenterAnalysis {
   }
 
  private:
-  //! Collect initial producer info using
-  //!  a work list algorithm through forward traversal
-  //!  a backward DFS would do the same
+  //! Collect initial producer info by visiting groups in topological order
   void computeAllProducers();
 
-  //! Add all consumers of `producer` to `to_visit`
-  void addConsumersToWorkList(SegmentedGroup* producer, GroupSet& to_visit) {
-    for (auto e : producer->consumer_edges) {
-      // A consumer wouldn't have been worked before any of its producer
-      to_visit.pushBack(e->to);
+  //! Returns the id of group, assigning a new one with no known producers if
+  //! the group hasn't been seen yet
+  int64_t getOrCreateId(SegmentedGroup* group) {
+    auto [it, inserted] = ids_.emplace(group, (int64_t)groups_.size());
+    if (inserted) {
+      groups_.push_back(group);
+      producers_.emplace_back();
     }
+    return it->second;
   }
 
-  //! Propagate all known producers of `from` into `into`, used to keep track
-  //! of:
-  //!  1. `from` is a producer of `into`
-  //!  2. `from` has been merged with other group to create `into`
-  void mergeAllKnownProducersIntoFrom(
-      SegmentedGroup* into,
-      SegmentedGroup* from) {
-    auto& producer_set_to_merge = *getAllKnownProducersSet(from);
-    for (auto group : producer_set_to_merge) {
-      getAllKnownProducersSet(into)->pushBack(group);
+  //! Removes group from the analysis. Its id is not reused.
+  void eraseGroup(SegmentedGroup* group) {
+    auto it = ids_.find(group);
+    if (it == ids_.end()) {
+      return;
     }
+    groups_.at(it->second) = nullptr;
+    producers_.at(it->second).clear();
+    ids_.erase(it);
   }
 
-  //! Utility to access known producers of a group so far
-  GroupSetOwningPtr& getAllKnownProducersSet(SegmentedGroup* group) {
-    auto& producer_set_ptr = known_producers_of_[group];
-    if (!producer_set_ptr) {
-      producer_set_ptr = std::make_unique<GroupSet>();
+  static bool test(const Bitset& bits, int64_t id) {
+    const auto word = (size_t)id / 64;
+    return word < bits.size() && ((bits[word] >> (id % 64)) & 1) != 0;
+  }
+
+  static void set(Bitset& bits, int64_t id) {
+    const auto word = (size_t)id / 64;
+    if (word >= bits.size()) {
+      bits.resize(word + 1, 0);
+    }
+    bits[word] |= (uint64_t)1 << (id % 64);
+  }
+
+  static void reset(Bitset& bits, int64_t id) {
+    const auto word = (size_t)id / 64;
+    if (word < bits.size()) {
+      bits[word] &= ~((uint64_t)1 << (id % 64));
     }
-    return producer_set_ptr;
   }
 
-  // utility to compute the set intersection of group sets a,b
-  GroupSet groupSetIntersection(const GroupSet& a, const GroupSet& b) {
-    bool a_is_smaller = a.size() < b.size();
-    const auto& smaller_group_set = a_is_smaller ? a : b;
-    const auto& bigger_group_set = a_is_smaller ? b : a;
+  static void orInto(Bitset& into, const Bitset& from) {
+    if (into.size() < from.size()) {
+      into.resize(from.size(), 0);
+    }
+    for (const auto i : c10::irange(from.size())) {
+      into[i] |= from[i];
+    }
+  }
 
-    GroupSet intersection;
-    for (auto group : smaller_group_set) {
-      if (bigger_group_set.has(group)) {
-        intersection.pushBack(group);
+  //! Calls fn(group, id) for each group in bits, in the order of ids
+  template <typename Fn>
+  void forEachGroup(const Bitset& bits, Fn fn) const {
+    for (const auto word : c10::irange(bits.size())) {
+      uint64_t remaining = bits[word];
+      while (remaining != 0) {
+        const auto id = (int64_t)(word * 64) + std::countr_zero(remaining);
+        remaining &= remaining - 1;
+        if (SegmentedGroup* group = groups_.at(id)) {
+          fn(group, id);
+        }
       }
     }
-    return intersection;
   }
 
+  //! Update the producers of all groups when `merged` replaces `ids`
+  void replaceProducers(const Bitset& ids, SegmentedGroup* merged);
+
  private:
   const SegmentedFusion* segmented_fusion_;
-  DependencyMap known_producers_of_;
+  //! Dense id of each live group
+  std::unordered_map<SegmentedGroup*, int64_t> ids_;
+  //! Group of each id, or nullptr once merged into another group
+  std::vector<SegmentedGroup*> groups_;
+  //! Transitive producers of each group, indexed by id
+  std::vector<Bitset> producers_;
 };
 
 //! Finds the common producers of given set of groups
@@ -1596,23 +1768,49 @@ GroupSet GroupDependencyAnalysis::getCommonProducersOf(
     return {};
   }
 
-  // Optimization: start with the smallest producer set
-  std::sort(
-      groups.begin(),
-      groups.end(),
-      [this](SegmentedGroup* a, SegmentedGroup* b) {
-        return known_producers_of_.at(a)->size() <
-            known_producers_of_.at(b)->size();
-      });
-
   // Get intersection of producers
-  GroupSet common_producers = *(known_producers_of_.at(groups[0]));
+  Bitset common_producers = producers_.at(ids_.at(groups[0]));
   for (const auto i : c10::irange(1, groups.size())) {
-    common_producers = groupSetIntersection(
-        common_producers, *(known_producers_of_.at(groups[i])));
+    const auto& producers = producers_.at(ids_.at(groups[i]));
+    common_producers.resize(
+        std::min(common_producers.size(), producers.size()));
+    for (const auto word : c10::irange(common_producers.size())) {
+      common_producers[word] &= producers[word];
+    }
   }
 
-  return common_producers;
+  GroupSet result;
+  forEachGroup(common_producers, [&result](SegmentedGroup* group, int64_t) {
+    result.pushBack(group);
+  });
+  return result;
+}
+
+void GroupDependencyAnalysis::replaceProducers(
+    const Bitset& ids,
+    SegmentedGroup* merged) {
+  const int64_t merged_id = ids_.at(merged);
+  const Bitset& merged_producers = producers_.at(merged_id);
+  for (const auto& [group, id] : ids_) {
+    if (id == merged_id) {
+      continue;
+    }
+    auto& producers = producers_.at(id);
+    bool depends_on_merged = false;
+    const auto num_words = std::min(producers.size(), ids.size());
+    for (const auto word : c10::irange(num_words)) {
+      if ((producers[word] & ids[word]) != 0) {
+        depends_on_merged = true;
+        // The merged groups no longer exist
+        producers[word] &= ~ids[word];
+      }
+    }
+    if (depends_on_merged) {
+      // merged and all of its producers are now producers of `group`
+      set(producers, merged_id);
+      orInto(producers, merged_producers);
+    }
+  }
 }
 
 //! Update the map when the given two groups have been merged to create `ab`
@@ -1622,34 +1820,7 @@ void GroupDependencyAnalysis::mergeGroups(
     SegmentedGroup* a,
     SegmentedGroup* b,
     SegmentedGroup* ab) {
-  // Access/Create the producer set of ab
-  auto& ab_set = getAllKnownProducersSet(ab);
-
-  // propagate a's and b's known producers into ab
-  mergeAllKnownProducersIntoFrom(ab, a);
-  mergeAllKnownProducersIntoFrom(ab, b);
-
-  // a, b are now merged, so no longer exist
-  ab_set->erase(a);
-  ab_set->erase(b);
-
-  // a, b no longer exist, remove their producer sets
-  known_producers_of_.erase(a);
-  known_producers_of_.erase(b);
-
-  // update producer maps of other groups
-  for (auto& it : known_producers_of_) {
-    // for all groups that are produced by either a or b
-    if (it.second->has(a) || it.second->has(b)) {
-      // insert ab as the new producer
-      it.second->pushBack(ab);
-      // all producers of both a and b are now producers of `it`
-      mergeAllKnownProducersIntoFrom(it.first, ab);
-    }
-    // a, b no longer exist, remove them from `it`
-    it.second->erase(a);
-    it.second->erase(b);
-  }
+  mergeGroups(GroupSet{a, b}, ab);
 }
 
 //! Update the map when the given two groups have been merged to create
@@ -1659,95 +1830,90 @@ void GroupDependencyAnalysis::mergeGroups(
 void GroupDependencyAnalysis::mergeGroups(
     const GroupSet& groups,
     SegmentedGroup* merged) {
-  // Access/Create the producer set of merged
-  auto& merged_set = getAllKnownProducersSet(merged);
+  const int64_t merged_id = getOrCreateId(merged);
 
   // Populate all producers of groups and
   //  write into producer map of merged
-  std::for_each(
-      groups.begin(), groups.end(), [this, merged](SegmentedGroup* group) {
-        mergeAllKnownProducersIntoFrom(merged, group);
-      });
-
-  // Erase all groups that was merged from producer map
-  std::for_each(
-      groups.begin(), groups.end(), [this, &merged_set](SegmentedGroup* group) {
-        // erase inter dependencies
-        merged_set->erase(group);
-        // erase producer map tracking merged entires
-        known_producers_of_.erase(group);
-      });
+  Bitset merged_ids;
+  Bitset merged_producers;
+  for (auto group : groups) {
+    auto it = ids_.find(group);
+    if (it == ids_.end()) {
+      continue;
+    }
+    set(merged_ids, it->second);
+    orInto(merged_producers, producers_.at(it->second));
+  }
+  // erase inter dependencies
+  for (const auto word : c10::irange(
+           std::min(merged_producers.size(), merged_ids.size()))) {
+    merged_producers[word] &= ~merged_ids[word];
+  }
+  producers_.at(merged_id) = std::move(merged_producers);
 
   // Update producer relationships with other groups in producer map
-  for (auto& it : known_producers_of_) {
-    auto producer_intersection = groupSetIntersection(*(it.second), groups);
-    // if current node has any producer that was merged
-    if (!producer_intersection.empty()) {
-      for (auto merged_producer : producer_intersection) {
-        // delete all disappearing producers
-        it.second->erase(merged_producer);
-      }
-      // insert the new group as producer
-      it.second->pushBack(merged);
-      // all producers of merged are now producers of `it`
-      mergeAllKnownProducersIntoFrom(it.first, merged);
-    }
+  replaceProducers(merged_ids, merged);
+
+  // Erase producer map tracking merged entires
+  for (auto group : groups) {
+    eraseGroup(group);
   }
 }
 
-//! Collect initial producer info using
-//!  a work list algorithm through forward traversal
-//!  a backward DFS would do the same
+//! Collect initial producer info by visiting groups in topological order
 void GroupDependencyAnalysis::computeAllProducers() {
-  GroupSet visited;
-  GroupSet to_visit;
+  std::unordered_map<SegmentedGroup*, int64_t> num_unvisited_producers;
+  std::vector<SegmentedGroup*> ready;
+
+  // Multi-edges between two groups count once
+  auto unique_producers = [](SegmentedGroup* group) {
+    GroupSet producers;
+    for (auto edge : group->producer_edges) {
+      producers.pushBack(edge->from);
+    }
+    return producers;
+  };
 
   // Collect source nodes, with no producers we are guaranteed
   //  a source node on a DAG
   for (auto group : segmented_fusion_->cgroups()) {
-    if (group->producer_edges.empty()) {
-      visited.pushBack(group);
+    getOrCreateId(group);
+    const auto num_producers = (int64_t)unique_producers(group).size();
+    num_unvisited_producers[group] = num_producers;
+    if (num_producers == 0) {
+      ready.push_back(group);
     }
   }
 
-  // visited now only contain source nodes
-  //  they can go backward to nowhere
-  for (auto group : visited) {
-    addConsumersToWorkList(group, to_visit);
-  }
+  int64_t num_visited = 0;
+  while (!ready.empty()) {
+    SegmentedGroup* group = ready.back();
+    ready.pop_back();
+    ++num_visited;
 
-  while (!to_visit.empty()) {
-    SegmentedGroup* to_update = nullptr;
-    for (auto visiting_group : to_visit) {
-      if (std::all_of(
-              visiting_group->producer_edges.begin(),
-              visiting_group->producer_edges.end(),
-              [&visited](SegmentedEdge* e) { return visited.has(e->from); })) {
-        // filter multi-edges
-        GroupSet producers_of_visiting_group;
-        for (auto edge : visiting_group->producer_edges) {
-          producers_of_visiting_group.pushBack(edge->from);
-        }
+    // populate all possible paths
+    // from producer backward, including
+    // the producer
+    const int64_t id = ids_.at(group);
+    for (auto producer : unique_producers(group)) {
+      const int64_t producer_id = ids_.at(producer);
+      set(producers_.at(id), producer_id);
+      orInto(producers_.at(id), producers_.at(producer_id));
+    }
 
-        // populate all possible paths
-        // from producer backward, including
-        // the producer
-        for (auto producer : producers_of_visiting_group) {
-          getAllKnownProducersSet(visiting_group)->pushBack(producer);
-          mergeAllKnownProducersIntoFrom(visiting_group, producer);
-        }
-        to_update = visiting_group;
-        break;
-      }
+    GroupSet consumers;
+    for (auto edge : group->consumer_edges) {
+      consumers.pushBack(edge->to);
     }
-    if (to_update) {
-      addConsumersToWorkList(to_update, to_visit);
-      to_visit.erase(to_update);
-      visited.pushBack(to_update);
-    } else {
-      NVF_ERROR(false, "unreachable, original graph not a DAG");
+    for (auto consumer : consumers) {
+      if (--num_unvisited_producers.at(consumer) == 0) {
+        ready.push_back(consumer);
+      }
     }
   }
+  NVF_ERROR(
+      num_visited == (int64_t)segmented_fusion_->cgroups().size(),
+      "unreachable, original graph not a DAG");
 }
 
 std::ostream& operator<<(
@@ -1907,27 +2073,16 @@ void convertInputRfactorsToRoots(Fusion* fusion) {
 
 std::pair<IrCloner, std::unique_ptr<Fusion>> SegmentedFusion::makeFusion(
     SegmentedGroup* sg) {
-  // TODO Optimize cloning step by only copying values and expressions between
-  // the fusion segment's inputs and outputs.
   auto fusion_segment = std::make_unique<Fusion>();
 
-  IrCloner complete_to_segment_map =
-      Fusion::copy(completeFusion(), fusion_segment.get());
-
-  std::vector<Val*> input_list(
-      fusion_segment->inputs().begin(), fusion_segment->inputs().end());
-  for (auto inp : input_list) {
-    fusion_segment->removeInput(inp);
-  }
-
-  std::vector<Val*> output_list(
-      fusion_segment->outputs().begin(), fusion_segment->outputs().end());
-  for (auto out : output_list) {
-    fusion_segment->removeOutput(out);
-  }
+  // Only clone the values and expressions between the segment's inputs and
+  // outputs instead of the complete fusion
+  const std::vector<Val*> segment_inputs = getAllInputs(sg);
+  IrCloner complete_to_segment_map = Fusion::copyBetween(
+      completeFusion(), fusion_segment.get(), segment_inputs, sg->output_vals);
 
   std::vector<TensorView*> view_tvs;
-  for (auto inp : getAllInputs(sg)) {
+  for (auto inp : segment_inputs) {
     auto clone_tv = complete_to_segment_map.clone(inp);
     fusion_segment->addInput(clone_tv);
     if (inp->isDefinitionType<ViewOp>()) {
@@ -2158,7 +2313,13 @@ SegmentedGroup* SegmentCandidateFinder::mergeNodes() {
           disconnected_edges.begin(), disconnected_edges.end());
     }
 
-    joined_group->setHeuristic(deriveHeuristic(joined_group));
+    // The heuristic of the merged pair was already derived by
+    // codeGenSupportedMerge
+    auto cache_it = merge_cache_.find(std::make_pair(group1, group2));
+    joined_group->setHeuristic(
+        cache_it != merge_cache_.end() && cache_it->second.has_value()
+            ? cache_it->second.value()
+            : deriveHeuristic(joined_group));
     // Need to maintain the group dependency data if it has been intialized
     //  by previous merging
     if (group_dependency_) {
@@ -3636,8 +3797,162 @@ std::optional<SegmentedGroup::NeighborGroup> PreferredMergeCandidatePicker::
       (*producer_edge_it)->from, *producer_edge_it);
 }
 
+//! Bytes of tv in global memory, or nullopt if its size is unknown
+std::optional<int64_t> materializedBytes(
+    TensorView* tv,
+    ExpressionEvaluator& expr_eval) {
+  int64_t numel = 1;
+  for (auto id : TensorDomain::noReductions(tv->getMaybeRFactorDomain())) {
+    // Broadcast domains are not materialized in memory
+    if (id->isBroadcast()) {
+      continue;
+    }
+    auto extent = expr_eval.evaluate(id->extent());
+    if (!extent.hasValue()) {
+      return std::nullopt;
+    }
+    numel *= extent.as<int64_t>();
+  }
+  return numel * (int64_t)dataTypeSize(tv->dtype());
+}
+
 } // namespace
 
+SegmentCostModel::SegmentCostModel() {
+  launch_overhead_us_ = 4.0;
+  const auto& option_args =
+      getEnableOptionArguments(EnableOption::SegmentCostModel);
+  if (!option_args.empty()) {
+    try {
+      launch_overhead_us_ = std::stod(option_args[0]);
+    } catch (const std::exception& e) {
+      debug() << "skip invalid argument for SegmentCostModel, arg = "
+              << option_args[0] << std::endl;
+    }
+  }
+  const auto properties = at::cuda::getCurrentDeviceProperties();
+  // Memory clock is in kHz and bus width in bits. The factor of 2 accounts
+  // for double data rate.
+  peak_bandwidth_bytes_per_us_ = 2.0 * properties->memoryClockRate * 1.0e-3 *
+      (properties->memoryBusWidth / 8.0);
+}
+
+SegmentCostModel::SegmentCostModel(
+    double launch_overhead_us,
+    double peak_bandwidth_bytes_per_us)
+    : launch_overhead_us_(launch_overhead_us),
+      peak_bandwidth_bytes_per_us_(peak_bandwidth_bytes_per_us) {
+  NVF_ERROR(
+      peak_bandwidth_bytes_per_us_ > 0.0,
+      "Invalid peak bandwidth: ",
+      peak_bandwidth_bytes_per_us_);
+}
+
+/*static*/ double SegmentCostModel::efficiency(
+    ScheduleHeuristic heuristic,
+    int64_t persistent_buffer_bytes) {
+  switch (heuristic) {
+    case ScheduleHeuristic::NoOp:
+    case ScheduleHeuristic::PointWise:
+    case ScheduleHeuristic::MultiTensor:
+      return 0.9;
+    case ScheduleHeuristic::Transpose:
+    case ScheduleHeuristic::Reduction:
+      return 0.8;
+    case ScheduleHeuristic::InnerPersistent:
+    case ScheduleHeuristic::OuterPersistent:
+    case ScheduleHeuristic::InnerOuterPersistent: {
+      // The persistent buffers of a block are held in registers or shared
+      // memory, so fewer blocks fit on an SM as the buffers grow. The
+      // schedulers reject buffers larger than the register file.
+      const double fraction_of_register_file =
+          std::min(1.0, (double)persistent_buffer_bytes /
+                   (double)scheduler_utils::register_file_size);
+      return 0.8 * std::max(0.3, 1.0 - 0.7 * fraction_of_register_file);
+    }
+    default:
+      // Not memory bound, e.g. matmul. Merging is never rejected.
+      return 1.0;
+  }
+}
+
+SegmentCost SegmentCostModel::estimate(
+    Fusion* fusion,
+    ScheduleHeuristic heuristic,
+    SchedulerRuntimeInfo& runtime_info) const {
+  FUSER_PERF_SCOPE("SegmentCostModel::estimate");
+  SegmentCost cost;
+
+  auto tensor_bytes = [&runtime_info](TensorView* tv) -> int64_t {
+    return materializedBytes(tv, runtime_info.expressionEvaluator())
+        .value_or(0);
+  };
+  for (auto tv : ir_utils::filterByType<TensorView>(fusion->inputs())) {
+    cost.bytes += tensor_bytes(tv);
+  }
+  for (auto tv : ir_utils::filterByType<TensorView>(fusion->outputs())) {
+    // Outputs evaluated on the host, e.g. views of inputs, move no data
+    if (fusion->getOutputAlias(tv).type == AllocationType::Evaluate) {
+      continue;
+    }
+    cost.bytes += tensor_bytes(tv);
+  }
+
+  int64_t persistent_buffer_bytes = 0;
+  if (heuristic == ScheduleHeuristic::InnerPersistent ||
+      heuristic == ScheduleHeuristic::OuterPersistent ||
+      heuristic == ScheduleHeuristic::InnerOuterPersistent) {
+    auto persistent_buffer_size = scheduler_utils::persistentBufferSize(
+        fusion, runtime_info, scheduler_utils::persistentBuffers(fusion));
+    persistent_buffer_bytes = std::min(
+        persistent_buffer_size.persistent_buffer_size,
+        persistent_buffer_size.projected_persistent_buffer_size);
+  }
+  cost.efficiency = efficiency(heuristic, persistent_buffer_bytes);
+  cost.time_us = launch_overhead_us_ +
+      (double)cost.bytes / (peak_bandwidth_bytes_per_us_ * cost.efficiency);
+  return cost;
+}
+
+bool SegmentCandidateFinder::isMergeProfitable(
+    SegmentedGroup* group1,
+    SegmentedGroup* group2,
+    ScheduleHeuristic merged_heuristic) {
+  NVF_ERROR(cost_model_.has_value());
+  auto estimate = [this](
+                      const std::vector<SegmentedGroup*>& groups,
+                      ScheduleHeuristic heuristic) {
+    FusionSegmentGuard fsg(segmented_fusion_.get(), groups);
+    return cost_model_->estimate(
+        segmented_fusion_->completeFusion(), heuristic, runtimeInfo());
+  };
+  auto group_heuristic = [this](SegmentedGroup* group) {
+    if (group->heuristic() != ScheduleHeuristic::None) {
+      return group->heuristic();
+    }
+    // Heuristics are only derived for groups with fusion outputs before
+    // merging
+    auto h = tryMerge(segmented_fusion_.get(), runtimeInfo(), group);
+    return h.value_or(ScheduleHeuristic::PointWise);
+  };
+
+  const auto merged = estimate({group1, group2}, merged_heuristic);
+  const auto separate1 = estimate({group1}, group_heuristic(group1));
+  const auto separate2 = estimate({group2}, group_heuristic(group2));
+  const bool profitable =
+      merged.time_us <= separate1.time_us + separate2.time_us;
+
+  if (isDebugDumpEnabled(DebugDumpOption::FusionSegmenterLog)) {
+    debug() << "Segment cost model: merging groups " << group1->groupId()
+            << " and " << group2->groupId() << " as "
+            << toString(merged_heuristic) << " is estimated at "
+            << merged.time_us << "us vs " << separate1.time_us << "us + "
+            << separate2.time_us << "us separately, "
+            << (profitable ? "merging" : "not merging") << std::endl;
+  }
+  return profitable;
+}
+
 bool SegmentCandidateFinder::codeGenSupportedMerge(
     SegmentedGroup* group1,
     SegmentedGroup* group2) {
@@ -3654,8 +3969,20 @@ bool SegmentCandidateFinder::codeGenSupportedMerge(
     }
     return true;
   }
+  // Groups are never modified once merging starts, as merging creates a new
+  // group, so the result for a pair stays valid
+  auto [cache_it, inserted] =
+      merge_cache_.emplace(std::make_pair(group1, group2), std::nullopt);
+  if (!inserted) {
+    return cache_it->second.has_value();
+  }
   auto h = tryMerge(segmented_fusion_.get(), runtimeInfo(), group1, group2);
-  return h.has_value();
+  if (h.has_value() &&
+      (!cost_model_.has_value() ||
+       isMergeProfitable(group1, group2, h.value()))) {
+    cache_it->second = h;
+  }
+  return cache_it->second.has_value();
 }
 
 // TODO: consider caching the heuristics value so tryMerge doesn't have to be
@@ -3690,11 +4017,16 @@ SegmentCandidateFinder::SegmentCandidateFinder(
            !options_.run_combine_reductions && options_.run_herrmann_merge &&
            options_.run_final_merge),
       "Invalid Segmenter options");
+  if (isOptionEnabled(EnableOption::SegmentCostModel) &&
+      runtime_info_.has_value() && !options_.only_segment_resharding_exprs) {
+    cost_model_.emplace();
+  }
   segmented_fusion_ = std::make_unique<SegmentedFusion>(std::move(fusion));
   findSegments();
 }
 
 void SegmentCandidateFinder::buildInitialSegments() {
+  merge_cache_.clear();
   groups().clear();
   edges().clear();
 
@@ -3834,12 +4166,18 @@ void SegmentCandidateFinder::resolveForwardedInputs() {
     group->exprs_.insert(
         group->exprs_.begin(), input_exprs.begin(), input_exprs.end());
   }
+  // Groups were modified in place
+  merge_cache_.clear();
 }
 
 void SegmentCandidateFinder::findSegments() {
   FUSER_PERF_SCOPE("Finding valid fusion segment solutions");
+  CompileStepScope step("SegmentCandidateFinder::findSegments");
 
-  buildInitialSegments();
+  {
+    CompileStepScope initial_step("buildInitialSegments");
+    buildInitialSegments();
+  }
 
   segmented_fusion_->validateIfDebug();
 
@@ -3877,8 +4215,12 @@ void SegmentCandidateFinder::findSegments() {
 
   if (options_.run_herrmann_merge) {
     bool merged_nodes = true;
+    int64_t merge_iteration = 0;
     // Initial merge iteration
     while (merged_nodes) {
+      CompileStepScope merge_step(
+          "herrmann merge iteration " + std::to_string(merge_iteration++));
+
       // Reset stateful traversal details in SegmentedGroups
       resetTraversal();
 
@@ -3913,6 +4255,7 @@ void SegmentCandidateFinder::findSegments() {
   if (options_.run_final_merge) {
     // TODO: consider interleaving herrmman merge and bruteforce merge, as
     // bruteforce merge can introduce opportunities for more herrmann merge
+    CompileStepScope final_merge_step("finalMerge");
     finalMerge();
   }
 
@@ -3929,7 +4272,16 @@ void SegmentCandidateFinder::findSegments() {
   // Forwarded input groups are no longer used. Clean them up.
   cleanupForwardedInputs();
 
-  finalize();
+  if (isOptionEnabled(EnableOption::SegmentRecomputation) &&
+      runtime_info_.has_value() && !options_.only_segment_resharding_exprs) {
+    CompileStepScope recompute_step("recomputeCheapProducers");
+    recomputeCheapProducers();
+  }
+
+  {
+    CompileStepScope finalize_step("finalize");
+    finalize();
+  }
 
   // Do sanity check on the final graph.
   segmented_fusion_->validate(/*require_disjoint=*/false);
@@ -4297,7 +4649,155 @@ void SegmentCandidateFinder::resolveNonscalarForwardedInput(
   }
 }
 
+namespace {
+
+// Producers with more tensor ops than this are not recomputed, since their
+// compute would no longer be negligible next to the traffic they save
+constexpr int64_t max_recomputed_exprs = 8;
+
+//! Whether all tensor ops from the complete fusion inputs to tv are cheap
+//! elementwise ops
+bool isCheapToRecompute(TensorView* tv) {
+  int64_t num_tensor_exprs = 0;
+  for (auto expr : StmtSort::getExprsTo({tv})) {
+    if (ir_utils::isScalarOp(expr)) {
+      continue;
+    }
+    auto ldst = dynamic_cast<LoadStoreOp*>(expr);
+    const bool is_cheap =
+        expr->isOneOf<UnaryOp, BinaryOp, TernaryOp, BroadcastOp, ExpandOp>() ||
+        (ldst != nullptr && ldst->opType() == LoadStoreOpType::Set);
+    if (!is_cheap || ++num_tensor_exprs > max_recomputed_exprs) {
+      return false;
+    }
+  }
+  return num_tensor_exprs > 0;
+}
+
+} // namespace
+
+void SegmentCandidateFinder::recomputeCheapProducers() {
+  FUSER_PERF_SCOPE("SegmentCandidateFinder::recomputeCheapProducers");
+  // Collected up front since the edges change as producers are recomputed
+  VectorOfUniqueEntries<TensorView*> intermediates;
+  for (SegmentedEdge* edge : edges()) {
+    auto tv = dynamic_cast<TensorView*>(edge->val);
+    if (tv != nullptr && !tv->isFusionInput() && !tv->isFusionOutput()) {
+      intermediates.pushBack(tv);
+    }
+  }
+
+  for (TensorView* tv : intermediates) {
+    if (!isCheapToRecompute(tv)) {
+      continue;
+    }
+
+    GroupSet consumers;
+    for (SegmentedEdge* edge : edges()) {
+      if (edge->val == tv) {
+        consumers.pushBack(edge->to);
+      }
+    }
+    if (consumers.empty()) {
+      continue;
+    }
+
+    // Recomputing reads the inputs of tv once per consumer instead of
+    // writing tv once and reading it once per consumer
+    std::optional<int64_t> tv_bytes =
+        materializedBytes(tv, expressionEvaluator());
+    std::optional<int64_t> input_bytes = 0;
+    const std::vector<Val*> inputs = IterVisitor::getInputsTo({tv});
+    for (auto inp : ir_utils::filterByType<TensorView>(inputs)) {
+      std::optional<int64_t> bytes =
+          materializedBytes(inp, expressionEvaluator());
+      if (!bytes.has_value()) {
+        input_bytes = std::nullopt;
+        break;
+      }
+      *input_bytes += *bytes;
+    }
+    const auto num_consumers = (int64_t)consumers.size();
+    if (!tv_bytes.has_value() || !input_bytes.has_value() ||
+        num_consumers * *input_bytes >= (num_consumers + 1) * *tv_bytes) {
+      continue;
+    }
+
+    const std::vector<Expr*> recomputed_exprs = StmtSort::getExprsTo({tv});
+    const std::unordered_set<Expr*> recomputed_expr_set(
+        recomputed_exprs.begin(), recomputed_exprs.end());
+    for (SegmentedGroup* consumer : consumers) {
+      // The consumer already computes part of tv, e.g. a forwarded input.
+      // Appending the rest would duplicate exprs within the group.
+      if (std::any_of(
+              consumer->exprs().begin(),
+              consumer->exprs().end(),
+              [&recomputed_expr_set](Expr* expr) {
+                return recomputed_expr_set.count(expr);
+              })) {
+        continue;
+      }
+
+      // Like resolveNonscalarForwardedInput, the consumer reads tv from a
+      // new group that computes it from the fusion inputs and is then
+      // merged into the consumer
+      SegmentedGroup* input_group = createInputGroup(tv);
+      SegmentedGroup* producer = nullptr;
+      for (SegmentedEdge* edge : consumer->producer_edges) {
+        if (edge->val != tv) {
+          continue;
+        }
+        producer = edge->from;
+        auto& producer_edges = producer->consumer_edges;
+        producer_edges.erase(
+            std::remove(producer_edges.begin(), producer_edges.end(), edge),
+            producer_edges.end());
+        edge->from = input_group;
+        input_group->consumer_edges.push_back(edge);
+      }
+      NVF_ERROR(producer != nullptr);
+
+      if (codeGenSupportedMerge(input_group, consumer)) {
+        NVF_ERROR(to_merge_.empty());
+        to_merge_.push_back(input_group);
+        to_merge_.push_back(consumer);
+        mergeNodes();
+        continue;
+      }
+
+      // The consumer can't be scheduled with tv recomputed, so it keeps
+      // reading tv from its producer
+      for (SegmentedEdge* edge : input_group->consumer_edges) {
+        edge->from = producer;
+        producer->consumer_edges.push_back(edge);
+      }
+      input_group->consumer_edges.clear();
+      std::unordered_set<SegmentedGroup*> groups_to_erase{input_group};
+      eraseGroups(groups_to_erase);
+    }
+  }
+
+  // Producers that only computed tensors for consumers that now recompute
+  // them are left without uses
+  while (true) {
+    std::unordered_set<SegmentedGroup*> unused_groups;
+    for (SegmentedGroup* group : groups()) {
+      if (group->output_vals.empty() && group->consumer_edges.empty()) {
+        unused_groups.insert(group);
+      }
+    }
+    if (unused_groups.empty()) {
+      break;
+    }
+    eraseGroups(unused_groups);
+  }
+
+  // Groups were added and removed without updating the dependency analysis
+  group_dependency_.reset();
+}
+
 void SegmentCandidateFinder::removeScalarEdges() {
+  merge_cache_.clear();
   // Remove all scalar edges between groups
   //  They may have been created by welford
   //   translation.
@@ -4379,6 +4879,7 @@ FusionKernelRuntime::SchedulerEntryPtr SegmentedFusion::
 
 HeuristicSummary* SegmentedFusion::getCachedHeuristicDataFor(
     SegmentedGroup* group) {
+  std::lock_guard<std::mutex> lock(heuristic_summary_cache_mutex_);
   auto data_it = heuristic_summary_cache_.find(group);
   if (data_it == heuristic_summary_cache_.end()) {
     return nullptr;
@@ -4389,6 +4890,7 @@ HeuristicSummary* SegmentedFusion::getCachedHeuristicDataFor(
 void SegmentedFusion::setCachedHeuristicDataFor(
     SegmentedGroup* group,
     std::unique_ptr<HeuristicSummary> data) {
+  std::lock_guard<std::mutex> lock(heuristic_summary_cache_mutex_);
   NVF_ERROR(!heuristic_summary_cache_.count(group));
   heuristic_summary_cache_[group] = std::move(data);
 }
@@ -4506,11 +5008,15 @@ namespace {
 //!     1. are not complete fusion input/output,
 //!     2. have a use chain that ends with a fp16
 //!         complete fusion output
-//!     3. are fp32 datatype
+//!     3. are fp32 datatype, or also fp16/bf16 datatype when
+//!         annotate_half_tvs is true, e.g., for storing them as fp8
 class ForceHalfAnnotation : public IterVisitor {
  public:
-  static std::unordered_set<TensorView*> getFP16AnnotatedSet(Fusion* fusion) {
+  static std::unordered_set<TensorView*> getFP16AnnotatedSet(
+      Fusion* fusion,
+      bool annotate_half_tvs) {
     ForceHalfAnnotation annotation;
+    annotation.annotate_half_tvs_ = annotate_half_tvs;
     std::vector<Val*> fp16_outputs;
     auto& cast_to_type = annotation.cast_to_type_;
     auto other_half_type =
@@ -4541,12 +5047,18 @@ class ForceHalfAnnotation : public IterVisitor {
 
   void handle(TensorView* tv) override {
     auto dtype = tv->getDataType();
-    if (dtype.has_value() && dtype.value() == DataType::Float &&
-        !tv->isFusionOutput() && !tv->isFusionInput()) {
+    if (!dtype.has_value() || tv->isFusionOutput() || tv->isFusionInput()) {
+      return;
+    }
+    if (dtype.value() == DataType::Float ||
+        (annotate_half_tvs_ &&
+         (dtype.value() == DataType::Half ||
+          dtype.value() == DataType::BFloat16))) {
       force_fp16_tv_set_.insert(tv);
     }
   }
 
+  bool annotate_half_tvs_ = false;
   std::unordered_set<TensorView*> force_fp16_tv_set_;
   std::optional<DataType> cast_to_type_ = std::nullopt;
 };
@@ -4554,8 +5066,12 @@ class ForceHalfAnnotation : public IterVisitor {
 } // namespace
 
 void SegmentedFusion::annotateFP16IntermediateTensors() {
-  force_fp16_tv_set_ =
-      ForceHalfAnnotation::getFP16AnnotatedSet(complete_fusion_.get());
+  // Half-precision tensors can only be lowered further to fp8
+  const bool annotate_half_tvs =
+      lower_precision_policy_.storage_type.has_value() &&
+      isFp8Type(lower_precision_policy_.storage_type.value());
+  force_fp16_tv_set_ = ForceHalfAnnotation::getFP16AnnotatedSet(
+      complete_fusion_.get(), annotate_half_tvs);
   for (auto out_tv :
        ir_utils::filterByType<TensorView>(complete_fusion_->outputs())) {
     if (out_tv) {
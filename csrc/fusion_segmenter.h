@@ -19,7 +19,9 @@
 #include <visibility.h>
 
 #include <deque>
+#include <limits>
 #include <list>
+#include <mutex>
 #include <unordered_set>
 #include <vector>
 
@@ -318,6 +320,28 @@ class FusionHeuristics {
   bool is_segmented_ = true;
 };
 
+//! How the tensors of segment boundaries are stored when
+//! EnableOption::IoToLowerPrecision is enabled. The policy is given by the
+//! option arguments, e.g.,
+//!   NVFUSER_ENABLE=io_to_lower_precision(fp8_e4m3,tolerance=0.1,scale=64)
+//! where the storage type is one of fp16, bf16, fp8_e4m3 and fp8_e5m2.
+struct LowerPrecisionPolicy {
+  //! Storage type of the boundary tensors. The half-precision type of the
+  //! fusion outputs is used when not given.
+  std::optional<DataType> storage_type = std::nullopt;
+  //! Largest unit roundoff allowed for a boundary tensor. When the storage
+  //! type is less precise, the half-precision type of the fusion outputs is
+  //! tried instead, and the tensor is kept as is if that is not precise
+  //! enough either.
+  double tolerance = std::numeric_limits<double>::infinity();
+  //! Float tensors stored as fp8 are multiplied by this scale before the
+  //! cast and divided by it after the cast back, so that small values don't
+  //! flush to zero.
+  double fp8_scale = 1.0;
+
+  static LowerPrecisionPolicy fromOptions();
+};
+
 //! Exported Interface for representing segmented fusion graph
 //!   this class owns the segmented groups
 class SegmentedFusion {
@@ -419,6 +443,10 @@ class SegmentedFusion {
       const std::vector<SegmentedEdge*>& edges,
       const std::vector<SegmentedGroup*>& groups_to_merge = {});
 
+  //! Storage type of a boundary tensor given lower_precision_policy_, or
+  //! nullopt if the tensor should be kept as is
+  std::optional<DataType> lowerPrecisionTypeOf(TensorView* tv) const;
+
   //! Revert the changes made by castInputOutputToLowerPrecision to the given
   //! edges
   void revertInputOutputPrecisionChanges(
@@ -494,10 +522,21 @@ class SegmentedFusion {
 
   DataType force_half_precision_type_;
 
+  //! Storage types and scaling of the tensors in force_fp16_tv_set_
+  LowerPrecisionPolicy lower_precision_policy_;
+
+  //! Tensors of the fp8 scaling exprs inserted by
+  //! castInputOutputToLowerPrecision, i.e., the scaled tensors before the
+  //! cast and the cast-back tensors before the unscaling
+  std::unordered_set<Val*> fp8_scaling_tvs_;
+
   //! Static traversal information to be used for fast heuristics lookup
   std::unordered_map<SegmentedGroup*, std::unique_ptr<HeuristicSummary>>
       heuristic_summary_cache_;
 
+  //! Heuristics of different groups may be computed concurrently
+  mutable std::mutex heuristic_summary_cache_mutex_;
+
   //! The number of values in fusion after constructing segmented fusion.
   //! Used for checking state during deserialization.
   size_t initial_vals_size_;
@@ -556,6 +595,56 @@ struct SegmentCandidateFinderOptions {
   bool only_segment_resharding_exprs = false;
 };
 
+//! Estimated cost of running a fusion segment as one kernel
+struct SegmentCost {
+  //! Bytes of the segment inputs and outputs moved through global memory
+  int64_t bytes = 0;
+  //! Expected fraction of the peak DRAM bandwidth achieved by the scheduler
+  double efficiency = 1.0;
+  //! Launch overhead plus the time to move bytes at the achieved bandwidth
+  double time_us = 0.0;
+};
+
+//! An analytical cost model of fusion segments, used with
+//! NVFUSER_ENABLE=segment_cost_model to reject merges that are expected to be
+//! slower than running the groups separately. Segments are assumed to be
+//! memory bound, so the time of a segment is a fixed kernel launch overhead
+//! plus its global memory traffic over the bandwidth its scheduler is
+//! expected to achieve. Persistent schedulers get less efficient as their
+//! persistent buffers grow, since larger buffers lower the occupancy, which
+//! is why a large persistent kernel can lose to two smaller kernels.
+class SegmentCostModel {
+ public:
+  //! Uses the current device's peak bandwidth. The launch overhead defaults
+  //! to the argument of the segment_cost_model option or 4us.
+  NVF_API SegmentCostModel();
+
+  NVF_API SegmentCostModel(
+      double launch_overhead_us,
+      double peak_bandwidth_bytes_per_us);
+
+  //! Estimates the cost of fusion, a complete fusion or a segment narrowed
+  //! by the segmenter, scheduled by heuristic
+  NVF_API SegmentCost estimate(
+      Fusion* fusion,
+      ScheduleHeuristic heuristic,
+      SchedulerRuntimeInfo& runtime_info) const;
+
+  //! Expected fraction of the peak bandwidth achieved by heuristic.
+  //! persistent_buffer_bytes is only used by the persistent heuristics.
+  NVF_API static double efficiency(
+      ScheduleHeuristic heuristic,
+      int64_t persistent_buffer_bytes = 0);
+
+  double launchOverheadUs() const {
+    return launch_overhead_us_;
+  }
+
+ private:
+  double launch_overhead_us_ = 0.0;
+  double peak_bandwidth_bytes_per_us_ = 0.0;
+};
+
 //!  SegmentCandidateFinder
 //!    Responsible for going through DAG and proposing things we could try to
 //!    fuse together, calls "canGenerateCode" on these proposed segments to see
@@ -630,6 +719,14 @@ class SegmentCandidateFinder {
 
   bool codeGenSupportedMerge(SegmentedGroup* group1, SegmentedGroup* group2);
 
+  //! Whether merging group1 and group2 into a group scheduled by
+  //! merged_heuristic is estimated to be no slower than running them
+  //! separately
+  bool isMergeProfitable(
+      SegmentedGroup* group1,
+      SegmentedGroup* group2,
+      ScheduleHeuristic merged_heuristic);
+
   void buildInitialSegments();
 
   void findSegments();
@@ -711,6 +808,15 @@ class SegmentCandidateFinder {
   // between fusion inputs and `forwarded_input`.
   SegmentedGroup* createInputGroup(Val* forwarded_input);
 
+  //! With NVFUSER_ENABLE=segment_recomputation, recomputes intermediate
+  //! tensors computed by cheap elementwise ops from the fusion inputs in each
+  //! consuming group instead of passing them through global memory. A tensor
+  //! is recomputed when reading its inputs once per consumer moves fewer
+  //! bytes than writing it once and reading it once per consumer, e.g. when
+  //! it is upcast from a half precision input. Producer groups left without
+  //! uses are removed.
+  void recomputeCheapProducers();
+
   //! Remove all scalar edges in group
   //!  (TODO: need structure better so we don't have to do this)
   void removeScalarEdges();
@@ -790,6 +896,27 @@ class SegmentCandidateFinder {
   // used for breaking the fusion into compute and communication segments
   std::optional<SchedulerRuntimeInfo> runtime_info_;
 
+  //! Only set with NVFUSER_ENABLE=segment_cost_model
+  std::optional<SegmentCostModel> cost_model_;
+
+  struct GroupPairHash {
+    size_t operator()(
+        const std::pair<SegmentedGroup*, SegmentedGroup*>& pair) const {
+      return std::hash<SegmentedGroup*>{}(pair.first) ^
+          (std::hash<SegmentedGroup*>{}(pair.second) << 1);
+    }
+  };
+
+  //! Results of codeGenSupportedMerge, i.e., the heuristic of the merged
+  //! group or nullopt if the pair can't be merged. The segmenter retries the
+  //! same pairs in every merge iteration, which is what makes it superlinear
+  //! without this cache.
+  std::unordered_map<
+      std::pair<SegmentedGroup*, SegmentedGroup*>,
+      std::optional<ScheduleHeuristic>,
+      GroupPairHash>
+      merge_cache_;
+
   //! Note:
   //!  Segmenter should eventually rely only on runtime_info_ for
   //!  safe caching. runtime_inputs_ is only used in translateWelford
@@ -12,14 +12,26 @@
 #include <type.h>
 
 #include <ATen/ATen.h>
+#include <c10/cuda/CUDAGraphsC10Utils.h>
+#include <c10/cuda/CUDAStream.h>
+
+#include <unordered_map>
 
 namespace nvfuser {
 
 namespace {
 
-// For each device, we maintain an arena tensor which we will slice to provide
-// individual tensors. These tensors will grow in size and remain at the
-// high-water mark for their particular device until the thread terminates.
+// For each device and stream, we maintain an arena tensor which we will slice
+// to provide individual tensors. These tensors will grow in size and remain at
+// the high-water mark for their particular device and stream until the thread
+// terminates.
+//
+// Kernels using the arena reset their slices to zero before they finish, so
+// the memory can be handed out again to the next launch on the same stream
+// without a memset: stream order guarantees the previous kernel is done.
+// Kernels on different streams may run concurrently, so each stream gets its
+// own arena. The arena tensor is (re)allocated on the stream it serves, which
+// makes freeing the old tensor on growth stream-ordered as well.
 class Arena {
  public:
   // Mark allocated_bytes_ as 0, allowing all available zeroed memory to be
@@ -47,6 +59,7 @@ class Arena {
 
     // after this function returns this will be the allocated size
     int64_t new_allocated_bytes = aligned_allocated_bytes + new_bytes;
+    high_water_bytes_ = std::max(high_water_bytes_, new_allocated_bytes);
 
     // resize tensor_ if needed. Minimum size is 128B.
     int64_t new_used_bytes = std::max((int64_t)128LL, tensor_.numel());
@@ -55,8 +68,9 @@ class Arena {
     }
     if (new_used_bytes > tensor_.numel()) {
       if (isDebugDumpEnabled(DebugDumpOption::GlobalZeroedMemory)) {
-        debug() << "[global zeroed memory] Resizing arena to " << new_used_bytes
-                << " bytes" << std::endl;
+        debug() << "[global zeroed memory] Resizing arena for stream "
+                << c10::cuda::getCurrentCUDAStream(device.index()).id()
+                << " to " << new_used_bytes << " bytes" << std::endl;
       }
       tensor_ = at::zeros(
           {new_used_bytes},
@@ -70,9 +84,14 @@ class Arena {
     }
 
     // Check that memory is zeroed before allocating. Note that this launches
-    // another kernel, so it is disabled for release builds.
+    // another kernel, so it is disabled for release builds. It also
+    // synchronizes with the host, which is not allowed while capturing a
+    // CUDA graph.
 #ifndef NDEBUG
-    checkZeroed();
+    if (c10::cuda::currentStreamCaptureStatusMayInitCtx() ==
+        c10::cuda::CaptureStatus::None) {
+      checkZeroed();
+    }
 #endif
 
     allocated_bytes_ = new_allocated_bytes;
@@ -85,6 +104,11 @@ class Arena {
         .view(sizes);
   }
 
+  //! Largest number of bytes requested between two resets
+  int64_t highWaterBytes() const {
+    return high_water_bytes_;
+  }
+
  private:
   void checkZeroed() const {
     c10::Scalar nnz = at::count_nonzero(tensor_).item();
@@ -98,37 +122,56 @@ class Arena {
  private:
   at::Tensor tensor_;
   int64_t allocated_bytes_ = 0LL;
+  int64_t high_water_bytes_ = 0LL;
 };
 
-// We hold one Arena for each device
-thread_local std::vector<Arena> arenas;
-
-} // namespace
+// We hold one Arena for each device and stream
+thread_local std::vector<std::unordered_map<c10::StreamId, Arena>> arenas;
 
-at::Tensor contigZeroedTensor(
-    const std::vector<int64_t>& sizes,
-    const c10::ScalarType& aten_dtype,
+std::unordered_map<c10::StreamId, Arena>& deviceArenas(
     const c10::Device& device) {
   NVF_ERROR(device.is_cuda(), "contigZeroTensor requires CUDA device");
   // Intermediate cast from int8_t to uint8_t for clarity:
   // https://clang.llvm.org/extra/clang-tidy/checks/bugprone/signed-char-misuse.html
   size_t device_num = (uint8_t)device.index();
 
-  // get arena from device number, resizing arenas if needed
+  // get arenas from device number, resizing arenas if needed
   if (device_num >= arenas.size()) {
     arenas.resize(device_num + 1);
   }
+  return arenas[device_num];
+}
 
-  // request tensor from arena
-  return arenas[device_num].getTensor(sizes, aten_dtype, device);
+} // namespace
+
+at::Tensor contigZeroedTensor(
+    const std::vector<int64_t>& sizes,
+    const c10::ScalarType& aten_dtype,
+    const c10::Device& device) {
+  auto& device_arenas = deviceArenas(device);
+
+  // request tensor from the arena of the current stream
+  const c10::StreamId stream_id =
+      c10::cuda::getCurrentCUDAStream(device.index()).id();
+  return device_arenas[stream_id].getTensor(sizes, aten_dtype, device);
 }
 
 // Note that this does not free allocated zeroed memory, but rather it marks all
 // zeroed memory as available for re-use.
 void releaseZeroedMemory() {
-  for (Arena& a : arenas) {
-    a.reset();
+  for (auto& device_arenas : arenas) {
+    for (auto& [stream_id, a] : device_arenas) {
+      a.reset();
+    }
+  }
+}
+
+int64_t zeroedMemoryHighWaterMark(const c10::Device& device) {
+  int64_t high_water_bytes = 0;
+  for (const auto& [stream_id, a] : deviceArenas(device)) {
+    high_water_bytes = std::max(high_water_bytes, a.highWaterBytes());
   }
+  return high_water_bytes;
 }
 
 } // namespace nvfuser
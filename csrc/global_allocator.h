@@ -12,8 +12,10 @@
 namespace nvfuser {
 
 //! This returns a slice of a thread local at::Tensor that contains all zeroes.
-//! Uses of this memory should always "clean up" by resetting the memory to zero
-//! at the end of the kernel.
+//! Each stream of a device has its own zeroed memory, so the returned slice
+//! may only be used by kernels on the current stream. Uses of this memory
+//! should always "clean up" by resetting the memory to zero at the end of the
+//! kernel.
 at::Tensor contigZeroedTensor(
     const std::vector<int64_t>& sizes,
     const c10::ScalarType& aten_dtype,
@@ -24,4 +26,8 @@ at::Tensor contigZeroedTensor(
 //! memory, but rather it marks all zeroed memory as available for re-use.
 void releaseZeroedMemory();
 
+//! Returns the largest number of zeroed bytes requested by a single launch on
+//! any stream of the given device from the calling thread
+int64_t zeroedMemoryHighWaterMark(const c10::Device& device);
+
 } // namespace nvfuser
@@ -200,21 +200,32 @@ bool validateReductionGrouping(
   return true;
 }
 
-} // namespace
+// Operands of the ReductionOps to group
+struct ReductionsToGroup {
+  std::vector<BinaryOpType> op_types;
+  std::vector<Val*> init_vals;
+  std::vector<Val*> outputs;
+  std::vector<Val*> inputs;
+};
 
-bool groupReductions(
+// Collect the operands of the definitions of reduction_outputs and
+// validate that they can be grouped
+bool collectReductionsToGroup(
     const std::vector<TensorView*>& reduction_outputs,
-    bool error_on_failure) {
+    bool error_on_failure,
+    ReductionsToGroup& reductions) {
   NVF_CHECK(!reduction_outputs.empty(), "No tensor is given");
 
-  auto container = reduction_outputs[0]->container();
-
   const auto num_reductions = reduction_outputs.size();
 
-  std::vector<BinaryOpType> op_types(num_reductions);
-  std::vector<Val*> init_vals(num_reductions);
-  std::vector<Val*> outputs(num_reductions);
-  std::vector<Val*> inputs(num_reductions);
+  auto& op_types = reductions.op_types;
+  auto& init_vals = reductions.init_vals;
+  auto& outputs = reductions.outputs;
+  auto& inputs = reductions.inputs;
+  op_types.resize(num_reductions);
+  init_vals.resize(num_reductions);
+  outputs.resize(num_reductions);
+  inputs.resize(num_reductions);
 
   for (const auto i : c10::irange(num_reductions)) {
     auto reduction_out = reduction_outputs.at(i);
@@ -241,20 +252,40 @@ bool groupReductions(
     inputs.at(i) = rop->in();
   }
 
-  if (!validateReductionGrouping(inputs, outputs, error_on_failure)) {
+  return validateReductionGrouping(inputs, outputs, error_on_failure);
+}
+
+} // namespace
+
+bool groupReductions(
+    const std::vector<TensorView*>& reduction_outputs,
+    bool error_on_failure) {
+  ReductionsToGroup reductions;
+  if (!collectReductionsToGroup(
+          reduction_outputs, error_on_failure, reductions)) {
     return false;
   }
 
   IrBuilder::create<GroupedReductionOp>(
-      container, op_types, init_vals, outputs, inputs);
+      reduction_outputs[0]->container(),
+      reductions.op_types,
+      reductions.init_vals,
+      reductions.outputs,
+      reductions.inputs);
 
-  for (auto output : ir_utils::filterByType<TensorView>(outputs)) {
+  for (auto output : ir_utils::filterByType<TensorView>(reductions.outputs)) {
     output->updateMaxProducerPosition();
   }
 
   return true;
 }
 
+bool canGroupReductions(const std::vector<TensorView*>& reduction_outputs) {
+  ReductionsToGroup reductions;
+  return collectReductionsToGroup(
+      reduction_outputs, /*error_on_failure=*/false, reductions);
+}
+
 #undef GROUP_REDUCTION_CHECK
 
 } // namespace nvfuser
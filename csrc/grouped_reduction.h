@@ -44,4 +44,9 @@ NVF_API bool groupReductions(
     const std::vector<TensorView*>& reduction_outputs,
     bool error_on_failure = true);
 
+//! Return true if groupReductions would group reduction_outputs. The fusion
+//! is not modified.
+NVF_API bool canGroupReductions(
+    const std::vector<TensorView*>& reduction_outputs);
+
 } // namespace nvfuser
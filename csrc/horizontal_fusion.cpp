@@ -0,0 +1,184 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <horizontal_fusion.h>
+
+#include <codegen.h>
+#include <driver_api.h>
+#include <exceptions.h>
+#include <instrumentation.h>
+
+#include <ATen/cuda/CUDAContext.h>
+#include <c10/cuda/CUDAGuard.h>
+#include <c10/util/irange.h>
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+namespace nvfuser {
+
+namespace {
+
+// Kernel parameters are limited to 4KB
+constexpr int64_t max_param_bytes = 4096;
+
+} // namespace
+
+/*static*/ bool HorizontalKernel::canFuse(const FusionExecutor& executor) {
+  if (!executor.hasCompiledKernel()) {
+    return false;
+  }
+  const kir::Kernel* kernel = executor.kernel();
+  const kir::KernelSummary& summary = kernel->summary();
+  if (kernel->topLevelExprs().empty() || !summary.global_allocations.empty() ||
+      !summary.dynamic_smem_allocations.empty() ||
+      !summary.static_smem_allocations.empty() || summary.has_philox_op ||
+      summary.has_block_reductions || summary.has_grid_reductions ||
+      summary.has_block_welford || summary.has_grid_welford ||
+      summary.has_block_broadcasts || summary.has_grid_broadcasts ||
+      summary.has_cooperative_grid_reduction) {
+    return false;
+  }
+  // Opaque parameters, e.g. TMA descriptors, are __grid_constant__, which
+  // can't be passed on to a device function
+  return std::all_of(
+      kernel->parameters().begin(),
+      kernel->parameters().end(),
+      [](Val* param) {
+        return param->isA<TensorView>() ||
+            std::holds_alternative<PrimDataType>(param->dtype().type);
+      });
+}
+
+HorizontalKernel::HorizontalKernel(std::vector<FusionExecutor*> executors)
+    : executors_(std::move(executors)) {
+  NVF_ERROR(
+      executors_.size() > 1,
+      "A horizontal kernel needs at least two kernels");
+  for (auto executor : executors_) {
+    NVF_ERROR(
+        canFuse(*executor),
+        "Kernel can't be part of a horizontal kernel: ",
+        executor->kernelName());
+    NVF_ERROR(
+        executor->kernel()->indexType() ==
+            executors_.front()->kernel()->indexType(),
+        "Kernels of a horizontal kernel must use the same index type");
+  }
+}
+
+void HorizontalKernel::compile(int64_t block_size) {
+  FUSER_PERF_SCOPE("HorizontalKernel::compile");
+  std::vector<const kir::Kernel*> kernels;
+  std::vector<std::string> function_names;
+  for (auto executor : executors_) {
+    kernels.push_back(executor->kernel());
+    function_names.push_back(executor->kernelName());
+  }
+  const std::string kernel_name =
+      executors_.front()->kernelName() + "_horizontal";
+  const PrimDataType index_type = kernels.front()->indexType();
+
+  const std::string code = codegen::generateHorizontalCudaKernel(
+      kernels, function_names, kernel_name);
+  CompileParams compile_params;
+  compile_params.index_type = index_type;
+  compiled_kernel_ = executor_utils::getCompiledKernel(
+      code,
+      executors_.front()->getStructuredCode(code, index_type),
+      kernel_name,
+      kernel_name,
+      compile_params,
+      block_size);
+  compiled_block_size_ = block_size;
+}
+
+void HorizontalKernel::launch(
+    const std::vector<std::optional<FusionExecutor::DeferredLaunch>>&
+        launches,
+    int64_t device_index) {
+  FUSER_PERF_SCOPE("HorizontalKernel::launch");
+  NVF_ERROR(launches.size() == executors_.size());
+
+  // All kernels have to run with the same blocks, and the combined grid and
+  // parameters have to be within their limits
+  const LaunchParams* block = nullptr;
+  int64_t num_blocks = 0;
+  int64_t param_bytes = 0;
+  bool can_combine = true;
+  for (const auto& launch : launches) {
+    if (!launch.has_value()) {
+      can_combine = false;
+      continue;
+    }
+    const LaunchParams& launch_params = launch->launch_params;
+    if (block == nullptr) {
+      block = &launch_params;
+    }
+    can_combine = can_combine && launch_params.smem() == 0 &&
+        launch_params.bdimx() == block->bdimx() &&
+        launch_params.bdimy() == block->bdimy() &&
+        launch_params.bdimz() == block->bdimz();
+    num_blocks += launch_params.gdimx() * launch_params.gdimy() *
+        launch_params.gdimz();
+    // Leave room for the alignment of each parameter and for the grid
+    param_bytes += (int64_t)launch->args.size() +
+        16 * (int64_t)launch->arg_offsets.size() + 16;
+  }
+  can_combine = can_combine && block != nullptr &&
+      num_blocks <= std::numeric_limits<int32_t>::max() &&
+      param_bytes <= max_param_bytes;
+
+  if (!can_combine) {
+    for (auto i : c10::irange(launches.size())) {
+      if (launches[i].has_value()) {
+        executors_[i]->launchDeferred(*launches[i]);
+      }
+    }
+    return;
+  }
+
+  if (compiled_kernel_ == nullptr || block->nThreads() > compiled_block_size_) {
+    compile(block->nThreads());
+  }
+
+  std::vector<std::array<uint32_t, 3>> grid_dims;
+  grid_dims.reserve(launches.size());
+  std::vector<void*> arg_ptrs;
+  for (const auto& launch : launches) {
+    for (auto offset : launch->arg_offsets) {
+      // cuLaunchKernel only reads the arguments
+      arg_ptrs.push_back(const_cast<std::byte*>(launch->args.data() + offset));
+    }
+    const LaunchParams& launch_params = launch->launch_params;
+    grid_dims.push_back(
+        {(uint32_t)launch_params.gdimx(),
+         (uint32_t)launch_params.gdimy(),
+         (uint32_t)launch_params.gdimz()});
+  }
+  for (auto& grid_dim : grid_dims) {
+    arg_ptrs.push_back(grid_dim.data());
+  }
+
+  c10::cuda::CUDAGuard dg((c10::DeviceIndex)device_index);
+  auto stream = at::cuda::getCurrentCUDAStream();
+  NVFUSER_CUDA_SAFE_CALL(cuLaunchKernel(
+      compiled_kernel_->function,
+      (unsigned int)num_blocks,
+      1,
+      1,
+      (unsigned int)block->bdimx(),
+      (unsigned int)block->bdimy(),
+      (unsigned int)block->bdimz(),
+      0,
+      stream,
+      arg_ptrs.data(),
+      nullptr));
+}
+
+} // namespace nvfuser
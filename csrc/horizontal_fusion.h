@@ -0,0 +1,70 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <executor.h>
+#include <executor_utils.h>
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace nvfuser {
+
+//! \class HorizontalKernel
+//! \brief Launches the kernels of several independent segments as a single
+//! kernel, see EnableOption::HorizontalFusion. Segments that only launch a
+//! few blocks each, e.g. the per-parameter updates of an optimizer step,
+//! then share a launch and fill the GPU together.
+//!
+//! The executors run with FusionExecutor::setDeferLaunchFlag, and their
+//! deferred launches are issued by launch. The combined kernel gives each
+//! kernel a consecutive range of its blocks, see
+//! codegen::generateHorizontalCudaKernel. It is compiled on its first
+//! launch. Launches that can't be combined, e.g. because the kernels use
+//! different block sizes for the given inputs, are issued one by one.
+class HorizontalKernel {
+ public:
+  //! Whether the kernel of executor can be part of a horizontal kernel. The
+  //! kernel must not use shared memory, grid communication, random numbers
+  //! or intermediate global buffers.
+  static bool canFuse(const FusionExecutor& executor);
+
+  //! The executors must outlive this object
+  explicit HorizontalKernel(std::vector<FusionExecutor*> executors);
+
+  int64_t numKernels() const {
+    return (int64_t)executors_.size();
+  }
+
+  //! Whether the combined kernel has been compiled, i.e. launched at least
+  //! once
+  bool isCompiled() const {
+    return compiled_kernel_ != nullptr;
+  }
+
+  //! Issues the deferred launches, indexed like the executors, on the
+  //! current stream of device_index. Executors that didn't defer a launch,
+  //! e.g. because kernel launches are disabled, are skipped.
+  void launch(
+      const std::vector<std::optional<FusionExecutor::DeferredLaunch>>&
+          launches,
+      int64_t device_index);
+
+ private:
+  //! Compiles the combined kernel for blocks of block_size threads
+  void compile(int64_t block_size);
+
+ private:
+  std::vector<FusionExecutor*> executors_;
+  std::shared_ptr<executor_utils::CompiledKernel> compiled_kernel_;
+  int64_t compiled_block_size_ = 0;
+};
+
+} // namespace nvfuser
@@ -7,16 +7,50 @@
 // clang-format on
 
 #include <host_ir/executor.h>
+
+#include <expr_evaluator.h>
 #include <ir/utils.h>
+#include <multidevice/communication.h>
+#include <options.h>
+
+#include <c10/cuda/CUDAGraphsC10Utils.h>
+#include <c10/cuda/CUDAGuard.h>
+
+#include <algorithm>
+#include <unordered_set>
 
 namespace nvfuser {
 
 namespace hir {
 
+namespace {
+
+// The Vals read by the body of for_loop before it writes them, other than its
+// index. The carried inputs are read by the first iteration.
+std::vector<Val*> getLoopInputs(ForLoop* for_loop) {
+  std::vector<Val*> inputs = for_loop->carriedInputs();
+  std::unordered_set<Val*> visited(inputs.begin(), inputs.end());
+  visited.insert(for_loop->index());
+  for (auto expr : for_loop->body()) {
+    for (auto input : expr->inputs()) {
+      if (visited.insert(input).second) {
+        inputs.push_back(input);
+      }
+    }
+    visited.insert(expr->outputs().begin(), expr->outputs().end());
+  }
+  return inputs;
+}
+
+} // namespace
+
 HostIrExecutor::HostIrExecutor(
     std::unique_ptr<HostIrContainer> container,
-    HostIrExecutorParams params)
-    : container_(std::move(container)), params_(params){};
+    HostIrExecutorParams params,
+    Communicator* communicator)
+    : container_(std::move(container)),
+      params_(params),
+      communicator_(communicator){};
 
 std::vector<at::Tensor> HostIrExecutor::runWithInput(
     const std::vector<c10::IValue>& inputs) {
@@ -27,11 +61,27 @@ std::vector<at::Tensor> HostIrExecutor::runWithInput(
     val_to_IValue_[container_->inputs().at(input_idx)] = inputs.at(input_idx);
   }
 
+  // The stream current at the start of the run has index 0
+  streams_.clear();
+  streams_.emplace(0, c10::cuda::getCurrentCUDAStream());
+
   // Interpret each instruction in an "eager" way by iterate over the Host Ir
   // Container's top level expression list
   for (auto expr : container_->topLevelExprs()) {
     dispatch(expr);
   }
+  // Make the work posted after the run ordered after the whole program
+  c10::cuda::setCurrentCUDAStream(streams_.at(0));
+  while (!pending_works_.empty()) {
+    waitFor(pending_works_.begin()->first);
+  }
+  for (const auto& [stream_index, stream] : streams_) {
+    if (stream_index != 0) {
+      at::cuda::CUDAEvent event;
+      event.record(stream);
+      event.block(streams_.at(0));
+    }
+  }
 
   // Collect global outputs
   std::vector<at::Tensor> outputs;
@@ -46,6 +96,7 @@ std::vector<at::Tensor> HostIrExecutor::runWithInput(
 void HostIrExecutor::handle(PostOnStream* post) {
   std::vector<c10::IValue> input_IValues;
   for (auto& input : post->inputs()) {
+    waitFor(input);
     NVF_ERROR(
         val_to_IValue_.find(input) != val_to_IValue_.end(),
         "No buffer associated with Val ",
@@ -85,6 +136,281 @@ void HostIrExecutor::handle(PostOnStream* post) {
   }
 }
 
+void HostIrExecutor::handle(ForLoop* for_loop) {
+  const auto start = evaluate(for_loop->start()).as<int64_t>();
+  const auto stop = evaluate(for_loop->stop()).as<int64_t>();
+  if (params_.capture_loops_in_cuda_graph && canCaptureLoop(for_loop)) {
+    runLoopWithCudaGraph(for_loop, start, stop);
+    return;
+  }
+  runLoop(for_loop, start, stop);
+}
+
+void HostIrExecutor::runLoop(ForLoop* for_loop, int64_t start, int64_t stop) {
+  for (auto i : c10::irange(start, stop)) {
+    val_to_IValue_[for_loop->index()] = i;
+    for (auto expr : for_loop->body()) {
+      dispatch(expr);
+    }
+    // The carried outputs are all read before any carried input is rebound,
+    // e.g. to swap two values
+    std::vector<c10::IValue> carried_values;
+    for (auto output : for_loop->carriedOutputs()) {
+      NVF_ERROR(
+          val_to_IValue_.find(output) != val_to_IValue_.end(),
+          "No buffer associated with carried Val ",
+          output,
+          " for handling ",
+          for_loop->toString());
+      carried_values.push_back(val_to_IValue_.at(output));
+    }
+    for (auto idx : c10::irange(carried_values.size())) {
+      val_to_IValue_[for_loop->carriedInputs().at(idx)] =
+          carried_values.at(idx);
+    }
+  }
+}
+
+bool HostIrExecutor::canCaptureLoop(ForLoop* for_loop) const {
+  // The first run has to compile and keep the FusionExecutors, so that
+  // nothing is compiled during capture. FusionExecutorCache may run
+  // segments with ATen functions synchronizing with the host.
+  if (params_.use_fusion_executor_cache || !params_.cache_fusion_executor) {
+    return false;
+  }
+  // Profiling and kernel timing synchronize with the host
+  if (isProfilerEnabled() ||
+      isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose) ||
+      isDebugDumpEnabled(DebugDumpOption::EffectiveBandwidth) ||
+      isOptionEnabled(EnableOption::KernelProfile)) {
+    return false;
+  }
+  // Communications, streams and events can't be captured
+  if (!std::all_of(
+          for_loop->body().begin(), for_loop->body().end(), [](Expr* expr) {
+            return expr->isA<PostOnStream>();
+          })) {
+    return false;
+  }
+  // Scalar inputs other than constants and the index would be baked into
+  // the graph
+  const std::vector<Val*> inputs = getLoopInputs(for_loop);
+  if (!std::all_of(inputs.begin(), inputs.end(), [](Val* input) {
+        return input->isA<TensorView>() || input->isConstScalar();
+      })) {
+    return false;
+  }
+  // Nested capture is not supported
+  return c10::cuda::currentStreamCaptureStatusMayInitCtx() ==
+      c10::cuda::CaptureStatus::None;
+}
+
+void HostIrExecutor::runLoopWithCudaGraph(
+    ForLoop* for_loop,
+    int64_t start,
+    int64_t stop) {
+  std::vector<void*> input_ptrs;
+  for (auto input : getLoopInputs(for_loop)) {
+    if (!input->isA<TensorView>()) {
+      continue;
+    }
+    NVF_ERROR(
+        val_to_IValue_.find(input) != val_to_IValue_.end(),
+        "No buffer associated with Val ",
+        input,
+        " for handling ",
+        for_loop->toString());
+    input_ptrs.push_back(val_to_IValue_.at(input).toTensor().data_ptr());
+  }
+
+  auto it = loop_graphs_.find(for_loop);
+  if (it == loop_graphs_.end() || it->second.start != start ||
+      it->second.stop != stop || it->second.input_ptrs != input_ptrs) {
+    // New bounds or inputs. Run eagerly once so that the FusionExecutors are
+    // compiled outside of capture.
+    LoopGraph& entry = loop_graphs_[for_loop];
+    entry = LoopGraph();
+    entry.start = start;
+    entry.stop = stop;
+    entry.input_ptrs = std::move(input_ptrs);
+    runLoop(for_loop, start, stop);
+    return;
+  }
+
+  LoopGraph& entry = it->second;
+  if (entry.graph == nullptr) {
+    // Capture has to happen on a non-default stream. Make the capture stream
+    // wait for the work already queued on the current stream.
+    c10::cuda::CUDAStream current_stream = c10::cuda::getCurrentCUDAStream();
+    c10::cuda::CUDAStream capture_stream = c10::cuda::getStreamFromPool();
+    at::cuda::CUDAEvent ready_event;
+    ready_event.record(current_stream);
+    ready_event.block(capture_stream);
+
+    auto graph = std::make_unique<at::cuda::CUDAGraph>();
+    {
+      c10::cuda::CUDAStreamGuard stream_guard(capture_stream);
+      graph->capture_begin();
+      runLoop(for_loop, start, stop);
+      graph->capture_end();
+    }
+    entry.graph = std::move(graph);
+
+    entry.bound_vals.clear();
+    std::vector<Val*> bound_vals = for_loop->carriedInputs();
+    bound_vals.push_back(for_loop->index());
+    for (auto expr : for_loop->body()) {
+      bound_vals.insert(
+          bound_vals.end(), expr->outputs().begin(), expr->outputs().end());
+    }
+    for (auto val : bound_vals) {
+      auto bound_it = val_to_IValue_.find(val);
+      if (bound_it != val_to_IValue_.end()) {
+        entry.bound_vals[val] = bound_it->second;
+      }
+    }
+  }
+
+  // Nothing has been executed yet during capture
+  entry.graph->replay();
+  for (const auto& [val, ivalue] : entry.bound_vals) {
+    val_to_IValue_[val] = ivalue;
+  }
+}
+
+void HostIrExecutor::handle(If* if_) {
+  const auto& body =
+      evaluate(if_->predicate()).as<bool>() ? if_->thenBody() : if_->elseBody();
+  for (auto expr : body) {
+    dispatch(expr);
+  }
+}
+
+void HostIrExecutor::handle(SetCurrentStream* set_current_stream) {
+  c10::cuda::setCurrentCUDAStream(getStream(
+      evaluate(set_current_stream->streamIndex()).as<int64_t>()));
+}
+
+void HostIrExecutor::handle(RecordEvent* record_event) {
+  const auto event_index = evaluate(record_event->eventIndex()).as<int64_t>();
+  events_[event_index].record(c10::cuda::getCurrentCUDAStream());
+}
+
+void HostIrExecutor::handle(WaitEvent* wait_event) {
+  const auto event_index = evaluate(wait_event->eventIndex()).as<int64_t>();
+  NVF_ERROR(
+      events_.count(event_index),
+      "Event ",
+      event_index,
+      " is waited for before being recorded");
+  events_.at(event_index).block(c10::cuda::getCurrentCUDAStream());
+}
+
+void HostIrExecutor::handle(Allocate* allocate) {
+  TensorView* buffer = allocate->buffer();
+  std::vector<int64_t> sizes;
+  for (auto id : TensorDomain::noReductions(buffer->getMaybeRFactorDomain())) {
+    sizes.push_back(evaluate(id->extent()).as<int64_t>());
+  }
+  at::Device device = communicator_ != nullptr && communicator_->is_available()
+      ? communicator_->device()
+      : at::Device(at::kCUDA, at::cuda::current_device());
+  val_to_IValue_[buffer] = at::empty(
+      sizes,
+      at::TensorOptions()
+          .dtype(data_type_to_aten(buffer->dtype()))
+          .device(device));
+}
+
+void HostIrExecutor::handle(Deallocate* deallocate) {
+  TensorView* buffer = deallocate->buffer();
+  // The tensor is still in use by the communications posted on it
+  waitFor(buffer);
+  val_to_IValue_.erase(buffer);
+}
+
+void HostIrExecutor::handle(PostCommunication* post) {
+  NVF_ERROR(
+      communicator_ != nullptr && communicator_->is_available(),
+      "A communicator is needed to execute ",
+      post->toString());
+  at::Tensor input_tensor;
+  at::Tensor output_tensor;
+  for (auto [buffer, tensor] :
+       {std::make_pair(post->inputBuffer(), &input_tensor),
+        std::make_pair(post->outputBuffer(), &output_tensor)}) {
+    if (buffer == nullptr) {
+      continue;
+    }
+    waitFor(buffer);
+    NVF_ERROR(
+        val_to_IValue_.find(buffer) != val_to_IValue_.end(),
+        "No buffer associated with Val ",
+        buffer,
+        " for handling ",
+        post->toString());
+    *tensor = val_to_IValue_.at(buffer).toTensor();
+  }
+
+  Communication* communication = post->communication();
+  c10::intrusive_ptr<c10d::Backend> backend =
+      communicator_->getBackendForTeam(
+          communication->params().team, std::nullopt);
+  c10::intrusive_ptr<c10d::Work> work = postSingleCommunication(
+      communication,
+      communicator_->deviceId(),
+      backend,
+      input_tensor,
+      output_tensor);
+  if (work == nullptr) {
+    return;
+  }
+  // Both buffers are in use until the communication completes
+  for (auto buffer : {post->inputBuffer(), post->outputBuffer()}) {
+    if (buffer != nullptr) {
+      pending_works_[buffer].push_back(work);
+    }
+  }
+}
+
+PolymorphicValue HostIrExecutor::evaluate(Val* val) const {
+  ExpressionEvaluator expr_eval;
+  for (const auto& [bound_val, ivalue] : val_to_IValue_) {
+    if (!bound_val->isScalar()) {
+      continue;
+    }
+    if (ivalue.isInt()) {
+      expr_eval.bind(bound_val, ivalue.toInt());
+    } else if (ivalue.isBool()) {
+      expr_eval.bind(bound_val, ivalue.toBool());
+    } else if (ivalue.isDouble()) {
+      expr_eval.bind(bound_val, ivalue.toDouble());
+    }
+  }
+  PolymorphicValue value = expr_eval.evaluate(val);
+  NVF_ERROR(value.hasValue(), "Cannot evaluate ", val->toInlineString());
+  return value;
+}
+
+c10::cuda::CUDAStream HostIrExecutor::getStream(int64_t stream_index) {
+  auto it = streams_.find(stream_index);
+  if (it == streams_.end()) {
+    it = streams_.emplace(stream_index, c10::cuda::getStreamFromPool()).first;
+  }
+  return it->second;
+}
+
+void HostIrExecutor::waitFor(Val* val) {
+  auto it = pending_works_.find(val);
+  if (it == pending_works_.end()) {
+    return;
+  }
+  for (const auto& work : it->second) {
+    work->wait();
+  }
+  pending_works_.erase(it);
+}
+
 } // namespace hir
 
 } // namespace nvfuser
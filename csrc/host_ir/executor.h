@@ -7,11 +7,16 @@
 // clang-format on
 #pragma once
 
+#include <ATen/cuda/CUDAEvent.h>
+#include <ATen/cuda/CUDAGraph.h>
+#include <c10/cuda/CUDAStream.h>
+
 #include <dispatch.h>
 #include <executor.h>
 #include <host_ir/container.h>
 #include <host_ir/host_ir.h>
 #include <kernel_cache.h>
+#include <multidevice/communicator.h>
 
 namespace nvfuser {
 
@@ -41,18 +46,53 @@ struct HostIrExecutorParams {
   // Experimental: whether to cache fusion executor. WAR: avoid recompilation
   // but implicitely assumes that the input shape don't change over iterations
   bool cache_fusion_executor = false;
+  // Experimental: whether to capture the iterations of a ForLoop as a CUDA
+  // graph replayed by the next runs, e.g. the timesteps of a recurrent
+  // network, so that they launch back to back without host overhead. Only
+  // applies to loops of PostOnStreams with cache_fusion_executor=true and
+  // use_fusion_executor_cache=false. Like EnableOption::CudaGraph, the
+  // values computed by a replayed loop are static buffers that are
+  // overwritten by the next replay.
+  bool capture_loops_in_cuda_graph = false;
 };
 
 class HostIrExecutor final : public OptInDispatch {
  public:
+  // communicator is only needed to execute PostCommunications
   HostIrExecutor(
       std::unique_ptr<HostIrContainer> container,
-      HostIrExecutorParams = HostIrExecutorParams());
+      HostIrExecutorParams = HostIrExecutorParams(),
+      Communicator* communicator = nullptr);
   std::vector<at::Tensor> runWithInput(const std::vector<c10::IValue>& inputs);
 
  private:
   using OptInDispatch::handle;
   void handle(PostOnStream* post) override;
+  void handle(ForLoop* for_loop) override;
+  void handle(If* if_) override;
+  void handle(PostCommunication* post) override;
+  void handle(SetCurrentStream* set_current_stream) override;
+  void handle(RecordEvent* record_event) override;
+  void handle(WaitEvent* wait_event) override;
+  void handle(Allocate* allocate) override;
+  void handle(Deallocate* deallocate) override;
+
+  // Runs the iterations of for_loop in [start, stop)
+  void runLoop(ForLoop* for_loop, int64_t start, int64_t stop);
+  // Whether for_loop can run as a CUDA graph, see
+  // HostIrExecutorParams::capture_loops_in_cuda_graph
+  bool canCaptureLoop(ForLoop* for_loop) const;
+  // Runs for_loop eagerly the first time it is run with its bounds and the
+  // buffers of its inputs, captures it the second time and replays it after
+  void runLoopWithCudaGraph(ForLoop* for_loop, int64_t start, int64_t stop);
+
+  // Returns the value of a scalar of the host program, computed from the
+  // scalars bound so far
+  PolymorphicValue evaluate(Val* val) const;
+  // Returns the stream of the given index, see SetCurrentStream
+  c10::cuda::CUDAStream getStream(int64_t stream_index);
+  // wait for the communications posted on val's buffer, if any
+  void waitFor(Val* val);
 
   std::unique_ptr<HostIrContainer> container_;
   HostIrExecutorParams params_;
@@ -61,6 +101,29 @@ class HostIrExecutor final : public OptInDispatch {
   // Cache Fusions, FusionExecutors
   std::unordered_map<PostOnStream*, FusionExecutor> fe_;
   std::unordered_map<PostOnStream*, FusionExecutorCache> fec_;
+  Communicator* communicator_;
+  // The streams and events of the host program, by index. Streams are
+  // cleared at the end of each run.
+  std::unordered_map<int64_t, c10::cuda::CUDAStream> streams_;
+  std::unordered_map<int64_t, at::cuda::CUDAEvent> events_;
+  // Communications that have been posted but not waited for yet, by the
+  // buffers they use
+  std::unordered_map<Val*, std::vector<c10::intrusive_ptr<c10d::Work>>>
+      pending_works_;
+
+  // A CUDA graph capturing all iterations of a ForLoop. The bounds and the
+  // data pointers of the inputs of the loop are baked into the graph, so it
+  // is only valid for those it was captured with.
+  struct LoopGraph {
+    int64_t start = 0;
+    int64_t stop = 0;
+    std::vector<void*> input_ptrs;
+    std::unique_ptr<at::cuda::CUDAGraph> graph;
+    // The values bound by the loop at the end of the capture, allocated from
+    // the private memory pool of graph
+    std::unordered_map<Val*, c10::IValue> bound_vals;
+  };
+  std::unordered_map<ForLoop*, LoopGraph> loop_graphs_;
 };
 
 } // namespace hir
@@ -13,8 +13,13 @@
 #include <ir/printer.h>
 #include <ir/utils.h>
 #include <kernel_ir.h>
+#include <multidevice/communication.h>
 #include <ops/all_ops.h>
 
+#include <c10/util/irange.h>
+
+#include <algorithm>
+
 namespace nvfuser {
 
 namespace hir {
@@ -98,6 +103,269 @@ bool PostOnStream::sameAs(const Statement* other) const {
   return false;
 }
 
+ForLoop::ForLoop(IrBuilderPasskey passkey, Val* index, Val* start, Val* stop)
+    : Expr(passkey, {}, {}, {index, start, stop}) {
+  NVF_ERROR(passkey.ir_container_->isA<hir::HostIrContainer>()); // NOLINT
+  NVF_ERROR(
+      index->isIntegralScalar() && start->isIntegralScalar() &&
+          stop->isIntegralScalar(),
+      "The index and bounds of a loop must be integers");
+}
+
+ForLoop::ForLoop(const ForLoop* src, IrCloner* ir_cloner)
+    : Expr(src, ir_cloner),
+      body_(ir_cloner->clone(src->body_)),
+      carried_inputs_(ir_cloner->clone(src->carried_inputs_)),
+      carried_outputs_(ir_cloner->clone(src->carried_outputs_)) {}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(ForLoop)
+
+void ForLoop::pushBackCarriedVal(Val* input, Val* output) {
+  NVF_ERROR(
+      input->isA<TensorView>() == output->isA<TensorView>() &&
+          input->dtype() == output->dtype(),
+      "A carried value must have the same type as its input: ",
+      input->toString(),
+      " vs ",
+      output->toString());
+  NVF_ERROR(
+      std::find(carried_inputs_.begin(), carried_inputs_.end(), input) ==
+          carried_inputs_.end(),
+      input->toString(),
+      " is already carried by the loop");
+  carried_inputs_.push_back(input);
+  carried_outputs_.push_back(output);
+}
+
+std::string ForLoop::toString(int indent_size) const {
+  int indent_increment = 2;
+  std::stringstream ss;
+  indent(ss, indent_size) << "FOR " << index()->toInlineString() << " in "
+                          << start()->toInlineString() << " : "
+                          << stop()->toInlineString() << ":";
+  for (auto i : c10::irange(carried_inputs_.size())) {
+    ss << (i == 0 ? " carrying " : ", ")
+       << carried_inputs_.at(i)->toInlineString() << " <- "
+       << carried_outputs_.at(i)->toInlineString();
+  }
+  ss << "{\n";
+  for (auto expr : body()) {
+    ss << expr->toString(indent_size + indent_increment);
+  }
+  indent(ss, indent_size) << "}" << std::endl;
+  return ss.str();
+}
+
+std::string ForLoop::toInlineString(int indent_size) const {
+  return toString(indent_size);
+}
+
+// TODO: implement
+bool ForLoop::sameAs(const Statement* other) const {
+  return false;
+}
+
+PostCommunication::PostCommunication(
+    IrBuilderPasskey passkey,
+    Communication* communication,
+    TensorView* input_buffer,
+    TensorView* output_buffer)
+    : Expr(passkey) {
+  NVF_ERROR(passkey.ir_container_->isA<hir::HostIrContainer>()); // NOLINT
+  NVF_ERROR(
+      input_buffer != nullptr || output_buffer != nullptr,
+      "A communication needs at least one buffer");
+  addAttribute(communication);
+  addAttribute(input_buffer);
+  addAttribute(output_buffer);
+}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(PostCommunication)
+
+Communication* PostCommunication::communication() const {
+  return attributes_.at(0)->as<Communication>();
+}
+
+std::string PostCommunication::toString(int indent_size) const {
+  auto buffer_string = [](TensorView* buffer) -> std::string {
+    return buffer == nullptr ? "none" : buffer->toString();
+  };
+  std::stringstream ss;
+  indent(ss, indent_size) << "Post " << communication()->params().type
+                          << " with input buffer: "
+                          << buffer_string(inputBuffer())
+                          << " and output buffer: "
+                          << buffer_string(outputBuffer()) << std::endl;
+  return ss.str();
+}
+
+std::string PostCommunication::toInlineString(int indent_size) const {
+  return toString(indent_size);
+}
+
+// TODO: implement
+bool PostCommunication::sameAs(const Statement* other) const {
+  return false;
+}
+
+If::If(IrBuilderPasskey passkey, Val* predicate)
+    : Expr(passkey, {}, {}, {predicate}) {
+  NVF_ERROR(passkey.ir_container_->isA<hir::HostIrContainer>()); // NOLINT
+  NVF_ERROR(
+      predicate->dtype() == DataType::Bool,
+      "The predicate of an If must be a boolean");
+}
+
+If::If(const If* src, IrCloner* ir_cloner)
+    : Expr(src, ir_cloner),
+      then_body_(ir_cloner->clone(src->then_body_)),
+      else_body_(ir_cloner->clone(src->else_body_)) {}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(If)
+
+std::string If::toString(int indent_size) const {
+  int indent_increment = 2;
+  std::stringstream ss;
+  indent(ss, indent_size) << "IF " << predicate()->toInlineString() << ":{\n";
+  for (auto expr : thenBody()) {
+    ss << expr->toString(indent_size + indent_increment);
+  }
+  if (!elseBody().empty()) {
+    indent(ss, indent_size) << "} ELSE {\n";
+    for (auto expr : elseBody()) {
+      ss << expr->toString(indent_size + indent_increment);
+    }
+  }
+  indent(ss, indent_size) << "}" << std::endl;
+  return ss.str();
+}
+
+std::string If::toInlineString(int indent_size) const {
+  return toString(indent_size);
+}
+
+// TODO: implement
+bool If::sameAs(const Statement* other) const {
+  return false;
+}
+
+SetCurrentStream::SetCurrentStream(IrBuilderPasskey passkey, Val* stream_index)
+    : Expr(passkey, {}, {}, {stream_index}) {
+  NVF_ERROR(passkey.ir_container_->isA<hir::HostIrContainer>()); // NOLINT
+  NVF_ERROR(stream_index->isIntegralScalar());
+}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(SetCurrentStream)
+
+std::string SetCurrentStream::toString(int indent_size) const {
+  std::stringstream ss;
+  indent(ss, indent_size) << "SetCurrentStream to Stream "
+                          << streamIndex()->toInlineString() << std::endl;
+  return ss.str();
+}
+
+std::string SetCurrentStream::toInlineString(int indent_size) const {
+  return toString(indent_size);
+}
+
+// TODO: implement
+bool SetCurrentStream::sameAs(const Statement* other) const {
+  return false;
+}
+
+RecordEvent::RecordEvent(IrBuilderPasskey passkey, Val* event_index)
+    : Expr(passkey, {}, {}, {event_index}) {
+  NVF_ERROR(passkey.ir_container_->isA<hir::HostIrContainer>()); // NOLINT
+  NVF_ERROR(event_index->isIntegralScalar());
+}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(RecordEvent)
+
+std::string RecordEvent::toString(int indent_size) const {
+  std::stringstream ss;
+  indent(ss, indent_size) << "RecordEvent " << eventIndex()->toInlineString()
+                          << std::endl;
+  return ss.str();
+}
+
+std::string RecordEvent::toInlineString(int indent_size) const {
+  return toString(indent_size);
+}
+
+// TODO: implement
+bool RecordEvent::sameAs(const Statement* other) const {
+  return false;
+}
+
+WaitEvent::WaitEvent(IrBuilderPasskey passkey, Val* event_index)
+    : Expr(passkey, {}, {}, {event_index}) {
+  NVF_ERROR(passkey.ir_container_->isA<hir::HostIrContainer>()); // NOLINT
+  NVF_ERROR(event_index->isIntegralScalar());
+}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(WaitEvent)
+
+std::string WaitEvent::toString(int indent_size) const {
+  std::stringstream ss;
+  indent(ss, indent_size) << "WaitEvent " << eventIndex()->toInlineString()
+                          << std::endl;
+  return ss.str();
+}
+
+std::string WaitEvent::toInlineString(int indent_size) const {
+  return toString(indent_size);
+}
+
+// TODO: implement
+bool WaitEvent::sameAs(const Statement* other) const {
+  return false;
+}
+
+Allocate::Allocate(IrBuilderPasskey passkey, TensorView* buffer)
+    : Expr(passkey, {}, {}, {buffer}) {
+  NVF_ERROR(passkey.ir_container_->isA<hir::HostIrContainer>()); // NOLINT
+}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(Allocate)
+
+std::string Allocate::toString(int indent_size) const {
+  std::stringstream ss;
+  indent(ss, indent_size) << "Allocate " << buffer()->toString() << std::endl;
+  return ss.str();
+}
+
+std::string Allocate::toInlineString(int indent_size) const {
+  return toString(indent_size);
+}
+
+// TODO: implement
+bool Allocate::sameAs(const Statement* other) const {
+  return false;
+}
+
+Deallocate::Deallocate(IrBuilderPasskey passkey, TensorView* buffer)
+    : Expr(passkey, {}, {}, {buffer}) {
+  NVF_ERROR(passkey.ir_container_->isA<hir::HostIrContainer>()); // NOLINT
+}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(Deallocate)
+
+std::string Deallocate::toString(int indent_size) const {
+  std::stringstream ss;
+  indent(ss, indent_size) << "Deallocate " << buffer()->toString()
+                          << std::endl;
+  return ss.str();
+}
+
+std::string Deallocate::toInlineString(int indent_size) const {
+  return toString(indent_size);
+}
+
+// TODO: implement
+bool Deallocate::sameAs(const Statement* other) const {
+  return false;
+}
+
 } // namespace hir
 
 } // namespace nvfuser
@@ -113,6 +113,327 @@ class PostOnStream : public Expr {
   }
 };
 
+/*
+  ForLoop represents the host instruction of executing its body for each value
+  of its index in [start, stop), e.g. to iterate over the microbatches of a
+  pipeline. The index is a scalar Val of the host program, which can be
+  passed to the HostUnits of the body, e.g. to select the microbatch they
+  process. start and stop are either constants or inputs of the host program.
+
+  A loop can also carry values across its iterations, e.g. the hidden and
+  cell states of a recurrent network over the timesteps of a sequence:
+  FOR t in 0 : T: carrying c <- c_next
+    c_next = Fusion0 (x, t, c)
+  The carried input c is bound before the loop, e.g. as an input of the host
+  program. At the end of each iteration, c is rebound to the value of c_next,
+  so that after the loop both hold the value of the last iteration.
+*/
+class ForLoop : public Expr {
+ public:
+  using Expr::Expr;
+  ForLoop(IrBuilderPasskey passkey, Val* index, Val* start, Val* stop);
+  ForLoop(const ForLoop* src, IrCloner* ir_cloner);
+
+  ForLoop(const ForLoop& other) = delete;
+  ForLoop& operator=(const ForLoop& other) = delete;
+  ForLoop(ForLoop&& other) = delete;
+  ForLoop& operator=(ForLoop&& other) = delete;
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+  const char* getOpString() const override {
+    return "hir::ForLoop";
+  }
+
+  bool sameAs(const Statement* other) const override;
+
+  Val* index() const {
+    return attributeVal(0);
+  }
+
+  Val* start() const {
+    return attributeVal(1);
+  }
+
+  Val* stop() const {
+    return attributeVal(2);
+  }
+
+  const std::vector<Expr*>& body() const {
+    return body_;
+  }
+
+  void pushBackBody(Expr* expr) {
+    body_.push_back(expr);
+  }
+
+  // Vals rebound at the end of each iteration to the value of the
+  // corresponding carried output
+  const std::vector<Val*>& carriedInputs() const {
+    return carried_inputs_;
+  }
+
+  const std::vector<Val*>& carriedOutputs() const {
+    return carried_outputs_;
+  }
+
+  void pushBackCarriedVal(Val* input, Val* output);
+
+ private:
+  std::vector<Expr*> body_;
+  std::vector<Val*> carried_inputs_;
+  std::vector<Val*> carried_outputs_;
+};
+
+/*
+  PostCommunication represents the host instruction of posting a network
+  Communication on the tensors that are bound at runtime to its input and
+  output buffers. Either buffer is nullptr if the device has none in the
+  Communication, e.g. the output buffer of the sender of a SendRecv. The
+  output buffer is written in place, so it must be produced earlier in the
+  host program, e.g. as an input of the program.
+
+  Posting doesn't wait for the Communication: the instructions that use the
+  buffers wait for it, so that the instructions in between overlap with it.
+*/
+class PostCommunication : public Expr {
+ public:
+  using Expr::Expr;
+  PostCommunication(
+      IrBuilderPasskey passkey,
+      Communication* communication,
+      TensorView* input_buffer,
+      TensorView* output_buffer);
+
+  PostCommunication(const PostCommunication& other) = delete;
+  PostCommunication& operator=(const PostCommunication& other) = delete;
+  PostCommunication(PostCommunication&& other) = delete;
+  PostCommunication& operator=(PostCommunication&& other) = delete;
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+  const char* getOpString() const override {
+    return "hir::PostCommunication";
+  }
+
+  bool sameAs(const Statement* other) const override;
+
+  Communication* communication() const;
+
+  TensorView* inputBuffer() const {
+    return attributes_.at(1) == nullptr ? nullptr
+                                        : attributes_.at(1)->as<TensorView>();
+  }
+
+  TensorView* outputBuffer() const {
+    return attributes_.at(2) == nullptr ? nullptr
+                                        : attributes_.at(2)->as<TensorView>();
+  }
+};
+
+/*
+  If represents the host instruction of executing its then body if its
+  predicate, a boolean scalar of the host program, is true, and its else body
+  otherwise. The predicate can be computed from the other scalars of the
+  program, e.g. from the index of a surrounding ForLoop.
+*/
+class If : public Expr {
+ public:
+  using Expr::Expr;
+  If(IrBuilderPasskey passkey, Val* predicate);
+  If(const If* src, IrCloner* ir_cloner);
+
+  If(const If& other) = delete;
+  If& operator=(const If& other) = delete;
+  If(If&& other) = delete;
+  If& operator=(If&& other) = delete;
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+  const char* getOpString() const override {
+    return "hir::If";
+  }
+
+  bool sameAs(const Statement* other) const override;
+
+  Val* predicate() const {
+    return attributeVal(0);
+  }
+
+  const std::vector<Expr*>& thenBody() const {
+    return then_body_;
+  }
+
+  const std::vector<Expr*>& elseBody() const {
+    return else_body_;
+  }
+
+  void pushBackThenBody(Expr* expr) {
+    then_body_.push_back(expr);
+  }
+
+  void pushBackElseBody(Expr* expr) {
+    else_body_.push_back(expr);
+  }
+
+ private:
+  std::vector<Expr*> then_body_;
+  std::vector<Expr*> else_body_;
+};
+
+/*
+  SetCurrentStream represents the host instruction of making the stream of the
+  given index current, so that the next kernels and communications are posted
+  on it. Streams are identified by integer scalars of the host program. The
+  stream of index 0 is the one current when the program starts, and the others
+  are taken from the stream pool on first use. The initial stream is current
+  again when the program ends.
+*/
+class SetCurrentStream : public Expr {
+ public:
+  using Expr::Expr;
+  SetCurrentStream(IrBuilderPasskey passkey, Val* stream_index);
+
+  SetCurrentStream(const SetCurrentStream& other) = delete;
+  SetCurrentStream& operator=(const SetCurrentStream& other) = delete;
+  SetCurrentStream(SetCurrentStream&& other) = delete;
+  SetCurrentStream& operator=(SetCurrentStream&& other) = delete;
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+  const char* getOpString() const override {
+    return "hir::SetCurrentStream";
+  }
+
+  bool sameAs(const Statement* other) const override;
+
+  Val* streamIndex() const {
+    return attributeVal(0);
+  }
+};
+
+/*
+  RecordEvent represents the host instruction of recording the event of the
+  given index on the current stream, and WaitEvent the one of making the
+  current stream wait for the last record of the event. Events are identified
+  by integer scalars of the host program.
+*/
+class RecordEvent : public Expr {
+ public:
+  using Expr::Expr;
+  RecordEvent(IrBuilderPasskey passkey, Val* event_index);
+
+  RecordEvent(const RecordEvent& other) = delete;
+  RecordEvent& operator=(const RecordEvent& other) = delete;
+  RecordEvent(RecordEvent&& other) = delete;
+  RecordEvent& operator=(RecordEvent&& other) = delete;
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+  const char* getOpString() const override {
+    return "hir::RecordEvent";
+  }
+
+  bool sameAs(const Statement* other) const override;
+
+  Val* eventIndex() const {
+    return attributeVal(0);
+  }
+};
+
+class WaitEvent : public Expr {
+ public:
+  using Expr::Expr;
+  WaitEvent(IrBuilderPasskey passkey, Val* event_index);
+
+  WaitEvent(const WaitEvent& other) = delete;
+  WaitEvent& operator=(const WaitEvent& other) = delete;
+  WaitEvent(WaitEvent&& other) = delete;
+  WaitEvent& operator=(WaitEvent&& other) = delete;
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+  const char* getOpString() const override {
+    return "hir::WaitEvent";
+  }
+
+  bool sameAs(const Statement* other) const override;
+
+  Val* eventIndex() const {
+    return attributeVal(0);
+  }
+};
+
+/*
+  Allocate represents the host instruction of allocating a tensor for a
+  TensorView of the host program, e.g. the output buffer of a
+  PostCommunication, with the TensorView's data type and its extents, which
+  are either constants or computed from the scalars of the program.
+  Deallocate releases the tensor, so that its memory can be reused by the
+  next allocations.
+*/
+class Allocate : public Expr {
+ public:
+  using Expr::Expr;
+  Allocate(IrBuilderPasskey passkey, TensorView* buffer);
+
+  Allocate(const Allocate& other) = delete;
+  Allocate& operator=(const Allocate& other) = delete;
+  Allocate(Allocate&& other) = delete;
+  Allocate& operator=(Allocate&& other) = delete;
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+  const char* getOpString() const override {
+    return "hir::Allocate";
+  }
+
+  bool sameAs(const Statement* other) const override;
+
+  TensorView* buffer() const {
+    return attributes_.at(0)->as<TensorView>();
+  }
+};
+
+class Deallocate : public Expr {
+ public:
+  using Expr::Expr;
+  Deallocate(IrBuilderPasskey passkey, TensorView* buffer);
+
+  Deallocate(const Deallocate& other) = delete;
+  Deallocate& operator=(const Deallocate& other) = delete;
+  Deallocate(Deallocate&& other) = delete;
+  Deallocate& operator=(Deallocate&& other) = delete;
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+  const char* getOpString() const override {
+    return "hir::Deallocate";
+  }
+
+  bool sameAs(const Statement* other) const override;
+
+  TensorView* buffer() const {
+    return attributes_.at(0)->as<TensorView>();
+  }
+};
+
 } // namespace hir
 
 } // namespace nvfuser
@@ -0,0 +1,64 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <host_ir/pipeline_schedule.h>
+
+#include <algorithm>
+
+namespace nvfuser {
+
+namespace hir {
+
+std::ostream& operator<<(std::ostream& os, PipelinePass pass) {
+  switch (pass) {
+    case PipelinePass::Forward:
+      return os << "F";
+    case PipelinePass::Backward:
+      return os << "B";
+  }
+  return os;
+}
+
+std::ostream& operator<<(std::ostream& os, const PipelineStep& step) {
+  return os << step.pass << step.microbatch;
+}
+
+std::vector<PipelineStep> getOneFOneBSchedule(
+    int64_t num_stages,
+    int64_t stage,
+    int64_t num_microbatches) {
+  NVF_CHECK(
+      num_stages > 0 && stage >= 0 && stage < num_stages,
+      "Invalid stage ",
+      stage,
+      " of a pipeline of ",
+      num_stages,
+      " stages");
+  NVF_CHECK(num_microbatches >= 0, "Invalid number of microbatches");
+
+  const int64_t num_warmup =
+      std::min(num_stages - stage - 1, num_microbatches);
+  std::vector<PipelineStep> steps;
+  steps.reserve(2 * num_microbatches);
+  int64_t next_forward = 0;
+  int64_t next_backward = 0;
+  for (; next_forward < num_warmup; next_forward++) {
+    steps.push_back({PipelinePass::Forward, next_forward});
+  }
+  for (; next_forward < num_microbatches; next_forward++, next_backward++) {
+    steps.push_back({PipelinePass::Forward, next_forward});
+    steps.push_back({PipelinePass::Backward, next_backward});
+  }
+  for (; next_backward < num_microbatches; next_backward++) {
+    steps.push_back({PipelinePass::Backward, next_backward});
+  }
+  return steps;
+}
+
+} // namespace hir
+
+} // namespace nvfuser
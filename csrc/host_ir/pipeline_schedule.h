@@ -0,0 +1,62 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <exceptions.h>
+#include <visibility.h>
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace nvfuser {
+
+namespace hir {
+
+// The passes a pipeline stage runs on each microbatch
+enum class PipelinePass { Forward, Backward };
+
+std::ostream& operator<<(std::ostream& os, PipelinePass pass);
+
+// One step of a pipeline stage: running a pass on a microbatch
+struct PipelineStep {
+  PipelinePass pass;
+  int64_t microbatch;
+
+  bool operator==(const PipelineStep& other) const {
+    return pass == other.pass && microbatch == other.microbatch;
+  }
+};
+
+std::ostream& operator<<(std::ostream& os, const PipelineStep& step);
+
+/*
+  Returns the steps the given stage of a pipeline runs, in order, with the
+  one-forward-one-backward (1F1B) schedule:
+    *) warmup: the stage runs the forward pass of the first
+       min(num_stages - stage - 1, num_microbatches) microbatches, to fill the
+       pipeline;
+    *) steady state: it alternates the forward pass of the next microbatch and
+       the backward pass of the oldest one;
+    *) cooldown: it runs the remaining backward passes.
+  Compared to running all the forward passes first, a stage then holds the
+  activations of at most num_stages microbatches instead of all of them.
+
+  The host program of a stage is built by lowering each step to the
+  PostOnStream of the pass's HostUnit, preceded by the PostCommunication
+  receiving its input from the neighboring stage and followed by the one
+  sending its output, so that the transfers overlap with the next steps.
+*/
+NVF_API std::vector<PipelineStep> getOneFOneBSchedule(
+    int64_t num_stages,
+    int64_t stage,
+    int64_t num_microbatches);
+
+} // namespace hir
+
+} // namespace nvfuser
@@ -0,0 +1,272 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <id_model/indexing.h>
+
+#include <device_lower/lower2device.h>
+#include <index_compute.h>
+#include <ir/builder.h>
+#include <ir/utils.h>
+
+#include <c10/util/irange.h>
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace nvfuser {
+
+namespace {
+
+// Partial splits and swizzles are left to the ComputeAtMap-based indexing
+bool isSupportedIndexingExpr(Expr* expr) {
+  if (auto split = dynamic_cast<Split*>(expr)) {
+    return split->startOffset()->isZeroInt() &&
+        split->stopOffset()->isZeroInt();
+  }
+  return expr->isOneOf<Merge, Resize>();
+}
+
+} // namespace
+
+TensorIndexer::TensorIndexer(IdModel& id_model) : id_model_(id_model) {
+  id_model_.maybeBuildGraph(IdMappingMode::EXACT);
+  id_model_.maybeBuildGraph(IdMappingMode::LOOP);
+}
+
+std::optional<TensorIndexer::IndexingPath> TensorIndexer::computePath(
+    TensorView* tv,
+    const TensorView* consumer_tv) const {
+  IndexingPath path;
+  std::unordered_set<ValGroup> known_groups;
+  std::vector<IterDomain*> to_visit;
+  for (IterDomain* leaf_id : consumer_tv->getLeafDomain()) {
+    // Broadcast loops are not materialized, and their index is zero
+    if (leaf_id->isBroadcast()) {
+      continue;
+    }
+    if (!loopGraph().hasGroup(leaf_id)) {
+      return std::nullopt;
+    }
+    const ValGroup& loop_group = loopGraph().toGroup(leaf_id);
+    IterDomain* promoted_id = leaf_id;
+    auto promotion_it = id_model_.loopPromotionMap().find(loop_group);
+    if (promotion_it != id_model_.loopPromotionMap().end()) {
+      promoted_id = promotion_it->second;
+    }
+    if (!exactGraph().hasGroup(promoted_id)) {
+      return std::nullopt;
+    }
+    const ValGroup& exact_group = exactGraph().toGroup(promoted_id);
+    path.loop_groups.emplace_back(loop_group, exact_group);
+    known_groups.insert(exact_group);
+    to_visit.push_back(promoted_id);
+  }
+
+  std::vector<ValGroup> alloc_groups;
+  for (IterDomain* id : tv->getMaybeAllocationDomain()) {
+    if (id->isReduction() || id->isBroadcast() || id->isStride()) {
+      continue;
+    }
+    if (!exactGraph().hasGroup(id)) {
+      return std::nullopt;
+    }
+    alloc_groups.push_back(exactGraph().toGroup(id));
+    to_visit.push_back(id);
+  }
+
+  // The exprs in the histories of the loop and allocation domains, which
+  // connect through the root domains mapped between tv and its consumer
+  ExprGroups candidates;
+  std::unordered_set<IterDomain*> visited;
+  while (!to_visit.empty()) {
+    IterDomain* id = to_visit.back();
+    to_visit.pop_back();
+    if (!visited.insert(id).second || id->definition() == nullptr) {
+      continue;
+    }
+    Expr* def = id->definition();
+    if (!exactGraph().hasGroup(def)) {
+      return std::nullopt;
+    }
+    candidates.pushBack(exactGraph().toGroup(def));
+    for (auto inp : ir_utils::filterByType<IterDomain>(def->inputs())) {
+      to_visit.push_back(inp);
+    }
+  }
+
+  auto all_known = [&](const std::vector<ValGroup>& groups) {
+    return std::all_of(groups.begin(), groups.end(), [&](const ValGroup& g) {
+      return known_groups.count(g) != 0;
+    });
+  };
+
+  // Backward steps from the loop domains are preferred, forward steps only
+  // reach the domains that are not in the history of the loop domains
+  std::unordered_set<ExprGroup> used;
+  bool progress = true;
+  while (progress) {
+    progress = false;
+    for (bool backward : {true, false}) {
+      for (const ExprGroup& expr_group : candidates) {
+        Expr* expr = expr_group->front();
+        if (used.count(expr_group) != 0 || !isSupportedIndexingExpr(expr)) {
+          continue;
+        }
+        std::vector<ValGroup> from = backward
+            ? exactGraph().outputGroups(expr_group)
+            : exactGraph().inputGroups(expr_group);
+        std::vector<ValGroup> to = backward
+            ? exactGraph().inputGroups(expr_group)
+            : exactGraph().outputGroups(expr_group);
+        if (!all_known(from) || all_known(to)) {
+          continue;
+        }
+        path.steps.push_back({expr_group, backward});
+        used.insert(expr_group);
+        known_groups.insert(to.begin(), to.end());
+        progress = true;
+      }
+      if (progress) {
+        break;
+      }
+    }
+  }
+
+  if (!all_known(alloc_groups)) {
+    return std::nullopt;
+  }
+  return path;
+}
+
+Val* TensorIndexer::getLoopIndex(
+    const ValGroup& loop_group,
+    const ValGroup& exact_group,
+    const std::vector<kir::ForLoop*>& loops) const {
+  for (kir::ForLoop* loop : loops) {
+    IterDomain* loop_id = loop->iter_domain();
+    if (!loopGraph().hasGroup(loop_id) ||
+        loopGraph().toGroup(loop_id) != loop_group) {
+      continue;
+    }
+    // The loop must iterate over the promoted domain
+    if (!exactGraph().hasGroup(loop_id) ||
+        exactGraph().toGroup(loop_id) != exact_group) {
+      return nullptr;
+    }
+    return loop->indexOrStartIfTrivial();
+  }
+  return nullptr;
+}
+
+Val* TensorIndexer::getLinearIndex(
+    TensorView* tv,
+    const TensorView* consumer_tv,
+    const std::vector<kir::ForLoop*>& loops) {
+  if (tv->getMemoryType() != MemoryType::Global) {
+    return nullptr;
+  }
+  if (std::any_of(loops.begin(), loops.end(), [](kir::ForLoop* loop) {
+        return loop->doubleBufferLoopStage() !=
+            DoubleBufferLoopStage::NotApplicable ||
+            loop->vectorize_shift() != nullptr;
+      })) {
+    return nullptr;
+  }
+
+  auto [it, inserted] = paths_[tv].try_emplace(consumer_tv);
+  if (inserted) {
+    it->second = computePath(tv, consumer_tv);
+  }
+  if (!it->second.has_value()) {
+    return nullptr;
+  }
+  const IndexingPath& path = it->second.value();
+
+  std::unordered_map<ValGroup, Val*> index_map;
+  for (const auto& [loop_group, exact_group] : path.loop_groups) {
+    Val* index = getLoopIndex(loop_group, exact_group, loops);
+    if (index == nullptr) {
+      return nullptr;
+    }
+    index_map.emplace(exact_group, index);
+  }
+
+  auto index_of = [&](IterDomain* id) {
+    return index_map.at(exactGraph().toGroup(id));
+  };
+  auto set_index = [&](IterDomain* id, Val* index) {
+    index_map.emplace(exactGraph().toGroup(id), index);
+  };
+  for (const IndexingStep& step : path.steps) {
+    Expr* expr = step.expr_group->front();
+    if (auto split = dynamic_cast<Split*>(expr)) {
+      Val* inner_extent = split->inner()->getMaybeExpandedExtent();
+      if (step.backward) {
+        set_index(
+            split->in(),
+            SimplifyingIrBuilder::addExpr(
+                SimplifyingIrBuilder::mulExpr(
+                    index_of(split->outer()), inner_extent),
+                index_of(split->inner())));
+      } else {
+        Val* in_index = index_of(split->in());
+        set_index(
+            split->outer(),
+            SimplifyingIrBuilder::divExpr(in_index, inner_extent));
+        set_index(
+            split->inner(),
+            SimplifyingIrBuilder::modExpr(in_index, inner_extent));
+      }
+    } else if (auto merge = dynamic_cast<Merge*>(expr)) {
+      Val* inner_extent = merge->inner()->getMaybeExpandedExtent();
+      if (step.backward) {
+        Val* out_index = index_of(merge->out());
+        set_index(
+            merge->outer(),
+            SimplifyingIrBuilder::divExpr(out_index, inner_extent));
+        set_index(
+            merge->inner(),
+            SimplifyingIrBuilder::modExpr(out_index, inner_extent));
+      } else {
+        set_index(
+            merge->out(),
+            SimplifyingIrBuilder::addExpr(
+                SimplifyingIrBuilder::mulExpr(
+                    index_of(merge->outer()), inner_extent),
+                index_of(merge->inner())));
+      }
+    } else {
+      auto resize = expr->as<Resize>();
+      if (step.backward) {
+        set_index(
+            resize->in(),
+            SimplifyingIrBuilder::subExpr(
+                index_of(resize->out()), resize->leftExpand()));
+      } else {
+        set_index(
+            resize->out(),
+            SimplifyingIrBuilder::addExpr(
+                index_of(resize->in()), resize->leftExpand()));
+      }
+    }
+  }
+
+  const auto& alloc_dom = tv->getMaybeAllocationDomain();
+  const std::vector<Val*> strides = Index::getStrides(tv);
+  Val* linear_index = GpuLower::current()->kernel()->zeroVal();
+  for (auto i : c10::irange(alloc_dom.size())) {
+    IterDomain* id = alloc_dom[i];
+    if (id->isReduction() || id->isBroadcast() || id->isStride()) {
+      continue;
+    }
+    linear_index = SimplifyingIrBuilder::addExpr(
+        linear_index, SimplifyingIrBuilder::mulExpr(index_of(id), strides[i]));
+  }
+  return linear_index;
+}
+
+} // namespace nvfuser
@@ -0,0 +1,107 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <id_model/id_model.h>
+#include <ir/all_nodes.h>
+#include <kernel_ir.h>
+#include <val_graph.h>
+
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace nvfuser {
+
+// Index computation on the graphs of an IdModel instead of the replays of
+// ComputeAtMap. The index of a tensor accessed by an expression is
+// computed as follows:
+//
+// 1. Each leaf domain of the consumer of the expression is in a group of
+//    the LOOP graph, whose promoted domain is the domain of a loop of the
+//    loop nest. The index of the exact group of the promoted domain is the
+//    index of that loop.
+//
+// 2. The indices are propagated through the Split, Merge and Resize exprs
+//    of the EXACT graph until every allocation domain of the tensor has an
+//    index, backward from the loop domains and then forward to the
+//    allocation domains, e.g., for a producer transformed differently from
+//    its consumer. The index of a group is computed once per tensor access,
+//    regardless of how many paths lead to it.
+//
+// 3. The linear index is the sum of the indices of the allocation domains
+//    multiplied by their strides.
+//
+// The traversal path of each pair of tensor and consumer is computed once
+// and reused by the loop nests that access the tensor again, e.g., the
+// loops of predicates and of the prologue and epilogue of a kernel.
+//
+// Only global tensors are indexed so far. Accesses that need the special
+// handling of the ComputeAtMap-based indexing, such as circular buffering,
+// rotated loops, overridden indices and swizzles, are not supported, in
+// which case getLinearIndex returns nullptr and the existing indexing is
+// used.
+class TensorIndexer {
+ public:
+  TensorIndexer(IdModel& id_model);
+
+  // Returns the linear index of tv in expressions of consumer_tv nested in
+  // loops, or nullptr if the access is not supported. tv is either a
+  // producer of consumer_tv or consumer_tv itself.
+  Val* getLinearIndex(
+      TensorView* tv,
+      const TensorView* consumer_tv,
+      const std::vector<kir::ForLoop*>& loops);
+
+ private:
+  // An ExprGroup of the EXACT graph to propagate indices through, from its
+  // outputs to its inputs if backward
+  struct IndexingStep {
+    ExprGroup expr_group;
+    bool backward = true;
+  };
+
+  // The LOOP groups of the leaf domains of a consumer and the EXACT groups
+  // of their promoted domains to start from, and the steps to reach the
+  // allocation domains of a tensor
+  struct IndexingPath {
+    std::vector<std::pair<ValGroup, ValGroup>> loop_groups;
+    std::vector<IndexingStep> steps;
+  };
+
+  // Computes the path from the loop domains of consumer_tv to the
+  // allocation domains of tv, or nullopt if some can't be reached
+  std::optional<IndexingPath> computePath(
+      TensorView* tv,
+      const TensorView* consumer_tv) const;
+
+  // Returns the index of the loop of loop_group, or nullptr if no loop
+  // materializes it with a domain of exact_group
+  Val* getLoopIndex(
+      const ValGroup& loop_group,
+      const ValGroup& exact_group,
+      const std::vector<kir::ForLoop*>& loops) const;
+
+  const ValGraph& exactGraph() const {
+    return id_model_.idGraph(IdMappingMode::EXACT);
+  }
+
+  const ValGraph& loopGraph() const {
+    return id_model_.idGraph(IdMappingMode::LOOP);
+  }
+
+  IdModel& id_model_;
+  // Memoized paths by tensor and consumer
+  std::unordered_map<
+      const TensorView*,
+      std::unordered_map<const TensorView*, std::optional<IndexingPath>>>
+      paths_;
+};
+
+} // namespace nvfuser
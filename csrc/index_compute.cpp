@@ -2418,8 +2418,16 @@ Val* Index::getProducerStridedIndices(
   }
 
   if (producer->getMemoryType() == MemoryType::Global) {
-    auto index = sumVals(getGlobalProducerStridedIndices(
-        producer, consumer, loops, rotated_loops, override_index));
+    Val* index = nullptr;
+    TensorIndexer* indexer = GpuLower::current()->tensorIndexer();
+    if (indexer != nullptr && rotated_loops.empty() &&
+        override_index.empty()) {
+      index = indexer->getLinearIndex(producer, consumer, loops);
+    }
+    if (index == nullptr) {
+      index = sumVals(getGlobalProducerStridedIndices(
+          producer, consumer, loops, rotated_loops, override_index));
+    }
     if (generate_pointer) {
       return SimplifyingIrBuilder::addExpr(
           IrBuilder::baseAddressExpr(producer), index);
@@ -2500,8 +2508,16 @@ Val* Index::getConsumerStridedIndices(
   }
 
   if (consumer->getMemoryType() == MemoryType::Global) {
-    auto index = sumVals(getGlobalConsumerStridedIndices(
-        consumer, loops, rotated_loops, override_index));
+    Val* index = nullptr;
+    TensorIndexer* indexer = GpuLower::current()->tensorIndexer();
+    if (indexer != nullptr && rotated_loops.empty() &&
+        override_index.empty()) {
+      index = indexer->getLinearIndex(consumer, consumer, loops);
+    }
+    if (index == nullptr) {
+      index = sumVals(getGlobalConsumerStridedIndices(
+          consumer, loops, rotated_loops, override_index));
+    }
     if (generate_pointer) {
       return SimplifyingIrBuilder::addExpr(
           IrBuilder::baseAddressExpr(consumer), index);
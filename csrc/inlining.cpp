@@ -6,10 +6,15 @@
  */
 // clang-format on
 #include <inlining.h>
+#include <ir/cloner.h>
 #include <ir/utils.h>
 #include <root_domain_map.h>
+#include <scheduler/utils.h>
 #include <transform_iter.h>
 
+#include <algorithm>
+#include <any>
+#include <optional>
 #include <utility>
 
 namespace nvfuser {
@@ -21,15 +26,41 @@ MaxPosCalculator::MaxPosCalculator(
   buildUnmappableDims(compute_at_only);
 }
 
+namespace {
+
+// Unmappable dims of a fusion, which only depend on the root and rfactor
+// domains of its tensors, so they are kept valid across split, merge and
+// reorder by caching them as fusion managed data with the version of the
+// tensor graph they were built for.
+struct UnmappableDimsCache {
+  int64_t tensor_graph_version = -1;
+  std::unordered_set<IterDomain*> unmappable_dims;
+};
+
+constexpr char kUnmappableDimsCacheKey[] = "MaxPosCalculator::unmappable_dims";
+
+} // namespace
+
 void MaxPosCalculator::buildUnmappableDims(bool compute_at_only) {
   // When used for computeAt only, i.e., without inlining storeAt
   // positions, the restriction below does not apply
   if (compute_at_only) {
     return;
   }
+  Fusion* fusion = FusionGuard::getCurFusion();
+  const int64_t tensor_graph_version = fusion->tensorGraphVersion();
+  if (fusion->hasManaged(kUnmappableDimsCacheKey)) {
+    const auto& cache =
+        fusion->getManaged<UnmappableDimsCache>(kUnmappableDimsCacheKey);
+    if (cache.tensor_graph_version == tensor_graph_version) {
+      unmappable_dims_ = cache.unmappable_dims;
+      return;
+    }
+  }
+
   ComputeAtRootDomainMap root_map;
   root_map.build();
-  auto all_tvs = ir_utils::allTvs(FusionGuard::getCurFusion());
+  auto all_tvs = ir_utils::allTvs(fusion);
   for (auto tv : all_tvs) {
     auto consumers = ir_utils::consumerTvsOf(tv);
     for (auto consumer : consumers) {
@@ -46,6 +77,13 @@ void MaxPosCalculator::buildUnmappableDims(bool compute_at_only) {
       }
     }
   }
+
+  // The cache is not carried over to copies of the fusion, as they may not
+  // contain all of the unmappable dims
+  fusion->manage(
+      kUnmappableDimsCacheKey,
+      UnmappableDimsCache{tensor_graph_version, unmappable_dims_},
+      [](IrCloner&, std::any) -> std::any { return UnmappableDimsCache(); });
 }
 
 bool MaxPosCalculator::isAllowedID(
@@ -200,6 +238,113 @@ void inlineMost(
 
 namespace {
 
+// Per-thread registers of the buffer of tv if it is inlined at pos, or
+// nullopt if they are not known at scheduling time
+std::optional<int64_t> bufferRegisters(TensorView* tv, int64_t pos) {
+  if (tv->getMemoryType() != MemoryType::Local) {
+    return 0;
+  }
+  int64_t numel = 1;
+  for (auto i : c10::irange(pos, (int64_t)tv->nDims())) {
+    IterDomain* id = tv->axis(i);
+    if (id->isThread() || id->isDeviceDim() || id->isBroadcast() ||
+        id->isReduction() || id->isStride()) {
+      continue;
+    }
+    if (!id->extent()->isConstInt()) {
+      return std::nullopt;
+    }
+    numel *= id->extent()->evaluate().as<int64_t>();
+  }
+  return ceilDiv(
+      numel * (int64_t)dataTypeSize(tv->dtype()),
+      scheduler_utils::bytes_per_register);
+}
+
+// The position of the first serial broadcast of tv within max_pos that a
+// consumer resolves, i.e., whose loop would repeat the computation of tv
+std::optional<int64_t> getRecomputationPos(TensorView* tv, int64_t max_pos) {
+  Expr* def = tv->definition();
+  if (def == nullptr ||
+      def->isOneOf<LoadStoreOp, BroadcastOp, SqueezeOp, ExpandOp, ViewOp>()) {
+    return std::nullopt;
+  }
+  for (auto pos : c10::irange(max_pos)) {
+    IterDomain* id = tv->axis(pos);
+    if (!id->isBroadcast() || id->isThread()) {
+      continue;
+    }
+    for (auto consumer : ir_utils::consumerTvsOf(tv)) {
+      const int64_t consumer_pos =
+          TransformReplay::getMatchedLeafPosWithoutReplayCasP(
+              consumer, tv, pos + 1);
+      if (consumer_pos > 0 &&
+          !consumer->axis(consumer_pos - 1)->isBroadcast()) {
+        return pos;
+      }
+    }
+  }
+  return std::nullopt;
+}
+
+} // namespace
+
+void inlineMostCostAware(
+    const std::vector<TensorView*>& tvs,
+    int64_t max_registers_per_thread,
+    const std::unordered_set<IterDomain*>& uninlinable_ids) {
+  if (tvs.empty()) {
+    return;
+  }
+  MaxPosCalculator calc(uninlinable_ids);
+
+  // Registers of the buffers when inlined most, and the extra registers of
+  // inlining a tensor before its recomputing loop
+  int64_t registers = 0;
+  struct Candidate {
+    TensorView* tv = nullptr;
+    int64_t pos = 0;
+    int64_t extra_registers = 0;
+  };
+  std::vector<Candidate> candidates;
+  for (auto tv : tvs) {
+    const auto max_pos = (int64_t)calc.getMaxPosAll(tv, /*best_effort=*/true);
+    const std::optional<int64_t> inlined_registers =
+        bufferRegisters(tv, max_pos);
+    registers += inlined_registers.value_or(0);
+    const std::optional<int64_t> pos = getRecomputationPos(tv, max_pos);
+    if (!pos.has_value() || !inlined_registers.has_value()) {
+      continue;
+    }
+    if (const std::optional<int64_t> cut_registers =
+            bufferRegisters(tv, pos.value())) {
+      candidates.push_back(
+          {tv, pos.value(), cut_registers.value() - inlined_registers.value()});
+    }
+  }
+  std::stable_sort(
+      candidates.begin(),
+      candidates.end(),
+      [](const Candidate& a, const Candidate& b) {
+        return a.extra_registers < b.extra_registers;
+      });
+
+  std::unordered_map<TensorView*, int64_t> positions;
+  for (const Candidate& candidate : candidates) {
+    if (registers + candidate.extra_registers > max_registers_per_thread) {
+      break;
+    }
+    registers += candidate.extra_registers;
+    positions.emplace(candidate.tv, candidate.pos);
+  }
+  for (auto tv : tvs) {
+    auto it = positions.find(tv);
+    tv->inlineAt(it == positions.end() ? -1 : it->second, true, &calc);
+  }
+}
+
+namespace {
+
 // Find the positions of `selected` tensors that is mapped to the given position
 // in the reference tensor.
 class FindMappedPositions : public MaxInfoSpanningTree::Propagator {
@@ -84,6 +84,24 @@ void inlineMost(
     const std::unordered_set<TensorView*>& tvs,
     const std::unordered_set<IterDomain*>& uninlinable_ids = {});
 
+// Register-cost-aware variant of inlineMost. Inlining a tensor computed by
+// an arithmetic op within the serial loop of a broadcast it has, e.g.,
+//
+//   T2[i0, b1, i2] = exp(T1[i0, b1, i2])
+//   T3[i0, i1, i2] = T2 * T0
+//
+// repeats its computation for each iteration of the loop of i1. Such
+// tensors are inlined right before the loop of the broadcast instead, as
+// long as the per-thread registers of the local buffers of all tensors stay
+// within max_registers_per_thread, starting from the tensors whose buffers
+// grow the least. The registers are estimated from the constant extents of
+// the leaf domains of each buffer, as an upper bound of the values live at
+// the same time, e.g., for a scheduler to keep a target occupancy.
+NVF_API void inlineMostCostAware(
+    const std::vector<TensorView*>& tvs,
+    int64_t max_registers_per_thread,
+    const std::unordered_set<IterDomain*>& uninlinable_ids = {});
+
 // Inline to the position corresponding to the reference position in the
 // reference tensor for all tensors in the current fusion.
 NVF_API void inlineAllAt(
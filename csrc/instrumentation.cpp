@@ -9,6 +9,8 @@
 #include <options.h>
 #include <utils.h>
 
+#include <array>
+
 #ifdef _WIN32
 #include <c10/util/win32-headers.h>
 #else
@@ -19,21 +21,116 @@
 namespace nvfuser {
 namespace inst {
 
+namespace {
+
+unsigned int processId() {
+#ifdef _WIN32
+  return GetCurrentProcessId();
+#else
+  return getpid();
+#endif // _WIN32
+}
+
+unsigned int threadId() {
+#ifdef _WIN32
+  return GetCurrentThreadId();
+#else
+  return std::hash<pthread_t>{}(pthread_self());
+#endif // _WIN32
+}
+
+constexpr std::chrono::milliseconds kDrainInterval(10);
+
+} // namespace
+
+//! Fixed-size record of a traced event. name is a string literal or interned
+//! by Trace::intern.
+struct EventRecord {
+  const char* name = nullptr;
+  Trace::Clock::rep ts = 0;
+  Trace::Clock::rep dur = 0;
+  unsigned int tid = 0;
+  char ph = 0;
+};
+
+//! Single-producer single-consumer ring buffer of the events of a thread. The
+//! thread that owns it pushes, and the drain thread of Trace pops.
+class EventBuffer {
+ public:
+  static constexpr size_t kCapacity = 16384;
+
+  //! Returns the number of events in the buffer after pushing event, or 0 if
+  //! the buffer is full and event is dropped
+  size_t push(const EventRecord& event) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    const size_t tail = tail_.load(std::memory_order_acquire);
+    if (head - tail == kCapacity) {
+      return 0;
+    }
+    events_[head % kCapacity] = event;
+    head_.store(head + 1, std::memory_order_release);
+    return head + 1 - tail;
+  }
+
+  template <typename Func>
+  void pop(const Func& func) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    const size_t head = head_.load(std::memory_order_acquire);
+    for (size_t i = tail; i != head; ++i) {
+      func(events_[i % kCapacity]);
+    }
+    tail_.store(head, std::memory_order_release);
+  }
+
+  bool empty() const {
+    return head_.load(std::memory_order_acquire) ==
+        tail_.load(std::memory_order_acquire);
+  }
+
+  //! Set when the owning thread exits, so another thread can take over the
+  //! buffer once it's drained
+  std::atomic<bool> retired{false};
+
+ private:
+  std::array<EventRecord, kCapacity> events_;
+  std::atomic<size_t> head_{0};
+  std::atomic<size_t> tail_{0};
+};
+
+namespace {
+
+//! The event buffer of the current thread, retired when the thread exits
+struct ThreadEventBuffer {
+  std::shared_ptr<EventBuffer> buffer;
+  unsigned int tid = 0;
+  //! Depth of the scope whose begin event was dropped, so the events in it
+  //! and its end event are dropped too instead of ending another scope
+  int64_t dropped_depth = 0;
+
+  ~ThreadEventBuffer() {
+    if (buffer != nullptr) {
+      buffer->retired.store(true, std::memory_order_release);
+    }
+  }
+};
+
+thread_local ThreadEventBuffer thread_event_buffer;
+
+} // namespace
+
 Trace::Trace() {
   const char* trace_filename = getNvFuserEnv("TRACE");
   if (trace_filename != nullptr) {
     log_file_ = fopen(trace_filename, "w");
     NVF_CHECK(log_file_ != nullptr, "Can't open trace file");
 
-    // Disable the file stream buffering, since it may result
-    // in torn writes in multi-threaded tracing
-    setbuf(log_file_, nullptr);
-
     // Print the trace prologue
     // (including a dummy TRACE_START event)
     fprintf(log_file_, "{\n\"traceEvents\": [\n");
     start_timestamp_ = Clock::now();
-    logEvent('I', "TRACE_START");
+    record('I', "TRACE_START", start_timestamp_);
+
+    drain_thread_ = std::thread([this]() { drainLoop(); });
   }
 
   // Note isOptionDisabled could throw an exception, so this
@@ -45,35 +142,162 @@ Trace::Trace() {
 
 Trace::~Trace() {
   if (log_file_ != nullptr) {
+    {
+      std::lock_guard<std::mutex> guard(drain_mutex_);
+      stop_draining_ = true;
+    }
+    drain_cv_.notify_one();
+    drain_thread_.join();
+    drain();
+
     // Print trace epilogue
-    logEvent('I', "TRACE_END", ' ');
+    const auto now = Clock::now();
+    if (const int64_t dropped = dropped_events_.load()) {
+      fprintf(
+          log_file_,
+          "{ \"name\": \"TRACE_DROPPED_EVENTS\", \"ph\": \"C\", \"pid\": %u, \"ts\": %.0f, \"args\": { \"count\": %lld } },\n",
+          processId(),
+          std::chrono::duration<double>(now - start_timestamp_).count() * 1e6,
+          (long long)dropped);
+    }
+    writeEvent(
+        'I', "TRACE_END", threadId(), now, Clock::duration::zero(), ' ');
     fprintf(log_file_, "],\n\"displayTimeUnit\": \"ms\"\n}\n");
     fclose(log_file_);
   }
 }
 
-void Trace::logEvent(char ph, const char* name, char sep) {
-  const std::chrono::duration<double> d = Clock::now() - start_timestamp_;
-  const double elapsed = d.count() * 1e6;
+void Trace::record(
+    char ph,
+    const char* name,
+    Clock::time_point ts,
+    Clock::duration dur) {
+  if (thread_event_buffer.buffer == nullptr) {
+    thread_event_buffer.buffer = acquireBuffer();
+    thread_event_buffer.tid = threadId();
+  }
+  int64_t& dropped_depth = thread_event_buffer.dropped_depth;
+  if (dropped_depth > 0) {
+    dropped_depth += ph == 'B' ? 1 : (ph == 'E' ? -1 : 0);
+    dropped_events_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  const size_t size = thread_event_buffer.buffer->push(
+      {name,
+       ts.time_since_epoch().count(),
+       dur.count(),
+       thread_event_buffer.tid,
+       ph});
+  if (size == 0) {
+    dropped_depth = ph == 'B' ? 1 : 0;
+    dropped_events_.fetch_add(1, std::memory_order_relaxed);
+  } else if (size == EventBuffer::kCapacity / 2) {
+    drain_cv_.notify_one();
+  }
+}
 
-#ifdef _WIN32
-  const unsigned int pid = GetCurrentProcessId();
-  const unsigned int tid = GetCurrentThreadId();
-#else
-  const unsigned int pid = getpid();
-  const unsigned int tid = std::hash<pthread_t>{}(pthread_self());
-#endif // _WIN32
+const char* Trace::intern(const char* name) {
+  std::lock_guard<std::mutex> guard(names_mutex_);
+  return names_.emplace(name).first->c_str();
+}
+
+std::shared_ptr<EventBuffer> Trace::acquireBuffer() {
+  std::lock_guard<std::mutex> guard(buffers_mutex_);
+  for (const auto& buffer : buffers_) {
+    if (buffer->retired.load(std::memory_order_acquire) && buffer->empty()) {
+      buffer->retired.store(false, std::memory_order_relaxed);
+      return buffer;
+    }
+  }
+  return buffers_.emplace_back(std::make_shared<EventBuffer>());
+}
+
+void Trace::drainLoop() {
+  std::unique_lock<std::mutex> lock(drain_mutex_);
+  while (!stop_draining_) {
+    drain_cv_.wait_for(lock, kDrainInterval);
+    drain();
+  }
+}
+
+void Trace::drain() {
+  std::vector<std::shared_ptr<EventBuffer>> buffers;
+  {
+    std::lock_guard<std::mutex> guard(buffers_mutex_);
+    buffers = buffers_;
+  }
+  for (const auto& buffer : buffers) {
+    buffer->pop([this](const EventRecord& event) {
+      writeEvent(
+          event.ph,
+          event.name,
+          event.tid,
+          Clock::time_point(Clock::duration(event.ts)),
+          Clock::duration(event.dur));
+    });
+  }
+  fflush(log_file_);
+}
 
+void Trace::writeEvent(
+    char ph,
+    const char* name,
+    unsigned int tid,
+    Clock::time_point ts,
+    Clock::duration dur,
+    char sep) {
+  const std::chrono::duration<double> elapsed = ts - start_timestamp_;
+  if (ph == 'X') {
+    fprintf(
+        log_file_,
+        "{ \"name\": \"%s\", \"ph\": \"X\", \"pid\": %u, \"tid\": %u, \"ts\": %.0f, \"dur\": %.0f }%c\n",
+        name,
+        processId(),
+        tid,
+        elapsed.count() * 1e6,
+        std::chrono::duration<double>(dur).count() * 1e6,
+        sep);
+    return;
+  }
   fprintf(
       log_file_,
       "{ \"name\": \"%s\", \"ph\": \"%c\", \"pid\": %u, \"tid\": %u, \"ts\": %.0f }%c\n",
-      name,
+      name != nullptr ? name : "",
       ph,
-      pid,
+      processId(),
       tid,
-      elapsed,
+      elapsed.count() * 1e6,
       sep);
 }
 
+namespace {
+
+thread_local ScopeTimer* current_scope_timer = nullptr;
+
+} // namespace
+
+ScopeTimer::ScopeTimer() : previous_(current_scope_timer) {
+  current_scope_timer = this;
+}
+
+ScopeTimer::~ScopeTimer() {
+  current_scope_timer = previous_;
+}
+
+ScopeTimer* ScopeTimer::current() {
+  return current_scope_timer;
+}
+
+std::unordered_map<std::string, ScopeTimer::Entry> ScopeTimer::entries()
+    const {
+  std::unordered_map<std::string, Entry> merged;
+  for (const auto& [name, entry] : entries_) {
+    auto& merged_entry = merged[name];
+    merged_entry.count += entry.count;
+    merged_entry.total += entry.total;
+  }
+  return merged;
+}
+
 } // namespace inst
 } // namespace nvfuser
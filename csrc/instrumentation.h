@@ -14,12 +14,23 @@
 
 // NOLINTNEXTLINE(modernize-deprecated-headers)
 #include <stdio.h>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 namespace nvfuser {
 namespace inst {
 
+class EventBuffer;
+
 //! An optional record of selected timestamped operations, events and counters
 //!
 //! This class is not intended to be used directly. Instead, the operations
@@ -36,6 +47,11 @@ namespace inst {
 //! An easy way to view traces is to type `about://tracing` in Chrome or
 //! Chromium.
 //!
+//! Tracing threads don't write to the trace file. Each thread records its
+//! events as fixed-size records in a lock-free ring buffer of its own, which a
+//! background thread drains to the trace file. Events of a thread whose buffer
+//! is full are dropped and counted in a final TRACE_DROPPED_EVENTS event.
+//!
 class Trace : public NonCopyable {
  public:
   using Clock = std::chrono::steady_clock;
@@ -48,7 +64,7 @@ class Trace : public NonCopyable {
 
   void beginEvent(const char* name) {
     if (log_file_ != nullptr) {
-      logEvent('B', name);
+      record('B', name, Clock::now());
     }
     if (record_nvtx_range_) {
       nvtxRangePushA(name);
@@ -60,36 +76,141 @@ class Trace : public NonCopyable {
       nvtxRangePop();
     }
     if (log_file_ != nullptr) {
-      logEvent('E', name);
+      record('E', name, Clock::now());
+    }
+  }
+
+  //! Records an event that already finished, e.g. because its name was only
+  //! known at its end. Only goes to the trace file, not to NVTX.
+  void completeEvent(
+      const char* name,
+      Clock::time_point start,
+      Clock::time_point end) {
+    if (log_file_ != nullptr) {
+      record('X', intern(name), start, end - start);
     }
   }
 
+  //! Whether a trace file is being written
+  bool enabled() const {
+    return log_file_ != nullptr;
+  }
+
  private:
   NVF_API Trace();
   NVF_API ~Trace();
 
-  NVF_API void logEvent(char ph, const char* name, char sep = ',');
+  //! Appends an event to the buffer of the calling thread. name must outlive
+  //! the trace, e.g., be a string literal or interned.
+  NVF_API void record(
+      char ph,
+      const char* name,
+      Clock::time_point ts,
+      Clock::duration dur = Clock::duration::zero());
+
+  //! Returns a copy of name that lives as long as the trace
+  NVF_API const char* intern(const char* name);
+
+  //! Returns a buffer retired by an exited thread, or a new one
+  std::shared_ptr<EventBuffer> acquireBuffer();
+
+  //! Writes the recorded events to log_file_ every few milliseconds, or
+  //! sooner when a buffer is half full, until the trace is destroyed
+  void drainLoop();
+
+  //! Writes the events recorded since the last drain to log_file_. Only
+  //! called from the drain thread, or after it has been joined.
+  void drain();
+
+  void writeEvent(
+      char ph,
+      const char* name,
+      unsigned int tid,
+      Clock::time_point ts,
+      Clock::duration dur,
+      char sep = ',');
 
  private:
   FILE* log_file_ = nullptr;
   Clock::time_point start_timestamp_;
   bool record_nvtx_range_ = true;
+
+  std::mutex buffers_mutex_;
+  //! Event buffers of all threads that recorded events
+  std::vector<std::shared_ptr<EventBuffer>> buffers_;
+  std::atomic<int64_t> dropped_events_{0};
+
+  std::mutex names_mutex_;
+  std::unordered_set<std::string> names_;
+
+  std::mutex drain_mutex_;
+  std::condition_variable drain_cv_;
+  bool stop_draining_ = false;
+  std::thread drain_thread_;
+};
+
+//! Accumulates the time the calling thread spends in each FUSER_PERF_SCOPE
+//! while the timer is alive, independently of the trace file, e.g., to break
+//! down the host overhead of a call in a benchmark. Times are inclusive of
+//! nested scopes. Timers of the same thread nest; only the innermost one
+//! records.
+class ScopeTimer : public NonCopyable {
+ public:
+  using Clock = Trace::Clock;
+
+  struct Entry {
+    int64_t count = 0;
+    Clock::duration total = Clock::duration::zero();
+  };
+
+  NVF_API ScopeTimer();
+  NVF_API ~ScopeTimer();
+
+  //! The innermost timer of the calling thread, or nullptr
+  NVF_API static ScopeTimer* current();
+
+  void add(const char* name, Clock::duration dur) {
+    auto& entry = entries_[name];
+    entry.count++;
+    entry.total += dur;
+  }
+
+  //! Accumulated times by scope name
+  NVF_API std::unordered_map<std::string, Entry> entries() const;
+
+  void reset() {
+    entries_.clear();
+  }
+
+ private:
+  ScopeTimer* previous_ = nullptr;
+  //! Keyed by the name pointers, which are mostly string literals
+  std::unordered_map<const char*, Entry> entries_;
 };
 
 //! \internal Automatic scope for a perf marker
 //!   (normally used through the FUSER_PERF_SCOPE macro)
 class TraceScope : public NonCopyable {
  public:
-  explicit TraceScope(const char* event_name) : event_name_(event_name) {
+  explicit TraceScope(const char* event_name)
+      : event_name_(event_name), timer_(ScopeTimer::current()) {
     Trace::instance()->beginEvent(event_name_);
+    if (timer_ != nullptr) {
+      start_ = Trace::Clock::now();
+    }
   }
 
   ~TraceScope() {
+    if (timer_ != nullptr) {
+      timer_->add(event_name_, Trace::Clock::now() - start_);
+    }
     Trace::instance()->endEvent(event_name_);
   }
 
  private:
   const char* event_name_ = nullptr;
+  ScopeTimer* timer_ = nullptr;
+  Trace::Clock::time_point start_;
 };
 
 #define FUSER_MACRO_CONCAT2(a, b) a##b
@@ -11,6 +11,7 @@
 #include <exceptions.h>
 
 #include <ir/builder_passkey.h>
+#include <ir/node_allocator.h>
 #include <polymorphic_value.h>
 #include <type.h>
 #include <utils.h>
@@ -103,6 +104,14 @@ class NVF_API Statement : public NonCopyable, public PolymorphicBase {
   // Cloning constructor
   Statement(const Statement* src, IrCloner* ir_cloner);
 
+  // IR nodes are allocated from pooled slabs, see node_allocator.h
+  static void* operator new(size_t size) {
+    return node_allocator::allocate(size);
+  }
+  static void operator delete(void* ptr, size_t size) noexcept {
+    node_allocator::deallocate(ptr, size);
+  }
+
   // Dispatch functions, definitions in dispatch.cpp
   template <typename T>
   static void dispatch(T handler, Statement*);
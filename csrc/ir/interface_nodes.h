@@ -453,9 +453,11 @@ class NVF_API TensorView : public Val {
   //! Inline the computation of this tensor into a consumer at the given
   //! position. The consumer to compute with is determined when the
   //! fusion is lowered. Specifically, it is the first consumer tensor
-  //! in the topologically ordered dependency graph. Before the
-  //! lowering, its compute-with consumer is considered unresolved,
-  //! which is then resolved by resolveComputeWith below.
+  //! in the topologically ordered dependency graph, together with the
+  //! later consumers computed in the same loops at the compute-with
+  //! position. Before the lowering, its compute-with consumer is
+  //! considered unresolved, which is then resolved by
+  //! resolveComputeWith below.
   //!
   //! The position is relative to its own domain. It is an
   //! error if the position is smaller than the compute-at position. If this
@@ -549,9 +551,7 @@ class NVF_API TensorView : public Val {
   }
 
  protected:
-  void setDomain(TensorDomain* td) {
-    domain_ = td;
-  }
+  void setDomain(TensorDomain* td);
 
  private:
   int64_t wrapDim(int64_t dim) const {
@@ -566,6 +566,12 @@ class NVF_API TensorView : public Val {
 
   void clearComputeWith();
 
+  //! Whether other_consumer is in the loops of consumer between the
+  //! compute-at and compute-with positions of this tensor
+  bool sharesComputeWithLoops(
+      TensorView* consumer,
+      TensorView* other_consumer) const;
+
  private:
   TensorDomain* domain_ = nullptr;
   int64_t compute_at_pos_ = 0;
@@ -312,7 +312,14 @@ class NVF_API UnaryOp : public Expr {
  public:
   using Expr::Expr;
 
-  UnaryOp(IrBuilderPasskey, UnaryOpType type, Val* out, Val* in);
+  //! If approximate is set, a Float out is computed with the fast hardware
+  //! approximation of the op, see approx_func_str
+  UnaryOp(
+      IrBuilderPasskey,
+      UnaryOpType type,
+      Val* out,
+      Val* in,
+      bool approximate = false);
 
   NVFUSER_DECLARE_CLONE_AND_CREATE
 
@@ -339,6 +346,10 @@ class NVF_API UnaryOp : public Expr {
     return attribute<UnaryOpType>(0);
   }
 
+  bool isApproximate() const {
+    return attribute<bool>(1);
+  }
+
  private:
   void printHelper(std::stringstream& ss, std::string input) const;
 };
@@ -933,6 +944,20 @@ class NVF_API ReductionOp : public Expr {
   bool serialGridReductionRequested() const {
     return attribute<bool>(3);
   }
+
+  //! Scheduling method to request that the blocks of this grid reduction
+  //! combine their results with atomic additions into the output, which is
+  //! zero-initialized before the kernel is launched. This avoids the work
+  //! buffer and the grid synchronization of gridReduce, but the order of the
+  //! additions and thus the result is not deterministic. Only valid for sum
+  //! reductions whose output is a fusion output in global memory.
+  void requestAtomicGridReduction(bool value = true) {
+    attribute<bool>(4) = value;
+  }
+
+  bool atomicGridReductionRequested() const {
+    return attribute<bool>(4);
+  }
 };
 
 //! Grouped reduction operation for horizontal fusions. It works like
@@ -2288,4 +2313,387 @@ class MatmulOp : public Expr {
       const std::vector<PolymorphicValue>& inputs) const override;
 };
 
+//! Grouped matmul of variable-sized groups of rows, e.g., the tokens routed
+//! to each expert of a mixture-of-experts layer. It multiplies the rows
+//! [offsets[g-1], offsets[g]) of A [M, K] by B[g] of B [G, K, N], where
+//! offsets [G] holds the end row of each group. Rows of A after the last
+//! group are set to zero in the output [M, N]. Like MatmulOp, it is
+//! expression evaluated without decomposition.
+class GroupedMatmulOp : public Expr {
+ public:
+  using Expr::Expr;
+
+  GroupedMatmulOp(
+      IrBuilderPasskey,
+      Val* out,
+      Val* in_a,
+      Val* in_b,
+      Val* offsets);
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  const char* getOpString() const override {
+    return "GroupedMatmulOp";
+  }
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+
+  Val* out() const {
+    return output(0);
+  }
+
+  Val* inA() const {
+    return input(0);
+  }
+
+  Val* inB() const {
+    return input(1);
+  }
+
+  Val* offsets() const {
+    return input(2);
+  }
+
+  std::vector<PolymorphicValue> evaluate(
+      const ExpressionEvaluator& ee,
+      const std::vector<PolymorphicValue>& inputs) const override;
+};
+
+//! Scaled dot product attention of query [N, H, L, E], key [N, H, S, E] and
+//! value [N, H, S, Ev], computed by the tiled online-softmax (flash attention)
+//! kernels of ATen, which never materialize the [L, S] attention scores.
+//! Outputs the attention [N, H, L, Ev], the logsumexp of the scores
+//! [N, H, L] and the philox seed and offset of the dropout, which are needed
+//! by the backward. It is expression evaluated without decomposition.
+class SdpaFwdOp : public Expr {
+ public:
+  using Expr::Expr;
+
+  SdpaFwdOp(
+      IrBuilderPasskey,
+      TensorView* output,
+      TensorView* log_sumexp,
+      TensorView* philox_seed,
+      TensorView* philox_offset,
+      TensorView* query,
+      TensorView* key,
+      TensorView* value,
+      Val* dropout_p,
+      Val* is_causal,
+      Val* scale);
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  const char* getOpString() const override {
+    return "SdpaFwdOp";
+  }
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+
+  TensorView* attnOut() const {
+    return output(0)->as<TensorView>();
+  }
+
+  TensorView* logSumExp() const {
+    return output(1)->as<TensorView>();
+  }
+
+  TensorView* philoxSeed() const {
+    return output(2)->as<TensorView>();
+  }
+
+  TensorView* philoxOffset() const {
+    return output(3)->as<TensorView>();
+  }
+
+  TensorView* query() const {
+    return input(0)->as<TensorView>();
+  }
+
+  TensorView* key() const {
+    return input(1)->as<TensorView>();
+  }
+
+  TensorView* value() const {
+    return input(2)->as<TensorView>();
+  }
+
+  Val* dropoutP() const {
+    return input(3);
+  }
+
+  Val* isCausal() const {
+    return input(4);
+  }
+
+  Val* scale() const {
+    return input(5);
+  }
+
+  std::vector<PolymorphicValue> evaluate(
+      const ExpressionEvaluator& ee,
+      const std::vector<PolymorphicValue>& inputs) const override;
+};
+
+//! Backward of SdpaFwdOp. It recomputes the attention scores tile by tile
+//! from the logsumexp of the forward instead of loading them, and outputs
+//! the gradients of query, key and value.
+class SdpaBwdOp : public Expr {
+ public:
+  using Expr::Expr;
+
+  SdpaBwdOp(
+      IrBuilderPasskey,
+      TensorView* grad_query,
+      TensorView* grad_key,
+      TensorView* grad_value,
+      TensorView* grad_output,
+      TensorView* query,
+      TensorView* key,
+      TensorView* value,
+      TensorView* output,
+      TensorView* log_sumexp,
+      Val* dropout_p,
+      Val* is_causal,
+      TensorView* philox_seed,
+      TensorView* philox_offset,
+      Val* scale);
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  const char* getOpString() const override {
+    return "SdpaBwdOp";
+  }
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+
+  TensorView* gradQuery() const {
+    return output(0)->as<TensorView>();
+  }
+
+  TensorView* gradKey() const {
+    return output(1)->as<TensorView>();
+  }
+
+  TensorView* gradValue() const {
+    return output(2)->as<TensorView>();
+  }
+
+  TensorView* gradAttn() const {
+    return input(0)->as<TensorView>();
+  }
+
+  TensorView* query() const {
+    return input(1)->as<TensorView>();
+  }
+
+  TensorView* key() const {
+    return input(2)->as<TensorView>();
+  }
+
+  TensorView* value() const {
+    return input(3)->as<TensorView>();
+  }
+
+  TensorView* attnOut() const {
+    return input(4)->as<TensorView>();
+  }
+
+  TensorView* logSumExp() const {
+    return input(5)->as<TensorView>();
+  }
+
+  Val* dropoutP() const {
+    return input(6);
+  }
+
+  Val* isCausal() const {
+    return input(7);
+  }
+
+  TensorView* philoxSeed() const {
+    return input(8)->as<TensorView>();
+  }
+
+  TensorView* philoxOffset() const {
+    return input(9)->as<TensorView>();
+  }
+
+  Val* scale() const {
+    return input(10);
+  }
+
+  std::vector<PolymorphicValue> evaluate(
+      const ExpressionEvaluator& ee,
+      const std::vector<PolymorphicValue>& inputs) const override;
+};
+
+//! Inclusive prefix scan of a tensor along one of its dimensions, e.g.,
+//! cumsum. The output has the same shape as the input: out[..., i, ...] is
+//! the combination of in[..., 0, ...] to in[..., i, ...] by the scan
+//! operator. It is expression evaluated by the scan kernels of ATen.
+class ScanOp : public Expr {
+ public:
+  using Expr::Expr;
+
+  ScanOp(
+      IrBuilderPasskey,
+      ScanOpType op_type,
+      Val* out,
+      Val* in,
+      int64_t dim);
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  const char* getOpString() const override {
+    return "ScanOp";
+  }
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+
+  TensorView* out() const {
+    return output(0)->as<TensorView>();
+  }
+
+  TensorView* in() const {
+    return input(0)->as<TensorView>();
+  }
+
+  ScanOpType getScanOpType() const {
+    return attribute<ScanOpType>(0);
+  }
+
+  //! Position of the scanned dimension in the logical domain of the input,
+  //! ignoring reductions
+  int64_t dim() const {
+    return attribute<int64_t>(1);
+  }
+
+  std::vector<PolymorphicValue> evaluate(
+      const ExpressionEvaluator& ee,
+      const std::vector<PolymorphicValue>& inputs) const override;
+};
+
+//! The k largest or smallest elements of a tensor along one of its
+//! dimensions and their indices in that dimension. Both outputs have the
+//! shape of the input except for the selected dimension, whose extent is k.
+//! It is expression evaluated by the selection kernels of ATen.
+class TopKOp : public Expr {
+ public:
+  using Expr::Expr;
+
+  TopKOp(
+      IrBuilderPasskey,
+      Val* values,
+      Val* indices,
+      Val* in,
+      Val* k,
+      int64_t dim,
+      bool largest,
+      bool sorted);
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  const char* getOpString() const override {
+    return "TopKOp";
+  }
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+
+  TensorView* values() const {
+    return output(0)->as<TensorView>();
+  }
+
+  TensorView* indices() const {
+    return output(1)->as<TensorView>();
+  }
+
+  TensorView* in() const {
+    return input(0)->as<TensorView>();
+  }
+
+  Val* k() const {
+    return input(1);
+  }
+
+  //! Position of the selected dimension in the logical domain of the input,
+  //! ignoring reductions
+  int64_t dim() const {
+    return attribute<int64_t>(0);
+  }
+
+  //! Selects the largest elements if true, the smallest otherwise
+  bool isLargest() const {
+    return attribute<bool>(1);
+  }
+
+  //! Orders the selected elements from the largest if isLargest and from
+  //! the smallest otherwise. The order is unspecified if false.
+  bool isSorted() const {
+    return attribute<bool>(2);
+  }
+
+  std::vector<PolymorphicValue> evaluate(
+      const ExpressionEvaluator& ee,
+      const std::vector<PolymorphicValue>& inputs) const override;
+};
+
+//! The indices that sort a tensor along one of its dimensions, i.e., the
+//! output has the shape of the input and out[..., i, ...] is the index of
+//! the i-th element in the sorted order. It is expression evaluated by the
+//! sort kernels of ATen.
+class ArgsortOp : public Expr {
+ public:
+  using Expr::Expr;
+
+  ArgsortOp(
+      IrBuilderPasskey,
+      Val* out,
+      Val* in,
+      int64_t dim,
+      bool descending,
+      bool stable);
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  const char* getOpString() const override {
+    return "ArgsortOp";
+  }
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+
+  TensorView* out() const {
+    return output(0)->as<TensorView>();
+  }
+
+  TensorView* in() const {
+    return input(0)->as<TensorView>();
+  }
+
+  //! Position of the sorted dimension in the logical domain of the input,
+  //! ignoring reductions
+  int64_t dim() const {
+    return attribute<int64_t>(0);
+  }
+
+  bool isDescending() const {
+    return attribute<bool>(1);
+  }
+
+  //! Keeps the order of equal elements if true
+  bool isStable() const {
+    return attribute<bool>(2);
+  }
+
+  std::vector<PolymorphicValue> evaluate(
+      const ExpressionEvaluator& ee,
+      const std::vector<PolymorphicValue>& inputs) const override;
+};
+
 } // namespace nvfuser
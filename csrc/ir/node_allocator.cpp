@@ -0,0 +1,141 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <ir/node_allocator.h>
+
+#include <options.h>
+
+#include <array>
+#include <mutex>
+#include <new>
+
+namespace nvfuser::node_allocator {
+
+namespace {
+
+constexpr size_t kAlignment = 16;
+constexpr size_t kMaxPooledSize = 1024;
+constexpr size_t kNumSizeClasses = kMaxPooledSize / kAlignment;
+constexpr size_t kSlabSize = 64 * 1024;
+
+struct FreeBlock {
+  FreeBlock* next;
+};
+
+size_t sizeClassOf(size_t size) {
+  return (size + kAlignment - 1) / kAlignment - 1;
+}
+
+//! Nodes must be freed the way they were allocated, so the option is only
+//! read once
+bool usePool() {
+  static const bool use_pool = !isOptionDisabled(DisableOption::IrNodePool);
+  return use_pool;
+}
+
+//! Carves slabs and holds the free blocks of exited threads
+class GlobalPool {
+ public:
+  //! Leaked, so that nodes of static objects can still be freed at exit
+  static GlobalPool& get() {
+    static GlobalPool* pool = new GlobalPool();
+    return *pool;
+  }
+
+  //! Returns a non-empty list of free blocks of the size class
+  FreeBlock* acquire(size_t size_class) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (FreeBlock* list = free_lists_[size_class]) {
+      free_lists_[size_class] = nullptr;
+      return list;
+    }
+    const size_t block_size = (size_class + 1) * kAlignment;
+    char* slab = static_cast<char*>(::operator new(kSlabSize));
+    FreeBlock* list = nullptr;
+    for (size_t i = kSlabSize / block_size; i > 0; --i) {
+      auto block = reinterpret_cast<FreeBlock*>(slab + (i - 1) * block_size);
+      block->next = list;
+      list = block;
+    }
+    return list;
+  }
+
+  void release(size_t size_class, FreeBlock* list) {
+    if (list == nullptr) {
+      return;
+    }
+    FreeBlock* last = list;
+    while (last->next != nullptr) {
+      last = last->next;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    last->next = free_lists_[size_class];
+    free_lists_[size_class] = list;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::array<FreeBlock*, kNumSizeClasses> free_lists_{};
+};
+
+// Trivially destructible, so that they are still usable by the nodes freed
+// after thread_cache_flusher, e.g., of other thread_local objects
+thread_local std::array<FreeBlock*, kNumSizeClasses> thread_free_lists{};
+thread_local bool thread_exited = false;
+
+//! Hands the free blocks of an exiting thread over to the global pool
+struct ThreadCacheFlusher {
+  ~ThreadCacheFlusher() {
+    for (size_t size_class = 0; size_class < kNumSizeClasses; ++size_class) {
+      GlobalPool::get().release(size_class, thread_free_lists[size_class]);
+      thread_free_lists[size_class] = nullptr;
+    }
+    thread_exited = true;
+  }
+};
+
+thread_local ThreadCacheFlusher thread_cache_flusher;
+
+} // namespace
+
+void* allocate(size_t size) {
+  if (!usePool() || size > kMaxPooledSize) {
+    return ::operator new(size);
+  }
+  const size_t size_class = sizeClassOf(size);
+  FreeBlock*& list = thread_free_lists[size_class];
+  if (list == nullptr) {
+    // Registers the flusher of this thread on its first refill
+    static_cast<void>(&thread_cache_flusher);
+    list = GlobalPool::get().acquire(size_class);
+  }
+  FreeBlock* block = list;
+  list = block->next;
+  if (thread_exited) {
+    GlobalPool::get().release(size_class, list);
+    list = nullptr;
+  }
+  return block;
+}
+
+void deallocate(void* ptr, size_t size) noexcept {
+  if (!usePool() || size > kMaxPooledSize) {
+    ::operator delete(ptr);
+    return;
+  }
+  const size_t size_class = sizeClassOf(size);
+  auto block = static_cast<FreeBlock*>(ptr);
+  if (thread_exited) {
+    block->next = nullptr;
+    GlobalPool::get().release(size_class, block);
+    return;
+  }
+  block->next = thread_free_lists[size_class];
+  thread_free_lists[size_class] = block;
+}
+
+} // namespace nvfuser::node_allocator
@@ -0,0 +1,34 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <visibility.h>
+
+#include <cstddef>
+
+namespace nvfuser::node_allocator {
+
+//! Allocates the memory of IR nodes, see Statement::operator new. Nodes are
+//! small and numerous, so allocating each of them with malloc dominates
+//! building, cloning and destroying large fusions, e.g., during
+//! segmentation. Instead, nodes are carved out of 64 KiB slabs, with separate
+//! slabs per 16-byte size class, and freed nodes are kept in per-thread free
+//! lists and reused by the next node of their size class, e.g., of the next
+//! clone of the fusion, so that clearing a container is a sequence of list
+//! pushes.
+//!
+//! Slabs are shared by all containers instead of being owned by one, as
+//! nodes move between containers, e.g., when swapping containers, which
+//! keeps their shortcut vals, and they are never returned to the system.
+//! Nodes larger than 1 KiB, and all nodes if DisableOption::IrNodePool is set
+//! when the first node is allocated, use the global operator new.
+NVF_API void* allocate(size_t size);
+
+NVF_API void deallocate(void* ptr, size_t size) noexcept;
+
+} // namespace nvfuser::node_allocator
@@ -276,6 +276,9 @@ std::vector<PolymorphicValue> ScatterOp::evaluate(
   const auto& index = inputs.at(1).as<at::Tensor>();
   const auto& src = inputs.at(2).as<at::Tensor>();
   auto dimension = dim();
+  if (getScatterOpType() == ScatterOpType::Add) {
+    return {at::scatter_add(input, dimension, index, src)};
+  }
   return {at::scatter(input, dimension, index, src)};
 }
 
@@ -380,11 +383,21 @@ std::vector<PolymorphicValue> EyeOp::evaluate(
 
 NVFUSER_DEFINE_CLONE_AND_CREATE(EyeOp)
 
-UnaryOp::UnaryOp(IrBuilderPasskey passkey, UnaryOpType type, Val* out, Val* in)
+UnaryOp::UnaryOp(
+    IrBuilderPasskey passkey,
+    UnaryOpType type,
+    Val* out,
+    Val* in,
+    bool approximate)
     : Expr(passkey) {
+  NVF_CHECK(
+      !approximate || approx_func_str(type).has_value(),
+      "No approximation of ",
+      type);
   addOutput(out);
   addInput(in);
   addDataAttribute(type);
+  addDataAttribute(approximate);
 }
 
 std::vector<PolymorphicValue> UnaryOp::evaluate(
@@ -508,6 +521,25 @@ std::vector<PolymorphicValue> UnaryOp::evaluate(
     case UnaryOpType::AdjustPartialLdMatrixAddrInTuring16:
       return {in};
       break;
+    case UnaryOpType::FastDivMultiplier:
+    case UnaryOpType::FastDivShift: {
+      // See fastDivMultiplier and fastDivShift in runtime/helpers.cu
+      const auto d = in.as<int64_t>();
+      // Zero-size divisors have no quotients to compute, so any multiplier
+      // works
+      if (d <= 0) {
+        return {(int64_t)0};
+      }
+      int64_t l = 0;
+      while (((int64_t)1 << l) < d) {
+        ++l;
+      }
+      if (getUnaryOpType() == UnaryOpType::FastDivShift) {
+        return {l};
+      }
+      return {((int64_t)1 << 32) * (((int64_t)1 << l) - d) / d + 1};
+      break;
+    }
     case UnaryOpType::Dereference:
       if (*out()->getDataType() == DataType::Float) {
         return {PolymorphicValue((double)*(float*)in)};
@@ -594,6 +626,9 @@ void UnaryOp::printHelper(std::stringstream& ss, std::string input) const {
           in()->getDataType().value(), out()->getDataType().value()));
       NVF_ERROR(cast_str != std::nullopt, "Unsupported Cast");
       ss << cast_str.value();
+    } else if (
+        isApproximate() && out()->getDataType().value() == DataType::Float) {
+      ss << approx_func_str(op_type).value();
     } else {
       ss << op_type;
       if (out()->getDataType().value() == DataType::Float &&
@@ -718,6 +753,11 @@ std::vector<PolymorphicValue> BinaryOp::evaluate(
     case BinaryOpType::Rshift:
       return {lhs >> rhs};
       break;
+    case BinaryOpType::UMulHi:
+      return {(int64_t)(((uint64_t)(uint32_t)lhs.as<int64_t>() *
+                         (uint64_t)(uint32_t)rhs.as<int64_t>()) >>
+                        32)};
+      break;
     case BinaryOpType::Complex:
       return {at::complex(lhs.as<at::Tensor>(), rhs.as<at::Tensor>())};
       break;
@@ -1525,6 +1565,7 @@ ReductionOp::ReductionOp(
   addDataAttribute(reduction_op_type);
   addDataAttribute(is_allreduce);
   addDataAttribute(false); // serial reduction
+  addDataAttribute(false); // atomic reduction
 }
 
 std::string ReductionOp::toString(int indent_size) const {
@@ -4501,4 +4542,378 @@ std::vector<PolymorphicValue> MatmulOp::evaluate(
   return {at::matmul(a, b)};
 }
 
+GroupedMatmulOp::GroupedMatmulOp(
+    IrBuilderPasskey passkey,
+    Val* out,
+    Val* in_a,
+    Val* in_b,
+    Val* offsets)
+    : Expr(passkey) {
+  addOutput(out);
+  addInput(in_a);
+  addInput(in_b);
+  addInput(offsets);
+}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(GroupedMatmulOp)
+
+std::string GroupedMatmulOp::toString(int indent_size) const {
+  std::stringstream ss;
+  indent(ss, indent_size) << out()->toString() << "\n";
+  indent(ss, indent_size + 1) << " = groupedMatmul(" << inA()->toString()
+                              << ",\n";
+  indent(ss, indent_size + 1) << "                 " << inB()->toString()
+                              << ",\n";
+  indent(ss, indent_size + 1) << "                 " << offsets()->toString()
+                              << ")\n";
+  return ss.str();
+}
+
+std::string GroupedMatmulOp::toInlineString(int indent_size) const {
+  NVF_CHECK(false, "Tensor op can not be printed inline");
+}
+
+std::vector<PolymorphicValue> GroupedMatmulOp::evaluate(
+    const ExpressionEvaluator& ee,
+    const std::vector<PolymorphicValue>& inputs) const {
+  const auto a = inputs.at(0).as<at::Tensor>();
+  const auto b = inputs.at(1).as<at::Tensor>();
+  // The group boundaries are needed on the host to slice the groups
+  const auto offsets = inputs.at(2).as<at::Tensor>().to(at::kCPU).to(at::kLong);
+  const int64_t num_groups = b.size(0);
+  NVF_CHECK(
+      offsets.dim() == 1 && offsets.size(0) == num_groups,
+      "Expected ",
+      num_groups,
+      " group offsets, got: ",
+      offsets.sizes());
+  const auto* ends = offsets.data_ptr<int64_t>();
+
+  // Rows after the last group are not computed
+  at::Tensor out = at::zeros({a.size(0), b.size(2)}, a.options());
+  int64_t begin = 0;
+  for (int64_t g : c10::irange(num_groups)) {
+    const int64_t end = ends[g];
+    NVF_CHECK(
+        begin <= end && end <= a.size(0),
+        "Invalid end row of group ",
+        g,
+        ": ",
+        end);
+    if (end > begin) {
+      // Write each group directly into its rows of the output
+      at::Tensor out_rows = out.narrow(0, begin, end - begin);
+      at::matmul_out(out_rows, a.narrow(0, begin, end - begin), b.select(0, g));
+    }
+    begin = end;
+  }
+  return {out};
+}
+
+SdpaFwdOp::SdpaFwdOp(
+    IrBuilderPasskey passkey,
+    TensorView* output,
+    TensorView* log_sumexp,
+    TensorView* philox_seed,
+    TensorView* philox_offset,
+    TensorView* query,
+    TensorView* key,
+    TensorView* value,
+    Val* dropout_p,
+    Val* is_causal,
+    Val* scale)
+    : Expr(passkey) {
+  addOutput(output);
+  addOutput(log_sumexp);
+  addOutput(philox_seed);
+  addOutput(philox_offset);
+  addInput(query);
+  addInput(key);
+  addInput(value);
+  addInput(dropout_p);
+  addInput(is_causal);
+  addInput(scale);
+}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(SdpaFwdOp)
+
+std::string SdpaFwdOp::toString(int indent_size) const {
+  std::stringstream ss;
+  indent(ss, indent_size) << attnOut()->toString() << ",\n";
+  indent(ss, indent_size) << logSumExp()->toString() << ",\n";
+  indent(ss, indent_size) << philoxSeed()->toString() << ",\n";
+  indent(ss, indent_size) << philoxOffset()->toString() << "\n";
+  indent(ss, indent_size + 1) << " = sdpa(" << query()->toString() << ",\n";
+  indent(ss, indent_size + 1) << "        " << key()->toString() << ",\n";
+  indent(ss, indent_size + 1) << "        " << value()->toString() << ",\n";
+  indent(ss, indent_size + 1)
+      << "        dropout_p = " << dropoutP()->toInlineString() << ",\n";
+  indent(ss, indent_size + 1)
+      << "        is_causal = " << isCausal()->toInlineString() << ",\n";
+  indent(ss, indent_size + 1)
+      << "        scale = " << scale()->toInlineString() << ")\n";
+  return ss.str();
+}
+
+std::string SdpaFwdOp::toInlineString(int indent_size) const {
+  NVF_CHECK(false, "Tensor op can not be printed inline");
+}
+
+std::vector<PolymorphicValue> SdpaFwdOp::evaluate(
+    const ExpressionEvaluator& ee,
+    const std::vector<PolymorphicValue>& inputs) const {
+  const auto query = inputs.at(0).as<at::Tensor>();
+  const auto key = inputs.at(1).as<at::Tensor>();
+  const auto value = inputs.at(2).as<at::Tensor>();
+  const auto dropout_p = inputs.at(3).as<double>();
+  const auto is_causal = inputs.at(4).as<bool>();
+  const auto scale = inputs.at(5).as<double>();
+
+  // The cumulative and maximum sequence lengths are only needed for nested
+  // sequences, and the debug mask is not requested
+  auto outputs = at::_scaled_dot_product_flash_attention(
+      query,
+      key,
+      value,
+      dropout_p,
+      is_causal,
+      /*return_debug_mask=*/false,
+      scale);
+  return {
+      std::get<0>(outputs),
+      std::get<1>(outputs),
+      std::get<6>(outputs),
+      std::get<7>(outputs)};
+}
+
+SdpaBwdOp::SdpaBwdOp(
+    IrBuilderPasskey passkey,
+    TensorView* grad_query,
+    TensorView* grad_key,
+    TensorView* grad_value,
+    TensorView* grad_output,
+    TensorView* query,
+    TensorView* key,
+    TensorView* value,
+    TensorView* output,
+    TensorView* log_sumexp,
+    Val* dropout_p,
+    Val* is_causal,
+    TensorView* philox_seed,
+    TensorView* philox_offset,
+    Val* scale)
+    : Expr(passkey) {
+  addOutput(grad_query);
+  addOutput(grad_key);
+  addOutput(grad_value);
+  addInput(grad_output);
+  addInput(query);
+  addInput(key);
+  addInput(value);
+  addInput(output);
+  addInput(log_sumexp);
+  addInput(dropout_p);
+  addInput(is_causal);
+  addInput(philox_seed);
+  addInput(philox_offset);
+  addInput(scale);
+}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(SdpaBwdOp)
+
+std::string SdpaBwdOp::toString(int indent_size) const {
+  std::stringstream ss;
+  indent(ss, indent_size) << gradQuery()->toString() << ",\n";
+  indent(ss, indent_size) << gradKey()->toString() << ",\n";
+  indent(ss, indent_size) << gradValue()->toString() << "\n";
+  indent(ss, indent_size + 1)
+      << " = sdpa_bwd(" << gradAttn()->toString() << ",\n";
+  for (TensorView* tv : {query(), key(), value(), attnOut(), logSumExp()}) {
+    indent(ss, indent_size + 1) << "            " << tv->toString() << ",\n";
+  }
+  indent(ss, indent_size + 1)
+      << "            dropout_p = " << dropoutP()->toInlineString() << ",\n";
+  indent(ss, indent_size + 1)
+      << "            is_causal = " << isCausal()->toInlineString() << ",\n";
+  indent(ss, indent_size + 1)
+      << "            " << philoxSeed()->toString() << ",\n";
+  indent(ss, indent_size + 1)
+      << "            " << philoxOffset()->toString() << ",\n";
+  indent(ss, indent_size + 1)
+      << "            scale = " << scale()->toInlineString() << ")\n";
+  return ss.str();
+}
+
+std::string SdpaBwdOp::toInlineString(int indent_size) const {
+  NVF_CHECK(false, "Tensor op can not be printed inline");
+}
+
+std::vector<PolymorphicValue> SdpaBwdOp::evaluate(
+    const ExpressionEvaluator& ee,
+    const std::vector<PolymorphicValue>& inputs) const {
+  const auto grad_output = inputs.at(0).as<at::Tensor>();
+  const auto query = inputs.at(1).as<at::Tensor>();
+  const auto key = inputs.at(2).as<at::Tensor>();
+  const auto value = inputs.at(3).as<at::Tensor>();
+  const auto output = inputs.at(4).as<at::Tensor>();
+  const auto log_sumexp = inputs.at(5).as<at::Tensor>();
+  const auto dropout_p = inputs.at(6).as<double>();
+  const auto is_causal = inputs.at(7).as<bool>();
+  const auto philox_seed = inputs.at(8).as<at::Tensor>();
+  const auto philox_offset = inputs.at(9).as<at::Tensor>();
+  const auto scale = inputs.at(10).as<double>();
+
+  // The sequences are not nested, so the cumulative sequence lengths are
+  // undefined and the maximum lengths are the sequence lengths
+  auto [grad_query, grad_key, grad_value] =
+      at::_scaled_dot_product_flash_attention_backward(
+          grad_output,
+          query,
+          key,
+          value,
+          output,
+          log_sumexp,
+          /*cum_seq_q=*/at::Tensor(),
+          /*cum_seq_k=*/at::Tensor(),
+          /*max_q=*/query.size(2),
+          /*max_k=*/key.size(2),
+          dropout_p,
+          is_causal,
+          philox_seed,
+          philox_offset,
+          scale);
+  return {grad_query, grad_key, grad_value};
+}
+
+ScanOp::ScanOp(
+    IrBuilderPasskey passkey,
+    ScanOpType op_type,
+    Val* out,
+    Val* in,
+    int64_t dim)
+    : Expr(passkey) {
+  addOutput(out);
+  addInput(in);
+  addDataAttribute(op_type);
+  addDataAttribute(dim);
+}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(ScanOp)
+
+std::string ScanOp::toString(int indent_size) const {
+  std::stringstream ss;
+  indent(ss, indent_size) << out()->toString() << "\n";
+  indent(ss, indent_size + 1) << " = " << getScanOpType() << "( "
+                              << in()->toString() << ", dim = " << dim()
+                              << " )\n";
+  return ss.str();
+}
+
+std::string ScanOp::toInlineString(int indent_size) const {
+  NVF_CHECK(false, "Tensor op can not be printed inline");
+}
+
+std::vector<PolymorphicValue> ScanOp::evaluate(
+    const ExpressionEvaluator& ee,
+    const std::vector<PolymorphicValue>& inputs) const {
+  const auto& in = inputs.at(0).as<at::Tensor>();
+  switch (getScanOpType()) {
+    case ScanOpType::Add:
+      return {at::cumsum(in, dim())};
+    case ScanOpType::Mul:
+      return {at::cumprod(in, dim())};
+    case ScanOpType::Max:
+      return {std::get<0>(at::cummax(in, dim()))};
+    case ScanOpType::Min:
+      return {std::get<0>(at::cummin(in, dim()))};
+    case ScanOpType::LogSumExp:
+      return {at::logcumsumexp(in, dim())};
+    default:
+      NVF_ERROR(false, "Unexpected scan type: ", getScanOpType());
+  }
+}
+
+TopKOp::TopKOp(
+    IrBuilderPasskey passkey,
+    Val* values,
+    Val* indices,
+    Val* in,
+    Val* k,
+    int64_t dim,
+    bool largest,
+    bool sorted)
+    : Expr(passkey) {
+  addOutput(values);
+  addOutput(indices);
+  addInput(in);
+  addInput(k);
+  addDataAttribute(dim);
+  addDataAttribute(largest);
+  addDataAttribute(sorted);
+}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(TopKOp)
+
+std::string TopKOp::toString(int indent_size) const {
+  std::stringstream ss;
+  indent(ss, indent_size) << values()->toString() << ",\n";
+  indent(ss, indent_size) << indices()->toString() << "\n";
+  indent(ss, indent_size + 1)
+      << " = topk( " << in()->toString() << ", k = " << k()->toInlineString()
+      << ", dim = " << dim() << ", largest = " << std::boolalpha
+      << isLargest() << ", sorted = " << isSorted() << " )\n";
+  return ss.str();
+}
+
+std::string TopKOp::toInlineString(int indent_size) const {
+  NVF_CHECK(false, "Tensor op can not be printed inline");
+}
+
+std::vector<PolymorphicValue> TopKOp::evaluate(
+    const ExpressionEvaluator& ee,
+    const std::vector<PolymorphicValue>& inputs) const {
+  const auto& in = inputs.at(0).as<at::Tensor>();
+  const auto k = (int64_t)inputs.at(1);
+  auto [values, indices] = at::topk(in, k, dim(), isLargest(), isSorted());
+  return {values, indices};
+}
+
+ArgsortOp::ArgsortOp(
+    IrBuilderPasskey passkey,
+    Val* out,
+    Val* in,
+    int64_t dim,
+    bool descending,
+    bool stable)
+    : Expr(passkey) {
+  addOutput(out);
+  addInput(in);
+  addDataAttribute(dim);
+  addDataAttribute(descending);
+  addDataAttribute(stable);
+}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(ArgsortOp)
+
+std::string ArgsortOp::toString(int indent_size) const {
+  std::stringstream ss;
+  indent(ss, indent_size) << out()->toString() << "\n";
+  indent(ss, indent_size + 1)
+      << " = argsort( " << in()->toString() << ", dim = " << dim()
+      << ", descending = " << std::boolalpha << isDescending()
+      << ", stable = " << isStable() << " )\n";
+  return ss.str();
+}
+
+std::string ArgsortOp::toInlineString(int indent_size) const {
+  NVF_CHECK(false, "Tensor op can not be printed inline");
+}
+
+std::vector<PolymorphicValue> ArgsortOp::evaluate(
+    const ExpressionEvaluator& ee,
+    const std::vector<PolymorphicValue>& inputs) const {
+  const auto& in = inputs.at(0).as<at::Tensor>();
+  return {at::argsort(in, isStable(), dim(), isDescending())};
+}
+
 } // namespace nvfuser
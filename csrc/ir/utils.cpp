@@ -1099,6 +1099,31 @@ int64_t getVectorizeSize(const TensorView* tv) {
   return 1;
 }
 
+std::optional<std::vector<int64_t>> getPermuteNew2Old(const Expr* expr) {
+  auto ldst = dynamic_cast<const LoadStoreOp*>(expr);
+  if (ldst == nullptr || ldst->opType() != LoadStoreOpType::Set) {
+    return std::nullopt;
+  }
+  auto out = dynamic_cast<TensorView*>(ldst->out());
+  if (out == nullptr || !out->hasRFactor() || out->hasAllocation() ||
+      out->getRootDomain().size() != out->getRFactorDomain().size()) {
+    return std::nullopt;
+  }
+  return computePermutation(out->getRootDomain(), out->getRFactorDomain());
+}
+
+std::optional<std::vector<int64_t>> getConstSizes(const TensorView* tv) {
+  std::vector<int64_t> sizes;
+  for (auto id : TensorDomain::noReductions(tv->getMaybeRFactorDomain())) {
+    Val* extent = id->getMaybeExpandedExtent();
+    if (!extent->isConstInt()) {
+      return std::nullopt;
+    }
+    sizes.push_back(extent->evaluate().as<int64_t>());
+  }
+  return sizes;
+}
+
 } // namespace nvfuser::ir_utils
 
 namespace nvfuser::MmaOpUtils {
@@ -649,4 +649,11 @@ std::optional<std::vector<int64_t>> computePermutation(
   return permutation;
 }
 
+//! Returns new2old of a permute, i.e., a set whose rfactor domain is a
+//! permutation of its root domain. Returns nullopt for any other expr.
+std::optional<std::vector<int64_t>> getPermuteNew2Old(const Expr* expr);
+
+//! Returns the sizes of the logical domain of tv if they are all constant
+std::optional<std::vector<int64_t>> getConstSizes(const TensorView* tv);
+
 } // namespace nvfuser::ir_utils
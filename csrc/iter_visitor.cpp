@@ -822,7 +822,23 @@ class DependencyChains : public IterVisitor {
 } // namespace
 
 bool DependencyCheck::isDependencyOf(Val* dependency, Val* of) {
-  return !DependencyChains::getDependencyChain(dependency, of).empty();
+  // Same as checking if getSingleDependencyChain is empty, but stops as soon
+  // as dependency is found and doesn't build the chain
+  std::unordered_set<Val*> visited;
+  std::vector<Val*> to_visit{of};
+  while (!to_visit.empty()) {
+    Val* val = to_visit.back();
+    to_visit.pop_back();
+    if (val == dependency) {
+      return true;
+    }
+    if (!visited.insert(val).second || val->definition() == nullptr) {
+      continue;
+    }
+    const auto& inputs = val->definition()->inputs();
+    to_visit.insert(to_visit.end(), inputs.begin(), inputs.end());
+  }
+  return false;
 }
 
 std::deque<Val*> DependencyCheck::getSingleDependencyChain(
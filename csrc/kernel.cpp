@@ -6,6 +6,7 @@
  */
 // clang-format on
 #include <debug.h>
+#include <device_lower/analysis/register_pressure.h>
 #include <device_lower/lower2device.h>
 #include <instrumentation.h>
 #include <ir/iostream.h>
@@ -15,6 +16,7 @@
 
 #include <ATen/cuda/CUDAContext.h>
 
+#include <algorithm>
 #include <iostream>
 #include <unordered_set>
 
@@ -98,6 +100,11 @@ class KernelIrScanner : private IrVisitor {
 
   void handle(RNGOp* rng_op) final {
     summary_.has_philox_op = true;
+    // The same op may appear in more than one scope, e.g. of peeled loops
+    auto& rng_ops = summary_.rng_ops;
+    if (std::find(rng_ops.begin(), rng_ops.end(), rng_op) == rng_ops.end()) {
+      rng_ops.push_back(rng_op);
+    }
   }
 
   void handle(TensorIndex* tensor_index) final {
@@ -153,10 +160,11 @@ class KernelIrScanner : private IrVisitor {
 
   void handle(GridReduction* grid_reduction) final {
     // summary.has_grid_reductions is used to determine whether we need a
-    // reduction workspace. Serial grid reductions do not require this
-    // workspace.
-    summary_.has_grid_reductions =
-        grid_reduction->serialReductionTensor() == nullptr;
+    // reduction workspace. Serial and atomic grid reductions do not require
+    // this workspace.
+    if (!grid_reduction->isSerial() && !grid_reduction->isAtomic()) {
+      summary_.has_grid_reductions = true;
+    }
     if (grid_reduction->isAllreduce()) {
       summary_.has_cooperative_grid_reduction = true;
     }
@@ -356,6 +364,9 @@ void Kernel::finalize(std::vector<Expr*> top_level_exprs) {
   summary_.min_device_version = GpuLower::current()->minDeviceVersion();
   summary_.min_device_version_reason =
       GpuLower::current()->minDeviceVersionReason();
+  summary_.cluster_dims = GpuLower::current()->clusterDims();
+  summary_.min_blocks_per_sm = GpuLower::current()->minBlocksPerSm();
+  summary_.estimated_register_usage = estimateRegisterUsage(this);
   parameters_ = GpuLower::current()->allKnownVals();
   parameters_.insert(parameters_.end(), outputs().begin(), outputs().end());
   for (auto alloc : summary_.global_allocations) {
@@ -443,6 +454,21 @@ void KernelPerformanceProfile::registerExpr(const Expr* expr) {
   expr_entry_map_.emplace(expr, slot);
 }
 
+void KernelPerformanceProfile::registerPhases() {
+  if (hasPhases()) {
+    return;
+  }
+  phase_index_ = getNewIndex();
+  for (int64_t i = 1; i < kNumKernelPhases; ++i) {
+    getNewIndex();
+  }
+}
+
+int64_t KernelPerformanceProfile::getPhaseIndexInProfileBuffer() const {
+  NVF_ERROR(hasPhases(), "Kernel phases are not profiled");
+  return phase_index_ * 2;
+}
+
 int64_t KernelPerformanceProfile::getNewIndex() {
   return num_profile_entries_++;
 }
@@ -495,6 +521,32 @@ std::string KernelPerformanceProfile::toString(const at::Tensor& buffer) const {
        << " us, " << count << "\n";
   }
 
+  if (hasPhases()) {
+    // Each warp adds its cycles of each phase and increments its count
+    constexpr std::array<const char*, kNumKernelPhases> phase_names = {
+        "load", "compute", "reduction", "grid sync", "store"};
+    std::array<double, kNumKernelPhases> cycles_per_warp = {};
+    double total_cycles_per_warp = 0.0;
+    for (const auto i : c10::irange(kNumKernelPhases)) {
+      auto index = phase_index_ + i;
+      auto count = buffer[index][1].item<int64_t>();
+      cycles_per_warp[i] = count == 0
+          ? 0.0
+          : static_cast<double>(buffer[index][0].item<int64_t>()) /
+              (double)count;
+      total_cycles_per_warp += cycles_per_warp[i];
+    }
+    ss << "Kernel phases per warp:\n";
+    for (const auto i : c10::irange(kNumKernelPhases)) {
+      ss << phase_names[i] << ", " << cycles_per_warp[i] / kilo_freq * 1000.0
+         << " us, "
+         << (total_cycles_per_warp == 0.0
+                 ? 0.0
+                 : cycles_per_warp[i] / total_cycles_per_warp * 100.0)
+         << " %\n";
+    }
+  }
+
   return ss.str();
 }
 
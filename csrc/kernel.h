@@ -19,6 +19,7 @@
 #include <vectorization_info.h>
 #include <visibility.h>
 
+#include <array>
 #include <memory>
 #include <unordered_map>
 #include <utility>
@@ -45,6 +46,9 @@ struct KernelSummary {
   //! Indicate the need to generate random numbers
   bool has_philox_op = false;
 
+  //! List of RNG ops, each of which keeps its latest philox result
+  std::vector<const RNGOp*> rng_ops;
+
   //! Do we have any block reductions?
   bool has_block_reductions = false;
 
@@ -121,13 +125,48 @@ struct KernelSummary {
 
   //! Plain text description of why min_device_version_ is required
   std::string min_device_version_reason;
+
+  //! Thread block cluster dimensions of the kernel, see
+  //! CompileParams::cluster_dims
+  std::array<int64_t, 3> cluster_dims = {1, 1, 1};
+
+  //! Target occupancy in blocks per SM, see
+  //! CompileParams::min_blocks_per_sm. If positive, the kernel is declared
+  //! with __launch_bounds__, whose arguments are only defined when the
+  //! kernel is compiled for a block size, so that FusionExecutor can
+  //! compile variants of the same code.
+  int64_t min_blocks_per_sm = 0;
+
+  //! Estimated number of registers per thread, see estimateRegisterUsage
+  int64_t estimated_register_usage = 0;
+
+  bool hasClusters() const {
+    return cluster_dims[0] > 1 || cluster_dims[1] > 1 || cluster_dims[2] > 1;
+  }
 };
 
+//! Phases of a kernel whose cycles are accumulated by
+//! NVFUSER_ENABLE=kernel_profile(phases)
+enum class KernelPhase { Load, Compute, Reduction, GridSync, Store };
+constexpr int64_t kNumKernelPhases = 5;
+
 class KernelPerformanceProfile {
  public:
   //! Register an expression to profile
   void registerExpr(const Expr* expr);
 
+  //! Register an entry for each KernelPhase
+  void registerPhases();
+
+  //! Query if the phases of the kernel are profiled
+  bool hasPhases() const {
+    return phase_index_ >= 0;
+  }
+
+  //! Get the index of the cycles of the first phase in the backing buffer.
+  //! Phase i has its cycles at 2 * i and its count at 2 * i + 1 from there.
+  int64_t getPhaseIndexInProfileBuffer() const;
+
   //! Query if an expression is profiled
   bool isProfiled(const Expr* expr) const;
 
@@ -169,6 +208,9 @@ class KernelPerformanceProfile {
   //! Map profiled expressions to profile entry offsets
   std::unordered_map<const Expr*, int64_t> expr_entry_map_;
 
+  //! Entry offset of the first phase, or -1 if phases aren't profiled
+  int64_t phase_index_ = -1;
+
   // TODO: Allow profiling of ForLoops
   //! Map profiled ForLoop to profile entry offsets
   // std::unordered_map<const kir::ForLoop*, int64_t> loop_entry_map_;
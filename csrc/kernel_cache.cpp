@@ -7,6 +7,7 @@
 // clang-format on
 #include <kernel_cache.h>
 
+#include <bandwidth_log.h>
 #include <debug.h>
 #include <driver_api.h>
 #include <dynamic_transform.h>
@@ -15,20 +16,38 @@
 #include <fusion_profiler.h>
 #include <instrumentation.h>
 #include <ir/utils.h>
+#include <kernel_db/heuristic_db.h>
 #include <options.h>
+#include <perf_monitor.h>
 #include <preseg_passes/pre_segmenter.h>
+#include <preseg_passes/remove_unneeded_outputs.h>
+#include <preseg_passes/segment_static_subgraphs.h>
+#include <scheduler/autotune.h>
 #include <scheduler/debug_utils.h>
+#include <scheduler/heuristic_plugin.h>
 #include <scheduler/registry.h>
+#include <scheduler/utils.h>
 #include <torch/csrc/jit/jit_log.h>
 #include <torch/csrc/jit/runtime/graph_executor.h>
 #include <utils.h>
 
+#include <ATen/cuda/CUDAEvent.h>
+#include <c10/cuda/CUDACachingAllocator.h>
+#include <c10/cuda/CUDAGraphsC10Utils.h>
 #include <c10/cuda/CUDAGuard.h>
+#include <c10/cuda/CUDAStream.h>
 #include <c10/util/irange.h>
 #include <torch/csrc/jit/jit_log.h>
 
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <limits>
+#include <memory>
 #include <mutex>
 #include <sstream>
+#include <unordered_set>
 
 namespace nvfuser {
 
@@ -61,6 +80,188 @@ KernelArgumentHolder copyMetadataArg(const KernelArgumentHolder& src) {
   return dst;
 }
 
+// Maps each extent of the tensor arguments to its shape bucket. Without
+// arguments to EnableOption::ShapeBuckets, an extent is in the bucket of the
+// next power of two. Otherwise the arguments are the inclusive upper bounds of
+// the buckets, and extents larger than the last one share one bucket.
+std::vector<int64_t> shapeBucketOf(const KernelArgumentHolder& args) {
+  std::vector<int64_t> bounds;
+  for (const auto& arg :
+       getEnableOptionArguments(EnableOption::ShapeBuckets)) {
+    bounds.push_back(std::stol(arg));
+  }
+  std::sort(bounds.begin(), bounds.end());
+
+  std::vector<int64_t> bucket;
+  for (const auto& arg : args) {
+    if (!arg->is<at::Tensor>()) {
+      continue;
+    }
+    const auto& tensor = arg->as<at::Tensor>();
+    bucket.push_back(tensor.dim());
+    for (int64_t size : tensor.sizes()) {
+      if (size <= 1) {
+        // Empty and broadcast extents are never bucketed with other extents
+        bucket.push_back(size - 2);
+      } else if (bounds.empty()) {
+        int64_t log2_ceil = 0;
+        while ((int64_t)1 << log2_ceil < size) {
+          ++log2_ceil;
+        }
+        bucket.push_back(log2_ceil);
+      } else {
+        bucket.push_back(
+            std::lower_bound(bounds.begin(), bounds.end(), size) -
+            bounds.begin());
+      }
+    }
+  }
+  return bucket;
+}
+
+// Returns everything the heuristics of a kernel runtime depend on of args: the
+// data type, sizes and alignment of each tensor, the strides of its non-size-1
+// dimensions and the value of each scalar. Strides of size-1 dimensions are
+// ignored as they are arbitrary, e.g., in slices and expanded tensors, and
+// don't change the schedule. Returns an empty vector if args has an argument
+// of another type, as it can't be described.
+std::vector<int64_t> heuristicProblemDescriptor(
+    const KernelArgumentHolder& args) {
+  std::vector<int64_t> descriptor;
+  descriptor.push_back(args.getDeviceIndex());
+  for (const auto& arg : args) {
+    if (arg->is<at::Tensor>()) {
+      const auto& tensor = arg->as<at::Tensor>();
+      descriptor.push_back((int64_t)tensor.scalar_type());
+      descriptor.push_back(tensor.dim());
+      for (auto i : c10::irange(tensor.dim())) {
+        descriptor.push_back(tensor.size(i));
+        descriptor.push_back(tensor.size(i) == 1 ? 0 : tensor.stride(i));
+      }
+      descriptor.push_back(
+          tensor.is_cuda()
+              ? (int64_t)SchedulerRuntimeInfo::computeAlignmentSize(
+                    (size_t)tensor.data_ptr())
+              : -1);
+    } else if (arg->is<int64_t>()) {
+      descriptor.push_back(-1);
+      descriptor.push_back(arg->as<int64_t>());
+    } else if (arg->is<bool>()) {
+      descriptor.push_back(-2);
+      descriptor.push_back(arg->as<bool>());
+    } else if (arg->is<double>()) {
+      int64_t bits = 0;
+      double value = arg->as<double>();
+      std::memcpy(&bits, &value, sizeof(bits));
+      descriptor.push_back(-3);
+      descriptor.push_back(bits);
+    } else {
+      return {};
+    }
+  }
+  return descriptor;
+}
+
+// Checks whether a kernel compiled with old_params is also valid for the
+// inputs new_params was computed for. The kernel is reused only if the new
+// parameters differ from the old ones in unrolling factors alone, and the
+// new inputs support at least the old vectorization width. Persistent and
+// other schedules are sensitive to the extents, so they are never reused.
+bool isValidInShapeBucket(
+    const std::shared_ptr<HeuristicParams>& old_params,
+    const std::shared_ptr<HeuristicParams>& new_params) {
+  auto fits = [](bool vectorize, int64_t old_factor, int64_t new_factor) {
+    return !vectorize || new_factor % old_factor == 0;
+  };
+
+  if (auto old_pparams =
+          std::dynamic_pointer_cast<PointwiseParams>(old_params)) {
+    auto new_pparams = std::dynamic_pointer_cast<PointwiseParams>(
+        new_params->clone());
+    if (new_pparams == nullptr ||
+        new_pparams->vectorize != old_pparams->vectorize ||
+        !fits(
+            old_pparams->vectorize,
+            old_pparams->unroll_factor,
+            new_pparams->unroll_factor)) {
+      return false;
+    }
+    new_pparams->unroll_factor = old_pparams->unroll_factor;
+    return old_pparams->sameAs(new_pparams);
+  }
+
+  if (auto old_rparams =
+          std::dynamic_pointer_cast<ReductionParams>(old_params)) {
+    auto new_rparams = std::dynamic_pointer_cast<ReductionParams>(
+        new_params->clone());
+    if (new_rparams == nullptr || old_rparams->persistent_kernel ||
+        new_rparams->persistent_kernel ||
+        new_rparams->vectorize_inner_reduction !=
+            old_rparams->vectorize_inner_reduction ||
+        new_rparams->vectorize_iter_dom != old_rparams->vectorize_iter_dom ||
+        !fits(
+            old_rparams->vectorize_inner_reduction,
+            old_rparams->unroll_factor_inner_reduction,
+            new_rparams->unroll_factor_inner_reduction) ||
+        !fits(
+            old_rparams->vectorize_iter_dom,
+            old_rparams->unroll_factor_iter_dom,
+            new_rparams->unroll_factor_iter_dom)) {
+      return false;
+    }
+    new_rparams->unroll_factor_inner_reduction =
+        old_rparams->unroll_factor_inner_reduction;
+    new_rparams->unroll_factor_iter_dom = old_rparams->unroll_factor_iter_dom;
+    new_rparams->unroll_factor_outer_reduction =
+        old_rparams->unroll_factor_outer_reduction;
+    return old_rparams->sameAs(new_rparams);
+  }
+
+  return false;
+}
+
+// Number of timed launches of each autotuning candidate
+constexpr int64_t autotune_iterations = 10;
+
+int64_t maxAutotuneCandidates() {
+  int64_t max_candidates = 8;
+  const auto& option_args = getEnableOptionArguments(EnableOption::Autotune);
+  if (!option_args.empty()) {
+    try {
+      max_candidates = std::max(std::stol(option_args[0]), 1L);
+    } catch (const std::exception& e) {
+      debug() << "skip invalid argument for Autotune, arg = "
+              << option_args[0] << std::endl;
+    }
+  }
+  return max_candidates;
+}
+
+// Copies tensor, including the elements its strides skip, into a new CUDA
+// tensor, so that benchmarked kernels don't overwrite inputs of the fusion.
+// Metadata tensors, i.e. the outputs of other segments at compile time, get
+// zeros, which are valid indices too.
+at::Tensor copyForBenchmark(const at::Tensor& tensor, int64_t device_index) {
+  int64_t storage_numel = 1;
+  for (auto i : c10::irange(tensor.dim())) {
+    if (tensor.size(i) == 0) {
+      storage_numel = 0;
+      break;
+    }
+    storage_numel += (tensor.size(i) - 1) * tensor.stride(i);
+  }
+  at::Tensor storage = at::empty(
+      {storage_numel},
+      tensor.options().device(
+          c10::Device(c10::DeviceType::CUDA, (c10::DeviceIndex)device_index)));
+  if (tensor.is_meta()) {
+    storage.zero_();
+  } else {
+    storage.copy_(tensor.as_strided({storage_numel}, {1}));
+  }
+  return storage.as_strided(tensor.sizes(), tensor.strides());
+}
+
 // Copy bytes of value to back of buffer. This is templated in order to avoid
 // implicit cast such as int64_t -> size_t that might lose information.
 template <typename T>
@@ -226,6 +427,129 @@ class ArgumentManager {
   }
 };
 
+// Assigns the segments of a FusionKernelRuntime to a pool of CUDA streams so
+// that segments without a dependency between them can run concurrently.
+// Streams are assigned statically from the producer lists in
+// RuntimeWorkSpace: a segment continues on the stream of its first producer
+// if no other consumer has claimed that stream yet, and otherwise starts on
+// the next stream of the pool in round-robin order. Cross-stream
+// dependencies are enforced with events, and all streams are joined back
+// into the current stream at the end.
+//
+// The zeroed memory used for grid synchronization is kept per stream (see
+// contigZeroedTensor), so segments using it can run concurrently as well.
+class SegmentStreamScheduler {
+ public:
+  SegmentStreamScheduler(
+      const RuntimeWorkSpace& runtime_workspace,
+      c10::DeviceIndex device_index,
+      int64_t num_streams)
+      : main_stream_(c10::cuda::getCurrentCUDAStream(device_index)) {
+    NVF_ERROR(num_streams > 0, "Invalid number of streams: ", num_streams);
+    streams_.push_back(main_stream_);
+    for (auto i : c10::irange(1, num_streams)) {
+      (void)i; // Suppress unused variable warning
+      streams_.push_back(c10::cuda::getStreamFromPool(
+          /*isHighPriority=*/false, device_index));
+    }
+
+    const int64_t num_groups =
+        (int64_t)runtime_workspace.group_run_order.size();
+    segment_stream_.resize(num_groups, 0);
+    std::vector<bool> stream_continued(num_groups, false);
+    int64_t next_stream = 0;
+    for (auto run_order_id : c10::irange(num_groups)) {
+      const auto& producers = runtime_workspace.group_producers.at(run_order_id);
+      auto unclaimed_producer = std::find_if(
+          producers.begin(), producers.end(), [&](int64_t producer) {
+            return !stream_continued[producer];
+          });
+      if (unclaimed_producer != producers.end()) {
+        stream_continued[*unclaimed_producer] = true;
+        segment_stream_[run_order_id] = segment_stream_[*unclaimed_producer];
+      } else {
+        segment_stream_[run_order_id] = next_stream;
+        next_stream = (next_stream + 1) % num_streams;
+      }
+    }
+
+    // Side streams must not start before the work already queued on the
+    // current stream, which may produce the fusion inputs.
+    at::cuda::CUDAEvent start_event;
+    start_event.record(main_stream_);
+    for (auto i : c10::irange(1, num_streams)) {
+      start_event.block(streams_.at(i));
+    }
+    segment_done_.resize(num_groups);
+  }
+
+  // Returns the stream the given segment has to be launched on, after
+  // having it wait for its producers running on other streams
+  c10::cuda::CUDAStream beginSegment(
+      int64_t run_order_id,
+      const std::vector<int64_t>& producers,
+      const KernelArgumentHolder& segment_inputs) {
+    c10::cuda::CUDAStream stream = streams_.at(segment_stream_[run_order_id]);
+    bool has_remote_producer = false;
+    for (int64_t producer : producers) {
+      if (segment_stream_[producer] != segment_stream_[run_order_id]) {
+        segment_done_.at(producer).block(stream);
+        has_remote_producer = true;
+      }
+    }
+    if (has_remote_producer) {
+      // Let the caching allocator know the inputs are used on this stream,
+      // so their memory is not reused by the producing stream while this
+      // segment may still read it.
+      for (const auto& input : segment_inputs) {
+        if (input->is<at::Tensor>() && input->as<at::Tensor>().is_cuda()) {
+          recordStream(input->as<at::Tensor>(), stream);
+        }
+      }
+    }
+    return stream;
+  }
+
+  void endSegment(int64_t run_order_id) {
+    segment_done_.at(run_order_id)
+        .record(streams_.at(segment_stream_[run_order_id]));
+  }
+
+  // Make the current stream wait for all segments and mark the given fusion
+  // outputs as used on the current stream
+  void join(const std::vector<at::Tensor>& outputs) {
+    for (auto i : c10::irange(1, (int64_t)streams_.size())) {
+      at::cuda::CUDAEvent done;
+      done.record(streams_.at(i));
+      done.block(main_stream_);
+    }
+    for (const auto& output : outputs) {
+      if (output.defined() && output.is_cuda()) {
+        recordStream(output, main_stream_);
+      }
+    }
+  }
+
+ private:
+  static void recordStream(
+      const at::Tensor& tensor,
+      const c10::cuda::CUDAStream& stream) {
+    if (tensor.has_storage() && tensor.storage().data_ptr()) {
+      c10::cuda::CUDACachingAllocator::recordStream(
+          tensor.storage().data_ptr(), stream);
+    }
+  }
+
+ private:
+  c10::cuda::CUDAStream main_stream_;
+  // streams_[0] is always main_stream_
+  std::vector<c10::cuda::CUDAStream> streams_;
+  // Index into streams_ of each segment in run order
+  std::vector<int64_t> segment_stream_;
+  // Recorded on the segment stream after each segment is launched
+  std::vector<at::cuda::CUDAEvent> segment_done_;
+};
+
 } // namespace
 
 flatbuffers::Offset<serde::InputsIdLookup> InputsIdLookup::serialize(
@@ -235,23 +559,35 @@ flatbuffers::Offset<serde::InputsIdLookup> InputsIdLookup::serialize(
 
   using fb_string = flatbuffers::Offset<flatbuffers::String>;
 
-  // For serialization, we require a consistent ordering for the
-  // encoding_lookup_ map.
-  std::unordered_map<std::string, size_t> str_key_ordering;
+  // For serialization, we require a consistent ordering of the entries. The
+  // LRU list is ordered by recent usage, freshly used entry first.
+  std::vector<const EncodingEntry*> entries;
+  for (const auto& shard : shards_) {
+    std::shared_lock<std::shared_mutex> guard(shard.mutex);
+    for (const auto& [hash, entry] : shard.entries) {
+      entries.push_back(entry.get());
+    }
+  }
+  std::sort(
+      entries.begin(),
+      entries.end(),
+      [](const EncodingEntry* a, const EncodingEntry* b) {
+        return a->last_use.load() > b->last_use.load();
+      });
 
   // 1. Serialize used_entry_ list
   std::vector<fb_string> lru_cache_fb;
-  for (const auto& str : used_entry_) {
-    lru_cache_fb.push_back(builder.CreateString(str));
-    str_key_ordering.emplace(str, str_key_ordering.size());
+  for (const auto* entry : entries) {
+    lru_cache_fb.push_back(builder.CreateString(entry->encoding));
   }
 
   // 2. Serialize encoding_lookup_ map
   std::vector<fb_string> encoding_lookup_keys_fb;
   std::vector<serde::EncodingEntry> encoding_lookup_values_fb;
-  for (auto&& [key, value] : encoding_lookup_) {
-    encoding_lookup_keys_fb.push_back(builder.CreateString(key));
-    encoding_lookup_values_fb.emplace_back(value.id, str_key_ordering.at(key));
+  for (const auto i : c10::irange(entries.size())) {
+    encoding_lookup_keys_fb.push_back(
+        builder.CreateString(entries.at(i)->encoding));
+    encoding_lookup_values_fb.emplace_back(entries.at(i)->id, i);
   }
 
   return serde::CreateInputsIdLookupDirect(
@@ -267,61 +603,113 @@ void InputsIdLookup::deserialize(const serde::InputsIdLookup* buffer) {
   // See definitions in serde/fusion_cache.fbs for tables
   // InputsIdLookup and EncodingEntry
   NVF_ERROR(buffer != nullptr, "serde::InputsIdLookup is nullptr.");
-  using list_iter = std::list<std::string>::iterator;
-  std::vector<list_iter> used_entry_iterators;
+  std::lock_guard<std::mutex> insertion_guard(insertion_mutex_);
 
   max_cache_size_ = buffer->max_cache_size();
   current_id_ = buffer->current_id();
-  for (auto fb_str : *buffer->lru_cache()) {
-    used_entry_.emplace_back(fb_str->str());
-    used_entry_iterators.emplace_back(std::prev(used_entry_.end()));
-  }
+  // The first entry of the LRU list is the most recently used one
+  const uint64_t num_entries = buffer->lru_cache()->size();
 
   for (auto idx : c10::irange(buffer->encoding_lookup_keys()->size())) {
-    auto fb_encoding_lookup_str = buffer->encoding_lookup_keys()->Get(idx);
+    std::string encoding = buffer->encoding_lookup_keys()->Get(idx)->str();
     auto fb_encoding_entry = buffer->encoding_lookup_values()->Get(idx);
 
-    EncodingEntry entry{
-        fb_encoding_entry->id(),
-        used_entry_iterators.at(fb_encoding_entry->lru_iter())};
-    encoding_lookup_.emplace(fb_encoding_lookup_str->str(), entry);
+    const size_t hash = std::hash<std::string>{}(encoding);
+    Shard& shard = shards_.at(hash % num_shards_);
+    std::unique_lock<std::shared_mutex> guard(shard.mutex);
+    shard.entries.emplace(
+        hash,
+        std::make_unique<EncodingEntry>(
+            std::move(encoding),
+            fb_encoding_entry->id(),
+            num_entries - 1 - fb_encoding_entry->lru_iter()));
+    size_++;
+  }
+  use_counter_ = num_entries;
+}
+
+InputsIdLookup::EncodingEntry* InputsIdLookup::findEntry(
+    const Shard& shard,
+    size_t hash,
+    const std::string& encoding) {
+  auto [begin, end] = shard.entries.equal_range(hash);
+  for (auto it = begin; it != end; ++it) {
+    if (it->second->encoding == encoding) {
+      return it->second.get();
+    }
+  }
+  return nullptr;
+}
+
+size_t InputsIdLookup::evictLeastRecentlyUsed() {
+  Shard* lru_shard = nullptr;
+  const EncodingEntry* lru_entry = nullptr;
+  uint64_t lru_last_use = std::numeric_limits<uint64_t>::max();
+  for (auto& shard : shards_) {
+    std::shared_lock<std::shared_mutex> guard(shard.mutex);
+    for (const auto& [hash, entry] : shard.entries) {
+      if (entry->last_use.load() < lru_last_use) {
+        lru_shard = &shard;
+        lru_entry = entry.get();
+        lru_last_use = entry->last_use.load();
+      }
+    }
+  }
+  NVF_ERROR(lru_entry != nullptr, "No entry to evict");
+
+  // Entries are only removed while holding insertion_mutex_, so lru_entry
+  // is still valid
+  std::unique_lock<std::shared_mutex> guard(lru_shard->mutex);
+  const size_t evict_id = lru_entry->id;
+  auto [begin, end] = lru_shard->entries.equal_range(
+      std::hash<std::string>{}(lru_entry->encoding));
+  for (auto it = begin; it != end; ++it) {
+    if (it->second.get() == lru_entry) {
+      lru_shard->entries.erase(it);
+      break;
+    }
   }
+  size_--;
+  return evict_id;
 }
 
 InputsIdLookup::IdLookupReturn InputsIdLookup::lookupId(
     const at::ArrayRef<c10::IValue>& inputs,
     const std::unordered_set<size_t>& scalar_inputs_to_record,
     int8_t device) {
+  FUSER_PERF_SCOPE("InputsIdLookup::lookupId");
   IdLookupReturn ret;
 
-  // lock mutex_ because we are touching encoding_
-  std::lock_guard<std::mutex> guard(mutex_);
-  encoding_.clear();
-  encodeBuffer(device, encoding_);
+  // string to store encoded input meta information. Reuse the buffer instead
+  // of stringtream gives few us perf gain. It is thread local so that
+  // concurrent lookups don't need to be serialized.
+  thread_local std::string encoding;
+  encoding.clear();
+  encodeBuffer(device, encoding);
   for (const auto i : c10::irange(inputs.size())) {
     auto input = inputs[i];
     if (input.isTensor()) {
       auto& input_tensor = input.toTensor();
 
       for (auto size : input_tensor.sizes()) {
-        encodeBuffer(size, encoding_);
-        encoding_.push_back(' ');
+        encodeBuffer(size, encoding);
+        encoding.push_back(' ');
       }
-      encoding_.push_back('X');
-      encoding_.push_back(' ');
+      encoding.push_back('X');
+      encoding.push_back(' ');
       for (auto stride : input_tensor.strides()) {
-        encodeBuffer(stride, encoding_);
-        encoding_.push_back(' ');
+        encodeBuffer(stride, encoding);
+        encoding.push_back(' ');
       }
-      encoding_.push_back('a');
+      encoding.push_back('a');
       encodeBuffer(
           SchedulerRuntimeInfo::computeAlignmentSize(
               (size_t)input_tensor.data_ptr()),
-          encoding_);
+          encoding);
       // NOTE: device is set for the whole set of inputs first using device arg
     } else {
       // encode s for scalar;
-      encoding_.push_back('s');
+      encoding.push_back('s');
       if (scalar_inputs_to_record.find(i) != scalar_inputs_to_record.end()) {
         // Add value of scalars here only if it is one of the scalars
         // provided, as these are used in determining concretization.
@@ -329,13 +717,13 @@ InputsIdLookup::IdLookupReturn InputsIdLookup::lookupId(
         // any DataType might appear via `cast` and `where`, so we handle all
         // cases here.
         if (input.isInt()) {
-          encodeBuffer(input.toInt(), encoding_);
+          encodeBuffer(input.toInt(), encoding);
         } else if (input.isBool()) {
-          encodeBuffer(input.toBool(), encoding_);
+          encodeBuffer(input.toBool(), encoding);
         } else if (input.isDouble()) {
-          encodeBuffer(input.toDouble(), encoding_);
+          encodeBuffer(input.toDouble(), encoding);
         } else if (input.isComplexDouble()) {
-          encodeBuffer(input.toComplexDouble(), encoding_);
+          encodeBuffer(input.toComplexDouble(), encoding);
         } else {
           NVF_ERROR(
               false,
@@ -344,34 +732,47 @@ InputsIdLookup::IdLookupReturn InputsIdLookup::lookupId(
         }
       }
     }
-    encoding_.push_back(';');
+    encoding.push_back(';');
   }
 
-  auto& entry = encoding_lookup_[encoding_];
+  const size_t hash = std::hash<std::string>{}(encoding);
+  Shard& shard = shards_.at(hash % num_shards_);
 
-  if (entry.id == 0) {
-    // no entry existed for given input set, set id for given entry
-    entry.id = current_id_++;
-    if (used_entry_.size() == max_cache_size_) {
-      // pop least recently used cache;
-      const auto& remove_iter = encoding_lookup_.find(used_entry_.back());
-      used_entry_.pop_back();
-      ret.evict_id = remove_iter->second.id;
-      ret.eviction = true;
-      encoding_lookup_.erase(remove_iter);
+  // Fast path: the input set has been seen before
+  {
+    std::shared_lock<std::shared_mutex> guard(shard.mutex);
+    if (EncodingEntry* entry = findEntry(shard, hash, encoding)) {
+      entry->last_use = use_counter_++;
+      ret.id = entry->id;
+      return ret;
     }
-  } else {
-    // short-cut to leave LRU entry as is
-    if (entry.lru_iter == used_entry_.begin()) {
-      ret.id = entry.id;
+  }
+
+  // no entry existed for given input set when we looked. Another thread may
+  // have inserted it since then, so look again while holding
+  // insertion_mutex_.
+  std::lock_guard<std::mutex> insertion_guard(insertion_mutex_);
+  {
+    std::shared_lock<std::shared_mutex> guard(shard.mutex);
+    if (EncodingEntry* entry = findEntry(shard, hash, encoding)) {
+      entry->last_use = use_counter_++;
+      ret.id = entry->id;
       return ret;
     }
+  }
 
-    used_entry_.erase(entry.lru_iter);
+  if (size_ > 0 && size_ >= max_cache_size_) {
+    // pop least recently used cache;
+    ret.evict_id = evictLeastRecentlyUsed();
+    ret.eviction = true;
   }
 
-  ret.id = entry.id;
-  entry.lru_iter = used_entry_.insert(used_entry_.begin(), encoding_);
+  ret.id = current_id_++;
+  std::unique_lock<std::shared_mutex> guard(shard.mutex);
+  shard.entries.emplace(
+      hash,
+      std::make_unique<EncodingEntry>(encoding, ret.id, use_counter_++));
+  size_++;
   return ret;
 }
 
@@ -399,6 +800,9 @@ void prepareRuntimeOrder(
   // Keep track of groups that has run
   std::vector<bool> group_ran(segmented_fusion->groups().size(), false);
 
+  // Position in the run order of the group producing each segment output
+  std::unordered_map<Val*, int64_t> producer_run_order_id;
+
   while (!std::all_of(
       group_ran.begin(), group_ran.end(), [](bool b) { return b; })) {
     bool one_ran = false;
@@ -417,12 +821,29 @@ void prepareRuntimeOrder(
           [&available_input](Val* val) { return available_input.count(val); });
 
       if (ready_to_run) {
+        const auto run_order_id =
+            (int64_t)runtime_workspace.group_run_order.size();
         runtime_workspace.group_run_order.push_back(group);
+
+        std::vector<int64_t> producers;
+        for (Val* input : group_inputs) {
+          auto producer_it = producer_run_order_id.find(input);
+          if (producer_it != producer_run_order_id.end() &&
+              std::find(
+                  producers.begin(), producers.end(), producer_it->second) ==
+                  producers.end()) {
+            producers.push_back(producer_it->second);
+          }
+        }
+        runtime_workspace.group_producers.push_back(std::move(producers));
+
         const auto& group_outputs = group->outputs();
 
         // Insert graph segment output to tensor map
         for (const size_t group_out_i : c10::irange(group_outputs.size())) {
           available_input.insert(group_outputs[group_out_i]);
+          producer_run_order_id.emplace(
+              group_outputs[group_out_i], run_order_id);
         }
         group_ran[group_i] = true;
         one_ran = true;
@@ -434,6 +855,73 @@ void prepareRuntimeOrder(
   }
 }
 
+void prepareSegmentSlots(
+    SegmentedFusion* segmented_fusion,
+    RuntimeWorkSpace& runtime_workspace) {
+  std::unordered_map<Val*, int64_t> slots;
+  auto bind = [&](Val* val) -> int64_t {
+    if (!slots.emplace(val, runtime_workspace.num_slots).second) {
+      return -1;
+    }
+    return runtime_workspace.num_slots++;
+  };
+  auto slotOf = [&slots](Val* val) {
+    auto it = slots.find(val);
+    NVF_ERROR(it != slots.end(), "No argument slot for ", val->toString());
+    return it->second;
+  };
+
+  for (Val* input : segmented_fusion->inputs()) {
+    NVF_ERROR(bind(input) >= 0, "Duplicated fusion input ", input);
+  }
+  for (Val* extent : runtime_workspace.group_extent_binding_order) {
+    runtime_workspace.extent_slots.push_back(bind(extent));
+  }
+
+  // Same lifetimes as ArgumentManager: fusion inputs and outputs are never
+  // released, and neither are the values of fusions with fewer than three
+  // segments
+  auto isFusionInputOrOutput = [](Val* val) {
+    return val->isFusionInput() || val->isFusionOutput();
+  };
+  const auto& group_run_order = runtime_workspace.group_run_order;
+  const int64_t num_groups = (int64_t)group_run_order.size();
+  std::unordered_map<int64_t, int64_t> last_used_run_order_id;
+  for (auto run_order_id : c10::irange(num_groups)) {
+    SegmentedGroup* group = group_run_order.at(run_order_id);
+    std::vector<int64_t> input_slots;
+    input_slots.reserve(group->inputs().size());
+    for (Val* input : group->inputs()) {
+      input_slots.push_back(slotOf(input));
+      if (run_order_id > 0 && !isFusionInputOrOutput(input)) {
+        last_used_run_order_id[input_slots.back()] = run_order_id;
+      }
+    }
+    std::vector<int64_t> output_slots;
+    output_slots.reserve(group->outputs().size());
+    for (Val* output : group->outputs()) {
+      output_slots.push_back(bind(output));
+      if (run_order_id > 0 && run_order_id < num_groups - 1 &&
+          !isFusionInputOrOutput(output)) {
+        last_used_run_order_id[slotOf(output)] = run_order_id;
+      }
+    }
+    runtime_workspace.group_input_slots.push_back(std::move(input_slots));
+    runtime_workspace.group_output_slots.push_back(std::move(output_slots));
+  }
+
+  runtime_workspace.group_released_slots.resize(num_groups);
+  if (num_groups >= 3) {
+    for (auto [slot, run_order_id] : last_used_run_order_id) {
+      runtime_workspace.group_released_slots.at(run_order_id).push_back(slot);
+    }
+  }
+
+  for (Val* output : segmented_fusion->outputs()) {
+    runtime_workspace.fusion_output_slots.push_back(slotOf(output));
+  }
+}
+
 FusionExecutorCache::FusionExecutorCache(
     std::unique_ptr<Fusion> fusion,
     int64_t fusion_id,
@@ -442,6 +930,257 @@ FusionExecutorCache::FusionExecutorCache(
       fusion_id_{fusion_id},
       auto_schedule_(auto_schedule) {}
 
+FusionExecutorCache::~FusionExecutorCache() {
+  KernelRuntimeLru::get().remove(this);
+}
+
+KernelRuntimeLru& KernelRuntimeLru::get() {
+  // Never destroyed, as FusionExecutorCaches may be destroyed at exit
+  static auto* lru = new KernelRuntimeLru();
+  return *lru;
+}
+
+void KernelRuntimeLru::setMemoryBudget(int64_t bytes) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  memory_budget_ = bytes;
+  evictToBudget(/*caller=*/nullptr, /*keep=*/nullptr);
+}
+
+KernelRuntimeLru::Stats KernelRuntimeLru::stats() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  Stats stats;
+  stats.hits = hits_;
+  stats.misses = misses_;
+  stats.evictions = evictions_;
+  stats.memory_bytes = memory_bytes_;
+  stats.memory_budget = memory_budget_;
+  return stats;
+}
+
+void KernelRuntimeLru::recordLookup(bool hit) {
+  ++(hit ? hits_ : misses_);
+}
+
+void KernelRuntimeLru::use(
+    FusionExecutorCache* cache,
+    FusionKernelRuntime* runtime) {
+  // The executors of a runtime being compiled in the background can't be
+  // inspected, so its footprint is updated when it is used after that
+  const std::optional<int64_t> bytes = runtime->hasAsyncCompile()
+      ? std::nullopt
+      : std::optional<int64_t>(runtime->memoryFootprint());
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto it = entry_of_runtime_.find(runtime);
+  if (it == entry_of_runtime_.end()) {
+    entries_.push_front(Entry{cache, runtime, 0});
+    it = entry_of_runtime_.emplace(runtime, entries_.begin()).first;
+  } else {
+    entries_.splice(entries_.begin(), entries_, it->second);
+  }
+  if (bytes.has_value()) {
+    memory_bytes_ += bytes.value() - it->second->bytes;
+    it->second->bytes = bytes.value();
+  }
+  evictToBudget(cache, runtime);
+}
+
+void KernelRuntimeLru::touch(FusionKernelRuntime* runtime) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto it = entry_of_runtime_.find(runtime);
+  if (it != entry_of_runtime_.end()) {
+    entries_.splice(entries_.begin(), entries_, it->second);
+  }
+}
+
+void KernelRuntimeLru::remove(FusionExecutorCache* cache) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (it->cache == cache) {
+      memory_bytes_ -= it->bytes;
+      entry_of_runtime_.erase(it->runtime);
+      it = entries_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void KernelRuntimeLru::evictToBudget(
+    FusionExecutorCache* caller,
+    FusionKernelRuntime* keep) {
+  if (memory_budget_ < 0) {
+    return;
+  }
+  // Other FusionExecutorCaches are only try-locked, since they may be
+  // waiting for mutex_ while holding their run lock
+  auto it = entries_.end();
+  while (memory_bytes_ > memory_budget_ && it != entries_.begin()) {
+    --it;
+    if (it->runtime == keep) {
+      continue;
+    }
+    const bool evicted = it->cache == caller
+        ? it->cache->evictKernelRuntime(it->runtime)
+        : it->cache->tryEvictKernelRuntime(it->runtime);
+    if (evicted) {
+      memory_bytes_ -= it->bytes;
+      ++evictions_;
+      entry_of_runtime_.erase(it->runtime);
+      it = entries_.erase(it);
+    }
+  }
+}
+
+namespace {
+
+// Appends everything a compiled kernel depends on of tensor to signature
+void appendTensorSignature(
+    const at::Tensor& tensor,
+    c10::SmallVectorImpl<int64_t>& signature) {
+  signature.push_back((int64_t)tensor.scalar_type());
+  signature.push_back(tensor.dim());
+  signature.append(tensor.sizes().begin(), tensor.sizes().end());
+  signature.append(tensor.strides().begin(), tensor.strides().end());
+  signature.push_back(
+      (int64_t)SchedulerRuntimeInfo::computeAlignmentSize(
+          (size_t)tensor.data_ptr()));
+}
+
+} // namespace
+
+void FusionExecutorCache::runFusionWithTensors(
+    c10::ArrayRef<at::Tensor> inputs,
+    c10::ArrayRef<at::Tensor> outputs) {
+  FUSER_PERF_SCOPE("FusionExecutorCache::runFusionWithTensors");
+  std::unique_lock<std::mutex> run_lock(run_mutex_);
+  NVF_CHECK(
+      unneeded_outputs_.empty(),
+      "runFusionWithTensors is not supported with unneeded outputs");
+  NVF_CHECK(
+      outputs.size() == fusion_->outputs().size(),
+      "Expected ",
+      fusion_->outputs().size(),
+      " outputs, but got ",
+      outputs.size());
+
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers)
+  c10::SmallVector<int64_t, 64> signature;
+  bool all_cuda = true;
+  for (const auto* tensors : {&inputs, &outputs}) {
+    for (const auto& tensor : *tensors) {
+      all_cuda = all_cuda && tensor.defined() && tensor.is_cuda();
+      if (!all_cuda) {
+        break;
+      }
+      signature.push_back(tensor.get_device());
+      appendTensorSignature(tensor, signature);
+    }
+  }
+
+  size_t signature_hash = 0;
+  for (int64_t value : signature) {
+    hashCombine(signature_hash, std::hash<int64_t>{}(value));
+  }
+
+  if (all_cuda && !isProfilerEnabled()) {
+    auto it = direct_launch_entries_.find(signature_hash);
+    if (it != direct_launch_entries_.end() &&
+        std::equal(
+            signature.begin(),
+            signature.end(),
+            it->second.signature.begin(),
+            it->second.signature.end())) {
+      // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers)
+      c10::SmallVector<void*, 16> data_ptrs;
+      for (const auto& tensor : inputs) {
+        data_ptrs.push_back(tensor.data_ptr());
+      }
+      for (const auto& tensor : outputs) {
+        data_ptrs.push_back(tensor.data_ptr());
+      }
+      std::lock_guard<std::mutex> runtime_guard(
+          it->second.runtime->runMutex());
+      it->second.executor->launchWithDataPointers(
+          it->second.cache_id, data_ptrs);
+      KernelRuntimeLru::get().touch(it->second.runtime);
+      return;
+    }
+  }
+
+  std::vector<c10::IValue> ivalues(inputs.begin(), inputs.end());
+  RunRecord record;
+  std::vector<at::Tensor> results = runFusionWithInputsImpl(
+      ivalues,
+      std::nullopt,
+      std::nullopt,
+      /*preallocated_outputs=*/{},
+      /*async_compile=*/false,
+      run_lock,
+      &record);
+  NVF_ERROR(results.size() == outputs.size());
+  for (const auto i : c10::irange(outputs.size())) {
+    outputs[i].copy_(results[i]);
+  }
+
+  if (all_cuda && !isProfilerEnabled()) {
+    maybeAddDirectLaunchEntry(
+        signature_hash,
+        std::vector<int64_t>(signature.begin(), signature.end()),
+        ivalues,
+        outputs,
+        results,
+        record);
+  }
+}
+
+void FusionExecutorCache::maybeAddDirectLaunchEntry(
+    size_t signature_hash,
+    std::vector<int64_t> signature,
+    const std::vector<c10::IValue>& inputs,
+    c10::ArrayRef<at::Tensor> outputs,
+    const std::vector<at::Tensor>& results,
+    const RunRecord& record) {
+  if (!fusion_->getPermutationInputMap().empty() ||
+      inputs.size() != fusion_->inputs().size() ||
+      std::any_of(
+          fusion_->outputs().begin(),
+          fusion_->outputs().end(),
+          [this](Val* out) {
+            return fusion_->getOutputAlias(out).type != AllocationType::New;
+          })) {
+    return;
+  }
+
+  // The kernel has to have written results with the same layout as outputs,
+  // since their sizes and strides are baked into the cached arguments
+  for (const auto i : c10::irange(outputs.size())) {
+    if (outputs[i].sizes() != results[i].sizes() ||
+        outputs[i].strides() != results[i].strides() ||
+        outputs[i].scalar_type() != results[i].scalar_type()) {
+      return;
+    }
+  }
+
+  // The run already looked up the inputs, so its cache id is reused rather
+  // than looking them up again
+  FusionKernelRuntime* kernel_runtime = record.runtime;
+  if (kernel_runtime == nullptr || kernel_runtime->isSegmented() ||
+      kernel_runtime->isCompiling() ||
+      kernel_runtime->executors().size() != 1) {
+    return;
+  }
+  FusionExecutor& executor = kernel_runtime->executors().front();
+  const size_t cache_id = record.cache_id;
+  if (!executor.canLaunchWithDataPointers(cache_id) ||
+      executor.kernel()->inputs().size() != inputs.size() ||
+      executor.kernel()->outputs().size() != outputs.size()) {
+    return;
+  }
+
+  direct_launch_entries_[signature_hash] = DirectLaunchEntry{
+      std::move(signature), kernel_runtime, &executor, cache_id};
+}
+
 KernelArgumentHolder FusionExecutorCache::prepareInputs(
     const at::ArrayRef<c10::IValue>& inputs,
     std::optional<int8_t> selected_device) {
@@ -515,11 +1254,266 @@ bool FusionExecutorCache::isCompiled(
 //
 // For details on Part_2, refer to the implementation note. [ Permutation
 // Bookkeeping and Propagation in Parser ]
+namespace {
+
+// Returns, for each input of fusion, whether it is split into chunks along its
+// outermost dimension when fusion runs chunk by chunk. Returns nullopt if some
+// op mixes elements across the outermost dimension of the outputs. The
+// outputs are always chunked; the chunking propagates backward from them.
+std::optional<std::vector<bool>> getOuterChunkedInputs(Fusion* fusion) {
+  if (!fusion->getPermutationInputMap().empty() ||
+      !fusion->getPermutationOutputMap().empty()) {
+    return std::nullopt;
+  }
+
+  auto is_outer_broadcast = [](TensorView* tv) {
+    const auto logical =
+        TensorDomain::noReductions(tv->getMaybeRFactorDomain());
+    return logical.empty() || logical.front()->isBroadcast();
+  };
+  std::unordered_map<TensorView*, bool> chunked;
+  // Returns false if tv is required to be both chunked and not chunked
+  auto require = [&](TensorView* tv, bool is_chunked) {
+    is_chunked = is_chunked && !is_outer_broadcast(tv);
+    auto [it, inserted] = chunked.try_emplace(tv, is_chunked);
+    return inserted || it->second == is_chunked;
+  };
+
+  for (Val* out : fusion->outputs()) {
+    auto out_tv = dynamic_cast<TensorView*>(out);
+    if (out_tv == nullptr || is_outer_broadcast(out_tv) ||
+        out_tv->hasAllocation() || out_tv->dtype() == DataType::Index ||
+        fusion->getOutputAlias(out_tv).type != AllocationType::New) {
+      return std::nullopt;
+    }
+    const auto logical =
+        TensorDomain::noReductions(out_tv->getMaybeRFactorDomain());
+    if (std::any_of(logical.begin(), logical.end(), [](IterDomain* id) {
+          return id->hasExpandedExtent();
+        })) {
+      return std::nullopt;
+    }
+    require(out_tv, true);
+  }
+
+  const std::vector<Expr*> exprs = StmtSort::getExprs(fusion);
+  for (auto expr_it = exprs.rbegin(); expr_it != exprs.rend(); expr_it++) {
+    Expr* expr = *expr_it;
+    if (!ir_utils::isTvOp(expr)) {
+      continue;
+    }
+    // Ops that map the outermost dimension of their output to that of their
+    // inputs, or to no input at all
+    if (!expr->isOneOf<
+            UnaryOp,
+            BinaryOp,
+            TernaryOp,
+            LoadStoreOp,
+            BroadcastOp,
+            ReductionOp>()) {
+      return std::nullopt;
+    }
+    auto out_tv = expr->output(0)->as<TensorView>();
+    if (out_tv->hasRFactor()) {
+      return std::nullopt;
+    }
+    // Scalar operands that depend on extents would change with the chunks
+    if (std::any_of(
+            expr->inputs().begin(), expr->inputs().end(), [](Val* in) {
+              return !in->isA<TensorView>() && !in->isConstScalar() &&
+                  !in->isFusionInput();
+            })) {
+      return std::nullopt;
+    }
+
+    auto out_it = chunked.find(out_tv);
+    bool in_chunked = out_it != chunked.end() && out_it->second;
+    if (auto bcast = dynamic_cast<BroadcastOp*>(expr)) {
+      // The outermost dimension of the input moves inward
+      in_chunked = in_chunked && !bcast->isBroadcastDim(0);
+    } else if (
+        expr->isA<ReductionOp>() &&
+        out_tv->getRootDomain().at(0)->isReduction()) {
+      return std::nullopt;
+    }
+    for (auto in_tv : ir_utils::filterByType<TensorView>(expr->inputs())) {
+      if (!require(in_tv, in_chunked)) {
+        return std::nullopt;
+      }
+    }
+  }
+
+  std::vector<bool> chunked_inputs;
+  chunked_inputs.reserve(fusion->inputs().size());
+  for (Val* in : fusion->inputs()) {
+    auto in_it = in->isA<TensorView>() ? chunked.find(in->as<TensorView>())
+                                       : chunked.end();
+    chunked_inputs.push_back(in_it != chunked.end() && in_it->second);
+  }
+  return chunked_inputs;
+}
+
+} // namespace
+
+std::optional<std::vector<at::Tensor>> FusionExecutorCache::runFusionInChunks(
+    const at::ArrayRef<c10::IValue>& inputs,
+    std::optional<int8_t> selected_device,
+    bool async_compile,
+    std::unique_lock<std::mutex>& run_lock) {
+  if (!unneeded_outputs_.empty()) {
+    return std::nullopt;
+  }
+  if (!outer_chunked_inputs_.has_value()) {
+    outer_chunked_inputs_ = getOuterChunkedInputs(fusion_.get());
+  }
+  if (!outer_chunked_inputs_->has_value()) {
+    return std::nullopt;
+  }
+  const std::vector<bool>& chunked_inputs = outer_chunked_inputs_->value();
+
+  // The number of outermost rows, the most rows per chunk that keep 32-bit
+  // indexing for all tensors, and whether the unchunked tensors need 64-bit
+  // indexing
+  int64_t num_rows = -1;
+  int64_t max_rows = std::numeric_limits<int64_t>::max();
+  bool needs_int64 = false;
+  std::optional<c10::Device> device;
+  // Returns false if chunking can't help
+  auto add_tensor = [&](at::IntArrayRef sizes,
+                        at::IntArrayRef strides,
+                        bool is_chunked) {
+    KernelIndexTypeCompute index_type_helper;
+    for (auto i : c10::irange(is_chunked ? 1 : 0, (int64_t)sizes.size())) {
+      index_type_helper.addDim(sizes[i], strides[i]);
+    }
+    if (!is_chunked) {
+      return index_type_helper.getType() == PrimDataType::Int32;
+    }
+    if (num_rows >= 0 && sizes[0] != num_rows) {
+      return false;
+    }
+    num_rows = sizes[0];
+    max_rows =
+        std::min(max_rows, index_type_helper.maxSizeOfNextDim(strides[0]));
+    needs_int64 = needs_int64 ||
+        index_type_helper.addDim(sizes[0], strides[0]) == PrimDataType::Int;
+    return true;
+  };
+  for (auto i : c10::irange(inputs.size())) {
+    if (!inputs[i].isTensor()) {
+      continue;
+    }
+    const at::Tensor& input = inputs[i].toTensor();
+    device = input.device();
+    if (!add_tensor(input.sizes(), input.strides(), chunked_inputs.at(i))) {
+      return std::nullopt;
+    }
+  }
+  if (!device.has_value()) {
+    return std::nullopt;
+  }
+  if (selected_device.has_value()) {
+    device = c10::Device(c10::DeviceType::CUDA, selected_device.value());
+  }
+
+  // Outputs are allocated contiguous like the runtime would
+  KernelArgumentHolder args =
+      KernelArgumentHolder::createKernelArgumentHolder(inputs);
+  ExpressionEvaluator expr_eval =
+      executor_utils::bindInputs(args, fusion_.get());
+  std::vector<std::vector<int64_t>> output_sizes;
+  output_sizes.reserve(fusion_->outputs().size());
+  for (Val* out : fusion_->outputs()) {
+    std::vector<int64_t> sizes;
+    for (IterDomain* id : TensorDomain::noReductions(
+             out->as<TensorView>()->getMaybeRFactorDomain())) {
+      sizes.push_back(expr_eval.evaluate(id->extent()).as<int64_t>());
+    }
+    std::vector<int64_t> strides(sizes.size(), 1);
+    for (int64_t i = (int64_t)sizes.size() - 2; i >= 0; i--) {
+      strides[i] = strides[i + 1] * sizes[i + 1];
+    }
+    if (!add_tensor(sizes, strides, /*is_chunked=*/true)) {
+      return std::nullopt;
+    }
+    output_sizes.push_back(std::move(sizes));
+  }
+  if (!needs_int64 || max_rows < 1 || max_rows >= num_rows) {
+    return std::nullopt;
+  }
+  // Keep the chunks aligned for vectorization
+  if (max_rows >= 16) {
+    max_rows -= max_rows % 16;
+  }
+
+  std::vector<at::Tensor> outputs;
+  outputs.reserve(output_sizes.size());
+  for (auto i : c10::irange(output_sizes.size())) {
+    outputs.push_back(at::empty(
+        output_sizes[i],
+        at::TensorOptions()
+            .dtype(data_type_to_aten(fusion_->outputs()[i]->dtype()))
+            .device(device.value())));
+  }
+
+  for (int64_t start = 0; start < num_rows; start += max_rows) {
+    const int64_t length = std::min(max_rows, num_rows - start);
+    std::vector<c10::IValue> chunk_inputs;
+    chunk_inputs.reserve(inputs.size());
+    for (auto i : c10::irange(inputs.size())) {
+      chunk_inputs.push_back(
+          chunked_inputs.at(i) ? inputs[i].toTensor().narrow(0, start, length)
+                               : inputs[i]);
+    }
+    std::vector<at::Tensor> chunk_outputs;
+    chunk_outputs.reserve(outputs.size());
+    for (const at::Tensor& output : outputs) {
+      chunk_outputs.push_back(output.narrow(0, start, length));
+    }
+    runFusionWithInputsImpl(
+        chunk_inputs,
+        /*forced_index_type=*/std::nullopt,
+        selected_device,
+        chunk_outputs,
+        async_compile,
+        run_lock);
+  }
+  return outputs;
+}
+
 std::vector<at::Tensor> FusionExecutorCache::runFusionWithInputs(
     const at::ArrayRef<c10::IValue>& inputs,
     std::optional<PrimDataType> forced_index_type,
-    std::optional<int8_t> selected_device) {
+    std::optional<int8_t> selected_device,
+    const std::vector<at::Tensor>& preallocated_outputs,
+    bool async_compile) {
+  std::unique_lock<std::mutex> run_lock(run_mutex_);
+  return runFusionWithInputsImpl(
+      inputs,
+      forced_index_type,
+      selected_device,
+      preallocated_outputs,
+      async_compile,
+      run_lock);
+}
+
+std::vector<at::Tensor> FusionExecutorCache::runFusionWithInputsImpl(
+    const at::ArrayRef<c10::IValue>& inputs,
+    std::optional<PrimDataType> forced_index_type,
+    std::optional<int8_t> selected_device,
+    const std::vector<at::Tensor>& preallocated_outputs,
+    bool async_compile,
+    std::unique_lock<std::mutex>& run_lock,
+    RunRecord* record) {
   FUSER_PERF_SCOPE("FusionExecutorCache::runFusionWithInputs");
+  if (isOptionEnabled(EnableOption::ChunkedIndexing) &&
+      !forced_index_type.has_value() && preallocated_outputs.empty()) {
+    if (auto outputs = runFusionInChunks(
+            inputs, selected_device, async_compile, run_lock)) {
+      return std::move(outputs.value());
+    }
+  }
+
   // NOTE: This should be the first code in the method to capture all host time
   if (isProfilerEnabled()) {
     FusionProfiler::start(isProfilerEnabledWithoutCupti());
@@ -527,38 +1521,39 @@ std::vector<at::Tensor> FusionExecutorCache::runFusionWithInputs(
 
   // Permute input tensor for kernel execution.
   // See Part_1 in Note [ Channels-Last support in nvfuser ]
-  at::ArrayRef<c10::IValue> perm_inputs = inputs;
-  const auto& to_be_permuted_inputs = fusion_->getPermutationInputMap();
-  std::vector<c10::IValue> inputs_vec;
-  if (!to_be_permuted_inputs.empty()) {
-    inputs_vec = inputs.vec();
-    for (const auto& pair : to_be_permuted_inputs) {
-      auto v = inputs_vec[pair.first];
-      NVF_CHECK(
-          v.isTensor(), "input permutation can only be applied at tensor");
-      auto tensor = v.toTensor();
-      inputs_vec[pair.first] = tensor.permute(pair.second);
-    }
-    perm_inputs = inputs_vec;
-  }
+  std::vector<c10::IValue> inputs_vec = permuteInputs(inputs);
+  at::ArrayRef<c10::IValue> perm_inputs =
+      inputs_vec.empty() ? inputs : inputs_vec;
 
   KernelArgumentHolder args = prepareInputs(perm_inputs, selected_device);
-  auto kernel_runtime = getKernelRuntimeFor(args, forced_index_type);
+  std::vector<LaunchParams> launch_params;
+  auto kernel_runtime =
+      getKernelRuntimeFor(args, forced_index_type, &launch_params);
 
   if (isProfilerEnabled()) {
     FusionProfiler::createSegments(kernel_runtime->executors().size());
   }
 
-  if (!kernel_runtime->isCompiled()) {
-    kernel_runtime->compileFusionParallel(args);
+  // While the kernels are compiled in the background, the fusion is
+  // evaluated with ATen. Profiling expects kernels, so it always waits.
+  std::optional<std::vector<at::Tensor>> eager_outputs;
+  if ((async_compile || isOptionEnabled(EnableOption::AsyncCompile)) &&
+      !isProfilerEnabled()) {
+    if (!kernel_runtime->isCompiling() && !kernel_runtime->isCompiled()) {
+      kernel_runtime->compileFusionAsync(args);
+    }
+    if (kernel_runtime->isCompiling()) {
+      eager_outputs = kernel_runtime->runWithExpressionEvaluator(args);
+      if (!eager_outputs.has_value()) {
+        kernel_runtime->waitForAsyncCompile();
+      }
+    }
   }
 
-  if (measure_kernel_time_) {
-    kernel_runtime->enableKernelTimeMeasurement();
+  if (!eager_outputs.has_value() && !kernel_runtime->isCompiled()) {
+    kernel_runtime->compileFusionParallel(args);
   }
 
-  most_recent_runtime_ = kernel_runtime;
-
   auto fusion = kernel_runtime->fusionSegments()->completeFusion();
 
   // Make sure the forced index type is indeed used
@@ -570,6 +1565,36 @@ std::vector<at::Tensor> FusionExecutorCache::runFusionWithInputs(
         " failed");
   }
 
+  // Preallocated outputs are given for the returned outputs only. Spread them
+  // over all outputs of the fusion, leaving hidden outputs to the runtime.
+  std::vector<at::Tensor> given_outputs;
+  if (!preallocated_outputs.empty()) {
+    NVF_CHECK(
+        unneeded_outputs_.empty(),
+        "Preallocated outputs are not supported with unneeded outputs");
+    NVF_CHECK(
+        fusion->getPermutationOutputMap().empty(),
+        "Preallocated outputs are not supported for fusions with permuted outputs");
+    given_outputs.resize(fusion->outputs().size());
+    size_t num_visible_outputs = 0;
+    for (auto out_index : c10::irange(fusion->outputs().size())) {
+      Val* out = fusion->outputs()[out_index];
+      if (fusion->getOutputAlias(out).hide_output) {
+        continue;
+      }
+      if (num_visible_outputs < preallocated_outputs.size()) {
+        given_outputs[out_index] = preallocated_outputs[num_visible_outputs];
+      }
+      num_visible_outputs++;
+    }
+    NVF_CHECK(
+        num_visible_outputs == preallocated_outputs.size(),
+        "Expected ",
+        num_visible_outputs,
+        " preallocated outputs but got ",
+        preallocated_outputs.size());
+  }
+
   int seq_id = 0;
   // Record kernel input and output tensors so profiler can construct
   // the data flow graph
@@ -577,12 +1602,32 @@ std::vector<at::Tensor> FusionExecutorCache::runFusionWithInputs(
       "run_fused_kernel",
       std::vector<c10::IValue>(inputs.begin(), inputs.end()),
       seq_id);
-  auto outputs = kernel_runtime->runWithInputs(args);
+  auto outputs = eager_outputs.has_value()
+      ? std::move(eager_outputs.value())
+      : runKernelRuntime(
+            kernel_runtime, args, given_outputs, launch_params, run_lock);
+  most_recent_runtime_ = kernel_runtime;
+  if (record != nullptr) {
+    *record = RunRecord{kernel_runtime, *args.getCacheId()};
+  }
+  if (eager_outputs.has_value()) {
+    for (auto out_index : c10::irange(given_outputs.size())) {
+      if (given_outputs[out_index].defined()) {
+        NVF_CHECK(
+            given_outputs[out_index].sizes() == outputs[out_index].sizes(),
+            "Preallocated output ",
+            out_index,
+            " has sizes ",
+            given_outputs[out_index].sizes(),
+            " but expected ",
+            outputs[out_index].sizes());
+        given_outputs[out_index].copy_(outputs[out_index]);
+        outputs[out_index] = given_outputs[out_index];
+      }
+    }
+  }
   RECORD_OUTPUTS(outputs);
 
-  // Kernel time measurement is off by default
-  kernel_runtime->disableKernelTimeMeasurement();
-
   // Permute output tensor returned by kernel execution.
   // See Part_3 in Note [ Permutation support in nvfuser ]
   for (const auto& pair : fusion->getPermutationOutputMap()) {
@@ -605,6 +1650,36 @@ std::vector<at::Tensor> FusionExecutorCache::runFusionWithInputs(
   }
   outputs.resize(new_size);
 
+  // Return undefined tensors for the outputs removed by
+  // RemoveUnneededOutputsPass
+  if (!unneeded_outputs_.empty()) {
+    // Whether each returned output of fusion_ is unneeded
+    std::vector<bool> is_unneeded;
+    for (auto out_index : c10::irange(fusion_->outputs().size())) {
+      if (!fusion_->getOutputAlias(fusion_->outputs()[out_index])
+               .hide_output) {
+        is_unneeded.push_back(std::binary_search(
+            unneeded_outputs_.begin(),
+            unneeded_outputs_.end(),
+            (int64_t)out_index));
+      }
+    }
+    // Nothing is removed if the pass is disabled
+    const auto num_unneeded =
+        (size_t)std::count(is_unneeded.begin(), is_unneeded.end(), true);
+    if (outputs.size() + num_unneeded == is_unneeded.size()) {
+      std::vector<at::Tensor> all_outputs;
+      all_outputs.reserve(is_unneeded.size());
+      auto output_it = outputs.begin();
+      for (bool unneeded : is_unneeded) {
+        all_outputs.push_back(unneeded ? at::Tensor() : *output_it++);
+      }
+      outputs = std::move(all_outputs);
+    }
+  }
+
+  KernelRuntimeLru::get().use(this, kernel_runtime);
+
   // NOTE: This should be the last code in the method to capture all host time
   if (isProfilerEnabled()) {
     FusionProfiler::stop();
@@ -616,6 +1691,176 @@ std::vector<at::Tensor> FusionExecutorCache::runFusionWithInputs(
   return outputs;
 }
 
+std::vector<at::Tensor> FusionExecutorCache::runKernelRuntime(
+    FusionKernelRuntime* kernel_runtime,
+    KernelArgumentHolder& args,
+    const std::vector<at::Tensor>& outputs,
+    const std::vector<LaunchParams>& launch_params,
+    std::unique_lock<std::mutex>& run_lock) {
+  const bool concurrent = isOptionEnabled(EnableOption::ConcurrentStreams);
+  auto run = [&]() {
+    std::lock_guard<std::mutex> runtime_guard(kernel_runtime->runMutex());
+    if (concurrent && !launch_params.empty()) {
+      kernel_runtime->updateHeuristicsLaunchParams(launch_params);
+    }
+    if (measure_kernel_time_) {
+      kernel_runtime->enableKernelTimeMeasurement();
+    }
+    auto results = kernel_runtime->runWithInputs(args, outputs);
+    // Kernel time measurement is off by default
+    kernel_runtime->disableKernelTimeMeasurement();
+    return results;
+  };
+  if (!concurrent) {
+    return run();
+  }
+
+  // kernel_runtime is not evicted while it is in running_runtimes_
+  running_runtimes_.insert(kernel_runtime);
+  run_lock.unlock();
+  std::vector<at::Tensor> results;
+  std::exception_ptr error;
+  try {
+    results = run();
+  } catch (...) {
+    error = std::current_exception();
+  }
+  run_lock.lock();
+  running_runtimes_.erase(running_runtimes_.find(kernel_runtime));
+  if (running_runtimes_.empty()) {
+    runs_done_.notify_all();
+  }
+  if (error != nullptr) {
+    std::rethrow_exception(error);
+  }
+  return results;
+}
+
+void FusionExecutorCache::waitForRunningRuntimes(
+    std::unique_lock<std::mutex>& run_lock) {
+  runs_done_.wait(run_lock, [this]() { return running_runtimes_.empty(); });
+}
+
+void FusionExecutorCache::markOutputsUnneeded(
+    std::vector<int64_t> output_indices) {
+  std::unique_lock<std::mutex> run_lock(run_mutex_);
+  waitForRunningRuntimes(run_lock);
+  NVF_CHECK(
+      fusion_->getPermutationOutputMap().empty(),
+      "Unneeded outputs are not supported for fusions with permuted outputs");
+  preseg_passes::RemoveUnneededOutputsPass::markUnneededOutputs(
+      fusion_.get(), output_indices);
+  std::sort(output_indices.begin(), output_indices.end());
+  output_indices.erase(
+      std::unique(output_indices.begin(), output_indices.end()),
+      output_indices.end());
+  if (output_indices == unneeded_outputs_) {
+    return;
+  }
+  unneeded_outputs_ = std::move(output_indices);
+
+  // The cached runtimes were segmented with the previous outputs
+  KernelRuntimeLru::get().remove(this);
+  kernel_runtimes_.clear();
+  concretized_fusions_.clear();
+  conc_info_id_map_.clear();
+  deterministic_conc_info_.clear();
+  id_to_kernel_runtime_.clear();
+  direct_launch_entries_.clear();
+  heuristic_cache_.clear();
+  most_recent_runtime_ = nullptr;
+}
+
+void FusionExecutorCache::markInputsStatic(
+    std::vector<int64_t> input_indices) {
+  std::unique_lock<std::mutex> run_lock(run_mutex_);
+  waitForRunningRuntimes(run_lock);
+  preseg_passes::SegmentStaticSubgraphsPass::markStaticInputs(
+      fusion_.get(), std::move(input_indices));
+
+  // The cached runtimes were segmented without the marks
+  KernelRuntimeLru::get().remove(this);
+  kernel_runtimes_.clear();
+  concretized_fusions_.clear();
+  conc_info_id_map_.clear();
+  deterministic_conc_info_.clear();
+  id_to_kernel_runtime_.clear();
+  direct_launch_entries_.clear();
+  heuristic_cache_.clear();
+  most_recent_runtime_ = nullptr;
+}
+
+std::vector<c10::IValue> FusionExecutorCache::permuteInputs(
+    const at::ArrayRef<c10::IValue>& inputs) const {
+  const auto& to_be_permuted_inputs = fusion_->getPermutationInputMap();
+  std::vector<c10::IValue> inputs_vec;
+  if (!to_be_permuted_inputs.empty()) {
+    inputs_vec = inputs.vec();
+    for (const auto& pair : to_be_permuted_inputs) {
+      auto v = inputs_vec[pair.first];
+      NVF_CHECK(
+          v.isTensor(), "input permutation can only be applied at tensor");
+      auto tensor = v.toTensor();
+      inputs_vec[pair.first] = tensor.permute(pair.second);
+    }
+  }
+  return inputs_vec;
+}
+
+size_t FusionExecutorCache::precompile(
+    const std::vector<std::vector<c10::IValue>>& inputs_list,
+    std::optional<int8_t> selected_device) {
+  FUSER_PERF_SCOPE("FusionExecutorCache::precompile");
+  std::lock_guard<std::mutex> run_guard(run_mutex_);
+
+  // Looking up runtimes creates cache entries, so it is done serially.
+  // Runtimes created here are not compiled until all of them have been
+  // looked up, which lets later input sets reuse them.
+  std::vector<std::pair<FusionKernelRuntime*, KernelArgumentHolder>>
+      to_compile;
+  std::unordered_set<FusionKernelRuntime*> seen_runtimes;
+  for (const auto& inputs : inputs_list) {
+    std::vector<c10::IValue> inputs_vec = permuteInputs(inputs);
+    KernelArgumentHolder args = prepareInputs(
+        inputs_vec.empty() ? at::ArrayRef<c10::IValue>(inputs) : inputs_vec,
+        selected_device);
+    FusionKernelRuntime* kernel_runtime = getKernelRuntimeFor(args);
+    if (seen_runtimes.insert(kernel_runtime).second &&
+        !kernel_runtime->isCompiling() && !kernel_runtime->isCompiled()) {
+      to_compile.emplace_back(kernel_runtime, std::move(args));
+    }
+  }
+
+  // Nothing runs these runtimes until they are compiled, so unlike
+  // compileFusionAsync no copy of the complete fusion is kept for the
+  // expression evaluator. FusionProfiler isn't thread-safe, so runtimes are
+  // compiled one at a time when it is enabled.
+  std::vector<std::future<void>> compiles;
+  compiles.reserve(to_compile.size());
+  for (auto& [kernel_runtime, args] : to_compile) {
+    compiles.push_back(std::async(
+        isProfilerEnabled() ? std::launch::deferred : std::launch::async,
+        [kernel_runtime = kernel_runtime, &args = args]() {
+          kernel_runtime->compileFusionParallel(args);
+        }));
+  }
+  // Wait for all runtimes before reporting the first error
+  std::exception_ptr first_error;
+  for (auto& compile : compiles) {
+    try {
+      compile.get();
+    } catch (...) {
+      if (first_error == nullptr) {
+        first_error = std::current_exception();
+      }
+    }
+  }
+  if (first_error != nullptr) {
+    std::rethrow_exception(first_error);
+  }
+  return to_compile.size();
+}
+
 std::string FusionExecutorCache::getCode(
     FusionKernelRuntime* kernel_runtime,
     bool intrinsic_code) const {
@@ -699,11 +1944,86 @@ std::string FusionExecutorCache::getScheduledIrFor(
   return getScheduledIr(kernel_runtime, tensor_transforms);
 }
 
+std::vector<LaunchConfigSweepResult> FusionExecutorCache::sweepLaunchConfigs(
+    const at::ArrayRef<c10::IValue>& inputs,
+    int64_t max_candidates) {
+  KernelArgumentHolder args = prepareInputs(inputs);
+  auto kernel_runtime = getKernelRuntimeFor(args);
+  if (!kernel_runtime->isCompiled()) {
+    kernel_runtime->compileFusionParallel(args);
+  }
+  return kernel_runtime->sweepLaunchConfigs(args, max_candidates);
+}
+
 void FusionExecutorCache::evictCache(size_t cache_id) {
+  // The runtime of cache_id may have been evicted already
   auto it = id_to_kernel_runtime_.find(cache_id);
-  NVF_ERROR(it != id_to_kernel_runtime_.end());
-  it->second->evictCache(cache_id);
-  id_to_kernel_runtime_.erase(it);
+  if (it != id_to_kernel_runtime_.end()) {
+    // Other calls may be running the runtime with their cache ids
+    std::lock_guard<std::mutex> runtime_guard(it->second->runMutex());
+    it->second->evictCache(cache_id);
+    id_to_kernel_runtime_.erase(it);
+  }
+  shape_call_counts_.erase(cache_id);
+  for (auto entry_it = direct_launch_entries_.begin();
+       entry_it != direct_launch_entries_.end();) {
+    if (entry_it->second.cache_id == cache_id) {
+      entry_it = direct_launch_entries_.erase(entry_it);
+    } else {
+      ++entry_it;
+    }
+  }
+}
+
+bool FusionExecutorCache::evictKernelRuntime(FusionKernelRuntime* runtime) {
+  if (runtime->hasAsyncCompile() || running_runtimes_.count(runtime) != 0) {
+    return false;
+  }
+  for (auto& [config, runtimes] : kernel_runtimes_) {
+    auto runtime_it = std::find_if(
+        runtimes.begin(), runtimes.end(), [runtime](const auto& r) {
+          return r.get() == runtime;
+        });
+    if (runtime_it == runtimes.end()) {
+      continue;
+    }
+    for (auto it = id_to_kernel_runtime_.begin();
+         it != id_to_kernel_runtime_.end();) {
+      it = it->second == runtime ? id_to_kernel_runtime_.erase(it)
+                                 : std::next(it);
+    }
+    for (auto it = direct_launch_entries_.begin();
+         it != direct_launch_entries_.end();) {
+      it = it->second.runtime == runtime ? direct_launch_entries_.erase(it)
+                                         : std::next(it);
+    }
+    for (auto it = heuristic_cache_.begin(); it != heuristic_cache_.end();) {
+      it = it->second.runtime == runtime ? heuristic_cache_.erase(it)
+                                         : std::next(it);
+    }
+    if (most_recent_runtime_ == runtime) {
+      most_recent_runtime_ = nullptr;
+    }
+    runtimes.erase(runtime_it);
+    return true;
+  }
+  return false;
+}
+
+bool FusionExecutorCache::tryEvictKernelRuntime(FusionKernelRuntime* runtime) {
+  std::unique_lock<std::mutex> run_lock(run_mutex_, std::try_to_lock);
+  return run_lock.owns_lock() && evictKernelRuntime(runtime);
+}
+
+bool FusionExecutorCache::countShapeSpecializationCall(size_t cache_id) {
+  if (!isOptionEnabled(EnableOption::ShapeSpecialization) ||
+      initialInfo().getMaybeSpecializedExtents().empty()) {
+    return false;
+  }
+  const auto& args =
+      getEnableOptionArguments(EnableOption::ShapeSpecialization);
+  const int64_t threshold = args.empty() ? 100 : std::stol(args.at(0));
+  return ++shape_call_counts_[cache_id] == threshold;
 }
 
 DynamicTransformInitialInfo& FusionExecutorCache::initialInfo() {
@@ -720,21 +2040,66 @@ DynamicTransformInitialInfo& FusionExecutorCache::initialInfo() {
   return initial_info_.value();
 }
 
+std::unique_ptr<Fusion> FusionExecutorCache::copyConcretizedFusion(
+    const ConcreteInfo& config,
+    DynamicTransformConcretizationInfo* conc_info) {
+  if (!initialInfo().isDynamic()) {
+    return std::make_unique<Fusion>(*fusion_);
+  }
+
+  std::unique_ptr<Fusion>& concretized = concretized_fusions_[config];
+  if (concretized == nullptr) {
+    // Clone fusion_ so that we can safely use an ExpressionEvaluator on it,
+    // for the purposes of computing the concretization info.
+    concretized = std::make_unique<Fusion>(*fusion_);
+    const auto& conc_initial_info =
+        concretized->getManaged<DynamicTransformInitialInfo>("initial_info");
+    NVF_ERROR(conc_info);
+    conc_info->setInitialInfo(&conc_initial_info);
+
+    if (isDebugDumpEnabled(DebugDumpOption::FusionIrConcretized)) {
+      debug() << "Fusion before concretization:" << std::endl;
+      concretized->printMath();
+      debug() << conc_initial_info.toString() << std::endl;
+      debug() << conc_info->toString() << std::endl;
+    }
+
+    FusionGuard fg(concretized.get());
+    DynamicTransform::concretizeFusion(concretized.get(), conc_info);
+    // Initial info is used during concretization and is owned by the
+    // concretized fusion. After concretization, we stop managing it so that
+    // we won't keep cloning it for every subsequent Fusion copy.
+    concretized->stopManaging("initial_info");
+
+    if (isDebugDumpEnabled(DebugDumpOption::FusionIrConcretized)) {
+      debug() << "Concretized Fusion:" << std::endl;
+      concretized->print();
+    }
+  }
+  return std::make_unique<Fusion>(*concretized);
+}
+
 FusionKernelRuntime* FusionExecutorCache::getKernelRuntimeFor(
     const KernelArgumentHolder& args,
-    std::optional<PrimDataType> forced_index_type) {
+    std::optional<PrimDataType> forced_index_type,
+    std::vector<LaunchParams>* launch_params) {
+  FUSER_PERF_SCOPE("FusionExecutorCache::getKernelRuntimeFor");
   // Check for id hit case
   auto unique_id_opt = args.getCacheId();
   NVF_CHECK(
       unique_id_opt.has_value(),
       "KernelArgumentHolder has no cache ID in getKernelRuntimeFor");
   auto unique_id = *unique_id_opt;
+  // Inputs run often enough get a kernel of their own with their extents as
+  // constants, while the runtime of other inputs stays generic
+  const bool specialize_extents = countShapeSpecializationCall(unique_id);
   auto id_it = id_to_kernel_runtime_.find(unique_id);
-  if (id_it != id_to_kernel_runtime_.end()) {
+  if (id_it != id_to_kernel_runtime_.end() && !specialize_extents) {
     // If the forced index type is given, don't use the cached runtime
     // if its index type does not match with the forced type
     if (!forced_index_type.has_value() ||
         forced_index_type.value() == id_it->second->getIndexType()) {
+      KernelRuntimeLru::get().recordLookup(/*hit=*/true);
       return id_it->second;
     }
   }
@@ -743,15 +2108,26 @@ FusionKernelRuntime* FusionExecutorCache::getKernelRuntimeFor(
   const auto& initial_info = initialInfo();
 
   // Compute concretization info to use as cache key
-  DynamicTransformConcretizationInfo* conc_info = nullptr;
+  const DynamicTransformConcretizationInfo* conc_info = nullptr;
+  // Set only when conc_info is seen for the first time on this device
+  DynamicTransformConcretizationInfo* new_conc_info = nullptr;
   if (initial_info.isDynamic()) {
-    // This class needs to own conc_info so it can be compared in subsequent
-    // invocations.
     auto expr_eval = executor_utils::bindInputs(args, fusion_.get());
-    cached_conc_info_.emplace_back(
-        std::make_unique<DynamicTransformConcretizationInfo>(
-            &initial_info, &expr_eval));
-    conc_info = cached_conc_info_.back().get();
+    auto info = std::make_unique<DynamicTransformConcretizationInfo>(
+        &initial_info, &expr_eval, specialize_extents);
+    // Look up an equal concretization by its hash, so cached_conc_info_ only
+    // grows with new concretizations instead of with every new input shape.
+    auto existing_it = kernel_runtimes_.find(
+        std::make_pair(args.getDeviceIndex(), info.get()));
+    if (existing_it != kernel_runtimes_.end()) {
+      conc_info = existing_it->first.second;
+    } else {
+      // This class needs to own conc_info so it can be compared in subsequent
+      // invocations.
+      new_conc_info = info.get();
+      conc_info = new_conc_info;
+      cached_conc_info_.push_back(std::move(info));
+    }
   }
 
   // Initialize or fetch vector of FusionKernelRuntime objects associated with
@@ -764,12 +2140,51 @@ FusionKernelRuntime* FusionExecutorCache::getKernelRuntimeFor(
     deterministic_conc_info_.emplace_back(config);
   }
 
+  // Arguments with the same problem descriptor as earlier ones get the same
+  // heuristics, so the runtime picked for those is reused with its launch
+  // params without recomputing the heuristics of each runtime
+  std::vector<int64_t> descriptor;
+  size_t descriptor_hash = 0;
+  if (isOptionEnabled(EnableOption::HeuristicCache) &&
+      !isOptionDisabled(DisableOption::KernelReuse)) {
+    descriptor = heuristicProblemDescriptor(args);
+  }
+  if (!descriptor.empty()) {
+    descriptor.push_back(conc_info_id_map_.at(config));
+    descriptor.push_back(
+        forced_index_type.has_value() ? (int64_t)forced_index_type.value()
+                                      : -1);
+    for (int64_t value : descriptor) {
+      hashCombine(descriptor_hash, std::hash<int64_t>{}(value));
+    }
+    auto it = heuristic_cache_.find(descriptor_hash);
+    if (it != heuristic_cache_.end() &&
+        it->second.descriptor == descriptor &&
+        !it->second.runtime->isCompiling()) {
+      {
+        std::lock_guard<std::mutex> runtime_guard(
+            it->second.runtime->runMutex());
+        it->second.runtime->updateHeuristicsLaunchParams(
+            it->second.launch_params);
+      }
+      if (launch_params != nullptr) {
+        *launch_params = it->second.launch_params;
+      }
+      KernelRuntimeLru::get().recordLookup(/*hit=*/true);
+      id_to_kernel_runtime_[unique_id] = it->second.runtime;
+      return it->second.runtime;
+    }
+  }
+
   // Check for re-use hit case
   //  a kernel runtime is re-usable if all the compiled
   //  kernels have the same heuristic parameters
   std::unique_ptr<FusionHeuristics> new_heuristics;
 
   FusionKernelRuntime* kernel_runtime = nullptr;
+  // The launch params of kernel_runtime for args. Other calls running the
+  // runtime may change those of the runtime itself.
+  std::vector<LaunchParams> runtime_launch_params;
 
   bool reusing = false;
   // By default, we try to avoid recompiling whenever possible. However, this
@@ -783,6 +2198,11 @@ FusionKernelRuntime* FusionExecutorCache::getKernelRuntimeFor(
         kernel_runtimes.begin(),
         kernel_runtimes.end(),
         [&args, &new_heuristics, &forced_index_type](auto& kernel_runtime) {
+          // Heuristics of a runtime being compiled in the background can't
+          // be updated until it finishes
+          if (kernel_runtime->isCompiling()) {
+            return false;
+          }
           auto maybe_heuristics =
               kernel_runtime->getMaybeHeuristicsFor(args, forced_index_type);
           if (!maybe_heuristics.has_value()) {
@@ -793,42 +2213,27 @@ FusionKernelRuntime* FusionExecutorCache::getKernelRuntimeFor(
         });
     if (reuse_it != kernel_runtimes.end()) {
       kernel_runtime = reuse_it->get();
-      kernel_runtime->updateHeuristicsLaunchParams(new_heuristics.get());
+      {
+        std::lock_guard<std::mutex> runtime_guard(kernel_runtime->runMutex());
+        kernel_runtime->updateHeuristicsLaunchParams(new_heuristics.get());
+      }
+      for (const auto& scheduler_entry : new_heuristics->heuristicsList()) {
+        runtime_launch_params.push_back(scheduler_entry->params()->lparams);
+      }
       reusing = true;
     }
   }
 
   if (!reusing) {
     // cache miss, need to re-build an optimized graph for this case
-
-    // Clone fusion_ so that we can safely use an ExpressionEvaluator on it, for
-    // the purposes of computing the concretization info.
-    auto conc_fusion = std::make_unique<Fusion>(*fusion_);
-    if (initial_info.isDynamic()) {
-      const auto& conc_initial_info =
-          conc_fusion->getManaged<DynamicTransformInitialInfo>("initial_info");
-      NVF_ERROR(conc_info);
-      conc_info->setInitialInfo(&conc_initial_info);
-
-      if (isDebugDumpEnabled(DebugDumpOption::FusionIrConcretized)) {
-        debug() << "Fusion before concretization:" << std::endl;
-        conc_fusion->printMath();
-        debug() << conc_initial_info.toString() << std::endl;
-        debug() << conc_info->toString() << std::endl;
-      }
-
-      DynamicTransform::concretizeFusion(conc_fusion.get(), conc_info);
-      // Initial info is used during concretization and is owned by conc_fusion.
-      // After concretization, we stop managing it so that we won't keep cloning
-      // it for every subsequent Fusion copy.
-      conc_fusion->stopManaging("initial_info");
-
-      if (isDebugDumpEnabled(DebugDumpOption::FusionIrConcretized)) {
-        debug() << "Concretized Fusion:" << std::endl;
-        conc_fusion->print();
-      }
-    }
+    std::unique_ptr<Fusion> conc_fusion =
+        copyConcretizedFusion(config, new_conc_info);
     FusionGuard fg(conc_fusion.get());
+    // Runtimes may have been evicted, so the number of runtimes may be the id
+    // of an existing one
+    const int64_t runtime_id = kernel_runtimes.empty()
+        ? 0
+        : kernel_runtimes.back()->runtimeId() + 1;
     kernel_runtimes.emplace_back(std::make_unique<FusionKernelRuntime>(
         std::move(conc_fusion),
         args,
@@ -836,13 +2241,27 @@ FusionKernelRuntime* FusionExecutorCache::getKernelRuntimeFor(
         forced_index_type,
         fusion_id_,
         conc_info_id_map_.at(config),
-        kernel_runtimes.size(),
+        runtime_id,
         auto_schedule_));
     kernel_runtime = kernel_runtimes.back().get();
 
     if (profiling_) {
       kernel_runtime->profile(true);
     }
+    for (const auto& scheduler_entry : kernel_runtime->schedulers()) {
+      runtime_launch_params.push_back(scheduler_entry->params()->lparams);
+    }
+  }
+  KernelRuntimeLru::get().recordLookup(/*hit=*/reusing);
+
+  if (!descriptor.empty()) {
+    HeuristicCacheEntry& entry = heuristic_cache_[descriptor_hash];
+    entry.descriptor = std::move(descriptor);
+    entry.runtime = kernel_runtime;
+    entry.launch_params = runtime_launch_params;
+  }
+  if (launch_params != nullptr) {
+    *launch_params = std::move(runtime_launch_params);
   }
 
   id_to_kernel_runtime_[unique_id] = kernel_runtime;
@@ -866,6 +2285,14 @@ flatbuffers::Offset<serde::FusionExecutorCache> FusionExecutorCache::serialize(
 
   for (const auto& config : deterministic_conc_info_) {
     const auto& device_runtimes = kernel_runtimes_.at(config);
+    // All the runtimes of config may have been evicted. Shape-specialized
+    // runtimes aren't serialized, since deserialization recomputes the
+    // concretization info without the extents to specialize.
+    if (device_runtimes.empty() ||
+        (config.second != nullptr &&
+         !config.second->getSpecializedExtents().empty())) {
+      continue;
+    }
     std::vector<flatbuffers::Offset<serde::FusionKernelRuntime>>
         fb_device_runtimes;
     fb_device_runtimes.reserve(device_runtimes.size());
@@ -897,6 +2324,9 @@ flatbuffers::Offset<serde::FusionExecutorCache> FusionExecutorCache::serialize(
   kernel_cache_values.reserve(id_to_kernel_runtime_.size());
 
   for (auto&& [cache_id, kernel_runtime_ptr] : id_to_kernel_runtime_) {
+    if (kernel_cache_ordering.count(kernel_runtime_ptr) == 0) {
+      continue;
+    }
     kernel_cache_keys.push_back(cache_id);
     kernel_cache_values.push_back(kernel_cache_ordering.at(kernel_runtime_ptr));
   }
@@ -961,23 +2391,9 @@ void FusionExecutorCache::deserialize(
     }
 
     for (auto fb_fusion_kernel_runtime : *fb_device_runtimes->runtimes()) {
-      auto conc_fusion = std::make_unique<Fusion>(*fusion_);
-      FusionGuard fg(conc_fusion.get());
-
       // Concretize original unscheduled fusion_ for this kernel runtime
-      if (initial_info.isDynamic()) {
-        const auto& conc_initial_info =
-            conc_fusion->getManaged<DynamicTransformInitialInfo>(
-                "initial_info");
-        NVF_ERROR(conc_info != nullptr);
-        conc_info->setInitialInfo(&conc_initial_info);
-
-        DynamicTransform::concretizeFusion(conc_fusion.get(), conc_info);
-        // Initial info is used during concretization and is owned by
-        // conc_fusion. After concretization, we stop managing it so that we
-        // won't keep cloning it for every subsequent Fusion copy.
-        conc_fusion->stopManaging("initial_info");
-      }
+      auto conc_fusion = copyConcretizedFusion(config, conc_info);
+      FusionGuard fg(conc_fusion.get());
 
       // 1. Deserialize arguments for this FusionKernelRuntime
       KernelArgumentHolder args;
@@ -999,7 +2415,7 @@ void FusionExecutorCache::deserialize(
           std::nullopt,
           fusion_id_,
           fb_device_runtimes->concrete_id(),
-          device_runtimes.size()));
+          fb_fusion_kernel_runtime->runtime_id()));
 
       // 3. For FusionKernelRuntime, we have a separate deserialize function
       // to create the FusionExecutor objects.
@@ -1033,6 +2449,7 @@ FusionKernelRuntime::FusionKernelRuntime(
       runtime_id_{runtime_id},
       auto_schedule_{auto_schedule} {
   FUSER_PERF_SCOPE("FusionKernelRuntime::FusionKernelRuntime");
+  CompileStepScope step("FusionKernelRuntime::FusionKernelRuntime");
 
   NVF_ERROR(
       !fusion->hasDynamicTransform(),
@@ -1085,8 +2502,12 @@ FusionKernelRuntime::FusionKernelRuntime(
   // Pre-compute the executor order so that the run time path
   //  would go directly to kernel launch.
   prepareRuntimeOrder(segmented_fusion_.get(), runtime_workspace_);
+  prepareSegmentSlots(segmented_fusion_.get(), runtime_workspace_);
+  findStaticSegments();
 
   executors_ = std::vector<FusionExecutor>(segmented_fusion_->groups().size());
+  autotuned_candidates_ =
+      std::vector<int64_t>(segmented_fusion_->groups().size(), 0);
   if (isDebugDumpEnabled(DebugDumpOption::FusionSegments)) {
     segmented_fusion_->print();
   }
@@ -1125,7 +2546,8 @@ flatbuffers::Offset<serde::FusionKernelRuntime> FusionKernelRuntime::serialize(
       runtime_id_,
       args_metadata_.serialize(builder),
       &executors_fb,
-      segmented_fusion_fb);
+      segmented_fusion_fb,
+      &autotuned_candidates_);
 }
 
 void FusionKernelRuntime::deserialize(
@@ -1155,6 +2577,24 @@ void FusionKernelRuntime::deserialize(
     NVF_ERROR(
         !sg || scheduler_entry->heuristic() == sg->heuristic(),
         "Heuristics do not match.");
+    // Reschedule with the parameters the kernel was autotuned with. The
+    // candidates only depend on the analytic heuristics, which were
+    // recomputed from the same arguments.
+    if (buffer->autotuned_candidates() != nullptr &&
+        buffer->autotuned_candidates()->Get(group_id) > 0) {
+      const int64_t candidate = buffer->autotuned_candidates()->Get(group_id);
+      const auto candidates = getAutotuneCandidates(
+          scheduler_entry->heuristic(), scheduler_entry->params());
+      NVF_ERROR(
+          candidate < (int64_t)candidates.size(),
+          "Autotuning candidate ",
+          candidate,
+          " of segment ",
+          group_id,
+          " does not exist.");
+      scheduler_entry->setParams(candidates.at(candidate));
+      autotuned_candidates_.at(group_id) = candidate;
+    }
     auto fusion_to_run = segmented_fusion_->makeFusion(sg).second;
     FusionGuard fg(fusion_to_run.get());
     scheduler_entry->schedule(fusion_to_run.get());
@@ -1170,11 +2610,16 @@ void FusionKernelRuntime::deserialize(
         runtime_id_,
         group_id);
   }
+
+  if (isOptionEnabled(EnableOption::HorizontalFusion)) {
+    planHorizontalKernels();
+  }
 }
 
 std::vector<at::Tensor> FusionKernelRuntime::runKernelWithInput(
     KernelArgumentHolder& args,
-    SegmentedGroup* sg) {
+    SegmentedGroup* sg,
+    std::vector<at::Tensor> outputs) {
   FUSER_PERF_SCOPE("FusionKernelRuntime::runKernelWithInput");
   std::lock_guard<std::mutex> guard(mutex_);
   // This function will be called once on un-segmented fusion,
@@ -1184,6 +2629,28 @@ std::vector<at::Tensor> FusionKernelRuntime::runKernelWithInput(
   // In the case of complete fusion, sg = nullptr, and the original fusion
   // is complied and run.
   NVF_ERROR(sg, "runKernelWithInput: need valid group to run");
+
+  // The outputs of a segment only depending on static inputs are reused
+  // while its inputs don't change. Outputs given by the caller or a memory
+  // plan have to be written, and a captured graph must run every segment.
+  std::optional<StaticSegmentRun>* static_run = nullptr;
+  if (auto it = static_segment_runs_.find(sg->groupId());
+      it != static_segment_runs_.end() && outputs.empty() &&
+      c10::cuda::currentStreamCaptureStatusMayInitCtx() ==
+          c10::cuda::CaptureStatus::None) {
+    static_run = &it->second;
+    if (static_run->has_value() && (*static_run)->matches(args)) {
+      return (*static_run)->outputs;
+    }
+  }
+  // The executor appends the outputs to args
+  std::vector<PolymorphicValue> static_run_inputs;
+  if (static_run != nullptr) {
+    for (auto i : c10::irange(sg->inputs().size())) {
+      static_run_inputs.push_back(*args[i]);
+    }
+  }
+
   auto [launch_params, compile_params] = getKernelConfig(args, sg);
   auto group_id = sg->groupId();
   auto scheduler_entry = schedulers().at(group_id).get();
@@ -1194,17 +2661,58 @@ std::vector<at::Tensor> FusionKernelRuntime::runKernelWithInput(
     most_recent_executor_log_.params = scheduler_entry->params()->clone();
   }
 
-  if (isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose) ||
-      measure_kernel_time_) {
+  const bool log_bandwidth = isOptionEnabled(EnableOption::BandwidthLog);
+  const bool measure_kernel_time =
+      isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose) ||
+      measure_kernel_time_ || log_bandwidth;
+  // Times the launches sampled by the perf monitor
+  PerfMonitor* perf_monitor = PerfMonitor::get();
+  const bool monitor_kernel_time = perf_monitor != nullptr &&
+      perf_monitor->shouldSample(executor.numRuns());
+  if (measure_kernel_time || monitor_kernel_time) {
     executor.setMeasureKernelTimeFlag(true);
   }
 
+  // Bytes read by the segment, in total and of inputs of the complete fusion,
+  // counted before the executor appends to args
+  int64_t input_bytes = 0;
+  int64_t fusion_input_bytes = 0;
+  if (log_bandwidth) {
+    for (auto i : c10::irange(sg->inputs().size())) {
+      if (!args[i]->is<at::Tensor>()) {
+        continue;
+      }
+      const auto num_bytes =
+          (int64_t)args[i]->as<at::Tensor>().storage().nbytes();
+      input_bytes += num_bytes;
+      if (sg->inputs().at(i)->isFusionInput()) {
+        fusion_input_bytes += num_bytes;
+      }
+    }
+  }
+
   if (isProfilerEnabled()) {
     auto& sprof = FusionProfiler::segment(group_id);
     sprof.inputBytesAccessed(executor.inputBytesProcessed(args));
+    sprof.setHeuristic(toString(scheduler_entry->heuristic()));
     sprof.startKernel(args.getDeviceIndex());
   }
-  auto outputs = executor.runFusion(args, launch_params, compile_params);
+  outputs = executor.runFusion(
+      args, launch_params, compile_params, std::move(outputs));
+  if (static_run != nullptr) {
+    StaticSegmentRun run;
+    for (const auto& input : static_run_inputs) {
+      if (input.is<at::Tensor>()) {
+        run.input_versions.push_back(input.as<at::Tensor>()._version());
+      }
+    }
+    run.inputs = std::move(static_run_inputs);
+    run.outputs = outputs;
+    for (const auto& output : outputs) {
+      run.output_versions.push_back(output._version());
+    }
+    *static_run = std::move(run);
+  }
   if (isProfilerEnabled()) {
     auto& sprof = FusionProfiler::segment(group_id);
     sprof.stopKernel();
@@ -1212,7 +2720,43 @@ std::vector<at::Tensor> FusionKernelRuntime::runKernelWithInput(
   }
 
   // Accumulate the kernel time of each segment
-  kernel_time_ms_ += executor.kernelTimeMs();
+  if (measure_kernel_time) {
+    kernel_time_ms_ += executor.kernelTimeMs();
+  }
+
+  if (monitor_kernel_time) {
+    if (executor.hasCompiledKernel()) {
+      perf_monitor->record(
+          executor.kernelName(),
+          *scheduler_entry->params(),
+          executor.kernelTimeMs());
+    }
+    if (!measure_kernel_time) {
+      executor.setMeasureKernelTimeFlag(false);
+    }
+  }
+
+  if (log_bandwidth && executor.hasCompiledKernel()) {
+    SegmentBandwidth record;
+    record.fusion_id = fusion_id_;
+    record.segment_id = group_id;
+    record.kernel_name = executor.kernelName();
+    record.heuristic = toString(scheduler_entry->heuristic());
+    record.params = scheduler_entry->params()->toString();
+    record.device = args.getDeviceIndex();
+    record.time_ms = executor.kernelTimeMs();
+    record.actual_bytes = input_bytes;
+    record.ideal_bytes = fusion_input_bytes;
+    for (auto i : c10::irange(outputs.size())) {
+      const auto num_bytes =
+          (int64_t)(outputs[i].numel() * outputs[i].element_size());
+      record.actual_bytes += num_bytes;
+      if (sg->outputs().at(i)->isFusionOutput()) {
+        record.ideal_bytes += num_bytes;
+      }
+    }
+    recordSegmentBandwidth(record);
+  }
 
   // Print relevant information all at once for easy debuging of perf
   if (isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose) &&
@@ -1339,16 +2883,271 @@ void FusionKernelRuntime::compileFusionParallel(KernelArgumentHolder args) {
         thread_pool_error_message,
         "\nUse NVFUSER_DISABLE=parallel_compile to simplify error message.");
   }
+  if (isOptionEnabled(EnableOption::HorizontalFusion)) {
+    planHorizontalKernels();
+  }
   if (isProfilerEnabled()) {
     FusionProfiler::stopCompile();
   }
 }
 
+bool FusionKernelRuntime::StaticSegmentRun::matches(
+    const KernelArgumentHolder& args) const {
+  auto input_version = input_versions.begin();
+  for (auto i : c10::irange(inputs.size())) {
+    if (!isSame(inputs.at(i), *args[i])) {
+      return false;
+    }
+    if (inputs.at(i).is<at::Tensor>() &&
+        inputs.at(i).as<at::Tensor>()._version() != *input_version++) {
+      return false;
+    }
+  }
+  for (auto i : c10::irange(outputs.size())) {
+    if (outputs.at(i)._version() != output_versions.at(i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void FusionKernelRuntime::findStaticSegments() {
+  Fusion* fusion = segmented_fusion_->completeFusion();
+  std::unordered_set<Val*> static_tvs;
+  for (auto index :
+       preseg_passes::SegmentStaticSubgraphsPass::getStaticInputs(fusion)) {
+    static_tvs.insert(fusion->inputs().at(index));
+  }
+  if (static_tvs.empty()) {
+    return;
+  }
+
+  for (SegmentedGroup* group : runtime_workspace_.group_run_order) {
+    const auto& inputs = group->inputs();
+    const bool is_static =
+        std::any_of(
+            inputs.begin(),
+            inputs.end(),
+            [](Val* inp) { return inp->isA<TensorView>(); }) &&
+        std::all_of(
+            inputs.begin(),
+            inputs.end(),
+            [&](Val* inp) {
+              return !inp->isA<TensorView>() || static_tvs.count(inp) != 0;
+            }) &&
+        std::none_of(
+            group->exprs().begin(),
+            group->exprs().end(),
+            [](Expr* expr) { return expr->isA<RNGOp>(); }) &&
+        std::none_of(
+            group->outputs().begin(), group->outputs().end(), [&](Val* out) {
+              return fusion->getOutputAlias(out).type ==
+                  AllocationType::ReuseBuffer;
+            });
+    if (!is_static) {
+      continue;
+    }
+    static_segment_runs_.emplace(group->groupId(), std::nullopt);
+    static_tvs.insert(group->outputs().begin(), group->outputs().end());
+  }
+}
+
+void FusionKernelRuntime::planHorizontalKernels() {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::planHorizontalKernels");
+  horizontal_kernels_.clear();
+  if (!is_segmented_) {
+    return;
+  }
+
+  int64_t max_kernels = 8;
+  const auto& option_args =
+      getEnableOptionArguments(EnableOption::HorizontalFusion);
+  if (!option_args.empty()) {
+    try {
+      max_kernels = std::stol(option_args[0]);
+    } catch (const std::exception& e) {
+      debug() << "skip invalid argument for HorizontalFusion, arg = "
+              << option_args[0] << std::endl;
+    }
+  }
+
+  auto can_fuse = [this](SegmentedGroup* sg) {
+    return schedulers().at(sg->groupId())->heuristic() ==
+        ScheduleHeuristic::PointWise &&
+        HorizontalKernel::canFuse(executors_.at(sg->groupId()));
+  };
+
+  // Inputs of sg that its kernel updates in place
+  auto written_inputs = [this](SegmentedGroup* sg) {
+    std::vector<Val*> written;
+    const kir::Kernel* kernel = executors_.at(sg->groupId()).kernel();
+    for (Val* output : kernel->outputs()) {
+      const AliasInfo& alias_info = kernel->getOutputAlias(output);
+      if (alias_info.type != AllocationType::ReuseBuffer) {
+        continue;
+      }
+      auto input_it = std::find(
+          kernel->inputs().begin(),
+          kernel->inputs().end(),
+          alias_info.aliased_io);
+      NVF_ERROR(input_it != kernel->inputs().end());
+      written.push_back(
+          sg->inputs().at(std::distance(kernel->inputs().begin(), input_it)));
+    }
+    return written;
+  };
+
+  const auto& run_order = runtime_workspace_.group_run_order;
+  const int64_t num_groups = (int64_t)run_order.size();
+  int64_t begin = 0;
+  while (begin < num_groups) {
+    std::unordered_set<Val*> read;
+    std::unordered_set<Val*> written;
+    int64_t end = begin;
+    for (; end < num_groups && end - begin < max_kernels; ++end) {
+      SegmentedGroup* sg = run_order.at(end);
+      if (!can_fuse(sg)) {
+        break;
+      }
+      const auto sg_written = written_inputs(sg);
+      const bool depends_on_batch =
+          std::any_of(
+              sg->inputs().begin(),
+              sg->inputs().end(),
+              [&written](Val* input) { return written.count(input); }) ||
+          std::any_of(sg_written.begin(), sg_written.end(), [&read](Val* v) {
+            return read.count(v);
+          });
+      if (depends_on_batch) {
+        break;
+      }
+      read.insert(sg->inputs().begin(), sg->inputs().end());
+      written.insert(sg->outputs().begin(), sg->outputs().end());
+      written.insert(sg_written.begin(), sg_written.end());
+    }
+
+    if (end - begin < 2) {
+      ++begin;
+      continue;
+    }
+    std::vector<FusionExecutor*> executors;
+    for (auto run_order_id : c10::irange(begin, end)) {
+      SegmentedGroup* sg = run_order.at(run_order_id);
+      executors.push_back(&executors_.at(sg->groupId()));
+    }
+    horizontal_kernels_[begin] =
+        std::make_unique<HorizontalKernel>(std::move(executors));
+    begin = end;
+  }
+}
+
+void FusionKernelRuntime::compileFusionAsync(
+    const KernelArgumentHolder& args) {
+  NVF_ERROR(!async_compile_.valid(), "Fusion is already being compiled");
+  // Cloned here since the complete fusion must not be cloned concurrently
+  // with the segments in the background
+  if (eager_fusion_ == nullptr) {
+    eager_fusion_ =
+        std::make_unique<Fusion>(*segmented_fusion_->completeFusion());
+    const std::vector<Expr*> exprs = eager_fusion_->exprs();
+    eager_evaluatable_ =
+        std::none_of(exprs.begin(), exprs.end(), [](Expr* expr) {
+          return expr->isOneOf<
+              RNGOp,
+              GatherOp,
+              ShiftOp,
+              MmaOp,
+              GroupedWelfordOp>();
+        });
+  }
+  // compileFusionParallel waits for all the work in getThreadPool(), so it
+  // is run in its own thread instead of as a task of that pool.
+  async_compile_ = std::async(
+      std::launch::async, [this, args]() { compileFusionParallel(args); });
+}
+
+int64_t FusionKernelRuntime::memoryFootprint() const {
+  // Rough size of a Statement of the IR, including its containers
+  constexpr int64_t bytes_per_statement = 256;
+  int64_t bytes = 0;
+  for (const auto& executor : executors_) {
+    bytes += executor.compiledKernelBytes();
+  }
+  Fusion* fusion = segmented_fusion_->completeFusion();
+  bytes += bytes_per_statement *
+      (int64_t)(fusion->vals().size() + fusion->unordered_exprs().size());
+  return bytes;
+}
+
+bool FusionKernelRuntime::isCompiling() {
+  if (!async_compile_.valid()) {
+    return false;
+  }
+  if (async_compile_.wait_for(std::chrono::seconds(0)) !=
+      std::future_status::ready) {
+    return true;
+  }
+  waitForAsyncCompile();
+  return false;
+}
+
+void FusionKernelRuntime::waitForAsyncCompile() {
+  if (async_compile_.valid()) {
+    // Resets async_compile_ and rethrows any error from compilation
+    async_compile_.get();
+  }
+}
+
+std::optional<std::vector<at::Tensor>> FusionKernelRuntime::
+    runWithExpressionEvaluator(const KernelArgumentHolder& args) {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::runWithExpressionEvaluator");
+  NVF_ERROR(eager_fusion_ != nullptr);
+  if (!eager_evaluatable_) {
+    return std::nullopt;
+  }
+
+  c10::cuda::CUDAGuard dg((c10::DeviceIndex)args.getDeviceIndex());
+  std::vector<at::Tensor> outputs;
+  try {
+    auto expr_eval = executor_utils::bindInputs(args, eager_fusion_.get());
+    for (Val* output : eager_fusion_->outputs()) {
+      const PolymorphicValue& out_value = expr_eval.evaluate(output);
+      if (!out_value.is<at::Tensor>()) {
+        return std::nullopt;
+      }
+      at::Tensor out_tensor = out_value.as<at::Tensor>();
+      // Outputs reusing the buffer of an input, e.g. running statistics, are
+      // updated in place like the kernel would do
+      const AliasInfo& alias_info = eager_fusion_->getOutputAlias(output);
+      if (alias_info.type == AllocationType::ReuseBuffer) {
+        at::Tensor aliased_input =
+            expr_eval.evaluate(alias_info.aliased_io).as<at::Tensor>();
+        if (alias_info.slice_start != nullptr) {
+          aliased_input = aliased_input.narrow(
+              alias_info.slice_dim,
+              expr_eval.evaluate(alias_info.slice_start).as<int64_t>(),
+              out_tensor.size(alias_info.slice_dim));
+        }
+        aliased_input.copy_(out_tensor);
+        out_tensor = aliased_input;
+      }
+      outputs.push_back(out_tensor);
+    }
+  } catch (const nvfError&) {
+    // An op whose evaluate doesn't support its dtype or op type, e.g. some
+    // unary ops. Errors from ATen, e.g. running out of memory, are real
+    // failures and are propagated.
+    return std::nullopt;
+  }
+  return outputs;
+}
+
 void FusionKernelRuntime::compileKernel(
     const KernelArgumentHolder& args,
     SegmentedGroup* sg) {
   FUSER_PERF_SCOPE("FusionKernelRuntime::compileKernel");
   auto group_id = sg->groupId();
+  CompileStepScope step("FusionKernelRuntime::compileKernel", group_id);
   if (isProfilerEnabled()) {
     FusionProfiler::segment(group_id).startCompile(args.getDeviceIndex());
   }
@@ -1364,53 +3163,636 @@ void FusionKernelRuntime::compileKernel(
   if (isDebugDumpEnabled(DebugDumpOption::FusionIrPresched)) {
     fusion_to_run->printMath();
   }
+  // The profiler would report the launches of the candidates as launches of
+  // the segment
+  if (auto_schedule_ && isOptionEnabled(EnableOption::Autotune) &&
+      !isProfilerEnabled()) {
+    autotuneKernel(args, sg);
+  }
+  const bool register_pressure_fallback = auto_schedule_ &&
+      isOptionEnabled(EnableOption::RegisterPressureFallback);
+  if (register_pressure_fallback) {
+    reduceRegisterPressure(sg);
+  }
   FusionGuard fg(fusion_to_run.get());
   if (auto_schedule_) {
+    CompileStepScope schedule_step("SchedulerEntry::schedule");
     scheduler_entry->schedule(fusion_to_run.get());
   }
   NVF_ERROR(
       scheduler_entry->params()->cparams.index_type.has_value(),
       "Kernel index type is not defined.");
-  executors_.at(group_id).compileFusion(
-      fusion_to_run.get(),
-      args,
-      scheduler_entry->params()->lparams,
-      scheduler_entry->params()->cparams,
-      scheduler_entry->heuristic(),
-      fusion_id_,
-      concrete_id_,
-      runtime_id_,
-      group_id);
+  auto compile = [&](Fusion* fusion) {
+    CompileParams cparams = scheduler_entry->params()->cparams;
+    // Spills are only reported in the verbose log of ptxas
+    cparams.enable_ptxas_verbose |= register_pressure_fallback;
+    executors_.at(group_id).compileFusion(
+        fusion,
+        args,
+        scheduler_entry->params()->lparams,
+        cparams,
+        scheduler_entry->heuristic(),
+        fusion_id_,
+        concrete_id_,
+        runtime_id_,
+        group_id);
+  };
+  compile(fusion_to_run.get());
+  // The estimate misses spills, e.g. of indexing, so recompile with the
+  // fallbacks until ptxas doesn't spill anymore
+  while (register_pressure_fallback &&
+         executors_.at(group_id).getKernelRegisterSpills() > 0) {
+    auto fallback = getRegisterPressureFallback(
+        scheduler_entry->heuristic(), scheduler_entry->params());
+    if (fallback == nullptr) {
+      break;
+    }
+    if (isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
+      debug() << "Segment " << group_id << " spills "
+              << executors_.at(group_id).getKernelRegisterSpills()
+              << " bytes, recompiling with" << fallback->toString()
+              << std::endl;
+    }
+    scheduler_entry->setParams(fallback);
+    auto fallback_fusion = segmented_fusion_->makeFusion(sg).second;
+    FusionGuard fallback_fg(fallback_fusion.get());
+    scheduleAutotuneCandidate(
+        scheduler_entry->heuristic(), fallback_fusion.get(), *fallback);
+    executors_.at(group_id) = FusionExecutor();
+    compile(fallback_fusion.get());
+  }
   if (isProfilerEnabled()) {
     FusionProfiler::segment(group_id).stopCompile();
   }
 }
 
-std::pair<LaunchParams, CompileParams> FusionKernelRuntime::getKernelConfig(
+void FusionKernelRuntime::reduceRegisterPressure(SegmentedGroup* sg) {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::reduceRegisterPressure");
+  const int64_t group_id = sg->groupId();
+  SchedulerEntry* scheduler_entry = schedulers().at(group_id).get();
+  const ScheduleHeuristic heuristic = scheduler_entry->heuristic();
+  std::shared_ptr<HeuristicParams> params = scheduler_entry->params();
+  while (auto fallback = getRegisterPressureFallback(heuristic, params)) {
+    auto fusion_to_run = segmented_fusion_->makeFusion(sg).second;
+    FusionGuard fg(fusion_to_run.get());
+    scheduleAutotuneCandidate(heuristic, fusion_to_run.get(), *params);
+    const int64_t registers = scheduler_utils::estimateScheduledRegisterUsage(
+        fusion_to_run.get(), params->cparams);
+    const int64_t register_limit = std::min(
+        params->cparams.maxrregcount,
+        scheduler_utils::max_registers_per_thread);
+    if (registers <= register_limit) {
+      break;
+    }
+    if (isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
+      debug() << "Segment " << group_id << " is estimated to use " << registers
+              << " registers per thread, falling back to"
+              << fallback->toString() << std::endl;
+    }
+    params = fallback;
+  }
+  scheduler_entry->setParams(params);
+}
+
+void FusionKernelRuntime::autotuneKernel(
     const KernelArgumentHolder& args,
     SegmentedGroup* sg) {
-  FUSER_PERF_SCOPE("FusionKernelRuntime::getKernelConfig");
-  auto group_id = sg->groupId();
-  auto scheduler_entry = schedulers().at(group_id).get();
-
-  // Check that the heuristics are matched, in the case of segmented fusion
-  NVF_ERROR(!sg || scheduler_entry->heuristic() == sg->heuristic());
+  FUSER_PERF_SCOPE("FusionKernelRuntime::autotuneKernel");
+  const int64_t group_id = sg->groupId();
+  SchedulerEntry* scheduler_entry = schedulers().at(group_id).get();
+  // The heuristics already replay the fastest parameters the heuristic DB
+  // recorded for this problem
+  HeuristicDb* heuristic_db = HeuristicDb::get();
+  const std::string signature = scheduler_entry->params()->problem_signature;
+  if (heuristic_db != nullptr && !signature.empty() &&
+      heuristic_db->best(signature).has_value()) {
+    return;
+  }
+  const std::vector<std::shared_ptr<HeuristicParams>> candidates =
+      getAutotuneCandidates(
+          scheduler_entry->heuristic(),
+          scheduler_entry->params(),
+          maxAutotuneCandidates());
+  if (candidates.size() < 2) {
+    return;
+  }
+
+  const std::vector<LaunchConfigSweepResult> results =
+      benchmarkCandidates(args, sg, candidates);
+  int64_t best_candidate = -1;
+  for (const auto& result : results) {
+    if (!result.valid) {
+      continue;
+    }
+    if (best_candidate < 0 ||
+        result.time_ms < results.at(best_candidate).time_ms) {
+      best_candidate = result.candidate;
+    }
+    if (heuristic_db != nullptr && !signature.empty()) {
+      heuristic_db->record(
+          signature,
+          heuristic_plugin::getConfigKnobs(*result.params),
+          result.time_ms);
+    }
+  }
+  if (heuristic_db != nullptr && !signature.empty() &&
+      !heuristic_db->sync()) {
+    TORCH_WARN(
+        "nvFuser's heuristic DB could not be written to ",
+        heuristic_db->dbFile().string());
+  }
+  NVF_ERROR(
+      best_candidate >= 0,
+      "No autotuning candidate of segment ",
+      group_id,
+      " could be compiled and launched");
+
+  autotuned_candidates_.at(group_id) = best_candidate;
+  scheduler_entry->setParams(candidates.at(best_candidate));
+}
+
+std::vector<LaunchConfigSweepResult> FusionKernelRuntime::benchmarkCandidates(
+    const KernelArgumentHolder& args,
+    SegmentedGroup* sg,
+    const std::vector<std::shared_ptr<HeuristicParams>>& candidates) {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::benchmarkCandidates");
+  const int64_t group_id = sg->groupId();
+  SchedulerEntry* scheduler_entry = schedulers().at(group_id).get();
+  const int64_t num_candidates = (int64_t)candidates.size();
+  std::vector<LaunchConfigSweepResult> results(num_candidates);
+  for (auto i : c10::irange(num_candidates)) {
+    results[i].segment_id = group_id;
+    results[i].candidate = i;
+    results[i].params = candidates[i];
+  }
+
+  // Compile the candidates in parallel. compileKernel may itself be a task of
+  // getThreadPool(), so they get their own threads. Candidates that fail to
+  // compile are dropped.
+  std::vector<std::unique_ptr<FusionExecutor>> executors(num_candidates);
+  std::vector<std::future<void>> compiles;
+  compiles.reserve(num_candidates);
+  for (auto i : c10::irange(num_candidates)) {
+    compiles.push_back(std::async(std::launch::async, [&, i]() {
+      try {
+        c10::cuda::CUDAGuard dg(args.getDeviceIndex());
+        auto fusion_to_run = segmented_fusion_->makeFusion(sg).second;
+        FusionGuard fg(fusion_to_run.get());
+        scheduleAutotuneCandidate(
+            scheduler_entry->heuristic(), fusion_to_run.get(), *candidates[i]);
+        auto executor = std::make_unique<FusionExecutor>();
+        executor->compileFusion(
+            fusion_to_run.get(),
+            args,
+            candidates[i]->lparams,
+            candidates[i]->cparams,
+            scheduler_entry->heuristic(),
+            fusion_id_,
+            concrete_id_,
+            runtime_id_,
+            group_id);
+        executors[i] = std::move(executor);
+      } catch (const std::exception& e) {
+        if (isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
+          debug() << "Candidate " << i << " of segment " << group_id
+                  << " failed to compile: " << e.what() << std::endl;
+        }
+      }
+    }));
+  }
+  for (auto& compile : compiles) {
+    compile.wait();
+  }
+
+  // Benchmark one candidate at a time, even if segments are compiled in
+  // parallel, so that their kernels don't compete for the GPU
+  static std::mutex benchmark_mutex;
+  std::lock_guard<std::mutex> guard(benchmark_mutex);
+  c10::cuda::CUDAGuard dg(args.getDeviceIndex());
+  KernelArgumentHolder benchmark_args;
+  benchmark_args.setDeviceIndex(args.getDeviceIndex());
+  for (const auto& arg : args) {
+    if (arg->is<at::Tensor>() && !arg->as<at::Tensor>().is_cpu()) {
+      benchmark_args.push(
+          copyForBenchmark(arg->as<at::Tensor>(), args.getDeviceIndex()));
+    } else {
+      benchmark_args.push(*arg);
+    }
+  }
+  CudaEventTimer timer(at::cuda::getCurrentCUDAStream());
+  for (auto i : c10::irange(num_candidates)) {
+    if (executors[i] == nullptr) {
+      continue;
+    }
+    try {
+      // The first launch is a warmup that also checks the launch parameters
+      executors[i]->runFusion(
+          benchmark_args, candidates[i]->lparams, candidates[i]->cparams);
+      timer.reset();
+      timer.start();
+      for (auto iter : c10::irange(autotune_iterations)) {
+        (void)iter; // Suppress unused variable warning
+        executors[i]->runFusion(
+            benchmark_args, candidates[i]->lparams, candidates[i]->cparams);
+      }
+      timer.stop();
+    } catch (const std::exception& e) {
+      if (isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
+        debug() << "Candidate " << i << " of segment " << group_id
+                << " failed to launch: " << e.what() << std::endl;
+      }
+      continue;
+    }
+    LaunchConfigSweepResult& result = results[i];
+    result.valid = true;
+    result.time_ms = timer.time() / (double)autotune_iterations;
+    result.launch_params = executors[i]->lastLaunchParams();
+    if (executors[i]->hasCompiledKernel()) {
+      result.occupancy =
+          executors[i]->computeKernelOccupancy(result.launch_params);
+    }
+    if (isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
+      debug() << "Candidate " << i << " of segment " << group_id << ": "
+              << result.time_ms << " ms" << candidates[i]->toString()
+              << std::endl;
+    }
+  }
+  return results;
+}
+
+std::vector<LaunchConfigSweepResult> FusionKernelRuntime::sweepLaunchConfigs(
+    KernelArgumentHolder args,
+    int64_t max_candidates) {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::sweepLaunchConfigs");
+  NVF_CHECK(
+      isCompiled(),
+      "The kernel runtime needs to be compiled to sweep its launch configs");
+  std::lock_guard<std::mutex> guard(mutex_);
+  ArgumentManager args_manager(
+      args, runtime_workspace_, segmented_fusion_->inputs());
+
+  std::vector<LaunchConfigSweepResult> results;
+  const int64_t num_groups = (int64_t)runtime_workspace_.group_run_order.size();
+  for (int64_t run_order_id = 0; run_order_id < num_groups; ++run_order_id) {
+    auto group_to_run = runtime_workspace_.group_run_order.at(run_order_id);
+    KernelArgumentHolder group_runtime_inputs;
+    group_runtime_inputs.setDeviceIndex(args.getDeviceIndex());
+    for (auto input : group_to_run->inputs()) {
+      group_runtime_inputs.push(*args_manager.checkTensorMap(input));
+    }
+
+    SchedulerEntry* scheduler_entry =
+        schedulers().at(group_to_run->groupId()).get();
+    auto group_results = benchmarkCandidates(
+        group_runtime_inputs,
+        group_to_run,
+        getAutotuneCandidates(
+            scheduler_entry->heuristic(),
+            scheduler_entry->params(),
+            max_candidates));
+    for (auto& result : group_results) {
+      if (!result.valid) {
+        continue;
+      }
+      result.pareto_optimal = std::none_of(
+          group_results.begin(),
+          group_results.end(),
+          [&result](const LaunchConfigSweepResult& other) {
+            return other.valid && other.time_ms < result.time_ms &&
+                other.occupancy > result.occupancy;
+          });
+    }
+    results.insert(results.end(), group_results.begin(), group_results.end());
+
+    // Later segments only need the metadata of the outputs, since their
+    // inputs are copied for benchmarking
+    auto fusion_to_run = segmented_fusion_->makeFusion(group_to_run).second;
+    auto group_runtime_outputs =
+        executors_[group_to_run->groupId()].inferOutputSizes(
+            fusion_to_run.get(), group_runtime_inputs);
+    args_manager.updateWithSegmentOutputs(
+        group_to_run->outputs(), group_runtime_outputs, run_order_id);
+  }
+  return results;
+}
+
+std::string toString(const std::vector<LaunchConfigSweepResult>& results) {
+  auto dims = [](int64_t x, int64_t y, int64_t z) {
+    std::stringstream ss;
+    ss << "(" << x << ", " << y << ", " << z << ")";
+    return ss.str();
+  };
+  std::stringstream ss;
+  int64_t segment_id = -1;
+  for (const auto& result : results) {
+    if (result.segment_id != segment_id) {
+      segment_id = result.segment_id;
+      ss << "Segment " << segment_id << ":\n"
+         << "   candidate                grid          block   time_ms"
+         << "  occupancy  knobs\n";
+    }
+    ss << (result.pareto_optimal ? " * " : "   ") << std::setw(9)
+       << result.candidate;
+    if (result.valid) {
+      const LaunchParams& lparams = result.launch_params;
+      ss << std::setw(20)
+         << dims(lparams.gdimx(), lparams.gdimy(), lparams.gdimz())
+         << std::setw(15)
+         << dims(lparams.bdimx(), lparams.bdimy(), lparams.bdimz())
+         << std::setw(10) << std::fixed << std::setprecision(4)
+         << result.time_ms << std::setw(10) << std::setprecision(1)
+         << result.occupancy << "%  ";
+    } else {
+      ss << std::setw(56) << "failed" << "  ";
+    }
+    const std::vector<int64_t> knobs =
+        heuristic_plugin::getConfigKnobs(*result.params);
+    for (auto i : c10::irange(knobs.size())) {
+      ss << (i > 0 ? "," : "") << knobs[i];
+    }
+    ss << "\n";
+  }
+  return ss.str();
+}
+
+std::pair<LaunchParams, CompileParams> FusionKernelRuntime::getKernelConfig(
+    const KernelArgumentHolder& args,
+    SegmentedGroup* sg) {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::getKernelConfig");
+  auto group_id = sg->groupId();
+  auto scheduler_entry = schedulers().at(group_id).get();
+
+  // Check that the heuristics are matched, in the case of segmented fusion
+  NVF_ERROR(!sg || scheduler_entry->heuristic() == sg->heuristic());
 
   return std::make_pair(
       scheduler_entry->params()->lparams, scheduler_entry->params()->cparams);
 }
 
 std::vector<at::Tensor> FusionKernelRuntime::runWithInputs(
-    KernelArgumentHolder& args) {
+    KernelArgumentHolder& args,
+    const std::vector<at::Tensor>& outputs) {
   FUSER_PERF_SCOPE("FusionKernelRuntime::runWithInputs");
+  NVF_CHECK(
+      outputs.empty() || outputs.size() == segmented_fusion_->outputs().size(),
+      "Expected ",
+      segmented_fusion_->outputs().size(),
+      " outputs but got ",
+      outputs.size());
+
+  // A replayed graph writes to the buffers it was captured with
+  if (outputs.empty() && canUseCudaGraph(args)) {
+    return runWithCudaGraph(args);
+  }
+  return runSegmentsAndGetOutputs(args, outputs);
+}
 
+bool FusionKernelRuntime::canUseCudaGraph(
+    const KernelArgumentHolder& args) const {
+  if (!isOptionEnabled(EnableOption::CudaGraph) ||
+      !args.getCacheId().has_value()) {
+    return false;
+  }
+  // Profiling and kernel timing record events and synchronize on the host,
+  // neither of which is allowed during stream capture. They would also be
+  // meaningless for a replayed graph.
+  if (profiling_ || measure_kernel_time_ || isProfilerEnabled() ||
+      isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose) ||
+      isDebugDumpEnabled(DebugDumpOption::EffectiveBandwidth) ||
+      isOptionEnabled(EnableOption::KernelProfile)) {
+    return false;
+  }
+  // Segments evaluated by ExpressionEvaluator may run arbitrary ATen
+  // functions, some of which synchronize with the host. Only capture
+  // FusionKernelRuntimes made of nvFuser kernels.
+  if (!std::all_of(executors_.begin(), executors_.end(), [](const auto& fe) {
+        return fe.hasCompiledKernel();
+      })) {
+    return false;
+  }
+  // Nested capture is not supported
+  return c10::cuda::currentStreamCaptureStatusMayInitCtx() ==
+      c10::cuda::CaptureStatus::None;
+}
+
+std::vector<at::Tensor> FusionKernelRuntime::runWithCudaGraph(
+    KernelArgumentHolder& args) {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::runWithCudaGraph");
+
+  // args is extended with segment outputs while running, so the input
+  // pointers must be gathered before anything is launched.
+  std::vector<void*> input_ptrs;
+  input_ptrs.reserve(args.size());
+  for (const auto& arg : args) {
+    input_ptrs.push_back(
+        arg->is<at::Tensor>() ? arg->as<at::Tensor>().data_ptr() : nullptr);
+  }
+
+  CudaGraphEntry& entry = cuda_graphs_[args.getCacheId().value()];
+
+  if (entry.graph != nullptr && entry.input_ptrs == input_ptrs) {
+    FUSER_PERF_SCOPE("FusionKernelRuntime::runWithCudaGraph::replay");
+    entry.graph->replay();
+    return entry.outputs;
+  }
+
+  if (entry.input_ptrs != input_ptrs) {
+    // New inputs. Run eagerly once so that all per-input state, such as
+    // ExecutorEntry and any recompilation, is set up outside of capture.
+    entry.graph.reset();
+    entry.outputs.clear();
+    entry.input_ptrs = std::move(input_ptrs);
+    return runSegmentsAndGetOutputs(args);
+  }
+
+  // Capture has to happen on a non-default stream. Make the capture stream
+  // wait for the work already queued on the current stream.
+  const auto device_index = (c10::DeviceIndex)args.getDeviceIndex();
+  c10::cuda::CUDAStream current_stream =
+      c10::cuda::getCurrentCUDAStream(device_index);
+  c10::cuda::CUDAStream capture_stream =
+      c10::cuda::getStreamFromPool(/*isHighPriority=*/false, device_index);
+  at::cuda::CUDAEvent ready_event;
+  ready_event.record(current_stream);
+  ready_event.block(capture_stream);
+
+  auto graph = std::make_unique<at::cuda::CUDAGraph>();
+  {
+    FUSER_PERF_SCOPE("FusionKernelRuntime::runWithCudaGraph::capture");
+    c10::cuda::CUDAStreamGuard stream_guard(capture_stream);
+    graph->capture_begin();
+    entry.outputs = runSegmentsAndGetOutputs(args);
+    graph->capture_end();
+  }
+  entry.graph = std::move(graph);
+
+  // Nothing has been executed yet during capture
+  entry.graph->replay();
+  return entry.outputs;
+}
+
+std::vector<at::Tensor> FusionKernelRuntime::SegmentMemoryPlan::
+    allocateOutputs(
+        int64_t run_order_id,
+        const at::Tensor& arena,
+        int64_t device_index) const {
+  std::vector<at::Tensor> outputs;
+  for (const auto& planned_output : segment_outputs.at(run_order_id)) {
+    // An empty arena means all planned intermediates are empty tensors
+    if (!planned_output.in_arena || !arena.defined()) {
+      outputs.push_back(at::empty_strided(
+          planned_output.sizes,
+          planned_output.strides,
+          at::TensorOptions()
+              .dtype(planned_output.dtype)
+              .device(at::kCUDA, device_index)));
+      continue;
+    }
+    // Offsets are aligned to at least the element size of any type
+    const auto element_size = (int64_t)at::elementSize(planned_output.dtype);
+    NVF_ERROR(planned_output.offset % element_size == 0);
+    at::Tensor output =
+        at::empty({0}, arena.options().dtype(planned_output.dtype));
+    output.set_(
+        arena.storage(),
+        planned_output.offset / element_size,
+        planned_output.sizes,
+        planned_output.strides);
+    outputs.push_back(std::move(output));
+  }
+  return outputs;
+}
+
+const FusionKernelRuntime::SegmentMemoryPlan& FusionKernelRuntime::
+    getMemoryPlan(const KernelArgumentHolder& args) {
+  NVF_ERROR(
+      args.getCacheId().has_value(),
+      "Segment memory planning requires an input cache id");
+  if (auto it = memory_plans_.find(*args.getCacheId());
+      it != memory_plans_.end()) {
+    return it->second;
+  }
+  FUSER_PERF_SCOPE("FusionKernelRuntime::getMemoryPlan");
+
+  // Dry run of the segments that only propagates output sizes
+  KernelArgumentHolder mutable_args(args);
+  ArgumentManager args_manager(
+      mutable_args, runtime_workspace_, segmented_fusion_->inputs());
+
+  const int64_t num_groups = (int64_t)runtime_workspace_.group_run_order.size();
+  std::unordered_map<Val*, int64_t> last_use;
+  for (auto run_order_id : c10::irange(num_groups)) {
+    for (Val* input :
+         runtime_workspace_.group_run_order.at(run_order_id)->inputs()) {
+      last_use[input] = run_order_id;
+    }
+  }
+
+  SegmentMemoryPlan memory_plan;
+  memory_plan.segment_outputs.resize(num_groups);
+  std::vector<BufferLifetime> lifetimes;
+  // (run order, output index) of each buffer in lifetimes
+  std::vector<std::pair<int64_t, size_t>> arena_outputs;
+
+  for (auto run_order_id : c10::irange(num_groups)) {
+    auto group_to_run = runtime_workspace_.group_run_order.at(run_order_id);
+    KernelArgumentHolder group_runtime_inputs;
+    group_runtime_inputs.setDeviceIndex(args.getDeviceIndex());
+    for (auto input : group_to_run->inputs()) {
+      group_runtime_inputs.push(*args_manager.checkTensorMap(input));
+    }
+
+    Fusion* group_fusion = group_to_run->getFusion();
+    auto group_runtime_outputs =
+        executors_.at(group_to_run->groupId())
+            .inferOutputSizes(group_fusion, group_runtime_inputs);
+
+    // Outputs can only be provided all at once, so a segment is planned
+    // only when all of its outputs are plain new buffers written by a
+    // kernel
+    const auto& outputs = group_to_run->outputs();
+    bool plannable =
+        executors_.at(group_to_run->groupId()).hasCompiledKernel() &&
+        std::unordered_set<Val*>(outputs.begin(), outputs.end()).size() ==
+            outputs.size();
+    for (auto i : c10::irange(outputs.size())) {
+      Val* output = outputs.at(i);
+      plannable = plannable && output->isA<TensorView>() &&
+          output->dtype() != DataType::Index &&
+          std::find(
+              group_to_run->inputs().begin(),
+              group_to_run->inputs().end(),
+              output) == group_to_run->inputs().end() &&
+          group_fusion->getOutputAlias(group_fusion->outputs().at(i)).type ==
+              AllocationType::New &&
+          (!output->isFusionOutput() ||
+           segmented_fusion_->completeFusion()->getOutputAlias(output).type ==
+               AllocationType::New);
+    }
+
+    if (plannable) {
+      auto& planned_outputs = memory_plan.segment_outputs.at(run_order_id);
+      for (auto i : c10::irange(outputs.size())) {
+        const auto& meta_tensor = group_runtime_outputs[i]->as<at::Tensor>();
+        PlannedOutput planned_output;
+        planned_output.sizes = meta_tensor.sizes().vec();
+        planned_output.strides = meta_tensor.strides().vec();
+        planned_output.dtype = meta_tensor.scalar_type();
+        if (!outputs.at(i)->isFusionOutput()) {
+          planned_output.in_arena = true;
+          int64_t span = 1;
+          for (auto dim : c10::irange(planned_output.sizes.size())) {
+            if (planned_output.sizes[dim] == 0) {
+              span = 0;
+              break;
+            }
+            span +=
+                (planned_output.sizes[dim] - 1) * planned_output.strides[dim];
+          }
+          auto it = last_use.find(outputs.at(i));
+          lifetimes.push_back(
+              {run_order_id,
+               it == last_use.end() ? run_order_id : it->second,
+               span * (int64_t)at::elementSize(planned_output.dtype)});
+          arena_outputs.emplace_back(run_order_id, i);
+        }
+        planned_outputs.push_back(std::move(planned_output));
+      }
+    }
+
+    args_manager.updateWithSegmentOutputs(
+        group_to_run->outputs(), group_runtime_outputs, run_order_id);
+  }
+
+  memory_plan.plan = planMemory(lifetimes);
+  for (auto i : c10::irange(arena_outputs.size())) {
+    const auto& [run_order_id, output_idx] = arena_outputs.at(i);
+    memory_plan.segment_outputs.at(run_order_id).at(output_idx).offset =
+        memory_plan.plan.offsets.at(i);
+  }
+
+  return memory_plans_[*args.getCacheId()] = std::move(memory_plan);
+}
+
+std::vector<at::Tensor> FusionKernelRuntime::runSegmentsAndGetOutputs(
+    KernelArgumentHolder& args,
+    const std::vector<at::Tensor>& outputs) {
   if (isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
     debug() << "=================RUNNING FUSION SEGMENTS================="
             << std::endl;
   }
 
+  if (canUseSegmentSlots(outputs)) {
+    auto fusion_outputs = runSegmentsWithSlots(args);
+    if (isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
+      debug() << "============= FINISHED RUNNING FUSION SEGMENTS ============"
+              << std::endl;
+    }
+    return fusion_outputs;
+  }
+
   c10::Device device(c10::DeviceType::CUDA, (int8_t)args.getDeviceIndex());
-  const auto& tensor_map = runSegmentsWithInputs(args);
+  const auto& tensor_map = runSegmentsWithInputs(args, outputs);
 
   if (isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
     debug() << "============= FINISHED RUNNING FUSION SEGMENTS ============"
@@ -1429,11 +3811,151 @@ std::vector<at::Tensor> FusionKernelRuntime::runWithInputs(
     const PolymorphicValue* runtime_output = tensor_map.at(output);
     fusion_outputs.push_back(runtime_output->as<at::Tensor>());
   }
+
+  // Outputs that were not written in place, e.g. aliases, forwarded inputs
+  // or outputs of segments evaluated by ExpressionEvaluator
+  for (auto i : c10::irange(outputs.size())) {
+    const at::Tensor& given = outputs[i];
+    if (!given.defined()) {
+      continue;
+    }
+    if (!fusion_outputs[i].is_same(given)) {
+      NVF_CHECK(
+          given.sizes() == fusion_outputs[i].sizes(),
+          "Output ",
+          i,
+          " has sizes ",
+          given.sizes(),
+          " but expected ",
+          fusion_outputs[i].sizes());
+      given.copy_(fusion_outputs[i]);
+      fusion_outputs[i] = given;
+    }
+  }
+  return fusion_outputs;
+}
+
+void FusionKernelRuntime::substituteGivenOutputs(
+    SegmentedGroup* sg,
+    const std::unordered_map<Val*, at::Tensor>& given_outputs,
+    std::vector<at::Tensor>& segment_outputs) const {
+  // Segments evaluated by ExpressionEvaluator make their own outputs, which
+  // are copied into the given tensors afterwards
+  const FusionExecutor& executor = executors_.at(sg->groupId());
+  if (!executor.hasCompiledKernel()) {
+    return;
+  }
+  const std::vector<Val*>& kernel_outputs = executor.kernel()->outputs();
+  NVF_ERROR(kernel_outputs.size() == sg->outputs().size());
+  for (auto i : c10::irange(sg->outputs().size())) {
+    auto it = given_outputs.find(sg->outputs()[i]);
+    if (it == given_outputs.end() ||
+        executor.kernel()->getOutputAlias(kernel_outputs[i]).type !=
+            AllocationType::New) {
+      continue;
+    }
+    segment_outputs.resize(sg->outputs().size());
+    segment_outputs[i] = it->second;
+  }
+}
+
+bool FusionKernelRuntime::canUseSegmentSlots(
+    const std::vector<at::Tensor>& outputs) const {
+  if (!isOptionEnabled(EnableOption::SegmentSlots) || !outputs.empty() ||
+      isProfilerEnabled() ||
+      isDebugDumpEnabled(DebugDumpOption::PerfDebugVerbose)) {
+    return false;
+  }
+  if (is_segmented_ &&
+      (isOptionEnabled(EnableOption::MultiStreamSegments) ||
+       isOptionEnabled(EnableOption::SegmentMemoryPlanning))) {
+    return false;
+  }
+  return horizontal_kernels_.empty() ||
+      !isOptionEnabled(EnableOption::HorizontalFusion);
+}
+
+std::vector<at::Tensor> FusionKernelRuntime::runSegmentsWithSlots(
+    KernelArgumentHolder& args) {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::runSegmentsWithSlots");
+  const int64_t num_inputs = (int64_t)segmented_fusion_->inputs().size();
+  NVF_ERROR(
+      (int64_t)args.size() == num_inputs,
+      "Inputs were not set up correctly, received ",
+      args.size(),
+      " inputs but expected ",
+      num_inputs);
+
+  const int64_t num_groups = (int64_t)runtime_workspace_.group_run_order.size();
+  num_live_args_after_segment_runs_.reserve(num_groups);
+  kernel_time_ms_ = 0;
+
+  std::vector<PolymorphicValue> slots(runtime_workspace_.num_slots);
+  int64_t num_live_slots = num_inputs;
+  int64_t extent_index = 0;
+  for (auto i : c10::irange(num_inputs)) {
+    slots[i] = *args[i];
+    if (!slots[i].is<at::Tensor>()) {
+      continue;
+    }
+    // Extents are counted as live even when their slot is shared, as
+    // ArgumentManager pushes all of them to the arguments
+    const at::Tensor& tensor = slots[i].as<at::Tensor>();
+    for (auto dim : c10::irange(tensor.dim())) {
+      int64_t slot = runtime_workspace_.extent_slots.at(extent_index++);
+      if (slot >= 0) {
+        slots[slot] = PolymorphicValue(tensor.size(dim));
+      }
+      num_live_slots++;
+    }
+  }
+
+  for (auto run_order_id : c10::irange(num_groups)) {
+    SegmentedGroup* group_to_run =
+        runtime_workspace_.group_run_order.at(run_order_id);
+    KernelArgumentHolder group_runtime_inputs;
+    group_runtime_inputs.setDeviceIndex(args.getDeviceIndex());
+    if (args.getCacheId().has_value()) {
+      group_runtime_inputs.setCacheId(args.getCacheId().value());
+    }
+    for (int64_t slot : runtime_workspace_.group_input_slots.at(run_order_id)) {
+      group_runtime_inputs.push(slots[slot]);
+    }
+
+    std::vector<at::Tensor> group_runtime_outputs =
+        runKernelWithInput(group_runtime_inputs, group_to_run);
+
+    const auto& output_slots =
+        runtime_workspace_.group_output_slots.at(run_order_id);
+    NVF_ERROR(
+        output_slots.size() == group_runtime_outputs.size(),
+        "Output size does not match.");
+    for (auto i : c10::irange(output_slots.size())) {
+      if (output_slots[i] >= 0) {
+        slots[output_slots[i]] = std::move(group_runtime_outputs[i]);
+        num_live_slots++;
+      }
+    }
+    for (int64_t slot :
+         runtime_workspace_.group_released_slots.at(run_order_id)) {
+      slots[slot] = PolymorphicValue();
+      num_live_slots--;
+    }
+    num_live_args_after_segment_runs_.push_back(num_live_slots);
+  }
+
+  std::vector<at::Tensor> fusion_outputs;
+  fusion_outputs.reserve(runtime_workspace_.fusion_output_slots.size());
+  for (int64_t slot : runtime_workspace_.fusion_output_slots) {
+    fusion_outputs.push_back(slots[slot].as<at::Tensor>());
+  }
   return fusion_outputs;
 }
 
 std::unordered_map<Val*, const PolymorphicValue*> FusionKernelRuntime::
-    runSegmentsWithInputs(KernelArgumentHolder& args) {
+    runSegmentsWithInputs(
+        KernelArgumentHolder& args,
+        const std::vector<at::Tensor>& outputs) {
   NVF_ERROR(
       args.size() == segmented_fusion_->inputs().size(),
       "Inputs were not set up correctly, received ",
@@ -1446,15 +3968,91 @@ std::unordered_map<Val*, const PolymorphicValue*> FusionKernelRuntime::
 
   int64_t total_bytes_processed = 0;
 
-  ArgumentManager args_manager(
-      args, runtime_workspace_, segmented_fusion_->inputs());
-
   // group should share cache id.
   auto group_cache_id = args.getCacheId();
   const int64_t num_groups = (int64_t)runtime_workspace_.group_run_order.size();
   num_live_args_after_segment_runs_.reserve(num_groups);
   kernel_time_ms_ = 0;
+
+  // Kernel timing synchronizes each segment with the host, which would
+  // serialize the streams anyway.
+  std::unique_ptr<SegmentStreamScheduler> stream_scheduler;
+  if (is_segmented_ && isOptionEnabled(EnableOption::MultiStreamSegments) &&
+      !measure_kernel_time_ && !compute_overall_bw && !isProfilerEnabled()) {
+    int64_t num_streams = 4;
+    const auto& option_args =
+        getEnableOptionArguments(EnableOption::MultiStreamSegments);
+    if (!option_args.empty()) {
+      try {
+        num_streams = std::stol(option_args[0]);
+      } catch (const std::exception& e) {
+        debug() << "skip invalid argument for MultiStreamSegments, arg = "
+                << option_args[0] << std::endl;
+      }
+    }
+    if (num_streams > 1) {
+      stream_scheduler = std::make_unique<SegmentStreamScheduler>(
+          runtime_workspace_,
+          (c10::DeviceIndex)args.getDeviceIndex(),
+          num_streams);
+    }
+  }
+
+  // The memory plan assumes segments run one after another in run order, so
+  // it is not used when segments run concurrently on multiple streams.
+  const SegmentMemoryPlan* memory_plan = nullptr;
+  at::Tensor arena;
+  if (is_segmented_ && group_cache_id.has_value() &&
+      stream_scheduler == nullptr &&
+      isOptionEnabled(EnableOption::SegmentMemoryPlanning)) {
+    memory_plan = &getMemoryPlan(args);
+    if (memory_plan->plan.arena_bytes > 0) {
+      arena = at::empty(
+          {memory_plan->plan.arena_bytes},
+          at::TensorOptions()
+              .dtype(at::kByte)
+              .device(at::kCUDA, args.getDeviceIndex()));
+    }
+    if (isProfilerEnabled()) {
+      FusionProfiler::intermediateBytesAllocated(
+          memory_plan->plan.total_bytes, memory_plan->plan.arena_bytes);
+    }
+  }
+
+  ArgumentManager args_manager(
+      args, runtime_workspace_, segmented_fusion_->inputs());
+
+  // The first given tensor of each fusion output, which can appear more than
+  // once in the outputs
+  std::unordered_map<Val*, at::Tensor> given_outputs;
+  for (auto i : c10::irange(outputs.size())) {
+    if (outputs[i].defined()) {
+      given_outputs.emplace(segmented_fusion_->outputs().at(i), outputs[i]);
+    }
+  }
+
+  // The segments of a horizontal kernel run one by one with their launches
+  // deferred, which are then issued together after the last of them. Their
+  // inputs are kept alive until then. The memory plan and the streams assume
+  // that segments finish in run order, and timing needs separate launches.
+  const bool use_horizontal_kernels = !horizontal_kernels_.empty() &&
+      isOptionEnabled(EnableOption::HorizontalFusion) &&
+      stream_scheduler == nullptr && memory_plan == nullptr &&
+      !measure_kernel_time_ && !compute_overall_bw && !isProfilerEnabled();
+  HorizontalKernel* horizontal_kernel = nullptr;
+  int64_t horizontal_kernel_end = -1;
+  std::vector<KernelArgumentHolder> deferred_inputs;
+  std::vector<std::optional<FusionExecutor::DeferredLaunch>> deferred_launches;
+
   for (auto run_order_id : c10::irange(num_groups)) {
+    if (use_horizontal_kernels && horizontal_kernel == nullptr) {
+      if (auto it = horizontal_kernels_.find(run_order_id);
+          it != horizontal_kernels_.end()) {
+        horizontal_kernel = it->second.get();
+        horizontal_kernel_end = run_order_id + horizontal_kernel->numKernels();
+      }
+    }
+
     // TODO: index mode should be updated per segmented kernel
     // Prepare input vector
     auto group_to_run = runtime_workspace_.group_run_order.at(run_order_id);
@@ -1470,13 +4068,49 @@ std::unordered_map<Val*, const PolymorphicValue*> FusionKernelRuntime::
     // TODO: currently we are still outputing PyTorch tensors, instead of
     // something abstract. This is quite unsatisfying.
 
+    std::vector<at::Tensor> segment_outputs;
+    if (memory_plan != nullptr) {
+      segment_outputs = memory_plan->allocateOutputs(
+          run_order_id, arena, args.getDeviceIndex());
+    }
+    if (!given_outputs.empty()) {
+      substituteGivenOutputs(group_to_run, given_outputs, segment_outputs);
+    }
+
     // Run graph segment
-    std::vector<at::Tensor> group_runtime_outputs =
-        runKernelWithInput(group_runtime_inputs, group_to_run);
+    std::vector<at::Tensor> group_runtime_outputs;
+    if (stream_scheduler != nullptr) {
+      c10::cuda::CUDAStreamGuard stream_guard(stream_scheduler->beginSegment(
+          run_order_id,
+          runtime_workspace_.group_producers.at(run_order_id),
+          group_runtime_inputs));
+      group_runtime_outputs = runKernelWithInput(
+          group_runtime_inputs, group_to_run, std::move(segment_outputs));
+      stream_scheduler->endSegment(run_order_id);
+    } else if (horizontal_kernel != nullptr) {
+      auto& executor = executors_.at(group_to_run->groupId());
+      executor.setDeferLaunchFlag(true);
+      group_runtime_outputs = runKernelWithInput(
+          group_runtime_inputs, group_to_run, std::move(segment_outputs));
+      executor.setDeferLaunchFlag(false);
+      deferred_launches.push_back(executor.takeDeferredLaunch());
+      deferred_inputs.push_back(group_runtime_inputs);
+    } else {
+      group_runtime_outputs = runKernelWithInput(
+          group_runtime_inputs, group_to_run, std::move(segment_outputs));
+    }
     args_manager.updateWithSegmentOutputs(
         group_to_run->outputs(), group_runtime_outputs, run_order_id);
     num_live_args_after_segment_runs_.push_back((int64_t)args.size());
 
+    if (horizontal_kernel != nullptr &&
+        run_order_id + 1 == horizontal_kernel_end) {
+      horizontal_kernel->launch(deferred_launches, args.getDeviceIndex());
+      horizontal_kernel = nullptr;
+      deferred_launches.clear();
+      deferred_inputs.clear();
+    }
+
     if (compute_overall_bw) {
       const auto& executor = executors_.at(group_to_run->groupId());
       for (auto bytes : executor.bytesInputsProcessed()) {
@@ -1488,6 +4122,18 @@ std::unordered_map<Val*, const PolymorphicValue*> FusionKernelRuntime::
     }
   }
 
+  if (stream_scheduler != nullptr) {
+    std::vector<at::Tensor> fusion_outputs;
+    for (Val* output : segmented_fusion_->outputs()) {
+      const PolymorphicValue* runtime_output =
+          args_manager.checkTensorMap(output);
+      if (runtime_output->is<at::Tensor>()) {
+        fusion_outputs.push_back(runtime_output->as<at::Tensor>());
+      }
+    }
+    stream_scheduler->join(fusion_outputs);
+  }
+
   if (isProfilerEnabled()) {
     int64_t input_bytes = 0;
     for (auto inp : fusionSegments()->inputs()) {
@@ -1612,6 +4258,15 @@ void FusionKernelRuntime::updateHeuristicsLaunchParams(
   }
 }
 
+void FusionKernelRuntime::updateHeuristicsLaunchParams(
+    const std::vector<LaunchParams>& launch_params) {
+  FUSER_PERF_SCOPE("FusionKernelRuntime::updateHeuristicsLaunchParams");
+  NVF_ERROR(launch_params.size() == heuristics_->heuristicsList().size());
+  for (const auto i : c10::irange(launch_params.size())) {
+    heuristics_->heuristicsList()[i]->updateLaunchConstraint(launch_params[i]);
+  }
+}
+
 std::optional<FusionKernelRuntime::HeuristicsPtr> FusionKernelRuntime::
     getMaybeHeuristicsFor(
         const KernelArgumentHolder& args,
@@ -1625,14 +4280,28 @@ std::optional<FusionKernelRuntime::HeuristicsPtr> FusionKernelRuntime::
   FusionKernelRuntime::HeuristicsPtr heuristics =
       std::make_unique<FusionHeuristics>(num_groups);
 
+  // Under a shape bucketing policy, the kernels compiled for the first inputs
+  // of a bucket are kept for other inputs of the same bucket
+  const bool same_shape_bucket = heuristics_ != nullptr &&
+      isOptionEnabled(EnableOption::ShapeBuckets) &&
+      shapeBucketOf(args) == shapeBucketOf(args_metadata_);
+
   // We make a mutable copy of args so that we can use it in an ArgumentManager
   KernelArgumentHolder mutable_args(args);
   ArgumentManager args_manager(
       mutable_args, runtime_workspace_, segmented_fusion_->inputs());
 
-  // Follow group run order
+  // The inputs of a group depend on the outputs of the groups before it, so
+  // they are inferred in run order first. This also creates the fusions of
+  // all groups, which must not be done concurrently as they are copied from
+  // the complete fusion.
+  std::vector<KernelArgumentHolder> all_group_runtime_inputs(num_groups);
+  std::vector<std::unique_ptr<PrecomputedValues>> all_precomputed_values(
+      num_groups);
   for (int64_t group_id : c10::irange(num_groups)) {
     auto group_to_run = runtime_workspace_.group_run_order.at(group_id);
+    CompileStepScope step(
+        "FusionKernelRuntime::inferOutputSizes", group_to_run->groupId());
 
     // Create fusion for this segmented group
     Fusion* fusion_to_run = group_to_run->getFusion();
@@ -1640,13 +4309,15 @@ std::optional<FusionKernelRuntime::HeuristicsPtr> FusionKernelRuntime::
     FusionGuard fg(fusion_to_run);
 
     // Get input arguments for SchedulerRuntimeInfo
-    KernelArgumentHolder group_runtime_inputs;
+    KernelArgumentHolder& group_runtime_inputs =
+        all_group_runtime_inputs.at(group_id);
     for (auto input : group_to_run->inputs()) {
       group_runtime_inputs.push(*args_manager.checkTensorMap(input));
     }
 
     // Create PrecomputedValues for fusion segment
-    auto evaluator_precomputed_values =
+    auto& evaluator_precomputed_values = all_precomputed_values.at(group_id);
+    evaluator_precomputed_values =
         std::make_unique<PrecomputedValues>(fusion_to_run);
     evaluator_precomputed_values->bindInputs(group_runtime_inputs);
     // TODO Remove binding the original fusion inputs when creating heuristics
@@ -1655,14 +4326,35 @@ std::optional<FusionKernelRuntime::HeuristicsPtr> FusionKernelRuntime::
         group_to_run->getCompleteFusionInputs(), args);
     evaluator_precomputed_values->evaluate();
 
+    // Generate metadata for the fusion's outputs
+    auto group_runtime_outputs = executors_.at(group_to_run->groupId())
+                                     .inferOutputSizes(
+                                         fusion_to_run,
+                                         group_runtime_inputs,
+                                         evaluator_precomputed_values.get());
+    args_manager.updateWithSegmentOutputs(
+        group_to_run->outputs(), group_runtime_outputs, group_id);
+  }
+
+  // Returns false if the heuristics of the group don't match the ones this
+  // runtime was compiled with. Groups only use their own fusion and
+  // HeuristicSummary, so this can run concurrently for different groups.
+  auto compute_heuristics = [&](int64_t group_id) -> bool {
+    auto group_to_run = runtime_workspace_.group_run_order.at(group_id);
+    CompileStepScope step(
+        "FusionKernelRuntime::getMaybeHeuristicsFor", group_to_run->groupId());
+
+    Fusion* fusion_to_run = group_to_run->getFusion();
+    FusionGuard fg(fusion_to_run);
+
     // Get all tensorviews for segmented fusion
     std::vector<TensorView*> all_tvs_for_fusion_to_run =
         ir_utils::allTvs(fusion_to_run);
 
     SchedulerRuntimeInfo fusion_to_run_info(
         fusion_to_run,
-        group_runtime_inputs,
-        evaluator_precomputed_values.get(),
+        all_group_runtime_inputs.at(group_id),
+        all_precomputed_values.at(group_id).get(),
         all_tvs_for_fusion_to_run,
         forced_index_type);
 
@@ -1671,33 +4363,72 @@ std::optional<FusionKernelRuntime::HeuristicsPtr> FusionKernelRuntime::
       heuristics->at(group_to_run->groupId()) =
           segmented_fusion_->makeInitialSchedulerEntry(
               group_to_run, fusion_to_run_info);
-    } else {
-      // Try to get scheduler entry
-      auto maybe_scheduler_entry =
-          group_to_run->getMaybeSchedulerEntry(fusion_to_run_info);
-      // If unavailable, then return std::nullopt
-      if (!maybe_scheduler_entry.has_value()) {
-        return std::nullopt;
+      return true;
+    }
+
+    // Try to get scheduler entry
+    auto maybe_scheduler_entry =
+        group_to_run->getMaybeSchedulerEntry(fusion_to_run_info);
+    // If unavailable, then return std::nullopt
+    if (!maybe_scheduler_entry.has_value()) {
+      return false;
+    }
+    // Check if this scheduler entry matches the previous entry for this
+    // segmented group. If no match, then return std::nullptr
+    auto scheduler_entry = std::move(maybe_scheduler_entry.value());
+    SchedulerEntry* prev_entry = heuristics_->at(group_to_run->groupId()).get();
+    if (!scheduler_entry->sameAs(prev_entry)) {
+      if (!same_shape_bucket ||
+          scheduler_entry->heuristic() != prev_entry->heuristic() ||
+          !isValidInShapeBucket(
+              prev_entry->params(), scheduler_entry->params())) {
+        return false;
       }
-      // Check if this scheduler entry matches the previous entry for this
-      // segmented group. If no match, then return std::nullptr
-      auto scheduler_entry = std::move(maybe_scheduler_entry.value());
-      if (!scheduler_entry->sameAs(
-              heuristics_->at(group_to_run->groupId()).get())) {
+      // Only the launch parameters of the returned heuristics are used to
+      // update this runtime, so keep the ones the kernel was compiled with
+      scheduler_entry->updateLaunchConstraint(prev_entry->params()->lparams);
+    }
+    // Add new scheduler entry for this segmented group
+    heuristics->at(group_to_run->groupId()) = std::move(scheduler_entry);
+    return true;
+  };
+
+  if (num_groups == 1 || isOptionDisabled(DisableOption::ParallelCompile)) {
+    for (int64_t group_id : c10::irange(num_groups)) {
+      if (!compute_heuristics(group_id)) {
         return std::nullopt;
       }
-      // Add new scheduler entry for this segmented group
-      heuristics->at(group_to_run->groupId()) = std::move(scheduler_entry);
     }
+    return heuristics;
+  }
 
-    // Generate metadata for the fusion's outputs
-    auto group_runtime_outputs = executors_.at(group_to_run->groupId())
-                                     .inferOutputSizes(
-                                         fusion_to_run,
-                                         group_runtime_inputs,
-                                         evaluator_precomputed_values.get());
-    args_manager.updateWithSegmentOutputs(
-        group_to_run->outputs(), group_runtime_outputs, group_id);
+  std::atomic<bool> all_match = true;
+  std::mutex error_message_mutex;
+  std::string error_message;
+  runOnThreadPool(num_groups, [&](int64_t group_id) {
+    FUSER_PERF_SCOPE("FusionKernelRuntime::getMaybeHeuristicsForParallel");
+    try {
+      c10::cuda::CUDAGuard dg(args.getDeviceIndex());
+      if (!compute_heuristics(group_id)) {
+        all_match.store(false);
+      }
+    } catch (const std::exception& e) {
+      const std::lock_guard<std::mutex> lock(error_message_mutex);
+      std::stringstream ss;
+      ss << error_message << "\nError from segmentation group "
+         << runtime_workspace_.group_run_order.at(group_id)->groupId() << ": "
+         << e.what() << "\n";
+      error_message = ss.str();
+    }
+  });
+  NVF_ERROR(
+      error_message.empty(),
+      "Detected exception while computing heuristics of fusion segments in ",
+      "parallel. Error messages from all threads are printed below.\n",
+      error_message,
+      "\nUse NVFUSER_DISABLE=parallel_compile to simplify error message.");
+  if (!all_match.load()) {
+    return std::nullopt;
   }
   return heuristics;
 }
@@ -13,15 +13,25 @@
 #include <executor.h>
 #include <fusion.h>
 #include <fusion_segmenter.h>
+#include <horizontal_fusion.h>
+#include <memory_planner.h>
 #include <scheduler/all_schedulers.h>
 #include <scheduler/registry.h>
 #include <serde/fusion_cache_generated.h>
 
+#include <ATen/cuda/CUDAGraph.h>
 #include <c10/util/ArrayRef.h>
 
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <future>
+#include <list>
 #include <mutex>
+#include <shared_mutex>
 #include <type_traits>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace nvfuser {
 
@@ -35,12 +45,68 @@ struct ExecutorLog {
   FusionExecutor* fusion_executor = nullptr;
 };
 
+//! \struct LaunchConfigSweepResult
+//! \brief The time and occupancy of a segment scheduled with one heuristic
+//! parameters candidate, see FusionExecutorCache::sweepLaunchConfigs.
+struct LaunchConfigSweepResult {
+  int64_t segment_id = -1;
+  //! Index in getAutotuneCandidates, 0 being the analytic heuristics
+  int64_t candidate = -1;
+  std::shared_ptr<HeuristicParams> params = nullptr;
+  //! Launch parameters of the timed launches, i.e. params->lparams with
+  //! the dimensions bound at launch time
+  LaunchParams launch_params;
+  //! False if the candidate failed to compile or to launch
+  bool valid = false;
+  //! Mean time of a launch
+  double time_ms = 0.0;
+  //! Theoretical occupancy, in percent of the warps an SM can hold
+  float occupancy = 0.0f;
+  //! True if no other valid candidate of the segment is both faster and has
+  //! a higher occupancy
+  bool pareto_optimal = false;
+};
+
+//! Prints the results of a sweep as a table per segment, with the
+//! pareto-optimal candidates marked by a *
+NVF_API std::string toString(
+    const std::vector<LaunchConfigSweepResult>& results);
+
 struct RuntimeWorkSpace {
   //! Pre-determined order to run the segmented groups
   std::vector<SegmentedGroup*> group_run_order;
 
   //! Pre-determined order to bind tensor input meta data
   std::vector<Val*> group_extent_binding_order;
+
+  //! For each group in group_run_order, the positions in group_run_order
+  //! of the groups producing its inputs. Groups that only consume fusion
+  //! inputs have no producers.
+  std::vector<std::vector<int64_t>> group_producers;
+
+  //! Argument slots resolved by prepareSegmentSlots, see
+  //! EnableOption::SegmentSlots. Every fusion input, bound extent and
+  //! segment output is given a slot, and the segments read and write slots
+  //! by position instead of looking their values up by Val.
+  int64_t num_slots = 0;
+
+  //! Slot of each entry of group_extent_binding_order, or -1 if the extent
+  //! is already bound, e.g. by an input scalar or a previous tensor input.
+  std::vector<int64_t> extent_slots;
+
+  //! For each group in group_run_order, the slots of its inputs
+  std::vector<std::vector<int64_t>> group_input_slots;
+
+  //! For each group in group_run_order, the slots of its outputs, or -1 for
+  //! outputs that are already bound, e.g. forwarded inputs
+  std::vector<std::vector<int64_t>> group_output_slots;
+
+  //! For each group in group_run_order, the slots that are released after
+  //! it runs as no later group reads them
+  std::vector<std::vector<int64_t>> group_released_slots;
+
+  //! Slot of each output of the segmented fusion
+  std::vector<int64_t> fusion_output_slots;
 };
 //! Simple hasher for pair<T, const U*>. There is no default hasher for pairs,
 //! since there are a lot of options how to combine hashes. In a case where one
@@ -81,6 +147,10 @@ struct PairPointerEquals {
 // Fusion
 void prepareRuntimeOrder(SegmentedFusion*, RuntimeWorkSpace&);
 
+// Resolve the argument slots of the segments in the run order computed by
+// prepareRuntimeOrder
+void prepareSegmentSlots(SegmentedFusion*, RuntimeWorkSpace&);
+
 //! FusionKernelRuntime is the unified interface from fusion graphs into
 //!  caching, compilation into kernels, and kernel launches.
 //!
@@ -117,6 +187,8 @@ class FusionKernelRuntime {
     for (auto& fe : executors_) {
       fe.evictCache(input_id);
     }
+    cuda_graphs_.erase(input_id);
+    memory_plans_.erase(input_id);
   }
 
   //! query if we have already attempted compilation
@@ -150,12 +222,46 @@ class FusionKernelRuntime {
   }
 
   //! Unified interface to run the managed kernels with given input
-  NVF_API std::vector<at::Tensor> runWithInputs(KernelArgumentHolder& args);
+  //!
+  //! outputs is either empty or has one entry per output of the complete
+  //! fusion. Defined entries are written to in place. The segment producing
+  //! an output writes directly into the given tensor when it's a kernel
+  //! allocating that output; otherwise, e.g. for aliases and outputs
+  //! evaluated by ExpressionEvaluator, the result is copied into it. The
+  //! returned vector holds the given tensors in their positions.
+  NVF_API std::vector<at::Tensor> runWithInputs(
+      KernelArgumentHolder& args,
+      const std::vector<at::Tensor>& outputs = {});
 
   //! Compile a kernel executor for given inputs. Note: The compilation is
   //! multithreaded. The segments in the fusion are compiled independently.
   NVF_API void compileFusionParallel(KernelArgumentHolder args);
 
+  //! Runs compileFusionParallel in a background thread. See
+  //! EnableOption::AsyncCompile. While it is in progress, only isCompiling,
+  //! waitForAsyncCompile, runWithExpressionEvaluator and evictCache may be
+  //! called on this runtime.
+  void compileFusionAsync(const KernelArgumentHolder& args);
+
+  //! Returns true while a background compilation is in progress. Errors
+  //! thrown by a finished background compilation are rethrown here.
+  bool isCompiling();
+
+  //! Blocks until the background compilation, if any, has finished
+  void waitForAsyncCompile();
+
+  //! Whether a background compilation was started and its result has not
+  //! been collected by isCompiling or waitForAsyncCompile yet
+  bool hasAsyncCompile() const {
+    return async_compile_.valid();
+  }
+
+  //! Runs the complete fusion without kernels through ExpressionEvaluator,
+  //! which is used while the kernels are being compiled in the background.
+  //! Returns std::nullopt if some expression can't be evaluated.
+  std::optional<std::vector<at::Tensor>> runWithExpressionEvaluator(
+      const KernelArgumentHolder& args);
+
   const std::vector<int64_t>& getArgsNumAfterSegmentRuns() {
     return num_live_args_after_segment_runs_;
   }
@@ -194,6 +300,17 @@ class FusionKernelRuntime {
     }
   }
 
+  //! ID of this runtime among the runtimes of a (device, concretization
+  //! info) key of its FusionExecutorCache
+  int64_t runtimeId() const {
+    return runtime_id_;
+  }
+
+  //! Estimate of the host memory held by this runtime in bytes, i.e. its
+  //! compiled kernels and its fusion IR, which is used to bound the memory of
+  //! all runtimes, see KernelRuntimeLru
+  int64_t memoryFootprint() const;
+
   //! Returns if this runtime is segmented
   bool isSegmented() const {
     return is_segmented_;
@@ -232,30 +349,130 @@ class FusionKernelRuntime {
   //!  for kernel launch for a new input dimension but same heuristics
   void updateHeuristicsLaunchParams(FusionHeuristics* update_heuristics);
 
+  //! Same as above with the launch params of each segment in launch_params,
+  //!  e.g., as recorded in FusionExecutorCache::heuristic_cache_
+  void updateHeuristicsLaunchParams(
+      const std::vector<LaunchParams>& launch_params);
+
   const std::vector<FusionExecutor>& executors() const {
     return executors_;
   }
 
+  std::vector<FusionExecutor>& executors() {
+    return executors_;
+  }
+
+  //! Held while running the segments of this runtime, whose executor
+  //! entries and workspace are shared by all calls
+  std::mutex& runMutex() {
+    return run_mutex_;
+  }
+
+  //! Horizontal kernels indexed by the run order id of their first segment.
+  //! See EnableOption::HorizontalFusion.
+  const std::unordered_map<int64_t, std::unique_ptr<HorizontalKernel>>&
+  horizontalKernels() const {
+    return horizontal_kernels_;
+  }
+
+  //! Compiles and benchmarks each segment with up to max_candidates
+  //! candidates of getAutotuneCandidates, without changing the parameters
+  //! the runtime runs with. args are the inputs of the complete fusion. The
+  //! runtime needs to be compiled. Results are in the run order of the
+  //! segments.
+  NVF_API std::vector<LaunchConfigSweepResult> sweepLaunchConfigs(
+      KernelArgumentHolder args,
+      int64_t max_candidates);
+
+  //! Index of the autotuning candidate picked for each segment, indexed by
+  //! group ID. See EnableOption::Autotune.
+  const std::vector<int64_t>& autotunedCandidates() const {
+    return autotuned_candidates_;
+  }
+
+  //! Returns the number of CUDA graphs currently captured by this runtime
+  size_t numCapturedCudaGraphs() const {
+    return std::count_if(
+        cuda_graphs_.begin(), cuda_graphs_.end(), [](const auto& entry) {
+          return entry.second.graph != nullptr;
+        });
+  }
+
  private:
+  //! Runs all segments eagerly and collects the global outputs
+  std::vector<at::Tensor> runSegmentsAndGetOutputs(
+      KernelArgumentHolder& args,
+      const std::vector<at::Tensor>& outputs = {});
+
+  //! Check if the given arguments can be run through a captured CUDA
+  //! graph. See EnableOption::CudaGraph.
+  bool canUseCudaGraph(const KernelArgumentHolder& args) const;
+
+  //! Runs the segments by replaying a CUDA graph keyed by the cache id of
+  //! args. The first run with a new set of input data pointers is eager
+  //! and serves as a warm-up; the second run captures the graph, and
+  //! subsequent runs with the same pointers replay it.
+  std::vector<at::Tensor> runWithCudaGraph(KernelArgumentHolder& args);
+
   //! Runs each fusion segment given arguments. The outputs for a fusion are
   //! added back to the arguments, so they can be used as inputs to successive
   //! segments. Returns a map that links each NvFuser Val to its corresponding
-  //! tensor.
+  //! tensor. Defined entries of outputs are passed to the segments
+  //! producing the corresponding fusion outputs, see runWithInputs.
   std::unordered_map<Val*, const PolymorphicValue*> runSegmentsWithInputs(
-      KernelArgumentHolder& args);
+      KernelArgumentHolder& args,
+      const std::vector<at::Tensor>& outputs = {});
+
+  //! Whether the segments can run through runSegmentsWithSlots, which
+  //! doesn't support given outputs nor the segment schedules that need the
+  //! tensor map of runSegmentsWithInputs, e.g. streams and memory plans
+  bool canUseSegmentSlots(const std::vector<at::Tensor>& outputs) const;
+
+  //! Runs each fusion segment given arguments, passing the values between
+  //! segments through the slots of runtime_workspace_. Returns the global
+  //! outputs.
+  std::vector<at::Tensor> runSegmentsWithSlots(KernelArgumentHolder& args);
+
+  //! Replaces the entries of segment_outputs that sg's kernel allocates for
+  //! fusion outputs with the tensors given for them. segment_outputs is
+  //! resized with undefined tensors when needed.
+  void substituteGivenOutputs(
+      SegmentedGroup* sg,
+      const std::unordered_map<Val*, at::Tensor>& given_outputs,
+      std::vector<at::Tensor>& segment_outputs) const;
 
   //! Interface to run a single kernel, either one kernel for single-kernel
   //! fusions, or a kernel for a segmentedGrouup in a segmented fusion. Returns
   //! the kernel outputs.
   std::vector<at::Tensor> runKernelWithInput(
       KernelArgumentHolder& args,
-      SegmentedGroup* sg);
+      SegmentedGroup* sg,
+      std::vector<at::Tensor> outputs = {});
 
   //! Interface to compile a single kernel. It is either a single kernel for a
   //! fusion or a kernel for a segmentedGrouup in a segmented fusion. Returns
   //! launch and compile parameters for kernel.
   void compileKernel(const KernelArgumentHolder& args, SegmentedGroup* sg);
 
+  //! Replaces the parameters of the scheduler entry of sg by their
+  //! getRegisterPressureFallback until the estimated register usage of the
+  //! scheduled segment fits in the register limit. See
+  //! EnableOption::RegisterPressureFallback.
+  void reduceRegisterPressure(SegmentedGroup* sg);
+
+  //! Benchmarks the candidates of getAutotuneCandidates for sg and replaces
+  //! the parameters of its scheduler entry by the fastest ones. args are the
+  //! inputs of sg. See EnableOption::Autotune.
+  void autotuneKernel(const KernelArgumentHolder& args, SegmentedGroup* sg);
+
+  //! Compiles sg with each of candidates in parallel, then times them one at
+  //! a time on copies of args, the inputs of sg. Returns a result per
+  //! candidate.
+  std::vector<LaunchConfigSweepResult> benchmarkCandidates(
+      const KernelArgumentHolder& args,
+      SegmentedGroup* sg,
+      const std::vector<std::shared_ptr<HeuristicParams>>& candidates);
+
   std::pair<LaunchParams, CompileParams> getKernelConfig(
       const KernelArgumentHolder& args,
       SegmentedGroup* sg);
@@ -263,6 +480,64 @@ class FusionKernelRuntime {
   //! Access the list of schedulers maintained in this runtime instance
   NVF_API const std::vector<SchedulerEntryPtr>& schedulers() const;
 
+  //! Outputs of a segment whose allocation is decided by a memory plan
+  struct PlannedOutput {
+    //! Intermediates live in the arena; fusion outputs get their own
+    //! allocation so they don't keep the arena alive after the run
+    bool in_arena = false;
+    int64_t offset = 0;
+    std::vector<int64_t> sizes;
+    std::vector<int64_t> strides;
+    at::ScalarType dtype = at::ScalarType::Undefined;
+  };
+
+  //! Placement of the tensors passed between segments for one input cache
+  //! id. See EnableOption::SegmentMemoryPlanning.
+  struct SegmentMemoryPlan {
+    //! Indexed by run order. Empty for segments that allocate their own
+    //! outputs, e.g. segments evaluated by ExpressionEvaluator or with
+    //! aliased outputs.
+    std::vector<std::vector<PlannedOutput>> segment_outputs;
+    MemoryPlan plan;
+
+    //! Allocates the outputs of the segment at run_order_id, slicing
+    //! intermediates out of arena. Returns an empty vector when the segment
+    //! allocates its own outputs.
+    std::vector<at::Tensor> allocateOutputs(
+        int64_t run_order_id,
+        const at::Tensor& arena,
+        int64_t device_index) const;
+  };
+
+  //! The last run of a segment that only depends on static inputs, see
+  //! FusionExecutorCache::markInputsStatic
+  struct StaticSegmentRun {
+    std::vector<PolymorphicValue> inputs;
+    //! Versions of the tensors in inputs
+    std::vector<int64_t> input_versions;
+    std::vector<at::Tensor> outputs;
+    std::vector<int64_t> output_versions;
+
+    //! Whether args are the same tensors at the same versions and the same
+    //! scalars as inputs, and the outputs weren't modified since
+    bool matches(const KernelArgumentHolder& args) const;
+  };
+
+  //! Finds the segments whose tensor inputs are all static inputs of the
+  //! fusion or outputs of other such segments. They don't contain random ops
+  //! or update inputs in place.
+  void findStaticSegments();
+
+  //! Groups consecutive segments in the run order into horizontal kernels.
+  //! The segments of a horizontal kernel are independent pointwise kernels,
+  //! i.e. none of them reads a tensor that another one writes.
+  void planHorizontalKernels();
+
+  //! Returns the memory plan for the cache id of args, building it from
+  //! the inferred output sizes and last uses of all segment outputs on the
+  //! first call. args must not contain the segment outputs yet.
+  const SegmentMemoryPlan& getMemoryPlan(const KernelArgumentHolder& args);
+
  private:
   //! Entries indexed by groupID:
   //! Executors holding compiled kernels
@@ -276,6 +551,10 @@ class FusionKernelRuntime {
   //! Heuristics object holding scheduler entries for all segments
   HeuristicsPtr heuristics_;
 
+  //! Index of the autotuning candidate picked for each segment, indexed by
+  //! group ID. 0 is the analytic choice of the scheduler.
+  std::vector<int64_t> autotuned_candidates_;
+
   // Checks if this runtime instance is for a single-kernel fusion (false) or a
   //  segmented fusion (true).
   bool is_segmented_ = true;
@@ -286,6 +565,11 @@ class FusionKernelRuntime {
   //! Pre-allocated runtime workspace to speed up kernel launch preparation.
   RuntimeWorkSpace runtime_workspace_;
 
+  //! Segments found by findStaticSegments, indexed by group ID, with their
+  //! last run if any. A run is reused while it matches the inputs.
+  std::unordered_map<int64_t, std::optional<StaticSegmentRun>>
+      static_segment_runs_;
+
   //! store number of arguments in KernelArgumentHolder after each segment
   //! used to check if arguments are erased if not being used in the following
   //! segments
@@ -304,6 +588,9 @@ class FusionKernelRuntime {
 
   std::mutex mutex_;
 
+  //! See runMutex
+  std::mutex run_mutex_;
+
   // ID of fusion in python frontend fusion cache, which maps to a single
   // FusionExecutorCache.
   int64_t fusion_id_ = -1;
@@ -317,8 +604,41 @@ class FusionKernelRuntime {
   // The heuristics and executor for most recent kernel launch
   ExecutorLog most_recent_executor_log_;
 
+  //! A CUDA graph capturing all segment launches for a single input cache
+  //! id. Data pointers of inputs are baked into the graph, so the graph is
+  //! only valid for the pointers it was captured with.
+  struct CudaGraphEntry {
+    std::vector<void*> input_ptrs;
+    std::unique_ptr<at::cuda::CUDAGraph> graph;
+    //! Outputs allocated from the private memory pool of graph. They are
+    //! overwritten on every replay.
+    std::vector<at::Tensor> outputs;
+  };
+
+  //! Captured CUDA graphs indexed by input cache id
+  std::unordered_map<size_t, CudaGraphEntry> cuda_graphs_;
+
+  //! Segment memory plans indexed by input cache id
+  std::unordered_map<size_t, SegmentMemoryPlan> memory_plans_;
+
+  //! Horizontal kernels indexed by the run order id of their first segment
+  std::unordered_map<int64_t, std::unique_ptr<HorizontalKernel>>
+      horizontal_kernels_;
+
   // Whether to auto schedule the Fusion. If set to false, scheduling is skipped
   const bool auto_schedule_;
+
+  //! A copy of the complete fusion evaluated by runWithExpressionEvaluator,
+  //! so it never shares IR with the background compilation
+  std::unique_ptr<Fusion> eager_fusion_;
+
+  //! False if eager_fusion_ has an expr without an ExpressionEvaluator
+  //! evaluation, e.g. random number generation, so it isn't run at all
+  bool eager_evaluatable_ = false;
+
+  //! Background compilation started by compileFusionAsync. Declared last so
+  //! it is joined before any state it uses is destroyed.
+  std::future<void> async_compile_;
 };
 
 //! Encoding an input set to unique id, which is used to short-cut cache entry
@@ -332,6 +652,11 @@ class FusionKernelRuntime {
 //! \note the uniqueness of the ide generated for a given input set is only
 //!   local to the instance of `InputsIdLookup`.
 //!
+//! \note lookupId may be called concurrently. A hit takes a shared lock on
+//!   the shard of its input set, so hits of any input sets proceed in
+//!   parallel. A miss holds insertion_mutex_ and takes an exclusive lock on
+//!   the shards it modifies.
+//!
 class InputsIdLookup : public NonCopyable {
  public:
   //! constructor where maximum cache size is fixed during init
@@ -379,7 +704,7 @@ class InputsIdLookup : public NonCopyable {
 
   //! debugging API that returns the size of lookup table
   size_t size() const {
-    return encoding_lookup_.size();
+    return size_.load();
   }
 
   //! Serialize InputsIdLookup using flatbuffers
@@ -390,36 +715,134 @@ class InputsIdLookup : public NonCopyable {
   void deserialize(const serde::InputsIdLookup* buffer);
 
  private:
-  // string to store encoded input meta information. Reuse the buffer instead of
-  // stringtream gives few us perf gain.
-  std::string encoding_; // Note: shared state, guarded by mutex_
-
-  // mutex_ used to guard reused encoding_
-  std::mutex mutex_;
-
-  //! entry stored in `encoding_lookup_` to implement LRU
-  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-member-init)
+  //! entry stored in a shard of the lookup table. A hit only updates
+  //! `last_use`, so it doesn't need exclusive access to the shard.
   struct EncodingEntry {
-    size_t id = 0;
-    std::list<std::string>::iterator lru_iter;
+    EncodingEntry(std::string encoding, size_t id, uint64_t last_use)
+        : encoding(std::move(encoding)), id(id), last_use(last_use) {}
+
+    const std::string encoding;
+    const size_t id = 0;
+    //! value of `use_counter_` at the most recent lookup of this entry. The
+    //! entry with the smallest value is the least recently used one.
+    std::atomic<uint64_t> last_use{0};
   };
 
+  //! Lookups of distinct input sets are spread over shards so that they
+  //! don't contend on a single lock. Hits only take a shared lock.
+  struct Shard {
+    mutable std::shared_mutex mutex;
+    //! map from the hash of an encoding to its entries. Encodings are only
+    //! compared as strings when their hashes are equal.
+    std::unordered_multimap<size_t, std::unique_ptr<EncodingEntry>> entries;
+  };
+
+  //! returns the entry of the given encoding in shard, or nullptr. The caller
+  //! holds a lock on the shard.
+  static EncodingEntry* findEntry(
+      const Shard& shard,
+      size_t hash,
+      const std::string& encoding);
+
+  //! removes the least recently used entry and returns its id. The caller
+  //! holds insertion_mutex_.
+  size_t evictLeastRecentlyUsed();
+
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers)
+  static constexpr size_t num_shards_ = 16;
+
+  std::array<Shard, num_shards_> shards_;
+
+  //! serializes insertions and evictions, which are rare compared to hits
+  std::mutex insertion_mutex_;
+
   //! maximum cache size for LRU
   size_t max_cache_size_ = 0;
 
   //! next available unique id, we monotonically increase `current_id_` avoid
-  //! conflicts
+  //! conflicts. Guarded by insertion_mutex_.
   size_t current_id_ = 1;
 
-  //! entry in the cache, This is used to implement LRU cache, where entries in
-  //! the list is ordered by their recent usage (freshly used entry is placed at
-  //! the beginning)
-  std::list<std::string> used_entry_;
+  //! logical clock of lookups used to implement LRU
+  std::atomic<uint64_t> use_counter_{0};
+
+  //! number of entries in all shards
+  std::atomic<size_t> size_{0};
+};
+
+class FusionExecutorCache;
+
+//! Process-wide least-recently-used eviction of the FusionKernelRuntimes of
+//! all FusionExecutorCaches, which bounds the memory held by their compiled
+//! kernels and IR, see FusionKernelRuntime::memoryFootprint. The budget is
+//! unlimited by default. Also counts the kernel runtime lookups of all
+//! FusionExecutorCaches.
+//!
+//! Runtimes are evicted after a FusionExecutorCache has run a fusion, never
+//! the one that just ran, nor runtimes being compiled in the background or
+//! whose FusionExecutorCache is running on another thread. An evicted
+//! runtime is rebuilt, i.e. segmented and compiled, when it is needed again.
+class KernelRuntimeLru {
+ public:
+  struct Stats {
+    //! Lookups that found a kernel runtime that can run the inputs
+    int64_t hits = 0;
+    //! Lookups that created a new kernel runtime
+    int64_t misses = 0;
+    int64_t evictions = 0;
+    //! Memory of the kernel runtimes that are not evicted in bytes
+    int64_t memory_bytes = 0;
+    //! Negative if unlimited
+    int64_t memory_budget = -1;
+  };
+
+  NVF_API static KernelRuntimeLru& get();
 
-  //! map from `std::string` to a unique id `size_t` (packaged in
-  //! `EncodingEntry`
-  //! ). We store an iterator to `used_entry_` to implement LRU
-  std::unordered_map<std::string, EncodingEntry> encoding_lookup_;
+  //! Sets the memory budget in bytes, where a negative budget is unlimited,
+  //! and evicts until it is met
+  NVF_API void setMemoryBudget(int64_t bytes);
+
+  NVF_API Stats stats() const;
+
+ private:
+  friend class FusionExecutorCache;
+
+  KernelRuntimeLru() = default;
+
+  void recordLookup(bool hit);
+
+  //! Marks runtime of cache as the most recently used one, updates its
+  //! memory footprint and evicts until the budget is met. The caller holds
+  //! the run lock of cache.
+  void use(FusionExecutorCache* cache, FusionKernelRuntime* runtime);
+
+  //! Marks runtime as the most recently used one if it is tracked
+  void touch(FusionKernelRuntime* runtime);
+
+  //! Forgets the runtimes of cache, which is being destroyed
+  void remove(FusionExecutorCache* cache);
+
+  //! Evicts the least recently used runtimes except keep until the budget is
+  //! met. caller, if not null, is the FusionExecutorCache whose run lock is
+  //! held by the caller. The caller holds mutex_.
+  void evictToBudget(FusionExecutorCache* caller, FusionKernelRuntime* keep);
+
+  struct Entry {
+    FusionExecutorCache* cache = nullptr;
+    FusionKernelRuntime* runtime = nullptr;
+    int64_t bytes = 0;
+  };
+
+  mutable std::mutex mutex_;
+  //! Tracked runtimes, the most recently used first
+  std::list<Entry> entries_;
+  std::unordered_map<FusionKernelRuntime*, std::list<Entry>::iterator>
+      entry_of_runtime_;
+  int64_t memory_bytes_ = 0;
+  int64_t memory_budget_ = -1;
+  std::atomic<int64_t> hits_{0};
+  std::atomic<int64_t> misses_{0};
+  int64_t evictions_ = 0;
 };
 
 //! [ Note -- Post-definition cache implementation ]
@@ -515,6 +938,8 @@ class FusionExecutorCache {
       int64_t fusion_id = 0,
       bool auto_schedule = true);
 
+  NVF_API ~FusionExecutorCache();
+
   //! Execute fusion graph with given inputs, create `FusionExecutor` as needed
   //! Note this function also handles permutation & input update outside of
   //! codegen.
@@ -524,10 +949,57 @@ class FusionExecutorCache {
   //! cases as our analysis of index type may be overly conservative
   //! for intermediate tensors.
   //! WARING: Correctness is not guaranteed.
+  //!
+  //! If preallocated_outputs is not empty, it must have one tensor for each
+  //! returned output, i.e. excluding hidden outputs, and the results are
+  //! written into those tensors in place, like PyTorch's out= variants.
+  //! Undefined tensors are allocated as usual. Sizes, strides, dtypes and
+  //! devices must match what the fusion would allocate.
+  //!
+  //! Concurrent calls, e.g. from python threads that released the GIL, are
+  //! serialized per FusionExecutorCache, as are runFusionWithTensors and
+  //! precompile. Different FusionExecutorCaches run concurrently.
+  //!
+  //! If async_compile is true, new kernel runtimes are compiled in the
+  //! background as with EnableOption::AsyncCompile, so the call doesn't wait
+  //! for compilation unless the fusion can't be evaluated without kernels.
   NVF_API std::vector<at::Tensor> runFusionWithInputs(
       const at::ArrayRef<c10::IValue>& inputs,
       std::optional<PrimDataType> forced_index_type = std::nullopt,
-      std::optional<int8_t> selected_device = std::nullopt);
+      std::optional<int8_t> selected_device = std::nullopt,
+      const std::vector<at::Tensor>& preallocated_outputs = {},
+      bool async_compile = false);
+
+  //! Lean launch path for latency-critical callers whose input shapes are
+  //! stable. Inputs are CUDA tensors, and the results are written to the
+  //! preallocated outputs. The first call with a new signature, i.e. device,
+  //! dtypes, sizes, strides and alignment of all inputs and outputs, goes
+  //! through runFusionWithInputs. Later calls with the same signature
+  //! relaunch the cached kernel directly, without converting to IValues, a
+  //! KernelArgumentHolder or binding an ExpressionEvaluator. Fusions that are
+  //! segmented or whose kernel needs more than its input and output tensors
+  //! always take the regular path, followed by a copy into the outputs.
+  NVF_API void runFusionWithTensors(
+      c10::ArrayRef<at::Tensor> inputs,
+      c10::ArrayRef<at::Tensor> outputs);
+
+  //! Marks the outputs at output_indices, i.e., indices into
+  //! fusion()->outputs(), as not needed by the caller. They are removed
+  //! before segmentation, so they are neither computed nor materialized, and
+  //! runFusionWithInputs returns undefined tensors in their place. Outputs
+  //! updating an input in place can't be marked. Replaces previous marks, and
+  //! an empty output_indices materializes all outputs again. Cached kernel
+  //! runtimes are discarded.
+  NVF_API void markOutputsUnneeded(std::vector<int64_t> output_indices);
+
+  //! Marks the tensor inputs at input_indices, i.e., indices into
+  //! fusion()->inputs(), as static, e.g., frozen weights. The subgraphs only
+  //! depending on them are segmented on their own, and their outputs are
+  //! reused by later runFusionWithInputs calls as long as the static inputs
+  //! are the same tensors and their version counters didn't change, i.e.,
+  //! they weren't updated in place. Replaces previous marks, and an empty
+  //! input_indices clears them. Cached kernel runtimes are discarded.
+  NVF_API void markInputsStatic(std::vector<int64_t> input_indices);
 
   //! Converts inputs from IValue to KernelArgumentHolder, also handles cache
   //! lookup
@@ -535,6 +1007,15 @@ class FusionExecutorCache {
       const at::ArrayRef<c10::IValue>& inputs,
       std::optional<int8_t> selected_device = std::nullopt);
 
+  //! Segments, schedules and compiles kernel runtimes for each of the given
+  //! input sets ahead of time, so that a later runFusionWithInputs with the
+  //! same input signature doesn't pay for compilation. Runtimes are compiled
+  //! concurrently. The values of input tensors are not used, so they can be
+  //! uninitialized. Returns the number of newly compiled runtimes.
+  NVF_API size_t precompile(
+      const std::vector<std::vector<c10::IValue>>& inputs_list,
+      std::optional<int8_t> selected_device = std::nullopt);
+
   //! query if there's a kernel ready to go for given inputs
   NVF_API bool isCompiled(
       const at::ArrayRef<c10::IValue>& inputs,
@@ -577,6 +1058,15 @@ class FusionExecutorCache {
       const at::ArrayRef<c10::IValue>& inputs,
       bool tensor_transforms = false);
 
+  //! Debugging aid for heuristic development: benchmarks the segments of the
+  //! kernel runtime of inputs with up to max_candidates heuristic parameters
+  //! each, e.g. block dimensions and unroll factors, and reports their time
+  //! and occupancy. The cached kernels are left as they are. See
+  //! FusionKernelRuntime::sweepLaunchConfigs.
+  NVF_API std::vector<LaunchConfigSweepResult> sweepLaunchConfigs(
+      const at::ArrayRef<c10::IValue>& inputs,
+      int64_t max_candidates = 64);
+
   // TODO: in a follow up we need a global logging structure
   //  to capture runtime profiling info. We also need to define
   //  a suitable profiling window / buffer size.
@@ -604,6 +1094,12 @@ class FusionExecutorCache {
     return concs;
   }
 
+  //! Count the cached concretization infos, which only grows with new
+  //! concretizations
+  size_t countConcretizationInfos() const {
+    return cached_conc_info_.size();
+  }
+
   //! Count kernel runtimes across all concretizations. If device is given,
   //! count only runtimes on the given device; otherwise count
   //! runtimes on all devices.
@@ -678,15 +1174,94 @@ class FusionExecutorCache {
   }
 
  private:
+  //! The kernel runtime a call ran and the cache id of its inputs
+  struct RunRecord {
+    FusionKernelRuntime* runtime = nullptr;
+    size_t cache_id = 0;
+  };
+
+  //! runFusionWithInputs for a caller that holds run_mutex_ with run_lock.
+  //! If given, record is set to what this call ran, which unlike
+  //! most_recent_runtime_ isn't changed by concurrent calls. It is left
+  //! unset when the inputs are run in chunks.
+  std::vector<at::Tensor> runFusionWithInputsImpl(
+      const at::ArrayRef<c10::IValue>& inputs,
+      std::optional<PrimDataType> forced_index_type,
+      std::optional<int8_t> selected_device,
+      const std::vector<at::Tensor>& preallocated_outputs,
+      bool async_compile,
+      std::unique_lock<std::mutex>& run_lock,
+      RunRecord* record = nullptr);
+
+  //! Runs the segments of kernel_runtime. With EnableOption::ConcurrentStreams,
+  //! run_lock is released meanwhile, so that calls on other streams can look
+  //! up and run their runtimes. Calls running the same runtime still take
+  //! turns launching its kernels, which then overlap on their streams. The
+  //! launch params given by getKernelRuntimeFor are restored before the run,
+  //! since other calls may have updated them meanwhile.
+  std::vector<at::Tensor> runKernelRuntime(
+      FusionKernelRuntime* kernel_runtime,
+      KernelArgumentHolder& args,
+      const std::vector<at::Tensor>& outputs,
+      const std::vector<LaunchParams>& launch_params,
+      std::unique_lock<std::mutex>& run_lock);
+
+  //! Waits until no call runs a runtime without run_mutex_, before the
+  //! runtimes are destroyed
+  void waitForRunningRuntimes(std::unique_lock<std::mutex>& run_lock);
+
+  //! For EnableOption::ChunkedIndexing. When the arguments need 64-bit
+  //! indexing but chunks of their outermost dimension don't, runs the fusion
+  //! with 32-bit indexing once per chunk. Each chunk writes its slice of
+  //! outputs allocated upfront, so only the base addresses of the chunks are
+  //! 64-bit. Returns nullopt when the fusion mixes elements across the
+  //! outermost dimension or chunking wouldn't avoid 64-bit indexing.
+  std::optional<std::vector<at::Tensor>> runFusionInChunks(
+      const at::ArrayRef<c10::IValue>& inputs,
+      std::optional<int8_t> selected_device,
+      bool async_compile,
+      std::unique_lock<std::mutex>& run_lock);
+
   //! evict cached short cut entry in `code_to_fe_lookup_` as well as cached
   //! entry in `FusionExecutor`
   void evictCache(size_t cache_id);
 
+  //! Destroys runtime and the cache entries referring to it, unless it is
+  //! being compiled in the background or run by another call. The caller
+  //! holds run_mutex_. Returns whether runtime was destroyed.
+  bool evictKernelRuntime(FusionKernelRuntime* runtime);
+
+  //! evictKernelRuntime if run_mutex_ isn't held by another thread
+  bool tryEvictKernelRuntime(FusionKernelRuntime* runtime);
+
+  //! Counts a call with the inputs of cache_id for
+  //! EnableOption::ShapeSpecialization. Returns whether this call reaches the
+  //! threshold, so that a kernel specialized to these inputs is compiled.
+  bool countShapeSpecializationCall(size_t cache_id);
+
+  //! Registers the kernel that record says was run for inputs in
+  //! direct_launch_entries_ if it can be relaunched with just the data
+  //! pointers of inputs and outputs
+  void maybeAddDirectLaunchEntry(
+      size_t signature_hash,
+      std::vector<int64_t> signature,
+      const std::vector<c10::IValue>& inputs,
+      c10::ArrayRef<at::Tensor> outputs,
+      const std::vector<at::Tensor>& results,
+      const RunRecord& record);
+
+  //! Permutes input tensors, see Part_1 in Note [ Permutation support in
+  //! nvfuser ]. Returns an empty vector if no input needs to be permuted.
+  std::vector<c10::IValue> permuteInputs(
+      const at::ArrayRef<c10::IValue>& inputs) const;
+
   //! The index type of forced_index_type is used to get a kernel
-  //! runtime no matter what sizes inputs have
+  //! runtime no matter what sizes inputs have. If the launch params of the
+  //! runtime are updated for inputs, they are copied to launch_params.
   FusionKernelRuntime* getKernelRuntimeFor(
       const KernelArgumentHolder& inputs,
-      std::optional<PrimDataType> forced_index_type = std::nullopt);
+      std::optional<PrimDataType> forced_index_type = std::nullopt,
+      std::vector<LaunchParams>* launch_params = nullptr);
 
   //! Get initial concretization info (without inputs). This computes the info
   //! if it has not yet been computed, then caches it for later use. This means
@@ -705,6 +1280,15 @@ class FusionExecutorCache {
   using ConcreteInfo =
       std::pair<int8_t, const DynamicTransformConcretizationInfo*>;
 
+  //! Returns a copy of fusion_ concretized for config. Concretization runs
+  //! only the first time config is seen, using conc_info, the mutable
+  //! concretization info of config. Later runtimes of the same config, e.g.,
+  //! for inputs that only differ in non-structural extents, copy the cached
+  //! concretized fusion, and conc_info may be null.
+  std::unique_ptr<Fusion> copyConcretizedFusion(
+      const ConcreteInfo& config,
+      DynamicTransformConcretizationInfo* conc_info);
+
   //! Holds FusionKernelRuntime for scheduled, static Fusions. The key in this
   //! map is a (device, concretization info) pair. In case fusion_ contains
   //! no dynamic transforms, the second part of the key is null. When a new set
@@ -725,6 +1309,13 @@ class FusionExecutorCache {
       cached_initial_info_;
   std::vector<std::unique_ptr<DynamicTransformConcretizationInfo>>
       cached_conc_info_;
+  //! fusion_ concretized for each pair of device_id and concretization info
+  std::unordered_map<
+      ConcreteInfo,
+      std::unique_ptr<Fusion>,
+      PairPointerHash,
+      PairPointerEquals>
+      concretized_fusions_;
   //! Map each pair of device_id and concretization info to an integer id
   std::unordered_map<ConcreteInfo, int64_t, PairPointerHash, PairPointerEquals>
       conc_info_id_map_;
@@ -744,9 +1335,47 @@ class FusionExecutorCache {
   //! short-cut for cache hit
   std::unordered_map<size_t, FusionKernelRuntime*> id_to_kernel_runtime_;
 
+  //! A kernel that runFusionWithTensors relaunches directly for inputs and
+  //! outputs with a given signature
+  struct DirectLaunchEntry {
+    std::vector<int64_t> signature;
+    FusionKernelRuntime* runtime = nullptr;
+    FusionExecutor* executor = nullptr;
+    size_t cache_id = 0;
+  };
+
+  //! Entries of runFusionWithTensors indexed by the hash of their signature
+  std::unordered_map<size_t, DirectLaunchEntry> direct_launch_entries_;
+
+  //! The kernel runtime picked by getKernelRuntimeFor for arguments with a
+  //! given problem descriptor, see EnableOption::HeuristicCache
+  struct HeuristicCacheEntry {
+    std::vector<int64_t> descriptor;
+    FusionKernelRuntime* runtime = nullptr;
+    //! Launch params of each segment of runtime for the descriptor
+    std::vector<LaunchParams> launch_params;
+  };
+
+  //! Entries of getKernelRuntimeFor indexed by the hash of their descriptor
+  std::unordered_map<size_t, HeuristicCacheEntry> heuristic_cache_;
+
+  //! Number of calls with the inputs of each cache id, see
+  //! EnableOption::ShapeSpecialization
+  std::unordered_map<size_t, int64_t> shape_call_counts_;
+
+  //! Sorted indices of the outputs marked by markOutputsUnneeded
+  std::vector<int64_t> unneeded_outputs_;
+
+  //! For each input of fusion_, whether runFusionInChunks splits it along its
+  //! outermost dimension. Null if fusion_ can't be run in chunks. Computed
+  //! on the first use.
+  std::optional<std::optional<std::vector<bool>>> outer_chunked_inputs_;
+
   //! Profiling info:
   //! TODO: this can be largely expanded to look at complete
   //!   caching profiles. Currently it just makes it easier to test
+  //! Set after the runtime has run, so with concurrent calls it is the
+  //! runtime of the call that finished last
   FusionKernelRuntime* most_recent_runtime_ = nullptr;
 
   //! Initial concretization info
@@ -758,6 +1387,18 @@ class FusionExecutorCache {
 
   // Whether to auto schedule the Fusion. If set to false, scheduling is skipped
   const bool auto_schedule_;
+
+  //! Serializes runFusionWithInputs, runFusionWithTensors and precompile,
+  //! which look up and update the caches above and run the kernel runtimes,
+  //! except for the runs of runKernelRuntime
+  std::mutex run_mutex_;
+
+  //! Runtimes run by runKernelRuntime without run_mutex_, once per call.
+  //! Guarded by run_mutex_.
+  std::unordered_multiset<FusionKernelRuntime*> running_runtimes_;
+
+  //! Notified when running_runtimes_ becomes empty
+  std::condition_variable runs_done_;
 };
 
 } // namespace nvfuser
@@ -0,0 +1,369 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <kernel_db/disk_cache.h>
+
+#include <debug.h>
+#include <exceptions.h>
+#include <instrumentation.h>
+#include <options.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <utility>
+
+#ifdef _WIN32
+#include <c10/util/win32-headers.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+namespace nvfuser {
+
+namespace {
+
+// Identifies the file format. Bump the version if the layout changes.
+constexpr char entry_magic[] = "nvfuser_kernel_disk_cache_v1";
+constexpr const char* entry_extension = ".kernel";
+constexpr const char* lock_extension = ".lock";
+
+void writeString(std::ostream& os, const char* data, size_t size) {
+  const uint64_t size64 = size;
+  os.write(reinterpret_cast<const char*>(&size64), sizeof(size64));
+  os.write(data, (std::streamsize)size);
+}
+
+// Reads a size-prefixed string, refusing sizes larger than what is left in the
+// file so that a corrupted entry can't trigger a huge allocation
+template <typename Container>
+bool readString(std::istream& is, uint64_t remaining, Container& dst) {
+  uint64_t size = 0;
+  if (!is.read(reinterpret_cast<char*>(&size), sizeof(size)) ||
+      size > remaining) {
+    return false;
+  }
+  dst.resize(size);
+  return (bool)is.read(dst.data(), (std::streamsize)size);
+}
+
+// Name of a temporary file that is unique across processes and threads
+fs::path temporaryPath(const fs::path& path) {
+#ifdef _WIN32
+  const unsigned int pid = GetCurrentProcessId();
+#else
+  const unsigned int pid = getpid();
+#endif // _WIN32
+  static std::atomic<uint64_t> counter{0};
+  std::stringstream ss;
+  ss << path.filename().string() << ".tmp." << pid << "."
+     << std::hash<std::thread::id>{}(std::this_thread::get_id()) << "."
+     << counter++;
+  return path.parent_path() / ss.str();
+}
+
+} // namespace
+
+KernelDiskCache::KernelDiskCache(fs::path cache_dir, int64_t max_bytes)
+    : cache_dir_(std::move(cache_dir)), max_bytes_(max_bytes) {
+  NVF_CHECK(max_bytes_ > 0, "Invalid kernel disk cache size: ", max_bytes_);
+  std::error_code ec;
+  fs::create_directories(cache_dir_, ec);
+  NVF_CHECK(
+      fs::is_directory(cache_dir_, ec),
+      "Unable to create nvFuser kernel disk cache directory! ",
+      cache_dir_.string(),
+      " ",
+      ec.message());
+}
+
+KernelDiskCache* KernelDiskCache::get() {
+  if (!isOptionEnabled(EnableOption::KernelDiskCache)) {
+    return nullptr;
+  }
+
+  static std::mutex cache_lock;
+  static std::unique_ptr<KernelDiskCache> cache;
+  static std::vector<std::string> cache_args;
+  static bool failed = false;
+
+  const auto& args = getEnableOptionArguments(EnableOption::KernelDiskCache);
+  std::lock_guard<std::mutex> guard(cache_lock);
+  // Options can be changed at runtime, e.g. by tests
+  if ((cache == nullptr && !failed) || args != cache_args) {
+    cache_args = args;
+    cache.reset();
+    failed = false;
+    try {
+      fs::path cache_dir = args.empty() || args[0].empty()
+          ? fs::temp_directory_path() / "nvfuser_kernel_cache"
+          : fs::path(args[0]);
+      int64_t max_mbytes = args.size() > 1 ? std::stol(args[1]) : 1024;
+      cache = std::make_unique<KernelDiskCache>(
+          std::move(cache_dir), max_mbytes * 1024 * 1024);
+    } catch (const std::exception& e) {
+      TORCH_WARN(
+          "nvFuser's kernel disk cache is disabled because it could not be opened. Exception: ",
+          e.what());
+      failed = true;
+    }
+  }
+  return cache.get();
+}
+
+fs::path KernelDiskCache::entryPath(
+    const std::string& key,
+    const std::string& full_src_code) const {
+  const size_t key_hash = std::hash<std::string>{}(key);
+  const size_t src_hash = std::hash<std::string>{}(full_src_code);
+  std::stringstream ss;
+  ss << std::hex << std::setfill('0') << std::setw(16) << key_hash
+     << std::setw(16) << src_hash << entry_extension;
+  return cache_dir_ / ss.str();
+}
+
+bool KernelDiskCache::query(
+    const std::string& key,
+    const std::string& full_src_code,
+    std::string& kernel_name,
+    std::vector<char>& binary) const {
+  FUSER_PERF_SCOPE("KernelDiskCache::query");
+  const fs::path path = entryPath(key, full_src_code);
+
+  std::error_code ec;
+  const auto file_size = fs::file_size(path, ec);
+  if (ec) {
+    return false;
+  }
+  std::ifstream file(path, std::ios::in | std::ios::binary);
+  if (!file) {
+    return false;
+  }
+
+  std::string magic(sizeof(entry_magic), '\0');
+  std::string stored_key;
+  std::string stored_src;
+  std::string stored_name;
+  std::vector<char> stored_binary;
+  if (!file.read(magic.data(), (std::streamsize)magic.size()) ||
+      magic != std::string(entry_magic, sizeof(entry_magic)) ||
+      !readString(file, file_size, stored_key) || stored_key != key ||
+      !readString(file, file_size, stored_src) ||
+      stored_src != full_src_code ||
+      !readString(file, file_size, stored_name) ||
+      !readString(file, file_size, stored_binary)) {
+    return false;
+  }
+
+  kernel_name = std::move(stored_name);
+  binary = std::move(stored_binary);
+
+  // Mark the entry as recently used. This may race with another process
+  // evicting it, which is fine since the binary has been read already.
+  fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+
+  if (isDebugDumpEnabled(DebugDumpOption::KernelDiskCache)) {
+    debug() << "[kernel disk cache] Hit " << path.string() << std::endl;
+  }
+  return true;
+}
+
+KernelDiskCache::EntryLock::EntryLock(EntryLock&& other) noexcept
+    : fd_(std::exchange(other.fd_, -1)), waited_(other.waited_) {}
+
+KernelDiskCache::EntryLock& KernelDiskCache::EntryLock::operator=(
+    EntryLock&& other) noexcept {
+  if (this != &other) {
+    release();
+    fd_ = std::exchange(other.fd_, -1);
+    waited_ = other.waited_;
+  }
+  return *this;
+}
+
+KernelDiskCache::EntryLock::~EntryLock() {
+  release();
+}
+
+void KernelDiskCache::EntryLock::release() {
+#ifndef _WIN32
+  if (fd_ >= 0) {
+    // Closing the file releases the lock
+    close(fd_);
+    fd_ = -1;
+  }
+#endif // _WIN32
+}
+
+KernelDiskCache::EntryLock KernelDiskCache::lock(
+    const std::string& key,
+    const std::string& full_src_code,
+    std::chrono::milliseconds timeout) const {
+  FUSER_PERF_SCOPE("KernelDiskCache::lock");
+  EntryLock entry_lock;
+#ifndef _WIN32
+  // A process locking a removed lock file would not exclude the processes
+  // locking its replacement, so evict only removes lock files that haven't
+  // been used for a long time
+  const fs::path path =
+      entryPath(key, full_src_code).replace_extension(lock_extension);
+  const int fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0666);
+  if (fd < 0) {
+    return entry_lock;
+  }
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  // flock locks are released by the kernel when their holder dies, so a
+  // crashed process can't block the others
+  while (flock(fd, LOCK_EX | LOCK_NB) != 0) {
+    if ((errno != EWOULDBLOCK && errno != EINTR) ||
+        std::chrono::steady_clock::now() >= deadline) {
+      close(fd);
+      return entry_lock;
+    }
+    entry_lock.waited_ = true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  entry_lock.fd_ = fd;
+  std::error_code ec;
+  fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+  if (entry_lock.waited_ &&
+      isDebugDumpEnabled(DebugDumpOption::KernelDiskCache)) {
+    debug() << "[kernel disk cache] Waited for " << path.string() << std::endl;
+  }
+#endif // _WIN32
+  return entry_lock;
+}
+
+bool KernelDiskCache::write(
+    const std::string& key,
+    const std::string& full_src_code,
+    const std::string& kernel_name,
+    const std::vector<char>& binary) {
+  FUSER_PERF_SCOPE("KernelDiskCache::write");
+  const fs::path path = entryPath(key, full_src_code);
+  const fs::path tmp_path = temporaryPath(path);
+
+  {
+    std::ofstream file(tmp_path, std::ios::out | std::ios::binary);
+    if (!file) {
+      return false;
+    }
+    file.write(entry_magic, sizeof(entry_magic));
+    writeString(file, key.data(), key.size());
+    writeString(file, full_src_code.data(), full_src_code.size());
+    writeString(file, kernel_name.data(), kernel_name.size());
+    writeString(file, binary.data(), binary.size());
+    file.close();
+    if (!file) {
+      std::error_code ec;
+      fs::remove(tmp_path, ec);
+      return false;
+    }
+  }
+
+  // Renaming within a directory is atomic, so concurrent readers either see
+  // the complete entry or none. If another process wrote the same entry in
+  // the meantime, the rename replaces it with identical contents.
+  std::error_code ec;
+  fs::rename(tmp_path, path, ec);
+  if (ec) {
+    fs::remove(tmp_path, ec);
+    return false;
+  }
+
+  if (isDebugDumpEnabled(DebugDumpOption::KernelDiskCache)) {
+    debug() << "[kernel disk cache] Wrote " << path.string() << std::endl;
+  }
+
+  if (sizeBytes() > max_bytes_) {
+    // Evict a bit more than needed so that eviction doesn't run on every
+    // write once the cache is full
+    evict(max_bytes_ / 10 * 9);
+  }
+  return true;
+}
+
+int64_t KernelDiskCache::sizeBytes() const {
+  int64_t total_bytes = 0;
+  std::error_code ec;
+  for (fs::directory_iterator it(cache_dir_, ec), end; !ec && it != end;
+       it.increment(ec)) {
+    if (it->path().extension() != entry_extension) {
+      continue;
+    }
+    std::error_code size_ec;
+    const auto size = fs::file_size(it->path(), size_ec);
+    if (!size_ec) {
+      total_bytes += (int64_t)size;
+    }
+  }
+  return total_bytes;
+}
+
+void KernelDiskCache::evict(int64_t target_bytes) const {
+  FUSER_PERF_SCOPE("KernelDiskCache::evict");
+  struct Entry {
+    fs::path path;
+    fs::file_time_type last_use;
+    int64_t size;
+  };
+  std::vector<Entry> entries;
+  int64_t total_bytes = 0;
+
+  const auto stale_time =
+      fs::file_time_type::clock::now() - std::chrono::hours(1);
+  std::error_code ec;
+  for (fs::directory_iterator it(cache_dir_, ec), end; !ec && it != end;
+       it.increment(ec)) {
+    std::error_code entry_ec;
+    const auto last_use = fs::last_write_time(it->path(), entry_ec);
+    if (it->path().extension() != entry_extension) {
+      // Temporary files left behind by processes that died while writing,
+      // and lock files that haven't been used for a long time
+      if (!entry_ec && last_use < stale_time &&
+          (it->path().filename().string().find(".tmp.") != std::string::npos ||
+           it->path().extension() == lock_extension)) {
+        fs::remove(it->path(), entry_ec);
+      }
+      continue;
+    }
+    const auto size = fs::file_size(it->path(), entry_ec);
+    if (!entry_ec) {
+      entries.push_back({it->path(), last_use, (int64_t)size});
+      total_bytes += (int64_t)size;
+    }
+  }
+
+  std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+    return a.last_use < b.last_use;
+  });
+  for (const auto& entry : entries) {
+    if (total_bytes <= target_bytes) {
+      break;
+    }
+    // Other processes may be evicting the same entry concurrently
+    std::error_code remove_ec;
+    fs::remove(entry.path, remove_ec);
+    total_bytes -= entry.size;
+    if (isDebugDumpEnabled(DebugDumpOption::KernelDiskCache)) {
+      debug() << "[kernel disk cache] Evicted " << entry.path.string()
+              << std::endl;
+    }
+  }
+}
+
+} // namespace nvfuser
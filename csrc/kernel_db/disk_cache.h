@@ -0,0 +1,122 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <kernel_db/kernel_db.h>
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <visibility.h>
+
+namespace nvfuser {
+
+//! KernelDiskCache is a persistent cache of compiled kernel binaries that is
+//! shared by all processes using the same cache directory. It is enabled with
+//! NVFUSER_ENABLE=kernel_disk_cache, optionally followed by the cache
+//! directory and the size limit in MB, e.g.
+//! NVFUSER_ENABLE=kernel_disk_cache(/path/to/cache,2048).
+//!
+//! Each entry is a single file named by a hash of its key and the generated
+//! CUDA source. The key is made of everything else that determines the
+//! binary: the compile args, the device architecture, the NVRTC version and
+//! the nvFuser version. The full key and source are stored in the entry and
+//! compared on lookup, so hash collisions can't return a wrong binary.
+//!
+//! Entries are written to a temporary file and renamed into place, so a
+//! reader never sees a partial entry. A hit refreshes the modification time
+//! of the entry, and writes evict the least recently used entries once the
+//! directory exceeds the size limit. All file system errors are treated as
+//! cache misses.
+//!
+//! Processes sharing the directory, e.g. the ranks of a job on a node, pick up
+//! the entries written by each other at runtime. A process compiling a
+//! missing entry holds its EntryLock, so the others wait for the entry instead
+//! of compiling the same kernel.
+class KernelDiskCache {
+ public:
+  //! Exclusive lock of an entry across processes. It is released when
+  //! destroyed or when the holding process dies.
+  class EntryLock {
+   public:
+    EntryLock() = default;
+    EntryLock(const EntryLock&) = delete;
+    EntryLock& operator=(const EntryLock&) = delete;
+    NVF_API EntryLock(EntryLock&& other) noexcept;
+    NVF_API EntryLock& operator=(EntryLock&& other) noexcept;
+    NVF_API ~EntryLock();
+
+    bool locked() const {
+      return fd_ >= 0;
+    }
+
+    //! Whether another process held the lock, in which case it has likely
+    //! written the entry in the meantime
+    bool waited() const {
+      return waited_;
+    }
+
+   private:
+    friend class KernelDiskCache;
+    void release();
+
+    int fd_ = -1;
+    bool waited_ = false;
+  };
+
+  NVF_API KernelDiskCache(fs::path cache_dir, int64_t max_bytes);
+
+  //! Returns the cache configured by EnableOption::KernelDiskCache, or
+  //! nullptr if the option is not enabled or the directory is not usable
+  static KernelDiskCache* get();
+
+  const fs::path& cacheDir() const {
+    return cache_dir_;
+  }
+
+  //! Looks up the binary compiled from full_src_code with the given key
+  NVF_API bool query(
+      const std::string& key,
+      const std::string& full_src_code,
+      std::string& kernel_name,
+      std::vector<char>& binary) const;
+
+  //! Locks the entry of full_src_code with the given key, waiting for the
+  //! process holding it for at most timeout. The returned lock is not locked
+  //! on timeout or if the platform or file system doesn't support locking.
+  NVF_API EntryLock lock(
+      const std::string& key,
+      const std::string& full_src_code,
+      std::chrono::milliseconds timeout = std::chrono::minutes(5)) const;
+
+  //! Stores a binary and evicts old entries if the cache grows too large
+  NVF_API bool write(
+      const std::string& key,
+      const std::string& full_src_code,
+      const std::string& kernel_name,
+      const std::vector<char>& binary);
+
+  //! Removes least recently used entries until the total size of all entries
+  //! is at most target_bytes
+  NVF_API void evict(int64_t target_bytes) const;
+
+  //! Total size of the entries currently in the cache directory
+  NVF_API int64_t sizeBytes() const;
+
+ private:
+  fs::path entryPath(const std::string& key, const std::string& full_src_code)
+      const;
+
+ private:
+  fs::path cache_dir_;
+  int64_t max_bytes_;
+};
+
+} // namespace nvfuser
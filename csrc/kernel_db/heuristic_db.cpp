@@ -0,0 +1,287 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <kernel_db/heuristic_db.h>
+
+#include <exceptions.h>
+#include <instrumentation.h>
+#include <kernel_db/utils.h>
+#include <options.h>
+#include <serde/heuristic_db_generated.h>
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+#ifdef _WIN32
+#include <c10/util/win32-headers.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace nvfuser {
+
+namespace {
+
+using Entries = std::map<std::string, std::vector<HeuristicDb::Record>>;
+
+//! Aggregates record into the records of signature, keeping the records
+//! sorted by their best time
+void addRecord(
+    Entries& entries,
+    const std::string& signature,
+    const HeuristicDb::Record& record) {
+  std::vector<HeuristicDb::Record>& records = entries[signature];
+  auto it = std::find_if(
+      records.begin(),
+      records.end(),
+      [&record](const HeuristicDb::Record& other) {
+        return other.knobs == record.knobs;
+      });
+  if (it == records.end()) {
+    records.push_back(record);
+  } else {
+    it->best_time_ms = std::min(it->best_time_ms, record.best_time_ms);
+    it->num_samples += record.num_samples;
+  }
+  std::stable_sort(
+      records.begin(),
+      records.end(),
+      [](const HeuristicDb::Record& a, const HeuristicDb::Record& b) {
+        return a.best_time_ms < b.best_time_ms;
+      });
+}
+
+//! Reads the records of a database file into entries
+bool readEntries(const fs::path& file, Entries& entries) {
+  std::error_code ec;
+  if (!fs::is_regular_file(file, ec)) {
+    return false;
+  }
+  std::vector<char> buffer;
+  if (!copy_from_binary_file(file.string(), buffer) || buffer.empty()) {
+    return false;
+  }
+  const auto* data = reinterpret_cast<const uint8_t*>(buffer.data());
+  flatbuffers::Verifier v(data, buffer.size());
+  if (!serde::VerifyHeuristicDbBuffer(v)) {
+    TORCH_WARN(
+        "nvFuser's heuristic DB ignores an invalid database file: ",
+        file.string());
+    return false;
+  }
+  const serde::HeuristicDb* db = serde::GetHeuristicDb(data);
+  if (db->entries() == nullptr) {
+    return true;
+  }
+  for (const serde::HeuristicDbEntry* fb_entry : *db->entries()) {
+    if (fb_entry->signature() == nullptr || fb_entry->records() == nullptr) {
+      continue;
+    }
+    const std::string signature = fb_entry->signature()->str();
+    for (const serde::HeuristicDbRecord* fb_record : *fb_entry->records()) {
+      HeuristicDb::Record record;
+      if (fb_record->knobs() != nullptr) {
+        record.knobs.assign(
+            fb_record->knobs()->begin(), fb_record->knobs()->end());
+      }
+      record.best_time_ms = fb_record->best_time_ms();
+      record.num_samples = fb_record->num_samples();
+      addRecord(entries, signature, record);
+    }
+  }
+  return true;
+}
+
+// Name of a temporary file that is unique across processes, like the ones of
+// KernelDiskCache
+fs::path temporaryPath(const fs::path& path) {
+#ifdef _WIN32
+  const unsigned int pid = GetCurrentProcessId();
+#else
+  const unsigned int pid = getpid();
+#endif // _WIN32
+  static std::atomic<uint64_t> counter{0};
+  std::stringstream ss;
+  ss << path.filename().string() << ".tmp." << pid << "." << counter++;
+  return path.parent_path() / ss.str();
+}
+
+} // namespace
+
+HeuristicDb::HeuristicDb(fs::path db_file) : db_file_(std::move(db_file)) {
+  readEntries(db_file_, entries_);
+}
+
+HeuristicDb* HeuristicDb::get() {
+  if (!isOptionEnabled(EnableOption::HeuristicDb)) {
+    return nullptr;
+  }
+
+  static std::mutex db_lock;
+  static std::unique_ptr<HeuristicDb> db;
+  static std::vector<std::string> db_args;
+
+  const auto& args = getEnableOptionArguments(EnableOption::HeuristicDb);
+  std::lock_guard<std::mutex> guard(db_lock);
+  // Options can be changed at runtime, e.g. by tests
+  if (db == nullptr || args != db_args) {
+    db_args = args;
+    fs::path db_file = args.empty() || args[0].empty()
+        ? fs::temp_directory_path() / "nvfuser_heuristic_db.bin"
+        : fs::path(args[0]);
+    db = std::make_unique<HeuristicDb>(std::move(db_file));
+  }
+  return db.get();
+}
+
+size_t HeuristicDb::size() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return entries_.size();
+}
+
+void HeuristicDb::record(
+    const std::string& signature,
+    const std::vector<int64_t>& knobs,
+    double time_ms,
+    int64_t num_samples) {
+  NVF_CHECK(num_samples > 0, "Invalid number of samples: ", num_samples);
+  mergeRecord(signature, {knobs, time_ms, num_samples});
+}
+
+void HeuristicDb::mergeRecord(
+    const std::string& signature,
+    const Record& record) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  addRecord(entries_, signature, record);
+  addRecord(pending_, signature, record);
+}
+
+std::optional<std::vector<int64_t>> HeuristicDb::best(
+    const std::string& signature) const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto it = entries_.find(signature);
+  if (it == entries_.end() || it->second.empty()) {
+    return std::nullopt;
+  }
+  return it->second.front().knobs;
+}
+
+std::vector<HeuristicDb::Record> HeuristicDb::records(
+    const std::string& signature) const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  auto it = entries_.find(signature);
+  if (it == entries_.end()) {
+    return {};
+  }
+  return it->second;
+}
+
+void HeuristicDb::merge(const HeuristicDb& other) {
+  if (&other == this) {
+    return;
+  }
+  Entries other_entries;
+  {
+    std::lock_guard<std::mutex> guard(other.mutex_);
+    other_entries = other.entries_;
+  }
+  for (const auto& [signature, records] : other_entries) {
+    for (const Record& record : records) {
+      mergeRecord(signature, record);
+    }
+  }
+}
+
+bool HeuristicDb::load(const fs::path& file) {
+  FUSER_PERF_SCOPE("HeuristicDb::load");
+  Entries file_entries;
+  if (!readEntries(file, file_entries)) {
+    return false;
+  }
+  for (const auto& [signature, records] : file_entries) {
+    for (const Record& record : records) {
+      mergeRecord(signature, record);
+    }
+  }
+  return true;
+}
+
+bool HeuristicDb::save(const fs::path& file) const {
+  FUSER_PERF_SCOPE("HeuristicDb::save");
+  flatbuffers::FlatBufferBuilder builder(1024);
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    std::vector<flatbuffers::Offset<serde::HeuristicDbEntry>> fb_entries;
+    fb_entries.reserve(entries_.size());
+    for (const auto& [signature, records] : entries_) {
+      std::vector<flatbuffers::Offset<serde::HeuristicDbRecord>> fb_records;
+      fb_records.reserve(records.size());
+      for (const Record& record : records) {
+        fb_records.push_back(serde::CreateHeuristicDbRecordDirect(
+            builder, &record.knobs, record.best_time_ms, record.num_samples));
+      }
+      fb_entries.push_back(serde::CreateHeuristicDbEntryDirect(
+          builder, signature.c_str(), &fb_records));
+    }
+    serde::FinishHeuristicDbBuffer(
+        builder, serde::CreateHeuristicDbDirect(builder, &fb_entries));
+  }
+
+  const fs::path tmp_path = temporaryPath(file);
+  {
+    std::ofstream out(tmp_path, std::ios::out | std::ios::binary);
+    if (!out) {
+      return false;
+    }
+    auto fb = builder.GetBufferSpan();
+    out.write(
+        reinterpret_cast<const char*>(fb.data()), (std::streamsize)fb.size());
+    out.close();
+    if (!out) {
+      std::error_code ec;
+      fs::remove(tmp_path, ec);
+      return false;
+    }
+  }
+  // Renaming within a directory is atomic, so concurrent readers either see
+  // the old or the new file
+  std::error_code ec;
+  fs::rename(tmp_path, file, ec);
+  if (ec) {
+    fs::remove(tmp_path, ec);
+    return false;
+  }
+  return true;
+}
+
+bool HeuristicDb::sync() {
+  FUSER_PERF_SCOPE("HeuristicDb::sync");
+  if (db_file_.empty()) {
+    return false;
+  }
+  // Only the records that are not in the file yet are added to it, so that
+  // syncing repeatedly doesn't count the same samples twice
+  std::lock_guard<std::mutex> guard(mutex_);
+  HeuristicDb synced;
+  readEntries(db_file_, synced.entries_);
+  for (const auto& [signature, records] : pending_) {
+    for (const Record& record : records) {
+      addRecord(synced.entries_, signature, record);
+    }
+  }
+  if (!synced.save(db_file_)) {
+    return false;
+  }
+  entries_ = std::move(synced.entries_);
+  pending_.clear();
+  return true;
+}
+
+} // namespace nvfuser
@@ -0,0 +1,108 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <kernel_db/kernel_db.h>
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <visibility.h>
+
+namespace nvfuser {
+
+//! HeuristicDb records how fast the kernels compiled with a set of heuristic
+//! parameters ran on a problem, so that the fastest parameters found by the
+//! autotuner on one run or machine can be reused by later ones. It is
+//! enabled with NVFUSER_ENABLE=heuristic_db, optionally followed by the path
+//! of the database file, e.g. NVFUSER_ENABLE=heuristic_db(/path/to/db.bin).
+//!
+//! Problems are identified by the signature of the ProblemDescription of the
+//! heuristic plugin API (see heuristic_plugin::problemSignature), which
+//! includes the sizes, data type and device of the kernel. Parameters are
+//! stored as the knobs that a plugin config can set (see
+//! heuristic_plugin::getConfigKnobs). The schedulers replay the fastest
+//! knobs of their signature, unless a plugin overrides them.
+//!
+//! Measurements of the same knobs are aggregated, keeping their best time
+//! and their number of samples. The database is stored as a flatbuffer, see
+//! serde/heuristic_db.fbs. Writes merge the file into the database before
+//! replacing the file atomically, so processes sharing a file don't corrupt
+//! it, but concurrent writes may drop each other's records. To share the
+//! measurements of a cluster, give each process its own file and combine
+//! them with tools/merge_heuristic_db.py.
+class HeuristicDb {
+ public:
+  //! One set of knobs measured for a signature
+  struct Record {
+    std::vector<int64_t> knobs;
+    double best_time_ms = 0.0;
+    int64_t num_samples = 0;
+  };
+
+  HeuristicDb() = default;
+  NVF_API explicit HeuristicDb(fs::path db_file);
+
+  //! Returns the database configured by EnableOption::HeuristicDb, or
+  //! nullptr if the option is not enabled
+  NVF_API static HeuristicDb* get();
+
+  const fs::path& dbFile() const {
+    return db_file_;
+  }
+
+  //! Returns the number of signatures in the db
+  NVF_API size_t size() const;
+
+  //! Adds a measurement of knobs for signature
+  NVF_API void record(
+      const std::string& signature,
+      const std::vector<int64_t>& knobs,
+      double time_ms,
+      int64_t num_samples = 1);
+
+  //! Returns the fastest knobs recorded for signature
+  NVF_API std::optional<std::vector<int64_t>> best(
+      const std::string& signature) const;
+
+  //! Returns the records of signature, fastest first
+  NVF_API std::vector<Record> records(const std::string& signature) const;
+
+  //! Aggregates the records of other into this db
+  NVF_API void merge(const HeuristicDb& other);
+
+  //! Merges the records of a database file into this db. Returns false if
+  //! the file doesn't exist or is not a valid database.
+  NVF_API bool load(const fs::path& file);
+
+  //! Writes this db to a file, replacing it atomically
+  NVF_API bool save(const fs::path& file) const;
+
+  //! Adds the records of this db that are not in its file yet to the file,
+  //! and reloads the file. Does nothing if the db was constructed without a
+  //! file.
+  NVF_API bool sync();
+
+ private:
+  void mergeRecord(const std::string& signature, const Record& record);
+
+ private:
+  fs::path db_file_;
+  mutable std::mutex mutex_;
+  //! Signatures are ordered so that saving the same records always gives the
+  //! same file
+  std::map<std::string, std::vector<Record>> entries_;
+  //! Records that have not been written to db_file_ yet
+  std::map<std::string, std::vector<Record>> pending_;
+};
+
+} // namespace nvfuser
@@ -5,6 +5,8 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 // clang-format on
+#include <algorithm>
+#include <cerrno>
 #include <fstream>
 #include <mutex>
 #include <regex>
@@ -15,10 +17,113 @@
 #include <options.h>
 #include <utils.h>
 
+#ifdef _WIN32
+#include <c10/util/win32-headers.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace nvfuser {
 
 static std::mutex kernel_db_lock;
 
+namespace {
+
+const std::string db_header(
+    "kernel_signature,compile_args,kernel_code_file,cubin_file");
+
+template <typename Container>
+std::string stableHash(const Container& data) {
+  return stable_hash(data.data(), data.size());
+}
+
+// Identifies the index file, which is replaced when it's compacted or reset
+uint64_t fileId(const fs::path& path) {
+#ifdef _WIN32
+  return 0;
+#else
+  struct stat st {};
+  return stat(path.c_str(), &st) == 0 ? (uint64_t)st.st_ino : 0;
+#endif // _WIN32
+}
+
+// Exclusive lock of the index across processes, released when destroyed or
+// when the holding process dies. A no-op on platforms without flock.
+class IndexLock {
+ public:
+  explicit IndexLock(const fs::path& path) {
+#ifndef _WIN32
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0666);
+    if (fd_ >= 0) {
+      while (flock(fd_, LOCK_EX) != 0 && errno == EINTR) {
+      }
+    }
+#endif // _WIN32
+  }
+  IndexLock(const IndexLock&) = delete;
+  IndexLock& operator=(const IndexLock&) = delete;
+
+  ~IndexLock() {
+#ifndef _WIN32
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+#endif // _WIN32
+  }
+
+ private:
+  int fd_ = -1;
+};
+
+fs::path lockPath(const fs::path& kernel_db_txt_file) {
+  return fs::path(kernel_db_txt_file.string() + ".lock");
+}
+
+// Writes data to a temporary file that is renamed to path, so other
+// processes either see all of data or nothing
+template <typename Container>
+bool copyToFileAtomically(const fs::path& path, const Container& data) {
+#ifdef _WIN32
+  const unsigned long pid = GetCurrentProcessId();
+#else
+  const unsigned long pid = getpid();
+#endif // _WIN32
+  const fs::path tmp_path(path.string() + ".tmp." + std::to_string(pid));
+  bool status = false;
+  {
+    std::ofstream file(tmp_path, std::ios::out | std::ios::binary);
+    if (file) {
+      file.write(data.data(), (std::streamsize)data.size());
+      file.close();
+      status = (bool)file;
+    }
+  }
+  std::error_code ec;
+  if (status) {
+    fs::rename(tmp_path, path, ec);
+    status = !ec;
+  }
+  if (!status) {
+    fs::remove(tmp_path, ec);
+  }
+  return status;
+}
+
+std::string entryLine(const KernelDbEntry& entry) {
+  std::string line(entry.kernel_signature);
+  line += "," + entry.compile_args + "," + entry.kernel_code_file + "," +
+      entry.cubin_file;
+  if (!entry.checksum.empty()) {
+    line += "," + entry.checksum;
+  }
+  return line + "\n";
+}
+
+} // namespace
+
 KernelDb::KernelDb(bool _disabled)
     : disabled_(_disabled),
       initialized_(false),
@@ -30,12 +135,19 @@ KernelDb& KernelDb::get() {
   const std::string kernel_db_dir = "nvfuser_kernel_db";
   const std::string kernel_db_file = "db.csv";
 
+  const auto& args = getEnableOptionArguments(EnableOption::KernelDb);
+  int64_t max_bytes = default_max_bytes;
+  if (!args.empty() && !args[0].empty()) {
+    max_bytes = std::stol(args[0]) * 1024 * 1024;
+  }
+
   return get(
       kernel_db_dir,
       kernel_db_file,
       true,
       !isOptionEnabled(EnableOption::KernelDb),
-      false);
+      false,
+      max_bytes);
 }
 
 KernelDb& KernelDb::get(
@@ -43,7 +155,8 @@ KernelDb& KernelDb::get(
     const std::string& kernel_db_file,
     bool use_temp_dir,
     bool disabled,
-    bool reset) {
+    bool reset,
+    int64_t max_bytes) {
   std::lock_guard<std::mutex> guard(kernel_db_lock);
 
   // The KernelDb is minimally constructed to at least hold the disable and
@@ -56,9 +169,13 @@ KernelDb& KernelDb::get(
     singleton.kernel_map_.clear();
     singleton.kernel_db_path_.clear();
     singleton.kernel_db_txt_file_.clear();
+    singleton.index_offset_ = 0;
+    singleton.index_file_id_ = 0;
+    singleton.num_index_lines_ = 0;
   }
 
   singleton.disabled_ = disabled;
+  singleton.max_bytes_ = max_bytes;
 
   // Intialize the Db if it isn't already disabled
   if (!singleton.disabled_ && !singleton.initialized_) {
@@ -85,8 +202,6 @@ bool KernelDb::open(
     const std::string& kernel_db_file,
     bool use_temp_dir) {
   FUSER_PERF_SCOPE("KernelDb::open");
-  const std::string header(
-      "kernel_signature,compile_args,kernel_code_file,cubin_file");
 
   // The KernelDb directory is queried and created if it doesn't exist
   {
@@ -98,7 +213,7 @@ bool KernelDb::open(
     }
     if (!fs::is_directory(kernel_db_path_)) {
       try {
-        fs::create_directory(kernel_db_path_);
+        fs::create_directories(kernel_db_path_);
       } catch (const std::exception& e) {
         TORCH_WARN(
             "Unable to create nvFuser Kernel DB directory! ",
@@ -109,67 +224,14 @@ bool KernelDb::open(
     }
   }
 
+  kernel_db_txt_file_ = kernel_db_path_ / kernel_db_file;
+  IndexLock index_lock(lockPath(kernel_db_txt_file_));
+
   // The CSV file that captures the db is read if it exists
   {
     FUSER_PERF_SCOPE("KernelDb::open::read_db_txt_file");
-
-    kernel_db_txt_file_ = kernel_db_path_ / kernel_db_file;
-    if (fs::is_regular_file(kernel_db_txt_file_)) {
-      std::ifstream in_file(kernel_db_txt_file_.c_str(), std::ios::in);
-      if (in_file) {
-        bool matched_header = false;
-        bool read_db_file = true;
-        // kernel_signature
-        //  --- Group 1: any word character and dash
-        // compile_args
-        //  --- Group 2: any word character, space, plus, dash and equals
-        // kernel_code_file
-        //  --- Group 3: [any word character, dash and slash].cu
-        // cubin_file
-        //  --- Group 4: [any word character, dash and slash].cubin
-        std::regex db_line_regex(
-            R"(^([\w-]+),([\w \+\-\=]+),([\w\-\/]+\.cu),([\w\-\/]+\.cubin)$)");
-        for (std::string line; std::getline(in_file, line);) {
-          if (!matched_header) {
-            if (line.compare(header) == 0) {
-              matched_header = true;
-            } else {
-              // Header is corrupted or badly formed
-              TORCH_WARN(
-                  "Kernel DB: CSV file header is corrupted or badly formed - Resetting!: ",
-                  line);
-              read_db_file = false;
-              break;
-            }
-          } else {
-            std::smatch db_line_match;
-            if (std::regex_match(line, db_line_match, db_line_regex)) {
-              if (db_line_match.size() == 5) {
-                KernelDbEntry temp{
-                    db_line_match[1],
-                    db_line_match[2],
-                    db_line_match[3],
-                    db_line_match[4]};
-
-                fs::path code_path = kernel_db_path_ / temp.kernel_code_file;
-                std::string code;
-                if (copy_from_text_file(code_path.string(), code)) {
-                  kernel_map_[code] = temp;
-                } else {
-                  TORCH_WARN(
-                      "Kernel DB: Unable to copy cuda file: ",
-                      code_path.string());
-                }
-              }
-            } else {
-              TORCH_WARN("Kernel DB: CSV line Doesn't match: ", line);
-            }
-          }
-        }
-        if (read_db_file) {
-          return true;
-        }
-      }
+    if (fs::is_regular_file(kernel_db_txt_file_) && readIndex()) {
+      return true;
     }
   }
 
@@ -186,18 +248,105 @@ bool KernelDb::open(
       }
     }
   }
+  kernel_map_.clear();
+  num_index_lines_ = 0;
 
   // Create an empty db csv file
   {
     FUSER_PERF_SCOPE("KernelDb::open::create_db_txt_file");
 
-    if (copy_to_text_file(kernel_db_txt_file_, header + "\n")) {
+    if (copy_to_text_file(kernel_db_txt_file_, db_header + "\n")) {
+      index_offset_ = (int64_t)fs::file_size(kernel_db_txt_file_);
+      index_file_id_ = fileId(kernel_db_txt_file_);
       return true;
     }
   }
   return false;
 }
 
+bool KernelDb::readIndex() {
+  FUSER_PERF_SCOPE("KernelDb::readIndex");
+  const uint64_t file_id = fileId(kernel_db_txt_file_);
+  std::error_code ec;
+  const auto file_size = fs::file_size(kernel_db_txt_file_, ec);
+  if (ec) {
+    return false;
+  }
+  // Another process compacted or reset the index, so read it from the start
+  if (file_id != index_file_id_ || (int64_t)file_size < index_offset_) {
+    kernel_map_.clear();
+    index_offset_ = 0;
+    num_index_lines_ = 0;
+  }
+  index_file_id_ = file_id;
+
+  std::ifstream in_file(kernel_db_txt_file_.c_str(), std::ios::in);
+  if (!in_file) {
+    return false;
+  }
+  in_file.seekg(index_offset_);
+  bool matched_header = index_offset_ > 0;
+  // kernel_signature
+  //  --- Group 1: any word character and dash
+  // compile_args
+  //  --- Group 2: any word character, space, plus, dash and equals
+  // kernel_code_file
+  //  --- Group 3: [any word character, dash and slash].cu
+  // cubin_file
+  //  --- Group 4: [any word character, dash and slash].cubin
+  // checksum (optional)
+  //  --- Group 5: 16 hex digits
+  std::regex db_line_regex(
+      R"(^([\w-]+),([\w \+\-\=]+),([\w\-\/]+\.cu),([\w\-\/]+\.cubin)(?:,([0-9a-f]{16}))?$)");
+  for (std::string line; std::getline(in_file, line);) {
+    if (!matched_header) {
+      if (line.compare(db_header) == 0) {
+        matched_header = true;
+        continue;
+      }
+      // Header is corrupted or badly formed
+      TORCH_WARN(
+          "Kernel DB: CSV file header is corrupted or badly formed - Resetting!: ",
+          line);
+      return false;
+    }
+    if (line.empty()) {
+      continue;
+    }
+    std::smatch db_line_match;
+    if (!std::regex_match(line, db_line_match, db_line_regex)) {
+      // E.g. the partial line of a process that died while appending
+      TORCH_WARN("Kernel DB: CSV line Doesn't match: ", line);
+      continue;
+    }
+    KernelDbEntry temp{
+        db_line_match[1],
+        db_line_match[2],
+        db_line_match[3],
+        db_line_match[4],
+        db_line_match[5]};
+
+    fs::path code_path = kernel_db_path_ / temp.kernel_code_file;
+    std::string code;
+    if (copy_from_text_file(code_path.string(), code)) {
+      // Later lines replace the entries of rewritten kernels
+      kernel_map_[code] = temp;
+      ++num_index_lines_;
+    } else {
+      TORCH_WARN("Kernel DB: Unable to copy cuda file: ", code_path.string());
+    }
+  }
+  index_offset_ = (int64_t)file_size;
+  return matched_header;
+}
+
+bool KernelDb::isValid(const KernelDbEntry& entry) const {
+  std::vector<char> cubin;
+  return copy_from_binary_file(
+             (kernel_db_path_ / entry.cubin_file).string(), cubin) &&
+      (entry.checksum.empty() || stableHash(cubin) == entry.checksum);
+}
+
 bool KernelDb::query(
     const std::string& kernel_code,
     const std::string& compile_args,
@@ -215,8 +364,22 @@ bool KernelDb::query(
       // loading
       fs::path cubin_file_path = kernel_db_path_ / db_entry->second.cubin_file;
       if (copy_from_binary_file(cubin_file_path.string(), cubin)) {
+        if (!db_entry->second.checksum.empty() &&
+            stableHash(cubin) != db_entry->second.checksum) {
+          // write replaces the entry once the kernel is recompiled
+          TORCH_WARN(
+              "Kernel DB: Ignoring corrupted cubin: ",
+              cubin_file_path.string());
+          cubin.clear();
+          return false;
+        }
         kernel_signature = db_entry->second.kernel_signature;
         status = true;
+        // Mark the entry as recently used. This may race with another
+        // process evicting it, which is fine since the cubin has been read.
+        std::error_code ec;
+        fs::last_write_time(
+            cubin_file_path, fs::file_time_type::clock::now(), ec);
       }
     }
   }
@@ -232,52 +395,138 @@ bool KernelDb::write(
     const std::vector<char>& cubin) {
   FUSER_PERF_SCOPE("KernelDb::write");
   std::lock_guard<std::mutex> guard(kernel_db_lock);
+  IndexLock index_lock(lockPath(kernel_db_txt_file_));
+
+  // Pick up the entries written by other processes
+  if (!readIndex()) {
+    return false;
+  }
 
   // Short-circuit path if kernel already exist in database.
   // Only return false if it does not already exist in the database and we fail
   // to add kernel to database.
-  if (kernel_map_.count(kernel_code) > 0) {
+  auto db_entry = kernel_map_.find(kernel_code);
+  if (db_entry != kernel_map_.end() && isValid(db_entry->second)) {
     return true;
   }
 
   // If the kernel doesn't already exist in the hash map, add it.
-  // The cubin and kernel code files are given a unique number based on the
-  // size of the hash map.
-  std::string kernel_num =
-      std::to_string(static_cast<unsigned long>(kernel_map_.size()));
-
-  // Kernel Code File path
-  std::string code_file_name("kernel_" + kernel_num + ".cu");
-  fs::path code_file_path = kernel_db_path_ / code_file_name;
-
-  // Cubin File path
-  std::string cubin_file_name("kernel_" + kernel_num + ".cubin");
-  fs::path cubin_file_path = kernel_db_path_ / cubin_file_name;
+  // The cubin and kernel code files are named by a hash of the kernel code,
+  // which is the same in all processes.
+  const std::string kernel_hash = stableHash(kernel_code);
+  const std::string code_file_name("kernel_" + kernel_hash + ".cu");
+  const std::string cubin_file_name("kernel_" + kernel_hash + ".cubin");
 
-  // Copy kernel code to file
-  bool status = copy_to_text_file(code_file_path.string(), kernel_code);
-
-  // If the kernel code copy was successful, copy the cubin to file
-  if (status) {
-    status = copy_to_binary_file(cubin_file_path.string(), cubin);
-  }
+  // Copy the kernel code and the cubin to files
+  bool status = copyToFileAtomically(
+                    kernel_db_path_ / code_file_name, kernel_code) &&
+      copyToFileAtomically(kernel_db_path_ / cubin_file_name, cubin);
 
   // If both files were created successfully, add an entry to the CSV file
+  KernelDbEntry tmp{
+      kernel_signature,
+      compile_args,
+      code_file_name,
+      cubin_file_name,
+      stableHash(cubin)};
   if (status) {
-    std::string entry(kernel_signature);
-    entry += "," + compile_args + "," + code_file_name + "," + cubin_file_name +
-        "\n";
+    std::string entry = entryLine(tmp);
+    // Terminate the partial line of a process that died while appending
+    std::ifstream in_file(kernel_db_txt_file_.c_str(), std::ios::in);
+    if (index_offset_ > 0 && in_file.seekg(index_offset_ - 1) &&
+        in_file.peek() != '\n') {
+      entry = "\n" + entry;
+    }
     status = append_to_text_file(kernel_db_txt_file_.string(), entry);
+    if (status) {
+      index_offset_ += (int64_t)entry.size();
+      ++num_index_lines_;
+    }
   }
 
   // If writing both files and adding an entry the CSV file was successful,
   // finally add an entry to the Kernel DB
   if (status) {
-    KernelDbEntry tmp{
-        kernel_signature, compile_args, code_file_name, cubin_file_name};
     kernel_map_[kernel_code] = tmp;
+    if (sizeBytes() > max_bytes_) {
+      // Evict a bit more than needed so that eviction doesn't run on every
+      // write once the db is full
+      compact(max_bytes_ / 10 * 9);
+    } else if (num_index_lines_ > 2 * (int64_t)kernel_map_.size() + 16) {
+      compact(max_bytes_);
+    }
   }
   return status;
 }
 
+int64_t KernelDb::sizeBytes() const {
+  int64_t total_bytes = 0;
+  for (const auto& [code, entry] : kernel_map_) {
+    for (const auto& file : {entry.kernel_code_file, entry.cubin_file}) {
+      std::error_code ec;
+      const auto size = fs::file_size(kernel_db_path_ / file, ec);
+      if (!ec) {
+        total_bytes += (int64_t)size;
+      }
+    }
+  }
+  return total_bytes;
+}
+
+void KernelDb::compact(int64_t target_bytes) {
+  FUSER_PERF_SCOPE("KernelDb::compact");
+  struct Entry {
+    const std::string* code;
+    fs::file_time_type last_use;
+    int64_t size;
+  };
+  std::vector<Entry> entries;
+  int64_t total_bytes = 0;
+  for (auto it = kernel_map_.begin(); it != kernel_map_.end();) {
+    const KernelDbEntry& entry = it->second;
+    std::error_code ec;
+    const auto last_use =
+        fs::last_write_time(kernel_db_path_ / entry.cubin_file, ec);
+    if (ec) {
+      // Evicted by another process
+      it = kernel_map_.erase(it);
+      continue;
+    }
+    int64_t size = 0;
+    for (const auto& file : {entry.kernel_code_file, entry.cubin_file}) {
+      std::error_code size_ec;
+      const auto file_size = fs::file_size(kernel_db_path_ / file, size_ec);
+      size += size_ec ? 0 : (int64_t)file_size;
+    }
+    entries.push_back({&it->first, last_use, size});
+    total_bytes += size;
+    ++it;
+  }
+
+  std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+    return a.last_use < b.last_use;
+  });
+  for (const auto& entry : entries) {
+    if (total_bytes <= target_bytes) {
+      break;
+    }
+    auto it = kernel_map_.find(*entry.code);
+    std::error_code ec;
+    fs::remove(kernel_db_path_ / it->second.kernel_code_file, ec);
+    fs::remove(kernel_db_path_ / it->second.cubin_file, ec);
+    total_bytes -= entry.size;
+    kernel_map_.erase(it);
+  }
+
+  std::string index = db_header + "\n";
+  for (const auto& [code, entry] : kernel_map_) {
+    index += entryLine(entry);
+  }
+  if (copyToFileAtomically(kernel_db_txt_file_, index)) {
+    index_offset_ = (int64_t)index.size();
+    index_file_id_ = fileId(kernel_db_txt_file_);
+    num_index_lines_ = (int64_t)kernel_map_.size();
+  }
+}
+
 } // namespace nvfuser
@@ -17,6 +17,8 @@ namespace fs = std::experimental::filesystem;
 #error "C++14 or Higher is required for filesystem library!"
 #endif
 
+#include <cstdint>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -36,11 +38,24 @@ struct KernelDbEntry {
   std::string kernel_code_file;
   //! Full file path to cubin
   std::string cubin_file;
+  //! Checksum of the cubin, empty for entries written without one
+  std::string checksum;
 };
 
 //! KernelDb class is a singleton structure that is used to open, query, and
 //! write to the the database that is held in a hash map.  The kernel code is
 //! used as string key to the hash map.
+//!
+//! The db directory can be shared by concurrent processes. The csv file is an
+//! append-only index that is updated under an exclusive file lock, and the
+//! files of an entry are renamed into place before the entry is appended, so
+//! readers never see a partial entry. Files are named by a hash of the kernel
+//! code, so processes writing different kernels don't clash. Each entry holds
+//! a checksum of its cubin, and corrupted entries are treated as misses and
+//! rewritten. A hit refreshes the modification time of the cubin, and a write
+//! that grows the db beyond its size limit evicts the least recently used
+//! entries. The index is compacted when evicting, or when it holds many more
+//! lines than entries.
 class KernelDb {
   KernelDb(bool _disabled);
 
@@ -64,7 +79,12 @@ class KernelDb {
       const std::string& kernel_db_file,
       bool use_temp_dir = true,
       bool disabled = false,
-      bool reset = false);
+      bool reset = false,
+      int64_t max_bytes = default_max_bytes);
+
+  //! Size limit of the kernel code and cubin files, which can be set in MB by
+  //! NVFUSER_ENABLE=kernel_db(<size>)
+  static constexpr int64_t default_max_bytes = 1024L * 1024 * 1024;
 
   //! Enable is derived from two booleans
   bool enabled() const {
@@ -91,7 +111,23 @@ class KernelDb {
       const std::string& kernel_signature,
       const std::vector<char>& cubin);
 
+  //! Total size of the kernel code and cubin files of the entries
+  NVF_API int64_t sizeBytes() const;
+
  private:
+  //! Reads the index lines appended since the last read, or the whole index
+  //! if it was replaced by another process. Returns false if the header
+  //! doesn't match. The caller holds the index lock.
+  bool readIndex();
+
+  //! Whether the cubin of entry can be read and matches its checksum
+  bool isValid(const KernelDbEntry& entry) const;
+
+  //! Removes the least recently used entries until the files of the others
+  //! take at most target_bytes, then rewrites the index with one line per
+  //! entry. The caller holds the index lock.
+  void compact(int64_t target_bytes);
+
   //! Disablement is specified by the user and can also be set by a
   //! failure to open the db
   bool disabled_ = true;
@@ -104,6 +140,16 @@ class KernelDb {
   fs::path kernel_db_path_;
   //! Full path to csv file used to record and restore the db
   fs::path kernel_db_txt_file_;
+
+  //! Size limit of the files of the db
+  int64_t max_bytes_ = default_max_bytes;
+  //! Number of bytes of the index that have been read
+  int64_t index_offset_ = 0;
+  //! File system id of the index that has been read, which changes when
+  //! another process compacts or resets the index
+  uint64_t index_file_id_ = 0;
+  //! Number of entry lines read from or appended to the index
+  int64_t num_index_lines_ = 0;
 };
 
 } // namespace nvfuser
@@ -0,0 +1,489 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <kernel_db/kernel_store.h>
+
+#include <debug.h>
+#include <exceptions.h>
+#include <instrumentation.h>
+#include <kernel_db/utils.h>
+#include <options.h>
+#include <utils.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <utility>
+
+#ifdef _WIN32
+#include <c10/util/win32-headers.h>
+#else
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+namespace nvfuser {
+
+namespace {
+
+// Identifies the object format. Bump the version if the layout changes.
+constexpr char object_magic[] = "nvfuser_kernel_store_v1";
+
+// Objects larger than this are refused, so a bad response can't exhaust memory
+constexpr size_t max_object_bytes = 1ull << 30;
+
+void appendString(std::vector<char>& dst, const char* data, size_t size) {
+  const uint64_t size64 = size;
+  const char* size_bytes = reinterpret_cast<const char*>(&size64);
+  dst.insert(dst.end(), size_bytes, size_bytes + sizeof(size64));
+  dst.insert(dst.end(), data, data + size);
+}
+
+// Reads a size-prefixed string at offset, advancing offset past it
+template <typename Container>
+bool readString(const std::vector<char>& src, size_t& offset, Container& dst) {
+  uint64_t size = 0;
+  if (src.size() - offset < sizeof(size)) {
+    return false;
+  }
+  std::memcpy(&size, src.data() + offset, sizeof(size));
+  offset += sizeof(size);
+  if (src.size() - offset < size) {
+    return false;
+  }
+  dst.assign(src.data() + offset, src.data() + offset + size);
+  offset += size;
+  return true;
+}
+
+//! Stores objects as files of a directory, e.g., on a network file system
+class LocalKernelStore : public KernelStore {
+ public:
+  explicit LocalKernelStore(fs::path dir) : dir_(std::move(dir)) {
+    std::error_code ec;
+    fs::create_directories(dir_, ec);
+    NVF_CHECK(
+        fs::is_directory(dir_, ec),
+        "Unable to create nvFuser kernel store directory! ",
+        dir_.string(),
+        " ",
+        ec.message());
+  }
+
+  bool get(const std::string& name, std::vector<char>& data) const override {
+    return copy_from_binary_file((dir_ / name).string(), data);
+  }
+
+  bool put(const std::string& name, const std::vector<char>& data) override {
+    // Renaming within a directory is atomic, so concurrent readers either see
+    // the complete object or none
+#ifdef _WIN32
+    const unsigned long pid = GetCurrentProcessId();
+#else
+    const unsigned long pid = getpid();
+#endif // _WIN32
+    static std::atomic<uint64_t> counter{0};
+    const fs::path path = dir_ / name;
+    const fs::path tmp_path(
+        path.string() + ".tmp." + std::to_string(pid) + "." +
+        std::to_string(counter++));
+    std::error_code ec;
+    if (!copy_to_binary_file(tmp_path.string(), data)) {
+      fs::remove(tmp_path, ec);
+      return false;
+    }
+    fs::rename(tmp_path, path, ec);
+    if (ec) {
+      fs::remove(tmp_path, ec);
+      return false;
+    }
+    return true;
+  }
+
+  std::string describe() const override {
+    return dir_.string();
+  }
+
+ private:
+  fs::path dir_;
+};
+
+//! Stores objects in an HTTP object store with GET and PUT requests. Only
+//! plain HTTP without authentication is supported.
+class HttpKernelStore : public KernelStore {
+ public:
+  HttpKernelStore(std::string host, std::string port, std::string prefix)
+      : host_(std::move(host)),
+        port_(std::move(port)),
+        prefix_(std::move(prefix)) {}
+
+  bool get(const std::string& name, std::vector<char>& data) const override {
+    std::stringstream request;
+    request << "GET " << prefix_ << "/" << name << " HTTP/1.1\r\n"
+            << "Host: " << host_ << "\r\n"
+            << "Connection: close\r\n\r\n";
+    const std::string header = request.str();
+    return send(header, nullptr, data);
+  }
+
+  bool put(const std::string& name, const std::vector<char>& data) override {
+    std::stringstream request;
+    request << "PUT " << prefix_ << "/" << name << " HTTP/1.1\r\n"
+            << "Host: " << host_ << "\r\n"
+            << "Content-Type: application/octet-stream\r\n"
+            << "Content-Length: " << data.size() << "\r\n"
+            << "Connection: close\r\n\r\n";
+    std::vector<char> response;
+    return send(request.str(), &data, response);
+  }
+
+  std::string describe() const override {
+    return "http://" + host_ + ":" + port_ + prefix_;
+  }
+
+ private:
+  //! Sends a request with an optional body, and returns the body of a 2xx
+  //! response
+  bool send(
+      const std::string& header,
+      const std::vector<char>* body,
+      std::vector<char>& response_body) const {
+#ifdef _WIN32
+    return false;
+#else
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    if (getaddrinfo(host_.c_str(), port_.c_str(), &hints, &addresses) != 0) {
+      return false;
+    }
+    int fd = -1;
+    for (addrinfo* ai = addresses; ai != nullptr; ai = ai->ai_next) {
+      fd = socket(ai->ai_family, ai->ai_socktype | SOCK_CLOEXEC, 0);
+      if (fd < 0) {
+        continue;
+      }
+      // Bounds connecting, sending and receiving, so an unreachable store
+      // can't stall compilation for long
+      timeval timeout{10, 0};
+      setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+      setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+      if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) {
+        break;
+      }
+      close(fd);
+      fd = -1;
+    }
+    freeaddrinfo(addresses);
+    if (fd < 0) {
+      return false;
+    }
+
+    auto send_all = [fd](const char* data, size_t size) {
+      while (size > 0) {
+        const ssize_t sent = ::send(fd, data, size, MSG_NOSIGNAL);
+        if (sent <= 0) {
+          return false;
+        }
+        data += sent;
+        size -= (size_t)sent;
+      }
+      return true;
+    };
+    std::vector<char> response;
+    bool ok = send_all(header.data(), header.size()) &&
+        (body == nullptr || send_all(body->data(), body->size()));
+    while (ok) {
+      char buffer[65536];
+      const ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+      if (received == 0) {
+        break;
+      }
+      ok = received > 0 && response.size() + received <= max_object_bytes;
+      if (ok) {
+        response.insert(response.end(), buffer, buffer + received);
+      }
+    }
+    close(fd);
+    return ok && parseResponse(response, response_body);
+#endif // _WIN32
+  }
+
+  //! Extracts the body of a complete 2xx response
+  static bool parseResponse(
+      const std::vector<char>& response,
+      std::vector<char>& body) {
+    const char separator[] = "\r\n\r\n";
+    const auto header_end = std::search(
+        response.begin(), response.end(), separator, separator + 4);
+    if (header_end == response.end()) {
+      return false;
+    }
+    std::string header(response.begin(), header_end);
+    std::transform(header.begin(), header.end(), header.begin(), [](char c) {
+      return (char)std::tolower((unsigned char)c);
+    });
+    // Status line, e.g. "HTTP/1.1 200 OK"
+    const auto status_pos = header.find(' ');
+    if (header.compare(0, 5, "http/") != 0 || status_pos == std::string::npos ||
+        header.size() < status_pos + 2 || header[status_pos + 1] != '2') {
+      return false;
+    }
+
+    const auto body_begin = header_end + 4;
+    auto header_value = [&header](const std::string& name) -> std::string {
+      const auto pos = header.find("\r\n" + name + ":");
+      if (pos == std::string::npos) {
+        return "";
+      }
+      const auto begin = header.find_first_not_of(' ', pos + name.size() + 3);
+      if (begin == std::string::npos) {
+        return "";
+      }
+      const auto end = header.find("\r\n", begin);
+      return header.substr(begin, end - begin);
+    };
+
+    if (header_value("transfer-encoding").find("chunked") ==
+        std::string::npos) {
+      body.assign(body_begin, response.end());
+      const std::string length = header_value("content-length");
+      if (length.empty()) {
+        return true;
+      }
+      // A malformed length is a failed request rather than an exception
+      size_t content_length = 0;
+      const auto [ptr, ec] = std::from_chars(
+          length.data(), length.data() + length.size(), content_length);
+      return ec == std::errc() && ptr == length.data() + length.size() &&
+          content_length == body.size();
+    }
+
+    // Each chunk is its size in hex, CRLF, the data and CRLF. The last chunk
+    // is empty.
+    body.clear();
+    auto pos = body_begin;
+    while (true) {
+      const auto line_end =
+          std::search(pos, response.end(), separator, separator + 2);
+      if (line_end == response.end()) {
+        return false;
+      }
+      const size_t chunk_size =
+          std::strtoull(std::string(pos, line_end).c_str(), nullptr, 16);
+      pos = line_end + 2;
+      if (chunk_size == 0) {
+        return true;
+      }
+      if ((size_t)(response.end() - pos) < chunk_size + 2) {
+        return false;
+      }
+      body.insert(body.end(), pos, pos + (std::ptrdiff_t)chunk_size);
+      pos += (std::ptrdiff_t)chunk_size + 2;
+    }
+  }
+
+ private:
+  std::string host_;
+  std::string port_;
+  //! Path of the objects, e.g. /bucket/nvfuser, without a trailing slash
+  std::string prefix_;
+};
+
+std::string objectName(
+    const std::string& key,
+    const std::string& full_src_code) {
+  return stable_hash(key.data(), key.size()) +
+      stable_hash(full_src_code.data(), full_src_code.size()) + ".kernel";
+}
+
+} // namespace
+
+std::shared_ptr<KernelStore> KernelStore::create(const std::string& url) {
+  const std::string file_scheme = "file://";
+  const std::string http_scheme = "http://";
+  if (url.compare(0, file_scheme.size(), file_scheme) == 0) {
+    return std::make_shared<LocalKernelStore>(url.substr(file_scheme.size()));
+  }
+  if (url.compare(0, http_scheme.size(), http_scheme) == 0) {
+    const std::string rest = url.substr(http_scheme.size());
+    const auto path_pos = rest.find('/');
+    const std::string authority = rest.substr(0, path_pos);
+    std::string prefix =
+        path_pos == std::string::npos ? "" : rest.substr(path_pos);
+    while (!prefix.empty() && prefix.back() == '/') {
+      prefix.pop_back();
+    }
+    const auto port_pos = authority.rfind(':');
+    if (port_pos == std::string::npos) {
+      return std::make_shared<HttpKernelStore>(authority, "80", prefix);
+    }
+    return std::make_shared<HttpKernelStore>(
+        authority.substr(0, port_pos), authority.substr(port_pos + 1), prefix);
+  }
+  return nullptr;
+}
+
+std::shared_ptr<KernelStore> KernelStore::remote() {
+  if (!isOptionEnabled(EnableOption::KernelRemoteCache)) {
+    return nullptr;
+  }
+
+  static std::mutex store_lock;
+  static std::shared_ptr<KernelStore> store;
+  static std::vector<std::string> store_args;
+  static bool failed = false;
+
+  const auto& args = getEnableOptionArguments(EnableOption::KernelRemoteCache);
+  std::lock_guard<std::mutex> guard(store_lock);
+  // Options can be changed at runtime, e.g. by tests
+  if ((store == nullptr && !failed) || args != store_args) {
+    store_args = args;
+    store.reset();
+    failed = false;
+    try {
+      NVF_CHECK(!args.empty(), "kernel_remote_cache requires a url");
+      store = create(args[0]);
+      NVF_CHECK(store != nullptr, "Unsupported url: ", args[0]);
+    } catch (const std::exception& e) {
+      TORCH_WARN(
+          "nvFuser's kernel remote cache is disabled because it could not be opened. Exception: ",
+          e.what());
+      failed = true;
+    }
+  }
+  return store;
+}
+
+bool KernelStore::query(
+    const std::string& key,
+    const std::string& full_src_code,
+    std::string& kernel_name,
+    std::vector<char>& binary) const {
+  FUSER_PERF_SCOPE("KernelStore::query");
+  std::vector<char> object;
+  if (!get(objectName(key, full_src_code), object)) {
+    return false;
+  }
+
+  size_t offset = sizeof(object_magic);
+  std::string stored_key;
+  std::string stored_src;
+  std::string stored_name;
+  std::vector<char> stored_binary;
+  if (object.size() < offset ||
+      std::memcmp(object.data(), object_magic, sizeof(object_magic)) != 0 ||
+      !readString(object, offset, stored_key) || stored_key != key ||
+      !readString(object, offset, stored_src) ||
+      stored_src != full_src_code ||
+      !readString(object, offset, stored_name) ||
+      !readString(object, offset, stored_binary)) {
+    return false;
+  }
+  kernel_name = std::move(stored_name);
+  binary = std::move(stored_binary);
+
+  if (isDebugDumpEnabled(DebugDumpOption::KernelDiskCache)) {
+    debug() << "[kernel remote cache] Hit " << describe() << "/"
+            << objectName(key, full_src_code) << std::endl;
+  }
+  return true;
+}
+
+bool KernelStore::write(
+    const std::string& key,
+    const std::string& full_src_code,
+    const std::string& kernel_name,
+    const std::vector<char>& binary) {
+  FUSER_PERF_SCOPE("KernelStore::write");
+  std::vector<char> object(object_magic, object_magic + sizeof(object_magic));
+  appendString(object, key.data(), key.size());
+  appendString(object, full_src_code.data(), full_src_code.size());
+  appendString(object, kernel_name.data(), kernel_name.size());
+  appendString(object, binary.data(), binary.size());
+  const bool status = put(objectName(key, full_src_code), object);
+  if (status && isDebugDumpEnabled(DebugDumpOption::KernelDiskCache)) {
+    debug() << "[kernel remote cache] Wrote " << describe() << "/"
+            << objectName(key, full_src_code) << std::endl;
+  }
+  return status;
+}
+
+struct KernelStoreLookup::State {
+  std::shared_ptr<KernelStore> store;
+  std::string key;
+  std::string full_src_code;
+  // Set by whichever of the pool task and wait() runs the query first
+  std::atomic<bool> started = false;
+
+  std::mutex mutex;
+  std::condition_variable done_cv;
+  bool done = false;
+  bool hit = false;
+  std::string kernel_name;
+  std::vector<char> binary;
+
+  void run() {
+    if (started.exchange(true)) {
+      return;
+    }
+    std::string name;
+    std::vector<char> object;
+    bool status = false;
+    try {
+      status = store->query(key, full_src_code, name, object);
+    } catch (const std::exception&) {
+    }
+    std::lock_guard<std::mutex> guard(mutex);
+    hit = status;
+    kernel_name = std::move(name);
+    binary = std::move(object);
+    done = true;
+    done_cv.notify_all();
+  }
+};
+
+KernelStoreLookup::KernelStoreLookup(
+    std::shared_ptr<KernelStore> store,
+    std::string key,
+    std::string full_src_code)
+    : state_(std::make_shared<State>()) {
+  state_->store = std::move(store);
+  state_->key = std::move(key);
+  state_->full_src_code = std::move(full_src_code);
+  // The task shares the state, so it can outlive the lookup, e.g., when a
+  // local cache has the kernel
+  getThreadPool()->run([state = state_]() { state->run(); });
+}
+
+bool KernelStoreLookup::wait(
+    std::string& kernel_name,
+    std::vector<char>& binary) {
+  FUSER_PERF_SCOPE("KernelStoreLookup::wait");
+  // Compiles also run on the thread pool, so the query runs here if no
+  // worker has picked it up yet rather than waiting for a free worker
+  state_->run();
+  std::unique_lock<std::mutex> lock(state_->mutex);
+  state_->done_cv.wait(lock, [this]() { return state_->done; });
+  if (!state_->hit) {
+    return false;
+  }
+  kernel_name = state_->kernel_name;
+  binary = state_->binary;
+  return true;
+}
+
+} // namespace nvfuser
@@ -0,0 +1,85 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <kernel_db/kernel_db.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <visibility.h>
+
+namespace nvfuser {
+
+//! KernelStore is a storage backend of compiled kernels, e.g., shared by all
+//! the nodes of a cluster. It is enabled with
+//! NVFUSER_ENABLE=kernel_remote_cache(<url>), where url is either
+//! file:///path/to/dir, e.g., a network file system, or
+//! http://host[:port]/prefix for an HTTP object store that serves GET and PUT
+//! of <prefix>/<object>, like an S3-compatible bucket writable without
+//! request signing or a WebDAV server.
+//!
+//! Objects are named by a stable hash of the source and the key, which covers
+//! everything else that determines the binary, see getCompiledKernel. The
+//! full key and source are stored in the object and compared on lookup, so
+//! hash collisions can't return a wrong binary. All errors are misses.
+class KernelStore {
+ public:
+  virtual ~KernelStore() = default;
+
+  //! Returns the store configured by EnableOption::KernelRemoteCache, or
+  //! nullptr if the option is not enabled or its url is not supported
+  static std::shared_ptr<KernelStore> remote();
+
+  //! Creates the store of url, or returns nullptr if url is not supported
+  NVF_API static std::shared_ptr<KernelStore> create(const std::string& url);
+
+  //! Reads the object of name
+  virtual bool get(const std::string& name, std::vector<char>& data) const = 0;
+
+  //! Writes the object of name, replacing an existing one
+  virtual bool put(const std::string& name, const std::vector<char>& data) = 0;
+
+  //! Description of the store for logs
+  virtual std::string describe() const = 0;
+
+  //! Looks up the binary compiled from full_src_code with the given key
+  NVF_API bool query(
+      const std::string& key,
+      const std::string& full_src_code,
+      std::string& kernel_name,
+      std::vector<char>& binary) const;
+
+  //! Stores a binary compiled from full_src_code with the given key
+  NVF_API bool write(
+      const std::string& key,
+      const std::string& full_src_code,
+      const std::string& kernel_name,
+      const std::vector<char>& binary);
+};
+
+//! A KernelStore::query that runs on the shared thread pool, so querying a
+//! remote store overlaps with the local lookups. Destroying the lookup
+//! doesn't wait for the query.
+class KernelStoreLookup {
+ public:
+  NVF_API KernelStoreLookup(
+      std::shared_ptr<KernelStore> store,
+      std::string key,
+      std::string full_src_code);
+
+  //! Waits for the query. Returns false on a miss.
+  NVF_API bool wait(std::string& kernel_name, std::vector<char>& binary);
+
+ private:
+  struct State;
+  std::shared_ptr<State> state_;
+};
+
+} // namespace nvfuser
@@ -6,7 +6,10 @@
  */
 // clang-format on
 #include <kernel_db/utils.h>
+#include <cstdint>
 #include <fstream>
+#include <iomanip>
+#include <sstream>
 
 namespace nvfuser {
 
@@ -76,4 +79,14 @@ bool copy_to_text_file(const std::string& file_path, const std::string& src) {
   return status;
 }
 
+std::string stable_hash(const char* data, size_t size) {
+  uint64_t hash = 14695981039346656037ull;
+  for (size_t i = 0; i < size; ++i) {
+    hash = (hash ^ (uint8_t)data[i]) * 1099511628211ull;
+  }
+  std::stringstream ss;
+  ss << std::hex << std::setfill('0') << std::setw(16) << hash;
+  return ss.str();
+}
+
 } // namespace nvfuser
@@ -34,4 +34,8 @@ NVF_API bool copy_to_text_file(
     const std::string& file_path,
     const std::string& src);
 
+//! Returns the 64-bit FNV-1a hash of data as 16 hex digits. Unlike std::hash,
+//! it is the same in every build and process, so it can name shared files.
+NVF_API std::string stable_hash(const char* data, size_t size);
+
 } // namespace nvfuser
@@ -564,6 +564,51 @@ std::string MBarrierWait::toInlineString(int indent_size) const {
 
 NVFUSER_DEFINE_CLONE_AND_CREATE(MBarrierWait)
 
+MBarrierWaitParity::MBarrierWaitParity(
+    IrBuilderPasskey passkey,
+    Val* mbarrier,
+    Val* parity)
+    : Expr(passkey) {
+  NVF_ERROR(passkey.ir_container_ != nullptr);
+  NVF_CHECK(parity->dtype() == DataType::UInt32);
+  addInput(mbarrier);
+  addInput(parity);
+}
+
+std::string MBarrierWaitParity::toString(int indent_size) const {
+  std::stringstream ss;
+  indent(ss, indent_size) << "MBarrierWaitParity(" << mbarrier()->toString()
+                          << ", " << parity()->toString() << ")\n";
+  return ss.str();
+}
+
+std::string MBarrierWaitParity::toInlineString(int indent_size) const {
+  NVF_CHECK(false, "MBarrierWaitParity can not be printed inline");
+}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(MBarrierWaitParity)
+
+MBarrierArriveCpAsync::MBarrierArriveCpAsync(
+    IrBuilderPasskey passkey,
+    Val* mbarrier)
+    : Expr(passkey) {
+  NVF_ERROR(passkey.ir_container_ != nullptr);
+  addInput(mbarrier);
+}
+
+std::string MBarrierArriveCpAsync::toString(int indent_size) const {
+  std::stringstream ss;
+  indent(ss, indent_size) << "MBarrierArriveCpAsync(" << mbarrier()->toString()
+                          << ")\n";
+  return ss.str();
+}
+
+std::string MBarrierArriveCpAsync::toInlineString(int indent_size) const {
+  NVF_CHECK(false, "MBarrierArriveCpAsync can not be printed inline");
+}
+
+NVFUSER_DEFINE_CLONE_AND_CREATE(MBarrierArriveCpAsync)
+
 BlockSerializeWait::BlockSerializeWait(
     IrBuilderPasskey passkey,
     ParallelTypeBitmap sync_dims,
@@ -1165,10 +1210,15 @@ std::string GridReduction::toString(int indent_size) const {
                           << ", initial value = " << init()->toString()
                           << ",\n";
   ++indent_size;
-  indent(ss, indent_size) << "reduction buffer = "
-                          << reduction_buffer()->buffer()->toString() << ",\n";
-  indent(ss, indent_size) << "sync buffer = "
-                          << sync_buffer()->buffer()->toString() << ",\n";
+  if (reduction_buffer() != nullptr) {
+    indent(ss, indent_size)
+        << "reduction buffer = " << reduction_buffer()->buffer()->toString()
+        << ",\n";
+  }
+  if (sync_buffer() != nullptr) {
+    indent(ss, indent_size) << "sync buffer = "
+                            << sync_buffer()->buffer()->toString() << ",\n";
+  }
   indent(ss, indent_size) << "read predicate = ";
   if (predicate() != nullptr) {
     ss << predicate()->toString();
@@ -1189,6 +1239,8 @@ std::string GridReduction::toString(int indent_size) const {
                           << (isAllreduce() ? "true" : "false") << " )\n";
   indent(ss, indent_size) << "serial reduction = "
                           << (isSerial() ? "true" : "false") << " )\n";
+  indent(ss, indent_size) << "atomic reduction = "
+                          << (isAtomic() ? "true" : "false") << " )\n";
   if (isSerial()) {
     indent(ss, indent_size)
         << "serial reduction tensor = " << serialReductionTensor()->toString()
@@ -44,6 +44,8 @@ class MBarrierInvalidate;
 class MBarrierArrive;
 class MBarrierArriveExpectTx;
 class MBarrierWait;
+class MBarrierWaitParity;
+class MBarrierArriveCpAsync;
 class BlockSerializeWait;
 class BlockSerializeRelease;
 class AsyncWait;
@@ -559,6 +561,57 @@ class NVF_API MBarrierWait final : public Expr {
   }
 };
 
+// IR node for: mbarrier.try_wait.parity
+// Waits for the completion of the mbarrier phase with the given parity. This
+// is used by circular buffering, where a stage is waited by a later iteration
+// than the one that arrived on its mbarrier.
+class NVF_API MBarrierWaitParity final : public Expr {
+ public:
+  using Expr::Expr;
+  explicit MBarrierWaitParity(
+      IrBuilderPasskey passkey,
+      Val* mbarrier,
+      Val* parity);
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  const char* getOpString() const override {
+    return "MBarrierWaitParity";
+  }
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+
+  Val* mbarrier() const {
+    return input(0);
+  }
+
+  Val* parity() const {
+    return input(1);
+  }
+};
+
+// IR node for: cp.async.mbarrier.arrive.noinc
+// Arrives on the mbarrier once all prior cp.async of the thread completed.
+class NVF_API MBarrierArriveCpAsync final : public Expr {
+ public:
+  using Expr::Expr;
+  explicit MBarrierArriveCpAsync(IrBuilderPasskey passkey, Val* mbarrier);
+
+  NVFUSER_DECLARE_CLONE_AND_CREATE
+
+  const char* getOpString() const override {
+    return "MBarrierArriveCpAsync";
+  }
+
+  std::string toString(int indent_size = 0) const override;
+  std::string toInlineString(int indent_size = 0) const override;
+
+  Val* mbarrier() const {
+    return input(0);
+  }
+};
+
 // For all but first block in each reduction segment, first thread waits for
 // sync flag to indicate it is our turn to proceed (sync flag is incremented by
 // BlockSerializeRelease). Then block sync. This has the effect of
@@ -986,7 +1039,7 @@ class NVF_API IfThenElse final : public Expr {
 //! This node provides FusionExecutor the information it needs to allocate the
 //! reduction and sync buffers.
 class GridReduction final : public ReductionOp {
-  static constexpr int num_reduction_op_attr = 4;
+  static constexpr int num_reduction_op_attr = 5;
 
  public:
   using ReductionOp::ReductionOp;
@@ -1013,12 +1066,14 @@ class GridReduction final : public ReductionOp {
   std::string toString(int indent_size = 0) const override;
   std::string toInlineString(int indent_size = 0) const override;
 
+  // nullptr for serial and atomic grid reductions
   Allocate* reduction_buffer() const {
-    return attribute(num_reduction_op_attr)->as<Allocate>();
+    return dynamic_cast<Allocate*>(attribute(num_reduction_op_attr));
   }
 
+  // nullptr for serial and atomic grid reductions
   Allocate* sync_buffer() const {
-    return attribute(num_reduction_op_attr + 1)->as<Allocate>();
+    return dynamic_cast<Allocate*>(attribute(num_reduction_op_attr + 1));
   }
 
   // Which instance of entering this grid reduction is this iteration?
@@ -1050,6 +1105,12 @@ class GridReduction final : public ReductionOp {
     return serialReductionTensor() != nullptr;
   }
 
+  //! Atomic grid reductions add the block results directly to the output,
+  //! so they have neither a work buffer nor a sync buffer
+  bool isAtomic() const {
+    return atomicGridReductionRequested();
+  }
+
   GridReduction* withThreadPredicate(
       const ParallelTypeBitmap& thread_predicate) {
     auto result = shallowCopy()->as<GridReduction>();
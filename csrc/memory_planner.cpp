@@ -0,0 +1,107 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <memory_planner.h>
+
+#include <exceptions.h>
+#include <utils.h>
+
+#include <algorithm>
+#include <map>
+#include <numeric>
+
+namespace nvfuser {
+
+namespace {
+
+int64_t alignUp(int64_t value, int64_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+bool livesOverlap(const BufferLifetime& a, const BufferLifetime& b) {
+  return a.first_use <= b.last_use && b.first_use <= a.last_use;
+}
+
+} // namespace
+
+MemoryPlan planMemory(
+    const std::vector<BufferLifetime>& lifetimes,
+    int64_t alignment) {
+  NVF_ERROR(alignment > 0, "Invalid alignment: ", alignment);
+
+  MemoryPlan plan;
+  plan.offsets.resize(lifetimes.size(), 0);
+
+  // Live bytes at each step, to report how close the plan is to optimal
+  std::map<int64_t, int64_t> live_bytes_delta;
+  for (const auto& lifetime : lifetimes) {
+    NVF_ERROR(
+        lifetime.first_use <= lifetime.last_use && lifetime.size_bytes >= 0,
+        "Invalid buffer lifetime: [",
+        lifetime.first_use,
+        ", ",
+        lifetime.last_use,
+        "] of ",
+        lifetime.size_bytes,
+        " bytes");
+    const int64_t size = alignUp(lifetime.size_bytes, alignment);
+    plan.total_bytes += size;
+    live_bytes_delta[lifetime.first_use] += size;
+    live_bytes_delta[lifetime.last_use + 1] -= size;
+  }
+  int64_t live_bytes = 0;
+  for (const auto& [step, delta] : live_bytes_delta) {
+    live_bytes += delta;
+    plan.peak_live_bytes = std::max(plan.peak_live_bytes, live_bytes);
+  }
+
+  // Larger buffers first, ties broken by earlier first use so the result is
+  // deterministic
+  std::vector<size_t> order(lifetimes.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    if (lifetimes[a].size_bytes != lifetimes[b].size_bytes) {
+      return lifetimes[a].size_bytes > lifetimes[b].size_bytes;
+    }
+    return lifetimes[a].first_use < lifetimes[b].first_use;
+  });
+
+  std::vector<size_t> placed;
+  placed.reserve(lifetimes.size());
+  for (size_t i : order) {
+    const int64_t size = alignUp(lifetimes[i].size_bytes, alignment);
+
+    // Address ranges taken by placed buffers live together with this one,
+    // sorted by offset
+    std::vector<std::pair<int64_t, int64_t>> conflicts;
+    for (size_t j : placed) {
+      if (livesOverlap(lifetimes[i], lifetimes[j])) {
+        conflicts.emplace_back(
+            plan.offsets[j],
+            plan.offsets[j] + alignUp(lifetimes[j].size_bytes, alignment));
+      }
+    }
+    std::sort(conflicts.begin(), conflicts.end());
+
+    // First fit into the gaps between conflicting ranges
+    int64_t offset = 0;
+    for (const auto& [begin, end] : conflicts) {
+      if (offset + size <= begin) {
+        break;
+      }
+      offset = std::max(offset, end);
+    }
+
+    plan.offsets[i] = offset;
+    plan.arena_bytes = std::max(plan.arena_bytes, offset + size);
+    placed.push_back(i);
+  }
+
+  return plan;
+}
+
+} // namespace nvfuser
@@ -0,0 +1,48 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace nvfuser {
+
+//! A buffer that is live from the start of step `first_use` until the end of
+//! step `last_use`, both inclusive. For segment intermediates, a step is the
+//! run order position of a segment.
+struct BufferLifetime {
+  int64_t first_use = 0;
+  int64_t last_use = 0;
+  int64_t size_bytes = 0;
+};
+
+//! Placement of a set of buffers in a single arena
+struct MemoryPlan {
+  //! Byte offset of each buffer in the arena, indexed like the lifetimes the
+  //! plan was made from
+  std::vector<int64_t> offsets;
+  //! Size of the arena needed to hold all buffers
+  int64_t arena_bytes = 0;
+  //! Lower bound of arena_bytes: the largest total size of buffers live at
+  //! the same step
+  int64_t peak_live_bytes = 0;
+  //! Memory needed if every buffer got its own allocation
+  int64_t total_bytes = 0;
+};
+
+//! Packs buffers with overlapping lifetimes into disjoint ranges of one arena,
+//! letting buffers whose lifetimes don't overlap share memory. This is
+//! coloring of the interval graph of the lifetimes where colors are address
+//! ranges. Buffers are placed in decreasing order of size, each at the lowest
+//! aligned offset not overlapping any already placed buffer it is live
+//! together with.
+MemoryPlan planMemory(
+    const std::vector<BufferLifetime>& lifetimes,
+    int64_t alignment = 256);
+
+} // namespace nvfuser
@@ -103,6 +103,9 @@ std::string toString(MmaMacro macro) {
       ss << "Hopper";
       break;
   }
+  if (underlying.sparse) {
+    ss << "Sparse";
+  }
   ss << "_" << underlying.m << "_" << underlying.n << "_" << underlying.k;
   return ss.str();
 }
@@ -33,14 +33,27 @@ enum class MatmulDomain { M = 0, N, K };
 //!  INPUT_B - a producer of MMA input B
 //!  INPUT_C - a producer of a tensor used in fusion epilogue,
 //!            for example tensor used in beta scaling fusion
+//!  INPUT_PROLOGUE - a producer of a tensor used in the prologue of MMA
+//!                   input A or B, for example dequantization scales
 //!  OUTPUT_D - the main consumer of MMA op results
 //!  OUTPUT_AUX - fusion outputs that are consumers of OUTPUT_D
+//!  OUTPUT_REDUCTION - fusion outputs that reduce the epilogue along M
+//!                     and/or N
 //!
 //! Naming convention is based on the following formula:
-//!    D = alpha * A x B + beta * C
+//!    D = alpha * A x (PROLOGUE * B) + beta * C
 //!    AUX = relu(D)
+//!    REDUCTION = sum(D, {M})
 //!  Note: bias vector tensors will be assigned to INPUT_C role.
-enum class MatmulRole { INPUT_A = 0, INPUT_B, OUTPUT_D, INPUT_C, OUTPUT_AUX };
+enum class MatmulRole {
+  INPUT_A = 0,
+  INPUT_B,
+  OUTPUT_D,
+  INPUT_C,
+  INPUT_PROLOGUE,
+  OUTPUT_AUX,
+  OUTPUT_REDUCTION
+};
 
 //! The expected number of occurances of core TensorView roles in fusion
 static constexpr size_t MATMUL_CORE_ROLES_EXPECTED_COUNT = 1;
@@ -87,7 +100,9 @@ struct MatMulTileOptions {
 enum class MmaMacro : uint64_t;
 
 struct MmaMacroEncode {
-  enum class Arch { NoMma, Volta, Turing, Ampere, Hopper } arch : 16;
+  enum class Arch { NoMma, Volta, Turing, Ampere, Hopper } arch : 8;
+  // Whether operand A is 2:4 structured-sparse
+  unsigned sparse : 8;
   unsigned m : 16;
   unsigned n : 16;
   unsigned k : 16;
@@ -97,8 +112,8 @@ struct MmaMacroEncode {
     // std::bit_cast for bit field is not supported by clang yet
     return std::bit_cast<uint64_t>(*this);
 #else
-    return (uint64_t)arch << 48 | (uint64_t)m << 32 | (uint64_t)n << 16 |
-        (uint64_t)k;
+    return (uint64_t)arch << 56 | (uint64_t)sparse << 48 | (uint64_t)m << 32 |
+        (uint64_t)n << 16 | (uint64_t)k;
 #endif
   }
 
@@ -106,8 +121,13 @@ struct MmaMacroEncode {
 
   constexpr MmaMacroEncode(MmaMacro macro);
 
-  constexpr MmaMacroEncode(Arch arch, unsigned m, unsigned n, unsigned k)
-      : arch(arch), m(m), n(n), k(k) {}
+  constexpr MmaMacroEncode(
+      Arch arch,
+      unsigned m,
+      unsigned n,
+      unsigned k,
+      bool sparse = false)
+      : arch(arch), sparse(sparse), m(m), n(n), k(k) {}
 };
 
 static_assert(sizeof(MmaMacroEncode) == sizeof(uint64_t));
@@ -126,6 +146,10 @@ static_assert(sizeof(MmaMacroEncode) == sizeof(uint64_t));
 #define MACRO(arch, m, n, k) \
   arch##_##m##_##n##_##k = MmaMacroEncode(MmaMacroEncode::Arch::arch, m, n, k)
 
+#define SPARSE_MACRO(arch, m, n, k)              \
+  arch##Sparse_##m##_##n##_##k = MmaMacroEncode( \
+      MmaMacroEncode::Arch::arch, m, n, k, /*sparse=*/true)
+
 enum class MmaMacro : uint64_t {
   NoMMA = 0,
 
@@ -136,6 +160,17 @@ enum class MmaMacro : uint64_t {
   MACRO(Ampere, 16, 8, 16),
   MACRO(Ampere, 16, 16, 16),
 
+  // Ampere macros with k = 32 take Int8 operands and accumulate in Int32. Like
+  // for 8-bit floating point, both operands have to be K-major (TN layout)
+  MACRO(Ampere, 16, 8, 32),
+  MACRO(Ampere, 16, 16, 32),
+
+  // Sparse Ampere macros multiply a 2:4 structured-sparse A, i.e., the
+  // compressed 16x16 values of a 16x32 tile and their metadata, with a dense
+  // 16-bit B (mma.sp). k is the dense extent of the tile.
+  SPARSE_MACRO(Ampere, 16, 8, 32),
+  SPARSE_MACRO(Ampere, 16, 16, 32),
+
   MACRO(Hopper, 64, 8, 16),
   MACRO(Hopper, 64, 16, 16),
   MACRO(Hopper, 64, 24, 16),
@@ -168,9 +203,45 @@ enum class MmaMacro : uint64_t {
   MACRO(Hopper, 64, 240, 16),
   MACRO(Hopper, 64, 248, 16),
   MACRO(Hopper, 64, 256, 16),
+
+  // Hopper macros with k = 32 take 8-bit floating point operands, and require
+  // both operands to be K-major (TN layout)
+  MACRO(Hopper, 64, 8, 32),
+  MACRO(Hopper, 64, 16, 32),
+  MACRO(Hopper, 64, 24, 32),
+  MACRO(Hopper, 64, 32, 32),
+  MACRO(Hopper, 64, 40, 32),
+  MACRO(Hopper, 64, 48, 32),
+  MACRO(Hopper, 64, 56, 32),
+  MACRO(Hopper, 64, 64, 32),
+  MACRO(Hopper, 64, 72, 32),
+  MACRO(Hopper, 64, 80, 32),
+  MACRO(Hopper, 64, 88, 32),
+  MACRO(Hopper, 64, 96, 32),
+  MACRO(Hopper, 64, 104, 32),
+  MACRO(Hopper, 64, 112, 32),
+  MACRO(Hopper, 64, 120, 32),
+  MACRO(Hopper, 64, 128, 32),
+  MACRO(Hopper, 64, 136, 32),
+  MACRO(Hopper, 64, 144, 32),
+  MACRO(Hopper, 64, 152, 32),
+  MACRO(Hopper, 64, 160, 32),
+  MACRO(Hopper, 64, 168, 32),
+  MACRO(Hopper, 64, 176, 32),
+  MACRO(Hopper, 64, 184, 32),
+  MACRO(Hopper, 64, 192, 32),
+  MACRO(Hopper, 64, 200, 32),
+  MACRO(Hopper, 64, 208, 32),
+  MACRO(Hopper, 64, 216, 32),
+  MACRO(Hopper, 64, 224, 32),
+  MACRO(Hopper, 64, 232, 32),
+  MACRO(Hopper, 64, 240, 32),
+  MACRO(Hopper, 64, 248, 32),
+  MACRO(Hopper, 64, 256, 32),
 };
 
 #undef MACRO
+#undef SPARSE_MACRO
 
 constexpr MmaMacroEncode::operator MmaMacro() {
 #if IS_CPP20 && !defined(__clang__)
@@ -188,7 +259,8 @@ constexpr MmaMacroEncode::MmaMacroEncode(MmaMacro macro)
   *this = std::bit_cast<MmaMacroEncode>(macro);
 }
 #else
-    : arch((Arch)(toUnderlying(macro) >> 48)),
+    : arch((Arch)(toUnderlying(macro) >> 56)),
+      sparse((toUnderlying(macro) >> 48) & 0xFF),
       m((toUnderlying(macro) >> 32) & 0xFFFF),
       n((toUnderlying(macro) >> 16) & 0xFFFF),
       k(toUnderlying(macro) & 0xFFFF) {
@@ -220,6 +292,21 @@ inline bool isHopper(MmaMacro macro) {
   return MmaMacroEncode(macro).arch == MmaMacroEncode::Arch::Hopper;
 }
 
+//! Whether operand A of the macro is 2:4 structured-sparse
+inline bool isSparse(MmaMacro macro) {
+  return MmaMacroEncode(macro).sparse;
+}
+
+//! Whether the macro multiplies 8-bit floating point operands
+inline bool isFp8(MmaMacro macro) {
+  return isHopper(macro) && MmaMacroEncode(macro).k == 32;
+}
+
+//! Whether the macro multiplies Int8 operands with Int32 accumulation
+inline bool isInt8(MmaMacro macro) {
+  return isAmpere(macro) && !isSparse(macro) && MmaMacroEncode(macro).k == 32;
+}
+
 //! Get the m size from macro type
 inline int getM(MmaMacro macro) {
   return MmaMacroEncode(macro).m;
@@ -0,0 +1,207 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <multidevice/auto_sharding.h>
+
+#include <ir/utils.h>
+#include <root_domain_map.h>
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace nvfuser {
+
+ShardingCostModel ShardingCostModel::forBackend(CommunicatorBackend backend) {
+  ShardingCostModel cost_model;
+  switch (backend) {
+    case CommunicatorBackend::nccl:
+      cost_model.ring_bandwidth = 100e9;
+      break;
+    case CommunicatorBackend::ucc:
+      cost_model.ring_bandwidth = 50e9;
+      break;
+    case CommunicatorBackend::gloo:
+      // goes through host memory
+      cost_model.ring_bandwidth = 5e9;
+      break;
+  }
+  return cost_model;
+}
+
+namespace {
+
+// Extent assumed for the axes whose extent is not known at compile time
+constexpr double kUnknownExtent = 1024;
+
+// Returns the estimated size in bytes of the unsharded tensor
+double unshardedBytes(TensorView* tv) {
+  double bytes = (double)dataTypeSize(tv->dtype());
+  for (auto id : TensorDomain::noReductions(tv->getMaybeRFactorDomain())) {
+    if (id->isBroadcast()) {
+      continue;
+    }
+    bytes *= id->extent()->isConstInt()
+        ? (double)id->extent()->evaluate().as<int64_t>()
+        : kUnknownExtent;
+  }
+  return bytes;
+}
+
+// Returns the logical axis of tv parallelized on DIDx, if any
+IterDomain* getShardedId(TensorView* tv) {
+  auto ids = tv->getMaybeRFactorDomain();
+  auto it = std::find_if(ids.begin(), ids.end(), [](IterDomain* id) {
+    return id->getParallelType() == ParallelType::DIDx;
+  });
+  return it == ids.end() ? nullptr : *it;
+}
+
+class ShardingPlanner {
+ public:
+  ShardingPlanner(const DeviceMesh& mesh, const ShardingCostModel& cost_model)
+      : mesh_(mesh),
+        num_devices_((double)mesh.vector().size()),
+        cost_model_(cost_model) {}
+
+  // Annotates output, whose producers are the TensorView inputs of its
+  // definition
+  void plan(TensorView* output) {
+    output->setDeviceMesh(mesh_);
+    if (num_devices_ <= 1 || output->definition() == nullptr) {
+      return;
+    }
+    std::vector<TensorView*> producers =
+        ir_utils::filterByType<TensorView>(output->definition()->inputs())
+            .vector();
+
+    // Candidate shardings: replicated, or sharded on an axis mapped to a
+    // sharded axis of a producer
+    std::vector<IterDomain*> candidates = {nullptr};
+    for (auto producer : producers) {
+      IterDomain* candidate = mapShardedId(producer, output);
+      if (candidate != nullptr && !candidate->isReduction() &&
+          !candidate->isBroadcast() &&
+          std::count(
+              output->getLeafDomain().begin(),
+              output->getLeafDomain().end(),
+              candidate) > 0 &&
+          std::count(candidates.begin(), candidates.end(), candidate) == 0) {
+        candidates.push_back(candidate);
+      }
+    }
+
+    IterDomain* best = nullptr;
+    double best_cost = std::numeric_limits<double>::infinity();
+    for (IterDomain* candidate : candidates) {
+      const double cost = estimateTime(output, producers, candidate);
+      if (cost < best_cost) {
+        best_cost = cost;
+        best = candidate;
+      }
+    }
+    if (best != nullptr) {
+      best->parallelize(ParallelType::DIDx);
+    }
+  }
+
+ private:
+  // Returns the axis of consumer mapped to the sharded axis of producer, if
+  // any
+  IterDomain* mapShardedId(TensorView* producer, TensorView* consumer) const {
+    IterDomain* sharded_id = getShardedId(producer);
+    if (sharded_id == nullptr) {
+      return nullptr;
+    }
+    auto p2c =
+        PairwiseRootDomainMap(producer, consumer).mapProducerToConsumer();
+    auto it = p2c.find(sharded_id);
+    return it == p2c.end() ? nullptr : it->second;
+  }
+
+  // Returns the time to move the fraction of a tensor a device sends and
+  // receives in a ring collective
+  double ringTime(double bytes) const {
+    return bytes * (num_devices_ - 1) / num_devices_ /
+        cost_model_.ring_bandwidth;
+  }
+
+  // Returns the estimated time to compute output from its producers, if it is
+  // sharded on sharded_id, or replicated if sharded_id is nullptr
+  double estimateTime(
+      TensorView* output,
+      const std::vector<TensorView*>& producers,
+      IterDomain* sharded_id) const {
+    const double output_bytes = unshardedBytes(output);
+    double communication_time = 0;
+    double accessed_bytes = output_bytes;
+    for (auto producer : producers) {
+      const double producer_bytes = unshardedBytes(producer);
+      accessed_bytes += producer_bytes;
+      if (!producer->hasDeviceMesh() ||
+          producer->getDeviceMesh().vector() != mesh_.vector()) {
+        // The cost of moving the producer to the mesh doesn't depend on the
+        // sharding of the output
+        continue;
+      }
+      if (getShardedId(producer) == nullptr) {
+        // Scatter the producer if the output is sharded
+        communication_time +=
+            sharded_id == nullptr ? 0 : ringTime(producer_bytes);
+        continue;
+      }
+      IterDomain* mapped_id = mapShardedId(producer, output);
+      if (mapped_id != nullptr && mapped_id == sharded_id) {
+        continue;
+      }
+      if (mapped_id != nullptr && mapped_id->isReduction()) {
+        // Allreduce, or ReduceScatter if the output is sharded
+        communication_time += sharded_id == nullptr
+            ? 2 * ringTime(output_bytes)
+            : ringTime(output_bytes);
+        continue;
+      }
+      // Allgather, followed by a Scatter if the output is sharded
+      communication_time += ringTime(producer_bytes);
+      if (sharded_id != nullptr) {
+        communication_time += ringTime(producer_bytes);
+      }
+    }
+    const double compute_time = accessed_bytes /
+        (sharded_id == nullptr ? 1 : num_devices_) /
+        cost_model_.memory_bandwidth;
+    return communication_time + compute_time;
+  }
+
+  const DeviceMesh& mesh_;
+  const double num_devices_;
+  const ShardingCostModel& cost_model_;
+};
+
+} // namespace
+
+void autoShard(
+    Fusion* fusion,
+    const DeviceMesh& mesh,
+    const ShardingCostModel& cost_model) {
+  ShardingPlanner planner(mesh, cost_model);
+  for (auto tv : ir_utils::filterByType<TensorView>(fusion->inputs())) {
+    if (!tv->hasDeviceMesh()) {
+      planner.plan(tv);
+    }
+  }
+  for (auto expr : fusion->exprs()) {
+    for (auto tv : ir_utils::filterByType<TensorView>(expr->outputs())) {
+      if (!tv->hasDeviceMesh()) {
+        planner.plan(tv);
+      }
+    }
+  }
+}
+
+} // namespace nvfuser
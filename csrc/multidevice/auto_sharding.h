@@ -0,0 +1,54 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <fusion.h>
+#include <multidevice/communicator.h>
+#include <multidevice/device_mesh.h>
+#include <visibility.h>
+
+namespace nvfuser {
+
+// Estimated throughputs used to compare the shardings of a tensor
+struct ShardingCostModel {
+  // Bytes per second per device of a ring collective among the devices of
+  // the mesh
+  double ring_bandwidth = 100e9;
+  // Bytes per second read or written by a kernel on one device
+  double memory_bandwidth = 2e12;
+
+  // Returns rough numbers for intra-node communications with the backend
+  static ShardingCostModel forBackend(CommunicatorBackend backend);
+};
+
+// Chooses the sharding of the TensorViews of the fusion without a DeviceMesh,
+// given the ones of the annotated TensorViews, e.g. a few inputs. The
+// unannotated TensorViews are placed on mesh, either replicated or with one
+// of their axes parallelized on DIDx.
+//
+// The TensorViews are visited in topological order, and each one greedily
+// gets the sharding that minimizes the estimated time of its definition:
+//   *) the communications needed to reshard its producers, e.g. an Allgather
+//      if a sharded axis of a producer is not sharded in the output, or an
+//      Allreduce if it is reduced, each moving (D-1)/D of the unsharded tensor
+//      per device of a ring of D devices;
+//   *) its computation, which reads and writes the producers and the output,
+//      divided among the devices if the output is sharded, so that replicated
+//      redundant work is accounted for.
+// The candidate shardings are replicated and the axes of the output that map
+// to the sharded axes of its producers. Extents that are not known at compile
+// time are assumed to be equal.
+//
+// This pass only annotates the fusion: the resharding exprs are inserted
+// afterwards by insertReshardings, e.g. by the MultiDeviceExecutor.
+NVF_API void autoShard(
+    Fusion* fusion,
+    const DeviceMesh& mesh,
+    const ShardingCostModel& cost_model = ShardingCostModel());
+
+} // namespace nvfuser
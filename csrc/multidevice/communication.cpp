@@ -452,4 +452,54 @@ c10::intrusive_ptr<c10d::Work> postSingleCommunication(
   }
 }
 
+void postCoalescedCommunication(
+    Communication* communication,
+    DeviceIdxType my_device_index,
+    c10::intrusive_ptr<c10d::Backend> backend,
+    const std::vector<at::Tensor>& input_tensors,
+    const std::vector<at::Tensor>& output_tensors) {
+  const CommParams& params = communication->params();
+  NVF_ERROR(
+      params.type == CommunicationType::Allgather ||
+          params.type == CommunicationType::Allreduce,
+      "Only Allgather and Allreduce communications can be coalesced, but got ",
+      params.type);
+  NVF_ERROR(input_tensors.size() == output_tensors.size());
+
+  std::vector<at::Tensor> flattened_inputs;
+  flattened_inputs.reserve(input_tensors.size());
+  for (const auto& input_tensor : input_tensors) {
+    flattened_inputs.push_back(input_tensor.reshape({-1}));
+  }
+  at::Tensor input_buffer = at::cat(flattened_inputs);
+
+  // Each output is a slice of the buffer along its last axis
+  const auto team_size = static_cast<int64_t>(params.team.size());
+  at::Tensor output_buffer;
+  if (params.type == CommunicationType::Allgather) {
+    output_buffer =
+        at::empty({team_size, input_buffer.numel()}, input_buffer.options());
+    postSingleCommunication(
+        communication,
+        my_device_index,
+        backend,
+        input_buffer.unsqueeze(0),
+        output_buffer)
+        ->wait();
+  } else {
+    std::vector<at::Tensor> tensors({input_buffer});
+    backend->allreduce(tensors, {.reduceOp = params.redOp})->wait();
+    output_buffer = input_buffer.unsqueeze(0);
+  }
+
+  int64_t offset = 0;
+  for (auto i : c10::irange(input_tensors.size())) {
+    const int64_t numel = input_tensors.at(i).numel();
+    const at::Tensor& output_tensor = output_tensors.at(i);
+    output_tensor.view({output_buffer.size(0), numel})
+        .copy_(output_buffer.slice(1, offset, offset + numel), true);
+    offset += numel;
+  }
+}
+
 } // namespace nvfuser
@@ -161,4 +161,16 @@ c10::intrusive_ptr<c10d::Work> postSingleCommunication(
     at::Tensor input_tensor,
     at::Tensor output_tensor);
 
+// Executes an Allgather or Allreduce communication on several pairs of input
+// and output tensors at once, by communicating the concatenation of the
+// flattened inputs and copying the result into the outputs, so that many
+// small communications pay for the latency of a single collective. The work
+// following on the stream waits for the communication, but the host doesn't.
+void postCoalescedCommunication(
+    Communication* communication,
+    DeviceIdxType my_device_index,
+    c10::intrusive_ptr<c10d::Backend> backend,
+    const std::vector<at::Tensor>& input_tensors,
+    const std::vector<at::Tensor>& output_tensors);
+
 } // namespace nvfuser
@@ -9,6 +9,7 @@
 
 #include <netdb.h>
 #include <map>
+#include <unordered_set>
 
 #ifdef NVFUSER_DISTRIBUTED
 #include <torch/csrc/distributed/c10d/PrefixStore.hpp>
@@ -244,6 +245,19 @@ c10::intrusive_ptr<c10d::Backend> Communicator::getBackendForTeam(
   return backends_.at(team_key);
 }
 
+void Communicator::warmupBackendsForTeams(
+    const std::vector<Team>& teams,
+    std::optional<CommunicatorBackend> backend) {
+  std::unordered_set<std::string> warm_teams;
+  for (const Team& team : teams) {
+    if (std::find(team.begin(), team.end(), deviceId()) == team.end() ||
+        !warm_teams.insert(getTeamKey(team, getBackend(backend))).second) {
+      continue;
+    }
+    getBackendForTeam(team, backend)->barrier()->wait();
+  }
+}
+
 c10::intrusive_ptr<c10d::Backend> Communicator::getWorld(
     std::optional<CommunicatorBackend> backend) {
   std::vector<RankType> all_ranks(size_);
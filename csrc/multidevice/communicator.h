@@ -90,6 +90,14 @@ class Communicator {
       const Team& team,
       std::optional<CommunicatorBackend> backend);
 
+  // creates the backends of the given teams the current device belongs to,
+  // and runs a barrier on each of them so that their lazily initialized
+  // communicators, e.g. NCCL's, are set up. This is collective: all the
+  // devices of the teams must call it with the teams in the same order.
+  void warmupBackendsForTeams(
+      const std::vector<Team>& teams,
+      std::optional<CommunicatorBackend> backend = std::nullopt);
+
   // returns the device associated with the current process
   auto device() const {
     return at::Device("cuda:" + std::to_string(local_rank_));
@@ -112,6 +120,11 @@ class Communicator {
   c10::intrusive_ptr<c10d::Backend> getWorld(
       std::optional<CommunicatorBackend> backend = std::nullopt);
 
+  // returns the store shared by all the processes, e.g. to exchange handles
+  c10d::TCPStore* getTcpStore() {
+    return store_.get();
+  }
+
   // returns if a backend is available for creation
   bool isBackendAvailable(CommunicatorBackend backend) const {
     if (backend == CommunicatorBackend::ucc) {
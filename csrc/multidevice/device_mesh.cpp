@@ -8,6 +8,8 @@
 
 #include <multidevice/device_mesh.h>
 
+#include <algorithm>
+#include <iterator>
 #include <numeric>
 
 namespace nvfuser {
@@ -19,6 +21,33 @@ namespace nvfuser {
   return DeviceMesh(devices);
 }
 
+std::vector<DeviceIdxType> DeviceMesh::orderedByNode(
+    int64_t devices_per_node) const {
+  NVF_ERROR(
+      devices_per_node > 0,
+      "devices_per_node must be positive, got ",
+      devices_per_node);
+  std::vector<int64_t> nodes;
+  for (auto device : vector_) {
+    int64_t node = device / devices_per_node;
+    if (std::find(nodes.begin(), nodes.end(), node) == nodes.end()) {
+      nodes.push_back(node);
+    }
+  }
+  std::vector<DeviceIdxType> ordered;
+  ordered.reserve(vector_.size());
+  for (auto node : nodes) {
+    std::copy_if(
+        vector_.begin(),
+        vector_.end(),
+        std::back_inserter(ordered),
+        [&](DeviceIdxType device) {
+          return device / devices_per_node == node;
+        });
+  }
+  return ordered;
+}
+
 std::string DeviceMesh::toString() const {
   std::stringstream ss;
   ss << "DeviceMesh{";
@@ -44,6 +44,13 @@ class DeviceMesh final {
     return std::find(vector_.begin(), vector_.end(), device) != vector_.end();
   }
 
+  // Returns the devices of the mesh grouped by node, assuming that nodes
+  // hold devices_per_node consecutive device indices. Nodes come in the
+  // order of their first device in the mesh, and devices keep their mesh
+  // order within a node. Consecutive devices are then connected by NVLink,
+  // except at the boundaries between nodes, which go over the network.
+  std::vector<DeviceIdxType> orderedByNode(int64_t devices_per_node) const;
+
   bool operator==(const DeviceMesh& other) const {
     return vector_ == other.vector();
   }
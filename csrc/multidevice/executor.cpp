@@ -6,6 +6,7 @@
  */
 // clang-format on
 #include <ATen/cuda/CUDAContext.h>
+#include <compute_at_map.h>
 #include <device_lower/utils.h>
 #include <fusion_segmenter.h>
 #include <ir/utils.h>
@@ -43,6 +44,99 @@ std::unique_ptr<Fusion> copyFusionAndChangeOutputs(
   return fusion_copy;
 }
 
+// returns the only compute group consuming the output of the Allgather group
+// allgather, if it can be run separately on each gathered shard and its
+// outputs concatenated along their outermost axis, or nullptr otherwise
+SegmentedGroup* getRingAllgatherConsumer(
+    SegmentedFusion* staged_fusion,
+    SegmentedGroup* allgather,
+    const ComputeAtMap& ca_map) {
+  auto gathered_tv = allgather->exprs().at(0)->output(0)->as<TensorView>();
+  if (gathered_tv->isFusionOutput()) {
+    return nullptr;
+  }
+  std::vector<SegmentedGroup*> consumers;
+  for (auto group : staged_fusion->groups()) {
+    const auto& inputs = group->inputs();
+    if (std::find(inputs.begin(), inputs.end(), gathered_tv) != inputs.end()) {
+      consumers.push_back(group);
+    }
+  }
+  if (consumers.size() != 1) {
+    return nullptr;
+  }
+  SegmentedGroup* consumer = consumers.at(0);
+
+  IterDomain* gathered_id =
+      TensorDomain::noReductions(gathered_tv->getMaybeRFactorDomain()).at(0);
+  auto is_gathered = [&](IterDomain* id) {
+    return ca_map.areMapped(id, gathered_id, IdMappingMode::EXACT);
+  };
+  // The other inputs are used entirely by each shard
+  for (auto input : consumer->inputs()) {
+    auto tv = dynamic_cast<TensorView*>(input);
+    if (tv == nullptr) {
+      return nullptr;
+    }
+    if (tv != gathered_tv &&
+        std::any_of(
+            tv->getMaybeRFactorDomain().begin(),
+            tv->getMaybeRFactorDomain().end(),
+            is_gathered)) {
+      return nullptr;
+    }
+  }
+  // The gathered axis is neither reduced nor reshaped
+  for (auto expr : consumer->exprs()) {
+    for (auto tv : ir_utils::filterByType<TensorView>(expr->outputs())) {
+      if (tv->hasRFactor() ||
+          std::any_of(
+              tv->getRootDomain().begin(),
+              tv->getRootDomain().end(),
+              [&](IterDomain* id) {
+                return id->isReduction() && is_gathered(id);
+              })) {
+        return nullptr;
+      }
+    }
+  }
+  // The outputs are computed on the same devices, and their outermost axis is
+  // the gathered one
+  for (auto output : consumer->outputs()) {
+    auto tv = dynamic_cast<TensorView*>(output);
+    if (tv == nullptr || !tv->hasDeviceMesh() ||
+        tv->getDeviceMesh().vector() != gathered_tv->getDeviceMesh().vector()) {
+      return nullptr;
+    }
+    auto domain = TensorDomain::noReductions(tv->getMaybeRFactorDomain());
+    if (domain.empty() || !is_gathered(domain.at(0))) {
+      return nullptr;
+    }
+  }
+  return consumer;
+}
+
+// returns whether the communications of the given resharding exprs can be
+// coalesced into a single collective
+bool areCoalescable(Expr* expr, Expr* other) {
+  auto is_coalescable = [](Expr* e) {
+    return isLowerableToAllgather(e) || isLowerableToAllreduce(e);
+  };
+  if (!is_coalescable(expr) || !is_coalescable(other) ||
+      expr->isA<ReductionOp>() != other->isA<ReductionOp>()) {
+    return false;
+  }
+  if (expr->isA<ReductionOp>() &&
+      expr->as<ReductionOp>()->getReductionOpType() !=
+          other->as<ReductionOp>()->getReductionOpType()) {
+    return false;
+  }
+  auto tv = expr->output(0)->as<TensorView>();
+  auto other_tv = other->output(0)->as<TensorView>();
+  return tv->dtype() == other_tv->dtype() &&
+      tv->getDeviceMesh().vector() == other_tv->getDeviceMesh().vector();
+}
+
 } // namespace
 
 MultiDeviceExecutor::MultiDeviceExecutor(
@@ -78,12 +172,96 @@ MultiDeviceExecutor::MultiDeviceExecutor(
   // prepare the order in which to launch the kernels/comms
   prepareRuntimeOrder(staged_fusion_.get(), workspace);
 
+  if (params_.decompose_allgather) {
+    ComputeAtMap ca_map(completeFusion());
+    for (auto group : staged_fusion_->groups()) {
+      if (!is_resharding_.at(group) ||
+          !isLowerableToAllgather(group->exprs().at(0))) {
+        continue;
+      }
+      SegmentedGroup* consumer =
+          getRingAllgatherConsumer(staged_fusion_.get(), group, ca_map);
+      if (consumer != nullptr && !is_resharding_.at(consumer) &&
+          ring_allgathers_.count(consumer) == 0) {
+        ring_allgathers_[consumer] = group;
+        decomposed_allgathers_.insert(group);
+      }
+    }
+  }
+
+  if (params_.use_peer_memory && isPeerMemoryAvailable(comm_)) {
+    for (auto group : staged_fusion_->groups()) {
+      if (is_resharding_.at(group) && !decomposed_allgathers_.count(group) &&
+          isLowerableToAllgather(group->exprs().at(0)) &&
+          !group->exprs().at(0)->output(0)->isFusionOutput()) {
+        peer_allgathers_[group] = nullptr;
+      }
+    }
+  }
+
+  if (params_.coalesce_communications) {
+    // A communication is coalesced into the bucket of an earlier one if its
+    // input is computed before the latter is posted
+    const auto& run_order = workspace.group_run_order;
+    std::unordered_map<Val*, int64_t> producer_position;
+    for (auto position : c10::irange((int64_t)run_order.size())) {
+      for (auto output : run_order.at(position)->outputs()) {
+        producer_position[output] = position;
+      }
+    }
+    auto is_coalescable = [&](SegmentedGroup* group) {
+      return is_resharding_.at(group) && !decomposed_allgathers_.count(group) &&
+          !peer_allgathers_.count(group) && !coalesced_groups_.count(group);
+    };
+    for (auto position : c10::irange((int64_t)run_order.size())) {
+      SegmentedGroup* group = run_order.at(position);
+      if (!is_coalescable(group)) {
+        continue;
+      }
+      std::vector<SegmentedGroup*> bucket = {group};
+      for (auto other_position :
+           c10::irange(position + 1, (int64_t)run_order.size())) {
+        SegmentedGroup* other = run_order.at(other_position);
+        if (!is_coalescable(other) ||
+            !areCoalescable(group->exprs().at(0), other->exprs().at(0))) {
+          continue;
+        }
+        auto it = producer_position.find(other->exprs().at(0)->input(0));
+        if (it == producer_position.end() || it->second < position) {
+          bucket.push_back(other);
+        }
+      }
+      if (bucket.size() > 1) {
+        coalesced_groups_.insert(bucket.begin() + 1, bucket.end());
+        coalesced_communications_[group] = std::move(bucket);
+      }
+    }
+  }
+
+  if (params_.warmup_backends) {
+    // All devices lower the same fusion, so they warm up the teams in the
+    // same order
+    std::vector<Team> teams;
+    for (SegmentedGroup* group : workspace.group_run_order) {
+      if (!is_resharding_.at(group) || !should_run_.at(group) ||
+          peer_allgathers_.count(group)) {
+        continue;
+      }
+      for (Communication* communication :
+           lowerCommunication(comm_.deviceId(), group->exprs().at(0))) {
+        teams.push_back(communication->params().team);
+      }
+    }
+    comm_.warmupBackendsForTeams(teams);
+  }
+
   // Allocator setup
   // vals_to_allocate_ stores the tensors that need to be allocated at runtime,
   // which correspond to the destination buffers of interdevice communications.
   // TODO: reuse allocated buffers and support inplace collectives
   for (SegmentedGroup* group : staged_fusion_->groups()) {
-    if (is_resharding_[group]) {
+    // The buffers of peer Allgathers are allocated with their IPC handles
+    if (is_resharding_[group] && !peer_allgathers_.count(group)) {
       NVF_ERROR(group->exprs().size() == 1);
       NVF_ERROR(group->exprs().at(0)->outputs().size() == 1);
       auto val = group->exprs().at(0)->outputs().at(0);
@@ -99,15 +277,11 @@ MultiDeviceExecutor::MultiDeviceExecutor(
       copyFusionAndChangeOutputs(completeFusion(), vals_to_allocate_);
 }
 
-void MultiDeviceExecutor::postKernel(
-    SegmentedGroup* group,
-    const LaunchParams& launch_params) {
-  if (!should_run_.at(group)) {
-    return;
-  }
-  // get the IValues corresponding to the group's input
+std::vector<c10::IValue> MultiDeviceExecutor::getGroupInputs(
+    SegmentedGroup* group) {
   std::vector<c10::IValue> group_input_IValues;
   for (auto& input : group->inputs()) {
+    waitFor(input);
     NVF_ERROR(
         val_to_IValue_.find(input) != val_to_IValue_.end(),
         "Device ",
@@ -119,28 +293,41 @@ void MultiDeviceExecutor::postKernel(
     NVF_ERROR(val_to_IValue_.at(input).isTensor());
     group_input_IValues.push_back(val_to_IValue_.at(input));
   }
+  return group_input_IValues;
+}
 
-  // placeholder for storing the group's outputs
-  std::vector<at::Tensor> outputs;
-
+std::vector<at::Tensor> MultiDeviceExecutor::runKernel(
+    SegmentedGroup* group,
+    const std::vector<c10::IValue>& inputs,
+    const LaunchParams& launch_params) {
   // Compile the group and execute it with FusionExecutor
   // Check if the executor has been cached. If not, create and cache it
   if (params_.use_fusion_executor_cache) {
     auto fusion = staged_fusion_->makeFusion(group).second;
     fec_.try_emplace(
         group, std::move(fusion), 0, !params_.skip_auto_scheduling);
-    outputs = fec_.at(group).runFusionWithInputs(group_input_IValues);
-  } else {
-    auto [it, has_emplaced] = fe_.try_emplace(group);
-    auto& fe = it->second;
-    if (has_emplaced) {
-      auto fusion = staged_fusion_->makeFusion(group).second;
-      fe.compileFusion(fusion.get(), group_input_IValues, launch_params);
-    }
-    outputs = fe.runFusion(group_input_IValues, launch_params);
-    if (!params_.cache_fusion_executor) {
-      fe_.erase(group);
-    }
+    return fec_.at(group).runFusionWithInputs(inputs);
+  }
+  auto [it, has_emplaced] = fe_.try_emplace(group);
+  auto& fe = it->second;
+  if (has_emplaced) {
+    auto fusion = staged_fusion_->makeFusion(group).second;
+    fe.compileFusion(fusion.get(), inputs, launch_params);
+  }
+  return fe.runFusion(inputs, launch_params);
+}
+
+void MultiDeviceExecutor::postKernel(
+    SegmentedGroup* group,
+    const LaunchParams& launch_params) {
+  if (!should_run_.at(group)) {
+    return;
+  }
+  std::vector<c10::IValue> group_input_IValues = getGroupInputs(group);
+  std::vector<at::Tensor> outputs =
+      runKernel(group, group_input_IValues, launch_params);
+  if (!params_.use_fusion_executor_cache && !params_.cache_fusion_executor) {
+    fe_.erase(group);
   }
 
   // Store the outputs in the context
@@ -149,6 +336,98 @@ void MultiDeviceExecutor::postKernel(
   }
 }
 
+void MultiDeviceExecutor::postRingAllgatherKernel(
+    SegmentedGroup* allgather,
+    SegmentedGroup* consumer,
+    const LaunchParams& launch_params) {
+  auto expr = allgather->exprs().at(0);
+  auto input_val = expr->inputs().at(0);
+  auto output_val = expr->outputs().at(0);
+  const DeviceMesh& mesh = output_val->as<TensorView>()->getDeviceMesh();
+  if (!mesh.has(comm_.deviceId())) {
+    return;
+  }
+  const Team& team = mesh.vector();
+  const auto num_shards = static_cast<int64_t>(team.size());
+  auto team_idx = [&team](DeviceIdxType device) {
+    return static_cast<int64_t>(
+        std::find(team.begin(), team.end(), device) - team.begin());
+  };
+  const int64_t my_idx = team_idx(comm_.deviceId());
+  // The ring visits the devices of a node before moving to the next node, so
+  // that only one hop per node goes over the network
+  const std::vector<DeviceIdxType> ring =
+      mesh.orderedByNode(comm_.local_size());
+  const auto my_ring_idx = static_cast<int64_t>(
+      std::find(ring.begin(), ring.end(), comm_.deviceId()) - ring.begin());
+  auto ring_shard = [&](int64_t ring_offset) {
+    return team_idx(ring.at((my_ring_idx + ring_offset) % num_shards));
+  };
+
+  // The gathered buffer is allocated as the destination of the Allgather.
+  // This device's shard is copied into it, and the others are received in
+  // place from the previous device of the ring.
+  waitFor(input_val);
+  at::Tensor input_tensor = val_to_IValue_.at(input_val).toTensor();
+  at::Tensor output_tensor = val_to_IValue_.at(output_val).toTensor();
+  auto shard = [&](int64_t shard_idx) {
+    return output_tensor.slice(0, shard_idx, shard_idx + 1);
+  };
+  shard(my_idx).copy_(input_tensor.view_as(shard(my_idx)), true);
+
+  std::vector<c10::IValue> group_input_IValues = getGroupInputs(consumer);
+  const auto& consumer_inputs = consumer->inputs();
+  const auto gathered_pos = std::distance(
+      consumer_inputs.begin(),
+      std::find(consumer_inputs.begin(), consumer_inputs.end(), output_val));
+
+  // Shards are sent with team-relative ranks on the backend of the whole team
+  c10::intrusive_ptr<c10d::Backend> backend =
+      comm_.getBackendForTeam(team, std::nullopt);
+  const auto next_rank = static_cast<int>(ring_shard(1));
+  const auto prev_rank = static_cast<int>(ring_shard(num_shards - 1));
+  std::vector<std::vector<at::Tensor>> shard_outputs(num_shards);
+  for (auto step : c10::irange(num_shards)) {
+    // At each step, a device computes on the shard it received at the previous
+    // step, while passing it on to the next device of the ring
+    const int64_t shard_idx = ring_shard(num_shards - step);
+    std::vector<c10::intrusive_ptr<c10d::Work>> works;
+    if (step + 1 < num_shards) {
+      const int64_t recv_idx = ring_shard(num_shards - step - 1);
+      std::vector<at::Tensor> send_tensors = {shard(shard_idx)};
+      std::vector<at::Tensor> recv_tensors = {shard(recv_idx)};
+      // Neighboring devices post in opposite orders, so that they are not
+      // both blocked sending to each other, e.g. with two devices
+      if (my_ring_idx % 2 == 0) {
+        works.push_back(backend->send(send_tensors, next_rank, /*tag=*/0));
+        works.push_back(backend->recv(recv_tensors, prev_rank, /*tag=*/0));
+      } else {
+        works.push_back(backend->recv(recv_tensors, prev_rank, /*tag=*/0));
+        works.push_back(backend->send(send_tensors, next_rank, /*tag=*/0));
+      }
+    }
+    group_input_IValues.at(gathered_pos) = shard(shard_idx);
+    shard_outputs.at(shard_idx) =
+        runKernel(consumer, group_input_IValues, launch_params);
+    for (const auto& work : works) {
+      work->wait();
+    }
+  }
+  if (!params_.use_fusion_executor_cache && !params_.cache_fusion_executor) {
+    fe_.erase(consumer);
+  }
+
+  // Store the concatenated outputs in the context
+  for (auto output_idx : c10::irange(consumer->outputs().size())) {
+    std::vector<at::Tensor> chunks;
+    chunks.reserve(num_shards);
+    for (const auto& outputs : shard_outputs) {
+      chunks.push_back(outputs.at(output_idx));
+    }
+    val_to_IValue_[consumer->outputs().at(output_idx)] = at::cat(chunks, 0);
+  }
+}
+
 void MultiDeviceExecutor::postCommunication(SegmentedGroup* group) {
   // Lower the group into a vector of Communications
   NVF_ERROR(
@@ -166,6 +445,7 @@ void MultiDeviceExecutor::postCommunication(SegmentedGroup* group) {
   // Compute input_tensor and output_tensor.
   auto input_val = expr->inputs().at(0);
   auto output_val = expr->outputs().at(0);
+  waitFor(input_val);
   at::Tensor input_tensor;
   if (val_to_IValue_.find(input_val) != val_to_IValue_.end()) {
     input_tensor = val_to_IValue_.at(input_val).toTensor();
@@ -175,16 +455,88 @@ void MultiDeviceExecutor::postCommunication(SegmentedGroup* group) {
     output_tensor = val_to_IValue_.at(output_val).toTensor();
   }
 
-  // post and wait communications
+  // post communications, which are waited for by the consumers of their
+  // output
   for (Communication* communication : communications) {
     c10::intrusive_ptr<c10d::Backend> backend =
         comm_.getBackendForTeam(communication->params().team, std::nullopt);
     c10::intrusive_ptr<c10d::Work> work = postSingleCommunication(
         communication, comm_.deviceId(), backend, input_tensor, output_tensor);
     if (work != nullptr) {
-      work->wait();
+      pending_works_[output_val].push_back(std::move(work));
     }
   }
+  if (!params_.overlap_communications) {
+    waitFor(output_val);
+  }
+}
+
+void MultiDeviceExecutor::postCoalescedCommunications(
+    const std::vector<SegmentedGroup*>& groups) {
+  // All the communications have the same team, so this device either takes
+  // part in all of them or in none
+  auto communications =
+      lowerCommunication(comm_.deviceId(), groups.at(0)->exprs().at(0));
+  if (communications.empty()) {
+    return;
+  }
+  NVF_ERROR(communications.size() == 1);
+  Communication* communication = communications.at(0);
+
+  std::vector<at::Tensor> input_tensors;
+  std::vector<at::Tensor> output_tensors;
+  for (auto group : groups) {
+    auto expr = group->exprs().at(0);
+    waitFor(expr->input(0));
+    input_tensors.push_back(val_to_IValue_.at(expr->input(0)).toTensor());
+    output_tensors.push_back(val_to_IValue_.at(expr->output(0)).toTensor());
+  }
+
+  c10::intrusive_ptr<c10d::Backend> backend =
+      comm_.getBackendForTeam(communication->params().team, std::nullopt);
+  postCoalescedCommunication(
+      communication, comm_.deviceId(), backend, input_tensors, output_tensors);
+}
+
+void MultiDeviceExecutor::postPeerAllgather(SegmentedGroup* group) {
+  auto expr = group->exprs().at(0);
+  auto input_val = expr->inputs().at(0);
+  auto output_val = expr->outputs().at(0);
+  const Team& team = output_val->as<TensorView>()->getDeviceMesh().vector();
+  if (std::find(team.begin(), team.end(), comm_.deviceId()) == team.end()) {
+    return;
+  }
+  waitFor(input_val);
+  at::Tensor input_tensor = val_to_IValue_.at(input_val).toTensor();
+
+  // The gathered tensor stacks the shards along the outermost axis. Its
+  // buffers are reallocated, collectively, only if the shards change.
+  std::vector<int64_t> sizes = input_tensor.sizes().vec();
+  sizes.at(0) *= static_cast<int64_t>(team.size());
+  std::unique_ptr<PeerMemoryAllgather>& allgather = peer_allgathers_.at(group);
+  if (allgather == nullptr || allgather->output().sizes() != sizes ||
+      allgather->output().scalar_type() != input_tensor.scalar_type()) {
+    allgather.reset();
+    allgather = std::make_unique<PeerMemoryAllgather>(
+        comm_, team, sizes, input_tensor.options());
+  }
+  // The copies and semaphores are posted on the stream, so there is nothing to
+  // wait for
+  allgather->post(input_tensor);
+  val_to_IValue_[output_val] = allgather->output();
+}
+
+void MultiDeviceExecutor::waitFor(Val* val) {
+  auto it = pending_works_.find(val);
+  if (it == pending_works_.end()) {
+    return;
+  }
+  // For NCCL, this makes the current stream wait for the communication
+  // without blocking the host
+  for (const auto& work : it->second) {
+    work->wait();
+  }
+  pending_works_.erase(it);
 }
 
 std::vector<at::Tensor> MultiDeviceExecutor::runWithInput(
@@ -215,13 +567,31 @@ std::vector<at::Tensor> MultiDeviceExecutor::runWithInput(
 
   // Run through the groups to launch kernels and comms
   for (auto group : workspace.group_run_order) {
-    if (!is_resharding_.at(group)) {
+    if (decomposed_allgathers_.count(group) || coalesced_groups_.count(group)) {
+      // posted with its consumer, resp. the first group of its bucket
+      continue;
+    }
+    if (auto it = ring_allgathers_.find(group); it != ring_allgathers_.end()) {
+      postRingAllgatherKernel(it->second, group, launch_params);
+    } else if (!is_resharding_.at(group)) {
       postKernel(group, launch_params);
+    } else if (peer_allgathers_.count(group)) {
+      postPeerAllgather(group);
+    } else if (auto bucket_it = coalesced_communications_.find(group);
+               bucket_it != coalesced_communications_.end()) {
+      postCoalescedCommunications(bucket_it->second);
     } else {
       postCommunication(group);
     }
   }
 
+  // Wait for the communications whose outputs are not used by this device,
+  // e.g. sends, so that the work issued after the execution is ordered after
+  // all of them as before
+  while (!pending_works_.empty()) {
+    waitFor(pending_works_.begin()->first);
+  }
+
   // Collect global outputs from context
   std::vector<at::Tensor> outputs;
   for (auto output_val : staged_fusion_->outputs()) {
@@ -14,6 +14,7 @@
 #include <multidevice/communication.h>
 #include <multidevice/communicator.h>
 #include <multidevice/multidevice.h>
+#include <multidevice/peer_memory.h>
 
 namespace nvfuser {
 
@@ -56,7 +57,12 @@ namespace nvfuser {
        on a single device, see postKernel
     2) each comm segment is lowered into a series of communications (defined in
        multidevice/communications.h) and are posted on the stream.
-       "Wait" primitives are also posted on the stream.
+       "Wait" primitives are posted on the stream before the first use of
+       the communicated tensor, so that independent segments overlap with
+       the communication, see MultiDeviceExecutorParams.
+    3) optionally, an Allgather and the compute segment consuming it are
+       decomposed into a ring of send/recv and a kernel per gathered shard,
+       see postRingAllgatherKernel.
 
   TODOS:
   *) the MultiDeviceExecutor should be integrated into FusionExecutorCache.
@@ -79,6 +85,32 @@ struct MultiDeviceExecutorParams {
   // Experimental: whether to cache fusion executor. WAR: avoid recompilation
   // but implicitely assumes that the input shape don't change over iterations
   bool cache_fusion_executor = false;
+  // Whether to wait for a communication only before its output is used, so
+  // that the kernels and communications that don't depend on it overlap with
+  // it. Otherwise, each communication is waited for right after it is posted.
+  bool overlap_communications = true;
+  // Experimental: whether to decompose an Allgather whose output is only used
+  // by one compute segment, which can be run independently on each gathered
+  // shard, e.g. an allgather-matmul. The segment is then run on each shard as
+  // soon as it is received, while the next shard is exchanged through a ring
+  // of send/recv, so that the communication overlaps with the compute. See
+  // postRingAllgatherKernel.
+  bool decompose_allgather = false;
+  // Experimental: whether to lower the Allgathers among devices of the same
+  // node to copies straight into the peers' buffers through CUDA IPC,
+  // synchronized on the streams, rather than to the c10d backend's
+  // collective. See PeerMemoryAllgather.
+  bool use_peer_memory = false;
+  // Experimental: whether to coalesce the Allgathers, resp. Allreduces, of
+  // tensors of the same data type on the same mesh into a single collective
+  // on their flattened concatenation, posted as soon as all their inputs are
+  // computed.
+  bool coalesce_communications = false;
+  // Whether to create, at instantiation, the backends of all the teams this
+  // device communicates with, rather than on their first use, which would
+  // otherwise stall the first run. Backends are cached by the Communicator,
+  // so they are shared by all the executors using it.
+  bool warmup_backends = false;
 };
 
 class MultiDeviceExecutor {
@@ -117,9 +149,36 @@ class MultiDeviceExecutor {
   void postKernel(SegmentedGroup* group, const LaunchParams& launch_params);
   // execute a SegmentedGroup representing inter-device communication
   void postCommunication(SegmentedGroup* group);
+  // execute the compute SegmentedGroup consumer on each shard gathered by the
+  // Allgather SegmentedGroup allgather, while the shards are passed along a
+  // ring of devices. The outputs are the concatenation of the outputs of each
+  // shard along their outermost axis.
+  void postRingAllgatherKernel(
+      SegmentedGroup* allgather,
+      SegmentedGroup* consumer,
+      const LaunchParams& launch_params);
+  // get the IValues corresponding to the group's inputs, waiting for the
+  // communications computing them
+  std::vector<c10::IValue> getGroupInputs(SegmentedGroup* group);
+  // compile, if needed, and run a compute SegmentedGroup on the given inputs
+  std::vector<at::Tensor> runKernel(
+      SegmentedGroup* group,
+      const std::vector<c10::IValue>& inputs,
+      const LaunchParams& launch_params);
+  // execute several compatible communication SegmentedGroups as a single
+  // collective
+  void postCoalescedCommunications(const std::vector<SegmentedGroup*>& groups);
+  // execute an Allgather SegmentedGroup through the peers' memory
+  void postPeerAllgather(SegmentedGroup* group);
+  // wait for the communications posted to compute val, if any
+  void waitFor(Val* val);
 
   // Stores concrete computed values,
   std::unordered_map<Val*, c10::IValue> val_to_IValue_;
+  // Communications that have been posted but not waited for yet, by the Val
+  // they compute
+  std::unordered_map<Val*, std::vector<c10::intrusive_ptr<c10d::Work>>>
+      pending_works_;
 
   // holds the Communicator to be used for execution
   Communicator& comm_;
@@ -137,6 +196,20 @@ class MultiDeviceExecutor {
   std::unordered_map<SegmentedGroup*, bool> should_run_;
   // Cache whether a SegmentedGroup requires inter-device communication
   std::unordered_map<SegmentedGroup*, bool> is_resharding_;
+  // Maps the compute SegmentedGroups run by postRingAllgatherKernel to the
+  // Allgather SegmentedGroup they consume, which is then not posted by itself
+  std::unordered_map<SegmentedGroup*, SegmentedGroup*> ring_allgathers_;
+  std::unordered_set<SegmentedGroup*> decomposed_allgathers_;
+  // Maps the first communication SegmentedGroup of each bucket of coalesced
+  // communications, in runtime order, to the whole bucket. The other groups of
+  // the buckets are not posted by themselves.
+  std::unordered_map<SegmentedGroup*, std::vector<SegmentedGroup*>>
+      coalesced_communications_;
+  std::unordered_set<SegmentedGroup*> coalesced_groups_;
+  // The Allgather SegmentedGroups executed through the peers' memory, with
+  // their buffers once allocated, which are reused across runs
+  std::unordered_map<SegmentedGroup*, std::unique_ptr<PeerMemoryAllgather>>
+      peer_allgathers_;
   // Cached objects used for MultiDevice allocation
   std::unique_ptr<Fusion> allocator_fusion_;
   // Cache the tensors that need to be allocated at runtime, which correspond to
@@ -367,6 +367,32 @@ std::vector<Communication*> lowerCommunication(
   return comms;
 }
 
+bool isLowerableToAllgather(Expr* expr) {
+  if (!isLowerableToCommunication(expr) || expr->isA<ReductionOp>() ||
+      isInnerResharding(expr)) {
+    return false;
+  }
+  auto input_tv = expr->inputs().at(0)->as<TensorView>();
+  auto output_tv = expr->outputs().at(0)->as<TensorView>();
+  const DeviceMesh& mesh = input_tv->getDeviceMesh();
+  return mesh.vector().size() > 1 && isSharded(input_tv) &&
+      !isSharded(output_tv) &&
+      mesh.vector() == output_tv->getDeviceMesh().vector();
+}
+
+bool isLowerableToAllreduce(Expr* expr) {
+  if (!expr->isA<ReductionOp>() || !isLowerableToCommunication(expr) ||
+      isInnerResharding(expr)) {
+    return false;
+  }
+  auto input_tv = expr->inputs().at(0)->as<TensorView>();
+  auto output_tv = expr->outputs().at(0)->as<TensorView>();
+  const DeviceMesh& mesh = input_tv->getDeviceMesh();
+  return mesh.vector().size() > 1 && isSharded(input_tv) &&
+      !isSharded(output_tv) &&
+      mesh.vector() == output_tv->getDeviceMesh().vector();
+}
+
 bool isLowerableToCommunication(Expr* expr) {
   NVF_ERROR(
       ir_utils::isTvOp(expr),
@@ -17,6 +17,14 @@ namespace nvfuser {
 // of communication.
 bool isLowerableToCommunication(Expr* expr);
 
+// Returns whether expr is lowered to an Allgather, i.e. gathers the shards of
+// a tensor sharded on its outermost axis to all the devices of its mesh.
+bool isLowerableToAllgather(Expr* expr);
+
+// Returns whether expr is lowered to an Allreduce, i.e. reduces a tensor
+// sharded on the reduced axis on all the devices of its mesh.
+bool isLowerableToAllreduce(Expr* expr);
+
 // Lower a PipelineCommunication into a series of Communication, given a
 // device_index.
 std::vector<Communication*> lowerCommunication(
@@ -0,0 +1,225 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <multidevice/peer_memory.h>
+
+#include <ATen/cuda/CUDAContext.h>
+#include <c10/cuda/CUDAGuard.h>
+
+#include <cuda_utils.h>
+#include <utils.h>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <string>
+
+namespace nvfuser {
+
+#if defined(NVFUSER_DISTRIBUTED) && (CUDA_VERSION >= 12000)
+
+namespace {
+
+// The semaphores are stored after the data, at an address aligned for them
+constexpr int64_t kSemaphoreAlignment = 256;
+
+// Counts the PeerMemoryAllgathers created by this process, so that all the
+// devices of a team use the same store keys for the same Allgather
+int64_t next_peer_memory_id = 0;
+
+std::string getHandleKey(int64_t id, int64_t team_idx) {
+  return "nvfuser_peer_memory_" + std::to_string(id) + "_" +
+      std::to_string(team_idx);
+}
+
+} // namespace
+
+bool isPeerMemoryAvailable(const Communicator& comm) {
+  return comm.is_available() && comm.size() == comm.local_size();
+}
+
+PeerMemoryAllgather::PeerMemoryAllgather(
+    Communicator& comm,
+    Team team,
+    std::vector<int64_t> sizes,
+    at::TensorOptions options)
+    : team_(std::move(team)),
+      my_idx_(std::distance(
+          team_.begin(),
+          std::find(team_.begin(), team_.end(), comm.deviceId()))) {
+  NVF_ERROR(
+      isPeerMemoryAvailable(comm),
+      "Peer memory requires all the processes to be on the same node");
+  NVF_ERROR(
+      my_idx_ < (int64_t)team_.size(),
+      "Device ",
+      comm.deviceId(),
+      " is not in the team of the Allgather");
+  NVF_ERROR(!sizes.empty() && sizes.at(0) == (int64_t)team_.size());
+  const auto num_devices = static_cast<int64_t>(team_.size());
+  const int64_t numel = std::accumulate(
+      sizes.begin(), sizes.end(), (int64_t)1, std::multiplies<int64_t>());
+  const auto element_size =
+      static_cast<int64_t>(c10::elementSize(options.dtype().toScalarType()));
+  shard_bytes_ = numel / num_devices * element_size;
+  buffer_bytes_ = roundUpToMultiple(numel * element_size, kSemaphoreAlignment);
+
+  c10::cuda::CUDAGuard device_guard(comm.device());
+  void* local_buffer = nullptr;
+  const int64_t semaphores_bytes = 2 * num_devices * (int64_t)sizeof(uint32_t);
+  NVFUSER_CUDA_RT_SAFE_CALL(
+      cudaMalloc(&local_buffer, buffer_bytes_ + semaphores_bytes));
+  NVFUSER_CUDA_RT_SAFE_CALL(
+      cudaMemset((char*)local_buffer + buffer_bytes_, 0, semaphores_bytes));
+  // The semaphores must be reset before the peers can write into them
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaDeviceSynchronize());
+
+  // Exchange the IPC handles of the buffers through the store
+  const int64_t id = next_peer_memory_id++;
+  cudaIpcMemHandle_t handle;
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaIpcGetMemHandle(&handle, local_buffer));
+  c10d::TCPStore* store = comm.getTcpStore();
+  std::vector<uint8_t> handle_bytes(sizeof(handle));
+  std::memcpy(handle_bytes.data(), &handle, sizeof(handle));
+  store->set(getHandleKey(id, my_idx_), handle_bytes);
+
+  buffers_.resize(num_devices, nullptr);
+  for (auto peer : c10::irange(num_devices)) {
+    if (peer == my_idx_) {
+      buffers_.at(peer) = local_buffer;
+      continue;
+    }
+    std::vector<uint8_t> peer_handle_bytes =
+        store->get(getHandleKey(id, peer));
+    NVF_ERROR(peer_handle_bytes.size() == sizeof(cudaIpcMemHandle_t));
+    cudaIpcMemHandle_t peer_handle;
+    std::memcpy(&peer_handle, peer_handle_bytes.data(), sizeof(peer_handle));
+    NVFUSER_CUDA_RT_SAFE_CALL(cudaIpcOpenMemHandle(
+        &buffers_.at(peer), peer_handle, cudaIpcMemLazyEnablePeerAccess));
+  }
+
+  output_ = at::from_blob(local_buffer, sizes, options.device(comm.device()));
+}
+
+PeerMemoryAllgather::~PeerMemoryAllgather() {
+  for (auto peer : c10::irange((int64_t)buffers_.size())) {
+    if (peer != my_idx_ && buffers_.at(peer) != nullptr) {
+      cudaIpcCloseMemHandle(buffers_.at(peer));
+    }
+  }
+  // cudaFree waits for the work of the device, including the last writes of
+  // the peers this device waited for
+  if (my_idx_ < (int64_t)buffers_.size()) {
+    cudaFree(buffers_.at(my_idx_));
+  }
+}
+
+void* PeerMemoryAllgather::semaphore(
+    int64_t owner,
+    Semaphore kind,
+    int64_t peer) const {
+  auto semaphores =
+      reinterpret_cast<uint32_t*>((char*)buffers_.at(owner) + buffer_bytes_);
+  return semaphores + kind * (int64_t)team_.size() + peer;
+}
+
+void PeerMemoryAllgather::post(const at::Tensor& input) {
+  NVF_ERROR(
+      input.numel() * (int64_t)input.element_size() == shard_bytes_,
+      "Expected a shard of ",
+      shard_bytes_,
+      " bytes but got ",
+      input.numel() * input.element_size());
+  at::Tensor shard = input.contiguous();
+  cudaStream_t stream = at::cuda::getCurrentCUDAStream();
+  const auto num_devices = static_cast<int64_t>(team_.size());
+  const uint32_t epoch = ++epoch_;
+  auto as_ptr = [](void* address) { return (CUdeviceptr)address; };
+  auto shard_of = [&](int64_t owner) {
+    return (char*)buffers_.at(owner) + my_idx_ * shard_bytes_;
+  };
+
+  // The previous uses of the buffer by this device are posted before this
+  // point of the stream, so the peers can write their shards once it's
+  // reached
+  for (auto peer : c10::irange(num_devices)) {
+    if (peer != my_idx_) {
+      NVFUSER_CUDA_SAFE_CALL(cuStreamWriteValue32_v2(
+          stream,
+          as_ptr(semaphore(peer, Ready, my_idx_)),
+          epoch,
+          CU_STREAM_WRITE_VALUE_DEFAULT));
+    }
+  }
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaMemcpyAsync(
+      shard_of(my_idx_),
+      shard.data_ptr(),
+      shard_bytes_,
+      cudaMemcpyDeviceToDevice,
+      stream));
+  // Write the shard into the buffer of each peer once it's ready, then
+  // signal it. The write of the semaphore is ordered after the copy.
+  for (auto peer : c10::irange(num_devices)) {
+    if (peer == my_idx_) {
+      continue;
+    }
+    NVFUSER_CUDA_SAFE_CALL(cuStreamWaitValue32_v2(
+        stream,
+        as_ptr(semaphore(my_idx_, Ready, peer)),
+        epoch,
+        CU_STREAM_WAIT_VALUE_GEQ));
+    NVFUSER_CUDA_RT_SAFE_CALL(cudaMemcpyAsync(
+        shard_of(peer),
+        shard.data_ptr(),
+        shard_bytes_,
+        cudaMemcpyDeviceToDevice,
+        stream));
+    NVFUSER_CUDA_SAFE_CALL(cuStreamWriteValue32_v2(
+        stream,
+        as_ptr(semaphore(peer, Done, my_idx_)),
+        epoch,
+        CU_STREAM_WRITE_VALUE_DEFAULT));
+  }
+  // Wait for the shards of the peers
+  for (auto peer : c10::irange(num_devices)) {
+    if (peer != my_idx_) {
+      NVFUSER_CUDA_SAFE_CALL(cuStreamWaitValue32_v2(
+          stream,
+          as_ptr(semaphore(my_idx_, Done, peer)),
+          epoch,
+          CU_STREAM_WAIT_VALUE_GEQ));
+    }
+  }
+}
+
+#else
+
+bool isPeerMemoryAvailable(const Communicator& comm) {
+  return false;
+}
+
+PeerMemoryAllgather::PeerMemoryAllgather(
+    Communicator& comm,
+    Team team,
+    std::vector<int64_t> sizes,
+    at::TensorOptions options)
+    : team_(std::move(team)), my_idx_(0) {
+  NVF_ERROR(
+      false,
+      "Peer memory requires a distributed build with CUDA 12 or newer");
+}
+
+PeerMemoryAllgather::~PeerMemoryAllgather() = default;
+
+void PeerMemoryAllgather::post(const at::Tensor& input) {
+  NVF_ERROR(false, "Peer memory is not available");
+}
+
+#endif
+
+} // namespace nvfuser
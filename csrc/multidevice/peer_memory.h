@@ -0,0 +1,92 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <ATen/core/Tensor.h>
+
+#include <exceptions.h>
+#include <multidevice/communicator.h>
+#include <multidevice/multidevice.h>
+#include <visibility.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace nvfuser {
+
+// Returns whether the devices of comm can access each other's memory
+// through CUDA IPC, i.e. all the processes are on the same node and the
+// stream memory operations used for synchronization are available.
+NVF_API bool isPeerMemoryAvailable(const Communicator& comm);
+
+/*
+  An Allgather among the devices of a team that copies each device's shard
+  directly into the gathered buffers of all the other devices, over NVLink
+  when available, instead of going through a c10d backend.
+
+  The gathered buffer of each device is allocated once, at construction, and
+  shared with the other devices of the team through CUDA IPC. Next to it, each
+  device holds two semaphores per peer, which the peers write into:
+    *) "ready": the device has finished using its buffer, so the peer can
+       write its next shard into it
+    *) "done": the peer has finished writing its shard into the buffer
+  The semaphores are incremented and waited for on the stream with the
+  stream memory operations of the driver, so that posting an Allgather
+  doesn't block the host nor requires launching a communication kernel.
+
+  All the devices of the team must construct and post the Allgathers in the
+  same order, with shards of the same size.
+*/
+class NVF_API PeerMemoryAllgather {
+ public:
+  // Collectively allocates the gathered buffers, of the given sizes and
+  // options, and opens the buffers of the other devices of the team.
+  PeerMemoryAllgather(
+      Communicator& comm,
+      Team team,
+      std::vector<int64_t> sizes,
+      at::TensorOptions options);
+  ~PeerMemoryAllgather();
+
+  PeerMemoryAllgather(const PeerMemoryAllgather&) = delete;
+  PeerMemoryAllgather& operator=(const PeerMemoryAllgather&) = delete;
+
+  // Returns the gathered buffer of this device. Its content is only valid
+  // after post, for the work posted after it on the stream, and until the
+  // next post.
+  const at::Tensor& output() const {
+    return output_;
+  }
+
+  // Copies input, the shard of this device, into the gathered buffers of all
+  // the devices of the team, on the current stream. The work posted next on
+  // the stream waits for the shards of the other devices to be received.
+  void post(const at::Tensor& input);
+
+ private:
+  enum Semaphore { Ready = 0, Done = 1 };
+
+  // Returns the address of the semaphore of the given kind that the device
+  // at position peer in the team writes into the memory of the device at
+  // position owner
+  void* semaphore(int64_t owner, Semaphore kind, int64_t peer) const;
+
+  const Team team_;
+  const int64_t my_idx_;
+  int64_t shard_bytes_;
+  int64_t buffer_bytes_;
+  // number of Allgathers posted so far, which is the value the semaphores
+  // are incremented to
+  uint32_t epoch_ = 0;
+  // The base address of the buffer of each device of the team, as mapped on
+  // this device
+  std::vector<void*> buffers_;
+  at::Tensor output_;
+};
+
+} // namespace nvfuser
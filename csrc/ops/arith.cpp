@@ -652,6 +652,27 @@ NVFUSER_DEFINE_UNARY_FLOAT_OP(tan, Tan)
 NVFUSER_DEFINE_UNARY_FLOAT_OP(tanh, Tanh)
 #undef NVFUSER_DEFINE_UNARY_FLOAT_OP
 
+#define NVFUSER_DEFINE_APPROX_UNARY_FLOAT_OP(op_name, op_type)           \
+  Val* op_name(Val* v) {                                                 \
+    auto cast_v =                                                        \
+        promoteValues(TypePromotion::float_op_config, {v}).front();      \
+    Val* out = ops::newValLike(cast_v, cast_v->getDataType().value());   \
+    IrBuilder::create<UnaryOp>(UnaryOpType::op_type, out, cast_v, true); \
+    return out;                                                          \
+  }                                                                      \
+  TensorView* op_name(TensorView* tv) {                                  \
+    return op_name(tv->as<Val>())->as<TensorView>();                     \
+  }
+
+NVFUSER_DEFINE_APPROX_UNARY_FLOAT_OP(approx_cos, Cos)
+NVFUSER_DEFINE_APPROX_UNARY_FLOAT_OP(approx_exp, Exp)
+NVFUSER_DEFINE_APPROX_UNARY_FLOAT_OP(approx_log, Log)
+NVFUSER_DEFINE_APPROX_UNARY_FLOAT_OP(approx_reciprocal, Reciprocal)
+NVFUSER_DEFINE_APPROX_UNARY_FLOAT_OP(approx_rsqrt, Rsqrt)
+NVFUSER_DEFINE_APPROX_UNARY_FLOAT_OP(approx_sin, Sin)
+NVFUSER_DEFINE_APPROX_UNARY_FLOAT_OP(approx_tanh, Tanh)
+#undef NVFUSER_DEFINE_APPROX_UNARY_FLOAT_OP
+
 #define NVFUSER_DEFINE_UNARY_IS_OP(operator_name, operator_type) \
   Val* operator_name(Val* value) {                               \
     return unaryIsOp(UnaryOpType::operator_type, value);         \
@@ -2612,10 +2633,25 @@ TensorView* fusedMultiplySum(
   // TODO:
   //  Add tf32 and other mma data types
   //  Add fallback path for non-mma data types.
-  NVF_CHECK(
-      tv_a->getDataType().value() == DataType::Half ||
-      tv_a->getDataType().value() == DataType::BFloat16);
-  NVF_CHECK(tv_a->getDataType().value() == tv_b->getDataType().value());
+  const auto isFp8 = [](TensorView* tv) {
+    return tv->getDataType().value() == DataType::Float8_e4m3fn ||
+        tv->getDataType().value() == DataType::Float8_e5m2;
+  };
+  if (isFp8(tv_a) || isFp8(tv_b)) {
+    // The two 8-bit floating point formats can be mixed
+    NVF_CHECK(
+        isFp8(tv_a) && isFp8(tv_b),
+        "Expected both mma operands to be 8-bit floating point, got: ",
+        tv_a->getDataType().value(),
+        " and ",
+        tv_b->getDataType().value());
+  } else {
+    NVF_CHECK(
+        tv_a->getDataType().value() == DataType::Half ||
+        tv_a->getDataType().value() == DataType::BFloat16 ||
+        tv_a->getDataType().value() == DataType::Int8);
+    NVF_CHECK(tv_a->getDataType().value() == tv_b->getDataType().value());
+  }
 
   NVF_CHECK(!axes.empty(), "No reduction axis specified");
 
@@ -2628,7 +2664,13 @@ TensorView* fusedMultiplySum(
   std::vector<unsigned int> uint_axes = ops::canonicalizeAxes(
       axes, (int64_t)tv_a->domain()->noReductions().size());
 
-  TensorView* out = newForMma(tv_a, tv_b, uint_axes);
+  // Int8 operands accumulate in Int32
+  TensorView* out = newForMma(
+      tv_a,
+      tv_b,
+      uint_axes,
+      tv_a->getDataType().value() == DataType::Int8 ? DataType::Int32
+                                                    : DataType::Float);
 
   if (init == nullptr) {
     init = IrBuilder::create<Val>(0.0, out->dtype());
@@ -2649,6 +2691,106 @@ TensorView* fusedMultiplySum(
   return out;
 }
 
+TensorView* scan(ScanOpType op_type, TensorView* in, int64_t dim) {
+  const auto ndims =
+      (int64_t)TensorDomain::noReductions(in->getMaybeRFactorDomain()).size();
+  NVF_CHECK(ndims > 0, "Cannot scan a 0-dim tensor: ", in->toString());
+  dim = wrapDim(dim, ndims);
+  NVF_CHECK(
+      op_type != ScanOpType::LogSumExp || isFloatingPointType(in->dtype()),
+      "logcumsumexp expects a floating point tensor, got: ",
+      in->dtype());
+
+  TensorView* out = ops::newValLike(in, in->dtype())->as<TensorView>();
+  IrBuilder::create<ScanOp>(op_type, out, in, dim);
+  return out;
+}
+
+namespace {
+
+// Casts boolean and integer inputs of cumsum and cumprod to Int, as sum and
+// prod do
+TensorView* castForCumulativeOp(TensorView* in, DataType dtype) {
+  if (dtype == DataType::Null &&
+      (isBooleanType(in->dtype()) || isIntegralType(in->dtype()))) {
+    dtype = DataType::Int;
+  }
+  if (dtype != DataType::Null) {
+    in = optionalCastStrict(dtype, in)->as<TensorView>();
+  }
+  return in;
+}
+
+} // namespace
+
+TensorView* cumsum(TensorView* in, int64_t dim, DataType dtype) {
+  return scan(ScanOpType::Add, castForCumulativeOp(in, dtype), dim);
+}
+
+TensorView* cumprod(TensorView* in, int64_t dim, DataType dtype) {
+  return scan(ScanOpType::Mul, castForCumulativeOp(in, dtype), dim);
+}
+
+TensorView* logcumsumexp(TensorView* in, int64_t dim) {
+  return scan(ScanOpType::LogSumExp, in, dim);
+}
+
+TopKResult topk(
+    TensorView* in,
+    Val* k,
+    int64_t dim,
+    bool largest,
+    bool sorted) {
+  const auto in_domain =
+      TensorDomain::noReductions(in->getMaybeRFactorDomain());
+  const auto ndims = (int64_t)in_domain.size();
+  NVF_CHECK(ndims > 0, "Cannot select from a 0-dim tensor: ", in->toString());
+  dim = wrapDim(dim, ndims);
+  NVF_CHECK(k->isIntegralScalar(), "k of topk must be an integer, got: ", k);
+
+  // The selected dimension has extent k, the others are those of the input
+  auto new_tv = [&](DataType dtype) {
+    std::vector<IterDomain*> out_domain;
+    out_domain.reserve(ndims);
+    for (auto idx : c10::irange(ndims)) {
+      if (idx == dim) {
+        out_domain.push_back(
+            IterDomainBuilder(
+                in->container()->zeroVal(),
+                SimplifyingIrBuilder::maybeCastExpr(DataType::Index, k))
+                .build());
+      } else {
+        out_domain.push_back(ops::newOutputIterDomain({in_domain.at(idx)}));
+      }
+    }
+    return IrBuilder::create<TensorView>(
+        IrBuilder::create<TensorDomain>(
+            out_domain,
+            TensorDomain::getContiguityFilledWith(out_domain, true)),
+        dtype);
+  };
+
+  TopKResult result{new_tv(in->dtype()), new_tv(DataType::Int)};
+  IrBuilder::create<TopKOp>(
+      result.values, result.indices, in, k, dim, largest, sorted);
+  return result;
+}
+
+TensorView* argsort(
+    TensorView* in,
+    int64_t dim,
+    bool descending,
+    bool stable) {
+  const auto ndims =
+      (int64_t)TensorDomain::noReductions(in->getMaybeRFactorDomain()).size();
+  NVF_CHECK(ndims > 0, "Cannot sort a 0-dim tensor: ", in->toString());
+  dim = wrapDim(dim, ndims);
+
+  TensorView* out = ops::newValLike(in, DataType::Int)->as<TensorView>();
+  IrBuilder::create<ArgsortOp>(out, in, dim, descending, stable);
+  return out;
+}
+
 TensorView* tensor(Val* val) {
   auto dtype = val->dtype();
   if (std::holds_alternative<PrimDataType>(dtype.type)) {
@@ -398,6 +398,24 @@ NVF_API TensorView* isreal(TensorView*);
 NVF_API Val* print(Val*);
 NVF_API TensorView* print(TensorView*);
 
+// Approximate versions of transcendental ops. Float results are computed with
+// the fast hardware approximations, e.g., __expf and tanh.approx.f32, instead
+// of the precise CUDA math functions. Other types use the precise ones.
+NVF_API Val* approx_cos(Val*);
+NVF_API TensorView* approx_cos(TensorView*);
+NVF_API Val* approx_exp(Val*);
+NVF_API TensorView* approx_exp(TensorView*);
+NVF_API Val* approx_log(Val*);
+NVF_API TensorView* approx_log(TensorView*);
+NVF_API Val* approx_reciprocal(Val*);
+NVF_API TensorView* approx_reciprocal(TensorView*);
+NVF_API Val* approx_rsqrt(Val*);
+NVF_API TensorView* approx_rsqrt(TensorView*);
+NVF_API Val* approx_sin(Val*);
+NVF_API TensorView* approx_sin(TensorView*);
+NVF_API Val* approx_tanh(Val*);
+NVF_API TensorView* approx_tanh(TensorView*);
+
 // Broadcasts inp based on bool vector. Size of broadcast bool vector should be
 // the number of dims desired in the broadcasted tensor. This vector should be
 // true if output dim should be a broadcasted dim, and false if it is not a
@@ -788,7 +806,8 @@ TensorView* viewAsScalar(TensorView* inp);
 //!
 //! Note & TODO:
 //!   currently only support lowering to a mma op
-//!   through this interface and only support fp16 inputs.
+//!   through this interface and only support fp16, bf16, fp8 and int8
+//!   inputs. Int8 inputs accumulate in int32, all others in float.
 //!   will support converting back to multiply and reduce in
 //!   a follow up.
 NVF_API TensorView* fusedMultiplySum(
@@ -797,6 +816,52 @@ NVF_API TensorView* fusedMultiplySum(
     const std::vector<int64_t>& axes,
     Val* init = nullptr);
 
+//! Inclusive prefix scan of in along dim by op_type. The output has the
+//! shape and dtype of in, e.g., scan(ScanOpType::Add, t0, 1) of t0 [N, M] is
+//! t1 [N, M] with t1[n, m] = t0[n, 0] + ... + t0[n, m].
+NVF_API TensorView* scan(ScanOpType op_type, TensorView* in, int64_t dim);
+
+//! Cumulative sum along dim. Like sum, boolean and integer inputs are summed
+//! as Int unless dtype is given.
+NVF_API TensorView* cumsum(
+    TensorView* in,
+    int64_t dim,
+    DataType dtype = DataType::Null);
+
+//! Cumulative product along dim. Like prod, boolean and integer inputs are
+//! multiplied as Int unless dtype is given.
+NVF_API TensorView* cumprod(
+    TensorView* in,
+    int64_t dim,
+    DataType dtype = DataType::Null);
+
+//! Cumulative log(sum(exp(in))) along dim of a floating point tensor,
+//! computed without overflowing exp.
+NVF_API TensorView* logcumsumexp(TensorView* in, int64_t dim);
+
+struct TopKResult {
+  TensorView* values = nullptr;
+  TensorView* indices = nullptr;
+};
+
+//! The k largest, or smallest if largest is false, elements of in along dim
+//! and their Int indices in that dimension. If sorted, they are ordered from
+//! the largest, or smallest; otherwise their order is unspecified.
+NVF_API TopKResult topk(
+    TensorView* in,
+    Val* k,
+    int64_t dim = -1,
+    bool largest = true,
+    bool sorted = true);
+
+//! The Int indices that sort in along dim, in ascending order unless
+//! descending. Equal elements keep their order if stable.
+NVF_API TensorView* argsort(
+    TensorView* in,
+    int64_t dim = -1,
+    bool descending = false,
+    bool stable = false);
+
 // Create a tensor view from the given value. The given value can be a single
 // scalar, an array of scalars, or a nested array of scalars.
 NVF_API TensorView* tensor(Val* val);
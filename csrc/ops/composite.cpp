@@ -299,6 +299,201 @@ TensorView* view_as_real(TensorView* x) {
   auto tv_vector = bitCastOp(vec_type, x);
   return viewAsScalar(tv_vector);
 }
+
+TensorView* requantize(TensorView* x, Val* scale, Val* zero_point) {
+  NVF_CHECK(
+      x->getDataType().value() == DataType::Int32,
+      "Operand of requantize must have Int32 type, got: ",
+      x->getDataType().value());
+  NVF_ERROR(scale != nullptr, "scale is invalid");
+  TensorView* y = round(mul(castOp(DataType::Float, x), scale));
+  if (zero_point != nullptr) {
+    y = add(y, zero_point);
+  }
+  y = clamp(
+      y,
+      IrBuilder::create<Val>(x->container(), -128.),
+      IrBuilder::create<Val>(x->container(), 127.));
+  return castOp(DataType::Int8, y);
+}
+
+TensorView* pack_int4(TensorView* x) {
+  NVF_CHECK(
+      x->getDataType().value() == DataType::Int8,
+      "Operand of pack_int4 must have Int8 type, got: ",
+      x->getDataType().value());
+  const auto dom = TensorDomain::noReductions(x->getMaybeRFactorDomain());
+  NVF_CHECK(!dom.empty(), "pack_int4 can not be applied to a 0d tensor");
+
+  // [..., K] -> [..., K/2, 2]
+  Val* two = IrBuilder::create<Val>(x->container(), 2L, DataType::Index);
+  std::vector<Val*> pairs_shape;
+  pairs_shape.reserve(dom.size() + 1);
+  for (auto id : dom) {
+    pairs_shape.push_back(id->getMaybeExpandedExtent());
+  }
+  pairs_shape.back() = div(pairs_shape.back(), two);
+  pairs_shape.push_back(two);
+  TensorView* pairs = reshape(x, pairs_shape);
+
+  Val* one = x->container()->oneVal(DataType::Index);
+  std::vector<Slice> even_items(pairs->nDims());
+  even_items.back() = {nullptr, one, nullptr};
+  std::vector<Slice> odd_items(pairs->nDims());
+  odd_items.back() = {one, nullptr, nullptr};
+  TensorView* low = flatten(slice(pairs, even_items), -2, -1);
+  TensorView* high = flatten(slice(pairs, odd_items), -2, -1);
+
+  Val* low_mask = IrBuilder::create<Val>(x->container(), 0xFL);
+  Val* nibble_bits = IrBuilder::create<Val>(x->container(), 4L);
+  return bitwise_or(
+      bitwise_and(low, low_mask), bitwise_left_shift(high, nibble_bits));
+}
+
+TensorView* unpack_int4(TensorView* x) {
+  NVF_CHECK(
+      x->getDataType().value() == DataType::Int8,
+      "Operand of unpack_int4 must have Int8 type, got: ",
+      x->getDataType().value());
+  NVF_CHECK(
+      !TensorDomain::noReductions(x->getMaybeRFactorDomain()).empty(),
+      "unpack_int4 can not be applied to a 0d tensor");
+
+  // The arithmetic shift sign-extends the high nibble. The low nibble is
+  //  sign-extended without shifting it out of the byte, as all intermediate
+  //  values fit in Int8: ((x & 0xF) ^ 8) - 8
+  Val* low_mask = IrBuilder::create<Val>(x->container(), 0xFL);
+  Val* sign_bit = IrBuilder::create<Val>(x->container(), 8L);
+  Val* nibble_bits = IrBuilder::create<Val>(x->container(), 4L);
+  TensorView* low =
+      sub(bitwise_xor(bitwise_and(x, low_mask), sign_bit), sign_bit);
+  TensorView* high = bitwise_right_shift(x, nibble_bits);
+
+  // [..., K/2, 2] -> [..., K]
+  TensorView* pairs = cat({unsqueeze(low, -1), unsqueeze(high, -1)}, -1);
+  return flatten(pairs, -2, -1);
+}
+
+TensorView* decompress_2_4(TensorView* values, TensorView* metadata) {
+  NVF_CHECK(
+      metadata->getDataType().value() == DataType::Int8,
+      "Metadata of decompress_2_4 must have Int8 type, got: ",
+      metadata->getDataType().value());
+  const auto dom = TensorDomain::noReductions(values->getMaybeRFactorDomain());
+  NVF_CHECK(
+      !dom.empty() &&
+          dom.size() ==
+              TensorDomain::noReductions(metadata->getMaybeRFactorDomain())
+                  .size(),
+      "decompress_2_4 expects values and metadata of the same rank, got: ",
+      values->toString(),
+      " and ",
+      metadata->toString());
+
+  // [..., K/2] -> [..., K/4, 2]
+  Val* two = IrBuilder::create<Val>(values->container(), 2L, DataType::Index);
+  std::vector<Val*> pairs_shape;
+  pairs_shape.reserve(dom.size() + 1);
+  for (auto id : dom) {
+    pairs_shape.push_back(id->getMaybeExpandedExtent());
+  }
+  pairs_shape.back() = div(pairs_shape.back(), two);
+  pairs_shape.push_back(two);
+  TensorView* pairs = reshape(values, pairs_shape);
+
+  Val* one = values->container()->oneVal(DataType::Index);
+  std::vector<Slice> first_items(pairs->nDims());
+  first_items.back() = {nullptr, one, nullptr};
+  std::vector<Slice> second_items(pairs->nDims());
+  second_items.back() = {one, nullptr, nullptr};
+  TensorView* first = slice(pairs, first_items);
+  TensorView* second = slice(pairs, second_items);
+
+  // [..., K/4] -> [..., K/4, 1]
+  Val* position_mask = IrBuilder::create<Val>(values->container(), 3L);
+  Val* position_bits = IrBuilder::create<Val>(values->container(), 2L);
+  TensorView* positions = unsqueeze(metadata, -1);
+  TensorView* first_position = bitwise_and(positions, position_mask);
+  TensorView* second_position = bitwise_and(
+      bitwise_right_shift(positions, position_bits), position_mask);
+
+  // [..., K/4, 4] -> [..., K]
+  Val* zero = values->container()->zeroVal(values->getDataType().value());
+  std::vector<TensorView*> groups;
+  groups.reserve(4);
+  for (auto i : c10::irange(4)) {
+    Val* position = IrBuilder::create<Val>(values->container(), (int64_t)i);
+    groups.push_back(where(
+        eq(first_position, position),
+        first,
+        where(eq(second_position, position), second, zero)));
+  }
+  return flatten(cat(groups, -1), -2, -1);
+}
+
+namespace {
+
+// [..., K] -> [..., K/block_size, block_size]
+TensorView* splitIntoBlocks(TensorView* x, int64_t block_size) {
+  const auto dom = TensorDomain::noReductions(x->getMaybeRFactorDomain());
+  NVF_CHECK(!dom.empty(), "Block quantization of a 0d tensor is not supported");
+  NVF_CHECK(block_size > 0, "Invalid block size: ", block_size);
+  Val* block_size_val =
+      IrBuilder::create<Val>(x->container(), block_size, DataType::Index);
+  std::vector<Val*> blocks_shape;
+  blocks_shape.reserve(dom.size() + 1);
+  for (auto id : dom) {
+    blocks_shape.push_back(id->getMaybeExpandedExtent());
+  }
+  blocks_shape.back() = div(blocks_shape.back(), block_size_val);
+  blocks_shape.push_back(block_size_val);
+  return reshape(x, blocks_shape);
+}
+
+} // namespace
+
+BlockQuantizeResult block_quantize(
+    TensorView* x,
+    int64_t block_size,
+    DataType dtype) {
+  double max_value = 0.0;
+  if (dtype == DataType::Float8_e4m3fn) {
+    max_value = 448.0;
+  } else if (dtype == DataType::Float8_e5m2) {
+    max_value = 57344.0;
+  } else if (dtype == DataType::Int8) {
+    max_value = 127.0;
+  } else {
+    NVF_CHECK(false, "Unsupported block quantization type: ", dtype);
+  }
+  Val* max_val = IrBuilder::create<Val>(x->container(), max_value);
+
+  TensorView* blocks =
+      splitIntoBlocks(maybeCastOp(DataType::Float, x), block_size);
+  TensorView* amax = max(abs(blocks), {-1});
+  // Keep all-zero blocks from dividing by zero
+  Val* min_amax = IrBuilder::create<Val>(x->container(), 1e-12);
+  amax = where(gt(amax, min_amax), amax, min_amax);
+  TensorView* scale = div(amax, max_val);
+
+  TensorView* y = div(blocks, unsqueeze(scale, -1));
+  if (dtype == DataType::Int8) {
+    y = round(y);
+  }
+  y = clamp(y, IrBuilder::create<Val>(x->container(), -max_value), max_val);
+  return {castOp(dtype, flatten(y, -2, -1)), scale};
+}
+
+TensorView* block_dequantize(
+    TensorView* quantized,
+    TensorView* scale,
+    int64_t block_size,
+    DataType dtype) {
+  TensorView* blocks =
+      splitIntoBlocks(castOp(DataType::Float, quantized), block_size);
+  TensorView* x = mul(blocks, unsqueeze(scale, -1));
+  return maybeCastOp(dtype, flatten(x, -2, -1));
+}
 namespace {
 
 //! Create new output for matmul
@@ -382,4 +577,269 @@ TensorView* eagerMatmul(TensorView* tv_a, TensorView* tv_b) {
   return out;
 }
 
+TensorView* conv2d(
+    TensorView* x,
+    TensorView* weight,
+    TensorView* bias,
+    const std::vector<int64_t>& padding,
+    const std::vector<int64_t>& dilation) {
+  const auto x_dom = TensorDomain::noReductions(x->getMaybeRFactorDomain());
+  const auto w_dom =
+      TensorDomain::noReductions(weight->getMaybeRFactorDomain());
+  NVF_CHECK(
+      x_dom.size() == 4 && w_dom.size() == 4,
+      "Expected input and weight to be 4D, got: ",
+      x_dom.size(),
+      " and ",
+      w_dom.size());
+  NVF_CHECK(
+      padding.size() == 2 && dilation.size() == 2,
+      "Expected the padding and the dilation of H and W");
+  NVF_CHECK(
+      padding[0] >= 0 && padding[1] >= 0 && dilation[0] > 0 &&
+          dilation[1] > 0,
+      "Invalid padding or dilation of conv2d");
+  NVF_CHECK(
+      w_dom[2]->extent()->isConstInt() && w_dom[3]->extent()->isConstInt(),
+      "The filter size of conv2d must be static: ",
+      weight->toString());
+  const int64_t filter_h = w_dom[2]->extent()->evaluate().as<int64_t>();
+  const int64_t filter_w = w_dom[3]->extent()->evaluate().as<int64_t>();
+
+  auto index = [&](int64_t value) {
+    return IrBuilder::create<Val>(x->container(), value, DataType::Index);
+  };
+
+  // Each tap (r, s) reads x[n, c, h + r * dilation - padding, ...] for the
+  // output [n, k, h, w], i.e., x padded so that its extent is the one of the
+  // output, which is cropped out of x when the widths are negative.
+  TensorView* acc = nullptr;
+  for (auto r : c10::irange(filter_h)) {
+    for (auto s : c10::irange(filter_w)) {
+      const int64_t left_h = padding[0] - r * dilation[0];
+      const int64_t right_h = padding[0] - (filter_h - 1 - r) * dilation[0];
+      const int64_t left_w = padding[1] - s * dilation[1];
+      const int64_t right_w = padding[1] - (filter_w - 1 - s) * dilation[1];
+      // [N, C, H', W'] -> [N, 1, C, H', W']
+      TensorView* window = pad(
+          x, {index(left_w), index(right_w), index(left_h), index(right_h)});
+      window = broadcast(
+          maybeCastOp(DataType::Float, window),
+          {false, true, false, false, false});
+
+      // [K, C, R, S] -> [K, C, 1, 1] -> [1, K, C, 1, 1]
+      TensorView* tap = pad(
+          weight,
+          {index(-s),
+           index(s + 1 - filter_w),
+           index(-r),
+           index(r + 1 - filter_h)},
+          nullptr,
+          IterType::Broadcast);
+      tap = broadcast(
+          maybeCastOp(DataType::Float, tap),
+          {true, false, false, false, false});
+
+      TensorView* product = mul(window, tap);
+      acc = acc == nullptr ? product : add(acc, product);
+    }
+  }
+  TensorView* out = sum(acc, {2});
+
+  if (bias != nullptr) {
+    NVF_CHECK(
+        TensorDomain::noReductions(bias->getMaybeRFactorDomain()).size() == 1,
+        "Expected bias to be 1D, got: ",
+        bias->toString());
+    out = add(
+        out,
+        broadcast(
+            maybeCastOp(DataType::Float, bias), {true, false, true, true}));
+  }
+  return maybeCastOp(x->dtype(), out);
+}
+
+TensorView* groupedMatmul(
+    TensorView* tv_a,
+    TensorView* tv_b,
+    TensorView* offsets) {
+  auto domain_a = TensorDomain::noReductions(tv_a->getMaybeRFactorDomain());
+  auto domain_b = TensorDomain::noReductions(tv_b->getMaybeRFactorDomain());
+  auto domain_offsets =
+      TensorDomain::noReductions(offsets->getMaybeRFactorDomain());
+  NVF_CHECK(
+      domain_a.size() == 2 && domain_b.size() == 3,
+      "Expected A to be 2D and B to be 3D, got: ",
+      domain_a.size(),
+      " and ",
+      domain_b.size());
+  NVF_CHECK(
+      domain_offsets.size() == 1 && isIntegralType(offsets->dtype()),
+      "Expected offsets to be a 1D integer tensor, got: ",
+      offsets->toString());
+  NVF_CHECK(
+      tv_a->dtype() == tv_b->dtype(),
+      "Expected A and B dtypes to have the same dtype, got: ",
+      tv_a->dtype(),
+      " and ",
+      tv_b->dtype());
+
+  std::vector<IterDomain*> out_domain{
+      ops::newOutputIterDomain({domain_a.at(0)}),
+      ops::newOutputIterDomain({domain_b.at(2)})};
+  TensorDomain* td = IrBuilder::create<TensorDomain>(
+      out_domain, TensorDomain::getContiguityFilledWith(out_domain, true));
+  auto out = IrBuilder::create<TensorView>(td, tv_a->dtype());
+  IrBuilder::create<GroupedMatmulOp>(out, tv_a, tv_b, offsets);
+  return out;
+}
+
+namespace {
+
+// Checks the inputs of sdpfa_fwd and sdpfa_bwd, and fills in the default
+// arguments
+void checkSdpfaInputs(
+    TensorView* query,
+    TensorView* key,
+    TensorView* value,
+    Val*& dropout_p,
+    Val*& is_causal,
+    Val*& scale) {
+  for (TensorView* tv : {query, key, value}) {
+    NVF_CHECK(
+        TensorDomain::noReductions(tv->getMaybeRFactorDomain()).size() == 4,
+        "Expected query, key and value to be 4D [N, H, L/S, E], got: ",
+        tv->toString());
+    NVF_CHECK(
+        tv->dtype() == DataType::Half || tv->dtype() == DataType::BFloat16,
+        "Flash attention requires Half or BFloat16 inputs, got: ",
+        tv->dtype());
+  }
+  NVF_CHECK(
+      query->dtype() == key->dtype() && query->dtype() == value->dtype(),
+      "Expected query, key and value to have the same dtype, got: ",
+      query->dtype(),
+      ", ",
+      key->dtype(),
+      " and ",
+      value->dtype());
+
+  if (dropout_p == nullptr) {
+    dropout_p = IrBuilder::create<Val>(0.0);
+  }
+  if (is_causal == nullptr) {
+    is_causal = IrBuilder::create<Val>(false);
+  }
+  if (scale == nullptr) {
+    Val* head_size = TensorDomain::noReductions(
+                         query->getMaybeRFactorDomain())
+                         .back()
+                         ->extent();
+    scale = reciprocal(sqrt(castOp(DataType::Double, head_size)));
+  }
+  NVF_CHECK(
+      dropout_p->dtype() == DataType::Double,
+      "Expected dropout_p to be a Double scalar, got: ",
+      dropout_p->dtype());
+  NVF_CHECK(
+      is_causal->dtype() == DataType::Bool,
+      "Expected is_causal to be a Bool scalar, got: ",
+      is_causal->dtype());
+  NVF_CHECK(
+      scale->dtype() == DataType::Double,
+      "Expected scale to be a Double scalar, got: ",
+      scale->dtype());
+}
+
+} // namespace
+
+SdpfaFwdResult sdpfa_fwd(
+    TensorView* query,
+    TensorView* key,
+    TensorView* value,
+    Val* dropout_p,
+    Val* is_causal,
+    Val* scale) {
+  checkSdpfaInputs(query, key, value, dropout_p, is_causal, scale);
+
+  auto domain_q = TensorDomain::noReductions(query->getMaybeRFactorDomain());
+  auto domain_k = TensorDomain::noReductions(key->getMaybeRFactorDomain());
+  auto domain_v = TensorDomain::noReductions(value->getMaybeRFactorDomain());
+
+  // [N, H, L]
+  auto makeBatchAndQueryDomain = [&]() {
+    std::vector<IterDomain*> domain;
+    for (auto idx : c10::irange(2)) {
+      domain.push_back(ops::newOutputIterDomain(
+          {domain_q.at(idx), domain_k.at(idx), domain_v.at(idx)}));
+    }
+    domain.push_back(ops::newOutputIterDomain({domain_q.at(2)}));
+    return domain;
+  };
+  std::vector<IterDomain*> lse_domain = makeBatchAndQueryDomain();
+  // [N, H, L, Ev]
+  std::vector<IterDomain*> out_domain = makeBatchAndQueryDomain();
+  out_domain.push_back(ops::newOutputIterDomain({domain_v.at(3)}));
+
+  auto makeTensor = [](const std::vector<IterDomain*>& domain, DataType dtype) {
+    TensorDomain* td = IrBuilder::create<TensorDomain>(
+        domain, TensorDomain::getContiguityFilledWith(domain, true));
+    return IrBuilder::create<TensorView>(td, dtype);
+  };
+  SdpfaFwdResult result;
+  result.output = makeTensor(out_domain, query->dtype());
+  result.log_sumexp = makeTensor(lse_domain, DataType::Float);
+  result.philox_seed = makeTensor({}, DataType::Int);
+  result.philox_offset = makeTensor({}, DataType::Int);
+  IrBuilder::create<SdpaFwdOp>(
+      result.output,
+      result.log_sumexp,
+      result.philox_seed,
+      result.philox_offset,
+      query,
+      key,
+      value,
+      dropout_p,
+      is_causal,
+      scale);
+  return result;
+}
+
+SdpfaBwdResult sdpfa_bwd(
+    TensorView* grad_output,
+    TensorView* query,
+    TensorView* key,
+    TensorView* value,
+    const SdpfaFwdResult& fwd,
+    Val* dropout_p,
+    Val* is_causal,
+    Val* scale) {
+  checkSdpfaInputs(query, key, value, dropout_p, is_causal, scale);
+  NVF_CHECK(
+      fwd.output != nullptr && fwd.log_sumexp != nullptr &&
+          fwd.philox_seed != nullptr && fwd.philox_offset != nullptr,
+      "Expected all the results of sdpfa_fwd");
+
+  SdpfaBwdResult result;
+  result.grad_query = ops::newOutputTV({query}, query->dtype());
+  result.grad_key = ops::newOutputTV({key}, key->dtype());
+  result.grad_value = ops::newOutputTV({value}, value->dtype());
+  IrBuilder::create<SdpaBwdOp>(
+      result.grad_query,
+      result.grad_key,
+      result.grad_value,
+      grad_output,
+      query,
+      key,
+      value,
+      fwd.output,
+      fwd.log_sumexp,
+      dropout_p,
+      is_causal,
+      fwd.philox_seed,
+      fwd.philox_offset,
+      scale);
+  return result;
+}
+
 } // namespace nvfuser
@@ -81,6 +81,119 @@ TensorView* leaky_relu(TensorView* x, Val* negative_slope);
 
 NVF_API TensorView* view_as_real(TensorView* x);
 
+//! Requantizes the Int32 result of an Int8 matmul to Int8, i.e.
+//! clamp(round(x * scale) + zero_point, -128, 127) computed in float. scale
+//! and the optional zero_point are scalars or tensors broadcastable to x, e.g.
+//! per-channel scales. Used as the epilogue of a matmul, it is fused into the
+//! matmul kernel.
+NVF_API TensorView* requantize(
+    TensorView* x,
+    Val* scale,
+    Val* zero_point = nullptr);
+
+//! Packs each pair of int4 values along the innermost dimension of x into one
+//! byte, the even item in the low nibble. x is Int8 with values in [-8, 7],
+//! and its innermost extent must be even.
+NVF_API TensorView* pack_int4(TensorView* x);
+
+//! Inverse of pack_int4: sign-extends both nibbles of each item of the Int8
+//! tensor x, doubling its innermost extent.
+NVF_API TensorView* unpack_int4(TensorView* x);
+
+//! Expands a 2:4 structured-sparse tensor, e.g., pruned weights, to its dense
+//! form [..., K]. Each group of four consecutive items along the innermost
+//! dimension has at most two nonzeros, whose values are stored in order in
+//! values [..., K/2]. The Int8 metadata [..., K/4] holds the positions of the
+//! two values in their group, the first one in bits 0-1 and the second one in
+//! bits 2-3, as in the metadata of sparse tensor-core MMA before it is
+//! reordered into the fragment layout of the instruction.
+NVF_API TensorView* decompress_2_4(TensorView* values, TensorView* metadata);
+
+struct BlockQuantizeResult {
+  TensorView* quantized = nullptr;
+  TensorView* scale = nullptr;
+};
+
+//! Quantizes x to dtype, one of Float8_e4m3fn, Float8_e5m2 and Int8, with a
+//! Float scale per block of block_size consecutive items along the innermost
+//! dimension, e.g., 1x128 blocks for FP8 training. The scale of a block maps
+//! its amax to the largest finite value of dtype, so quantized * scale
+//! approximates x. The innermost extent must be divisible by block_size, and
+//! scale has shape [..., K / block_size]. The per-block amax reduction and the
+//! scaled cast are scheduled as one normalization, so x is read once.
+NVF_API BlockQuantizeResult
+block_quantize(TensorView* x, int64_t block_size, DataType dtype);
+
+//! Inverse of block_quantize: multiplies each block of block_size items of
+//! the quantized tensor by its scale and casts the result to dtype.
+NVF_API TensorView* block_dequantize(
+    TensorView* quantized,
+    TensorView* scale,
+    int64_t block_size,
+    DataType dtype = DataType::Float);
+
 TensorView* eagerMatmul(TensorView* tv_a, TensorView* tv_b);
 
+//! 2D convolution of x [N, C, H, W] with weight [K, C, R, S] and the optional
+//! bias [K], with a stride of 1 and a single group, as an implicit GEMM: each
+//! of the R x S filter taps pads x to the window of the output it reads, so
+//! that the im2col matrix is never materialized, and the products of the taps
+//! are reduced over C. The filter size must be static. padding and dilation
+//! are given for H and W. The output has the dtype of x, so the elementwise
+//! epilogue of the convolution, e.g., a batch norm and an activation, can
+//! join the same fusion.
+NVF_API TensorView* conv2d(
+    TensorView* x,
+    TensorView* weight,
+    TensorView* bias = nullptr,
+    const std::vector<int64_t>& padding = {0, 0},
+    const std::vector<int64_t>& dilation = {1, 1});
+
+//! Multiplies variable-sized groups of rows of tv_a [M, K] by the matrices of
+//! tv_b [G, K, N]. offsets [G] is an integer tensor holding the end row of
+//! each group, i.e., the inclusive prefix sum of the group sizes. Returns
+//! [M, N] without padding the groups.
+TensorView* groupedMatmul(
+    TensorView* tv_a,
+    TensorView* tv_b,
+    TensorView* offsets);
+
+struct SdpfaFwdResult {
+  TensorView* output = nullptr;
+  TensorView* log_sumexp = nullptr;
+  TensorView* philox_seed = nullptr;
+  TensorView* philox_offset = nullptr;
+};
+
+//! Scaled dot product flash attention of query [N, H, L, E], key [N, H, S, E]
+//! and value [N, H, S, Ev], i.e., softmax(query x key^T * scale) x value with
+//! the given dropout probability and an optional causal mask. The attention
+//! scores are never materialized. dropout_p and is_causal default to 0 and
+//! false, and scale to 1 / sqrt(E).
+NVF_API SdpfaFwdResult sdpfa_fwd(
+    TensorView* query,
+    TensorView* key,
+    TensorView* value,
+    Val* dropout_p = nullptr,
+    Val* is_causal = nullptr,
+    Val* scale = nullptr);
+
+struct SdpfaBwdResult {
+  TensorView* grad_query = nullptr;
+  TensorView* grad_key = nullptr;
+  TensorView* grad_value = nullptr;
+};
+
+//! Backward of sdpfa_fwd, given the gradient of its output and its results.
+//! The arguments must match the ones of the forward.
+NVF_API SdpfaBwdResult sdpfa_bwd(
+    TensorView* grad_output,
+    TensorView* query,
+    TensorView* key,
+    TensorView* value,
+    const SdpfaFwdResult& fwd,
+    Val* dropout_p = nullptr,
+    Val* is_causal = nullptr,
+    Val* scale = nullptr);
+
 } // namespace nvfuser
@@ -163,6 +163,124 @@ TensorView* scatter(
   return scatterOp(ScatterOpType::Set, self, dim, index, src);
 }
 
+TensorView* scatter_add(
+    TensorView* self,
+    int64_t dim,
+    TensorView* index,
+    TensorView* src) {
+  const auto dtype = self->getDataType().value();
+  NVF_CHECK(
+      dtype == DataType::Float || dtype == DataType::Double ||
+          dtype == DataType::Int32,
+      "scatter_add only supports float, double and int32 tensors as they are ",
+      "accumulated with atomicAdd, but got ",
+      dtype);
+  if (src->getDataType().value() != dtype) {
+    src = castOp(dtype, src);
+  }
+  return scatterOp(ScatterOpType::Add, self, dim, index, src);
+}
+
+TensorView* index_add(
+    TensorView* self,
+    int64_t dim,
+    TensorView* index,
+    TensorView* src) {
+  auto src_dom = TensorDomain::noReductions(src->getMaybeRFactorDomain());
+  auto idx_dom = TensorDomain::noReductions(index->getMaybeRFactorDomain());
+  NVF_CHECK(idx_dom.size() == 1, "index_add requires a 1-D index tensor.");
+  dim = wrapDim(dim, (int64_t)src_dom.size());
+
+  std::vector<bool> bcast_flags(src_dom.size(), true);
+  bcast_flags.at(dim) = false;
+  auto expanded_index = expand_as(broadcast(index, bcast_flags), src);
+  return scatter_add(self, dim, expanded_index, src);
+}
+
+TensorView* paged_gather(
+    TensorView* pool,
+    TensorView* block_table,
+    int64_t block_size,
+    Val* length) {
+  auto table_dom =
+      TensorDomain::noReductions(block_table->getMaybeRFactorDomain());
+  NVF_CHECK(table_dom.size() == 1, "paged_gather requires a 1-D block table.");
+  NVF_CHECK(
+      isIntegralType(block_table->getDataType().value()),
+      "The block table must be integral: ",
+      block_table->toString());
+  NVF_CHECK(block_size > 0, "Invalid block size: ", block_size);
+
+  Val* block_size_val = IrBuilder::create<Val>(block_size, DataType::Index);
+  if (length == nullptr) {
+    length = SimplifyingIrBuilder::mulExpr(
+        table_dom.at(0)->extent(), block_size_val);
+  }
+
+  // Logical row i -> block_table[i / block_size] * block_size + i % block_size
+  TensorView* rows = iota(length);
+  TensorView* blocks = index_select(block_table, 0, div(rows, block_size_val));
+  if (blocks->getDataType().value() != DataType::Int) {
+    blocks = castOp(DataType::Int, blocks);
+  }
+  TensorView* slots =
+      add(mul(blocks, block_size_val), mod(rows, block_size_val));
+  return index_select(pool, 0, slots);
+}
+
+TensorView* ragged_to_padded(
+    TensorView* values,
+    TensorView* offsets,
+    Val* max_length,
+    Val* pad_value) {
+  auto values_dom = TensorDomain::noReductions(values->getMaybeRFactorDomain());
+  auto offsets_dom =
+      TensorDomain::noReductions(offsets->getMaybeRFactorDomain());
+  NVF_CHECK(
+      !values_dom.empty(), "ragged_to_padded can not be applied to 0d tensor.");
+  NVF_CHECK(offsets_dom.size() == 1, "The offsets must be a 1-D tensor.");
+  NVF_CHECK(
+      isIntegralType(offsets->getDataType().value()),
+      "The offsets must be integral: ",
+      offsets->toString());
+
+  Val* one = values->fusion()->oneVal();
+  Val* batch_size =
+      SimplifyingIrBuilder::subExpr(offsets_dom.at(0)->extent(), one);
+  max_length = SimplifyingIrBuilder::maybeCastExpr(DataType::Index, max_length);
+
+  // Flattened position n of the padded tensor is position n % max_length of
+  // sequence n / max_length.
+  TensorView* positions =
+      iota(SimplifyingIrBuilder::mulExpr(batch_size, max_length));
+  TensorView* seq = div(positions, max_length);
+  TensorView* starts = index_select(offsets, 0, seq);
+  TensorView* ends = index_select(offsets, 0, add(seq, one));
+  if (starts->getDataType().value() != DataType::Int) {
+    starts = castOp(DataType::Int, starts);
+    ends = castOp(DataType::Int, ends);
+  }
+  TensorView* rows = add(starts, mod(positions, max_length));
+  TensorView* valid = lt(rows, ends);
+  // Padded positions read row 0 instead of running past values.
+  rows = where(valid, rows, values->fusion()->zeroVal(DataType::Int));
+
+  TensorView* padded = index_select(values, 0, rows);
+  std::vector<bool> bcast_flags(values_dom.size(), true);
+  bcast_flags.at(0) = false;
+  padded = where(
+      broadcast(valid, bcast_flags),
+      padded,
+      SimplifyingIrBuilder::maybeCastExpr(
+          values->getDataType().value(), pad_value));
+
+  std::vector<Val*> padded_sizes = {batch_size, max_length};
+  for (auto id : c10::irange(1, values_dom.size())) {
+    padded_sizes.push_back(values_dom.at(id)->extent());
+  }
+  return reshape(padded, padded_sizes);
+}
+
 TensorView* take_along_axis(TensorView* inp, TensorView* index, int64_t dim) {
   const auto inp_domain =
       TensorDomain::noReductions(inp->getMaybeRFactorDomain());
@@ -43,6 +43,59 @@ NVF_API TensorView* scatter(
     TensorView* index,
     TensorView* src);
 
+//! torch.scatter_add. Elements of src with the same index are accumulated
+//! with atomicAdd, so the order of the additions, and thus the rounding of
+//! floating-point results, is not deterministic. The kernel iterates over
+//! the domain of the output, so index and src must have the shape of self,
+//! the same restriction as scatter. self must be a fusion input or
+//! otherwise computable on the host, as the output is initialized from it
+//! before the kernel launch.
+NVF_API TensorView* scatter_add(
+    TensorView* self,
+    int64_t dim,
+    TensorView* index,
+    TensorView* src);
+
+//! torch.index_add with a 1-D index of the size of src along dim. Lowered to
+//! scatter_add with index broadcast to the shape of src.
+NVF_API TensorView* index_add(
+    TensorView* self,
+    int64_t dim,
+    TensorView* index,
+    TensorView* src);
+
+//! Reads a paged tensor, e.g., a paged KV cache, in its logical order
+//! without gathering it into a contiguous buffer first. pool holds
+//! fixed-size blocks of block_size rows each, flattened along its outermost
+//! dimension, i.e., [num_blocks * block_size, ...]. Logical row i lives at
+//! pool[block_table[i / block_size] * block_size + i % block_size]. The
+//! result has length rows, which defaults to all rows covered by the 1-D
+//! block_table. Both lookups are index_selects, so the indirection is folded
+//! into the index computation of the consuming kernel; pool and block_table
+//! must be fusion inputs like for index_select.
+NVF_API TensorView* paged_gather(
+    TensorView* pool,
+    TensorView* block_table,
+    int64_t block_size,
+    Val* length = nullptr);
+
+//! Views a ragged batch, i.e., variable-length sequences packed back to back
+//! into values of shape [total_length, ...], as a padded tensor of shape
+//! [batch, max_length, ...]. Sequence b occupies rows
+//! [offsets[b], offsets[b + 1]) of values, so offsets is a 1-D tensor of
+//! batch + 1 entries. Positions past the end of a sequence read as
+//! pad_value; pick the identity of a following reduction, e.g., 0 for sum
+//! or -inf for max, to get per-sequence softmax or norms. The padded tensor
+//! is a logical view: each valid element is loaded from values by the
+//! consuming kernel, so the padding is never materialized in global memory
+//! unless the result itself is a fusion output. values and offsets must be
+//! fusion inputs.
+NVF_API TensorView* ragged_to_padded(
+    TensorView* values,
+    TensorView* offsets,
+    Val* max_length,
+    Val* pad_value);
+
 //! numpy.take_along_axis
 //! (https://numpy.org/doc/stable/reference/generated/numpy.take_along_axis.html)
 //! Note the order of the parameters follows the numpy order, which is
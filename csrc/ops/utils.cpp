@@ -408,6 +408,10 @@ Val* getMinimumValue(DataType v) {
       return IrBuilder::create<Val>(
           (int64_t)std::numeric_limits<int32_t>::lowest());
       break;
+    case (DataType::Int8):
+      return IrBuilder::create<Val>(
+          (int64_t)std::numeric_limits<int8_t>::lowest());
+      break;
     case (DataType::Bool):
       return IrBuilder::create<Val>(false);
       break;
@@ -453,6 +457,10 @@ Val* getMaximumValue(DataType v) {
       return IrBuilder::create<Val>(
           (int64_t)std::numeric_limits<int32_t>::max());
       break;
+    case (DataType::Int8):
+      return IrBuilder::create<Val>(
+          (int64_t)std::numeric_limits<int8_t>::max());
+      break;
     case (DataType::Bool):
       return IrBuilder::create<Val>(true);
       break;
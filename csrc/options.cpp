@@ -126,9 +126,11 @@ std::unordered_map<DebugDumpOption, std::vector<std::string>> Options<
       {"halo", DebugDumpOption::Halo},
       {"index_type", DebugDumpOption::IndexType},
       {"kernel_args", DebugDumpOption::KernelArgs},
+      {"kernel_disk_cache", DebugDumpOption::KernelDiskCache},
       {"kernel_ir", DebugDumpOption::KernelIr},
       {"launch_param", DebugDumpOption::LaunchParam},
       {"loop_rotation", DebugDumpOption::LoopRotation},
+      {"lower_pass_timing", DebugDumpOption::LowerPassTiming},
       {"lower_verbose", DebugDumpOption::LowerVerbose},
       {"occupancy", DebugDumpOption::Occupancy},
       {"parallel_dimensions", DebugDumpOption::ParallelDimensions},
@@ -154,12 +156,67 @@ template <>
 std::unordered_map<EnableOption, std::vector<std::string>> Options<
     EnableOption>::getOptionsFromEnv() {
   const std::unordered_map<std::string, EnableOption> available_options = {
+      {"async_compile", EnableOption::AsyncCompile},
+      {"atomic_grid_reduction", EnableOption::AtomicGridReduction},
+      {"autotune", EnableOption::Autotune},
+      {"bandwidth_log", EnableOption::BandwidthLog},
+      {"bank_conflict_swizzle", EnableOption::BankConflictSwizzle},
+      {"buffer_pool", EnableOption::BufferPool},
+      {"chunked_indexing", EnableOption::ChunkedIndexing},
+      {"cluster_reduction", EnableOption::ClusterReduction},
+      {"concurrent_streams", EnableOption::ConcurrentStreams},
+      {"contiguity_specialization", EnableOption::ContiguitySpecialization},
+      {"cost_aware_inlining", EnableOption::CostAwareInlining},
+      {"cuda_graph", EnableOption::CudaGraph},
+      {"fast_divmod", EnableOption::FastDivMod},
+      {"fusion_replay_log", EnableOption::FusionReplayLog},
+      {"grid_persistence", EnableOption::GridPersistence},
+      {"group_sibling_reductions", EnableOption::GroupSiblingReductions},
+      {"heuristic_cache", EnableOption::HeuristicCache},
+      {"heuristic_db", EnableOption::HeuristicDb},
+      {"horizontal_fusion", EnableOption::HorizontalFusion},
+      {"host_index_hoist", EnableOption::HostIndexHoist},
       {"id_model", EnableOption::IdModel},
+      {"inner_outer_shared_memory", EnableOption::InnerOuterSharedMemory},
       {"kernel_db", EnableOption::KernelDb},
+      {"kernel_disk_cache", EnableOption::KernelDiskCache},
       {"kernel_profile", EnableOption::KernelProfile},
+      {"kernel_remote_cache", EnableOption::KernelRemoteCache},
+      {"l2_aware_persistence", EnableOption::L2AwarePersistence},
+      {"lazy_serde", EnableOption::LazySerde},
+      {"loop_peeling", EnableOption::LoopPeeling},
+      {"matmul_heuristic_model", EnableOption::MatmulHeuristicModel},
+      {"matmul_persistent_tiles", EnableOption::MatmulPersistentTiles},
+      {"mbarrier_circular_buffer", EnableOption::MBarrierCircularBuffer},
       {"memory_promotion", EnableOption::MemoryPromotion},
+      {"multi_stream_segments", EnableOption::MultiStreamSegments},
+      {"multi_tensor_scheduler", EnableOption::MultiTensorScheduler},
+      {"occupancy_targeting", EnableOption::OccupancyTargeting},
+      {"parallel_lowering", EnableOption::ParallelLowering},
+      {"partial_vectorization", EnableOption::PartialVectorization},
+      {"perf_monitor", EnableOption::PerfMonitor},
+      {"prune_preamble", EnableOption::PrunePreamble},
+      {"reduced_precision_pointwise", EnableOption::ReducedPrecisionPointwise},
+      {"register_pressure_fallback", EnableOption::RegisterPressureFallback},
+      {"reproducible_reduction", EnableOption::ReproducibleReduction},
       {"reuse_zeroed_memory", EnableOption::ReuseZeroedMemory},
+      {"segment_cost_model", EnableOption::SegmentCostModel},
+      {"segment_memory_planning", EnableOption::SegmentMemoryPlanning},
+      {"segment_recomputation", EnableOption::SegmentRecomputation},
+      {"segment_slots", EnableOption::SegmentSlots},
+      {"serial_grid_reduction", EnableOption::SerialGridReduction},
+      {"serial_loop_pipelining", EnableOption::SerialLoopPipelining},
+      {"shape_buckets", EnableOption::ShapeBuckets},
+      {"shape_specialization", EnableOption::ShapeSpecialization},
+      {"skip_masked_reductions", EnableOption::SkipMaskedReductions},
+      {"smem_packing", EnableOption::SmemPacking},
+      {"slice_vectorization", EnableOption::SliceVectorization},
+      {"split_k_reduction", EnableOption::SplitKReduction},
       {"static_fusion_count", EnableOption::StaticFusionCount},
+      {"tma_pointwise", EnableOption::TmaPointwise},
+      {"two_pass_outer_normalization",
+       EnableOption::TwoPassOuterNormalization},
+      {"vectorized_row_gather", EnableOption::VectorizedRowGather},
       {"warn_register_spill", EnableOption::WarnRegisterSpill},
       {"io_to_lower_precision", EnableOption::IoToLowerPrecision},
   };
@@ -172,12 +229,15 @@ std::unordered_map<DisableOption, std::vector<std::string>> Options<
     DisableOption>::getOptionsFromEnv() {
   const std::unordered_map<std::string, DisableOption> available_options = {
       {"compile_to_sass", DisableOption::CompileToSass},
+      {"compiled_kernel_sharing", DisableOption::CompiledKernelSharing},
       {"expr_simplify", DisableOption::ExprSimplify},
       {"fallback", DisableOption::Fallback},
       {"fma", DisableOption::Fma},
+      {"host_evaluation", DisableOption::HostEvaluation},
       {"grouped_grid_welford_outer_opt",
        DisableOption::GroupedGridWelfordOuterOpt},
       {"index_hoist", DisableOption::IndexHoist},
+      {"ir_node_pool", DisableOption::IrNodePool},
       {"magic_zero", DisableOption::MagicZero},
       {"matmul_expr_eval", DisableOption::MatmulExprEval},
       {"nvtx", DisableOption::Nvtx},
@@ -209,6 +269,8 @@ std::unordered_map<ProfilerOption, std::vector<std::string>> Options<
       {"print", ProfilerOption::Print},
       {"print.nocupti", ProfilerOption::PrintNocupti},
       {"print.verbose", ProfilerOption::PrintVerbose},
+      {"counters", ProfilerOption::Counters},
+      {"sample", ProfilerOption::Sample},
   };
 
   auto options = parseEnvOptions("PROF", available_options);
@@ -279,7 +341,10 @@ const std::vector<std::string>& getDisableOptionArguments(
 }
 
 bool isProfilerEnabled() {
-  return ProfilerOptionsGuard::getCurOptions().hasAny();
+  // Sampling is done by the SamplingProfiler instead
+  return ProfilerOptionsGuard::getCurOptions().has(ProfilerOption::Enable) ||
+      ProfilerOptionsGuard::getCurOptions().has(ProfilerOption::Counters) ||
+      isProfilerEnabledWithoutCupti() || isProfilerPrintingEnabled();
 }
 bool isProfilerEnabledWithoutCupti() {
   return ProfilerOptionsGuard::getCurOptions().has(
@@ -296,7 +361,21 @@ bool isProfilerPrintingVerbose() {
       ProfilerOption::PrintVerbose);
 }
 
-const std::vector<std::string>& getDisableOptionArguments(
+int64_t getProfilerSamplingPeriod() {
+  const auto& options = ProfilerOptionsGuard::getCurOptions();
+  if (!options.has(ProfilerOption::Sample)) {
+    return 0;
+  }
+  const auto& args = options.getArgs(ProfilerOption::Sample);
+  if (args.empty() || args[0].empty()) {
+    return 100;
+  }
+  const int64_t period = std::stol(args[0]);
+  NVF_CHECK(period > 0, "Invalid sampling period: ", args[0]);
+  return period;
+}
+
+const std::vector<std::string>& getProfilerOptionArguments(
     ProfilerOption option) {
   return ProfilerOptionsGuard::getCurOptions().getArgs(option);
 }
@@ -54,6 +54,8 @@ enum class DebugDumpOption {
   FusionArgs, //!< Print the runtime fusion arguments
   GlobalZeroedMemory, //!< Print the log for zeroed global memory allocator
   KernelArgs, //!< Print the runtime kernel arguments when launching kernels
+  KernelDiskCache, //!< Print hits, writes and evictions of the kernel disk
+                   //!< cache and of the kernel remote cache
   EffectiveBandwidth, //! Measure kernel performance and print effective
                       //! bandwidth
   FusionSegmentsDrawing, //!< Dump Segmented Fusion Graph
@@ -76,6 +78,7 @@ enum class DebugDumpOption {
   BankConflictInfo, //! Dump bank confliction info
   SyncMap, //! RAW dependency info
   LowerVerbose, //! Print all passes' transform in GpuLower::lower
+  LowerPassTiming, //! Print the time spent in each step of GpuLower
   ExprSimplification, //! Print all passes' transform in simplifyExpr
   ExprSort, //! Print merging decisions on expression sorting
   ExprSortVerbose, //! Print verbose debug info on expression sorting
@@ -91,15 +94,213 @@ enum class DebugDumpOption {
 //! These can be set through the `NVFUSER_ENABLE` environment variable
 //!
 enum class EnableOption {
-  IdModel, //! Enable IdModel
-  KernelDb, //! Enable Kernel Database
-  KernelProfile, //! Enable intra-kernel performance profiling
+  AsyncCompile, //! Compile new kernel runtimes in the background and evaluate
+                //! fusions with ATen until the kernels are ready
+  AtomicGridReduction, //! Let the reduction scheduler combine the blocks of
+                       //! cross-grid sum reductions with atomic additions
+                       //! into the outputs. Faster but not deterministic.
+  Autotune, //! Benchmark candidate heuristic parameters of pointwise,
+            //! reduction and inner persistent kernels when compiling a new
+            //! kernel runtime and keep the fastest. The optional argument is
+            //! the maximum number of candidates per kernel (default 8).
+  BandwidthLog, //! Append the achieved bandwidth and the ideal versus actual
+                //! memory traffic of every segment run to the JSON lines
+                //! file given as argument
+  BankConflictSwizzle, //! XOR swizzle shared memory tensors with bank
+                       //! conflicts when lowering, trying each candidate
+                       //! swizzle on a copy of the fusion
+  BufferPool, //! Recycle the output and intermediate buffers of a kernel
+              //! launch across runs with the same input cache id once they
+              //! are no longer referenced outside of nvFuser
+  ChunkedIndexing, //! Launch fusions whose arguments need 64-bit indexing as
+                   //! a sequence of 32-bit indexed kernels over chunks of
+                   //! the outermost dimension when no op mixes elements
+                   //! across that dimension
+  ClusterReduction, //! Let the reduction scheduler launch cross-grid inner
+                    //! reductions with thread block clusters on Hopper and
+                    //! reduce the blocks of a cluster through distributed
+                    //! shared memory
+  ConcurrentStreams, //! Let calls of a FusionExecutorCache on different
+                     //! streams run concurrently from several threads.
+                     //! Only looking up and compiling the kernel runtimes
+                     //! is serialized, as well as launching the kernels of
+                     //! the same runtime.
+  ContiguitySpecialization, //! Concretize fusion inputs whose innermost
+                            //! dimension is not known to be contiguous
+                            //! with the runtime inner stride, so inputs
+                            //! that are only strided in outer dimensions
+                            //! are still vectorized
+  CostAwareInlining, //! Let the pointwise scheduler keep arithmetic tensors
+                     //! out of the loops of broadcasts that would repeat
+                     //! their computation if registers are left for them
+  CudaGraph, //! Enable capturing and replaying the segment launches of a
+             //! FusionKernelRuntime as a CUDA graph. Outputs of a replayed
+             //! graph are static buffers that are overwritten by the next
+             //! replay with the same inputs.
+  FastDivMod, //! Replace integer divisions and modulos of indices by
+              //! loop-invariant runtime extents with multiplications by
+              //! magic numbers precomputed once per kernel
+  FusionReplayLog, //! Append the input shapes of every execution of a python
+                   //! frontend fusion to a log that nvfuser_replay_bench
+                   //! replays. The argument is the path of the log, see
+                   //! python_frontend/fusion_replay.h.
+  GridPersistence, //! Let the inner persistent scheduler split normalization
+                   //! rows whose persistent buffer doesn't fit in a block
+                   //! across the blocks of a cooperative grid instead of
+                   //! segmenting the fusion
+  GroupSiblingReductions, //! Let the reduction scheduler group independent
+                          //! reductions of the same domains, e.g. a sum and
+                          //! a sum of squares, so that their grid reductions
+                          //! share one synchronization
+  HeuristicCache, //! Let FusionExecutorCache reuse the kernel runtime and
+                  //! launch parameters it picked for inputs with the same
+                  //! sizes, non-size-1 strides, alignment and scalar values
+                  //! without recomputing the heuristics of every runtime
+  HeuristicDb, //! Replay the fastest heuristic parameters recorded for a
+               //! problem signature, and record the candidates measured by
+               //! the autotuner. The optional argument is the database file
+               //! (default $TMPDIR/nvfuser_heuristic_db.bin).
+  HorizontalFusion, //! Launch consecutive independent pointwise segments of a
+                    //! segmented fusion as a single kernel that gives each
+                    //! segment a range of its blocks. The optional argument
+                    //! is the maximum number of segments per kernel
+                    //! (default 8).
+  HostIndexHoist, //! Evaluate the hoisted index and predicate scalars that
+                  //! only depend on the metadata of inputs, e.g. products
+                  //! of extents, on the host and pass them as kernel
+                  //! parameters
+  IdModel, //! Enable IdModel and index global tensors with it
+  InnerOuterSharedMemory, //! Let the combined inner-outer persistent
+                          //! scheduler keep the partial results of outer
+                          //! reductions in shared memory when the
+                          //! persistent buffers don't fit in registers
+  KernelDb, //! Enable Kernel Database. The optional argument is its size
+            //! limit in MB (default 1024).
+  KernelDiskCache, //! Enable the persistent cache of compiled kernels shared
+                   //! across processes. The optional arguments are the cache
+                   //! directory and its size limit in MB (default 1024).
+  KernelProfile, //! Enable intra-kernel performance profiling. With the
+                 //! argument "phases", also report the cycles each warp
+                 //! spends in loads, compute, reductions, grid syncs and
+                 //! stores
+  KernelRemoteCache, //! Share compiled kernels through a KernelStore, e.g. an
+                     //! HTTP object store. The argument is its url, see
+                     //! KernelStore.
+  L2AwarePersistence, //! Don't schedule inner normalizations as persistent
+                      //! kernels when a row of the persistent buffers
+                      //! starves the SM while all rows fit in L2, so the
+                      //! segmented second pass re-reads them from L2
+  LazySerde, //! Deserialize the fusions of a FusionCache file the first time
+             //! they are queried instead of at startup. The file is memory
+             //! mapped, and errors in a fusion surface when it is first used.
+  LoopPeeling, //! Peel the last iteration of serial loops to remove their
+               //! bounds checks from the other iterations
+  MatmulHeuristicModel, //! Pick the matmul tiles, stages, split-K and grid
+                        //! swizzle factors that an analytical occupancy and
+                        //! wave quantization model estimates to be the
+                        //! fastest. Optional key=value arguments tune the
+                        //! model, see MatmulHeuristicModel.
+  MatmulPersistentTiles, //! Let the matmul scheduler split K when that
+                         //! fills the last wave of CTAs, or else launch
+                         //! one wave of persistent CTAs that loop over the
+                         //! output tiles
+  MBarrierCircularBuffer, //! Synchronize the stages of circular buffered
+                          //! cp.async loads with an mbarrier per stage
+                          //! instead of cp.async groups and block syncs
   MemoryPromotion, //! Enable promotion of memory types for non-pointwise ops
+  MultiStreamSegments, //! Launch independent segments of a segmented fusion
+                       //! on a pool of CUDA streams. The optional argument
+                       //! is the number of streams, including the current
+                       //! stream (default 4).
+  MultiTensorScheduler, //! Schedule fusions made of independent elementwise
+                        //! subgraphs, e.g. the per-parameter updates of an
+                        //! optimizer step, as a single kernel
+  OccupancyTargeting, //! Let the persistent schedulers state the blocks per
+                      //! SM their register budget was chosen for. Kernels
+                      //! are declared with __launch_bounds__ of that target
+                      //! and recompiled without it if the compiled kernel
+                      //! spills or still doesn't reach it.
+  ParallelLowering, //! Run independent analyses of GpuLower concurrently on
+                    //! the thread pool
+  PartialVectorization, //! Load the inputs of pointwise kernels that are not
+                        //! aligned to the vectorization factor, e.g. sliced
+                        //! views, without vectorization instead of lowering
+                        //! the factor of all tensors
+  PerfMonitor, //! Time 1 in N launches of each segment and warn when a kernel
+               //! is slower than the best time of its problem in the
+               //! heuristic DB or in this process, see PerfMonitor
+  PrunePreamble, //! Only prepend the parts of the runtime library the
+                 //! generated kernel uses, to shorten its compilation
+  ReducedPrecisionPointwise, //! Compute additions, subtractions and
+                             //! multiplications of half or bfloat16 tensors
+                             //! whose results are cast back in that type
+                             //! without upcasting them to float
+  RegisterPressureFallback, //! Lower the unroll factors or persistent
+                            //! batches of pointwise, reduction and inner
+                            //! persistent kernels whose estimated register
+                            //! usage exceeds the limit, and recompile the
+                            //! kernels that ptxas reports to spill
+  ReproducibleReduction, //! Make the results of reductions bitwise
+                         //! reproducible across runs, devices and launch
+                         //! configurations by giving them a reduction tree
+                         //! that only depends on the reduction size.
+                         //! Normalizations are segmented.
+  SegmentCostModel, //! Reject segment merges that an analytical cost model
+                    //! estimates to be slower than the separate segments.
+                    //! The optional argument is the kernel launch overhead
+                    //! in microseconds (default 4).
+  SegmentMemoryPlanning, //! Pack the intermediate tensors passed between
+                         //! segments of a segmented fusion into a single
+                         //! arena planned from their lifetimes
+  SegmentRecomputation, //! Recompute cheap elementwise producers of tensors
+                        //! passed between segments in each consuming
+                        //! segment when that moves fewer bytes
+  SegmentSlots, //! Pass the values between the segments of a fusion through
+                //! argument slots resolved once per kernel runtime rather
+                //! than a map from Val looked up for each segment
+  SerialGridReduction, //! Let the reduction scheduler reduce outer reductions
+                       //! across the grid by combining the blocks one after
+                       //! another in the outputs, which is deterministic
+  SerialLoopPipelining, //! Let the reduction and normalization schedulers
+                        //! double buffer the loads of cached inputs in
+                        //! serial loops whose loads are latency bound
+  ShapeBuckets, //! Reuse the kernel runtime compiled for the first inputs
+                //! of a shape bucket for all inputs in that bucket when it is
+                //! valid for them. Buckets are powers of two by default, or
+                //! delimited by the given upper bounds of each bucket.
+  ShapeSpecialization, //! Compile a kernel with the concrete extents of the
+                       //! inputs as constants once the same input shapes
+                       //! were run the given number of times (default 100).
+                       //! Other shapes keep using the generic kernel.
+  SkipMaskedReductions, //! Skip the serial reduction loops of the elements
+                        //! that a where masks out afterward, e.g., the
+                        //! elements above the diagonal of a causal mask
+  SmemPacking, //! Assign the offsets of shared memory tensors with constant
+               //! sizes by packing their lifetimes with a best-fit
+               //! allocator instead of a stack
+  SplitKReduction, //! Let the reduction scheduler split the reduction of
+                   //! problems whose iteration domain doesn't fill the device
+                   //! evenly across full waves of blocks
   StaticFusionCount, //! Enable using single static count in kernel name
+  SliceVectorization, //! Vectorize loads of slices of fusion inputs when the
+                      //! slice offsets are aligned to the vector width
+  TmaPointwise, //! Let the pointwise scheduler stage the tiles of full and
+                //! contiguous inputs through shared memory with TMA bulk
+                //! tensor loads on Hopper
+  TwoPassOuterNormalization, //! Let the outer persistent scheduler read the
+                             //! inputs again after the grid Welford of
+                             //! normalizations whose persistent buffers
+                             //! don't fit in the registers of the device
+  VectorizedRowGather, //! Vectorize the index_select loads of lookup
+                       //! tables, e.g. embeddings, along the contiguous
+                       //! inner dimension of their rows
   ReuseZeroedMemory, //! Re-use zeroed memory used for grid synchronization
   WarnRegisterSpill, //! Enable warnings of register spill
   IoToLowerPrecision, //! Enable castInputOutputToLowerPrecision. #1889 explains
-                      //! why we disabled it by default.
+                      //! why we disabled it by default. Optional arguments
+                      //! select the storage type (fp16, bf16, fp8_e4m3 or
+                      //! fp8_e5m2), tolerance=<unit roundoff> and
+                      //! scale=<fp8 scale>. See LowerPrecisionPolicy.
   EndOfOption //! Placeholder for counting the number of elements
 };
 
@@ -110,17 +311,25 @@ enum class EnableOption {
 enum class DisableOption {
   CompileToSass, //! Disable direct compilation to sass so the ptx can be
                  //! examined
+  CompiledKernelSharing, //! Disable sharing the loaded kernel of executors
+                         //! that generate the same code, and the compiled
+                         //! binary of executors of other devices
   ExprSimplify, //! Disable expression simplifier
   Fallback, //! Disable fallback
   Fma, //! Disable FMA instructions
+  HostEvaluation, //! Disable evaluating tiny fusions of CPU scalars on the
+                  //! host instead of launching a kernel
   GroupedGridWelfordOuterOpt, //! Disable use of outer-optimized
                               //! grouped grid welford kernel
   IndexHoist, //! Disable index hoisting
+  IrNodePool, //! Allocate each IR node with the global operator new instead of
+              //! from the pooled slabs of node_allocator.h
   MagicZero, //! Disable nvfuser_zero
   MatmulExprEval, //! Disable ATen evaluation for the entire fusion containing
                   //! matmul
   Nvtx, //! Disable NVTX instrumentation
-  ParallelCompile, //! Disable compiling Fusion segments in parallel
+  ParallelCompile, //! Disable compiling Fusion segments and computing their
+                   //! heuristics in parallel
   ParallelSerde, //! Disable deserializing FusionExecutorCache in parallel
   PredicateElimination, //! Disable predicate elimination
   KernelReuse, //! Disable re-using cached FusionKernelRuntimes with different
@@ -150,6 +359,12 @@ enum class ProfilerOption {
   PrintVerbose, //! Enables the profiler and prints a complete set of columns
                 //! to the console.  WARNING: The output is will wrap on small
                 //! screens!
+  Counters, //! Enables the profiler and collects hardware counters of each
+            //! kernel with the CUPTI range profiler. Kernels are replayed
+            //! to collect the counters, which perturbs the host time.
+  Sample, //! Times 1 in N launches of each kernel with the low overhead
+          //! SamplingProfiler, e.g. sample(100). N defaults to 100. Does
+          //! not enable the profiler.
   EndOfOption //! Placeholder for counting the number of elements
 };
 
@@ -266,6 +481,8 @@ bool isProfilerEnabled();
 bool isProfilerEnabledWithoutCupti();
 bool isProfilerPrintingEnabled();
 bool isProfilerPrintingVerbose();
+//! Returns the N of ProfilerOption::Sample or 0 if sampling is disabled
+int64_t getProfilerSamplingPeriod();
 
 const std::vector<std::string>& getProfilerOptionArguments(
     ProfilerOption option);
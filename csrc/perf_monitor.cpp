@@ -0,0 +1,157 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <perf_monitor.h>
+
+#include <exceptions.h>
+#include <kernel_db/heuristic_db.h>
+#include <options.h>
+#include <scheduler/heuristic_plugin.h>
+
+#include <algorithm>
+#include <memory>
+
+namespace nvfuser {
+
+PerfMonitor* PerfMonitor::get() {
+  if (!isOptionEnabled(EnableOption::PerfMonitor)) {
+    return nullptr;
+  }
+
+  static std::mutex monitor_lock;
+  static std::unique_ptr<PerfMonitor> monitor;
+  static std::vector<std::string> monitor_args;
+
+  const auto& args = getEnableOptionArguments(EnableOption::PerfMonitor);
+  std::lock_guard<std::mutex> guard(monitor_lock);
+  // Options can be changed at runtime, e.g. by tests
+  if (monitor == nullptr || args != monitor_args) {
+    monitor_args = args;
+    int64_t period = 100;
+    double threshold_pct = 10.0;
+    if (!args.empty() && !args[0].empty()) {
+      period = std::stol(args[0]);
+      NVF_CHECK(period > 0, "Invalid perf_monitor sampling period: ", args[0]);
+    }
+    if (args.size() > 1 && !args[1].empty()) {
+      threshold_pct = std::stod(args[1]);
+      NVF_CHECK(
+          threshold_pct >= 0.0, "Invalid perf_monitor threshold: ", args[1]);
+    }
+    monitor = std::make_unique<PerfMonitor>(period, threshold_pct);
+  }
+  return monitor.get();
+}
+
+double PerfMonitor::bestTimeMs(
+    const std::string& signature,
+    const std::string& kernel_name) const {
+  double best_time_ms = -1.0;
+  auto update = [&best_time_ms](double time_ms) {
+    if (best_time_ms < 0.0 || time_ms < best_time_ms) {
+      best_time_ms = time_ms;
+    }
+  };
+  if (HeuristicDb* heuristic_db = HeuristicDb::get()) {
+    const std::vector<HeuristicDb::Record> records =
+        heuristic_db->records(signature);
+    if (!records.empty()) {
+      update(records.front().best_time_ms);
+    }
+  }
+  auto medians_it = best_medians_.find(signature);
+  if (medians_it != best_medians_.end()) {
+    for (const auto& [name, time_ms] : medians_it->second) {
+      if (name != kernel_name) {
+        update(time_ms);
+      }
+    }
+  }
+  return best_time_ms;
+}
+
+void PerfMonitor::record(
+    const std::string& kernel_name,
+    const HeuristicParams& params,
+    double time_ms) {
+  // Kernels without a signature can't be compared with other kernels
+  if (params.problem_signature.empty() || time_ms <= 0.0) {
+    return;
+  }
+  std::lock_guard<std::mutex> guard(mutex_);
+  KernelSamples& samples = kernels_[kernel_name];
+  samples.signature = params.problem_signature;
+  samples.times_ms.push_back(time_ms);
+  if ((int64_t)samples.times_ms.size() > window_size) {
+    samples.times_ms.pop_front();
+  }
+  ++samples.unrecorded_samples;
+  if ((int64_t)samples.times_ms.size() < window_size) {
+    return;
+  }
+
+  std::vector<double> times_ms(
+      samples.times_ms.begin(), samples.times_ms.end());
+  auto median_it = times_ms.begin() + (int64_t)times_ms.size() / 2;
+  std::nth_element(times_ms.begin(), median_it, times_ms.end());
+  const double median_ms = *median_it;
+
+  const double best_time_ms = bestTimeMs(samples.signature, kernel_name);
+  if (!samples.regressed && best_time_ms > 0.0 &&
+      median_ms > best_time_ms * (1.0 + threshold_pct_ / 100.0)) {
+    samples.regressed = true;
+    regressions_.push_back(
+        {kernel_name, samples.signature, median_ms, best_time_ms});
+    TORCH_WARN(
+        "nvFuser kernel ",
+        kernel_name,
+        " takes ",
+        median_ms,
+        " ms, ",
+        (median_ms / best_time_ms - 1.0) * 100.0,
+        "% more than the best time of its problem, ",
+        best_time_ms,
+        " ms. Problem signature: ",
+        samples.signature);
+  }
+
+  double& best_median_ms = best_medians_[samples.signature][kernel_name];
+  if (best_median_ms <= 0.0 || median_ms < best_median_ms) {
+    best_median_ms = median_ms;
+  }
+
+  if (samples.unrecorded_samples < window_size) {
+    return;
+  }
+  samples.unrecorded_samples = 0;
+  HeuristicDb* heuristic_db = HeuristicDb::get();
+  const std::vector<int64_t> knobs = heuristic_plugin::getConfigKnobs(params);
+  if (heuristic_db == nullptr || knobs.empty() ||
+      !heuristic_db->best(samples.signature).has_value()) {
+    return;
+  }
+  heuristic_db->record(samples.signature, knobs, median_ms, window_size);
+  if (!heuristic_db->sync()) {
+    TORCH_WARN(
+        "nvFuser's heuristic DB could not be written to ",
+        heuristic_db->dbFile().string());
+  }
+}
+
+std::vector<PerfRegression> PerfMonitor::regressions() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return regressions_;
+}
+
+void PerfMonitor::reset() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  kernels_.clear();
+  best_medians_.clear();
+  regressions_.clear();
+}
+
+} // namespace nvfuser
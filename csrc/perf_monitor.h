@@ -0,0 +1,113 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <scheduler/heuristic.h>
+#include <visibility.h>
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace nvfuser {
+
+//! \struct PerfRegression
+//! \brief A kernel that runs significantly slower than the best time known
+//! for its problem, see PerfMonitor
+struct PerfRegression {
+  std::string kernel_name;
+  //! heuristic_plugin::problemSignature of the kernel
+  std::string signature;
+  //! Median of the most recent sampled launches of the kernel
+  double time_ms = 0.0;
+  //! Best time of the problem in the heuristic DB or of another kernel of
+  //! this process
+  double best_time_ms = 0.0;
+};
+
+//! \class PerfMonitor
+//! \brief Detects kernels that got slower than they used to be, e.g. after a
+//! heuristic change or a driver update. It is enabled with
+//! NVFUSER_ENABLE=perf_monitor, optionally followed by the sampling period
+//! and the slowdown threshold in percent, e.g. perf_monitor(100,10), the
+//! default.
+//!
+//! 1 in period launches of each segment is timed with a CudaEventTimer,
+//! which synchronizes the stream. The median of the last window_size samples
+//! of a kernel is compared with the best time of its problem, identified by
+//! the signature of the heuristic DB, which is implied by sizes, data type
+//! and device. The best time is the fastest record of the heuristic DB if
+//! EnableOption::HeuristicDb is enabled, and the fastest median of the
+//! other kernels compiled for the problem in this process, e.g. by another
+//! FusionExecutorCache. A kernel slower than the best time by more than the
+//! threshold is reported once with a warning and listed in regressions().
+//!
+//! The medians are also added to the heuristic DB of problems that already
+//! have records, so that the history covers the parameters the kernels
+//! actually ran with. Problems without records are left to the autotuner,
+//! which skips the problems of the DB.
+class PerfMonitor {
+ public:
+  //! Samples the median is computed from
+  static constexpr int64_t window_size = 16;
+
+  //! Returns the monitor configured by EnableOption::PerfMonitor, or nullptr
+  //! if the option is not enabled
+  NVF_API static PerfMonitor* get();
+
+  PerfMonitor(int64_t period, double threshold_pct)
+      : period_(period), threshold_pct_(threshold_pct) {}
+
+  //! Whether the launch_count-th launch of a kernel is timed
+  bool shouldSample(int64_t launch_count) const {
+    return launch_count % period_ == 0;
+  }
+
+  //! Adds a sampled launch of the kernel kernel_name, scheduled with params
+  NVF_API void record(
+      const std::string& kernel_name,
+      const HeuristicParams& params,
+      double time_ms);
+
+  //! Kernels found to be slower than the best time of their problem
+  NVF_API std::vector<PerfRegression> regressions() const;
+
+  //! Drops all samples and regressions
+  NVF_API void reset();
+
+ private:
+  struct KernelSamples {
+    std::string signature;
+    std::deque<double> times_ms;
+    //! Samples since the last median added to the heuristic DB
+    int64_t unrecorded_samples = 0;
+    bool regressed = false;
+  };
+
+  //! Returns the best time of the problem of signature, ignoring the
+  //! medians of kernel_name, or a negative number if none is known. Needs
+  //! mutex_.
+  double bestTimeMs(
+      const std::string& signature,
+      const std::string& kernel_name) const;
+
+ private:
+  const int64_t period_;
+  const double threshold_pct_;
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, KernelSamples> kernels_;
+  //! Best medians of each kernel of a signature
+  std::unordered_map<std::string, std::unordered_map<std::string, double>>
+      best_medians_;
+  std::vector<PerfRegression> regressions_;
+};
+
+} // namespace nvfuser
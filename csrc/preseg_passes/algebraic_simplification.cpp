@@ -0,0 +1,246 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <preseg_passes/algebraic_simplification.h>
+
+#include <ir/utils.h>
+#include <ops/alias.h>
+#include <ops/arith.h>
+
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace nvfuser::preseg_passes {
+
+namespace {
+
+//! mul(x, 1), add(x, 0) and sub(x, 0) -> x. add(x, 0) is only folded for
+//! integral x, since -0.0 + 0.0 is 0.0.
+Val* simplifyIdentityOp(BinaryOp* bop) {
+  Val* lhs = bop->lhs();
+  Val* rhs = bop->rhs();
+  Val* x = nullptr;
+  switch (bop->getBinaryOpType()) {
+    case BinaryOpType::Mul:
+      x = rhs->isOne() ? lhs : (lhs->isOne() ? rhs : nullptr);
+      break;
+    case BinaryOpType::Add:
+      if (isIntegralType(bop->out()->dtype())) {
+        x = rhs->isZero() ? lhs : (lhs->isZero() ? rhs : nullptr);
+      }
+      break;
+    case BinaryOpType::Sub:
+      x = rhs->isZero() ? lhs : nullptr;
+      break;
+    default:
+      break;
+  }
+  // The other operand is a scalar, so x has the shape of the output
+  if (x == nullptr || !x->isA<TensorView>() ||
+      x->dtype() != bop->out()->dtype()) {
+    return nullptr;
+  }
+  return x;
+}
+
+//! div(x, c) -> mul(x, 1 / c) when |c| is a power of two, so 1 / c is exact
+//! and the product is rounded like the quotient
+Val* simplifyDivByConstant(BinaryOp* bop) {
+  auto x = dynamic_cast<TensorView*>(bop->lhs());
+  Val* c = bop->rhs();
+  if (bop->getBinaryOpType() != BinaryOpType::Div || x == nullptr ||
+      !isFloatingPointType(x->dtype()) || !c->isConstScalar() ||
+      !(isFloatingPointType(c->dtype()) || isIntegralType(c->dtype())) ||
+      c->isZero()) {
+    return nullptr;
+  }
+  const double divisor = (double)c->evaluate();
+  int exponent = 0;
+  if (std::abs(std::frexp(divisor, &exponent)) != 0.5) {
+    return nullptr;
+  }
+  const double reciprocal = 1.0 / divisor;
+  if (!std::isnormal(reciprocal)) {
+    return nullptr;
+  }
+  return maybeCastOp(
+      bop->out()->dtype(), mul(x, IrBuilder::create<Val>(reciprocal)));
+}
+
+//! neg(neg(x)) -> x
+Val* simplifyDoubleNegation(UnaryOp* uop) {
+  if (uop->getUnaryOpType() != UnaryOpType::Neg) {
+    return nullptr;
+  }
+  auto inner = dynamic_cast<UnaryOp*>(uop->in()->definition());
+  if (inner == nullptr || inner->getUnaryOpType() != UnaryOpType::Neg) {
+    return nullptr;
+  }
+  return inner->in();
+}
+
+//! reshape(reshape(x)) -> reshape(x). Only static reshapes are collapsed,
+//! since a dynamic reshape would need to be concretized again.
+Val* simplifyReshapes(ViewOp* vop) {
+  auto inner = dynamic_cast<ViewOp*>(vop->in()->definition());
+  if (inner == nullptr) {
+    return nullptr;
+  }
+  TensorView* x = inner->in();
+  const std::optional<std::vector<int64_t>> in_sizes =
+      ir_utils::getConstSizes(x);
+  const std::optional<std::vector<int64_t>> out_sizes =
+      ir_utils::getConstSizes(vop->out());
+  if (!in_sizes.has_value() || !out_sizes.has_value()) {
+    return nullptr;
+  }
+  return reshape(x, in_sizes.value(), out_sizes.value());
+}
+
+//! permute(permute(x)) -> permute(x), or x if the permutations cancel out
+Val* simplifyPermutes(LoadStoreOp* ldst) {
+  const std::optional<std::vector<int64_t>> outer =
+      ir_utils::getPermuteNew2Old(ldst);
+  Expr* inner_expr = ldst->in()->definition();
+  if (!outer.has_value() || inner_expr == nullptr) {
+    return nullptr;
+  }
+  const std::optional<std::vector<int64_t>> inner =
+      ir_utils::getPermuteNew2Old(inner_expr);
+  if (!inner.has_value()) {
+    return nullptr;
+  }
+  auto x = inner_expr->input(0)->as<TensorView>();
+  std::vector<int64_t> new2old;
+  new2old.reserve(outer->size());
+  bool is_identity = true;
+  for (auto i : c10::irange(outer->size())) {
+    new2old.push_back(inner->at(outer->at(i)));
+    is_identity = is_identity && new2old.back() == (int64_t)i;
+  }
+  if (is_identity) {
+    return x;
+  }
+  return permute(x, new2old);
+}
+
+//! set(x) -> x if the set is only a copy
+Val* simplifySet(LoadStoreOp* ldst) {
+  auto in = dynamic_cast<TensorView*>(ldst->in());
+  auto out = dynamic_cast<TensorView*>(ldst->out());
+  if (ldst->opType() != LoadStoreOpType::Set || in == nullptr ||
+      out == nullptr || out->hasRFactor() || out->hasAllocation() ||
+      in->dtype() != out->dtype()) {
+    return nullptr;
+  }
+  // A set between device meshes is a communication
+  if (in->hasDeviceMesh() || out->hasDeviceMesh()) {
+    return nullptr;
+  }
+  return in;
+}
+
+//! sum(broadcast(x)) -> x when only broadcast axes are reduced. Broadcast
+//! axes that are not reduced are kept.
+Val* simplifySumOfBroadcast(ReductionOp* rop) {
+  auto bop = dynamic_cast<BroadcastOp*>(rop->in()->definition());
+  if (rop->getReductionOpType() != BinaryOpType::Add ||
+      !rop->init()->isZero() || bop == nullptr) {
+    return nullptr;
+  }
+  auto out = rop->out()->as<TensorView>();
+  const std::vector<IterDomain*>& root = out->getRootDomain();
+  const std::vector<bool>& flags = bop->getBroadcastDimFlags();
+  NVF_ERROR(root.size() == flags.size());
+  std::vector<bool> remaining_flags;
+  bool has_remaining_broadcast = false;
+  for (auto i : c10::irange(root.size())) {
+    if (!root[i]->isReduction()) {
+      remaining_flags.push_back(flags[i]);
+      has_remaining_broadcast = has_remaining_broadcast || flags[i];
+    } else if (!flags[i]) {
+      return nullptr;
+    }
+  }
+  auto x = bop->in()->as<TensorView>();
+  return maybeCastOp(
+      out->dtype(),
+      has_remaining_broadcast ? broadcast(x, remaining_flags) : x);
+}
+
+//! Returns the value expr's output can be replaced with, or nullptr
+Val* simplify(Expr* expr) {
+  if (auto bop = dynamic_cast<BinaryOp*>(expr)) {
+    if (Val* x = simplifyIdentityOp(bop)) {
+      return x;
+    }
+    return simplifyDivByConstant(bop);
+  }
+  if (auto uop = dynamic_cast<UnaryOp*>(expr)) {
+    return simplifyDoubleNegation(uop);
+  }
+  if (auto vop = dynamic_cast<ViewOp*>(expr)) {
+    return simplifyReshapes(vop);
+  }
+  if (auto ldst = dynamic_cast<LoadStoreOp*>(expr)) {
+    if (Val* x = simplifyPermutes(ldst)) {
+      return x;
+    }
+    return simplifySet(ldst);
+  }
+  if (auto rop = dynamic_cast<ReductionOp*>(expr)) {
+    return simplifySumOfBroadcast(rop);
+  }
+  return nullptr;
+}
+
+} // namespace
+
+void AlgebraicSimplificationPass::runPass(Fusion* fusion) {
+  FusionGuard fg(fusion);
+
+  // Replacements of the outputs of simplified exprs
+  std::unordered_map<Val*, Val*> replacement_map;
+
+  // Exprs are visited in topological order, so chains like
+  // permute(permute(permute(x))) are simplified one expr at a time. Note
+  // that replacing inputs creates a new expr, so exprs are only modified
+  // when visited.
+  for (auto expr : fusion->exprs()) {
+    const std::vector<Val*> inputs = expr->inputs();
+    for (auto inp : inputs) {
+      if (auto it = replacement_map.find(inp); it != replacement_map.end()) {
+        expr = ir_utils::replaceValInExprInputs(expr, inp, it->second);
+      }
+    }
+
+    if (expr->outputs().size() != 1 ||
+        !expr->output(0)->isA<TensorView>()) {
+      continue;
+    }
+    Val* out = expr->output(0);
+    Val* replacement = simplify(expr);
+    if (replacement == nullptr || replacement == out) {
+      continue;
+    }
+    if (out->isFusionOutput()) {
+      // A fusion output can't be replaced with a tensor that is already a
+      // fusion input or output
+      if (replacement->isFusionInput() || replacement->isFusionOutput() ||
+          fusion->getOutputAlias(out).type != AllocationType::New) {
+        continue;
+      }
+      fusion->replaceOutput(out, replacement);
+    }
+    replacement_map.emplace(out, replacement);
+  }
+}
+
+} // namespace nvfuser::preseg_passes
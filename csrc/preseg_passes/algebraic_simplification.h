@@ -0,0 +1,36 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <preseg_passes/optimization_pass.h>
+#include <visibility.h>
+
+namespace nvfuser::preseg_passes {
+
+//! AlgebraicSimplificationPass applies tensor-level rewrites that are common
+//! in traced graphs:
+//!   - mul(x, 1) and sub(x, 0) are replaced with x, and so is add(x, 0) for
+//!     an integral x
+//!   - neg(neg(x)) is replaced with x
+//!   - div(x, c) is replaced with mul(x, 1 / c) for a floating-point x and a
+//!     constant c whose magnitude is a power of two, so the results match
+//!   - reshape(reshape(x)) is replaced with a single reshape when the shapes
+//!     are static
+//!   - permute(permute(x)) is replaced with a single permute, or x
+//!   - a set that neither permutes nor changes the allocation is removed
+//!   - sum(broadcast(x)) over broadcast axes is replaced with x, or the
+//!     remaining broadcast of x
+//! A fusion output is only replaced if its replacement is neither a fusion
+//! input nor a fusion output.
+class NVF_API AlgebraicSimplificationPass
+    : public OptimizationPass<AlgebraicSimplificationPass> {
+  friend class OptimizationPass<AlgebraicSimplificationPass>;
+
+ protected:
+  static void runPass(Fusion* fusion);
+};
+
+} // namespace nvfuser::preseg_passes
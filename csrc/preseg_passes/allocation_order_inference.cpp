@@ -92,10 +92,9 @@ class AllocationOrderInferencer : public IterVisitor {
   void handle(TernaryOp*) override;
   void handle(PadOp*) override;
   void handle(ReductionOp*) override;
-  // TODO: Add more propagation rules
-  // void handle(LoadStoreOp*) override;
-  // void handle(SqueezeOp*) override;
-  // void handle(ExpandOp*) override;
+  void handle(LoadStoreOp*) override;
+  void handle(SqueezeOp*) override;
+  void handle(ExpandOp*) override;
 
  private:
   // mapping allocation domain from producer to consumer without reduction
@@ -113,22 +112,27 @@ class AllocationOrderInferencer : public IterVisitor {
   // root domain map from producer to consumer.
   //   [r0', i0', i2', i1'] -> [i0', i2', i1'] -> [i0, i2, i1]
   // so the function would return [i0, i2, i1]
+  //
+  // Producer iterdomains that are not mapped to consumer, i.e. broadcast
+  // removed by SqueezeOp, are dropped.
   std::vector<IterDomain*> propagateAllocationDomain(
       TensorView* producer,
       TensorView* consumer) {
     // constructing alloc_domain for producer from its root domain, while
     // filtering out reduction because they won't appear in consumer's domain.
-    std::vector<IterDomain*> alloc_domain = TensorDomain::noReductions(
+    std::vector<IterDomain*> producer_alloc_domain = TensorDomain::noReductions(
         constructAllocationDomain(producer, alloc_order_map_.at(producer)));
     // creating producer to consumer root domain map
     std::unordered_map<IterDomain*, IterDomain*> p2c_map =
         PairwiseRootDomainMap(producer, consumer).mapProducerToConsumer();
     // map alloc_domain to consumer
-    std::transform(
-        alloc_domain.cbegin(),
-        alloc_domain.cend(),
-        alloc_domain.begin(),
-        [&p2c_map](IterDomain* id) { return p2c_map.at(id); });
+    std::vector<IterDomain*> alloc_domain;
+    alloc_domain.reserve(producer_alloc_domain.size());
+    for (IterDomain* id : producer_alloc_domain) {
+      if (auto iter = p2c_map.find(id); iter != p2c_map.end()) {
+        alloc_domain.push_back(iter->second);
+      }
+    }
     return alloc_domain;
   }
 
@@ -392,6 +396,42 @@ void AllocationOrderInferencer::handle(ReductionOp* op) {
   propagateAllocationOrder(in, out);
 }
 
+// LoadStoreOp propagation forwards allocation order through `set` and cache
+// ops.
+//
+// Note: permuted outputs, which have a rfactor domain, are skipped; keeping
+// the input layout for them would turn every transpose into a copy.
+void AllocationOrderInferencer::handle(LoadStoreOp* op) {
+  auto* out = dynamic_cast<TensorView*>(op->out());
+  auto* in = dynamic_cast<TensorView*>(op->in());
+  if (out == nullptr || in == nullptr || out->hasRFactor()) {
+    return;
+  }
+  propagateAllocationOrder(in, out);
+}
+
+// SqueezeOp propagation preserves the allocation order of the remaining
+// iterdomains, see propagateAllocationDomain.
+void AllocationOrderInferencer::handle(SqueezeOp* op) {
+  auto* out = dynamic_cast<TensorView*>(op->out());
+  auto* in = dynamic_cast<TensorView*>(op->in());
+  if (out == nullptr || in == nullptr) {
+    return;
+  }
+  propagateAllocationOrder(in, out);
+}
+
+// ExpandOp maps each input iterdomain to the output, with expanded broadcast
+// staying at their position in the allocation order.
+void AllocationOrderInferencer::handle(ExpandOp* op) {
+  auto* out = dynamic_cast<TensorView*>(op->out());
+  auto* in = dynamic_cast<TensorView*>(op->in());
+  if (out == nullptr || in == nullptr) {
+    return;
+  }
+  propagateAllocationOrder(in, out);
+}
+
 } // namespace
 
 // Note [ Allocation Order Propagation ]
@@ -0,0 +1,151 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <preseg_passes/common_subexpression_elimination.h>
+
+#include <ir/utils.h>
+#include <utils.h>
+
+#include <algorithm>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+namespace nvfuser::preseg_passes {
+
+namespace {
+
+bool sameInput(Val* a, Val* b) {
+  // Tensors are only the same if they are the same object, since duplicated
+  // producers have already been replaced. Scalars are compared structurally,
+  // e.g., two constants of the same value.
+  return a == b || (a->isScalar() && a->sameAs(b));
+}
+
+//! Duplicated exprs produce outputs of the same shape, which isn't
+//! necessarily captured by the attributes, e.g., the reduced axes of a
+//! ReductionOp.
+bool sameOutput(TensorView* a, TensorView* b) {
+  if (a->dtype() != b->dtype() || a->hasRFactor() != b->hasRFactor()) {
+    return false;
+  }
+  if (a->hasDeviceMesh() != b->hasDeviceMesh() ||
+      (a->hasDeviceMesh() && !(a->getDeviceMesh() == b->getDeviceMesh()))) {
+    return false;
+  }
+  auto same_ids = [](const std::vector<IterDomain*>& ids_a,
+                     const std::vector<IterDomain*>& ids_b) {
+    if (ids_a.size() != ids_b.size()) {
+      return false;
+    }
+    for (auto i : c10::irange(ids_a.size())) {
+      if (ids_a[i]->getIterType() != ids_b[i]->getIterType() ||
+          !ids_a[i]->extent()->sameAs(ids_b[i]->extent()) ||
+          ids_a[i]->hasExpandedExtent() != ids_b[i]->hasExpandedExtent() ||
+          (ids_a[i]->hasExpandedExtent() &&
+           !ids_a[i]->expandedExtent()->sameAs(ids_b[i]->expandedExtent()))) {
+        return false;
+      }
+    }
+    return true;
+  };
+  return same_ids(a->getRootDomain(), b->getRootDomain()) &&
+      same_ids(a->getMaybeRFactorDomain(), b->getMaybeRFactorDomain());
+}
+
+//! Whether expr can be compared with other exprs. Only exprs producing
+//! tensors are considered.
+bool isComparable(Expr* expr) {
+  if (expr->isA<RNGOp>() || expr->outputs().empty()) {
+    return false;
+  }
+  return std::all_of(
+      expr->outputs().begin(), expr->outputs().end(), [](Val* out) {
+        auto tv = dynamic_cast<TensorView*>(out);
+        return tv != nullptr && !tv->hasAllocation();
+      });
+}
+
+bool isDuplicate(Expr* expr, Expr* other) {
+  if (!expr->sameOp(other)) {
+    return false;
+  }
+  for (auto i : c10::irange(expr->inputs().size())) {
+    if (!sameInput(expr->input(i), other->input(i))) {
+      return false;
+    }
+  }
+  for (auto i : c10::irange(expr->outputs().size())) {
+    if (!sameOutput(
+            expr->output(i)->as<TensorView>(),
+            other->output(i)->as<TensorView>())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+//! Structural hash of an expr. Scalar inputs are skipped, as equal scalars
+//! can be different objects.
+size_t exprHash(Expr* expr) {
+  size_t hash = typeid(*expr).hash_code();
+  for (auto inp : expr->inputs()) {
+    hashCombine(
+        hash,
+        inp->isScalar() ? 0 : std::hash<Val*>()(inp));
+  }
+  return hash;
+}
+
+} // namespace
+
+void CommonSubexpressionEliminationPass::runPass(Fusion* fusion) {
+  FusionGuard fg(fusion);
+
+  // Replacements of the outputs of eliminated exprs
+  std::unordered_map<Val*, Val*> replacement_map;
+  // Exprs kept so far, bucketed by their hash
+  std::unordered_map<size_t, std::vector<Expr*>> kept_exprs;
+
+  // Exprs are visited in topological order, so the inputs of an expr are
+  // replaced before it is compared with the kept ones. Note that
+  // replacing inputs creates a new expr, so exprs are only modified when
+  // visited.
+  for (auto expr : fusion->exprs()) {
+    const std::vector<Val*> inputs = expr->inputs();
+    for (auto inp : inputs) {
+      if (auto it = replacement_map.find(inp); it != replacement_map.end()) {
+        expr = ir_utils::replaceValInExprInputs(expr, inp, it->second);
+      }
+    }
+
+    if (!isComparable(expr)) {
+      continue;
+    }
+
+    auto& bucket = kept_exprs[exprHash(expr)];
+    auto it = std::find_if(bucket.begin(), bucket.end(), [&](Expr* kept) {
+      return isDuplicate(expr, kept);
+    });
+    if (it == bucket.end()) {
+      bucket.push_back(expr);
+      continue;
+    }
+    // Fusion outputs are left as they are
+    if (std::any_of(
+            expr->outputs().begin(), expr->outputs().end(), [](Val* out) {
+              return out->isFusionOutput();
+            })) {
+      continue;
+    }
+    for (auto i : c10::irange(expr->outputs().size())) {
+      replacement_map.emplace(expr->output(i), (*it)->output(i));
+    }
+  }
+}
+
+} // namespace nvfuser::preseg_passes
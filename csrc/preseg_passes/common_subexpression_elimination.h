@@ -0,0 +1,28 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <preseg_passes/optimization_pass.h>
+#include <visibility.h>
+
+namespace nvfuser::preseg_passes {
+
+//! CommonSubexpressionEliminationPass replaces tensor expressions that compute
+//! the same value as an earlier expression, e.g., the repeated
+//! `rsqrt(var + eps)` or broadcasts produced by tracing frontends, with the
+//! earlier expression. Two expressions are considered the same when they have
+//! the same op and attributes, the same inputs and outputs of the same shape.
+//! Random number generation and expressions defining fusion outputs are left
+//! untouched.
+class NVF_API CommonSubexpressionEliminationPass
+    : public OptimizationPass<CommonSubexpressionEliminationPass> {
+  friend class OptimizationPass<CommonSubexpressionEliminationPass>;
+
+ protected:
+  static void runPass(Fusion* fusion);
+};
+
+} // namespace nvfuser::preseg_passes
@@ -7,6 +7,8 @@
 // clang-format on
 #include <preseg_passes/move_split_cat.h>
 
+#include <algorithm>
+#include <optional>
 #include <vector>
 
 #include <fusion.h>
@@ -16,6 +18,7 @@
 #include <ir/internal_base_nodes.h>
 #include <ir/utils.h>
 #include <ops/alias.h>
+#include <ops/arith.h>
 #include <transform_replay.h>
 
 namespace nvfuser::preseg_passes {
@@ -482,10 +485,181 @@ void CancelSplitCat::run() {
   }
 }
 
+// Returns the range of `slice` along `axis` if `slice` only slices that axis
+// with a unit step. Returns std::nullopt otherwise.
+std::optional<Slice> getSliceRangeOfOnlyAxis(SliceOp* slice, int64_t axis) {
+  const std::vector<Slice>& ranges = slice->getRanges();
+  if (std::any_of(ranges.begin(), ranges.end(), [](const Slice& range) {
+        return !range.step->isOne();
+      })) {
+    return std::nullopt;
+  }
+  const std::vector<IterDomain*>& root = slice->out()->getRootDomain();
+  const std::vector<IterDomain*>& rfactor =
+      slice->out()->getMaybeRFactorDomain();
+  for (auto i : c10::irange(static_cast<int64_t>(root.size()))) {
+    if ((i == axis) != (root[i] != rfactor[i])) {
+      return std::nullopt;
+    }
+  }
+  return ranges[axis];
+}
+
+// Walks up from `pad` through unary ops to a slice. Returns the slice and
+// puts the unary ops in between into `chain` in def-use order. Returns null
+// if anything else is in between.
+SliceOp* findSliceThroughUnaryOps(PadOp* pad, std::vector<Expr*>& chain) {
+  Expr* e = pad->in()->definition();
+  while (e != nullptr && e->isA<UnaryOp>()) {
+    chain.push_back(e);
+    e = e->input(0)->definition();
+  }
+  std::reverse(chain.begin(), chain.end());
+  return dynamic_cast<SliceOp*>(e);
+}
+
+// Rewrites the half rotation used by rotary position embeddings, i.e.,
+//
+//   lo = in[..., :h]
+//   hi = in[..., h:]
+//   out = cat([f(hi), g(lo)], dim=-1)
+//
+// where f and g are chains of unary ops, e.g., a negation, into
+//
+//   hi = pad(in, [-h, h])     # hi[..., i] = in[..., i + h] for i < n - h
+//   lo = pad(in, [n - h, h - n])  # lo[..., i] = in[..., i + h - n] otherwise
+//   out = where(arange(n) < n - h, f(hi), g(lo))
+//
+// The concatenated dimension doesn't have to be the innermost. Unlike the
+// original pattern, which ends with a pad of an intermediate tensor for each
+// of the cat inputs, all resize ops here read `in` directly. When `in` is a
+// permute of a fusion input, as in benchmarks/python/test_rope.py, the pads
+// are moved above the permutes, so the whole rotation can be scheduled as one
+// pointwise kernel without enabling memory promotion.
+class RotateHalfCat {
+ public:
+  explicit RotateHalfCat(Fusion* fusion) : fusion_(fusion) {}
+
+  void run() {
+    std::vector<Expr*> exprs = fusion_->exprs();
+    for (auto* cat : ir_utils::filterByType<CatOp>(exprs)) {
+      rewrite(cat);
+    }
+  }
+
+ private:
+  void rewrite(CatOp* cat) {
+    if (cat->inputs().size() != 2) {
+      return;
+    }
+    const int64_t axis = cat->concatenatedDim();
+
+    std::vector<Expr*> hi_chain;
+    std::vector<Expr*> lo_chain;
+    SliceOp* hi = findSliceThroughUnaryOps(
+        cat->input(0)->definition()->as<PadOp>(), hi_chain);
+    SliceOp* lo = findSliceThroughUnaryOps(
+        cat->input(1)->definition()->as<PadOp>(), lo_chain);
+    if (hi == nullptr || lo == nullptr || hi->in() != lo->in()) {
+      return;
+    }
+
+    std::optional<Slice> hi_range = getSliceRangeOfOnlyAxis(hi, axis);
+    std::optional<Slice> lo_range = getSliceRangeOfOnlyAxis(lo, axis);
+    if (!hi_range.has_value() || !lo_range.has_value()) {
+      return;
+    }
+    // `lo` and `hi` have to split the dimension into two. See slicesFormSplit
+    // for why the stop of `hi` is checked via its Resize.
+    if (!lo_range->start->isZero() ||
+        !lo_range->stop->sameAs(hi_range->start) ||
+        !hi->out()
+             ->getMaybeRFactorDomain()[axis]
+             ->definition()
+             ->as<Resize>()
+             ->rightExpand()
+             ->isZero()) {
+      return;
+    }
+
+    // Find the fusion input `in` is permuted from.
+    TensorView* base = hi->in();
+    int64_t base_axis = axis;
+    std::vector<Expr*> permutes;
+    while (!base->isFusionInput()) {
+      auto* set = dynamic_cast<LoadStoreOp*>(base->definition());
+      if (set == nullptr || set->opType() != LoadStoreOpType::Set ||
+          !set->in()->isA<TensorView>()) {
+        return;
+      }
+      const std::vector<IterDomain*>& root = base->getRootDomain();
+      IterDomain* id =
+          TensorDomain::noReductions(base->getMaybeRFactorDomain())[base_axis];
+      auto it = std::find(root.begin(), root.end(), id);
+      if (it == root.end()) {
+        return;
+      }
+      base_axis = std::distance(root.begin(), it);
+      permutes.push_back(set);
+      base = set->in()->as<TensorView>();
+    }
+    std::reverse(permutes.begin(), permutes.end());
+
+    FusionGuard fg(fusion_);
+    Val* extent = SimplifyingIrBuilder::maybeCastExpr(
+        DataType::Index,
+        TensorDomain::noReductions(hi->in()->getMaybeRFactorDomain())[axis]
+            ->extent());
+    Val* shift = hi_range->start;
+    Val* rest = SimplifyingIrBuilder::subExpr(extent, shift);
+
+    // Shifts `base` along `base_axis` by padding one side and cutting the
+    // other, and replays `permutes` and `chain` on the result.
+    auto shifted =
+        [&](Val* left, Val* right, const std::vector<Expr*>& chain) -> Val* {
+      const auto ndims = static_cast<int64_t>(
+          TensorDomain::noReductions(base->getMaybeRFactorDomain()).size());
+      std::vector<Val*> pad_widths(ndims * 2, fusion_->zeroVal());
+      pad_widths[(ndims - 1 - base_axis) * 2] = left;
+      pad_widths[(ndims - 1 - base_axis) * 2 + 1] = right;
+      Val* out = pad(base, pad_widths);
+      for (Expr* e : permutes) {
+        out = replayExprWithNewInput(e, out)->output(0);
+      }
+      for (Expr* e : chain) {
+        out = replayExprWithNewInput(e, out)->output(0);
+      }
+      return out;
+    };
+    Val* rotated_hi =
+        shifted(SimplifyingIrBuilder::negExpr(shift), shift, hi_chain);
+    Val* rotated_lo =
+        shifted(rest, SimplifyingIrBuilder::negExpr(rest), lo_chain);
+
+    const auto out_ndims = static_cast<int64_t>(
+        TensorDomain::noReductions(hi->out()->getMaybeRFactorDomain()).size());
+    std::vector<bool> bcast_flags(out_ndims, true);
+    bcast_flags[axis] = false;
+    TensorView* in_hi = broadcast(
+        lt(iota(extent, fusion_->zeroVal(), fusion_->oneVal(), DataType::Index),
+           rest),
+        bcast_flags);
+    Val* merged_out = where(in_hi, rotated_hi, rotated_lo);
+
+    // Same as CancelSplitCat::run, `cat->output(0)` may be a fusion output
+    // with allocation domain, so it is redefined as a Set.
+    IrBuilder::create<LoadStoreOp>(
+        LoadStoreOpType::Set, cat->output(0), merged_out);
+  }
+
+  Fusion* fusion_;
+};
+
 } // namespace
 
 void MoveSplitCatPass::runPass(Fusion* fusion) {
   CancelSplitCat(fusion).run();
+  RotateHalfCat(fusion).run();
 }
 
 } // namespace nvfuser::preseg_passes
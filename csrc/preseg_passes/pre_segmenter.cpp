@@ -7,29 +7,66 @@
 // clang-format on
 #include <preseg_passes/pre_segmenter.h>
 
+#include <fusion_profiler.h>
 #include <instrumentation.h>
 #include <preseg_passes/add_axioms.h>
+#include <preseg_passes/algebraic_simplification.h>
 #include <preseg_passes/allocation_order_inference.h>
+#include <preseg_passes/common_subexpression_elimination.h>
 #include <preseg_passes/consecutive_cast.h>
 #include <preseg_passes/exact_mapped_extent_substitution.h>
 #include <preseg_passes/mark_aliases_prepare.h>
 #include <preseg_passes/move_split_cat.h>
+#include <preseg_passes/propagate_layout_ops.h>
+#include <preseg_passes/reduced_precision_pointwise.h>
 #include <preseg_passes/remove_empty.h>
+#include <preseg_passes/remove_unneeded_outputs.h>
+#include <preseg_passes/segment_static_subgraphs.h>
 
 namespace nvfuser::preseg_passes {
 
+namespace {
+
+// Runs a pass as its own compile step
+template <typename Pass>
+void runProfiledPass(Fusion* fusion, const char* name) {
+  CompileStepScope step(name);
+  OptimizationPass<Pass>::runPass(fusion);
+}
+
+} // namespace
+
 /*static*/ void PreSegmenter::runPass(Fusion* fusion) {
   FUSER_PERF_SCOPE("PreSegmenter::runPass");
+  CompileStepScope step("PreSegmenter");
 
+  // Drop outputs the caller doesn't need, so that no pass works on dead code
+  runProfiledPass<RemoveUnneededOutputsPass>(
+      fusion, "RemoveUnneededOutputsPass");
   // Replace TensorViews with zero extent. Outputs and inputs may still be empty
-  OptimizationPass<RemoveEmptyPass>::runPass(fusion);
+  runProfiledPass<RemoveEmptyPass>(fusion, "RemoveEmptyPass");
   // removes consecutive cast operations
-  OptimizationPass<ConsecutiveCastPass>::runPass(fusion);
-  OptimizationPass<AddAxiomsPass>::runPass(fusion);
-  OptimizationPass<MoveSplitCatPass>::runPass(fusion);
-  OptimizationPass<MarkAliasesPreparePass>::runPass(fusion);
-  OptimizationPass<ExactMappedExtentSubstitutionPass>::runPass(fusion);
-  OptimizationPass<AllocationDomainPass>::runPass(fusion);
+  runProfiledPass<ConsecutiveCastPass>(fusion, "ConsecutiveCastPass");
+  // computes half and bfloat16 pointwise chains without upcasting
+  runProfiledPass<ReducedPrecisionPointwisePass>(
+      fusion, "ReducedPrecisionPointwisePass");
+  // moves permutes and reshapes toward the fusion inputs
+  runProfiledPass<PropagateLayoutOpsPass>(fusion, "PropagateLayoutOpsPass");
+  // folds tensor-level identities like mul(x, 1) and permute(permute(x))
+  runProfiledPass<AlgebraicSimplificationPass>(
+      fusion, "AlgebraicSimplificationPass");
+  // deduplicates exprs computing the same value
+  runProfiledPass<CommonSubexpressionEliminationPass>(
+      fusion, "CommonSubexpressionEliminationPass");
+  runProfiledPass<AddAxiomsPass>(fusion, "AddAxiomsPass");
+  runProfiledPass<MoveSplitCatPass>(fusion, "MoveSplitCatPass");
+  // separates the subgraphs only depending on static inputs
+  runProfiledPass<SegmentStaticSubgraphsPass>(
+      fusion, "SegmentStaticSubgraphsPass");
+  runProfiledPass<MarkAliasesPreparePass>(fusion, "MarkAliasesPreparePass");
+  runProfiledPass<ExactMappedExtentSubstitutionPass>(
+      fusion, "ExactMappedExtentSubstitutionPass");
+  runProfiledPass<AllocationDomainPass>(fusion, "AllocationDomainPass");
 }
 
 } // namespace nvfuser::preseg_passes
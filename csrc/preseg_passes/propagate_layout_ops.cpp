@@ -0,0 +1,135 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <preseg_passes/propagate_layout_ops.h>
+
+#include <ir/utils.h>
+#include <ops/alias.h>
+#include <ops/utils.h>
+
+#include <functional>
+#include <optional>
+#include <vector>
+
+namespace nvfuser::preseg_passes {
+
+namespace {
+
+//! Returns the pointwise expr defining tv if a layout op of tv can be moved
+//! across it, i.e., if tv is only used by the layout op
+Expr* getMovableProducer(TensorView* tv) {
+  Expr* def = tv->definition();
+  if (def == nullptr || !def->isOneOf<UnaryOp, BinaryOp, TernaryOp>() ||
+      tv->isFusionOutput() || tv->uses().size() != 1) {
+    return nullptr;
+  }
+  return def;
+}
+
+//! Replaces the output of layout_op with the pointwise expr def applied to
+//! the layout op of each tensor input of def. make_layout_op creates a
+//! layout op of a tensor input, or returns nullptr if it can't.
+bool moveAcross(
+    Expr* layout_op,
+    Expr* def,
+    const std::function<TensorView*(TensorView*)>& make_layout_op) {
+  Val* layout_out = layout_op->output(0);
+  if (layout_out->isFusionOutput() &&
+      layout_out->fusion()->getOutputAlias(layout_out).type !=
+          AllocationType::New) {
+    return false;
+  }
+
+  std::vector<Val*> new_inputs;
+  new_inputs.reserve(def->inputs().size());
+  for (auto inp : def->inputs()) {
+    auto inp_tv = dynamic_cast<TensorView*>(inp);
+    if (inp_tv == nullptr) {
+      new_inputs.push_back(inp);
+      continue;
+    }
+    TensorView* new_inp = make_layout_op(inp_tv);
+    if (new_inp == nullptr) {
+      return false;
+    }
+    new_inputs.push_back(new_inp);
+  }
+
+  TensorView* new_out =
+      ops::newOutputTV(new_inputs, def->output(0)->getDataType().value());
+  def->newObjectFunc()(
+      def->container(), new_inputs, {new_out}, def->attributes());
+  ir_utils::replaceValInAllExprInputsAndFusionOutputs(layout_out, new_out);
+  return true;
+}
+
+bool movePermute(Expr* expr) {
+  const std::optional<std::vector<int64_t>> new2old =
+      ir_utils::getPermuteNew2Old(expr);
+  if (!new2old.has_value()) {
+    return false;
+  }
+  Expr* def = getMovableProducer(expr->input(0)->as<TensorView>());
+  if (def == nullptr) {
+    return false;
+  }
+  // Check all inputs first, so that no dead permute is created
+  for (auto inp : ir_utils::filterByType<TensorView>(def->inputs())) {
+    if (TensorDomain::noReductions(inp->getMaybeRFactorDomain()).size() !=
+        new2old->size()) {
+      return false;
+    }
+  }
+  return moveAcross(expr, def, [&](TensorView* inp) {
+    return permute(inp, new2old.value());
+  });
+}
+
+bool moveReshape(Expr* expr) {
+  auto view_op = dynamic_cast<ViewOp*>(expr);
+  if (view_op == nullptr) {
+    return false;
+  }
+  Expr* def = getMovableProducer(view_op->in());
+  const std::optional<std::vector<int64_t>> in_sizes =
+      ir_utils::getConstSizes(view_op->in());
+  const std::optional<std::vector<int64_t>> out_sizes =
+      ir_utils::getConstSizes(view_op->out());
+  if (def == nullptr || !in_sizes.has_value() || !out_sizes.has_value()) {
+    return false;
+  }
+  for (auto inp : ir_utils::filterByType<TensorView>(def->inputs())) {
+    if (ir_utils::getConstSizes(inp) != in_sizes || inp->hasBroadcast()) {
+      return false;
+    }
+  }
+  return moveAcross(expr, def, [&](TensorView* inp) {
+    return reshape(inp, in_sizes.value(), out_sizes.value());
+  });
+}
+
+} // namespace
+
+void PropagateLayoutOpsPass::runPass(Fusion* fusion) {
+  FusionGuard fg(fusion);
+
+  // Each move takes a layout op one expr closer to the fusion inputs, so
+  // this terminates. Traversal restarts after every move since the moved
+  // exprs are replaced.
+  bool moved = true;
+  while (moved) {
+    moved = false;
+    for (auto expr : fusion->exprs()) {
+      if (movePermute(expr) || moveReshape(expr)) {
+        moved = true;
+        break;
+      }
+    }
+  }
+}
+
+} // namespace nvfuser::preseg_passes
@@ -0,0 +1,32 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <preseg_passes/optimization_pass.h>
+#include <visibility.h>
+
+namespace nvfuser::preseg_passes {
+
+//! PropagateLayoutOpsPass moves permutes and static reshapes across the
+//! pointwise exprs producing their inputs, toward the fusion inputs:
+//!
+//!   permute(add(x, y)) -> add(permute(x), permute(y))
+//!
+//! This way, transposes of a chain either meet and cancel, which
+//! AlgebraicSimplificationPass then folds, or land on the fusion inputs,
+//! leaving the rest of the graph to the pointwise scheduler. A layout op is
+//! only moved if the pointwise expr has no other use, so that no computation
+//! is duplicated. Reshapes are only moved if every tensor input has the same
+//! static shape and no broadcast.
+class NVF_API PropagateLayoutOpsPass
+    : public OptimizationPass<PropagateLayoutOpsPass> {
+  friend class OptimizationPass<PropagateLayoutOpsPass>;
+
+ protected:
+  static void runPass(Fusion* fusion);
+};
+
+} // namespace nvfuser::preseg_passes
@@ -0,0 +1,111 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <preseg_passes/reduced_precision_pointwise.h>
+
+#include <ir/builder.h>
+#include <ir/utils.h>
+#include <ops/utils.h>
+#include <options.h>
+
+#include <vector>
+
+namespace nvfuser::preseg_passes {
+
+namespace {
+
+//! Returns the input of val if it is a cast of a tensor of dtype
+TensorView* getUpcastInput(Val* val, DataType dtype) {
+  auto uop = dynamic_cast<UnaryOp*>(val->definition());
+  if (uop == nullptr || uop->getUnaryOpType() != UnaryOpType::Cast ||
+      !uop->in()->isA<TensorView>() || uop->in()->dtype() != dtype) {
+    return nullptr;
+  }
+  return uop->in()->as<TensorView>();
+}
+
+bool isReducibleOp(Expr* expr) {
+  auto bop = dynamic_cast<BinaryOp*>(expr);
+  if (bop == nullptr || !bop->lhs()->isA<TensorView>() ||
+      !bop->rhs()->isA<TensorView>()) {
+    return false;
+  }
+  switch (bop->getBinaryOpType()) {
+    case BinaryOpType::Add:
+    case BinaryOpType::Sub:
+    case BinaryOpType::Mul:
+      return true;
+    default:
+      return false;
+  }
+}
+
+//! Whether the Float tensor val is computed by reducible ops from tensors
+//! upcast from dtype. Leaves may have other uses, as they are only read, but
+//! the intermediate results are replaced, so they must not.
+bool isReducibleChain(Val* val, DataType dtype) {
+  if (val->dtype() != DataType::Float) {
+    return false;
+  }
+  if (getUpcastInput(val, dtype) != nullptr) {
+    return true;
+  }
+  if (val->isFusionOutput() || val->uses().size() != 1 ||
+      !isReducibleOp(val->definition())) {
+    return false;
+  }
+  auto bop = val->definition()->as<BinaryOp>();
+  return isReducibleChain(bop->lhs(), dtype) &&
+      isReducibleChain(bop->rhs(), dtype);
+}
+
+//! Recomputes the reducible chain of val in dtype
+Val* rebuildChain(Val* val, DataType dtype) {
+  if (auto in = getUpcastInput(val, dtype)) {
+    return in;
+  }
+  auto bop = val->definition()->as<BinaryOp>();
+  auto lhs = rebuildChain(bop->lhs(), dtype);
+  auto rhs = rebuildChain(bop->rhs(), dtype);
+  auto out = ops::newOutputTV({lhs, rhs}, dtype);
+  IrBuilder::create<BinaryOp>(bop->getBinaryOpType(), out, lhs, rhs);
+  return out;
+}
+
+} // namespace
+
+void ReducedPrecisionPointwisePass::runPass(Fusion* fusion) {
+  if (!isOptionEnabled(EnableOption::ReducedPrecisionPointwise)) {
+    return;
+  }
+  // The exprs of replaced chains stay in the copy, but are no longer
+  // downcasts of reducible chains since their outputs have no uses
+  std::vector<Expr*> exprs = fusion->exprs();
+  for (auto expr : exprs) {
+    auto uop = dynamic_cast<UnaryOp*>(expr);
+    if (uop == nullptr || uop->getUnaryOpType() != UnaryOpType::Cast ||
+        !uop->out()->isA<TensorView>()) {
+      continue;
+    }
+    auto out = uop->out()->as<TensorView>();
+    DataType dtype = out->dtype();
+    if ((dtype != DataType::Half && dtype != DataType::BFloat16) ||
+        out->hasAllocation()) {
+      continue;
+    }
+    // A single cast is left to ConsecutiveCastPass, so the chain needs at
+    // least one op
+    Val* in = uop->in();
+    if (!isReducibleOp(in->definition()) || !isReducibleChain(in, dtype)) {
+      continue;
+    }
+    ir_utils::replaceValInAllExprInputsAndFusionOutputs(
+        out, rebuildChain(in, dtype));
+  }
+}
+
+} // namespace nvfuser::preseg_passes
@@ -0,0 +1,32 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <preseg_passes/optimization_pass.h>
+#include <visibility.h>
+
+namespace nvfuser::preseg_passes {
+
+//! ReducedPrecisionPointwisePass computes chains of additions, subtractions
+//! and multiplications of half or bfloat16 tensors whose result is cast back
+//! to the same type in that type, e.g.,
+//!
+//!   T2 = castOp(Half, mul(add(castOp(Float, T0), castOp(Float, T1)),
+//!                         castOp(Float, T0)))
+//!
+//! becomes T2 = mul(add(T0, T1), T0) of Half tensors, which removes the
+//! conversions from the generated kernel. The results are rounded after each
+//! op instead of once, so the pass only runs if
+//! EnableOption::ReducedPrecisionPointwise is set.
+class NVF_API ReducedPrecisionPointwisePass
+    : public OptimizationPass<ReducedPrecisionPointwisePass> {
+  friend class OptimizationPass<ReducedPrecisionPointwisePass>;
+
+ protected:
+  static void runPass(Fusion* fusion);
+};
+
+} // namespace nvfuser::preseg_passes
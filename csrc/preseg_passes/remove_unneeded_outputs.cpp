@@ -0,0 +1,76 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <preseg_passes/remove_unneeded_outputs.h>
+
+#include <fusion.h>
+
+#include <algorithm>
+#include <any>
+
+namespace nvfuser::preseg_passes {
+
+namespace {
+
+// Output indices are kept instead of the outputs themselves, since
+// concretization may replace the outputs, but not reorder them.
+const std::string unneeded_outputs_key = "unneeded_outputs";
+
+} // namespace
+
+/*static*/ void RemoveUnneededOutputsPass::markUnneededOutputs(
+    Fusion* fusion,
+    std::vector<int64_t> output_indices) {
+  std::sort(output_indices.begin(), output_indices.end());
+  output_indices.erase(
+      std::unique(output_indices.begin(), output_indices.end()),
+      output_indices.end());
+  for (auto index : output_indices) {
+    NVF_CHECK(
+        index >= 0 && index < (int64_t)fusion->outputs().size(),
+        "Invalid output index: ",
+        index);
+    Val* out = fusion->outputs().at(index);
+    NVF_CHECK(
+        fusion->getOutputAlias(out).type != AllocationType::ReuseBuffer,
+        "Output updating an input in place can't be marked unneeded: ",
+        out->toString());
+    NVF_CHECK(
+        std::count(fusion->outputs().begin(), fusion->outputs().end(), out) ==
+            1,
+        "Output listed more than once can't be marked unneeded: ",
+        out->toString());
+  }
+  NVF_CHECK(
+      output_indices.size() < fusion->outputs().size(),
+      "At least one output must be needed");
+
+  if (output_indices.empty()) {
+    fusion->stopManaging(unneeded_outputs_key);
+    return;
+  }
+  fusion->manage(
+      unneeded_outputs_key,
+      std::any(std::move(output_indices)),
+      [](IrCloner&, std::any data) { return data; });
+}
+
+void RemoveUnneededOutputsPass::runPass(Fusion* fusion) {
+  if (!fusion->hasManaged(unneeded_outputs_key)) {
+    return;
+  }
+  const auto output_indices =
+      fusion->getManaged<std::vector<int64_t>>(unneeded_outputs_key);
+  // The indices are sorted, so remove the outputs from the back
+  for (auto it = output_indices.rbegin(); it != output_indices.rend(); ++it) {
+    fusion->removeOutput(fusion->outputs().at(*it));
+  }
+  // The indices refer to the original outputs
+  fusion->stopManaging(unneeded_outputs_key);
+}
+
+} // namespace nvfuser::preseg_passes
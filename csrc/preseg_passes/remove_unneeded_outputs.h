@@ -0,0 +1,37 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <preseg_passes/optimization_pass.h>
+#include <visibility.h>
+
+#include <vector>
+
+namespace nvfuser::preseg_passes {
+
+//! RemoveUnneededOutputsPass removes the fusion outputs marked by
+//! markUnneededOutputs, e.g., outputs the caller of a traced fusion throws
+//! away. The exprs only computing those outputs become dead, so they are
+//! neither segmented nor scheduled, and fusion inputs only feeding them are
+//! no longer read. Outputs aliasing an input, i.e., updated in place, must be
+//! materialized and can't be marked.
+class NVF_API RemoveUnneededOutputsPass
+    : public OptimizationPass<RemoveUnneededOutputsPass> {
+  friend class OptimizationPass<RemoveUnneededOutputsPass>;
+
+ public:
+  //! Marks the outputs at output_indices of fusion as unneeded. The marks
+  //! survive fusion copies, and replace any previous marks. An empty
+  //! output_indices clears the marks.
+  static void markUnneededOutputs(
+      Fusion* fusion,
+      std::vector<int64_t> output_indices);
+
+ protected:
+  static void runPass(Fusion* fusion);
+};
+
+} // namespace nvfuser::preseg_passes
@@ -0,0 +1,141 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <preseg_passes/segment_static_subgraphs.h>
+
+#include <debug.h>
+#include <fusion.h>
+#include <ir/utils.h>
+#include <ops/alias.h>
+#include <options.h>
+
+#include <algorithm>
+#include <any>
+#include <unordered_set>
+
+namespace nvfuser::preseg_passes {
+
+namespace {
+
+// Input indices are kept instead of the inputs themselves, since
+// concretization may replace the inputs, but not reorder them.
+const std::string static_inputs_key = "static_inputs";
+
+// Vals that only depend on the static inputs. Scalars are static if they are
+// constants or extents of static inputs. Tensors must depend on at least one
+// static input, so that constant tensors like iota are not separated.
+std::unordered_set<Val*> getStaticVals(
+    Fusion* fusion,
+    const std::vector<int64_t>& input_indices) {
+  std::unordered_set<Val*> static_vals;
+  for (auto index : input_indices) {
+    auto tv = fusion->inputs().at(index)->as<TensorView>();
+    static_vals.insert(tv);
+    for (auto id : tv->getMaybeRFactorDomain()) {
+      static_vals.insert(id->extent());
+      if (id->hasExpandedExtent()) {
+        static_vals.insert(id->expandedExtent());
+      }
+    }
+  }
+
+  auto is_static = [&](Val* val) {
+    return val->isConstScalar() || static_vals.count(val) != 0;
+  };
+  for (Expr* expr : fusion->exprs()) {
+    if (expr->isA<RNGOp>() ||
+        !std::all_of(expr->inputs().begin(), expr->inputs().end(), is_static)) {
+      continue;
+    }
+    const bool has_static_tv_input = std::any_of(
+        expr->inputs().begin(), expr->inputs().end(), [](Val* inp) {
+          return inp->isA<TensorView>();
+        });
+    for (auto out : expr->outputs()) {
+      if (!out->isA<TensorView>() || has_static_tv_input) {
+        static_vals.insert(out);
+      }
+    }
+  }
+  return static_vals;
+}
+
+} // namespace
+
+/*static*/ void SegmentStaticSubgraphsPass::markStaticInputs(
+    Fusion* fusion,
+    std::vector<int64_t> input_indices) {
+  std::sort(input_indices.begin(), input_indices.end());
+  input_indices.erase(
+      std::unique(input_indices.begin(), input_indices.end()),
+      input_indices.end());
+  for (auto index : input_indices) {
+    NVF_CHECK(
+        index >= 0 && index < (int64_t)fusion->inputs().size(),
+        "Invalid input index: ",
+        index);
+    NVF_CHECK(
+        fusion->inputs().at(index)->isA<TensorView>(),
+        "Only tensor inputs can be marked static: ",
+        fusion->inputs().at(index)->toString());
+  }
+
+  if (input_indices.empty()) {
+    fusion->stopManaging(static_inputs_key);
+    return;
+  }
+  fusion->manage(
+      static_inputs_key,
+      std::any(std::move(input_indices)),
+      [](IrCloner&, std::any data) { return data; });
+}
+
+/*static*/ std::vector<int64_t> SegmentStaticSubgraphsPass::getStaticInputs(
+    Fusion* fusion) {
+  if (!fusion->hasManaged(static_inputs_key)) {
+    return {};
+  }
+  return fusion->getManaged<std::vector<int64_t>>(static_inputs_key);
+}
+
+void SegmentStaticSubgraphsPass::runPass(Fusion* fusion) {
+  const std::vector<int64_t> input_indices = getStaticInputs(fusion);
+  if (input_indices.empty()) {
+    return;
+  }
+  const std::unordered_set<Val*> static_vals =
+      getStaticVals(fusion, input_indices);
+
+  for (TensorView* tv : ir_utils::allTvs(fusion)) {
+    if (static_vals.count(tv) == 0 || tv->isFusionInput()) {
+      continue;
+    }
+    std::vector<Expr*> dynamic_uses;
+    for (Expr* use : tv->uses()) {
+      if (std::any_of(
+              use->outputs().begin(), use->outputs().end(), [&](Val* out) {
+                return static_vals.count(out) == 0;
+              })) {
+        dynamic_uses.push_back(use);
+      }
+    }
+    if (dynamic_uses.empty()) {
+      continue;
+    }
+    TensorView* copy = segment_set(tv);
+    for (Expr* use : dynamic_uses) {
+      ir_utils::replaceValInExprInputs(use, tv, copy);
+    }
+  }
+
+  if (isDebugDumpEnabled(DebugDumpOption::PreSegmenterLogging)) {
+    debug() << "Fusion after SegmentStaticSubgraphsPass:" << std::endl;
+    fusion->printMath();
+  }
+}
+
+} // namespace nvfuser::preseg_passes
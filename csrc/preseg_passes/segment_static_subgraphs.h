@@ -0,0 +1,43 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <preseg_passes/optimization_pass.h>
+#include <visibility.h>
+
+#include <vector>
+
+namespace nvfuser::preseg_passes {
+
+//! SegmentStaticSubgraphsPass separates the tensors that only depend on the
+//! inputs marked by markStaticInputs, e.g., weights cast to bf16 or the rsqrt
+//! of a frozen running variance, from the rest of the fusion. Every use of
+//! such a tensor outside of its subgraph is replaced with a segment_set of
+//! it, so that the subgraph is segmented on its own and
+//! FusionKernelRuntime can reuse its outputs while the static inputs don't
+//! change. Tensors created by random ops are never static.
+class NVF_API SegmentStaticSubgraphsPass
+    : public OptimizationPass<SegmentStaticSubgraphsPass> {
+  friend class OptimizationPass<SegmentStaticSubgraphsPass>;
+
+ public:
+  //! Marks the tensor inputs at input_indices of fusion as static. The marks
+  //! survive fusion copies, and replace any previous marks. An empty
+  //! input_indices clears the marks.
+  static void markStaticInputs(
+      Fusion* fusion,
+      std::vector<int64_t> input_indices);
+
+  //! Sorted indices of the inputs marked by markStaticInputs
+  static std::vector<int64_t> getStaticInputs(Fusion* fusion);
+
+ protected:
+  static void runPass(Fusion* fusion);
+};
+
+} // namespace nvfuser::preseg_passes
@@ -21,7 +21,10 @@ namespace fs = std::filesystem;
 #ifdef _WIN32
 #include <c10/util/win32-headers.h>
 #else
+#include <fcntl.h>
 #include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 #endif
 
@@ -94,9 +97,67 @@ BinaryBuffer openFusionCache(std::string filename) {
   return buffer;
 }
 
+//! Contents of a FusionCache file. The file is memory mapped where
+//! supported, so that only the pages that are used are read.
+class FusionCacheFile {
+ public:
+  explicit FusionCacheFile(const std::string& filename) {
+#ifndef _WIN32
+    int fd = open(filename.c_str(), O_RDONLY);
+    struct stat file_stat;
+    if (fd != -1 && fstat(fd, &file_stat) == 0 && file_stat.st_size > 0) {
+      FUSER_PERF_SCOPE("Flatbuffers::mapFusionCache");
+      void* addr = mmap(
+          nullptr, (size_t)file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (addr != MAP_FAILED) {
+        data_ = static_cast<const uint8_t*>(addr);
+        size_ = (size_t)file_stat.st_size;
+        is_mapped_ = true;
+      }
+    }
+    if (fd != -1) {
+      close(fd);
+    }
+    if (is_mapped_) {
+      return;
+    }
+#endif // _WIN32
+    // openFusionCache reports why the file can't be read
+    buffer_ = openFusionCache(filename);
+    data_ = buffer_.data();
+    size_ = buffer_.size();
+  }
+
+  FusionCacheFile(const FusionCacheFile&) = delete;
+  FusionCacheFile& operator=(const FusionCacheFile&) = delete;
+
+  ~FusionCacheFile() {
+#ifndef _WIN32
+    if (is_mapped_) {
+      munmap(const_cast<uint8_t*>(data_), size_);
+    }
+#endif // _WIN32
+  }
+
+  const uint8_t* data() const {
+    return data_;
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+ private:
+  const uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+  bool is_mapped_ = false;
+  // Contents of the file if it can't be mapped
+  BinaryBuffer buffer_;
+};
+
 // This check function only throws errors if strict flag is enabled.
 const serde::FusionCache* verifyFusionCache(
-    const BinaryBuffer& buffer,
+    const FusionCacheFile& buffer,
     std::optional<int64_t> device_id) {
   FUSER_PERF_SCOPE("Flatbuffers::verifyFusionCache");
   auto fusion_cache_buffer = serde::GetFusionCache(buffer.data());
@@ -211,7 +272,10 @@ TrieNode::TrieNode(RecordFunctor* rec, TrieNode* _parent, size_t _fusion_id)
       fusion_id(_fusion_id),
       visits(0),
       parent(_parent),
-      trie_node_lock() {}
+      digest(_parent == nullptr ? 0 : _parent->digest),
+      trie_node_lock() {
+  hashCombine(digest, record->hash());
+}
 
 bool TrieNode::isTerminal() const {
   return (record.get()->recordType() == serde::RecordType::End);
@@ -294,6 +358,7 @@ FusionCache* FusionCache::get(
 }
 
 size_t FusionCache::numFusions() const {
+  std::lock_guard<std::mutex> guard(fusions_lock_);
   return fusions_.size();
 }
 
@@ -357,6 +422,16 @@ void FusionCache::stats(std::ostream& os) const {
     os << " Cache Hits: " << total_cache_hits;
     os << " Hit Rate: " << hit_rate << "%\n";
   }
+
+  auto runtime_stats = KernelRuntimeLru::get().stats();
+  os << "Kernel Runtime Hits: " << runtime_stats.hits;
+  os << " Misses: " << runtime_stats.misses;
+  os << " Evictions: " << runtime_stats.evictions << "\n";
+  os << "Kernel Runtime Memory: " << runtime_stats.memory_bytes << " bytes";
+  if (runtime_stats.memory_budget >= 0) {
+    os << " Budget: " << runtime_stats.memory_budget << " bytes";
+  }
+  os << "\n";
 }
 
 void FusionCache::reset() {
@@ -377,6 +452,7 @@ FusionCache::FusionCache(
       root_(nullptr),
       fusions_(),
       terminal_nodes_(),
+      terminal_digests_(),
       user_def_input_encodings_() {
   RecordFunctor* start = new StartRecord();
   root_ = std::make_unique<TrieNode>(start);
@@ -401,15 +477,78 @@ std::optional<TrieNode*> FusionCache::queryChildren(
   }
 }
 
+std::optional<TrieNode*> FusionCache::queryDefinition(
+    size_t digest,
+    const std::vector<std::unique_ptr<RecordFunctor>>& records,
+    RecordFunctor* end_record) {
+  NVF_CHECK(end_record, "Record is null!");
+  TrieNode* terminal = nullptr;
+  {
+    std::lock_guard<std::mutex> guard(terminal_digests_lock_);
+    auto it = terminal_digests_.find(digest);
+    if (it == terminal_digests_.end()) {
+      return std::nullopt;
+    }
+    terminal = it->second;
+  }
+
+  // Walk back up to the root to rule out a digest collision
+  if (!(*terminal->record == *end_record)) {
+    return std::nullopt;
+  }
+  TrieNode* node = terminal->parent;
+  for (auto it = records.rbegin(); it != records.rend(); ++it) {
+    if (node == nullptr || !(*node->record == **it)) {
+      return std::nullopt;
+    }
+    node = node->parent;
+  }
+  if (node != root_.get()) {
+    return std::nullopt;
+  }
+
+  // Count the visits the same way as a walk with queryChildren
+  for (node = terminal; node != root_.get(); node = node->parent) {
+    ++(node->visits);
+  }
+  return std::optional<TrieNode*>(terminal);
+}
+
 FusionSchedules* FusionCache::queryFusionSchedules(size_t fusion_id) const {
-  NVF_CHECK(
-      fusion_id < fusions_.size(),
-      "Invalid scheduler query for id:",
-      fusion_id);
-  FusionSchedules* ptr = fusions_.at(fusion_id).get();
+  FusionSchedules* ptr = nullptr;
+  {
+    std::lock_guard<std::mutex> guard(fusions_lock_);
+    NVF_CHECK(
+        fusion_id < fusions_.size(),
+        "Invalid scheduler query for id:",
+        fusion_id);
+    ptr = fusions_.at(fusion_id).get();
+  }
   NVF_CHECK(ptr != nullptr, "Unexpected null FusionSchedules object.");
+  if (ptr->lazy_deserialize) {
+    std::call_once(ptr->lazy_deserialize_once, ptr->lazy_deserialize);
+  }
   return ptr;
 }
+
+FusionExecutorCache* FusionCache::queryStitchedFusion(
+    const std::string& key,
+    const std::function<std::unique_ptr<Fusion>()>& stitch) {
+  std::lock_guard<std::mutex> guard(stitched_fusions_lock_);
+  auto it = stitched_fusions_.find(key);
+  if (it == stitched_fusions_.end()) {
+    std::unique_ptr<Fusion> fusion = stitch();
+    it = stitched_fusions_
+             .emplace(
+                 key,
+                 fusion == nullptr
+                     ? nullptr
+                     : std::make_unique<FusionExecutorCache>(std::move(fusion)))
+             .first;
+  }
+  return it->second.get();
+}
+
 std::optional<size_t> FusionCache::queryUserScheduleId(
     const FusionSchedules* scheds,
     const at::ArrayRef<c10::IValue>& inputs) {
@@ -456,6 +595,7 @@ TrieNode* FusionCache::createChild(TrieNode* node, RecordFunctor* rec) {
   } else {
     size_t fusion_id = 0;
     if (rec->recordType() == serde::RecordType::End) {
+      std::lock_guard<std::mutex> fusions_guard(fusions_lock_);
       NVF_CHECK(
           (fusions_.size() + 1) <= max_fusions_,
           "The number of fusions in nvfuser has exceeded ",
@@ -477,7 +617,9 @@ TrieNode* FusionCache::createChild(TrieNode* node, RecordFunctor* rec) {
     NVF_CHECK(child, "Created child of TrieNode should not be null!");
     ++(child->visits);
     if (rec->recordType() == serde::RecordType::End) {
-      terminal_nodes_.push_back(node->children[new_rec].get());
+      terminal_nodes_.push_back(child);
+      std::lock_guard<std::mutex> digests_guard(terminal_digests_lock_);
+      terminal_digests_.emplace(child->digest, child);
     }
     if (isDebugDumpEnabled(DebugDumpOption::PythonFrontendDebug)) {
       std::stringstream ss;
@@ -617,9 +759,11 @@ void FusionCache::deserialize(std::string filename) {
   NVF_CHECK(
       fusions_.empty(),
       "Deserialization is prohibited if FusionCache is already populated.");
-  const BinaryBuffer& buffer = openFusionCache(filename);
+  // The file is kept alive by the fusions that are deserialized lazily
+  auto buffer = std::make_shared<const FusionCacheFile>(filename);
   const serde::FusionCache* fusion_cache_buffer =
-      verifyFusionCache(buffer, device_id_);
+      verifyFusionCache(*buffer, device_id_);
+  const bool lazy = isOptionEnabled(EnableOption::LazySerde);
 
   // See table definition for FusionCache in serde/fusion_cache.fbs
   FUSER_PERF_SCOPE("FusionCache::deserialize");
@@ -655,6 +799,9 @@ void FusionCache::deserialize(std::string filename) {
   // terminal_nodes vector.
   std::vector<TrieNode*> bfs_order;
 
+  // FusionStates of the terminal nodes whose Fusion IR is built lazily
+  std::unordered_map<size_t, std::shared_ptr<FusionState>> terminal_states;
+
   // Starting from the root node, we build the Trie structure in breadth-first
   // (BFS) order.
   while (!queue.empty()) {
@@ -685,9 +832,14 @@ void FusionCache::deserialize(std::string filename) {
       NVF_CHECK(
           trie_ptr->fusion_id == fb_trie_node->fusion_id(),
           "The fusion id for this TrieNode should already be set.")
-      Fusion* fusion =
-          queryFusionSchedules(fb_trie_node->fusion_id())->preschedFusion();
-      state->buildFusionIr(fusion);
+      if (lazy) {
+        terminal_states.emplace(
+            fb_trie_node->fusion_id(), std::move(state_queue.front()));
+      } else {
+        Fusion* fusion =
+            queryFusionSchedules(fb_trie_node->fusion_id())->preschedFusion();
+        state->buildFusionIr(fusion);
+      }
     }
 
     // Table TrieNode => Field: children: [ulong]
@@ -727,11 +879,25 @@ void FusionCache::deserialize(std::string filename) {
     auto node_idx = fusion_cache_buffer->terminal_nodes()->Get(idx);
     auto trie_node = bfs_order.at(node_idx);
     terminal_nodes_.push_back(trie_node);
+    terminal_digests_.emplace(trie_node->digest, trie_node);
 
     auto fb_fec_node = fusion_cache_buffer->auto_gen_schedules()->Get(idx);
-    auto fusion_schedule = queryFusionSchedules(trie_node->fusion_id);
-
-    if (!isOptionDisabled(DisableOption::ParallelSerde)) {
+    auto fusion_schedule = fusions_.at(trie_node->fusion_id).get();
+
+    if (lazy) {
+      auto fusion_id = (int64_t)trie_node->fusion_id;
+      fusion_schedule->lazy_deserialize =
+          [buffer,
+           fb_fec_node,
+           fusion_id,
+           fusion_schedule,
+           state = terminal_states.at(trie_node->fusion_id)]() {
+            FUSER_PERF_SCOPE("FusionCache::deserializeFusionLazy");
+            state->buildFusionIr(fusion_schedule->preschedFusion());
+            fusion_schedule->auto_gen_schedules->deserialize(
+                fb_fec_node, fusion_id);
+          };
+    } else if (!isOptionDisabled(DisableOption::ParallelSerde)) {
       // Parallelize the deserialization of each FusionExecutorCache.
       getThreadPool()->run([=, &detect_exception_in_thread_pool]() {
         FUSER_PERF_SCOPE("FusionCache::deserializeFusionParallel");
@@ -751,7 +917,7 @@ void FusionCache::deserialize(std::string filename) {
     }
   }
 
-  if (!isOptionDisabled(DisableOption::ParallelSerde)) {
+  if (!lazy && !isOptionDisabled(DisableOption::ParallelSerde)) {
     // Wait until all fusion executor caches are deserialized
     getThreadPool()->waitWorkComplete();
     NVF_ERROR(
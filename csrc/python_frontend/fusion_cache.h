@@ -12,8 +12,12 @@
 #include <kernel_cache.h>
 #include <python_frontend/fusion_record.h>
 
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace nvfuser::python_frontend {
 
@@ -31,6 +35,9 @@ struct UserSchedule {
   int64_t fusion_id_ = -1;
   //! device ID for this user schedule
   int64_t device_id_ = -1;
+  //! Identifies the schedule function that produced this schedule, so a
+  //! later definition with the same schedule function can reuse it
+  std::optional<size_t> schedule_key_ = std::nullopt;
 };
 
 //! \struct FusionSchedules
@@ -57,6 +64,12 @@ struct FusionSchedules {
   std::mutex scheds_lock;
   //! ID of fusion in python frontend fusion cache
   int64_t fusion_id_ = -1;
+  //! Builds the prescheduled Fusion IR and deserializes auto_gen_schedules
+  //! the first time the fusion is queried, when the FusionCache was
+  //! deserialized with EnableOption::LazySerde. Set once by
+  //! FusionCache::deserialize, and run at most once successfully.
+  std::function<void()> lazy_deserialize;
+  std::once_flag lazy_deserialize_once;
 };
 
 //! \struct TrieNode
@@ -92,6 +105,9 @@ struct TrieNode {
   size_t visits;
   //! Parent node for printing
   TrieNode* parent;
+  //! Order-sensitive digest of the records from the root to this node, which
+  //! is the hashCombine of the digest of the parent and the record's hash
+  size_t digest;
   //! For thread-Safe locking of a node
   std::mutex trie_node_lock;
 };
@@ -109,11 +125,15 @@ struct TrieNode {
 //! of fusions that is checked to prevent a runaway case.
 //!
 //! \note
-//! Thread-Safety is assured by the Python GIL.  If a no-GIL python is used
-//! then further scrutiny needs to be applied to the mutexes used to limit
-//! acccess to the singleton pointer, node creation, and user schedule
-//! creation.  Otherwise, the Python GIL provides a natural thread based mutex
-//! that does not allow for multiple threads to interact.
+//! Thread-Safety of definitions is assured by the Python GIL.  If a no-GIL
+//! python is used then further scrutiny needs to be applied to the mutexes
+//! used to limit acccess to the singleton pointer, node creation, and user
+//! schedule creation.  Otherwise, the Python GIL provides a natural thread
+//! based mutex that does not allow for multiple threads to interact.
+//!
+//! Executions release the GIL, so queryFusionSchedules and numFusions are
+//! safe to call while other threads define new fusions, and user schedules
+//! are looked up and run under FusionSchedules::scheds_lock.
 
 class FusionCache {
   //! The constructor is private given the FusionCache is only constructed
@@ -156,6 +176,14 @@ class FusionCache {
   NVF_API std::optional<TrieNode*> queryChildren(
       TrieNode* node,
       RecordFunctor* rec) const;
+  //! Queries the terminal node of a complete definition with a single probe
+  //! by its digest. The records of the definition, excluding the start and
+  //! end records, are compared against the path to the terminal node so that
+  //! a digest collision results in a miss.
+  NVF_API std::optional<TrieNode*> queryDefinition(
+      size_t digest,
+      const std::vector<std::unique_ptr<RecordFunctor>>& records,
+      RecordFunctor* end_record);
   //! Query a Fusion's Schedules based on fusion id or cache id
   FusionSchedules* queryFusionSchedules(size_t fusion_id) const;
   //! Lookup the User Schedule Id and return null if one does not exist.
@@ -179,6 +207,13 @@ class FusionCache {
       int device);
   //! Get the root Trie ptr
   NVF_API TrieNode* rootTriePtr();
+  //! Thread-Safe: Query the executor of a fusion stitched from consecutive
+  //! lazy fusion calls, see LazyFusionQueue. stitch creates the fusion on
+  //! the first query of key. If it returns nullptr, the calls can't be
+  //! stitched, which is cached as well, and nullptr is returned.
+  NVF_API FusionExecutorCache* queryStitchedFusion(
+      const std::string& key,
+      const std::function<std::unique_ptr<Fusion>()>& stitch);
 
  private:
   //! The static pointer to the FusionCache
@@ -196,8 +231,21 @@ class FusionCache {
   std::unique_ptr<TrieNode> root_;
   //! A vector of nvFuser Fusion IR fusions.
   std::vector<std::unique_ptr<FusionSchedules>> fusions_;
+  //! Lock for fusions_, which grows while other threads execute fusions
+  mutable std::mutex fusions_lock_;
   //! A vector of Terminal trie nodes for Stats collection
   std::vector<TrieNode*> terminal_nodes_;
+  //! Terminal trie nodes by their digest for queryDefinition. On a
+  //! collision, the first terminal node is kept.
+  std::unordered_map<size_t, TrieNode*> terminal_digests_;
+  //! Lock for terminal_digests_, as terminal nodes may be created while
+  //! definitions are queried
+  std::mutex terminal_digests_lock_;
+  //! Executors of stitched lazy fusion calls by the key of the calls
+  std::unordered_map<std::string, std::unique_ptr<FusionExecutorCache>>
+      stitched_fusions_;
+  //! Lock for stitched_fusions_
+  std::mutex stitched_fusions_lock_;
 
   //! Items specifically to aid user defined schedules these data members
   //! are for the mechanics of user schedule usage and don't make sense as
@@ -5,12 +5,14 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 // clang-format on
+#include <c10/cuda/CUDAGuard.h>
 #include <debug.h>
 #include <instrumentation.h>
 #include <multidevice/communicator.h>
 #include <options.h>
 #include <python_frontend/fusion_cache.h>
 #include <python_frontend/fusion_definition.h>
+#include <python_frontend/fusion_replay.h>
 #include <scheduler/heuristic_types.h>
 #include <utils.h>
 #include <validator_utils.h>
@@ -40,6 +42,8 @@ const char* dtypeToPyString(PrimDataType t) {
       return "DataType.Int";
     case DataType::Int32:
       return "DataType.Int32";
+    case DataType::Int8:
+      return "DataType.Int8";
     case DataType::ComplexFloat:
       return "DataType.ComplexFloat";
     case DataType::ComplexDouble:
@@ -59,6 +63,7 @@ FusionDefinition::FusionDefinition(std::optional<size_t> id, size_t max_length)
       fusion_id_(id),
       fusion_cache_(FusionCache::get()),
       trie_node_(nullptr),
+      digest_(0),
       prev_fusion_(nullptr),
       user_sched_(nullptr),
       ops(this),
@@ -73,12 +78,46 @@ FusionDefinition* FusionDefinition::setupDefinition() {
   NVF_CHECK(max_length_ > 0, "Can't make a FusionDefinition with 0 records!");
   NVF_CHECK(!id().has_value(), "Fusion Schedule is already found!");
   trie_node_ = fusionCache()->rootTriePtr();
+  digest_ = trie_node_->digest;
   return this;
 }
 
+void FusionDefinition::walkTrie() {
+  FUSER_PERF_SCOPE("FusionDefinition::walkTrie");
+  trie_node_ = fusionCache()->rootTriePtr();
+  for (auto& record : recording_) {
+    auto child_node = fusionCache()->queryChildren(trie_node_, record.get());
+    // If the Record is found in the cache, the FusionDefinition and the Cache
+    // will not share Record given the Record had to be created in order to
+    // match it but it also already existed in the cache.
+    if (child_node.has_value()) {
+      if (isDebugDumpEnabled(DebugDumpOption::PythonFrontendDebug)) {
+        debug() << "\nFusionDefinition: Record (hash: 0x" << std::hex
+                << record->hash() << ") hit in Fusion Cache.\n";
+      }
+      trie_node_ = child_node.value();
+    } else {
+      if (isDebugDumpEnabled(DebugDumpOption::PythonFrontendDebug)) {
+        debug() << "\nFusionDefinition: Record (hash: 0x" << std::hex
+                << record->hash() << ") missed in Fusion Cache.\n";
+      }
+      trie_node_ = fusionCache()->createChild(trie_node_, record.get());
+    }
+  }
+}
+
 void FusionDefinition::finalizeDefinition() {
   FUSER_PERF_SCOPE("FusionDefinition::finalizeDefinition");
-  auto child_node = fusionCache()->queryChildren(trie_node_, end_record_.get());
+  // A definition that is already cached is found with a single probe by its
+  // digest. The trie is only walked record by record on a miss.
+  size_t digest = digest_;
+  hashCombine(digest, end_record_->hash());
+  auto child_node =
+      fusionCache()->queryDefinition(digest, recording_, end_record_.get());
+  if (!child_node.has_value()) {
+    walkTrie();
+    child_node = fusionCache()->queryChildren(trie_node_, end_record_.get());
+  }
   if (!child_node.has_value()) {
     if (isDebugDumpEnabled(DebugDumpOption::PythonFrontendDebug)) {
       debug() << "\nFusionDefinition: Terminal Node not found.\n";
@@ -105,7 +144,9 @@ void FusionDefinition::finalizeDefinition() {
   }
 }
 
-void FusionDefinition::setupSchedule(const at::ArrayRef<c10::IValue>& inputs) {
+void FusionDefinition::setupSchedule(
+    const at::ArrayRef<c10::IValue>& inputs,
+    std::optional<size_t> schedule_key) {
   FUSER_PERF_SCOPE("FusionDefinition::setupSchedule");
   NVF_CHECK(id().has_value(), "FusionDefinition definition does not exist!");
   auto scheds = fusionCache()->queryFusionSchedules(id().value());
@@ -114,6 +155,7 @@ void FusionDefinition::setupSchedule(const at::ArrayRef<c10::IValue>& inputs) {
       inputs.empty() || device > -1, "Inputs are not all on the same device!");
   NVF_CHECK(user_sched_ == nullptr, "Expected User Scheduler to be null!");
   user_sched_ = fusionCache()->createUserSchedule(scheds, inputs, device);
+  user_sched_->schedule_key_ = schedule_key;
 
   // Building a new Fusion container for scheduling with definition such that
   // the definition's tensor data members refer to the corresponding IR objects
@@ -128,6 +170,33 @@ void FusionDefinition::setupSchedule(const at::ArrayRef<c10::IValue>& inputs) {
   FusionGuard::setCurFusion(user_sched_->schedule.get());
 }
 
+bool FusionDefinition::existSchedule(
+    const at::ArrayRef<c10::IValue>& inputs,
+    size_t schedule_key) {
+  FUSER_PERF_SCOPE("FusionDefinition::existSchedule");
+  NVF_CHECK(id().has_value(), "FusionDefinition definition does not exist!");
+  auto scheds = fusionCache()->queryFusionSchedules(id().value());
+  auto device = getCommonDeviceCUDA(inputs);
+  if (!inputs.empty() && device < 0) {
+    return false;
+  }
+  std::lock_guard<std::mutex> guard(scheds->scheds_lock);
+  auto user_sched_id = fusionCache()->queryUserScheduleId(scheds, inputs);
+  if (!user_sched_id.has_value()) {
+    return false;
+  }
+  const auto& user_scheds = scheds->user_def_schedules.at(*user_sched_id);
+  if (static_cast<size_t>(device) >= user_scheds.size()) {
+    return false;
+  }
+  // Multidevice schedules are executed by the MultiDeviceExecutor of the
+  // definition that made them, so their executors are never compiled and
+  // they are always rescheduled.
+  const auto& user_sched = user_scheds.at(device);
+  return user_sched.schedule_key_ == schedule_key &&
+      user_sched.executor != nullptr && user_sched.executor->isCompiled();
+}
+
 void FusionDefinition::finalizeSchedule(
     const at::ArrayRef<c10::IValue>& inputs) {
   FUSER_PERF_SCOPE("FusionDefinition::finalizeSchedule");
@@ -174,16 +243,25 @@ std::vector<at::Tensor> FusionDefinition::execute(
     const at::ArrayRef<c10::IValue>& inputs,
     bool override_user_schedule,
     bool capture_debug_output,
-    std::optional<int8_t> selected_device) const {
+    std::optional<int8_t> selected_device,
+    const std::vector<at::Tensor>& preallocated_outputs,
+    bool profile) const {
   debug_output_ = std::nullopt;
+  if (profile) {
+    profile_ = std::nullopt;
+  }
   std::stringstream debug_ss;
   DebugStreamGuard dsg(capture_debug_output ? debug_ss : std::cout);
 
   NVF_CHECK(id().has_value(), "Valid fusion schedule is not available!");
+  recordFusionReplayCall(id().value(), inputs);
 
   auto scheds = fusionCache()->queryFusionSchedules(id().value());
 
   if (multidevice_executor_) {
+    NVF_CHECK(
+        preallocated_outputs.empty(),
+        "Preallocated outputs are not supported for multidevice fusions");
     return multidevice_executor_->runWithInput(inputs.vec());
   }
 
@@ -196,13 +274,16 @@ std::vector<at::Tensor> FusionDefinition::execute(
     NVF_CHECK(
         inputs.empty() || device > -1,
         "Inputs are not all on the same device or don't match selection!");
+    // User schedules are not thread-safe, so concurrent executions of them
+    // are serialized
+    std::lock_guard<std::mutex> guard(scheds->scheds_lock);
     auto user_sched_id = fusionCache()->queryUserScheduleId(scheds, inputs);
     if (user_sched_id.has_value()) {
       auto& user_sched = fusionCache()->queryUserSchedule(
           scheds, user_sched_id.value(), device);
       scheds->last_user_def_scheduled_ir = user_sched.schedule.get();
       scheds->last_user_def_executor = user_sched.executor.get();
-      outputs = user_sched.executor->runFusion(inputs);
+      outputs = user_sched.executor->runFusion(inputs, preallocated_outputs);
     }
   }
 
@@ -210,8 +291,18 @@ std::vector<at::Tensor> FusionDefinition::execute(
   // already at this point and we would not want to overwrite generated output
   // through user scheduled kernel.
   if (outputs.empty()) {
+    // The profiler is enabled for the duration of the execution. As it is a
+    // singleton, other fusions must not be executed concurrently.
+    std::optional<ProfilerOptionsGuard> profiler_guard;
+    if (profile) {
+      profiler_guard.emplace();
+      ProfilerOptionsGuard::getCurOptions().set(ProfilerOption::Enable);
+    }
     outputs = scheds->auto_gen_schedules->runFusionWithInputs(
-        inputs, std::nullopt, selected_device);
+        inputs, std::nullopt, selected_device, preallocated_outputs);
+    if (profile) {
+      profile_ = FusionProfiler::profile();
+    }
   }
 
   if (capture_debug_output) {
@@ -221,6 +312,92 @@ std::vector<at::Tensor> FusionDefinition::execute(
   return outputs;
 }
 
+const FusionProfile& FusionDefinition::profile() const {
+  NVF_CHECK(
+      profile_.has_value(),
+      "No profile is available! Execute the fusion with profile=True. User ",
+      "schedules are not profiled.");
+  return profile_.value();
+}
+
+FusionFuture FusionDefinition::executeAsync(
+    const at::ArrayRef<c10::IValue>& inputs,
+    c10::cuda::CUDAStream stream) const {
+  NVF_CHECK(id().has_value(), "Valid fusion schedule is not available!");
+  NVF_CHECK(
+      multidevice_executor_ == nullptr,
+      "Asynchronous execution is not supported for multidevice fusions");
+  recordFusionReplayCall(id().value(), inputs);
+  auto scheds = fusionCache()->queryFusionSchedules(id().value());
+
+  // Kernels and the outputs' allocations are issued on the current stream
+  c10::cuda::CUDAStreamGuard stream_guard(stream);
+  auto outputs = scheds->auto_gen_schedules->runFusionWithInputs(
+      inputs,
+      std::nullopt,
+      (int8_t)stream.device_index(),
+      /*preallocated_outputs=*/{},
+      /*async_compile=*/true);
+  auto event = std::make_shared<at::cuda::CUDAEvent>();
+  event->record(stream);
+  return FusionFuture(std::move(outputs), std::move(event));
+}
+
+FusionFuture::FusionFuture(
+    std::vector<at::Tensor> outputs,
+    std::shared_ptr<at::cuda::CUDAEvent> event)
+    : outputs_(std::move(outputs)), event_(std::move(event)) {
+  NVF_ERROR(event_ != nullptr, "CUDAEvent is null!");
+}
+
+bool FusionFuture::done() const {
+  return event_->query();
+}
+
+const std::vector<at::Tensor>& FusionFuture::result() const {
+  event_->synchronize();
+  return outputs_;
+}
+
+void FusionFuture::waitOn(c10::cuda::CUDAStream stream) const {
+  event_->block(stream);
+}
+
+FusionHandle FusionDefinition::handle() const {
+  NVF_CHECK(id().has_value(), "Valid fusion schedule is not available!");
+  NVF_CHECK(
+      multidevice_executor_ == nullptr,
+      "Fusion handles are not supported for multidevice fusions");
+  auto scheds = fusionCache()->queryFusionSchedules(id().value());
+  return FusionHandle(id().value(), scheds->auto_gen_schedules.get());
+}
+
+FusionHandle::FusionHandle(
+    size_t fusion_id,
+    FusionExecutorCache* executor_cache)
+    : fusion_id_(fusion_id), executor_cache_(executor_cache) {
+  NVF_ERROR(executor_cache_ != nullptr, "FusionExecutorCache is null!");
+}
+
+std::vector<at::Tensor> FusionHandle::execute(
+    const at::ArrayRef<c10::IValue>& inputs,
+    std::optional<int8_t> device,
+    const std::vector<at::Tensor>& outputs) const {
+  return executor_cache_->runFusionWithInputs(
+      inputs, std::nullopt, device, outputs);
+}
+
+size_t FusionDefinition::precompile(
+    const std::vector<std::vector<c10::IValue>>& inputs_list,
+    std::optional<int8_t> selected_device) const {
+  NVF_CHECK(id().has_value(), "Valid fusion schedule is not available!");
+  NVF_CHECK(
+      multidevice_executor_ == nullptr,
+      "Precompiling is not supported for multidevice fusions");
+  auto scheds = fusionCache()->queryFusionSchedules(id().value());
+  return scheds->auto_gen_schedules->precompile(inputs_list, selected_device);
+}
+
 std::string FusionDefinition::fusionIr() {
   NVF_CHECK(id().has_value(), "Invalid fusion definition!");
   std::stringstream ss;
@@ -322,6 +499,15 @@ std::string FusionDefinition::scheduledFusionIrFor(
       inputs, tensor_transforms);
 }
 
+std::vector<LaunchConfigSweepResult> FusionDefinition::sweepLaunchConfigs(
+    const at::ArrayRef<c10::IValue>& inputs,
+    int64_t max_candidates) const {
+  NVF_CHECK(id().has_value(), "Invalid fusion definition!");
+  auto scheds = fusionCache()->queryFusionSchedules(id().value());
+  return scheds->auto_gen_schedules->sweepLaunchConfigs(
+      inputs, max_candidates);
+}
+
 std::optional<size_t> FusionDefinition::id() const {
   return fusion_id_;
 }
@@ -356,26 +542,8 @@ void FusionDefinition::defineRecord(RecordFunctor* record) {
       "operations.  The max_length for FusionDefintion's might need to be ",
       "increased if the definition is created as expected.");
   addRecord(record);
-  auto child_node =
-      fusionCache()->queryChildren(trie_node_, recording_.back().get());
-  // If the Record is found in the cache, the FusionDefinition and the Cache
-  // will not share Record given the Record had to be created in order to
-  // match it but it also already existed in the cache.
-  if (child_node.has_value()) {
-    if (isDebugDumpEnabled(DebugDumpOption::PythonFrontendDebug)) {
-      debug() << "\nFusionDefinition: Record (hash: 0x" << std::hex
-              << record->hash() << ") hit in Fusion Cache.\n";
-    }
-    trie_node_ = child_node.value();
-    // The FusionDefinition and the Cache will share the Record
-  } else {
-    if (isDebugDumpEnabled(DebugDumpOption::PythonFrontendDebug)) {
-      debug() << "\nFusionDefinition: Record (hash: 0x" << std::hex
-              << record->hash() << ") missed in Fusion Cache.\n";
-    }
-    trie_node_ =
-        fusionCache()->createChild(trie_node_, recording_.back().get());
-  }
+  // The trie is only queried when the definition is finalized
+  hashCombine(digest_, record->hash());
 }
 
 Fusion* FusionDefinition::preschedFusion() {
@@ -6,7 +6,10 @@
  */
 // clang-format on
 #pragma once
+#include <ATen/cuda/CUDAEvent.h>
+#include <c10/cuda/CUDAStream.h>
 #include <exceptions.h>
+#include <fusion_profiler.h>
 #include <iostream>
 
 #include <kernel_cache.h>
@@ -18,6 +21,8 @@ namespace nvfuser::python_frontend {
 
 class FusionCache;
 class FusionDefinition;
+class FusionFuture;
+class FusionHandle;
 class FusionInterface;
 class FusionState;
 struct RecordFunctor;
@@ -118,24 +123,56 @@ class NVF_API FusionDefinition : public FusionState {
   //! cached
   NVF_API void finalizeDefinition();
   //! Setup user scheduling of a fusion
-  //! Copies fusion object and sets up FusionGuard
-  NVF_API void setupSchedule(const at::ArrayRef<c10::IValue>& inputs);
+  //! Copies fusion object and sets up FusionGuard. The optional key
+  //! identifies the schedule function, see existSchedule.
+  NVF_API void setupSchedule(
+      const at::ArrayRef<c10::IValue>& inputs,
+      std::optional<size_t> schedule_key = std::nullopt);
+  //! Whether a compiled user schedule for the inputs, made by the schedule
+  //! function identified by schedule_key, already exists in the cache, in
+  //! which case scheduling the fusion again can be skipped
+  NVF_API bool existSchedule(
+      const at::ArrayRef<c10::IValue>& inputs,
+      size_t schedule_key);
   //! Finalized use scheduling of a fusion
   //! resets FusionGuard, lowers IR to a kernel, compiles kernel
   NVF_API void finalizeSchedule(const at::ArrayRef<c10::IValue>& inputs);
   //! Prints a python function representing the definition
   NVF_API void print(std::ostream& os) const;
-  //! Executes a fusion if a valid definition or cache lookup occurred prior
+  //! Executes a fusion if a valid definition or cache lookup occurred prior.
+  //! Results are written into outputs when it's not empty, see
+  //! FusionExecutorCache::runFusionWithInputs. With profile=true the
+  //! execution is profiled with the FusionProfiler, see profile().
   NVF_API std::vector<at::Tensor> execute(
       const at::ArrayRef<c10::IValue>& inputs,
       bool override_user_schedule,
       bool capture_debug_output,
+      std::optional<int8_t> device,
+      const std::vector<at::Tensor>& outputs = {},
+      bool profile = false) const;
+  //! Executes the auto-generated schedules of a fusion on stream without
+  //! waiting for the kernels to finish nor to be compiled. Kernel runtimes
+  //! that are not compiled yet are compiled in the background, see
+  //! EnableOption::AsyncCompile. User schedules are not supported.
+  NVF_API FusionFuture executeAsync(
+      const at::ArrayRef<c10::IValue>& inputs,
+      c10::cuda::CUDAStream stream) const;
+  //! Returns a handle that executes the auto-generated schedules of the
+  //! defined fusion directly, see FusionHandle.
+  NVF_API FusionHandle handle() const;
+  //! Compiles the auto-generated schedules for each of the given input sets
+  //! ahead of time. Returns the number of newly compiled kernel runtimes.
+  NVF_API size_t precompile(
+      const std::vector<std::vector<c10::IValue>>& inputs_list,
       std::optional<int8_t> device) const;
   //! Return debugging output captured through exeuction with
   //! capture_debug_output=true
   std::optional<std::string> getDebugOutput() const {
     return debug_output_;
   }
+  //! Return the profile of the last execution with profile=true. Only
+  //! auto-generated schedules are profiled.
+  NVF_API const FusionProfile& profile() const;
   // Returns the tolerances values based on reduction sizes.
   NVF_API std::vector<std::pair<double, double>> getValTolerances(
       const at::ArrayRef<c10::IValue>& inputs);
@@ -160,6 +197,12 @@ class NVF_API FusionDefinition : public FusionState {
       const at::ArrayRef<c10::IValue>& inputs,
       bool tensor_transforms,
       bool override_user_schedule) const;
+  //! Benchmarks the auto-generated schedules for the given inputs with up to
+  //! max_candidates heuristic parameters per segment, see
+  //! FusionExecutorCache::sweepLaunchConfigs
+  NVF_API std::vector<LaunchConfigSweepResult> sweepLaunchConfigs(
+      const at::ArrayRef<c10::IValue>& inputs,
+      int64_t max_candidates) const;
   //! Return fusion id of defined FusionDefinition
   NVF_API std::optional<size_t> id() const;
   //! Prints the Prescheduled Fusion IR representation
@@ -188,6 +231,9 @@ class NVF_API FusionDefinition : public FusionState {
   FusionCache* fusionCache() const;
   //! Return a prescheduled Fusion object
   Fusion* preschedFusion();
+  //! Walks the trie from the root record by record, creating the nodes of
+  //! the records that are missing
+  void walkTrie();
 
   //! Holds the defined maximum length of a FusionDefinition in order to
   //! prevent a run away error. The user should feel free to increase this
@@ -199,6 +245,9 @@ class NVF_API FusionDefinition : public FusionState {
   FusionCache* fusion_cache_;
   //! Current pointer to node in FusionCache.
   TrieNode* trie_node_;
+  //! Order-sensitive digest of the records defined so far, which matches
+  //! TrieNode::digest of the corresponding trie node.
+  size_t digest_;
 
   // Book keeping data members for user created schedules
 
@@ -241,6 +290,7 @@ class NVF_API FusionDefinition : public FusionState {
 
  private:
   mutable std::optional<std::string> debug_output_ = std::nullopt;
+  mutable std::optional<FusionProfile> profile_ = std::nullopt;
 
   //! The reason we have these is due to the lack of cache for multidevice
   //! executor. The assumption is that the same multidevice_executor can handle
@@ -249,4 +299,53 @@ class NVF_API FusionDefinition : public FusionState {
   mutable std::unique_ptr<MultiDeviceExecutor> multidevice_executor_;
 };
 
+//! The outputs of FusionDefinition::executeAsync, which are allocated in the
+//! order of the stream the fusion was executed on, and an event recorded on
+//! that stream after the fusion.
+class NVF_API FusionFuture {
+ public:
+  FusionFuture(
+      std::vector<at::Tensor> outputs,
+      std::shared_ptr<at::cuda::CUDAEvent> event);
+
+  //! Whether the fusion has finished executing
+  bool done() const;
+
+  //! Blocks until the fusion has finished executing and returns its outputs
+  const std::vector<at::Tensor>& result() const;
+
+  //! Makes stream wait for the fusion without blocking the host, so the
+  //! outputs can be used on stream
+  void waitOn(c10::cuda::CUDAStream stream) const;
+
+ private:
+  std::vector<at::Tensor> outputs_;
+  std::shared_ptr<at::cuda::CUDAEvent> event_;
+};
+
+//! A handle to the FusionExecutorCache of a defined fusion, so that a fusion
+//! that is executed many times skips the FusionDefinition, i.e. the replay
+//! of its records and the lookups in the FusionCache. It does not support
+//! user schedules nor multidevice fusions, and is invalidated by
+//! FusionCache::reset.
+class NVF_API FusionHandle {
+ public:
+  FusionHandle(size_t fusion_id, FusionExecutorCache* executor_cache);
+
+  //! Same as FusionDefinition::execute with the auto-generated schedules
+  std::vector<at::Tensor> execute(
+      const at::ArrayRef<c10::IValue>& inputs,
+      std::optional<int8_t> device,
+      const std::vector<at::Tensor>& outputs = {}) const;
+
+  //! Fusion id of the FusionDefinition the handle was created from
+  size_t id() const {
+    return fusion_id_;
+  }
+
+ private:
+  size_t fusion_id_;
+  FusionExecutorCache* executor_cache_;
+};
+
 } // namespace nvfuser::python_frontend
@@ -0,0 +1,210 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <ir/all_nodes.h>
+#include <options.h>
+#include <python_frontend/fusion_replay.h>
+
+#include <ATen/ATen.h>
+#include <c10/util/irange.h>
+
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+
+namespace nvfuser::python_frontend {
+
+namespace {
+
+void writeList(std::ostream& os, c10::IntArrayRef values) {
+  os << "[";
+  for (auto i : c10::irange(values.size())) {
+    os << (i > 0 ? "," : "") << values[i];
+  }
+  os << "]";
+}
+
+std::vector<int64_t> parseList(const std::string& text) {
+  NVF_CHECK(
+      text.size() >= 2 && text.front() == '[' && text.back() == ']',
+      "Invalid list in fusion replay log: ",
+      text);
+  std::vector<int64_t> values;
+  std::stringstream ss(text.substr(1, text.size() - 2));
+  std::string value;
+  while (std::getline(ss, value, ',')) {
+    values.push_back(std::stoll(value));
+  }
+  return values;
+}
+
+FusionReplayCall::Input parseInput(const std::string& text) {
+  FusionReplayCall::Input input;
+  if (text.empty() || text.front() != '[') {
+    input.value = text;
+    return input;
+  }
+  input.is_tensor = true;
+  std::string tensor = text;
+  const std::string cpu_suffix = "@cpu";
+  if (tensor.size() > cpu_suffix.size() &&
+      tensor.compare(
+          tensor.size() - cpu_suffix.size(), cpu_suffix.size(), cpu_suffix) ==
+          0) {
+    input.is_cpu = true;
+    tensor.resize(tensor.size() - cpu_suffix.size());
+  }
+  const auto colon = tensor.find(':');
+  NVF_CHECK(
+      colon != std::string::npos,
+      "Missing strides in fusion replay log: ",
+      text);
+  input.sizes = parseList(tensor.substr(0, colon));
+  input.strides = parseList(tensor.substr(colon + 1));
+  NVF_CHECK(
+      input.sizes.size() == input.strides.size(),
+      "Sizes and strides don't match in fusion replay log: ",
+      text);
+  return input;
+}
+
+c10::IValue makeScalar(DataType dtype, const std::string& value) {
+  if (isBooleanType(dtype)) {
+    return c10::IValue(value == "true");
+  }
+  if (isIntegralType(dtype)) {
+    return c10::IValue((int64_t)std::stoll(value));
+  }
+  if (isComplexType(dtype)) {
+    double real = 0.0;
+    double imag = 0.0;
+    char paren = 0;
+    char comma = 0;
+    std::stringstream ss(value);
+    ss >> paren >> real >> comma >> imag;
+    return c10::IValue(c10::complex<double>(real, imag));
+  }
+  return c10::IValue(std::stod(value));
+}
+
+} // namespace
+
+void recordFusionReplayCall(
+    size_t fusion_id,
+    const at::ArrayRef<c10::IValue>& inputs) {
+  if (!isOptionEnabled(EnableOption::FusionReplayLog)) {
+    return;
+  }
+  const auto& args = getEnableOptionArguments(EnableOption::FusionReplayLog);
+  NVF_CHECK(
+      !args.empty(),
+      "NVFUSER_ENABLE=fusion_replay_log needs the path of the log");
+
+  std::stringstream line;
+  line << fusion_id;
+  for (const auto& input : inputs) {
+    line << ";";
+    if (input.isTensor()) {
+      const auto& tensor = input.toTensor();
+      writeList(line, tensor.sizes());
+      line << ":";
+      writeList(line, tensor.strides());
+      if (tensor.is_cpu()) {
+        line << "@cpu";
+      }
+    } else if (input.isBool()) {
+      line << (input.toBool() ? "true" : "false");
+    } else if (input.isInt()) {
+      line << input.toInt();
+    } else if (input.isComplexDouble()) {
+      const auto value = input.toComplexDouble();
+      line << std::setprecision(17) << "(" << value.real() << ","
+           << value.imag() << ")";
+    } else if (input.isDouble()) {
+      line << std::setprecision(17) << input.toDouble();
+    } else {
+      NVF_CHECK(
+          false, "Unsupported input in fusion replay log: ", input.tagKind());
+    }
+  }
+  line << "\n";
+
+  static std::mutex log_mutex;
+  static std::ofstream log(args.at(0), std::ios::app);
+  std::lock_guard<std::mutex> guard(log_mutex);
+  NVF_CHECK(log.good(), "Could not write the fusion replay log ", args.at(0));
+  log << line.str() << std::flush;
+}
+
+std::vector<FusionReplayCall> readFusionReplayLog(const std::string& path) {
+  std::ifstream file(path);
+  NVF_CHECK(file.good(), "Could not open fusion replay log ", path);
+  std::vector<FusionReplayCall> calls;
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty()) {
+      continue;
+    }
+    std::stringstream ss(line);
+    std::string field;
+    std::getline(ss, field, ';');
+    FusionReplayCall call;
+    call.fusion_id = std::stoul(field);
+    while (std::getline(ss, field, ';')) {
+      call.inputs.push_back(parseInput(field));
+    }
+    calls.push_back(std::move(call));
+  }
+  return calls;
+}
+
+std::vector<c10::IValue> makeFusionReplayInputs(
+    Fusion* fusion,
+    const FusionReplayCall& call) {
+  NVF_CHECK(
+      fusion->inputs().size() == call.inputs.size(),
+      "Fusion ",
+      call.fusion_id,
+      " has ",
+      fusion->inputs().size(),
+      " inputs, but the replay log has ",
+      call.inputs.size());
+  std::vector<c10::IValue> inputs;
+  inputs.reserve(call.inputs.size());
+  for (auto i : c10::irange(call.inputs.size())) {
+    const auto& input = call.inputs.at(i);
+    const DataType dtype = fusion->inputs().at(i)->dtype();
+    if (!input.is_tensor) {
+      inputs.emplace_back(makeScalar(dtype, input.value));
+      continue;
+    }
+    auto options = at::TensorOptions().dtype(data_type_to_aten(dtype));
+    options = input.is_cpu ? options.device(at::kCPU)
+                           : options.device(at::kCUDA, 0);
+    // Expanded tensors overlap in memory, so the storage is filled before
+    // the strides are applied
+    int64_t storage_numel = 1;
+    for (auto dim : c10::irange(input.sizes.size())) {
+      if (input.sizes.at(dim) == 0) {
+        storage_numel = 0;
+        break;
+      }
+      storage_numel += (input.sizes.at(dim) - 1) * input.strides.at(dim);
+    }
+    at::Tensor storage = at::empty({storage_numel}, options);
+    if (isFloatingPointType(dtype) || isComplexType(dtype)) {
+      storage.normal_();
+    } else {
+      storage.zero_();
+    }
+    inputs.emplace_back(storage.as_strided(input.sizes, input.strides));
+  }
+  return inputs;
+}
+
+} // namespace nvfuser::python_frontend
@@ -0,0 +1,67 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+#include <exceptions.h>
+#include <visibility.h>
+
+#include <fusion.h>
+
+#include <ATen/core/ivalue.h>
+
+#include <string>
+#include <vector>
+
+namespace nvfuser::python_frontend {
+
+//! \struct FusionReplayCall
+//! \brief One execution of a fusion of a FusionCache, as recorded in a replay
+//! log. Only the metadata of the inputs is recorded, so a replay runs with
+//! synthetic data.
+//!
+//! With NVFUSER_ENABLE=fusion_replay_log(<path>), FusionDefinition::execute
+//! appends a line per execution to the log:
+//!
+//!   <fusion id>;<input>;<input>;...
+//!
+//! where a tensor input is [<sizes>]:[<strides>], followed by @cpu for a CPU
+//! tensor, and a scalar input is its value. The types of the inputs are those
+//! of the fusion definition. Together with the serialized FusionCache, the
+//! log reproduces the fusions of a model without its code, see
+//! benchmarks/cpp/fusion_replay.cpp.
+struct FusionReplayCall {
+  struct Input {
+    bool is_tensor = false;
+    std::vector<int64_t> sizes;
+    std::vector<int64_t> strides;
+    bool is_cpu = false;
+    //! Value of a scalar input
+    std::string value;
+  };
+
+  size_t fusion_id = 0;
+  std::vector<Input> inputs;
+};
+
+//! Appends an execution of the fusion of fusion_id to the replay log if
+//! EnableOption::FusionReplayLog is enabled. Thread-safe.
+void recordFusionReplayCall(
+    size_t fusion_id,
+    const at::ArrayRef<c10::IValue>& inputs);
+
+//! Reads the executions recorded in the replay log at path
+NVF_API std::vector<FusionReplayCall> readFusionReplayLog(
+    const std::string& path);
+
+//! Creates synthetic inputs of call for the prescheduled fusion. Floating
+//! point tensors are random and the others are zero, so that index inputs
+//! stay in bounds.
+NVF_API std::vector<c10::IValue> makeFusionReplayInputs(
+    Fusion* fusion,
+    const FusionReplayCall& call);
+
+} // namespace nvfuser::python_frontend
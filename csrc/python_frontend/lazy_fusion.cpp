@@ -0,0 +1,315 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <python_frontend/lazy_fusion.h>
+
+#include <ir/cloner.h>
+#include <ir/utils.h>
+#include <python_frontend/fusion_cache.h>
+#include <python_frontend/fusion_definition.h>
+
+#include <c10/util/irange.h>
+
+#include <sstream>
+#include <unordered_map>
+
+namespace nvfuser::python_frontend {
+
+namespace {
+
+// Whether the output of a fusion can feed the input of the next one
+bool canFeed(Val* output, Val* input) {
+  auto out_tv = dynamic_cast<TensorView*>(output);
+  auto in_tv = dynamic_cast<TensorView*>(input);
+  if (out_tv == nullptr || in_tv == nullptr ||
+      out_tv->dtype() != in_tv->dtype()) {
+    return false;
+  }
+  auto out_ids = TensorDomain::noReductions(out_tv->getMaybeRFactorDomain());
+  auto in_ids = TensorDomain::noReductions(in_tv->getMaybeRFactorDomain());
+  if (out_ids.size() != in_ids.size()) {
+    return false;
+  }
+  for (auto i : c10::irange(out_ids.size())) {
+    if (out_ids[i]->isBroadcast() != in_ids[i]->isBroadcast() ||
+        out_ids[i]->hasExpandedExtent() || in_ids[i]->hasExpandedExtent()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+std::unique_ptr<Fusion> stitchFusions(
+    const std::vector<Fusion*>& fusions,
+    const std::vector<std::vector<StitchedInput>>& inputs,
+    const std::vector<std::pair<int64_t, int64_t>>& outputs) {
+  NVF_ERROR(fusions.size() == inputs.size());
+  auto stitched = std::make_unique<Fusion>();
+
+  // The outputs of each fusion in the stitched fusion
+  std::vector<std::vector<Val*>> fusion_outputs;
+  // The extents of the inputs fed by earlier fusions, replaced with the
+  // extents of the outputs feeding them
+  std::unordered_map<Val*, Val*> extent_map;
+  for (auto i : c10::irange(fusions.size())) {
+    Fusion* fusion = fusions[i];
+    NVF_ERROR(fusion->inputs().size() == inputs[i].size());
+    if (!fusion->getPermutationInputMap().empty() ||
+        !fusion->getPermutationOutputMap().empty() ||
+        std::any_of(
+            fusion->outputs().begin(),
+            fusion->outputs().end(),
+            [&](Val* out) {
+              return fusion->getOutputAlias(out).type ==
+                  AllocationType::ReuseBuffer;
+            })) {
+      return nullptr;
+    }
+
+    IrCloner cloner(stitched.get());
+    for (Expr* expr : fusion->exprs()) {
+      cloner.clone(expr);
+    }
+
+    // Inputs fed by earlier fusions are replaced in their uses
+    std::unordered_map<Val*, Val*> fed_inputs;
+    for (auto j : c10::irange(inputs[i].size())) {
+      const StitchedInput& input = inputs[i][j];
+      Val* in = cloner.clone(fusion->inputs()[j]);
+      if (input.call < 0) {
+        stitched->addInput(in);
+        continue;
+      }
+      NVF_ERROR(input.call < (int64_t)i, "Inputs must come from earlier calls");
+      Val* out = fusion_outputs.at(input.call).at(input.output);
+      if (!canFeed(out, in)) {
+        return nullptr;
+      }
+      ir_utils::replaceValInAllExprInputsAndFusionOutputs(in, out);
+      fed_inputs.emplace(in, out);
+      auto out_ids = TensorDomain::noReductions(
+          out->as<TensorView>()->getMaybeRFactorDomain());
+      auto in_ids = TensorDomain::noReductions(
+          in->as<TensorView>()->getMaybeRFactorDomain());
+      for (auto k : c10::irange(in_ids.size())) {
+        if (!in_ids[k]->extent()->isConstScalar()) {
+          extent_map.emplace(in_ids[k]->extent(), out_ids[k]->extent());
+        }
+      }
+    }
+
+    std::vector<Val*> outs = cloner.clone(fusion->outputs());
+    for (auto& out : outs) {
+      if (auto it = fed_inputs.find(out); it != fed_inputs.end()) {
+        out = it->second;
+      }
+    }
+    fusion_outputs.push_back(std::move(outs));
+  }
+
+  for (const auto& [call, output] : outputs) {
+    stitched->addOutput(fusion_outputs.at(call).at(output));
+  }
+  // The extents of the replaced inputs may still be used, e.g., by the
+  // shapes of reshapes and factories
+  if (!extent_map.empty()) {
+    ir_utils::replaceValue(stitched.get(), extent_map);
+  }
+  return stitched;
+}
+
+LazyTensor::LazyTensor(
+    std::shared_ptr<LazyFusionQueue> queue,
+    int64_t call,
+    int64_t output)
+    : queue_(std::move(queue)), call_(call), output_(output) {}
+
+const at::Tensor& LazyTensor::result() {
+  // Flushing materializes the tensor and resets queue_. The queue is copied
+  // under mutex_, since a flush on another thread may reset it meanwhile.
+  if (std::shared_ptr<LazyFusionQueue> queue = this->queue()) {
+    queue->flush();
+  }
+  NVF_ERROR(materialized(), "The lazy tensor was not materialized");
+  return tensor_;
+}
+
+void LazyTensor::materialize(at::Tensor tensor) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  tensor_ = std::move(tensor);
+  queue_ = nullptr;
+}
+
+std::vector<std::shared_ptr<LazyTensor>> LazyFusionQueue::enqueue(
+    const FusionDefinition& fd,
+    const std::vector<LazyInput>& inputs) {
+  NVF_CHECK(fd.id().has_value(), "Valid fusion schedule is not available!");
+  FusionSchedules* scheds =
+      FusionCache::get()->queryFusionSchedules(fd.id().value());
+  return enqueue(fd.id().value(), scheds->auto_gen_schedules.get(), inputs);
+}
+
+std::vector<std::shared_ptr<LazyTensor>> LazyFusionQueue::enqueue(
+    size_t fusion_id,
+    FusionExecutorCache* executor_cache,
+    const std::vector<LazyInput>& inputs) {
+  NVF_ERROR(executor_cache != nullptr, "FusionExecutorCache is null!");
+  Fusion* fusion = executor_cache->fusion();
+  NVF_CHECK(
+      inputs.size() == fusion->inputs().size(),
+      "Expected ",
+      fusion->inputs().size(),
+      " inputs but got ",
+      inputs.size());
+
+  // Tensors of other queues are materialized before the lock is taken
+  std::vector<std::optional<c10::IValue>> values(inputs.size());
+  for (auto i : c10::irange(inputs.size())) {
+    if (const auto* value = std::get_if<c10::IValue>(&inputs[i])) {
+      values[i] = *value;
+    } else if (const auto& tensor = std::get<std::shared_ptr<LazyTensor>>(
+                   inputs[i]);
+               tensor->queue().get() != this) {
+      values[i] = tensor->result();
+    }
+  }
+
+  std::lock_guard<std::mutex> guard(mutex_);
+  Call call;
+  call.fusion_id = fusion_id;
+  call.executor_cache = executor_cache;
+  for (auto i : c10::irange(inputs.size())) {
+    std::shared_ptr<LazyTensor> tensor;
+    if (!values[i].has_value()) {
+      tensor = std::get<std::shared_ptr<LazyTensor>>(inputs[i]);
+      // Materialized by a flush since it was checked
+      if (tensor->materialized()) {
+        values[i] = tensor->tensor_;
+      }
+    }
+    if (values[i].has_value()) {
+      call.inputs.push_back({-1, (int64_t)call.values.size()});
+      call.values.push_back(*values[i]);
+      continue;
+    }
+    NVF_CHECK(
+        fusion->inputs()[i]->isA<TensorView>(),
+        "A lazy tensor can't be a scalar input");
+    call.inputs.push_back({tensor->call_, tensor->output_});
+  }
+
+  std::vector<std::shared_ptr<LazyTensor>> outputs;
+  for (auto i : c10::irange(fusion->outputs().size())) {
+    outputs.push_back(std::make_shared<LazyTensor>(
+        shared_from_this(), (int64_t)calls_.size(), (int64_t)i));
+    call.outputs.push_back(outputs.back());
+  }
+  calls_.push_back(std::move(call));
+  return outputs;
+}
+
+size_t LazyFusionQueue::numPendingCalls() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return calls_.size();
+}
+
+void LazyFusionQueue::flush() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (calls_.empty()) {
+    return;
+  }
+  std::vector<Call> calls = std::move(calls_);
+  calls_.clear();
+
+  // The outputs that are still referenced, which are materialized
+  std::vector<std::vector<std::shared_ptr<LazyTensor>>> live_outputs;
+  std::vector<std::pair<int64_t, int64_t>> stitched_outputs;
+  for (auto i : c10::irange(calls.size())) {
+    live_outputs.emplace_back();
+    for (auto j : c10::irange(calls[i].outputs.size())) {
+      live_outputs.back().push_back(calls[i].outputs[j].lock());
+      if (live_outputs.back().back() != nullptr) {
+        stitched_outputs.emplace_back(i, j);
+      }
+    }
+  }
+  // Nothing can observe the results
+  if (stitched_outputs.empty()) {
+    return;
+  }
+  if (calls.size() == 1) {
+    runEagerly(calls, live_outputs);
+    return;
+  }
+
+  std::stringstream key;
+  for (const auto& call : calls) {
+    key << call.fusion_id << "(";
+    for (const auto& input : call.inputs) {
+      key << input.call << ":" << (input.call < 0 ? 0 : input.output) << ",";
+    }
+    key << ")";
+  }
+  key << "->";
+  for (const auto& [call, output] : stitched_outputs) {
+    key << call << ":" << output << ",";
+  }
+
+  FusionExecutorCache* stitched_cache =
+      FusionCache::get()->queryStitchedFusion(key.str(), [&]() {
+        std::vector<Fusion*> fusions;
+        std::vector<std::vector<StitchedInput>> inputs;
+        for (const auto& call : calls) {
+          fusions.push_back(call.executor_cache->fusion());
+          inputs.push_back(call.inputs);
+        }
+        return stitchFusions(fusions, inputs, stitched_outputs);
+      });
+  if (stitched_cache == nullptr) {
+    runEagerly(calls, live_outputs);
+    return;
+  }
+
+  std::vector<c10::IValue> values;
+  for (const auto& call : calls) {
+    values.insert(values.end(), call.values.begin(), call.values.end());
+  }
+  std::vector<at::Tensor> results = stitched_cache->runFusionWithInputs(values);
+  NVF_ERROR(results.size() == stitched_outputs.size());
+  for (auto i : c10::irange(results.size())) {
+    const auto& [call, output] = stitched_outputs[i];
+    live_outputs[call][output]->materialize(std::move(results[i]));
+  }
+}
+
+void LazyFusionQueue::runEagerly(
+    const std::vector<Call>& calls,
+    const std::vector<std::vector<std::shared_ptr<LazyTensor>>>& outputs) {
+  std::vector<std::vector<at::Tensor>> results;
+  for (const auto& call : calls) {
+    std::vector<c10::IValue> values;
+    for (const auto& input : call.inputs) {
+      if (input.call < 0) {
+        values.push_back(call.values.at(input.output));
+      } else {
+        values.emplace_back(results.at(input.call).at(input.output));
+      }
+    }
+    results.push_back(call.executor_cache->runFusionWithInputs(values));
+  }
+  for (auto i : c10::irange(calls.size())) {
+    for (auto j : c10::irange(outputs[i].size())) {
+      if (outputs[i][j] != nullptr) {
+        outputs[i][j]->materialize(results[i].at(j));
+      }
+    }
+  }
+}
+
+} // namespace nvfuser::python_frontend
@@ -0,0 +1,163 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+#include <exceptions.h>
+#include <visibility.h>
+
+#include <fusion.h>
+#include <kernel_cache.h>
+
+#include <ATen/core/ivalue.h>
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace nvfuser::python_frontend {
+
+class FusionDefinition;
+class LazyFusionQueue;
+
+//! Where an input of a fusion stitched by stitchFusions comes from: the
+//! output at `output` of the fusion at `call`, or an input of the stitched
+//! fusion if call is negative
+struct StitchedInput {
+  int64_t call = -1;
+  int64_t output = -1;
+};
+
+//! Stitches fusions executed one after another into a single fusion.
+//! inputs[i] lists where each input of fusions[i] comes from, and outputs
+//! lists the (call, output) pairs the stitched fusion outputs, in order. The
+//! inputs of the stitched fusion are the inputs of the fusions that don't
+//! come from earlier fusions, in order. The outputs of a fusion that are not
+//! listed are only intermediates of the stitched fusion, so they are not
+//! materialized.
+//!
+//! Returns nullptr if the fusions can't be stitched, i.e., an output feeds an
+//! input that doesn't have the same type, rank and broadcast dimensions, or
+//! a fusion updates its inputs in place or permutes them.
+NVF_API std::unique_ptr<Fusion> stitchFusions(
+    const std::vector<Fusion*>& fusions,
+    const std::vector<std::vector<StitchedInput>>& inputs,
+    const std::vector<std::pair<int64_t, int64_t>>& outputs);
+
+//! \class LazyTensor
+//! \brief An output of a fusion recorded by a LazyFusionQueue. It is
+//! materialized when its queue is flushed.
+class NVF_API LazyTensor {
+ public:
+  LazyTensor(
+      std::shared_ptr<LazyFusionQueue> queue,
+      int64_t call,
+      int64_t output);
+
+  //! Flushes the queue if the tensor is not materialized yet and returns it
+  const at::Tensor& result();
+
+  bool materialized() const {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return queue_ == nullptr;
+  }
+
+ private:
+  friend class LazyFusionQueue;
+
+  //! Returns queue_, which is null once materialized
+  std::shared_ptr<LazyFusionQueue> queue() const {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return queue_;
+  }
+
+  //! Sets the result and resets queue_. The caller holds the mutex of the
+  //! queue.
+  void materialize(at::Tensor tensor);
+
+  //! Guards queue_ and tensor_, which a flush on another thread sets.
+  //! tensor_ doesn't change once materialized.
+  mutable std::mutex mutex_;
+  //! The queue recording the fusion, reset once materialized
+  std::shared_ptr<LazyFusionQueue> queue_;
+  //! Index of the fusion in the pending calls of queue_, and of the tensor in
+  //! the outputs of the fusion
+  int64_t call_ = -1;
+  int64_t output_ = -1;
+  at::Tensor tensor_;
+};
+
+//! An input of a fusion recorded by a LazyFusionQueue: a tensor or a scalar,
+//! or an output of an earlier fusion
+using LazyInput = std::variant<c10::IValue, std::shared_ptr<LazyTensor>>;
+
+//! \class LazyFusionQueue
+//! \brief Records the executions of FusionDefinitions instead of running
+//! them, so that consecutive fusions whose outputs feed later ones run as a
+//! single fusion: the intermediates are neither written to nor read back from
+//! global memory, and there is a single launch per stitched segment.
+//!
+//! The recorded fusions are stitched and executed when the queue is flushed,
+//! either explicitly or when the result of a LazyTensor is needed. Outputs
+//! whose LazyTensors no longer exist at that point are not materialized. The
+//! stitched fusions are cached in the FusionCache by the sequence of fusion
+//! ids and the wiring of their inputs and outputs. Fusions that can't be
+//! stitched, see stitchFusions, run one after another. Only auto-generated
+//! schedules on a single device are supported.
+class NVF_API LazyFusionQueue
+    : public std::enable_shared_from_this<LazyFusionQueue> {
+ public:
+  static std::shared_ptr<LazyFusionQueue> create() {
+    return std::shared_ptr<LazyFusionQueue>(new LazyFusionQueue());
+  }
+
+  //! Records an execution of the fusion of fd and returns its outputs
+  std::vector<std::shared_ptr<LazyTensor>> enqueue(
+      const FusionDefinition& fd,
+      const std::vector<LazyInput>& inputs);
+
+  //! Same as above for the FusionExecutorCache of the fusion of fusion_id
+  std::vector<std::shared_ptr<LazyTensor>> enqueue(
+      size_t fusion_id,
+      FusionExecutorCache* executor_cache,
+      const std::vector<LazyInput>& inputs);
+
+  //! Executes the recorded fusions and materializes their outputs
+  void flush();
+
+  //! Number of recorded fusions that were not executed yet
+  size_t numPendingCalls() const;
+
+ private:
+  LazyFusionQueue() = default;
+
+  //! A recorded execution
+  struct Call {
+    size_t fusion_id = 0;
+    FusionExecutorCache* executor_cache = nullptr;
+    //! Values of the inputs that don't come from pending calls
+    std::vector<c10::IValue> values;
+    //! Where each input of the fusion comes from, see StitchedInput. For the
+    //! inputs of the stitched fusion, output indexes values.
+    std::vector<StitchedInput> inputs;
+    std::vector<std::weak_ptr<LazyTensor>> outputs;
+  };
+
+  //! Runs calls one after another
+  void runEagerly(
+      const std::vector<Call>& calls,
+      const std::vector<std::vector<std::shared_ptr<LazyTensor>>>& outputs);
+
+  //! Held while the calls are flushed, so that enqueue doesn't refer to calls
+  //! that are being flushed
+  mutable std::mutex mutex_;
+  std::vector<Call> calls_;
+};
+
+} // namespace nvfuser::python_frontend
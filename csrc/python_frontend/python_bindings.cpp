@@ -12,11 +12,15 @@
 #include <instrumentation.h>
 #include <ir/all_nodes.h>
 #include <ir/builder.h>
+#include <kernel_db/heuristic_db.h>
 #include <ops/all_ops.h>
+#include <perf_monitor.h>
 #include <python_frontend/fusion_cache.h>
 #include <python_frontend/fusion_definition.h>
 #include <python_frontend/fusion_record.h>
+#include <python_frontend/lazy_fusion.h>
 #include <python_frontend/python_bindings.h>
+#include <sampling_profiler.h>
 #include <torch/csrc/jit/python/pybind_utils.h>
 #include <complex>
 #include <iostream>
@@ -32,6 +36,87 @@ namespace nvfuser::python_frontend {
 // bindings. Ideally, these would be templated lambda functions but those
 // are not available without C++20.
 namespace {
+//! Wraps an array of another framework that implements the DLPack protocol,
+//! e.g. a CuPy or JAX array, in a torch.Tensor aliasing its memory. Other
+//! objects are returned as is.
+py::object fromDLPack(py::handle obj) {
+  if (THPVariable_Check(obj.ptr()) || !py::hasattr(obj, "__dlpack__")) {
+    return py::reinterpret_borrow<py::object>(obj);
+  }
+  // torch.utils.dlpack.from_dlpack passes the current stream to the
+  // producer, which makes it wait for its pending work on the array
+  return py::module_::import("torch.utils.dlpack").attr("from_dlpack")(obj);
+}
+
+//! Converts the python inputs of a fusion, where a list or tuple is a Vector
+//! of Sizes, to IValues
+std::vector<c10::IValue> toInputs(const py::iterable& iter) {
+  std::vector<c10::IValue> inputs;
+  for (py::handle obj : iter) {
+    // Allows for a Vector of Sizes to be inputed as a list/tuple
+    if (py::isinstance<py::list>(obj) || py::isinstance<py::tuple>(obj)) {
+      for (py::handle item : obj) {
+        inputs.push_back(torch::jit::toIValue(item, c10::AnyType::get()));
+      }
+    } else {
+      inputs.push_back(
+          torch::jit::toIValue(fromDLPack(obj), c10::AnyType::get()));
+    }
+  }
+  return inputs;
+}
+
+//! Converts the python inputs of a lazy fusion call like toInputs, except
+//! that LazyTensors are kept as is
+std::vector<LazyInput> toLazyInputs(const py::iterable& iter) {
+  std::vector<LazyInput> inputs;
+  for (py::handle obj : iter) {
+    if (py::isinstance<LazyTensor>(obj)) {
+      inputs.emplace_back(py::cast<std::shared_ptr<LazyTensor>>(obj));
+    } else if (
+        py::isinstance<py::list>(obj) || py::isinstance<py::tuple>(obj)) {
+      for (py::handle item : obj) {
+        inputs.emplace_back(torch::jit::toIValue(item, c10::AnyType::get()));
+      }
+    } else {
+      inputs.emplace_back(
+          torch::jit::toIValue(fromDLPack(obj), c10::AnyType::get()));
+    }
+  }
+  return inputs;
+}
+
+std::optional<int8_t> toInt8Device(std::optional<int64_t> device) {
+  std::optional<int8_t> int8_device = std::nullopt;
+  if (device.has_value()) {
+    NVF_CHECK(device.value() < 256, "Maximum device index is 255");
+    int8_device = (int8_t)device.value();
+  }
+  return int8_device;
+}
+
+//! Converts a torch.cuda.Stream to a CUDAStream
+c10::cuda::CUDAStream toCUDAStream(const py::handle& stream) {
+  return c10::cuda::CUDAStream(c10::Stream::unpack3(
+      (c10::StreamId)py::cast<int64_t>(stream.attr("stream_id")),
+      (c10::DeviceIndex)py::cast<int64_t>(stream.attr("device_index")),
+      (c10::DeviceType)py::cast<int64_t>(stream.attr("device_type"))));
+}
+
+//! Converts the preallocated outputs of a fusion, where None lets the fusion
+//! allocate that output
+std::vector<at::Tensor> toOutputs(const std::optional<py::iterable>& out) {
+  std::vector<at::Tensor> outputs;
+  if (out.has_value()) {
+    for (py::handle obj : out.value()) {
+      outputs.push_back(
+          obj.is_none() ? at::Tensor()
+                        : py::cast<at::Tensor>(fromDLPack(obj)));
+    }
+  }
+  return outputs;
+}
+
 Vector define_vector_base_fn(FusionDefinition& fd, std::vector<Scalar>& args) {
   FUSER_PERF_SCOPE("python_frontend::define_vector_base_fn");
   NVF_CHECK(!fd.completed(), "Attempting to add to a completed definition!");
@@ -397,6 +482,7 @@ void initNvFuserPythonBindings(PyObject* module) {
       .value("Half", DataType::Half)
       .value("Int", DataType::Int)
       .value("Int32", DataType::Int32)
+      .value("Int8", DataType::Int8)
       .value("Bool", DataType::Bool)
       .value("BFloat16", DataType::BFloat16)
       .value("Float8_e4m3fn", DataType::Float8_e4m3fn)
@@ -413,6 +499,179 @@ void initNvFuserPythonBindings(PyObject* module) {
   nvfuser.def("compute_contiguity", computeContiguity);
   nvfuser.def("compute_tensor_descriptor", computeTensorDescriptor);
   nvfuser.def("serialize", serialize);
+  //! Aggregates heuristic DB files, e.g. recorded on different machines, see
+  //! tools/merge_heuristic_db.py. Returns the number of signatures.
+  nvfuser.def(
+      "merge_heuristic_dbs",
+      [](const std::string& output, const std::vector<std::string>& inputs) {
+        HeuristicDb db;
+        for (const auto& input : inputs) {
+          NVF_CHECK(db.load(input), "Invalid heuristic DB file: ", input);
+        }
+        NVF_CHECK(db.save(output), "Failed to write heuristic DB: ", output);
+        return db.size();
+      },
+      py::arg("output"),
+      py::arg("inputs"));
+
+  //! Statistics of the kernel launches sampled with NVFUSER_PROF=sample(N)
+  py::class_<KernelSampleStats>(nvfuser, "KernelSampleStats")
+      .def_readonly("kernel_name", &KernelSampleStats::kernel_name)
+      .def_readonly("total_samples", &KernelSampleStats::total_samples)
+      .def_readonly("samples", &KernelSampleStats::samples)
+      .def_readonly("p50_ms", &KernelSampleStats::p50_ms)
+      .def_readonly("p99_ms", &KernelSampleStats::p99_ms)
+      .def_readonly("mean_ms", &KernelSampleStats::mean_ms)
+      .def_readonly(
+          "effective_bandwidth_gbs",
+          &KernelSampleStats::effective_bandwidth_gbs)
+      .def("__repr__", [](const KernelSampleStats& self) {
+        std::stringstream ss;
+        ss << "KernelSampleStats(kernel_name=" << self.kernel_name
+           << ", samples=" << self.samples << ", p50_ms=" << self.p50_ms
+           << ", p99_ms=" << self.p99_ms
+           << ", effective_bandwidth_gbs=" << self.effective_bandwidth_gbs
+           << ")";
+        return ss.str();
+      });
+  nvfuser.def(
+      "sampled_kernel_stats", []() { return SamplingProfiler::get().stats(); });
+  nvfuser.def(
+      "reset_sampled_kernel_stats", []() { SamplingProfiler::get().reset(); });
+
+  //! Kernels found slower than their best time with NVFUSER_ENABLE=perf_monitor
+  py::class_<PerfRegression>(nvfuser, "PerfRegression")
+      .def_readonly("kernel_name", &PerfRegression::kernel_name)
+      .def_readonly("signature", &PerfRegression::signature)
+      .def_readonly("time_ms", &PerfRegression::time_ms)
+      .def_readonly("best_time_ms", &PerfRegression::best_time_ms)
+      .def("__repr__", [](const PerfRegression& self) {
+        std::stringstream ss;
+        ss << "PerfRegression(kernel_name=" << self.kernel_name
+           << ", time_ms=" << self.time_ms
+           << ", best_time_ms=" << self.best_time_ms << ")";
+        return ss.str();
+      });
+  nvfuser.def("perf_regressions", []() {
+    PerfMonitor* monitor = PerfMonitor::get();
+    return monitor != nullptr ? monitor->regressions()
+                              : std::vector<PerfRegression>{};
+  });
+
+  //! Profile of a fusion executed with profile=True, see FusionProfiler
+  py::class_<KernelProfile>(nvfuser, "KernelProfile")
+      .def_readonly("name", &KernelProfile::name)
+      .def_readonly("segment_id", &KernelProfile::segment_id)
+      .def_readonly("scheduler", &KernelProfile::heuristic)
+      .def_readonly("device", &KernelProfile::device)
+      .def_readonly("compile_time_ms", &KernelProfile::compile_time_ms)
+      .def_readonly("time_ms", &KernelProfile::time_ms)
+      .def_readonly(
+          "effective_bandwidth_gbs", &KernelProfile::effective_bandwidth_gbs)
+      .def_readonly(
+          "percentage_peak_bandwidth",
+          &KernelProfile::percentage_peak_bandwidth)
+      .def_readonly("grid", &KernelProfile::grid)
+      .def_readonly("block", &KernelProfile::block)
+      .def_readonly("cluster", &KernelProfile::cluster)
+      .def_property_readonly(
+          "dynamic_smem_bytes",
+          [](const KernelProfile& self) { return self.shared_mem[0]; })
+      .def_property_readonly(
+          "static_smem_bytes",
+          [](const KernelProfile& self) { return self.shared_mem[1]; })
+      .def_readonly("registers", &KernelProfile::registers)
+      .def_readonly("input_bytes", &KernelProfile::input_bytes)
+      .def_readonly("output_bytes", &KernelProfile::output_bytes)
+      .def_readonly("device_name", &KernelProfile::device_name)
+      .def_readonly("peak_bandwidth_gbs", &KernelProfile::peak_bandwidth_gbs)
+      .def("__repr__", [](const KernelProfile& self) {
+        std::stringstream ss;
+        ss << "KernelProfile(name=" << self.name
+           << ", segment_id=" << self.segment_id
+           << ", scheduler=" << self.heuristic << ", time_ms=" << self.time_ms
+           << ", effective_bandwidth_gbs=" << self.effective_bandwidth_gbs
+           << ")";
+        return ss.str();
+      });
+  py::class_<CompileStepProfile>(nvfuser, "CompileStepProfile")
+      .def_readonly("name", &CompileStepProfile::name)
+      .def_readonly("segment_id", &CompileStepProfile::segment_id)
+      .def_readonly("depth", &CompileStepProfile::depth)
+      .def_readonly("start_ms", &CompileStepProfile::start_ms)
+      .def_readonly("time_ms", &CompileStepProfile::time_ms)
+      .def("__repr__", [](const CompileStepProfile& self) {
+        std::stringstream ss;
+        ss << "CompileStepProfile(name=" << self.name
+           << ", segment_id=" << self.segment_id << ", depth=" << self.depth
+           << ", time_ms=" << self.time_ms << ")";
+        return ss.str();
+      });
+  py::class_<FusionProfile>(nvfuser, "FusionProfile")
+      .def_readonly("fusion_id", &FusionProfile::fusion_id)
+      .def_readonly("segments", &FusionProfile::segments)
+      .def_readonly("cuda_evt_time_ms", &FusionProfile::cuda_evt_time_ms)
+      .def_readonly("host_time_ms", &FusionProfile::host_time_ms)
+      .def_readonly("compile_time_ms", &FusionProfile::compile_time_ms)
+      .def_readonly("kernel_time_ms", &FusionProfile::kernel_time_ms)
+      .def_readonly(
+          "effective_bandwidth_gbs", &FusionProfile::effective_bandwidth_gbs)
+      .def_readonly(
+          "percentage_peak_bandwidth",
+          &FusionProfile::percentage_peak_bandwidth)
+      .def_readonly("input_bytes", &FusionProfile::input_bytes)
+      .def_readonly("output_bytes", &FusionProfile::output_bytes)
+      .def_readonly("kernel_profiles", &FusionProfile::kernel_profiles)
+      .def_readonly("compile_steps", &FusionProfile::compile_steps)
+      .def("__repr__", [](const FusionProfile& self) {
+        std::stringstream ss;
+        ss << self;
+        return ss.str();
+      });
+
+  //! Result of FusionDefinition.sweep_launch_configs for one candidate
+  py::class_<LaunchConfigSweepResult>(nvfuser, "LaunchConfigSweepResult")
+      .def_readonly("segment_id", &LaunchConfigSweepResult::segment_id)
+      .def_readonly("candidate", &LaunchConfigSweepResult::candidate)
+      .def_readonly("valid", &LaunchConfigSweepResult::valid)
+      .def_readonly("time_ms", &LaunchConfigSweepResult::time_ms)
+      .def_readonly("occupancy", &LaunchConfigSweepResult::occupancy)
+      .def_readonly(
+          "pareto_optimal", &LaunchConfigSweepResult::pareto_optimal)
+      .def_property_readonly(
+          "grid",
+          [](const LaunchConfigSweepResult& self) {
+            const LaunchParams& lparams = self.launch_params;
+            return std::make_tuple(
+                lparams.gdimx(), lparams.gdimy(), lparams.gdimz());
+          })
+      .def_property_readonly(
+          "block",
+          [](const LaunchConfigSweepResult& self) {
+            const LaunchParams& lparams = self.launch_params;
+            return std::make_tuple(
+                lparams.bdimx(), lparams.bdimy(), lparams.bdimz());
+          })
+      .def_property_readonly(
+          "params",
+          [](const LaunchConfigSweepResult& self) {
+            return self.params->toString();
+          })
+      .def("__repr__", [](const LaunchConfigSweepResult& self) {
+        std::stringstream ss;
+        ss << "LaunchConfigSweepResult(segment_id=" << self.segment_id
+           << ", candidate=" << self.candidate << ", valid=" << self.valid
+           << ", time_ms=" << self.time_ms
+           << ", occupancy=" << self.occupancy
+           << ", pareto_optimal=" << self.pareto_optimal << ")";
+        return ss.str();
+      });
+  nvfuser.def(
+      "launch_config_sweep_table",
+      [](const std::vector<LaunchConfigSweepResult>& results) {
+        return toString(results);
+      },
+      py::arg("results"));
 
   //! Binding the FusionCache that holds a cache of Fusions
   //! This is only bound to provide an interface to get the number of fusions
@@ -450,11 +709,19 @@ void initNvFuserPythonBindings(PyObject* module) {
             self.print(ss);
             return ss.str();
           })
-      .def("stats", [](FusionCache& self) {
-        std::stringstream ss;
-        self.stats(ss);
-        return ss.str();
-      });
+      .def(
+          "stats",
+          [](FusionCache& self) {
+            std::stringstream ss;
+            self.stats(ss);
+            return ss.str();
+          })
+      .def_static(
+          "set_kernel_memory_budget",
+          [](int64_t bytes) {
+            KernelRuntimeLru::get().setMemoryBudget(bytes);
+          },
+          py::arg("bytes"));
 
   //! These are the FusionDefinition supported object types that are either
   //! defined as inputs or the output of an operation.
@@ -490,6 +757,88 @@ void initNvFuserPythonBindings(PyObject* module) {
   vector_class.def_property_readonly(
       "size", [](Vector& self) { return self.size; });
 
+  //! A FusionFuture holds the outputs of FusionDefinition.execute_async
+  py::class_<FusionFuture> fusion_future(nvfuser, "FusionFuture");
+  fusion_future.def("done", &FusionFuture::done)
+      .def(
+          "result",
+          [](const FusionFuture& self) {
+            py::gil_scoped_release release;
+            return self.result();
+          })
+      .def(
+          "wait_on",
+          [](const FusionFuture& self, const py::object& stream) {
+            self.waitOn(toCUDAStream(stream));
+          },
+          py::arg("stream"));
+
+  //! A FusionHandle executes a defined fusion with the least overhead, as
+  //! the inputs are converted and dispatched to the FusionExecutorCache
+  //! without going through the FusionDefinition.
+  py::class_<FusionHandle> fusion_handle(nvfuser, "FusionHandle");
+  fusion_handle
+      .def(
+          "__call__",
+          [](const FusionHandle& self,
+             const py::iterable& iter,
+             std::optional<int64_t> device,
+             const std::optional<py::iterable>& out) {
+            std::vector<c10::IValue> inputs = toInputs(iter);
+            std::vector<at::Tensor> outputs = toOutputs(out);
+            py::gil_scoped_release release;
+            return self.execute(inputs, toInt8Device(device), outputs);
+          },
+          py::arg("inputs"),
+          py::kw_only(),
+          py::arg("device") = py::none(),
+          py::arg("out") = py::none())
+      .def("id", &FusionHandle::id)
+      .def("__repr__", [](const FusionHandle& self) {
+        std::stringstream ss;
+        ss << "FusionHandle(id=" << self.id() << ")";
+        return ss.str();
+      });
+
+  //! Lazy fusion calls are queued instead of executed, so that consecutive
+  //! calls run as a single stitched fusion once a result is needed:
+  //!
+  //!   queue = LazyFusionQueue()
+  //!   (t1,) = queue.enqueue(fd1, [t0])
+  //!   (t2,) = queue.enqueue(fd2, [t1, s0])
+  //!   t2.result()  # runs fd1 and fd2 as one fusion
+  py::class_<LazyTensor, std::shared_ptr<LazyTensor>> lazy_tensor(
+      nvfuser, "LazyTensor");
+  lazy_tensor
+      .def(
+          "result",
+          [](LazyTensor& self) {
+            py::gil_scoped_release release;
+            return self.result();
+          })
+      .def("materialized", &LazyTensor::materialized);
+
+  py::class_<LazyFusionQueue, std::shared_ptr<LazyFusionQueue>> lazy_queue(
+      nvfuser, "LazyFusionQueue");
+  lazy_queue.def(py::init(&LazyFusionQueue::create))
+      .def(
+          "enqueue",
+          [](LazyFusionQueue& self,
+             const FusionDefinition& fd,
+             const py::iterable& iter) {
+            std::vector<LazyInput> inputs = toLazyInputs(iter);
+            return self.enqueue(fd, inputs);
+          },
+          py::arg("fd"),
+          py::arg("inputs"))
+      .def(
+          "flush",
+          [](LazyFusionQueue& self) {
+            py::gil_scoped_release release;
+            self.flush();
+          })
+      .def("num_pending_calls", &LazyFusionQueue::numPendingCalls);
+
   //! The FusionDefinition is a context manager in Python where the user will
   //! define the set the operations and connections between operations for
   //! nvFuser to create.
@@ -517,22 +866,29 @@ void initNvFuserPythonBindings(PyObject* module) {
           })
       .def(
           "_setup_schedule",
-          [](FusionDefinition& self, const py::iterable& iter) {
+          [](FusionDefinition& self,
+             const py::iterable& iter,
+             std::optional<size_t> schedule_key) {
             // Instrumentation to mark the beginning of a schedule
             inst::Trace::instance()->beginEvent("FusionDefinition Schedule");
-            std::vector<c10::IValue> inputs;
-            for (py::handle obj : iter) {
-              inputs.push_back(torch::jit::toIValue(obj, c10::AnyType::get()));
-            }
-            self.setupSchedule(inputs);
-          })
+            std::vector<c10::IValue> inputs = toInputs(iter);
+            self.setupSchedule(inputs, schedule_key);
+          },
+          py::arg("inputs"),
+          py::arg("schedule_key") = py::none())
+      .def(
+          "_exist_schedule",
+          [](FusionDefinition& self,
+             const py::iterable& iter,
+             size_t schedule_key) {
+            return self.existSchedule(toInputs(iter), schedule_key);
+          },
+          py::arg("inputs"),
+          py::arg("schedule_key"))
       .def(
           "_finalize_schedule",
           [](FusionDefinition& self, const py::iterable& iter) {
-            std::vector<c10::IValue> inputs;
-            for (py::handle obj : iter) {
-              inputs.push_back(torch::jit::toIValue(obj, c10::AnyType::get()));
-            }
+            std::vector<c10::IValue> inputs = toInputs(iter);
             self.finalizeSchedule(inputs);
             // Mark the end of a schedule
             inst::Trace::instance()->endEvent(nullptr);
@@ -550,38 +906,62 @@ void initNvFuserPythonBindings(PyObject* module) {
              const py::iterable& iter,
              bool override_user_schedule,
              std::optional<int64_t> device,
-             bool capture_debug_output) {
-            std::vector<c10::IValue> inputs;
-            for (py::handle obj : iter) {
-              // Allows for a Vector of Sizes to be inputed as a list/tuple
-              if (py::isinstance<py::list>(obj) ||
-                  py::isinstance<py::tuple>(obj)) {
-                for (py::handle item : obj) {
-                  inputs.push_back(
-                      torch::jit::toIValue(item, c10::AnyType::get()));
-                }
-              } else {
-                inputs.push_back(
-                    torch::jit::toIValue(obj, c10::AnyType::get()));
-              }
-            }
-            std::optional<int8_t> int8_device = std::nullopt;
-            if (device.has_value()) {
-              NVF_CHECK(device.value() < 256, "Maximum device index is 255");
-              int8_device = (int8_t)device.value();
-            }
+             bool capture_debug_output,
+             const std::optional<py::iterable>& out,
+             bool profile) {
+            std::vector<c10::IValue> inputs = toInputs(iter);
+            std::vector<at::Tensor> outputs = toOutputs(out);
+            // Other python threads may define and execute fusions while the
+            // fusion is compiled and launched
+            py::gil_scoped_release release;
             return self.execute(
                 inputs,
                 override_user_schedule,
                 capture_debug_output,
-                int8_device);
+                toInt8Device(device),
+                outputs,
+                profile);
           },
           py::arg("inputs"),
           py::arg("override_user_schedule") = false,
           py::kw_only(),
           py::arg("device") = py::none(),
           py::arg("capture_debug_output") = false,
+          py::arg("out") = py::none(),
+          py::arg("profile") = false,
           py::return_value_policy::reference)
+      .def(
+          "profile",
+          [](FusionDefinition& self) { return self.profile(); })
+      .def(
+          "_precompile",
+          [](FusionDefinition& self,
+             const py::iterable& inputs_list,
+             std::optional<int64_t> device) {
+            std::vector<std::vector<c10::IValue>> ivalues_list;
+            for (py::handle iter : inputs_list) {
+              ivalues_list.push_back(toInputs(py::cast<py::iterable>(iter)));
+            }
+            return self.precompile(ivalues_list, toInt8Device(device));
+          },
+          py::arg("inputs_list"),
+          py::kw_only(),
+          py::arg("device") = py::none())
+      .def(
+          "_execute_async",
+          [](FusionDefinition& self,
+             const py::iterable& iter,
+             const py::object& stream) {
+            std::vector<c10::IValue> inputs = toInputs(iter);
+            auto cuda_stream = toCUDAStream(stream);
+            py::gil_scoped_release release;
+            return self.executeAsync(inputs, cuda_stream);
+          },
+          py::arg("inputs"),
+          py::arg("stream"))
+      .def(
+          "handle",
+          [](FusionDefinition& self) { return self.handle(); })
       .def(
           "_debug_output",
           [](FusionDefinition& self) { return self.getDebugOutput(); },
@@ -617,6 +997,16 @@ void initNvFuserPythonBindings(PyObject* module) {
           py::arg("intrinsic_code") = false,
           py::arg("override_user_schedule") = false,
           py::return_value_policy::reference)
+      .def(
+          "_sweep_launch_configs",
+          [](FusionDefinition& self,
+             const py::iterable& iter,
+             int64_t max_candidates) {
+            std::vector<c10::IValue> inputs = toInputs(iter);
+            return self.sweepLaunchConfigs(inputs, max_candidates);
+          },
+          py::arg("inputs"),
+          py::arg("max_candidates"))
       .def(
           "_last_scheduled_fusion_ir",
           [](FusionDefinition& self,
@@ -975,6 +1365,13 @@ void initNvFuserPythonBindings(PyObject* module) {
   NVFUSER_PYTHON_BINDING_UNARY_OP("abs", abs)
   NVFUSER_PYTHON_BINDING_UNARY_OP("acos", acos)
   NVFUSER_PYTHON_BINDING_UNARY_OP("acosh", acosh)
+  NVFUSER_PYTHON_BINDING_UNARY_OP("approx_cos", approx_cos)
+  NVFUSER_PYTHON_BINDING_UNARY_OP("approx_exp", approx_exp)
+  NVFUSER_PYTHON_BINDING_UNARY_OP("approx_log", approx_log)
+  NVFUSER_PYTHON_BINDING_UNARY_OP("approx_reciprocal", approx_reciprocal)
+  NVFUSER_PYTHON_BINDING_UNARY_OP("approx_rsqrt", approx_rsqrt)
+  NVFUSER_PYTHON_BINDING_UNARY_OP("approx_sin", approx_sin)
+  NVFUSER_PYTHON_BINDING_UNARY_OP("approx_tanh", approx_tanh)
   NVFUSER_PYTHON_BINDING_UNARY_OP("asin", asin)
   NVFUSER_PYTHON_BINDING_UNARY_OP("asinh", asinh)
   NVFUSER_PYTHON_BINDING_UNARY_OP("atan", atan)
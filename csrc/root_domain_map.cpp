@@ -161,6 +161,60 @@ std::unordered_map<IterDomain*, IterDomain*> PairwiseRootDomainMap::map(
     return dom_map;
   }
 
+  // For GroupedMatmulOp, [M, K] x [G, K, N] -> [M, N]. The offsets are not
+  // mapped to the output.
+  if (auto op = dynamic_cast<GroupedMatmulOp*>(consumer_tv_->definition())) {
+    if (producer_tv_ == op->inA()) {
+      updatePairwiseRootDomainMap(producer_root.at(0), consumer_root.at(0));
+    } else if (producer_tv_ == op->inB()) {
+      updatePairwiseRootDomainMap(producer_root.at(2), consumer_root.at(1));
+    }
+    return dom_map;
+  }
+
+  // For SdpaFwdOp, query [N, H, L, E] and value [N, H, S, Ev] map to the
+  // attention [N, H, L, Ev], and query to the logsumexp [N, H, L]. The philox
+  // seed and offset are scalars.
+  if (auto op = dynamic_cast<SdpaFwdOp*>(consumer_tv_->definition())) {
+    const bool is_attn_out = consumer_tv_ == op->attnOut();
+    if ((is_attn_out || consumer_tv_ == op->logSumExp()) &&
+        producer_tv_ == op->query()) {
+      for (auto idx : c10::irange(3)) {
+        updatePairwiseRootDomainMap(
+            producer_root.at(idx), consumer_root.at(idx));
+      }
+    } else if (is_attn_out && producer_tv_ == op->value()) {
+      updatePairwiseRootDomainMap(producer_root.at(3), consumer_root.at(3));
+    }
+    return dom_map;
+  }
+
+  // For SdpaBwdOp, the gradients of query, key and value map to the
+  // respective inputs.
+  if (auto op = dynamic_cast<SdpaBwdOp*>(consumer_tv_->definition())) {
+    if ((consumer_tv_ == op->gradQuery() && producer_tv_ == op->query()) ||
+        (consumer_tv_ == op->gradKey() && producer_tv_ == op->key()) ||
+        (consumer_tv_ == op->gradValue() && producer_tv_ == op->value())) {
+      for (auto idx : c10::irange(consumer_root.size())) {
+        updatePairwiseRootDomainMap(
+            producer_root.at(idx), consumer_root.at(idx));
+      }
+    }
+    return dom_map;
+  }
+
+  // For TopKOp, the values and indices map to the input except for the
+  // selected dimension, whose extent is k.
+  if (auto op = dynamic_cast<TopKOp*>(consumer_tv_->definition())) {
+    for (auto idx : c10::irange(consumer_root.size())) {
+      if ((int64_t)idx != op->dim()) {
+        updatePairwiseRootDomainMap(
+            producer_root.at(idx), consumer_root.at(idx));
+      }
+    }
+    return dom_map;
+  }
+
   size_t itc = 0, itp = 0;
   while (itc < consumer_root.size() && itp < producer_root.size()) {
     IterDomain* producer_id = producer_root.at(itp);
@@ -0,0 +1,167 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <sampling_profiler.h>
+
+#include <cuda_utils.h>
+#include <exceptions.h>
+
+#include <algorithm>
+
+namespace nvfuser {
+
+void KernelSampleBuffer::push(float time_ms, int64_t bytes) {
+  const int64_t n = num_samples_.load(std::memory_order_relaxed);
+  const int64_t slot = n % capacity;
+  times_ms_[slot].store(time_ms, std::memory_order_relaxed);
+  bytes_[slot].store(bytes, std::memory_order_relaxed);
+  // Publishes the sample to readers
+  num_samples_.store(n + 1, std::memory_order_release);
+}
+
+KernelSampleStats KernelSampleBuffer::stats() const {
+  KernelSampleStats stats;
+  stats.kernel_name = kernel_name_;
+  stats.total_samples = num_samples_.load(std::memory_order_acquire);
+  stats.samples = std::min(stats.total_samples, capacity);
+  if (stats.samples == 0) {
+    return stats;
+  }
+
+  std::vector<float> times_ms(stats.samples);
+  double total_ms = 0.0;
+  double total_bytes = 0.0;
+  for (int64_t i = 0; i < stats.samples; ++i) {
+    times_ms[i] = times_ms_[i].load(std::memory_order_relaxed);
+    total_ms += times_ms[i];
+    total_bytes += (double)bytes_[i].load(std::memory_order_relaxed);
+  }
+
+  auto percentile = [&times_ms](double p) {
+    auto it = times_ms.begin() + (int64_t)(p * (double)(times_ms.size() - 1));
+    std::nth_element(times_ms.begin(), it, times_ms.end());
+    return (double)*it;
+  };
+  stats.p50_ms = percentile(0.5);
+  stats.p99_ms = percentile(0.99);
+  stats.mean_ms = total_ms / (double)stats.samples;
+  if (total_ms > 0.0) {
+    // bytes/ms to GB/s
+    stats.effective_bandwidth_gbs = total_bytes / total_ms * 1.0e-6;
+  }
+  return stats;
+}
+
+SamplingProfiler& SamplingProfiler::get() {
+  // Never destroyed, since the CUDA driver may be shut down at exit
+  static SamplingProfiler* profiler = new SamplingProfiler();
+  return *profiler;
+}
+
+cudaEvent_t SamplingProfiler::getEvent(int device) {
+  NVF_ERROR(device >= 0, "Invalid device index: ", device);
+  if ((size_t)device < free_events_.size() && !free_events_[device].empty()) {
+    cudaEvent_t event = free_events_[device].back();
+    free_events_[device].pop_back();
+    return event;
+  }
+  cudaEvent_t event = nullptr;
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaEventCreate(&event));
+  return event;
+}
+
+void SamplingProfiler::releaseEvent(int device, cudaEvent_t event) {
+  if ((size_t)device >= free_events_.size()) {
+    free_events_.resize(device + 1);
+  }
+  free_events_[device].push_back(event);
+}
+
+cudaEvent_t SamplingProfiler::startSample(int device, cudaStream_t stream) {
+  cudaEvent_t start = nullptr;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    start = getEvent(device);
+  }
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaEventRecord(start, stream));
+  return start;
+}
+
+void SamplingProfiler::stopSample(
+    int device,
+    cudaStream_t stream,
+    cudaEvent_t start,
+    const std::string& kernel_name,
+    int64_t bytes) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  cudaEvent_t stop = getEvent(device);
+  NVFUSER_CUDA_RT_SAFE_CALL(cudaEventRecord(stop, stream));
+
+  auto& buffer = buffers_[kernel_name];
+  if (buffer == nullptr) {
+    buffer = std::make_shared<KernelSampleBuffer>(kernel_name);
+  }
+  pending_samples_.push_back({device, start, stop, buffer, bytes});
+
+  collectFinishedSamples();
+}
+
+void SamplingProfiler::collectFinishedSamples() {
+  // Launches on different streams may finish in any order
+  for (auto it = pending_samples_.begin(); it != pending_samples_.end();) {
+    const cudaError_t status = cudaEventQuery(it->stop);
+    if (status == cudaErrorNotReady) {
+      ++it;
+      continue;
+    }
+    NVFUSER_CUDA_RT_SAFE_CALL(status);
+    float time_ms = 0.0f;
+    NVFUSER_CUDA_RT_SAFE_CALL(
+        cudaEventElapsedTime(&time_ms, it->start, it->stop));
+    if (it->buffer != nullptr) {
+      it->buffer->push(time_ms, it->bytes);
+    }
+    releaseEvent(it->device, it->start);
+    releaseEvent(it->device, it->stop);
+    it = pending_samples_.erase(it);
+  }
+}
+
+std::vector<KernelSampleStats> SamplingProfiler::stats() {
+  std::vector<std::shared_ptr<KernelSampleBuffer>> buffers;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    collectFinishedSamples();
+    buffers.reserve(buffers_.size());
+    for (const auto& [name, buffer] : buffers_) {
+      buffers.push_back(buffer);
+    }
+  }
+  // The buffers are read outside of the lock so that reading doesn't hold up
+  // the launches being sampled
+  std::vector<KernelSampleStats> stats;
+  stats.reserve(buffers.size());
+  for (const auto& buffer : buffers) {
+    stats.push_back(buffer->stats());
+  }
+  std::sort(stats.begin(), stats.end(), [](const auto& a, const auto& b) {
+    return a.kernel_name < b.kernel_name;
+  });
+  return stats;
+}
+
+void SamplingProfiler::reset() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  // Pending events are still recorded on their streams, so they are only
+  // released once finished
+  for (auto& sample : pending_samples_) {
+    sample.buffer = nullptr;
+  }
+  buffers_.clear();
+}
+
+} // namespace nvfuser
@@ -0,0 +1,133 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <cuda_runtime.h>
+#include <options.h>
+#include <visibility.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace nvfuser {
+
+//! \struct KernelSampleStats
+//! \brief Latency and bandwidth of a kernel over its most recent sampled
+//! launches
+struct KernelSampleStats {
+  std::string kernel_name{};
+  //! Number of launches sampled so far, including the ones that have been
+  //! overwritten in the ring buffer
+  int64_t total_samples{0};
+  //! Number of launches the statistics below are computed from
+  int64_t samples{0};
+
+  double p50_ms{0.0};
+  double p99_ms{0.0};
+  double mean_ms{0.0};
+  //! Bytes of the inputs and outputs over the kernel time of all samples
+  double effective_bandwidth_gbs{0.0};
+};
+
+//! \class KernelSampleBuffer
+//! \brief A fixed size ring buffer of the time and bytes of sampled launches
+//! of a kernel. Samples are pushed by one thread at a time and can be read
+//! concurrently without locking. A reader may see a sample that is being
+//! overwritten by a newer one, which doesn't matter for the statistics.
+class KernelSampleBuffer {
+ public:
+  static constexpr int64_t capacity = 1024;
+
+  explicit KernelSampleBuffer(std::string kernel_name)
+      : kernel_name_(std::move(kernel_name)) {}
+
+  void push(float time_ms, int64_t bytes);
+
+  KernelSampleStats stats() const;
+
+ private:
+  const std::string kernel_name_;
+  std::atomic<int64_t> num_samples_{0};
+  std::array<std::atomic<float>, capacity> times_ms_;
+  std::array<std::atomic<int64_t>, capacity> bytes_;
+};
+
+//! \class SamplingProfiler
+//! \brief A low overhead profiler meant to be left on in production. With
+//! NVFUSER_PROF=sample(N), 1 in N launches of each kernel is timed with a
+//! pair of CUDA events. The events are never synchronized with. Instead,
+//! finished events are collected without blocking when later samples are
+//! recorded or when the statistics are read.
+//!
+//! Unlike the FusionProfiler, the SamplingProfiler is not reset between
+//! fusions, so the statistics can be read at any time.
+class SamplingProfiler {
+ public:
+  NVF_API static SamplingProfiler& get();
+
+  //! Whether the launch_count-th launch of a kernel is sampled
+  static bool shouldSample(int64_t launch_count) {
+    const int64_t period = getProfilerSamplingPeriod();
+    return period > 0 && launch_count % period == 0;
+  }
+
+  //! Records the start of a sampled launch on stream
+  cudaEvent_t startSample(int device, cudaStream_t stream);
+
+  //! Records the end of a sampled launch started with startSample. The
+  //! sample is added to the statistics of the kernel once the launch
+  //! finishes.
+  void stopSample(
+      int device,
+      cudaStream_t stream,
+      cudaEvent_t start,
+      const std::string& kernel_name,
+      int64_t bytes);
+
+  //! Statistics of all sampled kernels, including the launches that finished
+  //! since the last call
+  NVF_API std::vector<KernelSampleStats> stats();
+
+  //! Drops all samples
+  NVF_API void reset();
+
+ private:
+  SamplingProfiler() = default;
+
+  struct PendingSample {
+    int device;
+    cudaEvent_t start;
+    cudaEvent_t stop;
+    std::shared_ptr<KernelSampleBuffer> buffer;
+    int64_t bytes;
+  };
+
+  cudaEvent_t getEvent(int device);
+  void releaseEvent(int device, cudaEvent_t event);
+
+  //! Moves the finished pending samples to their buffers. Needs mutex_.
+  void collectFinishedSamples();
+
+ private:
+  //! Protects everything but the contents of the buffers
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::shared_ptr<KernelSampleBuffer>>
+      buffers_;
+  std::deque<PendingSample> pending_samples_;
+  //! Events are reused since creating them is not free. Indexed by device.
+  std::vector<std::vector<cudaEvent_t>> free_events_;
+};
+
+} // namespace nvfuser
@@ -0,0 +1,274 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <scheduler/autotune.h>
+
+#include <exceptions.h>
+#include <options.h>
+#include <scheduler/normalization_inner.h>
+#include <scheduler/pointwise.h>
+#include <scheduler/pointwise_heuristic.h>
+#include <scheduler/reduction.h>
+#include <scheduler/reduction_heuristic.h>
+
+#include <algorithm>
+
+namespace nvfuser {
+
+namespace {
+
+constexpr int64_t kMaxThreadsPerBlock = 1024;
+constexpr int64_t kMinBdimx = 32;
+
+//! Factors below factor, halving down to 1, e.g. 8 -> {4, 2, 1}
+std::vector<int64_t> smallerFactors(int64_t factor) {
+  std::vector<int64_t> factors;
+  while (factor > 1) {
+    factor /= 2;
+    factors.push_back(factor);
+  }
+  return factors;
+}
+
+template <typename ParamsType>
+std::shared_ptr<ParamsType> cloneAs(const ParamsType& params) {
+  auto copy = std::dynamic_pointer_cast<ParamsType>(params.clone());
+  NVF_ERROR(copy != nullptr);
+  return copy;
+}
+
+using Candidates = std::vector<std::shared_ptr<HeuristicParams>>;
+
+void addPointwiseCandidates(
+    const PointwiseParams& params,
+    Candidates& candidates) {
+  // The vectorization factor is the largest one that is valid, so smaller
+  // powers of two are valid too. Unrolling is valid with any factor.
+  for (auto factor : smallerFactors(params.unroll_factor)) {
+    auto candidate = cloneAs(params);
+    candidate->unroll_factor = factor;
+    candidate->vectorize = params.vectorize && factor > 1;
+    candidates.push_back(candidate);
+  }
+  if (params.vectorize) {
+    auto candidate = cloneAs(params);
+    candidate->vectorize = false;
+    candidates.push_back(candidate);
+  }
+}
+
+//! Doubles and halves the bound block dimension of ptype if it is only
+//! bound at launch time, keeping the number of threads in the block limit
+void addBlockDimCandidates(
+    const std::shared_ptr<ReductionParams>& params,
+    ParallelType ptype,
+    Candidates& candidates) {
+  const int64_t dim = params->lparams.getRawVal(ptype);
+  if (dim == LaunchParams::UNINITIALIZED_VAL) {
+    return;
+  }
+  const int64_t min_dim = ptype == ParallelType::TIDx ? kMinBdimx : 1;
+  for (auto new_dim : {dim * 2, dim / 2}) {
+    if (new_dim < min_dim ||
+        params->lparams.nThreads() / dim * new_dim > kMaxThreadsPerBlock) {
+      continue;
+    }
+    auto candidate = cloneAs(*params);
+    LaunchParams& lparams = candidate->lparams;
+    lparams = LaunchParams(
+        lparams.getRawVal(ParallelType::BIDx),
+        lparams.getRawVal(ParallelType::BIDy),
+        lparams.getRawVal(ParallelType::BIDz),
+        ptype == ParallelType::TIDx ? new_dim
+                                    : lparams.getRawVal(ParallelType::TIDx),
+        ptype == ParallelType::TIDy ? new_dim
+                                    : lparams.getRawVal(ParallelType::TIDy),
+        lparams.getRawVal(ParallelType::TIDz));
+    candidates.push_back(candidate);
+  }
+}
+
+//! Smaller unroll factors of the inner reduction and the iteration domain.
+//! As for the pointwise scheduler, vectorization factors are the largest
+//! valid ones.
+void addUnrollCandidates(
+    const std::shared_ptr<ReductionParams>& params,
+    bool inner_reduction,
+    Candidates& candidates) {
+  if (inner_reduction) {
+    for (auto factor : smallerFactors(params->unroll_factor_inner_reduction)) {
+      auto candidate = cloneAs(*params);
+      candidate->unroll_factor_inner_reduction = factor;
+      candidate->vectorize_inner_reduction =
+          params->vectorize_inner_reduction && factor > 1;
+      candidates.push_back(candidate);
+    }
+  }
+  for (auto factor : smallerFactors(params->unroll_factor_iter_dom)) {
+    auto candidate = cloneAs(*params);
+    candidate->unroll_factor_iter_dom = factor;
+    candidate->vectorize_iter_dom = params->vectorize_iter_dom && factor > 1;
+    candidates.push_back(candidate);
+  }
+}
+
+void addReductionCandidates(
+    const std::shared_ptr<ReductionParams>& params,
+    Candidates& candidates) {
+  // Other parallelizations of the reduction would change its tree
+  if (params->persistent_kernel ||
+      isOptionEnabled(EnableOption::ReproducibleReduction)) {
+    return;
+  }
+  addUnrollCandidates(params, /*inner_reduction=*/true, candidates);
+  // Splits by block dimensions that are not static refer to the launch
+  // parameters, so any of them is valid
+  if (!params->static_bdimx) {
+    addBlockDimCandidates(params, ParallelType::TIDx, candidates);
+  }
+  if (!params->static_bdimy) {
+    addBlockDimCandidates(params, ParallelType::TIDy, candidates);
+  }
+}
+
+void addInnerPersistentCandidates(
+    const std::shared_ptr<ReductionParams>& params,
+    Candidates& candidates) {
+  // blockDim.x is the remainder of the reduction split by the persistent
+  // batches, unless it is static
+  if (params->persistent_kernel && params->fastest_dim &&
+      !params->static_bdimx) {
+    const int64_t batches = params->batches_per_block_inner_reduction;
+    for (auto new_batches : {batches * 2, batches / 2}) {
+      if (new_batches < 1) {
+        continue;
+      }
+      auto candidate = cloneAs(*params);
+      candidate->batches_per_block_inner_reduction = new_batches;
+      candidates.push_back(candidate);
+    }
+  }
+  addUnrollCandidates(params, /*inner_reduction=*/false, candidates);
+}
+
+} // namespace
+
+std::vector<std::shared_ptr<HeuristicParams>> getAutotuneCandidates(
+    ScheduleHeuristic heuristic,
+    const std::shared_ptr<HeuristicParams>& params,
+    int64_t max_candidates) {
+  NVF_ERROR(params != nullptr);
+  NVF_ERROR(max_candidates > 0, "At least one candidate is required");
+  Candidates candidates{params};
+  if (auto pparams = std::dynamic_pointer_cast<PointwiseParams>(params);
+      pparams != nullptr && heuristic == ScheduleHeuristic::PointWise) {
+    addPointwiseCandidates(*pparams, candidates);
+  } else if (auto rparams = std::dynamic_pointer_cast<ReductionParams>(params);
+             rparams != nullptr) {
+    if (heuristic == ScheduleHeuristic::Reduction) {
+      addReductionCandidates(rparams, candidates);
+    } else if (heuristic == ScheduleHeuristic::InnerPersistent) {
+      addInnerPersistentCandidates(rparams, candidates);
+    }
+  }
+
+  // Drop duplicates, e.g. unrolling instead of vectorizing by 1
+  Candidates unique_candidates;
+  for (const auto& candidate : candidates) {
+    if ((int64_t)unique_candidates.size() == max_candidates) {
+      break;
+    }
+    if (std::none_of(
+            unique_candidates.begin(),
+            unique_candidates.end(),
+            [&candidate](const std::shared_ptr<HeuristicParams>& other) {
+              return other->sameAs(candidate) &&
+                  other->lparams == candidate->lparams;
+            })) {
+      unique_candidates.push_back(candidate);
+    }
+  }
+  return unique_candidates;
+}
+
+std::shared_ptr<HeuristicParams> getRegisterPressureFallback(
+    ScheduleHeuristic heuristic,
+    const std::shared_ptr<HeuristicParams>& params) {
+  NVF_ERROR(params != nullptr);
+  if (auto pparams = std::dynamic_pointer_cast<PointwiseParams>(params);
+      pparams != nullptr && heuristic == ScheduleHeuristic::PointWise) {
+    if (pparams->unroll_factor > 1) {
+      auto fallback = cloneAs(*pparams);
+      fallback->unroll_factor /= 2;
+      fallback->vectorize = pparams->vectorize && fallback->unroll_factor > 1;
+      return fallback;
+    }
+    return nullptr;
+  }
+
+  auto rparams = std::dynamic_pointer_cast<ReductionParams>(params);
+  if (rparams == nullptr) {
+    return nullptr;
+  }
+  if (heuristic == ScheduleHeuristic::Reduction) {
+    if (rparams->persistent_kernel ||
+        isOptionEnabled(EnableOption::ReproducibleReduction)) {
+      return nullptr;
+    }
+    if (rparams->unroll_factor_inner_reduction > 1) {
+      auto fallback = cloneAs(*rparams);
+      fallback->unroll_factor_inner_reduction /= 2;
+      fallback->vectorize_inner_reduction =
+          rparams->vectorize_inner_reduction &&
+          fallback->unroll_factor_inner_reduction > 1;
+      return fallback;
+    }
+  } else if (heuristic == ScheduleHeuristic::InnerPersistent) {
+    // Each persistent batch is a buffer in registers
+    const int64_t bdimx = rparams->lparams.getRawVal(ParallelType::TIDx);
+    if (rparams->persistent_kernel && rparams->fastest_dim &&
+        !rparams->static_bdimx &&
+        rparams->batches_per_block_inner_reduction > 1 &&
+        (bdimx == LaunchParams::UNINITIALIZED_VAL ||
+         rparams->lparams.nThreads() * 2 <= kMaxThreadsPerBlock)) {
+      auto fallback = cloneAs(*rparams);
+      fallback->batches_per_block_inner_reduction /= 2;
+      return fallback;
+    }
+  } else {
+    return nullptr;
+  }
+  if (rparams->unroll_factor_iter_dom > 1) {
+    auto fallback = cloneAs(*rparams);
+    fallback->unroll_factor_iter_dom /= 2;
+    fallback->vectorize_iter_dom =
+        rparams->vectorize_iter_dom && fallback->unroll_factor_iter_dom > 1;
+    return fallback;
+  }
+  return nullptr;
+}
+
+void scheduleAutotuneCandidate(
+    ScheduleHeuristic heuristic,
+    Fusion* fusion,
+    const HeuristicParams& params) {
+  switch (heuristic) {
+    case ScheduleHeuristic::PointWise:
+      schedulePointwise(fusion, *params.as<PointwiseParams>());
+      return;
+    case ScheduleHeuristic::Reduction:
+      scheduleReduction(fusion, *params.as<ReductionParams>());
+      return;
+    case ScheduleHeuristic::InnerPersistent:
+      scheduleInnerPersistentKernel(fusion, *params.as<ReductionParams>());
+      return;
+    default:
+      NVF_ERROR(false, "No autotuning candidates for ", heuristic);
+  }
+}
+
+} // namespace nvfuser
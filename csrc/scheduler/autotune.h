@@ -0,0 +1,64 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <fusion.h>
+#include <scheduler/heuristic.h>
+#include <scheduler/heuristic_types.h>
+#include <visibility.h>
+
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace nvfuser {
+
+//! Returns the heuristic parameters the autotuner benchmarks for a kernel.
+//! The first candidate is params, the analytic choice of the scheduler. The
+//! others only vary knobs that keep the schedule valid for the inputs params
+//! was computed for:
+//!  - PointWise: smaller unroll and vectorization factors, and unrolling
+//!    instead of vectorizing
+//!  - Reduction: smaller unroll factors, and doubled or halved block
+//!    dimensions that are bound at launch time
+//!  - InnerPersistent: doubled or halved persistent batches, which in turn
+//!    halve or double blockDim.x, and smaller unroll factors of the
+//!    iteration domain
+//! Other heuristics only have the analytic candidate.
+//!
+//! The order of the candidates only depends on params and the first
+//! max_candidates are returned, so a candidate can be referred to by its
+//! index, e.g. in the serde cache. See EnableOption::Autotune.
+NVF_API std::vector<std::shared_ptr<HeuristicParams>> getAutotuneCandidates(
+    ScheduleHeuristic heuristic,
+    const std::shared_ptr<HeuristicParams>& params,
+    int64_t max_candidates = std::numeric_limits<int64_t>::max());
+
+//! Returns the parameters to fall back to when the kernel of params would
+//! use too many registers, or nullptr if there are none. The fallback
+//! changes one knob among the ones of getAutotuneCandidates, preferring the
+//! one that saves the most registers:
+//!  - PointWise: halved unroll factor
+//!  - Reduction: halved unroll factor of the inner reduction, then of the
+//!    iteration domain
+//!  - InnerPersistent: halved persistent batches, which doubles blockDim.x,
+//!    then halved unroll factor of the iteration domain
+//! See EnableOption::RegisterPressureFallback.
+NVF_API std::shared_ptr<HeuristicParams> getRegisterPressureFallback(
+    ScheduleHeuristic heuristic,
+    const std::shared_ptr<HeuristicParams>& params);
+
+//! Schedules fusion with a candidate of getAutotuneCandidates, like the
+//! SchedulerEntry of heuristic does with its own parameters. Also schedules
+//! the parameters of getRegisterPressureFallback.
+NVF_API void scheduleAutotuneCandidate(
+    ScheduleHeuristic heuristic,
+    Fusion* fusion,
+    const HeuristicParams& params);
+
+} // namespace nvfuser
@@ -14,6 +14,9 @@
 #include <scheduler/cache_policy_refiner.h>
 #include <scheduler/debug_utils.h>
 
+#include <unordered_map>
+#include <vector>
+
 namespace nvfuser {
 
 namespace {
@@ -118,42 +121,68 @@ const Expr* findExpand(const LoadStoreOp* ldst) {
   return nullptr;
 }
 
-// Returns true if the cache policy is changed.
-bool refineCachePolicy(LoadStoreOp* ldst) {
+// Returns true if the cache policy is changed. `num_loads` is the number of
+// global-to-local loads of the input of `ldst` in the fusion.
+bool refineCachePolicy(LoadStoreOp* ldst, int64_t num_loads) {
   vlog("Processing ", ldst->toString());
 
+  auto target_cache_op = CacheOp::AllLevels;
   const Expr* expand = findExpand(ldst);
-  if (expand == nullptr) {
+  if (expand != nullptr) {
     vlog(
-        "Skipped ",
+        "Changed the cache op of ",
         ldst->toString(),
-        " because we cannot find the using expand.");
-    return false;
+        " from ",
+        ldst->cacheOp(),
+        " to ",
+        target_cache_op,
+        " because it is expanded by ",
+        expand->toString());
+    ldst->setCacheOp(target_cache_op);
+    return true;
+  }
+
+  // The other loads of the same tensor, e.g. the recomputation of a
+  // projected persistent buffer, read the data again, so it shouldn't be
+  // evicted first
+  if (num_loads > 1) {
+    vlog(
+        "Changed the cache op of ",
+        ldst->toString(),
+        " from ",
+        ldst->cacheOp(),
+        " to ",
+        target_cache_op,
+        " because its input is loaded ",
+        num_loads,
+        " times.");
+    ldst->setCacheOp(target_cache_op);
+    return true;
   }
 
-  auto target_cache_op = CacheOp::AllLevels;
   vlog(
-      "Changed the cache op of ",
+      "Skipped ",
       ldst->toString(),
-      " from ",
-      ldst->cacheOp(),
-      " to ",
-      target_cache_op,
-      " because it is expanded by ",
-      expand->toString());
-  ldst->setCacheOp(target_cache_op);
-  return true;
+      " because we cannot find the using expand or another load.");
+  return false;
 }
 
 } // namespace
 
 void refineCachePolicy(Fusion* fusion) {
+  // Currently, we only change cache policy for global->local loads.
+  std::vector<LoadStoreOp*> loads;
+  std::unordered_map<Val*, int64_t> num_loads;
   for (Expr* expr : fusion->exprs()) {
-    // Currently, we only change cache policy for global->local loads.
     if (isLoadGlobalToLocal(expr)) {
-      refineCachePolicy(expr->as<LoadStoreOp>());
+      auto ldst = expr->as<LoadStoreOp>();
+      loads.push_back(ldst);
+      ++num_loads[ldst->in()];
     }
   }
+  for (LoadStoreOp* ldst : loads) {
+    refineCachePolicy(ldst, num_loads.at(ldst->in()));
+  }
 }
 
 } // namespace nvfuser
@@ -0,0 +1,114 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+
+#include <fusion.h>
+#include <ir/all_nodes.h>
+#include <ir/utils.h>
+#include <options.h>
+#include <scheduler/debug_utils.h>
+#include <scheduler/expr_eval_sched.h>
+#include <scheduler/registry.h>
+
+namespace nvfuser {
+
+bool isATenEvaluatedOp(const Expr* expr) {
+  return expr->isOneOf<
+      MatmulOp,
+      GroupedMatmulOp,
+      SdpaFwdOp,
+      SdpaBwdOp,
+      ScanOp,
+      TopKOp,
+      ArgsortOp>();
+}
+
+namespace {
+
+// Whether the fusion only computes pointwise ops of CPU scalars, which are
+// cheap to evaluate with ATen on the CPU
+bool isHostEvaluated(Fusion* fusion) {
+  if (isOptionDisabled(DisableOption::HostEvaluation)) {
+    return false;
+  }
+  const auto inputs = ir_utils::filterByType<TensorView>(fusion->inputs());
+  if (inputs.empty() ||
+      !std::all_of(inputs.begin(), inputs.end(), [](TensorView* tv) {
+        return tv->isCpuScalar();
+      })) {
+    return false;
+  }
+  const std::vector<Expr*> exprs = fusion->exprs();
+  return std::all_of(exprs.begin(), exprs.end(), [](Expr* expr) {
+    if (auto ldst = dynamic_cast<LoadStoreOp*>(expr)) {
+      return ldst->opType() == LoadStoreOpType::Set;
+    }
+    return expr->isOneOf<
+        UnaryOp,
+        BinaryOp,
+        TernaryOp,
+        BroadcastOp,
+        SqueezeOp,
+        ExpandOp>();
+  });
+}
+
+} // namespace
+
+ExprEvalScheduler::ExprEvalScheduler(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache)
+    : SchedulerEntry(heuristicType()) {
+  params_ =
+      std::make_shared<ExprEvalHeuristic>("", runtime_info.getIndexType());
+}
+
+bool ExprEvalScheduler::canScheduleCompileTime(Fusion* fusion) {
+  const std::vector<Expr*> exprs = fusion->exprs();
+  if ((exprs.size() != 1 || !isATenEvaluatedOp(exprs.front())) &&
+      !isHostEvaluated(fusion)) {
+    scheduler_debug_utils::canScheduleRejectReason(
+        heuristicType(),
+        "Fusion is neither a single ATen-evaluated op nor of CPU scalars");
+    return false;
+  }
+  return true;
+}
+
+bool ExprEvalScheduler::canScheduleRunTime(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache) {
+  if (!isHostEvaluated(fusion)) {
+    return true;
+  }
+  ExpressionEvaluator& ee = runtime_info.expressionEvaluator();
+  for (auto tv : ir_utils::filterByType<TensorView>(fusion->outputs())) {
+    int64_t numel = 1;
+    for (auto id : TensorDomain::noReductions(tv->getMaybeRFactorDomain())) {
+      Val* extent =
+          id->hasExpandedExtent() ? id->expandedExtent() : id->extent();
+      numel *= ee.evaluate(extent).as<int64_t>();
+    }
+    if (numel > kMaxHostEvaluatedNumel) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          heuristicType(), "Output is too large to be evaluated on the host");
+      return false;
+    }
+  }
+  return true;
+}
+
+void ExprEvalScheduler::schedule(Fusion* fusion) {
+  for (Val* out : fusion->outputs()) {
+    fusion->aliasOutputToInput(
+        out, /*input=*/nullptr, AllocationType::Evaluate);
+  }
+}
+
+} // namespace nvfuser
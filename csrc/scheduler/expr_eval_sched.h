@@ -0,0 +1,84 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <scheduler/heuristic.h>
+#include <scheduler/registry.h>
+
+namespace nvfuser {
+
+class Fusion;
+class SchedulerRuntimeInfo;
+class HeuristicSummary;
+
+//! Returns whether expr has no generated code and is only evaluated with
+//! ATen, e.g., MatmulOp, SDPA, scans and sorting. Schedulers generating
+//! kernels reject fusions containing such ops.
+bool isATenEvaluatedOp(const Expr* expr);
+
+//! Fusions of CPU scalars with at most this many elements in each output are
+//! evaluated on the host, see ExprEvalScheduler
+constexpr int64_t kMaxHostEvaluatedNumel = 16;
+
+//! ExprEval scheduler represents the case where a segment holding a single
+//! ATen-evaluated op is not compiled. Its outputs are computed with
+//! ExpressionEvaluator, i.e., by calling the ATen function of the op, while
+//! the surrounding segments of the fusion are still generated. The segment
+//! outputs are consumed by the following segments with whatever strides the
+//! ATen function returns.
+//!
+//! It also takes tiny fusions and segments whose tensor inputs are all CPU
+//! scalars, e.g., step counters and loss scale updates, unless
+//! DisableOption::HostEvaluation is set. Their pointwise ops are evaluated
+//! with ATen on the CPU, which is cheaper than compiling and launching a
+//! kernel, and the outputs are copied to the device without synchronizing.
+//! Tiny fusions of device tensors are still generated, as a single fused
+//! kernel is cheaper than an ATen launch per op.
+class ExprEvalScheduler : public SchedulerEntry {
+ public:
+  explicit ExprEvalScheduler(
+      Fusion* fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      HeuristicSummary* data_cache = nullptr);
+
+  //! Check if the fusion is a single ATen-evaluated op or can be evaluated
+  //! on the host
+  static bool canScheduleCompileTime(Fusion* fusion);
+
+  //! Check that the outputs of a host-evaluated fusion are tiny
+  static bool canScheduleRunTime(
+      Fusion* fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      HeuristicSummary* data_cache = nullptr);
+
+  constexpr static ScheduleHeuristic heuristicType() {
+    return ScheduleHeuristic::ExprEval;
+  }
+
+  void schedule(Fusion* fusion) override;
+};
+
+//! Provides a dummy heuristic type to ensure
+//!  unified interface on ExprEval scheduler.
+class ExprEvalHeuristic : public HeuristicParams {
+ public:
+  using HeuristicParams::HeuristicParams;
+
+  size_t hash() const override {
+    return 0;
+  }
+  std::shared_ptr<HeuristicParams> clone() const override {
+    return std::make_shared<ExprEvalHeuristic>();
+  }
+  bool sameAs(const std::shared_ptr<HeuristicParams>& other) const override {
+    auto other_casted = std::dynamic_pointer_cast<ExprEvalHeuristic>(other);
+    return other_casted != nullptr && other_casted->cparams == cparams;
+  };
+};
+
+} // namespace nvfuser
@@ -21,6 +21,11 @@ class HeuristicParams : public PolymorphicBase {
   LaunchParams lparams;
   CompileParams cparams;
 
+  //! Signature of the problem the parameters were computed for, which keys
+  //! them in the heuristic DB. Only set when EnableOption::HeuristicDb is
+  //! enabled, and not part of hash() and sameAs().
+  std::string problem_signature;
+
   virtual std::string toString() const {
     return "Undefined Heuristic Params";
   }
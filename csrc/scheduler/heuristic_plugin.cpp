@@ -0,0 +1,515 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+
+#include <scheduler/heuristic_plugin.h>
+
+#include <ir/interface_nodes.h>
+#include <kernel_db/heuristic_db.h>
+#include <options.h>
+#include <scheduler/registry.h>
+#include <sys_utils.h>
+#include <utils.h>
+
+#include <ATen/cuda/CUDAContext.h>
+#include <c10/util/irange.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+
+namespace nvfuser {
+
+namespace heuristic_plugin {
+
+namespace {
+
+std::mutex plugin_mutex;
+
+//! Looks up the factory functions of a plugin library on first use. A
+//! missing symbol means that the plugin doesn't override that scheduler.
+static class PluginInterface : LibraryLoader {
+ public:
+  PluginInterface() {
+    const char* envvar = getNvFuserEnv("HEURISTIC_PLUGIN");
+    if (envvar != nullptr) {
+      setFilename(envvar);
+    }
+  }
+
+  ~PluginInterface() = default;
+
+  bool available() const {
+    return !filename().empty();
+  }
+
+  template <typename ConfigType>
+  using FactoryPointer = std::unique_ptr<ConfigType> (*)();
+
+  FactoryPointer<PointwiseConfig> pointwiseFactory() {
+    return getFactory<PointwiseConfig>("makePointwiseConfig");
+  }
+
+  FactoryPointer<ReductionConfig> reductionFactory() {
+    return getFactory<ReductionConfig>("makeReductionConfig");
+  }
+
+  FactoryPointer<TransposeConfig> transposeFactory() {
+    return getFactory<TransposeConfig>("makeTransposeConfig");
+  }
+
+ private:
+  template <typename ConfigType>
+  FactoryPointer<ConfigType> getFactory(const char* symbol_name) {
+    if (!available()) {
+      return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(plugin_mutex);
+    auto it = symbols_.find(symbol_name);
+    if (it == symbols_.end()) {
+      void* symbol = nullptr;
+      try {
+        symbol = getSymbol(symbol_name);
+      } catch (const std::exception&) {
+        // The plugin only overrides some of the schedulers
+      }
+      it = symbols_.emplace(symbol_name, symbol).first;
+    }
+    return (FactoryPointer<ConfigType>)it->second;
+  }
+
+  std::unordered_map<std::string, void*> symbols_;
+} plugin;
+
+thread_local ConfigFactories config_factories;
+// Like matmul_heuristic_plugin, a flag indicates whether the factories of the
+// shared library have been overridden by ConfigFactoryGuard.
+thread_local bool config_factories_modified = false;
+
+template <typename ConfigType>
+std::unique_ptr<ConfigType> makeConfig(
+    const std::function<std::unique_ptr<ConfigType>()>& guard_factory,
+    PluginInterface::FactoryPointer<ConfigType> plugin_factory) {
+  if (config_factories_modified) {
+    return guard_factory ? guard_factory() : nullptr;
+  }
+  return plugin_factory != nullptr ? (*plugin_factory)() : nullptr;
+}
+
+//! Replays the knobs that the heuristic DB recorded for a problem, see
+//! getConfigKnobs
+class DbPointwiseConfig : public PointwiseConfig {
+ public:
+  explicit DbPointwiseConfig(std::vector<int64_t> knobs)
+      : knobs_(std::move(knobs)) {}
+
+  void configure() override {
+    vectorize = knobs_.at(0) != 0;
+    unroll_factor = (uint8_t)knobs_.at(1);
+  }
+
+ private:
+  std::vector<int64_t> knobs_;
+};
+
+class DbReductionConfig : public ReductionConfig {
+ public:
+  explicit DbReductionConfig(std::vector<int64_t> knobs)
+      : knobs_(std::move(knobs)) {}
+
+  void configure() override {
+    unroll_factor_inner_reduction = (uint8_t)knobs_.at(0);
+    vectorize_inner_reduction = knobs_.at(1) != 0;
+    unroll_factor_iter_dom = (uint8_t)knobs_.at(2);
+    vectorize_iter_dom = knobs_.at(3) != 0;
+    batches_per_block_inner_reduction = (uint16_t)knobs_.at(4);
+    batches_per_block_outer_reduction = (uint16_t)knobs_.at(5);
+    bdimx = (int32_t)knobs_.at(6);
+    bdimy = (int32_t)knobs_.at(7);
+  }
+
+ private:
+  std::vector<int64_t> knobs_;
+};
+
+class DbTransposeConfig : public TransposeConfig {
+ public:
+  explicit DbTransposeConfig(std::vector<int64_t> knobs)
+      : knobs_(std::move(knobs)) {}
+
+  void configure() override {
+    vectorize_factor1 = (uint8_t)knobs_.at(0);
+    vectorize_factor2 = (uint8_t)knobs_.at(1);
+  }
+
+ private:
+  std::vector<int64_t> knobs_;
+};
+
+constexpr size_t num_pointwise_knobs = 2;
+constexpr size_t num_reduction_knobs = 8;
+constexpr size_t num_transpose_knobs = 2;
+
+//! Returns a config replaying the fastest knobs that the heuristic DB
+//! recorded for signature, or nullptr if there are none
+template <typename DbConfigType>
+std::unique_ptr<DbConfigType> makeDbConfig(
+    const std::string& signature,
+    size_t num_knobs) {
+  HeuristicDb* db = HeuristicDb::get();
+  if (db == nullptr || signature.empty()) {
+    return nullptr;
+  }
+  std::optional<std::vector<int64_t>> knobs = db->best(signature);
+  // Records of an older layout of the knobs are ignored
+  if (!knobs.has_value() || knobs->size() != num_knobs) {
+    return nullptr;
+  }
+  return std::make_unique<DbConfigType>(std::move(*knobs));
+}
+
+std::unique_ptr<PointwiseConfig> makePointwiseConfig() {
+  return makeConfig(config_factories.pointwise, plugin.pointwiseFactory());
+}
+
+std::unique_ptr<ReductionConfig> makeReductionConfig() {
+  return makeConfig(config_factories.reduction, plugin.reductionFactory());
+}
+
+std::unique_ptr<TransposeConfig> makeTransposeConfig() {
+  return makeConfig(config_factories.transpose, plugin.transposeFactory());
+}
+
+//! Sets the problem signature of params if the heuristic DB or the perf
+//! monitor is enabled
+void setProblemSignature(
+    HeuristicParams& params,
+    const ProblemDescription& problem) {
+  if (HeuristicDb::get() != nullptr ||
+      isOptionEnabled(EnableOption::PerfMonitor)) {
+    params.problem_signature = problemSignature(problem);
+  }
+}
+
+char dtypeToChar(DataType dtype) {
+  if (dtype == DataType::Half) {
+    return 'H';
+  } else if (dtype == DataType::BFloat16) {
+    return 'T';
+  } else if (dtype == DataType::Float) {
+    return 'S';
+  } else if (dtype == DataType::Double) {
+    return 'D';
+  } else if (dtype == DataType::Float8_e4m3fn) {
+    return 'Q';
+  } else if (dtype == DataType::Float8_e5m2) {
+    return 'R';
+  } else if (dtype == DataType::Int32) {
+    return 'I';
+  } else if (dtype == DataType::Int8) {
+    return 'B';
+  } else if (dtype == DataType::ComplexFloat) {
+    return 'C';
+  } else if (dtype == DataType::ComplexDouble) {
+    return 'Z';
+  }
+  return '?';
+}
+
+//! Checks that factor is a valid vectorization factor of a kernel whose
+//! largest valid factor is max_factor. Invalid factors of a plugin are
+//! errors, while those replayed from the heuristic DB, e.g. recorded for
+//! differently aligned inputs, are ignored.
+bool checkVectorizationFactor(
+    int64_t factor,
+    int64_t max_factor,
+    const char* name,
+    bool from_db) {
+  const bool valid = factor >= 1 && max_factor % factor == 0;
+  NVF_CHECK(
+      valid || from_db,
+      "Heuristic plugin returned ",
+      name,
+      " = ",
+      factor,
+      ", which does not divide the largest valid vectorization factor ",
+      max_factor);
+  return valid;
+}
+
+} // namespace
+
+bool hasPlugin(ProblemDescription::Kernel kernel) {
+  // Without a plugin, the schedulers may replay the heuristic DB
+  if (HeuristicDb::get() != nullptr) {
+    return true;
+  }
+  if (config_factories_modified) {
+    switch (kernel) {
+      case ProblemDescription::Kernel::PointWise:
+        return (bool)config_factories.pointwise;
+      case ProblemDescription::Kernel::Transpose:
+        return (bool)config_factories.transpose;
+      default:
+        return (bool)config_factories.reduction;
+    }
+  }
+  switch (kernel) {
+    case ProblemDescription::Kernel::PointWise:
+      return plugin.pointwiseFactory() != nullptr;
+    case ProblemDescription::Kernel::Transpose:
+      return plugin.transposeFactory() != nullptr;
+    default:
+      return plugin.reductionFactory() != nullptr;
+  }
+}
+
+std::optional<ProblemDescription> makeProblemDescription(
+    ProblemDescription::Kernel kernel,
+    TensorView* reference,
+    SchedulerRuntimeInfo& runtime_info) {
+  ProblemDescription problem;
+  problem.kernel = kernel;
+
+  const std::vector<IterDomain*>& domain = reference->getMaybeRFactorDomain();
+  if (domain.size() > ProblemDescription::max_dims) {
+    return std::nullopt;
+  }
+  problem.num_dims = (uint8_t)domain.size();
+  for (auto i : c10::irange(domain.size())) {
+    auto extent =
+        runtime_info.expressionEvaluator().evaluate(domain[i]->extent());
+    NVF_ERROR(
+        extent.hasValue(),
+        "Error inferring size for heuristic plugin: ",
+        domain[i]->extent()->toInlineString());
+    problem.sizes[i] = extent.as<int64_t>();
+    if (domain[i]->isReduction()) {
+      problem.reduction_axes |= (uint8_t)(1 << i);
+    }
+  }
+  problem.dtype = dtypeToChar(reference->getDataType().value());
+
+  const cudaDeviceProp* device_prop = at::cuda::getCurrentDeviceProperties();
+  problem.device.major = (uint8_t)device_prop->major;
+  problem.device.minor = (uint8_t)device_prop->minor;
+  problem.device.sm_count = (uint16_t)device_prop->multiProcessorCount;
+  problem.device.max_threads_per_sm =
+      (uint16_t)device_prop->maxThreadsPerMultiProcessor;
+  problem.device.registers_per_sm =
+      (uint32_t)device_prop->regsPerMultiprocessor;
+  problem.device.max_shared_memory_per_block =
+      (uint32_t)device_prop->sharedMemPerBlockOptin;
+  return problem;
+}
+
+std::string problemSignature(const ProblemDescription& problem) {
+  std::stringstream ss;
+  ss << "kernel=" << (int)problem.kernel << ";sizes=";
+  for (auto i : c10::irange(problem.num_dims)) {
+    ss << (i > 0 ? "," : "") << problem.sizes[i];
+  }
+  ss << ";reduction_axes=" << (int)problem.reduction_axes
+     << ";dtype=" << problem.dtype
+     << ";max_input_dtype_size=" << (int)problem.max_input_dtype_size
+     << ";n_tensor_inputs=" << problem.n_tensor_inputs
+     << ";max_vectorization_factor=" << (int)problem.max_vectorization_factor
+     << ";total_reduction_numel=" << problem.total_reduction_numel
+     << ";total_iteration_numel=" << problem.total_iteration_numel
+     << ";inner_most_dimension_numel=" << problem.inner_most_dimension_numel
+     << ";fastest_dim_reduction=" << problem.fastest_dim_reduction
+     << ";max_persistent_buffer_size=" << problem.max_persistent_buffer_size
+     << ";device=" << (int)problem.device.major << "."
+     << (int)problem.device.minor << "," << problem.device.sm_count << ","
+     << problem.device.max_threads_per_sm << ","
+     << problem.device.registers_per_sm << ","
+     << problem.device.max_shared_memory_per_block;
+  return ss.str();
+}
+
+std::vector<int64_t> getConfigKnobs(const HeuristicParams& params) {
+  if (auto pparams = dynamic_cast<const PointwiseParams*>(&params)) {
+    return {pparams->vectorize, pparams->unroll_factor};
+  }
+  if (auto rparams = dynamic_cast<const ReductionParams*>(&params)) {
+    return {
+        rparams->unroll_factor_inner_reduction,
+        rparams->vectorize_inner_reduction,
+        rparams->unroll_factor_iter_dom,
+        rparams->vectorize_iter_dom,
+        rparams->batches_per_block_inner_reduction,
+        rparams->batches_per_block_outer_reduction,
+        rparams->lparams.getRawVal(ParallelType::TIDx),
+        rparams->lparams.getRawVal(ParallelType::TIDy)};
+  }
+  if (auto tparams = dynamic_cast<const TransposeParams*>(&params)) {
+    return {tparams->vectorize_factor1, tparams->vectorize_factor2};
+  }
+  return {};
+}
+
+bool updatePointwiseParams(
+    PointwiseParams& params,
+    const ProblemDescription& problem) {
+  setProblemSignature(params, problem);
+  std::unique_ptr<PointwiseConfig> config = makePointwiseConfig();
+  const bool from_db = config == nullptr;
+  if (from_db) {
+    config = makeDbConfig<DbPointwiseConfig>(
+        params.problem_signature, num_pointwise_knobs);
+  }
+  if (config == nullptr) {
+    return false;
+  }
+  config->problem = problem;
+  config->vectorize = params.vectorize;
+  config->unroll_factor = (uint8_t)params.unroll_factor;
+
+  // Execute the user-provided heuristic
+  config->configure();
+
+  NVF_CHECK(
+      config->unroll_factor >= 1 || from_db,
+      "Heuristic plugin returned unroll_factor = 0");
+  if (config->unroll_factor < 1 ||
+      (config->vectorize &&
+       !checkVectorizationFactor(
+           config->unroll_factor,
+           problem.max_vectorization_factor,
+           "unroll_factor",
+           from_db))) {
+    return false;
+  }
+  params.vectorize = config->vectorize;
+  params.unroll_factor = config->unroll_factor;
+  return true;
+}
+
+bool updateReductionParams(
+    ReductionParams& params,
+    const ProblemDescription& problem) {
+  setProblemSignature(params, problem);
+  std::unique_ptr<ReductionConfig> config = makeReductionConfig();
+  const bool from_db = config == nullptr;
+  if (from_db) {
+    config = makeDbConfig<DbReductionConfig>(
+        params.problem_signature, num_reduction_knobs);
+  }
+  if (config == nullptr) {
+    return false;
+  }
+  config->problem = problem;
+  config->unroll_factor_inner_reduction =
+      (uint8_t)params.unroll_factor_inner_reduction;
+  config->vectorize_inner_reduction = params.vectorize_inner_reduction;
+  config->unroll_factor_iter_dom = (uint8_t)params.unroll_factor_iter_dom;
+  config->vectorize_iter_dom = params.vectorize_iter_dom;
+  config->batches_per_block_inner_reduction =
+      (uint16_t)params.batches_per_block_inner_reduction;
+  config->batches_per_block_outer_reduction =
+      (uint16_t)params.batches_per_block_outer_reduction;
+  config->bdimx = (int32_t)params.lparams.getRawVal(ParallelType::TIDx);
+  config->bdimy = (int32_t)params.lparams.getRawVal(ParallelType::TIDy);
+
+  // Execute the user-provided heuristic
+  config->configure();
+
+  const bool valid_factors = config->unroll_factor_inner_reduction >= 1 &&
+      config->unroll_factor_iter_dom >= 1 &&
+      config->batches_per_block_inner_reduction >= 1 &&
+      config->batches_per_block_outer_reduction >= 1;
+  NVF_CHECK(
+      valid_factors || from_db, "Heuristic plugin returned a factor of 0");
+  if (!valid_factors ||
+      (config->vectorize_inner_reduction &&
+       !checkVectorizationFactor(
+           config->unroll_factor_inner_reduction,
+           problem.max_vectorization_factor,
+           "unroll_factor_inner_reduction",
+           from_db)) ||
+      (config->vectorize_iter_dom &&
+       !checkVectorizationFactor(
+           config->unroll_factor_iter_dom,
+           problem.max_vectorization_factor,
+           "unroll_factor_iter_dom",
+           from_db))) {
+    return false;
+  }
+  params.unroll_factor_inner_reduction = config->unroll_factor_inner_reduction;
+  params.vectorize_inner_reduction = config->vectorize_inner_reduction;
+  params.unroll_factor_iter_dom = config->unroll_factor_iter_dom;
+  params.vectorize_iter_dom = config->vectorize_iter_dom;
+  params.batches_per_block_inner_reduction =
+      config->batches_per_block_inner_reduction;
+  params.batches_per_block_outer_reduction =
+      config->batches_per_block_outer_reduction;
+  const LaunchParams& lparams = params.lparams;
+  params.lparams = LaunchParams(
+      lparams.getRawVal(ParallelType::BIDx),
+      lparams.getRawVal(ParallelType::BIDy),
+      lparams.getRawVal(ParallelType::BIDz),
+      config->bdimx,
+      config->bdimy,
+      lparams.getRawVal(ParallelType::TIDz));
+  return true;
+}
+
+bool updateTransposeParams(
+    TransposeParams& params,
+    const ProblemDescription& problem) {
+  setProblemSignature(params, problem);
+  std::unique_ptr<TransposeConfig> config = makeTransposeConfig();
+  const bool from_db = config == nullptr;
+  if (from_db) {
+    config = makeDbConfig<DbTransposeConfig>(
+        params.problem_signature, num_transpose_knobs);
+  }
+  if (config == nullptr) {
+    return false;
+  }
+  config->problem = problem;
+  config->vectorize_factor1 = (uint8_t)params.vectorize_factor1;
+  config->vectorize_factor2 = (uint8_t)params.vectorize_factor2;
+
+  // Execute the user-provided heuristic
+  config->configure();
+
+  if (!checkVectorizationFactor(
+          config->vectorize_factor1,
+          params.vectorize_factor1,
+          "vectorize_factor1",
+          from_db) ||
+      !checkVectorizationFactor(
+          config->vectorize_factor2,
+          params.vectorize_factor2,
+          "vectorize_factor2",
+          from_db)) {
+    return false;
+  }
+  params.vectorize_factor1 = config->vectorize_factor1;
+  params.vectorize_factor2 = config->vectorize_factor2;
+  return true;
+}
+
+ConfigFactoryGuard::ConfigFactoryGuard(ConfigFactories factories)
+    : prev_factories_(config_factories),
+      prev_factories_modified_(config_factories_modified) {
+  config_factories = std::move(factories);
+  config_factories_modified = true;
+}
+
+ConfigFactoryGuard::~ConfigFactoryGuard() {
+  config_factories = prev_factories_;
+  config_factories_modified = prev_factories_modified_;
+}
+
+} // namespace heuristic_plugin
+
+} // namespace nvfuser
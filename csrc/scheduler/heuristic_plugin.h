@@ -0,0 +1,107 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <ir/interface_nodes.h>
+#include <scheduler/heuristic_plugin_api.h>
+#include <scheduler/pointwise_heuristic.h>
+#include <scheduler/reduction_heuristic.h>
+#include <scheduler/transpose_heuristic.h>
+#include <visibility.h>
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace nvfuser {
+
+class SchedulerRuntimeInfo;
+
+namespace heuristic_plugin {
+
+//! Returns true if ConfigFactoryGuard provides a factory for kernel, if the
+//! shared library given by the environment variable NVFUSER_HEURISTIC_PLUGIN
+//! exports one, or if the heuristic DB is enabled.
+bool hasPlugin(ProblemDescription::Kernel kernel);
+
+//! Returns the description of a kernel with the given reference tensor,
+//! filling in its shape, data type and the properties of the current device.
+//! The other fields are left to the caller. Returns std::nullopt if the
+//! reference has more than ProblemDescription::max_dims dimensions.
+std::optional<ProblemDescription> makeProblemDescription(
+    ProblemDescription::Kernel kernel,
+    TensorView* reference,
+    SchedulerRuntimeInfo& runtime_info);
+
+//! Returns the key of problem in the heuristic DB
+NVF_API std::string problemSignature(const ProblemDescription& problem);
+
+//! Returns the knobs of params that the heuristic DB records, in the order
+//! of the fields of the config of their kernel. Block dimensions that are
+//! derived by the schedule are -1. Returns an empty vector for parameters
+//! that the plugin API doesn't cover.
+NVF_API std::vector<int64_t> getConfigKnobs(const HeuristicParams& params);
+
+//! If there is no plugin for the kernel of problem (see hasPlugin()) we
+//! return false. Otherwise, we use the plugin to modify the heuristic
+//! parameters in place. Without a plugin, the fastest knobs recorded in the
+//! heuristic DB for the problem are replayed if there are any, unless they
+//! are not valid for the problem. If the heuristic DB is enabled, the
+//! signature of problem is set on params in any case.
+bool updatePointwiseParams(
+    PointwiseParams& params,
+    const ProblemDescription& problem);
+
+bool updateReductionParams(
+    ReductionParams& params,
+    const ProblemDescription& problem);
+
+bool updateTransposeParams(
+    TransposeParams& params,
+    const ProblemDescription& problem);
+
+//! Define the types of the "make*Config" symbols
+using PointwiseConfigFactory =
+    std::function<std::unique_ptr<PointwiseConfig>()>;
+using ReductionConfigFactory =
+    std::function<std::unique_ptr<ReductionConfig>()>;
+using TransposeConfigFactory =
+    std::function<std::unique_ptr<TransposeConfig>()>;
+
+//! Factories of an imitated plugin. Empty factories leave the heuristics of
+//! their schedulers unchanged.
+struct ConfigFactories {
+  PointwiseConfigFactory pointwise;
+  ReductionConfigFactory reduction;
+  TransposeConfigFactory transpose;
+};
+
+//! This class can be used to imitate a plugin, like
+//! matmul_heuristic_plugin::KernelConfigFactoryGuard:
+//!
+//!   ConfigFactoryGuard cfg({.pointwise = []() {
+//!     return std::unique_ptr<PointwiseConfig>(new MyPointwiseConfig);
+//!   }});
+//!
+//! When cfg passes out of scope, the factories are reset to their prior
+//! values.
+class NVF_API ConfigFactoryGuard {
+ public:
+  explicit ConfigFactoryGuard(ConfigFactories factories);
+  ~ConfigFactoryGuard();
+
+ private:
+  ConfigFactories prev_factories_;
+  bool prev_factories_modified_;
+};
+
+} // namespace heuristic_plugin
+
+} // namespace nvfuser
@@ -0,0 +1,143 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+
+namespace nvfuser {
+
+namespace heuristic_plugin {
+
+//! This is the interface for plugging in heuristics of the pointwise,
+//! reduction, inner and outer persistent, and transpose schedulers. It
+//! mirrors matmul_heuristic_plugin, which does the same for the matmul
+//! scheduler. To plug in your own heuristics, create a dynamic library
+//! defining subclasses of the config structs below and overriding their
+//! `configure` methods. Export any of the following functions from it:
+//!
+//!   std::unique_ptr<PointwiseConfig> makePointwiseConfig();
+//!   std::unique_ptr<ReductionConfig> makeReductionConfig();
+//!   std::unique_ptr<TransposeConfig> makeTransposeConfig();
+//!
+//! Schedulers whose function is not exported keep their own heuristics.
+//! ReductionConfig is used for reduction, inner persistent and outer
+//! persistent kernels, which `problem.kernel` tells apart.
+//!
+//! If that library is located at /path/to/libfoo.so you can set
+//! NVFUSER_HEURISTIC_PLUGIN=/path/to/libfoo.so to use the plugin.
+//!
+//! Before `configure` is called, the parameters hold the values picked by
+//! the scheduler, so a plugin may only override some of them. nvFuser checks
+//! the vectorization factors against the problem. The other parameters are
+//! used as given.
+
+//! This is the information available to the plugin to determine the kernel
+//! configuration.
+struct ProblemDescription {
+  //! Explicit integer mapping for the kind of kernel
+  enum class Kernel {
+    PointWise = 0,
+    Reduction = 1,
+    InnerPersistent = 2,
+    OuterPersistent = 3,
+    Transpose = 4,
+  };
+  Kernel kernel = Kernel::PointWise;
+
+  static constexpr uint8_t max_dims = 8;
+  //! Extents of the reference tensor of the kernel, outermost first. Only
+  //! the first num_dims entries are set. Kernels with more than max_dims
+  //! dimensions are not passed to the plugin.
+  std::array<int64_t, max_dims> sizes = {};
+  uint8_t num_dims = 0;
+  //! Bit i is set if sizes[i] is reduced
+  uint8_t reduction_axes = 0;
+
+  //! Data type of the reference tensor using the letters of the precision
+  //! strings of matmul_heuristic_plugin, or '?' for other types
+  char dtype = 'S';
+  //! Size in bytes of the largest data type of the tensor inputs
+  uint8_t max_input_dtype_size = 4;
+  uint16_t n_tensor_inputs = 0;
+  //! Largest vectorization factor that is valid for the kernel. Not set for
+  //! transpose kernels, see TransposeConfig.
+  uint8_t max_vectorization_factor = 1;
+
+  //! Reduction and persistent kernels only
+  int64_t total_reduction_numel = 0;
+  int64_t total_iteration_numel = 0;
+  int64_t inner_most_dimension_numel = 0;
+  bool fastest_dim_reduction = false;
+  //! Persistent kernels only, in bytes
+  int64_t max_persistent_buffer_size = 0;
+
+  struct DeviceProperties {
+    uint8_t major = 0;
+    uint8_t minor = 0;
+    uint16_t sm_count = 0;
+    uint16_t max_threads_per_sm = 0;
+    uint32_t registers_per_sm = 0;
+    uint32_t max_shared_memory_per_block = 0;
+  } device;
+};
+
+struct PointwiseConfig {
+  ProblemDescription problem;
+
+  //! Vectorize by unroll_factor if true, otherwise unroll
+  bool vectorize = false;
+  uint8_t unroll_factor = 1;
+
+ public:
+  // This should be overridden to implement the actual heuristic logic
+  virtual void configure() = 0;
+
+  virtual ~PointwiseConfig() = default;
+};
+
+struct ReductionConfig {
+  ProblemDescription problem;
+
+  uint8_t unroll_factor_inner_reduction = 1;
+  bool vectorize_inner_reduction = false;
+  uint8_t unroll_factor_iter_dom = 1;
+  bool vectorize_iter_dom = false;
+  uint16_t batches_per_block_inner_reduction = 1;
+  uint16_t batches_per_block_outer_reduction = 1;
+  //! Block dimensions, -1 lets the schedule derive them
+  int32_t bdimx = -1;
+  int32_t bdimy = -1;
+
+ public:
+  // This should be overridden to implement the actual heuristic logic
+  virtual void configure() = 0;
+
+  virtual ~ReductionConfig() = default;
+};
+
+struct TransposeConfig {
+  ProblemDescription problem;
+
+  //! Vectorization factors of the two groups of inputs and outputs, whose
+  //! inner dimensions are transposed to each other. They must divide the
+  //! factors picked by the scheduler, which are the largest valid ones.
+  uint8_t vectorize_factor1 = 1;
+  uint8_t vectorize_factor2 = 1;
+
+ public:
+  // This should be overridden to implement the actual heuristic logic
+  virtual void configure() = 0;
+
+  virtual ~TransposeConfig() = default;
+};
+
+} // namespace heuristic_plugin
+
+} // namespace nvfuser
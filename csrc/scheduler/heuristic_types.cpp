@@ -27,8 +27,12 @@ std::string toString(ScheduleHeuristic sh) {
       return "inner_outer_persistent";
     case ScheduleHeuristic::Transpose:
       return "transpose";
+    case ScheduleHeuristic::MultiTensor:
+      return "multi_tensor";
     case ScheduleHeuristic::Matmul:
       return "matmul";
+    case ScheduleHeuristic::ExprEval:
+      return "expr_eval";
     case ScheduleHeuristic::None:
       return "none";
     default:
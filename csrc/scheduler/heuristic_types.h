@@ -55,16 +55,20 @@ enum class ScheduleHeuristic {
   InnerPersistent,
   InnerOuterPersistent,
   OuterPersistent,
-  Transpose
+  Transpose,
+  MultiTensor,
+  ExprEval
 };
 
 //! Define a schedule table to loop over all the heuristics in priority order.
-constexpr std::array<ScheduleHeuristic, 8> all_heuristics_in_priority_order = {
+constexpr std::array<ScheduleHeuristic, 10> all_heuristics_in_priority_order = {
+    ScheduleHeuristic::ExprEval,
     ScheduleHeuristic::NoOp,
     ScheduleHeuristic::Matmul,
     ScheduleHeuristic::Reduction,
     ScheduleHeuristic::Transpose,
     ScheduleHeuristic::PointWise,
+    ScheduleHeuristic::MultiTensor,
     ScheduleHeuristic::InnerPersistent,
     ScheduleHeuristic::OuterPersistent,
     ScheduleHeuristic::InnerOuterPersistent};
@@ -150,10 +150,11 @@ void swizzleSharedMemory(TensorView* shared_mem_tv) {
       shared_mem_tv->axis(-1 - skip)->extent()->evaluate().as<int64_t>();
 
   // Only tested for (1) ldmatrix access with sizeof(T) == 16bit (i.e.
-  // half/bfloat16) and (2) epilogue general access with sizeof(T) == 32bit
-  // (i.e. float)
+  // half/bfloat16) or 8bit (i.e. int8) and (2) epilogue general access with
+  // sizeof(T) == 32bit (i.e. float)
   const int64_t data_type_size = dataTypeSize(*shared_mem_tv->getDataType());
-  NVF_ERROR(data_type_size == 2 || data_type_size == 4);
+  NVF_ERROR(
+      data_type_size == 1 || data_type_size == 2 || data_type_size == 4);
 
   // For main loop, ldmatrix loads a n_rows x n_cols = 8 x 8 matrix each time.
   // For epilogue, threads in a warp is organized as 8 rows x 4 columns.
@@ -166,8 +167,9 @@ void swizzleSharedMemory(TensorView* shared_mem_tv) {
   //--20-21-22-23
   //--24-25-26-27
   //--28-29-30-31
+  // The rows of ldmatrix are 16 bytes wide, i.e. 16 items for 8-bit data.
   constexpr int64_t n_rows = 8;
-  constexpr int64_t n_cols = 8;
+  const int64_t n_cols = data_type_size == 1 ? 16 : 8;
 
   // Column size of the tile needs to be multiples of 8 for ldmatrix to work.
   NVF_ERROR(
@@ -216,7 +218,7 @@ void swizzleSharedMemory(TensorView* shared_mem_tv) {
    * has 8 rows, and each row has exactly one unit.
    */
 
-  constexpr int64_t items_per_unit = n_cols;
+  const int64_t items_per_unit = n_cols;
   const int64_t bytes_per_unit = items_per_unit * data_type_size;
   const int64_t words_per_unit = bytes_per_unit / smem_bytes_per_word;
   const int64_t num_megabanks = smem_banks / words_per_unit;
@@ -552,8 +554,14 @@ void scheduleProlog(
 
   mma_utils::orderTiledConcreteIdAsRoot(shared_mem_tv);
 
-  // Swizzle the shared memory data layout
-  swizzleSharedMemory(shared_mem_tv);
+  // Swizzle the shared memory data layout. The swizzle is only defined for
+  //  the ldmatrix rows of 16-bit and Int8 data and for 32-bit data, other
+  //  8-bit operands like fp8 weights keep their layout
+  const int64_t data_type_size = dataTypeSize(shared_mem_tv->dtype());
+  if (data_type_size == 2 || data_type_size == 4 ||
+      shared_mem_tv->dtype() == DataType::Int8) {
+    swizzleSharedMemory(shared_mem_tv);
+  }
   // Assuming we are always vectorizing smem write by 128b at the moment:
   //   TODO: would need a data-type and alignment dependent interface
   //    to support non-vectorizable shapes.
@@ -645,12 +653,109 @@ void scheduleOutputTensor(
       {c},
       {ParallelType::BIDx, ParallelType::BIDy, ParallelType::BIDz});
 }
+
+//! Schedules the epilogue when it reduces along M and/or N. The tensors read
+//!  from smem_epilogue split the CTA tile without merging M and N, so that the
+//!  reduced dimensions stay separate from the other ones. This puts TIDz and
+//!  TIDy on M and TIDx on N:
+//!  [Mo, No, Mi, Ni] -> [Mo, No, Mi/TIDy/TIDz, TIDz, TIDy, Ni/vect/TIDx,
+//!                       TIDx, vect]
+//! The transformations and parallelization are propagated to the rest of the
+//!  epilogue. The outputs that keep both M and N are vectorized.
+void scheduleEpilogueWithReductions(
+    Fusion* fusion,
+    TensorView* mma_result,
+    TensorView* smem_epilogue,
+    const mma_utils::RolesMap& roles_map,
+    const MatMulTileOptions& gemm_tile,
+    int64_t vectorization_factor) {
+  constexpr int64_t warp_size = 32l;
+  const int64_t tidy = gemm_tile.cta_tile.n / gemm_tile.warp_tile.n;
+  const int64_t tidz = gemm_tile.cta_tile.m / gemm_tile.warp_tile.m;
+  NVF_ERROR(
+      gemm_tile.cta_tile.n % warp_size == 0,
+      "Epilogue reductions require a CTA tile N that is a multiple of the warp size, got ",
+      gemm_tile.cta_tile.n);
+  NVF_ERROR(
+      gemm_tile.cta_tile.m % (tidy * tidz) == 0,
+      "Epilogue reductions require a CTA tile M that is a multiple of the number of warps, got ",
+      gemm_tile.cta_tile.m);
+  // Each thread of a warp writes a vector of the rows of the tile
+  while (gemm_tile.cta_tile.n % (warp_size * vectorization_factor) != 0) {
+    vectorization_factor /= 2;
+  }
+
+  const std::vector<TensorView*> outputs =
+      ir_utils::filterByType<TensorView>(fusion->outputs()).vector();
+  for (TensorView* tv : ir_utils::consumerTvsOf(smem_epilogue)) {
+    // [Mo, No, Mi, Ni]
+    checkConcreteStaticDim(tv->axis(-2));
+    checkConcreteStaticDim(tv->axis(-1));
+    tv->split(-1, vectorization_factor);
+    tv->split(-2, warp_size);
+    tv->axis(-2)->parallelize(ParallelType::TIDx);
+    // [Mo, No, Mi, Ni/vect/TIDx, TIDx, vect]
+    tv->split(-4, tidy);
+    tv->axis(-4)->parallelize(ParallelType::TIDy);
+    tv->split(-5, tidz);
+    tv->axis(-5)->parallelize(ParallelType::TIDz);
+    // [Mo, No, Mi/TIDy/TIDz, TIDz, TIDy, Ni/vect/TIDx, TIDx, vect]
+    scheduler_utils::parallelizeAllLike(
+        mma_result,
+        2,
+        {tv},
+        {ParallelType::BIDx, ParallelType::BIDy, ParallelType::BIDz});
+    scheduler_utils::BoundedDirectionalTransformPropagator::forward(
+        tv,
+        -1,
+        outputs,
+        scheduler_utils::BoundedDirectionalTransformPropagator::Options()
+            .propagateParallelType()
+            .propagateToBoundary());
+  }
+
+  for (MatmulRole role : {MatmulRole::OUTPUT_D, MatmulRole::OUTPUT_AUX}) {
+    if (!roles_map.count(role)) {
+      continue;
+    }
+    for (TensorView* d : roles_map.at(role)) {
+      d->axis(-1)->parallelize(ParallelType::Vectorize);
+    }
+  }
+}
+
+//! Rfactors the serial axes of the epilogue reductions, so that each thread
+//!  reduces its own elements before the block and grid reductions over the
+//!  parallelized axes
+void rFactorEpilogueReductions(
+    const std::vector<TensorView*>& epilogue_reductions) {
+  for (TensorView* tv : epilogue_reductions) {
+    std::vector<int64_t> serial_axes;
+    bool has_parallel_reduction = false;
+    for (int64_t i : c10::irange(tv->nDims())) {
+      IterDomain* id = tv->axis(i);
+      if (!id->isReduction()) {
+        continue;
+      }
+      if (id->isParallelized()) {
+        has_parallel_reduction = true;
+      } else {
+        serial_axes.push_back(i);
+      }
+    }
+    if (has_parallel_reduction && !serial_axes.empty()) {
+      tv->rFactor(serial_axes);
+    }
+  }
+}
+
 //! Propagates transformations from fusion output to fusion tv inputs that are
 //!  producers in the epilogue. Transformations' propagation aims at input tvs
 //!  which are not assigned to core roles, that is, are not MMA inputs.
 void scheduleFusionInputsForEpilogue(
     const mma_utils::RolesMap& roles_map,
-    const bool with_smem_epilogue) {
+    const bool with_smem_epilogue,
+    const std::vector<TensorView*>& epilogue_reductions) {
   std::vector<TensorView*> cached_tvs;
 
   // Handling transformations in fusion input tvs with assigned INPUT_C role by
@@ -668,8 +773,17 @@ void scheduleFusionInputsForEpilogue(
       cached_tvs.push_back(c->cacheAfter());
     }
 
-    scheduler_utils::BoundedDirectionalTransformPropagator::backward(
-        output_d, -1, c_tvs);
+    // INPUT_C tvs can also be used only by the epilogue reductions, which are
+    //  scheduled like output_d but keep their reduced dimensions
+    std::vector<TensorView*> references = {output_d};
+    references.insert(
+        references.end(),
+        epilogue_reductions.begin(),
+        epilogue_reductions.end());
+    for (TensorView* reference : references) {
+      scheduler_utils::BoundedDirectionalTransformPropagator::backward(
+          reference, -1, c_tvs);
+    }
 
     std::unordered_set<ParallelType> parallel_types = {};
     if (with_smem_epilogue) {
@@ -681,8 +795,10 @@ void scheduleFusionInputsForEpilogue(
       //!  enabled for matmul scheduler.
       parallel_types = allParallelTypesExcept({ParallelType::Vectorize});
     }
-    scheduler_utils::parallelizeAllLike(
-        output_d, -1, cached_tvs, parallel_types);
+    for (TensorView* reference : references) {
+      scheduler_utils::parallelizeAllLike(
+          reference, -1, cached_tvs, parallel_types);
+    }
 
     // The cached INPUT_C tvs are not needed anymore
     cached_tvs.clear();
@@ -800,6 +916,20 @@ void scheduleMatmul(Fusion* fusion, const MatmulParams& params) {
   const bool has_fusion_c_roles = (0 != roles_map.count(MatmulRole::INPUT_C));
   const bool has_non_mma_input_tvs = has_epilogue && has_fusion_c_roles;
 
+  // Reductions of the epilogue along M and/or N, which are finalized across
+  //  CTAs by grid reductions
+  std::vector<TensorView*> epilogue_reductions;
+  if (roles_map.count(MatmulRole::OUTPUT_REDUCTION)) {
+    NVF_ERROR(
+        params.splitk_factor == 1 && params.grid_swizzle_factor == 1 &&
+            params.num_persistent_ctas == 0,
+        "Epilogue reductions are not supported with split-K, grid swizzles ",
+        "or persistent CTAs");
+    for (ReductionOp* rop : ir_utils::getOpsOfType<ReductionOp>(fusion)) {
+      epilogue_reductions.push_back(rop->out()->as<TensorView>());
+    }
+  }
+
   // Including current tensor naming convention for reference,
   //  this is very temporary and will change over time and
   //  in fact the whole body of this function will
@@ -832,8 +962,9 @@ void scheduleMatmul(Fusion* fusion, const MatmulParams& params) {
   //
   //  result in global memory: d
 
-  // Currently the support is for a, b, c and d as fusion inputs/outputs
-  //  aka. no prolog fusion yet.
+  // Currently the support is for a, b, c and d as fusion inputs/outputs, and
+  //  for elementwise prologues of a and b, e.g. dequantization, that are
+  //  computed between acr/bcr and ab/bb.
 
   mma->setMacro(params.mma_macro);
 
@@ -890,26 +1021,51 @@ void scheduleMatmul(Fusion* fusion, const MatmulParams& params) {
   bcw_smem->definition()->as<LoadStoreOp>()->setCacheOp(cache_op_b);
   NVF_ERROR(acw_smem->uses().size() == 1);
   NVF_ERROR(bcw_smem->uses().size() == 1);
+  // ldmatrix only loads 16-bit data, wider or narrower operands like int8
+  //  weights that are dequantized in their prologue are read from shared
+  //  memory with regular loads
+  auto getSmemReadOpType = [mma](TensorView* smem_tv, LoadStoreOp* ldst) {
+    // Int8 operands are K-major, so they never need ldmatrix.trans, which
+    //  can only transpose 16-bit items
+    const int64_t data_type_size = dataTypeSize(smem_tv->dtype());
+    if (data_type_size != 2 && smem_tv->dtype() != DataType::Int8) {
+      return LoadStoreOpType::Set;
+    }
+    if (ldst != nullptr) {
+      if (!ldst->hasInnerTranspose()) {
+        return LoadStoreOpType::LdMatrix;
+      }
+      return data_type_size == 2 ? LoadStoreOpType::LdMatrixTranspose
+                                 : LoadStoreOpType::Set;
+    }
+    // A prologue that transposes the operand would need ldmatrix.trans on
+    //  the smem read
+    const auto exprs = DependencyCheck::getAllExprsBetween(
+        {smem_tv}, {mma->inA(), mma->inB()});
+    if (std::any_of(exprs.begin(), exprs.end(), [](Expr* expr) {
+          auto prologue_ldst = dynamic_cast<LoadStoreOp*>(expr);
+          return prologue_ldst != nullptr && prologue_ldst->hasInnerTranspose();
+        })) {
+      return LoadStoreOpType::Set;
+    }
+    return LoadStoreOpType::LdMatrix;
+  };
   if (auto ldst = dynamic_cast<LoadStoreOp*>(acw_smem->uses().at(0))) {
     acr = ldst->out()->as<TensorView>();
-    if (ldst->hasInnerTranspose()) {
-      ldst->setOpType(LoadStoreOpType::LdMatrixTranspose);
-    } else {
-      ldst->setOpType(LoadStoreOpType::LdMatrix);
-    }
+    ldst->setOpType(getSmemReadOpType(acw_smem, ldst));
   } else {
-    acr = acw_smem->cacheAfter(LoadStoreOpType::LdMatrix);
+    acr = acw_smem->cacheAfter(getSmemReadOpType(acw_smem, nullptr));
   }
   if (auto ldst = dynamic_cast<LoadStoreOp*>(bcw_smem->uses().at(0))) {
     bcr = ldst->out()->as<TensorView>();
-    if (ldst->hasInnerTranspose()) {
-      ldst->setOpType(LoadStoreOpType::LdMatrixTranspose);
-    } else {
-      ldst->setOpType(LoadStoreOpType::LdMatrix);
-    }
+    ldst->setOpType(getSmemReadOpType(bcw_smem, ldst));
   } else {
-    bcr = bcw_smem->cacheAfter(LoadStoreOpType::LdMatrix);
+    bcr = bcw_smem->cacheAfter(getSmemReadOpType(bcw_smem, nullptr));
   }
+  const bool acr_uses_ldmatrix =
+      acr->definition()->as<LoadStoreOp>()->opType() != LoadStoreOpType::Set;
+  const bool bcr_uses_ldmatrix =
+      bcr->definition()->as<LoadStoreOp>()->opType() != LoadStoreOpType::Set;
 
   // For Turing and Ampere, the layout of the MmaOp is always TN
   NVF_ERROR(
@@ -966,6 +1122,25 @@ void scheduleMatmul(Fusion* fusion, const MatmulParams& params) {
     }
   }
 
+  // Persistent CTAs:
+  if (params.num_persistent_ctas > 0) {
+    NVF_ERROR(
+        params.splitk_factor == 1,
+        "Persistent CTAs are not supported with split-K");
+    // Linearize the tiles so that consecutive tiles are the ones that
+    // consecutive CTAs would compute without persistence, i.e. along the
+    // dimension parallelized with BIDx
+    if (params.cta_order == MatmulParams::TileRasterizationOrder::RowMajor) {
+      mma_result->reorder(
+          {{num_device_and_batch_dims, num_device_and_batch_dims + 1}});
+    }
+    // [I1, I2]
+    mma_result->merge(num_device_and_batch_dims);
+    // [I1*I2]
+    mma_result->split(num_device_and_batch_dims, params.num_persistent_ctas);
+    // [I1*I2/num_persistent_ctas, num_persistent_ctas]
+  }
+
   // [..., iMo, iNo, rKo, iMi, iNi, rKi]
   int num_splitk_dims = 0;
   TensorView* splitk_sum = nullptr;
@@ -1105,20 +1280,27 @@ void scheduleMatmul(Fusion* fusion, const MatmulParams& params) {
   if (acr != ab) {
     //  -5  -4   -3   -2   -1
     //[8mi, 4k, 2ko, 2mo, 2ki]
-    acr->setAllocationDomain(acr->getLeafDomain(), true);
-    mma_utils::WarpMmaSwizzler::scheduleLdMatrix(acr, MmaOperand::A);
+    if (acr_uses_ldmatrix) {
+      acr->setAllocationDomain(acr->getLeafDomain(), true);
+      mma_utils::WarpMmaSwizzler::scheduleLdMatrix(acr, MmaOperand::A);
+    }
     ab->merge(-5);
     ab->axis(-4)->parallelize(ParallelType::TIDx);
-    propagate_mma_input_schedule_to(acr, nullptr);
+    // Without ldmatrix, each thread reads its own fragment of the operand
+    propagate_mma_input_schedule_to(
+        acr_uses_ldmatrix ? acr : acw_smem, nullptr);
   }
   if (bcr != bb) {
     //   -5  -4   -3   -2   -1
     // [8ni, 4k, 2ko, 1no, 2ki]
-    bcr->setAllocationDomain(bcr->getLeafDomain(), true);
-    mma_utils::WarpMmaSwizzler::scheduleLdMatrix(bcr, MmaOperand::B);
+    if (bcr_uses_ldmatrix) {
+      bcr->setAllocationDomain(bcr->getLeafDomain(), true);
+      mma_utils::WarpMmaSwizzler::scheduleLdMatrix(bcr, MmaOperand::B);
+    }
     bb->merge(-5);
     bb->axis(-4)->parallelize(ParallelType::TIDx);
-    propagate_mma_input_schedule_to(nullptr, bcr);
+    propagate_mma_input_schedule_to(
+        nullptr, bcr_uses_ldmatrix ? bcr : bcw_smem);
   }
 
   // Parallelization strategy:
@@ -1168,22 +1350,28 @@ void scheduleMatmul(Fusion* fusion, const MatmulParams& params) {
   } else if (num_local_batch_dims > 0) {
     mma_result->axis(num_device_dims)->parallelize(ParallelType::BIDz);
   }
-  switch (params.cta_order) {
-    case MatmulParams::TileRasterizationOrder::RowMajor:
-      mma_result->axis(num_device_and_batch_dims)
-          ->parallelize(ParallelType::BIDx);
-      mma_result->axis(num_device_and_batch_dims + 1)
-          ->parallelize(ParallelType::BIDy);
-      break;
-    case MatmulParams::TileRasterizationOrder::ColumnMajor:
-      mma_result->axis(num_device_and_batch_dims)
-          ->parallelize(ParallelType::BIDy);
-      mma_result->axis(num_device_and_batch_dims + 1)
-          ->parallelize(ParallelType::BIDx);
-      break;
-    default:
-      NVF_ERROR(
-          false, "Invalid TileRasterizationOrder passed to Matmul scheduler");
+  if (params.num_persistent_ctas > 0) {
+    // Each CTA loops serially over its tiles
+    mma_result->axis(num_device_and_batch_dims + 1)
+        ->parallelize(ParallelType::BIDx);
+  } else {
+    switch (params.cta_order) {
+      case MatmulParams::TileRasterizationOrder::RowMajor:
+        mma_result->axis(num_device_and_batch_dims)
+            ->parallelize(ParallelType::BIDx);
+        mma_result->axis(num_device_and_batch_dims + 1)
+            ->parallelize(ParallelType::BIDy);
+        break;
+      case MatmulParams::TileRasterizationOrder::ColumnMajor:
+        mma_result->axis(num_device_and_batch_dims)
+            ->parallelize(ParallelType::BIDy);
+        mma_result->axis(num_device_and_batch_dims + 1)
+            ->parallelize(ParallelType::BIDx);
+        break;
+      default:
+        NVF_ERROR(
+            false, "Invalid TileRasterizationOrder passed to Matmul scheduler");
+    }
   }
 
   // parallelize Mwo, Nwo by thread
@@ -1198,6 +1386,33 @@ void scheduleMatmul(Fusion* fusion, const MatmulParams& params) {
       {acr, bcr, ab, bb},
       {ParallelType::TIDy, ParallelType::TIDz});
 
+  // Operand prologues, e.g. dequantization or normalization, are computed on
+  //  the register fragments of the operands, together with the loads of their
+  //  INPUT_PROLOGUE inputs
+  {
+    std::vector<TensorView*> a_boundary = {acr};
+    std::vector<TensorView*> b_boundary = {bcr};
+    if (roles_map.count(MatmulRole::INPUT_PROLOGUE)) {
+      const auto& prologue_tvs = roles_map.at(MatmulRole::INPUT_PROLOGUE);
+      a_boundary.insert(
+          a_boundary.end(), prologue_tvs.begin(), prologue_tvs.end());
+      b_boundary.insert(
+          b_boundary.end(), prologue_tvs.begin(), prologue_tvs.end());
+    }
+    scheduler_utils::BoundedDirectionalTransformPropagator::backward(
+        ab,
+        -1,
+        a_boundary,
+        scheduler_utils::BoundedDirectionalTransformPropagator::Options()
+            .propagateParallelType());
+    scheduler_utils::BoundedDirectionalTransformPropagator::backward(
+        bb,
+        -1,
+        b_boundary,
+        scheduler_utils::BoundedDirectionalTransformPropagator::Options()
+            .propagateParallelType());
+  }
+
   // handle epilogue and always vectorize Ki
   if (params.use_smem_epilogue) {
     smem_epilogue->setMemoryType(MemoryType::Shared);
@@ -1211,18 +1426,31 @@ void scheduleMatmul(Fusion* fusion, const MatmulParams& params) {
             .propagateToBoundary());
     smem_epilogue->axis(-1)->parallelize(ParallelType::Vectorize);
 
-    for (auto [dc, d] : cached_outputs) {
-      // Schedule output tensor differently for better global memory access
-      // pattern.
-      scheduleOutputTensor(
-          mma_result, d, gemm_tile, params.supported_vec_size.epilogue);
-      d->axis(-1)->parallelize(ParallelType::Vectorize);
-
-      // Propagate output tensor transformations back to smem_epilogue
-      scheduler_utils::BoundedDirectionalTransformPropagator::backward(
-          d, -1, {smem_epilogue});
+    if (!epilogue_reductions.empty()) {
+      scheduleEpilogueWithReductions(
+          fusion,
+          mma_result,
+          smem_epilogue,
+          roles_map,
+          gemm_tile,
+          params.supported_vec_size.epilogue);
+    } else {
+      for (auto [dc, d] : cached_outputs) {
+        // Schedule output tensor differently for better global memory access
+        // pattern.
+        scheduleOutputTensor(
+            mma_result, d, gemm_tile, params.supported_vec_size.epilogue);
+        d->axis(-1)->parallelize(ParallelType::Vectorize);
+
+        // Propagate output tensor transformations back to smem_epilogue
+        scheduler_utils::BoundedDirectionalTransformPropagator::backward(
+            d, -1, {smem_epilogue});
+      }
     }
   } else {
+    NVF_ERROR(
+        epilogue_reductions.empty(),
+        "Epilogue reductions require a shared memory epilogue");
     for (auto [dc, d] : cached_outputs) {
       scheduler_utils::BoundedDirectionalTransformPropagator::forward(
           mma_result,
@@ -1250,8 +1478,10 @@ void scheduleMatmul(Fusion* fusion, const MatmulParams& params) {
   //  operations, input tvs with non-core roles
   //  core roles: essential for matmul, for example mma inputs' producers
   if (has_non_mma_input_tvs) {
-    scheduleFusionInputsForEpilogue(roles_map, params.use_smem_epilogue);
+    scheduleFusionInputsForEpilogue(
+        roles_map, params.use_smem_epilogue, epilogue_reductions);
   }
+  rFactorEpilogueReductions(epilogue_reductions);
 
   scheduleSplitKSum(
       splitk_sum, num_device_and_batch_dims, params.use_smem_epilogue);
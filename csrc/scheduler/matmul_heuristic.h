@@ -152,6 +152,13 @@ class MatmulParams : public HeuristicParams {
   //! axis and perform a grid reduction before the epilogue.
   int splitk_factor = 1;
 
+  //! If positive, launch this many CTAs along gridDim.x and let each of them
+  //!  loop over the output tiles instead of launching one CTA per tile. CTA
+  //!  i computes the tiles i, i + num_persistent_ctas, ... in the order given
+  //!  by cta_order and grid_swizzle_factor. Not supported with split-K,
+  //!  since its serial grid reduction would serialize the whole tile loop.
+  int num_persistent_ctas = 0;
+
   std::string toString() const override {
     std::stringstream ss;
     ss << "\n===== Matmul Parameters ========\n"
@@ -179,6 +186,7 @@ class MatmulParams : public HeuristicParams {
        << "Promote re-use of prologue shared memory: "
        << promote_prologue_smem_reuse << "\n"
        << "Split-K factor: " << splitk_factor << "\n"
+       << "Persistent CTAs: " << num_persistent_ctas << "\n"
        << "====================================\n";
     return ss.str();
   }
@@ -196,7 +204,8 @@ class MatmulParams : public HeuristicParams {
         (nvfuser::hash(tile_sizes) << 3) ^
         (std::hash<size_t>{}(static_cast<size_t>(cta_order)) << 4) ^
         (std::hash<size_t>{}(grid_swizzle_factor) << 5) ^
-        (std::hash<size_t>{}(splitk_factor) << 6);
+        (std::hash<size_t>{}(splitk_factor) << 6) ^
+        (std::hash<size_t>{}(num_persistent_ctas) << 7);
     return attr_hash;
   }
 
@@ -219,7 +228,8 @@ class MatmulParams : public HeuristicParams {
         other_casted->use_smem_epilogue == use_smem_epilogue &&
         other_casted->promote_prologue_smem_reuse ==
         promote_prologue_smem_reuse &&
-        other_casted->splitk_factor == splitk_factor;
+        other_casted->splitk_factor == splitk_factor &&
+        other_casted->num_persistent_ctas == num_persistent_ctas;
   }
 
   std::shared_ptr<HeuristicParams> clone() const override {
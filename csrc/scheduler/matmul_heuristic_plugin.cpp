@@ -90,8 +90,8 @@ std::string rolesToPrecisionString(const mma_utils::RolesMap& roles_map) {
       a->dtype() == b->dtype(), "Differing A and B dtypes not yet supported");
   TensorView* d = roles_map.at(MatmulRole::OUTPUT_D).front();
   precision[0] = mma_utils::dtypeToChar(a->dtype());
-  // NOTE: this assumes compute type is Float
-  precision[1] = 'S';
+  // Integer operands accumulate in Int32, all others in Float
+  precision[1] = isIntegralType(a->dtype()) ? 'I' : 'S';
   precision[2] = mma_utils::dtypeToChar(d->dtype());
   return precision;
 }
@@ -24,6 +24,7 @@
 #include <deque>
 #include <iostream>
 #include <iterator>
+#include <limits>
 #include <memory>
 #include <sstream>
 #include <type_traits>
@@ -45,13 +46,23 @@ using ProblemShape = std::array<int64_t, 3>;
 //! A helper for deciding the type of MMA op for given fusion and problem shape.
 inline std::optional<MmaMacro> getMmaOp(
     const int dev_version,
-    const ProblemShape& problem) {
+    const ProblemShape& problem,
+    const DataType& operand_dtype) {
   using MacroType = MmaMacro;
 
   // NOTE: A temp condition
   const ProblemShape::value_type n_extend = problem[(size_t)MatmulDomain::N];
   const bool use_small_n = ((n_extend % 8) == 0) && ((n_extend % 16) != 0);
 
+  if (operand_dtype == DataType::Int8) {
+    // Integer tensor cores with m16n8k32 shape are available since Ampere
+    if (dev_version < 80) {
+      return std::nullopt;
+    }
+    return (use_small_n) ? MacroType::Ampere_16_8_32
+                         : MacroType::Ampere_16_16_32;
+  }
+
   switch (dev_version) {
     case 75:
       return (use_small_n) ? MacroType::Turing_16_8_16
@@ -121,27 +132,41 @@ inline bool initCoreHeuristics(
 
   params->tile_sizes = {cta_tile, warp_tile, instruction_tile};
 
+  const auto& roleMinDtypeSize = [&roles_map](MatmulRole role) -> int64_t {
+    const auto op_it = roles_map.find(role);
+    NVF_ERROR(op_it != roles_map.end());
+    int64_t min_size_bytes = 128LL;
+    for (const TensorView* operand : op_it->second) {
+      min_size_bytes = std::min(min_size_bytes, dataTypeSize(operand->dtype()));
+    }
+    return min_size_bytes;
+  };
+
   // stages and async mem copy
   {
     // NOTE: compilation errors when async is enabled on Turing devices
     if (isAmpere(params->mma_macro)) {
-      constexpr int stages = 3;
+      int stages = 3;
+
+      // Hopper runs the Ampere pipeline, and its larger shared memory fits a
+      // deeper one. Add stages as long as two CTAs still fit in shared memory.
+      if (at::cuda::getCurrentDeviceProperties()->major >= 9) {
+        constexpr int max_stages = 5;
+        const int64_t stage_bytes =
+            cta_tile.m * cta_tile.k * roleMinDtypeSize(MatmulRole::INPUT_A) +
+            cta_tile.n * cta_tile.k * roleMinDtypeSize(MatmulRole::INPUT_B);
+        const auto smem_available = (int64_t)deviceAvailableSharedMemoryBytes();
+        while (stages < max_stages &&
+               2 * (stages + 1) * stage_bytes <= smem_available) {
+          stages++;
+        }
+      }
 
       params->double_buffer_options.double_buffer_smem_write = true;
       params->double_buffer_options.double_buffer_smem_read = true;
       params->double_buffer_options.smem_double_buffer_stage = stages;
     }
   }
-
-  const auto& roleMinDtypeSize = [&roles_map](MatmulRole role) -> int64_t {
-    const auto op_it = roles_map.find(role);
-    NVF_ERROR(op_it != roles_map.end());
-    int64_t min_size_bytes = 128LL;
-    for (const TensorView* operand : op_it->second) {
-      min_size_bytes = std::min(min_size_bytes, dataTypeSize(operand->dtype()));
-    }
-    return min_size_bytes;
-  };
   params->async_gmem_load_operands = isCpAsyncOperandLoadSupported(
       params.get(),
       roleMinDtypeSize(MatmulRole::INPUT_A),
@@ -188,6 +213,22 @@ ProblemShape getProblemShape(
       m_extend.as<int64_t>(), n_extend.as<int64_t>(), k_extend.as<int64_t>()};
 }
 
+//! A helper for getting the product of the batch dimensions of the matmul.
+int64_t getBatchSize(
+    const mma_utils::MulSumProperties::InputsOutputs& props,
+    SchedulerRuntimeInfo& runtime_info) {
+  const auto out_domain = TensorDomain::noDevices(props.out->getRootDomain());
+  int64_t batch_size = 1;
+  for (int64_t axis :
+       MmaOpUtils::getMmaOpDetails(props.out, props.a, props.b).batch_axes) {
+    auto extent = runtime_info.expressionEvaluator().evaluate(
+        out_domain.at(axis)->extent());
+    NVF_ERROR(extent.hasValue(), "Failed to acquire a batch dimension");
+    batch_size *= extent.as<int64_t>();
+  }
+  return batch_size;
+}
+
 std::string isMatmulFusionDefinitionSupported(
     Fusion* fusion,
     const mma_utils::MulSumProperties::InputsOutputs& props) {
@@ -275,12 +316,68 @@ std::string isMatmulFusionDefinitionSupported(
       tvs_with_roles.insert(entry->second.begin(), entry->second.end());
     }
 
+    // Operand prologues are computed on the tiles of A and B loaded in
+    //  registers, so they can neither reduce the operands, e.g. to compute
+    //  a norm along K, nor be used by the epilogue
+    entry = roles_map.find(MatmulRole::INPUT_PROLOGUE);
+    if (entry != roles_map.end()) {
+      const std::vector<Val*> operands = {props.a, props.b};
+      std::unordered_set<Val*> operand_producers = {
+          roles_map.at(MatmulRole::INPUT_A).front(),
+          roles_map.at(MatmulRole::INPUT_B).front()};
+      operand_producers.insert(entry->second.begin(), entry->second.end());
+      const auto exprs =
+          DependencyCheck::getAllExprsBetween(operand_producers, operands);
+      if (std::any_of(exprs.begin(), exprs.end(), [](Expr* expr) {
+            return expr->isA<ReductionOp>();
+          })) {
+        return "Reductions are not supported in operand prologues";
+      }
+      for (TensorView* tv : entry->second) {
+        const auto prologue_vals =
+            DependencyCheck::getAllValsBetween({tv}, operands);
+        const std::unordered_set<Val*> prologue_vals_set(
+            prologue_vals.begin(), prologue_vals.end());
+        for (Val* val : DependencyCheck::getAllDependentVals({tv})) {
+          if (!prologue_vals_set.count(val) && val != mma_output &&
+              !DependencyCheck::isDependencyOf(mma_output, val)) {
+            return "Inputs of operand prologues can not be used in the epilogue";
+          }
+        }
+      }
+      tvs_with_roles.insert(entry->second.begin(), entry->second.end());
+    }
+
     // Non-core output roles are optional, no requirements for definitions
     entry = roles_map.find(MatmulRole::OUTPUT_AUX);
     if (entry != roles_map.end()) {
       tvs_with_roles.insert(entry->second.begin(), entry->second.end());
     }
 
+    // Reductions of the epilogue are finalized across CTAs, so their results
+    //  can only be written out, not consumed by the rest of the epilogue
+    entry = roles_map.find(MatmulRole::OUTPUT_REDUCTION);
+    if (entry != roles_map.end()) {
+      if (!mma_details.batch_axes.empty()) {
+        return "Epilogue reductions are not supported in batched matmuls";
+      }
+      for (MatmulRole role : {MatmulRole::OUTPUT_D, MatmulRole::OUTPUT_AUX}) {
+        if (!roles_map.count(role)) {
+          continue;
+        }
+        for (TensorView* tv : roles_map.at(role)) {
+          const auto exprs =
+              DependencyCheck::getAllExprsBetween({mma_output}, {tv});
+          if (std::any_of(exprs.begin(), exprs.end(), [](Expr* expr) {
+                return expr->isA<ReductionOp>();
+              })) {
+            return "Results of epilogue reductions can not be used in the epilogue";
+          }
+        }
+      }
+      tvs_with_roles.insert(entry->second.begin(), entry->second.end());
+    }
+
     const auto in_out_tvs_count =
         fusion_inputs_tvs.size() + fusion_outputs_tvs.size();
     if (in_out_tvs_count != tvs_with_roles.size()) {
@@ -431,6 +528,374 @@ MatmulParams::SupportedVectorization getSupportedVectorization(
   return supported_vec_size;
 }
 
+//! Fixes the wave quantization of matmuls with many CTA tiles. The number of
+//! tiles is rarely a multiple of the number of CTAs that fit on the device,
+//! which leaves the last wave partially idle. Splitting K multiplies the work
+//! items, so a split-K factor is picked when it fills the waves noticeably
+//! better, as long as each slice of K still runs enough iterations to fill
+//! the operand pipeline. This plays the role of the split-K phase of a
+//! stream-K decomposition. Otherwise, if there are more tiles than CTAs, the
+//! kernel launches one wave of persistent CTAs that loop over the tiles.
+void initPersistentTileHeuristics(
+    MatmulParams* params,
+    const ProblemShape& problem_shape,
+    const mma_utils::RolesMap& roles_map) {
+  const auto device_prop = at::cuda::getCurrentDeviceProperties();
+  const GemmTile& cta_tile = params->tile_sizes.cta_tile;
+  const int64_t num_tiles =
+      ceilDiv(problem_shape[(size_t)MatmulDomain::M], cta_tile.m) *
+      ceilDiv(problem_shape[(size_t)MatmulDomain::N], cta_tile.n);
+  const int64_t num_k_iters =
+      ceilDiv(problem_shape[(size_t)MatmulDomain::K], cta_tile.k);
+
+  // When looping over tiles, the prologue of the next tile refills the
+  // operand buffers, so the epilogue can't reuse them
+  const auto smem_available = (int64_t)deviceAvailableSharedMemoryBytes();
+  const mma_utils::MmaDataTypes data_types{
+      roles_map.at(MatmulRole::INPUT_A).front()->dtype(),
+      roles_map.at(MatmulRole::INPUT_B).front()->dtype(),
+      DataType::Float};
+  params->promote_prologue_smem_reuse = false;
+  if (mma_utils::computeExpectedSharedMemoryUsage(*params, data_types) >
+      smem_available) {
+    params->use_smem_epilogue = false;
+  }
+  const int64_t smem_per_cta = std::max(
+      (int64_t)1,
+      mma_utils::computeExpectedSharedMemoryUsage(*params, data_types));
+  // The register usage of the accumulators is only known after compilation,
+  // so don't count on more than two CTAs per SM
+  const int64_t ctas_per_sm =
+      std::clamp(smem_available / smem_per_cta, (int64_t)1, (int64_t)2);
+  const int64_t max_ctas = device_prop->multiProcessorCount * ctas_per_sm;
+
+  // Fraction of the launched CTA slots that compute a work item
+  const auto waveEfficiency = [&](int64_t splitk) {
+    const int64_t num_items = num_tiles * splitk;
+    return (double)num_items /
+        (double)(ceilDiv(num_items, max_ctas) * max_ctas);
+  };
+  constexpr int64_t max_splitk_factor = 4;
+  // Split-K adds a grid reduction, which needs to pay for itself
+  constexpr double min_efficiency_gain = 0.1;
+  const int64_t min_k_iters =
+      std::max(2, params->double_buffer_options.smem_double_buffer_stage);
+  int64_t splitk = 1;
+  double efficiency = waveEfficiency(1);
+  for (int64_t factor = 2; factor <= max_splitk_factor; ++factor) {
+    if (num_k_iters < factor * min_k_iters) {
+      break;
+    }
+    const double factor_efficiency = waveEfficiency(factor);
+    if (factor_efficiency > efficiency + min_efficiency_gain) {
+      splitk = factor;
+      efficiency = factor_efficiency;
+    }
+  }
+  params->splitk_factor = (int)splitk;
+  params->num_persistent_ctas =
+      splitk == 1 && num_tiles > max_ctas ? (int)max_ctas : 0;
+}
+
+//! Epilogue reductions are computed from the unswizzled MMA results in shared
+//! memory, where the CTA tile keeps separate M and N dimensions so that either
+//! of them can be reduced. The partial results of each CTA are then finalized
+//! by a grid reduction across the CTAs that share the other dimension.
+void initEpilogueReductionHeuristics(
+    MatmulParams* params,
+    const mma_utils::RolesMap& roles_map) {
+  // Split-K would reduce the unfinished sums of its slices, while grid
+  // swizzles and persistent CTAs merge the reduced tile dimension with the
+  // other one
+  params->splitk_factor = 1;
+  params->grid_swizzle_factor = 1;
+  params->num_persistent_ctas = 0;
+  bool smem_epilogue_fits = false;
+  std::tie(smem_epilogue_fits, params->promote_prologue_smem_reuse) =
+      mma_utils::generateSharedMemoryEpilogueHeuristics(
+          params->tile_sizes,
+          params->double_buffer_options.smem_double_buffer_stage,
+          roles_map,
+          /*ignore_occupancy_drop=*/true);
+  NVF_CHECK(
+      smem_epilogue_fits,
+      "Epilogue reductions require a shared memory epilogue, which does not ",
+      "fit with tile sizes ",
+      toString(params->tile_sizes));
+  params->use_smem_epilogue = true;
+}
+
+//! Analytical model of the run time of matmul kernels, which scores the
+//! candidate configurations of initModelHeuristics. A kernel runs its work
+//! items, i.e. CTA tiles times split-K slices, in waves of as many CTAs as
+//! fit on the device given their shared memory, register and thread usage.
+//! Each wave takes as long as the slower of the tensor core work of its
+//! busiest SM and its DRAM traffic, where the operand tiles that are loaded
+//! by several CTAs of the wave mostly hit in L2. The grid swizzle factor
+//! shapes the footprint of a wave, and thus its L2 reuse.
+//!
+//! The weights of the model are given as arguments of
+//! EnableOption::MatmulHeuristicModel, e.g.,
+//!   NVFUSER_ENABLE=matmul_heuristic_model(flops_per_byte=200,l2_reuse=0.9)
+//! and can be fitted to the problems of benchmarks/python/matmul_problems.csv
+//! with benchmarks/python/tune_matmul_heuristic_model.py.
+struct MatmulHeuristicModel {
+  //! Ratio of the tensor core throughput of the device to its DRAM bandwidth
+  double flops_per_byte = 150.0;
+  //! Fraction of the operand loads of a wave that hit in L2 when another CTA
+  //! of the wave loads the same operand tile
+  double l2_reuse = 0.8;
+  //! Slowdown of the tensor cores by the shared memory reads of the operand
+  //! fragments, which is inversely proportional to the warp tile sizes
+  double smem_read_cost = 8.0;
+  //! Cost of the bytes of partial results reduced across split-K slices,
+  //! which also serialize the CTAs of a tile, relative to DRAM bytes
+  double splitk_cost = 2.0;
+  //! Number of operand stages in flight per SM that hide the latency of the
+  //! loads of the operands
+  double min_stages_per_sm = 4.0;
+
+  static MatmulHeuristicModel fromOptions() {
+    MatmulHeuristicModel model;
+    const std::unordered_map<std::string, double*> weights = {
+        {"flops_per_byte", &model.flops_per_byte},
+        {"l2_reuse", &model.l2_reuse},
+        {"smem_read_cost", &model.smem_read_cost},
+        {"splitk_cost", &model.splitk_cost},
+        {"min_stages_per_sm", &model.min_stages_per_sm}};
+    for (const auto& arg :
+         getEnableOptionArguments(EnableOption::MatmulHeuristicModel)) {
+      const auto eq_pos = arg.find('=');
+      if (eq_pos != std::string::npos) {
+        auto it = weights.find(arg.substr(0, eq_pos));
+        try {
+          const double value = std::stod(arg.substr(eq_pos + 1));
+          if (it != weights.end() && value >= 0.0) {
+            *it->second = value;
+            continue;
+          }
+        } catch (const std::exception&) {
+        }
+      }
+      debug() << "skip invalid argument for MatmulHeuristicModel, arg = "
+              << arg << std::endl;
+    }
+    model.l2_reuse = std::min(model.l2_reuse, 1.0);
+    return model;
+  }
+
+  //! Estimated run time of a matmul in units of the time an SM takes to
+  //! compute a flop, or infinity if the configuration doesn't fit on the
+  //! device
+  double estimateTime(
+      const MatmulParams& params,
+      const ProblemShape& problem_shape,
+      int64_t batch_size,
+      const mma_utils::MmaDataTypes& data_types) const {
+    const auto device_prop = at::cuda::getCurrentDeviceProperties();
+    const GemmTile& cta_tile = params.tile_sizes.cta_tile;
+    const GemmTile& warp_tile = params.tile_sizes.warp_tile;
+    const GemmTile warp_dims = cta_tile / warp_tile;
+    const int64_t threads_per_cta =
+        warp_dims.m * warp_dims.n * warp_dims.k * device_prop->warpSize;
+
+    // Occupancy. The accumulators and the double buffered operand fragments
+    //  of the warp tiles dominate the register usage.
+    const int64_t smem_per_cta = mma_utils::computeExpectedSharedMemoryUsage(
+        params, {data_types[0], data_types[1], DataType::Float});
+    if (smem_per_cta > (int64_t)deviceAvailableSharedMemoryBytes()) {
+      return std::numeric_limits<double>::infinity();
+    }
+    constexpr int64_t other_regs_per_thread = 32;
+    const int64_t regs_per_thread =
+        (warp_tile.m * warp_tile.n +
+         (warp_tile.m + warp_tile.n) * params.tile_sizes.instruction_tile.k) /
+            device_prop->warpSize +
+        other_regs_per_thread;
+    if (regs_per_thread > 255) {
+      return std::numeric_limits<double>::infinity();
+    }
+    const int64_t ctas_per_sm = std::min(
+        {(int64_t)device_prop->regsPerMultiprocessor /
+             (roundUpToMultiple(regs_per_thread, 8) * threads_per_cta),
+         (int64_t)device_prop->maxThreadsPerMultiProcessor / threads_per_cta,
+         (int64_t)device_prop->sharedMemPerMultiprocessor /
+             (smem_per_cta + (int64_t)device_prop->reservedSharedMemPerBlock),
+         (int64_t)device_prop->maxBlocksPerMultiProcessor});
+    if (ctas_per_sm < 1) {
+      return std::numeric_limits<double>::infinity();
+    }
+    const int64_t num_sms = device_prop->multiProcessorCount;
+    const int64_t num_slots = num_sms * ctas_per_sm;
+
+    // Work items of the row-major rasterization. A grid swizzle pads the N
+    //  tiles to a multiple of the swizzle factor, and with split-K the batch
+    //  is looped over by each CTA.
+    const int64_t swizzle = std::max(1, params.grid_swizzle_factor);
+    const int64_t splitk = std::max(1, params.splitk_factor);
+    const int64_t tiles_m =
+        ceilDiv(problem_shape[(size_t)MatmulDomain::M], cta_tile.m);
+    const int64_t tiles_n = roundUpToMultiple(
+        ceilDiv(problem_shape[(size_t)MatmulDomain::N], cta_tile.n), swizzle);
+    const int64_t tiles_per_batch = tiles_m * tiles_n;
+    const int64_t num_items =
+        tiles_per_batch * (splitk > 1 ? splitk : batch_size);
+    const int64_t batches_per_item = splitk > 1 ? batch_size : 1;
+    const int64_t num_k_iters =
+        ceilDiv(problem_shape[(size_t)MatmulDomain::K], cta_tile.k);
+    const int64_t k_slice = ceilDiv(num_k_iters, splitk) * cta_tile.k;
+
+    const double inverse_warp_tile =
+        1.0 / (double)warp_tile.m + 1.0 / (double)warp_tile.n;
+    double efficiency = 1.0 / (1.0 + smem_read_cost * inverse_warp_tile);
+    const int64_t stages = params.double_buffer_options.double_buffer_smem_write
+        ? params.double_buffer_options.smem_double_buffer_stage
+        : 1;
+    efficiency *=
+        std::min(1.0, (double)(stages * ctas_per_sm) / min_stages_per_sm);
+    const double flops_per_item = 2.0 * (double)(cta_tile.m * cta_tile.n) *
+        (double)(k_slice * batches_per_item) / efficiency;
+
+    const int64_t a_size = dataTypeSize(data_types[0]);
+    const int64_t b_size = dataTypeSize(data_types[1]);
+    double output_bytes_per_item = (double)(cta_tile.m * cta_tile.n) *
+        (double)(dataTypeSize(data_types[2]) * batches_per_item);
+    if (splitk > 1) {
+      // Partial results are written and read back in float
+      output_bytes_per_item += splitk_cost * 2.0 *
+          (double)(cta_tile.m * cta_tile.n * batches_per_item) *
+          (double)dataTypeSize(DataType::Float);
+    }
+
+    // Consecutive CTAs cover swizzle tiles along N, then the tiles along M
+    const auto waveTime = [&](int64_t num_ctas) {
+      const double compute =
+          (double)ceilDiv(num_ctas, num_sms) * flops_per_item;
+      const int64_t ctas_per_batch = std::min(num_ctas, tiles_per_batch);
+      const int64_t footprint_m =
+          std::min(tiles_m, ceilDiv(ctas_per_batch, swizzle));
+      const int64_t footprint_n =
+          std::min(tiles_n, ceilDiv(ctas_per_batch, footprint_m));
+      const double operand_bytes_per_k = (double)num_ctas *
+          (double)(cta_tile.m * a_size + cta_tile.n * b_size);
+      const double unique_bytes_per_k =
+          (double)(footprint_m * cta_tile.m * a_size +
+                   footprint_n * cta_tile.n * b_size) *
+          (double)num_ctas / (double)ctas_per_batch;
+      const double dram_bytes =
+          (unique_bytes_per_k +
+           (1.0 - l2_reuse) * (operand_bytes_per_k - unique_bytes_per_k)) *
+              (double)(k_slice * batches_per_item) +
+          (double)num_ctas * output_bytes_per_item;
+      return std::max(compute, dram_bytes * flops_per_byte / (double)num_sms);
+    };
+
+    const int64_t num_full_waves = num_items / num_slots;
+    double time = 0.0;
+    if (num_full_waves > 0) {
+      time += (double)num_full_waves * waveTime(num_slots);
+    }
+    if (num_items % num_slots != 0) {
+      time += waveTime(num_items % num_slots);
+    }
+    return time;
+  }
+};
+
+//! Picks the CTA and warp tiles, the number of stages, and the split-K and
+//! grid swizzle factors that MatmulHeuristicModel estimates to be the
+//! fastest. Epilogue reductions support neither split-K nor grid swizzles,
+//! and need a shared memory epilogue.
+void initModelHeuristics(
+    MatmulParams* params,
+    const ProblemShape& problem_shape,
+    int64_t batch_size,
+    const mma_utils::RolesMap& roles_map) {
+  const MatmulHeuristicModel model = MatmulHeuristicModel::fromOptions();
+  const GemmTile instruction_tile = getMmaOpShape(params->mma_macro);
+  const mma_utils::MmaDataTypes data_types = {
+      roles_map.at(MatmulRole::INPUT_A).front()->dtype(),
+      roles_map.at(MatmulRole::INPUT_B).front()->dtype(),
+      roles_map.at(MatmulRole::OUTPUT_D).front()->dtype()};
+  const int64_t a_size = dataTypeSize(data_types[0]);
+  const int64_t b_size = dataTypeSize(data_types[1]);
+  const bool has_epilogue_reductions =
+      roles_map.count(MatmulRole::OUTPUT_REDUCTION);
+
+  constexpr std::array<std::pair<int64_t, int64_t>, 8> warp_dims_candidates = {
+      {{1, 1}, {1, 2}, {2, 1}, {2, 2}, {1, 4}, {4, 1}, {2, 4}, {4, 2}}};
+  const int max_stages = isAmpere(params->mma_macro) ? 5 : 1;
+  const int max_splitk = has_epilogue_reductions ? 1 : 4;
+  const int max_swizzle = has_epilogue_reductions ? 1 : 8;
+
+  MatmulParams best = *params;
+  double best_time = std::numeric_limits<double>::infinity();
+  for (int64_t warp_k : {32, 64}) {
+    const int64_t num_k_iters =
+        ceilDiv(problem_shape[(size_t)MatmulDomain::K], warp_k);
+    for (int64_t warp_m : {32, 64}) {
+      for (int64_t warp_n : {32, 64}) {
+        if (warp_m % instruction_tile.m != 0 ||
+            warp_n % instruction_tile.n != 0 ||
+            warp_k % instruction_tile.k != 0) {
+          continue;
+        }
+        for (const auto& [warps_m, warps_n] : warp_dims_candidates) {
+          MatmulParams candidate = *params;
+          candidate.tile_sizes = {
+              {warp_m * warps_m, warp_n * warps_n, warp_k},
+              {warp_m, warp_n, warp_k},
+              instruction_tile};
+          candidate.use_smem_epilogue = has_epilogue_reductions;
+          candidate.promote_prologue_smem_reuse = has_epilogue_reductions;
+          for (int stages = 1; stages <= max_stages; ++stages) {
+            // Stages beyond the number of K iterations only use shared memory
+            if (max_stages > 1 &&
+                (stages < 2 || stages > std::max((int64_t)2, num_k_iters))) {
+              continue;
+            }
+            candidate.double_buffer_options = {
+                max_stages > 1, max_stages > 1, stages};
+            candidate.async_gmem_load_operands =
+                isCpAsyncOperandLoadSupported(&candidate, a_size, b_size);
+            // Circular buffering requires async loads
+            if (stages > 2 && !candidate.async_gmem_load_operands) {
+              continue;
+            }
+            for (int splitk = 1; splitk <= max_splitk; ++splitk) {
+              // Each slice of K needs enough iterations to fill the pipeline
+              if (splitk > 1 && num_k_iters < splitk * std::max(2, stages)) {
+                break;
+              }
+              candidate.splitk_factor = splitk;
+              for (int swizzle = 1; swizzle <= max_swizzle; swizzle *= 2) {
+                candidate.grid_swizzle_factor = swizzle;
+                const double time = model.estimateTime(
+                    candidate, problem_shape, batch_size, data_types);
+                // Simpler configurations are preferred when they are about
+                //  as fast
+                if (time < best_time * 0.99) {
+                  best = candidate;
+                  best_time = time;
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+  NVF_ERROR(
+      best_time < std::numeric_limits<double>::infinity(),
+      "The matmul heuristic model found no configuration that fits on the "
+      "device");
+  params->tile_sizes = best.tile_sizes;
+  params->double_buffer_options = best.double_buffer_options;
+  params->async_gmem_load_operands = best.async_gmem_load_operands;
+  params->splitk_factor = best.splitk_factor;
+  params->grid_swizzle_factor = best.grid_swizzle_factor;
+}
+
 } // anonymous namespace
 
 std::string getMatmulRunTimeRejectReason(
@@ -480,6 +945,28 @@ std::string getMatmulCompileTimeRejectReason(Fusion* fusion) {
 
   // #3
   {
+    const mma_utils::MulSumProperties::InputsOutputs& insouts =
+        mma_from_mul_sums.front().insouts;
+    const bool int8_operands = insouts.a->dtype() == DataType::Int8 &&
+        insouts.b->dtype() == DataType::Int8;
+    if (int8_operands) {
+      if (at::cuda::getCurrentDeviceProperties()->major < 8) {
+        return "Int8 operands require Ampere or newer";
+      }
+      if (insouts.out->dtype() != DataType::Int32) {
+        return "The product of Int8 operands must be accumulated in Int32";
+      }
+      // ldmatrix can not transpose 8-bit items
+      const auto layout_opt = mma_utils::getMmaLayout(fusion, insouts);
+      if (layout_opt.getData() != MmaLayout::TN) {
+        return "Int8 operands must both be K-major (TN layout)";
+      }
+    } else if (
+        dataTypeSize(insouts.a->dtype()) == 1 ||
+        dataTypeSize(insouts.b->dtype()) == 1) {
+      return "8-bit floating point operands are only supported by Hopper mma "
+             "macros, which the matmul scheduler does not use yet";
+    }
     auto support_status = isMatmulFusionDefinitionSupported(
         fusion, mma_from_mul_sums.front().insouts);
     if (!support_status.empty()) {
@@ -536,8 +1023,10 @@ std::shared_ptr<MatmulParams> getMatmulHeuristics(
       getProblemShape(mulSum.front().insouts, runtime_info);
 
   const auto device_prop = at::cuda::getCurrentDeviceProperties();
-  const auto mma_op =
-      getMmaOp(device_prop->major * 10 + device_prop->minor, problem_shape);
+  const auto mma_op = getMmaOp(
+      device_prop->major * 10 + device_prop->minor,
+      problem_shape,
+      mulSum.front().insouts.a->dtype());
   NVF_ERROR(
       mma_op.has_value(), "Failed to determine a MMA op for given problem.");
   params->mma_macro = mma_op.value();
@@ -565,6 +1054,12 @@ std::shared_ptr<MatmulParams> getMatmulHeuristics(
         /*batch_size=*/1, // TODO: extract actual batch size
         layout,
         roles_map);
+  } else if (isOptionEnabled(EnableOption::MatmulHeuristicModel)) {
+    initModelHeuristics(
+        params.get(),
+        problem_shape,
+        getBatchSize(mulSum.front().insouts, runtime_info),
+        roles_map);
   } else {
     TORCH_WARN_ONCE(
         "Scheduling a matmul without heuristic plugin. "
@@ -585,6 +1080,15 @@ std::shared_ptr<MatmulParams> getMatmulHeuristics(
           params->double_buffer_options.smem_double_buffer_stage,
           roles_map);
 
+  if (roles_map.count(MatmulRole::OUTPUT_REDUCTION)) {
+    initEpilogueReductionHeuristics(params.get(), roles_map);
+  } else if (
+      isOptionEnabled(EnableOption::MatmulPersistentTiles) &&
+      !isOptionEnabled(EnableOption::MatmulHeuristicModel)) {
+    // The heuristic model already picks split-K factors
+    initPersistentTileHeuristics(params.get(), problem_shape, roles_map);
+  }
+
   if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
     debug() << params->toString() << std::endl;
   }
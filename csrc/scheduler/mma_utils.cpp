@@ -778,8 +778,12 @@ void WarpMmaSwizzler::scheduleOperandRead(TensorView* tv, MmaOperand operand) {
   //     A                            B
   //  -2   -1          or          -2   -1
   //[64m, 16k]                    [8n, 16k]
+  //
+  // 8-bit operands have twice as many items along k, which is laid out in
+  // bytes the same way as 16-bit operands: each 32-bit register holds 2k'
+  // half or 4k' fp8 items.
   tv->split(-2, 8);
-  tv->split(-1, 2);
+  tv->split(-1, 4 / dataTypeSize(tv->dtype()));
   tv->split(-2, 4);
 
   //          A                               B
@@ -854,12 +858,15 @@ void WarpMmaSwizzler::scheduleOperandRead(TensorView* tv, MmaOperand operand) {
 void WarpMmaSwizzler::scheduleOperandRead(
     TensorView* tv,
     MmaInputSmemSwizzle swizzle) {
+  // Number of items in a 16-byte row of a core matrix
+  const int64_t core_matrix_items =
+      core_matrix_width_bytes / dataTypeSize(tv->dtype());
   if (swizzle == MmaInputSmemSwizzle::None) {
-    // For no-swizzle case, the entire tile are divided into 8x8 core matrices,
-    // and each core matrix resides in a contiguous 8*8*2 bytes region in shared
-    // memory. [K, M]
+    // For no-swizzle case, the entire tile are divided into 8x16B core
+    // matrices, and each core matrix resides in a contiguous 8*16 bytes region
+    // in shared memory. [K, M]
     tv->split(-2, 8);
-    tv->split(-1, 8);
+    tv->split(-1, core_matrix_items);
     // [Ko, K8, Mo, M8]
     tv->reorder({{-2, -3}});
     // [Ko, Mo, K8, M8]
@@ -867,7 +874,7 @@ void WarpMmaSwizzler::scheduleOperandRead(
     auto swizzle_size = getBytesFromSwizzle(swizzle) / 16;
     // For example, [K, M]
     tv->split(-2, 8);
-    tv->split(-1, 8);
+    tv->split(-1, core_matrix_items);
     // For example transpose2 == false
     // [Ko, K8, Mo, M8]
     // Note: the extent of Mo may not be a multiple of swizzle_size, but we
@@ -1026,13 +1033,17 @@ inline void resolveTvToMatmulDomainsMapping(
     IterDomain* m,
     IterDomain* n,
     IterDomain* k,
-    const ComputeAtMap& ca_map) {
+    const ComputeAtMap& ca_map,
+    bool skip_reductions = false) {
   for (const auto tv : tensors) {
     // This ensures all inputs are added to the deps_map.
     // There could be inputs such as a zero-dimensional bias which
     // would otherwise be skipped.
     deps_map[tv] = {};
     for (const auto domain : tv->getLeafDomain()) {
+      if (skip_reductions && domain->isReduction()) {
+        continue;
+      }
       if (ca_map.areMapped(m, domain, IdMappingMode::EXACT)) {
         deps_map[tv].push_back(MatmulDomain::M);
         continue;
@@ -1266,10 +1277,9 @@ RolesMapOpt getTensorsRoles(
       bool has_m = (end != std::find(begin, end, MatmulDomain::M));
       bool has_n = (end != std::find(begin, end, MatmulDomain::N));
 
-      // NOTE: depending on fusion definition k domain may appear in the output:
-      //  - for mma_output == fusion output k domain is present
-      //  - for mma_output != fusion output (fusion with epilogue) k domain
-      //    is not present
+      // NOTE: reduction domains are not resolved for outputs, so k domain
+      //  never appears in the output and outputs that reduce the epilogue
+      //  along m or n lack that domain
 
       // NOTE: the core fusion output tensors are the ones with m and n
       //  domains
@@ -1311,13 +1321,67 @@ RolesMapOpt getTensorsRoles(
       deps_map, mma_input_candidates, m, n, k, ca_map);
   findInputRolesByDomains(deps_map, roles_map);
 
+  // Inputs other than A and B that MMA inputs depend on are used in the
+  //  prologue of the operands, for example dequantization scales of B or
+  //  normalization weights of A. They are assigned to INPUT_PROLOGUE role
+  //  instead of a role resolved by their domains.
+  for (TensorView* tv : mma_input_candidates) {
+    if (!DependencyCheck::isDependencyOf(tv, props.a) &&
+        !DependencyCheck::isDependencyOf(tv, props.b)) {
+      continue;
+    }
+    bool is_core_input = false;
+    for (MatmulRole role : {MatmulRole::INPUT_A, MatmulRole::INPUT_B}) {
+      if (roles_map.count(role)) {
+        const auto& tvs = roles_map.at(role);
+        is_core_input |= std::find(tvs.begin(), tvs.end(), tv) != tvs.end();
+      }
+    }
+    if (is_core_input) {
+      continue;
+    }
+    if (roles_map.count(MatmulRole::INPUT_C)) {
+      auto& c_tvs = roles_map.at(MatmulRole::INPUT_C);
+      c_tvs.erase(std::remove(c_tvs.begin(), c_tvs.end(), tv), c_tvs.end());
+      if (c_tvs.empty()) {
+        roles_map.erase(MatmulRole::INPUT_C);
+      }
+    }
+    roles_map[MatmulRole::INPUT_PROLOGUE].push_back(tv);
+  }
+
   deps_map.clear();
 
   // Handle fusion output TensorView objects
   resolveTvToMatmulDomainsMapping(
-      deps_map, mma_output_candidates, m, n, k, ca_map);
+      deps_map,
+      mma_output_candidates,
+      m,
+      n,
+      k,
+      ca_map,
+      /*skip_reductions=*/true);
   findOutputRolesByDomains(deps_map, roles_map);
 
+  // Outputs without m or n domain are reductions of the epilogue if the
+  //  missing domains are reduced somewhere after the MMA op, for example in
+  //  bias gradients or in the amax of the result
+  for (TensorView* tv : mma_output_candidates) {
+    const auto& domains = deps_map.at(tv);
+    const auto begin = domains.begin();
+    const auto end = domains.end();
+    if (end != std::find(begin, end, MatmulDomain::M) &&
+        end != std::find(begin, end, MatmulDomain::N)) {
+      continue;
+    }
+    const auto exprs = DependencyCheck::getAllExprsBetween({props.out}, {tv});
+    if (std::any_of(exprs.begin(), exprs.end(), [](Expr* expr) {
+          return expr->isA<ReductionOp>();
+        })) {
+      roles_map[MatmulRole::OUTPUT_REDUCTION].push_back(tv);
+    }
+  }
+
   return roles_map;
 }
 
@@ -1531,6 +1595,10 @@ char dtypeToChar(const DataType& dtype) {
     return 'S';
   } else if (dtype == DataType::Double) {
     return 'D';
+  } else if (dtype == DataType::Int8) {
+    return 'B';
+  } else if (dtype == DataType::Int32) {
+    return 'I';
   }
   NVF_ERROR(false, "Unsupported dtype for matmul: ", dtype);
   return 0;
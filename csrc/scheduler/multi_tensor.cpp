@@ -0,0 +1,287 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <debug.h>
+#include <disjoint_set.h>
+#include <inlining.h>
+#include <instrumentation.h>
+#include <ir/utils.h>
+#include <options.h>
+#include <scheduler/debug_utils.h>
+#include <scheduler/multi_tensor.h>
+#include <scheduler/registry_utils.h>
+#include <scheduler/utils.h>
+#include <scheduler/vectorize_helper.h>
+
+#include <unordered_set>
+
+namespace nvfuser {
+
+namespace {
+
+constexpr int64_t kThreadX = 128;
+
+//! An independent subgraph of a fusion
+struct Subgraph {
+  //! The first fusion output of the subgraph
+  TensorView* reference = nullptr;
+  std::vector<TensorView*> tvs;
+};
+
+//! Splits the tensors of fusion into its disconnected subgraphs, ordered by
+//! their first fusion output. Tensors that don't reach an output, e.g.
+//! unused inputs, are dropped.
+std::vector<Subgraph> getSubgraphs(Fusion* fusion) {
+  DisjointSets<TensorView*> tv_sets;
+  for (auto tv : ir_utils::allTvs(fusion)) {
+    tv_sets.initializeSet(tv);
+  }
+  for (auto tv : ir_utils::filterByType<TensorView>(fusion->outputs())) {
+    tv_sets.initializeSet(tv);
+  }
+  for (auto expr : fusion->exprs()) {
+    auto out_tvs = ir_utils::filterByType<TensorView>(expr->outputs());
+    if (out_tvs.empty()) {
+      continue;
+    }
+    TensorView* out0 = *out_tvs.begin();
+    for (auto tv : ir_utils::filterByType<TensorView>(expr->inputs())) {
+      tv_sets.mapEntries(out0, tv);
+    }
+    for (auto tv : out_tvs) {
+      tv_sets.mapEntries(out0, tv);
+    }
+  }
+
+  std::vector<Subgraph> subgraphs;
+  std::unordered_set<const VectorOfUniqueEntries<TensorView*>*> seen;
+  for (auto out : ir_utils::filterByType<TensorView>(fusion->outputs())) {
+    const auto& tv_set = tv_sets.getDisjointSetOf(out);
+    if (!seen.insert(&tv_set).second) {
+      continue;
+    }
+    subgraphs.push_back({out, tv_set.vector()});
+  }
+  return subgraphs;
+}
+
+int64_t numElements(TensorView* tv, SchedulerRuntimeInfo& runtime_info) {
+  int64_t n_elems = 1;
+  for (auto id : TensorDomain::noReductions(tv->getMaybeRFactorDomain())) {
+    auto extent = runtime_info.expressionEvaluator().evaluate(id->extent());
+    NVF_ERROR(
+        extent.hasValue(),
+        "Error inferring size for multi-tensor scheduler: ",
+        id->extent()->toInlineString());
+    n_elems *= extent.as<int64_t>();
+  }
+  return n_elems;
+}
+
+//! Applies the 1D pointwise schedule to a subgraph
+void scheduleSubgraph(const Subgraph& subgraph, int64_t vectorization_factor) {
+  TensorView* reference_tv = subgraph.reference;
+
+  std::unordered_map<int64_t, int64_t> rfactor_reorder_map =
+      scheduler_utils::maybeRfactorReorderAsAllocationMap(reference_tv);
+  if (!rfactor_reorder_map.empty()) {
+    reference_tv->reorder(rfactor_reorder_map);
+  }
+  for (int64_t i = reference_tv->nDims() - 1; i > 0; i--) {
+    reference_tv->merge(i - 1, i);
+  }
+
+  if (vectorization_factor > 1) {
+    reference_tv->split(0, vectorization_factor);
+  }
+  reference_tv->split(0, kThreadX);
+  // [BIDx, TIDx, Vectorization]
+  reference_tv->axis(0)->parallelize(ParallelType::BIDx);
+  reference_tv->axis(1)->parallelize(ParallelType::TIDx);
+
+  TransformPropagator propagator(reference_tv);
+  MaxRootDomainInfoSpanningTree spanning_tree(reference_tv);
+  spanning_tree.traverse(&propagator);
+  scheduler_utils::parallelizeAllLike(reference_tv, subgraph.tvs);
+
+  if (vectorization_factor == 1) {
+    return;
+  }
+  // Vectorize the cached inputs and outputs like the pointwise scheduler
+  std::vector<TensorView*> vectorized_tvs;
+  bool should_vectorize_reference_tv = false;
+  for (auto tv : scheduler_utils::getInputsOutputsWithInnerDim(
+           reference_tv, true, true)) {
+    if (tv == reference_tv) {
+      should_vectorize_reference_tv = true;
+    }
+    if (!tv->isFusionInput()) {
+      vectorized_tvs.push_back(tv);
+      continue;
+    }
+    auto consumer_tvs = ir_utils::consumerTvsOf(tv);
+    vectorized_tvs.insert(
+        vectorized_tvs.end(), consumer_tvs.begin(), consumer_tvs.end());
+  }
+  if (vectorized_tvs.empty()) {
+    return;
+  }
+  IterDomain* vectorize_id = reference_tv->axis(2);
+  vectorize_id->parallelize(ParallelType::Vectorize);
+  scheduler_utils::parallelizeAllLike(
+      reference_tv, vectorized_tvs, {ParallelType::Vectorize});
+  if (!should_vectorize_reference_tv) {
+    vectorize_id->parallelize(ParallelType::Serial);
+  }
+}
+
+} // namespace
+
+MultiTensorScheduler::MultiTensorScheduler(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache)
+    : SchedulerEntry(heuristicType()) {
+  computeHeuristics(fusion, runtime_info, data_cache);
+}
+
+bool MultiTensorScheduler::canScheduleCompileTime(Fusion* fusion) {
+  if (!isOptionEnabled(EnableOption::MultiTensorScheduler)) {
+    scheduler_debug_utils::canScheduleRejectReason(
+        heuristicType(), "not enabled");
+    return false;
+  }
+
+  if (registry_utils::isConnectedFusionGraph(fusion)) {
+    scheduler_debug_utils::canScheduleRejectReason(
+        heuristicType(), "connected fusions are left to other schedulers");
+    return false;
+  }
+
+  // Only plain elementwise ops, so that flattening each subgraph is always
+  // valid
+  for (auto expr : fusion->exprs()) {
+    if (ir_utils::filterByType<TensorView>(expr->outputs()).empty()) {
+      continue;
+    }
+    if (!expr->isOneOf<UnaryOp, BinaryOp, TernaryOp, LoadStoreOp>()) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          heuristicType(), "unsupported op: ", expr->getOpString());
+      return false;
+    }
+  }
+
+  for (auto tv : ir_utils::allTvs(fusion)) {
+    if (tv->hasBroadcast() || tv->hasReduction() || tv->hasRFactor() ||
+        tv->isCpuScalar()) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          heuristicType(),
+          "only non-broadcast, non-reduction tensors are supported: ",
+          tv->toString());
+      return false;
+    }
+  }
+
+  for (const auto& subgraph : getSubgraphs(fusion)) {
+    if (subgraph.reference->isFusionInput() ||
+        subgraph.reference->nDims() == 0) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          heuristicType(),
+          "subgraph without a reference tensor: ",
+          subgraph.reference->toString());
+      return false;
+    }
+    for (auto tv : subgraph.tvs) {
+      if (tv->nDims() != subgraph.reference->nDims()) {
+        scheduler_debug_utils::canScheduleRejectReason(
+            heuristicType(),
+            "tensors of a subgraph must have the same rank: ",
+            tv->toString());
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+bool MultiTensorScheduler::canScheduleRunTime(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache) {
+  return true;
+}
+
+void MultiTensorScheduler::schedule(Fusion* fusion) {
+  FUSER_PERF_SCOPE("Schedule MultiTensor Fusion");
+  auto params = std::dynamic_pointer_cast<MultiTensorParams>(params_);
+  NVF_ERROR(
+      params != nullptr,
+      "Heuristic parameter is not a multi-tensor parameter");
+  scheduleMultiTensor(fusion, *params);
+}
+
+void MultiTensorScheduler::computeHeuristics(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache) {
+  params_ = getMultiTensorHeuristics(fusion, runtime_info, data_cache);
+  NVF_ERROR(params_ != nullptr);
+}
+
+std::shared_ptr<MultiTensorParams> getMultiTensorHeuristics(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache) {
+  FUSER_PERF_SCOPE("getMultiTensorHeuristics");
+
+  FusionGuard fg(fusion);
+
+  auto params = std::make_shared<MultiTensorParams>(
+      "Multi-tensor heuristics", runtime_info.getIndexType());
+  for (const auto& subgraph : getSubgraphs(fusion)) {
+    // The compile time entries of the data cache hold a single reference
+    // tensor, so the per subgraph analysis is not cached
+    const int64_t vectorization_factor =
+        numElements(subgraph.reference, runtime_info) == 0
+        ? 1
+        : vectorize_helper::getVectorizationFactor(
+              runtime_info, subgraph.reference, nullptr, 0);
+    params->vectorization_factors.push_back(vectorization_factor);
+  }
+
+  if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
+    debug() << params->toString() << std::endl;
+  }
+  return params;
+}
+
+void scheduleMultiTensor(Fusion* fusion, const MultiTensorParams& params) {
+  FusionGuard fg(fusion);
+
+  // Make sure we don't have global memory set on intermediate tensors from
+  // fusion segmentation
+  scheduler_utils::clearMemorySpace(fusion);
+
+  scheduler_utils::cacheInputs(fusion, true);
+  scheduler_utils::cacheAndForkOutputs(fusion, true);
+
+  const std::vector<Subgraph> subgraphs = getSubgraphs(fusion);
+  NVF_ERROR(
+      subgraphs.size() == params.vectorization_factors.size(),
+      "Expected ",
+      params.vectorization_factors.size(),
+      " subgraphs but found ",
+      subgraphs.size());
+  for (auto i : c10::irange(subgraphs.size())) {
+    scheduleSubgraph(subgraphs[i], params.vectorization_factors[i]);
+  }
+
+  inlineMost();
+}
+
+} // namespace nvfuser
@@ -0,0 +1,71 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <fusion.h>
+#include <scheduler/multi_tensor_heuristic.h>
+#include <scheduler/registry.h>
+#include <visibility.h>
+
+namespace nvfuser {
+
+class SchedulerRuntimeInfo;
+class HeuristicSummary;
+
+//! The multi-tensor scheduler generates a single kernel for a fusion made of
+//! independent elementwise subgraphs, like apex's multi_tensor_apply does for
+//! the per-parameter updates of an optimizer step. Without it, each subgraph
+//! becomes a segment of its own, and small parameters launch kernels of only
+//! a few blocks.
+//!
+//! Each subgraph is flattened to 1D and split into blocks of 128 threads,
+//! vectorized by the factor the pointwise vectorization analysis finds for
+//! it. All subgraphs share BIDx, so the kernel launches as many blocks as the
+//! largest subgraph needs and the other subgraphs predicate out the
+//! remaining blocks. Unlike multi_tensor_apply, the tensors are not grouped
+//! into a chunk table at run time, since a kernel is generated for the
+//! tensors of the fusion anyway.
+//!
+//! Enabled with EnableOption::MultiTensorScheduler.
+std::shared_ptr<MultiTensorParams> getMultiTensorHeuristics(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache = nullptr);
+
+NVF_API void scheduleMultiTensor(
+    Fusion* fusion,
+    const MultiTensorParams& params);
+
+class MultiTensorScheduler : public SchedulerEntry {
+ public:
+  explicit MultiTensorScheduler(
+      Fusion* fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      HeuristicSummary* data_cache = nullptr);
+
+  static bool canScheduleCompileTime(Fusion* fusion);
+
+  static bool canScheduleRunTime(
+      Fusion* fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      HeuristicSummary* data_cache = nullptr);
+
+  constexpr static ScheduleHeuristic heuristicType() {
+    return ScheduleHeuristic::MultiTensor;
+  }
+
+  void schedule(Fusion* fusion) override;
+
+ private:
+  void computeHeuristics(
+      Fusion* fusion,
+      SchedulerRuntimeInfo& runtime_info,
+      HeuristicSummary* data_cache = nullptr);
+};
+
+} // namespace nvfuser
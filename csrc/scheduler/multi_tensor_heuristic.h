@@ -0,0 +1,70 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#pragma once
+
+#include <scheduler/heuristic.h>
+
+#include <sstream>
+#include <vector>
+
+namespace nvfuser {
+
+// Parameters of the multi-tensor heuristic. Each independent subgraph of the
+// fusion is scheduled on its own, so the parameters are per subgraph, in the
+// order of the first fusion output of each subgraph.
+// Warning: equal operator is intended for use in caching the kernel associated
+// with these parameters. It does not check if the launch parameters are
+// equivelent!
+class MultiTensorParams : public HeuristicParams {
+ public:
+  // Vectorization factor of each subgraph, 1 means not vectorized
+  std::vector<int64_t> vectorization_factors;
+
+  using HeuristicParams::HeuristicParams;
+
+  // Warning: Does not check launch parameters!
+  bool sameAs(
+      const std::shared_ptr<HeuristicParams>& other_base) const override {
+    auto other_casted =
+        std::dynamic_pointer_cast<MultiTensorParams>(other_base);
+    if (other_casted == nullptr) {
+      return false;
+    }
+    return other_casted->cparams == cparams &&
+        other_casted->vectorization_factors == vectorization_factors;
+  }
+
+  std::string toString() const override {
+    std::stringstream ss;
+    ss << "\n===== Multi-tensor Parameters ========\n"
+       << (tag.empty() ? "" : "Tag: ") << tag << "\n"
+       << " Gridx: " << lparams.gdimx() << " BlckX: " << lparams.bdimx()
+       << "\n"
+       << "Vectorization factors:";
+    for (auto factor : vectorization_factors) {
+      ss << " " << factor;
+    }
+    ss << "\n====================================\n";
+    return ss.str();
+  }
+
+  // Warning: Hash is not based on launch parameters!
+  size_t hash() const override {
+    size_t attr_hash = vectorization_factors.size();
+    for (auto factor : vectorization_factors) {
+      attr_hash = attr_hash * 31 + static_cast<size_t>(factor);
+    }
+    return attr_hash;
+  }
+
+  std::shared_ptr<HeuristicParams> clone() const override {
+    return std::make_shared<MultiTensorParams>(*this);
+  }
+};
+
+} // namespace nvfuser
@@ -6,7 +6,9 @@
  */
 // clang-format on
 #include <instrumentation.h>
+#include <options.h>
 #include <scheduler/debug_utils.h>
+#include <scheduler/heuristic_plugin.h>
 #include <scheduler/normalization_inner.h>
 #include <scheduler/normalization_utils.h>
 #include <scheduler/reduction_utils.h>
@@ -74,6 +76,19 @@ std::pair<int64_t, int64_t> getPersistentBufferSize(
       persistent_buffer_size, available_persistent_buffer_size);
 }
 
+// Returns true if the persistent buffer of a 2D normalization doesn't fit in
+// the registers and shared memory of a block, and EnableOption::GridPersistence
+// lets the rows be split across the grid instead.
+bool useGridPersistence(
+    int64_t total_reduction_numel,
+    int64_t inner_most_dimension_numel,
+    int64_t persistent_buffer_size,
+    int64_t available_persistent_buffer_size) {
+  return isOptionEnabled(EnableOption::GridPersistence) &&
+      persistent_buffer_size > available_persistent_buffer_size &&
+      total_reduction_numel == inner_most_dimension_numel;
+}
+
 } // namespace
 
 bool InnerPersistentKernelScheduler::canScheduleRunTime(
@@ -106,13 +121,30 @@ bool InnerPersistentKernelScheduler::canScheduleRunTime(
   const int64_t device_multiprocessor_count =
       (int64_t)at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
 
-  if (persistent_buffer_size > available_persistent_buffer_size) {
+  const bool grid_persistence = useGridPersistence(
+      properties.total_reduction_numel,
+      properties.inner_most_dimension_numel,
+      persistent_buffer_size,
+      available_persistent_buffer_size);
+  if (persistent_buffer_size > available_persistent_buffer_size &&
+      !grid_persistence) {
     scheduler_debug_utils::canScheduleRejectReason(
         heuristicType(),
         "not enough registers or shared memory for persistence");
     return false;
   }
 
+  if (!grid_persistence &&
+      normalization_scheduler_utils::preferL2ResidentTwoPass(
+          persistent_buffer_size,
+          available_persistent_buffer_size,
+          properties.total_iteration_numel)) {
+    scheduler_debug_utils::canScheduleRejectReason(
+        heuristicType(),
+        "persistent buffers starve the SMs and are faster re-read from L2");
+    return false;
+  }
+
   const int64_t device_max_threads_per_multiprocessor =
       (int64_t)at::cuda::getCurrentDeviceProperties()
           ->maxThreadsPerMultiProcessor;
@@ -130,8 +162,10 @@ bool InnerPersistentKernelScheduler::canScheduleRunTime(
   }
 
   // Don't go persistent if we can't use a small fraction of the
-  // available SMs yet have a large reduction size.
-  if ( // Large reduction dim
+  // available SMs yet have a large reduction size. Grid persistence splits
+  // the reduction across the SMs instead.
+  if (!grid_persistence &&
+      // Large reduction dim
       properties.total_reduction_numel >=
           device_max_threads_per_multiprocessor * 4 &&
       properties.total_iteration_numel <
@@ -506,6 +540,14 @@ void innerPersistentHeuristic2D(
 
   // Fill in the reduction params
   rparams->cparams.maxrregcount = best_heuristic.register_per_thread;
+  if (isOptionEnabled(EnableOption::OccupancyTargeting)) {
+    // The occupancy is in warps per SM
+    const int64_t threads_per_block = best_heuristic.bdimy *
+        (best_heuristic.is_pad_bdimx ? best_heuristic.padded_bdimx
+                                     : best_heuristic.bdimx);
+    rparams->cparams.min_blocks_per_sm = scheduler_utils::safeDiv(
+        best_heuristic.occupancy * threads_per_warp, threads_per_block);
+  }
 
   // Inner reduction domain
   rparams->cross_block_inner_reduction = true;
@@ -587,6 +629,61 @@ void innerPersistentHeuristicSharedMemory(
       LaunchParams::UNINITIALIZED_VAL);
 }
 
+// Splits each row across gridDim.y blocks that keep their part of the
+// persistent buffers in registers, so the row is read from global memory only
+// once. Partial results are reduced across the grid, which requires a
+// cooperative launch, i.e. all blocks have to be resident at the same time.
+// Each block uses as many registers as the 2D heuristic allows a whole row
+// to use, so only one block fits per SM, and the grid loops over the rows in
+// chunks of gridDim.x.
+void innerPersistentHeuristicGrid(
+    const PersistentKernelProperties& properties,
+    std::shared_ptr<ReductionParams> rparams) {
+  const auto dev_prop = at::cuda::getCurrentDeviceProperties();
+  const int64_t max_threads_in_block = (int64_t)dev_prop->maxThreadsPerBlock;
+  const int64_t device_multiprocessor_count =
+      (int64_t)dev_prop->multiProcessorCount;
+  const int64_t vectorize_factor = properties.vectorize_factor;
+
+  // canScheduleRunTime makes sure that a row uses at most half of the SMs
+  const int64_t gdimy = ceilDiv(
+      properties.max_persistent_buffer_size,
+      scheduler_utils::register_file_size);
+  const int64_t gdimx = std::max(
+      (int64_t)1,
+      std::min(
+          properties.total_iteration_numel,
+          device_multiprocessor_count / gdimy));
+  const int64_t persistent_batch = ceilDiv(
+      properties.total_reduction_numel,
+      vectorize_factor * max_threads_in_block * gdimy);
+  rparams->cparams.maxrregcount =
+      getRegPerThreadGivenThreadsPerSM(max_threads_in_block);
+
+  // Inner reduction domain
+  rparams->cross_block_inner_reduction = true;
+  rparams->cross_grid_inner_reduction = true;
+  rparams->block_dim_inner_reduction = ParallelType::TIDx;
+  rparams->grid_dim_inner_reduction = ParallelType::BIDy;
+  rparams->pad_inner_reduction_to_warp = true;
+  rparams->batches_per_block_inner_reduction = persistent_batch;
+  rparams->unroll_factor_inner_reduction = vectorize_factor;
+  rparams->vectorize_inner_reduction = vectorize_factor > 1;
+
+  // Iter domain
+  rparams->multiple_reds_per_blk = false;
+  rparams->grid_dim_iter_dom = ParallelType::BIDx;
+  rparams->split_grid_dim_iter_dom_outer = true;
+  rparams->unroll_factor_iter_dom = 1;
+  rparams->lparams = LaunchParams(
+      gdimx,
+      gdimy,
+      LaunchParams::UNINITIALIZED_VAL,
+      LaunchParams::UNINITIALIZED_VAL,
+      LaunchParams::UNINITIALIZED_VAL,
+      LaunchParams::UNINITIALIZED_VAL);
+}
+
 // TODO: clean and revise the heuristics
 void innerPersistentHeuristic3D(
     const PersistentKernelProperties& properties,
@@ -1097,8 +1194,30 @@ std::shared_ptr<ReductionParams> getInnerPersistentHeuristics(
   rparams->project_persistent_buffers = prop.project_persistent_buffers;
   rparams->cparams.index_type = prop.index_type;
 
+  bool grid_persistence = false;
+  if (isOptionEnabled(EnableOption::GridPersistence)) {
+    auto reduction_tv_entry =
+        HeuristicSummaryEntry<HeuristicCompileTime::ReductionTVs>(
+            data_cache, [&fusion]() {
+              return std::make_unique<std::vector<TensorView*>>(
+                  scheduler_utils::getReductionTvs(fusion));
+            });
+    // pair of persistent_buffer_size and available_persistent_buffer_size
+    const std::pair<int64_t, int64_t> buffer_size = getPersistentBufferSize(
+        fusion, runtime_info, data_cache, reduction_tv_entry.get());
+    grid_persistence = useGridPersistence(
+        prop.total_reduction_numel,
+        prop.inner_most_dimension_numel,
+        buffer_size.first,
+        buffer_size.second);
+  }
+
   // specific heuristics for different cases
-  if (prop.max_persistent_buffer_size > scheduler_utils::register_file_size) {
+  if (grid_persistence) {
+    rparams->tag = "Grid Inner Persistent Heuristic.\n";
+    innerPersistentHeuristicGrid(prop, rparams);
+  } else if (
+      prop.max_persistent_buffer_size > scheduler_utils::register_file_size) {
     rparams->tag = "Shared Memory Inner Persistent Heuristic.\n";
     innerPersistentHeuristicSharedMemory(prop, rparams);
   } else if (prop.total_reduction_numel == prop.inner_most_dimension_numel) {
@@ -1109,6 +1228,16 @@ std::shared_ptr<ReductionParams> getInnerPersistentHeuristics(
     innerPersistentHeuristic3D(prop, rparams);
   }
 
+  if (heuristic_plugin::hasPlugin(
+          heuristic_plugin::ProblemDescription::Kernel::InnerPersistent)) {
+    normalization_scheduler_utils::updatePersistentParamsWithPlugin(
+        fusion,
+        runtime_info,
+        prop,
+        heuristic_plugin::ProblemDescription::Kernel::InnerPersistent,
+        *rparams);
+  }
+
   // debug print
   if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
     debug() << prop.toString() << std::endl;
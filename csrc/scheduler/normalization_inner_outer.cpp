@@ -7,6 +7,7 @@
 // clang-format on
 #include <inlining.h>
 #include <instrumentation.h>
+#include <options.h>
 #include <scheduler/debug_utils.h>
 #include <scheduler/normalization_inner_outer.h>
 #include <scheduler/normalization_utils.h>
@@ -182,6 +183,33 @@ bool InnerOuterPersistentKernelScheduler::canScheduleCompileTime(
 
 namespace {
 
+// Shared memory a block can use for the partial results of outer reductions,
+// excluding the reserved shared memory and the workspace of the block
+// reductions, which is estimated with the widest reduction data type.
+int64_t getAvailableSharedMemoryForOuterPartialBuffers() {
+  const auto dev_prop = at::cuda::getCurrentDeviceProperties();
+  const int64_t reduction_broadcast_workspace =
+      (int64_t)dev_prop->maxThreadsPerBlock * (int64_t)sizeof(double);
+  return (int64_t)dev_prop->sharedMemPerBlockOptin -
+      (int64_t)dev_prop->reservedSharedMemPerBlock -
+      reduction_broadcast_workspace;
+}
+
+// The partial results of outer reductions are accumulated by each block over
+// all its rows. When they and the persistent buffers of the inner reductions
+// don't fit in the register file together, keeping the partial results in
+// shared memory avoids segmenting the fusion into three kernels.
+bool useSharedMemoryForOuterPartialBuffers(
+    const int64_t persistent_buffer_size,
+    const int64_t outer_partial_buffer_size) {
+  return isOptionEnabled(EnableOption::InnerOuterSharedMemory) &&
+      outer_partial_buffer_size > 0 &&
+      persistent_buffer_size + outer_partial_buffer_size >
+          scheduler_utils::register_file_size_full &&
+      outer_partial_buffer_size <=
+          getAvailableSharedMemoryForOuterPartialBuffers();
+}
+
 std::pair<int64_t, int64_t> getPersistentBufferSize(
     Fusion* fusion,
     SchedulerRuntimeInfo& runtime_info,
@@ -208,16 +236,21 @@ std::pair<int64_t, int64_t> getPersistentBufferSize(
             persistent_buffer_size_info.projected_persistent_buffer_size);
 
   // in combined_inner_outer_reduction, the partial results of outer
-  // reductions must be persistent, allow register spill avoid segmentation
+  // reductions must be persistent, allow register spill avoid segmentation.
+  // They don't take registers if they are kept in shared memory.
   std::vector<TensorView*> outer_reduction_tvs;
   for (auto tv : reduction_tvs) {
     if (!scheduler_utils::isFastestDimReduction(tv)) {
       outer_reduction_tvs.emplace_back(tv);
     }
   }
-  persistent_buffer_size +=
+  const int64_t outer_partial_buffer_size =
       normalization_scheduler_utils::partialReductionBufferSize(
           outer_reduction_tvs, runtime_info);
+  if (!useSharedMemoryForOuterPartialBuffers(
+          persistent_buffer_size, outer_partial_buffer_size)) {
+    persistent_buffer_size += outer_partial_buffer_size;
+  }
 
   int64_t available_persistent_buffer_size =
       scheduler_utils::register_file_size_full;
@@ -371,9 +404,11 @@ std::shared_ptr<ReductionParams> innerOuterPersistentHeuristic(
     const size_t tmp_gmem_dtype_size,
     const size_t vectorize_factor,
     const bool project_to_input,
-    const PrimDataType index_type) {
+    const PrimDataType index_type,
+    const int64_t smem_outer_partial_buffer_size) {
   auto rparams = std::make_shared<ReductionParams>();
   rparams->project_persistent_buffers = project_to_input;
+  rparams->shared_mem_outer_partial_buffer = smem_outer_partial_buffer_size > 0;
   rparams->cparams.index_type = index_type;
   // Parameters for inner reduction:
   // Reduction dim: inner_vect, inner_batch, bdimx and bdimy
@@ -429,8 +464,21 @@ std::shared_ptr<ReductionParams> innerOuterPersistentHeuristic(
             ceilDiv(threads_per_block, warp_size),
             warp_allocation_granularity) *
         warp_allocation_granularity;
-    return scheduler_utils::safeDiv(
+    const int64_t blocks_per_sm = scheduler_utils::safeDiv(
         threads_per_sm / warp_size, allocated_warps_per_block);
+    if (smem_outer_partial_buffer_size == 0) {
+      return blocks_per_sm;
+    }
+    // All the blocks must be resident for the grid sync, so the partial
+    // results in shared memory also limit the blocks per SM.
+    const auto dev_prop = at::cuda::getCurrentDeviceProperties();
+    const int64_t smem_per_block = smem_outer_partial_buffer_size +
+        (int64_t)dev_prop->reservedSharedMemPerBlock +
+        (int64_t)dev_prop->maxThreadsPerBlock * (int64_t)sizeof(double);
+    return std::min(
+        blocks_per_sm,
+        scheduler_utils::safeDiv(
+            (int64_t)dev_prop->sharedMemPerMultiprocessor, smem_per_block));
   };
 
   const auto dev_prop = at::cuda::getCurrentDeviceProperties();
@@ -574,6 +622,9 @@ std::shared_ptr<ReductionParams> innerOuterPersistentHeuristic(
   rparams->vectorization_factor_tmp_gmem_write = iop.tmp_gmem_write_vect;
   rparams->cparams.maxrregcount =
       getRegPerThreadGivenThreadsPerSM(iop.bdimx * iop.bdimy * blocks_per_sm);
+  if (isOptionEnabled(EnableOption::OccupancyTargeting)) {
+    rparams->cparams.min_blocks_per_sm = blocks_per_sm;
+  }
   rparams->unroll_factor_inner_reduction = iop.inner_vect;
   rparams->batches_per_block_inner_reduction = iop.inner_batch;
   rparams->block_dim_inner_reduction = ParallelType::TIDx;
@@ -596,6 +647,8 @@ std::shared_ptr<ReductionParams> innerOuterPersistentHeuristic(
             << "inner_dim_numel: " << inner_dim_numel << "\n"
             << "max_persistent_buffer_size: " << max_persistent_buffer_size
             << "\n"
+            << "smem_outer_partial_buffer_size: "
+            << smem_outer_partial_buffer_size << "\n"
             << "vectorize_factor_input: " << iop.inner_vect << "\n"
             << "vectorization_factor_tmp_gmem_write: "
             << iop.tmp_gmem_write_vect << "\n"
@@ -618,7 +671,8 @@ std::shared_ptr<ReductionParams> persistentHeuristic(
     const int64_t max_persistent_buffer_size,
     size_t vectorize_factor,
     bool project_persistent_buffers,
-    const PrimDataType index_type) {
+    const PrimDataType index_type,
+    const int64_t smem_outer_partial_buffer_size) {
   const int64_t outer_dim_numel = total_iteration_numel;
   const int64_t inner_dim_numel = inner_most_dimension_numel;
   auto rparams = innerOuterPersistentHeuristic(
@@ -628,7 +682,8 @@ std::shared_ptr<ReductionParams> persistentHeuristic(
       tmp_gmem_dtype_size,
       vectorize_factor,
       project_persistent_buffers,
-      index_type);
+      index_type,
+      smem_outer_partial_buffer_size);
   return rparams;
 }
 
@@ -717,6 +772,9 @@ std::shared_ptr<ReductionParams> getInnerOuterPersistentHeuristics(
       ? persistent_buffer_size_info.projected_persistent_buffer_size
       : persistent_buffer_size_info.persistent_buffer_size;
 
+  // Size of the partial results of outer reductions if they are kept in
+  // shared memory instead of registers.
+  int64_t smem_outer_partial_buffer_size = 0;
   if (can_project) {
     // In combined_inner_outer_reduction, we have additional buffers for
     // partial results of outer reductions.
@@ -746,13 +804,14 @@ std::shared_ptr<ReductionParams> getInnerOuterPersistentHeuristics(
       }
     }
     // now we have the final decision on whether we project to input or not.
-    if (project_persistent_buffers) {
-      max_persistent_size =
-          persistent_buffer_size_info.projected_persistent_buffer_size +
-          outer_reduction_buffer_size;
+    max_persistent_size = project_persistent_buffers
+        ? persistent_buffer_size_info.projected_persistent_buffer_size
+        : persistent_buffer_size_info.persistent_buffer_size;
+    if (useSharedMemoryForOuterPartialBuffers(
+            max_persistent_size, outer_reduction_buffer_size)) {
+      smem_outer_partial_buffer_size = outer_reduction_buffer_size;
     } else {
-      max_persistent_size = persistent_buffer_size_info.persistent_buffer_size +
-          outer_reduction_buffer_size;
+      max_persistent_size += outer_reduction_buffer_size;
     }
   }
 
@@ -776,7 +835,8 @@ std::shared_ptr<ReductionParams> getInnerOuterPersistentHeuristics(
       max_persistent_size,
       vectorize_factor,
       project_persistent_buffers,
-      runtime_info.getIndexType());
+      runtime_info.getIndexType(),
+      smem_outer_partial_buffer_size);
   return heuristic;
 }
 
@@ -827,7 +887,10 @@ void scheduleReductionCombinedOuter(
       outer_reduction_tv->rFactor({1});
     }
     TensorView* partialResult = outer_reduction_tv->rFactor({1});
-    partialResult->cacheBefore();
+    TensorView* partialResultCache = partialResult->cacheBefore();
+    if (rparams.shared_mem_outer_partial_buffer) {
+      partialResultCache->setMemoryType(MemoryType::Shared);
+    }
     partialResult->setMemoryType(MemoryType::Global);
     TensorView* partialResultReload = partialResult->cacheAfter();
 
@@ -6,8 +6,10 @@
  */
 // clang-format on
 #include <instrumentation.h>
+#include <options.h>
 #include <scheduler/cache_policy_refiner.h>
 #include <scheduler/debug_utils.h>
+#include <scheduler/heuristic_plugin.h>
 #include <scheduler/normalization_outer.h>
 #include <scheduler/normalization_utils.h>
 #include <scheduler/reduction_utils.h>
@@ -36,6 +38,87 @@ bool OuterPersistentKernelScheduler::canScheduleCompileTime(Fusion* fusion) {
       fusion, heuristicType());
 }
 
+namespace {
+
+// Batch norms with a large N*H*W have persistent buffers that don't fit in
+// the registers of half of the device, so the fusion would be segmented into
+// a grid Welford and a normalization kernel. With
+// EnableOption::TwoPassOuterNormalization, the persistent buffers are
+// projected to the inputs, which are read again after the grid Welford.
+// The kernel then only needs a cooperative grid, whose blocks are resident at
+// the same time anyway as the launch configs use one block per SM.
+bool useTwoPassGridPersistence(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    HeuristicSummary* data_cache,
+    const int64_t vectorization_factor) {
+  if (!isOptionEnabled(EnableOption::TwoPassOuterNormalization)) {
+    return false;
+  }
+
+  auto reduction_tv_entry =
+      HeuristicSummaryEntry<HeuristicCompileTime::ReductionTVs>(
+          data_cache, [&fusion]() {
+            return std::make_unique<std::vector<TensorView*>>(
+                scheduler_utils::getReductionTvs(fusion));
+          });
+  const auto& reduction_tvs = reduction_tv_entry.get();
+  if (std::any_of(
+          reduction_tvs.begin(),
+          reduction_tvs.end(),
+          [](TensorView* reduction_tv) {
+            return !reduction_tv->definition()->isA<WelfordOp>();
+          })) {
+    return false;
+  }
+
+  auto persistent_buffer_info_entry =
+      HeuristicSummaryEntry<HeuristicCompileTime::PersistentBufferInfo>(
+          data_cache, [&fusion]() {
+            return std::make_unique<scheduler_utils::PersistentBufferInfo>(
+                scheduler_utils::persistentBuffers(fusion));
+          });
+  const auto& persistent_buffer_info = persistent_buffer_info_entry.get();
+
+  // All the persistent buffers must be inputs or recomputed from the inputs
+  const auto& projectable_buffers =
+      persistent_buffer_info.projectable_persistent_buffers;
+  if (!ir_utils::getViewOps(fusion).empty() ||
+      std::any_of(
+          persistent_buffer_info.persistent_buffers.begin(),
+          persistent_buffer_info.persistent_buffers.end(),
+          [&projectable_buffers](TensorView* buffer) {
+            return !buffer->isFusionInput() &&
+                std::find(
+                    projectable_buffers.begin(),
+                    projectable_buffers.end(),
+                    buffer) == projectable_buffers.end();
+          })) {
+    return false;
+  }
+
+  auto persistent_buffer_size_info = scheduler_utils::persistentBufferSize(
+      fusion, runtime_info, persistent_buffer_info, data_cache);
+  const int64_t persistent_buffer_size =
+      persistent_buffer_size_info.projected_persistent_buffer_size == 0
+      ? persistent_buffer_size_info.persistent_buffer_size
+      : std::min(
+            persistent_buffer_size_info.persistent_buffer_size,
+            persistent_buffer_size_info.projected_persistent_buffer_size);
+
+  const auto device_prop = at::cuda::getCurrentDeviceProperties();
+  const int64_t sm_register_file_size =
+      static_cast<int64_t>(device_prop->regsPerBlock * sizeof(int));
+  const int64_t required_sm_per_norm = ceilDiv(
+      persistent_buffer_size * vectorization_factor *
+          normalization_scheduler_utils::PreferredLaunchConfig::kMinBdimx,
+      sm_register_file_size);
+  return required_sm_per_norm >
+      scheduler_utils::safeDiv(device_prop->multiProcessorCount, 2);
+}
+
+} // namespace
+
 bool OuterPersistentKernelScheduler::canScheduleRunTime(
     Fusion* fusion,
     SchedulerRuntimeInfo& runtime_info,
@@ -84,12 +167,6 @@ bool OuterPersistentKernelScheduler::canScheduleRunTime(
   const auto available_persistent_buffer_size =
       sm_register_file_size * device_multiprocessor_count;
 
-  if (persistent_buffer_size > available_persistent_buffer_size) {
-    scheduler_debug_utils::canScheduleRejectReason(
-        heuristicType(), "not enough registers for persistence");
-    return false;
-  }
-
   auto reduced_tv = ir_utils::getSoleProducerTv(reduction_tvs.at(0));
 
   const int64_t vectorization_factor = vectorize_helper::getVectorizationFactor(
@@ -98,6 +175,33 @@ bool OuterPersistentKernelScheduler::canScheduleRunTime(
       data_cache,
       reduced_tv->nDims() - properties.inner_most_dimension_ndims);
 
+  if (useTwoPassGridPersistence(
+          fusion, runtime_info, data_cache, vectorization_factor)) {
+    if (vectorization_factor < 4) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          heuristicType(), "two pass - not enough vectorized");
+      return false;
+    }
+    if (!normalization_scheduler_utils::getGridOuterNormalizationParams(
+             properties.total_reduction_numel,
+             properties.total_iteration_numel,
+             vectorization_factor,
+             persistent_buffer_size,
+             /*reread_persistent_buffers=*/true)
+             .has_value()) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          heuristicType(), "two pass - no valid launch config found");
+      return false;
+    }
+    return true;
+  }
+
+  if (persistent_buffer_size > available_persistent_buffer_size) {
+    scheduler_debug_utils::canScheduleRejectReason(
+        heuristicType(), "not enough registers for persistence");
+    return false;
+  }
+
   // Minimum required multi reduction factor.
   const int64_t min_multi_reduction_factor = vectorization_factor *
       normalization_scheduler_utils::PreferredLaunchConfig::kMinBdimx;
@@ -294,13 +398,15 @@ std::shared_ptr<ReductionParams> gridOuterPersistentHeuristic(
     const int64_t max_persistent_buffer_size,
     const size_t vectorize_factor,
     const bool project_to_input,
-    const PrimDataType index_type) {
+    const PrimDataType index_type,
+    const bool two_pass) {
   auto outer_params =
       normalization_scheduler_utils::getGridOuterNormalizationParams(
           total_reduction_numel,
           total_iteration_numel,
           (int64_t)vectorize_factor,
-          max_persistent_buffer_size);
+          max_persistent_buffer_size,
+          two_pass);
 
   NVF_ERROR(outer_params.has_value(), "No valid config found");
 
@@ -310,7 +416,9 @@ std::shared_ptr<ReductionParams> gridOuterPersistentHeuristic(
   auto rparams = std::make_shared<ReductionParams>();
 
   rparams->persistent_kernel = true;
-  rparams->project_persistent_buffers = project_to_input;
+  // The inputs are read again instead of the persistent buffers
+  rparams->project_persistent_buffers = project_to_input || two_pass;
+  rparams->global_mem_persistent_buffer = two_pass;
   rparams->cparams.index_type = index_type;
   rparams->cross_block_inner_reduction = true;
   rparams->cross_grid_inner_reduction = true;
@@ -331,6 +439,9 @@ std::shared_ptr<ReductionParams> gridOuterPersistentHeuristic(
   rparams->compute_persistent_buffer_with_first_consumer = true;
   rparams->static_bdimx = true;
   rparams->static_bdimy = true;
+  if (two_pass) {
+    rparams->tag = "Two pass grid outer persistent kernel heuristic.\n";
+  }
 
   rparams->lparams = LaunchParams(
       rparams->split_grid_dim_iter_dom_inner
@@ -352,6 +463,7 @@ std::shared_ptr<ReductionParams> gridOuterPersistentHeuristic(
             << "max_persistent_buffer_size: " << max_persistent_buffer_size
             << "\n"
             << "persistent_buffer_factor: " << pb_size << "\n"
+            << "two_pass: " << two_pass << "\n"
             << "block(" << outer_params->launch_params.bdimx() << ", "
             << outer_params->launch_params.bdimy() << ", 1)" << std::endl;
     debug() << rparams->toString() << std::endl;
@@ -371,7 +483,8 @@ std::shared_ptr<ReductionParams> outerPersistentHeuristic(
     const int64_t max_persistent_buffer_size,
     const size_t vectorize_factor,
     const bool project_to_input,
-    const PrimDataType index_type) {
+    const PrimDataType index_type,
+    const bool two_pass) {
   // Set some targets for parallelization
   const int64_t n_elems = total_reduction_numel * total_iteration_numel;
   const auto dev_prop = at::cuda::getCurrentDeviceProperties();
@@ -399,7 +512,7 @@ std::shared_ptr<ReductionParams> outerPersistentHeuristic(
           normalization_scheduler_utils::PreferredLaunchConfig::kMinBdimx,
       (int64_t)register_file_size);
 
-  if (min_required_sm_per_norm > 1) {
+  if (min_required_sm_per_norm > 1 || two_pass) {
     return gridOuterPersistentHeuristic(
         total_reduction_numel,
         total_iteration_numel,
@@ -408,7 +521,8 @@ std::shared_ptr<ReductionParams> outerPersistentHeuristic(
         max_persistent_buffer_size,
         vectorize_factor,
         project_to_input,
-        index_type);
+        index_type,
+        two_pass);
   }
 
   // Compute maximum number of reductions we could do in the same kernel based
@@ -655,7 +769,19 @@ std::shared_ptr<ReductionParams> getOuterPersistentHeuristics(
       prop.max_persistent_buffer_size,
       prop.vectorize_factor,
       prop.project_persistent_buffers,
-      prop.index_type);
+      prop.index_type,
+      useTwoPassGridPersistence(
+          fusion, runtime_info, data_cache, prop.vectorize_factor));
+
+  if (heuristic_plugin::hasPlugin(
+          heuristic_plugin::ProblemDescription::Kernel::OuterPersistent)) {
+    normalization_scheduler_utils::updatePersistentParamsWithPlugin(
+        fusion,
+        runtime_info,
+        prop,
+        heuristic_plugin::ProblemDescription::Kernel::OuterPersistent,
+        *rparams);
+  }
   return rparams;
 }
 
@@ -8,8 +8,11 @@
 #include <expr_evaluator.h>
 #include <grouped_reduction.h>
 #include <instrumentation.h>
+#include <ops/alias.h>
+#include <options.h>
 #include <scheduler/cache_policy_refiner.h>
 #include <scheduler/debug_utils.h>
+#include <scheduler/heuristic_plugin.h>
 #include <scheduler/normalization_utils.h>
 #include <scheduler/reduction_utils.h>
 #include <scheduler/registry.h>
@@ -255,7 +258,8 @@ std::optional<std::tuple<int64_t, int64_t, bool>> reduceWorkOfLastBlock(
     const int64_t total_reduction_numel,
     const int64_t total_iteration_numel,
     const int64_t persistent_buffer_size,
-    const int64_t vectorize_factor) {
+    const int64_t vectorize_factor,
+    const bool reread_persistent_buffers) {
   const auto bdimy = launch_cfg.bdimy();
 
   // Aim to reduce the work size of the last block to be smaller than
@@ -284,12 +288,13 @@ std::optional<std::tuple<int64_t, int64_t, bool>> reduceWorkOfLastBlock(
   // gdimy. Stop if the minimum gdimy is hit or the register limit is
   // reached.
   while (current_gdimy >= min_gdimy &&
-         checkIfWithinRegisterSpace(
-             total_reduction_numel,
-             persistent_buffer_size,
-             vectorize_factor,
-             bdimy,
-             current_gdimy)) {
+         (reread_persistent_buffers ||
+          checkIfWithinRegisterSpace(
+              total_reduction_numel,
+              persistent_buffer_size,
+              vectorize_factor,
+              bdimy,
+              current_gdimy))) {
     auto ratio_of_last_block_work = getLastBlockWorkRatio(
         total_reduction_numel, bdimy, current_buffer_size);
     log("Ratio of last block work: ",
@@ -378,7 +383,8 @@ std::optional<GridOuterNormalizationParams> getGridOuterNormalizationParams(
     int64_t total_reduction_numel,
     int64_t total_iteration_numel,
     int64_t vectorize_factor,
-    int64_t persistent_buffer_size) {
+    int64_t persistent_buffer_size,
+    bool reread_persistent_buffers) {
   PreferredLaunchConfig launch_cfg;
 
   // The launch config starts with the largest blockDim.x, which may
@@ -413,7 +419,8 @@ std::optional<GridOuterNormalizationParams> getGridOuterNormalizationParams(
       continue;
     }
 
-    if (!checkIfWithinRegisterSpace(
+    if (!reread_persistent_buffers &&
+        !checkIfWithinRegisterSpace(
             total_reduction_numel,
             persistent_buffer_size,
             vectorize_factor,
@@ -471,7 +478,8 @@ std::optional<GridOuterNormalizationParams> getGridOuterNormalizationParams(
           total_reduction_numel,
           total_iteration_numel,
           persistent_buffer_size,
-          vectorize_factor);
+          vectorize_factor,
+          reread_persistent_buffers);
       if (!gdimy_pb_size.has_value()) {
         launch_cfg.moveToNextConfig();
         continue;
@@ -813,6 +821,21 @@ void checkReductionTvForScheduling(Fusion* fusion, TensorView* ref_red_tv) {
       "Tried to schedule a fusion with no tensor inputs, currently not supported.");
 }
 
+bool preferL2ResidentTwoPass(
+    int64_t persistent_buffer_size,
+    int64_t available_persistent_buffer_size,
+    int64_t total_iteration_numel) {
+  if (!isOptionEnabled(EnableOption::L2AwarePersistence) ||
+      persistent_buffer_size * 2 <= available_persistent_buffer_size) {
+    return false;
+  }
+  const int64_t l2_cache_size =
+      (int64_t)at::cuda::getCurrentDeviceProperties()->l2CacheSize;
+  // Guard the product against overflow for very large iteration domains
+  return total_iteration_numel <=
+      l2_cache_size / 2 / std::max(persistent_buffer_size, (int64_t)1);
+}
+
 int64_t getMaxRegOrSharedMemorySizeForPersistentBuffer(
     SchedulerRuntimeInfo& runtime_info,
     const std::vector<TensorView*>& persistent_buffers) {
@@ -1070,6 +1093,29 @@ PersistentKernelProperties getPersistentKernelProperties(
       .has_exp_op = has_exp_op};
 }
 
+void updatePersistentParamsWithPlugin(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    const PersistentKernelProperties& prop,
+    heuristic_plugin::ProblemDescription::Kernel kernel,
+    ReductionParams& rparams) {
+  auto problem = heuristic_plugin::makeProblemDescription(
+      kernel, scheduler_utils::getReductionTvs(fusion).at(0), runtime_info);
+  if (!problem.has_value()) {
+    return;
+  }
+  problem->max_input_dtype_size = (uint8_t)prop.max_dtype_size;
+  problem->n_tensor_inputs = (uint16_t)prop.n_tensor_inputs;
+  problem->max_vectorization_factor = (uint8_t)prop.vectorize_factor;
+  problem->total_reduction_numel = prop.total_reduction_numel;
+  problem->total_iteration_numel = prop.total_iteration_numel;
+  problem->inner_most_dimension_numel = prop.inner_most_dimension_numel;
+  problem->fastest_dim_reduction =
+      kernel == heuristic_plugin::ProblemDescription::Kernel::InnerPersistent;
+  problem->max_persistent_buffer_size = prop.max_persistent_buffer_size;
+  heuristic_plugin::updateReductionParams(rparams, *problem);
+}
+
 bool checkOpsAndInputs(Fusion* fusion, ScheduleHeuristic schedule_heuristic) {
   // Needs at least one reduction to consider.
   if (!ir_utils::hasAnyReductionOps(fusion)) {
@@ -1078,6 +1124,16 @@ bool checkOpsAndInputs(Fusion* fusion, ScheduleHeuristic schedule_heuristic) {
     return false;
   }
 
+  // Whether a normalization is persistent, and how its reduction is
+  // parallelized, depends on the register file and the number of SMs of the
+  // device, so the reductions are left to the reduction scheduler, whose
+  // reduction tree only depends on the size of the reduction.
+  if (isOptionEnabled(EnableOption::ReproducibleReduction)) {
+    scheduler_debug_utils::canScheduleRejectReason(
+        schedule_heuristic, "reproducible reductions are not persistent");
+    return false;
+  }
+
   if (ir_utils::filterByType<TensorView>(fusion->inputs()).empty()) {
     scheduler_debug_utils::canScheduleRejectReason(
         schedule_heuristic, "Scheduling not supported with no input");
@@ -1293,6 +1349,27 @@ void beforeSchedule(
   scheduler_utils::clearMemorySpace(fusion);
   scheduler_utils::prepareForMemoryTypePromotion(fusion);
 
+  // Give each use of a cached input that is a persistent buffer but the
+  // first one its own load, so no buffer is live across the reduction and
+  // the input is read again from global memory after it.
+  if (rparams.global_mem_persistent_buffer) {
+    const auto& persistent_buffers =
+        scheduler_utils::persistentBuffers(fusion).persistent_buffers;
+    for (auto tv : persistent_buffers) {
+      auto load = dynamic_cast<LoadStoreOp*>(tv->definition());
+      if (load == nullptr || !load->in()->isFusionInput() ||
+          tv->uses().size() < 2) {
+        continue;
+      }
+      const std::vector<Expr*> uses(tv->uses().begin() + 1, tv->uses().end());
+      for (auto use : uses) {
+        auto reload = set(load->in()->as<TensorView>());
+        ir_utils::replaceValInExprInputs(use, tv, reload);
+        cached_inputs.emplace_back(reload);
+      }
+    }
+  }
+
   // Use shared memory to store persistent buffers
   if (rparams.shared_mem_persistent_buffer) {
     const auto& persistent_buffers =
@@ -1399,7 +1476,9 @@ void schedulePersistentKernel(
       reduction_tvs,
       cached_inputs,
       cached_outputs,
-      dummy_outputs);
+      dummy_outputs,
+      /*pipeline_serial_loops=*/
+      !rparams.compute_persistent_buffer_with_first_consumer);
 
   if (rparams.compute_persistent_buffer_with_first_consumer) {
     NVF_ERROR(
@@ -10,9 +10,11 @@
 #include <exceptions.h>
 #include <executor_params.h>
 #include <ir/all_nodes.h>
+#include <scheduler/heuristic_plugin_api.h>
 #include <scheduler/heuristic_types.h>
 #include <scheduler/reduction_utils.h>
 #include <scheduler/utils.h>
+#include <visibility.h>
 #include <cmath>
 #include <optional>
 #include <ostream>
@@ -153,11 +155,15 @@ struct GridOuterNormalizationParams {
   int64_t unswitch_factor = -1;
 };
 
+//! If reread_persistent_buffers is true, the persistent buffers are read
+//! again from global memory after the grid reduction, so they don't limit the
+//! configurations to the register space.
 std::optional<GridOuterNormalizationParams> getGridOuterNormalizationParams(
     int64_t total_reduction_numel,
     int64_t total_iteration_numel,
     int64_t vectorize_factor,
-    int64_t persistent_buffer_size);
+    int64_t persistent_buffer_size,
+    bool reread_persistent_buffers = false);
 
 //! check iter type of each domain in inner and outer reduction tvs
 //! inner reduction must be [I,I,...R,R]
@@ -253,6 +259,15 @@ PersistentKernelProperties getPersistentKernelProperties(
     HeuristicSummary* data_cache,
     ScheduleHeuristic heuristic);
 
+// Lets the heuristic plugin override rparams of a persistent kernel with the
+// given properties. See heuristic_plugin::updateReductionParams.
+void updatePersistentParamsWithPlugin(
+    Fusion* fusion,
+    SchedulerRuntimeInfo& runtime_info,
+    const PersistentKernelProperties& prop,
+    heuristic_plugin::ProblemDescription::Kernel kernel,
+    ReductionParams& rparams);
+
 // Verify the presence of a reduction TensorView connected to a Fusion input
 void checkReductionTvForScheduling(Fusion* fusion, TensorView* ref_red_tv);
 
@@ -307,6 +322,17 @@ int64_t getMaxRegOrSharedMemorySizeForPersistentBuffer(
     SchedulerRuntimeInfo& runtime_info,
     const std::vector<TensorView*>& persistent_buffers);
 
+// Returns true if EnableOption::L2AwarePersistence is set and a non-persistent
+// two-pass schedule is expected to beat a persistent one. That is the case
+// when a row of the persistent buffers takes more than half of the registers
+// or shared memory available to a block, so at most one row is in flight per
+// SM, while the persistent buffers of all rows fit in half of the L2 cache, so
+// the second pass re-reads them from L2 instead of DRAM.
+NVF_API bool preferL2ResidentTwoPass(
+    int64_t persistent_buffer_size,
+    int64_t available_persistent_buffer_size,
+    int64_t total_iteration_numel);
+
 // Returns true if persistent buffers are projected to inputs, meaning the
 // inputs are cached instead of the persistent buffers. The decision of
 // projection is primarily based on the required sizes of the two cases --
@@ -10,8 +10,10 @@
 #include <debug.h>
 #include <inlining.h>
 #include <instrumentation.h>
+#include <options.h>
 #include <scheduler/cache_policy_refiner.h>
 #include <scheduler/debug_utils.h>
+#include <scheduler/heuristic_plugin.h>
 #include <scheduler/mark_aliases.h>
 #include <scheduler/pointwise.h>
 #include <scheduler/reduction_utils.h>
@@ -148,6 +150,196 @@ class DomainMap : public pointwise_utils::DomainMap {
   }
 };
 
+// TMA supports tensors of at most 5 dimensions and boxes of at most 256
+// elements in each dimension
+constexpr int64_t kTmaMaxDims = 5;
+constexpr int64_t kTmaMaxBoxSize = 256;
+// The innermost dimension of a box must have a multiple of 16 bytes
+constexpr int64_t kTmaMinTileInner = 16;
+constexpr int64_t kTmaTileElems = 4096;
+
+// Returns the fusion inputs that the TMA mode loads with TMA. These are the
+// inputs with a data type supported by TMA, no allocation domain and the same
+// dimensions as the reference, exactly mapped in the same order, all
+// contiguous.
+std::vector<TensorView*> getTmaLoadInputs(
+    Fusion* fusion,
+    const ComputeAtMap& ca_map,
+    TensorView* reference_tv) {
+  const auto ref_root =
+      TensorDomain::noReductions(reference_tv->getMaybeRFactorDomain());
+  if (ref_root.empty() || (int64_t)ref_root.size() > kTmaMaxDims) {
+    return {};
+  }
+
+  std::vector<TensorView*> tma_inputs;
+  for (auto tv : ir_utils::filterByType<TensorView>(fusion->inputs())) {
+    // Same as the inputs that are not cached by scheduler_utils::cacheInputs
+    if (tv->uses().empty() || ir_utils::isTorchGatherLookupTv(tv) ||
+        ir_utils::isIndexSelectLookupTv(tv) ||
+        ir_utils::isTvUsedByOpsOfType<SliceOp, SelectOp, PadOp>(tv)) {
+      continue;
+    }
+    const DataType dtype = tv->dtype();
+    if (tv->hasAllocation() ||
+        (dtype != DataType::Double && dtype != DataType::Float &&
+         dtype != DataType::Half && dtype != DataType::BFloat16 &&
+         dtype != DataType::Int && dtype != DataType::Int32)) {
+      continue;
+    }
+    const auto& root = tv->getMaybeRFactorDomain();
+    if (root.size() != ref_root.size()) {
+      continue;
+    }
+    bool is_tile_of_reference = true;
+    for (auto i : c10::irange(root.size())) {
+      if (root[i]->isBroadcast() ||
+          !tv->getContiguity().at(i).value_or(false) ||
+          !ca_map.areMapped(root[i], ref_root[i], IdMappingMode::EXACT)) {
+        is_tile_of_reference = false;
+        break;
+      }
+    }
+    if (is_tile_of_reference) {
+      tma_inputs.push_back(tv);
+    }
+  }
+  return tma_inputs;
+}
+
+// Returns the parameters of the TMA mode, or nullptr if the device or one of
+// the TMA inputs doesn't support it. The tile is as large as the innermost
+// dimensions allow up to kTmaTileElems elements, but shrinks to give every SM
+// a block and to fit the TMA inputs in shared memory.
+std::shared_ptr<PointwiseParams> getTmaLoadHeuristics(
+    const std::vector<TensorView*>& tma_inputs,
+    const std::vector<int64_t>& elem_counts,
+    int64_t n_elems,
+    int64_t vectorize_factor,
+    SchedulerRuntimeInfo& runtime_info) {
+  const auto dev_prop = at::cuda::getCurrentDeviceProperties();
+  if (dev_prop->major < 9) {
+    return nullptr;
+  }
+
+  const auto index_type = runtime_info.getIndexType();
+  const int64_t ndims = (int64_t)elem_counts.size();
+  int64_t smem_bytes_per_elem = 0;
+  for (auto tv : tma_inputs) {
+    const int64_t dtype_size = (int64_t)dataTypeSize(tv->dtype(), index_type);
+    // The global address and strides of TMA tensors must be multiples of 16
+    // bytes
+    if ((int64_t)runtime_info.getAlignmentSize(tv) < 16 ||
+        (ndims > 1 && elem_counts.back() * dtype_size % 16 != 0)) {
+      return nullptr;
+    }
+    smem_bytes_per_elem += dtype_size;
+  }
+
+  int64_t tile_inner = std::clamp(
+      scheduler_utils::roundUpPow2(elem_counts.back()),
+      kTmaMinTileInner,
+      kTmaMaxBoxSize);
+  int64_t tile_outer = 1;
+  if (ndims > 1) {
+    tile_outer = std::min(
+        {kTmaMaxBoxSize,
+         std::max(kTmaTileElems / tile_inner, (int64_t)1),
+         scheduler_utils::roundUpPow2(elem_counts.at(ndims - 2))});
+  }
+  while (tile_outer > 1 &&
+         ceilDiv(n_elems, tile_outer * tile_inner) <
+             dev_prop->multiProcessorCount) {
+    tile_outer /= 2;
+  }
+  while (tile_outer * tile_inner * smem_bytes_per_elem >
+         (int64_t)dev_prop->sharedMemPerBlock) {
+    if (tile_outer > 1) {
+      tile_outer /= 2;
+    } else if (tile_inner > kTmaMinTileInner) {
+      tile_inner /= 2;
+    } else {
+      return nullptr;
+    }
+  }
+
+  auto params =
+      std::make_shared<PointwiseParams>("Pointwise heuristics", index_type);
+  params->use_tma_load = true;
+  params->tma_tile_outer = tile_outer;
+  params->tma_tile_inner = tile_inner;
+  params->vectorize = vectorize_factor > 1;
+  params->unroll_factor = vectorize_factor;
+  params->lparams.bind(
+      std::min(kThreadX, ceilDiv(tile_outer * tile_inner, vectorize_factor)),
+      ParallelType::TIDx);
+  return params;
+}
+
+// Returns if an input is only used as the indices of index_select ops along
+// an outer dimension of their lookup tables. With VectorizedRowGather, it is
+// loaded once per gathered row and doesn't limit the vectorization factor.
+bool isRowGatherIndicesTv(TensorView* tv) {
+  return isOptionEnabled(EnableOption::VectorizedRowGather) &&
+      !tv->uses().empty() &&
+      std::all_of(tv->uses().begin(), tv->uses().end(), [tv](Expr* use) {
+           auto index_select = dynamic_cast<IndexSelectOp*>(use);
+           if (index_select == nullptr || index_select->indexTv() != tv ||
+               index_select->lookupTv() == tv) {
+             return false;
+           }
+           const auto lookup_ndims = TensorDomain::noReductions(
+                                         index_select->lookupTv()
+                                             ->getMaybeRFactorDomain())
+                                         .size();
+           return index_select->dim() + 1 < (int64_t)lookup_ndims;
+         });
+}
+
+// Returns the vectorizable inputs whose alignment is smaller than the
+// vectorization factor possible for the other inputs and outputs. Those are
+// the inputs to load without vectorization, so that the factor isn't
+// limited by them.
+std::unordered_set<TensorView*> getMisalignedInputs(
+    SchedulerRuntimeInfo& runtime_info,
+    TensorView* largest_out,
+    HeuristicSummary* data_cache,
+    int64_t break_point,
+    const std::unordered_map<int64_t, int64_t>& rfactor_reorder_map,
+    const std::vector<TensorView*>& vectorizable_inputs_outputs,
+    int64_t max_unroll_factor,
+    int64_t max_vectorize_bytes) {
+  std::unordered_set<TensorView*> inputs;
+  for (auto tv : vectorizable_inputs_outputs) {
+    if (tv->isFusionInput()) {
+      inputs.insert(tv);
+    }
+  }
+  // At least one tensor must remain vectorized
+  if (inputs.empty() || inputs.size() == vectorizable_inputs_outputs.size()) {
+    return {};
+  }
+  const int64_t max_factor = std::min(
+      max_unroll_factor,
+      vectorize_helper::getVectorizationFactor(
+          runtime_info,
+          largest_out,
+          data_cache,
+          break_point,
+          rfactor_reorder_map,
+          inputs,
+          max_vectorize_bytes));
+  std::unordered_set<TensorView*> misaligned_inputs;
+  for (auto tv : inputs) {
+    const auto dtype_size =
+        (int64_t)dataTypeSize(tv->dtype(), runtime_info.getIndexType());
+    if ((int64_t)runtime_info.getAlignmentSize(tv) < max_factor * dtype_size) {
+      misaligned_inputs.insert(tv);
+    }
+  }
+  return misaligned_inputs;
+}
+
 } // namespace
 
 std::shared_ptr<PointwiseParams> getPointwiseHeuristics(
@@ -197,6 +389,9 @@ std::shared_ptr<PointwiseParams> getPointwiseHeuristics(
   int64_t max_input_dtype_size = 2;
 
   for (auto inp : in_tvs) {
+    if (isRowGatherIndicesTv(inp)) {
+      continue;
+    }
     max_input_dtype_size = std::max(
         max_input_dtype_size,
         (int64_t)dataTypeSize(inp->getDataType().value(), index_type));
@@ -276,11 +471,12 @@ std::shared_ptr<PointwiseParams> getPointwiseHeuristics(
                     largest_out, true, true));
           });
 
-  constexpr int64_t kSixteen = 16; // clang tidy
+  // 16 bytes, or 32 bytes on Blackwell
+  const int64_t max_vectorize_bytes = vectorize_helper::maxVectorizationBytes();
 
   auto max_unroll_factor = ceilDiv(
       // Available unrolling based on size of data type
-      (int64_t)kSixteen / max_input_dtype_size,
+      max_vectorize_bytes / max_input_dtype_size,
       // Reduce max unrolling factor if we have many inputs/outputs to unroll
       // as it could start consuming a lot of registers.
       std::max(
@@ -333,8 +529,21 @@ std::shared_ptr<PointwiseParams> getPointwiseHeuristics(
             scheduler_utils::getBroadcastMultiples(largest_out, index_type));
       });
 
-  auto& view_disjoint_sets = broadcast_info.get().view_disjoint_set_ids;
-  auto& broadcast_byte_multiples = broadcast_info.get().broadcast_multiples;
+  // The cached multiples only know about compile-time broadcasts. Inputs that
+  // are expanded at runtime are read once per unique value too, so recompute
+  // the multiples treating their stride-0 dimensions as broadcast.
+  std::optional<scheduler_utils::BroadcastMultipleInformation>
+      runtime_broadcast_info;
+  if (!runtime_info.getStrideZeroInputIds().empty()) {
+    runtime_broadcast_info = scheduler_utils::getBroadcastMultiples(
+        largest_out, index_type, {}, runtime_info.getStrideZeroInputIds());
+  }
+  const auto& broadcast_multiple_info = runtime_broadcast_info.has_value()
+      ? runtime_broadcast_info.value()
+      : broadcast_info.get();
+
+  auto& view_disjoint_sets = broadcast_multiple_info.view_disjoint_set_ids;
+  auto& broadcast_byte_multiples = broadcast_multiple_info.broadcast_multiples;
 
   NVF_ERROR(broadcast_byte_multiples.size() == ref_root.size());
 
@@ -451,14 +660,52 @@ std::shared_ptr<PointwiseParams> getPointwiseHeuristics(
   // Don't try to vectorize if it's not recommended
   params->unroll_factor = 1;
 
-  const auto vectorize_factor = std::min(
+  auto vectorize_factor = std::min(
       max_unroll_factor,
       vectorize_helper::getVectorizationFactor(
           runtime_info,
           largest_out,
           data_cache,
           break_point,
-          rfactor_reorder_map));
+          rfactor_reorder_map,
+          /*unvectorized_inputs=*/{},
+          max_vectorize_bytes));
+
+  // Inputs that are not aligned to the vectorization factor, e.g. sliced
+  // views, are loaded without vectorization instead of limiting the factor of
+  // the other tensors
+  if (isOptionEnabled(EnableOption::PartialVectorization)) {
+    auto misaligned_inputs = getMisalignedInputs(
+        runtime_info,
+        largest_out,
+        data_cache,
+        break_point,
+        rfactor_reorder_map,
+        vectorizable_inputs_outputs_entry.get(),
+        max_unroll_factor,
+        max_vectorize_bytes);
+    const int64_t partial_vectorize_factor = misaligned_inputs.empty()
+        ? vectorize_factor
+        : std::min(
+              max_unroll_factor,
+              vectorize_helper::getVectorizationFactor(
+                  runtime_info,
+                  largest_out,
+                  data_cache,
+                  break_point,
+                  rfactor_reorder_map,
+                  misaligned_inputs,
+                  max_vectorize_bytes));
+    if (partial_vectorize_factor > vectorize_factor) {
+      vectorize_factor = partial_vectorize_factor;
+      for (auto i : c10::irange(fusion->inputs().size())) {
+        auto tv = dynamic_cast<TensorView*>(fusion->inputs().at(i));
+        if (tv != nullptr && misaligned_inputs.count(tv) > 0) {
+          params->unvectorized_inputs.push_back((int64_t)i);
+        }
+      }
+    }
+  }
 
   if (vectorize_factor == 1) {
     params->vectorize = false;
@@ -484,6 +731,46 @@ std::shared_ptr<PointwiseParams> getPointwiseHeuristics(
     params->split_grid_y_dim = true;
   }
 
+  if (isOptionEnabled(EnableOption::TmaPointwise) &&
+      rfactor_reorder_map.empty() && ir_utils::getViewOps(fusion).empty()) {
+    auto tma_inputs = getTmaLoadInputs(
+        fusion, domain_map.getComputeAtMap(), largest_out);
+    if (!tma_inputs.empty()) {
+      // Tiles are only vectorized along the innermost dimension
+      const int64_t tma_vectorize_factor = std::min(
+          max_unroll_factor,
+          vectorize_helper::getVectorizationFactor(
+              runtime_info,
+              largest_out,
+              data_cache,
+              (int64_t)ref_root.size() - 1));
+      if (auto tma_params = getTmaLoadHeuristics(
+              tma_inputs,
+              elem_counts,
+              n_elems,
+              tma_vectorize_factor,
+              runtime_info)) {
+        if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
+          debug() << tma_params->toString() << std::endl;
+        }
+        return tma_params;
+      }
+    }
+  }
+
+  if (heuristic_plugin::hasPlugin(
+          heuristic_plugin::ProblemDescription::Kernel::PointWise)) {
+    if (auto problem = heuristic_plugin::makeProblemDescription(
+            heuristic_plugin::ProblemDescription::Kernel::PointWise,
+            largest_out,
+            runtime_info)) {
+      problem->max_input_dtype_size = (uint8_t)max_input_dtype_size;
+      problem->n_tensor_inputs = (uint16_t)in_tvs.size();
+      problem->max_vectorization_factor = (uint8_t)vectorize_factor;
+      heuristic_plugin::updatePointwiseParams(*params, *problem);
+    }
+  }
+
   if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
     debug() << "\n===== Pointwise Stats ========\n"
             << "num_elems: " << n_elems << "\n"
@@ -532,9 +819,143 @@ bool hasReferenceTensorView(Fusion* fusion) {
   return getReferenceTensorView(fusion) != nullptr;
 }
 
+namespace {
+
+// Schedules the TMA mode. Every block loads one tile of each TMA input into
+// shared memory with a bulk tensor load, and its threads compute the tile from
+// shared memory once the mbarrier of the load completes. The other inputs and
+// the outputs are accessed with vectorized loads and stores as usual.
+void scheduleTmaPointwise(Fusion* fusion, const PointwiseParams& params) {
+  FusionGuard fg(fusion);
+
+  scheduler_utils::clearMemorySpace(fusion);
+
+  std::vector<TensorView*> tma_inputs;
+  {
+    TensorView* reference_tv = getReferenceTensorView(fusion);
+    NVF_ERROR(
+        reference_tv != nullptr,
+        "Could not find a fully broadcasted output to reference schedule on.");
+    ComputeAtMap ca_map(fusion);
+    tma_inputs = getTmaLoadInputs(fusion, ca_map, reference_tv);
+  }
+  NVF_ERROR(
+      !tma_inputs.empty(),
+      "TMA pointwise schedule requested without inputs to load with TMA.");
+  std::unordered_set<TensorView*> tma_tvs(tma_inputs.begin(), tma_inputs.end());
+
+  auto cached_inputs = scheduler_utils::cacheInputs(fusion, true);
+  scheduler_utils::cacheAndForkOutputs(fusion, true);
+
+  std::vector<TensorView*> smem_tvs;
+  for (auto tv : tma_inputs) {
+    // cacheInputs made the cache the only use of the input
+    auto smem_tv = tv->uses().at(0)->output(0)->as<TensorView>();
+    smem_tv->setMemoryType(MemoryType::Shared);
+    smem_tv->definition()->as<LoadStoreOp>()->setOpType(
+        LoadStoreOpType::CpAsyncBulkTensorTile);
+    smem_tvs.push_back(smem_tv);
+    tma_tvs.insert(smem_tv);
+  }
+
+  scheduler_utils::prepareForMemoryTypePromotion(fusion);
+
+  refineCachePolicy(fusion);
+
+  // Caching the outputs replaced the domains of the reference
+  TensorView* reference_tv = getReferenceTensorView(fusion);
+  const int64_t num_tile_dims = reference_tv->nDims() > 1 ? 2 : 1;
+
+  // [..., I0, I1] -> [..., I0/tile_outer, I1/tile_inner, tile_outer,
+  // tile_inner]
+  reference_tv->split(-1, params.tma_tile_inner);
+  if (num_tile_dims > 1) {
+    reference_tv->split(-3, params.tma_tile_outer);
+    reference_tv->reorder({{-3, -2}});
+  }
+  // [BIDx, tile_outer, tile_inner]
+  reference_tv->flatten(0, reference_tv->nDims() - num_tile_dims - 1);
+  reference_tv->axis(0)->parallelize(ParallelType::BIDx);
+
+  TransformPropagator propagator(reference_tv);
+  MaxRootDomainInfoSpanningTree entire_dag(reference_tv);
+  entire_dag.traverse(&propagator);
+  scheduler_utils::parallelizeAllLike(reference_tv, smem_tvs);
+
+  for (auto smem_tv : smem_tvs) {
+    smem_tv->setAllocationDomain(smem_tv->getLeafDomain(), true);
+    for (auto i : c10::irange(1, smem_tv->nDims())) {
+      smem_tv->axis(i)->parallelize(ParallelType::Bulk);
+    }
+  }
+
+  // The rest of the fusion computes the tile with all the threads of the
+  // block:
+  // [BIDx, tile_outer * tile_inner / (TIDx * vectorize), TIDx, vectorize]
+  reference_tv->flatten(1);
+  reference_tv->split(1, params.unroll_factor);
+  reference_tv->split(1, NamedScalar::getParallelDim(ParallelType::TIDx));
+  reference_tv->axis(2)->parallelize(ParallelType::TIDx);
+
+  std::vector<TensorView*> compute_tvs;
+  for (auto tv : ir_utils::allTvs(fusion)) {
+    if (tma_tvs.count(tv) == 0) {
+      compute_tvs.push_back(tv);
+    }
+  }
+  SetSelector selector({compute_tvs.begin(), compute_tvs.end()});
+  MaxRootDomainInfoSpanningTree compute_dag(reference_tv, &selector);
+  TransformPropagator compute_propagator(reference_tv);
+  compute_dag.traverse(&compute_propagator);
+  scheduler_utils::parallelizeAllLike(reference_tv, compute_tvs);
+
+  if (params.vectorize) {
+    std::vector<TensorView*> vectorized_tvs;
+    bool should_vectorize_reference_tv = false;
+    for (auto tv : scheduler_utils::getInputsOutputsWithInnerDim(
+             reference_tv, true, true)) {
+      if (tv == reference_tv) {
+        should_vectorize_reference_tv = true;
+      }
+      if (!tv->isFusionInput()) {
+        vectorized_tvs.emplace_back(tv);
+        continue;
+      }
+      // Shared memory tiles are loaded with TMA
+      if (tma_tvs.count(tv) > 0) {
+        continue;
+      }
+      auto consumer_tvs = ir_utils::consumerTvsOf(tv);
+      vectorized_tvs.insert(
+          vectorized_tvs.end(), consumer_tvs.begin(), consumer_tvs.end());
+    }
+    if (!vectorized_tvs.empty()) {
+      reference_tv->axis(3)->parallelize(ParallelType::Vectorize);
+      scheduler_utils::parallelizeAllLike(
+          reference_tv, vectorized_tvs, {ParallelType::Vectorize});
+      if (!should_vectorize_reference_tv) {
+        reference_tv->axis(3)->parallelize(ParallelType::Serial);
+      }
+    }
+  }
+
+  inlineMost();
+
+  scheduler_utils::promoteProducerMemoryTypes(fusion, cached_inputs);
+
+  markAliases(fusion);
+}
+
+} // namespace
+
 // TODO: Inline intermediate operations (avoid inlining unrolled/vectorized
 // input/output caches)
 void schedulePointwise(Fusion* fusion, const PointwiseParams& params) {
+  if (params.use_tma_load) {
+    scheduleTmaPointwise(fusion, params);
+    return;
+  }
+
   FusionGuard fg(fusion);
 
   // Make sure we don't have global memory set on intermediate tensors from
@@ -871,6 +1292,13 @@ void schedulePointwise(Fusion* fusion, const PointwiseParams& params) {
         vectorized_tvs.emplace_back(tv);
         continue;
       }
+      // Misaligned inputs are loaded without vectorization
+      if (std::any_of(
+              params.unvectorized_inputs.begin(),
+              params.unvectorized_inputs.end(),
+              [&](int64_t i) { return fusion->inputs().at(i) == tv; })) {
+        continue;
+      }
       // move inputs to consumers of inputs
       auto consumer_tvs = ir_utils::consumerTvsOf(tv);
       vectorized_tvs.insert(
@@ -908,7 +1336,24 @@ void schedulePointwise(Fusion* fusion, const PointwiseParams& params) {
     auto output = entry.second;
     inner_most_tensors.erase(output);
   }
-  inlineMost(inner_most_tensors);
+  if (isOptionEnabled(EnableOption::CostAwareInlining)) {
+    // Keep the registers of the inlined buffers within the budget of half
+    // occupancy
+    std::vector<TensorView*> tvs_to_inline;
+    std::copy_if(
+        all_tvs.begin(),
+        all_tvs.end(),
+        std::back_inserter(tvs_to_inline),
+        [&](TensorView* tv) { return inner_most_tensors.count(tv) != 0; });
+    const int64_t max_threads_per_sm =
+        at::cuda::getCurrentDeviceProperties()->maxThreadsPerMultiProcessor;
+    inlineMostCostAware(
+        tvs_to_inline,
+        getRegPerThreadGivenThreadsPerSM(max_threads_per_sm / 2) -
+            scheduler_utils::register_overhead);
+  } else {
+    inlineMost(inner_most_tensors);
+  }
 
   scheduler_utils::promoteProducerMemoryTypes(fusion, cached_inputs);
 
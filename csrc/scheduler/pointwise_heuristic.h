@@ -10,6 +10,7 @@
 #include <scheduler/heuristic.h>
 
 #include <sstream>
+#include <vector>
 
 namespace nvfuser {
 
@@ -43,6 +44,20 @@ class PointwiseParams : public HeuristicParams {
   // Unroll or vectorization factor
   int64_t unroll_factor = 1;
 
+  // Positions of the fusion inputs that are not aligned to the vectorization
+  // factor and are loaded without vectorization, while the other inputs and
+  // the outputs are vectorized
+  std::vector<int64_t> unvectorized_inputs;
+
+  // Load the tiles of full and contiguous inputs into shared memory with TMA
+  // on Hopper. The reference is tiled by tma_tile_outer and tma_tile_inner
+  // along its two innermost dimensions and each block computes one tile with
+  // the unroll factor as the vectorization factor. The break point, block
+  // split and grid y dim parameters are not used in this mode.
+  bool use_tma_load = false;
+  int64_t tma_tile_outer = 1;
+  int64_t tma_tile_inner = 1;
+
   using HeuristicParams::HeuristicParams;
 
   // Warning: Does not check launch parameters!
@@ -58,7 +73,11 @@ class PointwiseParams : public HeuristicParams {
         other.split_block == split_block &&
         other.split_grid_y_dim == split_grid_y_dim &&
         other.unroll_factor == unroll_factor &&
-        other.flip_grid_binding == flip_grid_binding;
+        other.unvectorized_inputs == unvectorized_inputs &&
+        other.flip_grid_binding == flip_grid_binding &&
+        other.use_tma_load == use_tma_load &&
+        other.tma_tile_outer == tma_tile_outer &&
+        other.tma_tile_inner == tma_tile_inner;
     return attr_equal;
   }
 
@@ -81,6 +100,13 @@ class PointwiseParams : public HeuristicParams {
     if (unroll_factor > 1) {
       if (vectorize) {
         ss << "Vectorize, Factor: " << unroll_factor << "\n";
+        if (!unvectorized_inputs.empty()) {
+          ss << "  Unvectorized inputs:";
+          for (auto i : unvectorized_inputs) {
+            ss << " " << i;
+          }
+          ss << "\n";
+        }
       } else {
         ss << "Unroll, Factor: " << unroll_factor << "\n";
       }
@@ -88,6 +114,10 @@ class PointwiseParams : public HeuristicParams {
     if (flip_grid_binding) {
       ss << "Flip BIDx/BIDy bindings\n";
     }
+    if (use_tma_load) {
+      ss << "TMA load, Tile: " << tma_tile_outer << " x " << tma_tile_inner
+         << "\n";
+    }
     ss << "====================================\n";
     return ss.str();
   }
@@ -99,7 +129,13 @@ class PointwiseParams : public HeuristicParams {
         static_cast<size_t>(split_block) << 5 ^
         static_cast<size_t>(split_grid_y_dim) << 6 ^
         static_cast<size_t>(unroll_factor) << 9 ^
-        static_cast<size_t>(flip_grid_binding) << 10;
+        static_cast<size_t>(flip_grid_binding) << 10 ^
+        static_cast<size_t>(use_tma_load) << 11 ^
+        static_cast<size_t>(tma_tile_outer) << 12 ^
+        static_cast<size_t>(tma_tile_inner) << 21;
+    for (auto i : unvectorized_inputs) {
+      attr_hash ^= static_cast<size_t>(1) << (30 + i % 32);
+    }
     return attr_hash;
   }
 
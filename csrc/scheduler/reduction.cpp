@@ -9,7 +9,9 @@
 #include <debug.h>
 #include <instrumentation.h>
 #include <multidevice/utils.h>
+#include <options.h>
 #include <scheduler/debug_utils.h>
+#include <scheduler/heuristic_plugin.h>
 #include <scheduler/mark_aliases.h>
 #include <scheduler/reduction.h>
 #include <scheduler/reduction_utils.h>
@@ -62,6 +64,203 @@ void reduceProductTo(int64_t& z, int64_t& y, int64_t& x, const int64_t max) {
   }
 }
 
+// Returns the number of blocks of the thread block clusters that reduce the
+// gdimx blocks of a cross-grid inner reduction through distributed shared
+// memory, or 1 if clusters are not used. A whole reduction segment goes into
+// a single cluster when it fits, otherwise the largest cluster that divides
+// the segment is used and only the clusters reduce through global memory.
+int64_t gridReductionClusterSize(const int64_t gdimx) {
+  if (!isOptionEnabled(EnableOption::ClusterReduction) ||
+      at::cuda::getCurrentDeviceProperties()->major < 9) {
+    return 1;
+  }
+  // Larger clusters are not portable
+  constexpr int64_t max_cluster_size = 8;
+  for (int64_t cluster_size = std::min(gdimx, max_cluster_size);
+       cluster_size > 1;
+       --cluster_size) {
+    if (gdimx % cluster_size == 0) {
+      return cluster_size;
+    }
+  }
+  return 1;
+}
+
+// Returns the number of blocks to split the reduction of a skinny problem
+// across, i.e., one whose iter_blocks blocks of the iteration domain don't
+// fill a wave of the device. The blocks, iter_blocks x (returned value), fill
+// full waves of resident blocks, and each of them reduces an even share of
+// the reduction_tiles of its outputs before the grid reduction combines the
+// partial results. Returns grid_dim when the problem is not skinny or
+// NVFUSER_ENABLE=split_k_reduction is not set.
+int64_t splitKGridDim(
+    const int64_t iter_blocks,
+    const int64_t reduction_tiles,
+    const int64_t threads_per_block,
+    const int64_t grid_dim) {
+  const auto* prop = at::cuda::getCurrentDeviceProperties();
+  const int64_t device_multiprocessor_count = prop->multiProcessorCount;
+  if (!isOptionEnabled(EnableOption::SplitKReduction) ||
+      iter_blocks >= device_multiprocessor_count) {
+    return grid_dim;
+  }
+  const int64_t blocks_per_sm = std::max(
+      (int64_t)prop->maxThreadsPerMultiProcessor / threads_per_block,
+      (int64_t)1);
+  const int64_t wave = device_multiprocessor_count * blocks_per_sm;
+
+  // Keep a few tiles per block so that the grid reduction doesn't dominate
+  constexpr int64_t min_tiles_per_block = 4;
+  const int64_t max_grid_dim =
+      std::max(reduction_tiles / min_tiles_per_block, (int64_t)1);
+
+  // Round the current number of waves to full waves
+  const int64_t waves =
+      std::max((iter_blocks * grid_dim + wave / 2) / wave, (int64_t)1);
+  int64_t split_grid_dim = std::min(
+      std::max(waves * wave / iter_blocks, (int64_t)1), max_grid_dim);
+
+  // Even shares of the tiles, without blocks that are left with nothing
+  const int64_t tiles_per_block = ceilDiv(reduction_tiles, split_grid_dim);
+  return ceilDiv(reduction_tiles, tiles_per_block);
+}
+
+// Returns true if the grid reductions of rparams can combine their blocks
+// with atomic additions, i.e., NVFUSER_ENABLE=atomic_grid_reduction is set
+// and every output of the fusion is an unused float or double sum reduction
+// that the scheduler reduces across the grid.
+bool canUseAtomicGridReduction(
+    Fusion* fusion,
+    const std::vector<TensorView*>& reduction_tvs,
+    const ReductionParams& rparams) {
+  if (!isOptionEnabled(EnableOption::AtomicGridReduction) ||
+      !(rparams.cross_grid_inner_reduction ||
+        rparams.cross_grid_outer_reduction) ||
+      rparams.persistent_kernel) {
+    return false;
+  }
+  // The outputs are not cached, so they all have to be the reductions
+  if (reduction_tvs.size() != fusion->outputs().size()) {
+    return false;
+  }
+  return std::all_of(
+      reduction_tvs.begin(), reduction_tvs.end(), [](TensorView* tv) {
+        auto rop = dynamic_cast<ReductionOp*>(tv->definition());
+        return rop != nullptr &&
+            rop->getReductionOpType() == BinaryOpType::Add &&
+            tv->isFusionOutput() && tv->uses().empty() &&
+            (tv->dtype() == DataType::Float ||
+             tv->dtype() == DataType::Double);
+      });
+}
+
+// Returns true if the grid reduction of rparams can combine its blocks one
+// after another in the output, i.e., NVFUSER_ENABLE=serial_grid_reduction is
+// set and the only output of the fusion is an unused outer reduction that the
+// scheduler reduces across the grid. The output doubles as the work buffer of
+// the serial grid reduction, so it is not cached.
+bool canUseSerialGridReduction(
+    Fusion* fusion,
+    const std::vector<TensorView*>& reduction_tvs,
+    const ReductionParams& rparams) {
+  if (!isOptionEnabled(EnableOption::SerialGridReduction) ||
+      rparams.fastest_dim || !rparams.cross_grid_inner_reduction ||
+      rparams.cross_grid_outer_reduction || rparams.schedule_3D ||
+      rparams.persistent_kernel || rparams.atomic_grid_reduction) {
+    return false;
+  }
+  if (reduction_tvs.size() != 1 || fusion->outputs().size() != 1) {
+    return false;
+  }
+  TensorView* tv = reduction_tvs.front();
+  return tv->definition()->isA<ReductionOp>() && tv->isFusionOutput() &&
+      tv->uses().empty();
+}
+
+// Heuristic of NVFUSER_ENABLE=reproducible_reduction, whose reduction tree
+// only depends on the size of the reduction, so that the results are bitwise
+// identical whatever the iteration domain, the device or the alignment of the
+// inputs are. The reduction domain is split into fixed-size chunks of
+// kReductionThreads x kReductionUnroll elements. Each thread serially reduces
+// one element of every unrolled step of a chunk, the threads of a chunk are
+// combined by the block reduction, and the chunks are reduced across the
+// grid, one per block. The reduction is never vectorized, as vectorization
+// depends on the alignment and changes the order of the serial reduction.
+// The iteration domain still uses the rest of the block and the grid.
+std::shared_ptr<ReductionParams> reproducibleReductionHeuristic(
+    const int64_t total_reduction_numel,
+    const int64_t total_iteration_numel,
+    const bool fastest_dim_reduction,
+    const size_t vectorize_factor) {
+  // Threads of the inner reductions, or of the outer reductions whose
+  // iteration domain uses TIDx
+  const int64_t reduction_threads = fastest_dim_reduction ? 128 : 16;
+  constexpr int64_t reduction_unroll = 4;
+  const int64_t num_chunks = ceilDiv(
+      total_reduction_numel, reduction_threads * reduction_unroll);
+
+  auto rparams = std::make_shared<ReductionParams>();
+  rparams->tag = "Reproducible reduction heuristic";
+  rparams->fastest_dim = fastest_dim_reduction;
+  rparams->cross_block_inner_reduction = true;
+  rparams->unroll_factor_inner_reduction = reduction_unroll;
+  rparams->cross_grid_inner_reduction = num_chunks > 1;
+  // One chunk per block, independent of the size of the grid
+  rparams->split_grid_dim_inner_reduction = false;
+  rparams->grid_dim_inner_reduction = ParallelType::BIDx;
+  rparams->static_bdimx = true;
+  rparams->static_bdimy = true;
+
+  int64_t gdimy = LaunchParams::UNINITIALIZED_VAL;
+  int64_t bdimx = reduction_threads;
+  int64_t bdimy = LaunchParams::UNINITIALIZED_VAL;
+  int64_t iter_blocks = total_iteration_numel;
+  if (fastest_dim_reduction) {
+    rparams->block_dim_inner_reduction = ParallelType::TIDx;
+  } else {
+    // The iteration domain is innermost, so it is vectorized by TIDx
+    rparams->block_dim_inner_reduction = ParallelType::TIDy;
+    rparams->block_dim_iter_dom = ParallelType::TIDx;
+    rparams->multiple_reds_per_blk = true;
+    rparams->unroll_factor_iter_dom = (int64_t)vectorize_factor;
+    rparams->vectorize_iter_dom = vectorize_factor > 1;
+    bdimx = std::min(
+        ceilDiv(total_iteration_numel, (int64_t)vectorize_factor),
+        (int64_t)32);
+    bdimy = reduction_threads;
+    iter_blocks =
+        ceilDiv(total_iteration_numel, bdimx * (int64_t)vectorize_factor);
+  }
+
+  if (rparams->cross_grid_inner_reduction) {
+    rparams->flip_grid = !fastest_dim_reduction;
+    rparams->grid_dim_iter_dom = ParallelType::BIDy;
+    if (iter_blocks > scheduler_utils::y_grid_limit) {
+      rparams->split_grid_dim_iter_dom_outer = true;
+      gdimy = scheduler_utils::y_grid_limit;
+    }
+  } else {
+    rparams->grid_dim_iter_dom = ParallelType::BIDx;
+  }
+
+  rparams->lparams = LaunchParams(
+      LaunchParams::UNINITIALIZED_VAL,
+      gdimy,
+      LaunchParams::UNINITIALIZED_VAL,
+      bdimx,
+      bdimy,
+      LaunchParams::UNINITIALIZED_VAL);
+
+  if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
+    debug() << "\n===== Reproducible Reduction Stats ========\n"
+            << "total_reduction_numel: " << total_reduction_numel << "\n"
+            << "total_iteration_numel: " << total_iteration_numel << "\n"
+            << "num_chunks: " << num_chunks << std::endl;
+    debug() << rparams->toString() << std::endl;
+  }
+  return rparams;
+}
+
 std::shared_ptr<ReductionParams> innerReductionHeuristic(
     const int64_t total_reduction_numel,
     const int64_t total_iteration_numel,
@@ -367,6 +566,13 @@ std::shared_ptr<ReductionParams> innerReductionHeuristic(
     }
   }
 
+  if (grodim == 1) {
+    const int64_t inner_reduction_tiles = ceilDiv(
+        inner_most_dimension_numel, bdimx * inner_reduction_unroll_factor);
+    gridim = splitKGridDim(
+        godim, inner_reduction_tiles, bdimx * bdimy * bdimz, gridim);
+  }
+
   if (grodim > 1 || gridim > 1) {
     // Grid reductions do not support unrolling iteration dimension, revert if
     // set. Recalculate godim.
@@ -468,6 +674,10 @@ std::shared_ptr<ReductionParams> innerReductionHeuristic(
       bdimy > 1 ? bdimy : LaunchParams::UNINITIALIZED_VAL,
       bdimz > 1 ? bdimz : LaunchParams::UNINITIALIZED_VAL);
 
+  if (rparams->cross_grid_inner_reduction) {
+    rparams->cparams.cluster_dims[0] = gridReductionClusterSize(gdimx);
+  }
+
   if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
     debug() << "\n===== Reduction Stats ========\n"
             << "total_reduction_numel: "
@@ -766,6 +976,12 @@ std::shared_ptr<ReductionParams> outerReductionHeuristic(
     }
   }
 
+  grdim = splitKGridDim(
+      gidim,
+      ceilDiv(total_reduction_numel, bdimy * inner_reduction_unroll_factor),
+      bdimx * bdimy,
+      grdim);
+
   int64_t gdimx = LaunchParams::UNINITIALIZED_VAL;
   int64_t gdimy = LaunchParams::UNINITIALIZED_VAL;
 
@@ -1025,6 +1241,13 @@ std::shared_ptr<ReductionParams> reductionHeuristic(
     const int64_t n_tensor_inputs,
     const int64_t max_input_dtype_size,
     const size_t vectorize_factor) {
+  if (isOptionEnabled(EnableOption::ReproducibleReduction)) {
+    return reproducibleReductionHeuristic(
+        total_reduction_numel,
+        total_iteration_numel,
+        fastest_dim_reduction,
+        vectorize_factor);
+  }
   if (fastest_dim_reduction) {
     return innerReductionHeuristic(
         total_reduction_numel,
@@ -1143,6 +1366,38 @@ std::shared_ptr<ReductionParams> getReductionHeuristics(
       max_dtype_size,
       vectorize_factor);
   heuristic->cparams.index_type = runtime_info.getIndexType();
+
+  // Plugins, replayed parameters and atomics would change the reduction tree
+  if (isOptionEnabled(EnableOption::ReproducibleReduction)) {
+    return heuristic;
+  }
+
+  if (heuristic_plugin::hasPlugin(
+          heuristic_plugin::ProblemDescription::Kernel::Reduction)) {
+    if (auto problem = heuristic_plugin::makeProblemDescription(
+            heuristic_plugin::ProblemDescription::Kernel::Reduction,
+            reduction_tv,
+            runtime_info)) {
+      problem->max_input_dtype_size = (uint8_t)max_dtype_size;
+      problem->n_tensor_inputs = (uint16_t)n_tensor_inputs;
+      problem->max_vectorization_factor = (uint8_t)vectorize_factor;
+      problem->total_reduction_numel = properties.total_reduction_numel;
+      problem->total_iteration_numel = properties.total_iteration_numel;
+      problem->inner_most_dimension_numel =
+          properties.inner_most_dimension_numel;
+      problem->fastest_dim_reduction = properties.fastest_dim_reduction;
+      heuristic_plugin::updateReductionParams(*heuristic, *problem);
+    }
+  }
+
+  if (canUseAtomicGridReduction(fusion, reduction_tvs, *heuristic)) {
+    heuristic->atomic_grid_reduction = true;
+    // The blocks don't exchange partial results anymore
+    heuristic->cparams.cluster_dims = {1, 1, 1};
+  } else if (canUseSerialGridReduction(fusion, reduction_tvs, *heuristic)) {
+    heuristic->serial_grid_reduction = true;
+    heuristic->cparams.cluster_dims = {1, 1, 1};
+  }
   return heuristic;
 }
 
@@ -1156,8 +1411,12 @@ void scheduleReduction(Fusion* fusion, const ReductionParams& rparams) {
   // Cache inputs if unrolled
   auto cached_inputs = scheduler_utils::cacheInputs(fusion, unroll);
 
-  // Cache and fork outputs
-  auto cached_outputs = scheduler_utils::cacheAndForkOutputs(fusion, unroll);
+  // Cache and fork outputs. Atomic and serial grid reductions accumulate
+  // directly into the outputs, so they are not cached.
+  auto cached_outputs = scheduler_utils::cacheAndForkOutputs(
+      fusion,
+      unroll && !rparams.atomic_grid_reduction &&
+          !rparams.serial_grid_reduction);
 
   // Make sure we don't have global memory set on intermediate tensors from
   // fusion segmentation
@@ -1184,6 +1443,15 @@ void scheduleReduction(Fusion* fusion, const ReductionParams& rparams) {
         scheduler_utils::domainReorderAsRfactorMap(reduction_tv));
   }
 
+  // Sibling reductions combining their blocks in one grid reduction only
+  // synchronize the grid once. Iteration grouped outer reductions and atomic
+  // grid reductions don't support grouped reductions.
+  if (isOptionEnabled(EnableOption::GroupSiblingReductions) &&
+      reduction_tvs.size() > 1 && rparams.fastest_dim &&
+      rparams.cross_grid_inner_reduction && !rparams.atomic_grid_reduction) {
+    reduction_scheduler_utils::groupSiblingReductions(reduction_tvs);
+  }
+
   NVF_ERROR(
       !(rparams.schedule_3D && isSharded(reduction_tv)),
       "Multidevice nvFuser does not support 3D reduction schedules");
@@ -1207,6 +1475,12 @@ void scheduleReduction(Fusion* fusion, const ReductionParams& rparams) {
   TensorView* reference_tv = reduction_scheduler_utils::scheduleReductionTV(
       rparams, reduction_tv, has_iter_axis);
 
+  // Serial grid reductions only reduce across blocks, so the block reduction
+  // is done by a separate reduction before
+  if (rparams.serial_grid_reduction) {
+    reduction_scheduler_utils::rFactorBlockReduction(reduction_tv);
+  }
+
   // Reduction tensor views and rfactor tensor views are setup. Let's finish off
   // the scheduling, particularly inlining and unrolling.
   NVF_ERROR(
@@ -1223,6 +1497,7 @@ void scheduleReduction(Fusion* fusion, const ReductionParams& rparams) {
   // see validateAndConvertIterDomainGrouping
   const bool has_welford = ir_utils::hasOpsOfType<WelfordOp>(fusion);
   const bool use_iter_grouped_reduction = !rparams.fastest_dim &&
+      !rparams.atomic_grid_reduction && !rparams.serial_grid_reduction &&
       (has_welford
            ? rparams.cross_grid_inner_reduction && rparams.persistent_kernel
            : rparams.cross_block_inner_reduction);
@@ -1236,7 +1511,21 @@ void scheduleReduction(Fusion* fusion, const ReductionParams& rparams) {
       use_iter_grouped_reduction,
       reduction_tvs,
       cached_inputs,
-      cached_outputs);
+      cached_outputs,
+      /*dummy_outputs=*/{},
+      /*pipeline_serial_loops=*/true);
+
+  if (rparams.atomic_grid_reduction) {
+    for (auto tv : reduction_tvs) {
+      if (tv->isFusionOutput()) {
+        tv->definition()->as<ReductionOp>()->requestAtomicGridReduction();
+      }
+    }
+  }
+
+  if (rparams.serial_grid_reduction) {
+    reduction_tv->definition()->as<ReductionOp>()->requestSerialGridReduction();
+  }
 
   scheduler_utils::promoteProducerMemoryTypes(fusion, cached_inputs);
 
@@ -136,6 +136,24 @@ class ReductionParams : public HeuristicParams {
   // use shared memory for persistent buffer, if false, will use registers
   bool shared_mem_persistent_buffer = false;
 
+  // specific to combined inner and outer reduction, keep the partial results
+  // of outer reductions in shared memory instead of registers
+  bool shared_mem_outer_partial_buffer = false;
+
+  // re-read persistent buffers projected to the inputs from global memory
+  // after the reduction instead of keeping them in registers
+  bool global_mem_persistent_buffer = false;
+
+  // Combine the blocks of cross-grid sum reductions with atomic additions
+  // into the zero-initialized outputs instead of a work buffer and a grid
+  // synchronization. The results are not deterministic.
+  bool atomic_grid_reduction = false;
+
+  // Combine the blocks of cross-grid reductions one after another in the
+  // outputs with a serial grid reduction instead of a work buffer and a
+  // tree of blocks. The results are deterministic.
+  bool serial_grid_reduction = false;
+
  public:
   using HeuristicParams::HeuristicParams;
 
@@ -181,7 +199,12 @@ class ReductionParams : public HeuristicParams {
         other.vectorization_factor_outer == vectorization_factor_outer &&
         other.vectorization_factor_tmp_gmem_write ==
             vectorization_factor_tmp_gmem_write &&
-        other.shared_mem_persistent_buffer == shared_mem_persistent_buffer;
+        other.shared_mem_persistent_buffer == shared_mem_persistent_buffer &&
+        other.shared_mem_outer_partial_buffer ==
+            shared_mem_outer_partial_buffer &&
+        other.global_mem_persistent_buffer == global_mem_persistent_buffer &&
+        other.atomic_grid_reduction == atomic_grid_reduction &&
+        other.serial_grid_reduction == serial_grid_reduction;
 
     if (other.static_bdimy || static_bdimy) {
       attr_equal = attr_equal && other.lparams.bdimy() == lparams.bdimy();
@@ -273,6 +296,22 @@ class ReductionParams : public HeuristicParams {
       ss << "\ncomputeWith persistent buffers";
     }
 
+    if (shared_mem_outer_partial_buffer) {
+      ss << "\nshared memory outer partial buffers";
+    }
+
+    if (global_mem_persistent_buffer) {
+      ss << "\nre-read persistent buffers from global memory";
+    }
+
+    if (atomic_grid_reduction) {
+      ss << "\natomic grid reduction";
+    }
+
+    if (serial_grid_reduction) {
+      ss << "\nserial grid reduction";
+    }
+
     ss << "\n" << lparams.toString();
     ss << cparams.toString() << "\n";
     ss << "====================================\n";
@@ -305,7 +344,11 @@ class ReductionParams : public HeuristicParams {
         static_cast<size_t>(batches_per_block_outer_reduction) << (bits - 21) ^
         static_cast<size_t>(unroll_factor_outer_reduction) << (bits - 22) ^
         static_cast<size_t>(compute_persistent_buffer_with_first_consumer)
-            << (bits - 23);
+            << (bits - 23) ^
+        static_cast<size_t>(atomic_grid_reduction) << (bits - 24) ^
+        static_cast<size_t>(shared_mem_outer_partial_buffer) << (bits - 25) ^
+        static_cast<size_t>(global_mem_persistent_buffer) << (bits - 26) ^
+        static_cast<size_t>(serial_grid_reduction) << (bits - 27);
     return attr_hash;
   }
 
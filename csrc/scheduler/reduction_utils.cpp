@@ -7,13 +7,16 @@
 // clang-format on
 #include <scheduler/reduction_utils.h>
 
+#include <ATen/cuda/CUDAContext.h>
 #include <expr_evaluator.h>
+#include <grouped_reduction.h>
 #include <inlining.h>
 #include <ir/cloner.h>
 #include <ir/utils.h>
 #include <maxinfo_propagator.h>
 #include <multidevice/utils.h>
 #include <ops/arith.h>
+#include <options.h>
 #include <scheduler/registry.h>
 #include <scheduler/utils.h>
 #include <transform_replay.h>
@@ -371,7 +374,8 @@ void multiReductionInliner(
     std::vector<TensorView*> reduction_tvs,
     std::vector<TensorView*> cached_inputs,
     std::vector<std::pair<TensorView*, TensorView*>> cached_outputs,
-    std::vector<TensorView*> dummy_outputs) {
+    std::vector<TensorView*> dummy_outputs,
+    const bool pipeline_serial_loops) {
   // Propagate transformations before we rfactor the other reductions
   propagateTransformation(reference_tv);
   // If reduction_tv is rfactored, rfactor all reductions.
@@ -395,8 +399,136 @@ void multiReductionInliner(
     fusion->removeOutput(output);
   }
 
-  // Inline the schedule
-  inlineMost();
+  const auto pipelined_inputs = pipeline_serial_loops
+      ? getPipelinedInputs(cached_inputs)
+      : std::vector<std::pair<TensorView*, int64_t>>{};
+  if (pipelined_inputs.empty()) {
+    // Inline the schedule
+    inlineMost();
+    return;
+  }
+
+  // Pipelined inputs are only inlined into their serial loops
+  std::unordered_set<TensorView*> inlined_tvs;
+  for (auto tv : ir_utils::allTvs(fusion)) {
+    inlined_tvs.insert(tv);
+  }
+  for (const auto& [tv, pos] : pipelined_inputs) {
+    inlined_tvs.erase(tv);
+  }
+  inlineMost(inlined_tvs);
+  for (const auto& [tv, pos] : pipelined_inputs) {
+    tv->inlineAt(pos + 1);
+    tv->doubleBuffer();
+  }
+}
+
+namespace {
+
+// Cycles to load from global memory
+constexpr int64_t kGlobalMemoryLatencyCycles = 600;
+
+// Maximum bytes per thread of the buffers of pipelined inputs, which are
+// doubled by pipelining
+constexpr int64_t kMaxPipelinedBytesPerThread = 64;
+
+// Position of the serial loop in which the loads of tv can be pipelined, i.e.
+// the innermost serial loop tv can be inlined into with only unswitched,
+// unrolled and vectorized loops inside, or -1
+int64_t getSerialLoopPosition(TensorView* tv, MaxPosCalculator& calc) {
+  const auto& leaf = tv->getLeafDomain();
+  const auto first_unroll_it =
+      std::find_if(leaf.begin(), leaf.end(), [](IterDomain* id) {
+        return id->getParallelType() == ParallelType::Unroll;
+      });
+  const int64_t end = std::min(
+      (int64_t)calc.getMaxPosAll(tv),
+      (int64_t)std::distance(leaf.begin(), first_unroll_it));
+  for (int64_t i = end - 1; i >= 0; --i) {
+    IterDomain* id = tv->axis(i);
+    if (id->isBroadcast() || isParallelTypeThread(id->getParallelType()) ||
+        id->getParallelType() == ParallelType::Unswitch) {
+      continue;
+    }
+    if (id->getParallelType() != ParallelType::Serial) {
+      return -1;
+    }
+    if (id->extent()->isConstInt() &&
+        id->extent()->evaluate().as<int64_t>() < 2) {
+      continue;
+    }
+    return i;
+  }
+  return -1;
+}
+
+// Bytes loaded by each thread per iteration of the loop at pos, or nullopt if
+// not known at compile time
+std::optional<int64_t> getBytesPerIteration(TensorView* tv, int64_t pos) {
+  int64_t bytes = (int64_t)dataTypeSize(tv->dtype());
+  for (int64_t i = pos + 1; i < tv->nDims(); ++i) {
+    IterDomain* id = tv->axis(i);
+    if (id->isBroadcast() || isParallelTypeThread(id->getParallelType())) {
+      continue;
+    }
+    if (!id->extent()->isConstInt()) {
+      return std::nullopt;
+    }
+    bytes *= id->extent()->evaluate().as<int64_t>();
+  }
+  return bytes;
+}
+
+// Whether loading bytes_per_thread per iteration leaves too few bytes in
+// flight to cover the global memory latency, assuming half of the maximum
+// number of threads of an SM are resident
+bool isLatencyBound(int64_t bytes_per_thread) {
+  const auto prop = at::cuda::getCurrentDeviceProperties();
+  // Both clock rates are in kHz
+  const double bytes_per_cycle_per_sm = 2.0 * prop->memoryClockRate *
+      (prop->memoryBusWidth / 8.0) /
+      ((double)prop->clockRate * prop->multiProcessorCount);
+  const double bytes_in_flight =
+      (double)bytes_per_thread * prop->maxThreadsPerMultiProcessor / 2.0;
+  return bytes_in_flight <
+      (double)kGlobalMemoryLatencyCycles * bytes_per_cycle_per_sm;
+}
+
+} // namespace
+
+std::vector<std::pair<TensorView*, int64_t>> getPipelinedInputs(
+    const std::vector<TensorView*>& cached_inputs) {
+  if (!isOptionEnabled(EnableOption::SerialLoopPipelining)) {
+    return {};
+  }
+  MaxPosCalculator calc;
+  std::vector<std::pair<TensorView*, int64_t>> pipelined_inputs;
+  int64_t bytes_per_thread = 0;
+  for (auto tv : cached_inputs) {
+    auto ldst = dynamic_cast<LoadStoreOp*>(tv->definition());
+    if (ldst == nullptr || !ldst->in()->isA<TensorView>() ||
+        ldst->in()->as<TensorView>()->getMemoryType() != MemoryType::Global ||
+        tv->getMemoryType() != MemoryType::Local || tv->isDoubleBuffered() ||
+        tv->isCircularBuffered()) {
+      continue;
+    }
+    const int64_t pos = getSerialLoopPosition(tv, calc);
+    if (pos < 0) {
+      continue;
+    }
+    const auto bytes = getBytesPerIteration(tv, pos);
+    if (!bytes.has_value()) {
+      continue;
+    }
+    pipelined_inputs.emplace_back(tv, pos);
+    bytes_per_thread += *bytes;
+  }
+  if (pipelined_inputs.empty() ||
+      bytes_per_thread > kMaxPipelinedBytesPerThread ||
+      !isLatencyBound(bytes_per_thread)) {
+    return {};
+  }
+  return pipelined_inputs;
 }
 
 void propagateTransformation(
@@ -716,6 +848,29 @@ TensorView* sortAndRFactor(TensorView* reference_tv) {
   return ir_utils::rFactorHelper(reference_tv, rfactor_axes);
 }
 
+TensorView* rFactorBlockReduction(TensorView* reduction_tv) {
+  std::vector<int64_t> rfactor_axes;
+  for (int64_t axis_i = 0; axis_i < reduction_tv->nDims(); axis_i++) {
+    auto id = reduction_tv->axis(axis_i);
+    if (id->isReduction() && id->isThreadDim()) {
+      rfactor_axes.emplace_back(axis_i);
+    }
+  }
+  if (rfactor_axes.empty()) {
+    return reduction_tv;
+  }
+
+  auto block_reduction_tv = ir_utils::rFactorHelper(reduction_tv, rfactor_axes);
+  for (auto id : block_reduction_tv->getLeafDomain()) {
+    if (id->getParallelType() == ParallelType::Unroll ||
+        id->getParallelType() == ParallelType::Vectorize ||
+        id->getParallelType() == ParallelType::MisalignedVectorize) {
+      id->parallelize(ParallelType::Serial);
+    }
+  }
+  return block_reduction_tv;
+}
+
 namespace {
 // If project_to_inputs is true, take all projectable persistent buffers,
 // and move them to the inputs. Otherwise, try to project to their immediate
@@ -952,6 +1107,34 @@ ReductionType getReductionType(const std::vector<TensorView*>& reduction_tvs) {
   }
 }
 
+void groupSiblingReductions(const std::vector<TensorView*>& reduction_tvs) {
+  std::vector<std::vector<TensorView*>> groups;
+  for (auto tv : reduction_tvs) {
+    if (!tv->definition()->isA<ReductionOp>()) {
+      continue;
+    }
+    auto group_it =
+        std::find_if(groups.begin(), groups.end(), [tv](const auto& group) {
+          if ((int64_t)group.size() >= kMaxNumGroupedReductions) {
+            return false;
+          }
+          std::vector<TensorView*> candidate = group;
+          candidate.push_back(tv);
+          return canGroupReductions(candidate);
+        });
+    if (group_it == groups.end()) {
+      groups.push_back({tv});
+    } else {
+      group_it->push_back(tv);
+    }
+  }
+  for (const auto& group : groups) {
+    if (group.size() > 1) {
+      groupReductions(group);
+    }
+  }
+}
+
 ReductionType getReductionType(Fusion* fusion) {
   const auto& reduction_tvs = scheduler_utils::getReductionTvs(fusion);
   return getReductionType(reduction_tvs);
@@ -27,7 +27,9 @@ TensorView* scheduleReductionTV(
     TensorView* reduction_tv,
     bool has_iter_axis);
 
-// Inlining function intended for single or multi reduction fusions.
+// Inlining function intended for single or multi reduction fusions. If
+// pipeline_serial_loops is true, the cached inputs selected by
+// getPipelinedInputs are inlined into their serial loops and double buffered.
 void multiReductionInliner(
     Fusion* fusion,
     TensorView* reduction_tv,
@@ -38,7 +40,18 @@ void multiReductionInliner(
     std::vector<TensorView*> reduction_tvs,
     std::vector<TensorView*> cached_inputs,
     std::vector<std::pair<TensorView*, TensorView*>> cached_outputs,
-    std::vector<TensorView*> dummy_outputs = {});
+    std::vector<TensorView*> dummy_outputs = {},
+    const bool pipeline_serial_loops = false);
+
+// Software pipelining of serial loops, e.g. the serial reduction loop, which
+// load the next iteration of the cached inputs while the current one is
+// computed. Returns the cached inputs to double buffer with the position of
+// their serial loop. They are selected if EnableOption::SerialLoopPipelining
+// is set and the bytes loaded per iteration are too few to cover the latency
+// of global memory with the threads of an SM, while the second buffer fits in
+// a few registers. Must be called on scheduled but not yet inlined tensors.
+std::vector<std::pair<TensorView*, int64_t>> getPipelinedInputs(
+    const std::vector<TensorView*>& cached_inputs);
 
 // Propagate transformations with internal cutoff boundary at boundaryNodesSet
 // in P2C forward propagate, disable propagation to TensorView in
@@ -85,6 +98,20 @@ NVF_API void propagateParallelization(
 // Reduction inliner expects an rfactored domain.
 NVF_API TensorView* sortAndRFactor(TensorView* reference_tv);
 
+// Rfactor the reduction axes of reduction_tv bound to threads, so that
+// reduction_tv only reduces across blocks, e.g., for a serial grid reduction.
+// The unrolled and vectorized axes of the rfactor are made serial as a block
+// reduction can't be vectorized. Returns the rfactor or reduction_tv if it
+// has no thread reduction axes. Must be called after sortAndRFactor.
+TensorView* rFactorBlockReduction(TensorView* reduction_tv);
+
+//! Group the reductions of reduction_tvs that don't depend on each other and
+//! have the same domains into GroupedReductionOps, see groupReductions. Each
+//! reduction joins the first group it can be grouped with, up to
+//! kMaxNumGroupedReductions reductions per group. Must be called before the
+//! reductions are scheduled.
+void groupSiblingReductions(const std::vector<TensorView*>& reduction_tvs);
+
 // If project_to_inputs is true, take all projectable persistent buffers,
 // and move them to the inputs. Otherwise, try to project to their immediate
 // producers if these producers are persistent buffers.
@@ -7,6 +7,7 @@
 // clang-format on
 #include <ATen/cuda/CUDAContext.h>
 #include <executor_utils.h>
+#include <fusion_profiler.h>
 #include <scheduler/all_schedulers.h>
 #include <scheduler/debug_utils.h>
 #include <scheduler/matmul_utils.h>
@@ -78,6 +79,18 @@ SchedulerRuntimeInfo::SchedulerRuntimeInfo(
         input_strides_elements_[fusion_inp] = std::move(ordered_strides);
       }
 
+      // find dimensions expanded by the framework
+      const std::vector<IterDomain*> alloc_dom =
+          TensorDomain::noReductions(input_tv->getMaybeAllocationDomain());
+      if (alloc_dom.size() == alloc_strides.size()) {
+        for (auto dim : c10::irange(alloc_dom.size())) {
+          if (alloc_strides.at(dim) == 0 && alloc_sizes.at(dim) > 1 &&
+              !alloc_dom.at(dim)->isBroadcast()) {
+            input_stride_zero_ids_.insert(alloc_dom.at(dim));
+          }
+        }
+      }
+
       // find and push discontiguous stride
       int64_t dtype_size = dataTypeSize(input_tv->dtype());
       input_discontig_strides_[fusion_inp] = {};
@@ -176,7 +189,9 @@ bool checkCanSchedule(
   //  it has to pass all the compile time checks to create a data cache for this
   //  fusion.
   if (!data_cache) {
-    if (!registry_utils::isConnectedFusionGraph(fusion)) {
+    // The multi-tensor scheduler is meant for disconnected graphs
+    if (SchedulerType::heuristicType() != ScheduleHeuristic::MultiTensor &&
+        !registry_utils::isConnectedFusionGraph(fusion)) {
       scheduler_debug_utils::canScheduleRejectReason(
           SchedulerType::heuristicType(),
           "Connected fusion graph check failed!");
@@ -187,6 +202,17 @@ bool checkCanSchedule(
           SchedulerType::heuristicType(), "Iter domain graph check failed!");
       return false;
     }
+    // Ops without generated code are left to the ExprEval scheduler
+    if (SchedulerType::heuristicType() != ScheduleHeuristic::ExprEval &&
+        std::any_of(
+            fusion->exprs().begin(),
+            fusion->exprs().end(),
+            isATenEvaluatedOp)) {
+      scheduler_debug_utils::canScheduleRejectReason(
+          SchedulerType::heuristicType(),
+          "Fusion has an op that is only evaluated with ATen");
+      return false;
+    }
     if (!SchedulerType::canScheduleCompileTime(fusion)) {
       return false;
     }
@@ -227,6 +253,12 @@ bool checkCanSchedule(
     case ScheduleHeuristic::Matmul:
       return checkCanSchedule<MatmulScheduler>(
           fusion, runtime_info, data_cache);
+    case ScheduleHeuristic::MultiTensor:
+      return checkCanSchedule<MultiTensorScheduler>(
+          fusion, runtime_info, data_cache);
+    case ScheduleHeuristic::ExprEval:
+      return checkCanSchedule<ExprEvalScheduler>(
+          fusion, runtime_info, data_cache);
     default:
       NVF_ERROR(false, "unreachable");
       return false;
@@ -239,6 +271,8 @@ bool checkCanSchedule(
     Fusion* fusion,
     SchedulerRuntimeInfo& runtime_info,
     HeuristicSummary* data_cache) {
+  // Scheduler entries compute their heuristics on construction
+  CompileStepScope step("computeHeuristics " + toString(sh));
   std::unique_ptr<SchedulerEntry> scheduler_entry = nullptr;
   switch (sh) {
     case ScheduleHeuristic::NoOp:
@@ -273,6 +307,14 @@ bool checkCanSchedule(
       scheduler_entry =
           std::make_unique<MatmulScheduler>(fusion, runtime_info, data_cache);
       break;
+    case ScheduleHeuristic::MultiTensor:
+      scheduler_entry = std::make_unique<MultiTensorScheduler>(
+          fusion, runtime_info, data_cache);
+      break;
+    case ScheduleHeuristic::ExprEval:
+      scheduler_entry = std::make_unique<ExprEvalScheduler>(
+          fusion, runtime_info, data_cache);
+      break;
     default:
       NVF_ERROR(false, "unreachable");
   }
@@ -363,6 +405,13 @@ HeuristicSummary::HeuristicSummary(
       NVF_ERROR(canSchedule, "Could not schedule matmul (run time)");
       break;
     }
+    case ScheduleHeuristic::MultiTensor:
+      getMultiTensorHeuristics(fusion, runtime_info, this);
+      MultiTensorScheduler::canScheduleRunTime(fusion, runtime_info, this);
+      break;
+    case ScheduleHeuristic::ExprEval:
+      ExprEvalScheduler::canScheduleRunTime(fusion, runtime_info, this);
+      break;
     default:
       NVF_ERROR(false, "unknown heuristic");
   }
@@ -440,6 +489,14 @@ void HeuristicSummary::validate() const {
       // TODO: add a proper set of checks
       break;
     }
+    case ScheduleHeuristic::MultiTensor: {
+      // Each subgraph has its own reference, so nothing is cached
+      break;
+    }
+    case ScheduleHeuristic::ExprEval: {
+      // Nothing is generated, so nothing is cached
+      break;
+    }
     default:
       NVF_ERROR(false, "unknown heuristic");
   }
@@ -39,9 +39,14 @@ class ExpressionEvaluator;
 
 class SchedulerRuntimeInfo : public NonCopyable {
  public:
-  // Max vector size we will consider, in bytes,
-  //  currently set to 16B = 128b
-  static constexpr int64_t max_alignment_size_in_byte = 16;
+  // Max alignment we will consider, in bytes, currently set to 32B = 256b,
+  //  the widest vectorized access, see max_vectorize_size_in_byte
+  static constexpr int64_t max_alignment_size_in_byte = 32;
+
+  // Max vector size schedulers consider by default, in bytes, currently set
+  //  to 16B = 128b. 32B accesses are only worth it on Blackwell, see
+  //  vectorize_helper::maxVectorizationBytes
+  static constexpr int64_t max_vectorize_size_in_byte = 16;
 
   //! Create runtime info for given fusion and input. Creating and binding
   //! evaluator is optional. The evaluator is used to manage intermediate
@@ -101,6 +106,13 @@ class SchedulerRuntimeInfo : public NonCopyable {
     return strides_it->second;
   }
 
+  //! Returns the non-broadcast allocation iterdomains of inputs that have a
+  //! zero stride and more than one element at runtime, i.e. dimensions the
+  //! framework expanded. Every element along them is the same value.
+  const std::unordered_set<IterDomain*>& getStrideZeroInputIds() const {
+    return input_stride_zero_ids_;
+  }
+
   // Computes alignment size in bytes for provided ptr address
   static size_t computeAlignmentSize(size_t ptr_address);
 
@@ -160,6 +172,9 @@ class SchedulerRuntimeInfo : public NonCopyable {
   // dimensions
   std::unordered_map<Val*, std::vector<size_t>> input_discontig_strides_;
 
+  // Input iterdomains that are expanded at runtime, see getStrideZeroInputIds
+  std::unordered_set<IterDomain*> input_stride_zero_ids_;
+
   // Cache for getAlignmentSize
   std::unordered_map<TensorView*, size_t> alignment_map_;
 
@@ -252,6 +267,13 @@ class SchedulerEntry {
     params_->lparams = launch_params;
   }
 
+  //! Replaces the heuristic parameters, e.g. by the ones picked by the
+  //! autotuner. See getAutotuneCandidates.
+  void setParams(std::shared_ptr<HeuristicParams> params) {
+    NVF_ERROR(params != nullptr);
+    params_ = std::move(params);
+  }
+
  protected:
   explicit SchedulerEntry(ScheduleHeuristic heuristic)
       : heuristic_(heuristic) {}
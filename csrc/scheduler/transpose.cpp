@@ -11,6 +11,7 @@
 #include <inlining.h>
 #include <instrumentation.h>
 #include <scheduler/debug_utils.h>
+#include <scheduler/heuristic_plugin.h>
 #include <scheduler/reduction_utils.h>
 #include <scheduler/registry_utils.h>
 #include <scheduler/transpose.h>
@@ -386,9 +387,57 @@ class DomainMap : public pointwise_utils::DomainMap {
            const std::vector<TensorView*>& v2) {
           return v1.size() > v2.size();
         });
+    moveTileableGroupsToFront(groups);
     return groups;
   }
 
+  // The scheduler tiles the inner most dimensions of the first two groups,
+  // and schedules the tensors of the other groups like the first group. The
+  // first group must have a reference tensor with a dimension mapped to the
+  // inner most dimension of the reference of the second group. Fusions with
+  // more than two groups may have a pair of groups that satisfies this even if
+  // their two largest groups don't, e.g. when a third permutation shares no
+  // dimension with the reference of the largest group. Move the largest such
+  // pair to the front, in their sorted order if possible, so that these
+  // fusions are not rejected.
+  void moveTileableGroupsToFront(
+      std::vector<std::vector<TensorView*>>& groups) const {
+    if (groups.size() < 2) {
+      return;
+    }
+    std::vector<TensorView*> references;
+    references.reserve(groups.size());
+    for (const auto& group : groups) {
+      references.push_back(findReferenceFor(group));
+    }
+    auto can_tile = [&](size_t i, size_t j) {
+      if (references[i] == nullptr || references[j] == nullptr) {
+        return false;
+      }
+      auto innermost = scheduler_utils::innerMostAllocDim(references[j]);
+      return innermost != nullptr &&
+          getMappedAllocDimIn(references[i], innermost) != nullptr;
+    };
+    for (auto sum : c10::irange((size_t)1, 2 * groups.size() - 2)) {
+      for (auto i : c10::irange(std::min(sum + 1, groups.size()))) {
+        auto j = sum - i;
+        if (j >= groups.size() || j == i || !can_tile(i, j)) {
+          continue;
+        }
+        if (i == 0 && j == 1) {
+          return;
+        }
+        auto group1 = std::move(groups[i]);
+        auto group2 = std::move(groups[j]);
+        groups.erase(groups.begin() + (int64_t)std::max(i, j));
+        groups.erase(groups.begin() + (int64_t)std::min(i, j));
+        groups.insert(groups.begin(), std::move(group2));
+        groups.insert(groups.begin(), std::move(group1));
+        return;
+      }
+    }
+  }
+
   // In the transpose scheculing, unlike the pointwise scheduling, the
   // permissive map is required to find reference tensors. See also PR
   // #661
@@ -928,16 +977,19 @@ std::shared_ptr<TransposeParams> getTransposeHeuristics(
   scan_max_dtype_size(fusion->inputs());
   scan_max_dtype_size(fusion->outputs());
 
+  // Tensors of all groups are unrolled, not only the tiled ones
+  int64_t n_grouped_tensors = 0;
+  for (const auto& group : grouped_inputs_outputs) {
+    n_grouped_tensors += (int64_t)group.size();
+  }
+
   auto max_unroll_factor = ceilDiv(
       // Available unrolling based on size of data type
       kSixteen / max_io_dtype_size,
       // Reduce max unrolling factor if we have many inputs/outputs to unroll
       // as it could start consuming a lot of registers.
       std::max(
-          (scheduler_utils::lastPow2(
-               (int64_t)grouped_inputs_outputs[0].size() +
-               (int64_t)grouped_inputs_outputs[1].size()) >>
-           2),
+          (scheduler_utils::lastPow2(n_grouped_tensors) >> 2),
           (int64_t)1));
 
   // Don't unroll at the cost of getting a full wave on the GPU
@@ -1017,6 +1069,20 @@ std::shared_ptr<TransposeParams> getTransposeHeuristics(
 
   params->lparams.bind(params->getThreadsPerBlock(), ParallelType::TIDx);
 
+  if (heuristic_plugin::hasPlugin(
+          heuristic_plugin::ProblemDescription::Kernel::Transpose)) {
+    if (auto problem = heuristic_plugin::makeProblemDescription(
+            heuristic_plugin::ProblemDescription::Kernel::Transpose,
+            reference1,
+            runtime_info)) {
+      problem->max_input_dtype_size = (uint8_t)max_io_dtype_size;
+      problem->n_tensor_inputs =
+          (uint16_t)ir_utils::filterByType<TensorView>(fusion->inputs())
+              .size();
+      heuristic_plugin::updateTransposeParams(*params, *problem);
+    }
+  }
+
   if (isDebugDumpEnabled(DebugDumpOption::SchedulerDebug)) {
     debug() << "\n===== Transpose Stats ========\n"
             << "inputs: " << ir_utils::toString(fusion->inputs()) << "\n"
@@ -10,11 +10,13 @@
 #include <scheduler/vectorize_helper.h>
 
 #include <contiguity.h>
+#include <device_lower/lower2device.h>
 #include <expr_evaluator.h>
 #include <instrumentation.h>
 #include <ir/utils.h>
 #include <multidevice/utils.h>
 #include <ops/all_ops.h>
+#include <options.h>
 #include <root_domain_map.h>
 #include <scheduler/mma_utils.h>
 #include <transform_iter.h>
@@ -1241,8 +1243,10 @@ IterDomain* projectIdToRoot(
     } else if (expr->isA<Resize>()) {
       auto resize = expr->as<Resize>();
       if (resize->out() == projected_id) {
-        // We do not allow vectorization with resize at this moment
-        if (vectorize_pass) {
+        // We do not allow vectorization with resize at this moment, except
+        // for slices with aligned offsets
+        if (vectorize_pass &&
+            !isOptionEnabled(EnableOption::SliceVectorization)) {
           projected_id = nullptr;
         } else {
           projected_id = resize->in();
@@ -1301,8 +1305,10 @@ IterDomain* projectIdToRFactor(
     } else if (expr->isA<Resize>()) {
       auto resize = expr->as<Resize>();
       if (resize->in() == projected_id) {
-        // We do not allow vectorization wit resize at this moment
-        if (vectorize_pass) {
+        // We do not allow vectorization wit resize at this moment, except
+        // for slices with aligned offsets
+        if (vectorize_pass &&
+            !isOptionEnabled(EnableOption::SliceVectorization)) {
           projected_id = nullptr;
         } else {
           projected_id = resize->out();
@@ -1473,6 +1479,39 @@ bool hasInnerDim(
   return true;
 }
 
+namespace {
+
+// Returns if the rows of a lookup table of index_select are loaded with
+// vectorized accesses, which vectorizes the outputs of its index_select ops.
+// All of its uses must use it as the lookup table. Whether the inner dimension
+// of the rows is contiguous and mapped to the reference is checked by
+// hasInnerDim; the indexed dimension never is.
+bool isVectorizableRowGatherLookupTv(TensorView* tv) {
+  return isOptionEnabled(EnableOption::VectorizedRowGather) &&
+      std::all_of(tv->uses().begin(), tv->uses().end(), [tv](Expr* use) {
+           auto index_select = dynamic_cast<IndexSelectOp*>(use);
+           return index_select != nullptr && index_select->lookupTv() == tv &&
+               index_select->indexTv() != tv;
+         });
+}
+
+// Returns if a fusion input used by slices is loaded with vectorized
+// accesses, which vectorizes the outputs of the slices. The input is not
+// cached, so its other uses must be copies that can be vectorized as well.
+// The alignment of the slice offsets is accounted for in the projected
+// extents of ContiguousInnerDimensionsMapper and validated at run time.
+bool isVectorizableSliceInput(TensorView* tv) {
+  return isOptionEnabled(EnableOption::SliceVectorization) &&
+      std::all_of(tv->uses().begin(), tv->uses().end(), [](Expr* use) {
+           if (auto* ldst = dynamic_cast<LoadStoreOp*>(use)) {
+             return ldst->opType() == LoadStoreOpType::Set;
+           }
+           return use->isA<SliceOp>();
+         });
+}
+
+} // namespace
+
 std::vector<TensorView*> getInputsOutputsWithInnerDim(
     TensorView* reference_tv,
     bool inner_only,
@@ -1514,9 +1553,11 @@ std::vector<TensorView*> getInputsOutputsWithInnerDim(
   for (auto input_tv :
        ir_utils::filterByType<TensorView>(reference_tv->fusion()->inputs())) {
     // for index_select(lookup_tv, dim, index_tv) op
-    // ignore it's lookup_tv.
+    // ignore it's lookup_tv, unless its rows are gathered with vectorized
+    // loads.
     if (ir_utils::isTorchGatherLookupTv(input_tv) ||
-        ir_utils::isIndexSelectLookupTv(input_tv)) {
+        (ir_utils::isIndexSelectLookupTv(input_tv) &&
+         !isVectorizableRowGatherLookupTv(input_tv))) {
       continue;
     }
 
@@ -1530,9 +1571,11 @@ std::vector<TensorView*> getInputsOutputsWithInnerDim(
           });
     };
 
-    // At this moment, vectorization through resize is not supported
+    // At this moment, vectorization through resize is not supported, except
+    // for slices with aligned offsets
     if (std::any_of(
-            input_tv->uses().begin(), input_tv->uses().end(), expr_resizes)) {
+            input_tv->uses().begin(), input_tv->uses().end(), expr_resizes) &&
+        !isVectorizableSliceInput(input_tv)) {
       continue;
     }
 
@@ -1622,7 +1665,8 @@ DisjointRFactorSetInfo getDisjointRFactorSetsOf(
 BroadcastMultipleInformation getBroadcastMultiples(
     TensorView* reference_tv,
     DataType index_type,
-    const std::unordered_map<int64_t, int64_t>& rfactor_reorder_map) {
+    const std::unordered_map<int64_t, int64_t>& rfactor_reorder_map,
+    const std::unordered_set<IterDomain*>& stride_zero_ids) {
   auto fusion = reference_tv->fusion();
   FusionGuard fg(fusion);
 
@@ -1704,9 +1748,12 @@ BroadcastMultipleInformation getBroadcastMultiples(
         continue;
       }
 
-      if (std::all_of(mapped_ids.begin(), mapped_ids.end(), [](IterDomain* id) {
-            return id->isBroadcast();
-          })) {
+      if (std::all_of(
+              mapped_ids.begin(),
+              mapped_ids.end(),
+              [&stride_zero_ids](IterDomain* id) {
+                return id->isBroadcast() || stride_zero_ids.count(id);
+              })) {
         continue;
       }
 
@@ -2505,6 +2552,16 @@ std::unordered_set<TensorView*> getAllTvsFrom(
   return tv_group;
 }
 
+int64_t estimateScheduledRegisterUsage(
+    Fusion* scheduled_fusion,
+    const CompileParams& compile_params) {
+  FUSER_PERF_SCOPE("scheduler_utils::estimateScheduledRegisterUsage");
+  Fusion fusion_copy = *scheduled_fusion;
+  GpuLower lower(&fusion_copy, compile_params);
+  lower.run();
+  return lower.kernel()->summary().estimated_register_usage;
+}
+
 } // namespace scheduler_utils
 
 } // namespace nvfuser
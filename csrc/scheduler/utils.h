@@ -11,6 +11,7 @@
 #include <device_lower/pass/loop_rotation.h>
 #include <disjoint_set.h>
 #include <exceptions.h>
+#include <executor_params.h>
 #include <fusion.h>
 #include <ir/all_nodes.h>
 #include <ir/cloner.h>
@@ -437,10 +438,14 @@ struct BroadcastMultipleInformation {
 //
 // rfactor_reorder_map is provided to assume reference_tv will be reordered per
 // the map
+//
+// Input iterdomains in stride_zero_ids, i.e. dimensions expanded at runtime,
+// are treated like broadcast since each of their values is loaded only once.
 NVF_API BroadcastMultipleInformation getBroadcastMultiples(
     TensorView* reference_tv,
     DataType index_type,
-    const std::unordered_map<int64_t, int64_t>& rfactor_reorder_map = {});
+    const std::unordered_map<int64_t, int64_t>& rfactor_reorder_map = {},
+    const std::unordered_set<IterDomain*>& stride_zero_ids = {});
 
 //! Propagate current transformations on from_tv up to the given
 //!  position, to all tensorviews on the owning fusion that has
@@ -658,5 +663,13 @@ int64_t getPersistentBufferSizeOfTensor(
     SchedulerRuntimeInfo& runtime_info,
     const PersistentBufferInfo& persistent_buffer_info);
 
+//! Lowers a copy of the scheduled fusion and returns the registers per
+//! thread estimated by estimateRegisterUsage, so that a schedule that is
+//! likely to spill can be detected before it is compiled. This lowers the
+//! fusion, so it is too expensive to be called in a heuristic loop.
+NVF_API int64_t estimateScheduledRegisterUsage(
+    Fusion* scheduled_fusion,
+    const CompileParams& compile_params);
+
 } // namespace scheduler_utils
 } // namespace nvfuser
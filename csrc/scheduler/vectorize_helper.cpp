@@ -14,8 +14,11 @@
 #include <expr_simplifier.h>
 #include <ir/builder.h>
 #include <iter_visitor.h>
+#include <options.h>
 #include <scheduler/registry.h>
 
+#include <ATen/cuda/CUDAContext.h>
+
 #include <c10/util/irange.h>
 
 #include <unordered_set>
@@ -369,6 +372,28 @@ std::vector<IterDomain*> ContiguousInnerDimensionsMapper::projectId(
     }
   };
 
+  // Maps `from` to `to` through `resize`, which can only be the outermost
+  // domain of a contiguous mapping. Accesses of `to` are shifted by the left
+  // expansion, so vectorized accesses stay aligned only if the expansions are
+  // divisible by the vector width.
+  auto propagateResize =
+      [&frontier, this](Resize* resize, IterDomain* from, IterDomain* to) {
+        auto it = std::find(frontier.begin(), frontier.end(), from);
+        if (it == frontier.end()) {
+          return;
+        }
+        *it = to;
+        frontier.erase(frontier.begin(), it);
+        if (recording_) {
+          addProjectedExtent(
+              to,
+              SimplifyingIrBuilder::gcdExpr(
+                  SimplifyingIrBuilder::gcdExpr(
+                      getProjectedExtent(from), resize->leftExpand()),
+                  resize->rightExpand()));
+        }
+      };
+
   // If `from` is [I1, I2, I3, I4], `to` is [I1, I5, I6, I7], where I2 =
   // merge(I5, I6) and I7 = merge(I3, I4), `from` is on both side of `to`. We
   // traverse the forward side and backward side separately. For this example,
@@ -388,8 +413,12 @@ std::vector<IterDomain*> ContiguousInnerDimensionsMapper::projectId(
     } else if (Merge* merge = dynamic_cast<Merge*>(expr)) {
       propagateDistribute(merge);
     } else if (Resize* resize = dynamic_cast<Resize*>(expr)) {
-      // Cannot vectorize through resize
-      clear_left_of(resize->out());
+      if (isOptionEnabled(EnableOption::SliceVectorization)) {
+        propagateResize(resize, resize->out(), resize->in());
+      } else {
+        // Cannot vectorize through resize
+        clear_left_of(resize->out());
+      }
     } else {
       // TODO: I wonder if we should just remove all inputs instead of erroring.
       // Seems that would be safe.
@@ -414,8 +443,12 @@ std::vector<IterDomain*> ContiguousInnerDimensionsMapper::projectId(
     } else if (Split* split = dynamic_cast<Split*>(expr)) {
       propagateDistribute(split);
     } else if (Resize* resize = dynamic_cast<Resize*>(expr)) {
-      // Cannot vectorize through resize
-      clear_left_of(resize->in());
+      if (isOptionEnabled(EnableOption::SliceVectorization)) {
+        propagateResize(resize, resize->in(), resize->out());
+      } else {
+        // Cannot vectorize through resize
+        clear_left_of(resize->in());
+      }
     } else {
       // TODO: I wonder if we should just remove all inputs instead of erroring.
       // Seems that would be safe.
@@ -800,7 +833,15 @@ int64_t getVectorizationFactor(
     TensorView* reference_tv,
     HeuristicSummary* data_cache,
     int64_t break_point,
-    const std::unordered_map<int64_t, int64_t>& rfactor_reorder_map) {
+    const std::unordered_map<int64_t, int64_t>& rfactor_reorder_map,
+    const std::unordered_set<TensorView*>& unvectorized_inputs,
+    int64_t max_vectorize_bytes) {
+  NVF_ERROR(
+      max_vectorize_bytes <= SchedulerRuntimeInfo::max_alignment_size_in_byte,
+      "Vectorized accesses are at most ",
+      SchedulerRuntimeInfo::max_alignment_size_in_byte,
+      " bytes wide, but got ",
+      max_vectorize_bytes);
   auto vectorizable_inputs_outputs_entry =
       HeuristicSummaryEntry<HeuristicCompileTime::VectorizableInputsAndOutputs>(
           data_cache, [&reference_tv]() {
@@ -829,16 +870,17 @@ int64_t getVectorizationFactor(
     return 1;
   }
 
-  int64_t max_vec_size = SchedulerRuntimeInfo::max_alignment_size_in_byte;
+  int64_t max_vec_size = max_vectorize_bytes;
   const auto& tv_to_inner_size_map = vectorize_maps_entry.get().at(break_point);
 
   for (auto inp_or_out : vectorizable_inputs_outputs) {
+    if (unvectorized_inputs.count(inp_or_out) > 0) {
+      continue;
+    }
     // factor <= max_factor / dtype_size
     const auto dtype_size =
         dataTypeSize(inp_or_out->dtype(), runtime_info.getIndexType());
-    max_vec_size = std::min(
-        max_vec_size,
-        SchedulerRuntimeInfo::max_alignment_size_in_byte / dtype_size);
+    max_vec_size = std::min(max_vec_size, max_vectorize_bytes / dtype_size);
 
     // factor <= alignment / dtype_size
     int64_t alignment_size = (int64_t)runtime_info.getAlignmentSize(inp_or_out);
@@ -870,6 +912,13 @@ int64_t getVectorizationFactor(
   return max_vec_size;
 }
 
+int64_t maxVectorizationBytes() {
+  if (at::cuda::getCurrentDeviceProperties()->major >= 10) {
+    return SchedulerRuntimeInfo::max_alignment_size_in_byte;
+  }
+  return SchedulerRuntimeInfo::max_vectorize_size_in_byte;
+}
+
 int64_t getVectorizationFactorTransposeGroup(
     SchedulerRuntimeInfo& runtime_info,
     TensorView* reference,
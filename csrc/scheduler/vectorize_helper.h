@@ -19,6 +19,7 @@
 
 #include <sstream>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -311,13 +312,23 @@ class NVF_API ContiguousInnerDimensionsMapper
 };
 
 // rfactor_reorder_map is provided to assume reference_tv will be reordered per
-// the map, hence changing the order of IterDomain in the reference
+// the map, hence changing the order of IterDomain in the reference. The
+// inputs in unvectorized_inputs are not going to be vectorized and don't
+// limit the factor. The vectorized accesses are at most max_vectorize_bytes
+// wide, which defaults to SchedulerRuntimeInfo::max_vectorize_size_in_byte.
 int64_t getVectorizationFactor(
     SchedulerRuntimeInfo& runtime_info,
     TensorView* reference_tv,
     HeuristicSummary* data_cache,
     int64_t break_point,
-    const std::unordered_map<int64_t, int64_t>& rfactor_reorder = {});
+    const std::unordered_map<int64_t, int64_t>& rfactor_reorder = {},
+    const std::unordered_set<TensorView*>& unvectorized_inputs = {},
+    int64_t max_vectorize_bytes = 16);
+
+//! The widest vectorized global access worth using on the current device.
+//! Blackwell (10.0+) has 256-bit loads and stores, older devices would split
+//! them into pairs of 128-bit accesses, which only adds register pressure.
+int64_t maxVectorizationBytes();
 
 int64_t getVectorizationFactorTransposeGroup(
     SchedulerRuntimeInfo& runtime_info,
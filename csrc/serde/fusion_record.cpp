@@ -724,6 +724,13 @@ void RecordFunctorFactory::setupFunctionMaps() {
   NVFUSER_UNARY_TV_OP("abs", abs)
   NVFUSER_UNARY_TV_OP("acos", acos)
   NVFUSER_UNARY_TV_OP("acosh", acosh)
+  NVFUSER_UNARY_TV_OP("approx_cos", approx_cos)
+  NVFUSER_UNARY_TV_OP("approx_exp", approx_exp)
+  NVFUSER_UNARY_TV_OP("approx_log", approx_log)
+  NVFUSER_UNARY_TV_OP("approx_reciprocal", approx_reciprocal)
+  NVFUSER_UNARY_TV_OP("approx_rsqrt", approx_rsqrt)
+  NVFUSER_UNARY_TV_OP("approx_sin", approx_sin)
+  NVFUSER_UNARY_TV_OP("approx_tanh", approx_tanh)
   NVFUSER_UNARY_TV_OP("asin", asin)
   NVFUSER_UNARY_TV_OP("asinh", asinh)
   NVFUSER_UNARY_TV_OP("atan", atan)
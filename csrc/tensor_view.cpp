@@ -126,6 +126,17 @@ void TensorView::printTransforms() const {
   IrTransformPrinter(std::cout).printTransforms(this);
 }
 
+void TensorView::setDomain(TensorDomain* td) {
+  // Leaf domain transformations are often replayed as new domains with the
+  // same root and rfactor domains, which don't change the tensor graph
+  if (domain_ != nullptr &&
+      (domain_->root() != td->root() ||
+       domain_->maybeRFactor() != td->maybeRFactor())) {
+    fusion()->invalidateTensorGraph();
+  }
+  domain_ = td;
+}
+
 // sets cpu_scalar_ value, which is special handling for CPU based zero-dim
 // tensors (i.e. CPU Tensors that only have one value). This is only used if
 // on an input value, otherwise ignored. This is important as special handling
@@ -404,6 +415,31 @@ int64_t TensorView::getComputePosition(const TensorView* consumer) const {
   }
 }
 
+bool TensorView::sharesComputeWithLoops(
+    TensorView* consumer,
+    TensorView* other_consumer) const {
+  const auto& ca_map = GpuLower::current()->caMap();
+  auto find_leaf_id = [&](TensorView* tv, IterDomain* id) -> IterDomain* {
+    auto it = std::find_if(
+        tv->getLeafDomain().begin(),
+        tv->getLeafDomain().end(),
+        [&](IterDomain* leaf_id) {
+          return ca_map->areMapped(id, leaf_id, IdMappingMode::PERMISSIVE);
+        });
+    return it == tv->getLeafDomain().end() ? nullptr : *it;
+  };
+  for (auto pos :
+       c10::irange(getComputeAtPosition(), getComputeWithPosition())) {
+    IterDomain* consumer_id = find_leaf_id(consumer, axis(pos));
+    IterDomain* other_id = find_leaf_id(other_consumer, axis(pos));
+    if (consumer_id == nullptr || other_id == nullptr ||
+        !ca_map->areMapped(consumer_id, other_id, IdMappingMode::LOOP)) {
+      return false;
+    }
+  }
+  return true;
+}
+
 bool TensorView::resolveComputeWith(const std::vector<Expr*>& sorted_exprs) {
   NVF_ERROR(container()->isA<kir::Kernel>(), "Function invalid for fusion.");
 
@@ -426,7 +462,8 @@ bool TensorView::resolveComputeWith(const std::vector<Expr*>& sorted_exprs) {
     use_set.insert(sibling->uses().begin(), sibling->uses().end());
   }
 
-  for (auto expr : sorted_exprs) {
+  for (auto it = sorted_exprs.begin(); it != sorted_exprs.end(); ++it) {
+    Expr* expr = *it;
     if (!use_set.count(expr)) {
       continue;
     }
@@ -436,6 +473,25 @@ bool TensorView::resolveComputeWith(const std::vector<Expr*>& sorted_exprs) {
         ir_utils::filterByType<TensorView>(expr->outputs()).begin(),
         ir_utils::filterByType<TensorView>(expr->outputs()).end()};
 
+    // Later uses in the loops of the first use at the computeWith
+    // position, e.g., several consumers of a persistent buffer in the
+    // same normalization epilogue, are computed with as well
+    TensorView* first_consumer = use_out_tvs.at(0);
+    for (auto later_it = std::next(it); later_it != sorted_exprs.end();
+         ++later_it) {
+      if (!use_set.count(*later_it)) {
+        continue;
+      }
+      auto later_out_tvs =
+          ir_utils::filterByType<TensorView>((*later_it)->outputs());
+      if (later_out_tvs.empty() ||
+          !sharesComputeWithLoops(first_consumer, *later_out_tvs.begin())) {
+        continue;
+      }
+      use_out_tvs.insert(
+          use_out_tvs.end(), later_out_tvs.begin(), later_out_tvs.end());
+    }
+
     for (auto sibling : siblings) {
       sibling->compute_with_consumers_ = use_out_tvs;
     }
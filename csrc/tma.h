@@ -68,6 +68,14 @@
 // future, we will need more advanced sync analysis and insert the correct syncs
 // at the correct point.
 //
+// Besides copies, TMA can also add a shared memory tile to global memory with
+// cp.reduce.async.bulk.tensor, e.g., to combine the partial results of a
+// split-K GEMM epilogue. In nvFuser, this is a ReductionOp from shared memory
+// to a global output with `Bulk` leaf domains that requests an atomic grid
+// reduction, see ReductionOp::requestAtomicGridReduction. Its reduction axes
+// must be parallelized by BID, and the output is zero-initialized by the
+// executor like that of any atomic grid reduction.
+//
 // During lowering, the index of the global tensor of the TMA expr must be
 // lowered as a kir::TensorIndex whose index has dtype `struct` with name
 // `Hopper::CpAsyncBulkTensorTileIndex`. The first field of this struct is the
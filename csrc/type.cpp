@@ -133,6 +133,13 @@ bool isInclusiveType(const DataType& base_type, const DataType& wider_type) {
       base_type == DataType::Int32) {
     return true;
   }
+  if ((wider_type == DataType::Int || wider_type == DataType::Int32 ||
+       wider_type == DataType::Double || wider_type == DataType::Float ||
+       wider_type == DataType::ComplexDouble ||
+       wider_type == DataType::ComplexFloat) &&
+      base_type == DataType::Int8) {
+    return true;
+  }
   if (wider_type == DataType::ComplexDouble &&
       base_type == DataType::ComplexFloat) {
     return true;
@@ -236,6 +243,8 @@ static std::string data_type2string(DataType t) {
               return "nvfuser_index_t";
             case DataType::Int32:
               return "int";
+            case DataType::Int8:
+              return "int8_t";
             case DataType::UInt:
               return "uint64_t";
             case DataType::UInt32:
@@ -354,6 +363,8 @@ bool needFloatSuffix(UnaryOpType t) {
     case UnaryOpType::ToUnsignedSmemAddr:
     case UnaryOpType::AdjustPartialLdMatrixAddrInTuring8:
     case UnaryOpType::AdjustPartialLdMatrixAddrInTuring16:
+    case UnaryOpType::FastDivMultiplier:
+    case UnaryOpType::FastDivShift:
       return false;
     default:
       return true;
@@ -476,6 +487,10 @@ static const char* unary_op_type2string(UnaryOpType t) {
       return "Turing::adjustPartialLdMatrixAddrInTuring<8>";
     case UnaryOpType::AdjustPartialLdMatrixAddrInTuring16:
       return "Turing::adjustPartialLdMatrixAddrInTuring<16>";
+    case UnaryOpType::FastDivMultiplier:
+      return "fastDivMultiplier";
+    case UnaryOpType::FastDivShift:
+      return "fastDivShift";
     default:
       NVF_ERROR(false, "No string found for unary op type.");
   }
@@ -548,6 +563,8 @@ static const char* binary_op_type2string(BinaryOpType t) {
       return "rshift";
     case BinaryOpType::Gcd:
       return "gcd";
+    case BinaryOpType::UMulHi:
+      return "__umulhi";
 
     // Bitwise Ops
     case BinaryOpType::BitwiseAnd:
@@ -652,6 +669,29 @@ static const char* binary_op_type_inline_op2string(BinaryOpType t) {
   return nullptr;
 }
 
+// The functions that are not CUDA intrinsics are defined in helpers.cu
+static const char* unary_op_type_approx2string(UnaryOpType t) {
+  switch (t) {
+    case UnaryOpType::Cos:
+      return "__cosf";
+    case UnaryOpType::Exp:
+      return "__expf";
+    case UnaryOpType::Log:
+      return "__logf";
+    case UnaryOpType::Reciprocal:
+      return "reciprocal_approx";
+    case UnaryOpType::Rsqrt:
+      return "rsqrt_approx";
+    case UnaryOpType::Sin:
+      return "__sinf";
+    case UnaryOpType::Tanh:
+      return "tanh_approx";
+    default:
+      break;
+  }
+  return nullptr;
+}
+
 static const char* rng_op_type_inline_op2string(RNGOpType t) {
   switch (t) {
     case RNGOpType::Uniform:
@@ -868,6 +908,7 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
     case supported_switch_pair(DataType::Index, DataType::Float):
     case supported_switch_pair(DataType::Int, DataType::Float):
     case supported_switch_pair(DataType::Int32, DataType::Float):
+    case supported_switch_pair(DataType::Int8, DataType::Float):
     case supported_switch_pair(DataType::UInt, DataType::Float):
     case supported_switch_pair(DataType::UInt32, DataType::Float):
     case supported_switch_pair(DataType::Double, DataType::Float):
@@ -878,6 +919,7 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
       return "(float)std::real";
     case supported_switch_pair(DataType::Index, DataType::Int):
     case supported_switch_pair(DataType::Int32, DataType::Int):
+    case supported_switch_pair(DataType::Int8, DataType::Int):
     case supported_switch_pair(DataType::UInt, DataType::Int):
     case supported_switch_pair(DataType::UInt32, DataType::Int):
     case supported_switch_pair(DataType::Float, DataType::Int):
@@ -898,9 +940,22 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
     case supported_switch_pair(DataType::ComplexFloat, DataType::Int32):
     case supported_switch_pair(DataType::ComplexDouble, DataType::Int32):
       return "(int32_t)std::real";
+    case supported_switch_pair(DataType::Index, DataType::Int8):
+    case supported_switch_pair(DataType::Int, DataType::Int8):
+    case supported_switch_pair(DataType::Int32, DataType::Int8):
+    case supported_switch_pair(DataType::UInt, DataType::Int8):
+    case supported_switch_pair(DataType::UInt32, DataType::Int8):
+    case supported_switch_pair(DataType::Float, DataType::Int8):
+    case supported_switch_pair(DataType::Double, DataType::Int8):
+    case supported_switch_pair(DataType::Bool, DataType::Int8):
+      return "(int8_t)";
+    case supported_switch_pair(DataType::ComplexFloat, DataType::Int8):
+    case supported_switch_pair(DataType::ComplexDouble, DataType::Int8):
+      return "(int8_t)std::real";
     case supported_switch_pair(DataType::Index, DataType::UInt):
     case supported_switch_pair(DataType::Int, DataType::UInt):
     case supported_switch_pair(DataType::Int32, DataType::UInt):
+    case supported_switch_pair(DataType::Int8, DataType::UInt):
     case supported_switch_pair(DataType::UInt32, DataType::UInt):
     case supported_switch_pair(DataType::Float, DataType::UInt):
     case supported_switch_pair(DataType::Double, DataType::UInt):
@@ -912,6 +967,7 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
     case supported_switch_pair(DataType::Index, DataType::UInt32):
     case supported_switch_pair(DataType::Int, DataType::UInt32):
     case supported_switch_pair(DataType::Int32, DataType::UInt32):
+    case supported_switch_pair(DataType::Int8, DataType::UInt32):
     case supported_switch_pair(DataType::UInt, DataType::UInt32):
     case supported_switch_pair(DataType::Float, DataType::UInt32):
     case supported_switch_pair(DataType::Double, DataType::UInt32):
@@ -922,6 +978,7 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
       return "(uint32_t)std::real";
     case supported_switch_pair(DataType::Int, DataType::Index):
     case supported_switch_pair(DataType::Int32, DataType::Index):
+    case supported_switch_pair(DataType::Int8, DataType::Index):
     case supported_switch_pair(DataType::UInt, DataType::Index):
     case supported_switch_pair(DataType::UInt32, DataType::Index):
     case supported_switch_pair(DataType::Float, DataType::Index):
@@ -934,6 +991,7 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
     case supported_switch_pair(DataType::Index, DataType::Double):
     case supported_switch_pair(DataType::Int, DataType::Double):
     case supported_switch_pair(DataType::Int32, DataType::Double):
+    case supported_switch_pair(DataType::Int8, DataType::Double):
     case supported_switch_pair(DataType::UInt, DataType::Double):
     case supported_switch_pair(DataType::UInt32, DataType::Double):
     case supported_switch_pair(DataType::Float, DataType::Double):
@@ -947,6 +1005,7 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
     case supported_switch_pair(DataType::Index, DataType::Bool):
     case supported_switch_pair(DataType::Int, DataType::Bool):
     case supported_switch_pair(DataType::Int32, DataType::Bool):
+    case supported_switch_pair(DataType::Int8, DataType::Bool):
     case supported_switch_pair(DataType::UInt, DataType::Bool):
     case supported_switch_pair(DataType::UInt32, DataType::Bool):
       return "(bool)";
@@ -956,6 +1015,7 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
     case supported_switch_pair(DataType::Index, DataType::ComplexDouble):
     case supported_switch_pair(DataType::Int, DataType::ComplexDouble):
     case supported_switch_pair(DataType::Int32, DataType::ComplexDouble):
+    case supported_switch_pair(DataType::Int8, DataType::ComplexDouble):
     case supported_switch_pair(DataType::UInt, DataType::ComplexDouble):
     case supported_switch_pair(DataType::UInt32, DataType::ComplexDouble):
     case supported_switch_pair(DataType::Double, DataType::ComplexDouble):
@@ -966,6 +1026,7 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
     case supported_switch_pair(DataType::Index, DataType::ComplexFloat):
     case supported_switch_pair(DataType::Int, DataType::ComplexFloat):
     case supported_switch_pair(DataType::Int32, DataType::ComplexFloat):
+    case supported_switch_pair(DataType::Int8, DataType::ComplexFloat):
     case supported_switch_pair(DataType::UInt, DataType::ComplexFloat):
     case supported_switch_pair(DataType::UInt32, DataType::ComplexFloat):
     case supported_switch_pair(DataType::Double, DataType::ComplexFloat):
@@ -980,6 +1041,7 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
       return "__double2half";
     case supported_switch_pair(DataType::Int, DataType::Half):
     case supported_switch_pair(DataType::Int32, DataType::Half):
+    case supported_switch_pair(DataType::Int8, DataType::Half):
     case supported_switch_pair(DataType::UInt, DataType::Half):
     case supported_switch_pair(DataType::UInt32, DataType::Half):
     case supported_switch_pair(DataType::Index, DataType::Half):
@@ -1019,6 +1081,7 @@ static const char* supported_casts2string(std::pair<DataType, DataType> t) {
       return "__half2bfloat";
     case supported_switch_pair(DataType::Int, DataType::BFloat16):
     case supported_switch_pair(DataType::Int32, DataType::BFloat16):
+    case supported_switch_pair(DataType::Int8, DataType::BFloat16):
     case supported_switch_pair(DataType::UInt, DataType::BFloat16):
     case supported_switch_pair(DataType::UInt32, DataType::BFloat16):
     case supported_switch_pair(DataType::Index, DataType::BFloat16):
@@ -1111,6 +1174,8 @@ DataType aten_to_data_type(const at::ScalarType& scalar_type) {
       return DataType::Int;
     case at::ScalarType::Int:
       return DataType::Int32;
+    case at::ScalarType::Char:
+      return DataType::Int8;
     case at::ScalarType::ComplexFloat:
       return DataType::ComplexFloat;
     case at::ScalarType::ComplexDouble:
@@ -1147,6 +1212,8 @@ at::ScalarType data_type_to_aten(const DataType& data_type) {
           "There's also this information in FusionExecutorCache and the Registry system.");
     case DataType::Int32:
       return at::ScalarType::Int;
+    case DataType::Int8:
+      return at::ScalarType::Char;
     case DataType::ComplexFloat:
       return at::ScalarType::ComplexFloat;
     case DataType::ComplexDouble:
@@ -1177,12 +1244,32 @@ std::ostream& operator<<(std::ostream& out, const BinaryOpType botype) {
 }
 
 std::ostream& operator<<(std::ostream& out, const ScatterOpType sotype) {
-  if (sotype == ScatterOpType::Set) {
-    return out << "scatter";
+  switch (sotype) {
+    case ScatterOpType::Set:
+      return out << "scatter";
+    case ScatterOpType::Add:
+      return out << "scatter_add";
   }
   NVF_ERROR(false, "No scatterOp type found for scatterOp.");
 }
 
+std::ostream& operator<<(std::ostream& out, const ScanOpType sotype) {
+  switch (sotype) {
+    case ScanOpType::Add:
+      return out << "cumsum";
+    case ScanOpType::Mul:
+      return out << "cumprod";
+    case ScanOpType::Max:
+      return out << "cummax";
+    case ScanOpType::Min:
+      return out << "cummin";
+    case ScanOpType::LogSumExp:
+      return out << "logcumsumexp";
+    default:
+      NVF_ERROR(false, "No scan type found for scanOp.");
+  }
+}
+
 std::ostream& operator<<(std::ostream& out, const TernaryOpType totype) {
   return out << ternary_op_type2string(totype);
 }
@@ -1325,6 +1412,12 @@ std::optional<std::string> inline_op_str(const RNGOpType rngtype) {
                         : std::nullopt;
 }
 
+std::optional<std::string> approx_func_str(const UnaryOpType uotype) {
+  const char* str = unary_op_type_approx2string(uotype);
+  return str != nullptr ? std::optional<std::string>(std::string(str))
+                        : std::nullopt;
+}
+
 std::optional<std::string> integer_op_str(const BinaryOpType botype) {
   const char* str = binary_op_integer_op2string(botype);
   return str != nullptr ? std::optional<std::string>(std::string(str))
@@ -1372,6 +1465,7 @@ std::string typePrefix(const DataType data_type) {
     case DataType::Index:
     case DataType::Int:
     case DataType::Int32:
+    case DataType::Int8:
     case DataType::UInt:
     case DataType::UInt32:
     case DataType::SMemAddress:
@@ -75,6 +75,7 @@ enum class PrimDataType {
   // Integral types
   Int,
   Int32,
+  Int8,
   UInt,
   UInt32,
   Index,
@@ -182,6 +183,7 @@ struct DataType {
   static constexpr PrimDataType Int = PrimDataType::Int;
   static constexpr PrimDataType Index = PrimDataType::Index;
   static constexpr PrimDataType Int32 = PrimDataType::Int32;
+  static constexpr PrimDataType Int8 = PrimDataType::Int8;
   static constexpr PrimDataType UInt = PrimDataType::UInt;
   static constexpr PrimDataType UInt32 = PrimDataType::UInt32;
   static constexpr PrimDataType Bool = PrimDataType::Bool;
@@ -265,6 +267,7 @@ inline bool isIntegralType(DataType dtype) {
             case DataType::Index:
             case DataType::Int:
             case DataType::Int32:
+            case DataType::Int8:
             case DataType::UInt:
             case DataType::UInt32:
               return true;
@@ -394,6 +397,10 @@ DEFINE_DATATYPE_TO_ATEN_AND_NATIVE_TYPE(
     DataType::Int32,
     at::ScalarType::Int,
     int);
+DEFINE_DATATYPE_TO_ATEN_AND_NATIVE_TYPE(
+    DataType::Int8,
+    at::ScalarType::Char,
+    int8_t);
 DEFINE_DATATYPE_TO_NATIVE_TYPE(DataType::UInt, uint64_t);
 DEFINE_DATATYPE_TO_NATIVE_TYPE(DataType::UInt32, uint32_t);
 DEFINE_DATATYPE_TO_ATEN_AND_NATIVE_TYPE(
@@ -594,7 +601,9 @@ enum class UnaryOpType {
   // Special unary ops
   ToUnsignedSmemAddr,
   AdjustPartialLdMatrixAddrInTuring8,
-  AdjustPartialLdMatrixAddrInTuring16
+  AdjustPartialLdMatrixAddrInTuring16,
+  FastDivMultiplier,
+  FastDivShift
 };
 
 // TODO: Order of this list is important as it affects type promotion. it's not
@@ -620,6 +629,7 @@ enum class BinaryOpType {
   Lshift,
   Rshift,
   Gcd,
+  UMulHi,
 
   // Bitwise Ops
   // These always return integers, as if each arg is first cast to int
@@ -646,7 +656,11 @@ enum class BinaryOpType {
   Complex
 };
 
-enum class ScatterOpType { Set };
+enum class ScatterOpType { Set, Add };
+
+// Combining operator of the inclusive prefix scan of ScanOp. LogSumExp
+// combines a and b into log(exp(a) + exp(b)).
+enum class ScanOpType { Add, Mul, Max, Min, LogSumExp };
 
 enum class RNGOpType {
   Uniform, // Uniform in [0, 1)
@@ -796,6 +810,7 @@ ValType promoteType(const ValType& t1, const ValType& t2);
   HANDLE_TYPE_PROMOTION(Type1, double);              \
   HANDLE_TYPE_PROMOTION(Type1, int64_t);             \
   HANDLE_TYPE_PROMOTION(Type1, int);                 \
+  HANDLE_TYPE_PROMOTION(Type1, int8_t);              \
   HANDLE_TYPE_PROMOTION(Type1, bool);                \
   HANDLE_TYPE_PROMOTION(Type1, std::complex<float>); \
   HANDLE_TYPE_PROMOTION(Type1, std::complex<double>)
@@ -836,6 +851,7 @@ inline DataType promoteType(const DataType& t1, const DataType& t2) {
   HANDLE_TYPE_PROMOTION1(double);
   HANDLE_TYPE_PROMOTION1(int64_t);
   HANDLE_TYPE_PROMOTION1(int);
+  HANDLE_TYPE_PROMOTION1(int8_t);
   HANDLE_TYPE_PROMOTION1(bool);
   HANDLE_TYPE_PROMOTION1(std::complex<float>);
   HANDLE_TYPE_PROMOTION1(std::complex<double>);
@@ -899,6 +915,7 @@ std::ostream& operator<<(std::ostream&, const UnaryOpType);
 NVF_API std::ostream& operator<<(std::ostream&, const BinaryOpType);
 std::ostream& operator<<(std::ostream&, const TernaryOpType);
 std::ostream& operator<<(std::ostream&, const ScatterOpType);
+std::ostream& operator<<(std::ostream&, const ScanOpType);
 std::ostream& operator<<(std::ostream&, const RNGOpType);
 NVF_API std::ostream& operator<<(std::ostream&, const ParallelType);
 NVF_API std::ostream& operator<<(std::ostream&, const MemoryType);
@@ -932,6 +949,8 @@ NVF_API bool isParallelTypeVectorize(ParallelType);
 std::optional<std::string> inline_op_str(const UnaryOpType);
 std::optional<std::string> inline_op_str(const BinaryOpType);
 std::optional<std::string> inline_op_str(const RNGOpType);
+//! The fast approximation of a UnaryOp of Float, if the hardware has one
+std::optional<std::string> approx_func_str(const UnaryOpType);
 std::optional<std::string> integer_op_str(const BinaryOpType);
 std::optional<std::string> bool_op_str(const BinaryOpType);
 const char* predicate_type2string(PredicateType t);
@@ -966,6 +985,8 @@ constexpr inline size_t primDataTypeSize(PrimDataType type) {
       return sizeof(int64_t);
     case DataType::Int32:
       return sizeof(int32_t);
+    case DataType::Int8:
+      return sizeof(int8_t);
     case DataType::UInt:
       return sizeof(uint64_t);
     case DataType::UInt32:
@@ -12,8 +12,11 @@
 #include <options.h>
 #include <utils.h>
 
+#include <atomic>
+#include <condition_variable>
 #include <cstdlib>
 #include <iostream>
+#include <mutex>
 #include <optional>
 
 namespace nvfuser {
@@ -37,6 +40,45 @@ c10::ThreadPool* getThreadPool() {
   return &pool;
 }
 
+void runOnThreadPool(int64_t n, const std::function<void(int64_t)>& work) {
+  struct State {
+    std::atomic<int64_t> next{0};
+    std::mutex mutex;
+    std::condition_variable done;
+    int64_t num_done = 0;
+    std::exception_ptr error;
+  };
+  auto state = std::make_shared<State>();
+  // Tasks only call work for the indices they take before all the work is
+  // done, so the ones that start late never use the reference to work
+  auto run_remaining = [state, n, &work]() {
+    for (int64_t i = state->next++; i < n; i = state->next++) {
+      std::exception_ptr error;
+      try {
+        work(i);
+      } catch (...) {
+        error = std::current_exception();
+      }
+      std::lock_guard<std::mutex> lock(state->mutex);
+      if (error != nullptr && state->error == nullptr) {
+        state->error = error;
+      }
+      if (++state->num_done == n) {
+        state->done.notify_all();
+      }
+    }
+  };
+  for (int64_t i = 1; i < n; i++) {
+    getThreadPool()->run(run_remaining);
+  }
+  run_remaining();
+  std::unique_lock<std::mutex> lock(state->mutex);
+  state->done.wait(lock, [&state, n]() { return state->num_done == n; });
+  if (state->error != nullptr) {
+    std::rethrow_exception(state->error);
+  }
+}
+
 C10_DIAGNOSTIC_PUSH_AND_IGNORED_IF_DEFINED("-Wunused-function")
 void debugPrint(const c10::TensorTypePtr& type) {
   std::stringstream sizes_s;
@@ -20,6 +20,7 @@
 
 #include <c10/core/thread_pool.h>
 #include <deque>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <regex>
@@ -52,6 +53,15 @@ namespace nvfuser {
 int getNumThreads();
 c10::ThreadPool* getThreadPool();
 
+//! Runs work(i) for each i in [0, n) on getThreadPool(). The calling thread
+//! runs work too, and only waits for the work already taken by the pool, so
+//! this can't deadlock when called from a task of the pool, e.g., while
+//! deserializing fusions or compiling segments in parallel. The first
+//! exception thrown by work is rethrown once all the work is done.
+NVF_API void runOnThreadPool(
+    int64_t n,
+    const std::function<void(int64_t)>& work);
+
 void debugPrint(const c10::TensorTypePtr& type);
 
 bool is_zero_dim_tensor(const std::shared_ptr<c10::TensorType>& tensor_type);
@@ -513,6 +523,19 @@ class KernelIndexTypeCompute {
     return getType();
   }
 
+  //! Largest size of a dimension of the given stride that addDim can add
+  //! while keeping 32-bit indexing
+  inline int64_t maxSizeOfNextDim(int64_t stride) const {
+    if (tensor_most_positive_index_ > most_positive_int32_index) {
+      return 0;
+    }
+    if (stride <= 0) {
+      return std::numeric_limits<int64_t>::max();
+    }
+    return (most_positive_int32_index - tensor_most_positive_index_) / stride +
+        1;
+  }
+
   inline PrimDataType getType() const {
     if (tensor_most_positive_index_ > most_positive_int32_index) {
       return PrimDataType::Int;
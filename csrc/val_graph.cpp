@@ -515,21 +515,44 @@ void ValGraph::mapExprs(Expr* expr0, Expr* expr1) {
 
   const ExprGroup& expr_new_group = toGroup(expr0);
 
+  // Only the groups of the inputs and outputs of the merged exprs can have
+  // them as uses or definitions, so there's no need to look at all groups
+  ValGroups producer_groups;
+  ValGroups consumer_groups;
+  for (Expr* expr : *expr_new_group) {
+    for (Val* inp : expr->inputs()) {
+      if (disjoint_vals_.mappingExists(inp)) {
+        producer_groups.pushBack(toGroup(inp));
+      }
+    }
+    for (Val* out : expr->outputs()) {
+      if (disjoint_vals_.mappingExists(out)) {
+        consumer_groups.pushBack(toGroup(out));
+      }
+    }
+  }
+
+  auto replace_orig_groups = [&](ExprGroups& expr_groups) {
+    if (expr_groups.has(expr0_orig_group) ||
+        expr_groups.has(expr1_orig_group)) {
+      expr_groups.erase(expr0_orig_group);
+      expr_groups.erase(expr1_orig_group);
+      expr_groups.pushBack(expr_new_group);
+    }
+  };
+
   // Update unique uses
-  for (auto& [producer_group, use_groups] : unique_uses_) {
-    if (use_groups.has(expr0_orig_group) || use_groups.has(expr1_orig_group)) {
-      use_groups.erase(expr0_orig_group);
-      use_groups.erase(expr1_orig_group);
-      use_groups.pushBack(expr_new_group);
+  for (const ValGroup& producer_group : producer_groups) {
+    if (auto it = unique_uses_.find(producer_group); it != unique_uses_.end()) {
+      replace_orig_groups(it->second);
     }
   }
 
   // Update unique definitions
-  for (auto& [consumer_group, def_groups] : unique_definitions_) {
-    if (def_groups.has(expr0_orig_group) || def_groups.has(expr1_orig_group)) {
-      def_groups.erase(expr0_orig_group);
-      def_groups.erase(expr1_orig_group);
-      def_groups.pushBack(expr_new_group);
+  for (const ValGroup& consumer_group : consumer_groups) {
+    if (auto it = unique_definitions_.find(consumer_group);
+        it != unique_definitions_.end()) {
+      replace_orig_groups(it->second);
     }
   }
 }
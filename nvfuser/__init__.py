@@ -2,6 +2,7 @@
 # All rights reserved.
 # SPDX-License-Identifier: BSD-3-Clause
 
+import itertools
 import logging
 import os
 import re
@@ -9,6 +10,7 @@ import sys
 from typing import Optional, Union, List  # noqa: F401
 
 import torch
+import torch.utils.dlpack
 
 # This is needed when libnvfuser.so is patched and doesn't have the pytorch library location available.
 pytorch_lib_dir = os.path.join(os.path.dirname(torch.__file__), "lib")
@@ -32,6 +34,10 @@ from . import contrib  # noqa: F401
 
 logger = logging.getLogger("nvfuser")
 
+# Unique keys of the schedule functions of FusionDefinition child classes.
+# Unlike id(), a key is never reused by another function.
+_schedule_keys = itertools.count()
+
 
 # Register automatic serialization of Nvfuser cache hierarchy and cuda kernels.
 def enable_automatic_serialization():
@@ -76,6 +82,9 @@ class FusionDefinition(_C._FusionDefinition):
         device=None,
         override_user_schedule=False,
         capture_debug_output=False,
+        out=None,
+        as_dlpack=False,
+        profile=False,
     ):
         """
         Executes an nvFuser set of kernels for a given Fusion
@@ -97,6 +106,9 @@ class FusionDefinition(_C._FusionDefinition):
 
         Args:
             inputs (List[Union[Tensor, Scalar]]): A list of inputs to fusion.
+                Besides torch tensors, input tensors can be arrays of any
+                framework implementing the DLPack protocol, e.g. CuPy or JAX
+                arrays, which are used without copying their memory.
 
         Kwargs:
             override_user_schedule (bool): For a user defined schedule,
@@ -114,9 +126,24 @@ class FusionDefinition(_C._FusionDefinition):
                 debugging information as a string. If True, the string can be
                 retrieved after execution using :meth:`get_debug_output`. If False,
                 then that method will return None when called.
+            out (Optional[List[Optional[Tensor]]]): Preallocated tensors, one
+                for each output of the fusion, to write the results into. An
+                entry of None is allocated by nvFuser. Each tensor must have
+                the sizes, strides, dtype and device nvFuser would allocate
+                the output with. The returned list holds the given tensors.
+                Like inputs, these can be DLPack arrays.
+            as_dlpack (bool): Whether to return the outputs as DLPack capsules
+                instead of tensors, which other frameworks can consume without
+                copying, e.g. with `cupy.from_dlpack`. (default: False)
+            profile (bool): Whether to profile the execution, after which
+                :meth:`profile` returns the FusionProfile with the time,
+                bandwidth, scheduler and launch parameters of the kernel of
+                each segment and the compile time breakdown. Other fusions
+                must not be executed concurrently. User schedules are not
+                profiled. (default: False)
 
         Returns:
-            List[Tensor]
+            List[Tensor], or List[PyCapsule] if as_dlpack is True
         """
         func_based_def = False
 
@@ -136,10 +163,16 @@ class FusionDefinition(_C._FusionDefinition):
             func_based_def = True
 
         # If schedule is defined by child class, make a schedule for inputs
+        # unless one made by the same schedule function is already compiled
         if func_based_def and (super(type(self), self).schedule != self.schedule):
-            self._setup_schedule(inputs)
-            self.schedule()
-            self._finalize_schedule(inputs)
+            schedule_fn = type(self).schedule
+            if not hasattr(schedule_fn, "_nvf_schedule_key"):
+                schedule_fn._nvf_schedule_key = next(_schedule_keys)
+            schedule_key = schedule_fn._nvf_schedule_key
+            if not self._exist_schedule(inputs, schedule_key):
+                self._setup_schedule(inputs, schedule_key)
+                self.schedule()
+                self._finalize_schedule(inputs)
 
         result = None
         try:
@@ -148,6 +181,8 @@ class FusionDefinition(_C._FusionDefinition):
                 override_user_schedule,
                 device=device,
                 capture_debug_output=capture_debug_output,
+                out=out,
+                profile=profile,
             )
         except Exception as err:
             msg = (
@@ -167,6 +202,8 @@ class FusionDefinition(_C._FusionDefinition):
                 "inputs = [\n"
             )
             for i in inputs:
+                if not isinstance(i, torch.Tensor) and hasattr(i, "__dlpack__"):
+                    i = torch.utils.dlpack.from_dlpack(i)
                 if isinstance(i, torch.Tensor):
                     # max linear index determines number of elements to generate
                     sz = 1
@@ -205,8 +242,84 @@ class FusionDefinition(_C._FusionDefinition):
             logger.exception(msg)
             raise
 
+        if as_dlpack:
+            return [torch.utils.dlpack.to_dlpack(t) for t in result]
         return result
 
+    def precompile(self, inputs_list, *, device=None):
+        """
+        Compiles kernels for each of the given sets of inputs ahead of time
+
+        Inputs with the same signature as one of the given sets, e.g. the same
+        shapes, strides and dtypes, can later be executed without waiting for
+        compilation. Kernels are compiled concurrently. Only the properties of
+        input tensors are used, so they can be created with `torch.empty`.
+        User schedules are not precompiled.
+
+        Args:
+            inputs_list (List[List[Union[Tensor, Scalar]]]): A list of input
+                sets, each of which is a list of inputs to fusion.
+
+        Kwargs:
+            device (Optional[Union[int, str, torch.device]]): See `execute`.
+
+        Returns:
+            int: the number of newly compiled kernel runtimes
+        """
+        if device is not None:
+            if not isinstance(device, torch.device):
+                device = torch.device(device)
+            assert (
+                device.type == "cuda"
+            ), "If device argument is passed it must be a CUDA device"
+            device = device.index
+
+        # if definition is not defined by a context manager, try a child class
+        if self.id() is None:
+            self._setup_definition()
+            self.definition()
+            self._finalize_definition()
+
+        return self._precompile(inputs_list, device=device)
+
+    def execute_async(self, inputs, *, stream=None):
+        """
+        Executes an nvFuser set of kernels for a given Fusion without waiting
+        for them to finish
+
+        The kernels are launched on `stream`, and the outputs are allocated
+        in its order. Kernels that are not compiled yet are compiled in the
+        background while the fusion is evaluated with ATen, so the call doesn't
+        wait for compilation. User schedules are not supported.
+
+        Args:
+            inputs (List[Union[Tensor, Scalar]]): A list of inputs to fusion.
+
+        Kwargs:
+            stream (Optional[torch.cuda.Stream]): The stream to execute the
+                fusion on, by default the current stream of the device of the
+                first CUDA input tensor.
+
+        Returns:
+            FusionFuture: `done()` tells whether the fusion has finished,
+                `result()` waits for it and returns the outputs, and
+                `wait_on(stream)` makes another stream wait for it.
+        """
+        # if definition is not defined by a context manager, try a child class
+        if self.id() is None:
+            self._setup_definition()
+            self.definition()
+            self._finalize_definition()
+
+        if stream is None:
+            cuda_inputs = [
+                i for i in inputs if isinstance(i, torch.Tensor) and i.is_cuda
+            ]
+            device = cuda_inputs[0].device if cuda_inputs else None
+            stream = torch.cuda.current_stream(device)
+
+        return self._execute_async(inputs, stream)
+
     def debug_output(self):
         """
         Retrieve string of captured debug information from the previous execution.
@@ -327,6 +440,27 @@ class FusionDefinition(_C._FusionDefinition):
             inputs, tensor_transforms, override_user_schedule
         )
 
+    def sweep_launch_configs(self, inputs, max_candidates=64, print_table=True):
+        """
+        Benchmarks the auto-generated schedules for the given inputs with
+        other heuristic parameters, e.g., block dimensions, unroll factors and
+        persistent batches. Each segment is compiled with up to max_candidates
+        parameter sets, which are timed one at a time. The cached kernels are
+        not changed.
+
+        Args:
+            inputs (List[Union[Tensor, Scalar]]): A list of inputs to fusion.
+            max_candidates (Int): The maximum number of candidates per segment. (default: 64)
+            print_table (Bool): Print the results as a table per segment, with the pareto-optimal candidates in time and occupancy marked by a *. (default: True)
+
+        Returns:
+            List[LaunchConfigSweepResult]
+        """
+        results = self._sweep_launch_configs(inputs, max_candidates)
+        if print_table:
+            print(launch_config_sweep_table(results))
+        return results
+
     def validate(
         self,
         inputs: List[torch.Tensor],
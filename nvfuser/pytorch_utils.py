@@ -19,6 +19,7 @@ _torch_dtype_to_nvfuser_dtype_map = {
     torch.float8_e5m2: DataType.Float8_e5m2,
     torch.long: DataType.Int,
     torch.int: DataType.Int32,
+    torch.int8: DataType.Int8,
     torch.bool: DataType.Bool,
     # Python scalars
     complex: DataType.ComplexDouble,
@@ -75,6 +75,10 @@ __device__ void loadGeneric(scalar_t* to, scalar_t* from) {
     case 16:
       *reinterpret_cast<uint4*>(to) = *reinterpret_cast<uint4*>(from);
       break;
+    case 32:
+      reinterpret_cast<uint4*>(to)[0] = reinterpret_cast<uint4*>(from)[0];
+      reinterpret_cast<uint4*>(to)[1] = reinterpret_cast<uint4*>(from)[1];
+      break;
   }
 }
 
@@ -167,6 +171,47 @@ __device__ void loadLocalToGlobal(
       }
       break;
     }
+    case 32: {
+      // Blackwell has 256-bit stores, older archs store it in two halves
+      uint4 const* data = reinterpret_cast<uint4*>(from);
+      auto to_ptr = (typename MaybeVolatile<uint4, is_volatile>::type*)to;
+#if __CUDA_ARCH__ >= 1000
+      if (!is_volatile) {
+        asm volatile(
+            "st.global.cs.v8.b32 [%0], {%1,%2,%3,%4,%5,%6,%7,%8};" ::"l"(
+                to_ptr),
+            "r"(data[0].x),
+            "r"(data[0].y),
+            "r"(data[0].z),
+            "r"(data[0].w),
+            "r"(data[1].x),
+            "r"(data[1].y),
+            "r"(data[1].z),
+            "r"(data[1].w));
+        break;
+      }
+#endif
+#pragma unroll
+      for (int i = 0; i < 2; ++i) {
+        if (is_volatile) {
+          asm volatile(
+              "st.volatile.global.v4.s32 [%0], {%1,%2,%3,%4};" ::"l"(
+                  to_ptr + i),
+              "r"(data[i].x),
+              "r"(data[i].y),
+              "r"(data[i].z),
+              "r"(data[i].w));
+        } else {
+          asm volatile(
+              "st.global.cs.v4.s32 [%0], {%1,%2,%3,%4};" ::"l"(to_ptr + i),
+              "r"(data[i].x),
+              "r"(data[i].y),
+              "r"(data[i].z),
+              "r"(data[i].w));
+        }
+      }
+      break;
+    }
   }
 }
 
@@ -194,6 +239,45 @@ __device__ void loadGlobalToLocalCached(void* to, void* from) {
   }
 }
 
+#define NVFUSER_LD_GLOBAL_V8(cache_op_str)                                   \
+  asm volatile("ld.global." cache_op_str                                     \
+               ".v8.b32 {%0,%1,%2,%3,%4,%5,%6,%7}, [%8];"                    \
+               : "=r"(data[0].x),                                            \
+                 "=r"(data[0].y),                                            \
+                 "=r"(data[0].z),                                            \
+                 "=r"(data[0].w),                                            \
+                 "=r"(data[1].x),                                            \
+                 "=r"(data[1].y),                                            \
+                 "=r"(data[1].z),                                            \
+                 "=r"(data[1].w)                                             \
+               : "l"(from))
+
+// 256-bit load, which is a single instruction on Blackwell and two 128-bit
+// loads on older archs
+template <CacheOp cache_op>
+__device__ void loadGlobalToLocalCached256(void* to, void* from) {
+#if __CUDA_ARCH__ >= 1000
+  uint4* data = reinterpret_cast<uint4*>(to);
+  switch (cache_op) {
+    case CacheOp::AllLevels:
+      NVFUSER_LD_GLOBAL_V8("ca");
+      break;
+    case CacheOp::Streaming:
+      NVFUSER_LD_GLOBAL_V8("cs");
+      break;
+    case CacheOp::Global:
+      NVFUSER_LD_GLOBAL_V8("cg");
+      break;
+  }
+#else
+  loadGlobalToLocalCached<uint4, cache_op>(to, from);
+  loadGlobalToLocalCached<uint4, cache_op>(
+      reinterpret_cast<uint4*>(to) + 1, reinterpret_cast<uint4*>(from) + 1);
+#endif
+}
+
+#undef NVFUSER_LD_GLOBAL_V8
+
 // For simplicity, cache_op is only used for non-volatile loads written in
 // inline assembly. Other loads are done with the default cache operator --
 // cache all levels. ld.volatile doesn't accept cache operator anyway.
@@ -231,6 +315,24 @@ __device__ void loadGlobalToLocal(
       }
       break;
     }
+    case 32: {
+      if (is_volatile) {
+        uint4* data = reinterpret_cast<uint4*>(to);
+        auto from_ptr = (uint4*)from;
+#pragma unroll
+        for (int i = 0; i < 2; ++i) {
+          asm volatile("ld.volatile.global.v4.s32 {%0,%1,%2,%3}, [%4];"
+                       : "=r"(data[i].x),
+                         "=r"(data[i].y),
+                         "=r"(data[i].z),
+                         "=r"(data[i].w)
+                       : "l"(from_ptr + i));
+        }
+      } else {
+        loadGlobalToLocalCached256<cache_op>(to, const_cast<scalar_t*>(from));
+      }
+      break;
+    }
   }
 }
 
@@ -276,5 +378,17 @@ __device__ void loadGlobalToGlobal(
           to, reinterpret_cast<scalar_t*>(&local_intermediate));
       break;
     }
+    case 32: {
+      uint4 local_intermediate[2];
+      loadGlobalToLocal<
+          scalar_t,
+          vec_size,
+          is_volatile_from,
+          CacheOp::Streaming>(
+          reinterpret_cast<scalar_t*>(local_intermediate), from);
+      loadLocalToGlobal<scalar_t, vec_size, is_volatile_to>(
+          to, reinterpret_cast<scalar_t*>(local_intermediate));
+      break;
+    }
   }
 }
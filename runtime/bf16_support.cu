@@ -229,3 +229,66 @@ __device__ __inline__ __bfloat __real_then_2bfloat(
     const std::complex<double> c) {
   return __double2bfloat(std::real(c));
 }
+
+// Arithmetic of the pointwise chains that are computed in bfloat16, see
+// EnableOption::ReducedPrecisionPointwise. add and sub of bf16 need sm_90, so
+// sm_80 uses fma with 1.0 (0x3f80), -1.0 (0xbf80) and -0.0 (0x8000) instead.
+__device__ __inline__ __bfloat operator+(const __bfloat a, const __bfloat b) {
+#if __CUDA_ARCH__ >= 900
+  __bfloat val;
+  asm("{  add.rn.bf16 %0, %1, %2;}\n"
+      : "=h"(__NVFUSER_BFLOAT_TO_US(val))
+      : "h"(__NVFUSER_BFLOAT_TO_CUS(a)), "h"(__NVFUSER_BFLOAT_TO_CUS(b)));
+  return val;
+#elif __CUDA_ARCH__ >= 800
+  __bfloat val;
+  asm("{  .reg .b16 one;\n"
+      "  mov.b16 one, 0x3f80U;\n"
+      "  fma.rn.bf16 %0, %1, one, %2;}\n"
+      : "=h"(__NVFUSER_BFLOAT_TO_US(val))
+      : "h"(__NVFUSER_BFLOAT_TO_CUS(a)), "h"(__NVFUSER_BFLOAT_TO_CUS(b)));
+  return val;
+#else
+  return __float2bfloat(__bfloat2float(a) + __bfloat2float(b));
+#endif
+}
+
+__device__ __inline__ __bfloat operator-(const __bfloat a, const __bfloat b) {
+#if __CUDA_ARCH__ >= 900
+  __bfloat val;
+  asm("{  sub.rn.bf16 %0, %1, %2;}\n"
+      : "=h"(__NVFUSER_BFLOAT_TO_US(val))
+      : "h"(__NVFUSER_BFLOAT_TO_CUS(a)), "h"(__NVFUSER_BFLOAT_TO_CUS(b)));
+  return val;
+#elif __CUDA_ARCH__ >= 800
+  __bfloat val;
+  asm("{  .reg .b16 neg_one;\n"
+      "  mov.b16 neg_one, 0xbf80U;\n"
+      "  fma.rn.bf16 %0, %2, neg_one, %1;}\n"
+      : "=h"(__NVFUSER_BFLOAT_TO_US(val))
+      : "h"(__NVFUSER_BFLOAT_TO_CUS(a)), "h"(__NVFUSER_BFLOAT_TO_CUS(b)));
+  return val;
+#else
+  return __float2bfloat(__bfloat2float(a) - __bfloat2float(b));
+#endif
+}
+
+__device__ __inline__ __bfloat operator*(const __bfloat a, const __bfloat b) {
+#if __CUDA_ARCH__ >= 900
+  __bfloat val;
+  asm("{  mul.rn.bf16 %0, %1, %2;}\n"
+      : "=h"(__NVFUSER_BFLOAT_TO_US(val))
+      : "h"(__NVFUSER_BFLOAT_TO_CUS(a)), "h"(__NVFUSER_BFLOAT_TO_CUS(b)));
+  return val;
+#elif __CUDA_ARCH__ >= 800
+  __bfloat val;
+  asm("{  .reg .b16 neg_zero;\n"
+      "  mov.b16 neg_zero, 0x8000U;\n"
+      "  fma.rn.bf16 %0, %1, %2, neg_zero;}\n"
+      : "=h"(__NVFUSER_BFLOAT_TO_US(val))
+      : "h"(__NVFUSER_BFLOAT_TO_CUS(a)), "h"(__NVFUSER_BFLOAT_TO_CUS(b)));
+  return val;
+#else
+  return __float2bfloat(__bfloat2float(a) * __bfloat2float(b));
+#endif
+}
@@ -0,0 +1,83 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+
+// Thread block clusters and distributed shared memory.
+//
+// Reference:
+// https://docs.nvidia.com/cuda/cuda-c-programming-guide/index.html#thread-block-clusters
+// https://docs.nvidia.com/cuda/parallel-thread-execution/index.html#cluster-dimension-special-registers
+
+#if (defined(__CUDA_ARCH__) && (__CUDA_ARCH__ >= 900))
+
+namespace cluster {
+
+// Index of this block within its cluster
+__device__ inline dim3 blockIdxInCluster() {
+  uint32_t x, y, z;
+  asm volatile("mov.u32 %0, %%cluster_ctaid.x;\n" : "=r"(x));
+  asm volatile("mov.u32 %0, %%cluster_ctaid.y;\n" : "=r"(y));
+  asm volatile("mov.u32 %0, %%cluster_ctaid.z;\n" : "=r"(z));
+  return dim3(x, y, z);
+}
+
+// Number of blocks of a cluster
+__device__ inline dim3 clusterDim() {
+  uint32_t x, y, z;
+  asm volatile("mov.u32 %0, %%cluster_nctaid.x;\n" : "=r"(x));
+  asm volatile("mov.u32 %0, %%cluster_nctaid.y;\n" : "=r"(y));
+  asm volatile("mov.u32 %0, %%cluster_nctaid.z;\n" : "=r"(z));
+  return dim3(x, y, z);
+}
+
+// Index of the cluster of this block in the grid
+__device__ inline dim3 clusterIdx() {
+  uint32_t x, y, z;
+  asm volatile("mov.u32 %0, %%clusterid.x;\n" : "=r"(x));
+  asm volatile("mov.u32 %0, %%clusterid.y;\n" : "=r"(y));
+  asm volatile("mov.u32 %0, %%clusterid.z;\n" : "=r"(z));
+  return dim3(x, y, z);
+}
+
+// Number of clusters of the grid
+__device__ inline dim3 gridDimInClusters() {
+  uint32_t x, y, z;
+  asm volatile("mov.u32 %0, %%nclusterid.x;\n" : "=r"(x));
+  asm volatile("mov.u32 %0, %%nclusterid.y;\n" : "=r"(y));
+  asm volatile("mov.u32 %0, %%nclusterid.z;\n" : "=r"(z));
+  return dim3(x, y, z);
+}
+
+// Synchronizes all threads of all blocks in the cluster. Shared memory writes
+// before the sync are visible to all blocks of the cluster after it, and no
+// block exits before the others are done accessing its shared memory.
+template <bool Aligned>
+__device__ inline void sync() {
+  if (Aligned) {
+    asm volatile("barrier.cluster.arrive.release.aligned;\n" ::: "memory");
+    asm volatile("barrier.cluster.wait.acquire.aligned;\n" ::: "memory");
+  } else {
+    asm volatile("barrier.cluster.arrive.release;\n" ::: "memory");
+    asm volatile("barrier.cluster.wait.acquire;\n" ::: "memory");
+  }
+}
+
+// Maps ptr, which points to the shared memory of this block, to the same
+// location in the shared memory of the block of the cluster with the given
+// rank. The returned generic address can be accessed like any other pointer.
+template <typename T>
+__device__ inline T* mapSharedRank(T* ptr, uint32_t rank) {
+  uint64_t mapped;
+  asm volatile("mapa.u64 %0, %1, %2;\n"
+               : "=l"(mapped)
+               : "l"(reinterpret_cast<uint64_t>(ptr)), "r"(rank));
+  return reinterpret_cast<T*>(mapped);
+}
+
+} // namespace cluster
+
+#endif // Arch 90
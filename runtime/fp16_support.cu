@@ -157,3 +157,29 @@ __device__ __inline__ __half __real_then_2half(const std::complex<float> c) {
 __device__ __inline__ __half __real_then_2half(const std::complex<double> c) {
   return __double2half(std::real(c));
 }
+
+// Arithmetic of the pointwise chains that are computed in half precision, see
+// EnableOption::ReducedPrecisionPointwise
+__device__ __inline__ __half operator+(const __half a, const __half b) {
+  __half val;
+  asm("{  add.rn.f16 %0, %1, %2;}\n"
+      : "=h"(__NVFUSER_HALF_TO_US(val))
+      : "h"(__NVFUSER_HALF_TO_CUS(a)), "h"(__NVFUSER_HALF_TO_CUS(b)));
+  return val;
+}
+
+__device__ __inline__ __half operator-(const __half a, const __half b) {
+  __half val;
+  asm("{  sub.rn.f16 %0, %1, %2;}\n"
+      : "=h"(__NVFUSER_HALF_TO_US(val))
+      : "h"(__NVFUSER_HALF_TO_CUS(a)), "h"(__NVFUSER_HALF_TO_CUS(b)));
+  return val;
+}
+
+__device__ __inline__ __half operator*(const __half a, const __half b) {
+  __half val;
+  asm("{  mul.rn.f16 %0, %1, %2;}\n"
+      : "=h"(__NVFUSER_HALF_TO_US(val))
+      : "h"(__NVFUSER_HALF_TO_CUS(a)), "h"(__NVFUSER_HALF_TO_CUS(b)));
+  return val;
+}
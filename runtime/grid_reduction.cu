@@ -359,6 +359,168 @@ __device__ void gridReduce(
 }
 #endif // NVFUSER_PROFILE_KERNEL
 
+#if (defined(__CUDA_ARCH__) && (__CUDA_ARCH__ >= 900))
+// Same as gridReduce, but for kernels launched with thread block clusters.
+// The blocks of each cluster are first reduced through distributed shared
+// memory into the last block of the cluster, so only one block per cluster
+// goes through the global work buffer and the semaphore. When a reduction
+// segment fits in a single cluster, global memory is not used at all.
+//
+// All blocks of a cluster must be in the same reduction segment, i.e., the
+// cluster dimensions must be 1 along the block dimensions that are not
+// reduced. Like gridReduce, the results are only valid in the last block of
+// each reduction segment. All threads of the cluster must call this function.
+template <
+    bool X_BLOCK,
+    bool Y_BLOCK,
+    bool Z_BLOCK,
+    bool X_THREAD,
+    bool Y_THREAD,
+    bool Z_THREAD,
+    bool PERSISTENT_REDUCTION,
+    bool Aligned,
+    typename T,
+    typename Func>
+__device__ void clusterGridReduce(
+    T& out,
+    const T& inp_val,
+    Func reduction_op,
+    volatile T* work_buf,
+    int64_t* sync_flags,
+    T* shared_buf,
+    bool read_pred,
+    bool write_pred,
+    T init_val,
+    const nvfuser_index_t entrance_ind,
+    const nvfuser_index_t n_entrances) {
+  T block_reduction_val = init_val;
+
+  // Do block reduction when required
+  if (X_THREAD || Y_THREAD || Z_THREAD) {
+    blockReduce<X_THREAD, Y_THREAD, Z_THREAD, Aligned>(
+        block_reduction_val,
+        inp_val,
+        reduction_op,
+        shared_buf,
+        read_pred,
+        true,
+        init_val);
+  } else if (read_pred) {
+    block_reduction_val = inp_val;
+  }
+
+  // Number of threads we can use in final reduction
+  const auto block_reduction_segment_size =
+      index_utils::maskedSize<!X_THREAD, !Y_THREAD, !Z_THREAD>(blockDim);
+  const auto thread_offset =
+      index_utils::maskedOffset<!X_THREAD, !Y_THREAD, !Z_THREAD>(
+          threadIdx, blockDim);
+  const bool has_block_result = (!X_THREAD || threadIdx.x == 0) &&
+      (!Y_THREAD || threadIdx.y == 0) && (!Z_THREAD || threadIdx.z == 0);
+
+  // Share the block results with the cluster. The block reduction may still
+  // be reading shared_buf.
+  block_sync::sync<Aligned>();
+  if (has_block_result) {
+    shared_buf[thread_offset] = block_reduction_val;
+  }
+  cluster::sync<Aligned>();
+
+  const dim3 cluster_dim = cluster::clusterDim();
+  const bool last_block_in_cluster =
+      index_utils::maskedIsLast<X_BLOCK, Y_BLOCK, Z_BLOCK>(
+          cluster::blockIdxInCluster(), cluster_dim);
+
+  T cluster_reduction_val = init_val;
+  if (last_block_in_cluster && has_block_result) {
+    const uint32_t cluster_size = cluster_dim.x * cluster_dim.y * cluster_dim.z;
+    for (uint32_t rank = 0; rank < cluster_size; ++rank) {
+      reduction_op(
+          cluster_reduction_val,
+          *cluster::mapSharedRank(shared_buf + thread_offset, rank));
+    }
+  }
+  // Keep the shared memory of the other blocks alive and unmodified until the
+  // last block is done reading it
+  cluster::sync<Aligned>();
+
+  const dim3 grid_dim_in_clusters = cluster::gridDimInClusters();
+  const dim3 cluster_idx = cluster::clusterIdx();
+
+  // Number of clusters to reduce in the reduction segment
+  const auto grid_reduction_segment_size =
+      index_utils::maskedSize<X_BLOCK, Y_BLOCK, Z_BLOCK>(grid_dim_in_clusters);
+
+  if (grid_reduction_segment_size == 1) {
+    if (last_block_in_cluster && has_block_result && write_pred) {
+      reduction_op(out, cluster_reduction_val);
+    }
+    return;
+  }
+
+  if (last_block_in_cluster) {
+    // Index of the reduction we're performing out of the
+    // grid_reduction_segment_size
+    const auto idx_in_grid_segment =
+        index_utils::maskedOffset<!X_BLOCK, !Y_BLOCK, !Z_BLOCK>(
+            blockIdx, gridDim);
+
+    // Number of reductions in the grid
+    const nvfuser_index_t grid_segment_size = PERSISTENT_REDUCTION
+        ? 1
+        : index_utils::maskedSize<!X_BLOCK, !Y_BLOCK, !Z_BLOCK>(gridDim);
+
+    // advance to the offset for this segment
+    work_buf += (entrance_ind * grid_segment_size + idx_in_grid_segment) *
+        grid_reduction_segment_size * block_reduction_segment_size;
+
+    if (has_block_result) {
+      auto cluster_offset =
+          index_utils::maskedOffset<X_BLOCK, Y_BLOCK, Z_BLOCK>(
+              cluster_idx, grid_dim_in_clusters);
+      work_buf[cluster_offset * block_reduction_segment_size + thread_offset] =
+          cluster_reduction_val;
+    }
+
+    // Only the last block of each cluster participates, and the last block of
+    // the last cluster is the last block of the segment
+    const bool last_cluster =
+        index_utils::maskedIsLast<X_BLOCK, Y_BLOCK, Z_BLOCK>(
+            cluster_idx, grid_dim_in_clusters);
+    int64_t& semaphore = PERSISTENT_REDUCTION
+        ? sync_flags[idx_in_grid_segment]
+        : sync_flags[entrance_ind * grid_segment_size + idx_in_grid_segment];
+    grid_sync::sync<X_BLOCK, Y_BLOCK, Z_BLOCK, PERSISTENT_REDUCTION, Aligned>(
+        semaphore, grid_reduction_segment_size, last_cluster);
+
+    if (last_cluster) {
+      // Cleanup with block reduction
+      gridReduceLastBlock<!X_THREAD, !Y_THREAD, !Z_THREAD, Aligned>(
+          out,
+          (T*)work_buf,
+          grid_reduction_segment_size,
+          block_reduction_segment_size,
+          reduction_op,
+          shared_buf,
+          write_pred,
+          init_val);
+    }
+
+    if (PERSISTENT_REDUCTION) {
+      // Make sure we're done with global memory before we allow the kernel to
+      // continue
+      grid_sync::sync<X_BLOCK, Y_BLOCK, Z_BLOCK, PERSISTENT_REDUCTION, Aligned>(
+          semaphore, grid_reduction_segment_size, last_cluster);
+    }
+  }
+
+  if (PERSISTENT_REDUCTION) {
+    // The other blocks of the cluster wait for the grid reduction as well
+    cluster::sync<Aligned>();
+  }
+}
+#endif // (defined(__CUDA_ARCH__) && (__CUDA_ARCH__ >= 900))
+
 template <
     bool X_BLOCK,
     bool Y_BLOCK,
@@ -667,6 +829,89 @@ __device__ void serialReductionStep(
   }
 }
 
+// Same as serialReductionStep, but "out" resides in global memory and is used
+// as the work buffer. Every step writes the partial result to "out", so it
+// holds the result after the last step. Unless first_step is true, "out" has
+// to hold the result of the previous step.
+template <int64_t vec_size, typename T, typename Func>
+__device__ void serialReductionStepInPlace(
+    volatile T* out,
+    T* in,
+    T init,
+    Func reduction_op,
+    bool first_step,
+    bool read_pred,
+    bool write_pred) {
+  if (!write_pred) {
+    return;
+  }
+  T out_reg[vec_size];
+  if (read_pred) {
+    loadGeneric<T, vec_size>(out_reg, in);
+  } else {
+#pragma unroll
+    for (int i = 0; i < vec_size; ++i) {
+      out_reg[i] = init;
+    }
+  }
+  if (!first_step) {
+    T work_reg[vec_size];
+    loadGlobalToLocal<T, vec_size, true, CacheOp::Global>(work_reg, out);
+#pragma unroll
+    for (int i = 0; i < vec_size; ++i) {
+      reduction_op(out_reg[i], work_reg[i]);
+    }
+  }
+  loadLocalToGlobal<T, vec_size, true>(out, out_reg);
+}
+
+// Sum reduction across blocks without a work buffer nor grid
+// synchronization. After the block reduction, each block adds its result to
+// out with an atomic addition, so out must be in global memory and
+// initialized to zero before the kernel is launched. The order of the
+// additions is not deterministic, and neither is the result.
+//
+// [X,Y,Z]_THREAD tell which thread dimensions are reduced. Unlike
+// gridReduce, the result is only complete once all the blocks are done, i.e.,
+// after the kernel.
+template <
+    bool X_THREAD,
+    bool Y_THREAD,
+    bool Z_THREAD,
+    bool Aligned,
+    typename T,
+    typename Func>
+__device__ void atomicGridReduce(
+    T& out,
+    const T& inp_val,
+    Func reduction_op,
+    T* shared_buf,
+    bool read_pred,
+    bool write_pred,
+    T init_val) {
+  T block_reduction_val = init_val;
+
+  // Do block reduction when required
+  if (X_THREAD || Y_THREAD || Z_THREAD) {
+    blockReduce<X_THREAD, Y_THREAD, Z_THREAD, Aligned>(
+        block_reduction_val,
+        inp_val,
+        reduction_op,
+        shared_buf,
+        read_pred,
+        true,
+        init_val);
+  } else if (read_pred) {
+    block_reduction_val = inp_val;
+  }
+
+  const bool has_block_result = (!X_THREAD || threadIdx.x == 0) &&
+      (!Y_THREAD || threadIdx.y == 0) && (!Z_THREAD || threadIdx.z == 0);
+  if (has_block_result && write_pred) {
+    atomicAdd(&out, block_reduction_val);
+  }
+}
+
 // vectorized reduction
 template <
     bool X_THREAD,
@@ -15,6 +15,31 @@ __device__ T globalAsVolatile(volatile T& global_val) {
   return global_val;
 }
 
+#if __CUDA_ARCH__ >= 700
+// Adds to the semaphore with release semantics, so that the preceding
+// accesses of the block, which are ordered before this by a block sync, are
+// visible to whoever acquires the new value
+__device__ uint64_t semaphoreAddRelease(int64_t& semaphore, uint64_t val) {
+  uint64_t old = 0;
+  asm volatile("atom.add.release.gpu.u64 %0, [%1], %2;\n"
+               : "=l"(old)
+               : "l"(&semaphore), "l"(val)
+               : "memory");
+  return old;
+}
+
+// Reads the semaphore with acquire semantics, so that the accesses following
+// this see those released by the other blocks
+__device__ int64_t semaphoreLoadAcquire(int64_t& semaphore) {
+  int64_t val = 0;
+  asm volatile("ld.acquire.gpu.b64 %0, [%1];\n"
+               : "=l"(val)
+               : "l"(&semaphore)
+               : "memory");
+  return val;
+}
+#endif
+
 // A grid synchronization that can be called multiple times in a kernel assuming
 // all the blocks fit on device at once. The semaphore is an integer semaphore
 // assumed to be initialized to 0 before launching the kernel. The persistent
@@ -34,10 +59,14 @@ __device__ void sync(
     int64_t& semaphore,
     const uint64_t& segment_size,
     const bool last_block) {
+#if __CUDA_ARCH__ < 700
   // Finish all global memory transactions before synchronizing
   __threadfence();
+#endif
 
-  // Synchronize all threads in a block before synchronizing blocks
+  // Synchronize all threads in a block before synchronizing blocks. From
+  // sm_70 on, the arrival of the block releases its accesses instead of a
+  // fence of every thread.
   block_sync::sync<Aligned>();
 
   // Only allow linear_tid == 0 to participate in the synchronization
@@ -55,15 +84,23 @@ __device__ void sync(
       semaphore_increment = FIRST_UINT64_BIT - (segment_size - 1);
     }
 
+#if __CUDA_ARCH__ >= 700
+    uint64_t oldArrive = semaphoreAddRelease(semaphore, semaphore_increment);
+#else
     uint64_t oldArrive =
         atomicAdd(reinterpret_cast<uint64_t*>(&semaphore), semaphore_increment);
+#endif
 
     // If for persistent kernels, lock all blocks until the semaphore has been
-    // reached. Make sure we access semaphore as a volatile address so we get
-    // the global memory updates.
+    // reached. Make sure we access semaphore as a volatile address, or with
+    // acquire semantics, so we get the global memory updates.
     unsigned int ns = 8;
     while ((PERSISTENT || last_block) &&
+#if __CUDA_ARCH__ >= 700
+           ((oldArrive ^ semaphoreLoadAcquire(semaphore)) & FIRST_UINT64_BIT) ==
+#else
            ((oldArrive ^ globalAsVolatile(semaphore)) & FIRST_UINT64_BIT) ==
+#endif
                0) {
       // Put a sleep here so we have some breaks in probing the global
       // semaphore, giving a better chance for other warps/blocks to catch up.
@@ -110,8 +147,10 @@ __device__ void sync(
     int64_t& semaphore,
     const uint64_t& segment_size,
     const nvfuser_index_t n_entrances) {
+#if __CUDA_ARCH__ < 700
   // Finish all global memory transactions before synchronizing
   __threadfence();
+#endif
 
   // Synchronize all threads in a block before synchronizing blocks
   block_sync::sync<Aligned>();
@@ -132,7 +171,11 @@ __device__ void sync(
 
       unsigned int ns = 8;
       // Last block needs to wait for all other blocks to finish
+#if __CUDA_ARCH__ >= 700
+      while (semaphoreLoadAcquire(semaphore) < finished_val) {
+#else
       while (globalAsVolatile(semaphore) < finished_val) {
+#endif
 #if __CUDA_ARCH__ >= 700
         // __nanosleep only available on compute capability 7.0 or higher
         __nanosleep(ns); // avoids busy waiting
@@ -142,7 +185,11 @@ __device__ void sync(
 #endif
       }
     } else {
+#if __CUDA_ARCH__ >= 700
+      semaphoreAddRelease(semaphore, 1);
+#else
       auto old = atomicAdd(reinterpret_cast<uint64_t*>(&semaphore), 1);
+#endif
     }
   }
 
@@ -52,6 +52,24 @@ __device__ constexpr double ceilDiv(int64_t a, double b) {
 
 // Monotonic and precise lerp is described here:
 // https://math.stackexchange.com/a/1798323
+// Shift and multiplier of the division of a non-negative 32-bit integer n by
+// an invariant divisor 0 < d < 2^31, so that
+//   n / d == (__umulhi(fastDivMultiplier(d), n) + n) >> fastDivShift(d)
+// See Granlund and Montgomery, Division by Invariant Integers using
+// Multiplication, 1994.
+__device__ inline uint32_t fastDivShift(int d) {
+  return d > 1 ? 32 - __clz(d - 1) : 0;
+}
+
+__device__ inline uint32_t fastDivMultiplier(int d) {
+  // Zero-size divisors have no quotients to compute
+  if (d <= 0) {
+    return 0;
+  }
+  const uint64_t l = fastDivShift(d);
+  return (uint32_t)((((uint64_t)1 << 32) * (((uint64_t)1 << l) - d)) / d + 1);
+}
+
 __device__ double lerp(double start, double end, double weight) {
   if (weight < 0.5) {
     return start + weight * (end - start);
@@ -353,6 +371,29 @@ __device__ int64_t rsqrt(int64_t z) {
   return ::rsqrt((double)z);
 }
 
+// Fast approximations used by approximate UnaryOps of Float
+__device__ float rsqrt_approx(float z) {
+  float val;
+  asm("{  rsqrt.approx.f32 %0, %1;}\n" : "=f"(val) : "f"(z));
+  return val;
+}
+
+__device__ float reciprocal_approx(float x) {
+  float val;
+  asm("{  rcp.approx.f32 %0, %1;}\n" : "=f"(val) : "f"(x));
+  return val;
+}
+
+__device__ float tanh_approx(float x) {
+#if __CUDA_ARCH__ >= 750
+  float val;
+  asm("{  tanh.approx.f32 %0, %1;}\n" : "=f"(val) : "f"(x));
+  return val;
+#else
+  return ::tanhf(x);
+#endif
+}
+
 __device__ double signbit(double a) {
   return ::signbit(a);
 }
@@ -496,6 +537,47 @@ __device__ inline int64_t readCycleCounter() {
   return clock64();
 }
 
+#ifdef NVFUSER_PROFILE_KERNEL
+// Accumulates the cycles a thread spends in each phase of a kernel. Each
+// mark(phase) attributes the cycles since the previous mark to phase.
+template <int NUM_PHASES>
+struct PhaseTimer {
+  __device__ PhaseTimer() : last(readCycleCounter()) {
+#pragma unroll
+    for (int i = 0; i < NUM_PHASES; ++i) {
+      cycles[i] = 0;
+    }
+  }
+
+  __device__ void mark(int phase) {
+    const int64_t now = readCycleCounter();
+    cycles[phase] += now - last;
+    last = now;
+  }
+
+  // Adds the cycles of the first thread of each warp to buffer, which has a
+  // cycle count followed by a warp count for each phase
+  __device__ void flush(int64_t* buffer) {
+    const unsigned int tid = threadIdx.x +
+        blockDim.x * (threadIdx.y + blockDim.y * threadIdx.z);
+    if (tid % 32 != 0) {
+      return;
+    }
+#pragma unroll
+    for (int i = 0; i < NUM_PHASES; ++i) {
+      atomicAdd(
+          reinterpret_cast<unsigned long long*>(buffer + 2 * i),
+          static_cast<unsigned long long>(cycles[i]));
+      atomicAdd(
+          reinterpret_cast<unsigned long long*>(buffer + 2 * i + 1), 1ull);
+    }
+  }
+
+  int64_t cycles[NUM_PHASES];
+  int64_t last;
+};
+#endif // NVFUSER_PROFILE_KERNEL
+
 __device__ float print_impl(const char* name, float value) {
   printf(
       "%s = %f @ threadIdx=(%d,%d,%d), blockIdx=(%d,%d,%d)\n",
@@ -72,6 +72,43 @@ __device__ inline void wait(uint32_t smem_barrier_ptr, uint64_t state) {
 #endif
 }
 
+// Waits for the completion of the phase of the mbarrier with the given
+// parity. A circular buffer stage waits for the phase parity of its iteration
+// instead of an arrival state, since the state of the producing arrival is
+// not available to the consuming iteration.
+__device__ inline void waitParity(uint32_t smem_barrier_ptr, uint32_t parity) {
+#if (defined(__CUDA_ARCH__) && (__CUDA_ARCH__ >= 900))
+  asm volatile(
+      "{\n"
+      ".reg .pred                complete;\n"
+      "waitLoop:\n"
+      "mbarrier.try_wait.parity.shared.b64 complete, [%0], %1;\n"
+      "@!complete bra waitLoop;\n"
+      "}\n" ::"r"(smem_barrier_ptr),
+      "r"(parity));
+#else
+  asm volatile(
+      "{\n"
+      ".reg .pred                P1;\n"
+      "LAB_WAIT:\n"
+      "mbarrier.test_wait.parity.shared.b64 P1, [%0], %1;\n"
+      "@P1                       bra.uni DONE;\n"
+      "nanosleep.u32 20;\n"
+      "bra.uni                   LAB_WAIT;\n"
+      "DONE:\n"
+      "}\n" ::"r"(smem_barrier_ptr),
+      "r"(parity));
+#endif
+}
+
+// Arrives on the mbarrier once all prior cp.async operations of the calling
+// thread have completed. The pending count of the mbarrier is not
+// incremented, so it must be initialized with the number of arriving threads.
+__device__ inline void arriveCpAsync(uint32_t smem_barrier_ptr) {
+  asm volatile("cp.async.mbarrier.arrive.noinc.shared.b64 [%0];\n" ::"r"(
+      smem_barrier_ptr));
+}
+
 } // namespace mbarrier
 
 #endif // (defined(__CUDA_ARCH__) && (__CUDA_ARCH__ >= 800))
@@ -236,6 +236,92 @@ __device__ inline void cpAsyncBulkTensorTileS2G(
       : "memory");
 }
 
+// TMA Reductions:
+//
+// Add the tile in shared memory to the tile of the tensor at the coordinates
+// of dest, e.g. to combine the partial results of the blocks of a split-K
+// GEMM. The data type is the one of the tensor map.
+
+__device__ inline void cpAsyncBulkTensorTileS2GReduceAdd(
+    const CpAsyncBulkTensorTileS2GIndex<1>& dest,
+    uint32_t smem_addr) {
+  uint64_t gmem_int_desc = reinterpret_cast<uint64_t>(dest.descriptor);
+  asm volatile(
+      "cp.reduce.async.bulk.tensor.1d.global.shared::cta.add.bulk_group"
+      " [%0, {%2}], [%1];"
+      :
+      : "l"(gmem_int_desc),
+        "r"(smem_addr),
+        "r"(dest.crds[0])
+      : "memory");
+}
+
+__device__ inline void cpAsyncBulkTensorTileS2GReduceAdd(
+    const CpAsyncBulkTensorTileS2GIndex<2>& dest,
+    uint32_t smem_addr) {
+  uint64_t gmem_int_desc = reinterpret_cast<uint64_t>(dest.descriptor);
+  asm volatile(
+      "cp.reduce.async.bulk.tensor.2d.global.shared::cta.add.bulk_group"
+      " [%0, {%2, %3}], [%1];"
+      :
+      : "l"(gmem_int_desc),
+        "r"(smem_addr),
+        "r"(dest.crds[0]),
+        "r"(dest.crds[1])
+      : "memory");
+}
+
+__device__ inline void cpAsyncBulkTensorTileS2GReduceAdd(
+    const CpAsyncBulkTensorTileS2GIndex<3>& dest,
+    uint32_t smem_addr) {
+  uint64_t gmem_int_desc = reinterpret_cast<uint64_t>(dest.descriptor);
+  asm volatile(
+      "cp.reduce.async.bulk.tensor.3d.global.shared::cta.add.bulk_group"
+      " [%0, {%2, %3, %4}], [%1];"
+      :
+      : "l"(gmem_int_desc),
+        "r"(smem_addr),
+        "r"(dest.crds[0]),
+        "r"(dest.crds[1]),
+        "r"(dest.crds[2])
+      : "memory");
+}
+
+__device__ inline void cpAsyncBulkTensorTileS2GReduceAdd(
+    const CpAsyncBulkTensorTileS2GIndex<4>& dest,
+    uint32_t smem_addr) {
+  uint64_t gmem_int_desc = reinterpret_cast<uint64_t>(dest.descriptor);
+  asm volatile(
+      "cp.reduce.async.bulk.tensor.4d.global.shared::cta.add.bulk_group"
+      " [%0, {%2, %3, %4, %5}], [%1];"
+      :
+      : "l"(gmem_int_desc),
+        "r"(smem_addr),
+        "r"(dest.crds[0]),
+        "r"(dest.crds[1]),
+        "r"(dest.crds[2]),
+        "r"(dest.crds[3])
+      : "memory");
+}
+
+__device__ inline void cpAsyncBulkTensorTileS2GReduceAdd(
+    const CpAsyncBulkTensorTileS2GIndex<5>& dest,
+    uint32_t smem_addr) {
+  uint64_t gmem_int_desc = reinterpret_cast<uint64_t>(dest.descriptor);
+  asm volatile(
+      "cp.reduce.async.bulk.tensor.5d.global.shared::cta.add.bulk_group"
+      " [%0, {%2, %3, %4, %5, %6}], [%1];"
+      :
+      : "l"(gmem_int_desc),
+        "r"(smem_addr),
+        "r"(dest.crds[0]),
+        "r"(dest.crds[1]),
+        "r"(dest.crds[2]),
+        "r"(dest.crds[3]),
+        "r"(dest.crds[4])
+      : "memory");
+}
+
 } // namespace Hopper
 
 #endif // Arch 90
@@ -21,7 +21,79 @@ __device__ __forceinline__ std::complex<T> shfl_xor(
   return std::complex<T>(real, imag);
 }
 
-template <bool SINGLE_WARP, bool Aligned, typename T, typename Func>
+// Reduces val across the lanes of a warp with shuffles. All lanes get the
+// result.
+template <typename T, typename Func>
+__device__ __forceinline__ void reduceWithinWarp(T& val, Func reduction_op) {
+  for (int i = 16; i >= 1; i /= 2) {
+    reduction_op(val, shfl_xor(val, i, 32));
+  }
+}
+
+// The 32-bit integer reductions that redux.sync can do in a single
+// instruction on sm_80 and newer
+enum class ReduxOp { None, Add, Min, Max, And, Or, Xor };
+
+template <ReduxOp OP>
+__device__ __forceinline__ int redux(int val) {
+  int out = 0;
+  if constexpr (OP == ReduxOp::Add) {
+    asm volatile("redux.sync.add.s32 %0, %1, %2;"
+                 : "=r"(out)
+                 : "r"(val), "r"(0xffffffff));
+  } else if constexpr (OP == ReduxOp::Min) {
+    asm volatile("redux.sync.min.s32 %0, %1, %2;"
+                 : "=r"(out)
+                 : "r"(val), "r"(0xffffffff));
+  } else if constexpr (OP == ReduxOp::Max) {
+    asm volatile("redux.sync.max.s32 %0, %1, %2;"
+                 : "=r"(out)
+                 : "r"(val), "r"(0xffffffff));
+  } else if constexpr (OP == ReduxOp::And) {
+    asm volatile("redux.sync.and.b32 %0, %1, %2;"
+                 : "=r"(out)
+                 : "r"(val), "r"(0xffffffff));
+  } else if constexpr (OP == ReduxOp::Or) {
+    asm volatile("redux.sync.or.b32 %0, %1, %2;"
+                 : "=r"(out)
+                 : "r"(val), "r"(0xffffffff));
+  } else if constexpr (OP == ReduxOp::Xor) {
+    asm volatile("redux.sync.xor.b32 %0, %1, %2;"
+                 : "=r"(out)
+                 : "r"(val), "r"(0xffffffff));
+  }
+  return out;
+}
+
+// Same as above, but with redux.sync when REDUX is given and the device
+// supports it. REDUX must be ReduxOp::None unless T is int and REDUX is the
+// reduction of reduction_op.
+template <ReduxOp REDUX, typename T, typename Func>
+__device__ __forceinline__ void reduceWithinWarp(T& val, Func reduction_op) {
+#if __CUDA_ARCH__ >= 800
+  if constexpr (REDUX != ReduxOp::None) {
+    val = redux<REDUX>(val);
+    return;
+  }
+#endif
+  reduceWithinWarp(val, reduction_op);
+}
+
+// Reduces over TIDx, which must be padded to a multiple of a warp. Each warp
+// is reduced with shuffles, or with redux.sync, see ReduxOp, and the results
+// of the warps are exchanged through shared memory unless SINGLE_WARP.
+//
+// Only the first thread of each reduction group gets the result unless
+// BROADCAST, in which case all threads get it. This replaces a block
+// broadcast of the result, which costs two more block syncs than the extra
+// one needed here.
+template <
+    bool SINGLE_WARP,
+    bool Aligned,
+    bool BROADCAST = false,
+    ReduxOp REDUX = ReduxOp::None,
+    typename T,
+    typename Func>
 __device__ void warpReduceTIDX(
     T& out,
     const T& inp_val,
@@ -40,9 +112,7 @@ __device__ void warpReduceTIDX(
   }
 
   // Reduce within each warp
-  for (int i = 16; i >= 1; i /= 2) {
-    reduction_op(reduce_val, shfl_xor(reduce_val, i, WARP_SIZE));
-  }
+  reduceWithinWarp<REDUX>(reduce_val, reduction_op);
 
   // Reduce across warp if needed
   // Load value to shared mem
@@ -72,20 +142,203 @@ __device__ void warpReduceTIDX(
                                            : init_val;
 
       // Reduce within warp 0
-      for (int i = 16; i >= 1; i /= 2) {
-        reduction_op(reduce_val, shfl_xor(reduce_val, i, 32));
+      reduceWithinWarp<REDUX>(reduce_val, reduction_op);
+
+      // Each lane has read its value before the reduction above, so the
+      // result can be written over the first one
+      if (BROADCAST && is_warp_head) {
+        shared_mem[smem_offset] = reduce_val;
       }
     }
 
-    if (is_warp_head) {
+    if (!BROADCAST && is_warp_head) {
       reduction_op(out, reduce_val);
     }
     // needs sync, otherwise other warps may access shared memory before this
     // reduction is done.
     block_sync::sync<Aligned>();
+
+    if (BROADCAST) {
+      reduction_op(out, shared_mem[smem_offset]);
+      // Keeps the result from being overwritten before all threads read it
+      block_sync::sync<Aligned>();
+    }
   } else {
     reduction_op(out, reduce_val);
   }
 }
 
+// Welford over TIDx, which must be padded to a multiple of a warp. The
+// (avg, M2, N) triplets of each warp are combined with shuffles, and the
+// results of the warps through shared memory unless SINGLE_WARP, instead of
+// the tree of blockWelford, which takes a block sync per level. Only the
+// first thread of each reduction group gets the result.
+template <bool SINGLE_WARP, bool Aligned, typename T, typename TN>
+__device__ void warpWelfordTIDX(
+    T& out_avg,
+    T& out_M2,
+    TN& out_N,
+    const T& in_avg,
+    const T& in_M2,
+    const TN& in_N,
+    T* shared_mem_avg,
+    T* shared_mem_M2,
+    TN* shared_mem_N,
+    bool read_write_pred,
+    T init_val) {
+  constexpr int WARP_SIZE = 32;
+
+  T reduce_avg = init_val;
+  T reduce_M2 = init_val;
+  TN reduce_N = 0;
+  if (read_write_pred) {
+    reduce_avg = in_avg;
+    reduce_M2 = in_M2;
+    reduce_N = in_N;
+  }
+
+  auto combine_within_warp = [&]() {
+    for (int i = 16; i >= 1; i /= 2) {
+      welfordCombine(
+          reduce_avg,
+          reduce_M2,
+          reduce_N,
+          shfl_xor(reduce_avg, i, 32),
+          shfl_xor(reduce_M2, i, 32),
+          shfl_xor(reduce_N, i, 32));
+    }
+  };
+
+  combine_within_warp();
+
+  if (SINGLE_WARP) {
+    welfordCombine(out_avg, out_M2, out_N, reduce_avg, reduce_M2, reduce_N);
+    return;
+  }
+
+  unsigned int warp_idx = threadIdx.x / WARP_SIZE;
+  unsigned int lane_idx = threadIdx.x % WARP_SIZE;
+  unsigned int reduce_group_id = threadIdx.z * blockDim.y + threadIdx.y;
+  unsigned int num_of_warps = blockDim.x / WARP_SIZE;
+  unsigned int smem_offset = reduce_group_id * num_of_warps;
+
+  block_sync::sync<Aligned>();
+
+  if (lane_idx == 0) {
+    shared_mem_avg[smem_offset + warp_idx] = reduce_avg;
+    shared_mem_M2[smem_offset + warp_idx] = reduce_M2;
+    shared_mem_N[smem_offset + warp_idx] = reduce_N;
+  }
+
+  block_sync::sync<Aligned>();
+
+  if (warp_idx == 0) {
+    assert(num_of_warps <= 32);
+    if (lane_idx < num_of_warps) {
+      reduce_avg = shared_mem_avg[smem_offset + lane_idx];
+      reduce_M2 = shared_mem_M2[smem_offset + lane_idx];
+      reduce_N = shared_mem_N[smem_offset + lane_idx];
+    } else {
+      reduce_avg = init_val;
+      reduce_M2 = init_val;
+      reduce_N = 0;
+    }
+    combine_within_warp();
+    if (lane_idx == 0) {
+      welfordCombine(out_avg, out_M2, out_N, reduce_avg, reduce_M2, reduce_N);
+    }
+  }
+  // Keeps other warps from overwriting shared memory before warp 0 has
+  // read it
+  block_sync::sync<Aligned>();
+}
+
+// Two reductions over TIDx grouped into a single sequence of shuffles and a
+// single exchange through shared memory, so they share the block syncs of
+// warpReduceTIDX. The partial results of the warps for the second reduction
+// follow those of the first one in shared memory.
+template <
+    bool SINGLE_WARP,
+    bool Aligned,
+    typename T0,
+    typename Func0,
+    typename T1,
+    typename Func1>
+__device__ void warpReduceTIDX(
+    T0& out0,
+    const T0& inp_val0,
+    Func0 reduction_op0,
+    T0 init_val0,
+    T1& out1,
+    const T1& inp_val1,
+    Func1 reduction_op1,
+    T1 init_val1,
+    void* shared_mem,
+    bool read_write_pred) {
+  constexpr int WARP_SIZE = 32;
+
+  T0 reduce_val0 = init_val0;
+  T1 reduce_val1 = init_val1;
+  if (read_write_pred) {
+    reduce_val0 = inp_val0;
+    reduce_val1 = inp_val1;
+  }
+
+  // Interleaving the shuffles of the two reductions hides their latency
+  for (int i = 16; i >= 1; i /= 2) {
+    reduction_op0(reduce_val0, shfl_xor(reduce_val0, i, WARP_SIZE));
+    reduction_op1(reduce_val1, shfl_xor(reduce_val1, i, WARP_SIZE));
+  }
+
+  if (!SINGLE_WARP) {
+    unsigned int warp_idx = threadIdx.x / WARP_SIZE;
+    unsigned int lane_idx = threadIdx.x % WARP_SIZE;
+    unsigned int reduce_group_id = threadIdx.z * blockDim.y + threadIdx.y;
+    bool is_warp_head = lane_idx == 0;
+    unsigned int num_of_warps = blockDim.x / WARP_SIZE;
+    unsigned int smem_offset = reduce_group_id * num_of_warps;
+
+    T0* shared_mem0 = static_cast<T0*>(shared_mem);
+    const int smem0_bytes =
+        (int)(sizeof(T0) * num_of_warps * blockDim.y * blockDim.z);
+    T1* shared_mem1 = reinterpret_cast<T1*>(
+        static_cast<char*>(shared_mem) +
+        alignBufferSize(smem0_bytes, (int)alignof(T1)));
+
+    block_sync::sync<Aligned>();
+
+    if (is_warp_head) {
+      shared_mem0[smem_offset + warp_idx] = reduce_val0;
+      shared_mem1[smem_offset + warp_idx] = reduce_val1;
+    }
+
+    block_sync::sync<Aligned>();
+
+    if (warp_idx == 0) {
+      assert(num_of_warps <= 32);
+
+      reduce_val0 = lane_idx < num_of_warps
+          ? shared_mem0[smem_offset + lane_idx]
+          : init_val0;
+      reduce_val1 = lane_idx < num_of_warps
+          ? shared_mem1[smem_offset + lane_idx]
+          : init_val1;
+
+      for (int i = 16; i >= 1; i /= 2) {
+        reduction_op0(reduce_val0, shfl_xor(reduce_val0, i, WARP_SIZE));
+        reduction_op1(reduce_val1, shfl_xor(reduce_val1, i, WARP_SIZE));
+      }
+    }
+
+    if (is_warp_head) {
+      reduction_op0(out0, reduce_val0);
+      reduction_op1(out1, reduce_val1);
+    }
+    block_sync::sync<Aligned>();
+  } else {
+    reduction_op0(out0, reduce_val0);
+    reduction_op1(out1, reduce_val1);
+  }
+}
+
 } // namespace warp
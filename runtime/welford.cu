@@ -106,6 +106,48 @@ __inline__ __device__ void welfordVectorized(
   a_N = ab_N;
 }
 
+// Versions combining partial states, where the count b_N is invariant
+// across the vectorized items. delta0 * delta1 is
+// delta0^2 * a_N / ab_N, so it is scaled by b_N.
+template <typename T, bool OutputGmem>
+__inline__ __device__ void welfordVectorized(
+    T& a_avg,
+    T& a_M2,
+    nvfuser_index_t& a_N,
+    const T b_avg,
+    const T b_M2,
+    const T b_N,
+    const T b_N_div_ab_N,
+    const nvfuser_index_t ab_N,
+    const bool pred) {
+  if (OutputGmem && !pred) {
+    return;
+  }
+  T predicated_b_avg = pred ? b_avg : a_avg;
+  T delta0 = predicated_b_avg - a_avg;
+  a_avg += delta0 * b_N_div_ab_N;
+  T delta1 = predicated_b_avg - a_avg;
+  a_M2 += (pred ? b_M2 : (T)0) + delta0 * delta1 * b_N;
+  a_N = ab_N;
+}
+
+template <typename T>
+__inline__ __device__ void welfordVectorized(
+    T& a_avg,
+    T& a_M2,
+    nvfuser_index_t& a_N,
+    const T b_avg,
+    const T b_M2,
+    const T b_N,
+    const T b_N_div_ab_N,
+    const nvfuser_index_t ab_N) {
+  T delta0 = b_avg - a_avg;
+  a_avg += delta0 * b_N_div_ab_N;
+  T delta1 = b_avg - a_avg;
+  a_M2 += b_M2 + delta0 * delta1 * b_N;
+  a_N = ab_N;
+}
+
 // [Z,Y,X]_THREADS is the number of participating threads in the z, y, x
 // dimension of the block.
 template <
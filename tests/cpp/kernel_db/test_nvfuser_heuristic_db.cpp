@@ -0,0 +1,165 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <gmock/gmock-matchers.h>
+#include <gtest/gtest.h>
+
+#include <fusion.h>
+#include <kernel_cache.h>
+#include <kernel_db/heuristic_db.h>
+#include <ops/all_ops.h>
+#include <scheduler/heuristic_plugin.h>
+#include <tests/cpp/utils.h>
+#include <tests/cpp/validator.h>
+
+#include <fstream>
+
+// RUN CMD: bin/test_jit --gtest_filter="NVFuserTest*HeuristicDb*"
+
+namespace nvfuser {
+
+namespace {
+
+fs::path makeTestDbFile(const std::string& name) {
+  fs::path file = fs::temp_directory_path() / name;
+  fs::remove(file);
+  return file;
+}
+
+} // namespace
+
+TEST_F(NVFuserTest, HeuristicDb_RecordAndMerge) {
+  HeuristicDb db;
+  const std::string signature("kernel=0;sizes=1024,128");
+  EXPECT_FALSE(db.best(signature).has_value());
+
+  db.record(signature, {1, 4}, 2.0);
+  db.record(signature, {1, 2}, 1.5);
+  db.record(signature, {1, 4}, 1.0);
+  EXPECT_EQ(db.size(), 1);
+  ASSERT_TRUE(db.best(signature).has_value());
+  EXPECT_EQ(db.best(signature).value(), std::vector<int64_t>({1, 4}));
+
+  // Measurements of the same knobs keep their best time and add up samples
+  std::vector<HeuristicDb::Record> records = db.records(signature);
+  ASSERT_EQ(records.size(), 2);
+  EXPECT_EQ(records[0].best_time_ms, 1.0);
+  EXPECT_EQ(records[0].num_samples, 2);
+  EXPECT_EQ(records[1].knobs, std::vector<int64_t>({1, 2}));
+
+  HeuristicDb other;
+  other.record(signature, {1, 2}, 0.5, 3);
+  other.record("kernel=1;sizes=16", {1, 1, 1, 1, 1, 1, 32, -1}, 0.1);
+  db.merge(other);
+  EXPECT_EQ(db.size(), 2);
+  EXPECT_EQ(db.best(signature).value(), std::vector<int64_t>({1, 2}));
+  EXPECT_EQ(db.records(signature).front().num_samples, 4);
+}
+
+TEST_F(NVFuserTest, HeuristicDb_SaveAndLoad) {
+  const fs::path db_file = makeTestDbFile("nvfuser_heuristic_db_test.bin");
+  const std::string signature("kernel=0;sizes=1024,128");
+
+  {
+    HeuristicDb db(db_file);
+    EXPECT_EQ(db.size(), 0);
+    db.record(signature, {1, 4}, 1.0);
+    ASSERT_TRUE(db.sync());
+    // Syncing again doesn't count the same samples twice
+    ASSERT_TRUE(db.sync());
+    EXPECT_EQ(db.records(signature).front().num_samples, 1);
+  }
+
+  // A second process on the same file sees the records and adds its own
+  {
+    HeuristicDb db(db_file);
+    ASSERT_EQ(db.records(signature).size(), 1);
+    db.record(signature, {1, 2}, 0.5);
+    ASSERT_TRUE(db.sync());
+  }
+  HeuristicDb db(db_file);
+  std::vector<HeuristicDb::Record> records = db.records(signature);
+  ASSERT_EQ(records.size(), 2);
+  EXPECT_EQ(records[0].knobs, std::vector<int64_t>({1, 2}));
+  EXPECT_EQ(records[1].num_samples, 1);
+
+  // Files are merged like databases
+  const fs::path merged_file =
+      makeTestDbFile("nvfuser_heuristic_db_merged.bin");
+  HeuristicDb merged;
+  ASSERT_TRUE(merged.load(db_file));
+  ASSERT_TRUE(merged.load(db_file));
+  ASSERT_TRUE(merged.save(merged_file));
+  HeuristicDb reloaded;
+  ASSERT_TRUE(reloaded.load(merged_file));
+  EXPECT_EQ(reloaded.records(signature).front().num_samples, 2);
+
+  // Files that are not a database are ignored
+  { std::ofstream(merged_file, std::ios::trunc) << "not a heuristic db"; }
+  HeuristicDb corrupted;
+  EXPECT_FALSE(corrupted.load(merged_file));
+  EXPECT_EQ(corrupted.size(), 0);
+
+  fs::remove(db_file);
+  fs::remove(merged_file);
+}
+
+// The autotuner records its measurements, and later runtimes replay the
+// fastest parameters instead of autotuning again
+TEST_F(NVFuserTest, HeuristicDb_RecordAndReplay) {
+  const fs::path db_file = makeTestDbFile("nvfuser_heuristic_db_replay.bin");
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::Autotune);
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::HeuristicDb, {db_file.string()});
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  TensorView* tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  fusion->addOutput(sum(tv0, {1}));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1024, 4096}, options);
+
+  std::shared_ptr<HeuristicParams> params;
+  {
+    FusionExecutorCache fec(std::make_unique<Fusion>(*fusion));
+    auto outputs = fec.runFusionWithInputs({t0});
+    testValidate(fec.fusion(), outputs, {t0}, __LINE__, __FILE__);
+    FusionKernelRuntime* runtime = fec.getMostRecentKernelRuntime();
+    ASSERT_EQ(runtime->schedulers().size(), 1);
+    params = runtime->schedulers().front()->params();
+  }
+  const std::string& signature = params->problem_signature;
+  ASSERT_FALSE(signature.empty());
+
+  HeuristicDb* db = HeuristicDb::get();
+  ASSERT_NE(db, nullptr);
+  std::vector<HeuristicDb::Record> records = db->records(signature);
+  ASSERT_GE(records.size(), 2);
+  EXPECT_EQ(records.front().knobs, heuristic_plugin::getConfigKnobs(*params));
+  EXPECT_EQ(HeuristicDb(db_file).records(signature).size(), records.size());
+
+  // Make a non-vectorized candidate the fastest
+  std::vector<int64_t> knobs = records.front().knobs;
+  knobs.at(0) = 1;
+  knobs.at(1) = 0;
+  db->record(signature, knobs, 0.0);
+
+  FusionExecutorCache fec(std::move(fusion));
+  auto outputs = fec.runFusionWithInputs({t0});
+  testValidate(fec.fusion(), outputs, {t0}, __LINE__, __FILE__);
+  FusionKernelRuntime* runtime = fec.getMostRecentKernelRuntime();
+  const SchedulerEntry* entry = runtime->schedulers().front().get();
+  EXPECT_EQ(heuristic_plugin::getConfigKnobs(*entry->params()), knobs);
+  EXPECT_EQ(runtime->autotunedCandidates().front(), 0);
+
+  fs::remove(db_file);
+}
+
+} // namespace nvfuser
@@ -74,4 +74,64 @@ TEST_F(NVFuserTest, KernelDb_Write_CUDA) {
   }
 }
 
+TEST_F(NVFuserTest, KernelDb_WriteEvictsAndRepairs_CUDA) {
+  const std::string kernel_db_dir("nvfuser_kernel_db_evict_test");
+  const std::string kernel_db_file("db.csv");
+  fs::path test_db_path = fs::temp_directory_path() / kernel_db_dir;
+  if (fs::is_directory(test_db_path)) {
+    fs::remove_all(test_db_path);
+  }
+
+  // Room for two entries of a 1000-byte cubin and a 200-byte kernel
+  auto& kernel_db = KernelDb::get(
+      kernel_db_dir,
+      kernel_db_file,
+      /*use_temp_dir=*/true,
+      /*disabled=*/false,
+      /*reset=*/true,
+      /*max_bytes=*/3000);
+  ASSERT_TRUE(kernel_db.enabled());
+
+  const std::string compile_args("--fmad=true");
+  const std::string kernel_signature("kernel");
+  const std::vector<char> cubin(1000, 'a');
+  std::vector<std::string> codes;
+  for (auto i : c10::irange(5)) {
+    codes.push_back(std::to_string(i) + std::string(199, 'x'));
+    ASSERT_TRUE(
+        kernel_db.write(codes.back(), compile_args, kernel_signature, cubin));
+  }
+  EXPECT_EQ(kernel_db.size(), 2u);
+  EXPECT_LE(kernel_db.sizeBytes(), 3000);
+
+  // The most recent entries are kept, and survive reopening the db
+  auto& reopened_db = KernelDb::get(
+      kernel_db_dir, kernel_db_file, true, false, true, 3000);
+  EXPECT_EQ(reopened_db.size(), 2u);
+  std::string name;
+  std::vector<char> queried_cubin;
+  EXPECT_FALSE(
+      reopened_db.query(codes.front(), compile_args, name, queried_cubin));
+  ASSERT_TRUE(
+      reopened_db.query(codes.back(), compile_args, name, queried_cubin));
+  EXPECT_EQ(queried_cubin, cubin);
+
+  // A corrupted cubin is a miss, and writing the entry again repairs it
+  for (const auto& dir_entry : fs::directory_iterator(test_db_path)) {
+    if (dir_entry.path().extension() == ".cubin") {
+      ASSERT_TRUE(copy_to_text_file(dir_entry.path().string(), "corrupted"));
+    }
+  }
+  EXPECT_FALSE(
+      reopened_db.query(codes.back(), compile_args, name, queried_cubin));
+  ASSERT_TRUE(
+      reopened_db.write(codes.back(), compile_args, kernel_signature, cubin));
+  EXPECT_TRUE(
+      reopened_db.query(codes.back(), compile_args, name, queried_cubin));
+
+  if (fs::is_directory(test_db_path)) {
+    fs::remove_all(test_db_path);
+  }
+}
+
 } // namespace nvfuser
@@ -0,0 +1,167 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <gmock/gmock-matchers.h>
+#include <gtest/gtest.h>
+
+#include <kernel_db/disk_cache.h>
+#include <tests/cpp/utils.h>
+
+#include <thread>
+
+// RUN CMD: bin/test_jit --gtest_filter="NVFuserTest*KernelDiskCache*"
+
+namespace nvfuser {
+
+namespace {
+
+fs::path makeTestCacheDir(const std::string& name) {
+  fs::path dir = fs::temp_directory_path() / name;
+  fs::remove_all(dir);
+  return dir;
+}
+
+} // namespace
+
+TEST_F(NVFuserTest, KernelDiskCache_QueryAndWrite) {
+  fs::path cache_dir = makeTestCacheDir("nvfuser_kernel_disk_cache_test");
+  KernelDiskCache cache(cache_dir, 1024 * 1024);
+
+  const std::string key("arch=8.0;args=--gpu-architecture=sm_80");
+  const std::string code("__global__ void kernel1() {}");
+  const std::vector<char> cubin{'c', 'u', 'b', 'i', 'n'};
+
+  std::string name;
+  std::vector<char> binary;
+  EXPECT_FALSE(cache.query(key, code, name, binary));
+
+  ASSERT_TRUE(cache.write(key, code, "_Z7kernel1v", cubin));
+  ASSERT_TRUE(cache.query(key, code, name, binary));
+  EXPECT_EQ(name, "_Z7kernel1v");
+  EXPECT_EQ(binary, cubin);
+
+  // Both the key and the code have to match
+  EXPECT_FALSE(cache.query(key + " -G", code, name, binary));
+  EXPECT_FALSE(cache.query(key, code + " ", name, binary));
+
+  // A second cache on the same directory, e.g. in another process, sees the
+  // entry as well
+  KernelDiskCache other_cache(cache_dir, 1024 * 1024);
+  EXPECT_TRUE(other_cache.query(key, code, name, binary));
+
+  // No temporary files are left behind
+  for (const auto& entry : fs::directory_iterator(cache_dir)) {
+    EXPECT_EQ(entry.path().extension(), ".kernel") << entry.path();
+  }
+
+  fs::remove_all(cache_dir);
+}
+
+TEST_F(NVFuserTest, KernelDiskCache_CorruptedEntry) {
+  fs::path cache_dir = makeTestCacheDir("nvfuser_kernel_disk_cache_corrupt");
+  KernelDiskCache cache(cache_dir, 1024 * 1024);
+
+  const std::string key("args=");
+  const std::string code("__global__ void kernel1() {}");
+  ASSERT_TRUE(cache.write(key, code, "kernel1", std::vector<char>(64, 'x')));
+
+  // Truncate the entry as if a non-atomic write had been interrupted
+  for (const auto& entry : fs::directory_iterator(cache_dir)) {
+    fs::resize_file(entry.path(), 40);
+  }
+
+  std::string name;
+  std::vector<char> binary;
+  EXPECT_FALSE(cache.query(key, code, name, binary));
+
+  fs::remove_all(cache_dir);
+}
+
+TEST_F(NVFuserTest, KernelDiskCache_EvictLeastRecentlyUsed) {
+  fs::path cache_dir = makeTestCacheDir("nvfuser_kernel_disk_cache_evict");
+  // Room for about three entries of 1KB each
+  KernelDiskCache cache(cache_dir, 3500);
+
+  const std::string key("args=");
+  const std::vector<char> cubin(1000, 'x');
+  auto code = [](int64_t i) {
+    return "__global__ void kernel" + std::to_string(i) + "() {}";
+  };
+
+  std::string name;
+  std::vector<char> binary;
+  for (auto i : c10::irange(3)) {
+    ASSERT_TRUE(cache.write(key, code(i), "kernel", cubin));
+    // Make sure modification times differ
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+  // Using the first entry makes the second one the least recently used
+  ASSERT_TRUE(cache.query(key, code(0), name, binary));
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+  ASSERT_TRUE(cache.write(key, code(3), "kernel", cubin));
+  EXPECT_LE(cache.sizeBytes(), 3500);
+  EXPECT_TRUE(cache.query(key, code(0), name, binary));
+  EXPECT_FALSE(cache.query(key, code(1), name, binary));
+  EXPECT_TRUE(cache.query(key, code(3), name, binary));
+
+  fs::remove_all(cache_dir);
+}
+
+TEST_F(NVFuserTest, KernelDiskCache_EntryLock) {
+#ifdef _WIN32
+  GTEST_SKIP() << "Entry locks are not supported on Windows";
+#endif // _WIN32
+  fs::path cache_dir = makeTestCacheDir("nvfuser_kernel_disk_cache_lock");
+  KernelDiskCache cache(cache_dir, 1024 * 1024);
+  // Stands for another process compiling the same kernel
+  KernelDiskCache other_cache(cache_dir, 1024 * 1024);
+
+  const std::string key("args=");
+  const std::string code("__global__ void kernel1() {}");
+  const std::vector<char> cubin{'c', 'u', 'b', 'i', 'n'};
+
+  KernelDiskCache::EntryLock entry_lock = cache.lock(key, code);
+  ASSERT_TRUE(entry_lock.locked());
+  EXPECT_FALSE(entry_lock.waited());
+
+  // Locking a held entry times out
+  KernelDiskCache::EntryLock timed_out =
+      other_cache.lock(key, code, std::chrono::milliseconds(20));
+  EXPECT_FALSE(timed_out.locked());
+  EXPECT_TRUE(timed_out.waited());
+
+  // Locking waits for the holder, which writes the entry before unlocking
+  bool found = false;
+  bool waited = false;
+  std::thread waiter([&]() {
+    KernelDiskCache::EntryLock other_lock = other_cache.lock(key, code);
+    waited = other_lock.waited();
+    std::string name;
+    std::vector<char> binary;
+    found = other_lock.locked() && other_cache.query(key, code, name, binary);
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  ASSERT_TRUE(cache.write(key, code, "kernel1", cubin));
+  entry_lock = KernelDiskCache::EntryLock();
+  waiter.join();
+  EXPECT_TRUE(waited);
+  EXPECT_TRUE(found);
+
+  // Lock files don't count towards the size of the cache
+  int64_t entry_bytes = 0;
+  for (const auto& entry : fs::directory_iterator(cache_dir)) {
+    if (entry.path().extension() == ".kernel") {
+      entry_bytes += (int64_t)fs::file_size(entry.path());
+    }
+  }
+  EXPECT_EQ(cache.sizeBytes(), entry_bytes);
+
+  fs::remove_all(cache_dir);
+}
+
+} // namespace nvfuser
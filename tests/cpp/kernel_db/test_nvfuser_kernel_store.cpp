@@ -0,0 +1,62 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <gmock/gmock-matchers.h>
+#include <gtest/gtest.h>
+
+#include <kernel_db/kernel_store.h>
+#include <tests/cpp/utils.h>
+
+// RUN CMD: bin/test_jit --gtest_filter="NVFuserTest*KernelStore*"
+
+namespace nvfuser {
+
+TEST_F(NVFuserTest, KernelStore_FileQueryAndWrite) {
+  fs::path store_dir = fs::temp_directory_path() / "nvfuser_kernel_store_test";
+  fs::remove_all(store_dir);
+  auto store = KernelStore::create("file://" + store_dir.string());
+  ASSERT_NE(store, nullptr);
+
+  const std::string key("arch=8.0;args=--gpu-architecture=sm_80");
+  const std::string code("__global__ void kernel1() {}");
+  const std::vector<char> cubin{'c', 'u', 'b', 'i', 'n'};
+
+  std::string name;
+  std::vector<char> binary;
+  EXPECT_FALSE(store->query(key, code, name, binary));
+  ASSERT_TRUE(store->write(key, code, "_Z7kernel1v", cubin));
+
+  // The lookup runs in the background
+  KernelStoreLookup lookup(store, key, code);
+  ASSERT_TRUE(lookup.wait(name, binary));
+  EXPECT_EQ(name, "_Z7kernel1v");
+  EXPECT_EQ(binary, cubin);
+
+  // Both the key and the code have to match
+  EXPECT_FALSE(store->query(key + " -G", code, name, binary));
+  KernelStoreLookup other_lookup(store, key, code + " ");
+  EXPECT_FALSE(other_lookup.wait(name, binary));
+
+  // No temporary files are left behind
+  for (const auto& entry : fs::directory_iterator(store_dir)) {
+    EXPECT_EQ(entry.path().extension(), ".kernel") << entry.path();
+  }
+  fs::remove_all(store_dir);
+}
+
+TEST_F(NVFuserTest, KernelStore_Urls) {
+  EXPECT_EQ(KernelStore::create("https://example.com/bucket"), nullptr);
+  EXPECT_EQ(KernelStore::create("s3://bucket"), nullptr);
+  auto store = KernelStore::create("http://localhost:9000/bucket/nvfuser/");
+  ASSERT_NE(store, nullptr);
+  EXPECT_EQ(store->describe(), "http://localhost:9000/bucket/nvfuser");
+  store = KernelStore::create("http://localhost");
+  ASSERT_NE(store, nullptr);
+  EXPECT_EQ(store->describe(), "http://localhost:80");
+}
+
+} // namespace nvfuser
@@ -181,6 +181,34 @@ TEST_F(NVFuserTest, PyFusionCache_CUDA) {
       FAIL() << "An unexpected assert on cache lookup!" << e.what();
     }
   }
+
+  // Verify the lookup of a complete fusion by the digest of its records,
+  // which has to match the records themselves.
+  {
+    std::vector<std::unique_ptr<RecordFunctor>> records;
+    records.emplace_back(new TensorRecord(
+        {State(0, serde::StateType::Tensor)}, {3}, {true}, DataType::Float));
+    std::unique_ptr<RecordFunctor> end_record(new EndRecord());
+    size_t digest = fc->rootTriePtr()->digest;
+    hashCombine(digest, records.back()->hash());
+    hashCombine(digest, end_record->hash());
+
+    auto terminal = fc->queryDefinition(digest, records, end_record.get());
+    ASSERT_TRUE(terminal.has_value());
+    ASSERT_TRUE(terminal.value()->isTerminal());
+    ASSERT_EQ(terminal.value()->digest, digest);
+    ASSERT_EQ(terminal.value()->fusion_id, 0u);
+
+    ASSERT_FALSE(fc->queryDefinition(digest + 1, records, end_record.get())
+                     .has_value());
+
+    // A digest collision must not return another fusion
+    std::vector<std::unique_ptr<RecordFunctor>> other_records;
+    other_records.emplace_back(new TensorRecord(
+        {State(0, serde::StateType::Tensor)}, {3}, {true}, DataType::Half));
+    ASSERT_FALSE(fc->queryDefinition(digest, other_records, end_record.get())
+                     .has_value());
+  }
 }
 
 } // namespace nvfuser
@@ -0,0 +1,89 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <gmock/gmock-matchers.h>
+#include <gtest/gtest.h>
+
+#include <torch/torch.h>
+
+#include <ops/all_ops.h>
+#include <options.h>
+#include <python_frontend/fusion_replay.h>
+#include <tests/cpp/utils.h>
+
+#include <cstdio>
+
+namespace nvfuser {
+using namespace nvfuser::python_frontend;
+
+// RUN CMD: bin/test_python_frontend --gtest_filter="NVFuserTest*FusionReplay*"
+TEST_F(NVFuserTest, FusionReplayLog_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+  auto tv0 = makeSymbolicTensor(3, DataType::Half);
+  auto tv1 = makeSymbolicTensor(2, DataType::Int);
+  auto tv2 = makeSymbolicTensor(0);
+  auto s0 = IrBuilder::create<Val>(DataType::Int);
+  auto s1 = IrBuilder::create<Val>(DataType::Double);
+  auto s2 = IrBuilder::create<Val>(DataType::Bool);
+  fusion.addInput(tv0);
+  fusion.addInput(tv1);
+  fusion.addInput(tv2);
+  fusion.addInput(s0);
+  fusion.addInput(s1);
+  fusion.addInput(s2);
+
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+  std::vector<c10::IValue> inputs{
+      at::randn({4, 8, 16}, options).transpose(1, 2),
+      at::zeros({3, 1}, options.dtype(at::kLong)).expand({3, 5}),
+      at::tensor(2.0f),
+      int64_t(7),
+      0.25,
+      true};
+
+  const std::string log_path =
+      testing::TempDir() + "nvfuser_fusion_replay_test.log";
+  std::remove(log_path.c_str());
+  {
+    EnableOptionsGuard eog;
+    EnableOptionsGuard::getCurOptions().set(
+        EnableOption::FusionReplayLog, {log_path});
+    recordFusionReplayCall(3, inputs);
+    recordFusionReplayCall(5, {});
+  }
+  // Not recorded once the option is disabled
+  recordFusionReplayCall(6, {});
+
+  auto calls = readFusionReplayLog(log_path);
+  ASSERT_EQ(calls.size(), 2);
+  EXPECT_EQ(calls.at(0).fusion_id, 3);
+  EXPECT_EQ(calls.at(1).fusion_id, 5);
+  EXPECT_TRUE(calls.at(1).inputs.empty());
+  ASSERT_EQ(calls.at(0).inputs.size(), inputs.size());
+  EXPECT_THAT(calls.at(0).inputs.at(1).strides, testing::ElementsAre(1, 0));
+  EXPECT_TRUE(calls.at(0).inputs.at(2).is_cpu);
+  EXPECT_EQ(calls.at(0).inputs.at(3).value, "7");
+  EXPECT_EQ(calls.at(0).inputs.at(5).value, "true");
+
+  auto replay_inputs = makeFusionReplayInputs(&fusion, calls.at(0));
+  ASSERT_EQ(replay_inputs.size(), inputs.size());
+  for (auto i : c10::irange(3)) {
+    const auto& expected = inputs.at(i).toTensor();
+    const auto& actual = replay_inputs.at(i).toTensor();
+    EXPECT_EQ(actual.sizes(), expected.sizes());
+    EXPECT_EQ(actual.strides(), expected.strides());
+    EXPECT_EQ(actual.scalar_type(), expected.scalar_type());
+    EXPECT_EQ(actual.device(), expected.device());
+  }
+  EXPECT_EQ(replay_inputs.at(3).toInt(), 7);
+  EXPECT_EQ(replay_inputs.at(4).toDouble(), 0.25);
+  EXPECT_TRUE(replay_inputs.at(5).toBool());
+  std::remove(log_path.c_str());
+}
+
+} // namespace nvfuser
@@ -0,0 +1,112 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <gmock/gmock-matchers.h>
+#include <gtest/gtest.h>
+
+#include <torch/torch.h>
+
+#include <kernel_cache.h>
+#include <ops/all_ops.h>
+#include <python_frontend/fusion_cache.h>
+#include <python_frontend/lazy_fusion.h>
+#include <tests/cpp/utils.h>
+
+namespace nvfuser {
+using namespace nvfuser::python_frontend;
+
+namespace {
+
+// x -> x + 1
+std::unique_ptr<Fusion> makeAddFusion() {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  fusion->addOutput(add(tv0, IrBuilder::create<Val>(1.0)));
+  return fusion;
+}
+
+// y, z -> y * z
+std::unique_ptr<Fusion> makeMulFusion() {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  auto tv0 = makeSymbolicTensor(2);
+  auto tv1 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  fusion->addOutput(mul(tv0, tv1));
+  return fusion;
+}
+
+} // namespace
+
+// RUN CMD: bin/test_python_frontend --gtest_filter="NVFuserTest*LazyFusion*"
+TEST_F(NVFuserTest, LazyFusionStitch_CUDA) {
+  std::unique_ptr<Fusion> add_fusion = makeAddFusion();
+  std::unique_ptr<Fusion> mul_fusion = makeMulFusion();
+
+  // The output of the add feeds the first input of the mul, and only the
+  // output of the mul is materialized
+  std::unique_ptr<Fusion> stitched = stitchFusions(
+      {add_fusion.get(), mul_fusion.get()},
+      {{{-1, 0}}, {{0, 0}, {-1, 1}}},
+      {{1, 0}});
+  ASSERT_NE(stitched, nullptr);
+  EXPECT_EQ(stitched->inputs().size(), 2);
+  EXPECT_EQ(stitched->outputs().size(), 1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({8, 16}, options);
+  at::Tensor t1 = at::randn({8, 16}, options);
+  FusionExecutorCache fec(std::move(stitched));
+  auto outputs = fec.runFusionWithInputs({t0, t1});
+  testValidate(
+      fec.fusion(), outputs, {t0, t1}, {(t0 + 1) * t1}, __LINE__, __FILE__);
+
+  // A 2D output can't feed a 1D input
+  std::unique_ptr<Fusion> reduction_fusion = std::make_unique<Fusion>();
+  {
+    FusionGuard fg(reduction_fusion.get());
+    auto tv0 = makeSymbolicTensor(1);
+    reduction_fusion->addInput(tv0);
+    reduction_fusion->addOutput(sum(tv0, {0}));
+  }
+  EXPECT_EQ(
+      stitchFusions(
+          {add_fusion.get(), reduction_fusion.get()},
+          {{{-1, 0}}, {{0, 0}}},
+          {{1, 0}}),
+      nullptr);
+}
+
+TEST_F(NVFuserTest, LazyFusionQueue_CUDA) {
+  FusionCache::reset();
+  FusionExecutorCache add_fec(makeAddFusion());
+  FusionExecutorCache mul_fec(makeMulFusion());
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({8, 16}, options);
+  at::Tensor t1 = at::randn({8, 16}, options);
+
+  std::shared_ptr<LazyFusionQueue> queue = LazyFusionQueue::create();
+  auto add_outputs = queue->enqueue(0, &add_fec, {c10::IValue(t0)});
+  auto mul_outputs =
+      queue->enqueue(1, &mul_fec, {add_outputs.at(0), c10::IValue(t1)});
+  EXPECT_EQ(queue->numPendingCalls(), 2);
+  // The intermediate is dead, so it is not materialized
+  add_outputs.clear();
+
+  const at::Tensor& result = mul_outputs.at(0)->result();
+  EXPECT_EQ(queue->numPendingCalls(), 0);
+  EXPECT_TRUE(mul_outputs.at(0)->materialized());
+  EXPECT_TRUE(result.allclose((t0 + 1) * t1));
+  // The stitched fusion ran instead of the recorded ones
+  EXPECT_FALSE(add_fec.isCompiled({t0}));
+}
+
+} // namespace nvfuser
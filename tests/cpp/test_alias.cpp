@@ -1109,6 +1109,39 @@ TEST_F(AliasTest, ReuseBufferAliasAcrossSegments) {
       << "`t0` should have been in-place updated to the same value as `t6`.";
 }
 
+TEST_F(AliasTest, ReuseBufferSlice) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  // A decode step that writes the new keys into a preallocated KV cache.
+  TensorView* cache = makeContigTensor(4);
+  TensorView* key = makeContigTensor(4);
+  Val* pos = IrBuilder::create<Val>(DataType::Int);
+  fusion->addInput(cache);
+  fusion->addInput(key);
+  fusion->addInput(pos);
+  TensorView* new_key = mul(key, IrBuilder::create<Val>(2.0));
+  fusion->addOutput(new_key);
+  fusion->aliasOutputToInputSlice(new_key, cache, /*dim=*/2, pos);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor cache_tensor = at::randn({2, 4, 16, 8}, options);
+  at::Tensor key_tensor = at::randn({2, 4, 3, 8}, options);
+  at::Tensor original_cache = cache_tensor.clone();
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  std::vector<at::Tensor> outputs =
+      executor_cache.runFusionWithInputs({cache_tensor, key_tensor, 5});
+  ASSERT_EQ(outputs.size(), 1);
+  EXPECT_TRUE(outputs[0].is_alias_of(cache_tensor));
+  EXPECT_TRUE(outputs[0].equal(key_tensor * 2));
+
+  at::Tensor expected_cache = original_cache.clone();
+  expected_cache.narrow(2, 5, 3).copy_(key_tensor * 2);
+  EXPECT_TRUE(cache_tensor.equal(expected_cache))
+      << "Only the slice [5, 8) of the cache should be updated.";
+}
+
 TEST_F(AliasTest, AliasOnlyKernelsAreNotLaunched) {
   if (detectComputeSanitizer()) {
     GTEST_SKIP()
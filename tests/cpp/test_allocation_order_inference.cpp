@@ -321,6 +321,39 @@ TEST_F(AllocationOrderInferenceTest, ReductionOpPropagation) {
   EXPECT_THAT(inferred_layout.at(tv5), ElementsAre(0, 3, 2, 1));
 }
 
+TEST_F(AllocationOrderInferenceTest, SetSqueezeExpandPropagation) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor({-1, -1, 1, -1});
+  std::vector<IterDomain*> tv0_nhwc = {
+      tv0->axis(0), tv0->axis(2), tv0->axis(3), tv0->axis(1)};
+  tv0->setAllocationDomain(tv0_nhwc, true); // stride order: {0, 2, 3, 1}
+  fusion.addInput(tv0);
+  auto tv1 = set(tv0); // stride order: {0, 2, 3, 1}
+  fusion.addOutput(tv1);
+  // the squeezed broadcast is dropped from the allocation order
+  auto tv2 = squeeze(tv1, std::vector<int64_t>{2}); // stride order: {0, 2, 1}
+  fusion.addOutput(tv2);
+  auto tv3 = expand(
+      tv1,
+      {tv1->axis(0)->extent(),
+       tv1->axis(1)->extent(),
+       IrBuilder::create<Val>(5L),
+       tv1->axis(3)->extent()}); // stride order: {0, 2, 3, 1}
+  fusion.addOutput(tv3);
+  // permute is not propagated through
+  auto tv4 = permute(tv0, {0, 2, 3, 1});
+  fusion.addOutput(tv4);
+
+  const auto inferred_layout = preseg_passes::inferenceAllocationOrder(&fusion);
+  EXPECT_THAT(inferred_layout.at(tv1), ElementsAre(0, 2, 3, 1));
+  EXPECT_THAT(inferred_layout.at(tv2), ElementsAre(0, 2, 1));
+  EXPECT_THAT(inferred_layout.at(tv3), ElementsAre(0, 2, 3, 1));
+  EXPECT_EQ(inferred_layout.count(tv4), 0);
+}
+
 TEST_F(AllocationOrderInferenceTest, EnableInRuntime) {
   auto fusion = std::make_unique<Fusion>();
   FusionGuard fg(fusion.get());
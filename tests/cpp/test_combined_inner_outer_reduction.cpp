@@ -1066,4 +1066,123 @@ TEST_F(NVFuserTest, CombinedSchedulerInnerOuterMismatch) {
   test({0});
 }
 
+// The persistent buffers of a half precision RMSNorm backward with a hidden
+// size of 28K and the partial results of grad_weight don't fit in the register
+// file together. EnableOption::InnerOuterSharedMemory keeps the partial
+// results in shared memory, so the fusion is still a single kernel.
+TEST_F(NVFuserTest, CombinedSchedulerSharedMemoryOuterPartialBuffer) {
+  const int64_t dim0 = 2048;
+  const int64_t dim1 = 28 * 1024;
+  const auto dev_prop = at::cuda::getCurrentDeviceProperties();
+  const int64_t available_smem = (int64_t)dev_prop->sharedMemPerBlockOptin -
+      (int64_t)dev_prop->reservedSharedMemPerBlock -
+      (int64_t)dev_prop->maxThreadsPerBlock * (int64_t)sizeof(double);
+  if (dim1 * (int64_t)sizeof(float) > available_smem) {
+    GTEST_SKIP() << "Not enough shared memory for the partial results";
+  }
+
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::InnerOuterSharedMemory);
+
+  std::unique_ptr<Fusion> fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  auto grad_out = makeContigTensor(2, DataType::Half);
+  auto input = makeContigTensor(2, DataType::Half);
+  auto rstd = makeConcreteTensor({dim0, 1});
+  auto weight = makeContigTensor(1, DataType::Half);
+  fusion.addInput(grad_out);
+  fusion.addInput(input);
+  fusion.addInput(rstd);
+  fusion.addInput(weight);
+
+  auto grads = rms_norm_backward(
+      castOp(DataType::Float, grad_out),
+      castOp(DataType::Float, input),
+      {dim1},
+      rstd,
+      castOp(DataType::Float, weight),
+      {true, true});
+  fusion.addOutput(castOp(DataType::Half, grads.grad_input));
+  fusion.addOutput(castOp(DataType::Half, grads.grad_weight));
+
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+  at::Tensor aten_grad_out = at::randn({dim0, dim1}, options).mul(0.01);
+  at::Tensor aten_input = at::randn({dim0, dim1}, options);
+  at::Tensor aten_weight = at::randn({dim1}, options);
+  at::Tensor aten_rstd =
+      at::rsqrt(aten_input.to(at::kFloat).pow(2).mean(-1, true).add(1e-6));
+  std::vector<c10::IValue> aten_inputs = {
+      aten_grad_out, aten_input, aten_rstd, aten_weight};
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+  auto cg_outputs = fec.runFusionWithInputs(aten_inputs);
+
+  FusionKernelRuntime* runtime = fec.getMostRecentKernelRuntime();
+  ASSERT_FALSE(runtime->isSegmented());
+  const SchedulerEntry* entry = runtime->schedulers().front().get();
+  EXPECT_EQ(entry->heuristic(), ScheduleHeuristic::InnerOuterPersistent);
+  EXPECT_TRUE(
+      entry->params()->as<ReductionParams>()->shared_mem_outer_partial_buffer);
+
+  testValidate(&fusion, cg_outputs, aten_inputs, __LINE__, __FILE__);
+}
+
+// The combined scheduler states the blocks per SM its register budget was
+// chosen for, and the kernel is declared with launch bounds of that target
+TEST_F(NVFuserTest, CombinedSchedulerOccupancyTarget) {
+  const int64_t dim0 = 8192;
+  const int64_t dim1 = 2048;
+
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::OccupancyTargeting);
+
+  std::unique_ptr<Fusion> fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  auto grad_out = makeContigTensor(2, DataType::Half);
+  auto input = makeContigTensor(2, DataType::Half);
+  auto rstd = makeConcreteTensor({dim0, 1});
+  auto weight = makeContigTensor(1, DataType::Half);
+  fusion.addInput(grad_out);
+  fusion.addInput(input);
+  fusion.addInput(rstd);
+  fusion.addInput(weight);
+
+  auto grads = rms_norm_backward(
+      castOp(DataType::Float, grad_out),
+      castOp(DataType::Float, input),
+      {dim1},
+      rstd,
+      castOp(DataType::Float, weight),
+      {true, true});
+  fusion.addOutput(castOp(DataType::Half, grads.grad_input));
+  fusion.addOutput(castOp(DataType::Half, grads.grad_weight));
+
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+  at::Tensor aten_grad_out = at::randn({dim0, dim1}, options).mul(0.01);
+  at::Tensor aten_input = at::randn({dim0, dim1}, options);
+  at::Tensor aten_weight = at::randn({dim1}, options);
+  at::Tensor aten_rstd =
+      at::rsqrt(aten_input.to(at::kFloat).pow(2).mean(-1, true).add(1e-6));
+  std::vector<c10::IValue> aten_inputs = {
+      aten_grad_out, aten_input, aten_rstd, aten_weight};
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+  auto cg_outputs = fec.runFusionWithInputs(aten_inputs);
+
+  FusionKernelRuntime* runtime = fec.getMostRecentKernelRuntime();
+  ASSERT_FALSE(runtime->isSegmented());
+  const SchedulerEntry* entry = runtime->schedulers().front().get();
+  EXPECT_EQ(entry->heuristic(), ScheduleHeuristic::InnerOuterPersistent);
+  EXPECT_GT(entry->params()->cparams.min_blocks_per_sm, 0);
+  EXPECT_NE(
+      fec.getMostRecentCode().find("__launch_bounds__"), std::string::npos);
+
+  testValidate(&fusion, cg_outputs, aten_inputs, __LINE__, __FILE__);
+}
+
 } // namespace nvfuser
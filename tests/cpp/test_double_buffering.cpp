@@ -6,6 +6,9 @@
  */
 // clang-format on
 
+#include <gmock/gmock-matchers.h>
+#include <gtest/gtest.h>
+
 #include <ops/all_ops.h>
 #include <tests/cpp/utils.h>
 #include <tests/cpp/validator.h>
@@ -683,4 +686,110 @@ TEST_F(DoubleBufferingTest, DoubleBufferNoSync) {
   testValidate(&fusion, cg_outputs, {t0, t1}, {ref}, __LINE__, __FILE__);
 }
 
+// Circular buffered cp.async loads synchronized with an mbarrier per stage
+TEST_F(DoubleBufferingTest, CircularBufferCpAsyncMBarrier) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::MBarrierCircularBuffer);
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  int m = 33, n = 48;
+
+  TensorView* tv0 = makeConcreteTensor({m, n});
+  TensorView* tv1 = makeConcreteTensor({m, n});
+
+  fusion.addInput(tv0);
+  fusion.addInput(tv1);
+
+  TensorView* tv2 = add(tv0, tv1);
+
+  fusion.addOutput(tv2);
+
+  auto tv0_shared = tv0->cacheAfter(LoadStoreOpType::CpAsync);
+  tv0_shared->setMemoryType(MemoryType::Shared);
+  tv0->computeAt(tv2, 1);
+
+  tv0_shared->split(1, 4);
+  tv0_shared->axis(-2)->parallelize(ParallelType::TIDx);
+
+  // Consume the loaded tile with a different thread mapping, which would
+  // otherwise need a RAW block sync
+  tv2->split(1, 4);
+  tv2->axis(-1)->parallelize(ParallelType::TIDx);
+
+  tv0_shared->circularBuffer(4);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({m, n}, options);
+  at::Tensor t1 = at::randn({m, n}, options);
+
+  FusionExecutor fe;
+  if (!deviceMajorMinorCheck(8)) {
+    ASSERT_ANY_THROW(fe.compileFusion(&fusion, {t0, t1}));
+    GTEST_SKIP() << "skipping tests on pre-AMPERE GPUs";
+  }
+  fe.compileFusion(&fusion, {t0, t1});
+
+  int64_t num_arrives = 0;
+  int64_t num_waits = 0;
+  for (auto expr :
+       ir_utils::flattenScopedExprs(fe.kernel()->topLevelExprs())) {
+    num_arrives += expr->isA<kir::MBarrierArriveCpAsync>();
+    num_waits += expr->isA<kir::MBarrierWaitParity>();
+    // The only cp.async wait drains the loads beyond the last stage
+    if (auto wait = dynamic_cast<kir::AsyncWait*>(expr)) {
+      EXPECT_EQ(wait->keepStages(), 0);
+    }
+  }
+  // One arrival in the prologue and one in the main loop
+  EXPECT_EQ(num_arrives, 2);
+  EXPECT_EQ(num_waits, 1);
+
+  auto cg_outputs = fe.runFusion({t0, t1});
+
+  auto ref = t0 + t1;
+
+  testValidate(&fusion, cg_outputs, {t0, t1}, {ref}, __LINE__, __FILE__);
+}
+
+// Deep pipeline of the serial loop of a reduction with mbarriers
+TEST_F(DoubleBufferingTest, CircularBufferReductionMBarrier) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::MBarrierCircularBuffer);
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  int m = 100, n = 128;
+
+  TensorView* tv0 = makeContigConcreteTensor({m, n});
+  fusion.addInput(tv0);
+  TensorView* tv1 = sum(tv0, {0});
+  fusion.addOutput(tv1);
+
+  auto tv0_shared = tv0->cacheAfter(LoadStoreOpType::CpAsync);
+  tv0_shared->setMemoryType(MemoryType::Shared);
+
+  // [rm, n], the serial reduction loop is the circular buffer loop
+  tv1->axis(1)->parallelize(ParallelType::TIDx);
+  tv0_shared->computeAt(tv1, 1);
+  tv0_shared->axis(1)->parallelize(ParallelType::TIDx);
+  tv0_shared->circularBuffer(6);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({m, n}, options);
+
+  FusionExecutor fe;
+  if (!deviceMajorMinorCheck(8)) {
+    ASSERT_ANY_THROW(fe.compileFusion(&fusion, {t0}));
+    GTEST_SKIP() << "skipping tests on pre-AMPERE GPUs";
+  }
+  fe.compileFusion(&fusion, {t0});
+  EXPECT_THAT(fe.kernelString(), ::testing::HasSubstr("mbarrier::waitParity"));
+  auto cg_outputs = fe.runFusion({t0});
+
+  testValidate(&fusion, cg_outputs, {t0}, {t0.sum(0)}, __LINE__, __FILE__);
+}
+
 } // namespace nvfuser
@@ -731,6 +731,39 @@ TEST_F(NVFuserTest, DynamicTransformFusionExecutorCache_CUDA) {
   }
 }
 
+// Inputs that only differ in non-structural extents reuse the cached
+// concretization, even when each of them needs a new runtime
+TEST_F(NVFuserTest, DynamicTransformReuseConcretization_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = makeSymbolicTensor(1);
+  fusion->addInput(tv1);
+  auto tv2 = reshape(tv0, {tv1->axis(0)->extent()});
+  auto tv3 = add(tv1, tv2);
+  fusion->addOutput(tv3);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  DisableOptionsGuard opt_guard;
+  DisableOptionsGuard::getCurOptions().set(DisableOption::KernelReuse);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  for (int64_t rows : {3, 5, 7}) {
+    auto t0 = at::randn({rows, 4}, options);
+    auto t1 = at::randn({rows * 4}, options);
+    std::vector<c10::IValue> inputs = {t0, t1};
+    auto cg_outputs = executor_cache.runFusionWithInputs(inputs);
+    testValidate(
+        executor_cache.fusion(), cg_outputs, inputs, __LINE__, __FILE__);
+  }
+  EXPECT_EQ(executor_cache.countRuntimes(), 3);
+  EXPECT_EQ(executor_cache.countConcretizations(), 1);
+  EXPECT_EQ(executor_cache.countConcretizationInfos(), 1);
+}
+
 using shape_t = std::vector<int64_t>;
 using dynamic_view_invocation = std::tuple<
     shape_t, // input_shape
@@ -12,6 +12,8 @@
 
 #include <tests/cpp/utils.h>
 
+#include <evaluator_common.h>
+#include <executor_kernel_arg.h>
 #include <expr_evaluator.h>
 #include <fusion.h>
 #include <ops/all_ops.h>
@@ -561,6 +563,128 @@ TEST_F(ExprEvalTest, TernaryOps) {
   }
 }
 
+//! Test integer extents evaluated by PrecomputedValues, some of which depend
+//! on floating point values
+TEST_F(ExprEvalTest, PrecomputedIntegerValues) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  TensorView* tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  Val* s0 = IrBuilder::create<Val>(DataType::Int);
+  fusion.addInput(s0);
+
+  Val* e0 = ceilDiv(tv0->axis(0)->extent(), s0);
+  Val* e1 = IrBuilder::maxExpr(
+      mod(tv0->axis(1)->extent(), s0), sub(s0, IrBuilder::create<Val>(1L)));
+  Val* e2 = castOp(
+      DataType::Int,
+      mul(castOp(DataType::Double, e0), IrBuilder::create<Val>(1.5)));
+  Val* e3 = add(e2, e1);
+  TensorView* tv1 =
+      full({e0, e1, e2, e3}, IrBuilder::create<Val>(0.0), DataType::Float);
+  fusion.addOutput(tv1);
+
+  PrecomputedValues pv(&fusion);
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  for (int64_t s : {3L, 4L}) {
+    at::Tensor t0 = at::empty({10, 7}, options);
+    KernelArgumentHolder args =
+        KernelArgumentHolder::createKernelArgumentHolder({t0, s});
+    pv.bindInputs(args);
+    pv.evaluate();
+
+    const int64_t expected_e0 = (10 + s - 1) / s;
+    const int64_t expected_e1 = std::max(7 % s, s - 1);
+    const int64_t expected_e2 = (int64_t)((double)expected_e0 * 1.5);
+    EXPECT_EQ(pv.getMaybeValueFor(e0), expected_e0);
+    EXPECT_EQ(pv.getMaybeValueFor(e1), expected_e1);
+    EXPECT_EQ(pv.getMaybeValueFor(e2), expected_e2);
+    EXPECT_EQ(pv.getMaybeValueFor(e3), expected_e2 + expected_e1);
+  }
+}
+
+//! Test extents evaluated by PrecomputedValues through comparisons, where
+//! and floating point math, some of which are left to the general path as
+//! they mix integer and floating point operands
+TEST_F(ExprEvalTest, PrecomputedScalarValues) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  TensorView* tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  Val* s0 = IrBuilder::create<Val>(DataType::Int);
+  fusion.addInput(s0);
+  Val* d0 = IrBuilder::create<Val>(DataType::Double);
+  fusion.addInput(d0);
+
+  Val* e0 = tv0->axis(0)->extent();
+  Val* e1 = tv0->axis(1)->extent();
+  // A floating point division by zero is an infinity rather than an error
+  Val* is_inf = gt(div(d0, IrBuilder::create<Val>(0.0)), d0);
+  Val* is_less = logical_and(logical_and(lt(e0, s0), ne(e1, s0)), is_inf);
+  Val* e2 = where(is_less, e0, s0);
+  Val* e3 = castOp(DataType::Int, mul(d0, castOp(DataType::Double, e1)));
+  Val* e4 = castOp(DataType::Int, IrBuilder::addExpr(d0, s0));
+  Val* e5 = add(e2, add(e3, e4));
+  TensorView* tv1 = full(
+      {e2, e3, e4, e5}, IrBuilder::create<Val>(0.0), DataType::Float);
+  fusion.addOutput(tv1);
+
+  PrecomputedValues pv(&fusion);
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  for (int64_t s : {7L, 12L}) {
+    const double d = 2.5;
+    at::Tensor t0 = at::empty({10, 7}, options);
+    KernelArgumentHolder args =
+        KernelArgumentHolder::createKernelArgumentHolder({t0, s, d});
+    pv.bindInputs(args);
+    pv.evaluate();
+
+    const int64_t expected_e2 = (10 < s && 7 != s) ? 10 : s;
+    const int64_t expected_e3 = (int64_t)(d * 7.0);
+    const int64_t expected_e4 = (int64_t)(d + (double)s);
+    EXPECT_EQ(pv.getMaybeValueFor(is_inf), true);
+    EXPECT_EQ(pv.getMaybeValueFor(is_less), 10 < s && 7 != s);
+    EXPECT_EQ(pv.getMaybeValueFor(e2), expected_e2);
+    EXPECT_EQ(pv.getMaybeValueFor(e3), expected_e3);
+    EXPECT_EQ(pv.getMaybeValueFor(e4), expected_e4);
+    EXPECT_EQ(
+        pv.getMaybeValueFor(e5), expected_e2 + expected_e3 + expected_e4);
+  }
+}
+
+//! Test that PrecomputedValues updates values after only some of the inputs
+//! change
+TEST_F(ExprEvalTest, PrecomputedIncrementalEvaluation) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  Val* a = IrBuilder::create<Val>(DataType::Int);
+  Val* b = IrBuilder::create<Val>(DataType::Int);
+  fusion.addInput(a);
+  fusion.addInput(b);
+  Val* e0 = mul(a, IrBuilder::create<Val>(2L));
+  Val* e1 = add(b, IrBuilder::create<Val>(1L));
+  Val* e2 = add(e0, e1);
+  TensorView* tv0 =
+      full({e0, e1, e2}, IrBuilder::create<Val>(0.0), DataType::Float);
+  fusion.addOutput(tv0);
+
+  PrecomputedValues pv(&fusion);
+  for (auto [a_value, b_value] : std::vector<std::pair<int64_t, int64_t>>{
+           {3, 4}, {3, 5}, {3, 5}, {6, 5}, {3, 4}}) {
+    KernelArgumentHolder args =
+        KernelArgumentHolder::createKernelArgumentHolder({a_value, b_value});
+    pv.bindInputs(args);
+    pv.evaluate();
+    EXPECT_TRUE(pv.hasValidValues());
+    EXPECT_EQ(pv.getMaybeValueFor(e0), a_value * 2);
+    EXPECT_EQ(pv.getMaybeValueFor(e1), b_value + 1);
+    EXPECT_EQ(pv.getMaybeValueFor(e2), a_value * 2 + b_value + 1);
+  }
+}
+
 TEST_F(ExprEvalTest, Permute) {
   Fusion fusion;
   FusionGuard fg(&fusion);
@@ -0,0 +1,747 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <gmock/gmock-matchers.h>
+#include <gtest/gtest.h>
+
+#include <fusion.h>
+#include <kernel_cache.h>
+#include <memory_planner.h>
+#include <ops/all_ops.h>
+#include <options.h>
+#include <scheduler/autotune.h>
+#include <scheduler/pointwise_heuristic.h>
+#include <scheduler/utils.h>
+#include <tests/cpp/utils.h>
+#include <tests/cpp/validator.h>
+
+namespace nvfuser {
+
+using FusionKernelRuntimeTest = NVFuserTest;
+
+TEST_F(FusionKernelRuntimeTest, CudaGraphReplay) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::CudaGraph);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  TensorView* tv1 = add(tv0, IrBuilder::create<Val>(1.0));
+  TensorView* tv2 = segment_set(tv1);
+  TensorView* tv3 = sum(tv2, {1});
+  fusion->addOutput(tv3);
+
+  FusionExecutorCache fec(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({128, 1024}, options);
+
+  // The first run is eager, the second one captures and the third one
+  // replays the graph.
+  for (auto i : c10::irange(3)) {
+    auto outputs = fec.runFusionWithInputs({t0});
+    FusionKernelRuntime* runtime = fec.getMostRecentKernelRuntime();
+    EXPECT_TRUE(runtime->isSegmented());
+    EXPECT_EQ(runtime->numCapturedCudaGraphs(), i == 0 ? 0 : 1);
+    testValidate(fec.fusion(), outputs, {t0}, __LINE__, __FILE__);
+  }
+
+  // Replaying reads through the captured data pointer, so in-place updates
+  // of the input are visible
+  t0.mul_(2.0);
+  auto outputs = fec.runFusionWithInputs({t0});
+  testValidate(fec.fusion(), outputs, {t0}, __LINE__, __FILE__);
+
+  // A different input pointer falls back to an eager warm-up run
+  at::Tensor t1 = at::randn({128, 1024}, options);
+  outputs = fec.runFusionWithInputs({t1});
+  EXPECT_EQ(fec.getMostRecentKernelRuntime()->numCapturedCudaGraphs(), 0);
+  testValidate(fec.fusion(), outputs, {t1}, __LINE__, __FILE__);
+}
+
+TEST_F(FusionKernelRuntimeTest, MultiStreamIndependentSegments) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::MultiStreamSegments, {"3"});
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  // Three independent branches joined by a final segment
+  TensorView* tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  TensorView* tv1 = segment_set(sum(tv0, {0}));
+  TensorView* tv2 = segment_set(sum(mul(tv0, tv0), {0}));
+  TensorView* tv3 = segment_set(max(tv0, {0}));
+  TensorView* tv4 = add(add(tv1, tv2), tv3);
+  fusion->addOutput(tv1);
+  fusion->addOutput(tv4);
+
+  FusionExecutorCache fec(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1024, 128}, options);
+
+  for (auto i : c10::irange(2)) {
+    (void)i; // Suppress unused variable warning
+    auto outputs = fec.runFusionWithInputs({t0});
+    EXPECT_TRUE(fec.getMostRecentKernelRuntime()->isSegmented());
+    testValidate(fec.fusion(), outputs, {t0}, __LINE__, __FILE__);
+  }
+}
+
+// The inputs of later segments are inferred from the outputs of earlier ones
+// before the heuristics of all segments are computed in parallel. They have to
+// match the heuristics computed one segment at a time.
+TEST_F(FusionKernelRuntimeTest, ParallelSegmentHeuristics) {
+  auto make_fusion = []() {
+    auto fusion = std::make_unique<Fusion>();
+    FusionGuard fg(fusion.get());
+    TensorView* tv0 = makeContigTensor(2);
+    fusion->addInput(tv0);
+    TensorView* tv1 = segment_set(sin(tv0));
+    TensorView* tv2 = segment_set(sum(tv1, {0}));
+    TensorView* tv3 = segment_set(exp(tv2));
+    TensorView* tv4 = sum(mul(tv0, tv0), {1});
+    fusion->addOutput(tv3);
+    fusion->addOutput(tv4);
+    return fusion;
+  };
+
+  FusionExecutorCache parallel_fec(make_fusion());
+  FusionExecutorCache serial_fec(make_fusion());
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  for (const auto& sizes :
+       std::vector<std::vector<int64_t>>{{1024, 128}, {37, 4099}}) {
+    at::Tensor t0 = at::randn(sizes, options);
+    auto outputs = parallel_fec.runFusionWithInputs({t0});
+    testValidate(parallel_fec.fusion(), outputs, {t0}, __LINE__, __FILE__);
+    {
+      DisableOptionsGuard opt_guard;
+      DisableOptionsGuard::getCurOptions().set(DisableOption::ParallelCompile);
+      serial_fec.runFusionWithInputs({t0});
+    }
+
+    FusionKernelRuntime* parallel_runtime =
+        parallel_fec.getMostRecentKernelRuntime();
+    FusionKernelRuntime* serial_runtime =
+        serial_fec.getMostRecentKernelRuntime();
+    ASSERT_TRUE(parallel_runtime->isSegmented());
+    const auto& parallel_heuristics =
+        parallel_runtime->schedulerHeuristics()->heuristicsList();
+    const auto& serial_heuristics =
+        serial_runtime->schedulerHeuristics()->heuristicsList();
+    ASSERT_EQ(parallel_heuristics.size(), serial_heuristics.size());
+    for (auto i : c10::irange(parallel_heuristics.size())) {
+      EXPECT_EQ(
+          parallel_heuristics[i]->heuristic(),
+          serial_heuristics[i]->heuristic());
+      EXPECT_TRUE(parallel_heuristics[i]->params()->sameAs(
+          serial_heuristics[i]->params()))
+          << "Heuristics of segment " << i << " differ:\n"
+          << parallel_heuristics[i]->params()->toString() << "\n"
+          << serial_heuristics[i]->params()->toString();
+    }
+  }
+}
+
+TEST_F(FusionKernelRuntimeTest, BufferPoolRecyclesReleasedOutputs) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::BufferPool);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  TensorView* tv1 = sin(tv0);
+  fusion->addOutput(tv1);
+
+  FusionExecutorCache fec(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({128, 64}, options);
+
+  auto held_outputs = fec.runFusionWithInputs({t0});
+  testValidate(fec.fusion(), held_outputs, {t0}, __LINE__, __FILE__);
+
+  // The first output is still referenced, so it must not be recycled
+  auto outputs = fec.runFusionWithInputs({t0});
+  EXPECT_NE(outputs[0].data_ptr(), held_outputs[0].data_ptr());
+  testValidate(fec.fusion(), outputs, {t0}, __LINE__, __FILE__);
+
+  // Once released, the pooled buffer is handed out again
+  void* released_ptr = outputs[0].data_ptr();
+  outputs.clear();
+  outputs = fec.runFusionWithInputs({t0});
+  EXPECT_EQ(outputs[0].data_ptr(), released_ptr);
+  testValidate(fec.fusion(), outputs, {t0}, __LINE__, __FILE__);
+}
+
+TEST_F(FusionKernelRuntimeTest, PlanMemoryReusesDeadBuffers) {
+  // Buffer 0 dies before 2 is produced, so they can share memory. Buffer 1
+  // is live together with both of them.
+  std::vector<BufferLifetime> lifetimes{
+      {0, 1, 1000}, {1, 3, 500}, {2, 3, 1000}, {4, 4, 100}};
+  MemoryPlan plan = planMemory(lifetimes, /*alignment=*/256);
+
+  ASSERT_EQ(plan.offsets.size(), lifetimes.size());
+  EXPECT_EQ(plan.offsets[0], plan.offsets[2]);
+  EXPECT_EQ(plan.total_bytes, 1024 + 512 + 1024 + 256);
+  EXPECT_EQ(plan.peak_live_bytes, 1024 + 512);
+  EXPECT_EQ(plan.arena_bytes, plan.peak_live_bytes);
+
+  for (auto i : c10::irange(lifetimes.size())) {
+    EXPECT_EQ(plan.offsets[i] % 256, 0);
+    for (auto j : c10::irange(i)) {
+      bool live_together = lifetimes[i].first_use <= lifetimes[j].last_use &&
+          lifetimes[j].first_use <= lifetimes[i].last_use;
+      bool share_memory =
+          plan.offsets[i] < plan.offsets[j] + lifetimes[j].size_bytes &&
+          plan.offsets[j] < plan.offsets[i] + lifetimes[i].size_bytes;
+      EXPECT_FALSE(live_together && share_memory)
+          << "Buffers " << i << " and " << j << " overlap";
+    }
+  }
+}
+
+TEST_F(FusionKernelRuntimeTest, SegmentMemoryPlanning) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::SegmentMemoryPlanning);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  // A chain of segments where each intermediate is only used by the next
+  // segment
+  TensorView* tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  TensorView* tv1 = segment_set(sin(tv0));
+  TensorView* tv2 = segment_set(cos(tv1));
+  TensorView* tv3 = segment_set(exp(tv2));
+  TensorView* tv4 = sum(tv3, {1});
+  fusion->addOutput(tv4);
+
+  FusionExecutorCache fec(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({256, 1024}, options);
+
+  for (auto i : c10::irange(2)) {
+    (void)i; // Suppress unused variable warning
+    auto outputs = fec.runFusionWithInputs({t0});
+    EXPECT_TRUE(fec.getMostRecentKernelRuntime()->isSegmented());
+    testValidate(fec.fusion(), outputs, {t0}, __LINE__, __FILE__);
+  }
+}
+
+TEST_F(FusionKernelRuntimeTest, SegmentSlots) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::SegmentSlots);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  // A chain of segments, with an input forwarded to the outputs and an
+  // intermediate that is also an output
+  TensorView* tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  TensorView* tv1 = segment_set(sin(tv0));
+  TensorView* tv2 = segment_set(cos(tv1));
+  TensorView* tv3 = sum(exp(tv2), {1});
+  fusion->addOutput(tv3);
+  fusion->addOutput(tv1);
+  fusion->addOutput(tv0);
+
+  FusionExecutorCache fec(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({256, 1024}, options);
+
+  for (auto i : c10::irange(2)) {
+    (void)i; // Suppress unused variable warning
+    auto outputs = fec.runFusionWithInputs({t0});
+    FusionKernelRuntime* runtime = fec.getMostRecentKernelRuntime();
+    EXPECT_TRUE(runtime->isSegmented());
+    testValidate(fec.fusion(), outputs, {t0}, __LINE__, __FILE__);
+  }
+
+  // The output of the second segment is released once the last segment has
+  // read it, while tv1 is kept as it is a fusion output
+  const auto& args_num =
+      fec.getMostRecentKernelRuntime()->getArgsNumAfterSegmentRuns();
+  ASSERT_GE(args_num.size(), 3);
+  EXPECT_EQ(args_num.at(2), args_num.at(1));
+}
+
+TEST_F(FusionKernelRuntimeTest, HorizontalFusion) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::HorizontalFusion);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  // Like an optimizer step, each parameter is updated independently, which
+  // gives a pointwise segment per parameter
+  std::vector<int64_t> sizes = {1000, 3000, 70};
+  for (auto i : c10::irange(sizes.size())) {
+    (void)i; // Suppress unused variable warning
+    TensorView* param = makeContigTensor(1);
+    TensorView* grad = makeContigTensor(1);
+    fusion->addInput(param);
+    fusion->addInput(grad);
+    fusion->addOutput(sub(param, mul(grad, IrBuilder::create<Val>(0.1))));
+  }
+
+  FusionExecutorCache fec(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  std::vector<c10::IValue> inputs;
+  for (auto size : sizes) {
+    inputs.push_back(at::randn({size}, options));
+    inputs.push_back(at::randn({size}, options));
+  }
+
+  for (auto i : c10::irange(2)) {
+    (void)i; // Suppress unused variable warning
+    auto outputs = fec.runFusionWithInputs(inputs);
+    FusionKernelRuntime* runtime = fec.getMostRecentKernelRuntime();
+    EXPECT_TRUE(runtime->isSegmented());
+    ASSERT_EQ(runtime->horizontalKernels().size(), 1);
+    const auto& horizontal_kernel =
+        runtime->horizontalKernels().begin()->second;
+    EXPECT_EQ(horizontal_kernel->numKernels(), (int64_t)sizes.size());
+    // All segments use the same blocks, so they were launched together
+    EXPECT_TRUE(horizontal_kernel->isCompiled());
+    testValidate(fec.fusion(), outputs, inputs, __LINE__, __FILE__);
+  }
+}
+
+TEST_F(FusionKernelRuntimeTest, AsyncCompileFallsBackToExpressionEvaluator) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::AsyncCompile);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  TensorView* tv1 = sin(tv0);
+  TensorView* tv2 = sum(tv1, {1});
+  fusion->addOutput(tv1);
+  fusion->addOutput(tv2);
+
+  FusionExecutorCache fec(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({128, 1024}, options);
+
+  // The first run returns results immediately, whether or not the kernels
+  // have been compiled yet
+  auto outputs = fec.runFusionWithInputs({t0});
+  testValidate(fec.fusion(), outputs, {t0}, __LINE__, __FILE__);
+
+  FusionKernelRuntime* runtime = fec.getMostRecentKernelRuntime();
+  runtime->waitForAsyncCompile();
+  EXPECT_FALSE(runtime->isCompiling());
+  EXPECT_TRUE(runtime->isCompiled());
+
+  outputs = fec.runFusionWithInputs({t0});
+  EXPECT_EQ(fec.getMostRecentKernelRuntime(), runtime);
+  testValidate(fec.fusion(), outputs, {t0}, __LINE__, __FILE__);
+}
+
+TEST_F(FusionKernelRuntimeTest, PrecompileInputSignatures) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  TensorView* tv1 = sum(sin(tv0), {1});
+  fusion->addOutput(tv1);
+
+  FusionExecutorCache fec(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  // A reduction and a much larger one that needs a different heuristic
+  std::vector<std::vector<c10::IValue>> inputs_list{
+      {at::empty({128, 64}, options)}, {at::empty({16, 1 << 20}, options)}};
+  // The same signature twice is only compiled once
+  inputs_list.push_back(inputs_list.front());
+
+  size_t num_compiled = fec.precompile(inputs_list);
+  EXPECT_GE(num_compiled, 1);
+  EXPECT_EQ(fec.countRuntimes(), num_compiled);
+  // Nothing left to compile
+  EXPECT_EQ(fec.precompile(inputs_list), 0);
+
+  for (const auto& inputs : inputs_list) {
+    at::Tensor t0 = at::randn(inputs[0].toTensor().sizes(), options);
+    EXPECT_TRUE(fec.isCompiled({t0}));
+    auto outputs = fec.runFusionWithInputs({t0});
+    testValidate(fec.fusion(), outputs, {t0}, __LINE__, __FILE__);
+  }
+  EXPECT_EQ(fec.countRuntimes(), num_compiled);
+}
+
+TEST_F(FusionKernelRuntimeTest, ShapeBucketsReuseKernels) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::ShapeBuckets);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  TensorView* tv1 = mul(sin(tv0), IrBuilder::create<Val>(2.0));
+  fusion->addOutput(tv1);
+
+  FusionExecutorCache fec(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  // Sequence lengths in (2048, 4096] share a bucket
+  for (int64_t seq_len : {2052, 3000, 4096}) {
+    at::Tensor t0 = at::randn({8, seq_len}, options);
+    auto outputs = fec.runFusionWithInputs({t0});
+    testValidate(fec.fusion(), outputs, {t0}, __LINE__, __FILE__);
+  }
+  EXPECT_EQ(fec.countRuntimes(), 1);
+
+  // User-supplied bucket bounds. Sequence lengths in (8, 16384] share the
+  // bucket of the runtime above, though they span several powers of two.
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::ShapeBuckets, {"8", "16384", "65536"});
+  for (int64_t seq_len : {5000, 9000, 16384}) {
+    at::Tensor t0 = at::randn({8, seq_len}, options);
+    auto outputs = fec.runFusionWithInputs({t0});
+    testValidate(fec.fusion(), outputs, {t0}, __LINE__, __FILE__);
+  }
+  EXPECT_EQ(fec.countRuntimes(), 1);
+}
+
+TEST_F(FusionKernelRuntimeTest, HeuristicCacheIgnoresSizeOneStrides) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::HeuristicCache);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* tv0 = makeSymbolicTensor(3);
+  fusion->addInput(tv0);
+  TensorView* tv1 = mul(sin(tv0), IrBuilder::create<Val>(2.0));
+  fusion->addOutput(tv1);
+
+  FusionExecutorCache fec(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor large = at::randn({64, 1, 4096}, options);
+  at::Tensor small = at::randn({2, 1, 128}, options);
+  // Same as large except for the stride of the size-1 dimension, so its
+  // cache ID differs but its heuristics are those of large
+  at::Tensor strided = at::randn({64, 4096}, options)
+                           .as_strided({64, 1, 4096}, {4096, 7, 1});
+  for (const auto& t0 : {large, small, strided}) {
+    auto outputs = fec.runFusionWithInputs({t0});
+    // strided must be launched with the launch params of large rather than
+    // those of the most recent inputs
+    testValidate(fec.fusion(), outputs, {t0}, __LINE__, __FILE__);
+  }
+  EXPECT_EQ(fec.countRuntimes(), 1);
+}
+
+TEST_F(FusionKernelRuntimeTest, RunFusionWithTensorsRelaunchesKernel) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* tv0 = makeContigTensor(2);
+  TensorView* tv1 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  TensorView* tv2 = add(sin(tv0), tv1);
+  fusion->addOutput(tv2);
+
+  FusionExecutorCache fec(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor out = at::empty({128, 256}, options);
+  for (auto i : c10::irange(3)) {
+    (void)i; // Suppress unused variable warning
+    // New input buffers with the same signature every time
+    at::Tensor t0 = at::randn({128, 256}, options);
+    at::Tensor t1 = at::randn({128, 256}, options);
+    fec.runFusionWithTensors({t0, t1}, {out});
+    testValidate(fec.fusion(), {out}, {t0, t1}, __LINE__, __FILE__);
+  }
+  EXPECT_EQ(fec.countRuntimes(), 1);
+
+  // A different signature goes through the regular path again
+  at::Tensor t0 = at::randn({64, 256}, options);
+  at::Tensor t1 = at::randn({64, 256}, options);
+  out = at::empty({64, 256}, options);
+  fec.runFusionWithTensors({t0, t1}, {out});
+  testValidate(fec.fusion(), {out}, {t0, t1}, __LINE__, __FILE__);
+}
+
+TEST_F(FusionKernelRuntimeTest, PreallocatedOutputs) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  TensorView* tv1 = segment_set(sin(tv0));
+  TensorView* tv2 = sum(tv1, {1});
+  fusion->addOutput(tv1);
+  fusion->addOutput(tv2);
+
+  FusionExecutorCache fec(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({128, 256}, options);
+  at::Tensor out1 = at::empty({128, 256}, options);
+  at::Tensor out2 = at::empty({128}, options);
+  for (auto i : c10::irange(2)) {
+    (void)i; // Suppress unused variable warning
+    std::vector<at::Tensor> outputs =
+        fec.runFusionWithInputs({t0}, std::nullopt, std::nullopt, {out1, out2});
+    EXPECT_TRUE(fec.getMostRecentKernelRuntime()->isSegmented());
+    ASSERT_EQ(outputs.size(), 2);
+    // Both segments write into the given buffers
+    EXPECT_EQ(outputs[0].data_ptr(), out1.data_ptr());
+    EXPECT_EQ(outputs[1].data_ptr(), out2.data_ptr());
+    testValidate(fec.fusion(), {out1, out2}, {t0}, __LINE__, __FILE__);
+  }
+
+  // Undefined outputs are allocated as usual
+  std::vector<at::Tensor> outputs = fec.runFusionWithInputs(
+      {t0}, std::nullopt, std::nullopt, {at::Tensor(), out2});
+  EXPECT_EQ(outputs[1].data_ptr(), out2.data_ptr());
+  testValidate(fec.fusion(), outputs, {t0}, __LINE__, __FILE__);
+
+  // Outputs that don't match the allocation of the fusion are rejected
+  at::Tensor transposed = at::empty({256, 128}, options).t();
+  EXPECT_THAT(
+      [&]() {
+        fec.runFusionWithInputs(
+            {t0}, std::nullopt, std::nullopt, {transposed, out2});
+      },
+      ::testing::ThrowsMessage<nvfError>(
+          ::testing::HasSubstr("does not match the cached output")));
+  EXPECT_THAT(
+      [&]() {
+        fec.runFusionWithInputs({t0}, std::nullopt, std::nullopt, {out1});
+      },
+      ::testing::ThrowsMessage<nvfError>(
+          ::testing::HasSubstr("preallocated outputs but got")));
+}
+
+TEST_F(FusionKernelRuntimeTest, AutotuneCandidates) {
+  auto params = std::make_shared<PointwiseParams>();
+  params->vectorize = true;
+  params->unroll_factor = 4;
+  auto candidates = getAutotuneCandidates(ScheduleHeuristic::PointWise, params);
+  // Vectorized by 4 and 2, not vectorized, and unrolled by 4
+  ASSERT_EQ(candidates.size(), 4);
+  EXPECT_EQ(candidates.front(), params);
+  std::vector<std::pair<bool, int64_t>> factors;
+  for (const auto& candidate : candidates) {
+    auto pparams = std::dynamic_pointer_cast<PointwiseParams>(candidate);
+    ASSERT_NE(pparams, nullptr);
+    factors.emplace_back(pparams->vectorize, pparams->unroll_factor);
+  }
+  EXPECT_THAT(
+      factors,
+      ::testing::ElementsAre(
+          std::make_pair(true, 4),
+          std::make_pair(true, 2),
+          std::make_pair(false, 1),
+          std::make_pair(false, 4)));
+
+  // Candidates are truncated without reordering them
+  candidates = getAutotuneCandidates(ScheduleHeuristic::PointWise, params, 2);
+  ASSERT_EQ(candidates.size(), 2);
+  EXPECT_EQ(candidates.front(), params);
+
+  // Heuristics without tunable knobs only have the analytic candidate
+  EXPECT_EQ(
+      getAutotuneCandidates(ScheduleHeuristic::Transpose, params).size(), 1);
+}
+
+TEST_F(FusionKernelRuntimeTest, Autotune) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::Autotune);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  TensorView* tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  fusion->addOutput(sum(tv0, {1}));
+
+  FusionExecutorCache fec(std::move(fusion));
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1024, 4096}, options);
+
+  for (auto i : c10::irange(2)) {
+    (void)i; // Suppress unused variable warning
+    auto outputs = fec.runFusionWithInputs({t0});
+    FusionKernelRuntime* runtime = fec.getMostRecentKernelRuntime();
+    ASSERT_EQ(runtime->schedulers().size(), 1);
+    ASSERT_EQ(runtime->autotunedCandidates().size(), 1);
+    const SchedulerEntry* entry = runtime->schedulers().front().get();
+    EXPECT_EQ(entry->heuristic(), ScheduleHeuristic::Reduction);
+    EXPECT_GE(runtime->autotunedCandidates().front(), 0);
+    testValidate(fec.fusion(), outputs, {t0}, __LINE__, __FILE__);
+  }
+  // The same runtime is used for the second run
+  EXPECT_EQ(fec.countRuntimes(), 1);
+}
+
+TEST_F(FusionKernelRuntimeTest, SweepLaunchConfigs) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  TensorView* tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  fusion->addOutput(sum(tv0, {1}));
+
+  FusionExecutorCache fec(std::move(fusion));
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1024, 4096}, options);
+  auto outputs = fec.runFusionWithInputs({t0});
+  const auto params = fec.getMostRecentKernelRuntime()
+                          ->schedulers()
+                          .front()
+                          ->params()
+                          ->clone();
+
+  const std::vector<LaunchConfigSweepResult> results =
+      fec.sweepLaunchConfigs({t0}, 4);
+  ASSERT_GT(results.size(), 1);
+  ASSERT_LE(results.size(), 4);
+  EXPECT_EQ(results.front().candidate, 0);
+  EXPECT_TRUE(results.front().valid);
+  EXPECT_GT(results.front().time_ms, 0.0);
+  EXPECT_GT(results.front().occupancy, 0.0f);
+  EXPECT_TRUE(std::any_of(
+      results.begin(), results.end(), [](const LaunchConfigSweepResult& r) {
+        return r.pareto_optimal;
+      }));
+  EXPECT_THAT(toString(results), ::testing::HasSubstr("Segment 0:"));
+
+  // The sweep leaves the cached kernel as it was
+  EXPECT_EQ(fec.countRuntimes(), 1);
+  EXPECT_TRUE(fec.getMostRecentKernelRuntime()
+                  ->schedulers()
+                  .front()
+                  ->params()
+                  ->sameAs(params));
+  outputs = fec.runFusionWithInputs({t0});
+  testValidate(fec.fusion(), outputs, {t0}, __LINE__, __FILE__);
+}
+
+TEST_F(FusionKernelRuntimeTest, RegisterUsageEstimate) {
+  auto estimate = [](int64_t factor) {
+    Fusion fusion;
+    FusionGuard fg(&fusion);
+    TensorView* tv0 = makeContigTensor(1);
+    fusion.addInput(tv0);
+    TensorView* tv1 = set(tv0);
+    TensorView* tv2 = set(tv1);
+    fusion.addOutput(tv2);
+    // tv1 is a local buffer of factor elements
+    tv2->split(0, factor);
+    tv1->computeAt(tv2, 1);
+    return scheduler_utils::estimateScheduledRegisterUsage(
+        &fusion, CompileParams());
+  };
+  const int64_t estimate_64 = estimate(64);
+  const int64_t estimate_128 = estimate(128);
+  EXPECT_GE(estimate_64, 64 + scheduler_utils::register_overhead);
+  EXPECT_GE(estimate_128, 128 + scheduler_utils::register_overhead);
+  EXPECT_GT(estimate_128, estimate_64);
+}
+
+TEST_F(FusionKernelRuntimeTest, RegisterPressureFallbackParams) {
+  auto params = std::make_shared<PointwiseParams>();
+  params->vectorize = true;
+  params->unroll_factor = 2;
+  auto fallback = std::dynamic_pointer_cast<PointwiseParams>(
+      getRegisterPressureFallback(ScheduleHeuristic::PointWise, params));
+  ASSERT_NE(fallback, nullptr);
+  EXPECT_EQ(fallback->unroll_factor, 1);
+  EXPECT_FALSE(fallback->vectorize);
+  // Nothing is left to lower
+  EXPECT_EQ(
+      getRegisterPressureFallback(ScheduleHeuristic::PointWise, fallback),
+      nullptr);
+  EXPECT_EQ(
+      getRegisterPressureFallback(ScheduleHeuristic::Transpose, params),
+      nullptr);
+}
+
+TEST_F(FusionKernelRuntimeTest, RegisterPressureFallback) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::RegisterPressureFallback);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  TensorView* tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  fusion->addOutput(sum(tv0, {1}));
+
+  FusionExecutorCache fec(std::move(fusion));
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1024, 4096}, options);
+  auto outputs = fec.runFusionWithInputs({t0});
+  FusionKernelRuntime* runtime = fec.getMostRecentKernelRuntime();
+  ASSERT_EQ(runtime->executors().size(), 1);
+  // The kernel of the fallback, if any, doesn't spill
+  EXPECT_LE(runtime->executors().front().getKernelRegisterSpills(), 0);
+  testValidate(fec.fusion(), outputs, {t0}, __LINE__, __FILE__);
+}
+
+TEST_F(FusionKernelRuntimeTest, KernelRuntimeLruEviction) {
+  auto make_fec = [](BinaryOpType op_type) {
+    auto fusion = std::make_unique<Fusion>();
+    FusionGuard fg(fusion.get());
+    TensorView* tv0 = makeContigTensor(1);
+    fusion->addInput(tv0);
+    fusion->addOutput(binaryOp(op_type, tv0, tv0));
+    return std::make_unique<FusionExecutorCache>(std::move(fusion));
+  };
+  auto fec0 = make_fec(BinaryOpType::Add);
+  auto fec1 = make_fec(BinaryOpType::Mul);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1024}, options);
+  auto& lru = KernelRuntimeLru::get();
+  const auto before = lru.stats();
+
+  fec0->runFusionWithInputs({t0});
+  fec1->runFusionWithInputs({t0});
+  EXPECT_EQ(lru.stats().misses, before.misses + 2);
+  EXPECT_GE(lru.stats().memory_bytes, before.memory_bytes);
+
+  // Only the runtime of fec1, which just ran, is kept
+  lru.setMemoryBudget(0);
+  fec1->runFusionWithInputs({t0});
+  EXPECT_EQ(lru.stats().hits, before.hits + 1);
+  EXPECT_GE(lru.stats().evictions, before.evictions + 1);
+  EXPECT_EQ(fec0->getMostRecentKernelRuntime(), nullptr);
+
+  // The evicted runtime is rebuilt, and the one of fec1 is evicted
+  auto outputs = fec0->runFusionWithInputs({t0});
+  EXPECT_EQ(lru.stats().misses, before.misses + 3);
+  EXPECT_EQ(fec1->getMostRecentKernelRuntime(), nullptr);
+  testValidate(fec0->fusion(), outputs, {t0}, __LINE__, __FILE__);
+
+  lru.setMemoryBudget(-1);
+}
+
+} // namespace nvfuser
@@ -6,6 +6,7 @@
  */
 // clang-format on
 #include <csrc/exceptions.h>
+#include <bandwidth_log.h>
 #include <gmock/gmock-matchers.h>
 #include <gtest/gtest.h>
 
@@ -16,9 +17,15 @@
 #include <inlining.h>
 #include <kernel_cache.h>
 #include <ops/all_ops.h>
+#include <perf_monitor.h>
+#include <sampling_profiler.h>
 #include <tests/cpp/utils.h>
 #include <tests/cpp/validator.h>
 
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
 namespace nvfuser {
 
 class FusionProfilerTest : public NVFuserTest {
@@ -187,6 +194,239 @@ TEST_F(FusionProfilerTest, Profile3Segments) {
   EXPECT_GT(fprof.percentage_peak_bandwidth, 0.0);
 }
 
+// The intermediate between the segments is counted by actual_bytes only
+TEST_F(FusionProfilerTest, BandwidthLog) {
+  const std::string path = testing::TempDir() + "bandwidth_log.jsonl";
+  std::remove(path.c_str());
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::BandwidthLog, {path});
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  auto tv0 = makeContigConcreteTensor({1024});
+  fusion->addInput(tv0);
+  auto tv1 = relu(tv0);
+  auto tv2 = segment_set(tv1);
+  auto tv3 = neg(tv2);
+  fusion->addOutput(tv3);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({1024}, options);
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto outputs = executor_cache.runFusionWithInputs({t0});
+  testValidate(executor_cache.fusion(), outputs, {t0}, __LINE__, __FILE__);
+
+  std::ifstream log(path);
+  std::vector<std::string> lines;
+  std::string line;
+  while (std::getline(log, line)) {
+    lines.push_back(line);
+  }
+  ASSERT_EQ(lines.size(), 2);
+  for (const auto& line : lines) {
+    EXPECT_THAT(line, testing::StartsWith("{\"fusion_id\":"));
+    EXPECT_THAT(line, testing::HasSubstr("\"heuristic\":\"pointwise\""));
+    EXPECT_THAT(line, testing::HasSubstr("\"actual_bytes\":8192"));
+    EXPECT_THAT(line, testing::HasSubstr("\"ideal_bytes\":4096"));
+    EXPECT_THAT(line, testing::EndsWith("}"));
+  }
+  std::remove(path.c_str());
+}
+
+TEST_F(FusionProfilerTest, BandwidthLogLine) {
+  SegmentBandwidth record;
+  record.fusion_id = 3;
+  record.segment_id = 1;
+  record.kernel_name = "nvfuser_pointwise";
+  record.heuristic = "pointwise";
+  record.params = "Pointwise \"params\"\n";
+  record.device = 0;
+  record.time_ms = 1.0;
+  record.actual_bytes = 2000000000;
+  record.ideal_bytes = 1000000000;
+  EXPECT_EQ(
+      toJsonLine(record, 1000.0),
+      "{\"fusion_id\":3,\"segment_id\":1,\"kernel\":\"nvfuser_pointwise\","
+      "\"heuristic\":\"pointwise\",\"device\":0,\"time_ms\":1,"
+      "\"actual_bytes\":2000000000,\"ideal_bytes\":1000000000,"
+      "\"gbs\":2000,\"peak_gbs\":1000,\"pct_peak\":200,"
+      "\"params\":\"Pointwise \\\"params\\\"\\n\"}");
+}
+
+TEST_F(FusionProfilerTest, ProfileCompileSteps) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  ProfilerOptionsGuard::getCurOptions().set(ProfilerOption::EnableNocupti);
+
+  auto shape = std::vector<int64_t>({4, 4});
+  auto tv0 = makeConcreteTensor(shape);
+  fusion->addInput(tv0);
+  auto tv1 = add(tv0, tv0);
+  fusion->addOutput(tv1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn(shape, options);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  executor_cache.runFusionWithInputs({t0});
+
+  const auto& steps = FusionProfiler::profile().compile_steps;
+  auto find_step = [&steps](const std::string& name) {
+    auto it =
+        std::find_if(steps.begin(), steps.end(), [&name](const auto& step) {
+          return step.name == name;
+        });
+    EXPECT_NE(it, steps.end()) << "Missing compile step " << name;
+    return it;
+  };
+  for (const auto& name :
+       {"PreSegmenter",
+        "SegmentCandidateFinder::findSegments",
+        "computeHeuristics pointwise",
+        "GpuLower::analysis",
+        "GpuLower::run",
+        "codegen::generateCudaKernel",
+        "nvrtcCompileProgram"}) {
+    find_step(name);
+  }
+
+  // Steps are ordered by start time, enclosing steps first
+  for (size_t i = 1; i < steps.size(); ++i) {
+    EXPECT_LE(steps.at(i - 1).start_ms, steps.at(i).start_ms);
+  }
+
+  // Lowering passes are nested in lowering, which is attributed to the
+  // compiled segment
+  auto lower = find_step("GpuLower::analysis");
+  auto pass = find_step("validateIr");
+  ASSERT_NE(lower, steps.end());
+  ASSERT_NE(pass, steps.end());
+  EXPECT_EQ(lower->segment_id, 0);
+  EXPECT_EQ(pass->segment_id, 0);
+  EXPECT_EQ(pass->depth, lower->depth + 1);
+  EXPECT_GE(pass->start_ms, lower->start_ms);
+  EXPECT_LE(pass->time_ms, lower->time_ms);
+  EXPECT_EQ(find_step("PreSegmenter")->segment_id, -1);
+}
+
+TEST_F(FusionProfilerTest, ProfileCounters) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  ProfilerOptionsGuard::getCurOptions().set(ProfilerOption::Counters);
+
+  auto shape = std::vector<int64_t>({1024, 1024});
+  auto tv0 = makeConcreteTensor(shape);
+  fusion->addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  fusion->addOutput(tv1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn(shape, options);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto outputs = executor_cache.runFusionWithInputs({t0});
+  testValidate(
+      executor_cache.fusion(), outputs, {t0}, {t0.sum({1})}, __LINE__, __FILE__);
+
+  auto fprof = FusionProfiler::profile();
+  ASSERT_EQ(fprof.kernel_profiles.size(), 1);
+  const auto& kprof = fprof.kernel_profiles.at(0);
+  EXPECT_EQ(kprof.heuristic, toString(ScheduleHeuristic::Reduction));
+  // Replaying the kernel to collect counters doesn't add to the kernel time
+  EXPECT_EQ(fprof.kernel_time_ms, kprof.time_ms);
+  // The range profiler is not available before CUDA 12.6
+  if (kprof.counters.collected) {
+    EXPECT_GT(kprof.counters.dram_throughput_pct, 0.0);
+    EXPECT_GT(kprof.counters.achieved_occupancy_pct, 0.0);
+    EXPECT_FALSE(kprof.counters.warp_stalls.empty());
+  }
+}
+
+TEST_F(FusionProfilerTest, SampleKernelLaunches) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  ProfilerOptionsGuard::getCurOptions().set(ProfilerOption::Sample, {"2"});
+  SamplingProfiler::get().reset();
+
+  auto shape = std::vector<int64_t>({1024});
+  auto tv0 = makeConcreteTensor(shape);
+  fusion->addInput(tv0);
+  auto tv1 = add(tv0, tv0);
+  fusion->addOutput(tv1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn(shape, options);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  for (int i = 0; i < 10; ++i) {
+    executor_cache.runFusionWithInputs({t0});
+  }
+  // Sampling doesn't enable the FusionProfiler
+  EXPECT_EQ(FusionProfiler::state(), ProfilerState::Ready);
+
+  cudaDeviceSynchronize();
+  auto stats = SamplingProfiler::get().stats();
+  ASSERT_EQ(stats.size(), 1);
+  EXPECT_EQ(stats.at(0).total_samples, 5);
+  EXPECT_EQ(stats.at(0).samples, 5);
+  EXPECT_GT(stats.at(0).p50_ms, 0.0);
+  EXPECT_GE(stats.at(0).p99_ms, stats.at(0).p50_ms);
+  EXPECT_GT(stats.at(0).effective_bandwidth_gbs, 0.0);
+
+  SamplingProfiler::get().reset();
+  EXPECT_TRUE(SamplingProfiler::get().stats().empty());
+}
+
+TEST_F(FusionProfilerTest, KernelSampleBufferStats) {
+  KernelSampleBuffer buffer("kernel");
+  // Overwrites the oldest samples, which are the slowest
+  for (int64_t i = 0; i < KernelSampleBuffer::capacity + 100; ++i) {
+    buffer.push(i < 100 ? 1000.0f : (float)(i % 100 + 1), 1000000);
+  }
+  auto stats = buffer.stats();
+  EXPECT_EQ(stats.kernel_name, "kernel");
+  EXPECT_EQ(stats.total_samples, KernelSampleBuffer::capacity + 100);
+  EXPECT_EQ(stats.samples, KernelSampleBuffer::capacity);
+  EXPECT_LE(stats.p99_ms, 100.0);
+  EXPECT_NEAR(stats.p50_ms, 50.0, 2.0);
+  EXPECT_NEAR(stats.effective_bandwidth_gbs, 1.0 / stats.mean_ms, 1e-6);
+}
+
+TEST_F(FusionProfilerTest, PerfMonitorRegressions) {
+  PerfMonitor monitor(/*period=*/1, /*threshold_pct=*/10.0);
+  PointwiseParams params;
+  params.problem_signature = "problem";
+  auto record = [&](const std::string& kernel_name, double time_ms) {
+    for (int64_t i = 0; i < PerfMonitor::window_size; ++i) {
+      monitor.record(kernel_name, params, time_ms);
+    }
+  };
+
+  // The first kernel of a problem has nothing to be compared with
+  record("kernel0", 1.0);
+  EXPECT_TRUE(monitor.regressions().empty());
+  // Within the threshold
+  record("kernel1", 1.05);
+  EXPECT_TRUE(monitor.regressions().empty());
+  // A newly compiled kernel of the same problem that is twice as slow
+  record("kernel2", 2.0);
+  record("kernel2", 2.0);
+  auto regressions = monitor.regressions();
+  ASSERT_EQ(regressions.size(), 1);
+  EXPECT_EQ(regressions.front().kernel_name, "kernel2");
+  EXPECT_EQ(regressions.front().signature, "problem");
+  EXPECT_DOUBLE_EQ(regressions.front().time_ms, 2.0);
+  EXPECT_DOUBLE_EQ(regressions.front().best_time_ms, 1.0);
+
+  // Other problems have their own best times
+  params.problem_signature = "other problem";
+  record("kernel3", 2.0);
+  EXPECT_EQ(monitor.regressions().size(), 1);
+
+  monitor.reset();
+  EXPECT_TRUE(monitor.regressions().empty());
+}
+
 TEST_F(FusionProfilerTest, FusionProfilerErrorChecks) {
   FusionProfiler::reset();
 
@@ -124,6 +124,154 @@ TEST_F(IndexingOpTest, Scatter1DIndexZerosSelfTvSameShape_CUDA) {
   }
 }
 
+// Duplicate indices must accumulate into the output on top of self
+TEST_F(IndexingOpTest, ScatterAddDuplicateIndices_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  TensorView* tv_self = makeContigTensor(2);
+  TensorView* tv_idx = makeContigTensor(2, DataType::Int);
+  TensorView* tv_src = makeContigTensor(2);
+  fusion.addInput(tv_self);
+  fusion.addInput(tv_idx);
+  fusion.addInput(tv_src);
+
+  auto tv_src_scaled = mul(tv_src, IrBuilder::create<Val>(2.0));
+  auto tv_out = scatter_add(tv_self, 0, tv_idx, tv_src_scaled);
+  fusion.addOutput(tv_out);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto options_i = at::TensorOptions().dtype(at::kLong).device(at::kCUDA, 0);
+  at::Tensor self = at::randn({128, 65}, options);
+  at::Tensor idx = at::randint(0, 4, {128, 65}, options_i);
+  at::Tensor src = at::randn({128, 65}, options);
+  std::vector<c10::IValue> aten_inputs = {self, idx, src};
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+  testValidate(&fusion, cg_outputs, aten_inputs, __LINE__, __FILE__);
+
+  // The output must be re-initialized from self on every launch
+  cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+  testValidate(&fusion, cg_outputs, aten_inputs, __LINE__, __FILE__);
+}
+
+TEST_F(IndexingOpTest, IndexAdd_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  TensorView* tv_self = makeContigTensor(2);
+  TensorView* tv_idx = makeContigTensor(1, DataType::Int);
+  TensorView* tv_src = makeContigTensor(2);
+  fusion.addInput(tv_self);
+  fusion.addInput(tv_idx);
+  fusion.addInput(tv_src);
+
+  auto tv_out = index_add(tv_self, 0, tv_idx, tv_src);
+  fusion.addOutput(tv_out);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto options_i = at::TensorOptions().dtype(at::kLong).device(at::kCUDA, 0);
+  at::Tensor self = at::randn({256, 32}, options);
+  at::Tensor idx = at::randint(0, 16, {256}, options_i);
+  at::Tensor src = at::randn({256, 32}, options);
+  std::vector<c10::IValue> aten_inputs = {self, idx, src};
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+  testValidate(
+      executor_cache.fusion(),
+      cg_outputs,
+      aten_inputs,
+      {self.index_add(0, idx, src)},
+      __LINE__,
+      __FILE__);
+}
+
+TEST_F(IndexingOpTest, PagedGather_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  constexpr int64_t block_size = 16;
+  TensorView* tv_pool = makeContigTensor(2);
+  TensorView* tv_table = makeContigTensor(1, DataType::Int32);
+  fusion.addInput(tv_pool);
+  fusion.addInput(tv_table);
+
+  auto tv_out = paged_gather(tv_pool, tv_table, block_size);
+  fusion.addOutput(tv_out);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto options_i = at::TensorOptions().dtype(at::kInt).device(at::kCUDA, 0);
+  at::Tensor pool = at::randn({8 * block_size, 64}, options);
+  at::Tensor table = at::randperm(8, options_i).narrow(0, 0, 5);
+  std::vector<c10::IValue> aten_inputs = {pool, table};
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+
+  at::Tensor expected =
+      pool.view({8, block_size, 64}).index_select(0, table).view({-1, 64});
+  testValidate(
+      executor_cache.fusion(),
+      cg_outputs,
+      aten_inputs,
+      {expected},
+      __LINE__,
+      __FILE__);
+  EXPECT_FALSE(executor_cache.getMostRecentKernelRuntime()->isSegmented());
+}
+
+TEST_F(IndexingOpTest, RaggedSoftmax_CUDA) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(&fusion);
+
+  TensorView* tv_values = makeContigTensor(2);
+  TensorView* tv_offsets = makeContigTensor(1, DataType::Int);
+  Val* max_length = IrBuilder::create<Val>(DataType::Int);
+  fusion.addInput(tv_values);
+  fusion.addInput(tv_offsets);
+  fusion.addInput(max_length);
+
+  // Per-sequence softmax over the tokens of each sequence
+  auto tv_padded = ragged_to_padded(
+      tv_values,
+      tv_offsets,
+      max_length,
+      IrBuilder::create<Val>(-std::numeric_limits<double>::infinity()));
+  auto tv_out = softmax(tv_padded, 1);
+  fusion.addOutput(tv_out);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto options_i = at::TensorOptions().dtype(at::kLong).device(at::kCUDA, 0);
+  const std::vector<int64_t> lengths = {5, 1, 15, 17};
+  at::Tensor values = at::randn({38, 32}, options);
+  at::Tensor offsets = at::tensor({0, 5, 6, 21, 38}, options_i);
+  std::vector<c10::IValue> aten_inputs = {values, offsets, 17};
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+
+  at::Tensor expected = at::zeros({4, 17, 32}, options);
+  int64_t start = 0;
+  for (auto b : c10::irange(lengths.size())) {
+    expected[(int64_t)b].narrow(0, 0, lengths[b]).copy_(
+        at::softmax(values.narrow(0, start, lengths[b]), 0));
+    start += lengths[b];
+  }
+  testValidate(
+      executor_cache.fusion(),
+      cg_outputs,
+      aten_inputs,
+      {expected},
+      __LINE__,
+      __FILE__);
+}
+
 // all torch.gather test follow the FusionTorchGather* pattern
 
 // Test the correctness of gather operator in different dimensions and selcted
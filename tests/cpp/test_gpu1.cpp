@@ -535,6 +535,23 @@ TEST_F(NVFuserTest, FusionTopoSort_CUDA) {
   NVF_CHECK(v4->definition()->name() == 1);
   NVF_CHECK(v5->definition()->name() == 2);
   NVF_CHECK(v6->definition()->name() == 3);
+
+  // The order is cached until the fusion is mutated
+  auto version = fusion.mutationVersion();
+  NVF_CHECK(fusion.exprs() == exprs);
+  NVF_CHECK(fusion.mutationVersion() == version);
+
+  Val* v7 = makeContigTensor(0, DataType::Double);
+  Expr* e4 = IrBuilder::create<BinaryOp>(BinaryOpType::Add, v7, v6, v0);
+  NVF_CHECK(fusion.mutationVersion() != version);
+  fusion.replaceOutput(v6, v7);
+  exprs = fusion.exprs();
+  NVF_CHECK(exprs.size() == 5, "Found ", exprs.size(), " but expecting 5");
+  NVF_CHECK(exprs[4] == e4);
+
+  fusion.removeExpr(e4);
+  exprs = fusion.exprs();
+  NVF_CHECK(exprs.size() == 3, "Found ", exprs.size(), " but expecting 3");
 }
 
 TEST_F(NVFuserTest, FusionFilterVals_CUDA) {
@@ -4460,6 +4477,87 @@ TEST_F(NVFuserTest, FusionGridReduction6_CUDA) {
       &fusion, {cg_output}, {input}, {aten_output}, __LINE__, __FILE__);
 }
 
+// Same as FusionGridReduction1, but reduces the blocks of thread block
+// clusters through distributed shared memory. With 8 blocks, the reduction
+// fits in one cluster, with 32 blocks, 4 clusters are reduced through global
+// memory.
+TEST_F(NVFuserTest, FusionClusterGridReduction_CUDA) {
+  NVFUSER_TEST_CUDA_ARCH_GUARD(9, 0);
+
+  const int bdimx = 128;
+  for (const int gdimx : {8, 32}) {
+    Fusion fusion;
+    FusionGuard fg(&fusion);
+
+    TensorView* tv0 = makeSymbolicTensor(2);
+    fusion.addInput(tv0);
+
+    TensorView* tv1 = sum(tv0, {1});
+    fusion.addOutput(tv1);
+
+    tv1->split(1, bdimx);
+    tv1->split(1, gdimx);
+    // tv1[I0, R1oo, R1oi{gdimx}, R1i{128}] = tv0[I0, I1]
+    TensorView* tv2 = tv1->rFactor({1});
+
+    tv0->computeAt(tv1, 1);
+
+    tv1->axis(0)->parallelize(ParallelType::BIDy);
+    tv1->axis(1)->parallelize(ParallelType::BIDx);
+    tv2->axis(2)->parallelize(ParallelType::BIDx);
+    tv1->axis(-1)->parallelize(ParallelType::TIDx);
+    tv2->axis(-1)->parallelize(ParallelType::TIDx);
+
+    auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+    at::Tensor input = at::randn({1000, 65000}, options);
+
+    CompileParams compile_params;
+    compile_params.cluster_dims = {8, 1, 1};
+    FusionExecutor fe;
+    fe.compileFusion(&fusion, {input}, LaunchParams(), compile_params);
+    EXPECT_THAT(
+        fe.kernelString(), testing::HasSubstr("__cluster_dims__(8, 1, 1)"));
+    EXPECT_THAT(
+        fe.kernelString(),
+        testing::HasSubstr("reduction::clusterGridReduce<"));
+    auto cg_outputs = fe.runFusion({input});
+
+    testValidate(&fusion, cg_outputs, {input}, __LINE__, __FILE__);
+  }
+}
+
+TEST_F(NVFuserTest, FusionClusterGridReductionScheduler_CUDA) {
+  NVFUSER_TEST_CUDA_ARCH_GUARD(9, 0);
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::ClusterReduction);
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  TensorView* tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  fusion.addOutput(sum(tv0, {1}));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor input = at::randn({16, 1 << 20}, options);
+
+  auto reduction_params = getReductionHeuristics(&fusion, {input});
+  ASSERT_NE(reduction_params, nullptr);
+  ASSERT_TRUE(reduction_params->cross_grid_inner_reduction);
+  EXPECT_GT(reduction_params->cparams.cluster_dims[0], 1);
+  scheduleReduction(&fusion, *reduction_params);
+
+  auto lparams = reduction_params->lparams;
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {input}, lparams, reduction_params->cparams);
+  EXPECT_THAT(
+      fe.kernelString(), testing::HasSubstr("reduction::clusterGridReduce<"));
+  auto cg_outputs = fe.runFusion({input}, lparams);
+
+  testValidate(
+      &fusion, cg_outputs, {input}, __LINE__, __FILE__, "", lparams);
+}
+
 // See issue #1049
 TEST_F(NVFuserTest, FusionGridReduction7_CUDA) {
   Fusion fusion;
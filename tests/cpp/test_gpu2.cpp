@@ -1035,6 +1035,44 @@ TEST_F(NVFuserTest, FusionInputsIdLookup_CUDA) {
   NVF_CHECK(id_3_norecord.id == id_3_lookup_norecord.id);
 }
 
+TEST_F(NVFuserTest, FusionInputsIdLookupConcurrent_CUDA) {
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  std::vector<at::Tensor> tensors;
+  for (auto i : c10::irange(8)) {
+    tensors.push_back(at::randn({i + 1, 8}, options));
+  }
+
+  nvfuser::InputsIdLookup inputs_id_lookup(100);
+  std::vector<size_t> expected_ids;
+  for (const auto& t : tensors) {
+    expected_ids.push_back(inputs_id_lookup.lookupId({t}).id);
+  }
+
+  // Concurrent lookups of known input sets return their ids, and concurrent
+  // lookups of a new input set agree on one new id
+  at::Tensor new_tensor = at::randn({16, 8}, options);
+  std::vector<size_t> new_ids(8);
+  std::vector<std::thread> threads;
+  for (auto thread_i : c10::irange(8)) {
+    threads.emplace_back([&, thread_i]() {
+      for (auto iter : c10::irange(100)) {
+        auto i = (thread_i + iter) % tensors.size();
+        auto ret = inputs_id_lookup.lookupId({tensors.at(i)});
+        NVF_CHECK(ret.id == expected_ids.at(i));
+        NVF_CHECK(ret.eviction == false);
+      }
+      new_ids.at(thread_i) = inputs_id_lookup.lookupId({new_tensor}).id;
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (auto id : new_ids) {
+    NVF_CHECK(id == new_ids.front());
+  }
+  NVF_CHECK(inputs_id_lookup.size() == tensors.size() + 1);
+}
+
 TEST_F(NVFuserTest, FusionDisjointSet_CUDA) {
   DisjointSets<int> set;
 
@@ -1147,6 +1185,43 @@ TEST_F(NVFuserTest, FusionDisjointSet_CUDA) {
   }
 }
 
+// Merged and erased sets are removed from disjointSets() lazily. Make sure
+// they never show up and the order of the remaining sets is kept.
+TEST_F(NVFuserTest, FusionDisjointSetOrder_CUDA) {
+  DisjointSets<int> set;
+  for (int i : c10::irange(6)) {
+    set.initializeSet(i);
+  }
+
+  auto to_vectors = [&set]() {
+    std::vector<std::vector<int>> vectors;
+    for (const auto& s : set.disjointSets()) {
+      vectors.push_back(s->vector());
+    }
+    return vectors;
+  };
+
+  set.mapEntries(1, 3);
+  set.mapEntries(4, 1);
+  EXPECT_EQ(set.size(), 4);
+  EXPECT_EQ(
+      to_vectors(),
+      std::vector<std::vector<int>>({{0}, {2}, {5}, {4, 1, 3}}));
+
+  set.erase(2);
+  set.erase(4);
+  set.mapEntries(0, 6);
+  EXPECT_EQ(set.size(), 3);
+  EXPECT_EQ(
+      to_vectors(), std::vector<std::vector<int>>({{5}, {1, 3}, {0, 6}}));
+
+  DisjointSets<int> copy(set);
+  set.mapEntries(5, 0);
+  EXPECT_EQ(copy.size(), 3);
+  EXPECT_EQ(set.size(), 2);
+  EXPECT_EQ(set.getAllElements().vector(), std::vector<int>({1, 3, 5, 0, 6}));
+}
+
 TEST_F(NVFuserTest, FusionNonUniqueBroadcastSize_CUDA) {
   Fusion fusion;
   FusionGuard fg(&fusion);
@@ -6515,6 +6590,102 @@ TEST_F(NVFuserTest, FusionWarpReducePredication_CUDA) {
   testValidate(&fusion, cg_outputs, {t0, t2}, {t1, t4}, __LINE__, __FILE__);
 }
 
+// A broadcast of a warp reduction over multiple warps should be fused
+// into the reduction
+TEST_F(NVFuserTest, FusionWarpReduceBroadcastMultipleWarps_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  auto tv2 = broadcast(tv1, {false, true});
+  auto tv3 = add(tv2, tv0);
+  fusion.addOutput(tv3);
+
+  for (auto tv : {tv0, tv1, tv2, tv3}) {
+    tv->axis(0)->parallelize(ParallelType::BIDx);
+    tv->axis(1)->parallelize(ParallelType::TIDx);
+  }
+  tv1->axis(1)->padToMultipleOfWarp();
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({16, 100}, options);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+  EXPECT_THAT(
+      fe.kernelString(),
+      ::testing::Not(::testing::HasSubstr("blockBroadcast")));
+  auto outputs = fe.runFusion({t0});
+  testValidate(&fusion, outputs, {t0}, __LINE__, __FILE__);
+}
+
+// Warp reductions of 32-bit integers should use redux.sync
+TEST_F(NVFuserTest, FusionWarpReduceRedux_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2, DataType::Int32);
+  fusion.addInput(tv0);
+  auto tv1 = sum(tv0, {1}, false, DataType::Int32);
+  auto tv2 = max(tv0, {1});
+  fusion.addOutput(tv1);
+  fusion.addOutput(tv2);
+
+  for (auto tv : {tv1, tv2}) {
+    tv->axis(0)->parallelize(ParallelType::BIDx);
+    tv->axis(1)->parallelize(ParallelType::TIDx);
+    tv->axis(1)->padToMultipleOfWarp();
+  }
+
+  auto options = at::TensorOptions().dtype(at::kInt).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randint(-100, 100, {16, 100}, options);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+  EXPECT_THAT(fe.kernelString(), ::testing::HasSubstr("warp::ReduxOp::Add"));
+  EXPECT_THAT(fe.kernelString(), ::testing::HasSubstr("warp::ReduxOp::Max"));
+  auto outputs = fe.runFusion({t0});
+  testValidate(&fusion, outputs, {t0}, __LINE__, __FILE__);
+}
+
+// Two grouped warp reductions should share a single warp reduction call
+TEST_F(NVFuserTest, FusionGroupedWarpReduction_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  auto tv2 = max(tv0, {1});
+  auto tv3 = add(tv1, tv2);
+  fusion.addOutput(tv3);
+
+  groupReductions({tv1, tv2});
+
+  for (auto tv : {tv1, tv2, tv3}) {
+    tv->axis(0)->parallelize(ParallelType::BIDx);
+  }
+  for (auto tv : {tv1, tv2}) {
+    tv->axis(1)->parallelize(ParallelType::TIDx);
+    tv->axis(1)->padToMultipleOfWarp();
+  }
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({16, 100}, options);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+  const std::string code = fe.kernelString();
+  const std::string warp_reduce = "warp::warpReduceTIDX";
+  auto first = code.find(warp_reduce);
+  ASSERT_NE(first, std::string::npos);
+  EXPECT_EQ(code.find(warp_reduce, first + 1), std::string::npos);
+  auto outputs = fe.runFusion({t0});
+  testValidate(&fusion, outputs, {t0}, __LINE__, __FILE__);
+}
+
 TEST_F(NVFuserTest, FusionSegfaultReduction_CUDA) {
   std::unique_ptr<Fusion> fusion_ptr = std::make_unique<Fusion>();
   Fusion& fusion = *fusion_ptr.get();
@@ -46,11 +46,13 @@
 
 #include <ATen/cuda/CUDAContext.h>
 #include <ATen/cuda/Exceptions.h>
+#include <c10/cuda/CUDAGuard.h>
 #include <c10/cuda/CUDAStream.h>
 
 #include <algorithm>
 #include <cmath>
 #include <sstream>
+#include <thread>
 
 namespace nvfuser {
 
@@ -5507,6 +5509,75 @@ TEST_F(NVFuserTest, FusionVectorizeWelford2_CUDA) {
       __FILE__);
 }
 
+// Combining the partial states of an rfactored welford
+TEST_F(NVFuserTest, FusionVectorizeWelford3_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  std::vector<int64_t> shape({9, 32});
+
+  auto tv0 = makeContigConcreteTensor(shape);
+  fusion.addInput(tv0);
+
+  auto tv1 = set(tv0);
+  auto tvs = Welford(tv1, {0});
+  fusion.addOutput(tvs.avg);
+  fusion.addOutput(tvs.var_sum);
+  fusion.addOutput(tvs.n);
+
+  tvs.avg->split(1, 4);
+  tvs.avg->split(0, 3);
+  auto rf_tvs = tvs.avg->rFactor({1}, {tvs.avg, tvs.var_sum, tvs.n});
+
+  MaxRootDomainInfoSpanningTree tree(rf_tvs.at(0));
+  TransformPropagator tp(rf_tvs.at(0));
+  tree.traverse(&tp);
+
+  tv1->axis(-1)->parallelize(ParallelType::Vectorize);
+
+  inlineMost();
+
+  GpuLower gpulw(&fusion);
+  auto all_exprs = KernelExprVisitor::getAllExprs(gpulw.run());
+  EXPECT_EQ(
+      std::count_if(
+          all_exprs.begin(),
+          all_exprs.end(),
+          [](Expr* expr) { return expr->isStrictlyA<WelfordOp>(); }),
+      0);
+  // Both of the welford of the items and the welford of partial states
+  // are vectorized
+  EXPECT_EQ(
+      std::count_if(
+          all_exprs.begin(),
+          all_exprs.end(),
+          [](Expr* expr) {
+            return expr->isStrictlyA<kir::VectorizedWelfordOp>();
+          }),
+      2);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto options_int = at::TensorOptions().dtype(at::kLong).device(at::kCUDA, 0);
+
+  at::Tensor t0 = at::randn(shape, options);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+  auto cg_outputs = fe.runFusion({t0});
+
+  auto ref_avg = t0.to(at::kDouble).mean({0});
+  auto ref_var = t0.to(at::kDouble).var({0}, false) * shape[0];
+  auto ref_N = at::ones({shape[1]}, options_int) * shape[0];
+
+  testValidate(
+      fe.kernel(),
+      cg_outputs,
+      {t0},
+      {ref_avg, ref_var, ref_N},
+      __LINE__,
+      __FILE__);
+}
+
 TEST_F(NVFuserTest, FusionRepro2241_CUDA) {
   std::unique_ptr<Fusion> fusion_ptr = std::make_unique<Fusion>();
   auto fusion = fusion_ptr.get();
@@ -6091,6 +6162,44 @@ TEST_F(NVFuserTest, FusionExecutorCacheIndexType1_CUDA) {
   c10::cuda::CUDACachingAllocator::emptyCache();
 }
 
+// A pointwise fusion over more elements than 32-bit indexing can address is
+// launched as 32-bit indexed kernels over chunks of its outermost dimension
+TEST_F(NVFuserTest, FusionExecutorCacheChunkedIndexing_CUDA) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::ChunkedIndexing);
+
+  auto fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(fusion_ptr.get());
+
+  auto tv0 = makeContigTensor(2, DataType::Half);
+  fusion.addInput(tv0);
+  auto tv1 = makeContigTensor(1, DataType::Half);
+  fusion.addInput(tv1);
+  auto tv2 = castOp(DataType::Float, tv0);
+  auto tv3 = broadcast(castOp(DataType::Float, tv1), {true, false});
+  auto tv4 = castOp(DataType::Half, add(tv2, tv3));
+  fusion.addOutput(tv4);
+
+  c10::cuda::CUDACachingAllocator::emptyCache();
+
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({36 * 1024, 32 * 1024}, options);
+  at::Tensor t1 = at::randn({32 * 1024}, options);
+  NVF_CHECK(
+      KernelArgumentHolder::createKernelArgumentHolder({t0, t1})
+          .getSmallestIndexTypeOfArguments() == PrimDataType::Int);
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs({t0, t1});
+
+  auto kernel_runtime = executor_cache.getMostRecentKernelRuntime();
+  EXPECT_EQ(kernel_runtime->getIndexType(), PrimDataType::Int32);
+  EXPECT_TRUE(at::equal(cg_outputs[0], t0 + t1));
+
+  c10::cuda::CUDACachingAllocator::emptyCache();
+}
+
 // Make sure the index type is also determined by intermediate
 // tensors. This is not ideal but just tests if the logic produces
 // what is expected at this moment
@@ -6221,6 +6330,43 @@ TEST_F(NVFuserTest, FusionManagedData_CUDA) {
   ASSERT_EQ(kernel->getManaged<T2>("data2").magic_number, 0x123456789abcdef);
 }
 
+// Leaf domain transformations don't change the tensor graph, so the
+// unmappable dims of MaxPosCalculator are reused across them
+TEST_F(NVFuserTest, FusionTensorGraphVersion_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  auto tv2 = broadcast(tv1, {false, true});
+  auto tv3 = add(tv0, tv2);
+  fusion.addOutput(tv3);
+
+  auto version = fusion.tensorGraphVersion();
+  tv3->split(1, 4);
+  tv3->reorder({{1, 2}});
+  TransformPropagatorWithCheck propagator(tv3);
+  MaxRootDomainInfoSpanningTree(tv3).traverse(&propagator);
+  EXPECT_EQ(fusion.tensorGraphVersion(), version);
+
+  inlineMost();
+  EXPECT_EQ(fusion.tensorGraphVersion(), version);
+  EXPECT_EQ(tv1->getComputeAtPosition(), 1);
+
+  // rfactor creates a new tensor, whose reduction domain is unmappable to its
+  // consumer, so inlining must not use the dims computed before
+  auto tv4 = tv1->rFactor({1});
+  EXPECT_NE(fusion.tensorGraphVersion(), version);
+  inlineMost();
+  EXPECT_EQ(tv4->getComputeAtPosition(), 1);
+  EXPECT_EQ(tv1->getComputeAtPosition(), 1);
+
+  version = fusion.tensorGraphVersion();
+  tv0->cacheAfter();
+  EXPECT_NE(fusion.tensorGraphVersion(), version);
+}
+
 // Repro of issue #2125, 1.45e+03 GB/s on A100-80G
 TEST_F(NVFuserTest, FusionAvoidRedundantWriteBroadcastedSoftmaxInput_CUDA) {
   std::unique_ptr<Fusion> fusion_ptr = std::make_unique<Fusion>();
@@ -8131,6 +8277,704 @@ TEST_F(NVFuserTest, TemplateFunctionTypeMismatch) {
       fusion, args, persistent_params->lparams, persistent_params->cparams);
   auto cg_outputs = fe.runFusion(args, persistent_params->lparams);
 }
+
+// Packing int4 values and unpacking them again is the identity, and unpacking
+// sign-extends both nibbles
+TEST_F(NVFuserTest, PackUnpackInt4) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2, DataType::Int8);
+  fusion->addInput(tv0);
+  auto tv1 = pack_int4(tv0);
+  auto tv2 = unpack_int4(tv1);
+  fusion->addOutput(tv1);
+  fusion->addOutput(tv2);
+
+  auto options = at::TensorOptions().dtype(at::kChar).device(at::kCUDA, 0);
+  auto t0 = at::randint(-8, 8, {33, 64}, options);
+  auto t0_pairs = t0.view({33, 32, 2});
+  auto t1 = at::bitwise_or(
+      at::bitwise_and(t0_pairs.select(2, 0), 0xF),
+      at::bitwise_left_shift(t0_pairs.select(2, 1), 4));
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto cg_outputs = executor_cache.runFusionWithInputs({t0});
+
+  EXPECT_TRUE(at::equal(cg_outputs[0], t1));
+  EXPECT_TRUE(at::equal(cg_outputs[1], t0));
+}
+
+// Block quantization computes the per-block amax and the scaled cast in one
+// kernel, and dequantization recovers x up to the rounding of fp8
+TEST_F(NVFuserTest, BlockQuantizeFp8) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  auto [tv1, tv2] = block_quantize(tv0, 128, DataType::Float8_e4m3fn);
+  auto tv3 = block_dequantize(tv1, tv2, 128);
+  fusion->addOutput(tv1);
+  fusion->addOutput(tv2);
+  fusion->addOutput(tv3);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({64, 1024}, options);
+  auto t2 = t0.view({64, 8, 128}).abs().amax(-1) / 448.0;
+  auto t1 = (t0.view({64, 8, 128}) / t2.unsqueeze(-1))
+                .view({64, 1024})
+                .to(at::kFloat8_e4m3fn);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto cg_outputs = executor_cache.runFusionWithInputs({t0});
+
+  EXPECT_FALSE(executor_cache.getMostRecentKernelRuntime()->isSegmented());
+  EXPECT_TRUE(at::allclose(cg_outputs[1], t2));
+  EXPECT_TRUE(at::allclose(
+      cg_outputs[0].to(at::kFloat), t1.to(at::kFloat), /*rtol=*/0.07));
+  EXPECT_TRUE(at::allclose(cg_outputs[2], t0, /*rtol=*/0.07, /*atol=*/1e-3));
+}
+
+// Convolution with a folded batch norm and a ReLU as its epilogue
+TEST_F(NVFuserTest, Conv2dImplicitGemm_CUDA) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  const int64_t N = 2, C = 16, H = 20, W = 24, K = 32;
+  auto tv0 = makeContigTensor(4);
+  auto tv1 = makeContigConcreteTensor({K, C, 3, 3});
+  auto tv2 = makeContigTensor(1);
+  auto tv3 = makeContigTensor(1);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  fusion->addInput(tv2);
+  fusion->addInput(tv3);
+  auto tv4 = conv2d(tv0, tv1, nullptr, {1, 2}, {1, 2});
+  auto tv5 = mul(tv4, broadcast(tv2, {true, false, true, true}));
+  auto tv6 = add(tv5, broadcast(tv3, {true, false, true, true}));
+  auto tv7 = relu(tv6);
+  fusion->addOutput(tv7);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({N, C, H, W}, options);
+  auto t1 = at::randn({K, C, 3, 3}, options);
+  auto t2 = at::randn({K}, options);
+  auto t3 = at::randn({K}, options);
+  std::vector<c10::IValue> inputs({t0, t1, t2, t3});
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto cg_outputs = executor_cache.runFusionWithInputs(inputs);
+
+  auto ref = at::relu(
+      at::conv2d(t0, t1, {}, /*stride=*/1, /*padding=*/{1, 2}, {1, 2}) *
+          t2.view({1, K, 1, 1}) +
+      t3.view({1, K, 1, 1}));
+  testValidate(
+      executor_cache.fusion(), cg_outputs, inputs, {ref}, __LINE__, __FILE__);
+}
+
+// The serial reduction loops of the scores masked out by a causal mask are
+// skipped
+TEST_F(NVFuserTest, SkipMaskedReductions_CUDA) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::SkipMaskedReductions);
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(2);
+  auto tv1 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  fusion.addInput(tv1);
+  auto tv2 = mul(
+      broadcast(tv0, {false, true, false}),
+      broadcast(tv1, {true, false, false}));
+  auto tv3 = sum(tv2, {2});
+  auto tv4 = broadcast(
+      iota(tv0->axis(0)->extent(), nullptr, nullptr, DataType::Index),
+      {false, true});
+  auto tv5 = broadcast(
+      iota(tv1->axis(0)->extent(), nullptr, nullptr, DataType::Index),
+      {true, false});
+  auto tv6 = where(ge(tv4, tv5), tv3, IrBuilder::create<Val>(0.0));
+  fusion.addOutput(tv6);
+
+  // Each thread reduces one score in a serial loop
+  tv6->axis(0)->parallelize(ParallelType::BIDx);
+  tv6->axis(1)->parallelize(ParallelType::TIDx);
+  TransformPropagatorWithCheck propagator(tv6);
+  MaxRootDomainInfoSpanningTree(tv6).traverse(&propagator);
+  scheduler_utils::parallelizeAllLike(tv6);
+  inlineMost();
+
+  GpuLower gpulw(&fusion);
+  auto exprs = ir_utils::flattenScopedExprs(gpulw.run()->topLevelExprs());
+  EXPECT_EQ(
+      std::count_if(
+          exprs.begin(),
+          exprs.end(),
+          [](Expr* expr) {
+            auto ite = dynamic_cast<kir::IfThenElse*>(expr);
+            return ite != nullptr &&
+                ite->predicate()->predicate_type() == PredicateType::Manual &&
+                ite->thenBody().size() == 1 &&
+                ite->thenBody()[0]->isA<kir::ForLoop>();
+          }),
+      1);
+
+  const int64_t M = 64, N = 96, K = 128;
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({M, K}, options);
+  auto t1 = at::randn({N, K}, options);
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0, t1});
+  auto cg_outputs = fe.runFusion({t0, t1});
+
+  auto mask = at::ones({M, N}, options.dtype(at::kBool)).tril();
+  auto ref = at::where(mask, at::matmul(t0, t1.t()), 0.0);
+  testValidate(&fusion, cg_outputs, {t0, t1}, {ref}, __LINE__, __FILE__);
+}
+
+// The cached input of a serial reduction loop is double buffered in
+// that loop when its loads are latency bound
+TEST_F(NVFuserTest, SerialLoopPipelining_CUDA) {
+  {
+    Fusion fusion;
+    FusionGuard fg(&fusion);
+
+    auto tv0 = makeSymbolicTensor(2);
+    fusion.addInput(tv0);
+    auto tv1 = sum(tv0, {1});
+    fusion.addOutput(tv1);
+
+    auto tv2 = tv0->cacheAfter();
+    tv1->split(1, 128);
+    tv1->axis(0)->parallelize(ParallelType::BIDx);
+    tv1->axis(-1)->parallelize(ParallelType::TIDx);
+    auto tv3 = tv1->rFactor({1});
+    TransformPropagatorWithCheck propagator(tv3);
+    MaxRootDomainInfoSpanningTree(tv3).traverse(&propagator);
+    scheduler_utils::parallelizeAllLike(tv3);
+
+    EnableOptionsGuard opt_guard;
+    EnableOptionsGuard::getCurOptions().set(
+        EnableOption::SerialLoopPipelining);
+    // Whether the loads are latency bound depends on the device, but the
+    // serial loop is always the outer reduction loop
+    for (const auto& [tv, pos] :
+         reduction_scheduler_utils::getPipelinedInputs({tv2})) {
+      EXPECT_EQ(tv, tv2);
+      EXPECT_EQ(pos, 1);
+    }
+  }
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  auto tv2 = sum(tv0, {0});
+  fusion->addOutput(tv1);
+  fusion->addOutput(tv2);
+
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::SerialLoopPipelining);
+
+  FusionExecutorCache fec(std::move(fusion));
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  for (auto size : {std::vector<int64_t>{129, 10001}, {10001, 129}}) {
+    auto t0 = at::randn(size, options);
+    auto cg_outputs = fec.runFusionWithInputs({t0});
+    testValidate(fec.fusion(), cg_outputs, {t0}, __LINE__, __FILE__);
+  }
+}
+
+// Only the runtime functions a kernel uses are prepended to it
+TEST_F(NVFuserTest, PrunePreamble_CUDA) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::PrunePreamble);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({8, 128}, options);
+
+  {
+    Fusion fusion;
+    FusionGuard fg(&fusion);
+    auto tv0 = makeSymbolicTensor(2);
+    fusion.addInput(tv0);
+    auto tv1 = add(tv0, IrBuilder::create<Val>(1.0));
+    fusion.addOutput(tv1);
+    tv1->axis(0)->parallelize(ParallelType::BIDx);
+    tv1->axis(1)->parallelize(ParallelType::TIDx);
+
+    FusionExecutor fe;
+    fe.compileFusion(&fusion, {t0});
+    auto code = fe.getStructuredCode();
+    EXPECT_EQ(code.find("namespace welford"), std::string::npos);
+    EXPECT_EQ(code.find("philox"), std::string::npos);
+    auto cg_outputs = fe.runFusion({t0});
+    testValidate(&fusion, cg_outputs, {t0}, __LINE__, __FILE__);
+  }
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  fusion.addOutput(tv1);
+  tv1->axis(0)->parallelize(ParallelType::BIDx);
+  tv1->axis(1)->parallelize(ParallelType::TIDx);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+  EXPECT_NE(
+      fe.getStructuredCode().find("namespace welford"), std::string::npos);
+  auto cg_outputs = fe.runFusion({t0});
+  testValidate(&fusion, cg_outputs, {t0}, __LINE__, __FILE__);
+}
+
+// Executors compiling the same kernel at the same time, under different
+// kernel names, all get a working kernel
+TEST_F(NVFuserTest, ConcurrentCompilationOfSameKernel_CUDA) {
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({8, 128}, options);
+
+  std::vector<at::Tensor> outputs(4);
+  std::vector<std::thread> threads;
+  for (auto thread_i : c10::irange(outputs.size())) {
+    threads.emplace_back([&, thread_i]() {
+      Fusion fusion;
+      FusionGuard fg(&fusion);
+      auto tv0 = makeSymbolicTensor(2);
+      fusion.addInput(tv0);
+      auto tv1 = add(sin(tv0), IrBuilder::create<Val>(1.0));
+      fusion.addOutput(tv1);
+      tv1->axis(0)->parallelize(ParallelType::BIDx);
+      tv1->axis(1)->parallelize(ParallelType::TIDx);
+
+      FusionExecutor fe;
+      fe.compileFusion(
+          &fusion,
+          KernelArgumentHolder::createKernelArgumentHolder({t0}),
+          LaunchParams(),
+          CompileParams(),
+          ScheduleHeuristic::None,
+          /*fusion_id=*/(int64_t)thread_i);
+      outputs.at(thread_i) = fe.runFusion({t0}).at(0);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  auto ref = t0.sin() + 1.0;
+  for (const auto& output : outputs) {
+    EXPECT_TRUE(output.allclose(ref));
+  }
+}
+
+// Threads running the same FusionExecutorCache on their own streams, with
+// inputs of shapes that share a kernel runtime and of shapes that don't
+TEST_F(NVFuserTest, ConcurrentStreams_CUDA) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::ConcurrentStreams);
+
+  auto fusion_ptr = std::make_unique<Fusion>();
+  {
+    FusionGuard fg(fusion_ptr.get());
+    auto tv0 = makeSymbolicTensor(2);
+    fusion_ptr->addInput(tv0);
+    auto tv1 = sum(add(sin(tv0), IrBuilder::create<Val>(1.0)), {1});
+    fusion_ptr->addOutput(tv1);
+  }
+  FusionExecutorCache fec(std::move(fusion_ptr));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  const std::vector<at::Tensor> inputs = {
+      at::randn({128, 1024}, options),
+      at::randn({1024, 128}, options),
+      at::randn({256, 2048}, options)};
+
+  constexpr int64_t num_threads = 4;
+  constexpr int64_t num_runs = 10;
+  std::vector<std::vector<at::Tensor>> outputs(num_threads);
+  std::vector<std::thread> threads;
+  for (auto thread_i : c10::irange(num_threads)) {
+    threads.emplace_back([&, thread_i]() {
+      c10::cuda::CUDAStreamGuard sg(c10::cuda::getStreamFromPool(false, 0));
+      for (auto run_i : c10::irange(num_runs)) {
+        const at::Tensor& t0 =
+            inputs.at((thread_i + run_i) % (int64_t)inputs.size());
+        outputs.at(thread_i).push_back(fec.runFusionWithInputs({t0}).at(0));
+      }
+      c10::cuda::getCurrentCUDAStream().synchronize();
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (auto thread_i : c10::irange(num_threads)) {
+    for (auto run_i : c10::irange(num_runs)) {
+      const at::Tensor& t0 =
+          inputs.at((thread_i + run_i) % (int64_t)inputs.size());
+      auto ref = (t0.sin() + 1.0).sum({1});
+      EXPECT_TRUE(outputs.at(thread_i).at(run_i).allclose(ref, 1e-4, 1e-4));
+    }
+  }
+}
+
+// IR nodes are pooled per thread, but may be freed by other threads, e.g.,
+// when a fusion built by a compilation thread is destroyed by the caller
+TEST_F(NVFuserTest, IrNodePoolAcrossThreads) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  {
+    FusionGuard fg(fusion_ptr.get());
+    auto tv0 = makeSymbolicTensor(2);
+    fusion_ptr->addInput(tv0);
+    auto tv1 = sum(add(sin(tv0), IrBuilder::create<Val>(1.0)), {1});
+    fusion_ptr->addOutput(tv1);
+  }
+  const std::string expected = ir_utils::toString(fusion_ptr->exprs());
+
+  std::vector<std::unique_ptr<Fusion>> clones(4);
+  std::vector<std::thread> threads;
+  for (auto thread_i : c10::irange(clones.size())) {
+    threads.emplace_back([&, thread_i]() {
+      // Clones freed by this thread are reused by the next ones
+      for ([[maybe_unused]] auto i : c10::irange(10)) {
+        clones.at(thread_i) = std::make_unique<Fusion>(*fusion_ptr);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  // Nodes of exited threads are freed by this one
+  for (auto& clone : clones) {
+    EXPECT_EQ(ir_utils::toString(clone->exprs()), expected);
+    clone.reset();
+  }
+  Fusion copy(*fusion_ptr);
+  EXPECT_EQ(ir_utils::toString(copy.exprs()), expected);
+}
+
+// Executors generating the same code share its loaded kernel
+TEST_F(NVFuserTest, CompiledKernelSharing_CUDA) {
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({8, 128}, options);
+
+  auto compile = [&t0](FusionExecutor& fe, int64_t fusion_id) {
+    Fusion fusion;
+    FusionGuard fg(&fusion);
+    auto tv0 = makeSymbolicTensor(2);
+    fusion.addInput(tv0);
+    auto tv1 = add(cos(tv0), IrBuilder::create<Val>(2.0));
+    fusion.addOutput(tv1);
+    tv1->axis(0)->parallelize(ParallelType::BIDx);
+    tv1->axis(1)->parallelize(ParallelType::TIDx);
+    fe.compileFusion(
+        &fusion,
+        KernelArgumentHolder::createKernelArgumentHolder({t0}),
+        LaunchParams(),
+        CompileParams(),
+        ScheduleHeuristic::None,
+        fusion_id);
+    auto cg_outputs = fe.runFusion({t0});
+    EXPECT_TRUE(cg_outputs.at(0).allclose(t0.cos() + 2.0));
+  };
+
+  FusionExecutor fe0;
+  FusionExecutor fe1;
+  compile(fe0, 0);
+  compile(fe1, 1);
+  EXPECT_EQ(fe0.compiledKernel().function, fe1.compiledKernel().function);
+
+  DisableOptionsGuard opt_guard;
+  DisableOptionsGuard::getCurOptions().set(
+      DisableOption::CompiledKernelSharing);
+  FusionExecutor fe2;
+  compile(fe2, 2);
+  EXPECT_NE(fe0.compiledKernel().function, fe2.compiledKernel().function);
+}
+
+// Executors of other devices of the same architecture load the binary
+// compiled for the first device instead of compiling it again
+TEST_F(NVFuserTest, CompiledBinarySharingAcrossDevices_CUDA) {
+  if (at::cuda::getNumGPUs() < 2) {
+    GTEST_SKIP() << "Needs at least two devices";
+  }
+  const auto* prop0 = at::cuda::getDeviceProperties(0);
+  const auto* prop1 = at::cuda::getDeviceProperties(1);
+  if (prop0->major != prop1->major || prop0->minor != prop1->minor) {
+    GTEST_SKIP() << "Needs two devices of the same architecture";
+  }
+
+  auto compile = [](FusionExecutor& fe, c10::DeviceIndex device) {
+    auto options =
+        at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, device);
+    auto t0 = at::randn({8, 128}, options);
+    Fusion fusion;
+    FusionGuard fg(&fusion);
+    auto tv0 = makeSymbolicTensor(2);
+    fusion.addInput(tv0);
+    auto tv1 = add(sin(tv0), IrBuilder::create<Val>(3.0));
+    fusion.addOutput(tv1);
+    tv1->axis(0)->parallelize(ParallelType::BIDx);
+    tv1->axis(1)->parallelize(ParallelType::TIDx);
+    fe.compileFusion(&fusion, {t0});
+    auto cg_outputs = fe.runFusion({t0});
+    EXPECT_TRUE(cg_outputs.at(0).allclose(t0.sin() + 3.0));
+  };
+
+  FusionExecutor fe0;
+  FusionExecutor fe1;
+  compile(fe0, 0);
+  compile(fe1, 1);
+  EXPECT_NE(fe0.compiledKernel().function, fe1.compiledKernel().function);
+  EXPECT_THAT(
+      fe1.compiledKernel().compile_log,
+      ::testing::HasSubstr("Reused the binary loaded on another device"));
+}
+
+// Welfords over TIDx padded to warps combine the triplets with shuffles
+TEST_F(NVFuserTest, WarpWelford_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tvs = Welford(tv0, {1});
+  fusion.addOutput(tvs.avg);
+  fusion.addOutput(tvs.var_sum);
+  fusion.addOutput(tvs.n);
+
+  for (auto tv : {tvs.avg, tvs.var_sum, tvs.n}) {
+    tv->axis(0)->parallelize(ParallelType::BIDx);
+    tv->axis(1)->parallelize(ParallelType::TIDx);
+    tv->axis(1)->padToMultipleOfWarp();
+  }
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  for (auto size : {20L, 100L}) {
+    auto t0 = at::randn({16, size}, options);
+    FusionExecutor fe;
+    fe.compileFusion(&fusion, {t0});
+    EXPECT_NE(fe.kernelString().find("warpWelfordTIDX"), std::string::npos);
+    auto cg_outputs = fe.runFusion({t0});
+    testValidate(
+        &fusion,
+        cg_outputs,
+        {t0},
+        {t0.mean({1}),
+         t0.var({1}, false) * size,
+         at::full({16}, size, options.dtype(at::kLong))},
+        __LINE__,
+        __FILE__);
+  }
+}
+
+// kernel_profile(phases) times the phases of a grid reduction
+TEST_F(NVFuserTest, KernelProfilePhases_CUDA) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::KernelProfile, {"phases"});
+
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  fusion.addOutput(tv1);
+
+  tv1->split(1, 128);
+  tv1->axis(0)->parallelize(ParallelType::BIDy);
+  tv1->axis(1)->parallelize(ParallelType::BIDx);
+  tv1->axis(2)->parallelize(ParallelType::TIDx);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({8, 1024}, options);
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+  EXPECT_TRUE(fe.kernel()->profile().hasPhases());
+  const auto& code = fe.kernelString();
+  EXPECT_NE(code.find("PhaseTimer<5> phase_timer;"), std::string::npos);
+  EXPECT_NE(
+      code.find(
+          "phase_timer.mark(" +
+          std::to_string((int)kir::KernelPhase::Reduction) + ");"),
+      std::string::npos);
+  auto cg_outputs = fe.runFusion({t0});
+  testValidate(&fusion, cg_outputs, {t0}, __LINE__, __FILE__);
+}
+
+// The sync buffers of the grid reductions of a kernel are cleared together
+TEST_F(NVFuserTest, CoalescedZeroedIntermediates_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = sum(tv0, {0});
+  auto tv2 = max(tv0, {0});
+  auto tv3 = min(tv0, {0});
+  fusion.addOutput(tv1);
+  fusion.addOutput(tv2);
+  fusion.addOutput(tv3);
+
+  for (auto tv : {tv1, tv2, tv3}) {
+    tv->axis(0)->parallelize(ParallelType::BIDx);
+    tv->axis(1)->parallelize(ParallelType::TIDx);
+  }
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({64, 32}, options);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+  // Reruns with the same buffers, which must be cleared every time
+  for (auto i : c10::irange(3)) {
+    (void)i;
+    auto cg_outputs = fe.runFusion({t0});
+    testValidate(&fusion, cg_outputs, {t0}, __LINE__, __FILE__);
+  }
+}
+
+// Launches with the same input id reuse the vectorization validation
+// only as long as the pointers are aligned the same way
+TEST_F(NVFuserTest, RevalidateMisalignedOutputOnCacheHit_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(1);
+  fusion.addInput(tv0);
+  auto tv1 = add(tv0, IrBuilder::create<Val>(1.0));
+  fusion.addOutput(tv1);
+
+  auto tv2 = tv0->cacheAfter();
+  auto tv3 = tv1->cacheBefore();
+  for (auto tv : {tv1, tv2, tv3}) {
+    tv->split(0, 4);
+    tv->split(0, 128);
+    tv->axis(0)->parallelize(ParallelType::BIDx);
+    tv->axis(1)->parallelize(ParallelType::TIDx);
+  }
+  tv1->axis(-1)->parallelize(ParallelType::Vectorize);
+  tv2->axis(-1)->parallelize(ParallelType::Vectorize);
+
+  const int64_t size = 4096;
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({size}, options);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+  const size_t cache_id = 0;
+  auto cg_outputs =
+      fe.runFusion({t0}, {}, LaunchParams(), CompileParams(), cache_id);
+  testValidate(&fusion, cg_outputs, {t0}, __LINE__, __FILE__);
+
+  // Same metadata as the cached output, but misaligned for vectorization
+  at::Tensor buffer = at::empty({size + 1}, options);
+  at::Tensor misaligned_output = buffer.slice(0, 1, size + 1);
+  EXPECT_THAT(
+      [&]() {
+        fe.runFusion(
+            {t0},
+            {misaligned_output},
+            LaunchParams(),
+            CompileParams(),
+            cache_id);
+      },
+      testing::ThrowsMessage<nvfuser::nvfError>(
+          testing::HasSubstr("not aligned")));
+
+  at::Tensor aligned_output = buffer.slice(0, 0, size);
+  cg_outputs = fe.runFusion(
+      {t0}, {aligned_output}, LaunchParams(), CompileParams(), cache_id);
+  testValidate(&fusion, cg_outputs, {t0}, __LINE__, __FILE__);
+}
+
+// Tiny fusions of CPU scalars are evaluated on the host without a kernel
+TEST_F(NVFuserTest, HostEvaluatedCpuScalars_CUDA) {
+  auto make_fusion = [](int64_t expanded_extent) {
+    auto fusion = std::make_unique<Fusion>();
+    FusionGuard fg(fusion.get());
+    auto tv0 = makeContigTensor(0, DataType::Double);
+    tv0->setCpuScalar(true);
+    fusion->addInput(tv0);
+    auto tv1 = mul(add(tv0, IrBuilder::create<Val>(1.0)), tv0);
+    auto tv2 = broadcast(tv1, {true});
+    auto tv3 = expand(tv2, {IrBuilder::create<Val>(expanded_extent)});
+    fusion->addOutput(tv1);
+    fusion->addOutput(tv3);
+    return fusion;
+  };
+  at::Tensor t0 = at::scalar_tensor(3.0, at::kDouble);
+
+  FusionExecutorCache fec(make_fusion(4));
+  auto outputs = fec.runFusionWithInputs({t0});
+  FusionKernelRuntime* runtime = fec.getMostRecentKernelRuntime();
+  ASSERT_FALSE(runtime->isSegmented());
+  EXPECT_EQ(
+      runtime->schedulerHeuristics()->heuristicsList().at(0)->heuristic(),
+      ScheduleHeuristic::ExprEval);
+  EXPECT_TRUE(outputs.at(0).is_cuda());
+  EXPECT_TRUE(outputs.at(1).is_cuda());
+  testValidate(fec.fusion(), outputs, {t0}, __LINE__, __FILE__);
+
+  // Outputs that aren't tiny are computed by a kernel
+  FusionExecutorCache large_fec(make_fusion(1024));
+  outputs = large_fec.runFusionWithInputs({t0});
+  runtime = large_fec.getMostRecentKernelRuntime();
+  EXPECT_NE(
+      runtime->schedulerHeuristics()->heuristicsList().at(0)->heuristic(),
+      ScheduleHeuristic::ExprEval);
+  testValidate(large_fec.fusion(), outputs, {t0}, __LINE__, __FILE__);
+}
+
+TEST_F(NVFuserTest, CostAwareInlining_CUDA) {
+  auto make_fusion = []() {
+    auto fusion = std::make_unique<Fusion>();
+    FusionGuard fg(fusion.get());
+    auto tv0 = makeContigConcreteTensor({8, 1, 4});
+    auto tv1 = makeContigConcreteTensor({8, 16, 4});
+    fusion->addInput(tv0);
+    fusion->addInput(tv1);
+    auto tv2 = exp(tv0);
+    auto tv3 = mul(tv2, tv1);
+    fusion->addOutput(tv3);
+    return fusion;
+  };
+  auto get_tv2 = [](Fusion* fusion) {
+    return fusion->outputs().at(0)->definition()->input(0)->as<TensorView>();
+  };
+
+  // The exp is computed once per element of tv0 instead of once per
+  // iteration of the loop of the broadcast
+  std::unique_ptr<Fusion> fusion = make_fusion();
+  FusionGuard fg(fusion.get());
+  TensorView* tv2 = get_tv2(fusion.get());
+  inlineMostCostAware({tv2}, /*max_registers_per_thread=*/255);
+  EXPECT_EQ(tv2->getComputeAtPosition(), 1);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({8, 1, 4}, options);
+  at::Tensor t1 = at::randn({8, 16, 4}, options);
+  FusionExecutor fe;
+  fe.compileFusion(fusion.get(), {t0, t1});
+  auto outputs = fe.runFusion({t0, t1});
+  testValidate(fusion.get(), outputs, {t0, t1}, __LINE__, __FILE__);
+
+  // The buffer of 4 floats doesn't fit in the registers, so tv2 is inlined
+  // most
+  std::unique_ptr<Fusion> small_fusion = make_fusion();
+  FusionGuard small_fg(small_fusion.get());
+  tv2 = get_tv2(small_fusion.get());
+  inlineMostCostAware({tv2}, /*max_registers_per_thread=*/2);
+  EXPECT_EQ(tv2->getComputeAtPosition(), 3);
+}
+
 // Test file size should be up to 10K LoC. Create a new file for more tests.
 
 } // namespace nvfuser
@@ -461,4 +461,42 @@ TEST_F(NVFuserTest, FusionComputeWith6_CUDA) {
   testValidate(&fusion, cg_outputs, {t0}, {t4}, __LINE__, __FILE__, "");
 }
 
+// Consumers in the same loop nest are all computed with. See
+// FusionComputeWith6 for a consumer in another loop nest.
+TEST_F(NVFuserTest, FusionComputeWithMultipleConsumers_CUDA) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = set(tv0);
+  auto tv2 = add(tv1, IrBuilder::create<Val>(1.0));
+  auto tv3 = mul(tv1, IrBuilder::create<Val>(2.0));
+  auto tv4 = add(tv2, tv3);
+  fusion.addOutput(tv4);
+
+  tv4->split(-1, 4);
+  TransformPropagatorWithCheck propagator(tv4);
+  MaxRootDomainInfoSpanningTree(tv4).traverse(&propagator);
+
+  tv4->axis(0)->parallelize(ParallelType::BIDx);
+  scheduler_utils::parallelizeAllLike(tv4);
+
+  inlineMost(std::vector<TensorView*>{tv2, tv3});
+  tv1->inlineAt(1);
+  tv1->computeWith(-1);
+
+  GpuLower gpulw(&fusion);
+  checkComputeWith(gpulw.run(), tv1, 3, {tv2, tv3});
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({17, 24}, options);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+  auto cg_outputs = fe.runFusion({t0});
+
+  testValidate(&fusion, cg_outputs, {t0}, __LINE__, __FILE__);
+}
+
 } // namespace nvfuser
@@ -6,6 +6,7 @@
  */
 // clang-format on
 #include <csrc/exceptions.h>
+#include <gmock/gmock-matchers.h>
 #include <gtest/gtest.h>
 
 #include <codegen.h>
@@ -2584,4 +2585,50 @@ TEST_F(NVFuserTest, FusionTensorRankLimit) {
       executor_cache.fusion(), cg_outputs, aten_inputs, __LINE__, __FILE__);
 }
 
+// The reduction scheduler groups a sum and a max of the same input, so that
+// their grid reductions share one synchronization
+TEST_F(NVFuserTest, FusionGroupSiblingGridReductions_CUDA) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::SplitKReduction);
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::GroupSiblingReductions);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  auto tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  auto tv2 = max(tv0, {1});
+  auto tv3 = sum(mul(tv0, tv0), {1});
+  fusion->addOutput(tv1);
+  fusion->addOutput(tv2);
+  fusion->addOutput(tv3);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({64, 1 << 20}, options);
+  std::vector<c10::IValue> inputs({t0});
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto cg_outputs = executor_cache.runFusionWithInputs(inputs);
+  testValidate(
+      executor_cache.fusion(), cg_outputs, inputs, __LINE__, __FILE__);
+
+  auto runtime = executor_cache.getMostRecentKernelRuntime();
+  ASSERT_FALSE(runtime->isSegmented());
+  auto rparams = runtime->schedulerHeuristics()
+                     ->heuristicsList()
+                     .at(0)
+                     ->params()
+                     ->as<ReductionParams>();
+  if (!rparams->cross_grid_inner_reduction) {
+    GTEST_SKIP() << "Not a grid reduction";
+  }
+  const std::string kernel_string =
+      runtime->executors().front().kernelString();
+  EXPECT_THAT(kernel_string, testing::HasSubstr("gridReduceGroup"));
+  EXPECT_THAT(
+      kernel_string,
+      testing::Not(testing::HasSubstr("reduction::gridReduce<")));
+}
+
 } // namespace nvfuser
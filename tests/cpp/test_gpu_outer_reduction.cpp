@@ -2380,4 +2380,209 @@ TEST_F(OuterReductionTest, OuterReductionMagicScheduler) {
   }
 }
 
+// Skinny reductions, e.g., the bias gradient of a large batch, split the
+// reduction across full waves of blocks with NVFUSER_ENABLE=split_k_reduction
+TEST_F(OuterReductionTest, SplitKSkinnyReduction) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::SplitKReduction);
+  const int64_t device_multiprocessor_count =
+      at::cuda::getCurrentDeviceProperties()->multiProcessorCount;
+
+  // Outer and inner reductions of 1M rows of 64 elements
+  for (const int64_t reduction_axis : {0, 1}) {
+    auto fusion = std::make_unique<Fusion>();
+    FusionGuard fg(fusion.get());
+    auto tv0 = makeContigTensor(2);
+    fusion->addInput(tv0);
+    fusion->addOutput(sum(tv0, {reduction_axis}));
+
+    std::vector<int64_t> shape({1 << 20, 64});
+    if (reduction_axis == 1) {
+      std::swap(shape[0], shape[1]);
+    }
+    auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+    auto t0 = at::randn(shape, options);
+    std::vector<c10::IValue> inputs({t0});
+    FusionExecutorCache executor_cache(std::move(fusion));
+    auto cg_outputs = executor_cache.runFusionWithInputs(inputs);
+
+    auto runtime = executor_cache.getMostRecentKernelRuntime();
+    ASSERT_FALSE(runtime->isSegmented());
+    auto rparams = runtime->schedulerHeuristics()
+                       ->heuristicsList()
+                       .at(0)
+                       ->params()
+                       ->as<ReductionParams>();
+    EXPECT_TRUE(rparams->cross_grid_inner_reduction);
+    const LaunchParams& lparams = rparams->lparams;
+    EXPECT_GE(
+        lparams.gdimx() * lparams.gdimy(), device_multiprocessor_count);
+
+    testValidate(
+        executor_cache.fusion(), cg_outputs, inputs, __LINE__, __FILE__);
+  }
+}
+
+TEST_F(OuterReductionTest, AtomicGridReduction) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::SplitKReduction);
+
+  for (const bool atomic : {false, true}) {
+    if (atomic) {
+      EnableOptionsGuard::getCurOptions().set(
+          EnableOption::AtomicGridReduction);
+    }
+    for (const int64_t reduction_axis : {0, 1}) {
+      auto fusion = std::make_unique<Fusion>();
+      FusionGuard fg(fusion.get());
+      auto tv0 = makeContigTensor(2);
+      fusion->addInput(tv0);
+      fusion->addOutput(sum(tv0, {reduction_axis}));
+
+      std::vector<int64_t> shape({1 << 20, 64});
+      if (reduction_axis == 1) {
+        std::swap(shape[0], shape[1]);
+      }
+      auto options =
+          at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+      auto t0 = at::randn(shape, options);
+      std::vector<c10::IValue> inputs({t0});
+      FusionExecutorCache executor_cache(std::move(fusion));
+
+      // Run twice as the outputs must be zeroed before every launch
+      for (auto i : c10::irange(2)) {
+        (void)i;
+        auto cg_outputs = executor_cache.runFusionWithInputs(inputs);
+        testValidate(
+            executor_cache.fusion(), cg_outputs, inputs, __LINE__, __FILE__);
+      }
+
+      auto runtime = executor_cache.getMostRecentKernelRuntime();
+      ASSERT_FALSE(runtime->isSegmented());
+      auto rparams = runtime->schedulerHeuristics()
+                         ->heuristicsList()
+                         .at(0)
+                         ->params()
+                         ->as<ReductionParams>();
+      EXPECT_TRUE(rparams->cross_grid_inner_reduction);
+      // Determinism is the default
+      EXPECT_EQ(rparams->atomic_grid_reduction, atomic);
+      const std::string kernel_string =
+          runtime->executors().front().kernelString();
+      if (atomic) {
+        EXPECT_THAT(
+            kernel_string, testing::HasSubstr("reduction::atomicGridReduce<"));
+        EXPECT_THAT(
+            kernel_string,
+            testing::Not(testing::HasSubstr("reduction::gridReduce<")));
+      } else {
+        EXPECT_THAT(
+            kernel_string,
+            testing::Not(testing::HasSubstr("reduction::atomicGridReduce<")));
+      }
+    }
+  }
+}
+
+
+// Rows of the same values are reduced to bitwise identical results whatever
+// the number of rows is, although it changes the launch configuration
+TEST_F(OuterReductionTest, ReproducibleReduction) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::ReproducibleReduction);
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  const at::Tensor row = at::randn({100000}, options);
+
+  for (const int64_t reduction_axis : {0, 1}) {
+    std::vector<at::Tensor> results;
+    for (const int64_t num_rows : {1, 7, 4096}) {
+      auto fusion = std::make_unique<Fusion>();
+      FusionGuard fg(fusion.get());
+      auto tv0 = makeContigTensor(2);
+      fusion->addInput(tv0);
+      fusion->addOutput(sum(tv0, {reduction_axis}));
+
+      at::Tensor t0 = reduction_axis == 1
+          ? row.unsqueeze(0).expand({num_rows, -1}).contiguous()
+          : row.unsqueeze(1).expand({-1, num_rows}).contiguous();
+      std::vector<c10::IValue> inputs({t0});
+      FusionExecutorCache executor_cache(std::move(fusion));
+      auto cg_outputs = executor_cache.runFusionWithInputs(inputs);
+      testValidate(
+          executor_cache.fusion(), cg_outputs, inputs, __LINE__, __FILE__);
+
+      auto runtime = executor_cache.getMostRecentKernelRuntime();
+      auto rparams = runtime->schedulerHeuristics()
+                         ->heuristicsList()
+                         .at(0)
+                         ->params()
+                         ->as<ReductionParams>();
+      EXPECT_TRUE(rparams->cross_grid_inner_reduction);
+      EXPECT_FALSE(rparams->vectorize_inner_reduction);
+      results.push_back(cg_outputs.at(0));
+    }
+    for (const auto& result : results) {
+      EXPECT_TRUE(at::equal(result, results.front().expand_as(result)));
+    }
+  }
+
+  // Normalizations are segmented so that their reductions use the same tree
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  auto tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  auto tv2 = div(tv0, broadcast(tv1, {false, true}));
+  fusion->addOutput(tv2);
+  at::Tensor t0 = at::randn({128, 1024}, options);
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto cg_outputs = executor_cache.runFusionWithInputs({t0});
+  testValidate(executor_cache.fusion(), cg_outputs, {t0}, __LINE__, __FILE__);
+  EXPECT_TRUE(executor_cache.getMostRecentKernelRuntime()->isSegmented());
+}
+
+// The persistent buffer of a channels-last batch norm with a large N*H*W
+// doesn't fit in the registers of the device. With
+// EnableOption::TwoPassOuterNormalization, the input is read again after the
+// grid Welford instead of segmenting the fusion.
+TEST_F(OuterReductionTest, TwoPassGridPersistentWelford) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::TwoPassOuterNormalization);
+
+  auto fusion_ptr = std::make_unique<Fusion>();
+  FusionGuard fg(fusion_ptr.get());
+
+  const int64_t reduction_size = 64 * 56 * 56;
+  const int64_t channels = 128;
+  const double kEps = 1e-5;
+
+  auto tv0 = makeContigTensor(2);
+  fusion_ptr->addInput(tv0);
+  auto tvs = Welford(tv0, {0});
+  auto tv1 = sub(tv0, broadcast(tvs.avg, {true, false}));
+  auto tv2 = rsqrt(add(div(tvs.var_sum, tvs.n), IrBuilder::create<Val>(kEps)));
+  auto tv3 = mul(tv1, broadcast(tv2, {true, false}));
+  fusion_ptr->addOutput(tv3);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({reduction_size, channels}, options);
+
+  FusionExecutorCache executor_cache(std::move(fusion_ptr));
+  auto cg_outputs = executor_cache.runFusionWithInputs({t0});
+
+  FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+  ASSERT_FALSE(runtime->isSegmented());
+  const SchedulerEntry* entry = runtime->schedulers().front().get();
+  EXPECT_EQ(entry->heuristic(), ScheduleHeuristic::OuterPersistent);
+  const auto* rparams = entry->params()->as<ReductionParams>();
+  EXPECT_TRUE(rparams->global_mem_persistent_buffer);
+  EXPECT_TRUE(rparams->cross_grid_inner_reduction);
+
+  auto ref = (t0 - t0.mean({0})) *
+      at::rsqrt(t0.var({0}, /*unbiased=*/false) + kEps);
+  testValidate(
+      executor_cache.fusion(), cg_outputs, {t0}, {ref}, __LINE__, __FILE__);
+}
+
 } // namespace nvfuser
@@ -1381,4 +1381,43 @@ TEST_F(TransposeTest, ReductionIterDomainOnInputsIssue1659) {
   testValidate(fusion_ptr, cg_outputs, {t0, t1}, __LINE__, __FILE__);
 }
 
+// The largest two groups can't be tiled together because the second one has
+// no reference tensor, but the first and the third can
+TEST_F(TransposeTest, TileGroupsBeyondTheLargestTwo) {
+  auto fusion = std::make_unique<Fusion>();
+  auto fusion_ptr = fusion.get();
+  FusionGuard fg(fusion_ptr);
+
+  // [A, B, C], [C, B] and [C, B, A]
+  auto tv0 = makeContigTensor(3);
+  auto tv1 = makeContigTensor(2);
+  auto tv2 = makeContigTensor(3);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  fusion->addInput(tv2);
+  auto tv3 = broadcast(transpose(tv1, 0, 1), {true, false, false});
+  auto tv4 = transpose(tv2, 0, 2);
+  auto tv5 = add(add(tv0, tv3), tv4);
+  fusion->addOutput(tv5);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({256, 128, 256}, options);
+  auto t1 = at::randn({256, 128}, options);
+  auto t2 = at::randn({256, 128, 256}, options);
+  std::vector<c10::IValue> aten_inputs({t0, t1, t2});
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto cg_outputs = executor_cache.runFusionWithInputs(aten_inputs);
+
+  auto runtime = executor_cache.getMostRecentKernelRuntime();
+  NVF_CHECK(!runtime->isSegmented(), "Segmentation not expected");
+  auto heuristic =
+      runtime->schedulerHeuristics()->heuristicsList().at(0).get()->heuristic();
+  NVF_CHECK(
+      heuristic == ScheduleHeuristic::Transpose,
+      "Unexpected heuristic: ",
+      heuristic);
+  testValidate(fusion_ptr, cg_outputs, aten_inputs, __LINE__, __FILE__);
+}
+
 } // namespace nvfuser
@@ -12,6 +12,7 @@
 #include <fusion_segmenter.h>
 #include <host_ir/container.h>
 #include <host_ir/executor.h>
+#include <host_ir/pipeline_schedule.h>
 #include <ir/all_nodes.h>
 #include <ir/builder.h>
 #include <multidevice/lower_communication.h>
@@ -377,6 +378,207 @@ TEST_P(HostIrTest, ThreeFusions) {
   GTEST_EXPECT_TRUE(torch::allclose(tv2_2_ref, outputs.at(0)));
 }
 
+/*
+  The fourth test runs a Fusion on each microbatch of its input with a host
+  loop, whose index selects the microbatch:
+  tv0: input
+  FOR i in 0 : num_microbatches:
+    tv1 = Fusion0 (tv0, i)
+  tv1: output, holding the result of the last microbatch
+*/
+
+TEST_P(HostIrTest, ForLoop) {
+  constexpr int64_t num_microbatches = 4;
+  std::vector<int64_t> input_sizes = {num_microbatches, 8, 32};
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  auto tv0 = makeConcreteTensor(input_sizes);
+  auto microbatch = IrBuilder::create<Val>(DataType::Int);
+  auto tv1 = select(tv0, 0, microbatch);
+  auto tv2 = add(tv1, tv1);
+  fusion->addInput(tv0);
+  fusion->addInput(microbatch);
+  fusion->addOutput(tv2);
+
+  auto hic = std::make_unique<HostIrContainer>();
+  FusionGuard::setCurFusion(hic.get());
+  auto host_unit = IrBuilder::create<HostUnit>(
+      static_cast<IrContainer*>(hic.get()), std::move(fusion));
+
+  IrCloner ir_cloner(hic.get());
+  Fusion* fusion_to_execute = host_unit->fusion_to_execute();
+  Val* input = ir_cloner.clone(fusion_to_execute->inputs().at(0));
+  Val* index = ir_cloner.clone(fusion_to_execute->inputs().at(1));
+  Val* output = ir_cloner.clone(fusion_to_execute->outputs().at(0));
+  auto post_on_stream = IrBuilder::create<PostOnStream>(
+      static_cast<IrContainer*>(hic.get()),
+      host_unit,
+      std::vector<Val*>({input, index}),
+      std::vector<Val*>({output}));
+  auto for_loop = IrBuilder::create<ForLoop>(
+      static_cast<IrContainer*>(hic.get()),
+      index,
+      hic->zeroVal(DataType::Int),
+      IrBuilder::create<Val>(num_microbatches, DataType::Int));
+  for_loop->pushBackBody(post_on_stream);
+
+  hic->pushBackTopLevelExprs(for_loop);
+  hic->addInput(input);
+  hic->addOutput(output);
+
+  HostIrExecutorParams params;
+  auto [use_fusion_executor_cache] = GetParam();
+  params.use_fusion_executor_cache = use_fusion_executor_cache;
+  params.cache_fusion_executor = true;
+  HostIrExecutor hie(std::move(hic), std::move(params));
+
+  auto options = at::TensorOptions().device(at::kCUDA, 0);
+  at::Tensor input_tensor = at::randn(input_sizes, options);
+  auto ref_output = input_tensor[num_microbatches - 1] * 2;
+
+  auto outputs = hie.runWithInput({input_tensor});
+
+  GTEST_EXPECT_TRUE(torch::allclose(ref_output, outputs.at(0)));
+}
+
+/*
+  The fifth test adds a conditional to the previous one, so that only the
+  microbatch of index 2 is processed:
+  FOR i in 0 : num_microbatches:
+    IF i == 2:
+      tv1 = Fusion0 (tv0, i)
+*/
+
+TEST_P(HostIrTest, IfInForLoop) {
+  constexpr int64_t num_microbatches = 4;
+  constexpr int64_t selected_microbatch = 2;
+  std::vector<int64_t> input_sizes = {num_microbatches, 8, 32};
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  auto tv0 = makeConcreteTensor(input_sizes);
+  auto microbatch = IrBuilder::create<Val>(DataType::Int);
+  auto tv1 = select(tv0, 0, microbatch);
+  auto tv2 = add(tv1, tv1);
+  fusion->addInput(tv0);
+  fusion->addInput(microbatch);
+  fusion->addOutput(tv2);
+
+  auto hic = std::make_unique<HostIrContainer>();
+  FusionGuard::setCurFusion(hic.get());
+  auto host_unit = IrBuilder::create<HostUnit>(
+      static_cast<IrContainer*>(hic.get()), std::move(fusion));
+
+  IrCloner ir_cloner(hic.get());
+  Fusion* fusion_to_execute = host_unit->fusion_to_execute();
+  Val* input = ir_cloner.clone(fusion_to_execute->inputs().at(0));
+  Val* index = ir_cloner.clone(fusion_to_execute->inputs().at(1));
+  Val* output = ir_cloner.clone(fusion_to_execute->outputs().at(0));
+  auto post_on_stream = IrBuilder::create<PostOnStream>(
+      static_cast<IrContainer*>(hic.get()),
+      host_unit,
+      std::vector<Val*>({input, index}),
+      std::vector<Val*>({output}));
+  auto if_ = IrBuilder::create<If>(
+      static_cast<IrContainer*>(hic.get()),
+      IrBuilder::eqExpr(
+          index, IrBuilder::create<Val>(selected_microbatch, DataType::Int)));
+  if_->pushBackThenBody(post_on_stream);
+  auto for_loop = IrBuilder::create<ForLoop>(
+      static_cast<IrContainer*>(hic.get()),
+      index,
+      hic->zeroVal(DataType::Int),
+      IrBuilder::create<Val>(num_microbatches, DataType::Int));
+  for_loop->pushBackBody(if_);
+
+  hic->pushBackTopLevelExprs(for_loop);
+  hic->addInput(input);
+  hic->addOutput(output);
+
+  HostIrExecutorParams params;
+  auto [use_fusion_executor_cache] = GetParam();
+  params.use_fusion_executor_cache = use_fusion_executor_cache;
+  HostIrExecutor hie(std::move(hic), std::move(params));
+
+  auto options = at::TensorOptions().device(at::kCUDA, 0);
+  at::Tensor input_tensor = at::randn(input_sizes, options);
+  auto ref_output = input_tensor[selected_microbatch] * 2;
+
+  auto outputs = hie.runWithInput({input_tensor});
+
+  GTEST_EXPECT_TRUE(torch::allclose(ref_output, outputs.at(0)));
+}
+
+/*
+  The sixth test runs a Fusion on a side stream, synchronized with the initial
+  stream through an event, and allocates a buffer:
+  buffer = Allocate
+  SetCurrentStream 1
+  tv1 = Fusion0 (tv0)
+  RecordEvent 0
+  SetCurrentStream 0
+  WaitEvent 0
+*/
+
+TEST_P(HostIrTest, StreamsEventsAndAllocate) {
+  std::vector<int64_t> input_sizes = {8, 32};
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  auto tv0 = makeConcreteTensor(input_sizes);
+  auto tv1 = add(tv0, tv0);
+  fusion->addInput(tv0);
+  fusion->addOutput(tv1);
+
+  auto hic = std::make_unique<HostIrContainer>();
+  FusionGuard::setCurFusion(hic.get());
+  auto container = static_cast<IrContainer*>(hic.get());
+  auto host_unit = IrBuilder::create<HostUnit>(container, std::move(fusion));
+
+  IrCloner ir_cloner(hic.get());
+  Fusion* fusion_to_execute = host_unit->fusion_to_execute();
+  Val* input = ir_cloner.clone(fusion_to_execute->inputs().at(0));
+  Val* output = ir_cloner.clone(fusion_to_execute->outputs().at(0));
+  TensorView* buffer = makeConcreteTensor({4, 16}, DataType::Half);
+
+  Val* side_stream = IrBuilder::create<Val>(1, DataType::Int);
+  Val* initial_stream = hic->zeroVal(DataType::Int);
+  Val* event = hic->zeroVal(DataType::Int);
+  for (Expr* expr : std::vector<Expr*>{
+           IrBuilder::create<Allocate>(container, buffer),
+           IrBuilder::create<SetCurrentStream>(container, side_stream),
+           IrBuilder::create<PostOnStream>(
+               container,
+               host_unit,
+               std::vector<Val*>({input}),
+               std::vector<Val*>({output})),
+           IrBuilder::create<RecordEvent>(container, event),
+           IrBuilder::create<SetCurrentStream>(container, initial_stream),
+           IrBuilder::create<WaitEvent>(container, event)}) {
+    hic->pushBackTopLevelExprs(expr);
+  }
+  hic->addInput(input);
+  hic->addOutput(output);
+  hic->addOutput(buffer);
+
+  HostIrExecutorParams params;
+  auto [use_fusion_executor_cache] = GetParam();
+  params.use_fusion_executor_cache = use_fusion_executor_cache;
+  HostIrExecutor hie(std::move(hic), std::move(params));
+
+  auto options = at::TensorOptions().device(at::kCUDA, 0);
+  at::Tensor input_tensor = at::randn(input_sizes, options);
+  c10::cuda::CUDAStream stream = c10::cuda::getCurrentCUDAStream();
+
+  auto outputs = hie.runWithInput({input_tensor});
+
+  EXPECT_EQ(c10::cuda::getCurrentCUDAStream(), stream);
+  GTEST_EXPECT_TRUE(torch::allclose(input_tensor * 2, outputs.at(0)));
+  EXPECT_EQ(outputs.at(1).sizes(), at::IntArrayRef({4, 16}));
+  EXPECT_EQ(outputs.at(1).scalar_type(), at::ScalarType::Half);
+}
+
 INSTANTIATE_TEST_SUITE_P(
     Manual,
     HostIrTest,
@@ -387,6 +589,134 @@ INSTANTIATE_TEST_SUITE_P(
                                   : "use_fusion_executor");
     });
 
+/*
+  A recurrent loop carries the hidden state of a simple RNN over the timesteps
+  of a sequence:
+  FOR t in 0 : num_timesteps: carrying h <- h_next
+    h_next = Fusion0 (x, t, h, w)
+  with h_next = tanh(x[t] + h * w). With capture_loops_in_cuda_graph, the
+  second run captures the loop as a CUDA graph replayed by the next runs.
+*/
+
+using HostIrLoopTest = NVFuserFixtureParamTest<bool>;
+
+TEST_P(HostIrLoopTest, CarriedValues) {
+  constexpr int64_t num_timesteps = 8;
+  std::vector<int64_t> input_sizes = {num_timesteps, 4, 32};
+  std::vector<int64_t> state_sizes = {4, 32};
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  auto x = makeConcreteTensor(input_sizes);
+  auto timestep = IrBuilder::create<Val>(DataType::Int);
+  auto h = makeConcreteTensor(state_sizes);
+  auto w = makeConcreteTensor(state_sizes);
+  auto h_next = tanh(add(select(x, 0, timestep), mul(h, w)));
+  fusion->addInput(x);
+  fusion->addInput(timestep);
+  fusion->addInput(h);
+  fusion->addInput(w);
+  fusion->addOutput(h_next);
+
+  auto hic = std::make_unique<HostIrContainer>();
+  FusionGuard::setCurFusion(hic.get());
+  auto container = static_cast<IrContainer*>(hic.get());
+  auto host_unit = IrBuilder::create<HostUnit>(container, std::move(fusion));
+
+  IrCloner ir_cloner(hic.get());
+  std::vector<Val*> inputs;
+  for (auto input : host_unit->fusion_to_execute()->inputs()) {
+    inputs.push_back(ir_cloner.clone(input));
+  }
+  Val* output =
+      ir_cloner.clone(host_unit->fusion_to_execute()->outputs().at(0));
+  auto for_loop = IrBuilder::create<ForLoop>(
+      container,
+      inputs.at(1),
+      hic->zeroVal(DataType::Int),
+      IrBuilder::create<Val>(num_timesteps, DataType::Int));
+  for_loop->pushBackBody(IrBuilder::create<PostOnStream>(
+      container, host_unit, inputs, std::vector<Val*>({output})));
+  for_loop->pushBackCarriedVal(inputs.at(2), output);
+
+  hic->pushBackTopLevelExprs(for_loop);
+  hic->addInput(inputs.at(0));
+  hic->addInput(inputs.at(2));
+  hic->addInput(inputs.at(3));
+  hic->addOutput(inputs.at(2));
+
+  HostIrExecutorParams params;
+  params.cache_fusion_executor = true;
+  params.capture_loops_in_cuda_graph = GetParam();
+  HostIrExecutor hie(std::move(hic), std::move(params));
+
+  auto options = at::TensorOptions().device(at::kCUDA, 0);
+  at::Tensor x_tensor = at::randn(input_sizes, options);
+  at::Tensor h_tensor = at::randn(state_sizes, options);
+  at::Tensor w_tensor = at::randn(state_sizes, options);
+
+  // The first run compiles, the second one captures and the last ones replay,
+  // with new values in the same buffers for the last one
+  for (auto run : c10::irange(4)) {
+    if (run == 3) {
+      x_tensor.normal_();
+      h_tensor.normal_();
+    }
+    at::Tensor ref_output = h_tensor;
+    for (auto t : c10::irange(num_timesteps)) {
+      ref_output = at::tanh(x_tensor[t] + ref_output * w_tensor);
+    }
+
+    auto outputs = hie.runWithInput({x_tensor, h_tensor, w_tensor});
+
+    GTEST_EXPECT_TRUE(torch::allclose(ref_output, outputs.at(0)));
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    ,
+    HostIrLoopTest,
+    testing::Bool(),
+    [](const testing::TestParamInfo<bool>& info) -> std::string {
+      return info.param ? "cuda_graph" : "eager";
+    });
+
+using PipelineScheduleTest = NVFuserTest;
+
+TEST_F(PipelineScheduleTest, OneFOneB) {
+  using F = PipelinePass;
+  // The first stage fills the pipeline with a forward pass per stage after it
+  // before alternating forward and backward passes
+  std::vector<PipelineStep> first_stage = {
+      {F::Forward, 0},
+      {F::Forward, 1},
+      {F::Forward, 2},
+      {F::Backward, 0},
+      {F::Forward, 3},
+      {F::Backward, 1},
+      {F::Backward, 2},
+      {F::Backward, 3}};
+  EXPECT_EQ(getOneFOneBSchedule(3, 0, 4), first_stage);
+
+  // The last stage runs the backward pass of each microbatch right after its
+  // forward pass
+  std::vector<PipelineStep> last_stage = {
+      {F::Forward, 0},
+      {F::Backward, 0},
+      {F::Forward, 1},
+      {F::Backward, 1},
+      {F::Forward, 2},
+      {F::Backward, 2},
+      {F::Forward, 3},
+      {F::Backward, 3}};
+  EXPECT_EQ(getOneFOneBSchedule(3, 2, 4), last_stage);
+
+  // The warmup is capped by the number of microbatches
+  std::vector<PipelineStep> few_microbatches = {
+      {F::Forward, 0}, {F::Backward, 0}};
+  EXPECT_EQ(getOneFOneBSchedule(4, 0, 1), few_microbatches);
+}
+
 } // namespace hir
 
 } // namespace nvfuser
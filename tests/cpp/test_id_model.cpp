@@ -13,11 +13,13 @@
 #include <tests/cpp/utils.h>
 #include <tests/cpp/validator.h>
 
+#include <executor.h>
 #include <fusion.h>
 #include <id_model/id_model.h>
 #include <id_model/to_string.h>
 #include <inlining.h>
 #include <ops/all_ops.h>
+#include <options.h>
 #include <transform_iter.h>
 #include <val_graph_visitor.h>
 
@@ -2146,4 +2148,41 @@ TEST_F(IdModelTest, PermutedDifferently) {
   EXPECT_TRUE(iterDomainsAreMapped(id_model, s1->axis(2), t1->axis(2)));
 }
 
+// Global tensors indexed with TensorIndexer, where the producers are not
+// transformed like the loop domains of their consumers and a broadcast is
+// resolved through an inlined merge
+TEST_F(IdModelTest, TensorIndexerGlobalTensors) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = makeContigTensor(1);
+  fusion.addInput(tv1);
+  auto tv2 = broadcast(tv1, {true, false});
+  auto tv3 = add(tv0, tv2);
+  fusion.addOutput(tv3);
+
+  // The inputs are indexed from the loops of [(i0*i1)/128, 128], where the
+  // loops of tv2 are promoted to those of tv3
+  for (auto tv : {tv2, tv3}) {
+    tv->merge(0);
+    tv->split(0, 128);
+    tv->axis(0)->parallelize(ParallelType::BIDx);
+    tv->axis(1)->parallelize(ParallelType::TIDx);
+  }
+  inlineMost();
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({33, 65}, options);
+  at::Tensor t1 = at::randn({65}, options);
+
+  EnableOptionsGuard eog;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::IdModel);
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0, t1});
+  auto outputs = fe.runFusion({t0, t1});
+  testValidate(&fusion, outputs, {t0, t1}, __LINE__, __FILE__);
+}
+
 } // namespace nvfuser
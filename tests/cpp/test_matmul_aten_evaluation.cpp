@@ -469,6 +469,160 @@ TEST_P(ATenNodesParametrizedTest, MatmulNodeSymbolic) {
   EXPECT_TRUE(at::allclose(out[0], out_ref));
 }
 
+// Groups of different sizes, including an empty one, are multiplied without
+// padding. Rows after the last group are zero.
+TEST_F(MatmulATenEvaluationTest, GroupedMatmul) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  const int64_t num_groups = 4, m = 100, k = 32, n = 16;
+  auto tv0 = makeSymbolicTensor(2, DataType::Half);
+  auto tv1 = makeSymbolicTensor(3, DataType::Half);
+  auto tv2 = makeSymbolicTensor(1, DataType::Int);
+  auto tv3 = groupedMatmul(tv0, tv1, tv2);
+
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  fusion->addInput(tv2);
+  fusion->addOutput(tv3);
+
+  auto options = at::TensorOptions().device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({m, k}, options.dtype(at::kHalf));
+  at::Tensor t1 = at::randn({num_groups, k, n}, options.dtype(at::kHalf));
+  const std::vector<int64_t> ends = {7, 7, 64, 91};
+  at::Tensor t2 = at::tensor(ends, options.dtype(at::kLong));
+
+  at::Tensor out_ref = at::zeros({m, n}, options.dtype(at::kHalf));
+  int64_t begin = 0;
+  for (int64_t g : c10::irange(num_groups)) {
+    out_ref.narrow(0, begin, ends[g] - begin)
+        .copy_(at::matmul(t0.narrow(0, begin, ends[g] - begin), t1[g]));
+    begin = ends[g];
+  }
+
+  FusionExecutor fe;
+  fusion->aliasOutputToInput(
+      fusion->outputs()[0], /*input=*/nullptr, AllocationType::Evaluate);
+  fe.compileFusion(fusion.get(), {t0, t1, t2});
+  auto out = fe.runFusion({t0, t1, t2});
+
+  // Verify that fusion compilation was skipped.
+  EXPECT_FALSE(fe.hasCompiledKernel());
+
+  EXPECT_TRUE(at::allclose(out[0], out_ref));
+}
+
+// Cumulative sums, products and logsumexps are evaluated by ATen along the
+// given dimension, including negative ones.
+TEST_F(MatmulATenEvaluationTest, Scan) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = cumsum(tv0, 1);
+  auto tv2 = cumprod(tv0, -2);
+  auto tv3 = logcumsumexp(tv0, 1);
+  fusion->addOutput(tv1);
+  fusion->addOutput(tv2);
+  fusion->addOutput(tv3);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({8, 1000}, options);
+
+  FusionExecutor fe;
+  for (Val* out : fusion->outputs()) {
+    fusion->aliasOutputToInput(
+        out, /*input=*/nullptr, AllocationType::Evaluate);
+  }
+  fe.compileFusion(fusion.get(), {t0});
+  auto out = fe.runFusion({t0});
+
+  // Verify that fusion compilation was skipped.
+  EXPECT_FALSE(fe.hasCompiledKernel());
+
+  EXPECT_TRUE(at::allclose(out[0], at::cumsum(t0, 1)));
+  EXPECT_TRUE(at::allclose(out[1], at::cumprod(t0, 0)));
+  EXPECT_TRUE(at::allclose(out[2], at::logcumsumexp(t0, 1)));
+}
+
+// The top-k values and indices of a vocabulary-sized row, with k given at
+// runtime, and the indices that sort it.
+TEST_F(MatmulATenEvaluationTest, TopKAndArgsort) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  auto k = IrBuilder::create<Val>(DataType::Int);
+  fusion->addInput(tv0);
+  fusion->addInput(k);
+  auto [tv1, tv2] = topk(tv0, k);
+  auto tv3 = argsort(tv0, 1, /*descending=*/true, /*stable=*/true);
+  fusion->addOutput(tv1);
+  fusion->addOutput(tv2);
+  fusion->addOutput(tv3);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({4, 128 * 1024}, options);
+  std::vector<c10::IValue> inputs = {t0, 50};
+
+  FusionExecutor fe;
+  for (Val* out : fusion->outputs()) {
+    fusion->aliasOutputToInput(
+        out, /*input=*/nullptr, AllocationType::Evaluate);
+  }
+  fe.compileFusion(fusion.get(), inputs);
+  auto out = fe.runFusion(inputs);
+
+  // Verify that fusion compilation was skipped.
+  EXPECT_FALSE(fe.hasCompiledKernel());
+
+  auto [values_ref, indices_ref] = at::topk(t0, 50);
+  EXPECT_EQ(out[0].sizes(), at::IntArrayRef({4, 50}));
+  EXPECT_TRUE(at::equal(out[0], values_ref));
+  EXPECT_TRUE(at::equal(out[1], indices_ref));
+  EXPECT_TRUE(at::equal(
+      out[2], at::argsort(t0, /*stable=*/true, 1, /*descending=*/true)));
+}
+
+// An ATen-evaluated op in the middle of a fusion is segmented out and run
+// with ExpressionEvaluator, while the surrounding pointwise ops are still
+// generated.
+TEST_F(MatmulATenEvaluationTest, TopKSegment) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = exp(tv0);
+  auto [tv2, tv3] = topk(tv1, IrBuilder::create<Val>(8L));
+  auto tv4 = mul(tv2, IrBuilder::create<Val>(2.0));
+  fusion->addOutput(tv3);
+  fusion->addOutput(tv4);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({4, 1024}, options);
+
+  FusionExecutorCache fec(std::move(fusion));
+  auto out = fec.runFusionWithInputs({t0});
+
+  FusionKernelRuntime* runtime = fec.getMostRecentKernelRuntime();
+  const auto& groups = runtime->fusionSegments()->groups();
+  EXPECT_EQ(groups.size(), 3);
+  EXPECT_EQ(
+      std::count_if(
+          groups.begin(),
+          groups.end(),
+          [](SegmentedGroup* group) {
+            return group->heuristic() == ScheduleHeuristic::ExprEval;
+          }),
+      1);
+
+  auto [values_ref, indices_ref] = at::topk(at::exp(t0), 8);
+  EXPECT_TRUE(at::equal(out[0], indices_ref));
+  EXPECT_TRUE(at::allclose(out[1], values_ref * 2));
+}
+
 constexpr int64_t b = 128, m = 64, k = 32, n = 16;
 
 // Parametrize a_shape and b_shape
@@ -2728,6 +2728,421 @@ TEST_F(MatmulSchedulerTest, StridedInputs) {
   }
 }
 
+// Hopper runs the Ampere pipeline with more stages to use its larger shared
+// memory
+TEST_F(MatmulSchedulerTest, HopperPipelineStages) {
+  NVFUSER_TEST_CUDA_ARCH_GUARD(9, 0);
+  const int M = 512, N = 256, K = 1024;
+  const auto layout = MmaLayout::TT;
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2, DataType::Half);
+  auto tv1 = makeContigTensor(2, DataType::Half);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+
+  tv0 = canonicalizeInputToBMNK(tv0, layout, MmaOperand::A);
+  tv1 = canonicalizeInputToBMNK(tv1, layout, MmaOperand::B);
+  auto tv2 = fusedMultiplySum(tv0, tv1, {-1});
+
+  fusion->addOutput(tv2);
+
+  auto t0 = matmulAtInput2D(layout, TensorMatmulPos::A, at::kHalf, M, N, K);
+  auto t1 = matmulAtInput2D(layout, TensorMatmulPos::B, at::kHalf, M, N, K);
+  auto tref = atMatmul(t0.to(at::kFloat), t1.to(at::kFloat), layout);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  executor_cache.profile(true);
+  auto outputs = executor_cache.runFusionWithInputs({t0, t1});
+
+  FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+  ASSERT_FALSE(runtime->isSegmented());
+  ASSERT_TRUE(isSchedulerInUse(runtime, ScheduleHeuristic::Matmul));
+  HeuristicParams* heur = runtime->getMostRecentExecutorLog().params.get();
+  ASSERT_TRUE(heur->isA<MatmulParams>());
+  const MatmulParams* mmheur = heur->as<MatmulParams>();
+  EXPECT_TRUE(mmheur->async_gmem_load_operands);
+  EXPECT_GT(mmheur->double_buffer_options.smem_double_buffer_stage, 3);
+
+  testValidate(
+      executor_cache.fusion(), outputs, {t0, t1}, {tref}, __LINE__, __FILE__);
+}
+
+// Matmuls with many more tiles than CTAs that fit on the device loop over
+// the tiles with one wave of persistent CTAs. K is too short to be split.
+TEST_F(MatmulSchedulerTest, PersistentTiles) {
+  NVFUSER_TEST_CUDA_ARCH_GUARD(8, 0);
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::MatmulPersistentTiles);
+  const int M = 4096, N = 4096, K = 64;
+  const auto layout = MmaLayout::TN;
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2, DataType::Half);
+  auto tv1 = makeContigTensor(2, DataType::Half);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+
+  tv0 = canonicalizeInputToBMNK(tv0, layout, MmaOperand::A);
+  tv1 = canonicalizeInputToBMNK(tv1, layout, MmaOperand::B);
+  auto tv2 = fusedMultiplySum(tv0, tv1, {-1});
+  auto tv3 = castOp(DataType::Half, tv2);
+
+  fusion->addOutput(tv3);
+
+  auto t0 = matmulAtInput2D(layout, TensorMatmulPos::A, at::kHalf, M, N, K);
+  auto t1 = matmulAtInput2D(layout, TensorMatmulPos::B, at::kHalf, M, N, K);
+  auto tref = atMatmul(t0.to(at::kFloat), t1.to(at::kFloat), layout)
+                  .to(at::kHalf);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto outputs = executor_cache.runFusionWithInputs({t0, t1});
+
+  FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+  ASSERT_FALSE(runtime->isSegmented());
+  ASSERT_TRUE(isSchedulerInUse(runtime, ScheduleHeuristic::Matmul));
+  const MatmulParams& params =
+      runtime->schedulerHeuristics()->heuristicsList().front()->matmulParams();
+  EXPECT_EQ(params.splitk_factor, 1);
+  EXPECT_GT(params.num_persistent_ctas, 0);
+  const GemmTile& cta_tile = params.tile_sizes.cta_tile;
+  EXPECT_LT(
+      params.num_persistent_ctas,
+      ceilDiv(M, cta_tile.m) * ceilDiv(N, cta_tile.n));
+
+  testValidate(
+      executor_cache.fusion(), outputs, {t0, t1}, {tref}, __LINE__, __FILE__);
+}
+
+// Reductions of the epilogue along M and/or N are fused with the matmul, like
+// dgrad+dbias, the per-row maxima of a softmax and the amax of the result.
+TEST_F(MatmulSchedulerTest, EpilogueReductions) {
+  NVFUSER_TEST_CUDA_ARCH_GUARD(8, 0);
+  const int M = 504, N = 1024, K = 256;
+  const auto layout = MmaLayout::TN;
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2, DataType::Half);
+  auto tv1 = makeContigTensor(2, DataType::Half);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+
+  tv0 = canonicalizeInputToBMNK(tv0, layout, MmaOperand::A);
+  tv1 = canonicalizeInputToBMNK(tv1, layout, MmaOperand::B);
+  auto tv2 = fusedMultiplySum(tv0, tv1, {-1});
+  auto tv3 = castOp(DataType::Half, tv2);
+  auto tv4 = sum(tv2, {0});
+  auto tv5 = max(tv2, {1});
+  auto tv6 = castOp(DataType::Half, max(abs(tv2), {0, 1}));
+
+  fusion->addOutput(tv3);
+  fusion->addOutput(tv4);
+  fusion->addOutput(tv5);
+  fusion->addOutput(tv6);
+
+  auto t0 = matmulAtInput2D(layout, TensorMatmulPos::A, at::kHalf, M, N, K);
+  auto t1 = matmulAtInput2D(layout, TensorMatmulPos::B, at::kHalf, M, N, K);
+  auto t2 = atMatmul(t0.to(at::kFloat), t1.to(at::kFloat), layout);
+  auto t3 = t2.to(at::kHalf);
+  auto t4 = t2.sum(0);
+  auto t5 = std::get<0>(t2.max(1));
+  auto t6 = t2.abs().max().to(at::kHalf);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto outputs = executor_cache.runFusionWithInputs({t0, t1});
+
+  FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+  ASSERT_FALSE(runtime->isSegmented());
+  ASSERT_TRUE(isSchedulerInUse(runtime, ScheduleHeuristic::Matmul));
+  const MatmulParams& params =
+      runtime->schedulerHeuristics()->heuristicsList().front()->matmulParams();
+  EXPECT_TRUE(params.use_smem_epilogue);
+  EXPECT_EQ(params.splitk_factor, 1);
+
+  testValidate(
+      executor_cache.fusion(),
+      outputs,
+      {t0, t1},
+      {t3, t4, t5, t6},
+      __LINE__,
+      __FILE__);
+}
+
+// RMSNorm followed by a linear layer, where the normalization of the
+// activations with precomputed inverse RMS values is fused into the operand
+// load of the matmul
+TEST_F(MatmulSchedulerTest, OperandPrologueNormalization) {
+  NVFUSER_TEST_CUDA_ARCH_GUARD(8, 0);
+  const int M = 504, N = 136, K = 248;
+  const auto layout = MmaLayout::TN;
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2, DataType::Half);
+  auto tv1 = makeContigTensor(2, DataType::Half);
+  auto tv2 = makeContigTensor(1, DataType::Float);
+  auto tv3 = makeContigTensor(1, DataType::Half);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  fusion->addInput(tv2);
+  fusion->addInput(tv3);
+
+  auto tv4 = mul(tv0, broadcast(tv2, {false, true}));
+  tv4 = castOp(DataType::Half, mul(tv4, broadcast(tv3, {true, false})));
+  tv4 = canonicalizeInputToBMNK(tv4, layout, MmaOperand::A);
+  tv1 = canonicalizeInputToBMNK(tv1, layout, MmaOperand::B);
+  auto tv5 = castOp(DataType::Half, fusedMultiplySum(tv4, tv1, {-1}));
+  fusion->addOutput(tv5);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = matmulAtInput2D(layout, TensorMatmulPos::A, at::kHalf, M, N, K);
+  auto t1 = matmulAtInput2D(layout, TensorMatmulPos::B, at::kHalf, M, N, K);
+  auto t2 = at::rsqrt(t0.to(at::kFloat).square().mean({1}) + 1e-5);
+  auto t3 = at::randn({K}, options).to(at::kHalf);
+  auto t4 = (t0.to(at::kFloat) * t2.unsqueeze(1) * t3.to(at::kFloat))
+                .to(at::kHalf);
+  auto t5 = atMatmul(t4.to(at::kFloat), t1.to(at::kFloat), layout)
+                .to(at::kHalf);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto outputs = executor_cache.runFusionWithInputs({t0, t1, t2, t3});
+
+  FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+  ASSERT_FALSE(runtime->isSegmented());
+  ASSERT_TRUE(isSchedulerInUse(runtime, ScheduleHeuristic::Matmul));
+
+  testValidate(
+      executor_cache.fusion(),
+      outputs,
+      {t0, t1, t2, t3},
+      {t5},
+      __LINE__,
+      __FILE__);
+}
+
+// Weight-only quantized linear layer, where the 8-bit weights are dequantized
+// with per-channel scales on their load from shared memory
+TEST_F(MatmulSchedulerTest, OperandPrologueDequantization) {
+  // 8-bit floating point types were introduced in Hopper
+  NVFUSER_TEST_CUDA_ARCH_GUARD(9, 0);
+  const int M = 504, N = 136, K = 248;
+  const auto layout = MmaLayout::TN;
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2, DataType::Half);
+  auto tv1 = makeContigTensor(2, DataType::Float8_e4m3fn);
+  auto tv2 = makeContigTensor(1, DataType::Float);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  fusion->addInput(tv2);
+
+  auto tv3 = mul(castOp(DataType::Float, tv1), broadcast(tv2, {false, true}));
+  tv3 = castOp(DataType::Half, tv3);
+  tv0 = canonicalizeInputToBMNK(tv0, layout, MmaOperand::A);
+  tv3 = canonicalizeInputToBMNK(tv3, layout, MmaOperand::B);
+  auto tv4 = castOp(DataType::Half, fusedMultiplySum(tv0, tv3, {-1}));
+  fusion->addOutput(tv4);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = matmulAtInput2D(layout, TensorMatmulPos::A, at::kHalf, M, N, K);
+  auto t1 = matmulAtInput2D(layout, TensorMatmulPos::B, at::kFloat, M, N, K)
+                .to(at::kFloat8_e4m3fn);
+  auto t2 = at::rand({N}, options) + 0.5;
+  auto t3 = (t1.to(at::kFloat) * t2.unsqueeze(1)).to(at::kHalf);
+  auto t4 = atMatmul(t0.to(at::kFloat), t3.to(at::kFloat), layout)
+                .to(at::kHalf);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto outputs = executor_cache.runFusionWithInputs({t0, t1, t2});
+
+  FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+  ASSERT_FALSE(runtime->isSegmented());
+  ASSERT_TRUE(isSchedulerInUse(runtime, ScheduleHeuristic::Matmul));
+
+  testValidate(
+      executor_cache.fusion(),
+      outputs,
+      {t0, t1, t2},
+      {t4},
+      __LINE__,
+      __FILE__);
+}
+
+// Int8 x Int8 -> Int32 matmul on integer tensor cores, requantized to Int8
+// with per-channel scales in the epilogue
+TEST_F(MatmulSchedulerTest, Int8Requantization) {
+  NVFUSER_TEST_CUDA_ARCH_GUARD(8, 0);
+  const int M = 504, N = 136, K = 248;
+  const auto layout = MmaLayout::TN;
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2, DataType::Int8);
+  auto tv1 = makeContigTensor(2, DataType::Int8);
+  auto tv2 = makeContigTensor(1, DataType::Float);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  fusion->addInput(tv2);
+
+  tv0 = canonicalizeInputToBMNK(tv0, layout, MmaOperand::A);
+  tv1 = canonicalizeInputToBMNK(tv1, layout, MmaOperand::B);
+  auto tv3 = fusedMultiplySum(tv0, tv1, {-1});
+  auto tv4 = requantize(tv3, broadcast(tv2, {true, false}));
+  fusion->addOutput(tv4);
+
+  auto options = at::TensorOptions().dtype(at::kChar).device(at::kCUDA, 0);
+  auto t0 = at::randint(-128, 128, {M, K}, options);
+  auto t1 = at::randint(-128, 128, {N, K}, options);
+  auto t2 = at::rand({N}, options.dtype(at::kFloat)) * 1e-3;
+  // The accumulator is exactly representable in double
+  auto t3 = atMatmul(t0.to(at::kDouble), t1.to(at::kDouble), layout)
+                .to(at::kInt);
+  auto t4 = (t3.to(at::kFloat) * t2.unsqueeze(0))
+                .round()
+                .clamp(-128, 127)
+                .to(at::kChar);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto outputs = executor_cache.runFusionWithInputs({t0, t1, t2});
+
+  FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+  ASSERT_FALSE(runtime->isSegmented());
+  ASSERT_TRUE(isSchedulerInUse(runtime, ScheduleHeuristic::Matmul));
+
+  testValidate(
+      executor_cache.fusion(),
+      outputs,
+      {t0, t1, t2},
+      {t4},
+      __LINE__,
+      __FILE__);
+}
+
+// Linear layer with 2:4 structured-sparse weights as A, dense activations as
+// B and a bias and ReLU epilogue per output feature
+TEST_F(MatmulSchedulerTest, StructuredSparseWeights) {
+  NVFUSER_TEST_CUDA_ARCH_GUARD(8, 0);
+  const int M = 504, N = 136, K = 248;
+  const auto layout = MmaLayout::TN;
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2, DataType::Half);
+  auto tv1 = makeContigTensor(2, DataType::Int8);
+  auto tv2 = makeContigTensor(2, DataType::Half);
+  auto tv3 = makeContigTensor(1, DataType::Float);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  fusion->addInput(tv2);
+  fusion->addInput(tv3);
+
+  auto tv4 = decompress_2_4(tv0, tv1);
+  tv4 = canonicalizeInputToBMNK(tv4, layout, MmaOperand::A);
+  tv2 = canonicalizeInputToBMNK(tv2, layout, MmaOperand::B);
+  auto tv5 = fusedMultiplySum(tv4, tv2, {-1});
+  auto tv6 = relu(add(tv5, broadcast(tv3, {false, true})));
+  fusion->addOutput(castOp(DataType::Half, tv6));
+
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+  // Two distinct sorted positions in each group of four
+  auto positions =
+      at::rand({M, K / 4, 4}, options.dtype(at::kFloat)).argsort(-1);
+  positions = std::get<0>(positions.slice(-1, 0, 2).sort(-1));
+  auto t0 = at::randn({M, K / 2}, options);
+  auto t1 = (positions.select(-1, 0) + positions.select(-1, 1) * 4)
+                .to(at::kChar);
+  auto t2 = matmulAtInput2D(layout, TensorMatmulPos::B, at::kHalf, M, N, K);
+  auto t3 = at::randn({M}, options.dtype(at::kFloat));
+  auto dense = at::zeros({M, K / 4, 4}, options)
+                   .scatter_(-1, positions, t0.view({M, K / 4, 2}))
+                   .view({M, K});
+  auto t4 = (atMatmul(dense.to(at::kFloat), t2.to(at::kFloat), layout) +
+             t3.unsqueeze(1))
+                .relu()
+                .to(at::kHalf);
+
+  FusionExecutorCache executor_cache(std::move(fusion));
+  auto outputs = executor_cache.runFusionWithInputs({t0, t1, t2, t3});
+
+  FusionKernelRuntime* runtime = executor_cache.getMostRecentKernelRuntime();
+  ASSERT_TRUE(isSchedulerInUse(runtime, ScheduleHeuristic::Matmul));
+
+  testValidate(
+      executor_cache.fusion(),
+      outputs,
+      {t0, t1, t2, t3},
+      {t4},
+      __LINE__,
+      __FILE__);
+}
+
+// The analytical heuristic model splits K when the tiles of the output don't
+// fill the device, unless its weights make split-K too expensive
+TEST_F(MatmulSchedulerTest, HeuristicModel) {
+  NVFUSER_TEST_CUDA_ARCH_GUARD(8, 0);
+  const int M = 256, N = 256, K = 8192;
+  const auto layout = MmaLayout::TN;
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2, DataType::Half);
+  auto tv1 = makeContigTensor(2, DataType::Half);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+
+  tv0 = canonicalizeInputToBMNK(tv0, layout, MmaOperand::A);
+  tv1 = canonicalizeInputToBMNK(tv1, layout, MmaOperand::B);
+  auto tv2 = fusedMultiplySum(tv0, tv1, {-1});
+  auto tv3 = castOp(DataType::Half, tv2);
+
+  fusion->addOutput(tv3);
+
+  auto t0 = matmulAtInput2D(layout, TensorMatmulPos::A, at::kHalf, M, N, K);
+  auto t1 = matmulAtInput2D(layout, TensorMatmulPos::B, at::kHalf, M, N, K);
+  auto tref = atMatmul(t0.to(at::kFloat), t1.to(at::kFloat), layout)
+                  .to(at::kHalf);
+
+  for (bool expensive_splitk : {false, true}) {
+    EnableOptionsGuard opt_guard;
+    if (expensive_splitk) {
+      EnableOptionsGuard::getCurOptions().set(
+          EnableOption::MatmulHeuristicModel, {"splitk_cost=1e6"});
+    } else {
+      EnableOptionsGuard::getCurOptions().set(
+          EnableOption::MatmulHeuristicModel);
+    }
+
+    FusionExecutorCache executor_cache(std::make_unique<Fusion>(*fusion));
+    auto outputs = executor_cache.runFusionWithInputs({t0, t1});
+
+    FusionKernelRuntime* runtime =
+        executor_cache.getMostRecentKernelRuntime();
+    ASSERT_FALSE(runtime->isSegmented());
+    ASSERT_TRUE(isSchedulerInUse(runtime, ScheduleHeuristic::Matmul));
+    const MatmulParams& params = runtime->schedulerHeuristics()
+                                     ->heuristicsList()
+                                     .front()
+                                     ->matmulParams();
+    if (expensive_splitk) {
+      EXPECT_EQ(params.splitk_factor, 1);
+    } else {
+      EXPECT_GT(params.splitk_factor, 1);
+    }
+
+    testValidate(
+        executor_cache.fusion(),
+        outputs,
+        {t0, t1},
+        {tref},
+        __LINE__,
+        __FILE__);
+  }
+}
+
 class TestKernelConfig : public matmul_heuristic_plugin::KernelConfig {
   void configure() override {
     // Set load_stages to 0, which is an allowed value (with a warning), but not
@@ -171,6 +171,31 @@ TEST_F(MemoryTest, RefineCachePolicy) {
   testValidate(&fusion, actual_outputs, {a, b}, {c}, __LINE__, __FILE__);
 }
 
+// Use ld.ca for tensors loaded more than once.
+TEST_F(MemoryTest, RefineCachePolicyOfReloadedTensor) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  TensorView* tv_a = makeContigTensor(1);
+  TensorView* tv_b = makeContigTensor(1);
+  fusion.addInput(tv_a);
+  fusion.addInput(tv_b);
+  TensorView* tv_a2 = set(tv_a);
+  TensorView* tv_a3 = set(tv_a);
+  TensorView* tv_b2 = set(tv_b);
+  fusion.addOutput(add(tv_a2, tv_b2));
+  fusion.addOutput(mul(tv_a3, IrBuilder::create<Val>(2.0)));
+
+  refineCachePolicy(&fusion);
+
+  for (auto tv : {tv_a2, tv_a3}) {
+    EXPECT_EQ(
+        tv->definition()->as<LoadStoreOp>()->cacheOp(), CacheOp::AllLevels);
+  }
+  EXPECT_EQ(
+      tv_b2->definition()->as<LoadStoreOp>()->cacheOp(), CacheOp::Streaming);
+}
+
 // Begin TMA tests
 
 class TMATest : public NVFuserTest {
@@ -318,7 +343,9 @@ class TMADimChecker : private kir::IrVisitor {
     kir::TensorIndex* gmem_ti = nullptr;
     if (ir_utils::isCpAsyncBulkLoad(expr)) {
       gmem_ti = expr->input(0)->as<kir::TensorIndex>();
-    } else if (ir_utils::isCpAsyncBulkStore(expr)) {
+    } else if (
+        ir_utils::isCpAsyncBulkStore(expr) ||
+        ir_utils::isCpAsyncBulkReduction(expr)) {
       gmem_ti = expr->output(0)->as<kir::TensorIndex>();
     }
     if (gmem_ti == nullptr) {
@@ -1098,6 +1125,47 @@ TEST_F(TMAMiscTest, LoadStrongCorrectness) {
 
 // It is not required to run compile-time invalid case tests on Hopper or newer
 // GPUs. Detecting invalid cases does not even require a GPU.
+// The blocks of a split reduction add their tiles to the output with
+// cp.reduce.async.bulk.tensor, like the partial results of a split-K GEMM
+TEST_F(TMAMiscTest, BulkReduction) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  const DataType dtype = DataType::Float;
+
+  auto tv0 = makeContigTensor(2, dtype);
+  fusion.addInput(tv0);
+  auto tv1 = set(tv0);
+  auto tv2 = sum(tv1, {0});
+  fusion.addOutput(tv2);
+
+  tv1->setMemoryType(MemoryType::Shared);
+  tv2->definition()->as<ReductionOp>()->requestAtomicGridReduction();
+
+  // Every block loads a tile of a split into shared memory
+  tv1->split(1, 128);
+  tv1->axis(0)->parallelize(ParallelType::BIDy);
+  tv1->axis(1)->parallelize(ParallelType::BIDx);
+  tv1->axis(2)->parallelize(ParallelType::TIDx);
+
+  // and adds it to the output with TMA
+  tv2->split(1, 128);
+  tv2->axis(0)->parallelize(ParallelType::BIDy);
+  tv2->axis(1)->parallelize(ParallelType::BIDx);
+  tv2->axis(2)->parallelize(ParallelType::Bulk);
+
+  auto options =
+      at::TensorOptions().dtype(data_type_to_aten(dtype)).device(at::kCUDA, 0);
+  auto t0 = at::randn({8, 4096}, options);
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0}, {}, matmul_cparams);
+
+  EXPECT_EQ(TMADimChecker::getDim(fe.kernel()), 1);
+
+  auto cg_outputs = fe.runFusion({t0});
+  testValidate(&fusion, cg_outputs, {t0}, __LINE__, __FILE__);
+}
+
 class TMACompileTimeInvalidTest : public NVFuserTest {};
 class TMARuntimeInvalidTest : public TMATest {};
 
@@ -274,6 +274,62 @@ INSTANTIATE_TEST_SUITE_P(
         all_dtypes),
     testName);
 
+// Int8 operands have to be K-major, so only the TN layout is tested
+class MmaInt8Test : public NVFuserFixtureParamTest<MmaMacro> {
+ protected:
+  MmaMacro macro;
+
+  void SetUp() override {
+    macro = GetParam();
+
+    if (cudaArchGuardShouldSkip(8, 0)) {
+      GTEST_SKIP() << "skipping tests on pre-Ampere GPUs";
+    }
+
+    NVFuserTest::SetUp();
+  }
+};
+
+TEST_P(MmaInt8Test, SingleTile) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+  auto M = getM(macro);
+  auto N = getN(macro);
+  auto K = getK(macro);
+
+  auto tv0 = makeConcreteTensor({M, 1, K}, DataType::Int8);
+  auto tv1 = makeConcreteTensor({1, N, K}, DataType::Int8);
+
+  auto options = at::TensorOptions().dtype(at::kChar).device(at::kCUDA, 0);
+  auto a_input = at::randint(-128, 128, {M, 1, K}, options);
+  auto b_input = at::randint(-128, 128, {1, N, K}, options);
+
+  auto cg_outputs = scheduleCompileAndRun(
+      &fusion,
+      tv0,
+      tv1,
+      {a_input, b_input},
+      2 /*dim to reduce [M, N, K]*/,
+      macro,
+      false /* propagate backwards*/);
+
+  // The products are exactly representable in double
+  auto tref = a_input.squeeze()
+                  .to(at::kDouble)
+                  .matmul(b_input.squeeze().t().to(at::kDouble))
+                  .to(at::kInt);
+
+  EXPECT_TRUE(at::equal(cg_outputs[0], tref));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Ampere,
+    MmaInt8Test,
+    testing::Values(MmaMacro::Ampere_16_8_32, MmaMacro::Ampere_16_16_32),
+    [](const testing::TestParamInfo<MmaMacro>& info) {
+      return toString(info.param);
+    });
+
 class HopperBase : public NVFuserTest {
  protected:
   void SetUp() override {
@@ -640,4 +696,154 @@ INSTANTIATE_TEST_SUITE_P(
         kAllSmemSwizzleModes),
     testNameHopperSS);
 
+auto all_hopper_fp8_macros = testing::Values(
+    MmaMacro::Hopper_64_8_32,
+    MmaMacro::Hopper_64_16_32,
+    MmaMacro::Hopper_64_24_32,
+    MmaMacro::Hopper_64_32_32,
+    MmaMacro::Hopper_64_40_32,
+    MmaMacro::Hopper_64_48_32,
+    MmaMacro::Hopper_64_56_32,
+    MmaMacro::Hopper_64_64_32,
+    MmaMacro::Hopper_64_72_32,
+    MmaMacro::Hopper_64_80_32,
+    MmaMacro::Hopper_64_88_32,
+    MmaMacro::Hopper_64_96_32,
+    MmaMacro::Hopper_64_104_32,
+    MmaMacro::Hopper_64_112_32,
+    MmaMacro::Hopper_64_120_32,
+    MmaMacro::Hopper_64_128_32,
+    MmaMacro::Hopper_64_136_32,
+    MmaMacro::Hopper_64_144_32,
+    MmaMacro::Hopper_64_152_32,
+    MmaMacro::Hopper_64_160_32,
+    MmaMacro::Hopper_64_168_32,
+    MmaMacro::Hopper_64_176_32,
+    MmaMacro::Hopper_64_184_32,
+    MmaMacro::Hopper_64_192_32,
+    MmaMacro::Hopper_64_200_32,
+    MmaMacro::Hopper_64_208_32,
+    MmaMacro::Hopper_64_216_32,
+    MmaMacro::Hopper_64_224_32,
+    MmaMacro::Hopper_64_232_32,
+    MmaMacro::Hopper_64_240_32,
+    MmaMacro::Hopper_64_248_32,
+    MmaMacro::Hopper_64_256_32);
+
+// A and B can have different 8-bit floating point types
+using HopperMmaFp8TestParams = std::tuple<
+    MmaMacro,
+    PrimDataType,
+    PrimDataType,
+    MmaInputSmemSwizzle,
+    MmaInputSmemSwizzle>;
+
+class HopperSSFp8
+    : public HopperBase,
+      public ::testing::WithParamInterface<HopperMmaFp8TestParams> {
+ protected:
+  MmaMacro macro;
+  PrimDataType dtype_a;
+  PrimDataType dtype_b;
+  MmaInputSmemSwizzle swizzle_a;
+  MmaInputSmemSwizzle swizzle_b;
+
+  void SetUp() override {
+    HopperBase::SetUp();
+
+    macro = std::get<0>(GetParam());
+    dtype_a = std::get<1>(GetParam());
+    dtype_b = std::get<2>(GetParam());
+    swizzle_a = std::get<3>(GetParam());
+    swizzle_b = std::get<4>(GetParam());
+  }
+};
+
+// 8-bit operands are always K-major, so only the TN layout is tested
+TEST_P(HopperSSFp8, SingleTile) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  const auto layout = MmaLayout::TN;
+  auto shapes = matmulAtInputShape3DHopperSS(
+      getM(macro), getN(macro), getK(macro), layout);
+
+  auto tv0 = makeConcreteTensor(shapes.first, dtype_a);
+  auto tv1 = makeConcreteTensor(shapes.second, dtype_b);
+  fusion.addInput(tv0);
+  fusion.addInput(tv1);
+
+  // Just doing a gmem->smem copy
+  tv0 = set(tv0);
+  tv0->setMemoryType(MemoryType::Shared);
+  tv1 = set(tv1);
+  tv1->setMemoryType(MemoryType::Shared);
+
+  // [M, N, K]
+  auto tv2 = fusedMultiplySum(tv0, tv1, {2});
+
+  fusion.addOutput(tv2);
+
+  auto mma_ops = ir_utils::getOpsOfType<MmaOp>(&fusion);
+  NVF_CHECK(
+      1 == mma_ops.size(),
+      "Invalid number of MmaOp instances in fusion definition, expected 1, got ",
+      mma_ops.size());
+  mma_ops.front()->setMacro(macro);
+
+  auto tv2c = tv2->cacheBefore();
+
+  moveInnerBroadcastLeft(tv0);
+  moveInnerBroadcastLeft(tv1);
+
+  tv0->applyMmaSwizzle(swizzle_a);
+  tv1->applyMmaSwizzle(swizzle_b);
+
+  naivelyParallelize(tv0);
+  naivelyParallelize(tv1);
+
+  tv2c->applyMmaSwizzle(MmaOperand::Accumulator);
+  tv2->applyMmaSwizzle(MmaOperand::Accumulator);
+
+  // at::randn doesn't generate 8-bit floating point numbers
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 =
+      at::randn(shapes.first, options).to(data_type_to_aten(dtype_a));
+  at::Tensor t1 =
+      at::randn(shapes.second, options).to(data_type_to_aten(dtype_b));
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0, t1}, LaunchParams(), matmul_cparams);
+  auto cg_outputs = fe.runFusion({t0, t1});
+  // The products of 8-bit numbers are exact in fp32, but the tensor cores
+  // accumulate them with fewer mantissa bits
+  auto tref = atMatmul(
+      t0.squeeze().to(at::kFloat), t1.squeeze().to(at::kFloat), layout);
+  EXPECT_TRUE(at::allclose(cg_outputs[0], tref, 1e-3, 1e-3));
+}
+
+std::string testNameHopperSSFp8(
+    const testing::TestParamInfo<HopperMmaFp8TestParams>& info) {
+  std::ostringstream os;
+  auto macro = std::get<0>(info.param);
+  auto dtype_a = std::get<1>(info.param);
+  auto dtype_b = std::get<2>(info.param);
+  auto swizzle_a = std::get<3>(info.param);
+  auto swizzle_b = std::get<4>(info.param);
+  os << toString(macro) << "_" << toString(swizzle_a) << "_"
+     << toString(swizzle_b) << "_" << dtype_a << "_" << dtype_b;
+  return os.str();
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    MmaTest,
+    HopperSSFp8,
+    testing::Combine(
+        all_hopper_fp8_macros,
+        testing::Values(DataType::Float8_e4m3fn, DataType::Float8_e5m2),
+        testing::Values(DataType::Float8_e4m3fn, DataType::Float8_e5m2),
+        kAllSmemSwizzleModes,
+        kAllSmemSwizzleModes),
+    testNameHopperSSFp8);
+
 } // namespace nvfuser
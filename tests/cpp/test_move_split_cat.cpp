@@ -576,4 +576,41 @@ TEST_F(MoveSplitCatTest, MultipleCatsOnSameSplit) {
   EXPECT_TRUE(out_tensors[1].is_alias_of(in_tensor));
 }
 
+TEST_F(MoveSplitCatTest, RotateHalf) {
+  constexpr int64_t b = 2, s = 16, h = 4, f = 64;
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  TensorView* q = makeContigConcreteTensor({b, s, h, f});
+  TensorView* cos = makeContigConcreteTensor({s, f});
+  TensorView* sin = makeContigConcreteTensor({s, f});
+  fusion->addInput(q);
+  fusion->addInput(cos);
+  fusion->addInput(sin);
+
+  q = permute(q, {0, 2, 1, 3});
+  TensorView* q_real = slice(q, {0, 0, 0, 0}, {b, h, s, f / 2});
+  TensorView* q_image = slice(q, {0, 0, 0, f / 2}, {b, h, s, f});
+  q_image = neg(q_image);
+  TensorView* q_rotated = cat({q_image, q_real}, /*dim=*/-1);
+  cos = broadcast(cos, {true, true, false, false});
+  sin = broadcast(sin, {true, true, false, false});
+  TensorView* out = add(mul(q, cos), mul(q_rotated, sin));
+  fusion->addOutput(out);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor q_tensor = at::randn({b, s, h, f}, options);
+  at::Tensor cos_tensor = at::randn({s, f}, options);
+  at::Tensor sin_tensor = at::randn({s, f}, options);
+  std::vector<c10::IValue> inputs = {q_tensor, cos_tensor, sin_tensor};
+
+  FusionExecutorCache fec(std::move(fusion));
+  auto out_tensors = fec.runFusionWithInputs(inputs);
+  testValidate(fec.fusion(), out_tensors, inputs, __LINE__, __FILE__);
+
+  // The slices and the cat are replaced with pads of `q`, so the rotation
+  // doesn't need to be segmented.
+  EXPECT_FALSE(fec.getMostRecentKernelRuntime()->isSegmented());
+}
+
 } // namespace nvfuser
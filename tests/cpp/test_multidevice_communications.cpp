@@ -11,6 +11,7 @@
 #include <ir/builder.h>
 #include <multidevice/communication.h>
 #include <multidevice/communicator.h>
+#include <multidevice/peer_memory.h>
 #include <tests/cpp/multidevice.h>
 
 #include <iostream>
@@ -369,4 +370,38 @@ INSTANTIATE_TEST_SUITE_P(
     testing::Values(CommunicatorBackend::nccl, CommunicatorBackend::ucc),
     testing::PrintToStringParamName());
 
+using PeerMemoryTest = MultiDeviceTest;
+
+TEST_F(PeerMemoryTest, Allgather) {
+  if (!isPeerMemoryAvailable(*communicator)) {
+    GTEST_SKIP() << "Peer memory not available";
+  }
+  constexpr int tensor_size = 1024;
+  constexpr int num_repetitions = 8;
+  std::vector<DeviceIdxType> all_ranks(communicator->size());
+  std::iota(all_ranks.begin(), all_ranks.end(), 0);
+  PeerMemoryAllgather allgather(
+      *communicator,
+      all_ranks,
+      {communicator->size(), tensor_size},
+      tensor_options);
+
+  // The buffers and semaphores are reused across repetitions
+  at::Tensor input_tensor = at::empty({1, tensor_size}, tensor_options);
+  for (auto repetition : c10::irange(num_repetitions)) {
+    input_tensor.copy_(
+        at::arange(tensor_size, tensor_options).unsqueeze(0) +
+        (communicator->deviceId() + 1) * repetition);
+    allgather.post(input_tensor);
+
+    at::Tensor ref = at::arange(tensor_size, tensor_options).unsqueeze(0) +
+        at::arange(1, communicator->size() + 1, tensor_options).unsqueeze(1) *
+            repetition;
+    EXPECT_TRUE(allgather.output().equal(ref))
+        << "Device " << communicator->deviceId() << " expected tensor:\n"
+        << ref << "\nbut obtained tensor:\n"
+        << allgather.output();
+  }
+}
+
 } // namespace nvfuser
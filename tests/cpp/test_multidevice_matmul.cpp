@@ -184,6 +184,52 @@ TEST_F(DistributedMatmulTest, LayoutTN_Allgather) {
       __FILE__);
 }
 
+TEST_F(DistributedMatmulTest, LayoutTN_DecomposedAllgatherMatmul) {
+  // MmaLayout::TN matmul A(T), B(N), C(T)
+  // A is sharded on dimension M
+  // Tests allgather + local matmul, decomposed into a matmul per shard of A
+  // overlapping with a ring exchange of the shards
+  std::unique_ptr<Fusion> fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  auto mesh = DeviceMesh::createForNumDevices(communicator->size());
+
+  int M = 256, N = 64, K = 64;
+  int Mo = num_devices_;
+  int Mi = M / Mo;
+
+  TensorView* a = makeContigTensor(3, DataType::Half); // (Mo,Mi,K)
+  TensorView* b = makeContigTensor(2, DataType::Half); // (N,K)
+  TensorView* a_gathered = set(a); // (Mo,Mi,K)
+  TensorView* a_b = broadcast(a_gathered, {false, false, true, false});
+  TensorView* b_b = broadcast(b, {true, true, false, false}); // (b,b,N,K)
+  TensorView* ab = mul(a_b, b_b); // (Mo,Mi,N,K)
+  TensorView* c = sum(ab, {-1}); // (Mo,Mi,N,r)
+
+  fusion->addInput(a);
+  fusion->addInput(b);
+  fusion->addOutput(c);
+
+  // Sharding M dimension of A only
+  a->axis(0)->parallelize(ParallelType::DIDx);
+  for (auto tv : {a, b, a_gathered, a_b, b_b, ab, c}) {
+    tv->setDeviceMesh(mesh);
+  }
+
+  auto [in0, in1, out] = getInputsAndReferenceOutputs(MmaLayout::TN, M, N, K);
+  in0 = in0.view({Mo, Mi, K});
+  out = out.view({Mo, Mi, N});
+
+  std::vector<c10::IValue> inputs = {
+      shardTensor(in0, a, communicator->deviceId()), in1};
+  MultiDeviceExecutorParams params = executor_params_;
+  params.decompose_allgather = true;
+  MultiDeviceExecutor runtime(std::move(fusion), *communicator, params);
+  auto outputs = runtime.runWithInput(inputs);
+
+  testValidate(
+      runtime.completeFusion(), outputs, inputs, {out}, __LINE__, __FILE__);
+}
+
 TEST_F(DistributedMatmulTest, LayoutNT_AllReduce) {
   // MmaLayout::NT matmul A(N), B(T), C(T)
   // Sharding: A, B are sharded along K. C is replicated.
@@ -126,6 +126,118 @@ TEST_F(PipelineTest, Pipeline) {
   executeAndValidate();
 }
 
+// The compute of device 1 that doesn't depend on the communication from
+// device 0 can run before the communication is waited for
+class PipelineTestCommunicationOverlap
+    : public PipelineTest,
+      public testing::WithParamInterface<bool> {};
+
+TEST_P(PipelineTestCommunicationOverlap, IndependentCompute) {
+  const std::vector<int64_t> input_shape = {4, 8};
+  multi_device_executor_params.overlap_communications = GetParam();
+
+  FusionGuard fg(fusion.get());
+  TensorView* tv0 = makeConcreteTensor(input_shape);
+  TensorView* tv1 = makeConcreteTensor(input_shape);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  TensorView* tv2 = sum(tv0, {1});
+  TensorView* tv3 = set(tv2);
+  TensorView* tv4 = sum(tv1, {1});
+  TensorView* tv5 = mul(tv4, tv4);
+  TensorView* tv6 = add(tv3, tv5);
+  fusion->addOutput(tv6);
+
+  DeviceMesh mesh0({0});
+  DeviceMesh mesh1({1});
+  tv0->setDeviceMesh(mesh0);
+  tv2->setDeviceMesh(mesh0);
+  for (auto tv : {tv1, tv3, tv4, tv5, tv6}) {
+    tv->setDeviceMesh(mesh1);
+  }
+
+  unsharded_inputs = {
+      at::randn(input_shape, tensor_options),
+      at::randn(input_shape, tensor_options)};
+
+  executeAndValidate();
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    ,
+    PipelineTestCommunicationOverlap,
+    testing::Bool(),
+    [](const testing::TestParamInfo<bool>& info) {
+      return info.param ? "Overlap" : "NoOverlap";
+    });
+
+class PipelineTestCoalescing : public PipelineTest,
+                               public testing::WithParamInterface<bool> {};
+
+TEST_P(PipelineTestCoalescing, SmallAllgathersAndAllreduces) {
+  const int64_t num_devices = communicator->size();
+  multi_device_executor_params.coalesce_communications = GetParam();
+
+  FusionGuard fg(fusion.get());
+  auto mesh = DeviceMesh::createForNumDevices(num_devices);
+  std::vector<TensorView*> gathered;
+  std::vector<TensorView*> reduced;
+  for (auto i : c10::irange(3)) {
+    TensorView* tv = makeConcreteTensor({num_devices, i + 1, 4});
+    fusion->addInput(tv);
+    TensorView* tv_gathered = set(tv);
+    TensorView* tv_reduced = sum(tv, {0});
+    tv->axis(0)->parallelize(ParallelType::DIDx);
+    for (auto t : {tv, tv_gathered, tv_reduced}) {
+      t->setDeviceMesh(mesh);
+    }
+    fusion->addOutput(add(tv_gathered, tv_gathered));
+    fusion->addOutput(add(tv_reduced, tv_reduced));
+  }
+  for (auto tv : fusion->outputs()) {
+    tv->as<TensorView>()->setDeviceMesh(mesh);
+  }
+
+  for (auto i : c10::irange(3)) {
+    unsharded_inputs.push_back(
+        at::randn({num_devices, i + 1, 4}, tensor_options));
+  }
+
+  executeAndValidate();
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    ,
+    PipelineTestCoalescing,
+    testing::Bool(),
+    [](const testing::TestParamInfo<bool>& info) {
+      return info.param ? "Coalesced" : "NotCoalesced";
+    });
+
+// The backends of the Allgather and Allreduce teams are created when the
+// executor is instantiated
+TEST_F(PipelineTest, WarmupBackends) {
+  const int64_t num_devices = communicator->size();
+  multi_device_executor_params.warmup_backends = true;
+
+  FusionGuard fg(fusion.get());
+  auto mesh = DeviceMesh::createForNumDevices(num_devices);
+  TensorView* tv0 = makeConcreteTensor({num_devices, 4});
+  fusion->addInput(tv0);
+  TensorView* tv1 = set(tv0);
+  TensorView* tv2 = sum(tv0, {0});
+  fusion->addOutput(tv1);
+  fusion->addOutput(tv2);
+  tv0->axis(0)->parallelize(ParallelType::DIDx);
+  for (auto tv : {tv0, tv1, tv2}) {
+    tv->setDeviceMesh(mesh);
+  }
+
+  unsharded_inputs = {at::randn({num_devices, 4}, tensor_options)};
+
+  executeAndValidate();
+}
+
 //(backend type, first stage's mesh, second stage's mesh (if not null), is first
 // stage sharded?, is second
 // stage sharded?, do_reduction?, sharded dimension, use_fusion_executor_cache?)
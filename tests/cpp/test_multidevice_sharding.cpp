@@ -7,6 +7,7 @@
 // clang-format on
 #include <fusion.h>
 #include <gtest/gtest.h>
+#include <multidevice/auto_sharding.h>
 #include <multidevice/executor.h>
 #include <multidevice/utils.h>
 #include <ops/all_ops.h>
@@ -124,4 +125,46 @@ INSTANTIATE_TEST_SUITE_P(
       return os.str();
     });
 
+using AutoShardingTest = MultiDeviceTest;
+
+// Only the input is annotated. The pointwise op and the inner reduction are
+// cheaper sharded like the input, and the outer reduction becomes an
+// Allreduce.
+TEST_F(AutoShardingTest, PointwiseAndReductions) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  int num_devices = communicator->size();
+  auto mesh = DeviceMesh::createForNumDevices(num_devices);
+  std::vector<int64_t> input_size = {num_devices, 16, 32};
+
+  TensorView* tv0 = makeConcreteTensor(input_size);
+  TensorView* tv1 = add(tv0, tv0);
+  TensorView* tv2 = sum(tv1, {2});
+  TensorView* tv3 = sum(tv2, {0});
+  fusion->addInput(tv0);
+  fusion->addOutput(tv3);
+
+  tv0->setDeviceMesh(mesh);
+  tv0->axis(0)->parallelize(ParallelType::DIDx);
+  autoShard(fusion.get(), mesh);
+
+  for (auto tv : {tv1, tv2, tv3}) {
+    EXPECT_EQ(tv->getDeviceMesh().vector(), mesh.vector());
+  }
+  if (num_devices > 1) {
+    EXPECT_TRUE(tv1->axis(0)->isDeviceDim());
+    EXPECT_TRUE(tv2->axis(0)->isDeviceDim());
+  }
+  EXPECT_FALSE(isSharded(tv3));
+
+  auto x0 = at::randn(input_size, tensor_options);
+  std::vector<c10::IValue> inputs = {
+      shardTensor(x0, tv0, communicator->deviceId())};
+  auto x3 = at::sum(x0 + x0, {2, 0});
+  MultiDeviceExecutor runtime(std::move(fusion), *communicator);
+  auto outputs = runtime.runWithInput(inputs);
+  testValidate(
+      runtime.completeFusion(), outputs, inputs, {x3}, __LINE__, __FILE__);
+}
+
 } // namespace nvfuser
@@ -1159,4 +1159,60 @@ TEST_F(NVFuserTest, AvoidProjectingToInputsIfRecomputeHasDropout) {
       "Shouldn't project persistent buffers to inputs!");
 }
 
+// A row of 128K floats doesn't fit in the registers and shared memory of a
+// block. EnableOption::GridPersistence splits it across a cooperative grid,
+// so the layer norm is a single kernel instead of being segmented.
+TEST_F(PersistentBufferTest, GridPersistentLayerNorm) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::GridPersistence);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  const int64_t hidden_size = 128 * 1024;
+  auto tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  auto ln_res = layer_norm(
+      tv0, {hidden_size}, nullptr, nullptr, IrBuilder::create<Val>(1e-5));
+  fusion->addOutput(ln_res.output);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({8, hidden_size}, options);
+
+  FusionExecutorCache fec(std::move(fusion));
+  auto outputs = fec.runFusionWithInputs({t0});
+  FusionKernelRuntime* runtime = fec.getMostRecentKernelRuntime();
+  ASSERT_FALSE(runtime->isSegmented());
+  const SchedulerEntry* entry = runtime->schedulers().front().get();
+  EXPECT_EQ(entry->heuristic(), ScheduleHeuristic::InnerPersistent);
+  const auto* rparams = entry->params()->as<ReductionParams>();
+  EXPECT_TRUE(rparams->cross_grid_inner_reduction);
+  EXPECT_GT(rparams->lparams.gdimy(), 1);
+  testValidate(fec.fusion(), outputs, {t0}, __LINE__, __FILE__);
+}
+
+TEST_F(PersistentBufferTest, L2AwarePersistence) {
+  const int64_t available_size = 256 * 1024;
+  const int64_t starving_size = 192 * 1024;
+  const int64_t l2_cache_size =
+      (int64_t)at::cuda::getCurrentDeviceProperties()->l2CacheSize;
+  // Number of rows whose starving buffers fill half of L2
+  const int64_t l2_rows = l2_cache_size / 2 / starving_size;
+
+  // Disabled by default
+  EXPECT_FALSE(normalization_scheduler_utils::preferL2ResidentTwoPass(
+      starving_size, available_size, 1));
+
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::L2AwarePersistence);
+  EXPECT_TRUE(normalization_scheduler_utils::preferL2ResidentTwoPass(
+      starving_size, available_size, l2_rows));
+  // Two rows fit in a block, keep the persistent kernel
+  EXPECT_FALSE(normalization_scheduler_utils::preferL2ResidentTwoPass(
+      available_size / 2, available_size, l2_rows));
+  // The second pass would miss in L2
+  EXPECT_FALSE(normalization_scheduler_utils::preferL2ResidentTwoPass(
+      starving_size, available_size, l2_rows + 1));
+}
+
 } // namespace nvfuser
@@ -8,10 +8,15 @@
 #include <gmock/gmock-matchers.h>
 #include <gtest/gtest.h>
 
+#include <executor.h>
 #include <fusion.h>
+#include <inlining.h>
 #include <ir/interface_nodes.h>
 #include <kernel_cache.h>
 #include <ops/all_ops.h>
+#include <scheduler/heuristic_plugin.h>
+#include <scheduler/multi_tensor.h>
+#include <scheduler/utils.h>
 #include <tests/cpp/utils.h>
 #include <tests/cpp/validator.h>
 
@@ -81,6 +86,93 @@ TEST_F(PointwiseTest, VectorizeStrideContiguity2D) {
   }
 }
 
+// An input without known contiguity is concretized with its runtime inner
+// stride, so every other row of a larger buffer is still vectorized
+TEST_F(PointwiseTest, VectorizeStrideContiguitySpecialization) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::ContiguitySpecialization);
+
+  auto fusion_ptr = std::make_unique<Fusion>();
+  auto fusion = fusion_ptr.get();
+  FusionGuard fg(fusion);
+
+  TensorView* tv0 = makeSymbolicTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = add(tv0, tv0);
+  fusion->addOutput(tv1);
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+  fec.profile(true);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({2048, 1024}, options);
+
+  // Every other row keeps the inner dimension contiguous
+  at::Tensor every_other_row = t0.slice(0, 0, 2048, 2);
+  auto cg_outputs = fec.runFusionWithInputs({every_other_row});
+  EXPECT_EQ(getVecSizeForPointwise(fec), (size_t)4);
+  testValidate(
+      fec.fusion(), cg_outputs, {every_other_row}, __LINE__, __FILE__);
+
+  // Every other column needs scalar loads and a different concretization
+  at::Tensor every_other_column = t0.slice(1, 0, 1024, 2);
+  cg_outputs = fec.runFusionWithInputs({every_other_column});
+  EXPECT_EQ(getVecSizeForPointwise(fec), (size_t)1);
+  testValidate(
+      fec.fusion(), cg_outputs, {every_other_column}, __LINE__, __FILE__);
+  EXPECT_EQ(fec.countConcretizationInfos(), 2);
+}
+
+// Inputs run often enough get a kernel with their extents as constants,
+// while other shapes keep using the generic kernel
+TEST_F(PointwiseTest, ShapeSpecialization) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::ShapeSpecialization, {"3"});
+
+  auto fusion_ptr = std::make_unique<Fusion>();
+  auto fusion = fusion_ptr.get();
+  FusionGuard fg(fusion);
+
+  TensorView* tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = add(tv0, IrBuilder::create<Val>(1.0));
+  fusion->addOutput(tv1);
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1000, 130}, options);
+  at::Tensor t1 = at::randn({999, 129}, options);
+
+  auto kernel_code = [&fec]() {
+    return fec.getMostRecentKernelRuntime()->executors().at(0).kernelString();
+  };
+
+  auto cg_outputs = fec.runFusionWithInputs({t0});
+  cg_outputs = fec.runFusionWithInputs({t0});
+  FusionKernelRuntime* generic_runtime = fec.getMostRecentKernelRuntime();
+  EXPECT_THAT(kernel_code(), testing::HasSubstr("logical_size"));
+
+  // The third call compiles the specialized kernel
+  cg_outputs = fec.runFusionWithInputs({t0});
+  FusionKernelRuntime* specialized_runtime = fec.getMostRecentKernelRuntime();
+  EXPECT_NE(specialized_runtime, generic_runtime);
+  EXPECT_THAT(kernel_code(), testing::Not(testing::HasSubstr("logical_size")));
+  testValidate(fec.fusion(), cg_outputs, {t0}, __LINE__, __FILE__);
+
+  cg_outputs = fec.runFusionWithInputs({t0});
+  EXPECT_EQ(fec.getMostRecentKernelRuntime(), specialized_runtime);
+
+  // Other shapes use the generic concretization
+  cg_outputs = fec.runFusionWithInputs({t1});
+  EXPECT_NE(fec.getMostRecentKernelRuntime(), specialized_runtime);
+  EXPECT_THAT(kernel_code(), testing::HasSubstr("logical_size"));
+  testValidate(fec.fusion(), cg_outputs, {t1}, __LINE__, __FILE__);
+  EXPECT_EQ(fec.countConcretizationInfos(), 2);
+}
+
 TEST_F(PointwiseTest, VectorizeStrideContiguity3D) {
   auto fusion_ptr = std::make_unique<Fusion>();
   auto fusion = fusion_ptr.get();
@@ -327,6 +419,45 @@ TEST_F(PointwiseTest, Issue1567VectorizeAllocationDomain) {
   testValidate(fusion, cg_outputs, aten_inputs, __LINE__, __FILE__);
 }
 
+// An input that is not aligned to the vectorization factor is loaded without
+// vectorization, while the other tensors keep the full factor
+TEST_F(PointwiseTest, PartialVectorizationMisalignedInput) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  auto fusion = fusion_ptr.get();
+  FusionGuard fg(fusion);
+
+  auto tv0 = makeContigTensor(2);
+  auto tv1 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  auto tv2 = add(tv0, tv1);
+  fusion->addOutput(tv2);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  // A view that starts one element after an aligned address
+  at::Tensor flat = at::randn({1024 * 128 + 1}, options);
+  at::Tensor t0 = flat.as_strided({1024, 128}, {128, 1}, /*storage_offset=*/1);
+  at::Tensor t1 = at::randn({1024, 128}, options);
+  std::vector<c10::IValue> aten_inputs = {t0, t1};
+
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::PartialVectorization);
+
+  auto params = getPointwiseHeuristics(fusion, aten_inputs);
+  auto lparams = schedulePointwise(fusion, aten_inputs);
+  FusionExecutor fe;
+  fe.compileFusion(fusion, aten_inputs, lparams);
+  auto cg_outputs = fe.runFusion(aten_inputs, lparams);
+
+  EXPECT_EQ(params->vectorize, true);
+  EXPECT_EQ(params->unroll_factor, 4);
+  EXPECT_THAT(params->unvectorized_inputs, testing::ElementsAre(0));
+  EXPECT_FALSE(hasVectorizationCache(tv0));
+  EXPECT_TRUE(hasVectorizationCache(tv1));
+
+  testValidate(fusion, cg_outputs, aten_inputs, __LINE__, __FILE__);
+}
+
 TEST_F(PointwiseTest, Issue1567VectorizationFactorAnalysisCase0) {
   auto fusion_ptr = std::make_unique<Fusion>();
   auto fusion = fusion_ptr.get();
@@ -486,4 +617,294 @@ TEST_F(PointwiseTest, VIssue1567ectorizationFactorAnalysisCase3) {
   testValidate(fusion, cg_outputs, aten_inputs, __LINE__, __FILE__);
 }
 
+TEST_F(PointwiseTest, MultiTensorOptimizerStep) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::MultiTensorScheduler);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  // Each parameter is updated independently, so without the multi-tensor
+  // scheduler the fusion would be segmented into a kernel per parameter
+  std::vector<int64_t> sizes = {1000, 3000, 70};
+  for (auto i : c10::irange(sizes.size())) {
+    (void)i; // Suppress unused variable warning
+    TensorView* param = makeContigTensor(1);
+    TensorView* grad = makeContigTensor(1);
+    fusion->addInput(param);
+    fusion->addInput(grad);
+    fusion->addOutput(sub(param, mul(grad, IrBuilder::create<Val>(0.1))));
+  }
+
+  FusionExecutorCache fec(std::move(fusion));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  std::vector<c10::IValue> inputs;
+  for (auto size : sizes) {
+    inputs.push_back(at::randn({size}, options));
+    inputs.push_back(at::randn({size}, options));
+  }
+  auto outputs = fec.runFusionWithInputs(inputs);
+
+  FusionKernelRuntime* runtime = fec.getMostRecentKernelRuntime();
+  EXPECT_FALSE(runtime->isSegmented());
+  const auto& scheduler_entry =
+      runtime->schedulerHeuristics()->heuristicsList().at(0);
+  EXPECT_EQ(scheduler_entry->heuristic(), ScheduleHeuristic::MultiTensor);
+  auto params =
+      std::dynamic_pointer_cast<MultiTensorParams>(scheduler_entry->params());
+  ASSERT_NE(params, nullptr);
+  // 70 floats can only be vectorized by 2
+  EXPECT_THAT(params->vectorization_factors, testing::ElementsAre(4, 4, 2));
+
+  testValidate(fec.fusion(), outputs, inputs, __LINE__, __FILE__);
+}
+
+namespace {
+
+// Halves the vectorization factor picked by the pointwise scheduler and
+// records the problem it was given
+class HalfVectorizationConfig : public heuristic_plugin::PointwiseConfig {
+ public:
+  void configure() override {
+    last_problem = problem;
+    if (vectorize && unroll_factor > 1) {
+      unroll_factor /= 2;
+    }
+  }
+
+  static heuristic_plugin::ProblemDescription last_problem;
+};
+
+heuristic_plugin::ProblemDescription HalfVectorizationConfig::last_problem;
+
+class InvalidVectorizationConfig : public heuristic_plugin::PointwiseConfig {
+ public:
+  void configure() override {
+    vectorize = true;
+    unroll_factor = 3;
+  }
+};
+
+} // namespace
+
+TEST_F(PointwiseTest, HeuristicPlugin) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  auto fusion = fusion_ptr.get();
+  FusionGuard fg(fusion);
+
+  TensorView* tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  fusion->addOutput(add(tv0, IrBuilder::create<Val>(1.0)));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1024, 128}, options);
+  std::vector<c10::IValue> inputs = {t0};
+
+  {
+    heuristic_plugin::ConfigFactoryGuard guard({.pointwise = []() {
+      return std::unique_ptr<heuristic_plugin::PointwiseConfig>(
+          new HalfVectorizationConfig);
+    }});
+    FusionExecutorCache fec(std::make_unique<Fusion>(*fusion));
+    auto outputs = fec.runFusionWithInputs(inputs);
+
+    const heuristic_plugin::ProblemDescription& problem =
+        HalfVectorizationConfig::last_problem;
+    EXPECT_EQ(
+        problem.kernel,
+        heuristic_plugin::ProblemDescription::Kernel::PointWise);
+    ASSERT_EQ(problem.num_dims, 2);
+    EXPECT_EQ(problem.sizes[0], 1024);
+    EXPECT_EQ(problem.sizes[1], 128);
+    EXPECT_EQ(problem.reduction_axes, 0);
+    EXPECT_EQ(problem.dtype, 'S');
+    EXPECT_EQ(problem.max_vectorization_factor, 4);
+    EXPECT_EQ(getVecSizeForPointwise(fec), 2);
+    testValidate(fec.fusion(), outputs, inputs, __LINE__, __FILE__);
+  }
+
+  {
+    heuristic_plugin::ConfigFactoryGuard guard({.pointwise = []() {
+      return std::unique_ptr<heuristic_plugin::PointwiseConfig>(
+          new InvalidVectorizationConfig);
+    }});
+    FusionExecutorCache fec(std::make_unique<Fusion>(*fusion));
+    EXPECT_THAT(
+        [&]() { fec.runFusionWithInputs(inputs); },
+        ::testing::ThrowsMessage<nvfError>(::testing::HasSubstr(
+            "does not divide the largest valid vectorization factor")));
+  }
+
+  // Without a plugin the scheduler's own heuristics are used
+  FusionExecutorCache fec(std::move(fusion_ptr));
+  auto outputs = fec.runFusionWithInputs(inputs);
+  EXPECT_EQ(getVecSizeForPointwise(fec), 4);
+  testValidate(fec.fusion(), outputs, inputs, __LINE__, __FILE__);
+}
+
+// Full and contiguous inputs are loaded with TMA, broadcast inputs and inputs
+// whose rows are not 16-byte aligned are not
+TEST_F(PointwiseTest, TmaLoad) {
+  if (cudaArchGuardShouldSkip(9, 0)) {
+    GTEST_SKIP() << "skipping tests on pre-Hopper GPUs";
+  }
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::TmaPointwise);
+
+  auto fusion_ptr = std::make_unique<Fusion>();
+  auto fusion = fusion_ptr.get();
+  FusionGuard fg(fusion);
+
+  TensorView* tv0 = makeContigTensor(3);
+  TensorView* tv1 = makeContigTensor(3, DataType::Half);
+  TensorView* tv2 = makeContigTensor(1);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  fusion->addInput(tv2);
+  auto tv3 = add(tv0, castOp(DataType::Float, tv1));
+  auto tv4 = mul(tv3, broadcast(tv2, {true, true, false}));
+  fusion->addOutput(tv4);
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  for (int64_t inner_size : {1032, 1025}) {
+    at::Tensor t0 = at::randn({3, 1000, inner_size}, options);
+    at::Tensor t1 = at::randn({3, 1000, inner_size}, options.dtype(at::kHalf));
+    at::Tensor t2 = at::randn({inner_size}, options);
+    std::vector<c10::IValue> inputs = {t0, t1, t2};
+    auto outputs = fec.runFusionWithInputs(inputs);
+
+    auto runtime = fec.getMostRecentKernelRuntime();
+    ASSERT_FALSE(runtime->isSegmented());
+    auto params = runtime->schedulers().front()->params();
+    const auto* pparams = dynamic_cast<PointwiseParams*>(params.get());
+    ASSERT_NE(pparams, nullptr);
+    EXPECT_EQ(pparams->use_tma_load, inner_size % 8 == 0);
+    testValidate(fec.fusion(), outputs, inputs, __LINE__, __FILE__);
+  }
+}
+
+// 32-byte vectorized accesses are single instructions on Blackwell and pairs
+// of 16-byte ones on older GPUs
+TEST_F(PointwiseTest, Vectorize32Bytes) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  TensorView* tv0 = makeContigTensor(1);
+  fusion.addInput(tv0);
+  TensorView* tv1 = add(tv0, IrBuilder::create<Val>(1.0));
+  fusion.addOutput(tv1);
+
+  TensorView* tv0_cache = tv0->cacheAfter();
+  tv1->cacheBefore();
+  tv1->split(0, 8);
+  tv1->split(0, 128);
+  TransformPropagatorWithCheck propagator(tv1);
+  MaxRootDomainInfoSpanningTree(tv1).traverse(&propagator);
+  tv1->axis(0)->parallelize(ParallelType::BIDx);
+  tv1->axis(1)->parallelize(ParallelType::TIDx);
+  scheduler_utils::parallelizeAllLike(tv1);
+  tv0_cache->axis(2)->parallelize(ParallelType::Vectorize);
+  tv1->axis(2)->parallelize(ParallelType::Vectorize);
+  inlineMost();
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({128 * 8 * 5}, options);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+  EXPECT_THAT(fe.kernelString(), ::testing::HasSubstr("/*vec_size=*/8"));
+  auto outputs = fe.runFusion({t0});
+
+  testValidate(&fusion, outputs, {t0}, {t0 + 1.0}, __LINE__, __FILE__);
+}
+
+// Embedding forward: whole rows of the table are gathered with vectorized
+// loads along the hidden dimension, fused with scaling and a positional add.
+TEST_F(PointwiseTest, VectorizedRowGather) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::VectorizedRowGather);
+
+  auto fusion_ptr = std::make_unique<Fusion>();
+  auto fusion = fusion_ptr.get();
+  FusionGuard fg(fusion);
+
+  const int64_t vocab = 1000, seq = 512, hidden = 768;
+  TensorView* tv0 = makeContigTensor(2);
+  TensorView* tv1 = makeContigTensor(1, DataType::Int);
+  TensorView* tv2 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  fusion->addInput(tv2);
+  auto tv3 = index_select(tv0, 0, tv1);
+  auto tv4 = mul(tv3, IrBuilder::create<Val>(2.0));
+  auto tv5 = add(tv4, tv2);
+  fusion->addOutput(tv5);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({vocab, hidden}, options);
+  at::Tensor t1 = at::randint(0, vocab, {seq}, options.dtype(at::kLong));
+  at::Tensor t2 = at::randn({seq, hidden}, options);
+  std::vector<c10::IValue> aten_inputs = {t0, t1, t2};
+
+  auto params = getPointwiseHeuristics(fusion, aten_inputs);
+  auto lparams = schedulePointwise(fusion, aten_inputs);
+  EXPECT_TRUE(params->vectorize);
+  EXPECT_TRUE(std::any_of(
+      tv3->getLeafDomain().begin(),
+      tv3->getLeafDomain().end(),
+      [](IterDomain* id) {
+        return id->getParallelType() == ParallelType::Vectorize;
+      }));
+
+  FusionExecutor fe;
+  fe.compileFusion(fusion, aten_inputs, lparams);
+  auto cg_outputs = fe.runFusion(aten_inputs, lparams);
+
+  testValidate(
+      fusion,
+      cg_outputs,
+      aten_inputs,
+      {at::index_select(t0, 0, t1) * 2.0 + t2},
+      __LINE__,
+      __FILE__);
+}
+
+// An input expanded by the framework, i.e. with a stride-0 dimension that is
+// not a broadcast in the fusion, is treated like a broadcast when picking the
+// 2D break point
+TEST_F(PointwiseTest, StrideZeroInputBreakPoint) {
+  auto fusion_ptr = std::make_unique<Fusion>();
+  auto fusion = fusion_ptr.get();
+  FusionGuard fg(fusion);
+
+  TensorView* tv0 = makeSymbolicTensor(2);
+  TensorView* tv1 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  auto tv2 = add(tv0, tv1);
+  fusion->addOutput(tv2);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1, 1024}, options).expand({1024, 1024});
+  at::Tensor t1 = at::randn({1024, 1024}, options);
+  std::vector<c10::IValue> aten_inputs = {t0, t1};
+
+  SchedulerRuntimeInfo runtime_info(fusion, aten_inputs);
+  EXPECT_THAT(
+      runtime_info.getStrideZeroInputIds(),
+      testing::UnorderedElementsAre(tv0->axis(0)));
+
+  auto params = getPointwiseHeuristics(fusion, aten_inputs);
+  EXPECT_EQ(params->break_point, 1);
+
+  auto lparams = schedulePointwise(fusion, aten_inputs);
+  FusionExecutor fe;
+  fe.compileFusion(fusion, aten_inputs, lparams);
+  auto cg_outputs = fe.runFusion(aten_inputs, lparams);
+
+  testValidate(fusion, cg_outputs, aten_inputs, __LINE__, __FILE__);
+}
+
 } // namespace nvfuser
@@ -12,8 +12,11 @@
 #include <tests/cpp/validator.h>
 
 #include <fusion.h>
+#include <inlining.h>
 #include <ir/all_nodes.h>
+#include <kernel_ir.h>
 #include <ops/all_ops.h>
+#include <options.h>
 
 namespace nvfuser {
 
@@ -483,4 +486,56 @@ TEST_F(PredicateEliminationTest, ExtentEqualToMaxParallelTypeExtent) {
   testValidate(&fusion, cg_outputs, {t0}, {t0}, __LINE__, __FILE__);
 }
 
+// The outer loop of a non-divisible split is peeled, so that only its last
+// iteration evaluates the unswitch predicate
+TEST_F(PredicateEliminationTest, LoopPeeling) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeSymbolicTensor(1);
+  fusion.addInput(tv0);
+  auto tv1 = sin(tv0);
+  auto tv2 = set(tv1);
+  fusion.addOutput(tv2);
+
+  tv2->split(0, 4);
+  tv2->split(0, 1);
+  TransformPropagatorWithCheck propagator(tv2);
+  MaxRootDomainInfoSpanningTree(tv2).traverse(&propagator);
+  tv2->axis(1)->parallelize(ParallelType::Unswitch);
+  inlineMost();
+
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::LoopPeeling);
+
+  GpuLower gpulw(&fusion);
+  gpulw.run();
+  const auto& top_level_exprs = gpulw.kernel()->topLevelExprs();
+  auto peeled_ite = std::find_if(
+      top_level_exprs.begin(), top_level_exprs.end(), [](Expr* expr) {
+        auto ite = dynamic_cast<kir::IfThenElse*>(expr);
+        return ite != nullptr && ite->thenBody().size() == 2 &&
+            ite->thenBody()[0]->isA<kir::ForLoop>() &&
+            ite->thenBody()[1]->isA<kir::ForLoop>() &&
+            ite->elseBody().size() == 1 &&
+            ite->elseBody()[0]->isA<kir::ForLoop>();
+      });
+  ASSERT_NE(peeled_ite, top_level_exprs.end());
+  // The main loop has no unswitch predicate
+  auto main_loop = (*peeled_ite)->as<kir::IfThenElse>()->thenBody()[0];
+  for (auto expr : main_loop->as<kir::ForLoop>()->body().exprs()) {
+    EXPECT_FALSE(expr->isA<kir::IfThenElse>()) << expr->toString();
+  }
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  for (auto size : {1, 3, 4, 5, 8, 1001}) {
+    auto t0 = at::randn({size}, options);
+
+    FusionExecutor fe;
+    fe.compileFusion(&fusion, {t0});
+    auto cg_outputs = fe.runFusion({t0});
+    testValidate(&fusion, cg_outputs, {t0}, __LINE__, __FILE__);
+  }
+}
+
 } // namespace nvfuser
@@ -12,8 +12,12 @@
 #include <ir/all_nodes.h>
 #include <ir/utils.h>
 #include <ops/all_ops.h>
+#include <preseg_passes/algebraic_simplification.h>
+#include <preseg_passes/common_subexpression_elimination.h>
 #include <preseg_passes/optimization_pass.h>
 #include <preseg_passes/pre_segmenter.h>
+#include <preseg_passes/propagate_layout_ops.h>
+#include <preseg_passes/reduced_precision_pointwise.h>
 #include <tests/cpp/utils.h>
 #include <tests/cpp/validator.h>
 
@@ -628,4 +632,334 @@ TEST_F(NVFuserTest, FusionRemoveEmptyMatmul_CUDA) {
   testValidate(preseg_fusion, outputs, aten_inputs, __LINE__, __FILE__);
 }
 
+// Test that the algebraic simplifications fold the whole chain into
+// mul(tv0, 0.25)
+TEST_F(NVFuserTest, FusionAlgebraicSimplification_CUDA) {
+  std::unique_ptr<Fusion> fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(fusion_ptr.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = mul(tv0, IrBuilder::create<Val>(1.0));
+  auto tv2 = neg(neg(tv1));
+  auto tv3 = div(tv2, IrBuilder::create<Val>(4.0));
+  auto tv4 = permute(permute(tv3, {1, 0}), {1, 0});
+  auto tv5 = sum(broadcast(tv4, {true, false, false}), {0});
+  fusion.addOutput(tv5);
+
+  OptimizationPass<AlgebraicSimplificationPass>::runPass(&fusion);
+
+  ASSERT_EQ(fusion.exprs().size(), 1);
+  auto bop = dynamic_cast<BinaryOp*>(fusion.outputs().at(0)->definition());
+  ASSERT_NE(bop, nullptr);
+  EXPECT_EQ(bop->getBinaryOpType(), BinaryOpType::Mul);
+  EXPECT_EQ(bop->lhs(), tv0);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor at0 = at::randn({5, 7}, options);
+  std::vector<c10::IValue> aten_inputs = {at0};
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+  auto outputs = fec.runFusionWithInputs(aten_inputs);
+
+  testValidate(
+      fec.fusion(), outputs, aten_inputs, {at0 / 4.0}, __LINE__, __FILE__);
+}
+
+// Test that rewrites that would change floating-point results are skipped:
+// 1 / 3 is inexact, and add(x, 0.0) turns -0.0 into 0.0
+TEST_F(NVFuserTest, FusionAlgebraicSimplificationInexact_CUDA) {
+  std::unique_ptr<Fusion> fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(fusion_ptr.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = div(tv0, IrBuilder::create<Val>(3.0));
+  auto tv2 = add(tv1, IrBuilder::create<Val>(0.0));
+  fusion.addOutput(tv2);
+
+  OptimizationPass<AlgebraicSimplificationPass>::runPass(&fusion);
+
+  auto add_op = dynamic_cast<BinaryOp*>(fusion.outputs().at(0)->definition());
+  ASSERT_NE(add_op, nullptr);
+  EXPECT_EQ(add_op->getBinaryOpType(), BinaryOpType::Add);
+  auto div_op = dynamic_cast<BinaryOp*>(add_op->lhs()->definition());
+  ASSERT_NE(div_op, nullptr);
+  EXPECT_EQ(div_op->getBinaryOpType(), BinaryOpType::Div);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor at0 = at::randn({5, 7}, options);
+  at0[0][0] = -0.0;
+  std::vector<c10::IValue> aten_inputs = {at0};
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+  auto outputs = fec.runFusionWithInputs(aten_inputs);
+
+  EXPECT_FALSE(outputs[0][0][0].signbit().item<bool>());
+  testValidate(
+      fec.fusion(),
+      outputs,
+      aten_inputs,
+      {at0 / 3.0 + 0.0},
+      __LINE__,
+      __FILE__);
+}
+
+// Test that a permute moved across relu cancels with the permute of the
+// input, leaving a pointwise fusion
+TEST_F(NVFuserTest, FusionPropagateLayoutOps_CUDA) {
+  std::unique_ptr<Fusion> fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(fusion_ptr.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  auto tv1 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  fusion.addInput(tv1);
+  auto tv2 = permute(tv0, {1, 0});
+  auto tv3 = relu(tv2);
+  auto tv4 = permute(tv3, {1, 0});
+  auto tv5 = add(tv4, tv1);
+  fusion.addOutput(tv5);
+
+  OptimizationPass<PropagateLayoutOpsPass>::runPass(&fusion);
+  OptimizationPass<AlgebraicSimplificationPass>::runPass(&fusion);
+
+  for (auto expr : fusion.exprs()) {
+    EXPECT_FALSE(ir_utils::getPermuteNew2Old(expr).has_value())
+        << "Unexpected permute: " << expr->toString();
+  }
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor at0 = at::randn({5, 7}, options);
+  at::Tensor at1 = at::randn({5, 7}, options);
+  std::vector<c10::IValue> aten_inputs = {at0, at1};
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+  auto outputs = fec.runFusionWithInputs(aten_inputs);
+
+  FusionKernelRuntime* runtime = fec.getMostRecentKernelRuntime();
+  ASSERT_EQ(runtime->fusionSegments()->groups().size(), 1);
+  EXPECT_EQ(
+      runtime->fusionSegments()->groups().at(0)->heuristic(),
+      ScheduleHeuristic::PointWise);
+  testValidate(
+      fec.fusion(),
+      outputs,
+      aten_inputs,
+      {at0.relu() + at1},
+      __LINE__,
+      __FILE__);
+}
+
+// Test that outputs marked unneeded are not computed and returned as
+// undefined tensors
+TEST_F(NVFuserTest, FusionUnneededOutputs_CUDA) {
+  std::unique_ptr<Fusion> fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(fusion_ptr.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = sum(tv0, {1});
+  auto tv2 = add(tv0, tv0);
+  fusion.addOutput(tv1);
+  fusion.addOutput(tv2);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor at0 = at::randn({5, 7}, options);
+  std::vector<c10::IValue> aten_inputs = {at0};
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+  fec.markOutputsUnneeded({1});
+  auto outputs = fec.runFusionWithInputs(aten_inputs);
+
+  ASSERT_EQ(outputs.size(), 2);
+  EXPECT_FALSE(outputs[1].defined());
+  EXPECT_TRUE(at::allclose(outputs[0], at0.sum({1})));
+
+  FusionKernelRuntime* runtime = fec.getMostRecentKernelRuntime();
+  EXPECT_FALSE(runtime->isSegmented());
+  EXPECT_EQ(runtime->fusionSegments()->completeFusion()->outputs().size(), 1);
+
+  // Both outputs are materialized again once the marks are cleared
+  fec.markOutputsUnneeded({});
+  outputs = fec.runFusionWithInputs(aten_inputs);
+  testValidate(
+      fec.fusion(),
+      outputs,
+      aten_inputs,
+      {at0.sum({1}), at0 + at0},
+      __LINE__,
+      __FILE__);
+}
+
+// Test that the rsqrt of a frozen variance is computed once per version
+TEST_F(NVFuserTest, FusionStaticInputs_CUDA) {
+  std::unique_ptr<Fusion> fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(fusion_ptr.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  auto tv1 = makeSymbolicTensor(1);
+  fusion.addInput(tv0);
+  fusion.addInput(tv1);
+  auto tv2 = rsqrt(add(tv1, IrBuilder::create<Val>(1e-5)));
+  auto tv3 = mul(tv0, broadcast(tv2, {true, false}));
+  fusion.addOutput(tv3);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor at0 = at::randn({5, 7}, options);
+  at::Tensor at1 = at::rand({7}, options);
+  std::vector<c10::IValue> aten_inputs = {at0, at1};
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+  fec.markInputsStatic({1});
+  auto outputs = fec.runFusionWithInputs(aten_inputs);
+  testValidate(
+      fec.fusion(),
+      outputs,
+      aten_inputs,
+      {at0 * (at1 + 1e-5).rsqrt()},
+      __LINE__,
+      __FILE__);
+
+  FusionKernelRuntime* runtime = fec.getMostRecentKernelRuntime();
+  ASSERT_TRUE(runtime->isSegmented());
+  Val* static_input = runtime->fusionSegments()->completeFusion()->inputs()[1];
+  const FusionExecutor* static_executor = nullptr;
+  for (SegmentedGroup* group : runtime->fusionSegments()->groups()) {
+    if (group->inputs() == std::vector<Val*>{static_input}) {
+      static_executor = &runtime->executors().at(group->groupId());
+    }
+  }
+  ASSERT_NE(static_executor, nullptr);
+  EXPECT_EQ(static_executor->numRuns(), 1);
+
+  // The static segment is skipped with new activations
+  aten_inputs[0] = at::randn({5, 7}, options);
+  outputs = fec.runFusionWithInputs(aten_inputs);
+  EXPECT_EQ(static_executor->numRuns(), 1);
+  testValidate(
+      fec.fusion(),
+      outputs,
+      aten_inputs,
+      {aten_inputs[0].toTensor() * (at1 + 1e-5).rsqrt()},
+      __LINE__,
+      __FILE__);
+
+  // and runs again once the static input is updated in place
+  at1.add_(1.0);
+  outputs = fec.runFusionWithInputs(aten_inputs);
+  EXPECT_EQ(static_executor->numRuns(), 2);
+  testValidate(
+      fec.fusion(),
+      outputs,
+      aten_inputs,
+      {aten_inputs[0].toTensor() * (at1 + 1e-5).rsqrt()},
+      __LINE__,
+      __FILE__);
+}
+
+// Test that duplicated rsqrt(x + eps) and broadcast are computed once
+TEST_F(NVFuserTest, FusionCommonSubexpressionElimination_CUDA) {
+  std::unique_ptr<Fusion> fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(fusion_ptr.get());
+
+  auto tv0 = makeSymbolicTensor(1);
+  auto tv1 = makeSymbolicTensor(2);
+  fusion.addInput(tv0);
+  fusion.addInput(tv1);
+  auto tv2 = rsqrt(add(tv0, IrBuilder::create<Val>(1e-5)));
+  auto tv3 = rsqrt(add(tv0, IrBuilder::create<Val>(1e-5)));
+  auto tv4 = mul(broadcast(tv2, {false, true}), tv1);
+  auto tv5 = mul(broadcast(tv3, {false, true}), tv1);
+  // A different reduction of the same input is not a duplicate
+  auto tv6 = sum(tv4, {0});
+  auto tv7 = sum(tv5, {1});
+  fusion.addOutput(tv6);
+  fusion.addOutput(tv7);
+
+  OptimizationPass<CommonSubexpressionEliminationPass>::runPass(&fusion);
+
+  // add, rsqrt, broadcast, mul and the two sums remain
+  EXPECT_EQ(fusion.exprs().size(), 6);
+  EXPECT_EQ(tv6->definition()->input(0), tv7->definition()->input(0));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor at0 = at::rand({7}, options) + 0.5;
+  at::Tensor at1 = at::randn({7, 9}, options);
+  std::vector<c10::IValue> aten_inputs = {at0, at1};
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+  auto outputs = fec.runFusionWithInputs(aten_inputs);
+
+  auto t4 = at0.add(1e-5).rsqrt().unsqueeze(-1) * at1;
+  testValidate(
+      fec.fusion(),
+      outputs,
+      aten_inputs,
+      {t4.sum({0}), t4.sum({1})},
+      __LINE__,
+      __FILE__);
+}
+
+// Test that a half chain of add and mul is computed without upcasting, while
+// the chain feeding a float output is left alone
+TEST_F(NVFuserTest, FusionReducedPrecisionPointwise_CUDA) {
+  std::unique_ptr<Fusion> fusion_ptr = std::make_unique<Fusion>();
+  Fusion& fusion = *fusion_ptr.get();
+  FusionGuard fg(fusion_ptr.get());
+
+  auto tv0 = makeSymbolicTensor(2, DataType::Half);
+  auto tv1 = makeSymbolicTensor(2, DataType::Half);
+  fusion.addInput(tv0);
+  fusion.addInput(tv1);
+  auto tv2 = mul(add(tv0, tv1), tv0);
+  auto tv3 = castOp(DataType::Half, tv2);
+  auto tv4 = sub(tv0, tv1);
+  fusion.addOutput(tv3);
+  fusion.addOutput(tv4);
+
+  OptimizationPass<ReducedPrecisionPointwisePass>::runPass(&fusion);
+  // The pass is opt-in
+  EXPECT_EQ(fusion.outputs().at(0), tv3);
+
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::ReducedPrecisionPointwise);
+  OptimizationPass<ReducedPrecisionPointwisePass>::runPass(&fusion);
+
+  auto out = fusion.outputs().at(0)->as<TensorView>();
+  EXPECT_NE(out, tv3);
+  EXPECT_EQ(out->dtype(), DataType::Half);
+  auto mul_op = dynamic_cast<BinaryOp*>(out->definition());
+  ASSERT_NE(mul_op, nullptr);
+  EXPECT_EQ(mul_op->getBinaryOpType(), BinaryOpType::Mul);
+  EXPECT_EQ(mul_op->rhs(), tv0);
+  EXPECT_EQ(mul_op->lhs()->dtype(), DataType::Half);
+  EXPECT_EQ(fusion.outputs().at(1), tv4);
+  EXPECT_EQ(tv4->dtype(), DataType::Float);
+
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+  at::Tensor at0 = at::randn({13, 17}, options);
+  at::Tensor at1 = at::randn({13, 17}, options);
+  std::vector<c10::IValue> aten_inputs = {at0, at1};
+
+  FusionExecutorCache fec(std::move(fusion_ptr));
+  auto outputs = fec.runFusionWithInputs(aten_inputs);
+
+  // Each op is rounded to half, as in the reference
+  testValidate(
+      fec.fusion(),
+      outputs,
+      aten_inputs,
+      {(at0 + at1) * at0, at0.to(at::kFloat) - at1.to(at::kFloat)},
+      __LINE__,
+      __FILE__);
+}
+
 } // namespace nvfuser::preseg_passes
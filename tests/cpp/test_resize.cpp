@@ -3377,4 +3377,51 @@ TEST_F(ResizeTest, AvoidVectorization) {
   testValidate(&fusion, outputs, inputs, __LINE__, __FILE__);
 }
 
+// Slices of fusion inputs are vectorized when their offsets are aligned
+TEST_F(ResizeTest, SliceVectorization) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::SliceVectorization);
+
+  for (const int64_t offset : {32L, 1L}) {
+    Fusion fusion;
+    FusionGuard fg(&fusion);
+
+    const std::vector<int64_t> shape({1024, 160});
+    auto tv0 = makeContigConcreteTensor(shape);
+    fusion.addInput(tv0);
+    auto tv1 = slice(
+        tv0,
+        {{fusion.zeroVal(), tv0->axis(0)->extent()},
+         {IrBuilder::create<Val>(offset),
+          IrBuilder::create<Val>(offset + 128)}});
+    auto tv2 = add(tv1, IrBuilder::create<Val>(1.0));
+    fusion.addOutput(tv2);
+
+    auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+    at::Tensor t0 = at::randn(shape, options);
+    std::vector<c10::IValue> inputs({t0});
+
+    auto params = getPointwiseHeuristics(&fusion, inputs);
+    if (offset % 4 != 0) {
+      // The sliced rows are not aligned to vectorized accesses
+      EXPECT_FALSE(params->vectorize);
+      continue;
+    }
+    ASSERT_TRUE(params->vectorize);
+    ASSERT_EQ(params->unroll_factor, 4);
+
+    schedulePointwise(&fusion, *params);
+    EXPECT_THAT(
+        tv1->getLeafDomain(),
+        Contains(
+            Property(&IterDomain::getParallelType, ParallelType::Vectorize)))
+        << "Failed to vectorize: " << tv1;
+
+    FusionExecutor fe;
+    fe.compileFusion(&fusion, inputs, params->lparams);
+    auto outputs = fe.runFusion(inputs, params->lparams);
+    testValidate(&fusion, outputs, inputs, __LINE__, __FILE__);
+  }
+}
+
 } // namespace nvfuser
@@ -129,6 +129,43 @@ TEST_F(RNGTest, ManualScheduleValidateWithCURand) {
   testValidate(fusion, {out}, {t0}, {ref}, __LINE__, __FILE__);
 }
 
+// Interleaved RNG ops keep their own philox results, so each of them only
+// calls philox once per 4 consecutive elements of a thread
+TEST_F(RNGTest, InterleavedOpsValidateWithCURand) {
+  int64_t size = 128;
+  auto dtype = at::kFloat;
+  std::unique_ptr<Fusion> fusion_ptr = std::make_unique<Fusion>();
+  auto fusion = fusion_ptr.get();
+  FusionGuard fg(fusion);
+
+  TensorView* tv0 = makeSymbolicTensor(1, aten_to_data_type(dtype));
+  fusion->addInput(tv0);
+  auto tv1 = rand_like(tv0);
+  auto tv2 = rand_like(tv0);
+  auto tv3 = add(tv1, tv2);
+  fusion->addOutput(tv3);
+
+  tv3->split(0, 8);
+  tv3->axis(0)->parallelize(ParallelType::TIDx);
+  tv1->computeAt(tv3, -1);
+  tv2->computeAt(tv3, -1);
+
+  auto options = at::TensorOptions().dtype(dtype).device(at::kCUDA, 0);
+  at::Tensor t0 = at::zeros({size}, options);
+
+  FusionExecutor fe;
+  fe.compileFusion(fusion, {t0});
+
+  at::manual_seed(0);
+  auto cg_outputs = fe.runFusion({t0});
+
+  at::manual_seed(0);
+  auto ref0 = generate_uniform(size, dtype);
+  auto ref1 = generate_uniform(size, dtype);
+
+  testValidate(fusion, cg_outputs, {t0}, {ref0 + ref1}, __LINE__, __FILE__);
+}
+
 TEST_F(RNGTest, ManualScheduleValidateWithCURand2) {
   auto dtype = at::kFloat;
   std::unique_ptr<Fusion> fusion_ptr = std::make_unique<Fusion>();
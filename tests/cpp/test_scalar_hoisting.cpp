@@ -5,12 +5,15 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 // clang-format on
+#include <gmock/gmock-matchers.h>
 #include <gtest/gtest.h>
 
 #include <executor.h>
 #include <fusion.h>
 #include <inlining.h>
 #include <ops/all_ops.h>
+#include <options.h>
+#include <scheduler/utils.h>
 #include <tests/cpp/utils.h>
 #include <tests/cpp/validator.h>
 
@@ -404,4 +407,115 @@ __global__ void CUDAGeneratedKernel(int64_t i0, int64_t i1, int64_t i2, Tensor<i
       fusion.get(), cg_outputs, {start, end, step}, __LINE__, __FILE__);
 }
 
+TEST_F(ScalarHoistTest, FastDivMod) {
+  if (isOptionDisabled(DisableOption::IndexHoist)) {
+    GTEST_SKIP() << "Index hoisting disabled";
+  }
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = transpose(tv0, 0, 1);
+  auto tv2 = sin(tv1);
+  fusion.addOutput(tv2);
+
+  tv2->merge(0);
+  tv2->split(0, 128);
+  tv2->axis(0)->parallelize(ParallelType::BIDx);
+  tv2->axis(1)->parallelize(ParallelType::TIDx);
+  TransformPropagatorWithCheck propagator(tv2);
+  MaxRootDomainInfoSpanningTree(tv2).traverse(&propagator);
+  scheduler_utils::parallelizeAllLike(tv2);
+  inlineMost();
+
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::FastDivMod);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({129, 77}, options);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0}, LaunchParams(), {DataType::Int32});
+  // The index of T0 divides the linear index by an extent of T0, whose magic
+  // numbers are computed by the host
+  EXPECT_THAT(fe.kernelString(), testing::HasSubstr("__umulhi("));
+  EXPECT_THAT(
+      fe.kernelString(),
+      testing::Not(testing::HasSubstr("fastDivMultiplier(")));
+  auto cg_outputs = fe.runFusion({t0});
+
+  testValidate(&fusion, cg_outputs, {t0}, __LINE__, __FILE__);
+}
+
+// Zero-size extents must not make the host divide by zero when computing the
+// magic numbers of their divisors
+TEST_F(ScalarHoistTest, FastDivModZeroExtent) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto divisor = IrBuilder::create<Val>(DataType::Index);
+  auto multiplier = IrBuilder::create<Val>(DataType::UInt32);
+  IrBuilder::create<UnaryOp>(
+      UnaryOpType::FastDivMultiplier, multiplier, divisor);
+  auto shift = IrBuilder::create<Val>(DataType::UInt32);
+  IrBuilder::create<UnaryOp>(UnaryOpType::FastDivShift, shift, divisor);
+
+  ExpressionEvaluator expr_eval;
+  expr_eval.bind(divisor, 0L);
+  EXPECT_EQ(expr_eval.evaluate(multiplier), 0L);
+  EXPECT_EQ(expr_eval.evaluate(shift), 0L);
+
+  ExpressionEvaluator expr_eval7;
+  expr_eval7.bind(divisor, 7L);
+  EXPECT_EQ(expr_eval7.evaluate(shift), 3L);
+  EXPECT_EQ(
+      expr_eval7.evaluate(multiplier),
+      ((int64_t)1 << 32) * (((int64_t)1 << 3) - 7) / 7 + 1);
+}
+
+TEST_F(ScalarHoistTest, HostIndexHoist) {
+  if (isOptionDisabled(DisableOption::IndexHoist)) {
+    GTEST_SKIP() << "Index hoisting disabled";
+  }
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeContigTensor(2);
+  fusion.addInput(tv0);
+  auto tv1 = sin(tv0);
+  fusion.addOutput(tv1);
+
+  tv1->merge(0);
+  tv1->split(0, 128);
+  tv1->axis(0)->parallelize(ParallelType::BIDx);
+  tv1->axis(1)->parallelize(ParallelType::TIDx);
+  TransformPropagatorWithCheck propagator(tv1);
+  MaxRootDomainInfoSpanningTree(tv1).traverse(&propagator);
+  scheduler_utils::parallelizeAllLike(tv1);
+  inlineMost();
+
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::HostIndexHoist);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({129, 77}, options);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0});
+  // The number of elements in the predicate is computed by the host
+  const std::vector<Val*>& params = fe.kernel()->parameters();
+  EXPECT_TRUE(std::any_of(params.begin(), params.end(), [](Val* param) {
+    return param->isScalar() && param->definition() != nullptr;
+  }));
+  auto cg_outputs = fe.runFusion({t0});
+
+  testValidate(&fusion, cg_outputs, {t0}, __LINE__, __FILE__);
+
+  // The parameter is recomputed for other sizes
+  auto t1 = at::randn({33, 1000}, options);
+  cg_outputs = fe.runFusion({t1});
+  testValidate(&fusion, cg_outputs, {t1}, __LINE__, __FILE__);
+}
+
 } // namespace nvfuser
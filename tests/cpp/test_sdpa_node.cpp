@@ -0,0 +1,136 @@
+// clang-format off
+/*
+ * SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+ * All rights reserved.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+// clang-format on
+#include <gtest/gtest.h>
+
+#include <executor.h>
+#include <fusion.h>
+#include <ops/all_ops.h>
+#include <tests/cpp/utils.h>
+#include <tests/cpp/validator.h>
+
+#include <cmath>
+
+namespace nvfuser {
+
+using SdpaTest = NVFuserTest;
+
+namespace {
+
+constexpr int64_t n = 2, h = 4, l = 256, s = 128, e = 64;
+
+// Attention scores that materialize [L, S], computed in float
+at::Tensor attentionProbs(at::Tensor q, at::Tensor k, bool is_causal) {
+  at::Tensor scores =
+      at::matmul(q.to(at::kFloat), k.to(at::kFloat).transpose(-2, -1)) /
+      std::sqrt((double)e);
+  if (is_causal) {
+    at::Tensor mask = at::ones({l, s}, q.options().dtype(at::kBool)).tril();
+    scores = scores.masked_fill(mask.logical_not(), -INFINITY);
+  }
+  return at::softmax(scores, -1);
+}
+
+std::vector<at::Tensor> runEvaluatedFusion(
+    Fusion* fusion,
+    const std::vector<c10::IValue>& inputs) {
+  for (Val* out : fusion->outputs()) {
+    fusion->aliasOutputToInput(
+        out, /*input=*/nullptr, AllocationType::Evaluate);
+  }
+  FusionExecutor fe;
+  fe.compileFusion(fusion, inputs);
+  auto outputs = fe.runFusion(inputs);
+  // Verify that fusion compilation was skipped.
+  EXPECT_FALSE(fe.hasCompiledKernel());
+  return outputs;
+}
+
+} // namespace
+
+TEST_F(SdpaTest, CausalForward) {
+  NVFUSER_TEST_CUDA_ARCH_GUARD(8, 0);
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(4, DataType::Half);
+  auto tv1 = makeContigTensor(4, DataType::Half);
+  auto tv2 = makeContigTensor(4, DataType::Half);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  fusion->addInput(tv2);
+  auto fwd = sdpfa_fwd(
+      tv0,
+      tv1,
+      tv2,
+      /*dropout_p=*/nullptr,
+      /*is_causal=*/IrBuilder::create<Val>(true));
+  fusion->addOutput(fwd.output);
+  fusion->addOutput(fwd.log_sumexp);
+
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+  at::Tensor q = at::randn({n, h, l, e}, options);
+  at::Tensor k = at::randn({n, h, s, e}, options);
+  at::Tensor v = at::randn({n, h, s, e}, options);
+  auto outputs = runEvaluatedFusion(fusion.get(), {q, k, v});
+
+  at::Tensor probs = attentionProbs(q, k, /*is_causal=*/true);
+  at::Tensor out_ref = at::matmul(probs, v.to(at::kFloat));
+  EXPECT_TRUE(at::allclose(outputs[0].to(at::kFloat), out_ref, 1e-2, 1e-2));
+  EXPECT_EQ(outputs[1].sizes(), at::IntArrayRef({n, h, l}));
+}
+
+TEST_F(SdpaTest, Backward) {
+  NVFUSER_TEST_CUDA_ARCH_GUARD(8, 0);
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(4, DataType::Half);
+  auto tv1 = makeContigTensor(4, DataType::Half);
+  auto tv2 = makeContigTensor(4, DataType::Half);
+  auto tv3 = makeContigTensor(4, DataType::Half);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  fusion->addInput(tv2);
+  fusion->addInput(tv3);
+  auto fwd = sdpfa_fwd(tv0, tv1, tv2);
+  auto bwd = sdpfa_bwd(tv3, tv0, tv1, tv2, fwd);
+  fusion->addOutput(bwd.grad_query);
+  fusion->addOutput(bwd.grad_key);
+  fusion->addOutput(bwd.grad_value);
+
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+  at::Tensor q = at::randn({n, h, l, e}, options);
+  at::Tensor k = at::randn({n, h, s, e}, options);
+  at::Tensor v = at::randn({n, h, s, e}, options);
+  at::Tensor grad_out = at::randn({n, h, l, e}, options);
+  auto outputs = runEvaluatedFusion(fusion.get(), {q, k, v, grad_out});
+
+  // dV = P^T dO, dS = P * (dO V^T - rowsum(dO * O)), dQ = dS K * scale and
+  // dK = dS^T Q * scale
+  const double scale = 1.0 / std::sqrt((double)e);
+  at::Tensor probs = attentionProbs(q, k, /*is_causal=*/false);
+  at::Tensor grad_out_f = grad_out.to(at::kFloat);
+  at::Tensor out = at::matmul(probs, v.to(at::kFloat));
+  at::Tensor grad_v_ref = at::matmul(probs.transpose(-2, -1), grad_out_f);
+  at::Tensor grad_probs =
+      at::matmul(grad_out_f, v.to(at::kFloat).transpose(-2, -1));
+  at::Tensor grad_scores = probs *
+      (grad_probs - (grad_out_f * out).sum(-1, /*keepdim=*/true));
+  at::Tensor grad_q_ref = at::matmul(grad_scores, k.to(at::kFloat)) * scale;
+  at::Tensor grad_k_ref =
+      at::matmul(grad_scores.transpose(-2, -1), q.to(at::kFloat)) * scale;
+
+  EXPECT_TRUE(at::allclose(
+      outputs[0].to(at::kFloat), grad_q_ref, 2e-2, 2e-2));
+  EXPECT_TRUE(at::allclose(
+      outputs[1].to(at::kFloat), grad_k_ref, 2e-2, 2e-2));
+  EXPECT_TRUE(at::allclose(
+      outputs[2].to(at::kFloat), grad_v_ref, 2e-2, 2e-2));
+}
+
+} // namespace nvfuser
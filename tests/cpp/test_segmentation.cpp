@@ -9,6 +9,8 @@
 #include <gtest/gtest.h>
 
 #include <fusion.h>
+#include <fusion_segmenter.h>
+#include <ir/utils.h>
 #include <ops/all_ops.h>
 #include <tests/cpp/utils.h>
 #include <tests/cpp/validator.h>
@@ -420,6 +422,98 @@ TEST_F(SegmentationTest, ForceBf16Simple) {
   }
 }
 
+TEST_F(SegmentationTest, ForceFp8Scaled) {
+  // Float8 types require Hopper
+  if (!deviceMajorMinorCheck(9)) {
+    GTEST_SKIP() << "skipping tests on pre-Hopper GPUs";
+  }
+
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::IoToLowerPrecision, {"fp8_e4m3", "scale=16"});
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  auto tv1 = makeSymbolicTensor(2);
+
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+
+  // Group 1
+  auto tv2 = sum(tv0, {1});
+  auto tv3 = broadcast(tv2, {false, true});
+
+  // Group 2
+  auto tv4 = add(tv3, tv1); // Edge: tv3: expect scaled cast to fp8
+  auto tv5 = castOp(DataType::Half, tv4);
+
+  fusion->addOutput(tv5);
+
+  FusionExecutorCache fec(std::move(fusion));
+
+  std::vector<int64_t> shape{15, 16};
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto in0 = at::randn(shape, options);
+  auto in1 = at::randn(shape, options);
+  auto outputs = fec.runFusionWithInputs({in0, in1});
+
+  SegmentedFusion* segmented_fusion =
+      fec.getMostRecentKernelRuntime()->fusionSegments();
+  for (SegmentedEdge* edge : segmented_fusion->edges()) {
+    auto* edge_tv = edge->val->as<TensorView>();
+    EXPECT_EQ(edge_tv->getDataType(), DataType::Float8_e4m3fn);
+  }
+
+  // e4m3 keeps 3 mantissa bits, so only check the result loosely
+  auto ref = (in0.sum({1}).unsqueeze(-1) + in1).to(at::kHalf);
+  EXPECT_TRUE(at::allclose(outputs[0], ref, 0.1, 0.1));
+}
+
+TEST_F(SegmentationTest, LowerPrecisionTolerance) {
+  EnableOptionsGuard opt_guard;
+  // e4m3 rounds to 2^-4, which exceeds the tolerance, so fp16 is used
+  EnableOptionsGuard::getCurOptions().set(
+      EnableOption::IoToLowerPrecision, {"fp8_e4m3", "tolerance=0.01"});
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeSymbolicTensor(2);
+  auto tv1 = makeSymbolicTensor(2);
+
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+
+  // Group 1
+  auto tv2 = sum(tv0, {1});
+  auto tv3 = broadcast(tv2, {false, true});
+
+  // Group 2
+  auto tv4 = add(tv3, tv1); // Edge: tv3: expect cast to fp16
+  auto tv5 = castOp(DataType::Half, tv4);
+
+  fusion->addOutput(tv5);
+
+  FusionExecutorCache fec(std::move(fusion));
+
+  std::vector<int64_t> shape{15, 16};
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto in0 = at::randn(shape, options);
+  auto in1 = at::randn(shape, options);
+  fec.runFusionWithInputs({in0, in1});
+
+  SegmentedFusion* segmented_fusion =
+      fec.getMostRecentKernelRuntime()->fusionSegments();
+  for (SegmentedEdge* edge : segmented_fusion->edges()) {
+    auto* edge_tv = edge->val->as<TensorView>();
+    EXPECT_EQ(edge_tv->getDataType(), DataType::Half);
+  }
+}
+
 TEST_F(SegmentationTest, ForceFp16NotAllCast) {
   EnableOptionsGuard opt_guard;
   EnableOptionsGuard::getCurOptions().set(EnableOption::IoToLowerPrecision);
@@ -601,4 +695,170 @@ TEST_F(SegmentationTest, codeGenSupportedMergeIssue1970) {
   testValidate(fec.fusion(), outputs, {in0}, __LINE__, __FILE__);
 }
 
+TEST_F(SegmentationTest, SegmentCostModelEstimate) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2);
+  auto tv1 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  auto tv2 = add(tv0, tv1);
+  auto tv3 = sum(tv2, {1});
+  fusion->addOutput(tv2);
+  fusion->addOutput(tv3);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({1024, 256}, options);
+  auto t1 = at::randn({1024, 256}, options);
+  SchedulerRuntimeInfo runtime_info(fusion.get(), {t0, t1});
+
+  // 1 MB/us, i.e., 1 TB/s
+  SegmentCostModel cost_model(/*launch_overhead_us=*/4.0, 1.0e6);
+  auto cost = cost_model.estimate(
+      fusion.get(), ScheduleHeuristic::PointWise, runtime_info);
+  EXPECT_EQ(cost.bytes, (3 * 1024 * 256 + 1024) * 4);
+  EXPECT_EQ(
+      cost.efficiency,
+      SegmentCostModel::efficiency(ScheduleHeuristic::PointWise));
+  EXPECT_DOUBLE_EQ(
+      cost.time_us, 4.0 + (double)cost.bytes / (1.0e6 * cost.efficiency));
+
+  // Persistent kernels get less efficient as their buffers grow
+  EXPECT_GT(
+      SegmentCostModel::efficiency(ScheduleHeuristic::InnerPersistent, 1024),
+      SegmentCostModel::efficiency(
+          ScheduleHeuristic::InnerPersistent, 64 * 1024));
+}
+
+TEST_F(SegmentationTest, SegmentCostModelKeepsCheapMerges) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::SegmentCostModel);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  auto tv1 = sin(tv0);
+  auto tv2 = cos(tv1);
+  auto tv3 = add(tv1, tv2);
+  fusion->addOutput(tv3);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({1024, 1024}, options);
+
+  FusionExecutorCache fec(std::move(fusion));
+  auto outputs = fec.runFusionWithInputs({t0});
+
+  // Merging pointwise ops saves both a launch and the intermediate traffic
+  EXPECT_FALSE(fec.getMostRecentKernelRuntime()->isSegmented());
+  testValidate(fec.fusion(), outputs, {t0}, __LINE__, __FILE__);
+}
+
+TEST_F(SegmentationTest, RecomputeCheapProducer) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::SegmentRecomputation);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2, DataType::Half);
+  fusion->addInput(tv0);
+  auto tv1 = castOp(DataType::Float, tv0);
+  auto tv2 = mul(tv1, IrBuilder::create<Val>(2.0));
+  // The reductions can't be scheduled together, so tv2 would be passed
+  // between them. Recomputing it from the half input moves fewer bytes.
+  auto tv3 = sum(tv2, {0});
+  auto tv4 = sum(tv2, {1});
+  fusion->addOutput(tv3);
+  fusion->addOutput(tv4);
+
+  auto options = at::TensorOptions().dtype(at::kHalf).device(at::kCUDA, 0);
+  auto t0 = at::randn({1024, 512}, options);
+
+  FusionExecutorCache fec(std::move(fusion));
+  auto outputs = fec.runFusionWithInputs({t0});
+
+  FusionKernelRuntime* runtime = fec.getMostRecentKernelRuntime();
+  EXPECT_EQ(runtime->fusionSegments()->groups().size(), 2);
+  for (SegmentedGroup* group : runtime->fusionSegments()->groups()) {
+    EXPECT_TRUE(group->producer_edges.empty())
+        << "Expected each segment to recompute tv2";
+  }
+  testValidate(fec.fusion(), outputs, {t0}, __LINE__, __FILE__);
+}
+
+// Exercises the dependency analysis and the merge cache of the segmenter on
+// a graph with many groups that can't all be merged
+TEST_F(SegmentationTest, ManyAlternatingReductions) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  TensorView* tv = tv0;
+  for (int i = 0; i < 8; ++i) {
+    // Alternating the reduction axis prevents fusing consecutive reductions
+    auto red = sum(tv, {i % 2});
+    tv = add(tv, broadcast(red, {i % 2 == 0, i % 2 == 1}));
+    fusion->addOutput(red);
+  }
+  fusion->addOutput(tv);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({128, 96}, options);
+
+  FusionExecutorCache fec(std::move(fusion));
+  auto outputs = fec.runFusionWithInputs({t0});
+
+  EXPECT_TRUE(fec.getMostRecentKernelRuntime()->isSegmented());
+  testValidate(fec.fusion(), outputs, {t0}, __LINE__, __FILE__);
+}
+
+// Each segment fusion should only contain the tensors of its own segment and
+// still produce the right result
+TEST_F(SegmentationTest, SegmentFusionOnlyCopiesItsSegment) {
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+
+  auto tv0 = makeContigTensor(2);
+  auto tv1 = makeContigTensor(1);
+  fusion->addInput(tv0);
+  fusion->addInput(tv1);
+  auto tv2 = sum(sin(tv0), {0});
+  auto tv3 = mul(sum(cos(tv0), {1}), tv1);
+  fusion->addOutput(tv2);
+  fusion->addOutput(tv3);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({128, 96}, options);
+  auto t1 = at::randn({128}, options);
+
+  FusionExecutorCache fec(std::move(fusion));
+  auto outputs = fec.runFusionWithInputs({t0, t1});
+
+  FusionKernelRuntime* runtime = fec.getMostRecentKernelRuntime();
+  EXPECT_TRUE(runtime->isSegmented());
+  SegmentedFusion* segmented_fusion = runtime->fusionSegments();
+  for (SegmentedGroup* group : segmented_fusion->groups()) {
+    std::unordered_set<StmtNameType> group_tv_names;
+    for (Expr* expr : group->exprs()) {
+      for (auto tv : ir_utils::filterByType<TensorView>(expr->inputs())) {
+        group_tv_names.insert(tv->name());
+      }
+      for (auto tv : ir_utils::filterByType<TensorView>(expr->outputs())) {
+        group_tv_names.insert(tv->name());
+      }
+    }
+    auto segment_fusion = segmented_fusion->makeFusion(group).second;
+    for (auto tv : ir_utils::filterByType<TensorView>(segment_fusion->vals())) {
+      EXPECT_EQ(group_tv_names.count(tv->name()), 1)
+          << tv->toString() << " is not in the segment";
+    }
+  }
+
+  testValidate(fec.fusion(), outputs, {t0, t1}, __LINE__, __FILE__);
+}
+
 } // namespace nvfuser
@@ -9,6 +9,7 @@
 #include <gmock/gmock-matchers.h>
 #include <gtest/gtest.h>
 
+#include <global_allocator.h>
 #include <grouped_reduction.h>
 #include <inlining.h>
 #include <ir/utils.h>
@@ -24,6 +25,7 @@
 
 #include <ATen/cuda/CUDAContext.h>
 #include <ATen/cuda/Exceptions.h>
+#include <c10/cuda/CUDAGuard.h>
 #include <c10/cuda/CUDAStream.h>
 
 #include <algorithm>
@@ -142,4 +144,80 @@ TEST_F(SerialGridReductionTest, Scheduling) {
   }
 }
 
+// The reduction scheduler combines the blocks of an outer grid reduction one
+// after another in the output, so the result doesn't depend on the order in
+// which the blocks finish
+TEST_F(SerialGridReductionTest, ReductionScheduler) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::SerialGridReduction);
+
+  auto fusion = std::make_unique<Fusion>();
+  FusionGuard fg(fusion.get());
+  auto tv0 = makeContigTensor(2);
+  fusion->addInput(tv0);
+  fusion->addOutput(sum(tv0, {0}));
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({1 << 20, 64}, options);
+  std::vector<c10::IValue> inputs({t0});
+  FusionExecutorCache executor_cache(std::move(fusion));
+
+  auto cg_outputs = executor_cache.runFusionWithInputs(inputs);
+  testValidate(executor_cache.fusion(), cg_outputs, inputs, __LINE__, __FILE__);
+
+  auto runtime = executor_cache.getMostRecentKernelRuntime();
+  ASSERT_FALSE(runtime->isSegmented());
+  auto rparams = runtime->schedulerHeuristics()
+                     ->heuristicsList()
+                     .at(0)
+                     ->params()
+                     ->as<ReductionParams>();
+  if (!rparams->serial_grid_reduction) {
+    GTEST_SKIP() << "Not reduced across the grid on this device";
+  }
+  EXPECT_THAT(
+      runtime->executors().front().kernelString(),
+      testing::HasSubstr("serialReductionStepInPlace"));
+
+  // Bitwise identical results across runs
+  for (auto i : c10::irange(3)) {
+    (void)i;
+    auto outputs = executor_cache.runFusionWithInputs(inputs);
+    EXPECT_TRUE(outputs.at(0).equal(cg_outputs.at(0)));
+  }
+}
+
+// Zeroed memory is handed out per stream, so kernels on different streams
+// never share semaphores while kernels on the same stream reuse them
+TEST_F(SerialGridReductionTest, ZeroedMemoryPerStream) {
+  const c10::Device device(c10::DeviceType::CUDA, 0);
+  c10::cuda::CUDAStream stream0 = c10::cuda::getStreamFromPool(false, 0);
+  c10::cuda::CUDAStream stream1 = c10::cuda::getStreamFromPool(false, 0);
+  ASSERT_NE(stream0, stream1);
+
+  releaseZeroedMemory();
+  at::Tensor semaphores0, semaphores1;
+  {
+    c10::cuda::CUDAStreamGuard sg(stream0);
+    semaphores0 = contigZeroedTensor({64}, at::kInt, device);
+  }
+  {
+    c10::cuda::CUDAStreamGuard sg(stream1);
+    semaphores1 = contigZeroedTensor({64}, at::kInt, device);
+  }
+  EXPECT_NE(semaphores0.data_ptr(), semaphores1.data_ptr());
+  EXPECT_EQ(semaphores0.count_nonzero().item<int64_t>(), 0);
+  EXPECT_EQ(semaphores1.count_nonzero().item<int64_t>(), 0);
+  EXPECT_GE(zeroedMemoryHighWaterMark(device), 64 * 4);
+
+  // After a release, the next launch on the same stream gets the same memory
+  releaseZeroedMemory();
+  {
+    c10::cuda::CUDAStreamGuard sg(stream0);
+    at::Tensor reused = contigZeroedTensor({64}, at::kInt, device);
+    EXPECT_EQ(reused.data_ptr(), semaphores0.data_ptr());
+  }
+  releaseZeroedMemory();
+}
+
 } // namespace nvfuser
@@ -39,6 +39,17 @@ TEST_F(ShardingTest, IsSharded) {
   EXPECT_ANY_THROW(isSharded(c));
 }
 
+TEST_F(ShardingTest, MeshOrderedByNode) {
+  // Two nodes of 4 devices, with the mesh alternating between them
+  DeviceMesh mesh({0, 4, 1, 5, 6, 2});
+  EXPECT_EQ(
+      mesh.orderedByNode(4), std::vector<DeviceIdxType>({0, 1, 2, 4, 5, 6}));
+  EXPECT_EQ(mesh.orderedByNode(1), mesh.vector());
+  EXPECT_EQ(
+      DeviceMesh({5, 0, 4}).orderedByNode(4),
+      std::vector<DeviceIdxType>({5, 4, 0}));
+}
+
 TEST_F(ShardingTest, PropagateSharding) {
   Fusion fusion;
   FusionGuard fg(&fusion);
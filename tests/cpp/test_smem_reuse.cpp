@@ -16,6 +16,7 @@
 #include <ir/utils.h>
 #include <kernel_cache.h>
 #include <ops/all_ops.h>
+#include <options.h>
 #include <scheduler/utils.h>
 #include <tests/cpp/utils.h>
 #include <tests/cpp/validator.h>
@@ -688,4 +689,69 @@ TEST_F(SmemReuseTest, ExpandInterferes) {
   testExpand(false);
 }
 
+// Same cases as SimpleCase and NeedsReorderedPush, with the allocations
+// packed instead of stacked
+TEST_F(SmemReuseTest, Packing) {
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::SmemPacking);
+
+  auto getSmemUsage = [](Fusion* fusion) {
+    GpuLower gpulw(fusion);
+    ExpressionEvaluator ee;
+    int64_t smem_usage = 0;
+    for (auto alloc : gpulw.run()->summary().dynamic_smem_allocations) {
+      EXPECT_NE(alloc->address(), nullptr);
+      EXPECT_TRUE(alloc->address()->isConstInt());
+      auto addr = ee.evaluate(alloc->address()).as<int64_t>();
+      EXPECT_EQ(addr % 16, 0);
+      auto size = ee.evaluate(alloc->size()).as<int64_t>() *
+          dataTypeSize(alloc->buffer()->dtype());
+      smem_usage = std::max(smem_usage, addr + size);
+    }
+    return smem_usage;
+  };
+
+  {
+    auto fusion = std::make_unique<Fusion>();
+    FusionGuard fg(fusion.get());
+    int64_t H = 5, W = 6;
+    auto tv0 =
+        full({IrBuilder::create<Val>(H)}, fusion->oneVal(), DataType::Float);
+    auto tv1 = set(tv0);
+    tv1->setMemoryType(MemoryType::Shared);
+    auto tv2 = set(tv1);
+    fusion->addOutput(tv2);
+    auto tv3 = sum(tv2, {0});
+    fusion->addOutput(tv3);
+    auto tv4 =
+        full({IrBuilder::create<Val>(W)}, fusion->oneVal(), DataType::Float);
+    auto tv5 = mul(tv3, tv4);
+    tv5->setMemoryType(MemoryType::Shared);
+    auto tv6 = set(tv5);
+    fusion->addOutput(tv6);
+
+    // Without a sync, the allocations are placed next to each other
+    EXPECT_EQ(getSmemUsage(fusion.get()), alignInt(W * 4) + H * 4);
+
+    tv3->axis(0)->parallelize(ParallelType::TIDx);
+    EXPECT_EQ(getSmemUsage(fusion.get()), W * 4);
+  }
+
+  {
+    auto fusion = std::make_unique<Fusion>();
+    FusionGuard fg(fusion.get());
+    int64_t H = 5;
+    auto [tv0, tv3] = needsReorderedPushDefinition(H);
+    tv3->axis(0)->parallelize(ParallelType::TIDx);
+    // B is placed first as the largest allocation, and A and C share the
+    // memory above it
+    EXPECT_EQ(getSmemUsage(fusion.get()), alignInt((H + 1) * 4) + (H + 1) * 4);
+
+    FusionExecutor fe;
+    fe.compileFusion(fusion.get());
+    auto cg_outputs = fe.runFusion({});
+    testValidate(fusion.get(), cg_outputs, {}, __LINE__, __FILE__);
+  }
+}
+
 } // namespace nvfuser
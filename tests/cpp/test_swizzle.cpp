@@ -8,8 +8,10 @@
 #include <csrc/exceptions.h>
 #include <gtest/gtest.h>
 
+#include <device_lower/analysis/bank_conflict.h>
 #include <kernel_cache.h>
 #include <ops/all_ops.h>
+#include <options.h>
 #include <swizzle.h>
 #include <tests/cpp/utils.h>
 #include <tests/cpp/validator.h>
@@ -471,6 +473,45 @@ TEST_F(SwizzleTest, TransposeBankConflictSwizzle2) {
   ASSERT_EQ(bank_conflict_info.at(tv1).first, std::vector<int64_t>{16});
 }
 
+TEST_F(SwizzleTest, TransposeBankConflictAutoSwizzle) {
+  // The lowering should pick a swizzle removing the 32-way bank confliction
+  // of a 32x32 non-vectorized transpose by itself.
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  auto tv0 = makeConcreteTensor({32, 32});
+  fusion.addInput(tv0);
+  auto tv1 = set(tv0);
+  auto tv2 = transpose(tv1, 0, 1);
+  auto tv3 = set(tv2);
+  fusion.addOutput(tv3);
+
+  tv1->setMemoryType(MemoryType::Shared);
+  tv1->axis(0)->parallelize(ParallelType::TIDy);
+  tv1->axis(1)->parallelize(ParallelType::TIDx);
+  tv2->axis(0)->parallelize(ParallelType::TIDy);
+  tv2->axis(1)->parallelize(ParallelType::TIDx);
+  tv3->axis(0)->parallelize(ParallelType::TIDy);
+  tv3->axis(1)->parallelize(ParallelType::TIDx);
+
+  ASSERT_EQ(fusion.bankConflictInfo().at(tv1).first, std::vector<int64_t>{32});
+
+  EnableOptionsGuard opt_guard;
+  EnableOptionsGuard::getCurOptions().set(EnableOption::BankConflictSwizzle);
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion);
+  EXPECT_TRUE(getBankConflictInfo(fe.kernel()).empty());
+  // Only the kernel is swizzled
+  EXPECT_FALSE(tv1->hasSwizzleOp());
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  auto t0 = at::randn({32, 32}, options);
+  auto cg_outputs = fe.runFusion({t0});
+
+  testValidate(&fusion, cg_outputs, {t0}, __LINE__, __FILE__);
+}
+
 TEST_F(SwizzleTest, DataSwizzleGlobal) {
   // Data swizzle is ignored in global indexing, so we should just throw an
   // error if someone wants to do so.
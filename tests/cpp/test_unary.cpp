@@ -5,10 +5,12 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 // clang-format on
+#include <gmock/gmock-matchers.h>
 #include <gtest/gtest.h>
 
 #include <limits>
 
+#include <executor.h>
 #include <fusion.h>
 #include <kernel_cache.h>
 #include <ops/arith.h>
@@ -66,6 +68,42 @@ TEST_P(UnaryTest, Neg) {
       fec.fusion(), out_tensors, {in_tensor}, {-in_tensor}, __LINE__, __FILE__);
 }
 
+// Test that approximate ops of Float use the fast intrinsics, while those of
+// Double still use the precise functions
+TEST_F(NVFuserTest, ApproximateUnaryOps) {
+  Fusion fusion;
+  FusionGuard fg(&fusion);
+
+  TensorView* tv0 = makeContigTensor(1);
+  TensorView* tv1 = makeContigTensor(1, DataType::Double);
+  fusion.addInput(tv0);
+  fusion.addInput(tv1);
+  TensorView* tv2 = mul(tv0, approx_tanh(tv0));
+  TensorView* tv3 = add(approx_exp(tv0), approx_rsqrt(approx_exp(tv0)));
+  TensorView* tv4 = approx_exp(tv1);
+  fusion.addOutput(tv2);
+  fusion.addOutput(tv3);
+  fusion.addOutput(tv4);
+
+  auto options = at::TensorOptions().dtype(at::kFloat).device(at::kCUDA, 0);
+  at::Tensor t0 = at::randn({1000}, options);
+  at::Tensor t1 = at::randn({1000}, options.dtype(at::kDouble));
+
+  FusionExecutor fe;
+  fe.compileFusion(&fusion, {t0, t1});
+  EXPECT_THAT(fe.kernelString(), ::testing::HasSubstr("tanh_approx("));
+  EXPECT_THAT(fe.kernelString(), ::testing::HasSubstr("__expf("));
+  EXPECT_THAT(fe.kernelString(), ::testing::HasSubstr("rsqrt_approx("));
+  EXPECT_THAT(fe.kernelString(), ::testing::HasSubstr(" exp("));
+  auto outputs = fe.runFusion({t0, t1});
+
+  // The approximations are only accurate to about 2^-11
+  EXPECT_TRUE(at::allclose(outputs[0], t0 * t0.tanh(), 1e-3, 1e-3));
+  EXPECT_TRUE(
+      at::allclose(outputs[1], t0.exp() + t0.exp().rsqrt(), 1e-3, 1e-3));
+  EXPECT_TRUE(at::allclose(outputs[2], t1.exp()));
+}
+
 namespace {
 
 std::string sanitizeTestName(std::string&& name) {
@@ -11,6 +11,7 @@ import random
 import re
 from typing import List, Callable
 import tempfile
+import threading
 import unittest
 import os
 
@@ -3828,6 +3829,171 @@ class TestNvFuserFrontend(TestCase):
         # Fails because vectorization 4 is set but only 1 supported
         nvf_out, _ = self.exec_nvfuser(fusion_func, inputs)
 
+    def test_execute_with_out(self):
+        inputs = [
+            torch.randn(4, 8, device="cuda"),
+            torch.randn(4, 8, device="cuda"),
+        ]
+
+        with FusionDefinition() as fd:
+            t0 = fd.from_pytorch(inputs[0])
+            t1 = fd.from_pytorch(inputs[1])
+            t2 = fd.ops.add(t0, t1)
+            t3 = fd.ops.sum(t2, [1])
+            fd.add_output(t2)
+            fd.add_output(t3)
+
+        out = [torch.empty(4, 8, device="cuda"), None]
+        nvf_out = fd.execute(inputs, out=out)
+        self.assertEqual(nvf_out[0].data_ptr(), out[0].data_ptr())
+        self.assertEqual(out[0], inputs[0] + inputs[1])
+        self.assertEqual(nvf_out[1], (inputs[0] + inputs[1]).sum(1))
+
+    def test_fusion_handle(self):
+        inputs = [
+            torch.randn(4, 8, device="cuda"),
+            torch.randn(4, 8, device="cuda"),
+        ]
+
+        with FusionDefinition() as fd:
+            t0 = fd.from_pytorch(inputs[0])
+            t1 = fd.from_pytorch(inputs[1])
+            t2 = fd.ops.mul(t0, t1)
+            fd.add_output(t2)
+
+        handle = fd.handle()
+        self.assertEqual(handle.id(), fd.id())
+        for _ in range(3):
+            nvf_out = handle(inputs)
+            self.assertEqual(nvf_out[0], inputs[0] * inputs[1])
+
+        out = [torch.empty(4, 8, device="cuda")]
+        nvf_out = handle(inputs, out=out)
+        self.assertEqual(nvf_out[0].data_ptr(), out[0].data_ptr())
+        self.assertEqual(out[0], inputs[0] * inputs[1])
+
+    def test_concurrent_execute(self):
+        inputs = [torch.randn(16, 32, device="cuda")]
+
+        def define(op):
+            with FusionDefinition() as fd:
+                t0 = fd.from_pytorch(inputs[0])
+                fd.add_output(op(fd, t0))
+            return fd
+
+        fds = [
+            define(lambda fd, t: fd.ops.sum(t, [1])),
+            define(lambda fd, t: fd.ops.exp(t)),
+        ]
+        expected = [inputs[0].sum(1), inputs[0].exp()]
+
+        errors = []
+
+        def run(fd, ref):
+            try:
+                for _ in range(10):
+                    nvf_out = fd.execute(inputs)
+                    torch.testing.assert_close(nvf_out[0], ref)
+            except Exception as err:
+                errors.append(err)
+
+        threads = [
+            threading.Thread(target=run, args=(fds[i % 2], expected[i % 2]))
+            for i in range(4)
+        ]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+        self.assertEqual(errors, [])
+
+    def test_execute_async(self):
+        inputs = [
+            torch.randn(4, 8, device="cuda"),
+            torch.randn(4, 8, device="cuda"),
+        ]
+
+        with FusionDefinition() as fd:
+            t0 = fd.from_pytorch(inputs[0])
+            t1 = fd.from_pytorch(inputs[1])
+            t2 = fd.ops.add(t0, t1)
+            t3 = fd.ops.sum(t2, [1])
+            fd.add_output(t3)
+
+        stream = torch.cuda.Stream()
+        # The inputs are used on another stream
+        stream.wait_stream(torch.cuda.current_stream())
+        for _ in range(2):
+            future = fd.execute_async(inputs, stream=stream)
+            future.wait_on(torch.cuda.current_stream())
+            nvf_out = future.result()
+            self.assertTrue(future.done())
+            self.assertEqual(nvf_out[0], (inputs[0] + inputs[1]).sum(1))
+
+    def test_dlpack_inputs_and_outputs(self):
+        # Stands for an array of another framework, e.g. a CuPy array
+        class Buffer:
+            def __init__(self, tensor):
+                self.tensor = tensor
+
+            def __dlpack__(self, stream=None):
+                return self.tensor.__dlpack__(stream=stream)
+
+            def __dlpack_device__(self):
+                return self.tensor.__dlpack_device__()
+
+        inputs = [
+            torch.randn(4, 8, device="cuda"),
+            torch.randn(4, 8, device="cuda").t(),
+        ]
+
+        with FusionDefinition() as fd:
+            t0 = fd.from_pytorch(inputs[0])
+            t1 = fd.from_pytorch(inputs[1])
+            t2 = fd.ops.mul(t0, fd.ops.permute(t1, [1, 0]))
+            fd.add_output(t2)
+
+        out = torch.empty(4, 8, device="cuda")
+        nvf_out = fd.execute(
+            [Buffer(t) for t in inputs], out=[Buffer(out)], as_dlpack=True
+        )
+        eager_out = inputs[0] * inputs[1].t()
+        self.assertEqual(out, eager_out)
+        # The capsule aliases the preallocated output
+        nvf_out = torch.utils.dlpack.from_dlpack(nvf_out[0])
+        self.assertEqual(nvf_out.data_ptr(), out.data_ptr())
+
+    def test_profile(self):
+        inputs = [
+            torch.randn(4, 8, device="cuda"),
+        ]
+
+        with FusionDefinition() as fd:
+            t0 = fd.from_pytorch(inputs[0])
+            t1 = fd.ops.sum(t0, [1])
+            t2 = fd.ops.exp(t0)
+            fd.add_output(t1)
+            fd.add_output(t2)
+
+        with self.assertRaisesRegex(RuntimeError, "No profile is available"):
+            fd.profile()
+
+        nvf_out = fd.execute(inputs, profile=True)
+        self.assertEqual(nvf_out[0], inputs[0].sum(1))
+        prof = fd.profile()
+        self.assertEqual(len(prof.kernel_profiles), prof.segments)
+        for kp in prof.kernel_profiles:
+            self.assertGreater(len(kp.name), 0)
+            self.assertGreater(len(kp.scheduler), 0)
+            self.assertGreater(kp.time_ms, 0.0)
+            self.assertGreater(kp.registers, 0)
+            self.assertEqual(len(kp.grid), 3)
+            self.assertGreater(kp.input_bytes + kp.output_bytes, 0)
+
+        # The profile is kept until the next profiled execution
+        fd.execute(inputs)
+        self.assertEqual(fd.profile().fusion_id, prof.fusion_id)
+
 
 if __name__ == "__main__":
     run_tests()
@@ -248,6 +248,39 @@ class TestScheduleOps(TestCase):
         self.valid_use(lambda fd: fd.sched.split(fd.t1, 1, 2))
         self.valid_use(lambda fd: fd.sched.split(fd.t1, -1, 2))
 
+    def test_reuse_user_schedule(self):
+        """
+        A compiled user schedule is reused by later instances of the same
+        FusionDefinition child class instead of scheduling again
+        """
+        inputs = [
+            torch.randn(4, 8, device="cuda"),
+        ]
+        schedule_calls = []
+
+        class Reused(FusionDefinition):
+            def definition(self):
+                self.t0 = self.from_pytorch(inputs[0])
+                self.t1 = self.ops.sum(self.t0, dim=-1)
+                self.add_output(self.t1)
+
+            def schedule(self):
+                schedule_calls.append(self)
+                self.sched.split(self.t1, 1, 2)
+
+        for _ in range(3):
+            fd = Reused()
+            nvf_out = fd.execute(inputs)
+            self.assertEqual(nvf_out[0], inputs[0].sum(dim=-1))
+        self.assertEqual(len(schedule_calls), 1)
+
+        # New input sizes need a schedule of their own
+        inputs[0] = torch.randn(16, 32, device="cuda")
+        fd = Reused()
+        nvf_out = fd.execute(inputs)
+        self.assertEqual(nvf_out[0], inputs[0].sum(dim=-1))
+        self.assertEqual(len(schedule_calls), 2)
+
 
 if __name__ == "__main__":
     run_tests()
@@ -0,0 +1,123 @@
+# SPDX-FileCopyrightText: Copyright (c) 2024-present NVIDIA CORPORATION & AFFILIATES.
+# All rights reserved.
+# SPDX-License-Identifier: BSD-3-Clause
+#
+# "check_matmul_sweep.py -h" for help.
+
+import argparse
+import json
+import math
+import sys
+
+
+def load_runs(benchmark_out: str) -> dict[str, dict]:
+    with open(benchmark_out) as f:
+        benchmarks = json.load(f)["benchmarks"]
+    return {b["name"]: b for b in benchmarks if b.get("run_type") != "aggregate"}
+
+
+def geomean(values: list[float]) -> float:
+    return math.exp(sum(math.log(v) for v in values) / len(values))
+
+
+def check(baseline: dict[str, dict], contender: dict[str, dict], args) -> list[str]:
+    regressions = []
+    for name, base in baseline.items():
+        if base.get("error_occurred"):
+            continue
+        run = contender.get(name)
+        if run is None:
+            regressions.append(f"{name}: missing from the contender")
+            continue
+        if run.get("error_occurred"):
+            regressions.append(f"{name}: {run.get('error_message')}")
+            continue
+
+        drop = 100.0 * (1.0 - run["tflops"] / base["tflops"])
+        if drop > args.max_tflops_drop:
+            regressions.append(
+                f"{name}: {run['tflops']:.1f} TFLOPs is {drop:.1f}% below "
+                f"the baseline {base['tflops']:.1f} TFLOPs"
+            )
+        if run["pct_of_cublas"] < args.min_pct_of_cublas:
+            regressions.append(
+                f"{name}: {run['pct_of_cublas']:.1f}% of cuBLAS is below "
+                f"{args.min_pct_of_cublas}%"
+            )
+        if run["registers"] > base["registers"] + args.max_register_increase:
+            regressions.append(
+                f"{name}: {run['registers']:.0f} registers per thread, "
+                f"baseline {base['registers']:.0f}"
+            )
+        if run["smem_bytes"] > base["smem_bytes"] + args.max_smem_increase:
+            regressions.append(
+                f"{name}: {run['smem_bytes']:.0f} bytes of shared memory, "
+                f"baseline {base['smem_bytes']:.0f}"
+            )
+    return regressions
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Compares two JSON outputs of nvfuser_matmul_bench, e.g. "
+        "from `bin/nvfuser_matmul_bench --benchmark_out=sweep.json "
+        "--benchmark_out_format=json`, and exits with 1 if any problem of the "
+        "contender regresses beyond the given thresholds."
+    )
+    parser.add_argument("baseline", type=str, help="The baseline JSON output")
+    parser.add_argument("contender", type=str, help="The contender JSON output")
+    parser.add_argument(
+        "--max-tflops-drop",
+        type=float,
+        default=5.0,
+        help="The allowed TFLOPs drop of a problem in percent",
+    )
+    parser.add_argument(
+        "--min-pct-of-cublas",
+        type=float,
+        default=0.0,
+        help="The minimum percent of cuBLAS performance of each problem",
+    )
+    parser.add_argument(
+        "--max-register-increase",
+        type=int,
+        default=0,
+        help="The allowed increase of registers per thread of a problem",
+    )
+    parser.add_argument(
+        "--max-smem-increase",
+        type=int,
+        default=0,
+        help="The allowed increase of shared memory bytes of a problem",
+    )
+    args = parser.parse_args()
+
+    baseline = load_runs(args.baseline)
+    contender = load_runs(args.contender)
+
+    common = [
+        name
+        for name, run in contender.items()
+        if not run.get("error_occurred")
+        and name in baseline
+        and not baseline[name].get("error_occurred")
+    ]
+    if common:
+        ratios = [contender[n]["tflops"] / baseline[n]["tflops"] for n in common]
+        pcts = [contender[n]["pct_of_cublas"] for n in common]
+        print(
+            f"{len(common)} problems: geometric mean TFLOPs change "
+            f"{100.0 * (geomean(ratios) - 1.0):+.2f}%, "
+            f"geometric mean {geomean(pcts):.1f}% of cuBLAS"
+        )
+
+    regressions = check(baseline, contender, args)
+    for regression in regressions:
+        print(regression)
+    if regressions:
+        print(f"{len(regressions)} regressions found")
+        sys.exit(1)
+
+
+if __name__ == "__main__":
+    main()
@@ -21,6 +21,7 @@ def uses_forbidden_option(arg: str) -> str:
         "--benchmark_out",
         "--benchmark_out_format",
         "--benchmark_format",
+        "--roofline_out",
     ):
         # Depending on which shell, the name of a long option and the value can
         # be split by a space or an =.
@@ -52,15 +53,22 @@ def check_out(branch_or_commit: str) -> None:
     subprocess.check_call("git submodule update --init --recursive", shell=True)
 
 
+def roofline_out_path(benchmark_out: str) -> str:
+    base, _ = os.path.splitext(benchmark_out)
+    return base + ".roofline.json"
+
+
 # Runs nvfuser_bench with `benchmark_args` on the given branch or commit. Dumps
 # outputs to `out_dir`. Returns `out_dir`/`branch_or_commit`.json that captures
-# the benchmark result. If the output already exists, skips benchmarking and
+# the benchmark result. The roofline report is written next to it, see
+# `roofline_out_path`. If the output already exists, skips benchmarking and
 # uses that output. This is useful, for example, when comparing multiple
 # contenders to the same base.
 def run_benchmark(
     branch_or_commit: str, benchmark_args: list[str], out_dir: str
 ) -> str:
     benchmark_out = os.path.join(out_dir, branch_or_commit + ".json")
+    roofline_out = roofline_out_path(benchmark_out)
     if os.path.exists(benchmark_out):
         print(f"{benchmark_out} already exists. Skip benchmarking {branch_or_commit}.")
         return benchmark_out
@@ -72,7 +80,11 @@ def run_benchmark(
     benchmark_command = " ".join(
         ["bin/nvfuser_bench"]
         + benchmark_args
-        + [f"--benchmark_out={benchmark_out}", "--benchmark_format=json"]
+        + [
+            f"--benchmark_out={benchmark_out}",
+            "--benchmark_format=json",
+            f"--roofline_out={roofline_out}",
+        ]
     )
     stdout_path = os.path.join(out_dir, branch_or_commit + ".stdout")
     stderr_path = os.path.join(out_dir, branch_or_commit + ".stderr")
@@ -170,6 +182,86 @@ def summarize_comparison(comparisons: Iterable[Comparison], out_dir: str) -> Non
     print(f"Saved the histogram of time changes to {histogram_out}.")
 
 
+@dataclass
+class RooflineComparison:
+    name: str
+    # Percent of speed of light, i.e., the achieved fraction of the roofline.
+    baseline_pct_sol: float
+    contender_pct_sol: float
+
+    @property
+    def change(self) -> float:
+        return self.contender_pct_sol - self.baseline_pct_sol
+
+    def __str__(self):
+        return f"Benchmark {self.name} changed from {self.baseline_pct_sol:.1f}% to {self.contender_pct_sol:.1f}% of SOL ({self.change:+.1f}%)"
+
+
+def load_roofline(roofline_out: str) -> dict[str, float]:
+    with open(roofline_out) as f:
+        data = json.loads(f.read())
+    return {row["name"]: row["pct_sol"] for row in data["benchmarks"]}
+
+
+# Compares the percent of SOL of the benchmarks in both roofline reports.
+# Writes the comparison to a .json file and prints the largest changes.
+def compare_roofline(baseline_out: str, contender_out: str, out_dir: str) -> None:
+    baseline_roofline_out = roofline_out_path(baseline_out)
+    contender_roofline_out = roofline_out_path(contender_out)
+    if not (
+        os.path.exists(baseline_roofline_out)
+        and os.path.exists(contender_roofline_out)
+    ):
+        print("Roofline reports are missing. Skip comparing percent of SOL.")
+        return
+
+    baseline = load_roofline(baseline_roofline_out)
+    contender = load_roofline(contender_roofline_out)
+    comparisons = sorted(
+        (
+            RooflineComparison(name, baseline[name], contender[name])
+            for name in baseline.keys() & contender.keys()
+        ),
+        key=lambda x: x.change,
+    )
+
+    baseline_name, _ = os.path.splitext(os.path.basename(baseline_out))
+    contender_name, _ = os.path.splitext(os.path.basename(contender_out))
+    comparison_out = os.path.join(
+        out_dir, f"{baseline_name}_vs_{contender_name}.roofline.json"
+    )
+    with open(comparison_out, "w") as f:
+        json.dump(
+            [
+                {
+                    "name": c.name,
+                    "baseline_pct_sol": c.baseline_pct_sol,
+                    "contender_pct_sol": c.contender_pct_sol,
+                    "change": c.change,
+                }
+                for c in comparisons
+            ],
+            f,
+            indent=2,
+        )
+
+    num_tops = 5
+    print()
+    print(f"Top {num_tops} percent of SOL gains:")
+    for comparison in reversed(comparisons[-num_tops:]):
+        if comparison.change <= 0:
+            break
+        print(f"  {comparison}")
+    print()
+    print(f"Top {num_tops} percent of SOL losses:")
+    for comparison in comparisons[:num_tops]:
+        if comparison.change >= 0:
+            break
+        print(f"  {comparison}")
+    print()
+    print(f"Saved the roofline comparison to {comparison_out}.")
+
+
 def get_head_branch_or_commit() -> str:
     # Return the branch name if possible.
     head_branch_or_commit = subprocess.check_output(
@@ -218,3 +310,4 @@ if __name__ == "__main__":
     comparison_out = compare(baseline_out, contender_out, args.out_dir)
     comparisons = load_comparison(comparison_out)
     summarize_comparison(comparisons, args.out_dir)
+    compare_roofline(baseline_out, contender_out, args.out_dir)
@@ -0,0 +1,28 @@
+# SPDX-FileCopyrightText: Copyright (c) 2023-present NVIDIA CORPORATION & AFFILIATES.
+# All rights reserved.
+# SPDX-License-Identifier: BSD-3-Clause
+
+# Merges the heuristic DB files recorded with NVFUSER_ENABLE=heuristic_db, e.g.
+# on the machines of a cluster, into a single file. Measurements of the same
+# parameters for the same problem keep their best time and add up their
+# number of samples.
+
+import argparse
+
+from nvfuser import _C
+
+arg_parser = argparse.ArgumentParser(
+    description="Merges nvFuser heuristic DB files", allow_abbrev=False
+)
+arg_parser.add_argument(
+    "-o", "--output", required=True, help="Merged heuristic DB file"
+)
+arg_parser.add_argument("inputs", nargs="+", help="Heuristic DB files to merge")
+
+args = arg_parser.parse_args()
+
+num_signatures = _C.merge_heuristic_dbs(args.output, args.inputs)
+print(
+    f"Merged {len(args.inputs)} heuristic DB files with {num_signatures} "
+    f"problem signatures into {args.output}"
+)